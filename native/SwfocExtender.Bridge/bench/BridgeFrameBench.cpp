@@ -0,0 +1,117 @@
+// cppcheck-suppress-file missingIncludeSystem
+// Times reading the hot commands (set_credits, a toggle) as JSON lines
+// against the same commands as binary frames, after checking that every
+// frame decodes back to the command its line parses to.
+//
+//   SwfocExtender.BridgeFrameBench [iterations]
+#include "swfoc_extender/bridge/BridgeFrame.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using swfoc::extender::bridge::BridgeCommand;
+using swfoc::extender::bridge::BridgeFixedPayload;
+using swfoc::extender::bridge::JsonObjectView;
+
+constexpr std::array<std::string_view, 2> kSampleLines {
+    R"({"commandId":"6f1c2a9e4b7d4e0f9a3b1c2d3e4f5a6b","featureId":"set_credits","profileId":"base_swfoc","mode":"Galactic","payload":{"intValue":50000,"lockCredits":true},"processId":18244,"processName":"StarWarsG.exe","resolvedAnchors":{"credits":"0x7FF6A1B20010","credits_rva":"0x1B20010"},"requestedBy":"runtime","timestampUtc":"2026-10-14T09:12:44.5120000Z"})",
+    R"({"commandId":"0a1b2c3d4e5f60718293a4b5c6d7e8f9","featureId":"toggle_fog_reveal","profileId":"aotr_1397421866_swfoc","payload":{"enable":true},"processId":18244,"resolvedAnchors":{"fog_reveal":"0x7FF6A1C04420"}})",
+};
+
+// The binary form of a line: the fixed fields in the header, and an
+// extension only for what the hot path does not read.
+std::string ToFrame(std::string_view line) {
+    auto command = swfoc::extender::bridge::ParseJsonCommand(line);
+    const auto payload = JsonObjectView::Parse(command.payloadJson);
+    BridgeFixedPayload fixed;
+    fixed.hasIntValue = payload.tryReadInt("intValue", fixed.intValue);
+    fixed.hasEnable = payload.tryReadBool("enable", fixed.enable);
+    static_cast<void>(payload.tryReadBool("lockCredits", fixed.lockCredits));
+    command.fixedPayload = fixed;
+    command.payloadJson.clear();
+
+    std::string frame;
+    swfoc::extender::bridge::EncodeBinaryCommand(frame, command);
+    return frame;
+}
+
+bool SameCommand(const BridgeCommand& left, const BridgeCommand& right) {
+    return left.commandId == right.commandId && left.featureId == right.featureId && left.profileId == right.profileId
+        && left.mode == right.mode && left.processName == right.processName && left.requestedBy == right.requestedBy
+        && left.timestampUtc == right.timestampUtc && left.processId == right.processId
+        && left.resolvedAnchors == right.resolvedAnchors;
+}
+
+// What BuildPluginRequest reads on the hot path; a checksum keeps the work.
+std::size_t ReadJson(std::string_view line) {
+    const auto command = swfoc::extender::bridge::ParseJsonCommand(line);
+    const auto payload = JsonObjectView::Parse(command.payloadJson);
+    std::int32_t intValue = 0;
+    auto enable = false;
+    auto lockCredits = false;
+    static_cast<void>(payload.tryReadInt("intValue", intValue));
+    static_cast<void>(payload.tryReadBool("enable", enable));
+    static_cast<void>(payload.tryReadBool("lockCredits", lockCredits));
+    return command.resolvedAnchors.size() + static_cast<std::size_t>(intValue) + (enable ? 1 : 0) + (lockCredits ? 1 : 0);
+}
+
+std::size_t ReadFrame(std::string_view frame) {
+    BridgeCommand command;
+    std::string error;
+    if (!swfoc::extender::bridge::TryDecodeBinaryCommand(frame, command, error)) {
+        return 0;
+    }
+    const auto& fixed = *command.fixedPayload;
+    return command.resolvedAnchors.size() + static_cast<std::size_t>(fixed.intValue) + (fixed.enable ? 1 : 0)
+        + (fixed.lockCredits ? 1 : 0);
+}
+
+template <typename TRead>
+double TimePerCommand(const std::vector<std::string>& inputs, long iterations, TRead read, std::size_t& checksum) {
+    const auto started = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        for (const auto& input : inputs) {
+            checksum += read(input);
+        }
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started);
+    return elapsed.count() / (static_cast<double>(iterations) * static_cast<double>(inputs.size()));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto iterations = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 200000L;
+    if (iterations <= 0) {
+        std::cerr << "iterations must be positive\n";
+        return 1;
+    }
+
+    std::vector<std::string> lines(kSampleLines.begin(), kSampleLines.end());
+    std::vector<std::string> frames;
+    for (const auto& line : lines) {
+        frames.push_back(ToFrame(line));
+        BridgeCommand decoded;
+        std::string error;
+        if (!swfoc::extender::bridge::TryDecodeBinaryCommand(frames.back(), decoded, error)
+            || !SameCommand(decoded, swfoc::extender::bridge::ParseJsonCommand(line))
+            || ReadFrame(frames.back()) != ReadJson(line)) {
+            std::cerr << "frame does not round-trip: " << line << ' ' << error << '\n';
+            return 1;
+        }
+    }
+
+    std::size_t checksum = 0;
+    const auto jsonNs = TimePerCommand(lines, iterations, ReadJson, checksum);
+    const auto frameNs = TimePerCommand(frames, iterations, ReadFrame, checksum);
+    std::cout << "json line: " << jsonNs << " ns/command, binary frame: " << frameNs
+              << " ns/command (checksum " << checksum << ")\n";
+    return 0;
+}
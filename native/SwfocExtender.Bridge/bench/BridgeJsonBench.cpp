@@ -0,0 +1,117 @@
+// cppcheck-suppress-file missingIncludeSystem
+// Times JsonObjectView over bridge command lines: one parse of the line, one
+// of its payload, then the fields handleRawCommand and BuildPluginRequest read.
+//
+//   SwfocExtender.BridgeJsonBench [captured.jsonl] [iterations]
+//
+// With no capture file it runs the built-in lines, shaped like the ones the
+// runtime's ExtenderCommand serializer writes.
+#include "swfoc_extender/bridge/BridgeJson.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using swfoc::extender::bridge::JsonObjectView;
+
+constexpr std::array<std::string_view, 4> kSampleLines {
+    R"({"commandId":"6f1c2a9e4b7d4e0f9a3b1c2d3e4f5a6b","featureId":"set_credits","profileId":"base_swfoc","mode":"Galactic","payload":{"intValue":50000,"lockCredits":true,"anchors":{"credits":"0x7FF6A1B20010"}},"processId":18244,"processName":"StarWarsG.exe","resolvedAnchors":{"credits":"0x7FF6A1B20010","credits_rva":"0x1B20010"},"requestedBy":"runtime","timestampUtc":"2026-10-14T09:12:44.5120000Z"})",
+    R"({"commandId":"0a1b2c3d4e5f60718293a4b5c6d7e8f9","featureId":"toggle_fog_reveal","profileId":"aotr_1397421866_swfoc","mode":"TacticalLand","payload":{"enable":true,"processId":18244},"processId":18244,"processName":"StarWarsG.exe","resolvedAnchors":{"fog_reveal":"0x7FF6A1C04420"},"requestedBy":"runtime","timestampUtc":"2026-10-14T09:12:45.0030000Z"})",
+    R"({"commandId":"f0e1d2c3b4a5968778695a4b3c2d1e0f","featureId":"spawn_tactical_entity","profileId":"roe_3447786229_swfoc","mode":"TacticalSpace","payload":{"helperHookId":"spawn_bridge","helperEntryPoint":"SWFOC_Trainer_Spawn","helperScript":"scripts/common/spawn_bridge.lua","operationKind":"spawn_tactical_entity","operationToken":"9c8b7a6f","helperInvocationContractVersion":"1.0","entityId":"Imperial_Star_Destroyer","faction":"Empire","populationPolicy":"ForceZeroTactical","persistencePolicy":"EphemeralBattleOnly","placementMode":"reinforcement_zone","worldPosition":"{\"x\":120.5,\"y\":0,\"z\":-44.25}","allowCrossFaction":true,"forceOverride":false},"processId":18244,"processName":"StarWarsG.exe","resolvedAnchors":{},"requestedBy":"runtime","timestampUtc":"2026-10-14T09:12:47.8800000Z"})",
+    R"({"commandId":"11223344556677889900aabbccddeeff","featureId":"health","processId":0,"payload":{},"resolvedAnchors":{}})",
+};
+
+std::vector<std::string> LoadLines(const char* path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (!line.empty()) {
+            lines.push_back(std::move(line));
+        }
+    }
+
+    return lines;
+}
+
+// Returns a checksum of what was read so the work cannot be optimized away.
+std::size_t ReadCommand(std::string_view text) {
+    const auto line = JsonObjectView::Parse(text);
+    auto sum = line.stringValue("commandId").size() + line.stringValue("featureId").size()
+        + line.stringValue("profileId").size() + line.stringValue("mode").size()
+        + line.stringValue("processName").size() + line.stringValue("requestedBy").size()
+        + line.stringValue("timestampUtc").size() + line.stringMap("resolvedAnchors").size();
+    if (std::int32_t processId = 0; line.tryReadInt("processId", processId)) {
+        sum += static_cast<std::size_t>(processId);
+    }
+
+    const auto payload = JsonObjectView::Parse(line.objectJson("payload"));
+    sum += payload.stringMap("anchors").size();
+    for (const auto key : {"symbol", "helperHookId", "helperEntryPoint", "helperScript", "operationKind",
+             "operationToken", "helperInvocationContractVersion", "unitId", "entityId", "entryMarker", "faction",
+             "targetFaction", "sourceFaction", "globalKey", "populationPolicy", "persistencePolicy",
+             "placementMode", "worldPosition"}) {
+        sum += payload.stringValue(key).size();
+    }
+
+    for (const auto key : {"processId", "intValue"}) {
+        if (std::int32_t value = 0; payload.tryReadInt(key, value)) {
+            sum += static_cast<std::size_t>(value);
+        }
+    }
+
+    for (const auto key : {"lockCredits", "forcePatchHook", "boolValue", "enable", "allowCrossFaction",
+             "forceOverride"}) {
+        if (auto value = false; payload.tryReadBool(key, value) && value) {
+            ++sum;
+        }
+    }
+
+    return sum;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> lines;
+    if (argc > 1) {
+        lines = LoadLines(argv[1]);
+        if (lines.empty()) {
+            std::cerr << "no command lines in " << argv[1] << '\n';
+            return 1;
+        }
+    } else {
+        lines.assign(kSampleLines.begin(), kSampleLines.end());
+    }
+
+    const auto iterations = argc > 2 ? std::strtol(argv[2], nullptr, 10) : 200000L;
+    if (iterations <= 0) {
+        std::cerr << "iterations must be positive\n";
+        return 1;
+    }
+
+    std::size_t checksum = 0;
+    const auto started = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        for (const auto& line : lines) {
+            checksum += ReadCommand(line);
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started);
+    const auto perLine = elapsed.count() / (static_cast<double>(iterations) * static_cast<double>(lines.size()));
+    std::cout << lines.size() << " lines x " << iterations << " iterations: " << perLine
+              << " ns/line (checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,78 @@
+// cppcheck-suppress-file missingIncludeSystem
+#pragma once
+
+#include "swfoc_extender/bridge/NamedPipeBridgeServer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace swfoc::extender::bridge {
+
+/// Binary framing for the bridge pipe, next to the newline-delimited JSON.
+///
+/// The first bytes written to a connection pick the framing: a frame that
+/// starts with kBinaryCommandMagic is binary, anything else is a JSON line,
+/// and the response uses the same framing. Integers are little-endian;
+/// every length counts bytes of UTF-8.
+///
+/// Command frame (40-byte header, then the variable fields in this order):
+///
+///     0  magic "SWFB"         20  u32 commandId length
+///     4  u32 frame length      24  u32 featureId length
+///     8  u8  version (1)       28  u32 profileId length
+///     9  u8  flags             32  u32 anchor count
+///    10  u16 reserved (0)      36  u32 extension length
+///    12  i32 processId
+///    16  i32 intValue
+///
+///    commandId, featureId, profileId,
+///    anchor count x (u32 key length, u32 value length, key, value),
+///    extension: an optional JSON object read like a command line (mode,
+///    processName, requestedBy, timestampUtc, resolvedAnchors, payload).
+///    Header fields win over the extension, so nothing the JSON protocol
+///    can say is lost, and the hot set_credits / toggle commands need none.
+///
+/// Result frame (36-byte header): magic "SWFR", u32 frame length, u8 version,
+/// u8 flags (bit 0: succeeded), u16 reserved, then u32 lengths of commandId,
+/// reasonCode, backend, hookState, message and the diagnostics JSON, followed
+/// by those fields in the same order.
+inline constexpr std::string_view kBinaryCommandMagic {"SWFB"};
+inline constexpr std::string_view kBinaryResultMagic {"SWFR"};
+inline constexpr std::uint8_t kBinaryFrameVersion = 1;
+inline constexpr std::size_t kBinaryCommandHeaderSize = 40;
+inline constexpr std::size_t kBinaryResultHeaderSize = 36;
+/// Longer frames are rejected instead of buffered.
+inline constexpr std::size_t kMaxBinaryFrameLength = 1024 * 1024;
+
+/// Command frame flag bits.
+inline constexpr std::uint8_t kFrameHasIntValue = 0x01;
+inline constexpr std::uint8_t kFrameLockCredits = 0x02;
+inline constexpr std::uint8_t kFrameHasEnable = 0x04;
+inline constexpr std::uint8_t kFrameEnable = 0x08;
+inline constexpr std::uint8_t kFrameHasBoolValue = 0x10;
+inline constexpr std::uint8_t kFrameBoolValue = 0x20;
+
+[[nodiscard]] bool IsBinaryFrame(std::string_view bytes) noexcept;
+
+/// Frame length from a binary header, or 0 until the length field has arrived.
+[[nodiscard]] std::size_t BinaryFrameLength(std::string_view bytes) noexcept;
+
+/// One JSON command line, fields the line omits left empty.
+[[nodiscard]] BridgeCommand ParseJsonCommand(std::string_view jsonLine);
+
+/// False, with error set, for a frame that is truncated, oversized, of
+/// another version, or whose lengths overrun it.
+[[nodiscard]] bool TryDecodeBinaryCommand(std::string_view frame, BridgeCommand& command, std::string& error);
+
+/// Appends command as a frame. fixedPayload, when set, fills the header;
+/// mode, processName, requestedBy, timestampUtc and a non-empty payloadJson
+/// go into the extension.
+void EncodeBinaryCommand(std::string& out, const BridgeCommand& command);
+
+void EncodeBinaryResult(std::string& out, const BridgeResult& result);
+
+[[nodiscard]] bool TryDecodeBinaryResult(std::string_view frame, BridgeResult& result, std::string& error);
+
+} // namespace swfoc::extender::bridge
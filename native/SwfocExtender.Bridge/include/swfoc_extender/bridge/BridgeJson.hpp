@@ -0,0 +1,101 @@
+// cppcheck-suppress-file missingIncludeSystem
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace swfoc::extender::bridge {
+
+using StringMap = std::map<std::string, std::string, std::less<>>;
+
+/// The top-level members of one JSON object, found in a single pass.
+///
+/// Parse walks the text once and records each member's key and raw value
+/// token as views into it; lookups then search that short member list
+/// instead of rescanning the text per key. Nested objects and arrays are
+/// skipped over as one token, so a key inside the payload never matches a
+/// lookup on the command line itself. Parsing stops at the first malformed
+/// member and keeps the members before it. The text must outlive the view.
+class JsonObjectView {
+public:
+    struct Member {
+        std::string_view key;    // as written, escapes left in
+        std::string_view value;  // raw token; a string keeps its quotes
+    };
+
+    JsonObjectView() = default;
+    [[nodiscard]] static JsonObjectView Parse(std::string_view json);
+
+    [[nodiscard]] const std::vector<Member>& members() const noexcept { return members_; }
+
+    /// Raw value token of the first member named key, or empty.
+    [[nodiscard]] std::string_view find(std::string_view key) const noexcept;
+
+    /// Unescaped contents of a string member; empty when absent or not a string.
+    [[nodiscard]] std::string stringValue(std::string_view key) const;
+
+    /// An integer member's leading digits, as std::stoi read them; a leading
+    /// '+' or a number outside int32 is rejected.
+    bool tryReadInt(std::string_view key, std::int32_t& value) const;
+
+    bool tryReadBool(std::string_view key, bool& value) const;
+
+    /// Text of an object member, braces included; "{}" when absent or not an object.
+    [[nodiscard]] std::string_view objectJson(std::string_view key) const noexcept;
+
+    /// An object member's members as strings: string values unescaped, other
+    /// values as their raw token. Members with an empty key are dropped.
+    [[nodiscard]] StringMap stringMap(std::string_view key) const;
+
+private:
+    std::vector<Member> members_;
+};
+
+/// Raw tokens of an array's elements, nested values skipped whole; empty if
+/// token is not an array. Stops at the first malformed element.
+[[nodiscard]] std::vector<std::string_view> JsonArrayElements(std::string_view token);
+
+/// Contents of a JSON string token (quotes included) with escapes resolved;
+/// \uXXXX becomes UTF-8. Empty if token is not a string.
+[[nodiscard]] std::string UnescapeJsonString(std::string_view token);
+
+[[nodiscard]] std::string EscapeJson(std::string_view value);
+
+/// Appends value's JSON escaping (no quotes) to out: runs that need no escape
+/// are copied whole, and no temporary string is built.
+void AppendEscapedJson(std::string& out, std::string_view value);
+
+/// Writes JSON straight into a caller-owned string.
+///
+/// The writer only appends; the caller clears and reuses the same buffer
+/// across responses so its capacity is allocated once. Commas are placed by
+/// the writer: key() emits one whenever a value precedes it at this depth.
+/// It does not check that calls nest correctly.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) noexcept : out_(&out) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& string(std::string_view value);
+    JsonWriter& boolean(bool value);
+    JsonWriter& number(std::int64_t value);
+
+    /// An already serialized value, copied as is; empty text writes "{}".
+    JsonWriter& raw(std::string_view json);
+
+    /// An object of string members.
+    JsonWriter& stringMap(const StringMap& values);
+
+private:
+    std::string* out_;
+    bool needsComma_ {false};
+};
+
+} // namespace swfoc::extender::bridge
@@ -2,13 +2,19 @@
 // cppcheck-suppress-file unusedStructMember
 #pragma once
 
+#include "swfoc_extender/bridge/BridgeJson.hpp"
+
 #include <atomic>
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 /*
 Cppcheck note (targeted): if cppcheck runs without STL include paths,
@@ -18,7 +24,24 @@ suppress only this header:
 
 namespace swfoc::extender::bridge {
 
-using StringMap = std::map<std::string, std::string, std::less<>>;
+/// Payload fields a binary frame carries in its fixed header. When present
+/// they win over the same keys in payloadJson, which then holds only what
+/// the frame's JSON extension added.
+struct BridgeFixedPayload {
+    [[maybe_unused]] std::int32_t intValue {0};
+    [[maybe_unused]] bool hasIntValue {false};
+    [[maybe_unused]] bool lockCredits {false};
+    [[maybe_unused]] bool hasEnable {false};
+    [[maybe_unused]] bool enable {false};
+    [[maybe_unused]] bool hasBoolValue {false};
+    [[maybe_unused]] bool boolValue {false};
+};
+
+/// How a command reached the server; the response goes back the same way.
+enum class BridgeFraming {
+    JsonLine,
+    Binary
+};
 
 struct BridgeCommand {
     [[maybe_unused]] std::string commandId;
@@ -31,6 +54,7 @@ struct BridgeCommand {
     [[maybe_unused]] std::int32_t processId {0};
     [[maybe_unused]] std::string processName;
     [[maybe_unused]] StringMap resolvedAnchors {};
+    [[maybe_unused]] std::optional<BridgeFixedPayload> fixedPayload {};
 };
 
 struct BridgeResult {
@@ -45,23 +69,44 @@ struct BridgeResult {
 
 class NamedPipeBridgeServer {
 public:
-    using Handler = std::function<BridgeResult(const BridgeCommand&)>;
+    using Handler = std::function<BridgeResult(BridgeCommand&&)>;
 
     explicit NamedPipeBridgeServer(std::string pipeName);
+    ~NamedPipeBridgeServer();
 
+    NamedPipeBridgeServer(const NamedPipeBridgeServer&) = delete;
+    NamedPipeBridgeServer& operator=(const NamedPipeBridgeServer&) = delete;
+
+    // The handler runs on the server's worker pool, so commands from
+    // different clients may reach it concurrently. It owns the command and
+    // may move members out of it (resolvedAnchors, payloadJson); commandId is
+    // read back afterward.
     void setHandler(Handler handler);
+
+    // Commands for a serialized feature run one at a time; every other
+    // feature (health, probe_capabilities, ...) runs concurrently with them.
+    // Call before start().
+    void serializeFeature(std::string featureId);
+
     bool start();
     void stop();
     [[nodiscard]] bool running() const noexcept;
 
 private:
-    void runLoop() const;
-    [[nodiscard]] BridgeResult handleRawCommand(std::string_view jsonLine) const;
+    struct PipeInstance;
+
+    void workerLoop();
+    void completeIo(PipeInstance& instance, std::uint32_t error, std::uint32_t bytesTransferred);
+    void closeInstances();
+    [[nodiscard]] BridgeResult handleRawCommand(std::string_view raw, BridgeFraming framing) const;
 
     [[maybe_unused]] std::string pipeName_;
     Handler handler_;
+    std::map<std::string, std::unique_ptr<std::mutex>, std::less<>> featureLocks_;
     std::atomic<bool> running_ {false};
-    std::jthread worker_;
+    void* completionPort_ {nullptr};
+    std::vector<std::unique_ptr<PipeInstance>> instances_;
+    std::vector<std::jthread> workers_;
 };
 
 } // namespace swfoc::extender::bridge
@@ -0,0 +1,32 @@
+// cppcheck-suppress-file missingIncludeSystem
+#pragma once
+
+#include "swfoc_extender/core/SignatureScanner.hpp"
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace swfoc::extender::bridge {
+
+/// The signatures of one profile document, in signatureSets order. Specs
+/// with a missing name or pattern, or an addressMode the runtime does not
+/// know, are left out; a missing addressMode means HitPlusOffset.
+[[nodiscard]] std::vector<core::SignatureSpec> ParseProfileSignatures(std::string_view profileJson);
+
+/// `<profilesDirectory>/<profileId>.json` and its inherits chain, parent sets
+/// first, as FileSystemProfileRepository merges them. Empty with error set
+/// when a profile is missing or the chain loops.
+[[nodiscard]] std::vector<core::SignatureSpec> LoadProfileSignatures(
+    const std::filesystem::path& profilesDirectory,
+    std::string_view profileId,
+    std::string& error);
+
+/// Every profile's own signatures (inherits is not followed, so a base
+/// profile's sets appear once), by file name, duplicates dropped.
+[[nodiscard]] std::vector<core::SignatureSpec> LoadAllProfileSignatures(
+    const std::filesystem::path& profilesDirectory,
+    std::string& error);
+
+} // namespace swfoc::extender::bridge
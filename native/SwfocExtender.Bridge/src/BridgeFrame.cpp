@@ -0,0 +1,349 @@
+// cppcheck-suppress-file missingIncludeSystem
+#include "swfoc_extender/bridge/BridgeFrame.hpp"
+
+#include <initializer_list>
+#include <utility>
+
+namespace swfoc::extender::bridge {
+
+namespace {
+
+constexpr std::size_t kFrameLengthOffset = 4;
+constexpr std::size_t kVersionOffset = 8;
+constexpr std::size_t kFlagsOffset = 9;
+
+void AppendU8(std::string& out, std::uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+void AppendU16(std::string& out, std::uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void AppendU32(std::string& out, std::uint32_t value) {
+    for (auto shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void PatchU32(std::string& out, std::size_t offset, std::uint32_t value) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        out[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Caller has checked that offset + 4 is in range.
+std::uint32_t ReadU32(std::string_view bytes, std::size_t offset) {
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[offset + i])) << (8 * i);
+    }
+    return value;
+}
+
+std::uint32_t LengthOf(std::string_view text) {
+    return static_cast<std::uint32_t>(text.size());
+}
+
+// Walks the variable part of a frame; every take fails once one has overrun.
+class FrameCursor {
+public:
+    FrameCursor(std::string_view frame, std::size_t cursor) : frame_(frame), cursor_(cursor) {}
+
+    bool take(std::uint32_t length, std::string_view& field) {
+        if (!ok_ || length > frame_.size() - cursor_) {
+            ok_ = false;
+            return false;
+        }
+        field = frame_.substr(cursor_, length);
+        cursor_ += length;
+        return true;
+    }
+
+    bool takeU32(std::uint32_t& value) {
+        if (!ok_ || frame_.size() - cursor_ < 4) {
+            ok_ = false;
+            return false;
+        }
+        value = ReadU32(frame_, cursor_);
+        cursor_ += 4;
+        return true;
+    }
+
+    [[nodiscard]] bool finished() const noexcept { return ok_ && cursor_ == frame_.size(); }
+
+private:
+    std::string_view frame_;
+    std::size_t cursor_;
+    bool ok_ {true};
+};
+
+bool CheckFrameHeader(std::string_view frame, std::string_view magic, std::size_t headerSize, std::string& error) {
+    if (frame.size() < headerSize || !frame.starts_with(magic)) {
+        error = "truncated_header";
+        return false;
+    }
+
+    const auto declared = ReadU32(frame, kFrameLengthOffset);
+    if (declared > kMaxBinaryFrameLength) {
+        error = "frame_too_large";
+        return false;
+    }
+
+    if (declared != frame.size()) {
+        error = "frame_length_mismatch";
+        return false;
+    }
+
+    if (static_cast<std::uint8_t>(frame[kVersionOffset]) != kBinaryFrameVersion) {
+        error = "unsupported_version";
+        return false;
+    }
+
+    return true;
+}
+
+void TakeIfEmpty(std::string& field, std::string& fromExtension) {
+    if (field.empty()) {
+        field = std::move(fromExtension);
+    }
+}
+
+// Header fields win; the extension fills in what the header left empty.
+void ApplyExtension(BridgeCommand& command, std::string_view extensionJson) {
+    auto extension = ParseJsonCommand(extensionJson);
+    TakeIfEmpty(command.commandId, extension.commandId);
+    TakeIfEmpty(command.featureId, extension.featureId);
+    TakeIfEmpty(command.profileId, extension.profileId);
+    TakeIfEmpty(command.mode, extension.mode);
+    TakeIfEmpty(command.requestedBy, extension.requestedBy);
+    TakeIfEmpty(command.timestampUtc, extension.timestampUtc);
+    TakeIfEmpty(command.processName, extension.processName);
+    command.payloadJson = std::move(extension.payloadJson);
+    command.resolvedAnchors.merge(extension.resolvedAnchors);
+    if (command.processId == 0) {
+        command.processId = extension.processId;
+    }
+}
+
+std::uint8_t FixedPayloadFlags(const BridgeFixedPayload& fixed) {
+    std::uint8_t flags = 0;
+    const auto set = [&flags](bool on, std::uint8_t bit) {
+        if (on) {
+            flags |= bit;
+        }
+    };
+    set(fixed.hasIntValue, kFrameHasIntValue);
+    set(fixed.lockCredits, kFrameLockCredits);
+    set(fixed.hasEnable, kFrameHasEnable);
+    set(fixed.enable, kFrameEnable);
+    set(fixed.hasBoolValue, kFrameHasBoolValue);
+    set(fixed.boolValue, kFrameBoolValue);
+    return flags;
+}
+
+std::string BuildExtensionJson(const BridgeCommand& command) {
+    std::string extension;
+    JsonWriter writer(extension);
+    writer.beginObject();
+    auto empty = true;
+    for (const auto& [name, value] : {
+             std::pair<std::string_view, std::string_view> {"mode", command.mode},
+             {"processName", command.processName},
+             {"requestedBy", command.requestedBy},
+             {"timestampUtc", command.timestampUtc}}) {
+        if (!value.empty()) {
+            writer.key(name).string(value);
+            empty = false;
+        }
+    }
+
+    if (!command.payloadJson.empty() && command.payloadJson != "{}") {
+        writer.key("payload").raw(command.payloadJson);
+        empty = false;
+    }
+    writer.endObject();
+
+    if (empty) {
+        extension.clear();
+    }
+    return extension;
+}
+
+} // namespace
+
+bool IsBinaryFrame(std::string_view bytes) noexcept {
+    return bytes.starts_with(kBinaryCommandMagic);
+}
+
+std::size_t BinaryFrameLength(std::string_view bytes) noexcept {
+    return bytes.size() < kFrameLengthOffset + 4 ? 0 : ReadU32(bytes, kFrameLengthOffset);
+}
+
+BridgeCommand ParseJsonCommand(std::string_view jsonLine) {
+    const auto line = JsonObjectView::Parse(jsonLine);
+    BridgeCommand command;
+    command.commandId = line.stringValue("commandId");
+    command.featureId = line.stringValue("featureId");
+    command.profileId = line.stringValue("profileId");
+    command.mode = line.stringValue("mode");
+    command.requestedBy = line.stringValue("requestedBy");
+    command.timestampUtc = line.stringValue("timestampUtc");
+    command.payloadJson = std::string(line.objectJson("payload"));
+    command.processName = line.stringValue("processName");
+    command.resolvedAnchors = line.stringMap("resolvedAnchors");
+    if (std::int32_t processId = 0; line.tryReadInt("processId", processId)) {
+        command.processId = processId;
+    }
+    return command;
+}
+
+bool TryDecodeBinaryCommand(std::string_view frame, BridgeCommand& command, std::string& error) {
+    if (!CheckFrameHeader(frame, kBinaryCommandMagic, kBinaryCommandHeaderSize, error)) {
+        return false;
+    }
+
+    const auto flags = static_cast<std::uint8_t>(frame[kFlagsOffset]);
+    BridgeFixedPayload fixed;
+    fixed.intValue = static_cast<std::int32_t>(ReadU32(frame, 16));
+    fixed.hasIntValue = (flags & kFrameHasIntValue) != 0;
+    fixed.lockCredits = (flags & kFrameLockCredits) != 0;
+    fixed.hasEnable = (flags & kFrameHasEnable) != 0;
+    fixed.enable = (flags & kFrameEnable) != 0;
+    fixed.hasBoolValue = (flags & kFrameHasBoolValue) != 0;
+    fixed.boolValue = (flags & kFrameBoolValue) != 0;
+
+    FrameCursor cursor(frame, kBinaryCommandHeaderSize);
+    std::string_view commandId;
+    std::string_view featureId;
+    std::string_view profileId;
+    cursor.take(ReadU32(frame, 20), commandId);
+    cursor.take(ReadU32(frame, 24), featureId);
+    cursor.take(ReadU32(frame, 28), profileId);
+
+    StringMap anchors;
+    const auto anchorCount = ReadU32(frame, 32);
+    for (std::uint32_t i = 0; i < anchorCount; ++i) {
+        std::uint32_t keyLength = 0;
+        std::uint32_t valueLength = 0;
+        std::string_view key;
+        std::string_view value;
+        if (!cursor.takeU32(keyLength) || !cursor.takeU32(valueLength) || !cursor.take(keyLength, key)
+            || !cursor.take(valueLength, value)) {
+            break;
+        }
+        anchors.insert_or_assign(std::string(key), std::string(value));
+    }
+
+    std::string_view extension;
+    cursor.take(ReadU32(frame, 36), extension);
+    if (!cursor.finished()) {
+        error = "field_length_mismatch";
+        return false;
+    }
+
+    command = BridgeCommand {};
+    command.commandId = std::string(commandId);
+    command.featureId = std::string(featureId);
+    command.profileId = std::string(profileId);
+    command.processId = static_cast<std::int32_t>(ReadU32(frame, 12));
+    command.resolvedAnchors = std::move(anchors);
+    command.payloadJson = "{}";
+    command.fixedPayload = fixed;
+    if (!extension.empty()) {
+        ApplyExtension(command, extension);
+    }
+    return true;
+}
+
+void EncodeBinaryCommand(std::string& out, const BridgeCommand& command) {
+    const auto fixed = command.fixedPayload.value_or(BridgeFixedPayload {});
+    const auto extension = BuildExtensionJson(command);
+
+    const auto start = out.size();
+    out.append(kBinaryCommandMagic);
+    AppendU32(out, 0);  // frame length, patched below
+    AppendU8(out, kBinaryFrameVersion);
+    AppendU8(out, FixedPayloadFlags(fixed));
+    AppendU16(out, 0);
+    AppendU32(out, static_cast<std::uint32_t>(command.processId));
+    AppendU32(out, static_cast<std::uint32_t>(fixed.intValue));
+    AppendU32(out, LengthOf(command.commandId));
+    AppendU32(out, LengthOf(command.featureId));
+    AppendU32(out, LengthOf(command.profileId));
+    AppendU32(out, static_cast<std::uint32_t>(command.resolvedAnchors.size()));
+    AppendU32(out, LengthOf(extension));
+
+    out.append(command.commandId);
+    out.append(command.featureId);
+    out.append(command.profileId);
+    for (const auto& [key, value] : command.resolvedAnchors) {
+        AppendU32(out, LengthOf(key));
+        AppendU32(out, LengthOf(value));
+        out.append(key);
+        out.append(value);
+    }
+    out.append(extension);
+
+    PatchU32(out, start + kFrameLengthOffset, static_cast<std::uint32_t>(out.size() - start));
+}
+
+void EncodeBinaryResult(std::string& out, const BridgeResult& result) {
+    const std::string_view diagnostics = result.diagnosticsJson.empty() ? std::string_view("{}") : result.diagnosticsJson;
+    const auto start = out.size();
+    out.append(kBinaryResultMagic);
+    AppendU32(out, 0);  // frame length, patched below
+    AppendU8(out, kBinaryFrameVersion);
+    AppendU8(out, result.succeeded ? 1 : 0);
+    AppendU16(out, 0);
+    for (const auto field : {std::string_view(result.commandId), std::string_view(result.reasonCode),
+             std::string_view(result.backend), std::string_view(result.hookState), std::string_view(result.message),
+             diagnostics}) {
+        AppendU32(out, LengthOf(field));
+    }
+
+    out.append(result.commandId);
+    out.append(result.reasonCode);
+    out.append(result.backend);
+    out.append(result.hookState);
+    out.append(result.message);
+    out.append(diagnostics);
+
+    PatchU32(out, start + kFrameLengthOffset, static_cast<std::uint32_t>(out.size() - start));
+}
+
+bool TryDecodeBinaryResult(std::string_view frame, BridgeResult& result, std::string& error) {
+    if (!CheckFrameHeader(frame, kBinaryResultMagic, kBinaryResultHeaderSize, error)) {
+        return false;
+    }
+
+    FrameCursor cursor(frame, kBinaryResultHeaderSize);
+    std::string_view commandId;
+    std::string_view reasonCode;
+    std::string_view backend;
+    std::string_view hookState;
+    std::string_view message;
+    std::string_view diagnostics;
+    cursor.take(ReadU32(frame, 12), commandId);
+    cursor.take(ReadU32(frame, 16), reasonCode);
+    cursor.take(ReadU32(frame, 20), backend);
+    cursor.take(ReadU32(frame, 24), hookState);
+    cursor.take(ReadU32(frame, 28), message);
+    cursor.take(ReadU32(frame, 32), diagnostics);
+    if (!cursor.finished()) {
+        error = "field_length_mismatch";
+        return false;
+    }
+
+    result.commandId = std::string(commandId);
+    result.succeeded = (static_cast<std::uint8_t>(frame[kFlagsOffset]) & 0x01) != 0;
+    result.reasonCode = std::string(reasonCode);
+    result.backend = std::string(backend);
+    result.hookState = std::string(hookState);
+    result.message = std::string(message);
+    result.diagnosticsJson = std::string(diagnostics);
+    return true;
+}
+
+} // namespace swfoc::extender::bridge
@@ -1,5 +1,9 @@
 // cppcheck-suppress-file missingIncludeSystem
+#include "swfoc_extender/bridge/BridgeJson.hpp"
 #include "swfoc_extender/bridge/NamedPipeBridgeServer.hpp"
+#include "swfoc_extender/core/CapabilityProbe.hpp"
+#include "swfoc_extender/core/PerfectHash.hpp"
+#include "swfoc_extender/overlay/OverlayState.hpp"
 #include "swfoc_extender/plugins/BuildPatchPlugin.hpp"
 #include "swfoc_extender/plugins/EconomyPlugin.hpp"
 #include "swfoc_extender/plugins/GlobalTogglePlugin.hpp"
@@ -16,10 +20,10 @@
 #include <iostream>
 #include <map>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #if defined(_WIN32)
@@ -28,20 +32,21 @@
 #endif
 
 namespace swfoc::extender::bridge::host_json {
-std::string EscapeJson(std::string_view value);
 std::string ToDiagnosticsJson(const StringMap& values);
-bool TryReadBool(std::string_view payloadJson, std::string_view key, bool& value);
-bool TryReadInt(std::string_view payloadJson, std::string_view key, int& value);
-std::string ExtractStringValue(std::string_view json, std::string_view key);
-StringMap ExtractStringMap(std::string_view json, std::string_view key);
 } // namespace swfoc::extender::bridge::host_json
 
 namespace {
 
 using swfoc::extender::bridge::BridgeCommand;
+using swfoc::extender::bridge::BridgeFixedPayload;
 using swfoc::extender::bridge::BridgeResult;
+using swfoc::extender::bridge::EscapeJson;
+using swfoc::extender::bridge::JsonObjectView;
+using swfoc::extender::bridge::JsonWriter;
 using swfoc::extender::bridge::NamedPipeBridgeServer;
 using swfoc::extender::bridge::StringMap;
+using swfoc::extender::core::ProbeCacheKey;
+using swfoc::extender::overlay::OverlayState;
 using swfoc::extender::plugins::BuildPatchPlugin;
 using swfoc::extender::plugins::CapabilitySnapshot;
 using swfoc::extender::plugins::CapabilityState;
@@ -51,32 +56,67 @@ using swfoc::extender::plugins::HelperLuaPlugin;
 using swfoc::extender::plugins::PluginRequest;
 using swfoc::extender::plugins::PluginResult;
 namespace process_mutation = swfoc::extender::plugins::process_mutation;
-using swfoc::extender::bridge::host_json::EscapeJson;
-using swfoc::extender::bridge::host_json::ExtractStringMap;
-using swfoc::extender::bridge::host_json::ExtractStringValue;
 using swfoc::extender::bridge::host_json::ToDiagnosticsJson;
-using swfoc::extender::bridge::host_json::TryReadBool;
-using swfoc::extender::bridge::host_json::TryReadInt;
+using ProbeSnapshotCache = swfoc::extender::core::CapabilitySnapshotCache<CapabilitySnapshot>;
 
 // S5421: global constants
 constexpr const char* kBackendName = "extender";
 constexpr const char* kDefaultPipeName = "SwfocExtenderBridge";
+constexpr auto kCapabilityProbeRefreshInterval = std::chrono::seconds(2);
+// A full snapshot (every supported feature, a few diagnostics each) fits.
+constexpr std::size_t kCapabilityProbeJsonReserve = 4 * 1024;
+
+enum class FeatureHandler : std::uint8_t {
+    Health,
+    CapabilityProbe,
+    Economy,
+    GlobalToggle,
+    BuildPatch,
+    Helper
+};
+
+// How the capability probe reports a feature: not at all, by reading the
+// first resolved anchor it finds, or as a helper-bridge feature.
+enum class FeatureProbe : std::uint8_t {
+    None,
+    Anchor,
+    Helper
+};
 
-constexpr std::array<const char*, 14> kSupportedFeatures = {
-    "freeze_timer",
-    "toggle_fog_reveal",
-    "toggle_ai",
-    "set_unit_cap",
-    "toggle_instant_build_patch",
-    "set_credits",
-    "spawn_unit_helper",
-    "spawn_context_entity",
-    "spawn_tactical_entity",
-    "spawn_galactic_entity",
-    "place_planet_building",
-    "set_context_allegiance",
-    "set_hero_state_helper",
-    "toggle_roe_respawn_helper"};
+// One row per command featureId. `serialized` marks features whose plugin
+// keeps state across a write (lock value, restore bytes, patch flags), so two
+// clients must not run them at once; health, capability probes and the
+// stateless helper features run concurrently. `anchors` are the probe's
+// anchor candidates in preference order.
+struct FeatureRoute {
+    std::string_view key;
+    FeatureHandler handler;
+    FeatureProbe probe;
+    bool serialized;
+    std::array<const char*, 4> anchors;
+};
+
+constexpr std::array<FeatureRoute, 16> kFeatureRoutes = {{
+    {"health", FeatureHandler::Health, FeatureProbe::None, false, {}},
+    {"probe_capabilities", FeatureHandler::CapabilityProbe, FeatureProbe::None, false, {}},
+    {"freeze_timer", FeatureHandler::GlobalToggle, FeatureProbe::Anchor, true, {"game_timer_freeze", "freeze_timer"}},
+    {"toggle_fog_reveal", FeatureHandler::GlobalToggle, FeatureProbe::Anchor, true, {"fog_reveal", "toggle_fog_reveal"}},
+    {"toggle_ai", FeatureHandler::GlobalToggle, FeatureProbe::Anchor, true, {"ai_enabled", "toggle_ai"}},
+    {"set_unit_cap", FeatureHandler::BuildPatch, FeatureProbe::Anchor, true, {"unit_cap", "set_unit_cap"}},
+    {"toggle_instant_build_patch", FeatureHandler::BuildPatch, FeatureProbe::Anchor, true,
+     {"instant_build_patch_injection", "instant_build_patch", "instant_build", "toggle_instant_build_patch"}},
+    {"set_credits", FeatureHandler::Economy, FeatureProbe::Anchor, true, {"credits", "set_credits"}},
+    {"spawn_unit_helper", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"spawn_context_entity", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"spawn_tactical_entity", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"spawn_galactic_entity", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"place_planet_building", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"set_context_allegiance", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"set_hero_state_helper", FeatureHandler::Helper, FeatureProbe::Helper, false, {}},
+    {"toggle_roe_respawn_helper", FeatureHandler::Helper, FeatureProbe::Helper, false, {}}}};
+
+// Laid out by the compiler: a command is routed with one hash and one compare.
+constexpr swfoc::extender::core::PerfectHashTable kFeatureTable {kFeatureRoutes};
 
 /*
 Cppcheck note (targeted): if cppcheck runs without STL/Windows SDK include paths,
@@ -84,128 +124,122 @@ missingIncludeSystem can be suppressed per translation unit with:
   --suppress=missingIncludeSystem:native/SwfocExtender.Bridge/src/BridgeHostMain.cpp
 */
 
-bool ResolveLockCredits(std::string_view payloadJson) {
-    if (auto lockCredits = false; TryReadBool(payloadJson, "lockCredits", lockCredits)) {
+bool ResolveLockCredits(const JsonObjectView& payload) {
+    if (auto lockCredits = false; payload.tryReadBool("lockCredits", lockCredits)) {
         return lockCredits;
     }
 
-    if (auto legacyForce = false; TryReadBool(payloadJson, "forcePatchHook", legacyForce)) {
+    if (auto legacyForce = false; payload.tryReadBool("forcePatchHook", legacyForce)) {
         return legacyForce;
     }
 
     return false;
 }
 
-int ResolveProcessId(const BridgeCommand& command) {
+int ResolveProcessId(const BridgeCommand& command, const JsonObjectView& payload) {
     if (command.processId > 0) {
         return command.processId;
     }
 
-    if (auto payloadProcessId = 0; TryReadInt(command.payloadJson, "processId", payloadProcessId) && payloadProcessId > 0) {
+    if (auto payloadProcessId = 0; payload.tryReadInt("processId", payloadProcessId) && payloadProcessId > 0) {
         return payloadProcessId;
     }
 
     return 0;
 }
 
-StringMap ResolveAnchors(const BridgeCommand& command) {
-    auto anchors = command.resolvedAnchors;
-
-    const auto payloadAnchors = ExtractStringMap(command.payloadJson, "anchors");
-    for (const auto& [key, value] : payloadAnchors) {
-        anchors[key] = value;
-    }
+// Payload anchors win over resolved ones. merge() relinks the resolved
+// entries the payload does not name, so neither map is copied.
+StringMap ResolveAnchors(StringMap resolvedAnchors, const JsonObjectView& payload) {
+    auto anchors = payload.stringMap("anchors");
+    anchors.merge(resolvedAnchors);
 
     // S6171: use contains() instead of find() != end()
-    if (const auto legacySymbol = ExtractStringValue(command.payloadJson, "symbol"); !legacySymbol.empty() && !anchors.contains(legacySymbol)) {
+    if (const auto legacySymbol = payload.stringValue("symbol"); !legacySymbol.empty() && !anchors.contains(legacySymbol)) {
         anchors.try_emplace(legacySymbol, legacySymbol);
     }
 
     return anchors;
 }
 
-PluginRequest BuildPluginRequest(const BridgeCommand& command) {
+// A binary frame's header fields override the payload keys of the same name.
+void ApplyFixedPayload(PluginRequest& request, const BridgeFixedPayload& fixed) {
+    request.payload.lockValue = fixed.lockCredits;
+    if (fixed.hasIntValue) {
+        request.payload.intValue = fixed.intValue;
+    }
+
+    if (fixed.hasEnable) {
+        request.payload.enable = fixed.enable;
+    }
+
+    if (fixed.hasBoolValue) {
+        request.payload.boolValue = fixed.boolValue;
+    }
+}
+
+// The payload is parsed once; every field below is a lookup in its member list.
+// command.resolvedAnchors is moved into the request.
+PluginRequest BuildPluginRequest(BridgeCommand& command) {
+    const auto payload = JsonObjectView::Parse(command.payloadJson);
     PluginRequest request {};
     request.identity.featureId = command.featureId;
     request.identity.profileId = command.profileId;
-    request.identity.processId = ResolveProcessId(command);
-    request.anchors = ResolveAnchors(command);
-    request.payload.lockValue = ResolveLockCredits(command.payloadJson);
-    request.helperBridge.helperHookId = ExtractStringValue(command.payloadJson, "helperHookId");
-    request.helperBridge.helperEntryPoint = ExtractStringValue(command.payloadJson, "helperEntryPoint");
-    request.helperBridge.helperScript = ExtractStringValue(command.payloadJson, "helperScript");
-    request.helperBridge.operationKind = ExtractStringValue(command.payloadJson, "operationKind");
-    request.helperBridge.operationToken = ExtractStringValue(command.payloadJson, "operationToken");
-    request.helperBridge.invocationContractVersion = ExtractStringValue(command.payloadJson, "helperInvocationContractVersion");
-    request.entityContext.unitId = ExtractStringValue(command.payloadJson, "unitId");
-    request.entityContext.entityId = ExtractStringValue(command.payloadJson, "entityId");
-    request.entityContext.entryMarker = ExtractStringValue(command.payloadJson, "entryMarker");
-    request.entityContext.faction = ExtractStringValue(command.payloadJson, "faction");
-    request.entityContext.targetFaction = ExtractStringValue(command.payloadJson, "targetFaction");
-    request.entityContext.sourceFaction = ExtractStringValue(command.payloadJson, "sourceFaction");
-    request.entityContext.globalKey = ExtractStringValue(command.payloadJson, "globalKey");
-    request.entityContext.populationPolicy = ExtractStringValue(command.payloadJson, "populationPolicy");
-    request.entityContext.persistencePolicy = ExtractStringValue(command.payloadJson, "persistencePolicy");
-    request.entityContext.placementMode = ExtractStringValue(command.payloadJson, "placementMode");
-    request.entityContext.worldPosition = ExtractStringValue(command.payloadJson, "worldPosition");
-
-    if (auto intValue = 0; TryReadInt(command.payloadJson, "intValue", intValue)) {
+    request.identity.processId = ResolveProcessId(command, payload);
+    request.anchors = ResolveAnchors(std::move(command.resolvedAnchors), payload);
+    request.payload.lockValue = ResolveLockCredits(payload);
+    request.helperBridge.helperHookId = payload.stringValue("helperHookId");
+    request.helperBridge.helperEntryPoint = payload.stringValue("helperEntryPoint");
+    request.helperBridge.helperScript = payload.stringValue("helperScript");
+    request.helperBridge.operationKind = payload.stringValue("operationKind");
+    request.helperBridge.operationToken = payload.stringValue("operationToken");
+    request.helperBridge.invocationContractVersion = payload.stringValue("helperInvocationContractVersion");
+    request.helperBridge.helperPreparedId = payload.stringValue("helperPreparedId");
+    request.entityContext.unitId = payload.stringValue("unitId");
+    request.entityContext.entityId = payload.stringValue("entityId");
+    request.entityContext.entryMarker = payload.stringValue("entryMarker");
+    request.entityContext.faction = payload.stringValue("faction");
+    request.entityContext.targetFaction = payload.stringValue("targetFaction");
+    request.entityContext.sourceFaction = payload.stringValue("sourceFaction");
+    request.entityContext.globalKey = payload.stringValue("globalKey");
+    request.entityContext.populationPolicy = payload.stringValue("populationPolicy");
+    request.entityContext.persistencePolicy = payload.stringValue("persistencePolicy");
+    request.entityContext.placementMode = payload.stringValue("placementMode");
+    request.entityContext.worldPosition = payload.stringValue("worldPosition");
+
+    if (auto intValue = 0; payload.tryReadInt("intValue", intValue)) {
         request.payload.intValue = intValue;
     }
 
-    if (auto boolValue = false; TryReadBool(command.payloadJson, "boolValue", boolValue)) {
+    if (auto boolValue = false; payload.tryReadBool("boolValue", boolValue)) {
         request.payload.boolValue = boolValue;
     }
 
-    if (auto enable = false; TryReadBool(command.payloadJson, "enable", enable)) {
+    if (auto enable = false; payload.tryReadBool("enable", enable)) {
         request.payload.enable = enable;
     } else if (command.featureId == "set_unit_cap" || command.featureId == "toggle_instant_build_patch") {
         request.payload.enable = true;
     }
 
-    if (auto allowCrossFaction = false; TryReadBool(command.payloadJson, "allowCrossFaction", allowCrossFaction)) {
+    if (auto allowCrossFaction = false; payload.tryReadBool("allowCrossFaction", allowCrossFaction)) {
         request.payload.allowCrossFaction = allowCrossFaction;
     }
 
-    if (auto forceOverride = false; TryReadBool(command.payloadJson, "forceOverride", forceOverride)) {
+    if (auto forceOverride = false; payload.tryReadBool("forceOverride", forceOverride)) {
         request.payload.forceOverride = forceOverride;
     }
 
-    return request;
-}
-
-// S5566: use ranges algorithm instead of manual loop
-bool IsSupportedFeature(std::string_view featureId) {
-    return std::ranges::any_of(kSupportedFeatures, [&](const char* supported) {
-        return featureId == supported;
-    });
-}
+    if (command.fixedPayload.has_value()) {
+        ApplyFixedPayload(request, *command.fixedPayload);
+    }
 
-bool IsGlobalToggleFeature(std::string_view featureId) {
-    return featureId == "freeze_timer" ||
-           featureId == "toggle_fog_reveal" ||
-           featureId == "toggle_ai";
-}
-
-bool IsHelperFeature(std::string_view featureId) {
-    constexpr std::array<const char*, 8> kHelperFeatures = {
-        "spawn_unit_helper",
-        "spawn_context_entity",
-        "spawn_tactical_entity",
-        "spawn_galactic_entity",
-        "place_planet_building",
-        "set_context_allegiance",
-        "set_hero_state_helper",
-        "toggle_roe_respawn_helper"};
-    return std::ranges::any_of(kHelperFeatures, [&](const char* f) {
-        return featureId == f;
-    });
+    return request;
 }
 
 void EnsureCapabilityEntries(CapabilitySnapshot& snapshot) {
-    for (const auto* featureId : kSupportedFeatures) {
+    for (const auto& route : kFeatureTable.entries()) {
         // S6171: use contains()
-        if (snapshot.features.contains(featureId)) {
+        if (route.probe == FeatureProbe::None || snapshot.features.contains(route.key)) {
             continue;
         }
 
@@ -213,7 +247,7 @@ void EnsureCapabilityEntries(CapabilitySnapshot& snapshot) {
         state.available = false;
         state.state = "Unknown";
         state.reasonCode = "CAPABILITY_REQUIRED_MISSING";
-        snapshot.features.try_emplace(featureId, state);
+        snapshot.features.try_emplace(std::string(route.key), state);
     }
 }
 
@@ -273,7 +307,7 @@ AnchorProbeResult ProbeCandidate(
 
 AnchorProbeResult ProbeReadableAnchor(
     const PluginRequest& probeContext,
-    std::initializer_list<const char*> candidates) {
+    const std::array<const char*, 4>& candidates) {
     AnchorProbeResult result {};
     if (probeContext.processId() <= 0) {
         result.reasonCode = "CAPABILITY_REQUIRED_MISSING";
@@ -282,6 +316,10 @@ AnchorProbeResult ProbeReadableAnchor(
     }
 
     for (const auto* candidate : candidates) {
+        if (candidate == nullptr) {
+            break;
+        }
+
         const auto it = probeContext.anchors.find(candidate);
         if (it == probeContext.anchors.end() || it->second.empty()) {
             continue;
@@ -312,17 +350,17 @@ CapabilityState BuildProbeState(const AnchorProbeResult& probe) {
 void AddProbeFeature(
     CapabilitySnapshot& snapshot,
     const PluginRequest& probeContext,
-    const char* featureId,
-    std::initializer_list<const char*> anchorCandidates) {
+    std::string_view featureId,
+    const std::array<const char*, 4>& anchorCandidates) {
     const auto probe = ProbeReadableAnchor(probeContext, anchorCandidates);
     // S6030: try_emplace
-    snapshot.features.try_emplace(featureId, BuildProbeState(probe));
+    snapshot.features.try_emplace(std::string(featureId), BuildProbeState(probe));
 }
 
 void AddHelperProbeFeature(
     CapabilitySnapshot& snapshot,
     const PluginRequest& probeContext,
-    const char* featureId) {
+    std::string_view featureId) {
     CapabilityState state {};
     state.available = probeContext.processId() > 0;
     state.state = state.available ? "Verified" : "Unavailable";
@@ -332,70 +370,38 @@ void AddHelperProbeFeature(
         {"processId", std::to_string(probeContext.processId())},
         {"helperBridgeState", state.available ? "ready" : "unavailable"}};
     // S6030: try_emplace
-    snapshot.features.try_emplace(featureId, state);
+    snapshot.features.try_emplace(std::string(featureId), state);
 }
 
 CapabilitySnapshot BuildCapabilityProbeSnapshot(const PluginRequest& probeContext) {
     CapabilitySnapshot snapshot {};
 
-    AddProbeFeature(snapshot, probeContext, "set_credits", {"credits", "set_credits"});
-    AddProbeFeature(snapshot, probeContext, "freeze_timer", {"game_timer_freeze", "freeze_timer"});
-    AddProbeFeature(snapshot, probeContext, "toggle_fog_reveal", {"fog_reveal", "toggle_fog_reveal"});
-    AddProbeFeature(snapshot, probeContext, "toggle_ai", {"ai_enabled", "toggle_ai"});
-    AddProbeFeature(snapshot, probeContext, "set_unit_cap", {"unit_cap", "set_unit_cap"});
-    AddProbeFeature(
-        snapshot,
-        probeContext,
-        "toggle_instant_build_patch",
-        {"instant_build_patch_injection", "instant_build_patch", "instant_build", "toggle_instant_build_patch"});
-    AddHelperProbeFeature(snapshot, probeContext, "spawn_unit_helper");
-    AddHelperProbeFeature(snapshot, probeContext, "spawn_context_entity");
-    AddHelperProbeFeature(snapshot, probeContext, "spawn_tactical_entity");
-    AddHelperProbeFeature(snapshot, probeContext, "spawn_galactic_entity");
-    AddHelperProbeFeature(snapshot, probeContext, "place_planet_building");
-    AddHelperProbeFeature(snapshot, probeContext, "set_context_allegiance");
-    AddHelperProbeFeature(snapshot, probeContext, "set_hero_state_helper");
-    AddHelperProbeFeature(snapshot, probeContext, "toggle_roe_respawn_helper");
+    for (const auto& route : kFeatureTable.entries()) {
+        if (route.probe == FeatureProbe::Anchor) {
+            AddProbeFeature(snapshot, probeContext, route.key, route.anchors);
+        } else if (route.probe == FeatureProbe::Helper) {
+            AddHelperProbeFeature(snapshot, probeContext, route.key);
+        }
+    }
 
     EnsureCapabilityEntries(snapshot);
     return snapshot;
 }
 
-void AppendDiagnosticsJson(std::ostringstream& out, const StringMap& diagnostics) {
-    out << R"(,"diagnostics":{)";
-    auto firstDiagnostic = true;
-    for (const auto& [key, value] : diagnostics) {
-        if (!firstDiagnostic) {
-            out << ',';
-        }
-        firstDiagnostic = false;
-        out << '"' << EscapeJson(key) << R"(":")" << EscapeJson(value) << '"';
-    }
-    out << '}';
-}
-
-std::string CapabilitySnapshotToJson(const CapabilitySnapshot& snapshot) {
-    std::ostringstream out;
-    out << '{';
-    auto first = true;
+void WriteCapabilitySnapshotJson(JsonWriter& writer, const CapabilitySnapshot& snapshot) {
+    writer.beginObject();
     for (const auto& [featureId, state] : snapshot.features) {
-        if (!first) {
-            out << ',';
-        }
-        first = false;
-        out
-            << '"' << EscapeJson(featureId) << R"(":{)"
-            << R"("available":)" << (state.available ? "true" : "false") << ','
-            << R"("state":")" << EscapeJson(state.state) << R"(",)"
-            << R"("reasonCode":")" << EscapeJson(state.reasonCode) << '"';
+        writer.key(featureId)
+            .beginObject()
+            .key("available").boolean(state.available)
+            .key("state").string(state.state)
+            .key("reasonCode").string(state.reasonCode);
         if (!state.diagnostics.empty()) {
-            AppendDiagnosticsJson(out, state.diagnostics);
+            writer.key("diagnostics").stringMap(state.diagnostics);
         }
-
-        out << '}';
+        writer.endObject();
     }
-    out << '}';
-    return out.str();
+    writer.endObject();
 }
 
 // S5566: use ranges algorithm
@@ -411,7 +417,7 @@ BridgeResult BuildBridgeResult(
     std::string_view reasonCode,
     std::string_view hookState,
     std::string_view message,
-    std::string_view diagnosticsJson) {
+    std::string diagnosticsJson) {
     BridgeResult result {};
     result.commandId = command.commandId;
     result.succeeded = succeeded;
@@ -419,7 +425,7 @@ BridgeResult BuildBridgeResult(
     result.backend = kBackendName;
     result.hookState = std::string(hookState);
     result.message = std::string(message);
-    result.diagnosticsJson = std::string(diagnosticsJson);
+    result.diagnosticsJson = std::move(diagnosticsJson);
     return result;
 }
 
@@ -427,24 +433,33 @@ BridgeResult BuildHealthResult(const BridgeCommand& command) {
     return BuildBridgeResult(command, true, "CAPABILITY_PROBE_PASS", "RUNNING", "Extender bridge is healthy.", R"({"bridge":"active"})");
 }
 
-BridgeResult BuildCapabilityProbeResult(
-    const BridgeCommand& command,
-    const EconomyPlugin&,
-    const GlobalTogglePlugin&,
-    const BuildPatchPlugin&) {
-    const auto probeContext = BuildPluginRequest(command);
-    const auto merged = BuildCapabilityProbeSnapshot(probeContext);
-
-    std::ostringstream diagnostics;
-    diagnostics
-        << "{"
-        << R"("bridge":"active",)"
-        << R"("processId":)" << probeContext.processId() << ','
-        << R"("anchorCount":)" << probeContext.anchors.size() << ','
-        << R"("capabilities":)" << CapabilitySnapshotToJson(merged)
-        << "}";
-
-    return BuildBridgeResult(command, true, "CAPABILITY_PROBE_PASS", ResolveProbeHookState(merged), "Capability probe completed.", diagnostics.str());
+// Anchor reads are answered from the cache while the process and anchor set
+// stay the same; the cache re-probes in the background between commands.
+BridgeResult BuildCapabilityProbeResult(BridgeCommand& command, ProbeSnapshotCache& probeCache) {
+    auto probeContext = BuildPluginRequest(command);
+    const auto processId = probeContext.processId();
+    const auto anchorCount = probeContext.anchors.size();
+    const ProbeCacheKey key {processId, swfoc::extender::core::HashAnchorSet(probeContext.anchors)};
+    auto cacheHit = false;
+    const auto snapshot = probeCache.get(
+        key,
+        [probeContext = std::move(probeContext)] { return BuildCapabilityProbeSnapshot(probeContext); },
+        &cacheHit);
+    const auto& merged = *snapshot;
+
+    std::string diagnostics;
+    diagnostics.reserve(kCapabilityProbeJsonReserve);
+    JsonWriter writer(diagnostics);
+    writer.beginObject()
+        .key("bridge").string("active")
+        .key("processId").number(processId)
+        .key("anchorCount").number(static_cast<std::int64_t>(anchorCount))
+        .key("probeCache").string(cacheHit ? "hit" : "miss")
+        .key("capabilities");
+    WriteCapabilitySnapshotJson(writer, merged);
+    writer.endObject();
+
+    return BuildBridgeResult(command, true, "CAPABILITY_PROBE_PASS", ResolveProbeHookState(merged), "Capability probe completed.", std::move(diagnostics));
 }
 
 BridgeResult BuildMissingIntValueResult(const BridgeCommand& command) {
@@ -455,8 +470,8 @@ BridgeResult BuildMissingIntValueResult(const BridgeCommand& command) {
 BridgeResult BuildBridgeResultFromPlugin(
     const BridgeCommand& command,
     const PluginRequest& pluginRequest,
-    const PluginResult& pluginResult) {
-    auto diagnostics = pluginResult.diagnostics;
+    PluginResult pluginResult) {
+    auto diagnostics = std::move(pluginResult.diagnostics);
 
     diagnostics["featureId"] = command.featureId;
     if (pluginRequest.processId() > 0) {
@@ -472,29 +487,58 @@ BridgeResult BuildBridgeResultFromPlugin(
     return BuildBridgeResult(command, pluginResult.succeeded, pluginResult.reasonCode, pluginResult.hookState, pluginResult.message, ToDiagnosticsJson(diagnostics));
 }
 
-BridgeResult BuildSetCreditsResult(const BridgeCommand& command, EconomyPlugin& economyPlugin) {
-    auto intValue = 0;
-    if (!TryReadInt(command.payloadJson, "intValue", intValue)) {
+// Mirrors a successful toggle into the game's overlay state block, so the
+// in-game HUD shows it without asking the pipe.
+void PublishOverlayState(OverlayState& overlayState, const PluginRequest& request, const PluginResult& result) {
+    if (!result.succeeded || request.processId() <= 0) {
+        return;
+    }
+
+    const auto featureId = request.featureId();
+    const auto processId = request.processId();
+    if (featureId == "set_credits") {
+        overlayState.publishCreditsLock(processId, request.lockValue(), request.intValue());
+    } else if (featureId == "set_unit_cap") {
+        overlayState.publishUnitCap(processId, request.enable() || request.boolValue(), request.intValue());
+    } else if (featureId == "toggle_instant_build_patch") {
+        overlayState.publishFlag(processId, swfoc::extender::overlay::kOverlayInstantBuildPatched, request.enable() || request.boolValue());
+    } else if (featureId == "freeze_timer") {
+        overlayState.publishFlag(processId, swfoc::extender::overlay::kOverlayTimerFrozen, request.boolValue());
+    } else if (featureId == "toggle_fog_reveal") {
+        overlayState.publishFlag(processId, swfoc::extender::overlay::kOverlayFogRevealed, request.boolValue());
+    } else if (featureId == "toggle_ai") {
+        overlayState.publishFlag(processId, swfoc::extender::overlay::kOverlayAiEnabled, request.boolValue());
+    }
+}
+
+BridgeResult BuildSetCreditsResult(BridgeCommand& command, EconomyPlugin& economyPlugin, OverlayState& overlayState) {
+    const auto hasFixedIntValue = command.fixedPayload.has_value() && command.fixedPayload->hasIntValue;
+    if (auto intValue = 0; !hasFixedIntValue && !JsonObjectView::Parse(command.payloadJson).tryReadInt("intValue", intValue)) {
         return BuildMissingIntValueResult(command);
     }
 
+    // BuildPluginRequest reads intValue from the frame header or the payload.
     auto pluginRequest = BuildPluginRequest(command);
-    pluginRequest.payload.intValue = intValue;
-
-    return BuildBridgeResultFromPlugin(command, pluginRequest, economyPlugin.execute(pluginRequest));
+    auto pluginResult = economyPlugin.execute(pluginRequest);
+    PublishOverlayState(overlayState, pluginRequest, pluginResult);
+    return BuildBridgeResultFromPlugin(command, pluginRequest, std::move(pluginResult));
 }
 
-BridgeResult BuildGlobalToggleResult(const BridgeCommand& command, GlobalTogglePlugin& globalTogglePlugin) {
+BridgeResult BuildGlobalToggleResult(BridgeCommand& command, GlobalTogglePlugin& globalTogglePlugin, OverlayState& overlayState) {
     auto pluginRequest = BuildPluginRequest(command);
-    return BuildBridgeResultFromPlugin(command, pluginRequest, globalTogglePlugin.execute(pluginRequest));
+    auto pluginResult = globalTogglePlugin.execute(pluginRequest);
+    PublishOverlayState(overlayState, pluginRequest, pluginResult);
+    return BuildBridgeResultFromPlugin(command, pluginRequest, std::move(pluginResult));
 }
 
-BridgeResult BuildPatchResult(const BridgeCommand& command, BuildPatchPlugin& buildPatchPlugin) {
+BridgeResult BuildPatchResult(BridgeCommand& command, BuildPatchPlugin& buildPatchPlugin, OverlayState& overlayState) {
     auto pluginRequest = BuildPluginRequest(command);
-    return BuildBridgeResultFromPlugin(command, pluginRequest, buildPatchPlugin.execute(pluginRequest));
+    auto pluginResult = buildPatchPlugin.execute(pluginRequest);
+    PublishOverlayState(overlayState, pluginRequest, pluginResult);
+    return BuildBridgeResultFromPlugin(command, pluginRequest, std::move(pluginResult));
 }
 
-BridgeResult BuildHelperResult(const BridgeCommand& command, HelperLuaPlugin& helperLuaPlugin) {
+BridgeResult BuildHelperResult(BridgeCommand& command, HelperLuaPlugin& helperLuaPlugin) {
     auto pluginRequest = BuildPluginRequest(command);
     return BuildBridgeResultFromPlugin(command, pluginRequest, helperLuaPlugin.execute(pluginRequest));
 }
@@ -506,36 +550,34 @@ BridgeResult BuildUnsupportedFeatureResult(const BridgeCommand& command) {
 }
 
 BridgeResult HandleBridgeCommand(
-    const BridgeCommand& command,
+    BridgeCommand& command,
     EconomyPlugin& economyPlugin,
     GlobalTogglePlugin& globalTogglePlugin,
     BuildPatchPlugin& buildPatchPlugin,
-    HelperLuaPlugin& helperLuaPlugin) {
-    if (command.featureId == "health") {
-        return BuildHealthResult(command);
-    }
-
-    if (command.featureId == "probe_capabilities") {
-        return BuildCapabilityProbeResult(command, economyPlugin, globalTogglePlugin, buildPatchPlugin);
-    }
-
-    if (!IsSupportedFeature(command.featureId)) {
+    HelperLuaPlugin& helperLuaPlugin,
+    ProbeSnapshotCache& probeCache,
+    OverlayState& overlayState) {
+    const auto* route = kFeatureTable.find(command.featureId);
+    if (route == nullptr) {
         return BuildUnsupportedFeatureResult(command);
     }
 
-    if (command.featureId == "set_credits") {
-        return BuildSetCreditsResult(command, economyPlugin);
-    }
-
-    if (IsGlobalToggleFeature(command.featureId)) {
-        return BuildGlobalToggleResult(command, globalTogglePlugin);
-    }
-
-    if (IsHelperFeature(command.featureId)) {
+    switch (route->handler) {
+    case FeatureHandler::Health:
+        return BuildHealthResult(command);
+    case FeatureHandler::CapabilityProbe:
+        return BuildCapabilityProbeResult(command, probeCache);
+    case FeatureHandler::Economy:
+        return BuildSetCreditsResult(command, economyPlugin, overlayState);
+    case FeatureHandler::GlobalToggle:
+        return BuildGlobalToggleResult(command, globalTogglePlugin, overlayState);
+    case FeatureHandler::Helper:
         return BuildHelperResult(command, helperLuaPlugin);
+    case FeatureHandler::BuildPatch:
+        break;
     }
 
-    return BuildPatchResult(command, buildPatchPlugin);
+    return BuildPatchResult(command, buildPatchPlugin, overlayState);
 }
 
 // S1874: replace deprecated std::getenv with MSVC-safe _dupenv_s
@@ -593,9 +635,17 @@ void ConfigureBridgeHandler(
     EconomyPlugin& economyPlugin,
     GlobalTogglePlugin& globalTogglePlugin,
     BuildPatchPlugin& buildPatchPlugin,
-    HelperLuaPlugin& helperLuaPlugin) {
-    server.setHandler([&economyPlugin, &globalTogglePlugin, &buildPatchPlugin, &helperLuaPlugin](const BridgeCommand& command) {
-        return HandleBridgeCommand(command, economyPlugin, globalTogglePlugin, buildPatchPlugin, helperLuaPlugin);
+    HelperLuaPlugin& helperLuaPlugin,
+    ProbeSnapshotCache& probeCache,
+    OverlayState& overlayState) {
+    for (const auto& route : kFeatureTable.entries()) {
+        if (route.serialized) {
+            server.serializeFeature(std::string(route.key));
+        }
+    }
+
+    server.setHandler([&economyPlugin, &globalTogglePlugin, &buildPatchPlugin, &helperLuaPlugin, &probeCache, &overlayState](BridgeCommand&& command) {
+        return HandleBridgeCommand(command, economyPlugin, globalTogglePlugin, buildPatchPlugin, helperLuaPlugin, probeCache, overlayState);
     });
 }
 
@@ -604,9 +654,11 @@ int RunBridgeHost(
     EconomyPlugin& economyPlugin,
     GlobalTogglePlugin& globalTogglePlugin,
     BuildPatchPlugin& buildPatchPlugin,
-    HelperLuaPlugin& helperLuaPlugin) {
+    HelperLuaPlugin& helperLuaPlugin,
+    ProbeSnapshotCache& probeCache,
+    OverlayState& overlayState) {
     NamedPipeBridgeServer server{std::string(pipeName)};
-    ConfigureBridgeHandler(server, economyPlugin, globalTogglePlugin, buildPatchPlugin, helperLuaPlugin);
+    ConfigureBridgeHandler(server, economyPlugin, globalTogglePlugin, buildPatchPlugin, helperLuaPlugin, probeCache, overlayState);
 
     if (!server.start()) {
         std::cerr << "Failed to start extender bridge host." << std::endl;
@@ -630,5 +682,7 @@ int main() {
     GlobalTogglePlugin globalTogglePlugin;
     BuildPatchPlugin buildPatchPlugin;
     HelperLuaPlugin helperLuaPlugin;
-    return RunBridgeHost(pipeName, economyPlugin, globalTogglePlugin, buildPatchPlugin, helperLuaPlugin);
+    ProbeSnapshotCache probeCache {kCapabilityProbeRefreshInterval};
+    OverlayState overlayState;
+    return RunBridgeHost(pipeName, economyPlugin, globalTogglePlugin, buildPatchPlugin, helperLuaPlugin, probeCache, overlayState);
 }
@@ -0,0 +1,386 @@
+// cppcheck-suppress-file missingIncludeSystem
+#include "swfoc_extender/bridge/BridgeJson.hpp"
+
+#include <array>
+#include <charconv>
+#include <system_error>
+
+namespace swfoc::extender::bridge {
+
+namespace {
+
+constexpr std::size_t kExpectedMemberCount = 16;
+constexpr std::string_view kHexDigits = "0123456789ABCDEF";
+
+bool IsJsonWhitespace(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+std::size_t SkipWhitespace(std::string_view json, std::size_t cursor) {
+    while (cursor < json.size() && IsJsonWhitespace(json[cursor])) {
+        ++cursor;
+    }
+    return cursor;
+}
+
+// Index just past the string token whose opening quote is at cursor, or npos.
+std::size_t SkipString(std::string_view json, std::size_t cursor) {
+    for (auto i = cursor + 1; i < json.size(); ++i) {
+        if (json[i] == '\\') {
+            ++i;
+        } else if (json[i] == '"') {
+            return i + 1;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Index just past the value token starting at cursor, or npos. Objects and
+// arrays are skipped whole; strings inside them may hold braces.
+std::size_t SkipValue(std::string_view json, std::size_t cursor) {
+    if (json[cursor] == '"') {
+        return SkipString(json, cursor);
+    }
+
+    if (json[cursor] == '{' || json[cursor] == '[') {
+        auto depth = 0;
+        for (auto i = cursor; i < json.size(); ++i) {
+            const auto ch = json[i];
+            if (ch == '"') {
+                i = SkipString(json, i);
+                if (i == std::string_view::npos) {
+                    return i;
+                }
+                --i;
+            } else if (ch == '{' || ch == '[') {
+                ++depth;
+            } else if ((ch == '}' || ch == ']') && --depth == 0) {
+                return i + 1;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    auto end = cursor;
+    while (end < json.size() && json[end] != ',' && json[end] != '}' && json[end] != ']') {
+        ++end;
+    }
+    while (end > cursor && IsJsonWhitespace(json[end - 1])) {
+        --end;
+    }
+    return end;
+}
+
+void AppendUtf8(std::string& out, std::uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool TryReadHex4(std::string_view text, std::size_t cursor, std::uint32_t& value) {
+    if (cursor + 4 > text.size()) {
+        return false;
+    }
+    const auto* first = text.data() + cursor;
+    const auto [last, error] = std::from_chars(first, first + 4, value, 16);
+    return error == std::errc {} && last == first + 4;
+}
+
+// Appends the \u escape at body[i] ("\uXXXX", or a surrogate pair) and
+// returns the index of its last character.
+std::size_t AppendUnicodeEscape(std::string& out, std::string_view body, std::size_t i) {
+    std::uint32_t codePoint = 0;
+    if (!TryReadHex4(body, i + 2, codePoint)) {
+        out.append(body.substr(i, 2));
+        return i + 1;
+    }
+
+    auto last = i + 5;
+    if (std::uint32_t low = 0; codePoint >= 0xD800 && codePoint < 0xDC00 && last + 3 <= body.size()
+        && body.substr(last + 1, 2) == R"(\u)"
+        && TryReadHex4(body, last + 3, low) && low >= 0xDC00 && low < 0xE000) {
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        last += 6;
+    }
+    AppendUtf8(out, codePoint);
+    return last;
+}
+
+char UnescapeSimple(char ch) {
+    switch (ch) {
+    case 'n':
+        return '\n';
+    case 'r':
+        return '\r';
+    case 't':
+        return '\t';
+    case 'b':
+        return '\b';
+    case 'f':
+        return '\f';
+    default:
+        return ch;  // \" \\ \/ and anything unknown stand for themselves
+    }
+}
+
+} // namespace
+
+JsonObjectView JsonObjectView::Parse(std::string_view json) {
+    JsonObjectView view;
+    auto cursor = SkipWhitespace(json, 0);
+    if (cursor >= json.size() || json[cursor] != '{') {
+        return view;
+    }
+
+    view.members_.reserve(kExpectedMemberCount);
+    cursor = SkipWhitespace(json, cursor + 1);
+    while (cursor < json.size() && json[cursor] == '"') {
+        const auto keyEnd = SkipString(json, cursor);
+        if (keyEnd == std::string_view::npos) {
+            break;
+        }
+
+        const auto colon = SkipWhitespace(json, keyEnd);
+        if (colon >= json.size() || json[colon] != ':') {
+            break;
+        }
+
+        const auto valueStart = SkipWhitespace(json, colon + 1);
+        if (valueStart >= json.size()) {
+            break;
+        }
+
+        const auto valueEnd = SkipValue(json, valueStart);
+        if (valueEnd == std::string_view::npos) {
+            break;
+        }
+
+        view.members_.push_back({json.substr(cursor + 1, keyEnd - cursor - 2), json.substr(valueStart, valueEnd - valueStart)});
+        cursor = SkipWhitespace(json, valueEnd);
+        if (cursor >= json.size() || json[cursor] != ',') {
+            break;
+        }
+        cursor = SkipWhitespace(json, cursor + 1);
+    }
+
+    return view;
+}
+
+std::string_view JsonObjectView::find(std::string_view key) const noexcept {
+    for (const auto& member : members_) {
+        if (member.key == key) {
+            return member.value;
+        }
+    }
+    return {};
+}
+
+std::string JsonObjectView::stringValue(std::string_view key) const {
+    return UnescapeJsonString(find(key));
+}
+
+bool JsonObjectView::tryReadInt(std::string_view key, std::int32_t& value) const {
+    const auto token = find(key);
+    if (token.empty() || token.front() == '+') {
+        return false;
+    }
+
+    std::int32_t parsed = 0;
+    const auto [last, error] = std::from_chars(token.data(), token.data() + token.size(), parsed);
+    if (error != std::errc {} || last == token.data()) {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+bool JsonObjectView::tryReadBool(std::string_view key, bool& value) const {
+    const auto token = find(key);
+    if (token == "true" || token == "false") {
+        value = token == "true";
+        return true;
+    }
+    return false;
+}
+
+std::string_view JsonObjectView::objectJson(std::string_view key) const noexcept {
+    const auto token = find(key);
+    return !token.empty() && token.front() == '{' ? token : std::string_view("{}");
+}
+
+StringMap JsonObjectView::stringMap(std::string_view key) const {
+    StringMap parsed;
+    const auto object = Parse(objectJson(key));
+    for (const auto& member : object.members()) {
+        if (member.key.empty()) {
+            continue;
+        }
+
+        const auto isString = member.value.front() == '"';
+        parsed.insert_or_assign(std::string(member.key), isString ? UnescapeJsonString(member.value) : std::string(member.value));
+    }
+    return parsed;
+}
+
+std::vector<std::string_view> JsonArrayElements(std::string_view token) {
+    std::vector<std::string_view> elements;
+    auto cursor = SkipWhitespace(token, 0);
+    if (cursor >= token.size() || token[cursor] != '[') {
+        return elements;
+    }
+
+    cursor = SkipWhitespace(token, cursor + 1);
+    while (cursor < token.size() && token[cursor] != ']') {
+        const auto end = SkipValue(token, cursor);
+        if (end == std::string_view::npos || end == cursor) {
+            break;
+        }
+
+        elements.push_back(token.substr(cursor, end - cursor));
+        cursor = SkipWhitespace(token, end);
+        if (cursor >= token.size() || token[cursor] != ',') {
+            break;
+        }
+        cursor = SkipWhitespace(token, cursor + 1);
+    }
+
+    return elements;
+}
+
+std::string UnescapeJsonString(std::string_view token) {
+    if (token.size() < 2 || token.front() != '"' || token.back() != '"') {
+        return {};
+    }
+
+    const auto body = token.substr(1, token.size() - 2);
+    std::string out;
+    out.reserve(body.size());
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        if (body[i] != '\\' || i + 1 == body.size()) {
+            out.push_back(body[i]);
+        } else if (body[i + 1] == 'u') {
+            i = AppendUnicodeEscape(out, body, i);
+        } else {
+            out.push_back(UnescapeSimple(body[++i]));
+        }
+    }
+    return out;
+}
+
+std::string EscapeJson(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size() + 8);
+    AppendEscapedJson(escaped, value);
+    return escaped;
+}
+
+void AppendEscapedJson(std::string& out, std::string_view value) {
+    std::size_t runStart = 0;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(value[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+
+        out.append(value, runStart, i - runStart);
+        runStart = i + 1;
+        switch (ch) {
+        case '\\':
+            out += R"(\\)";
+            break;
+        case '"':
+            out += R"(\")";
+            break;
+        case '\n':
+            out += R"(\n)";
+            break;
+        case '\r':
+            out += R"(\r)";
+            break;
+        case '\t':
+            out += R"(\t)";
+            break;
+        default:
+            // Other control characters are not valid raw inside a JSON string.
+            out += R"(\u00)";
+            out.push_back(kHexDigits[ch >> 4]);
+            out.push_back(kHexDigits[ch & 0x0F]);
+            break;
+        }
+    }
+    out.append(value, runStart, value.size() - runStart);
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    out_->push_back('{');
+    needsComma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    out_->push_back('}');
+    needsComma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    if (needsComma_) {
+        out_->push_back(',');
+    }
+    out_->push_back('"');
+    AppendEscapedJson(*out_, name);
+    out_->append(R"(":)");
+    needsComma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::string(std::string_view value) {
+    out_->push_back('"');
+    AppendEscapedJson(*out_, value);
+    out_->push_back('"');
+    needsComma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::boolean(bool value) {
+    out_->append(value ? "true" : "false");
+    needsComma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::number(std::int64_t value) {
+    std::array<char, 24> digits {};
+    const auto [last, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out_->append(digits.data(), error == std::errc {} ? last : digits.data());
+    needsComma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json) {
+    out_->append(json.empty() ? std::string_view("{}") : json);
+    needsComma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::stringMap(const StringMap& values) {
+    beginObject();
+    for (const auto& [name, value] : values) {
+        key(name).string(value);
+    }
+    return endObject();
+}
+
+} // namespace swfoc::extender::bridge
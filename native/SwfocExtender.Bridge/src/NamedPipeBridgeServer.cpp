@@ -1,12 +1,9 @@
 // cppcheck-suppress-file missingIncludeSystem
 #include "swfoc_extender/bridge/NamedPipeBridgeServer.hpp"
+#include "swfoc_extender/bridge/BridgeFrame.hpp"
 
 #include <array>
-#include <cctype>
 #include <chrono>
-#include <map>
-#include <sstream>
-#include <stdexcept>
 #include <string_view>
 #include <utility>
 
@@ -20,8 +17,11 @@ namespace swfoc::extender::bridge {
 namespace {
 
 constexpr auto kServerPollDelay = std::chrono::milliseconds(100);
-constexpr auto kClientWakePollDelay = std::chrono::milliseconds(25);
 constexpr std::size_t kPipeBufferSize = 16 * 1024;
+// Pre-created pipe instances (clients served at once) and completion-port
+// workers (commands handled at once).
+constexpr std::size_t kPipeInstanceCount = 4;
+constexpr std::size_t kWorkerThreadCount = 4;
 
 /*
 Cppcheck note (targeted): if cppcheck runs without STL/Windows SDK include paths,
@@ -37,290 +37,26 @@ std::string BuildFullPipeName(std::string_view pipeName) {
     return result;
 }
 
-std::string ExtractStringValue(std::string_view json, std::string_view key) {
-    auto quotedKey = std::string("\"");
-    quotedKey.append(key);
-    quotedKey.push_back('"');
-
-    const auto keyPos = json.find(quotedKey);
-    if (keyPos == std::string_view::npos) {
-        return {};
-    }
-
-    const auto colonPos = json.find(':', keyPos + quotedKey.length());
-    if (colonPos == std::string_view::npos) {
-        return {};
-    }
-
-    const auto firstQuote = json.find('"', colonPos + 1);
-    if (firstQuote == std::string_view::npos) {
-        return {};
-    }
-
-    const auto secondQuote = json.find('"', firstQuote + 1);
-    if (secondQuote == std::string_view::npos || secondQuote <= firstQuote) {
-        return {};
-    }
-
-    return std::string(json.substr(firstQuote + 1, secondQuote - firstQuote - 1));
-}
-
-std::string ExtractObjectJson(std::string_view json, std::string_view key) {
-    auto quotedKey = std::string("\"");
-    quotedKey.append(key);
-    quotedKey.push_back('"');
-
-    const auto keyPos = json.find(quotedKey);
-    if (keyPos == std::string_view::npos) {
-        return "{}";
-    }
-
-    const auto colonPos = json.find(':', keyPos + quotedKey.length());
-    if (colonPos == std::string_view::npos) {
-        return "{}";
-    }
-
-    const auto openBrace = json.find('{', colonPos + 1);
-    if (openBrace == std::string_view::npos) {
-        return "{}";
-    }
-
-    auto depth = 0;
-    for (auto i = openBrace; i < json.size(); ++i) {
-        if (json[i] == '{') {
-            ++depth;
-        } else if (json[i] == '}') {
-            --depth;
-            if (depth == 0) {
-                return std::string(json.substr(openBrace, i - openBrace + 1));
-            }
-        }
-    }
-
-    return "{}";
-}
-
-bool TryFindValueStart(std::string_view json, std::string_view key, std::size_t& start) {
-    auto quotedKey = std::string("\"");
-    quotedKey.append(key);
-    quotedKey.push_back('"');
-
-    const auto keyPos = json.find(quotedKey);
-    if (keyPos == std::string_view::npos) {
-        return false;
-    }
-
-    const auto colonPos = json.find(':', keyPos + quotedKey.size());
-    if (colonPos == std::string_view::npos) {
-        return false;
-    }
-
-    start = json.find_first_not_of(" \t\r\n", colonPos + 1);
-    return start != std::string_view::npos;
-}
-
-bool TryReadInt(std::string_view json, std::string_view key, std::int32_t& value) {
-    std::size_t start = 0;
-    if (!TryFindValueStart(json, key, start)) {
-        return false;
-    }
-
-    if (json[start] == '+') {
-        return false;
-    }
-
-    try {
-        std::size_t consumed = 0;
-        const auto parsed = std::stoi(std::string(json.substr(start)), &consumed);
-        if (consumed == 0) {
-            return false;
-        }
-
-        value = parsed;
-        return true;
-    } catch (const std::invalid_argument&) {
-        return false;
-    } catch (const std::out_of_range&) {
-        return false;
-    }
-}
-
-std::size_t FindUnescapedQuote(std::string_view value, std::size_t start) {
-    auto escaped = false;
-    for (auto i = start; i < value.size(); ++i) {
-        if (escaped) {
-            escaped = false;
-            continue;
-        }
-
-        if (value[i] == '\\') {
-            escaped = true;
-            continue;
-        }
-
-        if (value[i] == '"') {
-            return i;
-        }
-    }
-
-    return std::string_view::npos;
-}
-
-std::string TrimAsciiWhitespace(std::string_view value) {
-    auto first = value.begin();
-    while (first != value.end() && std::isspace(static_cast<unsigned char>(*first)) != 0) {
-        ++first;
-    }
-
-    auto last = value.end();
-    while (last != first && std::isspace(static_cast<unsigned char>(*(last - 1))) != 0) {
-        --last;
-    }
-
-    return {first, last};
-}
-
-std::size_t SkipAsciiWhitespace(std::string_view value, std::size_t cursor) {
-    return value.find_first_not_of(" \t\r\n", cursor);
-}
-
-bool TryParseFlatStringMapEntryKey(std::string_view objectJson, std::size_t& cursor, std::string& key);
-bool TryParseFlatStringMapEntryValue(std::string_view objectJson, std::size_t& cursor, std::string& value);
-
-bool TryParseFlatStringMapEntry(
-    std::string_view objectJson,
-    std::size_t& cursor,
-    std::string& key,
-    std::string& value) {
-    cursor = SkipAsciiWhitespace(objectJson, cursor);
-    if (cursor == std::string_view::npos || objectJson[cursor] == '}') {
-        return false;
-    }
-
-    if (!TryParseFlatStringMapEntryKey(objectJson, cursor, key)) {
-        return false;
-    }
-
-    if (!TryParseFlatStringMapEntryValue(objectJson, cursor, value)) {
-        return false;
-    }
-
-    cursor = SkipAsciiWhitespace(objectJson, cursor);
-    if (cursor != std::string_view::npos && objectJson[cursor] == ',') {
-        ++cursor;
-    }
-
-    return true;
-}
-
-bool TryParseFlatStringMapEntryKey(std::string_view objectJson, std::size_t& cursor, std::string& key) {
-    if (objectJson[cursor] != '"') {
-        return false;
-    }
-
-    const auto keyEnd = FindUnescapedQuote(objectJson, cursor + 1);
-    if (keyEnd == std::string_view::npos) {
-        return false;
-    }
-
-    key = std::string(objectJson.substr(cursor + 1, keyEnd - cursor - 1));
-    cursor = objectJson.find(':', keyEnd + 1);
-    if (cursor == std::string_view::npos) {
-        return false;
-    }
-
-    ++cursor;
-    cursor = SkipAsciiWhitespace(objectJson, cursor);
-    return cursor != std::string_view::npos;
-}
-
-bool TryParseFlatStringMapEntryValue(std::string_view objectJson, std::size_t& cursor, std::string& value) {
-    if (objectJson[cursor] == '"') {
-        const auto valueEnd = FindUnescapedQuote(objectJson, cursor + 1);
-        if (valueEnd == std::string_view::npos) {
-            return false;
-        }
-
-        value = std::string(objectJson.substr(cursor + 1, valueEnd - cursor - 1));
-        cursor = valueEnd + 1;
-    } else {
-        auto tokenEnd = cursor;
-        while (tokenEnd < objectJson.size() && objectJson[tokenEnd] != ',' && objectJson[tokenEnd] != '}') {
-            ++tokenEnd;
-        }
-
-        value = TrimAsciiWhitespace(objectJson.substr(cursor, tokenEnd - cursor));
-        cursor = tokenEnd;
-    }
-
-    return true;
-}
-
-StringMap ParseFlatStringMapObject(std::string_view objectJson) {
-    StringMap parsed;
-    auto cursor = objectJson.find('{');
-    if (cursor == std::string_view::npos) {
-        return parsed;
-    }
-
-    ++cursor;
-    std::string key;
-    std::string value;
-    while (TryParseFlatStringMapEntry(objectJson, cursor, key, value)) {
-        if (!key.empty()) {
-            parsed[key] = value;
-        }
-    }
-
-    return parsed;
-}
-
-StringMap ExtractStringMap(std::string_view json, std::string_view key) {
-    const auto objectJson = ExtractObjectJson(json, key);
-    return ParseFlatStringMapObject(objectJson);
-}
-
-std::string EscapeJson(std::string_view value) {
-    std::string escaped;
-    escaped.reserve(value.size() + 8);
-    for (const auto ch : value) {
-        switch (ch) {
-        case '\\':
-            escaped += R"(\\)";
-            break;
-        case '"':
-            escaped += R"(\")";
-            break;
-        case '\n':
-            escaped += R"(\n)";
-            break;
-        case '\r':
-            escaped += R"(\r)";
-            break;
-        case '\t':
-            escaped += R"(\t)";
-            break;
-        default:
-            escaped.push_back(ch);
-            break;
-        }
+// Replaces out with the response, keeping its capacity: a JSON line (newline
+// included) or a binary result frame.
+void WriteResponse(std::string& out, const BridgeResult& result, BridgeFraming framing) {
+    out.clear();
+    if (framing == BridgeFraming::Binary) {
+        EncodeBinaryResult(out, result);
+        return;
     }
 
-    return escaped;
-}
-
-std::string ToJsonLine(const BridgeResult& result) {
-    std::ostringstream out;
-    out << '{';
-    out << R"("commandId":")" << EscapeJson(result.commandId) << R"(",)";
-    out << R"("succeeded":)" << (result.succeeded ? "true" : "false") << ',';
-    out << R"("reasonCode":")" << EscapeJson(result.reasonCode) << R"(",)";
-    out << R"("backend":")" << EscapeJson(result.backend) << R"(",)";
-    out << R"("hookState":")" << EscapeJson(result.hookState) << R"(",)";
-    out << R"("message":")" << EscapeJson(result.message) << R"(",)";
-    out << R"("diagnostics":)" << (result.diagnosticsJson.empty() ? "{}" : result.diagnosticsJson);
-    out << '}';
-    return out.str();
+    JsonWriter(out)
+        .beginObject()
+        .key("commandId").string(result.commandId)
+        .key("succeeded").boolean(result.succeeded)
+        .key("reasonCode").string(result.reasonCode)
+        .key("backend").string(result.backend)
+        .key("hookState").string(result.hookState)
+        .key("message").string(result.message)
+        .key("diagnostics").raw(result.diagnosticsJson)
+        .endObject();
+    out.push_back('\n');
 }
 
 BridgeResult BuildBridgeFailureResult(
@@ -343,7 +79,7 @@ BridgeResult BuildBridgeFailureResult(
 HANDLE CreateBridgePipe(const std::string& fullPipeName) {
     return CreateNamedPipeA(
         fullPipeName.c_str(),
-        PIPE_ACCESS_DUPLEX,
+        PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
         PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
         PIPE_UNLIMITED_INSTANCES,
         kPipeBufferSize,
@@ -352,93 +88,165 @@ HANDLE CreateBridgePipe(const std::string& fullPipeName) {
         nullptr);
 }
 
-bool TryConnectClient(HANDLE pipe) {
-    if (ConnectNamedPipe(pipe, nullptr)) {
+// True once commandLine holds a whole command and sets framing. A binary
+// frame is whole once its declared length has arrived (the decoder rejects
+// one that is cut short or oversized); a JSON command is everything up to
+// its first newline, or the whole pipe message, line ending stripped.
+bool TakeCommandLine(std::string& commandLine, bool messageComplete, BridgeFraming& framing) {
+    if (IsBinaryFrame(commandLine)) {
+        framing = BridgeFraming::Binary;
+        const auto frameLength = BinaryFrameLength(commandLine);
+        if (frameLength == 0 || frameLength > kMaxBinaryFrameLength || commandLine.size() < frameLength) {
+            return messageComplete || frameLength > kMaxBinaryFrameLength;
+        }
+
+        commandLine.resize(frameLength);
         return true;
     }
-    return GetLastError() == ERROR_PIPE_CONNECTED;
-}
 
-bool TryCreateConnectedPipe(const std::string& fullPipeName, HANDLE& pipe) {
-    pipe = CreateBridgePipe(fullPipeName);
-    if (pipe == INVALID_HANDLE_VALUE) {
-        std::this_thread::sleep_for(kServerPollDelay);
+    framing = BridgeFraming::JsonLine;
+    if (const auto linePos = commandLine.find('\n'); linePos != std::string::npos) {
+        commandLine.erase(linePos);
+    } else if (!messageComplete) {
         return false;
     }
 
-    if (!TryConnectClient(pipe)) {
-        CloseHandle(pipe);
-        return false;
+    while (!commandLine.empty() && (commandLine.back() == '\r' || commandLine.back() == '\n')) {
+        commandLine.pop_back();
     }
 
     return true;
 }
+#endif
 
-bool ShouldContinueReading(std::string& commandLine, DWORD bytesRead, std::size_t bufferSize) {
-    if (const auto linePos = commandLine.find('\n'); linePos != std::string::npos) {
-        commandLine.erase(linePos);
-        return false;
-    }
-    return bytesRead >= bufferSize;
-}
+} // namespace
 
-std::string ReadCommandLine(HANDLE pipe, std::array<char, kPipeBufferSize>& buffer) {
+#if defined(_WIN32)
+// One pre-created pipe instance, registered with the completion port under
+// its own address. It has at most one overlapped operation outstanding, so
+// only the worker that dequeues that operation's completion touches it.
+struct NamedPipeBridgeServer::PipeInstance {
+    enum class State { Connecting, Reading, Writing };
+
+    OVERLAPPED overlapped {};
+    HANDLE pipe {INVALID_HANDLE_VALUE};
+    State state {State::Connecting};
+    std::array<char, kPipeBufferSize> buffer {};
     std::string commandLine;
-    DWORD bytesRead = 0;
-    while (ReadFile(pipe, buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, nullptr) != FALSE && bytesRead > 0) {
-        commandLine.append(buffer.data(), bytesRead);
-        if (!ShouldContinueReading(commandLine, bytesRead, buffer.size())) {
-            break;
+    BridgeFraming framing {BridgeFraming::JsonLine};
+    std::string response;
+
+    // (Re)creates the pipe and waits for a client.
+    bool open(const std::string& fullPipeName, HANDLE completionPort) {
+        if (pipe != INVALID_HANDLE_VALUE) {
+            CloseHandle(pipe);
         }
-    }
 
-    while (!commandLine.empty() && (commandLine.back() == '\r' || commandLine.back() == '\n')) {
-        commandLine.pop_back();
+        pipe = CreateBridgePipe(fullPipeName);
+        if (pipe == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        if (CreateIoCompletionPort(pipe, completionPort, reinterpret_cast<ULONG_PTR>(this), 0) == nullptr) {
+            CloseHandle(pipe);
+            pipe = INVALID_HANDLE_VALUE;
+            return false;
+        }
+
+        return beginConnect();
     }
 
-    return commandLine;
-}
+    // Each begin* returns false when the pipe refused the operation outright,
+    // and true once a completion for it is on its way to the port.
+    bool beginConnect() {
+        state = State::Connecting;
+        commandLine.clear();
+        overlapped = {};
+        if (ConnectNamedPipe(pipe, &overlapped)) {
+            return true;
+        }
+
+        const auto error = GetLastError();
+        if (error == ERROR_PIPE_CONNECTED) {
+            return beginRead();  // the client beat us to it; no completion is queued
+        }
+        return error == ERROR_IO_PENDING;
+    }
 
-void WriteResponse(HANDLE pipe, const BridgeResult& result) {
-    auto response = ToJsonLine(result);
-    response.push_back('\n');
+    bool beginRead() {
+        state = State::Reading;
+        overlapped = {};
+        if (ReadFile(pipe, buffer.data(), static_cast<DWORD>(buffer.size()), nullptr, &overlapped)) {
+            return true;
+        }
 
-    DWORD bytesWritten = 0;
-    (void)WriteFile(pipe, response.data(), static_cast<DWORD>(response.size()), &bytesWritten, nullptr);
-    FlushFileBuffers(pipe);
-}
+        const auto error = GetLastError();
+        return error == ERROR_IO_PENDING || error == ERROR_MORE_DATA;
+    }
 
-void CloseServerPipe(HANDLE pipe) {
-    DisconnectNamedPipe(pipe);
-    CloseHandle(pipe);
-}
+    // Sends response, which the caller has filled in place.
+    bool beginWrite() {
+        state = State::Writing;
+        overlapped = {};
+        if (WriteFile(pipe, response.data(), static_cast<DWORD>(response.size()), nullptr, &overlapped)) {
+            return true;
+        }
+        return GetLastError() == ERROR_IO_PENDING;
+    }
 
-template <typename CommandHandler>
-void ProcessConnectedClient(
-    HANDLE pipe,
-    std::array<char, kPipeBufferSize>& buffer,
-    CommandHandler&& handler) {
-    const auto commandLine = ReadCommandLine(pipe, buffer);
-    WriteResponse(pipe, handler(commandLine));
-    CloseServerPipe(pipe);
-}
+    // Drops the current client and waits for the next one.
+    bool recycle() {
+        DisconnectNamedPipe(pipe);
+        return beginConnect();
+    }
+};
+#else
+struct NamedPipeBridgeServer::PipeInstance {};
 #endif
 
-} // namespace
-
 NamedPipeBridgeServer::NamedPipeBridgeServer(std::string pipeName)
     : pipeName_(std::move(pipeName)) {}
 
+NamedPipeBridgeServer::~NamedPipeBridgeServer() {
+    stop();
+}
+
 void NamedPipeBridgeServer::setHandler(Handler handler) {
     handler_ = std::move(handler);
 }
 
+void NamedPipeBridgeServer::serializeFeature(std::string featureId) {
+    featureLocks_.try_emplace(std::move(featureId), std::make_unique<std::mutex>());
+}
+
 bool NamedPipeBridgeServer::start() {
     if (running_.exchange(true)) {
         return true;
     }
 
-    worker_ = std::jthread([this]() { runLoop(); });
+#if defined(_WIN32)
+    const auto fullPipeName = BuildFullPipeName(pipeName_);
+    completionPort_ = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, static_cast<DWORD>(kWorkerThreadCount));
+    if (completionPort_ == nullptr) {
+        running_.store(false);
+        return false;
+    }
+
+    for (std::size_t i = 0; i < kPipeInstanceCount; ++i) {
+        instances_.push_back(std::make_unique<PipeInstance>());
+        if (!instances_.back()->open(fullPipeName, completionPort_)) {
+            closeInstances();
+            running_.store(false);
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < kWorkerThreadCount; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+#else
+    workers_.emplace_back([this]() { workerLoop(); });
+#endif
     return true;
 }
 
@@ -448,48 +256,59 @@ void NamedPipeBridgeServer::stop() {
     }
 
 #if defined(_WIN32)
-    const auto fullPipeName = BuildFullPipeName(pipeName_);
-    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(800);
-    while (std::chrono::steady_clock::now() < deadline) {
-        if (auto client = CreateFileA(
-                fullPipeName.c_str(),
-                GENERIC_READ | GENERIC_WRITE,
-                0,
-                nullptr,
-                OPEN_EXISTING,
-                0,
-                nullptr);
-            client != INVALID_HANDLE_VALUE) {
-            CloseHandle(client);
-            break;
-        }
-        std::this_thread::sleep_for(kClientWakePollDelay);
+    // One wake-up packet per worker; each worker exits on the first it takes.
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        PostQueuedCompletionStatus(completionPort_, 0, 0, nullptr);
     }
 #endif
 
-    // jthread auto-joins, but we request_stop + join explicitly for deterministic shutdown
-    if (worker_.joinable()) {
-        worker_.join();
+    // jthread auto-joins, but we join explicitly for deterministic shutdown
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
     }
+    workers_.clear();
+    closeInstances();
 }
 
 bool NamedPipeBridgeServer::running() const noexcept {
     return running_.load();
 }
 
-BridgeResult NamedPipeBridgeServer::handleRawCommand(std::string_view jsonLine) const {
+void NamedPipeBridgeServer::closeInstances() {
+#if defined(_WIN32)
+    for (const auto& instance : instances_) {
+        if (instance->pipe == INVALID_HANDLE_VALUE) {
+            continue;
+        }
+
+        // The kernel may still write to the OVERLAPPED until the cancelled
+        // operation completes, so wait for it before the instance goes away.
+        CancelIoEx(instance->pipe, nullptr);
+        DWORD ignored = 0;
+        (void)GetOverlappedResult(instance->pipe, &instance->overlapped, &ignored, TRUE);
+        CloseHandle(instance->pipe);
+    }
+
+    if (completionPort_ != nullptr) {
+        CloseHandle(completionPort_);
+        completionPort_ = nullptr;
+    }
+#endif
+    instances_.clear();
+}
+
+BridgeResult NamedPipeBridgeServer::handleRawCommand(std::string_view raw, BridgeFraming framing) const {
     BridgeCommand command;
-    command.commandId = ExtractStringValue(jsonLine, "commandId");
-    command.featureId = ExtractStringValue(jsonLine, "featureId");
-    command.profileId = ExtractStringValue(jsonLine, "profileId");
-    command.mode = ExtractStringValue(jsonLine, "mode");
-    command.requestedBy = ExtractStringValue(jsonLine, "requestedBy");
-    command.timestampUtc = ExtractStringValue(jsonLine, "timestampUtc");
-    command.payloadJson = ExtractObjectJson(jsonLine, "payload");
-    command.processName = ExtractStringValue(jsonLine, "processName");
-    command.resolvedAnchors = ExtractStringMap(jsonLine, "resolvedAnchors");
-    if (std::int32_t processId = 0; TryReadInt(jsonLine, "processId", processId)) {
-        command.processId = processId;
+    if (framing == BridgeFraming::JsonLine) {
+        command = ParseJsonCommand(raw);
+    } else if (std::string frameError; !TryDecodeBinaryCommand(raw, command, frameError)) {
+        return BuildBridgeFailureResult(
+            {},
+            "invalid_command",
+            "Binary command frame is malformed.",
+            R"({"parseError":")" + frameError + R"("})");
     }
 
     if (command.commandId.empty()) {
@@ -508,7 +327,12 @@ BridgeResult NamedPipeBridgeServer::handleRawCommand(std::string_view jsonLine)
             R"({"handler":"missing"})");
     }
 
-    auto result = handler_(command);
+    std::unique_lock<std::mutex> featureGuard;
+    if (const auto lock = featureLocks_.find(command.featureId); lock != featureLocks_.end()) {
+        featureGuard = std::unique_lock<std::mutex>(*lock->second);
+    }
+
+    auto result = handler_(std::move(command));
     if (result.commandId.empty()) {
         result.commandId = command.commandId;
     }
@@ -520,26 +344,74 @@ BridgeResult NamedPipeBridgeServer::handleRawCommand(std::string_view jsonLine)
     return result;
 }
 
-void NamedPipeBridgeServer::runLoop() const {
+void NamedPipeBridgeServer::workerLoop() {
 #if !defined(_WIN32)
     while (running_.load()) {
         std::this_thread::sleep_for(kServerPollDelay);
     }
     return;
 #else
-    const auto fullPipeName = BuildFullPipeName(pipeName_);
-    std::array<char, kPipeBufferSize> buffer = {};
-    const auto handleCommand = [this](const std::string& commandLine) {
-        return handleRawCommand(commandLine);
-    };
+    while (true) {
+        DWORD bytesTransferred = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+        const auto dequeued = GetQueuedCompletionStatus(completionPort_, &bytesTransferred, &key, &overlapped, INFINITE);
+        const auto error = dequeued ? ERROR_SUCCESS : GetLastError();
+        if (overlapped == nullptr) {
+            return;  // stop()'s wake-up, or the port is gone
+        }
 
-    while (running_.load()) {
-        auto pipe = INVALID_HANDLE_VALUE;
-        if (!TryCreateConnectedPipe(fullPipeName, pipe)) {
-            continue;
+        if (!running_.load()) {
+            continue;  // shutting down: leave the instance for closeInstances()
         }
 
-        ProcessConnectedClient(pipe, buffer, handleCommand);
+        completeIo(*reinterpret_cast<PipeInstance*>(key), error, bytesTransferred);
+    }
+#endif
+}
+
+void NamedPipeBridgeServer::completeIo(PipeInstance& instance, std::uint32_t error, std::uint32_t bytesTransferred) {
+#if !defined(_WIN32)
+    (void)instance;
+    (void)error;
+    (void)bytesTransferred;
+#else
+    auto queued = false;
+    switch (instance.state) {
+    case PipeInstance::State::Connecting:
+        queued = error == ERROR_SUCCESS && instance.beginRead();
+        break;
+    case PipeInstance::State::Reading:
+        if (error != ERROR_SUCCESS && error != ERROR_MORE_DATA) {
+            break;
+        }
+
+        instance.commandLine.append(instance.buffer.data(), bytesTransferred);
+        if (!TakeCommandLine(instance.commandLine, error == ERROR_SUCCESS, instance.framing)) {
+            queued = instance.beginRead();
+        } else {
+            // Runs on this worker; other clients keep being served meanwhile.
+            // The instance's response buffer is reused by every client it serves.
+            WriteResponse(instance.response, handleRawCommand(instance.commandLine, instance.framing), instance.framing);
+            queued = instance.beginWrite();
+        }
+        break;
+    case PipeInstance::State::Writing:
+        if (error == ERROR_SUCCESS) {
+            FlushFileBuffers(instance.pipe);
+        }
+        break;
+    }
+
+    if (queued) {
+        return;
+    }
+
+    // One exchange per connection: done, or the client went away. Wait for
+    // the next client, recreating the pipe if it can no longer listen.
+    const auto fullPipeName = BuildFullPipeName(pipeName_);
+    while (!instance.recycle() && !instance.open(fullPipeName, completionPort_) && running_.load()) {
+        std::this_thread::sleep_for(kServerPollDelay);
     }
 #endif
 }
@@ -0,0 +1,139 @@
+// cppcheck-suppress-file missingIncludeSystem
+#include "swfoc_extender/bridge/ProfileSignatures.hpp"
+#include "swfoc_extender/bridge/BridgeJson.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <tuple>
+
+namespace swfoc::extender::bridge {
+
+namespace {
+
+// An absent addressMode is HitPlusOffset, the SignatureSpec record default.
+std::optional<core::SignatureAddressMode> ParseAddressMode(std::string_view text) {
+    if (text.empty() || text == "HitPlusOffset") {
+        return core::SignatureAddressMode::HitPlusOffset;
+    }
+
+    if (text == "ReadAbsolute32AtOffset") {
+        return core::SignatureAddressMode::ReadAbsolute32AtOffset;
+    }
+
+    if (text == "ReadRipRelative32AtOffset") {
+        return core::SignatureAddressMode::ReadRipRelative32AtOffset;
+    }
+
+    return std::nullopt;
+}
+
+bool TryReadFile(const std::filesystem::path& file, std::string& text) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+std::vector<core::SignatureSpec> ParseProfileSignatures(std::string_view profileJson) {
+    std::vector<core::SignatureSpec> specs;
+    const auto profile = JsonObjectView::Parse(profileJson);
+    for (const auto setToken : JsonArrayElements(profile.find("signatureSets"))) {
+        const auto set = JsonObjectView::Parse(setToken);
+        for (const auto signatureToken : JsonArrayElements(set.find("signatures"))) {
+            const auto signature = JsonObjectView::Parse(signatureToken);
+            const auto addressMode = ParseAddressMode(signature.stringValue("addressMode"));
+            core::SignatureSpec spec {};
+            spec.name = signature.stringValue("name");
+            spec.pattern = signature.stringValue("pattern");
+            if (spec.name.empty() || spec.pattern.empty() || !addressMode.has_value()) {
+                continue;
+            }
+
+            spec.addressMode = *addressMode;
+            if (std::int32_t offset = 0; signature.tryReadInt("offset", offset)) {
+                spec.offset = offset;
+            }
+
+            specs.push_back(std::move(spec));
+        }
+    }
+
+    return specs;
+}
+
+std::vector<core::SignatureSpec> LoadProfileSignatures(
+    const std::filesystem::path& profilesDirectory,
+    std::string_view profileId,
+    std::string& error) {
+    // Walk child to root, then emit root first.
+    std::vector<std::vector<core::SignatureSpec>> chain;
+    std::set<std::string, std::less<>> visited;
+    std::string currentId(profileId);
+    while (!currentId.empty()) {
+        if (!visited.insert(currentId).second) {
+            error = "profile inherits chain loops at " + currentId;
+            return {};
+        }
+
+        std::string text;
+        if (!TryReadFile(profilesDirectory / (currentId + ".json"), text)) {
+            error = "profile not found: " + currentId;
+            return {};
+        }
+
+        chain.push_back(ParseProfileSignatures(text));
+        currentId = JsonObjectView::Parse(text).stringValue("inherits");
+    }
+
+    std::vector<core::SignatureSpec> specs;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        std::ranges::move(*it, std::back_inserter(specs));
+    }
+    return specs;
+}
+
+std::vector<core::SignatureSpec> LoadAllProfileSignatures(
+    const std::filesystem::path& profilesDirectory,
+    std::string& error) {
+    std::error_code listError;
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(profilesDirectory, listError)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            files.push_back(entry.path());
+        }
+    }
+
+    if (listError) {
+        error = "cannot list profiles directory: " + listError.message();
+        return {};
+    }
+
+    std::ranges::sort(files);
+    std::vector<core::SignatureSpec> specs;
+    std::set<std::tuple<std::string, std::string, std::int32_t, int>> seen;
+    for (const auto& file : files) {
+        std::string text;
+        if (!TryReadFile(file, text)) {
+            error = "cannot read profile: " + file.string();
+            return {};
+        }
+
+        for (auto& spec : ParseProfileSignatures(text)) {
+            if (seen.emplace(spec.name, spec.pattern, spec.offset, static_cast<int>(spec.addressMode)).second) {
+                specs.push_back(std::move(spec));
+            }
+        }
+    }
+
+    return specs;
+}
+
+} // namespace swfoc::extender::bridge
@@ -0,0 +1,139 @@
+// cppcheck-suppress-file missingIncludeSystem
+// Resolves profile signatures against a module image dump.
+//
+//   SwfocExtender.SignatureScan <module-image> <profiles-dir>
+//       [--profile <id>] [--build-hash <64 hex digits>] [--cache-dir <dir>]
+//
+// module-image is the module as mapped in memory (sections at their RVAs),
+// the same bytes the runtime's SignatureResolver scans. Without --profile
+// every profile in profiles-dir contributes its signatures. With a build hash
+// (the SHA-256 a snapshot header stores as engine_build_hash) and a cache
+// directory, a later run for the same build and signature set skips the scan.
+//
+// Prints one JSON line per signature name; timing goes to stderr.
+#include "swfoc_extender/bridge/BridgeJson.hpp"
+#include "swfoc_extender/bridge/ProfileSignatures.hpp"
+#include "swfoc_extender/core/SignatureScanner.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+namespace core = swfoc::extender::core;
+using swfoc::extender::bridge::EscapeJson;
+
+struct ScanOptions {
+    std::string imagePath;
+    std::string profilesDirectory;
+    std::string profileId;
+    std::string cacheDirectory;
+    core::EngineBuildHash buildHash {};
+};
+
+bool TryParseBuildHash(std::string_view text, core::EngineBuildHash& hash) {
+    if (text.size() != hash.size() * 2) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < hash.size(); ++i) {
+        const auto* first = text.data() + i * 2;
+        if (const auto [last, error] = std::from_chars(first, first + 2, hash[i], 16); error != std::errc {} || last != first + 2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TryParseOptions(int argc, char** argv, ScanOptions& options) {
+    if (argc < 3) {
+        return false;
+    }
+
+    options.imagePath = argv[1];
+    options.profilesDirectory = argv[2];
+    for (auto i = 3; i + 1 < argc; i += 2) {
+        const std::string_view flag = argv[i];
+        const std::string_view value = argv[i + 1];
+        if (flag == "--profile") {
+            options.profileId = value;
+        } else if (flag == "--cache-dir") {
+            options.cacheDirectory = value;
+        } else if (flag != "--build-hash" || !TryParseBuildHash(value, options.buildHash)) {
+            return false;
+        }
+    }
+
+    return (argc - 3) % 2 == 0;
+}
+
+void PrintHit(const std::string& name, const core::SignatureHit& hit) {
+    std::cout << R"({"name":")" << EscapeJson(name) << R"(","found":)" << (hit.found ? "true" : "false");
+    if (hit.found) {
+        std::cout << R"(,"address":"0x)" << std::hex << std::uppercase << hit.address << std::dec << std::nouppercase
+                  << R"(","absolute":)" << (hit.absolute ? "true" : "false");
+    } else {
+        std::cout << R"(,"diagnostics":")" << EscapeJson(hit.diagnostics) << '"';
+    }
+    std::cout << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ScanOptions options;
+    if (!TryParseOptions(argc, argv, options)) {
+        std::cerr << "usage: SwfocExtender.SignatureScan <module-image> <profiles-dir> [--profile <id>]"
+                     " [--build-hash <64 hex digits>] [--cache-dir <dir>]\n";
+        return 2;
+    }
+
+    std::string error;
+    auto specs = options.profileId.empty()
+        ? swfoc::extender::bridge::LoadAllProfileSignatures(options.profilesDirectory, error)
+        : swfoc::extender::bridge::LoadProfileSignatures(options.profilesDirectory, options.profileId, error);
+    if (!error.empty()) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+
+    std::ifstream in(options.imagePath, std::ios::binary);
+    if (!in) {
+        std::cerr << "cannot read module image " << options.imagePath << '\n';
+        return 1;
+    }
+    const std::vector<std::uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const auto started = std::chrono::steady_clock::now();
+    const core::SignatureScanner scanner(std::move(specs));
+    auto fromCache = false;
+    const auto hits = core::ResolveSignatures(scanner, image, options.buildHash, options.cacheDirectory, &fromCache);
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started);
+
+    std::vector<std::string> names;
+    names.reserve(hits.size());
+    for (const auto& [name, hit] : hits) {
+        names.push_back(name);
+    }
+    std::ranges::sort(names);
+
+    auto found = 0;
+    for (const auto& name : names) {
+        const auto& hit = hits.find(name)->second;
+        found += hit.found ? 1 : 0;
+        PrintHit(name, hit);
+    }
+
+    std::cerr << found << '/' << names.size() << " signatures resolved from " << scanner.signatures().size()
+              << " patterns over " << image.size() << " bytes in " << elapsed.count() << " ms ("
+              << (fromCache ? "cache" : "scan") << ")\n";
+    return found == static_cast<int>(names.size()) ? 0 : 3;
+}
@@ -2,11 +2,22 @@
 // cppcheck-suppress-file unusedStructMember
 #pragma once
 
+#include "swfoc_extender/core/RcuSnapshot.hpp"
 #include "swfoc_extender/core/StringHash.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 
 /*
 Cppcheck note (targeted): if cppcheck runs without STL include paths,
@@ -28,18 +39,144 @@ struct CapabilityEntry {
     [[maybe_unused]] std::string reasonCode {"CAPABILITY_UNKNOWN"};
 };
 
+/// Safe to share between pipe workers: reads take the published map without
+/// a lock, and markAvailable() publishes an edited copy.
 class CapabilityProbe {
 public:
     using CapabilityMap = std::unordered_map<std::string, CapabilityEntry, StringHash, std::equal_to<>>;
+    using CapabilityMapPtr = RcuSnapshot<CapabilityMap>::Ptr;
 
     CapabilityProbe() = default;
 
     void markAvailable(std::string_view featureId, std::string_view reasonCode = "CAPABILITY_PROBE_PASS");
     bool isAvailable(std::string_view featureId) const;
-    const CapabilityMap& snapshot() const noexcept;
+    /// The map as of this call; later writes publish a new one.
+    CapabilityMapPtr snapshot() const noexcept;
 
 private:
-    [[maybe_unused]] CapabilityMap capabilities_;
+    [[maybe_unused]] RcuSnapshot<CapabilityMap> capabilities_;
+};
+
+/// Identifies what a capability snapshot was probed against.
+struct ProbeCacheKey {
+    std::int32_t processId {0};
+    std::uint64_t anchorSetHash {0};
+
+    bool operator==(const ProbeCacheKey&) const = default;
+};
+
+/// FNV-1a over an anchor map's (key, value) pairs in iteration order, so an
+/// ordered map hashes the same set the same way every time.
+template <typename TAnchorMap>
+std::uint64_t HashAnchorSet(const TAnchorMap& anchors) {
+    auto hash = 14695981039346656037ULL;
+    const auto mix = [&hash](std::string_view text) {
+        for (const auto ch : text) {
+            hash ^= static_cast<unsigned char>(ch);
+            hash *= 1099511628211ULL;
+        }
+        hash ^= 0xFF;
+        hash *= 1099511628211ULL;
+    };
+    for (const auto& [key, value] : anchors) {
+        mix(key);
+        mix(value);
+    }
+    return hash;
+}
+
+/// Keeps the last capability snapshot so repeated probes for the same
+/// process and anchor set are answered from memory.
+///
+/// A get() for another key (the trainer attached to a new process, or its
+/// anchors were re-resolved) probes synchronously and replaces the entry.
+/// Between requests a background thread re-runs the last probe every
+/// refreshInterval, so a cached answer is never older than that. Probes run
+/// without the lock held; a refresh that finishes after the key has moved
+/// on is dropped.
+template <typename TSnapshot>
+class CapabilitySnapshotCache {
+public:
+    using Probe = std::function<TSnapshot()>;
+    using SnapshotPtr = std::shared_ptr<const TSnapshot>;
+
+    explicit CapabilitySnapshotCache(std::chrono::milliseconds refreshInterval)
+        : refreshInterval_(refreshInterval),
+          refresher_([this](const std::stop_token& stopToken) { refreshLoop(stopToken); }) {}
+
+    CapabilitySnapshotCache(const CapabilitySnapshotCache&) = delete;
+    CapabilitySnapshotCache& operator=(const CapabilitySnapshotCache&) = delete;
+
+    /// The snapshot for key; probe runs only on a miss. cacheHit, when given,
+    /// says which it was. A refresh replaces the pointer, never the snapshot
+    /// behind it, so a caller may read it without the lock.
+    SnapshotPtr get(const ProbeCacheKey& key, Probe probe, bool* cacheHit = nullptr) {
+        {
+            std::scoped_lock lock(mutex_);
+            if (key_ == key) {
+                if (cacheHit != nullptr) {
+                    *cacheHit = true;
+                }
+                return snapshot_;
+            }
+        }
+
+        if (cacheHit != nullptr) {
+            *cacheHit = false;
+        }
+
+        auto snapshot = std::make_shared<const TSnapshot>(probe());
+        std::scoped_lock lock(mutex_);
+        key_ = key;
+        probe_ = std::move(probe);
+        snapshot_ = snapshot;
+        ++generation_;
+        changed_.notify_all();
+        return snapshot;
+    }
+
+    /// Drops the entry; the next get() probes.
+    void invalidate() {
+        std::scoped_lock lock(mutex_);
+        key_.reset();
+        probe_ = nullptr;
+        ++generation_;
+    }
+
+private:
+    void refreshLoop(const std::stop_token& stopToken) {
+        std::unique_lock lock(mutex_);
+        while (!stopToken.stop_requested()) {
+            const auto generation = generation_;
+            if (!probe_) {
+                changed_.wait(lock, stopToken, [this, generation] { return generation_ != generation; });
+                continue;
+            }
+
+            // A fresh synchronous probe restarts the interval.
+            if (changed_.wait_for(lock, stopToken, refreshInterval_, [this, generation] { return generation_ != generation; })
+                || stopToken.stop_requested()) {
+                continue;
+            }
+
+            auto probe = probe_;
+            lock.unlock();
+            auto snapshot = std::make_shared<const TSnapshot>(probe());
+            lock.lock();
+            if (generation_ == generation) {
+                snapshot_ = std::move(snapshot);
+            }
+        }
+    }
+
+    std::chrono::milliseconds refreshInterval_;
+    std::mutex mutex_;
+    std::condition_variable_any changed_;
+    std::optional<ProbeCacheKey> key_;
+    Probe probe_;
+    SnapshotPtr snapshot_;
+    std::uint64_t generation_ {0};
+    std::jthread refresher_;  // last: joined before the state it reads is destroyed
 };
 
 } // namespace swfoc::extender::core
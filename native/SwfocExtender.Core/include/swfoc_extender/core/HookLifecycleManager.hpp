@@ -2,6 +2,7 @@
 // cppcheck-suppress-file unusedStructMember
 #pragma once
 
+#include "swfoc_extender/core/RcuSnapshot.hpp"
 #include "swfoc_extender/core/StringHash.hpp"
 
 #include <string>
@@ -28,9 +29,12 @@ struct HookRecord {
     [[maybe_unused]] std::string reasonCode {"HOOK_NOT_INSTALLED"};
 };
 
+/// Safe to share between pipe workers: get() and snapshot() read the
+/// published map without a lock; each mark*() publishes an edited copy.
 class HookLifecycleManager {
 public:
     using HookMap = std::unordered_map<std::string, HookRecord, StringHash, std::equal_to<>>;
+    using HookMapPtr = RcuSnapshot<HookMap>::Ptr;
 
     HookLifecycleManager() = default;
 
@@ -38,9 +42,13 @@ public:
     void markFailed(std::string_view hookId, std::string_view reasonCode);
     void markRolledBack(std::string_view hookId);
     HookRecord get(std::string_view hookId) const;
+    /// Every hook's record as of this call.
+    HookMapPtr snapshot() const noexcept;
 
 private:
-    [[maybe_unused]] HookMap hooks_;
+    void publish(std::string_view hookId, HookRecord record);
+
+    [[maybe_unused]] RcuSnapshot<HookMap> hooks_;
 };
 
 } // namespace swfoc::extender::core
@@ -0,0 +1,78 @@
+// cppcheck-suppress-file missingIncludeSystem
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace swfoc::extender::core {
+
+/// Seeded 32-bit FNV-1a; constexpr so tables can be laid out at compile time.
+constexpr std::uint32_t SeededFnv1a(std::uint32_t seed, std::string_view text) noexcept {
+    auto hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (const auto ch : text) {
+        hash ^= static_cast<std::uint8_t>(ch);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/// Collision-free lookup over a fixed key set. The constructor searches for a
+/// seed that sends every `Entry::key` to its own slot, so a lookup is one hash
+/// and one string compare. Build it `constexpr` and the search runs in the
+/// compiler; a key set with no such seed (or a duplicate key) then fails to
+/// compile instead of failing at run time.
+template <typename Entry, std::size_t N, std::size_t Slots = 4 * N>
+class PerfectHashTable {
+    static_assert(Slots >= N && (Slots & (Slots - 1)) == 0, "Slots must be a power of two >= N");
+    static constexpr std::uint32_t kMaxSeed = 1u << 16;
+    static constexpr std::uint8_t kEmpty = 0xFF;
+    static_assert(N < kEmpty, "slot indices are 8-bit");
+
+public:
+    constexpr explicit PerfectHashTable(const std::array<Entry, N>& entries) : entries_(entries) {
+        for (std::uint32_t seed = 0; seed < kMaxSeed; ++seed) {
+            if (tryPlace(seed)) {
+                seed_ = seed;
+                return;
+            }
+        }
+
+        throw "PerfectHashTable: no collision-free seed (duplicate key?)";
+    }
+
+    /// The entry whose key equals `key`, or nullptr.
+    constexpr const Entry* find(std::string_view key) const noexcept {
+        const auto index = slots_[SeededFnv1a(seed_, key) & (Slots - 1)];
+        if (index == kEmpty || entries_[index].key != key) {
+            return nullptr;
+        }
+
+        return &entries_[index];
+    }
+
+    constexpr const std::array<Entry, N>& entries() const noexcept { return entries_; }
+    constexpr std::uint32_t seed() const noexcept { return seed_; }
+
+private:
+    constexpr bool tryPlace(std::uint32_t seed) {
+        slots_.fill(kEmpty);
+        for (std::size_t i = 0; i < N; ++i) {
+            auto& slot = slots_[SeededFnv1a(seed, entries_[i].key) & (Slots - 1)];
+            if (slot != kEmpty) {
+                return false;
+            }
+            slot = static_cast<std::uint8_t>(i);
+        }
+
+        return true;
+    }
+
+    std::array<Entry, N> entries_ {};
+    std::array<std::uint8_t, Slots> slots_ {};
+    std::uint32_t seed_ {0};
+};
+
+} // namespace swfoc::extender::core
@@ -0,0 +1,46 @@
+// cppcheck-suppress-file missingIncludeSystem
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace swfoc::extender::core {
+
+/// A value readers share without a lock: load() hands out the current
+/// immutable copy, and update() publishes an edited copy in its place.
+///
+/// Writers are serialized among themselves and never block a reader; a
+/// reader keeps whatever version it loaded alive for as long as it holds the
+/// pointer, so nothing it sees changes underneath it. Each update() copies
+/// the whole value, which suits small, read-mostly state.
+template <typename T>
+class RcuSnapshot {
+public:
+    using Ptr = std::shared_ptr<const T>;
+
+    RcuSnapshot() : current_(std::make_shared<const T>()) {}
+
+    RcuSnapshot(const RcuSnapshot&) = delete;
+    RcuSnapshot& operator=(const RcuSnapshot&) = delete;
+
+    [[nodiscard]] Ptr load() const noexcept {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    /// Runs edit(T&) on a copy of the current value and publishes it.
+    template <typename Edit>
+    void update(Edit&& edit) {
+        std::scoped_lock lock(writeMutex_);
+        auto next = std::make_shared<T>(*current_.load(std::memory_order_relaxed));
+        std::forward<Edit>(edit)(*next);
+        current_.store(std::move(next), std::memory_order_release);
+    }
+
+private:
+    std::atomic<Ptr> current_;
+    std::mutex writeMutex_;
+};
+
+} // namespace swfoc::extender::core
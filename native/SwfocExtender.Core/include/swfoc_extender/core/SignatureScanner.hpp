@@ -0,0 +1,109 @@
+// cppcheck-suppress-file missingIncludeSystem
+// cppcheck-suppress-file unusedStructMember
+#pragma once
+
+#include "swfoc_extender/core/StringHash.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Cppcheck note (targeted): if cppcheck runs without STL include paths,
+suppress only this header:
+  --suppress=missingIncludeSystem:native/SwfocExtender.Core/include/swfoc_extender/core/SignatureScanner.hpp
+*/
+
+namespace swfoc::extender::core {
+
+/// Mirrors SwfocTrainer.Core.Models.SignatureAddressMode.
+enum class SignatureAddressMode {
+    HitPlusOffset = 0,
+    ReadAbsolute32AtOffset,
+    ReadRipRelative32AtOffset
+};
+
+/// One profile signature: an AOB pattern ("8B 0D ?? ?? ...") and how the
+/// anchor address is derived from its hit.
+struct SignatureSpec {
+    std::string name;
+    std::string pattern;
+    std::int32_t offset {0};
+    SignatureAddressMode addressMode {SignatureAddressMode::HitPlusOffset};
+};
+
+struct SignatureHit {
+    [[maybe_unused]] bool found {false};
+    [[maybe_unused]] bool absolute {false};  // ReadAbsolute32AtOffset: address is not module-relative
+    [[maybe_unused]] std::uint64_t address {0};  // module-relative unless absolute
+    [[maybe_unused]] std::string diagnostics;
+};
+
+using SignatureHits = std::unordered_map<std::string, SignatureHit, StringHash, std::equal_to<>>;
+using EngineBuildHash = std::array<std::uint8_t, 32>;
+
+/// Parses "AA ?? BB" into bytes, with -1 for a wildcard ("?" or "??").
+[[nodiscard]] bool TryParseSignaturePattern(std::string_view text, std::vector<std::int16_t>& bytes);
+
+/// Resolves a set of signatures in one pass over a module image.
+///
+/// Each pattern is filed under one of its literal bytes, preferring a byte
+/// that is rare in x64 code. The pass compares every 16-byte block of the
+/// image against all filed byte values at once (SSE2 where available) and
+/// tries only the patterns filed under a byte that matched, so the cost is
+/// one sweep no matter how many signatures the profiles carry. Each pattern
+/// reports its lowest hit, as AobScanner.FindPattern does, and the sweep
+/// stops once every pattern has one.
+///
+/// Several specs may share a name (one per game build); the first spec in
+/// order that hits answers for the name.
+class SignatureScanner {
+public:
+    explicit SignatureScanner(std::vector<SignatureSpec> signatures);
+
+    [[nodiscard]] SignatureHits scan(std::span<const std::uint8_t> image) const;
+
+    /// FNV-1a over every spec. A cache written for other specs is stale.
+    [[nodiscard]] std::uint64_t fingerprint() const noexcept;
+
+    [[nodiscard]] const std::vector<SignatureSpec>& signatures() const noexcept;
+
+private:
+    struct CompiledPattern {
+        std::vector<std::int16_t> bytes;
+        std::size_t anchorIndex {0};
+        bool valid {false};
+    };
+
+    [[nodiscard]] std::vector<std::int64_t> findFirstHits(std::span<const std::uint8_t> image) const;
+
+    std::vector<SignatureSpec> signatures_;
+    std::vector<CompiledPattern> compiled_;
+    std::array<std::vector<std::uint32_t>, 256> patternsByAnchorByte_ {};
+    std::uint64_t fingerprint_ {0};
+};
+
+/// `<directory>/<engine_build_hash as hex>.sigcache`.
+[[nodiscard]] std::filesystem::path SignatureCachePath(const std::filesystem::path& directory, const EngineBuildHash& engineBuildHash);
+
+/// False when the file is missing, malformed or written for another fingerprint.
+[[nodiscard]] bool TryLoadSignatureCache(const std::filesystem::path& file, std::uint64_t fingerprint, SignatureHits& hits);
+
+bool StoreSignatureCache(const std::filesystem::path& file, std::uint64_t fingerprint, const SignatureHits& hits);
+
+/// Cache hit for this build and signature set, else a scan that refreshes the
+/// cache. An all-zero engineBuildHash (hash unavailable) always scans and
+/// never writes, so one hash cannot stand for every build.
+[[nodiscard]] SignatureHits ResolveSignatures(
+    const SignatureScanner& scanner,
+    std::span<const std::uint8_t> image,
+    const EngineBuildHash& engineBuildHash,
+    const std::filesystem::path& cacheDirectory,
+    bool* fromCache = nullptr);
+
+} // namespace swfoc::extender::core
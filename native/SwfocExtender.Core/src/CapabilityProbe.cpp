@@ -1,5 +1,7 @@
 #include "swfoc_extender/core/CapabilityProbe.hpp"
 
+#include <utility>
+
 namespace swfoc::extender::core {
 
 void CapabilityProbe::markAvailable(std::string_view featureId, std::string_view reasonCode) {
@@ -7,16 +9,17 @@ void CapabilityProbe::markAvailable(std::string_view featureId, std::string_view
     entry.available = true;
     entry.state = CapabilityState::Verified;
     entry.reasonCode = reasonCode;
-    capabilities_[std::string{featureId}] = entry;
+    capabilities_.update([&](CapabilityMap& map) { map[std::string{featureId}] = std::move(entry); });
 }
 
 bool CapabilityProbe::isAvailable(std::string_view featureId) const {
-    const auto it = capabilities_.find(featureId);
-    return it != capabilities_.end() && it->second.available;
+    const auto map = capabilities_.load();
+    const auto it = map->find(featureId);
+    return it != map->end() && it->second.available;
 }
 
-const CapabilityProbe::CapabilityMap& CapabilityProbe::snapshot() const noexcept {
-    return capabilities_;
+CapabilityProbe::CapabilityMapPtr CapabilityProbe::snapshot() const noexcept {
+    return capabilities_.load();
 }
 
 } // namespace swfoc::extender::core
@@ -1,35 +1,46 @@
 #include "swfoc_extender/core/HookLifecycleManager.hpp"
 
+#include <utility>
+
 namespace swfoc::extender::core {
 
 void HookLifecycleManager::markInstalled(std::string_view hookId) {
     HookRecord record {};
     record.state = HookState::Installed;
     record.reasonCode = "HOOK_OK";
-    hooks_[std::string{hookId}] = record;
+    publish(hookId, std::move(record));
 }
 
 void HookLifecycleManager::markFailed(std::string_view hookId, std::string_view reasonCode) {
     HookRecord record {};
     record.state = HookState::Failed;
     record.reasonCode = reasonCode;
-    hooks_[std::string{hookId}] = record;
+    publish(hookId, std::move(record));
 }
 
 void HookLifecycleManager::markRolledBack(std::string_view hookId) {
     HookRecord record {};
     record.state = HookState::RolledBack;
     record.reasonCode = "ROLLBACK_SUCCESS";
-    hooks_[std::string{hookId}] = record;
+    publish(hookId, std::move(record));
 }
 
 HookRecord HookLifecycleManager::get(std::string_view hookId) const {
-    const auto it = hooks_.find(hookId);
-    if (it == hooks_.end()) {
+    const auto hooks = hooks_.load();
+    const auto it = hooks->find(hookId);
+    if (it == hooks->end()) {
         return HookRecord{};
     }
 
     return it->second;
 }
 
+HookLifecycleManager::HookMapPtr HookLifecycleManager::snapshot() const noexcept {
+    return hooks_.load();
+}
+
+void HookLifecycleManager::publish(std::string_view hookId, HookRecord record) {
+    hooks_.update([&](HookMap& hooks) { hooks[std::string{hookId}] = std::move(record); });
+}
+
 } // namespace swfoc::extender::core
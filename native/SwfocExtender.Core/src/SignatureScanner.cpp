@@ -0,0 +1,383 @@
+// cppcheck-suppress-file missingIncludeSystem
+#include "swfoc_extender/core/SignatureScanner.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWFOC_SIGNATURE_SCAN_SSE2 1
+#endif
+
+namespace swfoc::extender::core {
+
+namespace {
+
+constexpr std::int16_t kWildcard = -1;
+constexpr std::string_view kCacheMagic = "swfoc-signature-cache 1";
+
+// Opcode and prefix bytes that open a large share of x64 instructions. A
+// pattern filed under one of these would be tried at most positions.
+bool IsCommonCodeByte(std::uint8_t value) {
+    switch (value) {
+    case 0x00:
+    case 0x0F:
+    case 0x48:
+    case 0x89:
+    case 0x8B:
+    case 0xCC:
+    case 0xFF:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::size_t ChooseAnchorIndex(const std::vector<std::int16_t>& bytes) {
+    auto firstLiteral = bytes.size();
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        if (bytes[i] == kWildcard) {
+            continue;
+        }
+
+        if (!IsCommonCodeByte(static_cast<std::uint8_t>(bytes[i]))) {
+            return i;
+        }
+
+        firstLiteral = std::min(firstLiteral, i);
+    }
+
+    return firstLiteral;
+}
+
+bool MatchesAt(const std::vector<std::int16_t>& pattern, const std::uint8_t* at) {
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != kWildcard && at[i] != static_cast<std::uint8_t>(pattern[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// cmp byte ptr [rip+disp32], imm8 and mov byte ptr [rip+disp32], imm8 end one
+// byte after the displacement (SignatureResolverAddressing.GuessRipImmediateLength).
+std::int64_t RipImmediateLength(const std::vector<std::int16_t>& pattern) {
+    if (pattern.size() >= 2 && ((pattern[0] == 0x80 && pattern[1] == 0x3D) || (pattern[0] == 0xC6 && pattern[1] == 0x05))) {
+        return 1;
+    }
+    return 0;
+}
+
+SignatureHit ResolveHit(const SignatureSpec& spec, const std::vector<std::int16_t>& pattern, std::int64_t hit, std::span<const std::uint8_t> image) {
+    SignatureHit resolved {};
+    const auto valueIndex = hit + spec.offset;
+    if (spec.addressMode == SignatureAddressMode::HitPlusOffset) {
+        resolved.found = valueIndex >= 0;
+        resolved.address = static_cast<std::uint64_t>(valueIndex);
+        return resolved;
+    }
+
+    if (valueIndex < 0 || static_cast<std::uint64_t>(valueIndex) + sizeof(std::int32_t) > image.size()) {
+        resolved.diagnostics = "value offset out of range for " + spec.name;
+        return resolved;
+    }
+
+    if (spec.addressMode == SignatureAddressMode::ReadAbsolute32AtOffset) {
+        std::uint32_t raw = 0;
+        std::memcpy(&raw, image.data() + valueIndex, sizeof(raw));
+        resolved.found = raw != 0;
+        resolved.absolute = true;
+        resolved.address = raw;
+        if (!resolved.found) {
+            resolved.diagnostics = "decoded null absolute address for " + spec.name;
+        }
+        return resolved;
+    }
+
+    std::int32_t displacement = 0;
+    std::memcpy(&displacement, image.data() + valueIndex, sizeof(displacement));
+    const auto target = valueIndex + static_cast<std::int64_t>(sizeof(displacement)) + RipImmediateLength(pattern) + displacement;
+    resolved.found = target >= 0;
+    resolved.address = static_cast<std::uint64_t>(target);
+    if (!resolved.found) {
+        resolved.diagnostics = "RIP-relative target lies before the module for " + spec.name;
+    }
+    return resolved;
+}
+
+std::uint64_t Fnv1a(std::uint64_t hash, std::string_view text) {
+    for (const auto ch : text) {
+        hash ^= static_cast<std::uint8_t>(ch);
+        hash *= 1099511628211ULL;
+    }
+    // A separator, so ("ab","c") and ("a","bc") differ.
+    hash ^= 0xFF;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+std::string ToHex(std::uint64_t value) {
+    std::array<char, 16> digits {};
+    const auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value, 16);
+    return error == std::errc {} ? std::string(digits.data(), end) : std::string {};
+}
+
+bool TryParseHex(std::string_view text, std::uint64_t& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    return error == std::errc {} && end == text.data() + text.size();
+}
+
+} // namespace
+
+bool TryParseSignaturePattern(std::string_view text, std::vector<std::int16_t>& bytes) {
+    bytes.clear();
+    std::size_t cursor = 0;
+    while (cursor < text.size()) {
+        if (text[cursor] == ' ') {
+            ++cursor;
+            continue;
+        }
+
+        auto end = text.find(' ', cursor);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+
+        const auto token = text.substr(cursor, end - cursor);
+        cursor = end;
+        if (token == "?" || token == "??") {
+            bytes.push_back(kWildcard);
+            continue;
+        }
+
+        unsigned value = 0;
+        const auto [last, error] = std::from_chars(token.data(), token.data() + token.size(), value, 16);
+        if (error != std::errc {} || last != token.data() + token.size() || token.size() > 2) {
+            bytes.clear();
+            return false;
+        }
+        bytes.push_back(static_cast<std::int16_t>(value));
+    }
+
+    return ChooseAnchorIndex(bytes) < bytes.size();
+}
+
+SignatureScanner::SignatureScanner(std::vector<SignatureSpec> signatures)
+    : signatures_(std::move(signatures)) {
+    fingerprint_ = 14695981039346656037ULL;
+    compiled_.resize(signatures_.size());
+    for (std::size_t i = 0; i < signatures_.size(); ++i) {
+        const auto& spec = signatures_[i];
+        fingerprint_ = Fnv1a(fingerprint_, spec.name);
+        fingerprint_ = Fnv1a(fingerprint_, spec.pattern);
+        fingerprint_ = Fnv1a(fingerprint_, std::to_string(spec.offset));
+        fingerprint_ = Fnv1a(fingerprint_, std::to_string(static_cast<int>(spec.addressMode)));
+
+        auto& compiled = compiled_[i];
+        compiled.valid = TryParseSignaturePattern(spec.pattern, compiled.bytes);
+        if (!compiled.valid) {
+            continue;
+        }
+
+        compiled.anchorIndex = ChooseAnchorIndex(compiled.bytes);
+        const auto anchorByte = static_cast<std::uint8_t>(compiled.bytes[compiled.anchorIndex]);
+        patternsByAnchorByte_[anchorByte].push_back(static_cast<std::uint32_t>(i));
+    }
+}
+
+std::vector<std::int64_t> SignatureScanner::findFirstHits(std::span<const std::uint8_t> image) const {
+    std::vector<std::int64_t> hits(compiled_.size(), -1);
+    auto remaining = static_cast<std::size_t>(std::ranges::count_if(compiled_, [](const auto& pattern) { return pattern.valid; }));
+    const auto* data = image.data();
+    const auto size = image.size();
+
+    const auto tryAt = [&](std::size_t position) {
+        for (const auto index : patternsByAnchorByte_[data[position]]) {
+            const auto& pattern = compiled_[index];
+            if (hits[index] >= 0 || position < pattern.anchorIndex) {
+                continue;
+            }
+
+            const auto start = position - pattern.anchorIndex;
+            if (start + pattern.bytes.size() <= size && MatchesAt(pattern.bytes, data + start)) {
+                hits[index] = static_cast<std::int64_t>(start);
+                --remaining;
+            }
+        }
+    };
+
+    std::size_t position = 0;
+#if defined(SWFOC_SIGNATURE_SCAN_SSE2)
+    __m128i needles[256];  // a C array: std containers drop __m128i alignment attributes
+    std::size_t needleCount = 0;
+    for (std::size_t value = 0; value < patternsByAnchorByte_.size(); ++value) {
+        if (!patternsByAnchorByte_[value].empty()) {
+            needles[needleCount++] = _mm_set1_epi8(static_cast<char>(value));
+        }
+    }
+
+    for (; remaining > 0 && position + 16 <= size; position += 16) {
+        const auto block = _mm_loadu_si128(std::bit_cast<const __m128i*>(data + position));
+        auto matched = _mm_setzero_si128();
+        for (std::size_t i = 0; i < needleCount; ++i) {
+            matched = _mm_or_si128(matched, _mm_cmpeq_epi8(block, needles[i]));
+        }
+
+        for (auto mask = static_cast<unsigned>(_mm_movemask_epi8(matched)); mask != 0; mask &= mask - 1) {
+            tryAt(position + static_cast<std::size_t>(std::countr_zero(mask)));
+        }
+    }
+#endif
+
+    for (; remaining > 0 && position < size; ++position) {
+        if (!patternsByAnchorByte_[data[position]].empty()) {
+            tryAt(position);
+        }
+    }
+
+    return hits;
+}
+
+SignatureHits SignatureScanner::scan(std::span<const std::uint8_t> image) const {
+    const auto firstHits = findFirstHits(image);
+    SignatureHits hits;
+    for (std::size_t i = 0; i < signatures_.size(); ++i) {
+        const auto& spec = signatures_[i];
+        auto& entry = hits[spec.name];
+        if (entry.found) {
+            continue;
+        }
+
+        if (!compiled_[i].valid) {
+            entry.diagnostics = "invalid pattern for " + spec.name;
+        } else if (firstHits[i] < 0) {
+            entry.diagnostics = "pattern not found for " + spec.name;
+        } else {
+            entry = ResolveHit(spec, compiled_[i].bytes, firstHits[i], image);
+        }
+    }
+
+    return hits;
+}
+
+std::uint64_t SignatureScanner::fingerprint() const noexcept {
+    return fingerprint_;
+}
+
+const std::vector<SignatureSpec>& SignatureScanner::signatures() const noexcept {
+    return signatures_;
+}
+
+std::filesystem::path SignatureCachePath(const std::filesystem::path& directory, const EngineBuildHash& engineBuildHash) {
+    static constexpr std::string_view kDigits = "0123456789abcdef";
+    std::string name;
+    name.reserve(engineBuildHash.size() * 2 + 9);
+    for (const auto value : engineBuildHash) {
+        name.push_back(kDigits[value >> 4]);
+        name.push_back(kDigits[value & 0x0F]);
+    }
+
+    name += ".sigcache";
+    return directory / name;
+}
+
+bool TryLoadSignatureCache(const std::filesystem::path& file, std::uint64_t fingerprint, SignatureHits& hits) {
+    std::ifstream in(file);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kCacheMagic) {
+        return false;
+    }
+
+    if (!std::getline(in, line) || line != "fingerprint " + ToHex(fingerprint)) {
+        return false;
+    }
+
+    SignatureHits loaded;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        // <name> <found 0|1> <absolute 0|1> <address hex>
+        std::istringstream fields(line);
+        std::string name;
+        std::string found;
+        std::string absolute;
+        std::string address;
+        SignatureHit hit {};
+        if (!(fields >> name >> found >> absolute >> address) || !TryParseHex(address, hit.address)) {
+            return false;
+        }
+
+        hit.found = found == "1";
+        hit.absolute = absolute == "1";
+        if (!hit.found) {
+            hit.diagnostics = "pattern not found for " + name + " (cached)";
+        }
+        loaded.insert_or_assign(std::move(name), std::move(hit));
+    }
+
+    hits = std::move(loaded);
+    return true;
+}
+
+bool StoreSignatureCache(const std::filesystem::path& file, std::uint64_t fingerprint, const SignatureHits& hits) {
+    std::error_code error;
+    std::filesystem::create_directories(file.parent_path(), error);
+
+    // Written beside the target and renamed over it, so a reader never sees
+    // half a cache.
+    auto staging = file;
+    staging += ".tmp";
+    {
+        std::ofstream out(staging, std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+
+        out << kCacheMagic << '\n' << "fingerprint " << ToHex(fingerprint) << '\n';
+        for (const auto& [name, hit] : hits) {
+            out << name << ' ' << (hit.found ? '1' : '0') << ' ' << (hit.absolute ? '1' : '0') << ' ' << ToHex(hit.address) << '\n';
+        }
+
+        if (!out.flush()) {
+            return false;
+        }
+    }
+
+    std::filesystem::rename(staging, file, error);
+    return !error;
+}
+
+SignatureHits ResolveSignatures(
+    const SignatureScanner& scanner,
+    std::span<const std::uint8_t> image,
+    const EngineBuildHash& engineBuildHash,
+    const std::filesystem::path& cacheDirectory,
+    bool* fromCache) {
+    const auto hashKnown = std::ranges::any_of(engineBuildHash, [](const auto value) { return value != 0; });
+    const auto cacheFile = SignatureCachePath(cacheDirectory, engineBuildHash);
+    if (SignatureHits cached; hashKnown && !cacheDirectory.empty() && TryLoadSignatureCache(cacheFile, scanner.fingerprint(), cached)) {
+        if (fromCache != nullptr) {
+            *fromCache = true;
+        }
+        return cached;
+    }
+
+    if (fromCache != nullptr) {
+        *fromCache = false;
+    }
+
+    auto hits = scanner.scan(image);
+    if (hashKnown && !cacheDirectory.empty()) {
+        StoreSignatureCache(cacheFile, scanner.fingerprint(), hits);
+    }
+    return hits;
+}
+
+} // namespace swfoc::extender::core
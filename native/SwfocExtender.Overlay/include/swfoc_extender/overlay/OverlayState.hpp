@@ -1,19 +1,92 @@
+// cppcheck-suppress-file missingIncludeSystem
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
 namespace swfoc::extender::overlay {
 
+/// Shared-memory name of the block for one game process:
+/// Local\SwfocExtender_OverlayState_<pid>. The in-game overlay lives in that
+/// process, so it opens the name from its own PID.
+constexpr const char* kOverlayStateBaseName = "Local\\SwfocExtender_OverlayState";
+constexpr std::uint32_t kOverlayStateMagic = 0x4C564F58u;  // "XOVL"
+constexpr std::uint16_t kOverlayStateVersion = 1;
+
+/// Bits of OverlayStateBlock::flags / ::known.
+enum OverlayStateFlag : std::uint32_t {
+    kOverlayCreditsLocked = 0x01,       // set_credits with lockCredits
+    kOverlayTimerFrozen = 0x02,         // freeze_timer
+    kOverlayFogRevealed = 0x04,         // toggle_fog_reveal
+    kOverlayAiEnabled = 0x08,           // toggle_ai
+    kOverlayUnitCapPatched = 0x10,      // set_unit_cap
+    kOverlayInstantBuildPatched = 0x20  // toggle_instant_build_patch
+};
+
+/// The mapped block. `seq` is a seqlock: odd while the extender writes, bumped
+/// to the next even value when the fields are consistent again. A bit in
+/// `known` is set once the extender has applied that feature in this process;
+/// until then the matching `flags` bit says nothing. swfoc_overlay mirrors the
+/// offsets (overlay_extender_state.h); append fields, bump nothing.
+struct OverlayStateBlock {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t headerSize;
+    std::atomic<std::uint32_t> seq;
+    std::uint32_t flags;
+    std::uint32_t known;
+    std::int32_t lockedCredits;  // valid while kOverlayCreditsLocked
+    std::int32_t unitCap;        // valid while kOverlayUnitCapPatched
+    std::uint32_t processId;
+    std::uint64_t writes;        // publishes since the block was created
+    std::uint64_t updatedMs;     // wall clock (ms since the epoch) of the last publish
+};
+static_assert(offsetof(OverlayStateBlock, seq) == 8, "seq offset is shared with swfoc_overlay");
+static_assert(offsetof(OverlayStateBlock, processId) == 28, "processId offset is shared with swfoc_overlay");
+static_assert(offsetof(OverlayStateBlock, writes) == 32, "writes offset is shared with swfoc_overlay");
+static_assert(sizeof(OverlayStateBlock) == 48, "OverlayStateBlock size is shared with swfoc_overlay");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "seq must be lock-free to live in shared memory");
+
+/// Extender-side writer of the overlay state block, one game process at a
+/// time (reattach() moves it to another PID and starts from an empty block).
+/// Every publish is a full seqlock write, so the overlay never sees half an
+/// update. Without Win32 the block is private memory, which keeps the seqlock
+/// logic testable.
 class OverlayState {
 public:
-    void setVisible(bool visible) noexcept {
-        visible_ = visible;
-    }
+    OverlayState() = default;
+    ~OverlayState();
 
-    bool visible() const noexcept {
-        return visible_;
-    }
+    OverlayState(const OverlayState&) = delete;
+    OverlayState& operator=(const OverlayState&) = delete;
+
+    /// Points the writer at processId's block, creating it on first use.
+    /// False when the mapping cannot be created.
+    bool reattach(std::int32_t processId);
+    void detach();
+
+    /// Sets or clears one OverlayStateFlag bit and marks it known.
+    void publishFlag(std::int32_t processId, OverlayStateFlag flag, bool on);
+    void publishCreditsLock(std::int32_t processId, bool locked, std::int32_t credits);
+    void publishUnitCap(std::int32_t processId, bool patched, std::int32_t unitCap);
+
+    /// Seqlock copy of the current block. False while detached.
+    bool read(OverlayStateBlock& out) const;
+
+    /// The mapping name for processId.
+    static std::string BlockName(std::int32_t processId);
 
 private:
-    bool visible_ {false};
+    template <typename Edit>
+    void publish(std::int32_t processId, Edit&& edit);
+
+    mutable std::mutex mutex_;
+    std::int32_t processId_ {0};
+    void* mapping_ {nullptr};
+    OverlayStateBlock* block_ {nullptr};
 };
 
 } // namespace swfoc::extender::overlay
@@ -1 +1,179 @@
+// cppcheck-suppress-file missingIncludeSystem
 #include "swfoc_extender/overlay/OverlayState.hpp"
+
+#include <chrono>
+#include <new>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace swfoc::extender::overlay {
+
+namespace {
+
+std::uint64_t NowMs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void InitializeBlock(OverlayStateBlock& block, std::int32_t processId) {
+    block.seq.store(0, std::memory_order_relaxed);
+    block.flags = 0;
+    block.known = 0;
+    block.lockedCredits = 0;
+    block.unitCap = 0;
+    block.processId = static_cast<std::uint32_t>(processId);
+    block.writes = 0;
+    block.updatedMs = 0;
+    block.headerSize = static_cast<std::uint16_t>(sizeof(OverlayStateBlock));
+    block.version = kOverlayStateVersion;
+    // Readers check the magic first; it goes in last.
+    std::atomic_thread_fence(std::memory_order_release);
+    block.magic = kOverlayStateMagic;
+}
+
+} // namespace
+
+OverlayState::~OverlayState() {
+    detach();
+}
+
+std::string OverlayState::BlockName(std::int32_t processId) {
+    return std::string(kOverlayStateBaseName) + "_" + std::to_string(processId);
+}
+
+bool OverlayState::reattach(std::int32_t processId) {
+    std::scoped_lock lock(mutex_);
+    if (block_ != nullptr && processId_ == processId) {
+        return true;
+    }
+
+    if (processId <= 0) {
+        return false;
+    }
+
+#if defined(_WIN32)
+    if (mapping_ != nullptr) {
+        UnmapViewOfFile(block_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+    mapping_ = nullptr;
+    block_ = nullptr;
+
+    const auto name = BlockName(processId);
+    auto* mapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(sizeof(OverlayStateBlock)), name.c_str());
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    auto* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(OverlayStateBlock));
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mapping_ = mapping;
+    block_ = static_cast<OverlayStateBlock*>(view);
+#else
+    delete block_;
+    block_ = new (std::nothrow) OverlayStateBlock();
+    if (block_ == nullptr) {
+        return false;
+    }
+#endif
+
+    processId_ = processId;
+    InitializeBlock(*block_, processId);
+    return true;
+}
+
+void OverlayState::detach() {
+    std::scoped_lock lock(mutex_);
+#if defined(_WIN32)
+    if (block_ != nullptr) {
+        UnmapViewOfFile(block_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+#else
+    delete block_;
+#endif
+    mapping_ = nullptr;
+    block_ = nullptr;
+    processId_ = 0;
+}
+
+// Writers are serialized on mutex_; the overlay only ever reads, so the
+// seqlock needs no compare-exchange.
+template <typename Edit>
+void OverlayState::publish(std::int32_t processId, Edit&& edit) {
+    if (!reattach(processId)) {
+        return;
+    }
+
+    std::scoped_lock lock(mutex_);
+    if (block_ == nullptr) {
+        return;
+    }
+
+    auto& block = *block_;
+    const auto seq = block.seq.load(std::memory_order_relaxed);
+    block.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::forward<Edit>(edit)(block);
+    ++block.writes;
+    block.updatedMs = NowMs();
+    block.seq.store(seq + 2, std::memory_order_release);
+}
+
+void OverlayState::publishFlag(std::int32_t processId, OverlayStateFlag flag, bool on) {
+    publish(processId, [flag, on](OverlayStateBlock& block) {
+        block.flags = on ? (block.flags | flag) : (block.flags & ~static_cast<std::uint32_t>(flag));
+        block.known |= flag;
+    });
+}
+
+void OverlayState::publishCreditsLock(std::int32_t processId, bool locked, std::int32_t credits) {
+    publish(processId, [locked, credits](OverlayStateBlock& block) {
+        block.flags = locked ? (block.flags | kOverlayCreditsLocked) : (block.flags & ~kOverlayCreditsLocked);
+        block.known |= kOverlayCreditsLocked;
+        block.lockedCredits = locked ? credits : 0;
+    });
+}
+
+void OverlayState::publishUnitCap(std::int32_t processId, bool patched, std::int32_t unitCap) {
+    publish(processId, [patched, unitCap](OverlayStateBlock& block) {
+        block.flags = patched ? (block.flags | kOverlayUnitCapPatched) : (block.flags & ~kOverlayUnitCapPatched);
+        block.known |= kOverlayUnitCapPatched;
+        block.unitCap = patched ? unitCap : 0;
+    });
+}
+
+bool OverlayState::read(OverlayStateBlock& out) const {
+    std::scoped_lock lock(mutex_);
+    if (block_ == nullptr) {
+        return false;
+    }
+
+    // The lock keeps writers out, so one copy is consistent.
+    const auto& block = *block_;
+    out.magic = block.magic;
+    out.version = block.version;
+    out.headerSize = block.headerSize;
+    out.seq.store(block.seq.load(std::memory_order_acquire), std::memory_order_relaxed);
+    out.flags = block.flags;
+    out.known = block.known;
+    out.lockedCredits = block.lockedCredits;
+    out.unitCap = block.unitCap;
+    out.processId = block.processId;
+    out.writes = block.writes;
+    out.updatedMs = block.updatedMs;
+    return true;
+}
+
+} // namespace swfoc::extender::overlay
@@ -50,8 +50,6 @@ private:
 
     PluginResult ExecuteRestore(const PluginRequest& request, const AnchorMatch& resolvedAnchor, std::uintptr_t targetAddress, std::string_view restoreKey);
     PluginResult ExecuteApply(const PluginRequest& request, const AnchorMatch& resolvedAnchor, std::uintptr_t targetAddress, std::string_view restoreKey);
-    PluginResult ExecuteUnitCapApply(const PluginRequest& request, const AnchorMatch& resolvedAnchor, std::uintptr_t targetAddress, std::string_view restoreKey, std::string& writeError, process_mutation::WriteOperationDiagnostics& writeDiagnostics);
-    PluginResult ExecuteInstantBuildApply(const PluginRequest& request, const AnchorMatch& resolvedAnchor, std::uintptr_t targetAddress, std::string_view restoreKey, std::string& writeError, process_mutation::WriteOperationDiagnostics& writeDiagnostics);
 
     std::atomic<bool> unitCapPatchInstalled_ {false};
     std::atomic<bool> instantBuildPatchInstalled_ {false};
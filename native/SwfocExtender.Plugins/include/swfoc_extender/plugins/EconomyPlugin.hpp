@@ -4,7 +4,11 @@
 #include "swfoc_extender/plugins/PluginContracts.hpp"
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
 
 /*
 Cppcheck note (targeted): if cppcheck runs without STL include paths,
@@ -24,9 +28,27 @@ public:
     CapabilitySnapshot capabilitySnapshot() const;
 
 private:
+    struct LockTarget {
+        std::int32_t processId {0};
+        std::uintptr_t address {0};
+    };
+
+    void enforceLockLoop(const std::stop_token& stopToken);
+
     std::atomic<bool> hookInstalled_ {false};
     std::atomic<bool> lockEnabled_ {false};
     std::atomic<std::int32_t> lockedCreditsValue_ {0};
+    std::atomic<std::uint64_t> lockCorrections_ {0};
+
+    // Guards lockTarget_ and lockGeneration_, and is held across every
+    // credits write, so the enforcer never races a command's own write.
+    std::mutex lockMutex_;
+    std::condition_variable_any lockChanged_;
+    LockTarget lockTarget_ {};
+    std::uint64_t lockGeneration_ {0};
+
+    // Declared last: stopped and joined before the state above goes away.
+    std::jthread lockEnforcer_;
 };
 
 } // namespace swfoc::extender::plugins
@@ -3,16 +3,61 @@
 
 #include "swfoc_extender/plugins/PluginContracts.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
 namespace swfoc::extender::plugins {
 
+/// One helper invocation whose hook metadata has been validated, keyed by
+/// (helperHookId, helperScript hash, contract version). A later request may
+/// send just its id in helperPreparedId plus the per-operation fields.
+struct PreparedHelper {
+    std::string id;
+    std::string helperHookId;
+    std::string helperEntryPoint;
+    std::string helperScript;
+    std::string invocationContractVersion;
+    std::uint64_t uses {0};
+};
+
 class HelperLuaPlugin final : public IPlugin {
 public:
+    /// Prepared invocations kept; past this new ones are not stored.
+    static constexpr std::size_t kMaxPreparedHelpers = 256;
+
     HelperLuaPlugin() = default;
 
     const char* id() const noexcept override;
     PluginResult execute(const PluginRequest& request) override;
 
     CapabilitySnapshot capabilitySnapshot() const;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view sv) const noexcept {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+    using PreparedMap = std::unordered_map<std::string, PreparedHelper, StringHash, std::equal_to<>>;
+    using PreparedIdMap = std::unordered_map<std::string, std::string, StringHash, std::equal_to<>>;
+
+    /// Fills the hook metadata of a request that only names a prepared id.
+    bool ResolvePrepared(std::string_view preparedId, PluginRequest::HelperBridge& helperBridge);
+    /// The prepared id for a validated request, and whether it was cached.
+    std::string Prepare(const PluginRequest& request, bool& cacheHit);
+
+    std::mutex preparedMutex_;
+    // cppcheck-suppress unusedStructMember
+    PreparedMap preparedByKey_;
+    // cppcheck-suppress unusedStructMember
+    PreparedIdMap preparedKeyById_;
+    std::uint32_t nextPreparedId_ {0};
 };
 
 } // namespace swfoc::extender::plugins
@@ -55,6 +55,9 @@ struct PluginRequest {
         [[maybe_unused]] std::string operationKind {};
         [[maybe_unused]] std::string operationToken {};
         [[maybe_unused]] std::string invocationContractVersion {};
+        // Id of an invocation HelperLuaPlugin prepared earlier; stands in for
+        // the four fields above when they are omitted.
+        [[maybe_unused]] std::string helperPreparedId {};
 
         HelperBridge() = default;
         HelperBridge(const HelperBridge&) = default;
@@ -108,6 +111,7 @@ struct PluginRequest {
     [[nodiscard]] const std::string& operationKind() const noexcept { return helperBridge.operationKind; }
     [[nodiscard]] const std::string& operationToken() const noexcept { return helperBridge.operationToken; }
     [[nodiscard]] const std::string& invocationContractVersion() const noexcept { return helperBridge.invocationContractVersion; }
+    [[nodiscard]] const std::string& helperPreparedId() const noexcept { return helperBridge.helperPreparedId; }
 
     [[nodiscard]] const std::string& unitId() const noexcept { return entityContext.unitId; }
     [[nodiscard]] const std::string& entityId() const noexcept { return entityContext.entityId; }
@@ -1,10 +1,14 @@
 // cppcheck-suppress-file missingIncludeSystem
 #pragma once
 
+#include <algorithm>
 #include <bit>
 #include <charconv>
 #include <cstdint>
 #include <format>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <string>
 #include <string_view>
@@ -31,6 +35,23 @@ struct WriteOperationDiagnostics
     std::string restoreProtectOk {"n/a"};
 };
 
+/// One entry of a TryWritePatchBatch transaction.
+struct PatchWrite
+{
+    std::uintptr_t address {0};
+    std::span<const std::uint8_t> bytes;
+};
+
+/// What TryWritePatchBatch did with the entry at the same index.
+struct PatchWriteStatus
+{
+    bool protectOk {false};
+    bool captured {false};
+    bool written {false};
+    std::vector<std::uint8_t> originalBytes;  // the bytes the write replaced, read inside the window
+    std::string error;
+};
+
 namespace detail {
 
 /// Wraps reinterpret_cast for casting integer addresses to Win32 pointer types.
@@ -98,6 +119,127 @@ inline HANDLE OpenProcessHandle(DWORD accessMask, std::int32_t processId, std::s
     return process;
 }
 
+/// Every access the helpers below need, plus SYNCHRONIZE for the exit wait.
+constexpr DWORD kCachedProcessAccess =
+    PROCESS_VM_OPERATION | PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_QUERY_INFORMATION | SYNCHRONIZE;
+
+struct ProcessHandleEntry
+{
+    HANDLE process {nullptr};
+    HANDLE exitWait {nullptr};
+
+    ProcessHandleEntry() = default;
+    ProcessHandleEntry(const ProcessHandleEntry&) = delete;
+    ProcessHandleEntry& operator=(const ProcessHandleEntry&) = delete;
+
+    ~ProcessHandleEntry()
+    {
+        if (exitWait != nullptr)
+        {
+            // Non-blocking: this may run inside the exit callback itself.
+            UnregisterWait(exitWait);
+        }
+
+        if (process != nullptr)
+        {
+            CloseHandle(process);
+        }
+    }
+};
+
+/// A process handle held for the length of one operation. A cached entry
+/// stays open while any lease on it is alive, even after eviction.
+using ProcessHandleLease = std::shared_ptr<const ProcessHandleEntry>;
+
+/// One handle per target process, opened with kCachedProcessAccess on first
+/// use, so a credits lock tick or a patch does not pay an OpenProcess each
+/// time. A thread-pool wait on the handle evicts the entry when the process
+/// exits; until then a reused process id cannot reach the cache, because the
+/// old entry still answers for it and its operations fail against the dead
+/// process instead of touching the new one.
+class ProcessHandleCache
+{
+public:
+    ProcessHandleLease acquire(std::int32_t processId, DWORD fallbackAccess, std::string& error)
+    {
+        std::scoped_lock lock(mutex_);
+        if (const auto it = entries_.find(processId); it != entries_.end())
+        {
+            return it->second;
+        }
+
+        auto entry = std::make_shared<ProcessHandleEntry>();
+        entry->process = OpenProcess(kCachedProcessAccess, FALSE, static_cast<DWORD>(processId));
+        if (entry->process == nullptr)
+        {
+            // A caller without write or query rights still gets a one-shot
+            // handle with just the access its operation asks for.
+            entry->process = OpenProcessHandle(fallbackAccess, processId, error);
+            return entry->process == nullptr ? nullptr : entry;
+        }
+
+        // Registered under the lock, so a callback for a process that has
+        // already exited waits until the entry is in the map to remove it.
+        if (!RegisterWaitForSingleObject(
+                &entry->exitWait,
+                entry->process,
+                &ProcessHandleCache::OnProcessExit,
+                std::bit_cast<PVOID>(static_cast<std::intptr_t>(processId)),
+                INFINITE,
+                WT_EXECUTEONLYONCE))
+        {
+            entry->exitWait = nullptr;
+            return entry;
+        }
+
+        entries_.emplace(processId, entry);
+        return entry;
+    }
+
+    void evictIfExited(std::int32_t processId)
+    {
+        ProcessHandleLease evicted;
+        {
+            std::scoped_lock lock(mutex_);
+            const auto it = entries_.find(processId);
+            if (it == entries_.end() || WaitForSingleObject(it->second->process, 0) != WAIT_OBJECT_0)
+            {
+                return;
+            }
+
+            evicted = std::move(it->second);
+            entries_.erase(it);
+        }
+    }
+
+private:
+    static VOID CALLBACK OnProcessExit(PVOID context, BOOLEAN timedOut);
+
+    std::mutex mutex_;
+    std::map<std::int32_t, ProcessHandleLease> entries_;
+};
+
+inline ProcessHandleCache& SharedProcessHandles()
+{
+    static ProcessHandleCache cache;
+    return cache;
+}
+
+inline VOID CALLBACK ProcessHandleCache::OnProcessExit(PVOID context, BOOLEAN /*timedOut*/)
+{
+    SharedProcessHandles().evictIfExited(static_cast<std::int32_t>(std::bit_cast<std::intptr_t>(context)));
+}
+
+inline std::uintptr_t ProcessPageSize()
+{
+    static const auto pageSize = [] {
+        SYSTEM_INFO info {};
+        GetSystemInfo(&info);
+        return static_cast<std::uintptr_t>(info.dwPageSize);
+    }();
+    return pageSize;
+}
+
 inline bool TryReadProcessExact(HANDLE process, std::uintptr_t address, SIZE_T length, std::vector<std::uint8_t>& output, std::string& error)
 {
     output.resize(length);
@@ -214,15 +356,13 @@ inline bool TryReadBytes(
     }
 
 #if defined(_WIN32)
-    HANDLE process = detail::OpenProcessHandle(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, processId, error);
+    const auto process = detail::SharedProcessHandles().acquire(processId, PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, error);
     if (process == nullptr)
     {
         return false;
     }
 
-    const auto readOk = detail::TryReadProcessExact(process, address, length, output, error);
-    CloseHandle(process);
-    return readOk;
+    return detail::TryReadProcessExact(process->process, address, length, output, error);
 #else
     (void)processId;
     (void)address;
@@ -246,16 +386,16 @@ inline bool TryWriteBytesPatchSafe(
     }
 
 #if defined(_WIN32)
-    HANDLE process = detail::OpenProcessHandle(PROCESS_VM_OPERATION | PROCESS_VM_WRITE | PROCESS_VM_READ, processId, error);
-    if (process == nullptr)
+    const auto lease = detail::SharedProcessHandles().acquire(processId, PROCESS_VM_OPERATION | PROCESS_VM_WRITE | PROCESS_VM_READ, error);
+    if (lease == nullptr)
     {
         return false;
     }
 
+    const auto process = lease->process;
     DWORD oldProtect = 0;
     if (!detail::TryEnablePatchProtection(process, address, length, oldProtect, error))
     {
-        CloseHandle(process);
         return false;
     }
 
@@ -266,7 +406,6 @@ inline bool TryWriteBytesPatchSafe(
 
     const auto writeOk = detail::TryWriteProcessExact(process, address, bytes, length, error);
     const auto restoreOk = detail::TryRestorePatchProtection(process, address, length, oldProtect, error, diagnostics);
-    CloseHandle(process);
 
     if (!writeOk)
     {
@@ -309,15 +448,13 @@ inline bool TryWriteValue(
         return false;
     }
 
-    HANDLE process = detail::OpenProcessHandle(PROCESS_VM_OPERATION | PROCESS_VM_WRITE | PROCESS_VM_READ, processId, error);
+    const auto process = detail::SharedProcessHandles().acquire(processId, PROCESS_VM_OPERATION | PROCESS_VM_WRITE | PROCESS_VM_READ, error);
     if (process == nullptr)
     {
         return false;
     }
 
-    const auto writeOk = detail::TryWriteProcessExact(process, address, detail::value_as_bytes(value), sizeof(TValue), error);
-    CloseHandle(process);
-    return writeOk;
+    return detail::TryWriteProcessExact(process->process, address, detail::value_as_bytes(value), sizeof(TValue), error);
 #else
     (void)processId;
     (void)address;
@@ -332,4 +469,114 @@ inline bool TryWriteValue(
 #endif
 }
 
+/// Applies every write in one VirtualProtectEx window per page: each page the
+/// batch touches is made writable once, every entry on it is captured into
+/// originalBytes and written, then each page gets its own protection back.
+/// Entries are independent; one that fails leaves the others applied, and
+/// statuses says which. Returns true when every entry was written and every
+/// page restored. diagnostics sums len over the batch and reports the first
+/// page's old protection.
+inline bool TryWritePatchBatch(
+    std::int32_t processId,
+    std::span<const PatchWrite> writes,
+    std::vector<PatchWriteStatus>& statuses,
+    std::string& error,
+    WriteOperationDiagnostics* diagnostics = nullptr) {
+    statuses.assign(writes.size(), PatchWriteStatus {});
+    SIZE_T totalLength = 0;
+    for (const auto& write : writes) {
+        totalLength += write.bytes.size();
+    }
+
+    detail::SetBaseDiagnostics(diagnostics, "patch", totalLength, "false");
+    if (processId <= 0 || writes.empty()) {
+        error = "invalid process id or empty write batch";
+        return false;
+    }
+
+#if defined(_WIN32)
+    const auto lease = detail::SharedProcessHandles().acquire(processId, PROCESS_VM_OPERATION | PROCESS_VM_WRITE | PROCESS_VM_READ, error);
+    if (lease == nullptr) {
+        return false;
+    }
+
+    const auto process = lease->process;
+    const auto pageSize = detail::ProcessPageSize();
+    std::vector<std::uintptr_t> pages;
+    for (std::size_t i = 0; i < writes.size(); ++i) {
+        const auto& write = writes[i];
+        if (write.address == 0 || write.bytes.empty() || write.bytes.size() > UINTPTR_MAX - write.address) {
+            statuses[i].error = "invalid address or write length";
+            continue;
+        }
+
+        for (auto page = write.address & ~(pageSize - 1); page < write.address + write.bytes.size(); page += pageSize) {
+            pages.push_back(page);
+        }
+    }
+
+    std::ranges::sort(pages);
+    pages.erase(std::ranges::unique(pages).begin(), pages.end());
+
+    std::vector<DWORD> oldProtects(pages.size(), 0);
+    std::vector<std::uint8_t> unlocked(pages.size(), 0);
+    std::string protectError;
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        unlocked[i] = detail::TryEnablePatchProtection(process, pages[i], pageSize, oldProtects[i], protectError) ? 1 : 0;
+    }
+
+    if (diagnostics != nullptr && !pages.empty() && unlocked.front() != 0) {
+        diagnostics->oldProtect = detail::FormatProtect(oldProtects.front());
+    }
+
+    auto allWritten = true;
+    for (std::size_t i = 0; i < writes.size(); ++i) {
+        const auto& write = writes[i];
+        auto& status = statuses[i];
+        if (!status.error.empty()) {
+            allWritten = false;
+            continue;
+        }
+
+        const auto first = std::ranges::lower_bound(pages, write.address & ~(pageSize - 1)) - pages.begin();
+        const auto last = std::ranges::lower_bound(pages, write.address + write.bytes.size()) - pages.begin();
+        status.protectOk = std::all_of(unlocked.begin() + first, unlocked.begin() + last, [](auto flag) { return flag != 0; });
+        if (!status.protectOk) {
+            status.error = protectError;
+        } else if (detail::TryReadProcessExact(process, write.address, write.bytes.size(), status.originalBytes, status.error)) {
+            status.captured = true;
+            status.written = detail::TryWriteProcessExact(process, write.address, write.bytes.data(), write.bytes.size(), status.error);
+        }
+
+        allWritten = allWritten && status.written;
+    }
+
+    auto restoreOk = true;
+    for (std::size_t i = 0; i < pages.size(); ++i) {
+        if (unlocked[i] != 0) {
+            restoreOk = detail::TryRestorePatchProtection(process, pages[i], pageSize, oldProtects[i], protectError, nullptr) && restoreOk;
+        }
+    }
+
+    if (diagnostics != nullptr) {
+        diagnostics->restoreProtectOk = restoreOk ? "true" : "false";
+    }
+
+    if (!restoreOk) {
+        error = protectError;
+    } else if (!allWritten) {
+        error = "one or more batch writes failed";
+    }
+
+    return allWritten && restoreOk;
+#else
+    for (auto& status : statuses) {
+        status.error = "process mutation is only supported on Windows hosts";
+    }
+
+    error = "process mutation is only supported on Windows hosts";
+    return false;
+#endif
+}
+
 } // namespace swfoc::extender::plugins::process_mutation
@@ -12,6 +12,8 @@
 // cppcheck-suppress missingIncludeSystem
 #include <optional>
 // cppcheck-suppress missingIncludeSystem
+#include <span>
+// cppcheck-suppress missingIncludeSystem
 #include <string>
 // cppcheck-suppress missingIncludeSystem
 #include <string_view>
@@ -284,90 +286,49 @@ PluginResult BuildPatchPlugin::ExecuteRestore(
         .diagnostics = writeDiagnostics});
 }
 
+// The original bytes are captured inside the same protection window as the
+// write, so the restore snapshot is exactly what the patch replaced.
 PluginResult BuildPatchPlugin::ExecuteApply(
     const PluginRequest& request,
     const AnchorMatch& resolvedAnchor,
     std::uintptr_t targetAddress,
     std::string_view restoreKey) {
     const auto isUnitCap = request.featureId() == "set_unit_cap";
-    const auto writeLength = isUnitCap ? sizeof(std::int32_t) : sizeof(std::uint8_t);
-
-    std::vector<std::uint8_t> originalBytes;
-    std::string readError;
-    if (!process_mutation::TryReadBytes(
-            request.processId(),
-            targetAddress,
-            writeLength,
-            originalBytes,
-            readError)) {
-        return BuildReadFailureResult(request, resolvedAnchor, readError, "capture_original");
-    }
-
-    StoreRestoreBytes(restoreKey, std::move(originalBytes));
+    const auto clamped = std::clamp(request.intValue(), kMinUnitCap, kMaxUnitCap);
+    const auto enabledByte = static_cast<std::uint8_t>(1);
+    const auto patchBytes = isUnitCap
+        ? std::span<const std::uint8_t>(process_mutation::detail::value_as_bytes(clamped), sizeof(clamped))
+        : std::span<const std::uint8_t>(&enabledByte, sizeof(enabledByte));
+    const std::array writes {process_mutation::PatchWrite {targetAddress, patchBytes}};
 
+    std::vector<process_mutation::PatchWriteStatus> statuses;
     std::string writeError;
     process_mutation::WriteOperationDiagnostics writeDiagnostics {};
-    if (isUnitCap) {
-        return ExecuteUnitCapApply(request, resolvedAnchor, targetAddress, restoreKey, writeError, writeDiagnostics);
+    const auto applied = process_mutation::TryWritePatchBatch(request.processId(), writes, statuses, writeError, &writeDiagnostics);
+    auto& status = statuses.front();
+    if (status.protectOk && !status.captured) {
+        return BuildReadFailureResult(request, resolvedAnchor, status.error, "capture_original");
     }
 
-    return ExecuteInstantBuildApply(request, resolvedAnchor, targetAddress, restoreKey, writeError, writeDiagnostics);
-}
-
-PluginResult BuildPatchPlugin::ExecuteUnitCapApply(
-    const PluginRequest& request,
-    const AnchorMatch& resolvedAnchor,
-    std::uintptr_t targetAddress,
-    std::string_view restoreKey,
-    std::string& writeError,
-    process_mutation::WriteOperationDiagnostics& writeDiagnostics) {
-    const auto clamped = std::clamp(request.intValue(), kMinUnitCap, kMaxUnitCap);
-    if (!process_mutation::TryWriteValue<std::int32_t>(
-            request.processId(),
-            targetAddress,
-            clamped,
-            writeError,
-            process_mutation::WriteMutationMode::Patch,
-            &writeDiagnostics)) {
-        return BuildWriteFailureResult(request, resolvedAnchor, true, writeError, writeDiagnostics);
+    if (status.captured) {
+        StoreRestoreBytes(std::string(restoreKey), std::move(status.originalBytes));
     }
 
-    ApplyUnitCapState(true, request.intValue());
-    return BuildMutationSuccessResult({
-        .request = request,
-        .resolvedAnchor = resolvedAnchor,
-        .enablePatch = true,
-        .appliedValue = clamped,
-        .reasonCode = "CAPABILITY_PROBE_PASS",
-        .message = "Build patch value applied through extender plugin.",
-        .operation = "apply",
-        .restoreKey = restoreKey,
-        .diagnostics = writeDiagnostics});
-}
+    if (!applied) {
+        return BuildWriteFailureResult(request, resolvedAnchor, true, status.error.empty() ? writeError : status.error, writeDiagnostics);
+    }
 
-PluginResult BuildPatchPlugin::ExecuteInstantBuildApply(
-    const PluginRequest& request,
-    const AnchorMatch& resolvedAnchor,
-    std::uintptr_t targetAddress,
-    std::string_view restoreKey,
-    std::string& writeError,
-    process_mutation::WriteOperationDiagnostics& writeDiagnostics) {
-    if (const auto enabledByte = static_cast<std::uint8_t>(1); !process_mutation::TryWriteValue<std::uint8_t>(
-            request.processId(),
-            targetAddress,
-            enabledByte,
-            writeError,
-            process_mutation::WriteMutationMode::Patch,
-            &writeDiagnostics)) {
-        return BuildWriteFailureResult(request, resolvedAnchor, true, writeError, writeDiagnostics);
+    if (isUnitCap) {
+        ApplyUnitCapState(true, request.intValue());
+    } else {
+        ApplyInstantBuildState(true);
     }
 
-    ApplyInstantBuildState(true);
     return BuildMutationSuccessResult({
         .request = request,
         .resolvedAnchor = resolvedAnchor,
         .enablePatch = true,
-        .appliedValue = 1,
+        .appliedValue = isUnitCap ? clamped : 1,
         .reasonCode = "CAPABILITY_PROBE_PASS",
         .message = "Build patch value applied through extender plugin.",
         .operation = "apply",
@@ -2,9 +2,13 @@
 #include "swfoc_extender/plugins/EconomyPlugin.hpp"
 #include "swfoc_extender/plugins/ProcessMutationHelpers.hpp"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstring>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 namespace swfoc::extender::plugins {
 
@@ -14,6 +18,38 @@ using AnchorMatch = std::pair<std::string, std::string>;
 
 constexpr std::array<std::string_view, 2> kCreditsAnchors = {"credits", "set_credits"};
 
+// Lock polling backs off while the value holds and tightens when the game
+// keeps spending, so a steady lock costs a read every half second.
+constexpr auto kLockMinInterval = std::chrono::milliseconds(8);
+constexpr auto kLockInitialInterval = std::chrono::milliseconds(50);
+constexpr auto kLockMaxInterval = std::chrono::milliseconds(500);
+
+enum class LockCheck {
+    Held,
+    Corrected,
+    Lost
+};
+
+// Reads the locked credits and writes them back only when they have drifted.
+// Lost means the process can no longer be read or written.
+LockCheck EnforceCreditsLock(std::int32_t processId, std::uintptr_t address, std::int32_t lockedValue) {
+    std::vector<std::uint8_t> current;
+    std::string error;
+    if (!process_mutation::TryReadBytes(processId, address, sizeof(lockedValue), current, error)) {
+        return LockCheck::Lost;
+    }
+
+    std::int32_t observed = 0;
+    std::memcpy(&observed, current.data(), sizeof(observed));
+    if (observed == lockedValue) {
+        return LockCheck::Held;
+    }
+
+    return process_mutation::TryWriteValue<std::int32_t>(processId, address, lockedValue, error)
+        ? LockCheck::Corrected
+        : LockCheck::Lost;
+}
+
 std::optional<AnchorMatch> FindCreditsAnchor(const PluginRequest& request) {
     for (const auto& key : kCreditsAnchors) {
         const auto it = request.anchors.find(key);
@@ -134,6 +170,7 @@ PluginResult EconomyPlugin::execute(const PluginRequest& request) {
         return BuildInvalidAnchorResult(request, *resolvedAnchor);
     }
 
+    std::scoped_lock guard(lockMutex_);
     if (std::string writeError; !process_mutation::TryWriteValue<std::int32_t>(
             request.processId(),
             targetAddress,
@@ -144,7 +181,60 @@ PluginResult EconomyPlugin::execute(const PluginRequest& request) {
 
     lockEnabled_.store(request.lockValue());
     lockedCreditsValue_.store(request.intValue());
-    return BuildMutationSuccessResult(request, *resolvedAnchor, request.intValue());
+    lockTarget_ = LockTarget {request.processId(), targetAddress};
+    ++lockGeneration_;
+    if (request.lockValue() && !lockEnforcer_.joinable()) {
+        lockEnforcer_ = std::jthread([this](const std::stop_token& stopToken) { enforceLockLoop(stopToken); });
+    }
+
+    lockChanged_.notify_all();
+    auto result = BuildMutationSuccessResult(request, *resolvedAnchor, request.intValue());
+    if (request.lockValue()) {
+        result.diagnostics["lockEnforcement"] = "background";
+        result.diagnostics["lockCorrections"] = std::to_string(lockCorrections_.load());
+    }
+
+    return result;
+}
+
+// Runs on lockEnforcer_ for the life of the plugin once a lock has been set.
+// Every set_credits command bumps lockGeneration_, which restarts the
+// cadence; a lock the process no longer honours is dropped until the next
+// command arms it again.
+void EconomyPlugin::enforceLockLoop(const std::stop_token& stopToken) {
+    auto interval = std::chrono::milliseconds(kLockInitialInterval);
+    std::unique_lock lock(lockMutex_);
+    while (!stopToken.stop_requested()) {
+        const auto generation = lockGeneration_;
+        const auto commandArrived = [this, generation] { return lockGeneration_ != generation; };
+        if (!lockEnabled_.load()) {
+            lockChanged_.wait(lock, stopToken, commandArrived);
+            interval = kLockInitialInterval;
+            continue;
+        }
+
+        if (lockChanged_.wait_for(lock, stopToken, interval, commandArrived)) {
+            interval = kLockInitialInterval;
+            continue;
+        }
+
+        if (stopToken.stop_requested()) {
+            break;
+        }
+
+        switch (EnforceCreditsLock(lockTarget_.processId, lockTarget_.address, lockedCreditsValue_.load())) {
+        case LockCheck::Held:
+            interval = std::min(interval * 2, std::chrono::milliseconds(kLockMaxInterval));
+            break;
+        case LockCheck::Corrected:
+            lockCorrections_.fetch_add(1);
+            interval = std::max(interval / 4, std::chrono::milliseconds(kLockMinInterval));
+            break;
+        case LockCheck::Lost:
+            lockEnabled_.store(false);
+            break;
+        }
+    }
 }
 
 CapabilitySnapshot EconomyPlugin::capabilitySnapshot() const {
@@ -2,9 +2,11 @@
 #include "swfoc_extender/plugins/HelperLuaPlugin.hpp"
 
 #include <array>
+#include <cstdint>
 #include <format>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace swfoc::extender::plugins {
 
@@ -258,6 +260,25 @@ bool ValidateRequest(const PluginRequest& request, PluginResult& failure) {
            ValidateHeroStateRequest(request, failure);
 }
 
+// FNV-1a, so the key does not carry the whole script text.
+std::uint64_t HashScript(std::string_view script) {
+    auto hash = 14695981039346656037ULL;
+    for (const auto ch : script) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string BuildPreparedKey(const PluginRequest& request) {
+    return std::format(
+        "{}|{:016x}|{}", request.helperHookId(), HashScript(request.helperScript()), request.invocationContractVersion());
+}
+
+bool NamesPreparedHelperOnly(const PluginRequest& request) {
+    return HasValue(request.helperPreparedId()) && !HasValue(request.helperHookId()) && !HasValue(request.helperEntryPoint());
+}
+
 CapabilityState BuildAvailableCapability() {
     CapabilityState state {};
     state.available = true;
@@ -272,12 +293,83 @@ const char* HelperLuaPlugin::id() const noexcept {
     return "helper_lua";
 }
 
+// A request naming only helperPreparedId runs with the metadata it was
+// prepared from; any other request is validated as sent and prepared (or
+// found prepared) once it passes.
 PluginResult HelperLuaPlugin::execute(const PluginRequest& request) {
-    if (PluginResult failure {}; !ValidateRequest(request, failure)) {
+    const PluginRequest* effective = &request;
+    PluginRequest resolved;
+    const auto byId = NamesPreparedHelperOnly(request);
+    if (byId) {
+        resolved = request;
+        if (!ResolvePrepared(request.helperPreparedId(), resolved.helperBridge)) {
+            return BuildFailure(
+                request,
+                "HELPER_ENTRYPOINT_NOT_FOUND",
+                "Prepared helper id is unknown; resend the full helper metadata.",
+                {{"helperPreparedId", request.helperPreparedId()}});
+        }
+        effective = &resolved;
+    }
+
+    if (PluginResult failure {}; !ValidateRequest(*effective, failure)) {
         return failure;
     }
 
-    return BuildSuccess(request);
+    auto cacheHit = false;
+    const auto preparedId = byId ? request.helperPreparedId() : Prepare(*effective, cacheHit);
+    auto result = BuildSuccess(*effective);
+    if (!preparedId.empty()) {
+        result.diagnostics["helperPreparedId"] = preparedId;
+    }
+    result.diagnostics["helperPrepareCache"] = byId ? "by_id" : (cacheHit ? "hit" : (preparedId.empty() ? "full" : "miss"));
+    return result;
+}
+
+bool HelperLuaPlugin::ResolvePrepared(std::string_view preparedId, PluginRequest::HelperBridge& helperBridge) {
+    std::scoped_lock lock(preparedMutex_);
+    const auto key = preparedKeyById_.find(preparedId);
+    if (key == preparedKeyById_.end()) {
+        return false;
+    }
+
+    auto& prepared = preparedByKey_.find(key->second)->second;
+    ++prepared.uses;
+    helperBridge.helperHookId = prepared.helperHookId;
+    helperBridge.helperEntryPoint = prepared.helperEntryPoint;
+    helperBridge.helperScript = prepared.helperScript;
+    helperBridge.invocationContractVersion = prepared.invocationContractVersion;
+    return true;
+}
+
+std::string HelperLuaPlugin::Prepare(const PluginRequest& request, bool& cacheHit) {
+    auto key = BuildPreparedKey(request);
+    std::scoped_lock lock(preparedMutex_);
+    if (const auto it = preparedByKey_.find(key); it != preparedByKey_.end()) {
+        // Same hook, script and contract under another entry point: the
+        // newer one wins.
+        it->second.helperEntryPoint = request.helperEntryPoint();
+        ++it->second.uses;
+        cacheHit = true;
+        return it->second.id;
+    }
+
+    cacheHit = false;
+    if (preparedByKey_.size() >= kMaxPreparedHelpers) {
+        return {};
+    }
+
+    PreparedHelper prepared {};
+    prepared.id = std::format("hp{}", ++nextPreparedId_);
+    prepared.helperHookId = request.helperHookId();
+    prepared.helperEntryPoint = request.helperEntryPoint();
+    prepared.helperScript = request.helperScript();
+    prepared.invocationContractVersion = request.invocationContractVersion();
+    prepared.uses = 1;
+    preparedKeyById_.try_emplace(prepared.id, key);
+    auto id = prepared.id;
+    preparedByKey_.try_emplace(std::move(key), std::move(prepared));
+    return id;
 }
 
 CapabilitySnapshot HelperLuaPlugin::capabilitySnapshot() const {
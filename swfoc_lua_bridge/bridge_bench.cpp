@@ -0,0 +1,586 @@
+// bridge_bench.cpp -- throughput microbenchmarks for lua_bridge.cpp.
+//
+// test_harness.cpp checks that the bridge is right; this measures how fast
+// it is, so a change to a hot helper can be compared before and after and
+// tracked across releases. It includes lua_bridge.cpp itself rather than
+// harness mirrors, wires the fn_* pointers to the fake_lua.cpp stub VM (as
+// WireFakes does) and points g_base at a synthetic game image in process
+// memory, so every case runs the real helper code:
+//
+//   dostring          DoString round-trip against the stub VM
+//   walk_tactical     WalkAllTacticalObjects over 100 .. 10000 list nodes
+//                     (the walk stops at kMaxTacticalObjects)
+//   enumerate_units   Lua_EnumerateUnits CSV, index cached / rebuilt per call
+//   walk_planets      WalkGalacticPlanets over a galactic list, 1 node in 8
+//                     a planet; list_planets adds the Lua_ListPlanets CSV
+//   type_census       GetTypeCensus (walk + bucket + name hash) over 1000 /
+//                     10000 objects of 16 types
+//   type_exists       Lua_BatchTypeExists of 512 names, answers cached /
+//                     re-probed through Find_Object_Type every call
+//   write_event       WriteEvent into the shared event ring, 16 B payload
+//   dump_state        Lua_DumpState of the synthetic image, raw and lz4
+//   safe_append_fmt   SafeAppendFmt of one EnumerateUnits-shaped row
+//   crc32             Crc32_Update over 64 KiB (items = bytes)
+//
+// Each case runs kSamples timed samples of at least kSampleMs after one
+// warm-up sample, and reports the median and best ns/op. Not a pass/fail
+// test.
+//
+// Build + run via build_bridge_bench.bat.
+//
+// Usage:
+//   bridge_bench.exe [--format text|jsonl|csv] [--out <path>] [--filter <name>]
+//
+// jsonl and csv print one record per case with stable field names
+// (bench, n, samples, iters, ns_op, ns_op_min, items); that output is the
+// one to keep across releases.
+
+#include "lua_bridge.cpp"
+
+#include "fake_lua.h"
+#include "replay_state.h"
+#include "replay_tick.h"
+
+#include <chrono>
+
+// LuaBridge_Init is never called; these only satisfy the link.
+bool Proxy_Init() { return true; }
+void Proxy_Shutdown() {}
+int  Proxy_ExportStatus(char*, size_t) { return 0; }
+
+#define LS(fakePtr) reinterpret_cast<lua_State*>(fakePtr)
+
+static void BenchWireFakes() {
+    fn_pushstring   = reinterpret_cast<pfn_lua_pushstring>(&fake_pushstring);
+    fn_pushcclosure = reinterpret_cast<pfn_lua_pushcclosure>(&fake_pushcclosure);
+    fn_settop       = reinterpret_cast<pfn_lua_settop>(&fake_settop);
+    fn_tonumber     = reinterpret_cast<pfn_lua_tonumber>(&fake_tonumber);
+    fn_tostring     = reinterpret_cast<pfn_lua_tostring>(&fake_tostring);
+    fn_type         = reinterpret_cast<pfn_lua_type>(&fake_type);
+    fn_newtable     = reinterpret_cast<pfn_lua_newtable>(&fake_newtable);
+    fn_settable     = reinterpret_cast<pfn_lua_settable>(&fake_settable);
+    fn_gettable     = reinterpret_cast<pfn_lua_gettable>(&fake_gettable);
+    fn_rawseti      = reinterpret_cast<pfn_lua_rawseti>(&fake_rawseti);
+    fn_pushnumber   = reinterpret_cast<pfn_lua_pushnumber>(&fake_pushnumber);
+    fn_pushboolean  = reinterpret_cast<pfn_lua_pushboolean>(&fake_pushboolean);
+    fn_pushnil      = reinterpret_cast<pfn_lua_pushnil>(&fake_pushnil);
+    fn_gettop       = reinterpret_cast<pfn_lua_gettop>(&fake_gettop);
+    fn_pcall        = reinterpret_cast<pfn_lua_pcall>(&fake_pcall);
+    fn_load         = reinterpret_cast<pfn_lua_load>(&fake_load);
+}
+
+// ======================================================================
+// Synthetic game image
+// ======================================================================
+
+static uint8_t* g_benchImage = nullptr;
+static constexpr size_t kBenchImageSize = 32 * 1024 * 1024;
+
+static constexpr uintptr_t kPlayerArrayOff = 0x200000;
+static constexpr uintptr_t kPlayerBaseOff  = 0x300000;
+static constexpr uintptr_t kPlayerStride   = 0x1000;
+static constexpr uintptr_t kModeOff        = 0x380000;  // game-mode object
+static constexpr uintptr_t kInnerOff       = 0x381000;  // tactical list owner
+static constexpr uintptr_t kNodesOff       = 0x400000;  // 0x20 per node
+static constexpr uintptr_t kObjsOff        = 0x800000;  // 0x400 per object
+static constexpr uintptr_t kPacksOff       = 0x1200000; // 0x300 per planet data pack
+static constexpr uintptr_t kPlanetTypeOff  = 0x1300000; // one shared planet type
+static constexpr uintptr_t kUnitTypesOff   = 0x1310000; // 0x200 per census type
+static constexpr int       kBenchPlayers   = 4;
+static constexpr int       kBenchMaxUnits  = 10000;
+
+template <typename T>
+static void BenchPut(uintptr_t off, T v) {
+    memcpy(g_benchImage + off, &v, sizeof(v));
+}
+
+static void BenchSetupPlayers() {
+    for (int slot = 0; slot < kBenchPlayers; slot++) {
+        const uintptr_t off = kPlayerBaseOff + slot * kPlayerStride;
+        BenchPut<int32_t>(off + RVA::PlayerObj::SlotIndex, slot);
+        BenchPut<uint8_t>(off + RVA::PlayerObj::LocalPlayer, slot == 1 ? 1 : 0);
+        BenchPut<float>(off + RVA::PlayerObj::Credits, 5000.0f + slot);
+        BenchPut<float>(off + RVA::PlayerObj::MaxCredits, 100000.0f);
+        BenchPut<int32_t>(off + RVA::PlayerObj::TechLevel, 3);
+        BenchPut<int32_t>(off + RVA::PlayerObj::MaxTechLevel, 5);
+        const char* faction = slot == 1 ? "EMPIRE" : "REBEL";
+        memcpy(g_benchImage + off + 0xF0, faction, strlen(faction) + 1);
+        BenchPut<uint64_t>(off + RVA::PlayerObj::FactionName, (uint64_t)(g_base + off + 0xF0));
+        BenchPut<uint64_t>(kPlayerArrayOff + slot * 8, (uint64_t)(g_base + off));
+    }
+    BenchPut<uint64_t>(RVA::PlayerArray_Global, (uint64_t)(g_base + kPlayerArrayOff));
+    BenchPut<int32_t>(RVA::PlayerCount_Global, kBenchPlayers);
+}
+
+// Lays out an n-node tactical object list (the shape WalkAllTacticalObjects
+// follows) with one root unit per node, owners round-robin over the players.
+static void BenchSetupTacticalList(int n) {
+    BenchPut<uint64_t>(RVA::GameModeRoot_Global, (uint64_t)(g_base + kModeOff));
+    BenchPut<uint64_t>(kModeOff + RVA::Selection::kModeRootIndirection, (uint64_t)(g_base + kInnerOff));
+    const uintptr_t sentinel = g_base + kInnerOff + RVA::Selection::kObjectListSentinel;
+    BenchPut<uint64_t>(kInnerOff + RVA::Selection::kObjectListHead,
+                       n > 0 ? (uint64_t)(g_base + kNodesOff) : (uint64_t)sentinel);
+    for (int i = 0; i < n; i++) {
+        const uintptr_t node = kNodesOff + (uintptr_t)i * 0x20;
+        const uintptr_t obj  = kObjsOff + (uintptr_t)i * 0x400;
+        const uint64_t next = i + 1 < n ? (uint64_t)(g_base + node + 0x20) : (uint64_t)sentinel;
+        BenchPut<uint64_t>(node + RVA::Selection::kNodeNext, next);
+        BenchPut<uint64_t>(node + RVA::Selection::kNodeDataPlus24,
+                           (uint64_t)(g_base + obj + RVA::Selection::kNodeDataAdjustment));
+        BenchPut<int32_t>(obj + RVA::GameObj::OwnerPlayerID, i % kBenchPlayers);
+        BenchPut<float>(obj + RVA::GameObj::HP, 100.0f + (float)(i % 400));
+        BenchPut<uint8_t>(obj + RVA::GameObj::ParentIndex, 0xFF);
+    }
+    InvalidateTacticalUnitIndex();
+}
+
+// The same list with every 8th object turned into a planet (the shape
+// WalkGalacticPlanets reads): a data pack with owner / structures /
+// destroyed, and a type whose name fits the small-string buffer.
+static int BenchSetupGalaxy(int n) {
+    BenchSetupTacticalList(n);
+    const char* name = "Coruscant";
+    memcpy(g_benchImage + kPlanetTypeOff + RVA::UnitType::Name, name, strlen(name) + 1);
+    BenchPut<uint64_t>(kPlanetTypeOff + RVA::UnitType::NameSize, strlen(name));
+    BenchPut<uint64_t>(kPlanetTypeOff + RVA::UnitType::NameCapacity, 15);
+    int planets = 0;
+    for (int i = 0; i < n && planets < RVA::Planet::kMaxPlanets; i += 8, planets++) {
+        const uintptr_t obj  = kObjsOff + (uintptr_t)i * 0x400;
+        const uintptr_t pack = kPacksOff + (uintptr_t)planets * 0x300;
+        BenchPut<uint8_t>(obj + RVA::Planet::kBehaviorSlot, 0);
+        BenchPut<uint64_t>(obj + RVA::Planet::kDataPack, (uint64_t)(g_base + pack));
+        BenchPut<uint64_t>(obj + RVA::GameObj::GameObjType, (uint64_t)(g_base + kPlanetTypeOff));
+        BenchPut<int32_t>(pack + RVA::Planet::kOwnerPlayerID, planets % 3 == 0 ? -1 : planets % kBenchPlayers);
+        BenchPut<int32_t>(pack + RVA::Planet::kBuiltCount, planets % 5);
+        BenchPut<uint8_t>(pack + RVA::Planet::kDestroyed, 0);
+    }
+    return planets;
+}
+
+// ======================================================================
+// Timing and output
+// ======================================================================
+
+static const int    kSamples  = 5;
+static const double kSampleMs = 50.0;
+
+enum BenchFormat { BENCH_TEXT, BENCH_JSONL, BENCH_CSV };
+static BenchFormat g_benchFormat = BENCH_TEXT;
+static FILE*       g_benchOut = nullptr;
+static const char* g_benchFilter = nullptr;
+
+// Runs `op` (which performs `batch` operations per call) until one sample
+// lasts kSampleMs, then reports. `items` is what one op processes (list
+// nodes walked, rows formatted), 0 when it has no natural count.
+template <typename Op>
+static void BenchRun(const char* name, int n, uint64_t batch, uint64_t items, Op&& op) {
+    if (g_benchFilter && !strstr(name, g_benchFilter)) return;
+    using Clock = std::chrono::steady_clock;
+    uint64_t calls = 1;
+    for (;;) {  // warm-up doubles as calibration
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < calls; i++) op();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms >= kSampleMs / 4 || calls >= (1ull << 30)) {
+            calls = ms > 0.0 ? (uint64_t)(calls * kSampleMs / ms) + 1 : calls * 4;
+            break;
+        }
+        calls *= 2;
+    }
+    double ns[kSamples];
+    for (int s = 0; s < kSamples; s++) {
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < calls; i++) op();
+        ns[s] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (double)(calls * batch);
+    }
+    std::sort(ns, ns + kSamples);
+    const double median = ns[kSamples / 2];
+    const unsigned long long iters = (unsigned long long)(calls * batch);
+    switch (g_benchFormat) {
+    case BENCH_JSONL:
+        fprintf(g_benchOut,
+                "{\"bench\":\"%s\",\"n\":%d,\"samples\":%d,\"iters\":%llu,\"ns_op\":%.2f,\"ns_op_min\":%.2f,"
+                "\"items\":%llu}\n",
+                name, n, kSamples, iters, median, ns[0], (unsigned long long)items);
+        break;
+    case BENCH_CSV:
+        fprintf(g_benchOut, "%s,%d,%d,%llu,%.2f,%.2f,%llu\n", name, n, kSamples, iters, median, ns[0],
+                (unsigned long long)items);
+        break;
+    default:
+        fprintf(g_benchOut, "  %-28s n=%-6d %12.1f ns/op  (min %.1f", name, n, median, ns[0]);
+        if (items) fprintf(g_benchOut, ", %.2f ns/item", median / (double)items);
+        fprintf(g_benchOut, ")\n");
+        break;
+    }
+    fflush(g_benchOut);
+}
+
+// ======================================================================
+// Cases
+// ======================================================================
+
+static void BenchDoString(FakeLuaState* L) {
+    BenchRun("dostring", 0, 1, 0, [L]() {
+        DoString(LS(L), "return SWFOC_GetCredits(0)");
+        fn_settop(LS(L), 0);
+    });
+}
+
+static void BenchWalk() {
+    static uintptr_t objs[RVA::Selection::kMaxTacticalObjects];
+    const int sizes[] = {100, 1000, 2048, 10000};
+    for (int n : sizes) {
+        BenchSetupTacticalList(n);
+        const int walked = WalkAllTacticalObjects(objs, RVA::Selection::kMaxTacticalObjects);
+        BenchRun("walk_tactical", n, 1, (uint64_t)walked, []() {
+            WalkAllTacticalObjects(objs, RVA::Selection::kMaxTacticalObjects);
+        });
+    }
+}
+
+static void BenchCensus() {
+    const int kTypes = 16;
+    for (int t = 0; t < kTypes; t++) {
+        const uintptr_t type = kUnitTypesOff + (uintptr_t)t * 0x200;
+        char name[16];
+        const int len = snprintf(name, sizeof(name), "UNIT_TYPE_%d", t);
+        memcpy(g_benchImage + type + RVA::UnitType::Name, name, (size_t)len + 1);
+        BenchPut<uint64_t>(type + RVA::UnitType::NameSize, (uint64_t)len);
+        BenchPut<uint64_t>(type + RVA::UnitType::NameCapacity, 15);
+    }
+    const int sizes[] = {1000, 10000};
+    for (int n : sizes) {
+        BenchSetupTacticalList(n);
+        for (int i = 0; i < n; i++) {
+            BenchPut<uint64_t>(kObjsOff + (uintptr_t)i * 0x400 + RVA::GameObj::GameObjType,
+                               (uint64_t)(g_base + kUnitTypesOff + (uintptr_t)(i % kTypes) * 0x200));
+        }
+        BenchRun("type_census", n, 1, (uint64_t)n, []() {
+            g_luaDCallTickCounter = g_luaDCallTickCounter + 1;
+            GetTypeCensus();
+        });
+    }
+    for (int i = 0; i < kBenchMaxUnits; i++)
+        BenchPut<uint64_t>(kObjsOff + (uintptr_t)i * 0x400 + RVA::GameObj::GameObjType, 0);
+    BenchSetupTacticalList(0);
+}
+
+// Grid vs. brute force for "units within 150 of a point" over a map of
+// scattered units; positions are synthetic (no live position RE yet).
+static void BenchSpatial() {
+    static SpatialGrid g;
+    static uint64_t objs[SPATIAL_GRID_MAX];
+    static int32_t  owner[SPATIAL_GRID_MAX];
+    static float    xs[SPATIAL_GRID_MAX], ys[SPATIAL_GRID_MAX];
+    const int n = SPATIAL_GRID_MAX;
+    uint32_t rng = 12345;
+    for (int i = 0; i < n; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        xs[i] = (float)(rng >> 8 & 0x3FFF) - 8192.0f;
+        rng = rng * 1664525u + 1013904223u;
+        ys[i] = (float)(rng >> 8 & 0x3FFF) - 8192.0f;
+        objs[i] = 0x10000 + (uint64_t)i * 0x400;
+        owner[i] = i % 3;
+    }
+    static uint16_t hits[SPATIAL_GRID_MAX];
+    volatile int sink = 0;
+    BenchRun("spatial_rebuild", n, 1, (uint64_t)n, [&]() {
+        g.count = 0;  // force the re-sort path
+        SpatialGridUpdate(&g, objs, owner, xs, ys, n);
+    });
+    BenchRun("spatial_refresh", n, 1, (uint64_t)n, [&]() {
+        SpatialGridUpdate(&g, objs, owner, xs, ys, n);
+    });
+    BenchRun("spatial_radius", n, 1, 1, [&]() {
+        sink = sink + SpatialGridQueryRadius(&g, xs[sink & 1023], ys[sink & 1023], 150.0f, hits, n);
+    });
+    BenchRun("linear_radius", n, 1, 1, [&]() {
+        const float x = xs[sink & 1023], y = ys[sink & 1023];
+        int c = 0;
+        for (int i = 0; i < n; i++) {
+            const float dx = xs[i] - x, dy = ys[i] - y;
+            if (dx * dx + dy * dy <= 150.0f * 150.0f) c++;
+        }
+        sink = sink + c;
+    });
+}
+
+// Area splash over a replay roster: the per-call entry point (loads a sim
+// from the unit table each time) vs. a sweep kernel on a loaded sim.
+static void BenchReplaySplash() {
+    const int n = 2000;
+    ReplayState s;
+    for (int i = 0; i < n; i++) {
+        const uint64_t obj = 0x10000 + (uint64_t)i * 0x400;
+        ReplayMutMockUnit(s, obj, "unit", i % 3, 1e9f, 1e9f, 4);
+        if (i % 16 == 0) ReplayMutMakeInvulnerable(s, obj, true);
+    }
+    ReplayMutSetDamageMultiplier(s, 1, 2.0f);
+    ReplayMutSetAreaDamageEnabled(s, true);
+    volatile int sink = 0;
+    BenchRun("replay_splash", n, 1, (uint64_t)n, [&]() {
+        sink = sink + ReplayMutApplyAreaSplash(s, 0x10000, 1.0f);
+        s.damage_event_log.mut().pop(s.damage_event_log.size());
+    });
+    static ReplaySim sim;
+    ReplaySimLoad(s, &sim);
+    BenchRun("replay_sim_splash", n, 1, (uint64_t)n, [&]() {
+        sink = sink + ReplaySimSplash(&sim, 0, false, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f);
+        sim.evUnit.clear();
+        sim.evRequested.clear();
+        sim.evCurrent.clear();
+    });
+}
+
+// Fork and restore a snapshot-sized state: with nothing written the tables
+// stay shared; one unit hit copies the units table alone.
+static void BenchReplayFork() {
+    const int n = 2000;
+    ReplayState s;
+    for (int i = 0; i < n; i++) {
+        const uint64_t obj = 0x10000 + (uint64_t)i * 0x400;
+        ReplayMutMockUnit(s, obj, "unit_type_name_" + std::to_string(i), i % 3, 1e9f, 1e9f, 4);
+        s.objects.mut()["object_type_name_" + std::to_string(i)] = (uint32_t)i;
+        s.globals.mut()["global_name_" + std::to_string(i)] = ReplayGlobal{};
+    }
+    ReplayForkTable forks;
+    BenchRun("replay_fork_restore", n, 1, 1, [&]() {
+        const uint32_t id = ReplayFork(s, &forks);
+        ReplayRestore(s, forks, id);
+        ReplayDropFork(&forks, id);
+    });
+    BenchRun("replay_fork_hit_restore", n, 1, 1, [&]() {
+        const uint32_t id = ReplayFork(s, &forks);
+        ReplayMutApplyDamage(s, 0x10000, 1.0f);
+        ReplayRestore(s, forks, id);
+        ReplayDropFork(&forks, id);
+    });
+}
+
+static void BenchReplayEventLog() {
+    const int n = REPLAY_EVENT_DRAIN_ROWS;
+    ReplayState s;
+    ReplayMutMockUnit(s, 0x10000, "unit", 0, 1e9f, 1e9f, 1);
+    volatile size_t sink = 0;
+    BenchRun("replay_event_drain_csv", n, 1, (uint64_t)n, [&]() {
+        for (int i = 0; i < n; i++) ReplayMutApplyDamage(s, 0x10000, 1.0f);
+        sink = sink + ReplayObsEventStreamDrain(s).size();
+    });
+    std::vector<uint8_t> page;
+    BenchRun("replay_event_drain_binary", n, 1, (uint64_t)n, [&]() {
+        for (int i = 0; i < n; i++) ReplayMutApplyDamage(s, 0x10000, 1.0f);
+        page.clear();
+        sink = sink + ReplayObsEventStreamDrainBinary(s, &page);
+    });
+}
+
+static void BenchReplayIncome() {
+    const int ticks = 1000;
+    ReplayState s;
+    for (uint32_t slot = 0; slot < 8; slot++) s.players.push_back(ReplayPlayer{slot, "FACTION", 1000.0, 0, ""});
+    ReplayMutSetIncomeMultiplier(s, 1, 2.0f);
+    ReplayMutSetIncomeMultiplier(s, 3, 0.5f);
+    ReplayMutSetFreezeCredits(s, 5, true, 5000.0);
+    ReplayTickConfig cfg;
+    cfg.income_per_sec = 30.0;
+    BenchRun("replay_tick_income", ticks, 1, (uint64_t)ticks * 8, [&]() {
+        ReplayTickRun(s, cfg, ticks, [](const ReplayState&) {});
+    });
+}
+
+static void BenchPlanets(FakeLuaState* L) {
+    static PlanetRow rows[RVA::Planet::kMaxPlanets];
+    const int sizes[] = {1000, 4096};
+    for (int n : sizes) {
+        const int planets = BenchSetupGalaxy(n);
+        BenchRun("walk_planets", n, 1, (uint64_t)planets, []() {
+            WalkGalacticPlanets(rows, RVA::Planet::kMaxPlanets);
+        });
+        BenchRun("list_planets", n, 1, (uint64_t)planets, [L]() {
+            fn_settop(LS(L), 0);
+            Lua_ListPlanets(LS(L));
+        });
+    }
+    fn_settop(LS(L), 0);
+    BenchSetupTacticalList(0);
+}
+
+static void BenchEnumerate(FakeLuaState* L) {
+    const int sizes[] = {100, 1000, 2048};
+    for (int n : sizes) {
+        BenchSetupTacticalList(n);
+        const uint64_t rows = (uint64_t)(n / kBenchPlayers);
+        auto call = [L]() {
+            fn_settop(LS(L), 0);
+            fn_pushnumber(LS(L), 2);
+            Lua_EnumerateUnits(LS(L));
+        };
+        // Same luaD_call tick: the index is built once and served from cache.
+        BenchRun("enumerate_units_cached", n, 1, rows, call);
+        // A new tick per call: walk, index build and format every time.
+        BenchRun("enumerate_units_rebuild", n, 1, rows, [&call]() {
+            g_luaDCallTickCounter = g_luaDCallTickCounter + 1;
+            call();
+        });
+    }
+    fn_settop(LS(L), 0);
+}
+
+static void BenchTypeExists(FakeLuaState* L) {
+    static std::string names;
+    names.clear();
+    for (int i = 0; i < 512; i++) {
+        const std::string name = "BENCH_TYPE_" + std::to_string(i);
+        if (i % 3 != 0) L->known_object_types.insert(name);
+        names += (i ? "|" : "") + name;
+    }
+    L->has_game_globals = true;
+    auto probe = [L]() {
+        fn_settop(LS(L), 0);
+        fn_pushstring(LS(L), names.c_str());
+        Lua_BatchTypeExists(LS(L));
+    };
+    BenchRun("type_exists_cached", 512, 1, 512, probe);
+    BenchRun("type_exists_probe", 512, 1, 512, [&probe]() {
+        InvalidateTypeCache();
+        probe();
+    });
+    fn_settop(LS(L), 0);
+    L->has_game_globals = false;
+    L->known_object_types.clear();
+}
+
+static void BenchWriteEvent() {
+    static SharedEvtBuffer evt;
+    ShmEvtInit(&evt);
+    evt.flags.store(1, std::memory_order_release);
+    g_evtBuf = &evt;
+    uint8_t payload[16] = {};
+    uint8_t out[64];
+    uint16_t type, sz;
+    // Bursts that fit the ring, drained untimed-ish between: the drain is
+    // inside the sample but amortised over the burst.
+    const uint32_t kBurst = 1024;
+    BenchRun("write_event", 16, kBurst, 0, [&]() {
+        for (uint32_t i = 0; i < kBurst; i++) {
+            memcpy(payload, &i, sizeof(i));
+            WriteEvent(EVT_HP_CHANGE, payload, sizeof(payload));
+        }
+        while (ShmEvtRead(&evt, &type, out, sizeof(out), &sz)) {}
+    });
+
+    // 2026-10-14: the same burst as compact EVT_HP_BATCH records
+    // (event_compact.h), staged per thread and flushed at the end.
+    static EvtCompactSet compact;
+    const int batch = EvtCompactClaim(&compact, 1);
+    auto sink = [](uint16_t t, const void* p, uint16_t n) { return ShmEvtWrite(&evt, t, p, n); };
+    auto burst = [&]() {
+        for (uint32_t i = 0; i < kBurst; i++)
+            EvtCompactAppend(&compact, batch, 1000 + i / 4, (uint16_t)(i & 255), 30000, 120, 3, sink);
+        EvtCompactFlushStale(&compact, ~0ull, 0, sink);
+    };
+    BenchRun("write_event_compact", 16, kBurst, 0, [&]() {
+        burst();
+        while (ShmEvtRead(&evt, &type, out, sizeof(out), &sz)) {}
+    });
+    g_evtBuf = nullptr;
+}
+
+static void BenchDumpState(FakeLuaState* L) {
+    const char* path = "bridge_bench_snapshot.swfocsnap";
+    BenchSetupTacticalList(1000);
+    auto dump = [L, path](const char* codec) {
+        fn_settop(LS(L), 0);
+        fn_pushstring(LS(L), path);
+        if (codec) fn_pushstring(LS(L), codec);
+        Lua_DumpState(LS(L));
+        fn_settop(LS(L), 0);
+    };
+    BenchRun("dump_state", 1000, 1, 0, [&dump]() { dump(nullptr); });
+    BenchRun("dump_state_lz4", 1000, 1, 0, [&dump]() { dump("lz4"); });
+    remove(path);
+}
+
+static void BenchSafeAppend() {
+    static char buf[65536];
+    const int kRows = 64;
+    BenchRun("safe_append_fmt", kRows, kRows, 0, []() {
+        size_t off = SafeAppendFmt(buf, 0, sizeof(buf), "count=%d", kRows);
+        for (int r = 0; r < kRows; r++) {
+            off = SafeAppendFmt(buf, off, sizeof(buf), "|%llu;%d;%.3f;%u;%u;%d;%d",
+                                (unsigned long long)(0x140000000ull + r * 0x400), r & 3, 100.0f + r, 0u, 0u,
+                                r == 1, 0);
+        }
+    });
+}
+
+static void BenchCrc32() {
+    static uint8_t buf[65536];
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)(i * 131u + 7u);
+    static volatile uint32_t sink;
+    BenchRun("crc32", (int)sizeof(buf), 1, sizeof(buf), []() { sink = Crc32_Update(0, buf, sizeof(buf)); });
+}
+
+int main(int argc, char** argv) {
+    g_benchOut = stdout;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* f = argv[++i];
+            if (strcmp(f, "jsonl") == 0) g_benchFormat = BENCH_JSONL;
+            else if (strcmp(f, "csv") == 0) g_benchFormat = BENCH_CSV;
+            else if (strcmp(f, "text") == 0) g_benchFormat = BENCH_TEXT;
+            else { fprintf(stderr, "unknown format: %s\n", f); return 2; }
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            g_benchOut = fopen(argv[++i], "w");
+            if (!g_benchOut) { fprintf(stderr, "cannot open %s\n", argv[i]); return 2; }
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            g_benchFilter = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--format text|jsonl|csv] [--out <path>] [--filter <name>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    g_benchImage = reinterpret_cast<uint8_t*>(
+        VirtualAlloc(nullptr, kBenchImageSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+    if (!g_benchImage) { fprintf(stderr, "VirtualAlloc failed\n"); return 1; }
+    memset(g_benchImage, 0, kBenchImageSize);
+    g_base = reinterpret_cast<uintptr_t>(g_benchImage);
+    static_assert(kObjsOff + (uintptr_t)kBenchMaxUnits * 0x400 <= kBenchImageSize, "image too small");
+    static_assert(kNodesOff + (uintptr_t)kBenchMaxUnits * 0x20 <= kObjsOff, "node area overlaps objects");
+    static_assert(kObjsOff + (uintptr_t)kBenchMaxUnits * 0x400 <= kPacksOff
+                  && kPacksOff + (uintptr_t)RVA::Planet::kMaxPlanets * 0x300 <= kPlanetTypeOff
+                  && kPlanetTypeOff + 0x200 <= kUnitTypesOff,
+                  "planet areas overlap objects");
+
+    BenchWireFakes();
+    BenchSetupPlayers();
+    FakeLuaState L;
+
+    if (g_benchFormat == BENCH_TEXT) {
+        fprintf(g_benchOut, "=== Bridge microbenchmarks (%d samples of >= %.0f ms, median) ===\n", kSamples,
+                kSampleMs);
+    } else if (g_benchFormat == BENCH_CSV) {
+        fprintf(g_benchOut, "bench,n,samples,iters,ns_op,ns_op_min,items\n");
+    }
+    BenchDoString(&L);
+    BenchWalk();
+    BenchEnumerate(&L);
+    BenchPlanets(&L);
+    BenchSpatial();
+    BenchReplaySplash();
+    BenchReplayFork();
+    BenchReplayEventLog();
+    BenchReplayIncome();
+    BenchCensus();
+    BenchTypeExists(&L);
+    BenchWriteEvent();
+    BenchDumpState(&L);
+    BenchSafeAppend();
+    BenchCrc32();
+
+    if (g_benchOut != stdout) fclose(g_benchOut);
+    VirtualFree(g_benchImage, 0, MEM_RELEASE);
+    return 0;
+}
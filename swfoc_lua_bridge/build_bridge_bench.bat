@@ -0,0 +1,38 @@
+@echo off
+REM build_bridge_bench.bat -- compile + run bridge_bench.cpp, the throughput
+REM microbenchmarks for lua_bridge.cpp (DoString, the tactical walk,
+REM EnumerateUnits, WriteEvent, DumpState, SafeAppendFmt). Needs no game: it
+REM drives the real bridge code against fake_lua.cpp and a synthetic image.
+REM Same MinGW toolchain as build.bat; MinHook is linked but never called.
+REM
+REM   build_bridge_bench.bat            human-readable table
+REM   build_bridge_bench.bat jsonl      one JSON record per case, also
+REM                                     written to bridge_bench.jsonl
+
+set GCC=x86_64-w64-mingw32-gcc
+set GPP=x86_64-w64-mingw32-g++
+set CFLAGS=-O2 -DWIN32_LEAN_AND_MEAN
+
+echo === Bridge microbenchmarks ===
+%GCC% -c %CFLAGS% -Iminhook/include -Iminhook/src minhook/src/hook.c -o hook.o
+%GCC% -c %CFLAGS% minhook/src/buffer.c -o buffer.o
+%GCC% -c %CFLAGS% minhook/src/trampoline.c -o trampoline.o
+%GCC% -c %CFLAGS% minhook/src/hde/hde64.c -o hde64.o
+if errorlevel 1 goto fail
+
+%GPP% -O2 -std=c++17 -DWIN32_LEAN_AND_MEAN -I. -Iminhook/include -static -o bridge_bench.exe bridge_bench.cpp fake_lua.cpp hook.o buffer.o trampoline.o hde64.o -lkernel32 -luser32
+if errorlevel 1 goto fail
+
+if "%1"=="jsonl" (
+    .\bridge_bench.exe --format jsonl --out bridge_bench.jsonl
+    type bridge_bench.jsonl
+) else (
+    .\bridge_bench.exe
+)
+goto end
+
+:fail
+echo.
+echo === BENCHMARK BUILD FAILED ===
+
+:end
@@ -0,0 +1,20 @@
+@echo off
+REM build_evt_ring_bench.bat -- compile + run evt_ring_bench.cpp, the
+REM per-event cost benchmark for the shared event ring writer (ShmEvtWrite in
+REM shared_memory.h). Needs no game: it drives the ring in process memory.
+REM Same MinGW g++ as build.bat.
+
+set GPP=x86_64-w64-mingw32-g++
+
+echo === Event ring writer benchmark ===
+%GPP% -O2 -std=c++17 -DWIN32_LEAN_AND_MEAN -I. -static -o evt_ring_bench.exe evt_ring_bench.cpp
+if errorlevel 1 goto fail
+
+.\evt_ring_bench.exe
+goto end
+
+:fail
+echo.
+echo === BENCHMARK BUILD FAILED ===
+
+:end
@@ -0,0 +1,24 @@
+@echo off
+REM build_pipe_loadgen.bat -- compile pipe_loadgen.cpp, the end-to-end load
+REM generator for the bridge command pipe. Same MinGW g++ as build.bat.
+REM
+REM Against the replay harness (no game needed):
+REM   swfoc_replay.exe <snapshot.swfocsnap>
+REM   pipe_loadgen.exe --pipe replay --mix-file <commands.txt> --clients 4
+REM Against the live bridge:
+REM   pipe_loadgen.exe --mix hud --transport persist --clients 2
+
+set GPP=x86_64-w64-mingw32-g++
+
+echo === Pipe load generator ===
+%GPP% -O2 -std=c++17 -DWIN32_LEAN_AND_MEAN -I. -static -o pipe_loadgen.exe pipe_loadgen.cpp
+if errorlevel 1 goto fail
+
+echo Built pipe_loadgen.exe
+goto end
+
+:fail
+echo.
+echo === LOAD GENERATOR BUILD FAILED ===
+
+:end
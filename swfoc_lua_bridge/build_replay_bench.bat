@@ -0,0 +1,39 @@
+@echo off
+REM build_replay_bench.bat -- write the make_test_snapshot.py fixtures, then
+REM compile + run replay_bench.cpp, the replay-path regression suite. Fails
+REM (exit 1) when any case is over replay_bench_budgets.txt by more than the
+REM tolerance or stops scaling linearly. Needs Python 3 for the fixtures.
+REM
+REM   build_replay_bench.bat            check against the stored budgets
+REM   build_replay_bench.bat budgets    rewrite replay_bench_budgets.txt
+
+set GPP=x86_64-w64-mingw32-g++
+
+echo === Replay regression suite ===
+for %%n in (10 1000 10000) do (
+    python make_test_snapshot.py replay_bench_%%n.swfocsnap --scale %%n --planets 200
+    if errorlevel 1 goto fail
+)
+
+%GPP% -O2 -std=c++17 -static -o replay_bench.exe replay_bench.cpp fake_lua.cpp fake_memory.cpp -lws2_32
+if errorlevel 1 goto fail
+
+if "%1"=="budgets" (
+    .\replay_bench.exe --write-budgets replay_bench_budgets.txt
+) else (
+    .\replay_bench.exe --budgets replay_bench_budgets.txt
+)
+if errorlevel 1 goto regress
+goto end
+
+:fail
+echo.
+echo === REPLAY BENCH BUILD FAILED ===
+exit /b 2
+
+:regress
+echo.
+echo === REPLAY BENCH REGRESSION ===
+exit /b 1
+
+:end
@@ -0,0 +1,32 @@
+@echo off
+REM build_snapshot_fuzz.bat -- compile snapshot_fuzz.cpp, the fuzz target for
+REM the .swfocsnap parser, and write its seed corpus to fuzz_seeds\. Same
+REM MinGW g++ as build.bat; this build replays inputs and reports the parse
+REM rate. For coverage-guided fuzzing build the same file with clang
+REM libFuzzer or AFL++ (see the header of snapshot_fuzz.cpp).
+REM
+REM   snapshot_fuzz.exe --iterations 10000 fuzz_seeds\v2_units.swfocsnap
+
+set GPP=x86_64-w64-mingw32-g++
+
+echo === Snapshot parser fuzz target ===
+%GPP% -O2 -std=c++17 -I. -static -o snapshot_fuzz.exe snapshot_fuzz.cpp
+if errorlevel 1 goto fail
+
+echo === Seed corpus ===
+if not exist fuzz_seeds mkdir fuzz_seeds
+python make_test_snapshot.py fuzz_seeds\v1.swfocsnap --v1
+python make_test_snapshot.py fuzz_seeds\v2_early.swfocsnap --v2-early
+python make_test_snapshot.py fuzz_seeds\v2.swfocsnap
+python make_test_snapshot.py fuzz_seeds\v2_units.swfocsnap --units
+python make_test_snapshot.py fuzz_seeds\v3_units.swfocsnap --v3 --units
+if errorlevel 1 goto fail
+
+.\snapshot_fuzz.exe fuzz_seeds\v1.swfocsnap fuzz_seeds\v2_early.swfocsnap fuzz_seeds\v2.swfocsnap fuzz_seeds\v2_units.swfocsnap fuzz_seeds\v3_units.swfocsnap
+goto end
+
+:fail
+echo.
+echo === FUZZ TARGET BUILD FAILED ===
+
+:end
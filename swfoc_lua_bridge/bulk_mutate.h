@@ -0,0 +1,198 @@
+#pragma once
+// bulk_mutate.h -- filter + field-op plans for SWFOC_BulkMutateUnits.
+//
+// Sweeps such as SweepLocalUnitsInvulnerable and HealAllLocal each walked
+// the tactical list on their own, and clients editing many units sent one
+// pipe command per unit. A bulk plan is parsed once and applied in a single
+// main-thread pass over the unit index:
+//
+//   filter  comma-separated terms, all of which must hold:
+//             all | local | selected | owner=<slot> | type=<obj_addr>
+//           (type= matches units sharing that unit's GameObjType record)
+//   ops     semicolon-separated field=value pairs, applied in order:
+//             hull | invuln | invuln_flag | prevent_death | shield | speed
+//           `invuln` is the hardpoint-behavior path (the gameplay effect);
+//           `invuln_flag` is the display byte only, as in SWFOC_SetUnitField.
+//
+// Parsing and filter matching live here (header-only, Win32-free, driven by
+// test_harness.cpp); the bridge reads the unit fields and applies the ops.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#define BULK_MAX_OPS       8
+#define BULK_MAX_FAILURES  64  // per-unit failures listed in the reply
+
+enum BulkField : uint8_t {
+    BULK_HULL = 0,
+    BULK_INVULN,
+    BULK_INVULN_FLAG,
+    BULK_PREVENT_DEATH,
+    BULK_SHIELD,
+    BULK_SPEED,
+};
+
+// Per-unit failure codes, reported as "<addr>:<name>".
+enum BulkFailure : uint8_t {
+    BULK_OK = 0,
+    BULK_FAIL_READONLY,     // not owned by the local player (enemy READ-ONLY)
+    BULK_FAIL_INVULN_PATH,  // hardpoint-behavior path refused the unit
+    BULK_FAIL_NO_ENGINE_FN, // shield / speed helper not resolved
+};
+
+struct BulkOp {
+    uint8_t field;
+    float   value;
+};
+
+struct BulkFilter {
+    int32_t  owner;       // -1 = any
+    bool     localOnly;
+    bool     selectedOnly;
+    uint64_t typeOf;      // obj_addr whose type to match, 0 = any
+    uint64_t typePtr;     // resolved by the bridge from typeOf
+};
+
+struct BulkPlan {
+    BulkFilter filter;
+    BulkOp     ops[BULK_MAX_OPS];
+    int        opCount;
+};
+
+// What the filter needs to know about one unit.
+struct BulkUnitView {
+    int32_t  owner;
+    bool     local;
+    bool     selected;
+    uint64_t typePtr;
+};
+
+// Outcome of one pass. Failures past BULK_MAX_FAILURES are counted only.
+struct BulkResult {
+    int      matched;
+    int      applied;  // units on which every op succeeded
+    int      failed;
+    int      listed;
+    uint64_t failAddr[BULK_MAX_FAILURES];
+    uint8_t  failCode[BULK_MAX_FAILURES];
+};
+
+inline void BulkResultFail(BulkResult* r, uint64_t addr, uint8_t code) {
+    if (r->listed < BULK_MAX_FAILURES) {
+        r->failAddr[r->listed] = addr;
+        r->failCode[r->listed] = code;
+        r->listed++;
+    }
+    r->failed++;
+}
+
+inline const char* BulkFailureName(uint8_t code) {
+    switch (code) {
+        case BULK_FAIL_READONLY:     return "readonly";
+        case BULK_FAIL_INVULN_PATH:  return "invuln_path";
+        case BULK_FAIL_NO_ENGINE_FN: return "no_engine_fn";
+        default:                     return "ok";
+    }
+}
+
+inline bool BulkFieldFromName(const char* name, size_t len, uint8_t* out) {
+    static const struct { const char* name; uint8_t field; } kFields[] = {
+        {"hull", BULK_HULL},           {"invuln", BULK_INVULN},
+        {"invuln_flag", BULK_INVULN_FLAG}, {"prevent_death", BULK_PREVENT_DEATH},
+        {"shield", BULK_SHIELD},       {"speed", BULK_SPEED},
+    };
+    for (const auto& f : kFields) {
+        if (strlen(f.name) == len && memcmp(f.name, name, len) == 0) {
+            *out = f.field;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parses a full number from [s, s + len); false on trailing garbage.
+inline bool BulkParseNumber(const char* s, size_t len, double* out) {
+    char tmp[32];
+    if (len == 0 || len >= sizeof(tmp)) return false;
+    memcpy(tmp, s, len);
+    tmp[len] = '\0';
+    char* end = nullptr;
+    const double v = strtod(tmp, &end);
+    if (end != tmp + len) return false;
+    *out = v;
+    return true;
+}
+
+// Empty or null means "all". *err names the first bad term.
+inline bool BulkParseFilter(const char* s, BulkFilter* f, const char** err) {
+    f->owner = -1;
+    f->localOnly = false;
+    f->selectedOnly = false;
+    f->typeOf = 0;
+    f->typePtr = 0;
+    if (!s) return true;
+    while (*s) {
+        const char* end = strchr(s, ',');
+        const size_t len = end ? (size_t)(end - s) : strlen(s);
+        const char* eq = (const char*)memchr(s, '=', len);
+        double v = 0.0;
+        if (len == 0 || (len == 3 && memcmp(s, "all", 3) == 0)) {
+            // no constraint
+        } else if (len == 5 && memcmp(s, "local", 5) == 0) {
+            f->localOnly = true;
+        } else if (len == 8 && memcmp(s, "selected", 8) == 0) {
+            f->selectedOnly = true;
+        } else if (eq && eq - s == 5 && memcmp(s, "owner", 5) == 0
+                   && BulkParseNumber(eq + 1, len - 6, &v) && v >= 0.0 && v < 16.0) {
+            f->owner = (int32_t)v;
+        } else if (eq && eq - s == 4 && memcmp(s, "type", 4) == 0
+                   && BulkParseNumber(eq + 1, len - 5, &v) && v > 0.0) {
+            f->typeOf = (uint64_t)v;
+        } else {
+            if (err) *err = s;
+            return false;
+        }
+        if (!end) break;
+        s = end + 1;
+    }
+    return true;
+}
+
+// At least one op is required. *err names the first bad op.
+inline bool BulkParseOps(const char* s, BulkPlan* plan, const char** err) {
+    plan->opCount = 0;
+    if (!s) s = "";
+    while (*s) {
+        const char* end = strchr(s, ';');
+        const size_t len = end ? (size_t)(end - s) : strlen(s);
+        if (len > 0) {
+            const char* eq = (const char*)memchr(s, '=', len);
+            uint8_t field = 0;
+            double v = 0.0;
+            if (!eq || plan->opCount >= BULK_MAX_OPS || !BulkFieldFromName(s, (size_t)(eq - s), &field)
+                || !BulkParseNumber(eq + 1, len - (size_t)(eq - s) - 1, &v)) {
+                if (err) *err = s;
+                return false;
+            }
+            plan->ops[plan->opCount].field = field;
+            plan->ops[plan->opCount].value = (float)v;
+            plan->opCount++;
+        }
+        if (!end) break;
+        s = end + 1;
+    }
+    if (plan->opCount == 0) {
+        if (err) *err = s;
+        return false;
+    }
+    return true;
+}
+
+inline bool BulkFilterMatches(const BulkFilter& f, const BulkUnitView& u) {
+    if (f.owner >= 0 && u.owner != f.owner) return false;
+    if (f.localOnly && !u.local) return false;
+    if (f.selectedOnly && !u.selected) return false;
+    if (f.typeOf && (!f.typePtr || u.typePtr != f.typePtr)) return false;
+    return true;
+}
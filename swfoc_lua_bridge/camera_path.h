@@ -0,0 +1,235 @@
+#pragma once
+// camera_path.h -- a whole camera fly-through uploaded in one command and
+// played back by the bridge.
+//
+// Driving the cinematic camera wires (Set_Cinematic_Camera_Key and friends)
+// or SWFOC_SetCameraPos from a client costs a pipe round-trip per keyframe,
+// and the camera stutters whenever one is late. SWFOC_CameraPath("play")
+// takes every key at once:
+//
+//   "ms;x;y;z|ms;x;y;z|..."                 positions only
+//   "ms;x;y;z;tx;ty;tz|ms;x;y;z;tx;ty;tz|..."  positions and look-at targets
+//
+// one key per '|', ms the key's offset from the start of the path (strictly
+// increasing). Every key has the same shape. Hook_luaD_call then evaluates
+// the path at most every CAMERA_PATH_STEP_MS and writes the pose, with no
+// pipe traffic until the path ends:
+//
+//   * Positions and targets follow a Catmull-Rom spline through the keys.
+//     Tangents are central differences over the key times (one-sided at the
+//     ends), so the speed through a key is continuous however the keys
+//     are spaced.
+//   * CameraPathMatrix builds the camera's 3x4 [R|t] transform: the
+//     right-handed, Z-up look-at the overlay's projection uses (columns
+//     right, up, back). A positions-only path keeps the camera's rotation.
+//   * A looping path wraps; otherwise the last key is applied once more
+//     and playback stops.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge parses and plays on the main thread.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#define CAMERA_PATH_KEYS    64
+#define CAMERA_PATH_STEP_MS 16       // one applied pose per frame at most
+#define CAMERA_PATH_MAX_MS  3600000  // last key's offset
+
+enum CameraPathParseResult {
+    CAMERA_PATH_PARSE_OK = 0,
+    CAMERA_PATH_PARSE_EMPTY,     // fewer than two keys
+    CAMERA_PATH_PARSE_TOO_MANY,  // over CAMERA_PATH_KEYS
+    CAMERA_PATH_PARSE_FIELDS,    // not 4 or 7 fields, or shapes differ
+    CAMERA_PATH_PARSE_NUMBER,    // a field is not a finite number
+    CAMERA_PATH_PARSE_TIME,      // ms not increasing or past CAMERA_PATH_MAX_MS
+};
+
+struct CameraPathKey {
+    uint32_t ms;
+    float    pos[3];
+    float    target[3];
+};
+
+struct CameraPose {
+    float pos[3];
+    float target[3];
+};
+
+struct CameraPath {
+    CameraPathKey key[CAMERA_PATH_KEYS];
+    int32_t       keys;
+    bool          targets;  // keys carry look-at targets
+    bool          loop;
+    bool          playing;
+    uint64_t      startMs;
+    uint64_t      nextMs;
+    uint32_t      frames;   // poses handed to the bridge
+    uint32_t      missed;   // poses the bridge could not apply (no camera)
+};
+
+inline const char* CameraPathParseError(int r) {
+    switch (r) {
+    case CAMERA_PATH_PARSE_OK:       return "ok";
+    case CAMERA_PATH_PARSE_EMPTY:    return "need at least two keys";
+    case CAMERA_PATH_PARSE_TOO_MANY: return "too many keys";
+    case CAMERA_PATH_PARSE_FIELDS:   return "expected ms;x;y;z or ms;x;y;z;tx;ty;tz on every key";
+    case CAMERA_PATH_PARSE_NUMBER:   return "bad number";
+    case CAMERA_PATH_PARSE_TIME:     return "key times must increase and stay under an hour";
+    }
+    return "?";
+}
+
+inline bool CameraPathParseNumber(const char* s, const char* e, double* out) {
+    char buf[32];
+    const size_t n = (size_t)(e - s);
+    if (!n || n >= sizeof(buf)) return false;
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    char* end = nullptr;
+    const double v = strtod(buf, &end);
+    if (*end != '\0' || !(v >= -3.0e38 && v <= 3.0e38)) return false;  // also NaN / inf
+    *out = v;
+    return true;
+}
+
+// Parses spec into `out` (stopped, not yet started). `out` is left
+// untouched on failure.
+inline int CameraPathParse(CameraPath* out, const char* spec) {
+    CameraPath p;
+    memset(&p, 0, sizeof(p));
+    int fieldsPerKey = 0;
+    const char* s = spec ? spec : "";
+    while (*s) {
+        const char* e = strchr(s, '|');
+        if (!e) e = s + strlen(s);
+        if (e > s) {
+            if (p.keys == CAMERA_PATH_KEYS) return CAMERA_PATH_PARSE_TOO_MANY;
+            double v[7];
+            int nf = 0;
+            for (const char* f = s; f <= e; ) {
+                const char* fe = f;
+                while (fe < e && *fe != ';') fe++;
+                if (nf == 7 || !CameraPathParseNumber(f, fe, &v[nf]))
+                    return nf == 7 ? CAMERA_PATH_PARSE_FIELDS : CAMERA_PATH_PARSE_NUMBER;
+                nf++;
+                f = fe + 1;
+            }
+            if ((nf != 4 && nf != 7) || (fieldsPerKey && nf != fieldsPerKey)) return CAMERA_PATH_PARSE_FIELDS;
+            fieldsPerKey = nf;
+            CameraPathKey& k = p.key[p.keys];
+            if (v[0] < 0.0 || v[0] > CAMERA_PATH_MAX_MS || v[0] != std::floor(v[0])) return CAMERA_PATH_PARSE_TIME;
+            k.ms = (uint32_t)v[0];
+            if (p.keys && k.ms <= p.key[p.keys - 1].ms) return CAMERA_PATH_PARSE_TIME;
+            for (int i = 0; i < 3; i++) {
+                k.pos[i] = (float)v[1 + i];
+                k.target[i] = nf == 7 ? (float)v[4 + i] : 0.0f;
+            }
+            p.keys++;
+        }
+        s = *e ? e + 1 : e;
+    }
+    if (p.keys < 2) return CAMERA_PATH_PARSE_EMPTY;
+    p.targets = fieldsPerKey == 7;
+    *out = p;
+    return CAMERA_PATH_PARSE_OK;
+}
+
+inline uint32_t CameraPathDuration(const CameraPath* p) {
+    return p->keys >= 2 ? p->key[p->keys - 1].ms - p->key[0].ms : 0;
+}
+
+// Tangent (units per ms) at key i of one channel.
+inline float CameraPathTangent(const CameraPath* p, int i, int ch, bool target) {
+    const int a = i > 0 ? i - 1 : i;
+    const int b = i + 1 < p->keys ? i + 1 : i;
+    const float* va = target ? p->key[a].target : p->key[a].pos;
+    const float* vb = target ? p->key[b].target : p->key[b].pos;
+    return (vb[ch] - va[ch]) / (float)(p->key[b].ms - p->key[a].ms);
+}
+
+// The pose tMs after the first key, clamped to the path.
+inline void CameraPathEvaluate(const CameraPath* p, uint32_t tMs, CameraPose* out) {
+    const uint32_t at = p->key[0].ms + (tMs < CameraPathDuration(p) ? tMs : CameraPathDuration(p));
+    int i = 0;
+    while (i + 2 < p->keys && p->key[i + 1].ms <= at) i++;
+    const CameraPathKey& k0 = p->key[i];
+    const CameraPathKey& k1 = p->key[i + 1];
+    const float span = (float)(k1.ms - k0.ms);
+    const float u = (float)(at - k0.ms) / span;
+    const float u2 = u * u, u3 = u2 * u;
+    const float h00 = 2 * u3 - 3 * u2 + 1, h10 = u3 - 2 * u2 + u;
+    const float h01 = -2 * u3 + 3 * u2, h11 = u3 - u2;
+    for (int ch = 0; ch < 3; ch++) {
+        out->pos[ch] = h00 * k0.pos[ch] + h10 * span * CameraPathTangent(p, i, ch, false)
+                     + h01 * k1.pos[ch] + h11 * span * CameraPathTangent(p, i + 1, ch, false);
+        out->target[ch] = p->targets
+            ? h00 * k0.target[ch] + h10 * span * CameraPathTangent(p, i, ch, true)
+              + h01 * k1.target[ch] + h11 * span * CameraPathTangent(p, i + 1, ch, true)
+            : 0.0f;
+    }
+}
+
+inline void CameraPathStart(CameraPath* p, uint64_t nowMs, bool loop) {
+    p->loop = loop;
+    p->playing = true;
+    p->startMs = nowMs;
+    p->nextMs = nowMs;
+    p->frames = 0;
+    p->missed = 0;
+}
+
+// One playback step. True with *out set when a pose is due; a non-looping
+// path stops after handing out its last key.
+inline bool CameraPathStep(CameraPath* p, uint64_t nowMs, CameraPose* out) {
+    if (!p->playing || nowMs < p->nextMs) return false;
+    const uint32_t duration = CameraPathDuration(p);
+    uint64_t t = nowMs - p->startMs;
+    if (t >= duration) {
+        if (p->loop) {
+            p->startMs += t - t % duration;
+            t %= duration;
+        } else {
+            t = duration;
+            p->playing = false;
+        }
+    }
+    CameraPathEvaluate(p, (uint32_t)t, out);
+    p->nextMs = nowMs + CAMERA_PATH_STEP_MS;
+    p->frames++;
+    return true;
+}
+
+// The camera transform for `pose`: row-major 3x4, translation in [3], [7],
+// [11]. `current` supplies the rotation when the path has no targets, or
+// when the target sits on the camera. Looking straight down falls back to
+// +Y as the up hint.
+inline void CameraPathMatrix(const CameraPath* p, const CameraPose& pose, const float current[12], float m[12]) {
+    memcpy(m, current, 12 * sizeof(float));
+    m[3] = pose.pos[0];
+    m[7] = pose.pos[1];
+    m[11] = pose.pos[2];
+    if (!p->targets) return;
+
+    float back[3] = {pose.pos[0] - pose.target[0], pose.pos[1] - pose.target[1], pose.pos[2] - pose.target[2]};
+    const float bl = std::sqrt(back[0] * back[0] + back[1] * back[1] + back[2] * back[2]);
+    if (!(bl > 1e-4f)) return;
+    for (float& c : back) c /= bl;
+    float hint[3] = {0.0f, 0.0f, 1.0f};
+    if (std::fabs(back[2]) > 0.999f) {
+        hint[1] = 1.0f;
+        hint[2] = 0.0f;
+    }
+    float right[3] = {hint[1] * back[2] - hint[2] * back[1], hint[2] * back[0] - hint[0] * back[2],
+                      hint[0] * back[1] - hint[1] * back[0]};
+    const float rl = std::sqrt(right[0] * right[0] + right[1] * right[1] + right[2] * right[2]);
+    for (float& c : right) c /= rl;
+    const float up[3] = {back[1] * right[2] - back[2] * right[1], back[2] * right[0] - back[0] * right[2],
+                         back[0] * right[1] - back[1] * right[0]};
+    for (int r = 0; r < 3; r++) {
+        m[r * 4 + 0] = right[r];
+        m[r * 4 + 1] = up[r];
+        m[r * 4 + 2] = back[r];
+    }
+}
@@ -0,0 +1,222 @@
+#pragma once
+// combat_stats.h -- damage and kill rollups per owner slot and per unit type,
+// so a client asks for a summary instead of folding the event stream.
+//
+// Take_Damage_Outer adds each hit to its victim's slot row and type row and
+// DeathHandler counts kills for the killer's slot and type and deaths for the
+// victim's. Every table is fixed size and every update is an atomic on the
+// row it touches; no hook ever takes a lock:
+//
+//   * Damage is kept in fixed point (COMBAT_STATS_FIXED units per HP), so
+//     totals add exactly whichever thread lands first.
+//   * The rolling window is COMBAT_STATS_BUCKETS one-second buckets. Each
+//     bucket word packs the low 16 bits of its second above 48 bits of
+//     damage; a hit in a new second swaps the whole word with one CAS, so
+//     a stale bucket is never summed and never needs a sweep. Windows run
+//     up to COMBAT_STATS_MAX_WINDOW seconds and count the current second as
+//     a whole one.
+//   * Type rows are open addressing (linear probe, COMBAT_STATS_PROBE
+//     slots) on the GameObjectType pointer, claimed by CAS. A type that
+//     finds no row is counted in typesDropped. Reset zeroes the counts but
+//     keeps the claimed keys, so it never races a claim; a hit landing
+//     during the reset may survive it.
+//
+// Attribution: the engine hands Take_Damage_Outer the victim and a source
+// tag, not the attacker, so damage is recorded as taken. Kills are the one
+// place the attacker is known.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#define COMBAT_STATS_SLOTS      16
+#define COMBAT_STATS_TYPES      256  // power of two
+#define COMBAT_STATS_PROBE      16
+#define COMBAT_STATS_BUCKETS    64   // one second each
+#define COMBAT_STATS_MAX_WINDOW 60
+#define COMBAT_STATS_FIXED      16   // damage units per HP
+#define COMBAT_STATS_TOP_TYPES  24   // type lines in a summary
+
+#define COMBAT_STATS_VALUE_MASK ((uint64_t)((1ULL << 48) - 1))
+
+struct CombatStatRow {
+    std::atomic<uint64_t> window[COMBAT_STATS_BUCKETS];  // (second & 0xFFFF) << 48 | damage
+    std::atomic<uint64_t> taken;                         // damage since reset
+    std::atomic<uint32_t> hits;
+    std::atomic<uint32_t> kills;
+    std::atomic<uint32_t> deaths;
+};
+
+struct CombatStats {
+    CombatStatRow         slot[COMBAT_STATS_SLOTS];
+    std::atomic<uint64_t> typeKey[COMBAT_STATS_TYPES];  // 0 = free
+    CombatStatRow         type[COMBAT_STATS_TYPES];
+    std::atomic<uint32_t> typesDropped;  // updates whose type found no row
+    std::atomic<uint32_t> slotsDropped;  // updates for a slot outside the table
+};
+
+inline void CombatStatRowReset(CombatStatRow* r) {
+    for (auto& w : r->window) w.store(0, std::memory_order_relaxed);
+    r->taken.store(0, std::memory_order_relaxed);
+    r->hits.store(0, std::memory_order_relaxed);
+    r->kills.store(0, std::memory_order_relaxed);
+    r->deaths.store(0, std::memory_order_relaxed);
+}
+
+inline void CombatStatsReset(CombatStats* s) {
+    for (auto& r : s->slot) CombatStatRowReset(&r);
+    for (auto& r : s->type) CombatStatRowReset(&r);
+    s->typesDropped.store(0, std::memory_order_relaxed);
+    s->slotsDropped.store(0, std::memory_order_relaxed);
+}
+
+inline CombatStatRow* CombatStatsSlotRow(CombatStats* s, int slot) {
+    if (slot < 0 || slot >= COMBAT_STATS_SLOTS) {
+        s->slotsDropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &s->slot[slot];
+}
+
+// The row for `type`, claiming a free one on first sight. Null for type 0
+// and, counted in typesDropped, when the probe finds neither.
+inline CombatStatRow* CombatStatsTypeRow(CombatStats* s, uint64_t type) {
+    if (!type) return nullptr;
+    uint32_t i = (uint32_t)((type >> 4) * 0x9E3779B97F4A7C15ULL >> 32) & (COMBAT_STATS_TYPES - 1);
+    for (int n = 0; n < COMBAT_STATS_PROBE; n++, i = (i + 1) & (COMBAT_STATS_TYPES - 1)) {
+        uint64_t key = s->typeKey[i].load(std::memory_order_acquire);
+        if (key == type) return &s->type[i];
+        if (key == 0) {
+            if (s->typeKey[i].compare_exchange_strong(key, type, std::memory_order_acq_rel)) return &s->type[i];
+            if (key == type) return &s->type[i];
+        }
+    }
+    s->typesDropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+inline void CombatStatRowAddDamage(CombatStatRow* r, uint64_t sec, uint64_t q) {
+    std::atomic<uint64_t>& b = r->window[sec % COMBAT_STATS_BUCKETS];
+    const uint64_t stamp = (sec & 0xFFFF) << 48;
+    uint64_t w = b.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        if ((w & ~COMBAT_STATS_VALUE_MASK) != stamp) {
+            next = stamp | std::min(q, COMBAT_STATS_VALUE_MASK);
+        } else {
+            const uint64_t v = (w & COMBAT_STATS_VALUE_MASK) + q;
+            next = stamp | std::min(v, COMBAT_STATS_VALUE_MASK);
+        }
+    } while (!b.compare_exchange_weak(w, next, std::memory_order_relaxed));
+    r->taken.fetch_add(q, std::memory_order_relaxed);
+    r->hits.fetch_add(1, std::memory_order_relaxed);
+}
+
+// One hit of `damage` HP on a unit of `victimType` owned by victimSlot.
+// Non-positive and non-finite amounts are ignored.
+inline void CombatStatsRecordDamage(CombatStats* s, int victimSlot, uint64_t victimType, float damage,
+                                    uint64_t nowMs) {
+    if (!(damage > 0.0f) || !std::isfinite(damage)) return;
+    const uint64_t q = (uint64_t)((double)damage * COMBAT_STATS_FIXED + 0.5);
+    if (!q) return;
+    const uint64_t sec = nowMs / 1000;
+    if (CombatStatRow* r = CombatStatsSlotRow(s, victimSlot)) CombatStatRowAddDamage(r, sec, q);
+    if (CombatStatRow* r = CombatStatsTypeRow(s, victimType)) CombatStatRowAddDamage(r, sec, q);
+}
+
+// One death. The killer side is skipped when there is no killer slot / type
+// (environmental deaths).
+inline void CombatStatsRecordDeath(CombatStats* s, int victimSlot, uint64_t victimType,
+                                   int killerSlot, uint64_t killerType) {
+    if (CombatStatRow* r = CombatStatsSlotRow(s, victimSlot)) r->deaths.fetch_add(1, std::memory_order_relaxed);
+    if (CombatStatRow* r = CombatStatsTypeRow(s, victimType)) r->deaths.fetch_add(1, std::memory_order_relaxed);
+    if (killerSlot >= 0)
+        if (CombatStatRow* r = CombatStatsSlotRow(s, killerSlot)) r->kills.fetch_add(1, std::memory_order_relaxed);
+    if (CombatStatRow* r = CombatStatsTypeRow(s, killerType)) r->kills.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline int CombatStatsClampWindow(int windowS) {
+    return windowS < 1 ? 1 : windowS > COMBAT_STATS_MAX_WINDOW ? COMBAT_STATS_MAX_WINDOW : windowS;
+}
+
+// HP taken in the last windowS seconds, the current one included.
+inline double CombatStatRowWindow(const CombatStatRow& r, uint64_t nowMs, int windowS) {
+    windowS = CombatStatsClampWindow(windowS);
+    const uint64_t sec = nowMs / 1000;
+    uint64_t sum = 0;
+    for (int i = 0; i < windowS && (uint64_t)i <= sec; i++) {
+        const uint64_t at = sec - i;
+        const uint64_t w = r.window[at % COMBAT_STATS_BUCKETS].load(std::memory_order_relaxed);
+        if ((w >> 48) == (at & 0xFFFF)) sum += w & COMBAT_STATS_VALUE_MASK;
+    }
+    return (double)sum / COMBAT_STATS_FIXED;
+}
+
+inline bool CombatStatRowEmpty(const CombatStatRow& r) {
+    return !r.hits.load(std::memory_order_relaxed) && !r.kills.load(std::memory_order_relaxed)
+        && !r.deaths.load(std::memory_order_relaxed);
+}
+
+inline size_t CombatStatsAppendRow(char* buf, size_t off, size_t cap, const char* key, const char* name,
+                                   const CombatStatRow& r, uint64_t nowMs, int windowS) {
+    if (off >= cap) return off;
+    const double window = CombatStatRowWindow(r, nowMs, windowS);
+    const int n = snprintf(buf + off, cap - off, "%s=%s taken=%.1f dps=%.1f total=%.1f hits=%u kills=%u deaths=%u\n",
+                           key, name, window, window / CombatStatsClampWindow(windowS),
+                           (double)r.taken.load(std::memory_order_relaxed) / COMBAT_STATS_FIXED,
+                           r.hits.load(std::memory_order_relaxed), r.kills.load(std::memory_order_relaxed),
+                           r.deaths.load(std::memory_order_relaxed));
+    if (n < 0) return off;
+    return (size_t)n >= cap - off ? cap - 1 : off + (size_t)n;
+}
+
+// The summary: a header line, one line per slot with activity, then the
+// COMBAT_STATS_TOP_TYPES most damaged types in the window (ties broken by
+// total). typeName(type, out, cap) writes a type's display name.
+//
+//   window=10 types=3 types_dropped=0 slots_dropped=0
+//   slot=1 taken=420.0 dps=42.0 total=1310.5 hits=57 kills=3 deaths=1
+//   type=TIE_Fighter taken=400.0 dps=40.0 total=900.0 hits=40 kills=0 deaths=1
+template <typename TypeName>
+inline size_t CombatStatsFormat(const CombatStats& s, uint64_t nowMs, int windowS, TypeName&& typeName,
+                                char* buf, size_t cap) {
+    if (!cap) return 0;
+    buf[0] = 0;
+    windowS = CombatStatsClampWindow(windowS);
+
+    struct Ranked { int idx; double window; uint64_t total; };
+    Ranked ranked[COMBAT_STATS_TYPES];
+    int types = 0;
+    for (int i = 0; i < COMBAT_STATS_TYPES; i++) {
+        if (!s.typeKey[i].load(std::memory_order_acquire) || CombatStatRowEmpty(s.type[i])) continue;
+        ranked[types++] = {i, CombatStatRowWindow(s.type[i], nowMs, windowS),
+                           s.type[i].taken.load(std::memory_order_relaxed)};
+    }
+    std::sort(ranked, ranked + types, [](const Ranked& a, const Ranked& b) {
+        return a.window != b.window ? a.window > b.window : a.total > b.total;
+    });
+
+    size_t off = 0;
+    const int n = snprintf(buf, cap, "window=%d types=%d types_dropped=%u slots_dropped=%u\n", windowS, types,
+                           s.typesDropped.load(std::memory_order_relaxed),
+                           s.slotsDropped.load(std::memory_order_relaxed));
+    if (n > 0) off = (size_t)n >= cap ? cap - 1 : (size_t)n;
+    char name[64];
+    for (int i = 0; i < COMBAT_STATS_SLOTS; i++) {
+        if (CombatStatRowEmpty(s.slot[i])) continue;
+        snprintf(name, sizeof(name), "%d", i);
+        off = CombatStatsAppendRow(buf, off, cap, "slot", name, s.slot[i], nowMs, windowS);
+    }
+    for (int i = 0; i < types && i < COMBAT_STATS_TOP_TYPES; i++) {
+        const uint64_t type = s.typeKey[ranked[i].idx].load(std::memory_order_relaxed);
+        name[0] = 0;
+        typeName(type, name, sizeof(name));
+        if (!name[0]) snprintf(name, sizeof(name), "0x%llx", (unsigned long long)type);
+        off = CombatStatsAppendRow(buf, off, cap, "type", name, s.type[ranked[i].idx], nowMs, windowS);
+    }
+    return off;
+}
@@ -0,0 +1,230 @@
+#pragma once
+// crash_trail.h -- what the bridge was doing when it crashed: a ring of the
+// last commands it executed, per-thread hook breadcrumbs and a sorted
+// symbol table, all read by CrashHandler without locks or heap.
+//
+// A crash report used to carry registers, five stack words and a linear
+// scan over knownFuncs, which could not say which pipe command or detour
+// was running under heavy automation. Now:
+//
+//   * Every pipe command, batch chunk and shared-memory command is logged
+//     into CrashTrail before it runs: one fetch_add on `head` claims the
+//     next of CRASH_TRAIL_SLOTS entries (oldest overwritten, never blocks)
+//     and a seqlock-style `seq` (odd while the text is copied) lets the
+//     crash handler skip an entry caught mid-write. CrashTrailEnd marks it
+//     finished, so the report shows which command never completed.
+//   * Each thread keeps a CrashCrumbs stack of the detours it is inside (up
+//     to CRASH_CRUMB_DEPTH deep) and the last one it entered. It is written
+//     with plain stores by its own thread only; the unhandled-exception
+//     filter runs on the faulting thread and reads its own crumbs.
+//   * CrashSymbolFind is a binary search over a table sorted once at init.
+//
+// Timestamps are whatever monotonic tick the caller passes (the cycle
+// counter in the bridge); the formatter prints them as age relative to
+// `now` given the tick frequency.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#define CRASH_TRAIL_SLOTS  64   // power of two
+#define CRASH_TRAIL_TEXT   96   // command prefix kept per entry, NUL included
+#define CRASH_CRUMB_DEPTH  4
+
+enum CrashTrailKind : uint32_t {
+    CRASH_TRAIL_PIPE = 0,  // one pipe command (ExecutePipeSlot)
+    CRASH_TRAIL_BATCH,     // one chunk of an "@batch" slot
+    CRASH_TRAIL_SHM,       // shared-memory command buffer / ring
+};
+
+inline const char* CrashTrailKindName(uint32_t kind) {
+    switch (kind) {
+    case CRASH_TRAIL_PIPE:  return "pipe";
+    case CRASH_TRAIL_BATCH: return "batch";
+    case CRASH_TRAIL_SHM:   return "shm";
+    default:                return "?";
+    }
+}
+
+struct CrashTrailEntry {
+    std::atomic<uint64_t> seq;   // 2*pos+1 while writing, 2*pos+2 once published
+    std::atomic<uint32_t> done;  // set by CrashTrailEnd
+    uint32_t              kind;
+    uint32_t              tid;
+    int64_t               tick;
+    char                  text[CRASH_TRAIL_TEXT];
+};
+
+struct CrashTrail {
+    CrashTrailEntry       entries[CRASH_TRAIL_SLOTS];
+    std::atomic<uint64_t> head;  // next position to claim
+};
+
+inline void CrashTrailInit(CrashTrail* t) {
+    for (auto& e : t->entries) {
+        e.seq.store(0, std::memory_order_relaxed);
+        e.done.store(0, std::memory_order_relaxed);
+        e.text[0] = '\0';
+    }
+    t->head.store(0, std::memory_order_relaxed);
+}
+
+// Records a command about to run. Returns its position for CrashTrailEnd.
+inline uint64_t CrashTrailBegin(CrashTrail* t, uint32_t kind, uint32_t tid, int64_t tick, const char* text) {
+    const uint64_t pos = t->head.fetch_add(1, std::memory_order_relaxed);
+    CrashTrailEntry* e = &t->entries[pos & (CRASH_TRAIL_SLOTS - 1)];
+    e->seq.store(2 * pos + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    e->kind = kind;
+    e->tid  = tid;
+    e->tick = tick;
+    e->done.store(0, std::memory_order_relaxed);
+    size_t n = 0;
+    if (text) {
+        // Keep the prefix; newlines would break the one-line-per-entry report.
+        for (; n < CRASH_TRAIL_TEXT - 1 && text[n]; n++) {
+            e->text[n] = (text[n] == '\r' || text[n] == '\n') ? ' ' : text[n];
+        }
+    }
+    e->text[n] = '\0';
+    e->seq.store(2 * pos + 2, std::memory_order_release);
+    return pos;
+}
+
+// Marks the command at `pos` finished, unless its entry was reused since.
+inline void CrashTrailEnd(CrashTrail* t, uint64_t pos) {
+    CrashTrailEntry* e = &t->entries[pos & (CRASH_TRAIL_SLOTS - 1)];
+    if (e->seq.load(std::memory_order_acquire) == 2 * pos + 2) e->done.store(1, std::memory_order_release);
+}
+
+struct CrashTrailRecord {
+    uint64_t pos;
+    uint32_t kind;
+    uint32_t tid;
+    int64_t  tick;
+    bool     done;
+    char     text[CRASH_TRAIL_TEXT];
+};
+
+// Copies up to `max` of the newest published entries, oldest first. Entries
+// being rewritten while we read are skipped.
+inline uint32_t CrashTrailSnapshot(const CrashTrail* t, CrashTrailRecord* out, uint32_t max) {
+    const uint64_t head = t->head.load(std::memory_order_acquire);
+    uint64_t first = head > CRASH_TRAIL_SLOTS ? head - CRASH_TRAIL_SLOTS : 0;
+    if (head - first > max) first = head - max;
+    uint32_t n = 0;
+    for (uint64_t pos = first; pos < head; pos++) {
+        const CrashTrailEntry* e = &t->entries[pos & (CRASH_TRAIL_SLOTS - 1)];
+        if (e->seq.load(std::memory_order_acquire) != 2 * pos + 2) continue;
+        CrashTrailRecord* r = &out[n];
+        r->pos  = pos;
+        r->kind = e->kind;
+        r->tid  = e->tid;
+        r->tick = e->tick;
+        r->done = e->done.load(std::memory_order_acquire) != 0;
+        memcpy(r->text, e->text, CRASH_TRAIL_TEXT);
+        r->text[CRASH_TRAIL_TEXT - 1] = '\0';
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e->seq.load(std::memory_order_relaxed) != 2 * pos + 2) continue;
+        n++;
+    }
+    return n;
+}
+
+// Per-thread detour breadcrumbs. Only the owning thread writes them.
+struct CrashCrumbs {
+    uint32_t depth;                       // detours currently entered (may exceed the stack)
+    uint32_t hooks[CRASH_CRUMB_DEPTH];    // innermost last
+    int64_t  entered[CRASH_CRUMB_DEPTH];
+    uint32_t lastHook;                    // most recent entry, +1 (0 = none yet)
+    int64_t  lastTick;
+    uint64_t entries;
+};
+
+inline void CrashCrumbEnter(CrashCrumbs* c, uint32_t hook, int64_t tick) {
+    if (c->depth < CRASH_CRUMB_DEPTH) {
+        c->hooks[c->depth]   = hook;
+        c->entered[c->depth] = tick;
+    }
+    c->depth++;
+    c->lastHook = hook + 1;
+    c->lastTick = tick;
+    c->entries++;
+}
+
+inline void CrashCrumbLeave(CrashCrumbs* c) {
+    if (c->depth) c->depth--;
+}
+
+struct CrashSymbol {
+    uintptr_t   rva;
+    const char* name;
+};
+
+inline void CrashSymbolSort(CrashSymbol* syms, size_t n) {
+    std::sort(syms, syms + n, [](const CrashSymbol& a, const CrashSymbol& b) { return a.rva < b.rva; });
+}
+
+// Nearest symbol at or below `rva` in a table sorted by CrashSymbolSort.
+inline const CrashSymbol* CrashSymbolFind(const CrashSymbol* syms, size_t n, uintptr_t rva) {
+    size_t lo = 0, hi = n;  // first index with syms[i].rva > rva
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (syms[mid].rva <= rva) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo ? &syms[lo - 1] : nullptr;
+}
+
+inline int CrashAppend(char* buf, int cap, int* pos, const char* fmt, ...) {
+    if (*pos >= cap - 1) return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *pos, (size_t)(cap - *pos), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    if (n > cap - 1 - *pos) n = cap - 1 - *pos;  // truncated: keep what fit
+    *pos += n;
+    return n;
+}
+
+// Report sections for the crashing thread's crumbs and the trail. `hookName`
+// maps a hook id to its name; ages are (now - tick) * 1000 / freq in ms.
+template <typename HookName>
+inline void CrashFormatTrail(char* buf, int cap, int* pos, const CrashCrumbs* crumbs, const CrashTrail* trail,
+                             int64_t now, int64_t freq, HookName&& hookName) {
+    auto ageMs = [now, freq](int64_t tick) -> double {
+        return freq > 0 ? (double)(now - tick) * 1000.0 / (double)freq : 0.0;
+    };
+    CrashAppend(buf, cap, pos, "Hooks on the crashing thread:\r\n");
+    if (!crumbs || crumbs->entries == 0) {
+        CrashAppend(buf, cap, pos, "  (no bridge detour ran on this thread)\r\n");
+    } else {
+        const uint32_t shown = crumbs->depth < CRASH_CRUMB_DEPTH ? crumbs->depth : CRASH_CRUMB_DEPTH;
+        if (crumbs->depth == 0) CrashAppend(buf, cap, pos, "  inside: none\r\n");
+        for (uint32_t i = shown; i-- > 0;) {
+            CrashAppend(buf, cap, pos, "  inside: %s (entered %.1f ms ago)\r\n", hookName(crumbs->hooks[i]),
+                        ageMs(crumbs->entered[i]));
+        }
+        if (crumbs->depth > shown) CrashAppend(buf, cap, pos, "  ... %u more\r\n", crumbs->depth - shown);
+        CrashAppend(buf, cap, pos, "  last entered: %s (%.1f ms ago), %llu detour calls on this thread\r\n",
+                    crumbs->lastHook ? hookName(crumbs->lastHook - 1) : "none", ageMs(crumbs->lastTick),
+                    (unsigned long long)crumbs->entries);
+    }
+
+    static CrashTrailRecord records[CRASH_TRAIL_SLOTS];  // static: the crash may be a stack overflow
+    const uint32_t n = trail ? CrashTrailSnapshot(trail, records, CRASH_TRAIL_SLOTS) : 0;
+    CrashAppend(buf, cap, pos, "\r\nRecent commands (oldest first, %u):\r\n", n);
+    if (n == 0) CrashAppend(buf, cap, pos, "  (none)\r\n");
+    for (uint32_t i = 0; i < n; i++) {
+        const CrashTrailRecord* r = &records[i];
+        CrashAppend(buf, cap, pos, "  #%llu %-5s tid=%u %8.1f ms ago %s %s\r\n", (unsigned long long)r->pos,
+                    CrashTrailKindName(r->kind), r->tid, ageMs(r->tick), r->done ? "done   " : "RUNNING", r->text);
+    }
+}
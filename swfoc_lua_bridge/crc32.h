@@ -0,0 +1,66 @@
+#pragma once
+// crc32.h -- the snapshot CRC32 shared by lua_bridge.cpp, replay_harness.cpp
+// and test_harness.cpp.
+//
+// Polynomial 0xEDB88320, reflected, init/xor 0xFFFFFFFF: the zlib/PKZIP
+// CRC, so make_test_snapshot.py's zlib.crc32 agrees byte for byte. Each
+// file used to carry its own byte-at-a-time copy with a lazily built table;
+// this one is slicing-by-8:
+//
+//   * Eight 256-entry tables, built at compile time (no init call, no
+//     first-use race between the writer's I/O thread and replay workers).
+//   * The main loop folds 8 input bytes per step with eight independent
+//     table loads instead of a chain of eight dependent ones; head and
+//     tail bytes go through table 0 as before.
+//
+// The x86 crc32 instruction (SSE4.2) computes CRC32C, a different
+// polynomial, so it cannot produce this checksum without changing the
+// file format.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct Crc32Tables {
+    uint32_t t[8][256];
+};
+
+constexpr Crc32Tables Crc32MakeTables() {
+    Crc32Tables r = {};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        r.t[0][i] = c;
+    }
+    for (int s = 1; s < 8; s++) {
+        for (uint32_t i = 0; i < 256; i++) r.t[s][i] = (r.t[s - 1][i] >> 8) ^ r.t[0][r.t[s - 1][i] & 0xFFu];
+    }
+    return r;
+}
+
+inline constexpr Crc32Tables kCrc32Tables = Crc32MakeTables();
+
+// Running CRC: pass 0 to start, or the previous result to continue.
+inline uint32_t Crc32_Update(uint32_t crc, const void* data, size_t len) {
+    const uint32_t (*t)[256] = kCrc32Tables.t;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc ^= 0xFFFFFFFFu;
+    while (len && (reinterpret_cast<uintptr_t>(p) & 7)) {
+        crc = t[0][(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+        len--;
+    }
+    while (len >= 8) {
+        uint32_t lo, hi;  // little-endian words, as on every bridge target
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xFFu] ^ t[6][(lo >> 8) & 0xFFu] ^ t[5][(lo >> 16) & 0xFFu] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFFu] ^ t[2][(hi >> 8) & 0xFFu] ^ t[1][(hi >> 16) & 0xFFu] ^ t[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = t[0][(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,267 @@
+#pragma once
+// csv_row.h -- append-only builder for the "count=N|a;b;c|..." list replies.
+//
+// SWFOC_ListTacticalUnits, SWFOC_EnumerateUnits, SWFOC_EventStreamDrain,
+// SWFOC_GetAllPlayers and SWFOC_GetHardpoints, and the replay observers
+// ReplayObsListAllPlayers / ReplayObsListHeroes, used to format every field
+// through snprintf: one vararg call, one format-string parse and a locale
+// lookup per row. They now append through a CsvRow instead:
+//
+//   * Integers are written digit by digit; no format string.
+//   * CsvRowFixed writes "%.<d>f" (d = 0..3) from the exact binary value of
+//     the double, rounding ties to even, so the bytes match the CRT's
+//     printf. Non-finite values and magnitudes of 2^63 or more still go
+//     through snprintf.
+//   * Appends clamp at the end of the buffer exactly like SafeAppendFmt (a
+//     field that does not fit is cut, the buffer stays NUL-terminated), so
+//     the live truncation markers behave as before.
+//
+// Live and replay emitters share this code, so a fixture row and a live row
+// with the same values are byte-identical.
+//
+// No std::to_chars: the bridge builds as C++14 (build.bat).
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#define CSV_U64_MAX    20  // digits of 2^64 - 1
+#define CSV_I64_MAX    20  // sign + digits of 2^63
+#define CSV_FIXED_MAX  24  // "-" + 19 digits + "." + 3 below 2^63
+#define CSV_FLOAT_FIXED_MAX 44  // "-" + 39 digits (FLT_MAX) + "." + 3: any float
+#define CSV_FIXED_SCRATCH 352  // any double through the snprintf path (DBL_MAX: 309 digits)
+
+struct CsvRow {
+    char*  buf;
+    size_t cap;  // buffer size, NUL included
+    size_t len;
+};
+
+inline void CsvRowInit(CsvRow* r, char* buf, size_t cap) {
+    r->buf = buf;
+    r->cap = cap;
+    r->len = 0;
+    if (buf && cap) buf[0] = '\0';
+}
+
+// Rows of `rowMax` bytes after a `header`-byte prefix, plus the NUL.
+inline size_t CsvRowCapacity(size_t header, size_t rows, size_t rowMax) {
+    return header + rows * rowMax + 1;
+}
+
+inline void CsvRowPut(CsvRow* r, const char* s, size_t n) {
+    if (!r->buf || r->cap == 0 || r->len >= r->cap - 1) return;
+    const size_t room = r->cap - 1 - r->len;
+    if (n > room) n = room;
+    memcpy(r->buf + r->len, s, n);
+    r->len += n;
+    r->buf[r->len] = '\0';
+}
+
+inline void CsvRowStr(CsvRow* r, const char* s) {
+    CsvRowPut(r, s, strlen(s));
+}
+
+inline void CsvRowChar(CsvRow* r, char c) {
+    CsvRowPut(r, &c, 1);
+}
+
+// Writes v in decimal ending just before `end`; returns the first digit.
+inline char* CsvDigitsBackward(char* end, uint64_t v) {
+    do {
+        *--end = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v);
+    return end;
+}
+
+inline void CsvRowU64(CsvRow* r, uint64_t v) {
+    char tmp[CSV_U64_MAX];
+    char* p = CsvDigitsBackward(tmp + sizeof(tmp), v);
+    CsvRowPut(r, p, static_cast<size_t>(tmp + sizeof(tmp) - p));
+}
+
+inline void CsvRowI64(CsvRow* r, int64_t v) {
+    char tmp[CSV_I64_MAX];
+    const uint64_t mag = v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v);
+    char* p = CsvDigitsBackward(tmp + sizeof(tmp), mag);
+    if (v < 0) *--p = '-';
+    CsvRowPut(r, p, static_cast<size_t>(tmp + sizeof(tmp) - p));
+}
+
+// "%016llX"
+inline void CsvRowHex16(CsvRow* r, uint64_t v) {
+    static const char kHex[] = "0123456789ABCDEF";
+    char tmp[16];
+    for (int i = 15; i >= 0; i--) {
+        tmp[i] = kHex[v & 0xF];
+        v >>= 4;
+    }
+    CsvRowPut(r, tmp, sizeof(tmp));
+}
+
+// "%.<decimals>f" of v into out (CSV_FIXED_SCRATCH bytes); returns the
+// length. decimals is 0..3.
+//
+// v = m * 2^-sh exactly (m < 2^53). The integer part is m >> sh; the
+// fractional bits times 10^decimals fit in 63 bits, so the digits and the
+// rounding decision are exact -- no double arithmetic after frexp.
+inline size_t CsvFormatFixed(char* out, double v, int decimals) {
+    if (decimals < 0) decimals = 0;
+    if (decimals > 3) decimals = 3;
+    const double a = std::fabs(v);
+    if (!std::isfinite(v) || a >= 9223372036854775808.0) {
+        const int n = snprintf(out, CSV_FIXED_SCRATCH, "%.*f", decimals, v);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+    static const uint64_t kScale[4] = {1, 10, 100, 1000};
+    const uint64_t scale = kScale[decimals];
+
+    uint64_t ip = 0;     // integer part
+    uint64_t fd = 0;     // fractional digits, 0 .. scale
+    int exp = 0;
+    const double f = std::frexp(a, &exp);               // a = f * 2^exp, f in [0.5, 1)
+    if (a != 0.0 && exp >= -11) {                       // below 2^-12 every digit is 0
+        const uint64_t m = static_cast<uint64_t>(std::ldexp(f, 53));
+        const int sh = 53 - exp;                        // fractional bits, <= 64
+        if (sh <= 0) {
+            ip = m << -sh;
+        } else {
+            ip = sh < 64 ? m >> sh : 0;
+            const uint64_t frac = sh < 64 ? m & ((uint64_t(1) << sh) - 1) : m;
+            const uint64_t scaled = frac * scale;       // < 2^63
+            fd = sh < 64 ? scaled >> sh : 0;
+            const uint64_t rem = sh < 64 ? scaled & ((uint64_t(1) << sh) - 1) : scaled;
+            const uint64_t half = uint64_t(1) << (sh - 1);
+            const uint64_t last = decimals ? fd : ip;
+            if (rem > half || (rem == half && (last & 1))) fd++;
+            if (fd == scale) {
+                fd = 0;
+                ip++;
+            }
+        }
+    }
+
+    char tmp[CSV_FIXED_MAX];
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+    if (decimals) {
+        for (int i = 0; i < decimals; i++) {
+            *--p = static_cast<char>('0' + fd % 10);
+            fd /= 10;
+        }
+        *--p = '.';
+    }
+    p = CsvDigitsBackward(p, ip);
+    if (std::signbit(v)) *--p = '-';
+    const size_t n = static_cast<size_t>(end - p);
+    memcpy(out, p, n);
+    out[n] = '\0';
+    return n;
+}
+
+inline void CsvRowFixed(CsvRow* r, double v, int decimals) {
+    char tmp[CSV_FIXED_SCRATCH];
+    CsvRowPut(r, tmp, CsvFormatFixed(tmp, v, decimals));
+}
+
+// ---- Shared row shapes ---------------------------------------------------
+// One function per row contract, called by the live helper and its replay
+// observer alike.
+
+// "count=%d"
+inline void CsvRowCount(CsvRow* r, int64_t count) {
+    CsvRowStr(r, "count=");
+    CsvRowI64(r, count);
+}
+
+// SWFOC_ListTacticalUnits / SWFOC_EnumerateUnits:
+//   "|%llu;%d;%.3f;%u;%u;%d;%d"
+//   obj_addr;owner_slot;hull;invuln_flag;prevent_death_bit;is_local;is_selected
+#define CSV_UNIT_ROW_MAX (1 + CSV_U64_MAX + 1 + CSV_I64_MAX + 1 + CSV_FLOAT_FIXED_MAX + 4 * (1 + CSV_I64_MAX))
+
+inline void CsvRowUnit(CsvRow* r, uint64_t addr, int32_t owner, float hull, uint32_t invuln,
+                       uint32_t pdb, int isLocal, int selected) {
+    CsvRowChar(r, '|');
+    CsvRowU64(r, addr);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, owner);
+    CsvRowChar(r, ';');
+    CsvRowFixed(r, hull, 3);
+    CsvRowChar(r, ';');
+    CsvRowU64(r, invuln);
+    CsvRowChar(r, ';');
+    CsvRowU64(r, pdb);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, isLocal);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, selected);
+}
+
+// SWFOC_EventStreamDrain:
+//   "|%llu;%llu;%d;%.3f;%.3f"
+//   timestamp_ms;obj_addr;owner_slot;requested_hp;current_hp
+#define CSV_EVENT_ROW_MAX (1 + CSV_U64_MAX + 1 + CSV_U64_MAX + 1 + CSV_I64_MAX + 2 * (1 + CSV_FLOAT_FIXED_MAX))
+
+inline void CsvRowDamageEvent(CsvRow* r, uint64_t timestampMs, uint64_t addr, int32_t owner,
+                              float requestedHp, float currentHp) {
+    CsvRowChar(r, '|');
+    CsvRowU64(r, timestampMs);
+    CsvRowChar(r, ';');
+    CsvRowU64(r, addr);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, owner);
+    CsvRowChar(r, ';');
+    CsvRowFixed(r, requestedHp, 3);
+    CsvRowChar(r, ';');
+    CsvRowFixed(r, currentHp, 3);
+}
+
+// SWFOC_GetAllPlayers:
+//   "|%d;%s;%.3f;%d;%d;%d;%d"
+//   slot;faction;credits;tech_level;is_human;is_local;unit_count
+// CSV_PLAYER_ROW_MAX leaves out the faction name. Credits are a float live
+// and a double in the replay model.
+#define CSV_PLAYER_ROW_MAX (1 + CSV_I64_MAX + 1 + 1 + CSV_FIXED_MAX + 4 * (1 + CSV_I64_MAX))
+
+inline void CsvRowPlayer(CsvRow* r, int64_t slot, const char* faction, double credits, int32_t tech,
+                         int isHuman, int isLocal, int unitCount) {
+    CsvRowChar(r, '|');
+    CsvRowI64(r, slot);
+    CsvRowChar(r, ';');
+    CsvRowStr(r, faction);
+    CsvRowChar(r, ';');
+    CsvRowFixed(r, credits, 3);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, tech);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, isHuman);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, isLocal);
+    CsvRowChar(r, ';');
+    CsvRowI64(r, unitCount);
+}
+
+// Runs fill(CsvRow*) into a string of `estimate` bytes and returns what it
+// wrote. A reply that fills the buffer is rebuilt at twice the size, so an
+// estimate from CSV_*_MAX only costs a retry when a value is wider than the
+// bound (a fixed field of 2^63 or more, a long name).
+template <typename Fill>
+inline std::string CsvRowBuildString(size_t estimate, Fill fill) {
+    std::string out;
+    for (size_t cap = estimate < 64 ? 64 : estimate;; cap *= 2) {
+        out.resize(cap);
+        CsvRow r;
+        CsvRowInit(&r, &out[0], cap);
+        fill(&r);
+        if (r.len < cap - 1) {
+            out.resize(r.len);
+            return out;
+        }
+    }
+}
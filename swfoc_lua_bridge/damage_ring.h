@@ -0,0 +1,174 @@
+#pragma once
+// damage_ring.h -- per-thread damage-event rings behind
+// SWFOC_EventStreamDrain.
+//
+// Detour_SetHP runs on whichever engine thread applies damage. v1 shared
+// one 256-entry array between all of them: a burst overwrote events the
+// drain was still formatting, and the drain's lock sat next to the hook
+// path. Here each engine thread claims its own single-writer ring on first
+// push:
+//
+//   * Writer (hook thread): wait-free -- one relaxed load of its own head,
+//     one acquire load of tail, a copy and a release store. A full ring
+//     drops the new event and bumps `dropped`; it never overwrites an event
+//     the reader has not consumed.
+//   * Reader (SWFOC_EventStreamDrain, one at a time): copies events out and
+//     advances tail. Formatting happens after the copy, touching nothing
+//     the hook uses.
+//   * Capacity is configurable (DamageRingSetCapacity). A writer adopts a
+//     new capacity the next time it finds its ring empty; the reader never
+//     touches storage of an empty ring, so the old block can be freed there.
+//   * Threads beyond DAMAGE_RING_THREADS get no ring; their events are
+//     counted in `unowned_drops`.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#define DAMAGE_RING_THREADS      16
+#define DAMAGE_RING_CAP_DEFAULT  4096   // events per thread
+#define DAMAGE_RING_CAP_MIN      256
+#define DAMAGE_RING_CAP_MAX      65536
+
+struct DamageEvent {
+    uint64_t timestamp_ms;
+    uint64_t obj_addr;
+    int32_t  owner_slot;
+    float    requested_hp;
+    float    current_hp;
+};
+
+struct DamageRingStorage {
+    uint32_t    mask;      // capacity - 1
+    DamageEvent events[1]; // capacity entries
+};
+
+struct DamageThreadRing {
+    std::atomic<uint32_t>           owner;    // thread id, 0 = unclaimed
+    std::atomic<DamageRingStorage*> storage;  // replaced only by the writer while empty
+    std::atomic<uint32_t>           head;     // writer-owned, monotonic
+    std::atomic<uint32_t>           tail;     // reader-owned, monotonic
+    std::atomic<uint32_t>           dropped;  // events refused because the ring was full
+};
+
+struct DamageRingSet {
+    DamageThreadRing      rings[DAMAGE_RING_THREADS];
+    std::atomic<uint32_t> capacity;       // applied when a ring is next empty
+    std::atomic<uint32_t> unowned_drops;  // pushes from threads without a ring
+};
+
+inline uint32_t DamageRingRoundCapacity(uint32_t n) {
+    if (n < DAMAGE_RING_CAP_MIN) n = DAMAGE_RING_CAP_MIN;
+    if (n > DAMAGE_RING_CAP_MAX) n = DAMAGE_RING_CAP_MAX;
+    uint32_t cap = DAMAGE_RING_CAP_MIN;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+
+inline DamageRingStorage* DamageRingAlloc(uint32_t capacity) {
+    DamageRingStorage* s = static_cast<DamageRingStorage*>(
+        malloc(sizeof(DamageRingStorage) + (capacity - 1) * sizeof(DamageEvent)));
+    if (s) s->mask = capacity - 1;
+    return s;
+}
+
+// Only call while no writer or reader can run (startup / tests).
+inline void DamageRingSetInit(DamageRingSet* set) {
+    for (int i = 0; i < DAMAGE_RING_THREADS; i++) {
+        DamageThreadRing* r = &set->rings[i];
+        r->owner.store(0, std::memory_order_relaxed);
+        r->storage.store(nullptr, std::memory_order_relaxed);
+        r->head.store(0, std::memory_order_relaxed);
+        r->tail.store(0, std::memory_order_relaxed);
+        r->dropped.store(0, std::memory_order_relaxed);
+    }
+    set->capacity.store(DAMAGE_RING_CAP_DEFAULT, std::memory_order_relaxed);
+    set->unowned_drops.store(0, std::memory_order_relaxed);
+}
+
+// Only call while no writer or reader can run (shutdown / tests).
+inline void DamageRingSetFree(DamageRingSet* set) {
+    for (int i = 0; i < DAMAGE_RING_THREADS; i++) {
+        free(set->rings[i].storage.exchange(nullptr, std::memory_order_relaxed));
+    }
+}
+
+// Returns the previous capacity. `n` is rounded up to a power of two
+// within [DAMAGE_RING_CAP_MIN, DAMAGE_RING_CAP_MAX].
+inline uint32_t DamageRingSetCapacity(DamageRingSet* set, uint32_t n) {
+    return set->capacity.exchange(DamageRingRoundCapacity(n), std::memory_order_relaxed);
+}
+
+// Claims a ring for thread `tid` (non-zero). Returns its index, or -1 when
+// every ring is owned by another thread.
+inline int DamageRingClaim(DamageRingSet* set, uint32_t tid) {
+    for (int i = 0; i < DAMAGE_RING_THREADS; i++) {
+        if (set->rings[i].owner.load(std::memory_order_relaxed) == tid) return i;
+    }
+    for (int i = 0; i < DAMAGE_RING_THREADS; i++) {
+        uint32_t expected = 0;
+        if (set->rings[i].owner.compare_exchange_strong(expected, tid, std::memory_order_acq_rel))
+            return i;
+    }
+    return -1;
+}
+
+// Writer side, called only by the ring's owner thread (ring < 0 counts an
+// unowned drop). Returns false when the event was dropped.
+inline bool DamageRingPush(DamageRingSet* set, int ring, const DamageEvent& ev) {
+    if (ring < 0 || ring >= DAMAGE_RING_THREADS) {
+        set->unowned_drops.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    DamageThreadRing* r = &set->rings[ring];
+    const uint32_t h = r->head.load(std::memory_order_relaxed);
+    const uint32_t t = r->tail.load(std::memory_order_acquire);
+    DamageRingStorage* s = r->storage.load(std::memory_order_relaxed);
+    if (h == t) {
+        const uint32_t want = set->capacity.load(std::memory_order_relaxed);
+        if (!s || s->mask + 1 != want) {
+            DamageRingStorage* fresh = DamageRingAlloc(want);
+            if (fresh) {
+                r->storage.store(fresh, std::memory_order_release);
+                free(s);
+                s = fresh;
+            }
+        }
+    }
+    if (!s || h - t > s->mask) {
+        r->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    s->events[h & s->mask] = ev;
+    r->head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+// Reader side (one reader at a time). Copies up to `max` unread events from
+// every ring into `out`, oldest first within each ring, and consumes them.
+// Returns the number copied; events beyond `max` stay for the next call.
+inline int DamageRingDrain(DamageRingSet* set, DamageEvent* out, int max) {
+    int n = 0;
+    for (int i = 0; i < DAMAGE_RING_THREADS && n < max; i++) {
+        DamageThreadRing* r = &set->rings[i];
+        const uint32_t t = r->tail.load(std::memory_order_relaxed);
+        const uint32_t h = r->head.load(std::memory_order_acquire);
+        if (h == t) continue;
+        const DamageRingStorage* s = r->storage.load(std::memory_order_acquire);
+        uint32_t take = h - t;
+        if (take > (uint32_t)(max - n)) take = (uint32_t)(max - n);
+        for (uint32_t k = 0; k < take; k++) out[n++] = s->events[(t + k) & s->mask];
+        r->tail.store(t + take, std::memory_order_release);
+    }
+    return n;
+}
+
+// Total events refused since startup (full rings + threads without a ring).
+inline uint64_t DamageRingDropped(const DamageRingSet* set) {
+    uint64_t n = set->unowned_drops.load(std::memory_order_relaxed);
+    for (int i = 0; i < DAMAGE_RING_THREADS; i++)
+        n += set->rings[i].dropped.load(std::memory_order_relaxed);
+    return n;
+}
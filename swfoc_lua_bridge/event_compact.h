@@ -0,0 +1,297 @@
+#pragma once
+// event_compact.h -- compact HP-change encoding for the shared event ring.
+//
+// Every damage tick used to cost one 24-byte EVT_HP_CHANGE record, so a
+// large battle filled the 64 KB ring in a few thousand hits. In compact
+// mode (SHMEM_EVT_FLAG_COMPACT, layout in shared_memory.h) the damage hook
+// packs its events instead:
+//
+//   * Session ids: a unit's first compact event claims a slot in a lock-free
+//     open-addressed table keyed on its ObjectID; the slot index is the
+//     16-bit session id. The claimer writes the EVT_UNIT_KEY binding, then
+//     publishes the slot -- other threads only use a published id, so the
+//     binding always precedes its uses in the ring. Keys carry the table
+//     epoch, so EvtSessionReset forgets every binding at once without
+//     racing a hook that is mid-claim.
+//   * Batches: each engine thread appends to its own staging batch (claimed
+//     on first use, like damage_ring.h), at ~8 bytes per event: a varint ms
+//     delta, the session id, 16-bit HP and damage fractions of max hull and
+//     the damage type. A batch goes out as one EVT_HP_BATCH record when it
+//     is full; Hook_luaD_call flushes batches older than
+//     EVT_COMPACT_MAX_AGE_MS so a quiet thread never sits on events.
+//   * A batch's `busy` flag serializes its owner's appends against that
+//     flush; the owner takes it uncontended except during a flush.
+//
+// The ring sink is a callback (type, payload, size) -> bool, so this file
+// never sees SharedEvtBuffer.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#define EVT_COMPACT_SESSION_SLOTS 4096  // power of two; session ids are slot indices
+#define EVT_COMPACT_PROBE         16
+#define EVT_COMPACT_THREADS       16
+#define EVT_COMPACT_BATCH_EVENTS  32
+#define EVT_COMPACT_BATCH_BYTES   384   // staged entry bytes per batch
+#define EVT_COMPACT_ENTRY_MAX     17    // 10-byte varint + 7 fixed bytes
+#define EVT_COMPACT_HEADER_MAX    11    // count + 10-byte varint
+#define EVT_COMPACT_RECORD_MAX    (EVT_COMPACT_HEADER_MAX + EVT_COMPACT_BATCH_BYTES)
+#define EVT_COMPACT_MAX_AGE_MS    50
+#define EVT_COMPACT_TYPE_HP_BATCH 0x06  // EventType::EVT_HP_BATCH (shared_memory.h)
+
+// ---- Varints (LEB128) and fractions ---------------------------------------
+
+inline uint32_t EvtVarintPut(uint8_t* p, uint64_t v) {
+    uint32_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// Bytes consumed, 0 when truncated or longer than 10 bytes.
+inline uint32_t EvtVarintGet(const uint8_t* p, uint32_t avail, uint64_t* v) {
+    uint64_t out = 0;
+    for (uint32_t n = 0; n < avail && n < 10; n++) {
+        out |= (uint64_t)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *v = out;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+// value / max scaled by 32767 (EVT_COMPACT_HP_SCALE), clamped to [0, 2);
+// 0xFFFF (EVT_COMPACT_HP_UNKNOWN) when max is not positive.
+inline uint16_t EvtQuantizeFraction(float value, float max) {
+    if (!(max > 0.0f)) return 0xFFFF;
+    const float q = value / max * 32767.0f + 0.5f;
+    if (!(q > 0.0f)) return 0;  // also NaN
+    if (q >= 65534.0f) return 65534;
+    return (uint16_t)q;
+}
+
+inline float EvtDequantizeFraction(uint16_t q, float max) {
+    return q == 0xFFFF ? -1.0f : (float)q / 32767.0f * max;
+}
+
+// ---- Session table ---------------------------------------------------------
+// key = epoch << 33 | published << 32 | unit_id; any other epoch is a free slot.
+
+struct EvtSessionTable {
+    std::atomic<uint64_t> key[EVT_COMPACT_SESSION_SLOTS];
+    std::atomic<uint32_t> epoch;  // 0 until the first reset
+    std::atomic<uint32_t> full;   // acquires that found no slot
+};
+
+inline void EvtSessionReset(EvtSessionTable* t) {
+    t->epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+inline uint32_t EvtSessionHome(uint32_t unitId) {
+    return (unitId * 2654435761u) >> (32 - 12);  // log2(EVT_COMPACT_SESSION_SLOTS)
+}
+static_assert(EVT_COMPACT_SESSION_SLOTS == 1 << 12, "EvtSessionHome shift");
+
+// The session id for unitId, or -1 (table full, or claimed by another thread
+// that has not published it yet). *claim is nonzero when this call took the
+// slot: the caller writes EVT_UNIT_KEY, then EvtSessionPublish or
+// EvtSessionRelease with that claim.
+inline int EvtSessionAcquire(EvtSessionTable* t, uint32_t unitId, uint64_t* claim) {
+    *claim = 0;
+    const uint64_t epoch = t->epoch.load(std::memory_order_acquire) & 0x7FFFFFFFu;
+    const uint64_t mine = epoch << 33 | unitId;
+    const uint32_t home = EvtSessionHome(unitId);
+    for (uint32_t i = 0; i < EVT_COMPACT_PROBE; i++) {
+        const uint32_t s = (home + i) & (EVT_COMPACT_SESSION_SLOTS - 1);
+        uint64_t k = t->key[s].load(std::memory_order_acquire);
+        for (;;) {
+            if (k >> 33 == epoch) {
+                if ((uint32_t)k != unitId) break;  // someone else's: probe on
+                return (k >> 32 & 1) ? (int)s : -1;
+            }
+            if (t->key[s].compare_exchange_weak(k, mine, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                *claim = mine;
+                return (int)s;
+            }
+        }
+    }
+    t->full.fetch_add(1, std::memory_order_relaxed);
+    return -1;
+}
+
+// Both are no-ops when a reset let another unit take the slot since.
+inline void EvtSessionPublish(EvtSessionTable* t, int sid, uint64_t claim) {
+    t->key[sid].compare_exchange_strong(claim, claim | 1ull << 32, std::memory_order_acq_rel);
+}
+
+// Gives a claimed slot back (its EVT_UNIT_KEY could not be written).
+inline void EvtSessionRelease(EvtSessionTable* t, int sid, uint64_t claim) {
+    t->key[sid].compare_exchange_strong(claim, 0, std::memory_order_acq_rel);
+}
+
+// ---- Per-thread batches ----------------------------------------------------
+
+struct EvtCompactBatch {
+    std::atomic<uint32_t> owner;  // thread id, 0 = unclaimed
+    std::atomic<uint32_t> busy;   // held by an append or a flush
+    std::atomic<uint64_t> firstMs;  // 0 = empty; read by the stale check
+    uint64_t lastMs;
+    uint32_t count;
+    uint32_t len;
+    uint8_t  body[EVT_COMPACT_BATCH_BYTES];
+};
+
+struct EvtCompactSet {
+    EvtCompactBatch       batches[EVT_COMPACT_THREADS];
+    EvtSessionTable       sessions;
+    uint64_t              baseMs;        // EvtStreamInfo::base_ms
+    std::atomic<uint32_t> staged;        // events waiting in batches
+    std::atomic<uint32_t> written;       // events that reached the ring in a batch
+    std::atomic<uint32_t> records;       // EVT_HP_BATCH records written
+    std::atomic<uint32_t> lost;          // events in batches the ring refused
+    std::atomic<uint32_t> unowned;       // appends from threads without a batch
+};
+
+inline int EvtCompactClaim(EvtCompactSet* set, uint32_t tid) {
+    for (int i = 0; i < EVT_COMPACT_THREADS; i++) {
+        if (set->batches[i].owner.load(std::memory_order_relaxed) == tid) return i;
+    }
+    for (int i = 0; i < EVT_COMPACT_THREADS; i++) {
+        uint32_t expected = 0;
+        if (set->batches[i].owner.compare_exchange_strong(expected, tid, std::memory_order_acq_rel))
+            return i;
+    }
+    return -1;
+}
+
+inline void EvtCompactLock(EvtCompactBatch* b) {
+    for (uint32_t spins = 0; b->busy.exchange(1, std::memory_order_acquire); spins++) {
+        if (spins >= 64) std::this_thread::yield();
+    }
+}
+
+inline void EvtCompactUnlock(EvtCompactBatch* b) {
+    b->busy.store(0, std::memory_order_release);
+}
+
+// Writes b's events as one EVT_HP_BATCH through sink and empties it. Caller
+// holds b->busy.
+template<typename Sink>
+inline void EvtCompactFlushLocked(EvtCompactSet* set, EvtCompactBatch* b, Sink&& sink) {
+    if (!b->count) return;
+    uint8_t rec[EVT_COMPACT_RECORD_MAX];
+    const uint64_t first = b->firstMs.load(std::memory_order_relaxed);
+    uint32_t n = 0;
+    rec[n++] = (uint8_t)b->count;
+    n += EvtVarintPut(rec + n, first >= set->baseMs ? first - set->baseMs : 0);
+    memcpy(rec + n, b->body, b->len);
+    n += b->len;
+    if (sink((uint16_t)EVT_COMPACT_TYPE_HP_BATCH, rec, (uint16_t)n)) {
+        set->written.fetch_add(b->count, std::memory_order_relaxed);
+        set->records.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        set->lost.fetch_add(b->count, std::memory_order_relaxed);
+    }
+    set->staged.fetch_sub(b->count, std::memory_order_relaxed);
+    b->count = 0;
+    b->len = 0;
+    b->firstMs.store(0, std::memory_order_relaxed);
+}
+
+// Owner thread: stages one event (batch < 0 counts it as unowned and
+// returns false, so the caller writes the full record instead).
+template<typename Sink>
+inline bool EvtCompactAppend(EvtCompactSet* set, int batch, uint64_t nowMs, uint16_t sid, uint16_t oldHp,
+                             uint16_t damage, int damageType, Sink&& sink) {
+    if (batch < 0 || batch >= EVT_COMPACT_THREADS) {
+        set->unowned.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    EvtCompactBatch* b = &set->batches[batch];
+    EvtCompactLock(b);
+    if (b->count >= EVT_COMPACT_BATCH_EVENTS || b->len + EVT_COMPACT_ENTRY_MAX > EVT_COMPACT_BATCH_BYTES)
+        EvtCompactFlushLocked(set, b, sink);
+    if (!b->count) {
+        b->firstMs.store(nowMs ? nowMs : 1, std::memory_order_relaxed);
+        b->lastMs = nowMs;
+    }
+    uint8_t* p = b->body + b->len;
+    uint32_t n = EvtVarintPut(p, nowMs > b->lastMs ? nowMs - b->lastMs : 0);
+    memcpy(p + n, &sid, 2);
+    memcpy(p + n + 2, &oldHp, 2);
+    memcpy(p + n + 4, &damage, 2);
+    p[n + 6] = (uint8_t)(damageType < 0 ? 0 : damageType > 0xFF ? 0xFF : damageType);
+    b->len += n + 7;
+    b->count++;
+    b->lastMs = nowMs;
+    set->staged.fetch_add(1, std::memory_order_relaxed);
+    if (b->count >= EVT_COMPACT_BATCH_EVENTS) EvtCompactFlushLocked(set, b, sink);
+    EvtCompactUnlock(b);
+    return true;
+}
+
+// Any thread: flushes every batch whose first event is at least maxAgeMs
+// old (0 = every non-empty batch). Returns the batches flushed.
+template<typename Sink>
+inline int EvtCompactFlushStale(EvtCompactSet* set, uint64_t nowMs, uint64_t maxAgeMs, Sink&& sink) {
+    int flushed = 0;
+    for (int i = 0; i < EVT_COMPACT_THREADS; i++) {
+        EvtCompactBatch* b = &set->batches[i];
+        const uint64_t first = b->firstMs.load(std::memory_order_relaxed);
+        if (!first || nowMs - first < maxAgeMs) continue;
+        EvtCompactLock(b);
+        if (b->count) {
+            EvtCompactFlushLocked(set, b, sink);
+            flushed++;
+        }
+        EvtCompactUnlock(b);
+    }
+    return flushed;
+}
+
+// ---- Reader ----------------------------------------------------------------
+
+struct EvtCompactHP {
+    uint64_t ms;          // since EvtStreamInfo::base_ms
+    uint16_t sid;
+    uint16_t old_hp;      // fraction of max hull, 0xFFFF = unknown
+    uint16_t damage;
+    uint8_t  damage_type;
+};
+
+// Calls visit(const EvtCompactHP&) for each event in an EVT_HP_BATCH
+// payload. Returns the event count, or -1 when the payload is malformed.
+template<typename Visit>
+inline int EvtCompactDecodeBatch(const uint8_t* p, uint32_t size, Visit&& visit) {
+    if (size < 1) return -1;
+    const uint32_t count = p[0];
+    uint32_t off = 1;
+    uint64_t ms = 0;
+    uint32_t used = EvtVarintGet(p + off, size - off, &ms);
+    if (!used) return -1;
+    off += used;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t dt = 0;
+        used = EvtVarintGet(p + off, size - off, &dt);
+        if (!used || off + used + 7 > size) return -1;
+        off += used;
+        EvtCompactHP e;
+        ms += dt;
+        e.ms = ms;
+        memcpy(&e.sid, p + off, 2);
+        memcpy(&e.old_hp, p + off + 2, 2);
+        memcpy(&e.damage, p + off + 4, 2);
+        e.damage_type = p[off + 6];
+        off += 7;
+        visit(e);
+    }
+    return off == size ? (int)count : -1;
+}
@@ -0,0 +1,129 @@
+// evt_ring_bench.cpp -- per-event cost of the shared event ring writer.
+//
+// Times ShmEvtWrite (shared_memory.h) uncontended in drop-free bursts and
+// with 4 producers racing one reader, next to a replica of the v1
+// WriteEvent (per-byte `% ringSize`, unaligned records) for comparison.
+// Payloads are the sizes of the real hook records: 16-byte EvtHPChange and
+// 8-byte EvtUnitDied.
+//
+// Build + run via build_evt_ring_bench.bat. Not a pass/fail test: it prints
+// ns/event so a change to the writer can be compared before and after.
+
+#include "shared_memory.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+static SharedEvtBuffer g_buf;
+
+// v1 WriteEvent, kept verbatim apart from the buffer argument.
+struct LegacyEvtBuffer {
+    std::atomic<uint32_t> write_pos;
+    std::atomic<uint32_t> read_pos;
+    std::atomic<uint32_t> event_count;
+    std::atomic<uint32_t> flags;
+    uint8_t ring[64 * 1024 - 16];
+};
+static LegacyEvtBuffer g_legacy;
+
+static void LegacyWriteEvent(LegacyEvtBuffer* b, uint16_t type, const void* payload, uint16_t payloadSize) {
+    uint32_t totalSize = 4 + payloadSize;
+    uint32_t wp = b->write_pos.load(std::memory_order_relaxed);
+    uint32_t ringSize = sizeof(b->ring);
+    uint8_t header[4];
+    memcpy(header, &type, 2);
+    memcpy(header + 2, &payloadSize, 2);
+    for (uint32_t i = 0; i < 4; i++)
+        b->ring[(wp + i) % ringSize] = header[i];
+    const uint8_t* src = static_cast<const uint8_t*>(payload);
+    for (uint32_t i = 0; i < payloadSize; i++)
+        b->ring[(wp + 4 + i) % ringSize] = src[i];
+    b->write_pos.store((wp + totalSize) % ringSize, std::memory_order_release);
+    b->event_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+static double NsPerEvent(std::chrono::steady_clock::duration d, uint64_t events) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    return events ? (double)ns / (double)events : 0.0;
+}
+
+// Writer cost with no contention and no drops: write a burst of kBurst
+// records, then drain them untimed, and repeat.
+static const uint32_t kBurst = 2048;
+
+static void RunRing(const char* label, uint32_t count, uint16_t size) {
+    ShmEvtInit(&g_buf);
+    uint8_t payload[16] = {};
+    uint8_t out[64];
+    uint16_t type, sz;
+    std::chrono::steady_clock::duration spent{};
+    for (uint32_t done = 0; done < count; done += kBurst) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kBurst; i++) {
+            memcpy(payload, &i, sizeof(i));
+            ShmEvtWrite(&g_buf, EVT_HP_CHANGE, payload, size);
+        }
+        spent += std::chrono::steady_clock::now() - t0;
+        while (ShmEvtRead(&g_buf, &type, out, sizeof(out), &sz)) {}
+    }
+    printf("  %-36s %7.1f ns/event  (dropped %u)\n", label, NsPerEvent(spent, count),
+           g_buf.dropped.load());
+}
+
+static void RunLegacy(const char* label, uint32_t count, uint16_t size) {
+    memset((void*)&g_legacy, 0, sizeof(g_legacy));
+    uint8_t payload[16] = {};
+    std::chrono::steady_clock::duration spent{};
+    for (uint32_t done = 0; done < count; done += kBurst) {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < kBurst; i++) {
+            memcpy(payload, &i, sizeof(i));
+            LegacyWriteEvent(&g_legacy, EVT_HP_CHANGE, payload, size);
+        }
+        spent += std::chrono::steady_clock::now() - t0;
+    }
+    printf("  %-36s %7.1f ns/event\n", label, NsPerEvent(spent, count));
+}
+
+// Contended: `producers` threads write while one reader drains. Reports ns
+// per attempted event; drops show how far the reader fell behind.
+static void RunContended(const char* label, int producers, uint32_t perThread, uint16_t size) {
+    ShmEvtInit(&g_buf);
+    std::atomic<bool> stop{false};
+    std::thread reader([&]() {
+        uint16_t type, sz;
+        uint8_t out[64];
+        while (!stop.load(std::memory_order_relaxed))
+            while (ShmEvtRead(&g_buf, &type, out, sizeof(out), &sz)) {}
+    });
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; t++) {
+        threads.emplace_back([=]() {
+            uint8_t payload[16] = {};
+            for (uint32_t i = 0; i < perThread; i++) {
+                memcpy(payload, &i, sizeof(i));
+                ShmEvtWrite(&g_buf, EVT_HP_CHANGE, payload, size);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    const double ns = NsPerEvent(std::chrono::steady_clock::now() - t0, (uint64_t)producers * perThread);
+    stop.store(true);
+    reader.join();
+    printf("  %-36s %7.1f ns/event  (dropped %u of %llu)\n", label, ns,
+           g_buf.dropped.load(), (unsigned long long)producers * perThread);
+}
+
+int main() {
+    const uint32_t kEvents = 4000000;
+    printf("=== Event ring writer benchmark (%u events per run) ===\n", kEvents);
+    RunLegacy("v1 per-byte modulo, 16 B payload", kEvents, 16);
+    RunLegacy("v1 per-byte modulo,  8 B payload", kEvents, 8);
+    RunRing("v2 memcpy ring, 16 B payload", kEvents, 16);
+    RunRing("v2 memcpy ring,  8 B payload", kEvents, 8);
+    RunContended("v2 memcpy ring, 4 producers, 16 B", 4, kEvents / 4, 16);
+    return 0;
+}
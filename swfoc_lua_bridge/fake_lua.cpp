@@ -1,5 +1,6 @@
 // fake_lua.cpp -- Stub Lua 5.0.2 C API implementations for test harness.
-// Every function logs its call to L->call_log and manipulates L->stack.
+// Every function manipulates L->stack and, while L->log_calls is set, logs
+// its call to L->call_log.
 
 #include "fake_lua.h"
 #include <cstring>
@@ -14,8 +15,12 @@
 #define FL_TTABLE      5
 #define FL_TFUNCTION   6
 
-// GLOBALSINDEX pseudo-index
-#define FL_GLOBALSINDEX (-10001)
+// GLOBALSINDEX / REGISTRYINDEX pseudo-indices
+#define FL_GLOBALSINDEX  (-10001)
+#define FL_REGISTRYINDEX (-10000)
+
+// StackEntry::boolval on a loaded chunk: calling it returns a function.
+#define FL_CHUNK_RETURNS_FUNCTION 1
 
 // ---- Internal helpers ----
 
@@ -23,7 +28,7 @@
 // zero-based vector index. Returns -1 if out of range.
 static int resolve_index(FakeLuaState* L, int idx) {
     if (idx > 0) return idx - 1;                              // 1-based -> 0-based
-    if (idx < 0 && idx != FL_GLOBALSINDEX) return (int)L->stack.size() + idx;
+    if (idx < 0 && idx != FL_GLOBALSINDEX && idx != FL_REGISTRYINDEX) return (int)L->stack.size() + idx;
     return -1;  // GLOBALSINDEX or other pseudo-index
 }
 
@@ -34,12 +39,12 @@ static void log_call(FakeLuaState* L, const std::string& entry) {
 // ---- API stubs ----
 
 int fake_gettop(FakeLuaState* L) {
-    log_call(L, "gettop");
+    if (L->log_calls) log_call(L, "gettop");
     return (int)L->stack.size();
 }
 
 void fake_settop(FakeLuaState* L, int idx) {
-    log_call(L, "settop(" + std::to_string(idx) + ")");
+    if (L->log_calls) log_call(L, "settop(" + std::to_string(idx) + ")");
     if (idx >= 0) {
         L->stack.resize((size_t)idx);
     } else {
@@ -51,80 +56,94 @@ void fake_settop(FakeLuaState* L, int idx) {
 }
 
 const char* fake_pushstring(FakeLuaState* L, const char* s) {
-    log_call(L, std::string("pushstring(\"") + (s ? s : "null") + "\")");
-    StackEntry e;
+    if (L->log_calls) log_call(L, std::string("pushstring(\"") + (s ? s : "null") + "\")");
+    L->stack.emplace_back();
+    StackEntry& e = L->stack.back();
     e.type = FL_TSTRING;
     e.strval = s ? s : "";
-    L->stack.push_back(e);
     // Return pointer to the string stored in the stack entry.
     // This is stable until the entry is popped/overwritten.
     return L->stack.back().strval.c_str();
 }
 
 void fake_pushnumber(FakeLuaState* L, double n) {
-    char buf[64];
-    snprintf(buf, sizeof(buf), "pushnumber(%.6g)", n);
-    log_call(L, buf);
+    if (L->log_calls) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "pushnumber(%.6g)", n);
+        log_call(L, buf);
+    }
     StackEntry e;
     e.type = FL_TNUMBER;
     e.numval = n;
-    L->stack.push_back(e);
+    L->stack.push_back(std::move(e));
 }
 
 void fake_pushboolean(FakeLuaState* L, int b) {
-    log_call(L, std::string("pushboolean(") + std::to_string(b) + ")");
+    if (L->log_calls) log_call(L, std::string("pushboolean(") + std::to_string(b) + ")");
     StackEntry e;
     e.type = FL_TBOOLEAN;
     e.boolval = b;
-    L->stack.push_back(e);
+    L->stack.push_back(std::move(e));
 }
 
 void fake_pushnil(FakeLuaState* L) {
-    log_call(L, "pushnil");
+    if (L->log_calls) log_call(L, "pushnil");
     StackEntry e;
     e.type = FL_TNIL;
-    L->stack.push_back(e);
+    L->stack.push_back(std::move(e));
 }
 
 void fake_pushcclosure(FakeLuaState* L, void* fn, int n) {
-    log_call(L, "pushcclosure");
+    if (L->log_calls) log_call(L, "pushcclosure");
     // Pop n upvalues from the stack (Lua 5.0 semantics)
     for (int i = 0; i < n && !L->stack.empty(); i++)
         L->stack.pop_back();
     StackEntry e;
     e.type = FL_TFUNCTION;
     e.funcptr = fn;
-    L->stack.push_back(e);
+    L->stack.push_back(std::move(e));
 }
 
 void fake_newtable(FakeLuaState* L) {
-    log_call(L, "newtable");
+    if (L->log_calls) log_call(L, "newtable");
     StackEntry e;
     e.type = FL_TTABLE;
-    L->stack.push_back(e);
+    L->stack.push_back(std::move(e));
 }
 
 void fake_settable(FakeLuaState* L, int idx) {
-    log_call(L, "settable(" + std::to_string(idx) + ")");
+    if (L->log_calls) log_call(L, "settable(" + std::to_string(idx) + ")");
     // Stack: ... table ... key value  (top = value, top-1 = key)
     if (L->stack.size() < 2) return;
 
-    StackEntry value = L->stack.back(); L->stack.pop_back();
-    StackEntry key   = L->stack.back(); L->stack.pop_back();
+    StackEntry value = std::move(L->stack.back()); L->stack.pop_back();
+    StackEntry key   = std::move(L->stack.back()); L->stack.pop_back();
 
     if (idx == FL_GLOBALSINDEX) {
-        // Set global
-        L->globals[key.strval] = value;
+        // Set global, remembering what it held if a checkpoint is set
+        auto it = L->globals.find(key.strval);
+        if (L->checkpointed) {
+            const bool had = it != L->globals.end();
+            L->undo_log.emplace_back(key.strval, std::make_pair(had, had ? it->second : StackEntry()));
+        }
+        if (it != L->globals.end()) {
+            it->second = std::move(value);
+        } else {
+            L->globals.emplace(std::move(key.strval), std::move(value));
+        }
+    } else if (idx == FL_REGISTRYINDEX && key.type == FL_TSTRING) {
+        if (value.type == FL_TNIL) L->registry.erase(key.strval);
+        else L->registry[key.strval] = std::move(value);
     }
     // For regular table indices we just pop -- we don't simulate real table storage
     // beyond globals, which is sufficient for testing the bridge.
 }
 
 void fake_gettable(FakeLuaState* L, int idx) {
-    log_call(L, "gettable(" + std::to_string(idx) + ")");
+    if (L->log_calls) log_call(L, "gettable(" + std::to_string(idx) + ")");
     if (L->stack.empty()) return;
 
-    StackEntry key = L->stack.back(); L->stack.pop_back();
+    StackEntry key = std::move(L->stack.back()); L->stack.pop_back();
 
     if (idx == FL_GLOBALSINDEX) {
         auto it = L->globals.find(key.strval);
@@ -134,24 +153,35 @@ void fake_gettable(FakeLuaState* L, int idx) {
             StackEntry e;
             e.type = FL_TFUNCTION;
             e.strval = "Find_Object_Type";
-            L->stack.push_back(e);
+            L->stack.push_back(std::move(e));
         } else {
             StackEntry e;
             e.type = FL_TNIL;
-            L->stack.push_back(e);
+            L->stack.push_back(std::move(e));
+        }
+    } else if (idx == FL_REGISTRYINDEX) {
+        auto it = key.type == FL_TSTRING ? L->registry.find(key.strval) : L->registry.end();
+        if (it != L->registry.end()) {
+            L->stack.push_back(it->second);
+        } else {
+            StackEntry e;
+            e.type = FL_TNIL;
+            L->stack.push_back(std::move(e));
         }
     } else {
         // Non-global gettable: push nil
         StackEntry e;
         e.type = FL_TNIL;
-        L->stack.push_back(e);
+        L->stack.push_back(std::move(e));
     }
 }
 
 void fake_rawseti(FakeLuaState* L, int idx, int n) {
-    char buf[64];
-    snprintf(buf, sizeof(buf), "rawseti(%d, %d)", idx, n);
-    log_call(L, buf);
+    if (L->log_calls) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "rawseti(%d, %d)", idx, n);
+        log_call(L, buf);
+    }
     // Pop the value from the top; the table at idx remains
     if (!L->stack.empty()) {
         L->stack.pop_back();
@@ -159,14 +189,14 @@ void fake_rawseti(FakeLuaState* L, int idx, int n) {
 }
 
 int fake_type(FakeLuaState* L, int idx) {
-    log_call(L, "type(" + std::to_string(idx) + ")");
+    if (L->log_calls) log_call(L, "type(" + std::to_string(idx) + ")");
     int ri = resolve_index(L, idx);
     if (ri < 0 || ri >= (int)L->stack.size()) return FL_TNIL;
     return L->stack[ri].type;
 }
 
 double fake_tonumber(FakeLuaState* L, int idx) {
-    log_call(L, "tonumber(" + std::to_string(idx) + ")");
+    if (L->log_calls) log_call(L, "tonumber(" + std::to_string(idx) + ")");
     int ri = resolve_index(L, idx);
     if (ri < 0 || ri >= (int)L->stack.size()) return 0.0;
     const auto& e = L->stack[ri];
@@ -183,7 +213,7 @@ double fake_tonumber(FakeLuaState* L, int idx) {
 static thread_local std::string s_tostring_buf;
 
 const char* fake_tostring(FakeLuaState* L, int idx) {
-    log_call(L, "tostring(" + std::to_string(idx) + ")");
+    if (L->log_calls) log_call(L, "tostring(" + std::to_string(idx) + ")");
     int ri = resolve_index(L, idx);
     if (ri < 0 || ri >= (int)L->stack.size()) return nullptr;
     const auto& e = L->stack[ri];
@@ -198,9 +228,11 @@ const char* fake_tostring(FakeLuaState* L, int idx) {
 }
 
 int fake_pcall(FakeLuaState* L, int nargs, int nresults, int errfunc) {
-    char buf[128];
-    snprintf(buf, sizeof(buf), "pcall(nargs=%d, nresults=%d)", nargs, nresults);
-    log_call(L, buf);
+    if (L->log_calls) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "pcall(nargs=%d, nresults=%d)", nargs, nresults);
+        log_call(L, buf);
+    }
 
     if (L->pcall_error != 0) {
         // Simulate error: pop the function + args, push error message
@@ -210,7 +242,7 @@ int fake_pcall(FakeLuaState* L, int nargs, int nresults, int errfunc) {
         StackEntry e;
         e.type = FL_TSTRING;
         e.strval = L->pcall_error_msg.empty() ? "pcall error" : L->pcall_error_msg;
-        L->stack.push_back(e);
+        L->stack.push_back(std::move(e));
         return L->pcall_error;
     }
 
@@ -230,6 +262,17 @@ int fake_pcall(FakeLuaState* L, int nargs, int nresults, int errfunc) {
         }
     }
 
+    // A chunk loaded from "return function ..." source returns its closure.
+    bool returnsFunction = false;
+    std::string closureName;
+    if (L->stack.size() >= (size_t)(1 + nargs)) {
+        const auto& fn = L->stack[L->stack.size() - 1 - nargs];
+        if (fn.type == FL_TFUNCTION && fn.boolval == FL_CHUNK_RETURNS_FUNCTION) {
+            returnsFunction = true;
+            closureName = fn.strval + ":closure";
+        }
+    }
+
     // Simulate success: pop the function + args
     int toPop = 1 + nargs;
     for (int i = 0; i < toPop && !L->stack.empty(); i++)
@@ -246,22 +289,25 @@ int fake_pcall(FakeLuaState* L, int nargs, int nresults, int errfunc) {
             // dependencies on lua_types.h tag values out of fake_lua.
             e.type   = FL_TFUNCTION;
             e.strval = "<type_wrapper>";
+        } else if (returnsFunction && i == 0) {
+            e.type   = FL_TFUNCTION;
+            e.strval = closureName;
         } else {
             e.type = FL_TNIL;
         }
-        L->stack.push_back(e);
+        L->stack.push_back(std::move(e));
     }
     return 0;
 }
 
 int fake_load(FakeLuaState* L, void* reader, void* data, const char* chunkname) {
-    log_call(L, std::string("load(\"") + (chunkname ? chunkname : "") + "\")");
+    if (L->log_calls) log_call(L, std::string("load(\"") + (chunkname ? chunkname : "") + "\")");
 
     if (L->load_error != 0) {
         StackEntry e;
         e.type = FL_TSTRING;
         e.strval = L->load_error_msg.empty() ? "load error" : L->load_error_msg;
-        L->stack.push_back(e);
+        L->stack.push_back(std::move(e));
         return L->load_error;
     }
 
@@ -269,17 +315,57 @@ int fake_load(FakeLuaState* L, void* reader, void* data, const char* chunkname)
     StackEntry e;
     e.type = FL_TFUNCTION;
     e.strval = chunkname ? chunkname : "chunk";
-    L->stack.push_back(e);
+    if (reader) {
+        auto read = reinterpret_cast<const char* (*)(FakeLuaState*, void*, size_t*)>(reader);
+        size_t sz = 0;
+        const char* src = read(L, data, &sz);
+        static const char kPrefix[] = "return function";
+        if (src && sz >= sizeof(kPrefix) - 1 && memcmp(src, kPrefix, sizeof(kPrefix) - 1) == 0)
+            e.boolval = FL_CHUNK_RETURNS_FUNCTION;
+    }
+    L->stack.push_back(std::move(e));
     return 0;
 }
 
 void fake_reset(FakeLuaState* L) {
     L->stack.clear();
     L->globals.clear();
+    L->registry.clear();
     L->call_log.clear();
     L->has_game_globals = false;
     L->pcall_error = 0;
     L->pcall_error_msg.clear();
     L->load_error = 0;
     L->load_error_msg.clear();
+    L->checkpointed = false;
+    L->undo_log.clear();
+}
+
+void fake_checkpoint(FakeLuaState* L) {
+    L->checkpointed = true;
+    L->checkpoint_game_globals = L->has_game_globals;
+    L->undo_log.clear();
+}
+
+void fake_restore(FakeLuaState* L) {
+    if (!L->checkpointed) {
+        fake_reset(L);
+        return;
+    }
+    // Newest first, so a global written twice ends at its checkpoint value.
+    for (auto it = L->undo_log.rbegin(); it != L->undo_log.rend(); ++it) {
+        if (it->second.first) {
+            L->globals[it->first] = std::move(it->second.second);
+        } else {
+            L->globals.erase(it->first);
+        }
+    }
+    L->undo_log.clear();
+    L->stack.clear();
+    L->call_log.clear();
+    L->has_game_globals = L->checkpoint_game_globals;
+    L->pcall_error = 0;
+    L->pcall_error_msg.clear();
+    L->load_error = 0;
+    L->load_error_msg.clear();
 }
@@ -2,11 +2,31 @@
 // fake_lua.h -- Stub Lua 5.0.2 API for offline testing of the SWFOC bridge.
 // Provides a FakeLuaState with stack simulation and call logging so that
 // every bridge function can be exercised without the game process.
+//
+// Batch callers (swfoc_replay --corpus, fuzz loops) reset the state once per
+// script, so a reset reuses what the last script allocated:
+//
+//   * The stack keeps its capacity across pops and resets. StackEntry packs
+//     its scalars ahead of strval, and strval's small-string buffer holds
+//     the short names and numbers helpers push without a heap allocation.
+//   * globals is a hash table; nothing iterates it in key order.
+//   * call_log records only while log_calls is set. It is off by default:
+//     formatting one entry per API call dominated batch runs, and only the
+//     tests that inspect the log need it.
+//   * fake_checkpoint marks the globals (normally right after RegisterAll);
+//     fake_restore then undoes only the global writes made since, instead of
+//     clearing the table and registering every helper again.
+//
+// The registry holds string keys only (what the bridge's helper scripts use)
+// and survives fake_restore, like the real state's does across scripts. A
+// loaded chunk whose source starts with "return function" yields a function
+// when called, so code that keeps precompiled closures can be tested.
 
 #include <vector>
-#include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <cstdint>
 #include <cstddef>
 
@@ -16,18 +36,20 @@ struct FakeLuaState;
 // Stack entry: every push/pop manipulates these.
 struct StackEntry {
     int type;           // LUA_TNIL=0, LUA_TBOOLEAN=1, LUA_TNUMBER=3, LUA_TSTRING=4, etc.
-    double numval;
-    std::string strval;
     int boolval;
+    double numval;
     void* funcptr;      // for TFUNCTION entries (closure pointer)
+    std::string strval;
 
-    StackEntry() : type(0), numval(0), strval(), boolval(0), funcptr(nullptr) {}
+    StackEntry() : type(0), boolval(0), numval(0), funcptr(nullptr), strval() {}
 };
 
 struct FakeLuaState {
     std::vector<StackEntry> stack;
-    std::map<std::string, StackEntry> globals;   // Global table (GLOBALSINDEX)
-    std::vector<std::string> call_log;           // Log of all API calls made
+    std::unordered_map<std::string, StackEntry> globals;   // Global table (GLOBALSINDEX)
+    std::unordered_map<std::string, StackEntry> registry;  // String keys of REGISTRYINDEX
+    std::vector<std::string> call_log;           // API calls made, while log_calls is set
+    bool log_calls = false;                      // Kept across fake_reset / fake_restore
 
     bool has_game_globals = false;    // If true, Find_Object_Type exists as a global function
     int pcall_error = 0;             // If non-zero, pcall returns this error code
@@ -41,6 +63,13 @@ struct FakeLuaState {
     // otherwise. Lets the harness verify both the "exists" and "missing"
     // paths without injecting a real engine pointer.
     std::set<std::string> known_object_types;
+
+    // fake_checkpoint state. undo_log holds, per global written through
+    // settable since the checkpoint, the name and whether and what it held
+    // before; writes made straight into `globals` are not undone.
+    bool checkpointed = false;
+    bool checkpoint_game_globals = false;
+    std::vector<std::pair<std::string, std::pair<bool, StackEntry>>> undo_log;
 };
 
 // ---- Stub function declarations ----
@@ -64,4 +93,6 @@ int         fake_pcall(FakeLuaState* L, int nargs, int nresults, int errfunc);
 int         fake_load(FakeLuaState* L, void* reader, void* data, const char* chunkname);
 
 // Helpers
-void fake_reset(FakeLuaState* L);   // Clear stack, globals, call_log
+void fake_reset(FakeLuaState* L);       // Clear stack, globals, registry, call_log; drop the checkpoint
+void fake_checkpoint(FakeLuaState* L);  // Mark the current globals for fake_restore
+void fake_restore(FakeLuaState* L);     // Back to the checkpoint (fake_reset without one)
@@ -0,0 +1,117 @@
+#pragma once
+// hardpoint_layout.h -- per-unit-type hardpoint layout, learned once.
+//
+// SWFOC_GetHardpoints scanned all 32 component slots of a unit, validating
+// every pointer it found, and CallMakeInvulnerableInline looked the
+// INVULNERABLE behavior up in the engine registry (a std::string build and
+// a map search) for every unit it touched, so a god-mode sweep over a
+// capital-ship fleet repeated the same discovery per ship. Hardpoint layout
+// is fixed by the unit type, so the bridge keeps it per type pointer
+// (GameObj+0x298):
+//
+//   * childMask is the set of component slots that hold a child, span the
+//     highest one + 1. They are the union over the first
+//     HARDPOINT_LAYOUT_LEARN units of the type (one of them may have lost
+//     a hardpoint); after that GetHardpoints reads only those slots.
+//   * hardpoints is the largest HardpointCount seen for the type, for the
+//     diagnostics; the invulnerability path still asks the engine per unit,
+//     because indexing past a unit's own count is not safe.
+//   * behavior is the INVULNERABLE behavior object, looked up once per
+//     binding.
+//
+// The table is bound to the live GameModeClass and a generation the bridge
+// bumps on lua_open / lua_close, like type_cache.h: types are rebuilt on
+// every game load, and a freed type's address can come back as another
+// type. When the slots run out, new types are simply not stored.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge reads hardpoints on the main thread only.
+
+#include <cstdint>
+#include <cstring>
+
+#define HARDPOINT_LAYOUT_SLOTS   512  // types, power of two
+#define HARDPOINT_LAYOUT_MAX     384  // 3/4 load factor
+#define HARDPOINT_LAYOUT_CHILDREN 32  // component slots GetHardpoints reads
+#define HARDPOINT_LAYOUT_LEARN   4    // units per type before the layout is fixed
+
+struct HardpointLayout {
+    uint64_t type;       // UnitType*, 0 = empty slot
+    uint32_t childMask;  // bit i = component slot i holds a child
+    uint8_t  span;       // highest child slot + 1
+    uint8_t  samples;    // units the mask was learned from
+    int16_t  hardpoints; // largest HardpointCount seen, -1 = never asked
+};
+
+struct HardpointLayoutCache {
+    uint64_t        mode;      // GameModeClass* the table belongs to
+    uint32_t        gen;
+    bool            bound;
+    uint32_t        count;
+    uint64_t        behavior;  // INVULNERABLE behavior, 0 = not looked up
+    HardpointLayout slots[HARDPOINT_LAYOUT_SLOTS];
+    uint32_t        hits;      // lookups answered by a fixed layout
+    uint32_t        misses;
+    uint32_t        resets;
+};
+
+inline void HardpointLayoutClear(HardpointLayoutCache* c) {
+    memset(c->slots, 0, sizeof(c->slots));
+    c->count = 0;
+    c->behavior = 0;
+}
+
+// Empties the table when (mode, gen) changed. Returns true when layouts
+// were dropped.
+inline bool HardpointLayoutBind(HardpointLayoutCache* c, uint64_t mode, uint32_t gen) {
+    if (c->bound && c->mode == mode && c->gen == gen) return false;
+    const bool dropped = c->bound && (c->count > 0 || c->behavior);
+    HardpointLayoutClear(c);
+    c->mode = mode;
+    c->gen = gen;
+    c->bound = true;
+    if (dropped) c->resets++;
+    return dropped;
+}
+
+// The entry for `type`, inserted empty when new; nullptr for type 0 or a
+// full table.
+inline HardpointLayout* HardpointLayoutFor(HardpointLayoutCache* c, uint64_t type) {
+    if (!type) return nullptr;
+    uint64_t h = type >> 3;
+    h ^= h >> 17;
+    h *= 0x9E3779B97F4A7C15ull;
+    uint32_t i = (uint32_t)(h >> 40) & (HARDPOINT_LAYOUT_SLOTS - 1);
+    while (c->slots[i].type) {
+        if (c->slots[i].type == type) return &c->slots[i];
+        i = (i + 1) & (HARDPOINT_LAYOUT_SLOTS - 1);
+    }
+    if (c->count >= HARDPOINT_LAYOUT_MAX) return nullptr;
+    HardpointLayout* e = &c->slots[i];
+    e->type = type;
+    e->hardpoints = -1;
+    c->count++;
+    return e;
+}
+
+// True once the child slots are fixed; counts the lookup.
+inline bool HardpointLayoutKnown(HardpointLayoutCache* c, const HardpointLayout* e) {
+    const bool known = e && e->samples >= HARDPOINT_LAYOUT_LEARN;
+    if (known) c->hits++;
+    else       c->misses++;
+    return known;
+}
+
+// Adds one unit's occupied child slots (a full scan) to the layout.
+inline void HardpointLayoutLearn(HardpointLayout* e, uint32_t mask) {
+    if (!e || e->samples >= HARDPOINT_LAYOUT_LEARN) return;
+    e->childMask |= mask;
+    uint8_t span = 0;
+    for (uint32_t m = e->childMask; m; m >>= 1) span++;
+    e->span = span;
+    e->samples++;
+}
+
+inline void HardpointLayoutNoteCount(HardpointLayout* e, int count) {
+    if (e && count > e->hardpoints && count <= 0x7FFF) e->hardpoints = (int16_t)count;
+}
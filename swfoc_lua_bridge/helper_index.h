@@ -0,0 +1,64 @@
+#pragma once
+// helper_index.h -- name lookup over the bridge's SWFOC_* helper table.
+//
+// RegisterAll binds every helper as its own global, one pushstring +
+// pushcclosure + settable per helper, on every lua_open; the game opens
+// hundreds of states per session and only the few that drain pipe commands
+// ever call a helper. With lazy registration (SWFOC_SetLazyRegistration) a
+// new state gets a single global instead, the SWFOC table, whose __index
+// metamethod looks a name up here the first time a script reads SWFOC.<name>
+// and caches the closure in the table:
+//
+//   * Names are the registration names less their "SWFOC_" prefix, so
+//     SWFOC.GetCredits is SWFOC_GetCredits: the table keeps no second list of
+//     names to drift from the first. A full name is accepted too.
+//   * The index is the registration table's positions sorted by name, built
+//     once; a lookup is a binary search, no allocation.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: build before the first lookup, then read-only.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define HELPER_INDEX_PREFIX     "SWFOC_"
+#define HELPER_INDEX_PREFIX_LEN 6
+
+struct HelperIndex {
+    std::vector<uint16_t> order;  // entry positions, by short name
+};
+
+// `name` less HELPER_INDEX_PREFIX, or `name` when it has none.
+inline const char* HelperShortName(const char* name) {
+    return strncmp(name, HELPER_INDEX_PREFIX, HELPER_INDEX_PREFIX_LEN) == 0 ? name + HELPER_INDEX_PREFIX_LEN
+                                                                           : name;
+}
+
+// Sorts the positions of `entries[0..n)` (anything with a `name` member) by
+// short name.
+template <typename Entry>
+inline void HelperIndexBuild(HelperIndex* index, const Entry* entries, size_t n) {
+    index->order.resize(n);
+    for (size_t i = 0; i < n; i++) index->order[i] = static_cast<uint16_t>(i);
+    std::sort(index->order.begin(), index->order.end(), [entries](uint16_t a, uint16_t b) {
+        return strcmp(HelperShortName(entries[a].name), HelperShortName(entries[b].name)) < 0;
+    });
+}
+
+// Position in `entries` of the helper `name` (short or full), or -1.
+template <typename Entry>
+inline int HelperIndexFind(const HelperIndex& index, const Entry* entries, const char* name) {
+    if (!name) return -1;
+    const char* key = HelperShortName(name);
+    size_t lo = 0, hi = index.order.size();
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const int c = strcmp(HelperShortName(entries[index.order[mid]].name), key);
+        if (c == 0) return index.order[mid];
+        if (c < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return -1;
+}
@@ -0,0 +1,171 @@
+#pragma once
+// hook_cost.h -- optional per-hook overhead counters for the MinHook
+// detours that run inside engine hot loops (SetHP, WeaponTick, AddCredits,
+// Take_Damage_Outer, DeathHandler, the victory monitor counter).
+//
+// What a detour costs the frame is the time spent in OUR code, not in the
+// original it forwards to. A HookCostScope therefore reads the cycle
+// counter four times: on entry, just before and just after the call to the
+// original, and on exit; only the two outer stretches are charged.
+//
+//   * Off by default. While `enabled` is clear a detour pays one relaxed
+//     load and never reads the cycle counter.
+//   * Counters are per thread: each hooking thread claims one cache-line
+//     aligned HookCostThread on first use (as DamageRingClaim does) and is
+//     its only writer, so recording is plain load + store -- no lock prefix,
+//     no line shared with another core. Threads past HOOK_COST_THREADS share
+//     the overflow block, which falls back to atomic read-modify-writes.
+//   * Readers aggregate all blocks on demand (HookCostSum). A reset from
+//     the reader may race an owner's pending store and lose that one update;
+//     the numbers are for profiling, not accounting.
+//
+// The cycle source is passed in, so the harness can drive scopes with
+// synthetic timestamps. Header-only and Win32-free so test_harness.cpp
+// drives the real code.
+
+#include <atomic>
+#include <cstdint>
+
+#define HOOK_COST_THREADS 8
+
+enum HookCostId : uint32_t {
+    HOOK_COST_SET_HP = 0,
+    HOOK_COST_WEAPON_TICK,
+    HOOK_COST_ADD_CREDITS,
+    HOOK_COST_TAKE_DAMAGE_OUTER,
+    HOOK_COST_DEATH_HANDLER,
+    HOOK_COST_VICTORY_MONITOR,
+    HOOK_COST_COUNT,
+};
+
+inline const char* HookCostName(uint32_t hook) {
+    static const char* const kNames[HOOK_COST_COUNT] = {
+        "SetHP", "WeaponTick", "AddCredits", "TakeDamageOuter", "DeathHandler", "VictoryMonitorCounter",
+    };
+    return hook < HOOK_COST_COUNT ? kNames[hook] : "unknown";
+}
+
+struct HookCostCounter {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> cycles;     // our code only, original excluded
+    std::atomic<uint64_t> maxCycles;  // worst single call
+};
+
+struct alignas(64) HookCostThread {
+    std::atomic<uint32_t> owner;   // thread id, 0 = free
+    bool                  shared;  // the overflow block: several writers
+    HookCostCounter       hooks[HOOK_COST_COUNT];
+};
+
+struct HookCostTable {
+    std::atomic<uint32_t> enabled;
+    HookCostThread        threads[HOOK_COST_THREADS];
+    HookCostThread        overflow;
+};
+
+struct HookCostTotals {
+    uint64_t calls;
+    uint64_t cycles;
+    uint64_t maxCycles;
+    uint32_t threads;  // blocks that recorded this hook
+};
+
+// Zeroes every counter; thread claims are kept.
+inline void HookCostReset(HookCostTable* t) {
+    auto clear = [](HookCostThread& th) {
+        for (auto& c : th.hooks) {
+            c.calls.store(0, std::memory_order_relaxed);
+            c.cycles.store(0, std::memory_order_relaxed);
+            c.maxCycles.store(0, std::memory_order_relaxed);
+        }
+    };
+    for (auto& th : t->threads) clear(th);
+    clear(t->overflow);
+}
+
+// Only call while no hook can run (startup / tests).
+inline void HookCostInit(HookCostTable* t) {
+    t->enabled.store(0, std::memory_order_relaxed);
+    for (auto& th : t->threads) {
+        th.owner.store(0, std::memory_order_relaxed);
+        th.shared = false;
+    }
+    t->overflow.owner.store(0, std::memory_order_relaxed);
+    t->overflow.shared = true;
+    HookCostReset(t);
+}
+
+// Block for thread `tid` (non-zero): its own once claimed, else overflow.
+inline HookCostThread* HookCostClaim(HookCostTable* t, uint32_t tid) {
+    for (auto& th : t->threads) {
+        if (th.owner.load(std::memory_order_relaxed) == tid) return &th;
+    }
+    for (auto& th : t->threads) {
+        uint32_t expected = 0;
+        if (th.owner.compare_exchange_strong(expected, tid, std::memory_order_acq_rel)) return &th;
+    }
+    return &t->overflow;
+}
+
+inline void HookCostAdd(HookCostThread* th, uint32_t hook, uint64_t cycles) {
+    HookCostCounter* c = &th->hooks[hook];
+    if (th->shared) {
+        c->calls.fetch_add(1, std::memory_order_relaxed);
+        c->cycles.fetch_add(cycles, std::memory_order_relaxed);
+        uint64_t seen = c->maxCycles.load(std::memory_order_relaxed);
+        while (cycles > seen && !c->maxCycles.compare_exchange_weak(seen, cycles, std::memory_order_relaxed)) {}
+        return;
+    }
+    c->calls.store(c->calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    c->cycles.store(c->cycles.load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+    if (cycles > c->maxCycles.load(std::memory_order_relaxed)) c->maxCycles.store(cycles, std::memory_order_relaxed);
+}
+
+// One detour invocation. `thread` is nullptr when profiling was off at
+// entry; every other call is then a no-op.
+struct HookCostScope {
+    HookCostThread* thread;
+    uint32_t        hook;
+    uint64_t        start;     // cycle counter at entry
+    uint64_t        excluded;  // cycles spent in the original
+    uint64_t        origStart;
+};
+
+inline void HookCostBegin(HookCostScope* s, HookCostThread* th, uint32_t hook, uint64_t now) {
+    s->thread    = th;
+    s->hook      = hook;
+    s->start     = now;
+    s->excluded  = 0;
+    s->origStart = now;
+}
+
+inline void HookCostOriginalBegin(HookCostScope* s, uint64_t now) {
+    if (s->thread) s->origStart = now;
+}
+
+inline void HookCostOriginalEnd(HookCostScope* s, uint64_t now) {
+    if (s->thread) s->excluded += now - s->origStart;
+}
+
+inline void HookCostEnd(HookCostScope* s, uint64_t now) {
+    if (!s->thread) return;
+    const uint64_t total = now - s->start;
+    HookCostAdd(s->thread, s->hook, total > s->excluded ? total - s->excluded : 0);
+}
+
+inline HookCostTotals HookCostSum(const HookCostTable* t, uint32_t hook) {
+    HookCostTotals out = {};
+    auto add = [&out, hook](const HookCostThread& th) {
+        const HookCostCounter& c = th.hooks[hook];
+        const uint64_t calls = c.calls.load(std::memory_order_relaxed);
+        if (calls == 0) return;
+        out.calls += calls;
+        out.cycles += c.cycles.load(std::memory_order_relaxed);
+        const uint64_t m = c.maxCycles.load(std::memory_order_relaxed);
+        if (m > out.maxCycles) out.maxCycles = m;
+        out.threads++;
+    };
+    for (const auto& th : t->threads) add(th);
+    add(t->overflow);
+    return out;
+}
@@ -0,0 +1,271 @@
+#pragma once
+// instance_names.h -- instance-scoped pipe / shared-memory names and the
+// instance registry, so several live bridges and swfoc_replay.exe servers
+// can run side by side on one machine (a CI node running test shards).
+//
+// Every bridge-owned name used to be fixed: \\.\pipe\swfoc_bridge,
+// \\.\pipe\swfoc_bridge_replay and the Local\SWFOC_Bridge_* mappings, so a
+// second game or replay server on the box failed CreateNamedPipe / shared
+// the first one's mappings. Now:
+//
+//   * An instance TAG (1..INSTANCE_TAG_MAX-1 of [A-Za-z0-9_-]) is appended
+//     to each name as "_<tag>". No tag keeps today's names exactly, so
+//     every existing client (bridge/*.py, the editor, the overlay) works
+//     unchanged against an untagged bridge.
+//   * The live bridge takes its tag from the SWFOC_BRIDGE_INSTANCE
+//     environment variable (it is a DLL, so there is no command line);
+//     swfoc_replay.exe and pipe_loadgen.exe take --instance <tag>. The
+//     value "pid" means the process's own PID, which is unique without any
+//     coordination between shards.
+//   * Each server drops one record into %TEMP%\swfoc_instances\ while it is
+//     up (<kind>_<pid>.inst: pipe name, tag, PID, start time, source) and
+//     deletes it on a clean exit. `swfoc_replay.exe --list-instances` and
+//     InstanceRegistryList read the directory, skip records whose PID is
+//     gone and delete them, so a crashed shard never shows up twice.
+//     One file per process means no shared file to lock or corrupt.
+//
+// The naming and record-format functions are pure so test_harness.cpp pins
+// them; only the registry I/O at the bottom touches Win32.
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define INSTANCE_ENV_VAR       "SWFOC_BRIDGE_INSTANCE"
+#define INSTANCE_TAG_PID       "pid"
+#define INSTANCE_TAG_MAX       32    // NUL included
+#define INSTANCE_NAME_MAX      128   // NUL included; pipe and mapping names
+#define INSTANCE_REGISTRY_DIR  "swfoc_instances"
+#define INSTANCE_RECORD_EXT    ".inst"
+#define INSTANCE_RECORD_MAGIC  "swfoc-instance 1"
+
+// True for 1..INSTANCE_TAG_MAX-1 characters of [A-Za-z0-9_-]: the tag ends
+// up in pipe, mapping and file names, so nothing else is let through.
+inline bool InstanceTagValid(const char* tag) {
+    if (!tag || !tag[0]) return false;
+    size_t n = 0;
+    for (; tag[n]; n++) {
+        const char c = tag[n];
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+                        || c == '_' || c == '-';
+        if (!ok || n + 1 >= INSTANCE_TAG_MAX) return false;
+    }
+    return true;
+}
+
+// The tag a --instance value or SWFOC_BRIDGE_INSTANCE names: "" for none
+// (null or empty: the legacy names), the decimal `pid` for "pid", else the
+// value itself. False, with *out empty, when the value is not a valid tag.
+inline bool InstanceTagResolve(const char* spec, uint32_t pid, char* out, size_t cap) {
+    if (!out || cap == 0) return false;
+    out[0] = '\0';
+    if (!spec || !spec[0]) return true;
+    if (strcmp(spec, INSTANCE_TAG_PID) == 0) {
+        const int n = snprintf(out, cap, "%u", pid);
+        if (n < 0 || (size_t)n >= cap) { out[0] = '\0'; return false; }
+        return true;
+    }
+    if (!InstanceTagValid(spec) || strlen(spec) >= cap) return false;
+    memcpy(out, spec, strlen(spec) + 1);
+    return true;
+}
+
+// `base` untouched for no tag, else "<base>_<tag>". False when it would not
+// fit in `cap`.
+inline bool InstanceName(const char* base, const char* tag, char* out, size_t cap) {
+    if (!base || !out || cap == 0) return false;
+    const int n = (tag && tag[0]) ? snprintf(out, cap, "%s_%s", base, tag) : snprintf(out, cap, "%s", base);
+    if (n < 0 || (size_t)n >= cap) { out[0] = '\0'; return false; }
+    return true;
+}
+
+// Per-slot event names: "<prefix><i>" for no tag (the legacy layout), else
+// "<prefix>_<tag>_<i>" -- the separator keeps tag "a1" slot 2 apart from
+// tag "a" slot 12.
+inline bool InstanceEventName(const char* prefix, const char* tag, int i, char* out, size_t cap) {
+    if (!prefix || !out || cap == 0) return false;
+    const int n = (tag && tag[0]) ? snprintf(out, cap, "%s_%s_%d", prefix, tag, i)
+                                  : snprintf(out, cap, "%s%d", prefix, i);
+    if (n < 0 || (size_t)n >= cap) { out[0] = '\0'; return false; }
+    return true;
+}
+
+// ----------------------------------------------------------------------
+// Registry records
+// ----------------------------------------------------------------------
+
+struct InstanceRecord {
+    std::string kind;      // "bridge" or "replay"
+    uint32_t    pid = 0;
+    std::string tag;       // "" for an untagged server
+    std::string pipe;      // full \\.\pipe\ name clients open
+    int64_t     started = 0;  // time(nullptr) at registration
+    std::string source;    // game executable or snapshot path, for humans
+};
+
+// "<kind>_<pid>.inst". False when the kind is not a tag-safe word.
+inline bool InstanceRecordFileName(const char* kind, uint32_t pid, char* out, size_t cap) {
+    if (!InstanceTagValid(kind) || !out || cap == 0) return false;
+    const int n = snprintf(out, cap, "%s_%u%s", kind, pid, INSTANCE_RECORD_EXT);
+    if (n < 0 || (size_t)n >= cap) { out[0] = '\0'; return false; }
+    return true;
+}
+
+// The record file's text: the magic line then one key=value per line.
+// Values never hold a newline (FormatInstanceRecord replaces any with a
+// space), so a reader can split on '\n' alone.
+inline std::string FormatInstanceRecord(const InstanceRecord& r) {
+    auto clean = [](const std::string& s) {
+        std::string v = s;
+        for (char& c : v) if (c == '\n' || c == '\r') c = ' ';
+        return v;
+    };
+    char num[32];
+    std::string out = INSTANCE_RECORD_MAGIC "\n";
+    out += "kind=" + clean(r.kind) + "\n";
+    snprintf(num, sizeof(num), "%u", r.pid);
+    out += std::string("pid=") + num + "\n";
+    out += "tag=" + clean(r.tag) + "\n";
+    out += "pipe=" + clean(r.pipe) + "\n";
+    snprintf(num, sizeof(num), "%lld", (long long)r.started);
+    out += std::string("started=") + num + "\n";
+    out += "source=" + clean(r.source) + "\n";
+    return out;
+}
+
+// Parses FormatInstanceRecord's text. False unless the magic line is first
+// and kind, a non-zero pid and pipe are all present; unknown keys are
+// skipped so a newer writer's extra fields do not hide its record.
+inline bool ParseInstanceRecord(const char* text, size_t len, InstanceRecord* out) {
+    if (!text || !out) return false;
+    *out = InstanceRecord();
+    const char* p = text;
+    const char* end = text + len;
+    bool first = true;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', (size_t)(end - p)));
+        const char* lineEnd = nl ? nl : end;
+        std::string line(p, lineEnd);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        p = nl ? nl + 1 : end;
+        if (first) {
+            if (line != INSTANCE_RECORD_MAGIC) return false;
+            first = false;
+            continue;
+        }
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        const std::string key = line.substr(0, eq);
+        const std::string val = line.substr(eq + 1);
+        if (key == "kind") out->kind = val;
+        else if (key == "pid") out->pid = (uint32_t)strtoul(val.c_str(), nullptr, 10);
+        else if (key == "tag") out->tag = val;
+        else if (key == "pipe") out->pipe = val;
+        else if (key == "started") out->started = strtoll(val.c_str(), nullptr, 10);
+        else if (key == "source") out->source = val;
+    }
+    return !first && !out->kind.empty() && out->pid != 0 && !out->pipe.empty();
+}
+
+// One JSON line per record for --list-instances.
+inline std::string InstanceRecordJson(const InstanceRecord& r) {
+    auto esc = [](const std::string& s) {
+        std::string v;
+        for (char c : s) {
+            if (c == '"' || c == '\\') v += '\\';
+            v += c;
+        }
+        return v;
+    };
+    char pid[16], started[32];
+    snprintf(pid, sizeof(pid), "%u", r.pid);
+    snprintf(started, sizeof(started), "%lld", (long long)r.started);
+    return "{\"kind\":\"" + esc(r.kind) + "\",\"pid\":" + pid + ",\"tag\":\"" + esc(r.tag) + "\",\"pipe\":\""
+           + esc(r.pipe) + "\",\"started\":" + started + ",\"source\":\"" + esc(r.source) + "\"}";
+}
+
+// ----------------------------------------------------------------------
+// Registry I/O (Win32)
+// ----------------------------------------------------------------------
+
+// %TEMP%\swfoc_instances\, created if missing, with the trailing slash.
+inline std::string InstanceRegistryDir() {
+    char tmp[MAX_PATH];
+    const DWORD n = GetTempPathA(MAX_PATH, tmp);
+    std::string dir = (n > 0 && n < MAX_PATH) ? std::string(tmp) : std::string(".\\");
+    if (!dir.empty() && dir.back() != '\\' && dir.back() != '/') dir += '\\';
+    dir += INSTANCE_REGISTRY_DIR "\\";
+    CreateDirectoryA(dir.c_str(), nullptr);  // fails harmlessly when it exists
+    return dir;
+}
+
+// The tag SWFOC_BRIDGE_INSTANCE names for this process ("" when unset).
+// False when the variable is set to something that is not a valid tag.
+inline bool InstanceTagFromEnv(char* out, size_t cap) {
+    char spec[INSTANCE_TAG_MAX + 8];
+    const DWORD n = GetEnvironmentVariableA(INSTANCE_ENV_VAR, spec, sizeof(spec));
+    if (n >= sizeof(spec)) { if (out && cap) out[0] = '\0'; return false; }
+    return InstanceTagResolve(n ? spec : nullptr, GetCurrentProcessId(), out, cap);
+}
+
+// Writes this process's record. Returns the file path to pass to
+// InstanceRegistryRemove on exit, or "" when it could not be written.
+inline std::string InstanceRegistryAdd(const InstanceRecord& r) {
+    char name[64];
+    if (!InstanceRecordFileName(r.kind.c_str(), r.pid, name, sizeof(name))) return std::string();
+    const std::string path = InstanceRegistryDir() + name;
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return std::string();
+    const std::string text = FormatInstanceRecord(r);
+    const bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    fclose(f);
+    if (!ok) { DeleteFileA(path.c_str()); return std::string(); }
+    return path;
+}
+
+inline void InstanceRegistryRemove(const std::string& path) {
+    if (!path.empty()) DeleteFileA(path.c_str());
+}
+
+inline bool InstanceProcessAlive(uint32_t pid) {
+    if (pid == GetCurrentProcessId()) return true;
+    HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!h) return false;
+    DWORD code = 0;
+    const bool alive = GetExitCodeProcess(h, &code) && code == STILL_ACTIVE;
+    CloseHandle(h);
+    return alive;
+}
+
+// Every registered server whose process is still running, in directory
+// order. Records of exited processes are deleted; unreadable files are left
+// alone (a writer may be mid-write).
+inline std::vector<InstanceRecord> InstanceRegistryList() {
+    std::vector<InstanceRecord> out;
+    const std::string dir = InstanceRegistryDir();
+    WIN32_FIND_DATAA fd;
+    HANDLE h = FindFirstFileA((dir + "*" INSTANCE_RECORD_EXT).c_str(), &fd);
+    if (h == INVALID_HANDLE_VALUE) return out;
+    do {
+        const std::string path = dir + fd.cFileName;
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) continue;
+        char buf[2048];
+        const size_t n = fread(buf, 1, sizeof(buf), f);
+        fclose(f);
+        InstanceRecord r;
+        if (!ParseInstanceRecord(buf, n, &r)) continue;
+        if (!InstanceProcessAlive(r.pid)) {
+            DeleteFileA(path.c_str());
+            continue;
+        }
+        out.push_back(r);
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+    return out;
+}
@@ -0,0 +1,188 @@
+#pragma once
+// log_ring.h -- bounded lock-free line buffer behind the bridge's Log().
+//
+// Log() did vfprintf + fflush per line on whatever thread called it: the
+// pipe instances, DrainPipeCommand and many Lua_* functions on the game's
+// main thread, several times per command. Lines now go through this ring
+// and a writer thread does the I/O:
+//
+//   * Producers (any thread): claim a slot with one CAS on `head`, format
+//     straight into it with vsnprintf and publish it with a release store of
+//     the slot's sequence (a bounded MPMC queue, one consumer at a time).
+//     No lock, no heap, no I/O. A full ring drops the line and counts it in
+//     `dropped` -- a game thread never waits on the disk.
+//   * A line longer than LOG_RING_LINE_MAX - 1 bytes is cut and ends in
+//     "...\n".
+//   * Level and category are tested before anything else, so a line that is
+//     switched off costs two relaxed loads. Categories come from the "[Tag]"
+//     prefix every bridge line already starts with.
+//   * One consumer at a time holds `draining`: the writer thread, or the
+//     crash handler's synchronous flush (LogRingFlush), which spins briefly
+//     for the writer to let go and never allocates.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#define LOG_RING_SLOTS     1024   // power of two
+#define LOG_RING_LINE_MAX  512    // bytes per line, NUL included
+
+enum LogLevel : uint32_t {
+    LOG_LEVEL_ERROR = 0,
+    LOG_LEVEL_WARN  = 1,
+    LOG_LEVEL_INFO  = 2,
+    LOG_LEVEL_DEBUG = 3,
+};
+
+enum LogCategory : uint32_t {
+    LOG_CAT_BRIDGE = 1u << 0,  // [Bridge]
+    LOG_CAT_PIPE   = 1u << 1,  // [Pipe]
+    LOG_CAT_SHM    = 1u << 2,  // [SHM]
+    LOG_CAT_LUA    = 1u << 3,  // [Lua], [DoString]
+    LOG_CAT_DUMP   = 1u << 4,  // [Dump]
+    LOG_CAT_EVENTS = 1u << 5,  // [Events]
+    LOG_CAT_TEST   = 1u << 6,  // [Test], [DiagSelfTest]
+    LOG_CAT_OTHER  = 1u << 7,  // untagged lines and unknown tags
+    LOG_CAT_ALL    = 0xFFu,
+};
+
+struct LogRingSlot {
+    std::atomic<uint32_t> seq;  // == position when free, position + 1 once published
+    uint32_t              len;
+    char                  text[LOG_RING_LINE_MAX];
+};
+
+struct LogRing {
+    LogRingSlot           slots[LOG_RING_SLOTS];
+    std::atomic<uint32_t> head;        // next position a producer claims
+    std::atomic<uint32_t> tail;        // next position the consumer writes
+    std::atomic<uint32_t> draining;    // 1 while a consumer holds the ring
+    std::atomic<uint32_t> level;       // lines above this level are skipped
+    std::atomic<uint32_t> categories;  // LogCategory mask
+    std::atomic<uint64_t> dropped;     // lines refused because the ring was full
+    std::atomic<uint64_t> written;     // lines handed to a sink
+};
+
+// Only call while no producer or consumer can run (startup / tests).
+inline void LogRingInit(LogRing* r) {
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; i++) {
+        r->slots[i].seq.store(i, std::memory_order_relaxed);
+        r->slots[i].len = 0;
+    }
+    r->head.store(0, std::memory_order_relaxed);
+    r->tail.store(0, std::memory_order_relaxed);
+    r->draining.store(0, std::memory_order_relaxed);
+    r->level.store(LOG_LEVEL_DEBUG, std::memory_order_relaxed);
+    r->categories.store(LOG_CAT_ALL, std::memory_order_relaxed);
+    r->dropped.store(0, std::memory_order_relaxed);
+    r->written.store(0, std::memory_order_relaxed);
+}
+
+// Category of a line from its leading "[Tag]".
+inline uint32_t LogCategoryOf(const char* fmt) {
+    static const struct { const char* tag; uint32_t category; } kTags[] = {
+        {"[Bridge]", LOG_CAT_BRIDGE}, {"[Pipe]", LOG_CAT_PIPE},   {"[SHM]", LOG_CAT_SHM},
+        {"[Lua]", LOG_CAT_LUA},       {"[DoString]", LOG_CAT_LUA}, {"[Dump]", LOG_CAT_DUMP},
+        {"[Events]", LOG_CAT_EVENTS}, {"[Test]", LOG_CAT_TEST},   {"[DiagSelfTest]", LOG_CAT_TEST},
+    };
+    if (!fmt || fmt[0] != '[') return LOG_CAT_OTHER;
+    for (const auto& t : kTags) {
+        if (strncmp(fmt, t.tag, strlen(t.tag)) == 0) return t.category;
+    }
+    return LOG_CAT_OTHER;
+}
+
+inline bool LogRingEnabled(const LogRing* r, uint32_t level, uint32_t category) {
+    return level <= r->level.load(std::memory_order_relaxed) &&
+           (r->categories.load(std::memory_order_relaxed) & category) != 0;
+}
+
+// Formats one line into the ring. False if the ring was full (counted).
+inline bool LogRingPushV(LogRing* r, const char* fmt, va_list args) {
+    uint32_t pos = r->head.load(std::memory_order_relaxed);
+    LogRingSlot* s;
+    for (;;) {
+        s = &r->slots[pos & (LOG_RING_SLOTS - 1)];
+        const uint32_t seq = s->seq.load(std::memory_order_acquire);
+        const int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (r->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            r->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = r->head.load(std::memory_order_relaxed);
+        }
+    }
+
+    const int n = vsnprintf(s->text, LOG_RING_LINE_MAX, fmt, args);
+    if (n < 0) {
+        s->len = 0;
+    } else if (n >= LOG_RING_LINE_MAX) {
+        memcpy(s->text + LOG_RING_LINE_MAX - 5, "...\n", 5);
+        s->len = LOG_RING_LINE_MAX - 1;
+    } else {
+        s->len = (uint32_t)n;
+    }
+    s->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+inline bool LogRingPush(LogRing* r, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    const bool ok = LogRingPushV(r, fmt, args);
+    va_end(args);
+    return ok;
+}
+
+inline bool LogRingTryBeginDrain(LogRing* r) {
+    uint32_t expected = 0;
+    return r->draining.compare_exchange_strong(expected, 1, std::memory_order_acquire);
+}
+
+inline void LogRingEndDrain(LogRing* r) {
+    r->draining.store(0, std::memory_order_release);
+}
+
+// Hands every published line, in order, to sink(text, len). The caller
+// holds the drain. Stops at the first slot still being formatted; that line
+// and the ones after it go out on the next drain.
+template <typename Sink>
+inline uint32_t LogRingDrain(LogRing* r, Sink&& sink) {
+    uint32_t pos = r->tail.load(std::memory_order_relaxed);
+    uint32_t n = 0;
+    for (;;) {
+        LogRingSlot* s = &r->slots[pos & (LOG_RING_SLOTS - 1)];
+        if (s->seq.load(std::memory_order_acquire) != pos + 1) break;
+        sink(s->text, s->len);
+        s->seq.store(pos + LOG_RING_SLOTS, std::memory_order_release);
+        pos++;
+        n++;
+    }
+    r->tail.store(pos, std::memory_order_relaxed);
+    r->written.fetch_add(n, std::memory_order_relaxed);
+    return n;
+}
+
+// Synchronous drain to f for the crash handler and shutdown: waits a
+// bounded time for the writer thread to release the ring, then writes and
+// flushes. False if the writer kept it (its lines are then on their way).
+inline bool LogRingFlush(LogRing* r, FILE* f) {
+    if (!f) return false;
+    bool held = false;
+    for (int spin = 0; spin < 100000 && !(held = LogRingTryBeginDrain(r)); spin++) {
+        std::this_thread::yield();
+    }
+    if (held) {
+        LogRingDrain(r, [f](const char* text, uint32_t len) { fwrite(text, 1, len, f); });
+        LogRingEndDrain(r);
+    }
+    fflush(f);
+    return held;
+}
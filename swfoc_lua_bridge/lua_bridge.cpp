@@ -3,9 +3,13 @@
 // own thread context (safe, no thread issues).
 
 #include <windows.h>
+#include <dbghelp.h>
+#include <intrin.h>
 #include <cstdio>
 #include <cstring>
+#include <ctime>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <algorithm>
 #include <unordered_map>
@@ -13,6 +17,46 @@
 #include "rvas.h"
 #include "lua_types.h"
 #include "shared_memory.h"
+#include "pipe_protocol.h"
+#include "pipe_queue.h"
+#include "state_set.h"
+#include "damage_ring.h"
+#include "unit_shadow.h"
+#include "unit_index.h"
+#include "region_cache.h"
+#include "obj_memo.h"
+#include "bulk_mutate.h"
+#include "crc32.h"
+#include "snap_writer.h"
+#include "snap_lz4.h"
+#include "snap_delta.h"
+#include "snap_index.h"
+#include "log_ring.h"
+#include "perf_hist.h"
+#include "hook_cost.h"
+#include "combat_mods.h"
+#include "combat_stats.h"
+#include "pending_journal.h"
+#include "slot_mods.h"
+#include "crash_trail.h"
+#include "type_cache.h"
+#include "type_census.h"
+#include "unit_handles.h"
+#include "spatial_grid.h"
+#include "selection_tracker.h"
+#include "position_track.h"
+#include "spawn_batch.h"
+#include "event_compact.h"
+#include "helper_index.h"
+#include "instance_names.h"
+#include "csv_row.h"
+#include "player_table.h"
+#include "hardpoint_layout.h"
+#include "mod_catalog.h"
+#include "timeline_ring.h"
+#include "camera_path.h"
+#include "lua_table_rows.h"
+#include "planet_table.h"
 
 static uintptr_t g_base = 0;
 static lua_State* g_mainState = nullptr;
@@ -20,21 +64,26 @@ static FILE* g_log = nullptr;
 
 // Game state cache — only states with game globals (e.g. Find_Object_Type)
 static CRITICAL_SECTION csGameStates;
-static std::vector<void*> cached_game_states;
+static StateRegistry cached_game_states;
 
 // Track all states that received our SWFOC_* function registration (for pipe/shmem drain)
-static std::vector<void*> registered_states;
+// 2026-10-14: both are StateRegistry (state_set.h): O(1) open/close, and
+// registered_states.set is the lock-free lookup Hook_luaD_call uses.
+static StateRegistry registered_states;
 static CRITICAL_SECTION csRegistered;
+// 2026-10-14: states that got the full RegisterAll pass while lazy
+// registration is on (EnsureFullRegistration). Written under csRegistered.
+static StatePtrSet g_fullRegisteredSet;
 
 // ======================================================================
 // Diagnostic counters — exposed via SWFOC_Diag* helpers for live-validation.
-// All volatile + InterlockedIncrement so the PipeThreadProc writer and the
+// All volatile + InterlockedIncrement so the pipe instance writers and the
 // Hook_luaD_call writer can race with the Lua reader on whatever state is
 // currently draining commands. Zero-initialized at module load (BSS).
 // ======================================================================
-static volatile LONG g_pipeReceivedCount  = 0;  // inc on every ReadFile success in PipeThreadProc
+static volatile LONG g_pipeReceivedCount  = 0;  // inc on every command frame read by a pipe instance
 static volatile LONG g_pipeCompletedCount = 0;  // inc on every successful Lua execute + reply
-static volatile LONG g_pipeErrorCount     = 0;  // inc on every failure branch inside PipeThreadProc
+static volatile LONG g_pipeErrorCount     = 0;  // inc on every failure branch inside the pipe instances
 static volatile LONGLONG g_luaDCallTickCounter = 0;  // inc on every Hook_luaD_call invocation
 
 // Registered-helper name manifest — populated by RegisterAll once at first
@@ -75,6 +124,11 @@ static pfn_lua_pushnil      fn_pushnil          = nullptr;
 static pfn_lua_gettop       fn_gettop           = nullptr;
 static pfn_lua_pcall        fn_pcall            = nullptr;
 static pfn_lua_load         fn_load             = nullptr;
+static pfn_lua_pushvalue    fn_pushvalue        = nullptr;
+static pfn_lua_remove       fn_remove           = nullptr;
+static pfn_lua_touserdata   fn_touserdata       = nullptr;
+static pfn_lua_rawset       fn_rawset           = nullptr;
+static pfn_lua_setmetatable fn_setmetatable     = nullptr;
 
 // ======================================================================
 // Named pipe command queue (thread-safe)
@@ -87,55 +141,255 @@ static pfn_lua_load         fn_load             = nullptr;
 #define PIPE_CMD_MAX 16384
 #define PIPE_NAME    "\\\\.\\pipe\\swfoc_bridge"
 
-static CRITICAL_SECTION g_pipeLock;
-static char  g_pipeCmd[PIPE_CMD_MAX];
-static bool  g_pipeCmdPending = false;
-// The response buffer must be at least as large as PIPE_CMD_MAX — this was
-// the real truncation cause before the 2026-04-10 bump (old value was 512,
-// which capped every reply regardless of what the pipe protocol supported).
-static char  g_pipeResult[PIPE_CMD_MAX];
-static bool  g_pipeResultReady = false;
-static HANDLE g_pipeThread = nullptr;
+// 2026-10-14: the pipe and every mapping are instance-scoped
+// (instance_names.h). BridgeResolveInstance suffixes them with the
+// SWFOC_BRIDGE_INSTANCE tag before InitSharedMemory; unset, they stay
+// PIPE_NAME and the SHMEM_*_NAME names.
+static char g_instanceTag[INSTANCE_TAG_MAX] = "";
+static char g_pipeName[INSTANCE_NAME_MAX] = PIPE_NAME;
+static std::string g_instanceRecordPath;  // our registry record, removed at shutdown
+
+// 2026-10-14: replaced the single g_pipeCmd/g_pipeCmdPending slot with a
+// PIPE_QUEUE_SLOTS-deep ticketed queue (pipe_queue.h). Every slot carries its
+// own PIPE_CMD_MAX result buffer, so concurrent pipe instances no longer
+// bounce each other with "queue full" and a drain pass can run several
+// commands back to back.
+static PipeCmdQueue g_pipeQueue;
+#define PIPE_DRAIN_MAX_PER_CALL 4
+
+// 2026-10-14: per-pass main-thread time budget (pipe_queue.h), set with
+// SWFOC_SetPipeDrainBudget. g_pipeBatchCursor holds a batch that ran out of
+// budget mid-way; it is only touched by the draining (main) thread.
+static volatile LONG g_pipeDrainBudgetUs = PIPE_DRAIN_BUDGET_US_DEFAULT;
+static volatile LONG g_pipeDeferredCount = 0;  // drain passes that left work behind
+static PipeBatchCursor g_pipeBatchCursor = {};
+static int g_pipeDrainDepth = 0;  // > 1 when a drained command calls SWFOC_DrainPipe
+
+// 2026-10-14: record-only helpers push their intent into g_pendingJournal
+// (pending_journal.h); the outermost DrainPipeCommand pass folds it into
+// g_pendingState, which only the main thread touches.
+static PendingJournal g_pendingJournal;
+static PendingState   g_pendingState;
+
+// Push-to-collect round-trip latency per pipe command (pipe_queue.h),
+// reported by SWFOC_DiagPipeStats.
+static PipeLatencyHistogram g_pipeLatency = {};
+static LARGE_INTEGER g_qpcFreq = {};
+
+// 2026-10-14: per-stage pipe timings and per-helper call latency
+// (perf_hist.h), reported by SWFOC_DiagPerf. Helpers reach g_perf through
+// Lua_PerfTrampoline, which RegisterAll binds every SWFOC_* name to.
+static PerfCounters g_perf = {};
+
+static int64_t PipeQpcNow() {
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+static inline uint64_t PerfTicksToNs(int64_t ticks) {
+    const int64_t freq = g_qpcFreq.QuadPart;
+    return ticks > 0 && freq > 0 ? (uint64_t)ticks * 1000000000ull / (uint64_t)freq : 0;
+}
+
+// Records the time since `since` (PipeQpcNow ticks) under `stage`.
+static inline void PerfStageSince(uint32_t stage, int64_t since) {
+    PerfRecord(&g_perf.stages[stage], PerfTicksToNs(PipeQpcNow() - since));
+}
+
+// 2026-10-14: the listener now runs PIPE_INSTANCE_COUNT overlapped pipe
+// instances, one thread each, so a persistent client (see pipe_protocol.h)
+// no longer locks everyone else out. g_pipeShutdownEvent is manual-reset and
+// wakes every instance out of ConnectNamedPipe/ReadFile on shutdown.
+#define PIPE_INSTANCE_COUNT 4
+static HANDLE g_pipeThreads[PIPE_INSTANCE_COUNT] = {};
+static HANDLE g_pipeShutdownEvent = nullptr;
 static volatile bool g_pipeShutdown = false;
 
+// "@telemetry" record builder (pipe_protocol.h); defined with the HUD
+// counters below. Safe to call from a pipe thread.
+static void FillPipeTelemetry(PipeTelemetry* t);
+
+// Posts a drain request to the main thread's message pump (defined with the
+// focus-drain timer below). Safe to call from a pipe thread.
+static void PipeWakeMainThread();
+
 // ======================================================================
 // Shared memory command buffer (for CE which can't use pipes)
 // ======================================================================
 
+static char g_shmCmdName[INSTANCE_NAME_MAX] = SHMEM_CMD_NAME;
+static char g_shmRingName[INSTANCE_NAME_MAX] = SHMEM_RING_NAME;
+static char g_shmEvtName[INSTANCE_NAME_MAX] = SHMEM_EVT_NAME;
+static char g_shmUnitsName[INSTANCE_NAME_MAX] = SHMEM_UNITS_NAME;
+static char g_shmPlanetsName[INSTANCE_NAME_MAX] = SHMEM_PLANETS_NAME;
+
 static HANDLE g_hCmdMap = nullptr;
 static SharedCmdBuffer* g_cmdBuf = nullptr;
 static uint32_t g_lastCmdSeq = 0;
 
+// 2026-10-14: v2 command ring (shared_memory.h) next to the v1 buffer, with
+// one auto-reset done event per slot for clients to wait on.
+#define SHMEM_RING_DRAIN_MAX 4
+static HANDLE g_hRingMap = nullptr;
+static SharedCmdRing* g_cmdRing = nullptr;
+static HANDLE g_ringDone[SHMEM_RING_SLOTS] = {};
+static volatile LONG g_ringDrainGuard = 0;
+
 // Event buffer (for later waves)
 static HANDLE g_hEvtMap = nullptr;
 static SharedEvtBuffer* g_evtBuf = nullptr;
 
+// Binary unit table for SWFOC_ListTacticalUnits("bin") / EnumerateUnits
+static HANDLE g_hUnitsMap = nullptr;
+static SharedUnitTable* g_unitTable = nullptr;
+
+// Binary planet table for SWFOC_ListPlanets("bin")
+static HANDLE g_hPlanetsMap = nullptr;
+static SharedPlanetTable* g_planetTable = nullptr;
+
 // ======================================================================
-// Event ring buffer writer (lock-free SPSC: DLL is sole writer)
+// Event ring buffer writer (multi-producer: the damage / death hooks run
+// on several engine threads; see ShmEvtWrite in shared_memory.h)
 // ======================================================================
 
+// 2026-10-14: session timeline (timeline_ring.h). While g_timelineOn, every
+// event below is also staged for the timeline writer thread, with or without
+// the shared ring. The rest of the recorder sits with SWFOC_Timeline.
+static SharedEvtBuffer g_timelineStage;
+static std::atomic<bool> g_timelineOn{false};
+static uint64_t CaptureTimestampMs();
+
+static void TimelineRecordEvent(uint16_t type, const void* payload, uint16_t payloadSize) {
+    if (g_timelineOn.load(std::memory_order_relaxed))
+        TimelineStage(&g_timelineStage, type, CaptureTimestampMs(), payload, payloadSize);
+}
+
 static void WriteEvent(uint16_t type, const void* payload, uint16_t payloadSize) {
+    // The timeline keeps the full selection list instead (SampleTimeline).
+    if (type != EVT_SELECTION) TimelineRecordEvent(type, payload, payloadSize);
     if (!g_evtBuf) return;
     if (!(g_evtBuf->flags.load(std::memory_order_acquire) & 1)) return;
+    ShmEvtWrite(g_evtBuf, type, payload, payloadSize);
+}
 
-    uint32_t totalSize = 4 + payloadSize; // 2 bytes type + 2 bytes size + payload
-    uint32_t wp = g_evtBuf->write_pos.load(std::memory_order_relaxed);
-    uint32_t ringSize = sizeof(g_evtBuf->ring);
+// 2026-10-14: compact HP encoding (event_compact.h), on while
+// SHMEM_EVT_FLAG_COMPACT is set. Batches are flushed by Hook_luaD_call
+// (FlushCompactEvents) and by SWFOC_EventControl.
+static_assert(EVT_COMPACT_TYPE_HP_BATCH == EVT_HP_BATCH, "batch record type drifted");
+static_assert(EVT_COMPACT_RECORD_MAX < 0xFFFF, "a batch fits one record");
+static EvtCompactSet g_evtCompact;
+static thread_local int t_evtCompactBatch = -2;  // -2 = not claimed yet, -1 = none free
+static ULONGLONG g_evtCompactFlushTick = 0;
 
-    uint8_t header[4];
-    memcpy(header, &type, 2);
-    memcpy(header + 2, &payloadSize, 2);
+static bool EvtRingSink(uint16_t type, const void* payload, uint16_t size) {
+    return g_evtBuf && ShmEvtWrite(g_evtBuf, type, payload, size);
+}
 
-    for (uint32_t i = 0; i < 4; i++)
-        g_evtBuf->ring[(wp + i) % ringSize] = header[i];
-    const uint8_t* src = static_cast<const uint8_t*>(payload);
-    for (uint32_t i = 0; i < payloadSize; i++)
-        g_evtBuf->ring[(wp + 4 + i) % ringSize] = src[i];
+// Stages one HP change. False = no batch or session id for it; the caller
+// writes the plain EVT_HP_CHANGE instead.
+static bool WriteCompactHP(uintptr_t obj, const EvtHPChange& evt) {
+    if (t_evtCompactBatch == -2) t_evtCompactBatch = EvtCompactClaim(&g_evtCompact, (uint32_t)GetCurrentThreadId());
+    if (t_evtCompactBatch < 0) {
+        g_evtCompact.unowned.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // The type's base max hull is the fractions' base; a reader uses the
+    // value bound in EVT_UNIT_KEY. No type pointer = unknown fractions.
+    const uintptr_t typePtr = *reinterpret_cast<uintptr_t*>(obj + RVA::GameObj::GameObjType);
+    const float maxHull = typePtr ? *reinterpret_cast<float*>(typePtr + RVA::UnitType::MaxHull) : 0.0f;
+    uint64_t claim = 0;
+    const int sid = EvtSessionAcquire(&g_evtCompact.sessions, evt.unit_id, &claim);
+    if (sid < 0) return false;
+    if (claim) {
+        EvtUnitKey key;
+        key.sid = (uint16_t)sid;
+        key.unit_id = evt.unit_id;
+        key.max_hull = maxHull;
+        if (!EvtRingSink(EVT_UNIT_KEY, &key, sizeof(key))) {
+            EvtSessionRelease(&g_evtCompact.sessions, sid, claim);
+            return false;
+        }
+        EvtSessionPublish(&g_evtCompact.sessions, sid, claim);
+    }
+    return EvtCompactAppend(&g_evtCompact, t_evtCompactBatch, CaptureTimestampMs(), (uint16_t)sid,
+                            EvtQuantizeFraction(evt.old_hp, maxHull), EvtQuantizeFraction(evt.damage, maxHull),
+                            evt.damage_type, EvtRingSink);
+}
 
-    g_evtBuf->write_pos.store((wp + totalSize) % ringSize, std::memory_order_release);
-    g_evtBuf->event_count.fetch_add(1, std::memory_order_relaxed);
+// maxAgeMs 0 flushes every staged batch.
+static void FlushCompactEvents(uint64_t maxAgeMs) {
+    g_evtCompactFlushTick = GetTickCount64() + EVT_COMPACT_MAX_AGE_MS / 2;
+    EvtCompactFlushStale(&g_evtCompact, CaptureTimestampMs(), maxAgeMs, EvtRingSink);
 }
 
+// ======================================================================
+// Detour overhead counters (hook_cost.h)
+// ======================================================================
+// 2026-10-14: off until SWFOC_DiagHookCost("on"). g_hookCostTsc0/Qpc0 pair
+// a cycle reading with a QPC reading at init so the report can convert
+// cycles to time without a calibration sleep.
+static HookCostTable g_hookCost;
+static thread_local HookCostThread* t_hookCost = nullptr;
+static uint64_t g_hookCostTsc0 = 0;
+static int64_t  g_hookCostQpc0 = 0;
+
+// 2026-10-14: crash breadcrumbs (crash_trail.h). Every command the bridge
+// runs goes into g_crashTrail and every timed detour into its thread's
+// t_crashCrumbs, both stamped with __rdtsc(); CrashHandler reports them with
+// the g_hookCostTsc0/Qpc0 calibration.
+static CrashTrail g_crashTrail;
+static thread_local CrashCrumbs t_crashCrumbs = {};
+
+// One command in g_crashTrail for the lifetime of the object.
+class CrashTrailCommand {
+public:
+    CrashTrailCommand(uint32_t kind, const char* text)
+        : pos_(CrashTrailBegin(&g_crashTrail, kind, (uint32_t)GetCurrentThreadId(), (int64_t)__rdtsc(), text)) {}
+    ~CrashTrailCommand() { CrashTrailEnd(&g_crashTrail, pos_); }
+    CrashTrailCommand(const CrashTrailCommand&) = delete;
+    CrashTrailCommand& operator=(const CrashTrailCommand&) = delete;
+
+private:
+    uint64_t pos_;
+};
+
+// Times one detour invocation; route the call to the original through
+// original() so its cycles are left out. Also leaves the crash breadcrumb.
+class HookCostTimer {
+public:
+    explicit HookCostTimer(uint32_t hook) {
+        scope_.thread = nullptr;
+        const uint64_t now = __rdtsc();
+        CrashCrumbEnter(&t_crashCrumbs, hook, (int64_t)now);
+        if (!g_hookCost.enabled.load(std::memory_order_relaxed)) return;
+        if (!t_hookCost) t_hookCost = HookCostClaim(&g_hookCost, (uint32_t)GetCurrentThreadId());
+        HookCostBegin(&scope_, t_hookCost, hook, now);
+    }
+    ~HookCostTimer() {
+        if (scope_.thread) HookCostEnd(&scope_, __rdtsc());
+        CrashCrumbLeave(&t_crashCrumbs);
+    }
+    HookCostTimer(const HookCostTimer&) = delete;
+    HookCostTimer& operator=(const HookCostTimer&) = delete;
+
+    template <typename Fn, typename... Args>
+    auto original(Fn fn, Args... args) {
+        if (scope_.thread) HookCostOriginalBegin(&scope_, __rdtsc());
+        if constexpr (std::is_void_v<decltype(fn(args...))>) {
+            fn(args...);
+            if (scope_.thread) HookCostOriginalEnd(&scope_, __rdtsc());
+        } else {
+            auto result = fn(args...);
+            if (scope_.thread) HookCostOriginalEnd(&scope_, __rdtsc());
+            return result;
+        }
+    }
+
+private:
+    HookCostScope scope_;
+};
+
 // ======================================================================
 // Event stream hooks — Take_Damage_Outer + DeathHandler
 // ======================================================================
@@ -154,19 +408,7 @@ typedef void (*pfn_DeathHandler)(void* obj, int deathCause, void* killer,
                                  void* deathEvent, int deathAnim, int ownerTransfer);
 static pfn_DeathHandler real_DeathHandler = nullptr;
 
-#pragma pack(push, 1)
-struct EvtHPChange {
-    uint32_t unit_id;     // GameObj+0x50
-    float    old_hp;      // GameObj+0x5C (before damage)
-    float    damage;      // from damageParams[0]
-    int      damage_type; // damageType arg
-};
-
-struct EvtUnitDied {
-    uint32_t unit_id;     // GameObj+0x50
-    int      death_cause; // deathCause arg
-};
-#pragma pack(pop)
+// EvtHPChange / EvtUnitDied payloads are defined in shared_memory.h.
 
 // 2026-04-28 (iter 96): forward-declare the global-damage-multiplier
 // reader. Definition lives near the SWFOC_SetDamageMultiplier section
@@ -174,6 +416,23 @@ struct EvtUnitDied {
 // Returns the current multiplier, or 1.0f if the lock isn't initialised yet.
 static float ReadGlobalDamageMultiplier();
 
+// 2026-10-14: god, OHK, the global damage multiplier and damage-event
+// logging are bits of one word (combat_mods.h) so each detour pays a single
+// load when nothing is on. Event logging starts on, as it always was.
+static std::atomic<uint32_t> g_combatMods{COMBAT_MOD_DAMAGE_EVENTS};
+
+// 2026-10-14: per-slot / per-type damage and kill rollups (combat_stats.h),
+// fed while COMBAT_MOD_STATS is on. SWFOC_CombatStats reads and toggles it.
+static CombatStats g_combatStats;
+
+// 2026-10-14: per-slot income / build-speed / fire-rate / damage / freeze
+// modifiers (slot_mods.h). Hook_AddCredits indexes it by the player's slot;
+// the other fields are stored for the detours that will know the owner.
+static SlotModifierTable g_slotMods;
+// Slot -1 in SWFOC_SetIncomeMultiplier means the global knob, as in the
+// replay mirror; defined next to SWFOC_SetCreditsMultiplierGlobal.
+static void StoreGlobalCreditsMultiplier(double mult);
+
 // 2026-05-08 (iter 285): forward declaration + atomic definitions for
 // Tier 3 HUD counter machinery used inside Hook_DeathHandler (line ~206).
 // The Lua getters + units-alive walker live in the SetDamageMultiplier/
@@ -185,6 +444,7 @@ static std::atomic<int> g_localPlayerDeaths{0};
 
 static char Hook_TakeDamageOuter(void* obj, int damageType, uint8_t applyDamage,
                                   float* damageParams, int sourceInfo, unsigned int flags) {
+    HookCostTimer cost(HOOK_COST_TAKE_DAMAGE_OUTER);
     // 2026-04-28 (iter 96): SWFOC_SetDamageMultiplier global-only LIVE
     // wiring. iter 95 architectural finding: Take_Damage_Outer is THE
     // chokepoint for hull/shield damage and damageParams[0] is the
@@ -194,110 +454,197 @@ static char Hook_TakeDamageOuter(void* obj, int damageType, uint8_t applyDamage,
     // attacker context isn't available at this layer (sourceInfo arg is
     // a tag, not an attacker GameObj*). See the iter 95 comment block
     // for SetDamageMultiplier below for the full architectural reasoning.
-    if (damageParams) {
+    if (damageParams && CombatModOn(&g_combatMods, COMBAT_MOD_DAMAGE_MULT)) {
         const float mult = ReadGlobalDamageMultiplier();
         if (mult != 1.0f && mult >= 0.0f) {
             damageParams[0] = damageParams[0] * mult;
         }
     }
 
-    if (g_evtBuf && (g_evtBuf->flags.load(std::memory_order_acquire) & 1)) {
+    // 2026-10-14: combat rollups. The damage is the post-multiplier value,
+    // as the event below records it.
+    if (obj && damageParams && CombatModOn(&g_combatMods, COMBAT_MOD_STATS)) {
+        const uintptr_t victim = reinterpret_cast<uintptr_t>(obj);
+        CombatStatsRecordDamage(&g_combatStats, *reinterpret_cast<int32_t*>(victim + RVA::GameObj::OwnerPlayerID),
+                                *reinterpret_cast<uint64_t*>(victim + RVA::GameObj::GameObjType), damageParams[0],
+                                GetTickCount64());
+    }
+
+    const uint32_t evtFlags = g_evtBuf ? g_evtBuf->flags.load(std::memory_order_acquire) : 0;
+    if ((evtFlags & 1) || g_timelineOn.load(std::memory_order_relaxed)) {
         EvtHPChange evt;
         evt.unit_id    = *reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::ObjectID);
         evt.old_hp     = *reinterpret_cast<float*>(reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::HP);
         evt.damage     = damageParams ? damageParams[0] : 0.0f;  // Records POST-scale value.
         evt.damage_type = damageType;
-        WriteEvent(EVT_HP_CHANGE, &evt, sizeof(evt));
+        if ((evtFlags & 1) && (evtFlags & SHMEM_EVT_FLAG_COMPACT) && WriteCompactHP(reinterpret_cast<uintptr_t>(obj), evt))
+            TimelineRecordEvent(EVT_HP_CHANGE, &evt, sizeof(evt));
+        else
+            WriteEvent(EVT_HP_CHANGE, &evt, sizeof(evt));
     }
-    return real_TakeDamageOuter(obj, damageType, applyDamage, damageParams, sourceInfo, flags);
+    return cost.original(real_TakeDamageOuter, obj, damageType, applyDamage, damageParams, sourceInfo, flags);
 }
 
 static void Hook_DeathHandler(void* obj, int deathCause, void* killer,
                                void* deathEvent, int deathAnim, int ownerTransfer) {
-    if (g_evtBuf && (g_evtBuf->flags.load(std::memory_order_acquire) & 1)) {
-        EvtUnitDied evt;
-        evt.unit_id    = *reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::ObjectID);
-        evt.death_cause = deathCause;
-        WriteEvent(EVT_UNIT_DIED, &evt, sizeof(evt));
-    }
+    HookCostTimer cost(HOOK_COST_DEATH_HANDLER);
     // 2026-05-08 (iter 285): Tier 3 HUD counter increments. Compare killer
     // and victim owner-slots against the local player; bump atomic counters
     // when the local player is involved. Non-fatal on null/garbage pointers
     // (defensive: deathCause may correspond to environmental kill where
     // killer is null). FindLocalPlayerSlot() returns -1 in galactic-mode
     // transitions; both branches gate on >=0 so transitions are no-ops.
+    // 2026-10-14: the same slots go into EVT_UNIT_DIED so the overlay can
+    // count from the stream with exactly these rules.
     const int localSlot = FindLocalPlayerSlot();
+    const int victimSlot = obj ? static_cast<int>(*reinterpret_cast<uint32_t*>(
+        reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::OwnerPlayerID)) : -1;
+    const int killerSlot = killer ? static_cast<int>(*reinterpret_cast<uint32_t*>(
+        reinterpret_cast<uintptr_t>(killer) + RVA::GameObj::OwnerPlayerID)) : -1;
+
+    if ((g_evtBuf && (g_evtBuf->flags.load(std::memory_order_acquire) & 1))
+        || g_timelineOn.load(std::memory_order_relaxed)) {
+        EvtUnitDied evt;
+        evt.unit_id    = *reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::ObjectID);
+        evt.death_cause = deathCause;
+        evt.victim_owner = victimSlot;
+        evt.killer_owner = killerSlot;
+        evt.local_slot = localSlot;
+        WriteEvent(EVT_UNIT_DIED, &evt, sizeof(evt));
+    }
+    if (obj && CombatModOn(&g_combatMods, COMBAT_MOD_STATS)) {
+        const uint64_t victimType = *reinterpret_cast<uint64_t*>(reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::GameObjType);
+        const uint64_t killerType = killer
+            ? *reinterpret_cast<uint64_t*>(reinterpret_cast<uintptr_t>(killer) + RVA::GameObj::GameObjType) : 0;
+        CombatStatsRecordDeath(&g_combatStats, victimSlot, victimType, killerSlot, killerType);
+    }
     if (localSlot >= 0) {
-        if (killer) {
-            const auto killerSlot = *reinterpret_cast<uint32_t*>(
-                reinterpret_cast<uintptr_t>(killer) + RVA::GameObj::OwnerPlayerID);
-            if (static_cast<int>(killerSlot) == localSlot) {
-                g_localPlayerKills.fetch_add(1, std::memory_order_relaxed);
-            }
+        if (killer && killerSlot == localSlot) {
+            g_localPlayerKills.fetch_add(1, std::memory_order_relaxed);
         }
-        if (obj) {
-            const auto victimSlot = *reinterpret_cast<uint32_t*>(
-                reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::OwnerPlayerID);
-            if (static_cast<int>(victimSlot) == localSlot) {
-                g_localPlayerDeaths.fetch_add(1, std::memory_order_relaxed);
-            }
+        if (obj && victimSlot == localSlot) {
+            g_localPlayerDeaths.fetch_add(1, std::memory_order_relaxed);
         }
     }
-    real_DeathHandler(obj, deathCause, killer, deathEvent, deathAnim, ownerTransfer);
+    cost.original(real_DeathHandler, obj, deathCause, killer, deathEvent, deathAnim, ownerTransfer);
+}
+
+// Log lines go through g_logRing (log_ring.h) to LogWriterThreadProc. Until
+// that thread runs (or if it failed to start) Log() writes synchronously.
+// SWFOC_SetLogLevel changes the level and category mask at runtime.
+static LogRing g_logRing;
+static HANDLE g_logThread = nullptr;
+static HANDLE g_logStopEvent = nullptr;
+static volatile LONG g_logAsync = 0;
+#define LOG_WRITER_PERIOD_MS 25
+
+static void LogV(uint32_t level, const char* fmt, va_list args) {
+    if (!g_log || !LogRingEnabled(&g_logRing, level, LogCategoryOf(fmt))) return;
+    if (g_logAsync) {
+        LogRingPushV(&g_logRing, fmt, args);
+        return;
+    }
+    vfprintf(g_log, fmt, args);
+    fflush(g_log);
 }
 
 static void Log(const char* fmt, ...) {
-    if (!g_log) return;
     va_list args;
     va_start(args, fmt);
-    vfprintf(g_log, fmt, args);
+    LogV(LOG_LEVEL_INFO, fmt, args);
     va_end(args);
-    fflush(g_log);
 }
 
-template<typename T>
-static T Resolve(uintptr_t rva) {
-    return reinterpret_cast<T>(g_base + rva);
+// Per-command detail (every pipe receive / execute); the first lines to go
+// when the level is lowered to info.
+static void LogDebug(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    LogV(LOG_LEVEL_DEBUG, fmt, args);
+    va_end(args);
 }
 
-// ======================================================================
-// CRC32 (polynomial 0xEDB88320, table-driven, zlib-compatible)
-// Used by SWFOC_DumpState to seal snapshot files. SAFE from any thread —
-// no Lua calls, no heap allocation, table is lazily initialized once.
-// ======================================================================
-
-static uint32_t g_crc32Table[256];
-static bool g_crc32TableReady = false;
-
-static void Crc32_BuildTable() {
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t c = i;
-        for (int k = 0; k < 8; k++) {
-            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+// Synchronous: the crash handler and shutdown call this so queued lines
+// reach the file before the process goes away.
+static void LogFlush() {
+    LogRingFlush(&g_logRing, g_log);
+}
+
+static DWORD WINAPI LogWriterThreadProc(LPVOID) {
+    uint64_t reportedDrops = 0;
+    for (;;) {
+        const bool stopping = WaitForSingleObject(g_logStopEvent, LOG_WRITER_PERIOD_MS) == WAIT_OBJECT_0;
+        if (LogRingTryBeginDrain(&g_logRing)) {
+            uint32_t n = LogRingDrain(&g_logRing, [](const char* text, uint32_t len) {
+                fwrite(text, 1, len, g_log);
+            });
+            const uint64_t dropped = g_logRing.dropped.load(std::memory_order_relaxed);
+            if (dropped != reportedDrops) {
+                fprintf(g_log, "[Log] %llu lines dropped (ring full)\n",
+                        (unsigned long long)(dropped - reportedDrops));
+                reportedDrops = dropped;
+                n++;
+            }
+            LogRingEndDrain(&g_logRing);
+            if (n) fflush(g_log);
         }
-        g_crc32Table[i] = c;
+        if (stopping) return 0;
     }
-    g_crc32TableReady = true;
 }
 
-static uint32_t Crc32_Update(uint32_t crc, const void* data, size_t len) {
-    if (!g_crc32TableReady) Crc32_BuildTable();
-    const uint8_t* p = static_cast<const uint8_t*>(data);
-    crc = crc ^ 0xFFFFFFFFu;
-    for (size_t i = 0; i < len; i++) {
-        crc = g_crc32Table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+static void LogStartWriter() {
+    LogRingInit(&g_logRing);
+    if (!g_log) return;
+    g_logStopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!g_logStopEvent) return;
+    g_logThread = CreateThread(nullptr, 0, LogWriterThreadProc, nullptr, 0, nullptr);
+    if (g_logThread) InterlockedExchange(&g_logAsync, 1);
+}
+
+static void LogStopWriter() {
+    if (g_logThread) {
+        SetEvent(g_logStopEvent);
+        WaitForSingleObject(g_logThread, 2000);
+        CloseHandle(g_logThread);
+        g_logThread = nullptr;
     }
-    return crc ^ 0xFFFFFFFFu;
+    if (g_logStopEvent) { CloseHandle(g_logStopEvent); g_logStopEvent = nullptr; }
+    InterlockedExchange(&g_logAsync, 0);
+    LogFlush();
+}
+
+template<typename T>
+static T Resolve(uintptr_t rva) {
+    return reinterpret_cast<T>(g_base + rva);
 }
 
 // ======================================================================
 // Shared memory initialization
 // ======================================================================
 
+// Suffixes the pipe and mapping names with the SWFOC_BRIDGE_INSTANCE tag.
+// A value that is not a valid tag is logged and ignored: a bridge on the
+// legacy names beats no bridge at all.
+static void BridgeResolveInstance() {
+    if (!InstanceTagFromEnv(g_instanceTag, sizeof(g_instanceTag))) {
+        Log("[Bridge] WARNING: %s is not a valid instance tag ([A-Za-z0-9_-], at most %d), using the default names\n",
+            INSTANCE_ENV_VAR, INSTANCE_TAG_MAX - 1);
+        g_instanceTag[0] = '\0';
+    }
+    if (!g_instanceTag[0]) return;
+    InstanceName(PIPE_NAME, g_instanceTag, g_pipeName, sizeof(g_pipeName));
+    InstanceName(SHMEM_CMD_NAME, g_instanceTag, g_shmCmdName, sizeof(g_shmCmdName));
+    InstanceName(SHMEM_RING_NAME, g_instanceTag, g_shmRingName, sizeof(g_shmRingName));
+    InstanceName(SHMEM_EVT_NAME, g_instanceTag, g_shmEvtName, sizeof(g_shmEvtName));
+    InstanceName(SHMEM_UNITS_NAME, g_instanceTag, g_shmUnitsName, sizeof(g_shmUnitsName));
+    InstanceName(SHMEM_PLANETS_NAME, g_instanceTag, g_shmPlanetsName, sizeof(g_shmPlanetsName));
+    Log("[Bridge] Instance '%s': pipe=%s\n", g_instanceTag, g_pipeName);
+}
+
 static bool InitSharedMemory() {
     // Command buffer
     g_hCmdMap = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
-        PAGE_READWRITE, 0, sizeof(SharedCmdBuffer), SHMEM_CMD_NAME);
+        PAGE_READWRITE, 0, sizeof(SharedCmdBuffer), g_shmCmdName);
     if (!g_hCmdMap) {
         Log("[SHM] CreateFileMapping CMD failed: %lu\n", GetLastError());
         return false;
@@ -310,20 +657,84 @@ static bool InitSharedMemory() {
         return false;
     }
     memset(g_cmdBuf, 0, sizeof(SharedCmdBuffer));
-    Log("[SHM] Command buffer created: %s (%u bytes)\n", SHMEM_CMD_NAME, (uint32_t)sizeof(SharedCmdBuffer));
+    Log("[SHM] Command buffer created: %s (%u bytes)\n", g_shmCmdName, (uint32_t)sizeof(SharedCmdBuffer));
+
+    // Command ring v2. Optional: v1 keeps working if this fails.
+    g_hRingMap = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
+        PAGE_READWRITE, 0, sizeof(SharedCmdRing), g_shmRingName);
+    if (g_hRingMap) {
+        g_cmdRing = (SharedCmdRing*)MapViewOfFile(g_hRingMap,
+            FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedCmdRing));
+    }
+    if (g_cmdRing) {
+        char evName[64];
+        for (int i = 0; i < SHMEM_RING_SLOTS; i++) {
+            InstanceEventName(SHMEM_RING_EVENT_PREFIX, g_instanceTag, i, evName, sizeof(evName));
+            g_ringDone[i] = CreateEventA(nullptr, FALSE, FALSE, evName);
+        }
+        ShmRingInit(g_cmdRing);
+        Log("[SHM] Command ring created: %s (%d slots, %u bytes)\n", g_shmRingName,
+            SHMEM_RING_SLOTS, (uint32_t)sizeof(SharedCmdRing));
+    } else {
+        Log("[SHM] Command ring unavailable: %lu\n", GetLastError());
+        if (g_hRingMap) { CloseHandle(g_hRingMap); g_hRingMap = nullptr; }
+    }
 
+    return true;
+}
+
+// 2026-10-14: the event buffer and the unit / planet tables are mapped by
+// the background init phase, after the game thread is already running, so
+// each view is initialized through a local and only then published behind
+// a release fence: a reader sees either nullptr or a ready table.
+static void InitEventSharedMemory() {
     // Event buffer (created now, populated later in Wave 1D)
     g_hEvtMap = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
-        PAGE_READWRITE, 0, sizeof(SharedEvtBuffer), SHMEM_EVT_NAME);
+        PAGE_READWRITE, 0, sizeof(SharedEvtBuffer), g_shmEvtName);
     if (g_hEvtMap) {
-        g_evtBuf = (SharedEvtBuffer*)MapViewOfFile(g_hEvtMap,
+        SharedEvtBuffer* evt = (SharedEvtBuffer*)MapViewOfFile(g_hEvtMap,
             FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedEvtBuffer));
-        if (g_evtBuf) {
-            memset(g_evtBuf, 0, sizeof(SharedEvtBuffer));
-            Log("[SHM] Event buffer created: %s (%u bytes)\n", SHMEM_EVT_NAME, (uint32_t)sizeof(SharedEvtBuffer));
+        if (evt) {
+            ShmEvtInit(evt);
+            std::atomic_thread_fence(std::memory_order_release);
+            g_evtBuf = evt;
+            Log("[SHM] Event buffer created: %s (%u bytes)\n", g_shmEvtName, (uint32_t)sizeof(SharedEvtBuffer));
+        }
+    }
+
+    // Unit table. Optional: the CSV unit helpers work without it.
+    g_hUnitsMap = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
+        PAGE_READWRITE, 0, sizeof(SharedUnitTable), g_shmUnitsName);
+    if (g_hUnitsMap) {
+        SharedUnitTable* units = (SharedUnitTable*)MapViewOfFile(g_hUnitsMap,
+            FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedUnitTable));
+        if (units) {
+            ShmUnitsInit(units);
+            std::atomic_thread_fence(std::memory_order_release);
+            g_unitTable = units;
+            Log("[SHM] Unit table created: %s (%u bytes)\n", g_shmUnitsName, (uint32_t)sizeof(SharedUnitTable));
+        } else {
+            CloseHandle(g_hUnitsMap);
+            g_hUnitsMap = nullptr;
+        }
+    }
+
+    // Planet table. Optional as well: SWFOC_ListPlanets falls back to CSV.
+    g_hPlanetsMap = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
+        PAGE_READWRITE, 0, sizeof(SharedPlanetTable), g_shmPlanetsName);
+    if (g_hPlanetsMap) {
+        SharedPlanetTable* planets = (SharedPlanetTable*)MapViewOfFile(g_hPlanetsMap,
+            FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedPlanetTable));
+        if (planets) {
+            ShmPlanetsInit(planets);
+            std::atomic_thread_fence(std::memory_order_release);
+            g_planetTable = planets;
+            Log("[SHM] Planet table created: %s (%u bytes)\n", g_shmPlanetsName, (uint32_t)sizeof(SharedPlanetTable));
+        } else {
+            CloseHandle(g_hPlanetsMap);
+            g_hPlanetsMap = nullptr;
         }
     }
-    return true;
 }
 
 // Helpers using now-confirmed RVAs
@@ -354,224 +765,788 @@ static const char* StringReader(lua_State* L, void* ud, size_t* sz) {
     return rd->str;
 }
 
+// 2026-10-14: compiled-chunk cache. Editors and the HUD resend the same
+// probe text many times a second, and every DoString used to re-run the
+// parser for it. Each state now keeps registry[CHUNK_CACHE_KEY] =
+// { [chunk text] = compiled function, [1] = entry count }; a hit skips
+// lua_load entirely. Only successful compiles are stored, so load errors
+// still come back fresh every time. The table is dropped (and rebuilt on
+// the next miss) once it holds CHUNK_CACHE_MAX_ENTRIES chunks, which bounds
+// memory when callers embed changing arguments in the chunk text. A cached
+// function keeps the chunkname of its first load.
+#define CHUNK_CACHE_KEY         "SWFOC.ChunkCache"
+#define CHUNK_CACHE_MAX_ENTRIES 256
+#define CHUNK_CACHE_MAX_CODE    4096
+
+// Main-thread writers, SWFOC_DiagPipeStats reader.
+static volatile LONG g_chunkCacheHits = 0;
+static volatile LONG g_chunkCacheMisses = 0;
+
+static int LoadChunk(lua_State* L, const char* code, size_t len, const char* chunkname) {
+    StringReaderData rd;
+    rd.str  = code;
+    rd.len  = len;
+    rd.done = false;
+    return fn_load(L, StringReader, &rd, chunkname);
+}
+
+// Pushes this state's cache table, creating it on first use.
+static void PushChunkCache(lua_State* L) {
+    fn_pushstring(L, CHUNK_CACHE_KEY);
+    fn_gettable(L, LUA_REGISTRYINDEX);
+    if (fn_type(L, -1) == LUA_TTABLE) return;
+    fn_settop(L, -2);
+    fn_newtable(L);
+    fn_pushstring(L, CHUNK_CACHE_KEY);
+    fn_pushvalue(L, -2);
+    fn_settable(L, LUA_REGISTRYINDEX);
+}
+
+// Same contract as lua_load: pushes the compiled chunk (0) or the error
+// message (non-zero), served from the cache when the text was seen before.
+static int LoadChunkCached(lua_State* L, const char* code, const char* chunkname) {
+    const size_t len = strlen(code);
+    if (!fn_pushvalue || !fn_remove || len > CHUNK_CACHE_MAX_CODE)
+        return LoadChunk(L, code, len, chunkname);
+
+    PushChunkCache(L);
+    const int cache = fn_gettop(L);
+    fn_pushstring(L, code);
+    fn_gettable(L, cache);
+    if (fn_type(L, -1) == LUA_TFUNCTION) {
+        fn_remove(L, cache);
+        InterlockedIncrement(&g_chunkCacheHits);
+        return 0;
+    }
+    fn_settop(L, -2);
+    InterlockedIncrement(&g_chunkCacheMisses);
+
+    int loadErr = LoadChunk(L, code, len, chunkname);
+    if (loadErr == 0) {
+        fn_pushnumber(L, 1);
+        fn_gettable(L, cache);
+        const int entries = (int)fn_tonumber(L, -1);  // nil -> 0
+        fn_settop(L, -2);
+        if (entries >= CHUNK_CACHE_MAX_ENTRIES) {
+            // Flush: forget the full table; the next miss starts a new one.
+            fn_pushstring(L, CHUNK_CACHE_KEY);
+            fn_pushnil(L);
+            fn_settable(L, LUA_REGISTRYINDEX);
+        } else {
+            fn_pushstring(L, code);
+            fn_pushvalue(L, -2);
+            fn_settable(L, cache);
+            fn_pushnumber(L, 1);
+            fn_pushnumber(L, entries + 1);
+            fn_settable(L, cache);
+        }
+    }
+    fn_remove(L, cache);
+    return loadErr;
+}
+
 // Load + execute a Lua string. Returns 0 on success, error code otherwise.
 // On success, pushes 1 return value (or nil if script returns nothing).
 // On failure, pushes error message string onto the stack.
 // Caller must pop the top value in both cases.
 static int DoString(lua_State* L, const char* code, const char* chunkname = "=pipe") {
     if (!fn_load || !fn_pcall) return -1;
-    StringReaderData rd;
-    rd.str  = code;
-    rd.len  = strlen(code);
-    rd.done = false;
-    int loadErr = fn_load(L, StringReader, &rd, chunkname);
+    const int64_t t0 = PipeQpcNow();
+    int loadErr = LoadChunkCached(L, code, chunkname);
+    const int64_t t1 = PipeQpcNow();
+    PerfRecord(&g_perf.stages[PERF_STAGE_LUA_COMPILE], PerfTicksToNs(t1 - t0));
     if (loadErr != 0) {
         // error string is on top of stack
         return loadErr;
     }
     // chunk is on top — call it with 0 args, 1 result (capture return value)
     int callErr = fn_pcall(L, 0, 1, 0);
+    PerfStageSince(PERF_STAGE_LUA_EXEC, t1);
     return callErr; // top of stack has return value (success) or error string (failure)
 }
 
+// 2026-10-14: precompiled helper scripts. SWFOC_GetPlanets,
+// SWFOC_GetFactionRoster and SWFOC_RevealAll used to DoString a fixed
+// multi-line script (the roster with the faction name pasted in), so the
+// galactic-map refresh paid the parser on every call and every new faction
+// missed the chunk cache. Each script is now "return function(args) ...
+// end": RegisterAll runs it once per state and keeps the closure at
+// registry[key]; callers push the closure, push their arguments and
+// fn_pcall it. A state that never went through RegisterAll compiles on
+// first use.
+enum HelperScriptId {
+    HELPER_GET_PLANETS = 0,  // () -> rows or '(no_planets)'
+    HELPER_FACTION_ROSTER,   // (faction) -> rows or '(empty)'
+    HELPER_REVEAL_ALL,       // (slot or 'local')
+    HELPER_SPAWN_UNITS,      // (faction, type, x, y, z, n) -> units spawned
+    HELPER_SCRIPT_COUNT
+};
+
+struct HelperScript {
+    const char* key;        // registry key of the compiled closure
+    const char* chunkname;
+    const char* code;
+};
+
+// Lua 5.0: no '#table' (counter-style iteration); pcall, table.concat and
+// tostring are available.
+static const HelperScript kHelperScripts[HELPER_SCRIPT_COUNT] = {
+    {"SWFOC.Helper.GetPlanets", "=SWFOC_GetPlanets",
+        "return function()\n"
+        "local cats = { 'Planet', 'GalacticPlanet', 'Planetary' }\n"
+        "local pl = nil\n"
+        "for _, c in pairs(cats) do\n"
+        "  local ok, r = pcall(Find_All_Objects_Of_Type, c)\n"
+        "  if ok and r and type(r) == 'table' then\n"
+        "    pl = r; break\n"
+        "  end\n"
+        "end\n"
+        "if not pl then return '(no_planets)' end\n"
+        "local rows = {}\n"
+        "local n = 0\n"
+        "for i, p in pairs(pl) do\n"
+        "  if p then\n"
+        "    n = n + 1\n"
+        "    local name = '?'\n"
+        "    local faction = 'NONE'\n"
+        "    local tech = 0\n"
+        "    local ok1, nm = pcall(function() return tostring(p:Get_Type()) end)\n"
+        "    if ok1 and nm then name = nm end\n"
+        "    local ok2, ow = pcall(function() return p:Get_Owner() end)\n"
+        "    if ok2 and ow then\n"
+        "      local ok3, fn = pcall(function() return tostring(ow:Get_Faction_Name()) end)\n"
+        "      if ok3 and fn then faction = fn end\n"
+        "      local ok4, tl = pcall(function() return ow:Get_Tech_Level() end)\n"
+        "      if ok4 and type(tl) == 'number' then tech = tl end\n"
+        "    end\n"
+        "    rows[n] = name .. ';' .. faction .. ';' .. tech\n"
+        "  end\n"
+        "end\n"
+        "if n == 0 then return '(no_planets)' end\n"
+        "return table.concat(rows, '\\n')\n"
+        "end"},
+    {"SWFOC.Helper.FactionRoster", "=SWFOC_GetFactionRoster",
+        "return function(target)\n"
+        "local cats = { 'GroundCompany', 'Hero', 'SpaceUnit', 'Infantry', 'Vehicle' }\n"
+        "local rows = {}\n"
+        "local n = 0\n"
+        "for _, c in pairs(cats) do\n"
+        "  local ok, list = pcall(Find_All_Objects_Of_Type, c)\n"
+        "  if ok and list and type(list) == 'table' then\n"
+        "    for _, u in pairs(list) do\n"
+        "      if u then\n"
+        "        local fac = '?'\n"
+        "        local ok1, ow = pcall(function() return u:Get_Owner() end)\n"
+        "        if ok1 and ow then\n"
+        "          local ok2, fn = pcall(function() return tostring(ow:Get_Faction_Name()) end)\n"
+        "          if ok2 and fn then fac = fn end\n"
+        "        end\n"
+        "        if fac == target then\n"
+        "          local name = '?'\n"
+        "          local ok3, nm = pcall(function() return tostring(u:Get_Type()) end)\n"
+        "          if ok3 and nm then name = nm end\n"
+        "          n = n + 1\n"
+        "          rows[n] = name .. ';' .. c\n"
+        "        end\n"
+        "      end\n"
+        "    end\n"
+        "  end\n"
+        "end\n"
+        "if n == 0 then return '(empty)' end\n"
+        "return table.concat(rows, '\\n')\n"
+        "end"},
+    {"SWFOC.Helper.RevealAll", "=SWFOC_RevealAll",
+        "return function(who)\n"
+        "local p = Find_Player(who)\n"
+        "if p and p.Get_Fog_Of_War then p:Get_Fog_Of_War():Reveal_All(p) end\n"
+        "end"},
+    {"SWFOC.Helper.SpawnUnits", "=SWFOC_SpawnBatch",
+        "return function(faction, typ, x, y, z, n)\n"
+        "local p = Find_Player(faction)\n"
+        "local t = Find_Object_Type(typ)\n"
+        "if not p or not t then return 0 end\n"
+        "local pos = Create_Position(x, y, z)\n"
+        "local k = 0\n"
+        "for i = 1, n do\n"
+        "  if pcall(Spawn_Unit, p, t, pos) then k = k + 1 end\n"
+        "end\n"
+        "return k\n"
+        "end"},
+};
+
+// RegisterAll writer, SWFOC_DiagPipeStats reader.
+static volatile LONG g_helperCompiles = 0;
+
+// Compiles helper `id` and stores its closure in the registry. Leaves the
+// stack as it was; false (logged) if the script failed to load or run.
+static bool CompileHelperScript(lua_State* L, int id) {
+    const HelperScript& h = kHelperScripts[id];
+    if (!fn_load || !fn_pcall) return false;
+    fn_pushstring(L, h.key);
+    const int64_t t0 = PipeQpcNow();
+    int err = LoadChunk(L, h.code, strlen(h.code), h.chunkname);
+    PerfStageSince(PERF_STAGE_LUA_COMPILE, t0);
+    if (err == 0) err = fn_pcall(L, 0, 1, 0);
+    if (err != 0 || fn_type(L, -1) != LUA_TFUNCTION) {
+        const char* msg = err != 0 ? fn_tostring(L, -1) : "did not return a function";
+        Log("[Bridge] Helper script %s failed to compile (rc=%d): %s\n", h.chunkname + 1, err, msg ? msg : "?");
+        fn_settop(L, -3);
+        return false;
+    }
+    fn_settable(L, LUA_REGISTRYINDEX);
+    InterlockedIncrement(&g_helperCompiles);
+    return true;
+}
+
+// Pushes helper `id`'s closure and returns true, or pushes nothing and
+// returns false when it cannot be compiled.
+static bool PushHelperScript(lua_State* L, int id) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        fn_pushstring(L, kHelperScripts[id].key);
+        fn_gettable(L, LUA_REGISTRYINDEX);
+        if (fn_type(L, -1) == LUA_TFUNCTION) return true;
+        fn_settop(L, -2);
+        if (attempt == 0 && !CompileHelperScript(L, id)) return false;
+    }
+    return false;
+}
+
 // ======================================================================
-// Named pipe listener thread
+// Named pipe listener threads
 // ======================================================================
 
-static DWORD WINAPI PipeThreadProc(LPVOID) {
-    Log("[Pipe] Listener thread started, pipe=%s\n", PIPE_NAME);
+// Completes an overlapped pipe operation. `started` is what ReadFile /
+// WriteFile returned. Returns false on I/O failure or when shutdown fires
+// first (the operation is cancelled before returning).
+static bool PipeAwaitIo(HANDLE hPipe, OVERLAPPED* ov, BOOL started, DWORD* transferred) {
+    *transferred = 0;
+    if (!started) {
+        if (GetLastError() != ERROR_IO_PENDING) return false;
+        HANDLE waits[2] = { ov->hEvent, g_pipeShutdownEvent };
+        if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0) {
+            CancelIo(hPipe);
+            GetOverlappedResult(hPipe, ov, transferred, TRUE);
+            return false;
+        }
+    }
+    return GetOverlappedResult(hPipe, ov, transferred, FALSE) != FALSE;
+}
 
-    while (!g_pipeShutdown) {
-        HANDLE hPipe = CreateNamedPipeA(
-            PIPE_NAME,
-            PIPE_ACCESS_DUPLEX,
-            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
-            1,        // max instances
-            512,      // out buffer
-            PIPE_CMD_MAX, // in buffer
-            1000,     // default timeout ms
-            nullptr);
+static bool PipeConnect(HANDLE hPipe, OVERLAPPED* ov) {
+    ResetEvent(ov->hEvent);
+    if (ConnectNamedPipe(hPipe, ov)) return true;
+    DWORD err = GetLastError();
+    if (err == ERROR_PIPE_CONNECTED) return true;
+    if (err != ERROR_IO_PENDING) return false;
+    DWORD unused;
+    return PipeAwaitIo(hPipe, ov, FALSE, &unused);
+}
 
-        if (hPipe == INVALID_HANDLE_VALUE) {
-            Log("[Pipe] CreateNamedPipe failed: %lu\n", GetLastError());
-            InterlockedIncrement(&g_pipeErrorCount);
-            Sleep(1000);
-            continue;
-        }
+static bool PipeRead(HANDLE hPipe, OVERLAPPED* ov, char* buf, DWORD cap, DWORD* got) {
+    ResetEvent(ov->hEvent);
+    BOOL ok = ReadFile(hPipe, buf, cap, nullptr, ov);
+    return PipeAwaitIo(hPipe, ov, ok, got) && *got > 0;
+}
 
-        // Wait for client — blocks until connection or error
-        BOOL connected = ConnectNamedPipe(hPipe, nullptr)
-            ? TRUE : (GetLastError() == ERROR_PIPE_CONNECTED);
+static bool PipeWrite(HANDLE hPipe, OVERLAPPED* ov, const char* data, DWORD len) {
+    ResetEvent(ov->hEvent);
+    BOOL ok = WriteFile(hPipe, data, len, nullptr, ov);
+    DWORD written;
+    return PipeAwaitIo(hPipe, ov, ok, &written) && written == len;
+}
 
-        if (!connected || g_pipeShutdown) {
-            if (!g_pipeShutdown) InterlockedIncrement(&g_pipeErrorCount);
-            CloseHandle(hPipe);
-            continue;
+// Queues one command for main-thread execution and waits for its result.
+// NEVER execute Lua from a pipe thread — race condition causes heap corruption.
+// The reply (always '\n'-terminated) is copied into `reply`. Returns false for
+// queue-full / timeout replies so the caller can account them as errors.
+static bool ExecuteOnMainThread(const char* cmd, size_t cmdLen, char* reply, size_t replyCap,
+                                uint32_t batchCount = 0) {
+    uint32_t ticket;
+    const int64_t t0 = PipeQpcNow();
+    if (!PipeQueuePush(&g_pipeQueue, cmd, cmdLen, &ticket, batchCount, t0)) {
+        snprintf(reply, replyCap, PIPE_REPLY_QUEUE_FULL ", try again\n");
+        return false;
+    }
+    PipeWakeMainThread();
+
+    // Block until the main thread (luaD_call hook / focus-drain timer)
+    // completes the slot or shutdown fires. Re-check after every wake: the
+    // slot event may carry a stale signal from an abandoned earlier ticket.
+    HANDLE waits[2] = { PipeQueueDoneEvent(&g_pipeQueue, ticket), g_pipeShutdownEvent };
+    const ULONGLONG deadline = GetTickCount64() + 10000;
+    for (;;) {
+        if (PipeQueueCollect(&g_pipeQueue, ticket, reply, replyCap)) {
+            const uint64_t waitNs = PerfTicksToNs(PipeQpcNow() - t0);
+            PipeLatencyRecord(&g_pipeLatency, waitNs / 1000);
+            PerfRecord(&g_perf.stages[PERF_STAGE_MAIN_WAIT], waitNs);
+            return true;
         }
+        ULONGLONG now = GetTickCount64();
+        if (now >= deadline) break;
+        if (WaitForMultipleObjects(2, waits, FALSE, (DWORD)(deadline - now)) != WAIT_OBJECT_0) break;
+    }
+    if (PipeQueueCollect(&g_pipeQueue, ticket, reply, replyCap)) return true;
+    PipeQueueAbandon(&g_pipeQueue, ticket);
+    snprintf(reply, replyCap, PIPE_REPLY_TIMEOUT " (10s) - game may be paused or in menu\n");
+    return false;
+}
+
+// Runs one command frame (or one packed batch) and writes its reply.
+// Returns false if the reply could not be written (client gone).
+static bool PipeServeCommand(HANDLE hPipe, OVERLAPPED* ov, const char* cmd, size_t cmdLen,
+                             uint32_t batchCount = 0) {
+    // SWFOC_DiagPipeStats: count every command frame (or batch) as "received".
+    InterlockedIncrement(&g_pipeReceivedCount);
+    if (batchCount) {
+        LogDebug("[Pipe] Received batch of %u (%zu bytes): %.64s%s\n", batchCount, cmdLen, cmd, cmdLen > 64 ? "..." : "");
+    } else {
+        LogDebug("[Pipe] Received %zu bytes: %.64s%s\n", cmdLen, cmd, cmdLen > 64 ? "..." : "");
+    }
+
+    static thread_local char reply[PIPE_CMD_MAX];
+    bool executed = ExecuteOnMainThread(cmd, cmdLen, reply, sizeof(reply), batchCount);
+    const int64_t writeStart = PipeQpcNow();
+    bool wrote = PipeWrite(hPipe, ov, reply, (DWORD)strlen(reply));
+    PerfStageSince(PERF_STAGE_REPLY_WRITE, writeStart);
+    // SWFOC_DiagPipeStats: successful reply => completed, otherwise error.
+    if (executed && wrote) {
+        InterlockedIncrement(&g_pipeCompletedCount);
+    } else {
+        InterlockedIncrement(&g_pipeErrorCount);
+    }
+    return wrote;
+}
+
+static bool PipeReplyError(HANDLE hPipe, OVERLAPPED* ov, const char* resp) {
+    InterlockedIncrement(&g_pipeErrorCount);
+    return PipeWrite(hPipe, ov, resp, (DWORD)strlen(resp));
+}
+
+// Answers "@telemetry" from this thread -- no queue slot, no main-thread wait.
+static bool PipeServeTelemetry(HANDLE hPipe, OVERLAPPED* ov) {
+    InterlockedIncrement(&g_pipeReceivedCount);
+    PipeTelemetry t;
+    FillPipeTelemetry(&t);
+    bool wrote = PipeWrite(hPipe, ov, reinterpret_cast<const char*>(&t), (DWORD)sizeof(t));
+    InterlockedIncrement(wrote ? &g_pipeCompletedCount : &g_pipeErrorCount);
+    return wrote;
+}
 
-        Log("[Pipe] Client connected\n");
+// Takes the next frame from buf, reading more from the client as needed.
+// Returns false when the client hangs up, shutdown fires, or a frame
+// overflows the buffer (the client is told before returning).
+static bool PipeNextFrame(HANDLE hPipe, OVERLAPPED* ov, char* buf, size_t* len, bool nulOnly,
+                          char* frame, size_t frameCap, size_t* flen) {
+    while (!g_pipeShutdown) {
+        if (PipeTakeFrame(buf, len, nulOnly, frame, frameCap, flen)) return true;
+        if (*len >= PIPE_CMD_MAX - 1) {
+            PipeReplyError(hPipe, ov, "ERR: command exceeds PIPE_CMD_MAX\n");
+            return false;
+        }
+        // Only a read that completes a frame already started is timed; the
+        // wait for a client's next command is idle time, not latency.
+        DWORD got = 0;
+        const bool partial = *len > 0;
+        const int64_t readStart = PipeQpcNow();
+        if (!PipeRead(hPipe, ov, buf + *len, (DWORD)(PIPE_CMD_MAX - 1 - *len), &got)) return false;
+        if (partial) PerfStageSince(PERF_STAGE_PIPE_READ, readStart);
+        *len += got;
+    }
+    return false;
+}
 
-        // Read command in one blocking ReadFile call.
-        // The client sends the entire command + null terminator as a single write.
-        // ReadFile blocks until data arrives or the client disconnects.
-        char buf[PIPE_CMD_MAX];
-        DWORD totalRead = 0;
-        BOOL readOk = ReadFile(hPipe, buf, PIPE_CMD_MAX - 1, &totalRead, nullptr);
-        if (!readOk || totalRead == 0) {
+// Collects the `count` chunk frames that follow an "@batch N" directive,
+// packs them NUL-separated and runs them as one queue slot so they execute
+// in a single drain pass. Returns false if the session should end.
+static bool PipeServeBatch(HANDLE hPipe, OVERLAPPED* ov, char* buf, size_t* len, bool nulOnly,
+                           uint32_t count) {
+    static thread_local char packed[PIPE_CMD_MAX];
+    static thread_local char frame[PIPE_CMD_MAX];
+    size_t packedLen = 0;
+    bool fits = true;
+    for (uint32_t i = 0; i < count; i++) {
+        size_t flen = 0;
+        if (!PipeNextFrame(hPipe, ov, buf, len, nulOnly, frame, sizeof(frame), &flen)) return false;
+        if (packedLen + flen + 1 > sizeof(packed)) { fits = false; continue; }
+        memcpy(packed + packedLen, frame, flen + 1);  // keep the NUL separator
+        packedLen += flen + 1;
+    }
+    if (!fits) return PipeReplyError(hPipe, ov, "ERR: batch exceeds PIPE_CMD_MAX\n");
+    return PipeServeCommand(hPipe, ov, packed, packedLen, count);
+}
+
+// Services one connected client. The first read decides the dialect: a
+// plain chunk is a legacy one-shot command, "@batch N" a one-shot batch,
+// "@telemetry" a one-shot binary counter read and "@persist" keeps the connection open for framed commands (pipe_protocol.h).
+static void PipeServeClient(HANDLE hPipe, OVERLAPPED* ov) {
+    static thread_local char buf[PIPE_CMD_MAX];
+    static thread_local char frame[PIPE_CMD_MAX];
+    DWORD got = 0;
+    if (!PipeRead(hPipe, ov, buf, PIPE_CMD_MAX - 1, &got)) {
+        if (!g_pipeShutdown) {
             Log("[Pipe] Read failed or empty (client disconnected without sending)\n");
             InterlockedIncrement(&g_pipeErrorCount);
-            DisconnectNamedPipe(hPipe);
-            CloseHandle(hPipe);
-            continue;
         }
-        // SWFOC_DiagPipeStats: count every successful ReadFile as "received".
-        InterlockedIncrement(&g_pipeReceivedCount);
-        // Find null terminator in the received data
-        buf[totalRead] = '\0';  // safety null
-        size_t cmdLen = strnlen(buf, totalRead);
-
-        if (totalRead == 0) {
-            Log("[Pipe] Empty command, ignoring\n");
-            InterlockedIncrement(&g_pipeErrorCount);
-            const char* resp = "ERR: empty command\n";
-            DWORD written;
-            WriteFile(hPipe, resp, (DWORD)strlen(resp), &written, nullptr);
-            FlushFileBuffers(hPipe);
-            DisconnectNamedPipe(hPipe);
-            CloseHandle(hPipe);
-            continue;
+        return;
+    }
+    buf[got] = '\0';  // safety null
+
+    if (!PipeIsDirective(buf, got)) {
+        // Legacy one-shot: the whole write (up to the first NUL) is the command.
+        size_t cmdLen = strnlen(buf, got);
+        if (cmdLen == 0) {
+            PipeReplyError(hPipe, ov, "ERR: empty command\n");
+            return;
         }
+        PipeServeCommand(hPipe, ov, buf, cmdLen);
+        return;
+    }
 
-        Log("[Pipe] Received %lu bytes: %.64s%s\n", totalRead, buf, totalRead > 64 ? "..." : "");
+    // Opening directive. An unterminated one is taken as the whole write.
+    size_t len = got;
+    size_t flen = 0;
+    if (!PipeTakeFrame(buf, &len, false, frame, sizeof(frame), &flen)) {
+        flen = strnlen(buf, len);
+        memcpy(frame, buf, flen);
+        frame[flen] = '\0';
+        len = 0;
+    }
+    bool nulOnly = false;
+    uint32_t batchCount = 0;
+    if (PipeParseBatch(frame, flen, &batchCount, &nulOnly)) {
+        PipeServeBatch(hPipe, ov, buf, &len, nulOnly, batchCount);
+        return;
+    }
+    if (PipeIsTelemetry(frame, flen)) {
+        PipeServeTelemetry(hPipe, ov);
+        return;
+    }
+    if (!PipeParsePersist(frame, flen, &nulOnly)) {
+        PipeReplyError(hPipe, ov, "ERR: unknown directive\n");
+        return;
+    }
+    if (!PipeWrite(hPipe, ov, "OK\n", 3)) return;
+    Log("[Pipe] Persistent session (%s framing)\n", nulOnly ? "NUL" : "newline");
 
-        // Queue the command for main-thread execution via luaD_call hook.
-        // NEVER execute Lua from the pipe thread — race condition causes heap corruption.
-        EnterCriticalSection(&g_pipeLock);
-        if (g_pipeCmdPending) {
-            LeaveCriticalSection(&g_pipeLock);
-            InterlockedIncrement(&g_pipeErrorCount);
-            const char* resp = "ERR: queue full, try again\n";
-            DWORD written;
-            WriteFile(hPipe, resp, (DWORD)strlen(resp), &written, nullptr);
-            FlushFileBuffers(hPipe);
-            DisconnectNamedPipe(hPipe);
-            CloseHandle(hPipe);
+    while (PipeNextFrame(hPipe, ov, buf, &len, nulOnly, frame, sizeof(frame), &flen)) {
+        if (!PipeIsDirective(frame, flen)) {
+            if (!PipeServeCommand(hPipe, ov, frame, flen)) return;
             continue;
         }
-        memcpy(g_pipeCmd, buf, totalRead + 1);
-        g_pipeCmdPending = true;
-        g_pipeResultReady = false;
-        LeaveCriticalSection(&g_pipeLock);
-
-        // Wait for main thread (luaD_call hook) to execute and produce result
-        for (int wait = 0; wait < 10000; wait += 5) {
-            Sleep(5);
-            EnterCriticalSection(&g_pipeLock);
-            bool ready = g_pipeResultReady;
-            LeaveCriticalSection(&g_pipeLock);
-            if (ready) break;
+        bool batchNul = nulOnly;
+        if (PipeParseBatch(frame, flen, &batchCount, &batchNul)) {
+            if (!PipeServeBatch(hPipe, ov, buf, &len, batchNul, batchCount)) return;
+        } else if (PipeIsTelemetry(frame, flen)) {
+            if (!PipeServeTelemetry(hPipe, ov)) return;
+        } else if (!PipeReplyError(hPipe, ov, "ERR: unknown directive\n")) {
+            return;
         }
+    }
+}
 
-        EnterCriticalSection(&g_pipeLock);
-        const char* resp;
-        bool timedOut = false;
-        if (g_pipeResultReady) {
-            resp = g_pipeResult;
-        } else {
-            resp = "ERR: timeout (10s) - game may be paused or in menu\n";
-            g_pipeCmdPending = false;
-            timedOut = true;
-        }
-        DWORD written;
-        BOOL wrote = WriteFile(hPipe, resp, (DWORD)strlen(resp), &written, nullptr);
-        g_pipeResultReady = false;
-        LeaveCriticalSection(&g_pipeLock);
-        // SWFOC_DiagPipeStats: successful reply => completed, otherwise error.
-        if (timedOut || !wrote) {
+static DWORD WINAPI PipeInstanceThreadProc(LPVOID param) {
+    const int instance = (int)(intptr_t)param;
+    Log("[Pipe] Instance %d started, pipe=%s\n", instance, g_pipeName);
+
+    OVERLAPPED ov = {};
+    ov.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!ov.hEvent) {
+        Log("[Pipe] Instance %d: CreateEvent failed: %lu\n", instance, GetLastError());
+        InterlockedIncrement(&g_pipeErrorCount);
+        return 1;
+    }
+
+    while (!g_pipeShutdown) {
+        // Message-type pipe so a persistent client in PIPE_READMODE_MESSAGE
+        // receives exactly one reply per ReadFile; legacy clients open in
+        // byte mode and see no difference.
+        HANDLE hPipe = CreateNamedPipeA(
+            g_pipeName,
+            PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+            PIPE_TYPE_MESSAGE | PIPE_READMODE_BYTE | PIPE_WAIT,
+            PIPE_INSTANCE_COUNT,
+            PIPE_CMD_MAX, // out buffer
+            PIPE_CMD_MAX, // in buffer
+            1000,         // default timeout ms
+            nullptr);
+
+        if (hPipe == INVALID_HANDLE_VALUE) {
+            Log("[Pipe] Instance %d: CreateNamedPipe failed: %lu\n", instance, GetLastError());
             InterlockedIncrement(&g_pipeErrorCount);
-        } else {
-            InterlockedIncrement(&g_pipeCompletedCount);
+            WaitForSingleObject(g_pipeShutdownEvent, 1000);
+            continue;
         }
 
+        if (!PipeConnect(hPipe, &ov)) {
+            if (!g_pipeShutdown) InterlockedIncrement(&g_pipeErrorCount);
+            CloseHandle(hPipe);
+            continue;
+        }
+
+        Log("[Pipe] Client connected (instance %d)\n", instance);
+        PipeServeClient(hPipe, &ov);
+
         FlushFileBuffers(hPipe);
         DisconnectNamedPipe(hPipe);
         CloseHandle(hPipe);
-        Log("[Pipe] Client disconnected\n");
+        Log("[Pipe] Client disconnected (instance %d)\n", instance);
     }
 
-    Log("[Pipe] Listener thread exiting\n");
+    CloseHandle(ov.hEvent);
+    Log("[Pipe] Instance %d exiting\n", instance);
     return 0;
 }
 
-// Drain one pending pipe command on the calling thread's lua_State.
-// Returns true if a command was executed.
-static bool DrainPipeCommand(lua_State* L) {
-    EnterCriticalSection(&g_pipeLock);
-    if (!g_pipeCmdPending) {
-        LeaveCriticalSection(&g_pipeLock);
-        return false;
+// Starts executing a packed "@batch N" slot: N NUL-separated chunks, one
+// framed reply (pipe_protocol.h).
+static void PipeBatchCursorBegin(PipeBatchCursor* c, PipeCmdSlot* slot) {
+    c->slot  = slot;
+    c->next  = slot->cmd;
+    c->index = 0;
+    c->off   = PipeBatchBegin(slot->result, sizeof(slot->result), slot->batchCount);
+    LogDebug("[Pipe] Executing batch of %u\n", slot->batchCount);
+}
+
+// Runs batch chunks from the cursor until the batch is finished (returns
+// true) or the budget is spent after at least one chunk (returns false; call
+// again on a later tick to continue). Space for a short ERR entry is held
+// back for every chunk still to run, so an oversized result degrades to
+// "result truncated" instead of breaking the frame.
+static bool ExecutePipeBatchStep(lua_State* L, PipeBatchCursor* c, const PipeDrainBudget* budget) {
+    const size_t kEntryReserve = 32;
+    PipeCmdSlot* slot = c->slot;
+    const uint32_t count = slot->batchCount;
+    for (bool first = true; c->index < count; first = false) {
+        if (!first && PipeBudgetSpent(budget, PipeQpcNow())) return false;
+        const uint32_t i = c->index;
+        const size_t chunkLen = strlen(c->next);
+        CrashTrailCommand trail(CRASH_TRAIL_BATCH, c->next);
+        int savedTop = fn_gettop(L);
+        int err = DoString(L, c->next, "=pipe");
+        const char* text = fn_tostring(L, -1);
+        if (!text) text = (err == 0) ? "" : "unknown error";
+        const size_t room = sizeof(slot->result) - (count - i - 1) * kEntryReserve;
+        if (!PipeBatchAppend(slot->result, room, &c->off, err == 0, text, strlen(text))) {
+            static const char kTrunc[] = "result truncated";
+            PipeBatchAppend(slot->result, sizeof(slot->result), &c->off, false, kTrunc, sizeof(kTrunc) - 1);
+        }
+        if (err != 0) Log("[Pipe] Batch chunk %u error: %s\n", i, text);
+        fn_settop(L, savedTop);
+        c->next += chunkLen + 1;
+        c->index++;
     }
-    // Copy command out under lock
-    char cmd[PIPE_CMD_MAX];
-    memcpy(cmd, g_pipeCmd, PIPE_CMD_MAX);
-    LeaveCriticalSection(&g_pipeLock);
+    return true;
+}
 
-    Log("[Pipe] Executing: %.64s%s\n", cmd, strlen(cmd) > 64 ? "..." : "");
+// Execute one popped command slot on the calling thread's lua_State and
+// store the reply in the slot.
+static void ExecutePipeSlot(lua_State* L, PipeCmdSlot* slot) {
+    const char* cmd = slot->cmd;
+    LogDebug("[Pipe] Executing: %.64s%s\n", cmd, strlen(cmd) > 64 ? "..." : "");
+    CrashTrailCommand trail(CRASH_TRAIL_PIPE, cmd);
     int savedTop = fn_gettop(L);  // Stack guard (Fix #3)
     int err = DoString(L, cmd, "=pipe");
 
-    EnterCriticalSection(&g_pipeLock);
     if (err == 0) {
         // DoString now returns 1 value on success — capture it
         const char* retVal = fn_tostring(L, -1);
         if (retVal && retVal[0]) {
-            snprintf(g_pipeResult, sizeof(g_pipeResult), "%s\n", retVal);
+            snprintf(slot->result, sizeof(slot->result), "%s\n", retVal);
         } else {
-            strcpy(g_pipeResult, "OK\n");
+            strcpy(slot->result, "OK\n");
         }
-        Log("[Pipe] Execution OK: %.64s\n", g_pipeResult);
+        LogDebug("[Pipe] Execution OK: %.64s\n", slot->result);
     } else {
         const char* errMsg = fn_tostring(L, -1);
         if (!errMsg) errMsg = "unknown error";
-        snprintf(g_pipeResult, sizeof(g_pipeResult), "ERR: %s\n", errMsg);
+        snprintf(slot->result, sizeof(slot->result), "ERR: %s\n", errMsg);
         Log("[Pipe] Execution error: %s\n", errMsg);
     }
     fn_settop(L, savedTop);  // Restore stack regardless (Fix #3)
-    g_pipeResultReady = true;
-    g_pipeCmdPending = false;
-    LeaveCriticalSection(&g_pipeLock);
+}
+
+// Queued commands or a batch waiting to resume.
+static inline bool PipeHasPendingWork() {
+    return PipeQueueHasWork(&g_pipeQueue) || g_pipeBatchCursor.slot != nullptr;
+}
+
+static void EnsureFullRegistration(lua_State* L);  // with RegisterAll below
+
+// Drain up to PIPE_DRAIN_MAX_PER_CALL queued pipe commands on the calling
+// thread's lua_State, stopping early once g_pipeDrainBudgetUs is spent (at
+// least one command or batch chunk always runs). A batch that runs out of
+// budget parks in g_pipeBatchCursor and resumes first on the next pass.
+// Returns true if any work was done.
+static bool DrainPipeCommand(lua_State* L) {
+    // A drained command calling SWFOC_DrainPipe must not touch the parked
+    // batch its caller may be stepping; nested passes run unbudgeted with a
+    // local cursor, so their batches always finish inline.
+    const bool nested = ++g_pipeDrainDepth > 1;
+    PipeDrainBudget budget;
+    PipeBudgetBegin(&budget, PipeQpcNow(), g_qpcFreq.QuadPart, nested ? 0 : (uint32_t)g_pipeDrainBudgetUs);
+    PipeBatchCursor local = {};
+    PipeBatchCursor* cursor = nested ? &local : &g_pipeBatchCursor;
+    int executed = 0;
+    bool parked = false;
+    if (cursor->slot) {
+        executed++;
+        EnsureFullRegistration(L);
+        if (ExecutePipeBatchStep(L, cursor, &budget)) {
+            PipeQueueComplete(&g_pipeQueue, cursor->slot);
+            cursor->slot = nullptr;
+        } else {
+            parked = true;
+        }
+    }
+    while (!parked && executed < PIPE_DRAIN_MAX_PER_CALL) {
+        if (executed > 0 && PipeBudgetSpent(&budget, PipeQpcNow())) break;
+        PipeCmdSlot* slot = PipeQueuePop(&g_pipeQueue);
+        if (!slot) break;
+        if (slot->queuedAt) PerfStageSince(PERF_STAGE_QUEUE_WAIT, slot->queuedAt);
+        executed++;
+        EnsureFullRegistration(L);
+        if (slot->batchCount) {
+            PipeBatchCursorBegin(cursor, slot);
+            if (!ExecutePipeBatchStep(L, cursor, &budget)) {
+                parked = true;
+                break;
+            }
+            cursor->slot = nullptr;
+        } else {
+            ExecutePipeSlot(L, slot);
+        }
+        PipeQueueComplete(&g_pipeQueue, slot);
+    }
+    if (!nested && PipeHasPendingWork()) InterlockedIncrement(&g_pipeDeferredCount);
+    if (!nested && PendingJournalHasWork(&g_pendingJournal)) PendingJournalApply(&g_pendingJournal, &g_pendingState);
+    g_pipeDrainDepth--;
+    return executed > 0;
+}
+
+// ======================================================================
+// Memory validation
+// ======================================================================
+
+// 2026-10-14: CanReadMem replaces IsBadReadPtr on every pointer hop. It
+// answers from a per-thread VirtualQuery region cache (region_cache.h) that
+// is dropped whenever the luaD_call tick changes or REGION_CACHE_WINDOW_MS
+// passes, so a walk over thousands of units costs a binary search per hop
+// instead of a page probe. The crash handler keeps IsBadReadPtr: it must not
+// trust state cached before the fault.
+#define REGION_CACHE_WINDOW_MS 16
+
+static thread_local RegionCache t_regionCache;
+
+static bool QueryRegion(uint64_t addr, uint64_t* start, uint64_t* end, bool* readable) {
+    MEMORY_BASIC_INFORMATION mbi;
+    if (VirtualQuery(reinterpret_cast<LPCVOID>(addr), &mbi, sizeof(mbi)) != sizeof(mbi)) return false;
+    *start = (uint64_t)(uintptr_t)mbi.BaseAddress;
+    *end = *start + (uint64_t)mbi.RegionSize;
+    const DWORD kReadable = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY
+                          | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+    *readable = mbi.State == MEM_COMMIT && (mbi.Protect & kReadable)
+             && !(mbi.Protect & (PAGE_GUARD | PAGE_NOACCESS));
     return true;
 }
 
+// Epoch shared with the GameObj field memo (obj_memo.h).
+static uint64_t CurrentProbeEpoch() {
+    return ((uint64_t)g_luaDCallTickCounter << 32) ^ (GetTickCount64() / REGION_CACHE_WINDOW_MS);
+}
+
+static bool CanReadMem(uintptr_t addr, size_t len) {
+    if (addr == 0) return false;
+    return RegionCacheCanRead(&t_regionCache, CurrentProbeEpoch(), addr, len, QueryRegion);
+}
+
 // ======================================================================
 // Player helpers (read-only, safe)
 // ======================================================================
 
+// 2026-10-14: per-tick player table (player_table.h). The getters below
+// used to re-read the player array on every call; GetPlayerTable reads it
+// once per luaD_call tick (or PLAYER_TABLE_MAX_AGE_MS while paused drains
+// hold the tick still) and they answer from the table. Thread-local like
+// t_objMemo, because the death and damage detours ask for the local slot
+// too. Every helper that writes credits, tech or the local-player flag calls
+// InvalidatePlayerTable, so a read later in the same tick sees the write.
+#define PLAYER_TABLE_MAX_AGE_MS 100
+
+static int ReadCurrentHumanPlayerSlotRaw();
+static const UnitIndex* GetTacticalUnitIndex();
+static uint32_t g_unitIndexBuilds = 0;  // lets derived per-tick caches spot a rebuild
+
+struct PlayerTableCache {
+    PlayerTable table;
+    LONGLONG    tick;
+    ULONGLONG   ms;
+    uint32_t    gen;
+    uint32_t    unitBuilds;
+};
+static std::atomic<uint32_t> g_playerTableGen{1};
+static thread_local PlayerTableCache t_playerTable = {};
+
+static void InvalidatePlayerTable() {
+    g_playerTableGen.fetch_add(1, std::memory_order_release);
+}
+
+static const PlayerTable* GetPlayerTable() {
+    PlayerTableCache& c = t_playerTable;
+    const LONGLONG tick = g_luaDCallTickCounter;
+    const ULONGLONG now = GetTickCount64();
+    const uint32_t gen = g_playerTableGen.load(std::memory_order_acquire);
+    if (c.gen == gen && c.tick == tick && now - c.ms < PLAYER_TABLE_MAX_AGE_MS) return &c.table;
+
+    PlayerTable* t = &c.table;
+    PlayerTableReset(t, *reinterpret_cast<int*>(g_base + RVA::PlayerCount_Global));
+    const uintptr_t pa = *reinterpret_cast<uintptr_t*>(g_base + RVA::PlayerArray_Global);
+    for (int i = 0; pa && i < t->count; i++) {
+        const uintptr_t p = *reinterpret_cast<uintptr_t*>(pa + i * 8);
+        if (!p || !CanReadMem(p, RVA::PlayerObj::MaxTechLevel + 4)) continue;
+        PlayerRow& r = t->rows[i];
+        r.player  = (uint64_t)p;
+        r.faction = *reinterpret_cast<const char**>(p + RVA::PlayerObj::FactionName);
+        r.credits = *reinterpret_cast<float*>(p + RVA::PlayerObj::Credits);
+        r.tech    = *reinterpret_cast<int32_t*>(p + RVA::PlayerObj::TechLevel);
+        r.isHuman = *reinterpret_cast<uint8_t*>(p + RVA::PlayerObj::LocalPlayer) == 1 ? 1 : 0;
+    }
+    PlayerTableFinish(t);
+    t->humanSlot = ReadCurrentHumanPlayerSlotRaw();
+    c.tick = tick;
+    c.ms = now;
+    c.gen = gen;
+    c.unitBuilds = 0;
+    return t;
+}
+
+// The table plus units[] from the unit index. Main thread only, like
+// GetTacticalUnitIndex.
+static const PlayerTable* GetPlayerTableWithUnits() {
+    GetPlayerTable();
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    PlayerTableCache& c = t_playerTable;
+    if (!c.table.unitsValid || c.unitBuilds != g_unitIndexBuilds) {
+        for (int i = 0; i < c.table.count; i++) c.table.rows[i].units = UnitIndexOwnerCount(idx, i);
+        c.table.unitsValid = true;
+        c.unitBuilds = g_unitIndexBuilds;
+    }
+    return &c.table;
+}
+
 static uintptr_t GetPlayerObj(int slot) {
-    auto pa = *reinterpret_cast<uintptr_t*>(g_base + RVA::PlayerArray_Global);
-    if (!pa) return 0;
-    return *reinterpret_cast<uintptr_t*>(pa + slot * 8);
+    return (uintptr_t)PlayerTablePlayer(GetPlayerTable(), slot);
 }
 
 static int GetPlayerCount() {
-    return *reinterpret_cast<int*>(g_base + RVA::PlayerCount_Global);
+    return GetPlayerTable()->count;
 }
 
 static int FindLocalPlayerSlot() {
-    int count = GetPlayerCount();
-    for (int i = 0; i < count; i++) {
-        auto p = GetPlayerObj(i);
-        if (p && *reinterpret_cast<uint8_t*>(p + RVA::PlayerObj::LocalPlayer) == 1)
-            return i;
-    }
-    return -1;
+    return GetPlayerTable()->localSlot;
 }
 
 static const char* GetFactionName(int slot) {
-    auto p = GetPlayerObj(slot);
-    if (!p) return "?";
-    auto namePtr = *reinterpret_cast<const char**>(p + RVA::PlayerObj::FactionName);
-    return namePtr ? namePtr : "?";
+    return PlayerTableFaction(GetPlayerTable(), slot);
 }
 
 // ======================================================================
@@ -590,13 +1565,53 @@ static int Lua_GetVersion(lua_State* L) {
     return 1;
 }
 
-// SWFOC_GetBuildInfo() -> "<date> <time> | <version>"
+// 2026-10-14: startup readiness. LuaBridge_Init (on the loader thread)
+// runs only the critical phase and sets BRIDGE_INIT_CORE; the rest runs on
+// BridgeInitBackgroundProc. Each bit is set once its piece is live, so a
+// missing bit after BRIDGE_INIT_DONE means that piece failed (see the log).
+enum BridgeInitBits : LONG {
+    BRIDGE_INIT_CORE      = 0x01,  // Lua API, lua_open / lua_close / luaD_call, command shm
+    BRIDGE_INIT_CRASH_DIR = 0x02,  // crash_reports/ exists
+    BRIDGE_INIT_EVENT_SHM = 0x04,  // event buffer mapped
+    BRIDGE_INIT_COMBAT    = 0x08,  // Take_Damage_Outer, DeathHandler, WeaponTick
+    BRIDGE_INIT_ECONOMY   = 0x10,  // AddCredits
+    BRIDGE_INIT_VICTORY   = 0x20,  // VictoryMonitor trampoline (dormant)
+    BRIDGE_INIT_PIPE      = 0x40,  // at least one pipe instance listening
+    BRIDGE_INIT_DONE      = 0x80,  // background phase finished
+};
+static volatile LONG g_initReady = 0;
+static volatile LONG g_initCoreUs = 0;        // critical phase, loader thread
+static volatile LONG g_initBackgroundUs = 0;  // background phase
+
+// SWFOC_GetBuildInfo() -> "<date> <time> | <version> | init=<phases> core_us=N background_us=M"
 // Uses compile-time __DATE__ / __TIME__ so every rebuild produces a distinct
 // string. Paired with SWFOC_GetVersion() to give two independent proofs of
 // which DLL the game actually loaded. If a live test sees a stale __DATE__
 // here, the new DLL was not loaded regardless of what the version string says.
+// <phases> lists the BridgeInitBits that are set, '+'-joined, with
+// "pending" while the background phase still runs.
 static int Lua_GetBuildInfo(lua_State* L) {
-    fn_pushstring(L, __DATE__ " " __TIME__ " | " SWFOC_BRIDGE_VERSION);
+    static const struct { LONG bit; const char* name; } kPhases[] = {
+        {BRIDGE_INIT_CORE, "core"},       {BRIDGE_INIT_CRASH_DIR, "crash_dir"},
+        {BRIDGE_INIT_EVENT_SHM, "event_shm"}, {BRIDGE_INIT_COMBAT, "combat"},
+        {BRIDGE_INIT_ECONOMY, "economy"}, {BRIDGE_INIT_VICTORY, "victory"},
+        {BRIDGE_INIT_PIPE, "pipe"},
+    };
+    const LONG ready = g_initReady;
+    char phases[128];
+    size_t off = 0;
+    phases[0] = '\0';
+    for (const auto& p : kPhases) {
+        if (!(ready & p.bit)) continue;
+        int n = snprintf(phases + off, sizeof(phases) - off, "%s%s", off ? "+" : "", p.name);
+        if (n > 0 && (size_t)n < sizeof(phases) - off) off += (size_t)n;
+    }
+    if (!(ready & BRIDGE_INIT_DONE)) snprintf(phases + off, sizeof(phases) - off, "%spending", off ? "+" : "");
+    char out[384];
+    snprintf(out, sizeof(out), "%s | init=%s core_us=%ld background_us=%ld",
+             __DATE__ " " __TIME__ " | " SWFOC_BRIDGE_VERSION, phases[0] ? phases : "none",
+             (long)g_initCoreUs, (long)g_initBackgroundUs);
+    fn_pushstring(L, out);
     return 1;
 }
 
@@ -704,6 +1719,7 @@ static int Lua_SetHumanPlayer_v2(lua_State* L) {
     // increment+wrap; we do it via a direct assignment since we already
     // validated the target bounds.
     *currentSlotPtr = target;
+    InvalidatePlayerTable();
 
     // Subsystem refresh: notify camera/HUD/selection/input router of the
     // new local player. Uses the same path as the engine's own
@@ -819,14 +1835,14 @@ static int Lua_SetHumanPlayer_v3(lua_State* L) {
     uintptr_t newAiBefore = 0;
     if (oldSlot >= 0 && oldSlot < playerCount) {
         auto oldPlayer = *reinterpret_cast<uintptr_t*>(pa + 8 * oldSlot);
-        if (oldPlayer && !IsBadReadPtr(reinterpret_cast<void*>(oldPlayer + kAiPlayerOffset), 8)) {
+        if (oldPlayer && CanReadMem(oldPlayer + kAiPlayerOffset, 8)) {
             oldAiPtr = reinterpret_cast<uintptr_t*>(oldPlayer + kAiPlayerOffset);
             oldAiBefore = *oldAiPtr;
         }
     }
     {
         auto newPlayer = *reinterpret_cast<uintptr_t*>(pa + 8 * target);
-        if (newPlayer && !IsBadReadPtr(reinterpret_cast<void*>(newPlayer + kAiPlayerOffset), 8)) {
+        if (newPlayer && CanReadMem(newPlayer + kAiPlayerOffset, 8)) {
             newAiPtr = reinterpret_cast<uintptr_t*>(newPlayer + kAiPlayerOffset);
             newAiBefore = *newAiPtr;
         }
@@ -842,6 +1858,7 @@ static int Lua_SetHumanPlayer_v3(lua_State* L) {
         *reinterpret_cast<uint8_t*>(player + RVA::PlayerObj::LocalPlayer) = value;
     }
     *currentSlotPtr = target;
+    InvalidatePlayerTable();
 
     // === Phase 2: AI brain pointer swap (NEW in v3) ===
     if (oldAiPtr && newAiPtr) {
@@ -906,7 +1923,7 @@ static int Lua_GetAiBrain(lua_State* L) {
         return 1;
     }
     static const uintptr_t kAiPlayerOffset = 0x360;
-    if (IsBadReadPtr(reinterpret_cast<void*>(player + kAiPlayerOffset), 8)) {
+    if (!CanReadMem(player + kAiPlayerOffset, 8)) {
         fn_pushstring(L, "ERR: SWFOC_GetAiBrain: +0x360 unreadable");
         return 1;
     }
@@ -1057,6 +2074,7 @@ static int Lua_SetCredits(lua_State* L) {
     double amount = fn_tonumber(L, 1);
     auto p = GetPlayerObj(slot);
     *reinterpret_cast<float*>(p + RVA::PlayerObj::Credits) = static_cast<float>(amount);
+    InvalidatePlayerTable();
     Log("[Bridge] Credits set to %.0f\n", amount);
     fn_pushnumber(L, 1);
     return 1;
@@ -1064,11 +2082,10 @@ static int Lua_SetCredits(lua_State* L) {
 
 // SWFOC_GetCredits() -> number
 static int Lua_GetCredits(lua_State* L) {
-    int slot = FindLocalPlayerSlot();
-    if (slot < 0) { fn_pushnumber(L, 0); return 1; }
-    auto p = GetPlayerObj(slot);
-    float c = *reinterpret_cast<float*>(p + RVA::PlayerObj::Credits);
-    fn_pushnumber(L, static_cast<double>(c));
+    const PlayerTable* t = GetPlayerTable();
+    const PlayerRow* r = PlayerTableRow(t, t->localSlot);
+    if (!r) { fn_pushnumber(L, 0); return 1; }
+    fn_pushnumber(L, static_cast<double>(r->credits));
     return 1;
 }
 
@@ -1079,6 +2096,7 @@ static int Lua_SetTechLevel(lua_State* L) {
     int level = static_cast<int>(fn_tonumber(L, 1));
     auto p = GetPlayerObj(slot);
     *reinterpret_cast<int*>(p + RVA::PlayerObj::TechLevel) = level;
+    InvalidatePlayerTable();
     Log("[Bridge] Tech level set to %d\n", level);
     fn_pushnumber(L, 1);
     return 1;
@@ -1115,15 +2133,15 @@ static int Lua_HeroInstantRespawn(lua_State* L) {
 
 // SWFOC_ListFactions() -> table of {slot, name, credits, is_local}
 static int Lua_ListFactions(lua_State* L) {
-    int count = GetPlayerCount();
+    const PlayerTable* t = GetPlayerTable();
     fn_newtable(L); // result table
 
     int idx = 1;
-    for (int i = 0; i < count; i++) {
-        auto p = GetPlayerObj(i);
-        if (!p) continue;
-        auto isLocal = *reinterpret_cast<uint8_t*>(p + RVA::PlayerObj::LocalPlayer) == 1;
-        auto credits = *reinterpret_cast<float*>(p + RVA::PlayerObj::Credits);
+    for (int i = 0; i < t->count; i++) {
+        const PlayerRow* r = PlayerTableRow(t, i);
+        if (!r) continue;
+        auto isLocal = r->isHuman != 0;
+        auto credits = r->credits;
 
         fn_newtable(L); // entry table
 
@@ -1132,7 +2150,7 @@ static int Lua_ListFactions(lua_State* L) {
         fn_settable(L, -3);
 
         fn_pushstring(L, "name");
-        fn_pushstring(L, GetFactionName(i));
+        fn_pushstring(L, PlayerTableFaction(t, i));
         fn_settable(L, -3);
 
         fn_pushstring(L, "credits");
@@ -1175,7 +2193,7 @@ static int Lua_DoString(lua_State* L) {
         fn_pushstring(L, "SWFOC_DoString: expected string argument");
         return 2;
     }
-    Log("[DoString] Executing: %.64s%s\n", code, strlen(code) > 64 ? "..." : "");
+    LogDebug("[DoString] Executing: %.64s%s\n", code, strlen(code) > 64 ? "..." : "");
     int topBefore = fn_gettop(L);
     int err = DoString(L, code, "=SWFOC_DoString");
     if (err == 0) {
@@ -1211,11 +2229,11 @@ static int Lua_DrainPipe(lua_State* L) {
 // SWFOC_StateInfo() -> string describing cached game states
 static int SWFOC_StateInfo(lua_State* L) {
     EnterCriticalSection(&csGameStates);
-    int count = (int)cached_game_states.size();
+    int count = (int)cached_game_states.states.size();
     std::string info = "Game states: " + std::to_string(count) + "\n";
     for (int i = 0; i < count; i++) {
         char buf[64];
-        snprintf(buf, sizeof(buf), "  [%d] %p\n", i, cached_game_states[i]);
+        snprintf(buf, sizeof(buf), "  [%d] %p\n", i, cached_game_states.states[i]);
         info += buf;
     }
     LeaveCriticalSection(&csGameStates);
@@ -1223,46 +2241,91 @@ static int SWFOC_StateInfo(lua_State* L) {
     return 1;
 }
 
+// SWFOC_Unit handle table (see Lua_Unit); lua_close forgets its bindings.
+static UnitHandleTable g_unitHandles;
+
+// BatchTypeExists answer cache (see Lua_BatchTypeExists)
+static TypeCache g_typeCache;
+static volatile LONG g_typeCacheGen = 0;
+
+static void InvalidateTypeCache() {
+    InterlockedIncrement(&g_typeCacheGen);
+}
+
+// Called with every SWFOC_GetCurrentMod answer; a different mod than last
+// time means the type catalog may have changed too.
+static void NoteCurrentModForTypeCache(const char* modName) {
+    static uint64_t s_lastModHash = 0;
+    const uint64_t h = TypeCacheHash(modName, strlen(modName));
+    if (s_lastModHash && h != s_lastModHash) InvalidateTypeCache();
+    s_lastModHash = h;
+}
+
+static TypeCacheKey CurrentTypeCacheKey(lua_State* L) {
+    TypeCacheKey key = {};
+    key.state = (uint64_t)(uintptr_t)L;
+    const uintptr_t slot = g_base + RVA::GameModeRoot_Global;
+    if (g_base && CanReadMem(slot, 8)) key.mode = *reinterpret_cast<uint64_t*>(slot);
+    key.gen = (uint32_t)g_typeCacheGen;
+    return key;
+}
+
 // ======================================================================
 // lua_close hook — evict destroyed states from the game state cache
 // ======================================================================
 
 void Hook_lua_close(void* L) {
+    InvalidateTypeCache();
+    UnitHandleDropState(&g_unitHandles, (uint64_t)(uintptr_t)L);
     EnterCriticalSection(&csGameStates);
-    auto it = std::find(cached_game_states.begin(), cached_game_states.end(), L);
-    if (it != cached_game_states.end()) {
-        cached_game_states.erase(it);
-        Log("Removed game state: %p (remaining: %d)\n", L, (int)cached_game_states.size());
-    }
+    if (StateRegistryErase(&cached_game_states, L))
+        Log("Removed game state: %p (remaining: %d)\n", L, (int)cached_game_states.states.size());
     LeaveCriticalSection(&csGameStates);
 
     // Also remove from registered states
     EnterCriticalSection(&csRegistered);
-    auto it2 = std::find(registered_states.begin(), registered_states.end(), L);
-    if (it2 != registered_states.end()) {
-        registered_states.erase(it2);
-        Log("Removed registered state: %p (remaining: %d)\n", L, (int)registered_states.size());
+    if (StateRegistryErase(&registered_states, L)) {
+        StateSetErase(&g_fullRegisteredSet, L);
+        Log("Removed registered state: %p (remaining: %d)\n", L, (int)registered_states.states.size());
     }
     LeaveCriticalSection(&csRegistered);
 
     orig_lua_close(L);
 }
 
-// SWFOC_EventControl(enable) -> 1 on success, 0 if no event buffer
-// enable=1: reset ring buffer and enable event stream
+// SWFOC_EventControl(enable [, "compact"]) -> 1 on success, 0 if no event buffer
+// enable=1: discard unread events, clear counters, enable event stream
 // enable=0: disable event stream
+// 2026-10-14: "compact" also sets SHMEM_EVT_FLAG_COMPACT: the stream starts
+// with EVT_STREAM_INFO and HP changes arrive as EVT_HP_BATCH.
 static int Lua_EventControl(lua_State* L) {
     if (!g_evtBuf) { fn_pushnumber(L, 0); return 1; }
     int enable = static_cast<int>(fn_tonumber(L, 1));
+    const bool compact = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TSTRING
+        && fn_tostring(L, 2) && strcmp(fn_tostring(L, 2), "compact") == 0;
+    FlushCompactEvents(0);  // nothing staged may outlive the stream it belongs to
     if (enable) {
-        g_evtBuf->write_pos.store(0, std::memory_order_release);
-        g_evtBuf->read_pos.store(0, std::memory_order_release);
-        g_evtBuf->event_count.store(0, std::memory_order_release);
-        g_evtBuf->flags.store(1, std::memory_order_release);
-        Log("[Events] Stream enabled\n");
+        // Hooks may be mid-write on other threads, so discard the backlog
+        // instead of rewinding the cursors under them.
+        g_evtBuf->flags.store(0, std::memory_order_release);
+        ShmEvtDiscard(g_evtBuf);
+        if (compact) {
+            EvtSessionReset(&g_evtCompact.sessions);
+            g_evtCompact.baseMs = CaptureTimestampMs();
+            EvtStreamInfo info;
+            info.encoding = EVT_COMPACT_ENCODING;
+            info.base_ms = g_evtCompact.baseMs;
+            ShmEvtWrite(g_evtBuf, EVT_STREAM_INFO, &info, sizeof(info));
+        }
+        g_evtBuf->flags.store(compact ? 1 | SHMEM_EVT_FLAG_COMPACT : 1, std::memory_order_release);
+        Log("[Events] Stream enabled%s\n", compact ? " (compact)" : "");
     } else {
         g_evtBuf->flags.store(0, std::memory_order_release);
-        Log("[Events] Stream disabled\n");
+        Log("[Events] Stream disabled (%u dropped, %u compact events in %u batches, %u lost)\n",
+            g_evtBuf->dropped.load(std::memory_order_relaxed),
+            g_evtCompact.written.load(std::memory_order_relaxed),
+            g_evtCompact.records.load(std::memory_order_relaxed),
+            g_evtCompact.lost.load(std::memory_order_relaxed));
     }
     fn_pushnumber(L, 1);
     return 1;
@@ -1332,61 +2395,29 @@ static const char* const kDumpGlobals[] = {
 static const uint32_t kDumpGlobalsCount =
     sizeof(kDumpGlobals) / sizeof(kDumpGlobals[0]);
 
-// Buffered write helper: appends bytes to a growing std::vector<uint8_t> and
-// updates a running CRC32 checksum. All section writes go through here so
-// the final CRC covers every byte before the end marker.
-struct DumpBuf {
-    std::vector<uint8_t> bytes;
-    uint32_t crc;
-
-    DumpBuf() : crc(0) {}
-
-    void append(const void* p, size_t n) {
-        const uint8_t* b = static_cast<const uint8_t*>(p);
-        bytes.insert(bytes.end(), b, b + n);
-    }
-    void u8(uint8_t v)   { append(&v, 1); }
-    void u16(uint16_t v) { append(&v, 2); }
-    void u32(uint32_t v) { append(&v, 4); }
-    void u64(uint64_t v) { append(&v, 8); }
-    void f64(double v)   { append(&v, 8); }
-
-    // Write a null-padded fixed-width ASCII field
-    void fixedStr(const char* s, size_t width) {
-        std::vector<uint8_t> tmp(width, 0);
-        if (s) {
-            size_t n = strnlen(s, width);
-            memcpy(tmp.data(), s, n);
-        }
-        append(tmp.data(), width);
-    }
-};
-
 // Safely read a pointer from an absolute engine address. Returns 0 on failure.
-// Uses IsBadReadPtr for defensive bounds checking before the actual read.
-// NOTE: IsBadReadPtr is deprecated on modern Windows but MinGW's MinHook-based
-// build targets it intentionally because there is no SEH available.
+// Uses CanReadMem for defensive bounds checking before the actual read.
 static uint64_t SafeReadU64(uintptr_t addr) {
     if (addr == 0) return 0;
-    if (IsBadReadPtr(reinterpret_cast<void*>(addr), 8)) return 0;
+    if (!CanReadMem(addr, 8)) return 0;
     return *reinterpret_cast<uint64_t*>(addr);
 }
 static uint32_t SafeReadU32(uintptr_t addr) {
     if (addr == 0) return 0;
-    if (IsBadReadPtr(reinterpret_cast<void*>(addr), 4)) return 0;
+    if (!CanReadMem(addr, 4)) return 0;
     return *reinterpret_cast<uint32_t*>(addr);
 }
 static float SafeReadF32(uintptr_t addr) {
     if (addr == 0) return 0.0f;
-    if (IsBadReadPtr(reinterpret_cast<void*>(addr), 4)) return 0.0f;
+    if (!CanReadMem(addr, 4)) return 0.0f;
     return *reinterpret_cast<float*>(addr);
 }
 static const char* SafeReadCStr(uintptr_t addr) {
     if (addr == 0) return nullptr;
-    if (IsBadReadPtr(reinterpret_cast<void*>(addr), 8)) return nullptr;
+    if (!CanReadMem(addr, 8)) return nullptr;
     const char* p = *reinterpret_cast<const char**>(addr);
     if (!p) return nullptr;
-    if (IsBadReadPtr((void*)p, 1)) return nullptr;
+    if (!CanReadMem((uintptr_t)p, 1)) return nullptr;
     return p;
 }
 
@@ -1400,11 +2431,11 @@ static uint64_t CaptureTimestampMs() {
     return (ft100ns / 10000ULL) - kEpochDeltaMs;
 }
 
-// Look up a whitelisted global, write one section-4 record to buf.
+// Look up a whitelisted global, write one section-4 record to w.
 // Stack is saved/restored around the lookup so we never leave residue
 // behind for the calling Lua context.
-static void WriteGlobalRecord(lua_State* L, DumpBuf& buf, const char* name) {
-    buf.fixedStr(name, 64);
+static void WriteGlobalRecord(lua_State* L, SnapWriter* w, const char* name) {
+    SnapFixedStr(w, name, 64);
 
     int savedTop = fn_gettop(L);
     fn_pushstring(L, name);
@@ -1430,10 +2461,9 @@ static void WriteGlobalRecord(lua_State* L, DumpBuf& buf, const char* name) {
     fn_settop(L, savedTop);
 
     // lua_type encoded as uint8 + 7 bytes of zero padding
-    buf.u8(static_cast<uint8_t>(ty & 0xFF));
-    uint8_t pad[7] = {0};
-    buf.append(pad, 7);
-    buf.u64(raw);
+    SnapU8(w, static_cast<uint8_t>(ty & 0xFF));
+    SnapZeros(w, 7);
+    SnapU64(w, raw);
 }
 
 // Count live instances of a given object type.
@@ -1450,6 +2480,10 @@ static void WriteGlobalRecord(lua_State* L, DumpBuf& buf, const char* name) {
 // SAFETY: no unbounded loops, every gettable/pcall goes through
 // fn_settop stack restore on failure. If any required fn_* is unresolved,
 // returns 0 immediately so the section payload still has the expected shape.
+//
+// 2026-10-14: only the fallback now. CaptureSnapshot takes exact counts
+// from the native type census (GetTypeCensus) whenever the mode object
+// list is live, and calls this only when it is not.
 static uint32_t QueryObjectTypeCount(lua_State* L, const char* typeName) {
     if (!fn_pushstring || !fn_gettable || !fn_pcall || !fn_type ||
         !fn_gettop || !fn_settop || !fn_tonumber) {
@@ -1472,10 +2506,9 @@ static uint32_t QueryObjectTypeCount(lua_State* L, const char* typeName) {
     int resultTy = fn_type(L, -1);
     uint32_t count = 0;
     if (resultTy == LUA_TTABLE) {
-        // Present sentinel. Exact counting via table.getn requires
-        // lua_pushvalue, which we do not resolve. v1 consumers only care
-        // that the type is present; they ignore the numeric value when it
-        // comes from a table branch.
+        // Present sentinel. Exact counts come from the type census; v1
+        // consumers only care that the type is present and ignore the
+        // numeric value when it comes from a table branch.
         count = 1;
     } else if (resultTy == LUA_TNUMBER) {
         count = static_cast<uint32_t>(fn_tonumber(L, -1));
@@ -1503,6 +2536,14 @@ static uint32_t QueryObjectTypeCount(lua_State* L, const char* typeName) {
 // kMaxInputBytes. Names individually capped at kMaxNameBytes. If either
 // cap is hit we return "ERR: SWFOC_BatchTypeExists: input too large" so
 // the editor can fall back to per-name probes.
+//
+// 2026-10-14: answers are remembered in g_typeCache (type_cache.h) for the
+// probing state and the live GameModeClass, so a repeat probe of the same
+// catalog makes no pcall at all. g_typeCacheGen is bumped by lua_open,
+// lua_close and a changed SWFOC_GetCurrentMod answer. An optional arg 2 of
+// "bitmap" replies "bitmap n=N <hex>" instead: bit i (LSB first within
+// each byte) is name i, two hex digits per byte -- 128 characters for a
+// full 512-name batch instead of 1023.
 static int Lua_BatchTypeExists(lua_State* L) {
     constexpr size_t kMaxInputBytes = 16384;  // 16 KB of names per probe
     constexpr size_t kMaxNameBytes  = 256;    // per-entry safety cap
@@ -1572,20 +2613,36 @@ static int Lua_BatchTypeExists(lua_State* L) {
         ++cursor;
     }
 
+    const bool bitmap = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TSTRING &&
+                        fn_tostring(L, 2) && strcmp(fn_tostring(L, 2), "bitmap") == 0;
     if (nameCount == 0) {
-        fn_pushstring(L, "");
+        fn_pushstring(L, bitmap ? "bitmap n=0 " : "");
         return 1;
     }
 
+    TypeCacheBind(&g_typeCache, CurrentTypeCacheKey(L));
+
     // Per-name probe: push Find_Object_Type, push name, pcall, check
     // truthiness of the single return.
     static thread_local char s_out[kMaxNames * 2 + 1]; // "1|1|0|..." worst case
+    static thread_local uint8_t s_bits[(kMaxNames + 7) / 8];
+    memset(s_bits, 0, sizeof(s_bits));
     size_t off = 0;
+    size_t cached = 0;
     for (size_t i = 0; i < nameCount; ++i) {
         if (i > 0 && off < sizeof(s_out) - 1) {
             s_out[off++] = '|';
         }
 
+        const size_t nameLen = strlen(s_names[i]);
+        const int known = nameLen ? TypeCacheLookup(&g_typeCache, s_names[i], nameLen) : 0;
+        if (known >= 0) {
+            if (known) s_bits[i >> 3] |= (uint8_t)(1u << (i & 7));
+            if (off < sizeof(s_out) - 1) s_out[off++] = known ? '1' : '0';
+            cached++;
+            continue;
+        }
+
         int top = fn_gettop(L);
         fn_pushstring(L, "Find_Object_Type");
         fn_gettable(L, LUA_GLOBALSINDEX);
@@ -1606,50 +2663,54 @@ static int Lua_BatchTypeExists(lua_State* L) {
             if (rty != LUA_TNIL) {
                 flag = '1';
             }
+            TypeCacheStore(&g_typeCache, s_names[i], nameLen, flag == '1');
         }
         fn_settop(L, top);
 
+        if (flag == '1') s_bits[i >> 3] |= (uint8_t)(1u << (i & 7));
         if (off < sizeof(s_out) - 1) {
             s_out[off++] = flag;
         }
     }
     s_out[off] = '\0';
+    if (bitmap) {
+        static const char kHex[] = "0123456789abcdef";
+        off = (size_t)snprintf(s_out, sizeof(s_out), "bitmap n=%zu ", nameCount);
+        for (size_t b = 0; b < (nameCount + 7) / 8 && off + 2 < sizeof(s_out); b++) {
+            s_out[off++] = kHex[s_bits[b] >> 4];
+            s_out[off++] = kHex[s_bits[b] & 0xF];
+        }
+        s_out[off] = '\0';
+    }
     fn_pushstring(L, s_out);
-    Log("[Bridge] BatchTypeExists: probed=%zu out_len=%zu\n", nameCount, off);
+    Log("[Bridge] BatchTypeExists: probed=%zu cached=%zu out_len=%zu\n", nameCount, cached, off);
     return 1;
 }
 
 // Metadata writer: length-prefixed key then length-prefixed value
-static void WriteMetaPair(DumpBuf& buf, const char* key, const char* value) {
+static void WriteMetaPair(SnapWriter* w, const char* key, const char* value) {
     size_t kl = key ? strnlen(key, 0xFFFE) : 0;
     size_t vl = value ? strnlen(value, 0xFFFE) : 0;
-    buf.u16(static_cast<uint16_t>(kl));
-    buf.append(key, kl);
-    buf.u16(static_cast<uint16_t>(vl));
-    buf.append(value, vl);
+    SnapU16(w, static_cast<uint16_t>(kl));
+    SnapPut(w, key, kl);
+    SnapU16(w, static_cast<uint16_t>(vl));
+    SnapPut(w, value, vl);
 }
 
-// Forward declarations for the 2026-04-23 sections 11-13 writer. The real
+// Forward declarations for the 2026-04-23 sections 11-14 writer. The real
 // definitions live below (Phase 3.2 / selection reader), so we need these
 // prototypes here because Lua_DumpState precedes them in file order.
 static bool IsValidObjAddr(uintptr_t addr);
 static bool ResolveSelectionVector(uintptr_t& outVec);
 static int  WalkSelectionVector(uintptr_t vec, uintptr_t* outObjs, int maxOut);
-
-static int Lua_DumpState(lua_State* L) {
-    const char* path = fn_tostring(L, 1);
-    if (!path || !path[0]) {
-        fn_pushstring(L, "ERR: SWFOC_DumpState: expected string path argument");
-        return 1;
-    }
-
-    Log("[Dump] SWFOC_DumpState called, path=%s\n", path);
-
-    // ---- Build the whole snapshot in memory first, then write in one go.
-    // This keeps partial-write failure windows small and lets us CRC over
-    // the exact bytes we are about to flush.
-    DumpBuf buf;
-
+static const SelectionTracker* GetSelection();
+static const TypeCensus* GetTypeCensus();
+static bool ReadUnitWorldBounds(uintptr_t obj, float* pos, float* halfExtent);
+
+// Capture pass: reads engine memory and stores the header and every section
+// into w. Runs on the game's main thread; the writer's I/O thread does the
+// rest (SnapWriterFinish, or SnapWriterClose for SWFOC_DumpStateAsync).
+static void CaptureSnapshot(lua_State* L, SnapWriter* w) {
     // ---- File header (68 bytes) ----
     // See SNAPSHOT_FORMAT.md for the full layout. Section 1 begins at
     // file offset 0x44.
@@ -1657,17 +2718,22 @@ static int Lua_DumpState(lua_State* L) {
     // explicit local_slot in section 1. v1 reader retained in
     // replay_harness.cpp for back-compat with snapshots captured before
     // this change.
+    // A compressing writer stamps v3 (same layout, sections may carry
+    // SNAP_SECTION_LZ4), a delta writer v4 (section 0 names the base); the
+    // staged bytes are otherwise identical.
+    const uint32_t version = w->base ? 4 : w->lz4 ? 3 : 2;
     const uint8_t kMagic[16] = {
-        'S','W','F','O','C','S','N','A','P','v','2',0,0,0,0,0
+        'S','W','F','O','C','S','N','A','P','v', static_cast<uint8_t>('0' + version),
+        0,0,0,0,0
     };
-    buf.append(kMagic, 16);
-    // 0x10: format_version = 2 (was 1 prior to 2026-04-08)
-    buf.u32(2);
+    SnapPut(w, kMagic, 16);
+    // 0x10: format_version = 2, 3 when compressed, 4 for a delta (was 1
+    // prior to 2026-04-08)
+    SnapU32(w, version);
     // 0x14: capture_timestamp_ms
-    buf.u64(CaptureTimestampMs());
+    SnapU64(w, CaptureTimestampMs());
     // 0x1C: engine_build_hash = 32 bytes zero (SHA-256 computation deferred)
-    uint8_t zeroHash[32] = {0};
-    buf.append(zeroHash, 32);
+    SnapZeros(w, 32);
     // 0x3C: game_mode — probed from the GameModeRoot chain (Task 108, 2026-04-23).
     //   0 = menu / no active mode
     //   1 = tactical (object list populated)
@@ -1686,28 +2752,27 @@ static int Lua_DumpState(lua_State* L) {
     // they fail together, which is the right coupling.
     uint8_t gameMode = 0;
     uintptr_t rootAddr = g_base + RVA::GameModeRoot_Global;
-    if (!IsBadReadPtr(reinterpret_cast<void*>(rootAddr), 8)) {
+    if (CanReadMem(rootAddr, 8)) {
         uintptr_t rootPtr = SafeReadU64(rootAddr);
-        if (rootPtr && !IsBadReadPtr(
-                reinterpret_cast<void*>(rootPtr + RVA::Selection::kModeRootIndirection), 8)) {
+        if (rootPtr && CanReadMem(rootPtr + RVA::Selection::kModeRootIndirection, 8)) {
             uintptr_t innerPtr = SafeReadU64(
                 rootPtr + RVA::Selection::kModeRootIndirection);
-            if (innerPtr && !IsBadReadPtr(reinterpret_cast<void*>(innerPtr), 0x80)) {
+            if (innerPtr && CanReadMem(innerPtr, 0x80)) {
                 uintptr_t sentinel = innerPtr + RVA::Selection::kObjectListSentinel;
                 uintptr_t head = SafeReadU64(innerPtr + RVA::Selection::kObjectListHead);
                 gameMode = (head && head != sentinel) ? 1 : 2;
             }
         }
     }
-    buf.u8(gameMode);
+    SnapU8(w, gameMode);
     // 0x3D: 7 bytes reserved padding
-    uint8_t headerPad[7] = {0};
-    buf.append(headerPad, 7);
+    SnapZeros(w, 7);
 
     // ---- Section 1: player_array ----
+    if (w->base) SnapWriteDeltaBase(w);
+
     {
-        std::vector<uint8_t> payload;
-        DumpBuf sec;
+        SnapBeginSection(w, 1);
 
         // Read and bound player count
         uintptr_t pcAddr = g_base + RVA::PlayerCount_Global;
@@ -1719,98 +2784,92 @@ static int Lua_DumpState(lua_State* L) {
         uintptr_t arrBase = SafeReadU64(g_base + RVA::PlayerArray_Global);
         // If the array pointer looks invalid, fall back to count=0.
         uint32_t actual = 0;
-        sec.u32(0); // placeholder for player_count, rewritten below
+        const size_t countOff = SnapOffset(w);
+        SnapU32(w, 0); // placeholder for player_count, rewritten below
 
         // v2 addition: explicit local_slot. Resolve via FindLocalPlayerSlot.
         // The reader treats UINT32_MAX as "no local player" (e.g. main menu).
         int localSlotInt = FindLocalPlayerSlot();
         uint32_t localSlot = (localSlotInt < 0) ? 0xFFFFFFFFu : static_cast<uint32_t>(localSlotInt);
-        sec.u32(localSlot);
+        SnapU32(w, localSlot);
 
         for (uint32_t i = 0; i < clamped; i++) {
             uint64_t pPtr = arrBase ? SafeReadU64(arrBase + i * 8) : 0;
             if (!pPtr) continue;
             // slot
-            sec.u32(i);
+            SnapU32(w, i);
             // faction (null-padded 64)
             const char* faction = SafeReadCStr(pPtr + RVA::PlayerObj::FactionName);
-            sec.fixedStr(faction ? faction : "", 64);
+            SnapFixedStr(w, faction ? faction : "", 64);
             // credits (widened to double)
             float c = SafeReadF32(pPtr + RVA::PlayerObj::Credits);
-            sec.f64(static_cast<double>(c));
+            SnapF64(w, static_cast<double>(c));
             // tech_level (int32)
             int32_t tech = static_cast<int32_t>(SafeReadU32(pPtr + RVA::PlayerObj::TechLevel));
-            int32_t tmp = tech;
-            sec.append(&tmp, 4);
+            SnapPut(w, &tech, 4);
             // player_name reserved — 64 zero bytes
-            sec.fixedStr("", 64);
+            SnapZeros(w, 64);
             actual++;
         }
         // Patch the real player_count into the first 4 bytes of the section payload
-        memcpy(sec.bytes.data(), &actual, 4);
-
-        buf.u32(1);                                             // section_id
-        buf.u32(static_cast<uint32_t>(sec.bytes.size()));        // section_length
-        buf.append(sec.bytes.data(), sec.bytes.size());          // payload
+        SnapPatchU32(w, countOff, actual);
+        SnapEndSection(w);
     }
 
     // ---- Section 2: lua_state_registry ----
     {
-        DumpBuf sec;
+        SnapBeginSection(w, 2);
         EnterCriticalSection(&csRegistered);
-        uint32_t stateCount = static_cast<uint32_t>(registered_states.size());
+        uint32_t stateCount = static_cast<uint32_t>(registered_states.states.size());
         if (stateCount > 1024) stateCount = 1024;
-        sec.u32(stateCount);
+        SnapU32(w, stateCount);
         for (uint32_t i = 0; i < stateCount; i++) {
-            sec.u64(reinterpret_cast<uint64_t>(registered_states[i]));
+            SnapU64(w, reinterpret_cast<uint64_t>(registered_states.states[i]));
         }
         LeaveCriticalSection(&csRegistered);
 
-        buf.u32(2);
-        buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // ---- Section 3: object_catalog ----
+    // Exact counts from the type census when the mode list is live; the
+    // per-type Find_All_Objects_Of_Type probe only runs without one.
     {
-        DumpBuf sec;
-        sec.u32(kDumpObjectTypesCount);
+        SnapBeginSection(w, 3);
+        SnapU32(w, kDumpObjectTypesCount);
+        const TypeCensus* census = GetTypeCensus();
         for (uint32_t i = 0; i < kDumpObjectTypesCount; i++) {
-            sec.fixedStr(kDumpObjectTypes[i], 64);
-            uint32_t count = QueryObjectTypeCount(L, kDumpObjectTypes[i]);
-            sec.u32(count);
+            SnapFixedStr(w, kDumpObjectTypes[i], 64);
+            uint32_t count = census->objects
+                ? TypeCensusCountByName(census, kDumpObjectTypes[i])
+                : QueryObjectTypeCount(L, kDumpObjectTypes[i]);
+            SnapU32(w, count);
         }
 
-        buf.u32(3);
-        buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // ---- Section 4: global_registry ----
     {
-        DumpBuf sec;
-        sec.u32(kDumpGlobalsCount);
+        SnapBeginSection(w, 4);
+        SnapU32(w, kDumpGlobalsCount);
         for (uint32_t i = 0; i < kDumpGlobalsCount; i++) {
-            WriteGlobalRecord(L, sec, kDumpGlobals[i]);
+            WriteGlobalRecord(L, w, kDumpGlobals[i]);
         }
 
-        buf.u32(4);
-        buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // ---- Section 5: metadata ----
     {
-        DumpBuf sec;
-        sec.u32(4); // entry_count: four required keys
-        WriteMetaPair(sec, "capture_method",       "powrprof_dll");
-        WriteMetaPair(sec, "mod_name",             "unknown");
-        WriteMetaPair(sec, "mod_version",          "unknown");
-        WriteMetaPair(sec, "swfoc_bridge_version", "1.0");
+        SnapBeginSection(w, 5);
+        SnapU32(w, 4); // entry_count: four required keys
+        WriteMetaPair(w, "capture_method",       "powrprof_dll");
+        WriteMetaPair(w, "mod_name",             "unknown");
+        WriteMetaPair(w, "mod_version",          "unknown");
+        WriteMetaPair(w, "swfoc_bridge_version", "1.0");
 
-        buf.u32(5);
-        buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // ---- v2.1 extension (added 2026-04-23 for Task 101) ----
@@ -1818,28 +2877,22 @@ static int Lua_DumpState(lua_State* L) {
     // replay harness to exercise Task 99 (hardpoint-behavior invulnerability)
     // and Task 100 (damage-path simulation) offline. All three sections are
     // OPTIONAL — readers predating this extension skip cleanly via the
-    // unknown-section rule. The writer emits them only when ResolveSelectionVector
-    // succeeds; main-menu / no-selection captures stay backwards-compatible.
-    uintptr_t selVec = 0;
-    bool haveSelection = ResolveSelectionVector(selVec);
-    uintptr_t selObjs[RVA::Selection::kMaxSelectionCount];
-    int selCount = 0;
-    if (haveSelection) {
-        selCount = WalkSelectionVector(selVec, selObjs, RVA::Selection::kMaxSelectionCount);
-        if (selCount < 0) selCount = 0;
-    }
-
-    if (haveSelection && selCount > 0) {
+    // unknown-section rule. The writer emits them only when the selection
+    // (GetSelection) is non-empty; main-menu / no-selection captures stay
+    // backwards-compatible.
+    const SelectionTracker* selection = GetSelection();
+    const uint64_t* selObjs = selection->objs;
+    const int selCount = selection->count;
+
+    if (selCount > 0) {
         // ---- Section 11: selected_units ----
         {
-            DumpBuf sec;
-            sec.u32(static_cast<uint32_t>(selCount));
+            SnapBeginSection(w, 11);
+            SnapU32(w, static_cast<uint32_t>(selCount));
             for (int i = 0; i < selCount; i++) {
-                sec.u64(static_cast<uint64_t>(selObjs[i]));
+                SnapU64(w, static_cast<uint64_t>(selObjs[i]));
             }
-            buf.u32(11);
-            buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-            buf.append(sec.bytes.data(), sec.bytes.size());
+            SnapEndSection(w);
         }
 
         // ---- Section 12: unit_detail ----
@@ -1849,12 +2902,12 @@ static int Lua_DumpState(lua_State* L) {
         // so the reader still has a stable slot. Hardpoint count uses the
         // same Components-array walk as Lua_GetHardpoints (bounded at 32).
         {
-            DumpBuf sec;
-            sec.u32(static_cast<uint32_t>(selCount));
+            SnapBeginSection(w, 12);
+            SnapU32(w, static_cast<uint32_t>(selCount));
             for (int i = 0; i < selCount; i++) {
                 uintptr_t obj = selObjs[i];
-                sec.u64(static_cast<uint64_t>(obj));
-                sec.fixedStr("", 64); // type_name (reserved; Component-type lookup TODO)
+                SnapU64(w, static_cast<uint64_t>(obj));
+                SnapZeros(w, 64); // type_name (reserved; Component-type lookup TODO)
 
                 // Defensive read guard: if the object pointer went stale
                 // between selection resolution and this write, emit zeros
@@ -1871,44 +2924,40 @@ static int Lua_DumpState(lua_State* L) {
                     preventDeath = *reinterpret_cast<uint8_t*>(obj + RVA::GameObj::PreventDeath);
                     // max_hull is not in the stable GameObj layout — leave 0.
                 }
-                int32_t ownerTmp = ownerSlot;
-                sec.append(&ownerTmp, 4);
+                SnapPut(w, &ownerSlot, 4);
                 uint32_t hullBits = 0, maxHullBits = 0;
                 memcpy(&hullBits, &hull, 4);
                 memcpy(&maxHullBits, &maxHull, 4);
-                sec.u32(hullBits);
-                sec.u32(maxHullBits);
-                sec.u8(invuln);
-                sec.u8(preventDeath);
-                uint8_t rsv[6] = {0};
-                sec.append(rsv, 6);
+                SnapU32(w, hullBits);
+                SnapU32(w, maxHullBits);
+                SnapU8(w, invuln);
+                SnapU8(w, preventDeath);
+                SnapZeros(w, 6);
 
                 // Hardpoint indices: walk Components[0..31], emit one uint32
                 // per non-null child. The replay harness mirrors this via
                 // ReplayMutMockUnit(hardpoint_count), then section 13
                 // attaches behaviors on top.
-                uint32_t hpCountPayloadOffset = static_cast<uint32_t>(sec.bytes.size());
-                sec.u32(0); // placeholder for hardpoint_count
+                const size_t hpCountOff = SnapOffset(w);
+                SnapU32(w, 0); // placeholder for hardpoint_count
                 uint32_t hpCount = 0;
                 if (IsValidObjAddr(obj)) {
                     uintptr_t components =
                         *reinterpret_cast<uintptr_t*>(obj + RVA::GameObj::ComponentArray);
-                    if (components && !IsBadReadPtr(reinterpret_cast<void*>(components), 0x100)) {
+                    if (components && CanReadMem(components, 0x100)) {
                         for (uint32_t j = 0; j < 32; j++) {
                             uintptr_t child =
                                 *reinterpret_cast<uintptr_t*>(components + j * 8);
                             if (!child) continue;
                             if (!IsValidObjAddr(child)) continue;
-                            sec.u32(j);
+                            SnapU32(w, j);
                             hpCount++;
                         }
                     }
                 }
-                memcpy(sec.bytes.data() + hpCountPayloadOffset, &hpCount, 4);
+                SnapPatchU32(w, hpCountOff, hpCount);
             }
-            buf.u32(12);
-            buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-            buf.append(sec.bytes.data(), sec.bytes.size());
+            SnapEndSection(w);
         }
 
         // ---- Section 13: behavior_attach (empty placeholder for now) ----
@@ -1918,25 +2967,42 @@ static int Lua_DumpState(lua_State* L) {
         // tests using the mocked path populate behaviors programmatically
         // via SWFOC_ReplayAttachBehavior.
         {
-            DumpBuf sec;
-            sec.u32(0);
-            buf.u32(13);
-            buf.u32(static_cast<uint32_t>(sec.bytes.size()));
-            buf.append(sec.bytes.data(), sec.bytes.size());
+            SnapBeginSection(w, 13);
+            SnapU32(w, 0);
+            SnapEndSection(w);
         }
-    }
 
-    // ---- End marker: id 0xFFFFFFFF, length 4, CRC32 of everything before.
-    uint32_t endId = 0xFFFFFFFFu;
-    uint32_t endLen = 4;
-    buf.u32(endId);
-    buf.u32(endLen);
-    uint32_t crc = Crc32_Update(0, buf.bytes.data(), buf.bytes.size());
-    buf.u32(crc);
+        // ---- Section 14: unit_position (2026-10-14) ----
+        // World position of each selected unit whose bounds read
+        // (ReadUnitWorldBounds); the replay splash and radius queries use
+        // them. Skipped when none do, which is every capture until the
+        // position RE lands.
+        float pos[SELECTION_TRACK_MAX][3];
+        uint64_t placed[SELECTION_TRACK_MAX];
+        uint32_t placedCount = 0;
+        for (int i = 0; i < selCount; i++) {
+            float half[3];
+            const uintptr_t obj = (uintptr_t)selObjs[i];
+            if (IsValidObjAddr(obj) && ReadUnitWorldBounds(obj, pos[placedCount], half)) {
+                placed[placedCount++] = selObjs[i];
+            }
+        }
+        if (placedCount > 0) {
+            SnapBeginSection(w, 14);
+            SnapU32(w, placedCount);
+            for (uint32_t i = 0; i < placedCount; i++) {
+                SnapU64(w, placed[i]);
+                SnapPut(w, pos[i], 12);
+            }
+            SnapEndSection(w);
+        }
+    }
+}
 
-    // ---- Flush to disk in binary mode.
-    FILE* f = fopen(path, "wb");
-    if (!f) {
+// The DumpState reply for a finished writer; SWFOC_DumpStatePoll hands back
+// the same strings.
+static int PushSnapResult(lua_State* L, const char* path, const SnapWriteResult& res) {
+    if (!res.opened) {
         char errbuf[512];
         snprintf(errbuf, sizeof(errbuf),
                  "ERR: SWFOC_DumpState: could not open '%s' for write", path);
@@ -1944,26 +3010,216 @@ static int Lua_DumpState(lua_State* L) {
         fn_pushstring(L, errbuf);
         return 1;
     }
-    size_t wrote = fwrite(buf.bytes.data(), 1, buf.bytes.size(), f);
-    fclose(f);
-    if (wrote != buf.bytes.size()) {
+    if (res.written != res.total) {
         char errbuf[512];
         snprintf(errbuf, sizeof(errbuf),
                  "ERR: SWFOC_DumpState: short write (%zu of %zu bytes) to '%s'",
-                 wrote, buf.bytes.size(), path);
-        Log("[Dump] short write: %zu/%zu\n", wrote, buf.bytes.size());
+                 res.written, res.total, path);
+        Log("[Dump] short write: %zu/%zu\n", res.written, res.total);
         fn_pushstring(L, errbuf);
         return 1;
     }
 
     char okbuf[512];
-    snprintf(okbuf, sizeof(okbuf),
-             "OK: snapshot written to %s (%zu bytes)", path, buf.bytes.size());
-    Log("[Dump] %s\n", okbuf);
+    if (res.lz4 || res.delta) {
+        snprintf(okbuf, sizeof(okbuf),
+                 "OK: snapshot written to %s (%zu bytes, %s from %zu)", path, res.total,
+                 res.delta ? (res.lz4 ? "lz4 delta" : "delta") : "lz4", res.raw);
+    } else {
+        snprintf(okbuf, sizeof(okbuf),
+                 "OK: snapshot written to %s (%zu bytes)", path, res.total);
+    }
+    Log("[Dump] %s (handoffs=%u stalls=%u grows=%u)\n",
+        okbuf, res.handoffs, res.stalls, res.grows);
+    fn_pushstring(L, okbuf);
+    return 1;
+}
+
+// Full stream of the newest capture that reached disk intact: the base of
+// the next delta. Shared with delta writers' I/O threads, hence read-only.
+static SnapStream g_snapBase;
+
+// Optional codec argument of SWFOC_DumpState / SWFOC_DumpStateAsync: nil or
+// "raw" writes v2, "lz4" writes v3 with LZ4-compressed sections, "delta"
+// writes a v4 delta against g_snapBase, "lz4+delta" both. Pushes the ERR
+// reply and returns false for anything else, or for a delta with no base.
+static bool ParseSnapCodec(lua_State* L, const char* fnName, bool* lz4, bool* delta) {
+    const char* codec = fn_tostring(L, 2);
+    *lz4 = false;
+    *delta = false;
+    if (!codec || strcmp(codec, "raw") == 0) return true;
+    if (strcmp(codec, "lz4") == 0 || strcmp(codec, "lz4+delta") == 0) *lz4 = true;
+    if (strcmp(codec, "delta") == 0 || strcmp(codec, "lz4+delta") == 0) *delta = true;
+    char errbuf[160];
+    if (!*lz4 && !*delta) {
+        snprintf(errbuf, sizeof(errbuf),
+                 "ERR: %s: unknown codec '%.32s' (expected raw, lz4, delta or lz4+delta)",
+                 fnName, codec);
+    } else if (*delta && !g_snapBase) {
+        snprintf(errbuf, sizeof(errbuf),
+                 "ERR: %s: no base capture for a delta yet (take a full one first)", fnName);
+    } else {
+        return true;
+    }
+    fn_pushstring(L, errbuf);
+    return false;
+}
+
+// Adopts a finished writer's kept stream as the delta base unless a newer
+// capture already is (async captures can finish out of order).
+static void AdoptSnapBase(SnapWriter* w, const SnapWriteResult& res) {
+    if (!res.opened || res.written != res.total || w->kept.size() < 68 + 12) return;
+    if (g_snapBase && SnapStreamTimestamp(g_snapBase->data()) > SnapStreamTimestamp(w->kept.data())) {
+        return;
+    }
+    g_snapBase = std::make_shared<const std::vector<uint8_t>>(std::move(w->kept));
+}
+
+static int Lua_DumpState(lua_State* L) {
+    const char* path = fn_tostring(L, 1);
+    if (!path || !path[0]) {
+        fn_pushstring(L, "ERR: SWFOC_DumpState: expected string path argument");
+        return 1;
+    }
+    bool lz4, delta;
+    if (!ParseSnapCodec(L, "SWFOC_DumpState", &lz4, &delta)) return 1;
+
+    Log("[Dump] SWFOC_DumpState called, path=%s%s%s\n", path, lz4 ? " lz4" : "",
+        delta ? " delta" : "");
+
+    // ---- Stream the snapshot through snap_writer.h: this thread stores
+    // fields in place, each finished section goes to the writer's I/O
+    // thread, which does the fopen / fwrite / CRC and appends the section
+    // index. Crc32_Update (crc32.h) is the shared slicing-by-8 CRC.
+    SnapWriter w;
+    SnapWriterOpen(&w, path, Crc32_Update);
+    SnapWriterKeepStream(&w);
+    SnapWriterIndexSections(&w, 68);
+    if (lz4) SnapWriterCompressSections(&w, 68);
+    if (delta) SnapWriterDeltaAgainst(&w, g_snapBase, 68);
+
+    CaptureSnapshot(L, &w);
+
+    SnapWriteResult res;
+    SnapWriterFinish(&w, &res);
+    AdoptSnapBase(&w, res);
+    return PushSnapResult(L, path, res);
+}
+
+// ---- Asynchronous capture (SWFOC_DumpStateAsync / SWFOC_DumpStatePoll) ----
+// Scheduled captures every few seconds must not stall tactical frames, so
+// the async path splits the capture in two:
+//   1. SWFOC_DumpStateAsync runs CaptureSnapshot into a deferred writer on
+//      the main thread: engine reads and in-place stores into one reserved
+//      staging chunk, within a single call, never waiting on the I/O thread.
+//   2. SnapWriterClose hands the staged file over; the I/O thread opens the
+//      file, runs the CRC over it, writes it and appends the CRC. The
+//      call returns "OK: queued id=N ..." without waiting for that.
+// SWFOC_DumpStatePoll(id) answers "PENDING id=N" until the file is closed,
+// then the same OK / ERR reply SWFOC_DumpState gives, and retires the job.
+// Jobs live only on the main thread (both helpers are Lua calls), so the
+// table needs no lock. A capture that is finished but never polled is
+// reclaimed when every slot is taken.
+#define SNAP_ASYNC_SLOTS 4
+
+struct SnapAsyncJob {
+    uint32_t    id;      // 0 = free
+    SnapWriter* writer;
+    char        path[MAX_PATH];
+};
+
+static SnapAsyncJob g_snapJobs[SNAP_ASYNC_SLOTS];
+static uint32_t     g_snapNextJobId = 1;
+
+static void RetireSnapJob(SnapAsyncJob* job, SnapWriteResult* res) {
+    SnapWriterCollect(job->writer, res);
+    AdoptSnapBase(job->writer, *res);
+    delete job->writer;
+    job->writer = nullptr;
+    job->id = 0;
+}
+
+static SnapAsyncJob* ClaimSnapJobSlot() {
+    for (SnapAsyncJob& job : g_snapJobs) {
+        if (job.id == 0) return &job;
+    }
+    SnapAsyncJob* oldest = nullptr;
+    for (SnapAsyncJob& job : g_snapJobs) {
+        if (SnapWriterDone(job.writer) && (!oldest || job.id < oldest->id)) oldest = &job;
+    }
+    if (oldest) {
+        SnapWriteResult dropped;
+        Log("[Dump] reclaiming unpolled capture id=%u (%s)\n", oldest->id, oldest->path);
+        RetireSnapJob(oldest, &dropped);
+    }
+    return oldest;
+}
+
+static int Lua_DumpStateAsync(lua_State* L) {
+    const char* path = fn_tostring(L, 1);
+    if (!path || !path[0]) {
+        fn_pushstring(L, "ERR: SWFOC_DumpStateAsync: expected string path argument");
+        return 1;
+    }
+    if (strlen(path) >= MAX_PATH) {
+        fn_pushstring(L, "ERR: SWFOC_DumpStateAsync: path too long");
+        return 1;
+    }
+    bool lz4, delta;
+    if (!ParseSnapCodec(L, "SWFOC_DumpStateAsync", &lz4, &delta)) return 1;
+    SnapAsyncJob* job = ClaimSnapJobSlot();
+    if (!job) {
+        fn_pushstring(L, "ERR: SWFOC_DumpStateAsync: all capture slots still writing");
+        return 1;
+    }
+
+    const int64_t t0 = PipeQpcNow();
+    job->writer = new SnapWriter;
+    SnapWriterOpen(job->writer, path, Crc32_Update, true);
+    SnapWriterKeepStream(job->writer);
+    SnapWriterIndexSections(job->writer, 68);
+    if (lz4) SnapWriterCompressSections(job->writer, 68);
+    if (delta) SnapWriterDeltaAgainst(job->writer, g_snapBase, 68);
+    CaptureSnapshot(L, job->writer);
+    const size_t staged = SnapOffset(job->writer) + 12;  // + end marker and CRC
+    SnapWriterClose(job->writer);
+    const int64_t t1 = PipeQpcNow();
+
+    job->id = g_snapNextJobId++;
+    if (g_snapNextJobId == 0) g_snapNextJobId = 1;
+    snprintf(job->path, sizeof(job->path), "%s", path);
+
+    char okbuf[512];
+    snprintf(okbuf, sizeof(okbuf), "OK: queued id=%u (%zu bytes staged) for %s",
+             job->id, staged, path);
+    Log("[Dump] %s in %lld us\n", okbuf,
+        (long long)((t1 - t0) * 1000000 / g_qpcFreq.QuadPart));
     fn_pushstring(L, okbuf);
     return 1;
 }
 
+static int Lua_DumpStatePoll(lua_State* L) {
+    const uint32_t id = static_cast<uint32_t>(fn_tonumber(L, 1));
+    for (SnapAsyncJob& job : g_snapJobs) {
+        if (job.id == 0 || job.id != id) continue;
+        if (!SnapWriterDone(job.writer)) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "PENDING id=%u", id);
+            fn_pushstring(L, buf);
+            return 1;
+        }
+        char path[MAX_PATH];
+        snprintf(path, sizeof(path), "%s", job.path);
+        SnapWriteResult res;
+        RetireSnapJob(&job, &res);
+        return PushSnapResult(L, path, res);
+    }
+    char errbuf[96];
+    snprintf(errbuf, sizeof(errbuf), "ERR: SWFOC_DumpStatePoll: unknown capture id %u", id);
+    fn_pushstring(L, errbuf);
+    return 1;
+}
+
 // ======================================================================
 // Phase 3.2: Combat / Inspect helpers ported from CE trainer
 // ----------------------------------------------------------------------
@@ -1975,22 +3231,22 @@ static int Lua_DumpState(lua_State* L) {
 
 // Validate that an absolute address looks like a plausible in-process
 // pointer to engine memory. We do not have a precise heap range, but we
-// can rule out null, low pages, and obviously bogus values. IsBadReadPtr
-// is the last line of defense (deprecated, but the only SEH-free option
-// available to MinGW builds).
+// can rule out null, low pages, and obviously bogus values. CanReadMem
+// is the last line of defense (MinGW builds have no SEH).
 static bool IsValidObjAddr(uintptr_t addr) {
     if (addr == 0) return false;
     if (addr < 0x10000) return false; // null page / low memory
     // Reject sign-extended kernel addresses
     if ((addr & 0xFFFF000000000000ULL) == 0xFFFF000000000000ULL) return false;
-    if (IsBadReadPtr(reinterpret_cast<void*>(addr), 0x400)) return false;
+    if (!CanReadMem(addr, 0x400)) return false;
     return true;
 }
 
 // Walk the parent-component chain to the root unit. Mirrors the gd_walk
 // loop in the CE God Mode cave. Adds a hard 8-iteration cap (the trainer
 // has no termination guard other than ParentIdx==0xFF or null components,
-// which can loop forever in pathological cases).
+// which can loop forever in pathological cases). Uncached; GetObjFields
+// memoizes the result per tick.
 static uintptr_t WalkToRootUnit(uintptr_t obj) {
     if (!IsValidObjAddr(obj)) return 0;
     uintptr_t cur = obj;
@@ -1998,7 +3254,7 @@ static uintptr_t WalkToRootUnit(uintptr_t obj) {
         uint8_t parentIdx = *reinterpret_cast<uint8_t*>(cur + RVA::GameObj::ParentIndex);
         if (parentIdx == 0xFF) return cur; // root
         uintptr_t components = *reinterpret_cast<uintptr_t*>(cur + RVA::GameObj::ComponentArray);
-        if (!components || IsBadReadPtr(reinterpret_cast<void*>(components), (parentIdx + 1) * 8)) {
+        if (!components || !CanReadMem(components, (parentIdx + 1) * 8)) {
             return cur;
         }
         uintptr_t parent = *reinterpret_cast<uintptr_t*>(components + parentIdx * 8);
@@ -2009,7 +3265,7 @@ static uintptr_t WalkToRootUnit(uintptr_t obj) {
 }
 
 // Resolve the root unit's owning PlayerObject* via the PlayerArray global.
-// Returns 0 if any link is invalid.
+// Returns 0 if any link is invalid. Uncached, like WalkToRootUnit.
 static uintptr_t GetOwnerPlayerObj(uintptr_t rootObj) {
     if (!IsValidObjAddr(rootObj)) return 0;
     int32_t ownerId = *reinterpret_cast<int32_t*>(rootObj + RVA::GameObj::OwnerPlayerID);
@@ -2020,15 +3276,36 @@ static uintptr_t GetOwnerPlayerObj(uintptr_t rootObj) {
     return player;
 }
 
+// 2026-10-14: per-thread GameObj field memo (obj_memo.h). Resolves validity,
+// component array, root unit, owner player and the is-human flag once per
+// object and probe epoch, so a command touching many units (or the SetHP
+// detour running per hit) stops re-walking the same chains. The epoch is
+// CurrentProbeEpoch, the one CanReadMem uses.
+static thread_local ObjMemo t_objMemo;
+
+static const ObjMemoEntry* GetObjFields(uintptr_t obj) {
+    const uint64_t epoch = CurrentProbeEpoch();
+    if (const ObjMemoEntry* e = ObjMemoLookup(&t_objMemo, (uint64_t)obj, epoch)) return e;
+    ObjMemoEntry fresh = {};
+    fresh.obj = (uint64_t)obj;
+    fresh.epoch = epoch;
+    if (IsValidObjAddr(obj)) {
+        fresh.valid = 1;
+        fresh.components = *reinterpret_cast<uintptr_t*>(obj + RVA::GameObj::ComponentArray);
+        const uintptr_t root = WalkToRootUnit(obj);
+        fresh.root = root;
+        const uintptr_t player = GetOwnerPlayerObj(root);
+        fresh.player = player;
+        fresh.isHuman = (player && CanReadMem(player + RVA::PlayerObj::LocalPlayer, 1)
+                         && *reinterpret_cast<uint8_t*>(player + RVA::PlayerObj::LocalPlayer) == 1) ? 1 : 0;
+    }
+    return ObjMemoStore(&t_objMemo, fresh);
+}
+
 // Test whether a root unit is owned by the local human player. Reads the
 // PlayerObject.LocalPlayer byte at +0x62 (the same field every cave checks).
 static bool IsObjOwnedByHuman(uintptr_t obj) {
-    uintptr_t root = WalkToRootUnit(obj);
-    if (!root) return false;
-    uintptr_t player = GetOwnerPlayerObj(root);
-    if (!player) return false;
-    if (IsBadReadPtr(reinterpret_cast<void*>(player + RVA::PlayerObj::LocalPlayer), 1)) return false;
-    return *reinterpret_cast<uint8_t*>(player + RVA::PlayerObj::LocalPlayer) == 1;
+    return GetObjFields(obj)->isHuman != 0;
 }
 
 // MSVC std::string layout (x64). Matches the 32-byte structure the engine's
@@ -2062,13 +3339,31 @@ static void* EngineLookupInvulnerableBehavior() {
 static void* EngineQueryInterface(uintptr_t obj, int iface_id) {
     if (!IsValidObjAddr(obj)) return nullptr;
     uintptr_t vtable = *reinterpret_cast<uintptr_t*>(obj);
-    if (!vtable || IsBadReadPtr(reinterpret_cast<void*>(vtable + 0x10), 8)) return nullptr;
+    if (!vtable || !CanReadMem(vtable + 0x10, 8)) return nullptr;
     typedef void* (*pfn_QI)(void*, int);
     auto fn = *reinterpret_cast<pfn_QI*>(vtable + 0x10);
     if (!fn) return nullptr;
     return fn(reinterpret_cast<void*>(obj), iface_id);
 }
 
+// 2026-10-14: per-type hardpoint layouts and the INVULNERABLE behavior
+// (hardpoint_layout.h), bound to the live GameModeClass and the type
+// cache's generation so a game load drops them. Main thread only.
+static HardpointLayoutCache g_hpLayout;
+
+static HardpointLayoutCache* BoundHardpointLayouts() {
+    uint64_t mode = 0;
+    const uintptr_t slot = g_base + RVA::GameModeRoot_Global;
+    if (g_base && CanReadMem(slot, 8)) mode = *reinterpret_cast<uint64_t*>(slot);
+    HardpointLayoutBind(&g_hpLayout, mode, (uint32_t)g_typeCacheGen);
+    return &g_hpLayout;
+}
+
+// The layout entry for a validated obj's type; nullptr when the table is full.
+static HardpointLayout* HardpointLayoutOf(HardpointLayoutCache* c, uintptr_t obj) {
+    return HardpointLayoutFor(c, *reinterpret_cast<uint64_t*>(obj + RVA::GameObj::GameObjType));
+}
+
 // Reimplement MakeInvulnerable's behavior-attach chain inline — this is the
 // path Task 99 unblocks. The engine's Lua wrapper (0x57D550) takes a
 // userdata which we cannot synthesize from C++, so we reproduce the
@@ -2078,7 +3373,9 @@ static void* EngineQueryInterface(uintptr_t obj, int iface_id) {
 static bool CallMakeInvulnerableInline(uintptr_t obj, bool enable) {
     if (!IsValidObjAddr(obj)) return false;
 
-    void* behavior = EngineLookupInvulnerableBehavior();
+    HardpointLayoutCache* layouts = BoundHardpointLayouts();
+    if (!layouts->behavior) layouts->behavior = (uint64_t)(uintptr_t)EngineLookupInvulnerableBehavior();
+    void* behavior = reinterpret_cast<void*>(static_cast<uintptr_t>(layouts->behavior));
     if (!behavior) return false;
 
     typedef char  (*pfn_BehaviorAttach)(void* obj, void* behavior, char);
@@ -2109,6 +3406,7 @@ static bool CallMakeInvulnerableInline(uintptr_t obj, bool enable) {
     if (!mgr) return false;
     int count = HardpointCount(mgr);
     if (count <= 0 || count > 256) return false;
+    HardpointLayoutNoteCount(HardpointLayoutOf(layouts, obj), count);
 
     int mutated = 0;
     for (int i = 0; i < count; i++) {
@@ -2209,7 +3507,7 @@ static int Lua_InspectUnit(lua_State* L) {
     uint8_t  preventDeath  = *reinterpret_cast<uint8_t*>(addr + RVA::GameObj::PreventDeath);
     uint8_t  invulnFlag    = *reinterpret_cast<uint8_t*>(addr + RVA::GameObj::InvulnFlag);
     uint8_t  hardpointFlag = *reinterpret_cast<uint8_t*>(addr + RVA::GameObj::HardpointFlag);
-    uintptr_t componentsPtr = *reinterpret_cast<uintptr_t*>(addr + RVA::GameObj::ComponentArray);
+    uintptr_t componentsPtr = (uintptr_t)GetObjFields(addr)->components;
 
     char buf[512];
     snprintf(buf, sizeof(buf),
@@ -2244,7 +3542,8 @@ static size_t SafeAppendFmt(char* buf, size_t offset, size_t cap, const char* fm
 // Walks the Components array of the supplied object (which is expected
 // to BE the root — the caller is responsible). For each non-null child,
 // emits its address and current HP. Bounded to 32 children to avoid
-// pathological loops if Components contains garbage.
+// pathological loops if Components contains garbage. Once the unit's type
+// has a fixed layout (hardpoint_layout.h) only its child slots are read.
 static int Lua_GetHardpoints(lua_State* L) {
     double rawAddr = fn_tonumber(L, 1);
     uintptr_t addr = static_cast<uintptr_t>(static_cast<uint64_t>(rawAddr));
@@ -2252,32 +3551,47 @@ static int Lua_GetHardpoints(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_GetHardpoints: invalid obj_addr");
         return 1;
     }
-    uintptr_t components = *reinterpret_cast<uintptr_t*>(addr + RVA::GameObj::ComponentArray);
-    if (!components || IsBadReadPtr(reinterpret_cast<void*>(components), 0x100)) {
+    constexpr int kMaxChildren = HARDPOINT_LAYOUT_CHILDREN;
+    HardpointLayoutCache* layouts = BoundHardpointLayouts();
+    HardpointLayout* layout = HardpointLayoutOf(layouts, addr);
+    const bool known = HardpointLayoutKnown(layouts, layout);
+    const int span = known ? layout->span : kMaxChildren;
+    const uint32_t mask = known ? layout->childMask : 0xFFFFFFFFu;
+    uintptr_t components = (uintptr_t)GetObjFields(addr)->components;
+    if (!components || span == 0 || !CanReadMem(components, (size_t)span * 8)) {
         fn_pushstring(L, "count=0");
         return 1;
     }
     // Two-phase: count first so we can emit a stable "count=N" prefix,
-    // then format each entry. Single linear walk for each phase, with
-    // bounded snprintf via SafeAppendFmt — no return-value math on the
-    // raw snprintf result.
-    constexpr int kMaxChildren = 32;
+    // then format each entry. Single linear walk for each phase; the
+    // CsvRow appends clamp at the end of buf (csv_row.h).
     uintptr_t children[kMaxChildren];
     int count = 0;
-    for (int i = 0; i < kMaxChildren; i++) {
+    uint32_t occupied = 0;
+    for (int i = 0; i < span; i++) {
+        if (!((mask >> i) & 1u)) continue;
         uintptr_t child = *reinterpret_cast<uintptr_t*>(components + i * 8);
         if (!child) continue;
         if (!IsValidObjAddr(child)) continue;
+        occupied |= 1u << i;
         children[count++] = child;
     }
+    if (!known) HardpointLayoutLearn(layout, occupied);
     char buf[2048];
-    size_t off = 0;
-    off = SafeAppendFmt(buf, off, sizeof(buf), "count=%d", count);
+    CsvRow row;
+    CsvRowInit(&row, buf, sizeof(buf));
+    CsvRowCount(&row, count);
     for (int i = 0; i < count; i++) {
         float hp = *reinterpret_cast<float*>(children[i] + RVA::GameObj::HP);
-        off = SafeAppendFmt(buf, off, sizeof(buf),
-                            " child%d=0x%016llX hp%d=%.3f",
-                            i, (unsigned long long)children[i], i, hp);
+        // " child%d=0x%016llX hp%d=%.3f"
+        CsvRowStr(&row, " child");
+        CsvRowI64(&row, i);
+        CsvRowStr(&row, "=0x");
+        CsvRowHex16(&row, (uint64_t)children[i]);
+        CsvRowStr(&row, " hp");
+        CsvRowI64(&row, i);
+        CsvRowChar(&row, '=');
+        CsvRowFixed(&row, hp, 3);
     }
     fn_pushstring(L, buf);
     return 1;
@@ -2296,7 +3610,7 @@ static int Lua_GetHardpoints(lua_State* L) {
 //   walk node = *(vec + kVectorHead) until node == vec + kVectorSentinel;
 //                obj = *(node + kNodeDataPlus24) - kNodeDataAdjustment
 //
-// Every hop is IsBadReadPtr-guarded so a torn read from the shared memory
+// Every hop is CanReadMem-guarded so a torn read from the shared memory
 // drain thread degrades to "no selection" rather than crashing the game.
 // The function does NOT call the engine's sub_14039AD40 validator — that
 // helper replays vtable calls that are unsafe outside the main thread,
@@ -2308,23 +3622,28 @@ static int Lua_GetHardpoints(lua_State* L) {
 // +0x30, use it to index the vec_begin pointer at +0x00, then read the
 // slot id out of the player at +0x4C. Returns -1 on any dereference
 // failure. Harness tests swap g_base with a fake image so all arithmetic
-// must go through g_base for test isolation.
-static int ReadCurrentHumanPlayerSlot() {
+// must go through g_base for test isolation. Read once per tick into the
+// player table (humanSlot); ReadCurrentHumanPlayerSlot serves it from there.
+static int ReadCurrentHumanPlayerSlotRaw() {
     uintptr_t pl = g_base + RVA::PlayerListClass_Global;
-    if (IsBadReadPtr(reinterpret_cast<void*>(pl), 0x40)) return -1;
+    if (!CanReadMem(pl, 0x40)) return -1;
     uintptr_t vecBegin = *reinterpret_cast<uintptr_t*>(pl + 0x00);
     uintptr_t vecEnd   = *reinterpret_cast<uintptr_t*>(pl + 0x08);
     if (!vecBegin || vecBegin == vecEnd) return -1;
     int curIdx = *reinterpret_cast<int*>(pl + 0x30);
     if (curIdx < 0 || curIdx > 7) return -1;
     uintptr_t entryAddr = vecBegin + 8 * curIdx;
-    if (IsBadReadPtr(reinterpret_cast<void*>(entryAddr), 8)) return -1;
+    if (!CanReadMem(entryAddr, 8)) return -1;
     uintptr_t player = *reinterpret_cast<uintptr_t*>(entryAddr);
     if (!player) return -1;
-    if (IsBadReadPtr(reinterpret_cast<void*>(player + 0x4C), 4)) return -1;
+    if (!CanReadMem(player + 0x4C, 4)) return -1;
     return *reinterpret_cast<int*>(player + 0x4C);
 }
 
+static int ReadCurrentHumanPlayerSlot() {
+    return GetPlayerTable()->humanSlot;
+}
+
 // Resolve the per-player selection-vector header for the current human.
 //
 // 2026-04-23 bug fix: previously this function did ONE dereference at
@@ -2353,14 +3672,14 @@ static bool ResolveSelectionVector(uintptr_t& outVec) {
     // global slot 0xB15418 (module-relative). This is the canonical global
     // pointer IDA prints as `qword_140B15418`.
     uintptr_t globalSlotAddr = g_base + RVA::GameModeRoot_Global;
-    if (IsBadReadPtr(reinterpret_cast<void*>(globalSlotAddr), 8)) return false;
+    if (!CanReadMem(globalSlotAddr, 8)) return false;
     uintptr_t globalPtr = *reinterpret_cast<uintptr_t*>(globalSlotAddr);
     if (!globalPtr) return false;
 
     // Step 2: second dereference — read *(globalPtr + 0x18) to get the
     // live GameModeClass instance. This is the value IDA shows as
     // `*(qword_140B15418 + 24)` in sub_14003AFE0 / sub_1402BD2F0.
-    if (IsBadReadPtr(reinterpret_cast<void*>(globalPtr + RVA::Selection::kModeRootIndirection), 8)) {
+    if (!CanReadMem(globalPtr + RVA::Selection::kModeRootIndirection, 8)) {
         return false;
     }
     uintptr_t mgrRoot = *reinterpret_cast<uintptr_t*>(
@@ -2368,7 +3687,7 @@ static bool ResolveSelectionVector(uintptr_t& outVec) {
     if (!mgrRoot) return false;
 
     // Step 3: read the flat per-player vector array base.
-    if (IsBadReadPtr(reinterpret_cast<void*>(mgrRoot + RVA::Selection::kPerPlayerVectorsArray), 8)) {
+    if (!CanReadMem(mgrRoot + RVA::Selection::kPerPlayerVectorsArray, 8)) {
         return false;
     }
     uintptr_t vecArrayBase = *reinterpret_cast<uintptr_t*>(
@@ -2380,7 +3699,7 @@ static bool ResolveSelectionVector(uintptr_t& outVec) {
     int slot = ReadCurrentHumanPlayerSlot();
     if (slot < 0 || slot > 7) return false;
     uintptr_t vec = vecArrayBase + RVA::Selection::kSelectionEntryStride * slot;
-    if (IsBadReadPtr(reinterpret_cast<void*>(vec), RVA::Selection::kSelectionEntryStride)) {
+    if (!CanReadMem(vec, RVA::Selection::kSelectionEntryStride)) {
         return false;
     }
     outVec = vec;
@@ -2398,18 +3717,18 @@ static int Lua_DiagSelection(lua_State* L) {
     uintptr_t globalSlotAddr = g_base + RVA::GameModeRoot_Global;
 
     uintptr_t val_at_global = 0;
-    if (!IsBadReadPtr(reinterpret_cast<void*>(globalSlotAddr), 8)) {
+    if (CanReadMem(globalSlotAddr, 8)) {
         val_at_global = *reinterpret_cast<uintptr_t*>(globalSlotAddr);
     }
 
     uintptr_t val_at_global_plus_18 = 0;
-    if (!IsBadReadPtr(reinterpret_cast<void*>(globalSlotAddr + 0x18), 8)) {
+    if (CanReadMem(globalSlotAddr + 0x18, 8)) {
         val_at_global_plus_18 = *reinterpret_cast<uintptr_t*>(globalSlotAddr + 0x18);
     }
 
     // Two-deref interpretation (the fix): mgrRoot = *(val_at_global + 0x18)
     uintptr_t mgr_twoderef = 0;
-    if (val_at_global && !IsBadReadPtr(reinterpret_cast<void*>(val_at_global + 0x18), 8)) {
+    if (val_at_global && CanReadMem(val_at_global + 0x18, 8)) {
         mgr_twoderef = *reinterpret_cast<uintptr_t*>(val_at_global + 0x18);
     }
 
@@ -2418,10 +3737,10 @@ static int Lua_DiagSelection(lua_State* L) {
 
     // For each, try to read vecArrayBase
     uintptr_t vec_two = 0, vec_one = 0;
-    if (mgr_twoderef && !IsBadReadPtr(reinterpret_cast<void*>(mgr_twoderef + 0x1C0), 8)) {
+    if (mgr_twoderef && CanReadMem(mgr_twoderef + 0x1C0, 8)) {
         vec_two = *reinterpret_cast<uintptr_t*>(mgr_twoderef + 0x1C0);
     }
-    if (mgr_oneDeref && !IsBadReadPtr(reinterpret_cast<void*>(mgr_oneDeref + 0x1C0), 8)) {
+    if (mgr_oneDeref && CanReadMem(mgr_oneDeref + 0x1C0, 8)) {
         vec_one = *reinterpret_cast<uintptr_t*>(mgr_oneDeref + 0x1C0);
     }
 
@@ -2431,7 +3750,7 @@ static int Lua_DiagSelection(lua_State* L) {
     uintptr_t actualVec = 0;
     bool resolved = ResolveSelectionVector(actualVec);
     uintptr_t head = 0;
-    if (actualVec && !IsBadReadPtr(reinterpret_cast<void*>(actualVec + 0x10), 8)) {
+    if (actualVec && CanReadMem(actualVec + 0x10, 8)) {
         head = *reinterpret_cast<uintptr_t*>(actualVec + 0x10);
     }
     uintptr_t sentinel = actualVec + 0x08;
@@ -2451,6 +3770,11 @@ static int Lua_DiagSelection(lua_State* L) {
         (unsigned long long)head,
         (unsigned long long)sentinel,
         (head == sentinel) ? 1 : 0);
+    // 2026-10-14: what every selection reader is served (GetSelection).
+    const SelectionTracker* sel = GetSelection();
+    off = SafeAppendFmt(buf, off, sizeof(buf),
+        " | tracked=%d seq=%u samples=%u changes=%u",
+        sel->count, sel->seq, sel->samples, sel->changes);
 
     fn_pushstring(L, buf);
     return 1;
@@ -2464,12 +3788,12 @@ static int Lua_DiagSelection(lua_State* L) {
 static int WalkSelectionVector(uintptr_t vec, uintptr_t* outObjs, int maxOut) {
     if (!vec || !outObjs || maxOut <= 0) return 0;
     uintptr_t sentinel = vec + RVA::Selection::kVectorSentinel;
-    if (IsBadReadPtr(reinterpret_cast<void*>(vec + RVA::Selection::kVectorHead), 8)) return 0;
+    if (!CanReadMem(vec + RVA::Selection::kVectorHead, 8)) return 0;
     uintptr_t node = *reinterpret_cast<uintptr_t*>(vec + RVA::Selection::kVectorHead);
     if (!node || node == sentinel) return 0;
     int found = 0;
     for (int i = 0; i < RVA::Selection::kMaxSelectionCount && node && node != sentinel; i++) {
-        if (IsBadReadPtr(reinterpret_cast<void*>(node + RVA::Selection::kNodeDataPlus24), 8)) break;
+        if (!CanReadMem(node + RVA::Selection::kNodeDataPlus24, 8)) break;
         uintptr_t dataPlus24 = *reinterpret_cast<uintptr_t*>(
             node + RVA::Selection::kNodeDataPlus24);
         uintptr_t obj = (dataPlus24 == 0)
@@ -2479,12 +3803,46 @@ static int WalkSelectionVector(uintptr_t vec, uintptr_t* outObjs, int maxOut) {
             outObjs[found++] = obj;
             if (found >= maxOut) break;
         }
-        if (IsBadReadPtr(reinterpret_cast<void*>(node + RVA::Selection::kNodeNext), 8)) break;
+        if (!CanReadMem(node + RVA::Selection::kNodeNext, 8)) break;
         node = *reinterpret_cast<uintptr_t*>(node + RVA::Selection::kNodeNext);
     }
     return found;
 }
 
+// 2026-10-14: the one place the selection is walked (selection_tracker.h).
+// Every reader goes through GetSelection, which re-samples at most once per
+// luaD_call tick and publishes EVT_SELECTION when the list changed.
+static_assert(SELECTION_TRACK_MAX == RVA::Selection::kMaxSelectionCount,
+              "tracker holds a full selection walk");
+static SelectionTracker g_selection = {{}, 0, 0, 0, -1, 0, 0, 0, 0};
+
+static const SelectionTracker* SampleSelection(LONGLONG tick, ULONGLONG now) {
+    uintptr_t vec = 0;
+    uintptr_t walked[RVA::Selection::kMaxSelectionCount];
+    uint64_t  objs[RVA::Selection::kMaxSelectionCount];
+    int n = 0;
+    if (ResolveSelectionVector(vec)) {
+        n = WalkSelectionVector(vec, walked, RVA::Selection::kMaxSelectionCount);
+        for (int i = 0; i < n; i++) objs[i] = (uint64_t)walked[i];
+    }
+    if (SelectionTrackerUpdate(&g_selection, (uint64_t)vec, objs, n, tick, now)) {
+        EvtSelection evt;
+        evt.seq = g_selection.seq;
+        evt.count = g_selection.count;
+        evt.first_obj = g_selection.count > 0 ? g_selection.objs[0] : 0;
+        evt.hash = g_selection.hash;
+        WriteEvent(EVT_SELECTION, &evt, sizeof(evt));
+    }
+    return &g_selection;
+}
+
+static const SelectionTracker* GetSelection() {
+    const LONGLONG tick = g_luaDCallTickCounter;
+    const ULONGLONG now = GetTickCount64();
+    if (SelectionTrackerFresh(&g_selection, tick, now)) return &g_selection;
+    return SampleSelection(tick, now);
+}
+
 // Walk the tactical-battle GameObjectManager's linked list of every live
 // unit on the current map. Same doubly-linked-list pattern as the selection
 // walker, but rooted at the GameMode's inner object (verified via IDA
@@ -2495,44 +3853,316 @@ static int WalkSelectionVector(uintptr_t vec, uintptr_t* outObjs, int maxOut) {
 //   first     = *(inner + kObjectListHead)    (0x48)
 //   walk:     node = *(node + kNodeNext);  obj = *(node + 24) - 24
 //
-// Returns the number of obj_addrs written to outObjs (capped at maxOut).
-// Bounded to kMaxTacticalObjects regardless of maxOut to defend against a
-// torn/corrupted list from drain-thread reads.
-static int WalkAllTacticalObjects(uintptr_t* outObjs, int maxOut) {
-    if (!outObjs || maxOut <= 0) return 0;
+// ModeObjectListRoot returns `inner`, or 0 when the chain is not live; it
+// also keys the planet table (planet_table.h) to the galactic session.
+// WalkModeObjectList follows at most capWalk nodes and hands every
+// IsValidObjAddr object to visit(obj), which returns false to stop early.
+// The cap defends against a torn/corrupted list from drain-thread reads.
+static uintptr_t ModeObjectListRoot() {
     uintptr_t globalSlotAddr = g_base + RVA::GameModeRoot_Global;
-    if (IsBadReadPtr(reinterpret_cast<void*>(globalSlotAddr), 8)) return 0;
+    if (!CanReadMem(globalSlotAddr, 8)) return 0;
     uintptr_t globalPtr = *reinterpret_cast<uintptr_t*>(globalSlotAddr);
     if (!globalPtr) return 0;
-    if (IsBadReadPtr(reinterpret_cast<void*>(globalPtr + RVA::Selection::kModeRootIndirection), 8)) return 0;
+    if (!CanReadMem(globalPtr + RVA::Selection::kModeRootIndirection, 8)) return 0;
     uintptr_t inner = *reinterpret_cast<uintptr_t*>(
         globalPtr + RVA::Selection::kModeRootIndirection);
-    if (!inner || IsBadReadPtr(reinterpret_cast<void*>(inner), 0x80)) return 0;
+    if (!inner || !CanReadMem(inner, 0x80)) return 0;
+    return inner;
+}
+
+template <typename Visit>
+static void WalkModeObjectList(int capWalk, Visit&& visit) {
+    const uintptr_t inner = ModeObjectListRoot();
+    if (!inner) return;
 
     uintptr_t sentinel = inner + RVA::Selection::kObjectListSentinel;
-    if (IsBadReadPtr(reinterpret_cast<void*>(inner + RVA::Selection::kObjectListHead), 8)) return 0;
+    if (!CanReadMem(inner + RVA::Selection::kObjectListHead, 8)) return;
     uintptr_t node = *reinterpret_cast<uintptr_t*>(inner + RVA::Selection::kObjectListHead);
-    if (!node || node == sentinel) return 0;
 
+    for (int i = 0; i < capWalk && node && node != sentinel; i++) {
+        if (!CanReadMem(node + RVA::Selection::kNodeDataPlus24, 8)) break;
+        uintptr_t dataPlus24 = *reinterpret_cast<uintptr_t*>(
+            node + RVA::Selection::kNodeDataPlus24);
+        uintptr_t obj = (dataPlus24 == 0)
+            ? 0
+            : (dataPlus24 - RVA::Selection::kNodeDataAdjustment);
+        if (obj && IsValidObjAddr(obj) && !visit(obj)) break;
+        if (!CanReadMem(node + RVA::Selection::kNodeNext, 8)) break;
+        node = *reinterpret_cast<uintptr_t*>(node + RVA::Selection::kNodeNext);
+    }
+}
+
+// Returns the number of obj_addrs written to outObjs (capped at maxOut).
+// Bounded to kMaxTacticalObjects regardless of maxOut.
+static int WalkAllTacticalObjects(uintptr_t* outObjs, int maxOut) {
+    if (!outObjs || maxOut <= 0) return 0;
+    int found = 0;
+    WalkModeObjectList(RVA::Selection::kMaxTacticalObjects, [&](uintptr_t obj) {
+        outObjs[found++] = obj;
+        return found < maxOut;
+    });
+    return found;
+}
+
+// 2026-10-14: native galactic planet walk (rvas.h RVA::Planet). Planets sit
+// on the same mode object list as everything else; the engine's own
+// planet-only getters tell them apart by the 0xFF sentinel at +0x335 and
+// read the rest through the PlanetaryDataPackClass at +0xB8. One pass
+// yields owner, tech, structure count and the destroyed flag, with no Lua
+// table building, Find_All_Objects_Of_Type pcall or per-planet Get_Owner()
+// round trips. Main thread only, like the tactical walk.
+#define PLANET_NAME_MAX SHMEM_PLANETS_NAME_LEN
+
+struct PlanetRow {
+    uintptr_t obj;
+    char      name[PLANET_NAME_MAX];  // type name, NUL-terminated, clipped
+    int32_t   owner;                  // player slot, -1 = neutral
+    int32_t   tech;                   // owner's tech level, 0 when neutral
+    int32_t   buildings;              // persistent tactical structures
+    int8_t    capital;                // 1 / 0, or -1 while RVA::Planet::kCapitalFlag is unknown
+    uint8_t   destroyed;
+};
+
+// Copies a GameObjectType's name (RVA::UnitType::Name, MSVC small-string
+// layout) into out and returns its length; 0 when unreadable.
+static size_t ReadObjectTypeName(uintptr_t type, char* out, size_t cap) {
+    out[0] = 0;
+    if (!type || !CanReadMem(type + RVA::UnitType::Name, RVA::UnitType::NameCapacity - RVA::UnitType::Name + 8))
+        return 0;
+    size_t len = *reinterpret_cast<size_t*>(type + RVA::UnitType::NameSize);
+    size_t strCap = *reinterpret_cast<size_t*>(type + RVA::UnitType::NameCapacity);
+    const char* chars = reinterpret_cast<const char*>(type + RVA::UnitType::Name);
+    if (strCap >= 16) {
+        chars = *reinterpret_cast<const char* const*>(type + RVA::UnitType::Name);
+        if (!chars) return 0;
+    } else if (len > 15) {
+        return 0;  // torn or not a string
+    }
+    if (len >= cap) len = cap - 1;
+    if (len && !CanReadMem(reinterpret_cast<uintptr_t>(chars), len)) return 0;
+    memcpy(out, chars, len);
+    out[len] = 0;
+    return len;
+}
+
+static size_t ReadTypeName(uintptr_t obj, char* out, size_t cap) {
+    return ReadObjectTypeName(*reinterpret_cast<uintptr_t*>(obj + RVA::GameObj::GameObjType), out, cap);
+}
+
+static int WalkGalacticPlanets(PlanetRow* out, int maxOut) {
+    if (!out || maxOut <= 0) return 0;
+    const PlayerTable* players = GetPlayerTable();
     int found = 0;
-    int capWalk = RVA::Selection::kMaxTacticalObjects;
-    for (int i = 0; i < capWalk && node && node != sentinel; i++) {
-        if (IsBadReadPtr(reinterpret_cast<void*>(node + RVA::Selection::kNodeDataPlus24), 8)) break;
-        uintptr_t dataPlus24 = *reinterpret_cast<uintptr_t*>(
-            node + RVA::Selection::kNodeDataPlus24);
-        uintptr_t obj = (dataPlus24 == 0)
-            ? 0
-            : (dataPlus24 - RVA::Selection::kNodeDataAdjustment);
-        if (obj && IsValidObjAddr(obj)) {
-            outObjs[found++] = obj;
-            if (found >= maxOut) break;
+    WalkModeObjectList(RVA::Selection::kMaxModeListWalk, [&](uintptr_t obj) {
+        if (*reinterpret_cast<uint8_t*>(obj + RVA::Planet::kBehaviorSlot) == 0xFF) return true;
+        uintptr_t dp = *reinterpret_cast<uintptr_t*>(obj + RVA::Planet::kDataPack);
+        if (!dp || !CanReadMem(dp, RVA::Planet::kDestroyed + 1)) return true;
+        PlanetRow& r = out[found];
+        r.obj = obj;
+        ReadTypeName(obj, r.name, sizeof(r.name));
+        r.owner = *reinterpret_cast<int32_t*>(dp + RVA::Planet::kOwnerPlayerID);
+        r.tech = 0;
+        if (r.owner >= 0 && r.owner < players->count) {
+            if (const PlayerRow* pr = PlayerTableRow(players, r.owner)) r.tech = pr->tech;
+        } else {
+            r.owner = -1;
         }
-        if (IsBadReadPtr(reinterpret_cast<void*>(node + RVA::Selection::kNodeNext), 8)) break;
-        node = *reinterpret_cast<uintptr_t*>(node + RVA::Selection::kNodeNext);
-    }
+        r.buildings = *reinterpret_cast<int32_t*>(dp + RVA::Planet::kBuiltCount);
+        if (r.buildings < 0) r.buildings = 0;
+        r.capital = RVA::Planet::kCapitalFlag < 0
+            ? (int8_t)-1
+            : (int8_t)(*reinterpret_cast<uint8_t*>(dp + RVA::Planet::kCapitalFlag) ? 1 : 0);
+        r.destroyed = *reinterpret_cast<uint8_t*>(dp + RVA::Planet::kDestroyed) ? 1 : 0;
+        return ++found < maxOut;
+    });
     return found;
 }
 
+static PlanetRow g_planetRows[RVA::Planet::kMaxPlanets];
+static_assert(SHMEM_PLANETS_MAX >= RVA::Planet::kMaxPlanets,
+              "planet table must hold every walked planet");
+
+// 2026-10-14: planet name -> ID table (planet_table.h) for SWFOC_PlanetBatch.
+// Built from one WalkGalacticPlanets pass and kept while the mode object
+// list root -- the galactic session -- stays the same. A table that came up
+// empty (outside galactic mode, or the walk ran before the planets were on
+// the list) is rebuilt on the next call. Main thread only.
+static PlanetTable g_planetIds;
+static_assert(PLANET_TABLE_MAX >= RVA::Planet::kMaxPlanets, "planet ID table must hold every walked planet");
+static_assert(PLANET_TABLE_NAME >= PLANET_NAME_MAX, "planet ID table must hold every walked name");
+
+static const PlanetTable* GetPlanetTable(bool rebuild) {
+    const uintptr_t session = ModeObjectListRoot();
+    if (!rebuild && session && session == g_planetIds.session && g_planetIds.count) return &g_planetIds;
+    PlanetTableBegin(&g_planetIds, session);
+    const int count = session ? WalkGalacticPlanets(g_planetRows, RVA::Planet::kMaxPlanets) : 0;
+    for (int i = 0; i < count; i++) PlanetTableAdd(&g_planetIds, g_planetRows[i].obj, g_planetRows[i].name);
+    return &g_planetIds;
+}
+
+// A resolved planet object still on the list as a planet (a table built
+// for this session can only go stale if the engine reallocated it).
+static bool PlanetObjLive(uint64_t obj) {
+    return obj && IsValidObjAddr((uintptr_t)obj)
+        && *reinterpret_cast<uint8_t*>((uintptr_t)obj + RVA::Planet::kBehaviorSlot) != 0xFF;
+}
+
+// 2026-10-14: per-tick object-type census (type_census.h). One walk of the
+// whole mode list buckets every object by its GameObjectType pointer; each
+// distinct type's name is read and hashed once afterwards. DumpState's
+// object catalog and SWFOC_TypeCensus read exact populations from it
+// instead of one Find_All_Objects_Of_Type per type. Same tick / age reuse
+// as the unit index below. Main thread only.
+#define TYPE_CENSUS_MAX_AGE_MS 100
+#define TYPE_CENSUS_NAME_MAX   64
+
+static TypeCensus g_typeCensus;
+static LONGLONG   g_typeCensusTick = -1;
+static ULONGLONG  g_typeCensusMs = 0;
+
+static const TypeCensus* GetTypeCensus() {
+    const LONGLONG tick = g_luaDCallTickCounter;
+    const ULONGLONG now = GetTickCount64();
+    if (tick == g_typeCensusTick && now - g_typeCensusMs < TYPE_CENSUS_MAX_AGE_MS) return &g_typeCensus;
+
+    TypeCensus* c = &g_typeCensus;
+    TypeCensusReset(c);
+    WalkModeObjectList(RVA::Selection::kMaxModeListWalk, [c](uintptr_t obj) {
+        const uint64_t type = *reinterpret_cast<uint64_t*>(obj + RVA::GameObj::GameObjType);
+        if (type) TypeCensusAdd(c, type);
+        return true;
+    });
+    char name[TYPE_CENSUS_NAME_MAX];
+    for (uint32_t k = 0; k < c->distinct; k++) {
+        const uint16_t i = c->used[k];
+        const size_t len = ReadObjectTypeName((uintptr_t)c->type[i], name, sizeof(name));
+        c->nameHash[i] = len ? TypeCensusNameHash(name, len) : 0;
+    }
+    g_typeCensusTick = tick;
+    g_typeCensusMs = now;
+    return c;
+}
+
+// 2026-10-14: per-tick unit index (unit_index.h). The unit helpers used to
+// walk the tactical list themselves -- EnumerateUnits twice -- and
+// re-validate every object each time. GetTacticalUnitIndex walks once,
+// validates once, resolves the selection into a hash set and serves every
+// caller in the same luaD_call tick. Paused-game drains do not advance the
+// tick, so an index older than UNIT_INDEX_MAX_AGE_MS is rebuilt as well.
+// Main thread only, like the walk itself.
+static_assert(UNIT_INDEX_MAX >= RVA::Selection::kMaxTacticalObjects,
+              "unit index must hold every walked object");
+#define UNIT_INDEX_MAX_AGE_MS 100
+
+static UnitIndex g_unitIndex;
+static LONGLONG  g_unitIndexTick = -1;
+static ULONGLONG g_unitIndexMs = 0;
+// g_unitIndexBuilds (defined with the player table) counts the rebuilds.
+
+static void InvalidateTacticalUnitIndex() {
+    g_unitIndexTick = -1;
+}
+
+static const UnitIndex* GetTacticalUnitIndex() {
+    const LONGLONG tick = g_luaDCallTickCounter;
+    const ULONGLONG now = GetTickCount64();
+    if (tick == g_unitIndexTick && now - g_unitIndexMs < UNIT_INDEX_MAX_AGE_MS) return &g_unitIndex;
+
+    static constexpr int kMax = RVA::Selection::kMaxTacticalObjects;
+    static uintptr_t s_walk[kMax];
+    static uint64_t  s_objs[kMax];
+    static int32_t   s_owner[kMax];
+    const int walked = WalkAllTacticalObjects(s_walk, kMax);
+    int n = 0;
+    for (int i = 0; i < walked; i++) {
+        uintptr_t obj = s_walk[i];
+        if (!IsValidObjAddr(obj)) continue;
+        s_objs[n] = (uint64_t)obj;
+        s_owner[n] = *reinterpret_cast<int32_t*>(obj + RVA::GameObj::OwnerPlayerID);
+        n++;
+    }
+    const SelectionTracker* selection = GetSelection();
+    UnitIndexBuild(&g_unitIndex, s_objs, s_owner, n, selection->objs, n > 0 ? selection->count : 0);
+    g_unitIndexBuilds++;
+    g_unitIndexTick = tick;
+    g_unitIndexMs = now;
+    return &g_unitIndex;
+}
+
+// 2026-10-14: binary mode shared by SWFOC_ListTacticalUnits("bin") and
+// SWFOC_EnumerateUnits(slot, "bin"). Fills g_unitTable (shared_memory.h)
+// with the same columns the CSV rows carry, plus world bounds where known,
+// and pushes "bin count=N seq=S bounds=B". slotFilter < 0 keeps every unit
+// and flags local ownership via IsObjOwnedByHuman, like the
+// ListTacticalUnits CSV; otherwise rows are filtered by owner and local
+// means owner == FindLocalPlayerSlot(), like the EnumerateUnits CSV.
+static_assert(SHMEM_UNITS_MAX >= RVA::Selection::kMaxTacticalObjects,
+              "unit table must hold every walked object");
+
+// World-space center and half-extents of one unit, for the version-2 bounds
+// columns the overlay builds its pick index from and for the spatial grid
+// behind the SWFOC_QueryUnitsIn* range queries. rvas.h pins no GameObj
+// transform or collision-extent offset yet -- the only position RVAs,
+// SetPosition and Transform_Update, are writers -- so this reports no
+// bounds and rows go out without SHM_UNIT_HAS_BOUNDS until that RE lands.
+// The columns, the reply's bounds= count, the grid and the overlay side are
+// in place for it; this is the one function to fill in.
+static bool ReadUnitWorldBounds(uintptr_t obj, float* pos, float* halfExtent) {
+    (void)obj;
+    (void)pos;
+    (void)halfExtent;
+    return false;
+}
+
+static bool IsBinaryUnitMode(lua_State* L, int idx) {
+    if (fn_gettop(L) < idx || fn_type(L, idx) != LUA_TSTRING) return false;
+    const char* mode = fn_tostring(L, idx);
+    return mode && strcmp(mode, "bin") == 0;
+}
+
+static int PushUnitTable(lua_State* L, const UnitIndex* idx, int slotFilter) {
+    if (!g_unitTable) {
+        fn_pushstring(L, "ERR: unit table unavailable");
+        return 1;
+    }
+    const int localSlot = slotFilter >= 0 ? FindLocalPlayerSlot() : -1;
+    const int rows = slotFilter >= 0 ? UnitIndexOwnerCount(idx, slotFilter) : idx->count;
+    const uint16_t* pos = UnitIndexOwnerUnits(idx, slotFilter);
+
+    SharedUnitTable* t = g_unitTable;
+    ShmUnitsBeginWrite(t);
+    uint32_t n = 0;
+    uint32_t bounded = 0;
+    for (int r = 0; r < rows && n < SHMEM_UNITS_MAX; r++) {
+        const int i = slotFilter >= 0 ? pos[r] : r;
+        const uintptr_t obj = (uintptr_t)idx->objs[i];
+        const int32_t owner = idx->owner[i];
+        uint8_t flags = 0;
+        if (*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::InvulnFlag)) flags |= SHM_UNIT_INVULN;
+        if (*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::PreventDeath) & 0x80) flags |= SHM_UNIT_PREVENT_DEATH;
+        if (slotFilter >= 0 ? owner == localSlot : IsObjOwnedByHuman(obj)) flags |= SHM_UNIT_LOCAL_OWNER;
+        if (UnitIndexIsSelected(idx, obj)) flags |= SHM_UNIT_SELECTED;
+        if (ReadUnitWorldBounds(obj, t->pos[n], t->half_extent[n])) {
+            flags |= SHM_UNIT_HAS_BOUNDS;
+            bounded++;
+        }
+        t->obj_addr[n] = (uint64_t)obj;
+        t->owner[n]    = owner;
+        t->hull[n]     = *reinterpret_cast<float*>(obj + RVA::GameObj::HP);
+        t->flags[n]    = flags;
+        n++;
+    }
+    t->count       = n;
+    t->slot_filter = slotFilter < 0 ? -1 : slotFilter;
+    t->tick        = (uint64_t)g_luaDCallTickCounter;
+    const uint32_t seq = ShmUnitsEndWrite(t);
+
+    char reply[64];
+    snprintf(reply, sizeof(reply), "bin count=%u seq=%u bounds=%u", n, seq, bounded);
+    fn_pushstring(L, reply);
+    return 1;
+}
+
 // SWFOC_ListTacticalUnits() -> CSV of per-unit rows, one per '|' separator.
 //
 // Row format (semicolon-separated fields, chosen because '|' separates rows):
@@ -2548,65 +4178,53 @@ static int WalkAllTacticalObjects(uintptr_t* outObjs, int maxOut) {
 //   is_selected is 1 if the obj_addr is present in the current selection vector.
 //
 // Returns "count=0" when the tactical object list is empty or the chain is not
-// live (e.g. main menu / galactic mode). CSV approach chosen over a Lua table
-// because Lua 5.0's table-construction API is not exposed to the bridge.
-// See Task 104 (2026-04-23) for rationale and Task 107 for the V2 consumer.
+// live (e.g. main menu / galactic mode). CSV is the pipe clients' form (Task
+// 104, 2026-04-23; Task 107 for the V2 consumer); in-VM callers use the
+// SWFOC_ListTacticalUnitsT table form below.
+//
+// SWFOC_ListTacticalUnits("bin") writes the rows to the shared unit table
+// instead (PushUnitTable) and returns "bin count=N seq=S bounds=B", never
+// truncated.
 static int Lua_ListTacticalUnits(lua_State* L) {
-    static constexpr int kMax = RVA::Selection::kMaxTacticalObjects;
-    static thread_local uintptr_t s_objs[kMax];
-    int count = WalkAllTacticalObjects(s_objs, kMax);
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    if (IsBinaryUnitMode(L, 1)) return PushUnitTable(L, idx, -1);
+    const int count = idx->count;
     if (count <= 0) {
         fn_pushstring(L, "count=0");
         return 1;
     }
 
-    // Pre-resolve the current selection so we can flag is_selected per row
-    // without walking the selection vector in a nested loop.
-    uintptr_t selVec = 0;
-    uintptr_t selObjs[RVA::Selection::kMaxSelectionCount];
-    int selCount = 0;
-    if (ResolveSelectionVector(selVec)) {
-        selCount = WalkSelectionVector(selVec, selObjs, RVA::Selection::kMaxSelectionCount);
-        if (selCount < 0) selCount = 0;
-    }
-    auto isSelected = [&](uintptr_t obj) {
-        for (int i = 0; i < selCount; i++) if (selObjs[i] == obj) return 1;
-        return 0;
-    };
-
     // Response size: ~96 bytes per row × kMax is ~200 KB worst-case; we cap
     // the emitted string at 64 KB so a single pipe response fits. Callers
     // can paginate via a follow-up helper if needed (Task 104 follow-up).
+    // Below the cap the buffer is sized from the row count.
     constexpr size_t kBufCap = 65536;
-    char* buf = reinterpret_cast<char*>(malloc(kBufCap));
+    const size_t cap = std::min(kBufCap, CsvRowCapacity(32, (size_t)count, CSV_UNIT_ROW_MAX));
+    char* buf = reinterpret_cast<char*>(malloc(cap));
     if (!buf) {
         fn_pushstring(L, "ERR: SWFOC_ListTacticalUnits: alloc failed");
         return 1;
     }
-    size_t off = 0;
-    off = SafeAppendFmt(buf, off, kBufCap, "count=%d", count);
+    CsvRow row;
+    CsvRowInit(&row, buf, cap);
+    CsvRowCount(&row, count);
 
     int emitted = 0;
     for (int i = 0; i < count; i++) {
-        uintptr_t obj = s_objs[i];
-        if (!IsValidObjAddr(obj)) continue;
-        int32_t owner = *reinterpret_cast<int32_t*>(obj + RVA::GameObj::OwnerPlayerID);
+        uintptr_t obj = (uintptr_t)idx->objs[i];
+        int32_t owner = idx->owner[i];
         float   hull  = *reinterpret_cast<float*>(obj + RVA::GameObj::HP);
         uint8_t iflag = *reinterpret_cast<uint8_t*>(obj + RVA::GameObj::InvulnFlag);
         uint8_t pdb   = (*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::PreventDeath) & 0x80) ? 1 : 0;
         int localOwn  = IsObjOwnedByHuman(obj) ? 1 : 0;
-        int selected  = isSelected(obj);
-        off = SafeAppendFmt(
-            buf, off, kBufCap,
-            "|%llu;%d;%.3f;%u;%u;%d;%d",
-            (unsigned long long)obj,
-            (int)owner, hull,
-            (unsigned)iflag, (unsigned)pdb,
-            localOwn, selected);
+        int selected  = UnitIndexIsSelected(idx, obj) ? 1 : 0;
+        CsvRowUnit(&row, (uint64_t)obj, owner, hull, iflag, pdb, localOwn, selected);
         emitted++;
-        if (off >= kBufCap - 128) {
+        if (row.len >= kBufCap - 128) {
             // Truncate: append an "...+N more" marker so callers see the cap hit.
-            SafeAppendFmt(buf, off, kBufCap, "|...+%d_truncated", count - emitted);
+            CsvRowStr(&row, "|...+");
+            CsvRowI64(&row, count - emitted);
+            CsvRowStr(&row, "_truncated");
             break;
         }
     }
@@ -2616,6 +4234,474 @@ static int Lua_ListTacticalUnits(lua_State* L) {
     return 1;
 }
 
+// 2026-10-14: table forms of the list helpers, for story scripts and helper
+// Lua that would otherwise split the CSV with Lua 5.0's string library
+// (lua_table_rows.h). Each *T helper returns an array of records keyed by
+// the CSV's field names and is never truncated; pipe clients keep the CSV
+// and "bin" forms. When the table API did not resolve the reply is an
+// "ERR: ..." string instead.
+static LuaRowsApi BridgeRowsApi() {
+    return {fn_gettop, fn_settop, fn_newtable, fn_pushvalue, fn_pushstring, fn_pushnumber, fn_settable, fn_rawseti};
+}
+
+static bool BeginRowsReply(lua_State* L, LuaRows* rows, const char* const* keys, int nkeys, const char* helper) {
+    const LuaRowsApi api = BridgeRowsApi();
+    if (!LuaRowsApiReady(api) || !LuaRowsBegin(rows, api, L, keys, nkeys)) {
+        char err[96];
+        snprintf(err, sizeof(err), "ERR: %s: Lua table API unavailable", helper);
+        fn_pushstring(L, err);
+        return false;
+    }
+    return true;
+}
+
+enum UnitRowKey {
+    UNIT_KEY_OBJ = 0,
+    UNIT_KEY_OWNER,
+    UNIT_KEY_HULL,
+    UNIT_KEY_INVULN,
+    UNIT_KEY_PREVENT_DEATH,
+    UNIT_KEY_LOCAL,
+    UNIT_KEY_SELECTED,
+    UNIT_ROW_KEYS
+};
+static const char* const kUnitRowKeys[UNIT_ROW_KEYS] = {
+    "obj_addr", "owner_slot", "hull", "invuln_flag", "prevent_death", "is_local_owner", "is_selected",
+};
+
+// One unit record, from the same reads as the CSV row.
+static void AppendUnitRow(LuaRows* rows, const UnitIndex* idx, int i, bool isLocal) {
+    const uintptr_t obj = (uintptr_t)idx->objs[i];
+    LuaRowOpen(rows);
+    LuaRowNumber(rows, UNIT_KEY_OBJ, (double)obj);
+    LuaRowNumber(rows, UNIT_KEY_OWNER, (double)idx->owner[i]);
+    LuaRowNumber(rows, UNIT_KEY_HULL, (double)*reinterpret_cast<float*>(obj + RVA::GameObj::HP));
+    LuaRowNumber(rows, UNIT_KEY_INVULN, (double)*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::InvulnFlag));
+    LuaRowNumber(rows, UNIT_KEY_PREVENT_DEATH,
+                 (*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::PreventDeath) & 0x80) ? 1.0 : 0.0);
+    LuaRowNumber(rows, UNIT_KEY_LOCAL, isLocal ? 1.0 : 0.0);
+    LuaRowNumber(rows, UNIT_KEY_SELECTED, UnitIndexIsSelected(idx, obj) ? 1.0 : 0.0);
+    LuaRowClose(rows);
+}
+
+// SWFOC_ListTacticalUnitsT() -> { {obj_addr=, owner_slot=, hull=,
+// invuln_flag=, prevent_death=, is_local_owner=, is_selected=}, ... }, the
+// rows of SWFOC_ListTacticalUnits; {} outside tactical mode.
+static int Lua_ListTacticalUnitsT(lua_State* L) {
+    LuaRows rows;
+    if (!BeginRowsReply(L, &rows, kUnitRowKeys, UNIT_ROW_KEYS, "SWFOC_ListTacticalUnitsT")) return 1;
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    for (int i = 0; i < idx->count; i++) AppendUnitRow(&rows, idx, i, IsObjOwnedByHuman((uintptr_t)idx->objs[i]));
+    LuaRowsEnd(&rows);
+    return 1;
+}
+
+// 2026-10-14: spatial index over the per-tick unit index (spatial_grid.h),
+// for SWFOC_QueryUnitsInRadius / SWFOC_QueryUnitsInRect. Re-fed from
+// g_unitIndex whenever that is rebuilt; SpatialGridUpdate turns a tick in
+// which no unit changed cell into an in-place position refresh. Only units
+// with known world bounds (ReadUnitWorldBounds) are placed -- the rest are
+// counted in g_spatialUnplaced and reported as unplaced= so a caller can
+// tell "nobody there" from "positions not readable".
+static_assert(SPATIAL_GRID_MAX >= RVA::Selection::kMaxTacticalObjects,
+              "spatial grid must hold every walked object");
+static SpatialGrid g_spatialGrid;
+static uint32_t    g_spatialGridBuild = 0;
+static uint32_t    g_spatialUnplaced = 0;
+
+static const SpatialGrid* GetTacticalSpatialGrid() {
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    if (g_spatialGridBuild == g_unitIndexBuilds) return &g_spatialGrid;
+
+    static uint64_t s_objs[SPATIAL_GRID_MAX];
+    static int32_t  s_owner[SPATIAL_GRID_MAX];
+    static float    s_x[SPATIAL_GRID_MAX];
+    static float    s_y[SPATIAL_GRID_MAX];
+    int n = 0;
+    uint32_t unplaced = 0;
+    for (int i = 0; i < idx->count; i++) {
+        float pos[3], half[3];
+        if (n >= SPATIAL_GRID_MAX || !ReadUnitWorldBounds((uintptr_t)idx->objs[i], pos, half)) {
+            unplaced++;
+            continue;
+        }
+        s_objs[n] = idx->objs[i];
+        s_owner[n] = idx->owner[i];
+        s_x[n] = pos[0];
+        s_y[n] = pos[1];
+        n++;
+    }
+    SpatialGridUpdate(&g_spatialGrid, s_objs, s_owner, s_x, s_y, n);
+    g_spatialUnplaced = unplaced;
+    g_spatialGridBuild = g_unitIndexBuilds;
+    return &g_spatialGrid;
+}
+
+#define SPATIAL_QUERY_DEFAULT_LIMIT 256
+#define SPATIAL_QUERY_MAX_LIMIT     1024  // keeps the reply under 64 KB
+
+static int SpatialQueryLimit(lua_State* L, int idx) {
+    if (fn_gettop(L) < idx || fn_type(L, idx) != LUA_TNUMBER) return SPATIAL_QUERY_DEFAULT_LIMIT;
+    const int limit = (int)fn_tonumber(L, idx);
+    if (limit < 1) return 1;
+    return limit > SPATIAL_QUERY_MAX_LIMIT ? SPATIAL_QUERY_MAX_LIMIT : limit;
+}
+
+// Shared reply: "count=N shown=S placed=P unplaced=U" then one
+// "|obj_addr;owner;x;y" row per shown unit, in grid order.
+static int PushSpatialRows(lua_State* L, const SpatialGrid* g, const uint16_t* hits, int total, int limit) {
+    const int shown = total < limit ? total : limit;
+    char* buf = reinterpret_cast<char*>(malloc(65536));
+    if (!buf) {
+        fn_pushstring(L, "ERR: spatial query: alloc failed");
+        return 1;
+    }
+    size_t off = SafeAppendFmt(buf, 0, 65536, "count=%d shown=%d placed=%u unplaced=%u", total, shown,
+                               g->count, g_spatialUnplaced);
+    for (int k = 0; k < shown; k++) {
+        const uint16_t e = hits[k];
+        off = SafeAppendFmt(buf, off, 65536, "|%llu;%d;%.1f;%.1f", (unsigned long long)g->obj[e], g->owner[e],
+                            g->x[e], g->y[e]);
+    }
+    fn_pushstring(L, buf);
+    free(buf);
+    return 1;
+}
+
+// SWFOC_QueryUnitsInRadius(x, y, radius [, limit]) -> units whose ground
+// position is within radius of (x, y); see PushSpatialRows for the reply.
+// limit defaults to 256 rows (max 1024); count= is always the full total.
+static int Lua_QueryUnitsInRadius(lua_State* L) {
+    const float x = (float)fn_tonumber(L, 1);
+    const float y = (float)fn_tonumber(L, 2);
+    const float r = (float)fn_tonumber(L, 3);
+    const int limit = SpatialQueryLimit(L, 4);
+    const SpatialGrid* g = GetTacticalSpatialGrid();
+    uint16_t hits[SPATIAL_QUERY_MAX_LIMIT];
+    const int total = SpatialGridQueryRadius(g, x, y, r, hits, limit);
+    return PushSpatialRows(L, g, hits, total, limit);
+}
+
+// SWFOC_QueryUnitsInRect(x0, y0, x1, y1 [, limit]) -> units inside the
+// ground rectangle spanned by the two corners; same reply and limit.
+static int Lua_QueryUnitsInRect(lua_State* L) {
+    const float x0 = (float)fn_tonumber(L, 1);
+    const float y0 = (float)fn_tonumber(L, 2);
+    const float x1 = (float)fn_tonumber(L, 3);
+    const float y1 = (float)fn_tonumber(L, 4);
+    const int limit = SpatialQueryLimit(L, 5);
+    const SpatialGrid* g = GetTacticalSpatialGrid();
+    uint16_t hits[SPATIAL_QUERY_MAX_LIMIT];
+    const int total = SpatialGridQueryRect(g, x0, y0, x1, y1, hits, limit);
+    return PushSpatialRows(L, g, hits, total, limit);
+}
+
+// Table form of PushSpatialRows: { {obj_addr=, owner_slot=, x=, y=}, ... }
+// for the shown units, then the full total as a second result.
+static int PushSpatialTable(lua_State* L, const SpatialGrid* g, const uint16_t* hits, int total, int limit,
+                            const char* helper) {
+    static const char* const kKeys[] = {"obj_addr", "owner_slot", "x", "y"};
+    LuaRows rows;
+    if (!BeginRowsReply(L, &rows, kKeys, 4, helper)) return 1;
+    const int shown = total < limit ? total : limit;
+    for (int k = 0; k < shown; k++) {
+        const uint16_t e = hits[k];
+        LuaRowOpen(&rows);
+        LuaRowNumber(&rows, 0, (double)g->obj[e]);
+        LuaRowNumber(&rows, 1, (double)g->owner[e]);
+        LuaRowNumber(&rows, 2, (double)g->x[e]);
+        LuaRowNumber(&rows, 3, (double)g->y[e]);
+        LuaRowClose(&rows);
+    }
+    LuaRowsEnd(&rows);
+    fn_pushnumber(L, (double)total);
+    return 2;
+}
+
+// SWFOC_QueryUnitsInRadiusT(x, y, radius [, limit]) -> units, total.
+static int Lua_QueryUnitsInRadiusT(lua_State* L) {
+    const float x = (float)fn_tonumber(L, 1);
+    const float y = (float)fn_tonumber(L, 2);
+    const float r = (float)fn_tonumber(L, 3);
+    const int limit = SpatialQueryLimit(L, 4);
+    const SpatialGrid* g = GetTacticalSpatialGrid();
+    uint16_t hits[SPATIAL_QUERY_MAX_LIMIT];
+    const int total = SpatialGridQueryRadius(g, x, y, r, hits, limit);
+    return PushSpatialTable(L, g, hits, total, limit, "SWFOC_QueryUnitsInRadiusT");
+}
+
+// SWFOC_QueryUnitsInRectT(x0, y0, x1, y1 [, limit]) -> units, total.
+static int Lua_QueryUnitsInRectT(lua_State* L) {
+    const float x0 = (float)fn_tonumber(L, 1);
+    const float y0 = (float)fn_tonumber(L, 2);
+    const float x1 = (float)fn_tonumber(L, 3);
+    const float y1 = (float)fn_tonumber(L, 4);
+    const int limit = SpatialQueryLimit(L, 5);
+    const SpatialGrid* g = GetTacticalSpatialGrid();
+    uint16_t hits[SPATIAL_QUERY_MAX_LIMIT];
+    const int total = SpatialGridQueryRect(g, x0, y0, x1, y1, hits, limit);
+    return PushSpatialTable(L, g, hits, total, limit, "SWFOC_QueryUnitsInRectT");
+}
+
+// 2026-10-14: EVT_POSITION streaming (position_track.h). Hook_luaD_call
+// samples the tracked units at the configured rate; positions come from
+// ReadUnitWorldBounds, so until that is filled in every live unit counts
+// as unplaced and only keyframe headers go out.
+static PositionTracker g_positionTrack;
+
+static int ReadTrackedPosition(uint64_t obj, float* xyz) {
+    if (!IsValidObjAddr((uintptr_t)obj)) return POS_READ_GONE;
+    float half[3];
+    return ReadUnitWorldBounds((uintptr_t)obj, xyz, half) ? POS_READ_OK : POS_READ_UNPLACED;
+}
+
+static void SamplePositionTrack(ULONGLONG now) {
+    if (g_positionTrack.follow) {
+        const SelectionTracker* selection = GetSelection();
+        if (selection->seq != g_positionTrack.followSeq) {
+            PositionTrackSetUnits(&g_positionTrack, selection->objs, selection->count);
+            g_positionTrack.followSeq = selection->seq;
+        }
+    }
+    static uint8_t record[POSITION_TRACK_RECORD_MAX];
+    const uint32_t size = PositionTrackSample(&g_positionTrack, now, ReadTrackedPosition, record);
+    if (size) WriteEvent(EVT_POSITION, record, (uint16_t)size);
+}
+
+// SWFOC_TrackUnits([units [, hz]]) -> "tracking=N follow=F hz=H seq=S
+// records=R entries=E gone=G events=0|1". units is "selected" (follow the
+// local selection), a comma-separated list of decimal obj_addrs, a single
+// obj_addr number, or "" / "off" to stop; hz defaults to 10 (max 60). With
+// no arguments only the status is returned. Records only reach the ring
+// while SWFOC_EventControl(1) has it enabled.
+static int Lua_TrackUnits(lua_State* L) {
+    PositionTracker* t = &g_positionTrack;
+    if (fn_gettop(L) >= 1) {
+        const int hz = fn_gettop(L) >= 2 ? (int)fn_tonumber(L, 2) : POSITION_TRACK_DEFAULT_HZ;
+        uint64_t objs[POSITION_TRACK_MAX];
+        int n = 0;
+        bool follow = false;
+        if (fn_type(L, 1) == LUA_TNUMBER) {
+            objs[n++] = (uint64_t)fn_tonumber(L, 1);
+        } else if (fn_type(L, 1) == LUA_TSTRING) {
+            const char* spec = fn_tostring(L, 1);
+            if (spec && strcmp(spec, "selected") == 0) {
+                follow = true;
+            } else if (spec && strcmp(spec, "off") != 0) {
+                const char* p = spec;
+                while (*p && n < POSITION_TRACK_MAX) {
+                    char* end = nullptr;
+                    const unsigned long long v = strtoull(p, &end, 10);
+                    if (end == p) break;
+                    objs[n++] = (uint64_t)v;
+                    p = (*end == ',') ? end + 1 : end;
+                }
+            }
+        }
+        PositionTrackReset(t);
+        t->follow = follow;
+        PositionTrackSetUnits(t, objs, n);
+        PositionTrackSetRate(t, t->count > 0 || follow ? hz : 0);
+        if (follow) t->followSeq = GetSelection()->seq - 1;  // adopt on the first sample
+    }
+    const bool events = g_evtBuf && (g_evtBuf->flags.load(std::memory_order_acquire) & 1);
+    char buf[160];
+    SafeAppendFmt(buf, 0, sizeof(buf), "tracking=%d follow=%d hz=%u seq=%u records=%u entries=%u gone=%u events=%d",
+                  t->count, t->follow ? 1 : 0, t->hz, t->seq, t->records, t->entries, t->gone, events ? 1 : 0);
+    fn_pushstring(L, buf);
+    return 1;
+}
+
+// ======================================================================
+// Session timeline recorder (timeline_ring.h)
+// ======================================================================
+// 2026-10-14: SWFOC_Timeline("on") maps a ring file (swfoc_timeline.swfoctl
+// next to the game exe unless a path is given; the previous file is kept as
+// <path>.prev) and starts TimelineWriterProc, the file's only writer. Hooks
+// stage events through TimelineRecordEvent; Hook_luaD_call samples the
+// selection every TIMELINE_SAMPLE_MS and reads a keyframe every
+// TIMELINE_KEYFRAME_MS (SampleTimeline). Start and stop run on the main
+// thread (the helper) or at shutdown. swfoc_replay.exe --timeline loads any
+// point of the file as a ReplayState.
+static TimelineKeySlot g_timelineKey;
+static TimelineWriter g_timelineWriter = {};
+static HANDLE g_timelineFile = INVALID_HANDLE_VALUE;
+static HANDLE g_timelineMap = nullptr;
+static uint8_t* g_timelineView = nullptr;
+static HANDLE g_timelineThread = nullptr;
+static HANDLE g_timelineStop = nullptr;
+static char g_timelinePath[MAX_PATH] = "";
+static uint32_t g_timelineRing = 0;
+static ULONGLONG g_timelineNextSample = 0;
+static ULONGLONG g_timelineNextKey = 0;
+static uint32_t g_timelineSelSeq = 0;
+
+static DWORD WINAPI TimelineWriterProc(LPVOID) {
+    for (;;) {
+        const DWORD r = WaitForSingleObject(g_timelineStop, TIMELINE_FLUSH_MS);
+        // Keyframe first, so every event staged after it was read follows it.
+        TimelineTakeKeyframe(&g_timelineKey, &g_timelineWriter);
+        TimelineDrainStage(&g_timelineStage, &g_timelineWriter, CaptureTimestampMs());
+        if (r != WAIT_TIMEOUT) break;
+    }
+    return 0;
+}
+
+static void CloseTimelineFile() {
+    if (g_timelineView) {
+        FlushViewOfFile(g_timelineView, 0);
+        UnmapViewOfFile(g_timelineView);
+    }
+    if (g_timelineMap) CloseHandle(g_timelineMap);
+    if (g_timelineFile != INVALID_HANDLE_VALUE) CloseHandle(g_timelineFile);
+    g_timelineView = nullptr;
+    g_timelineMap = nullptr;
+    g_timelineFile = INVALID_HANDLE_VALUE;
+    g_timelineWriter = {};
+}
+
+static void StopTimeline() {
+    g_timelineOn.store(false, std::memory_order_release);
+    if (g_timelineThread) {
+        SetEvent(g_timelineStop);
+        WaitForSingleObject(g_timelineThread, 2000);
+        CloseHandle(g_timelineThread);
+        g_timelineThread = nullptr;
+    }
+    if (g_timelineStop) { CloseHandle(g_timelineStop); g_timelineStop = nullptr; }
+    CloseTimelineFile();
+}
+
+// Returns nullptr, or why recording could not start.
+static const char* StartTimeline(const char* path, uint32_t ringBytes) {
+    if (g_timelineThread) return nullptr;
+    if (path && *path) {
+        if (strlen(path) >= MAX_PATH - 8) return "path too long";
+        strcpy(g_timelinePath, path);
+    } else {
+        GetModuleFileNameA(nullptr, g_timelinePath, MAX_PATH - 32);
+        char* slash = strrchr(g_timelinePath, '\\');
+        strcpy(slash ? slash + 1 : g_timelinePath, "swfoc_timeline.swfoctl");
+    }
+    // What led up to the last crash is in the previous file; keep it.
+    char prev[MAX_PATH];
+    snprintf(prev, sizeof(prev), "%s.prev", g_timelinePath);
+    MoveFileExA(g_timelinePath, prev, MOVEFILE_REPLACE_EXISTING);
+
+    const uint64_t size = TIMELINE_HEADER_SIZE + (uint64_t)ringBytes;
+    g_timelineFile = CreateFileA(g_timelinePath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                 nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (g_timelineFile == INVALID_HANDLE_VALUE) return "could not create the timeline file";
+    g_timelineMap = CreateFileMappingA(g_timelineFile, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, nullptr);
+    g_timelineView = g_timelineMap ? static_cast<uint8_t*>(MapViewOfFile(g_timelineMap, FILE_MAP_WRITE, 0, 0, (SIZE_T)size))
+                                   : nullptr;
+    if (!g_timelineView || !TimelineFormat(g_timelineView, size, GetCurrentProcessId(), CaptureTimestampMs(),
+                                           &g_timelineWriter)) {
+        CloseTimelineFile();
+        return "could not map the timeline file";
+    }
+
+    // Nothing stages while g_timelineOn is false, but a hook may still be
+    // finishing a write from the last session; discard never moves backwards.
+    ShmEvtDiscard(&g_timelineStage);
+    g_timelineKey.full.store(0, std::memory_order_relaxed);
+    g_timelineStop = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    g_timelineThread = g_timelineStop ? CreateThread(nullptr, 0, TimelineWriterProc, nullptr, 0, nullptr) : nullptr;
+    if (!g_timelineThread) {
+        StopTimeline();
+        return "could not start the writer thread";
+    }
+    g_timelineRing = ringBytes;
+    g_timelineNextSample = 0;
+    g_timelineNextKey = 0;
+    g_timelineSelSeq = GetSelection()->seq - 1;  // the first sample records the selection
+    g_timelineOn.store(true, std::memory_order_release);
+    Log("[Bridge] Timeline recording to %s (%u KB ring)\n", g_timelinePath, ringBytes >> 10);
+    return nullptr;
+}
+
+// Main thread, from Hook_luaD_call.
+static void SampleTimeline(LONGLONG tick, ULONGLONG now) {
+    g_timelineNextSample = now + TIMELINE_SAMPLE_MS;
+    const SelectionTracker* selection = GetSelection();
+    const uint32_t selected = selection->count <= 0 ? 0
+                            : selection->count > TIMELINE_KEY_SELECTED ? TIMELINE_KEY_SELECTED : (uint32_t)selection->count;
+    if (selection->seq != g_timelineSelSeq) {
+        g_timelineSelSeq = selection->seq;
+        uint8_t rec[8 + TIMELINE_KEY_SELECTED * sizeof(uint64_t)];
+        memcpy(rec, &selection->seq, 4);
+        memcpy(rec + 4, &selected, 4);
+        memcpy(rec + 8, selection->objs, selected * sizeof(uint64_t));
+        TimelineRecordEvent(TIMELINE_REC_SELECTION, rec, (uint16_t)(8 + selected * sizeof(uint64_t)));
+    }
+
+    if (now < g_timelineNextKey) return;
+    g_timelineNextKey = now + TIMELINE_KEYFRAME_MS;
+    TimelineKeySlot* slot = &g_timelineKey;
+    if (slot->full.load(std::memory_order_acquire)) {
+        slot->skipped++;
+        return;
+    }
+    const PlayerTable* players = GetPlayerTable();
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    TimelineKeyBuilder b;
+    TimelineKeyBegin(&b, slot->bytes, players->localSlot, (uint64_t)tick);
+    for (int i = 0; i < players->count; i++) {
+        const PlayerRow& r = players->rows[i];
+        if (r.player) TimelineKeyAddPlayer(&b, i, r.credits, r.tech, r.isHuman != 0, r.isLocal != 0, r.faction);
+    }
+    for (int i = 0; idx && i < idx->count; i++) {
+        const uintptr_t obj = (uintptr_t)idx->objs[i];
+        const uintptr_t typePtr = *reinterpret_cast<uintptr_t*>(obj + RVA::GameObj::GameObjType);
+        if (!TimelineKeyAddUnit(&b, obj, *reinterpret_cast<uint32_t*>(obj + RVA::GameObj::ObjectID), idx->owner[i],
+                                *reinterpret_cast<float*>(obj + RVA::GameObj::HP),
+                                typePtr ? *reinterpret_cast<float*>(typePtr + RVA::UnitType::MaxHull) : 0.0f))
+            break;
+    }
+    TimelineKeySetSelection(&b, selection->seq, selection->objs, (int)selected);
+    slot->size = TimelineKeyFinish(&b);
+    slot->ms = CaptureTimestampMs();
+    slot->built++;
+    slot->full.store(1, std::memory_order_release);
+}
+
+// SWFOC_Timeline([mode [, ring_mb [, path]]]) -> "on=0|1 path=P ring=B
+// used=U records=R keyframes=K dropped=D skipped=S". "on" starts recording
+// into a ring of ring_mb MB (default 32, 1..1024, rounded down to a power
+// of two); "off" stops and flushes the file; no mode, or any other, only
+// reports. "ERR: ..." when the file cannot be set up.
+static int Lua_Timeline(lua_State* L) {
+    const char* mode = fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TSTRING ? fn_tostring(L, 1) : nullptr;
+    if (mode && strcmp(mode, "on") == 0) {
+        double mb = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TNUMBER ? fn_tonumber(L, 2) : 0.0;
+        uint32_t ring = TIMELINE_RING_DEFAULT;
+        if (mb >= 1.0) {
+            const uint64_t want = (uint64_t)(mb > 1024.0 ? 1024.0 : mb) << 20;
+            ring = TIMELINE_RING_MIN;
+            while ((uint64_t)ring * 2 <= want && ring < TIMELINE_RING_MAX) ring *= 2;
+        }
+        const char* path = fn_gettop(L) >= 3 && fn_type(L, 3) == LUA_TSTRING ? fn_tostring(L, 3) : nullptr;
+        if (const char* err = StartTimeline(path, ring)) {
+            char buf[96];
+            SafeAppendFmt(buf, 0, sizeof(buf), "ERR: SWFOC_Timeline: %s", err);
+            fn_pushstring(L, buf);
+            return 1;
+        }
+    } else if (mode && strcmp(mode, "off") == 0) {
+        StopTimeline();
+    }
+    const TimelineFileHeader* h = g_timelineWriter.hdr;
+    char buf[MAX_PATH + 192];
+    SafeAppendFmt(buf, 0, sizeof(buf), "on=%d path=%s ring=%u used=%llu records=%llu keyframes=%llu dropped=%llu skipped=%u",
+                  g_timelineOn.load(std::memory_order_acquire) ? 1 : 0, g_timelinePath[0] ? g_timelinePath : "-",
+                  h ? h->ring_size : 0u,
+                  h ? (unsigned long long)(h->head.load(std::memory_order_acquire) - h->tail.load(std::memory_order_acquire)) : 0ULL,
+                  h ? (unsigned long long)h->records : 0ULL, h ? (unsigned long long)h->keyframes : 0ULL,
+                  h ? (unsigned long long)h->dropped : 0ULL, g_timelineKey.skipped);
+    fn_pushstring(L, buf);
+    return 1;
+}
+
 // SWFOC_GetSelectedUnit() -> number (obj_addr as a 64-bit raw pointer) or 0.
 // Returns the first valid entry in the current human player's selection
 // vector. Zero means "nothing selected" OR "pointer chain not yet live"
@@ -2625,50 +4711,45 @@ static int Lua_ListTacticalUnits(lua_State* L) {
 // 48 bits, double has a 53-bit mantissa). C# side parses it with
 // (ulong)double.
 static int Lua_GetSelectedUnit(lua_State* L) {
-    uintptr_t vec = 0;
-    if (!ResolveSelectionVector(vec)) {
-        fn_pushnumber(L, 0.0);
-        return 1;
-    }
-    uintptr_t obj = 0;
-    int found = WalkSelectionVector(vec, &obj, 1);
-    if (found <= 0) {
-        fn_pushnumber(L, 0.0);
-        return 1;
-    }
-    fn_pushnumber(L, static_cast<double>(obj));
+    const SelectionTracker* selection = GetSelection();
+    fn_pushnumber(L, selection->count > 0 ? static_cast<double>(selection->objs[0]) : 0.0);
     return 1;
 }
 
 // SWFOC_GetSelectedUnits() -> comma-separated decimal obj_addrs, or "".
-// Lua 5.0 doesn't have a stable lua_createtable binding in our API set so
-// we stringify. C# side splits on ',' and parses each as ulong. Empty
+// The string form is for pipe clients (SWFOC_GetSelectedUnitsT returns a
+// table). C# side splits on ',' and parses each as ulong. Empty
 // string means nothing selected. The format uses decimal (not hex with an
 // 0x prefix) so the parser in the editor matches Lua 5.0's only accepted
 // number literal syntax.
 static int Lua_GetSelectedUnits(lua_State* L) {
-    uintptr_t vec = 0;
-    if (!ResolveSelectionVector(vec)) {
-        fn_pushstring(L, "");
-        return 1;
-    }
-    uintptr_t objs[RVA::Selection::kMaxSelectionCount];
-    int count = WalkSelectionVector(vec, objs, RVA::Selection::kMaxSelectionCount);
-    if (count <= 0) {
+    const SelectionTracker* selection = GetSelection();
+    if (selection->count <= 0) {
         fn_pushstring(L, "");
         return 1;
     }
     char buf[2048];
     size_t off = 0;
-    for (int i = 0; i < count; i++) {
+    for (int i = 0; i < selection->count; i++) {
         off = SafeAppendFmt(buf, off, sizeof(buf),
                             i == 0 ? "%llu" : ",%llu",
-                            static_cast<unsigned long long>(objs[i]));
+                            static_cast<unsigned long long>(selection->objs[i]));
     }
     fn_pushstring(L, buf);
     return 1;
 }
 
+// SWFOC_GetSelectedUnitsT() -> { obj_addr, ... }, the selection as an array
+// of numbers ({} when nothing is selected).
+static int Lua_GetSelectedUnitsT(lua_State* L) {
+    LuaRows rows;
+    if (!BeginRowsReply(L, &rows, nullptr, 0, "SWFOC_GetSelectedUnitsT")) return 1;
+    const SelectionTracker* selection = GetSelection();
+    for (int i = 0; i < selection->count; i++) LuaRowsNumber(&rows, static_cast<double>(selection->objs[i]));
+    LuaRowsEnd(&rows);
+    return 1;
+}
+
 // ----------------------------------------------------------------------
 // SetHP combat hook (unified God Mode + One-Hit Kill detour)
 // ----------------------------------------------------------------------
@@ -2685,8 +4766,6 @@ static int Lua_GetSelectedUnits(lua_State* L) {
 typedef void (__fastcall *pfn_SetHP)(void* obj, float new_hp);
 static pfn_SetHP g_real_SetHP = nullptr;
 
-static volatile LONG g_god_mode_enabled = 0;
-static volatile LONG g_ohk_enabled       = 0;
 static CRITICAL_SECTION g_combat_hook_lock;
 static bool g_combat_hook_lock_initialized = false;
 static bool g_combat_hook_installed = false;
@@ -2697,24 +4776,19 @@ static bool g_combat_hook_installed = false;
 // Each SetHP detour invocation appends an event describing the attempted
 // HP transition. SWFOC_EventStreamDrain reads and clears the accumulated
 // buffer, returning a CSV the V2 editor + replay harness consume in the
-// same shape. Fixed-capacity, drop-oldest-on-overflow so the detour stays
-// lock-free on the hot path. A single CriticalSection guards drain so
-// readers see a coherent snapshot.
+// same shape.
+//
+// 2026-10-14: one wait-free single-writer ring per engine thread
+// (damage_ring.h) replaces the shared 256-entry array, which let a burst
+// overwrite slots the drain was still reading. Capacity defaults to
+// DAMAGE_RING_CAP_DEFAULT events per thread and is set with
+// SWFOC_SetEventStreamCapacity. A full ring drops the new event and counts
+// it; the drain only serializes against other drains.
 // ======================================================================
 
-struct DamageEvent {
-    uint64_t timestamp_ms;
-    uint64_t obj_addr;
-    int32_t  owner_slot;
-    float    requested_hp;
-    float    current_hp;
-};
-
-static constexpr int kEventRingSize = 256;
-static DamageEvent g_eventRing[kEventRingSize] = {};
-static volatile LONG g_eventWriteIdx = 0; // monotonic; modulo is the slot
-static volatile LONG g_eventReadIdx  = 0; // monotonic; advances on drain
-static CRITICAL_SECTION g_eventRingLock;
+static DamageRingSet g_damageRings;
+static thread_local int t_damageRing = -2;  // -2 = not claimed yet, -1 = no ring free
+static CRITICAL_SECTION g_eventRingLock;    // drains only; the detour never takes it
 static bool g_eventRingLockInit = false;
 
 static void EnsureEventRingLock() {
@@ -2724,26 +4798,22 @@ static void EnsureEventRingLock() {
     }
 }
 
-// Best-effort push that never blocks the detour. On overflow, oldest
-// events are overwritten -- readers losing the window is strictly better
-// than stalling the game thread. Safe to call before the drain lock is
-// initialised (the initial zeroing of g_eventRing makes every slot a
-// defined-but-stale value).
+// Never blocks the detour: claims this thread's ring on first use, then
+// one copy and a release store.
 static void PushDamageEvent(uint64_t obj_addr, int32_t owner, float requested, float current) {
-    LONG next = InterlockedIncrement(&g_eventWriteIdx);
-    int slot = (next - 1) % kEventRingSize;
-    DamageEvent& slot_ref = g_eventRing[slot];
-    slot_ref.timestamp_ms = 0;
+    if (t_damageRing == -2) t_damageRing = DamageRingClaim(&g_damageRings, (uint32_t)GetCurrentThreadId());
+    DamageEvent ev;
     FILETIME ft;
     GetSystemTimeAsFileTime(&ft);
     ULARGE_INTEGER uli;
     uli.LowPart  = ft.dwLowDateTime;
     uli.HighPart = ft.dwHighDateTime;
-    slot_ref.timestamp_ms = (uli.QuadPart - 116444736000000000ULL) / 10000ULL;
-    slot_ref.obj_addr     = obj_addr;
-    slot_ref.owner_slot   = owner;
-    slot_ref.requested_hp = requested;
-    slot_ref.current_hp   = current;
+    ev.timestamp_ms = (uli.QuadPart - 116444736000000000ULL) / 10000ULL;
+    ev.obj_addr     = obj_addr;
+    ev.owner_slot   = owner;
+    ev.requested_hp = requested;
+    ev.current_hp   = current;
+    DamageRingPush(&g_damageRings, t_damageRing, ev);
 }
 
 static void EnsureCombatHookLock() {
@@ -2754,33 +4824,28 @@ static void EnsureCombatHookLock() {
 }
 
 static void __fastcall Detour_SetHP(void* obj, float new_hp) {
-    // Read the flags once into locals — no lock needed on the hot path
-    // (writers hold g_combat_hook_lock; readers see a coherent byte).
-    LONG god = g_god_mode_enabled;
-    LONG ohk = g_ohk_enabled;
-    uintptr_t objAddr = reinterpret_cast<uintptr_t>(obj);
-    float currentHp = 0.0f;
-    int32_t owner = -1;
-    bool addrOk = IsValidObjAddr(objAddr);
-    if (addrOk) {
-        currentHp = *reinterpret_cast<float*>(objAddr + RVA::GameObj::HP);
-        owner = *reinterpret_cast<int32_t*>(objAddr + RVA::GameObj::OwnerPlayerID);
+    HookCostTimer cost(HOOK_COST_SET_HP);
+    // One relaxed load of the packed modifier word; with nothing SetHP acts
+    // on switched on, forward untouched. Writers hold g_combat_hook_lock.
+    const uint32_t mods = g_combatMods.load(std::memory_order_relaxed);
+    if (!(mods & COMBAT_MODS_SETHP)) {
+        if (g_real_SetHP) cost.original(g_real_SetHP, obj, new_hp);
+        return;
     }
+    const uintptr_t objAddr = reinterpret_cast<uintptr_t>(obj);
+    const bool addrOk = IsValidObjAddr(objAddr);
+    const float currentHp = addrOk ? *reinterpret_cast<float*>(objAddr + RVA::GameObj::HP) : 0.0f;
     // Always log the REQUESTED transition, regardless of whether god/ohk
     // flips the final value. The event stream's job is to witness intent;
     // consumers can diff current_hp vs requested_hp to detect clamping.
-    if (addrOk) PushDamageEvent(objAddr, owner, new_hp, currentHp);
-    if (god || ohk) {
-        bool human = IsObjOwnedByHuman(objAddr);
-        if (god && human) {
-            if (new_hp < currentHp) return;
-        }
-        if (ohk && !human) {
-            new_hp = 0.0f;
-        }
+    if (addrOk && (mods & COMBAT_MOD_DAMAGE_EVENTS)) {
+        const int32_t owner = *reinterpret_cast<int32_t*>(objAddr + RVA::GameObj::OwnerPlayerID);
+        PushDamageEvent(objAddr, owner, new_hp, currentHp);
     }
+    // Ownership is looked up only if god mode sees HP drop or OHK is on.
+    if (!CombatResolveHp(mods, currentHp, &new_hp, [objAddr] { return IsObjOwnedByHuman(objAddr); })) return;
     if (g_real_SetHP) {
-        g_real_SetHP(obj, new_hp);
+        cost.original(g_real_SetHP, obj, new_hp);
     }
 }
 
@@ -2817,6 +4882,8 @@ static void RemoveCombatHook() {
     Log("[Bridge] SetHP combat hook removed\n");
 }
 
+static void ApplyBulkPlan(BulkPlan* plan, BulkResult* out);  // defined after Lua_SetUnitField
+
 // Sweep every live tactical unit and attach/remove the INVULNERABLE behavior
 // on every hardpoint of every human-owned unit. This is the Task 106 wiring
 // that routes God Mode through the Task 99 hardpoint-behavior path — the
@@ -2829,20 +4896,16 @@ static void RemoveCombatHook() {
 // every local hardpoint and does NOT touch enemy units; disable removes
 // immunity from local units only.
 static int SweepLocalUnitsInvulnerable(bool enable) {
-    static constexpr int kMax = RVA::Selection::kMaxTacticalObjects;
-    static thread_local uintptr_t s_objs[kMax];
-    int count = WalkAllTacticalObjects(s_objs, kMax);
-    if (count <= 0) return 0;
-    int flipped = 0;
-    for (int i = 0; i < count; i++) {
-        uintptr_t obj = s_objs[i];
-        if (!IsValidObjAddr(obj)) continue;
-        if (!IsObjOwnedByHuman(obj)) continue;
-        if (CallMakeInvulnerableInline(obj, enable)) flipped++;
-    }
-    Log("[Bridge] SweepLocalUnitsInvulnerable(enable=%d): walked=%d flipped=%d\n",
-        (int)enable, count, flipped);
-    return flipped;
+    BulkPlan plan;
+    BulkParseFilter("local", &plan.filter, nullptr);
+    plan.ops[0].field = BULK_INVULN;
+    plan.ops[0].value = enable ? 1.0f : 0.0f;
+    plan.opCount = 1;
+    static BulkResult s_result;
+    ApplyBulkPlan(&plan, &s_result);
+    Log("[Bridge] SweepLocalUnitsInvulnerable(enable=%d): matched=%d flipped=%d\n",
+        (int)enable, s_result.matched, s_result.applied);
+    return s_result.applied;
 }
 
 // SWFOC_GodMode(enable) -> "OK" or "ERR: ..."
@@ -2859,10 +4922,10 @@ static int Lua_GodMode(lua_State* L) {
     bool ok = true;
     if (enable) {
         if (!InstallCombatHook()) ok = false;
-        InterlockedExchange(&g_god_mode_enabled, 1);
+        CombatModSet(&g_combatMods, COMBAT_MOD_GOD, true);
     } else {
-        InterlockedExchange(&g_god_mode_enabled, 0);
-        if (!g_god_mode_enabled && !g_ohk_enabled) RemoveCombatHook();
+        CombatModSet(&g_combatMods, COMBAT_MOD_GOD, false);
+        if (!CombatModOn(&g_combatMods, COMBAT_MOD_GOD | COMBAT_MOD_OHK)) RemoveCombatHook();
     }
     LeaveCriticalSection(&g_combat_hook_lock);
     // The hardpoint-behavior sweep runs OUTSIDE the hook lock — it walks
@@ -2877,7 +4940,8 @@ static int Lua_GodMode(lua_State* L) {
     }
     Log("[Bridge] GodMode -> %s (god=%d ohk=%d hook=%d sweep_flipped=%d)\n",
         enable ? "ENABLED" : "DISABLED",
-        (int)g_god_mode_enabled, (int)g_ohk_enabled, (int)g_combat_hook_installed,
+        (int)CombatModOn(&g_combatMods, COMBAT_MOD_GOD), (int)CombatModOn(&g_combatMods, COMBAT_MOD_OHK),
+        (int)g_combat_hook_installed,
         flipped);
     char buf[96];
     snprintf(buf, sizeof(buf),
@@ -2902,23 +4966,15 @@ static int Lua_GodMode(lua_State* L) {
 // the next damage tick). Users who want surgical heal should reach for
 // SWFOC_SetUnitHull(obj, target) instead.
 static int Lua_HealAllLocal(lua_State* L) {
-    static constexpr int kMax = RVA::Selection::kMaxTacticalObjects;
-    static thread_local uintptr_t s_objs[kMax];
-    int count = WalkAllTacticalObjects(s_objs, kMax);
-    if (count <= 0) {
-        fn_pushnumber(L, 0.0);
-        return 1;
-    }
-    int healed = 0;
-    for (int i = 0; i < count; i++) {
-        uintptr_t obj = s_objs[i];
-        if (!IsValidObjAddr(obj)) continue;
-        if (!IsObjOwnedByHuman(obj)) continue;
-        *reinterpret_cast<float*>(obj + RVA::GameObj::HP) = 99999.0f;
-        healed++;
-    }
-    Log("[Bridge] HealAllLocal: walked=%d healed=%d\n", count, healed);
-    fn_pushnumber(L, static_cast<double>(healed));
+    BulkPlan plan;
+    BulkParseFilter("local", &plan.filter, nullptr);
+    plan.ops[0].field = BULK_HULL;
+    plan.ops[0].value = 99999.0f;
+    plan.opCount = 1;
+    static BulkResult s_result;
+    ApplyBulkPlan(&plan, &s_result);
+    Log("[Bridge] HealAllLocal: matched=%d healed=%d\n", s_result.matched, s_result.applied);
+    fn_pushnumber(L, static_cast<double>(s_result.applied));
     return 1;
 }
 
@@ -2932,9 +4988,10 @@ static int Lua_HealAllLocal(lua_State* L) {
 //     gracefully returns empty list since parts.Length < 3).
 //   - Engine error: "ERR: <reason>".
 //
-// Strategy (per iter-294 audit + iter-179 helper precedent): use DoString to
-// invoke the engine's `Find_All_Objects_Of_Type` Lua API at category "Planet"
-// (with fallback to "GalacticPlanet" / "Planetary"). Iterate the returned
+// Strategy (per iter-294 audit + iter-179 helper precedent): run a Lua
+// helper (HELPER_GET_PLANETS, precompiled by RegisterAll) that invokes the
+// engine's `Find_All_Objects_Of_Type` Lua API at category "Planet" (with
+// fallback to "GalacticPlanet" / "Planetary"). Iterate the returned
 // table; for each planet, extract Get_Type() + Get_Owner():Get_Faction_Name()
 // + Get_Owner():Get_Tech_Level() via pcall to tolerate per-planet read
 // failures. Defaults: faction='NONE', tech=0 if owner is nil/unowned.
@@ -2944,46 +5001,45 @@ static int Lua_HealAllLocal(lua_State* L) {
 // dispatcher caused silent empty-roster results. Fixed to legacy newline
 // format with tech_level included so the dispatcher parses without changes.
 //
-// Lua 5.0 specifics: no `#table` (uses counter-style iteration);
-// `pcall` available; `table.concat` available; `tostring` available.
+// 2026-10-14: the rows now come from WalkGalacticPlanets first, in the same
+// wire format. The Lua helper only runs when the native walk finds no
+// planet (chain not live, or an engine build whose layout moved).
 static int Lua_GetPlanets(lua_State* L) {
-    static const char* kEnumerateScript =
-        "local cats = { 'Planet', 'GalacticPlanet', 'Planetary' }\n"
-        "local pl = nil\n"
-        "for _, c in pairs(cats) do\n"
-        "  local ok, r = pcall(Find_All_Objects_Of_Type, c)\n"
-        "  if ok and r and type(r) == 'table' then\n"
-        "    pl = r; break\n"
-        "  end\n"
-        "end\n"
-        "if not pl then return '(no_planets)' end\n"
-        "local rows = {}\n"
-        "local n = 0\n"
-        "for i, p in pairs(pl) do\n"
-        "  if p then\n"
-        "    n = n + 1\n"
-        "    local name = '?'\n"
-        "    local faction = 'NONE'\n"
-        "    local tech = 0\n"
-        "    local ok1, nm = pcall(function() return tostring(p:Get_Type()) end)\n"
-        "    if ok1 and nm then name = nm end\n"
-        "    local ok2, ow = pcall(function() return p:Get_Owner() end)\n"
-        "    if ok2 and ow then\n"
-        "      local ok3, fn = pcall(function() return tostring(ow:Get_Faction_Name()) end)\n"
-        "      if ok3 and fn then faction = fn end\n"
-        "      local ok4, tl = pcall(function() return ow:Get_Tech_Level() end)\n"
-        "      if ok4 and type(tl) == 'number' then tech = tl end\n"
-        "    end\n"
-        "    rows[n] = name .. ';' .. faction .. ';' .. tech\n"
-        "  end\n"
-        "end\n"
-        "if n == 0 then return '(no_planets)' end\n"
-        "return table.concat(rows, '\\n')";
-    int rc = DoString(L, kEnumerateScript, "=SWFOC_GetPlanets");
+    const int64_t tw = PipeQpcNow();
+    const int planets = WalkGalacticPlanets(g_planetRows, RVA::Planet::kMaxPlanets);
+    PerfStageSince(PERF_STAGE_LUA_EXEC, tw);
+    if (planets > 0) {
+        constexpr size_t kBufCap = 65536;
+        char* buf = reinterpret_cast<char*>(malloc(kBufCap));
+        if (!buf) {
+            fn_pushstring(L, "ERR: SWFOC_GetPlanets: alloc failed");
+            return 1;
+        }
+        size_t off = 0;
+        buf[0] = 0;
+        for (int i = 0; i < planets; i++) {
+            const PlanetRow& r = g_planetRows[i];
+            off = SafeAppendFmt(buf, off, kBufCap, "%s%s;%s;%d", i ? "\n" : "",
+                                r.name[0] ? r.name : "?",
+                                r.owner >= 0 ? GetFactionName(r.owner) : "NONE", (int)r.tech);
+        }
+        fn_pushstring(L, buf);
+        free(buf);
+        Log("[Bridge] GetPlanets -- native walk returned %d planets\n", planets);
+        return 1;
+    }
+
+    if (!PushHelperScript(L, HELPER_GET_PLANETS)) {
+        fn_pushstring(L, "ERR: SWFOC_GetPlanets helper script failed to compile");
+        return 1;
+    }
+    const int64_t t0 = PipeQpcNow();
+    int rc = fn_pcall(L, 0, 1, 0);
+    PerfStageSince(PERF_STAGE_LUA_EXEC, t0);
     if (rc != 0) {
         fn_settop(L, -2);
         fn_pushstring(L, "ERR: SWFOC_GetPlanets engine error (galactic API likely unavailable)");
-        Log("[Bridge] GetPlanets -- DoString rc=%d (galactic API unavailable?)\n", rc);
+        Log("[Bridge] GetPlanets -- pcall rc=%d (galactic API unavailable?)\n", rc);
         return 1;
     }
     const char* resultStr = fn_tostring(L, -1);
@@ -2993,9 +5049,257 @@ static int Lua_GetPlanets(lua_State* L) {
         Log("[Bridge] GetPlanets -- non-stringable result; returning (no_planets)\n");
         return 1;
     }
-    Log("[Bridge] GetPlanets -- LIVE returned '%.200s%s'\n",
-        resultStr, strlen(resultStr) > 200 ? "..." : "");
-    fn_pushstring(L, resultStr);
+    Log("[Bridge] GetPlanets -- LIVE returned '%.200s%s'\n",
+        resultStr, strlen(resultStr) > 200 ? "..." : "");
+    fn_pushstring(L, resultStr);
+    return 1;
+}
+
+// SWFOC_TypeCensus([limit]) -> "types=N objects=M dropped=D|name;count|..."
+//
+// The per-tick type census (GetTypeCensus): every object on the mode list
+// bucketed by type, largest population first, at most `limit` rows
+// (default and cap 64). One list walk covers every type, for the HUD's
+// unit statistics and any other per-type population query. dropped counts
+// objects whose type did not fit the census table. "types=0 objects=0
+// dropped=0" when no game is loaded.
+#define TYPE_CENSUS_MAX_ROWS 64
+
+static int Lua_TypeCensus(lua_State* L) {
+    int limit = TYPE_CENSUS_MAX_ROWS;
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER) {
+        limit = (int)fn_tonumber(L, 1);
+        if (limit < 0) limit = 0;
+        if (limit > TYPE_CENSUS_MAX_ROWS) limit = TYPE_CENSUS_MAX_ROWS;
+    }
+    const TypeCensus* c = GetTypeCensus();
+    uint16_t top[TYPE_CENSUS_MAX_ROWS];
+    const int rows = TypeCensusTop(c, top, limit);
+
+    char buf[TYPE_CENSUS_MAX_ROWS * (TYPE_CENSUS_NAME_MAX + 16) + 64];
+    size_t off = SafeAppendFmt(buf, 0, sizeof(buf), "types=%u objects=%u dropped=%u",
+                               c->distinct, c->objects, c->dropped);
+    char name[TYPE_CENSUS_NAME_MAX];
+    for (int r = 0; r < rows; r++) {
+        const uint16_t i = top[r];
+        if (!ReadObjectTypeName((uintptr_t)c->type[i], name, sizeof(name))) strcpy(name, "?");
+        off = SafeAppendFmt(buf, off, sizeof(buf), "|%s;%u", name, c->count[i]);
+    }
+    fn_pushstring(L, buf);
+    return 1;
+}
+
+// SWFOC_Unit(obj_addr [, type_name]) -> the engine GameObjectWrapper of
+// exactly that object, or nil.
+//
+// The unit-method wires take a Lua expression; the overlay passes
+// SWFOC_Unit(<handle>, "<type>") instead of Find_First_Object("<type>") so a
+// click acts on the clicked unit, not the first of its type. The first call
+// for an address runs Find_All_Objects_Of_Type(type) (type_name, or the
+// object's own type name when omitted) and keeps the entry whose wrapper
+// points back at obj_addr (RVA::LuaWrapper::GameObject); the binding goes in
+// g_unitHandles (unit_handles.h) and the wrapper in the registry, so later
+// calls are one probe plus one registry read. A binding whose wrapper lost
+// its object, or whose object changed type, is dropped and re-resolved.
+// nil means the unit is gone -- the method call then fails with an engine
+// error rather than acting on a sibling.
+#define UNIT_HANDLE_MAX_SCAN 4096  // Find_All_Objects_Of_Type entries examined
+
+static uint64_t WrapperObject(uintptr_t wrapper) {
+    if (!wrapper || !CanReadMem(wrapper + RVA::LuaWrapper::GameObject, 8)) return 0;
+    return *reinterpret_cast<uint64_t*>(wrapper + RVA::LuaWrapper::GameObject);
+}
+
+// The GameObjectWrapper behind the userdata at idx when it wraps obj, else 0.
+// The userdata block normally holds the wrapper pointer; a wrapper stored
+// inline is accepted too. Either is taken only when its object field equals
+// obj, so a different layout can only miss, never pick another unit.
+static uintptr_t MatchUnitWrapper(lua_State* L, int idx, uintptr_t obj) {
+    const int ty = fn_type(L, idx);
+    if (ty != LUA_TUSERDATA && ty != LUA_TLIGHTUSERDATA) return 0;
+    const uintptr_t block = reinterpret_cast<uintptr_t>(fn_touserdata(L, idx));
+    if (!block || !CanReadMem(block, 8)) return 0;
+    const uintptr_t boxed = *reinterpret_cast<uintptr_t*>(block);
+    if (WrapperObject(boxed) == obj) return boxed;
+    if (WrapperObject(block) == obj) return block;
+    return 0;
+}
+
+static int Lua_Unit(lua_State* L) {
+    if (!fn_touserdata || !fn_pushvalue) {
+        fn_pushnil(L);
+        return 1;
+    }
+    const uintptr_t obj = (uintptr_t)(uint64_t)fn_tonumber(L, 1);
+    if (!IsValidObjAddr(obj)) {
+        fn_pushnil(L);
+        return 1;
+    }
+    const uint64_t type = *reinterpret_cast<uint64_t*>(obj + RVA::GameObj::GameObjType);
+    char key[32];
+
+    UnitHandleEntry* e = UnitHandleFind(&g_unitHandles, (uint64_t)(uintptr_t)L, obj);
+    if (e) {
+        UnitHandleRegistryKey((uint32_t)(e - g_unitHandles.entries), key, sizeof(key));
+        if (UnitHandleStillValid(e, WrapperObject((uintptr_t)e->wrapper), type)) {
+            fn_pushstring(L, key);
+            fn_gettable(L, LUA_REGISTRYINDEX);
+            if (fn_type(L, -1) != LUA_TNIL) {
+                g_unitHandles.hits++;
+                return 1;
+            }
+            fn_settop(L, -2);
+        }
+        g_unitHandles.stale++;
+        fn_pushstring(L, key);
+        fn_pushnil(L);
+        fn_settable(L, LUA_REGISTRYINDEX);
+        UnitHandleDrop(e);
+    }
+
+    char typeName[TYPE_CENSUS_NAME_MAX];
+    const char* arg = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TSTRING ? fn_tostring(L, 2) : nullptr;
+    if (arg && arg[0]) snprintf(typeName, sizeof(typeName), "%s", arg);
+    else if (!ReadTypeName(obj, typeName, sizeof(typeName))) {
+        fn_pushnil(L);
+        return 1;
+    }
+
+    const int top = fn_gettop(L);
+    fn_pushstring(L, "Find_All_Objects_Of_Type");
+    fn_gettable(L, LUA_GLOBALSINDEX);
+    if (fn_type(L, -1) != LUA_TFUNCTION) {
+        fn_settop(L, top);
+        fn_pushnil(L);
+        return 1;
+    }
+    fn_pushstring(L, typeName);
+    if (fn_pcall(L, 1, 1, 0) != 0 || fn_type(L, -1) != LUA_TTABLE) {
+        fn_settop(L, top);
+        fn_pushnil(L);
+        return 1;
+    }
+    const int list = fn_gettop(L);
+    uintptr_t wrapper = 0;
+    for (int i = 1; i <= UNIT_HANDLE_MAX_SCAN && !wrapper; i++) {
+        fn_pushnumber(L, i);
+        fn_gettable(L, list);
+        if (fn_type(L, -1) == LUA_TNIL) break;
+        wrapper = MatchUnitWrapper(L, -1, obj);
+        if (!wrapper) fn_settop(L, -2);
+    }
+    if (!wrapper) {
+        fn_settop(L, top);
+        fn_pushnil(L);
+        Log("[Bridge] SWFOC_Unit(%llu, %s) -- no live wrapper\n", (unsigned long long)obj, typeName);
+        return 1;
+    }
+
+    // Stack: ..., list, wrapper. Keep the wrapper in the slot's registry key.
+    e = UnitHandleBind(&g_unitHandles, (uint64_t)(uintptr_t)L, obj, wrapper, type);
+    UnitHandleRegistryKey((uint32_t)(e - g_unitHandles.entries), key, sizeof(key));
+    fn_pushstring(L, key);
+    fn_pushvalue(L, -2);
+    fn_settable(L, LUA_REGISTRYINDEX);
+    return 1;
+}
+
+// SWFOC_ListPlanets([mode]) -> CSV of per-planet rows, one per '|' separator.
+//
+// Row format (semicolon-separated, as SWFOC_ListTacticalUnits):
+//   obj_addr_decimal;type_name;owner_slot;faction;tech;buildings;capital;destroyed
+//
+// owner_slot is -1 and faction "NONE" for neutral planets; tech is the
+// owner's tech level (0 when neutral); buildings counts the persistent
+// tactical structures; capital is -1 until rvas.h pins the capital flag.
+// Returns "count=0" outside galactic mode.
+//
+// SWFOC_ListPlanets("bin") writes the rows to the shared planet table
+// (shared_memory.h) instead and returns "bin count=N seq=S".
+static int Lua_ListPlanets(lua_State* L) {
+    const int count = WalkGalacticPlanets(g_planetRows, RVA::Planet::kMaxPlanets);
+    if (IsBinaryUnitMode(L, 1)) {
+        if (!g_planetTable) {
+            fn_pushstring(L, "ERR: planet table unavailable");
+            return 1;
+        }
+        const int localSlot = FindLocalPlayerSlot();
+        SharedPlanetTable* t = g_planetTable;
+        ShmPlanetsBeginWrite(t);
+        uint32_t n = 0;
+        for (; n < (uint32_t)count && n < SHMEM_PLANETS_MAX; n++) {
+            const PlanetRow& r = g_planetRows[n];
+            uint8_t flags = 0;
+            if (r.destroyed) flags |= SHM_PLANET_DESTROYED;
+            if (r.capital >= 0) flags |= SHM_PLANET_CAPITAL_KNOWN;
+            if (r.capital > 0) flags |= SHM_PLANET_CAPITAL;
+            if (r.owner >= 0 && r.owner == localSlot) flags |= SHM_PLANET_LOCAL_OWNER;
+            t->obj_addr[n]  = (uint64_t)r.obj;
+            t->owner[n]     = r.owner;
+            t->tech[n]      = r.tech;
+            t->buildings[n] = r.buildings;
+            t->flags[n]     = flags;
+            memcpy(t->name[n], r.name, SHMEM_PLANETS_NAME_LEN);
+        }
+        t->count = n;
+        t->tick  = (uint64_t)g_luaDCallTickCounter;
+        const uint32_t seq = ShmPlanetsEndWrite(t);
+        char reply[48];
+        snprintf(reply, sizeof(reply), "bin count=%u seq=%u", n, seq);
+        fn_pushstring(L, reply);
+        return 1;
+    }
+    if (count <= 0) {
+        fn_pushstring(L, "count=0");
+        return 1;
+    }
+
+    constexpr size_t kBufCap = 65536;
+    char* buf = reinterpret_cast<char*>(malloc(kBufCap));
+    if (!buf) {
+        fn_pushstring(L, "ERR: SWFOC_ListPlanets: alloc failed");
+        return 1;
+    }
+    size_t off = SafeAppendFmt(buf, 0, kBufCap, "count=%d", count);
+    for (int i = 0; i < count; i++) {
+        const PlanetRow& r = g_planetRows[i];
+        off = SafeAppendFmt(buf, off, kBufCap, "|%llu;%s;%d;%s;%d;%d;%d;%u",
+                            (unsigned long long)r.obj, r.name[0] ? r.name : "?", (int)r.owner,
+                            r.owner >= 0 ? GetFactionName(r.owner) : "NONE", (int)r.tech,
+                            (int)r.buildings, (int)r.capital, (unsigned)r.destroyed);
+        if (off >= kBufCap - 192) {
+            SafeAppendFmt(buf, off, kBufCap, "|...+%d_truncated", count - i - 1);
+            break;
+        }
+    }
+    fn_pushstring(L, buf);
+    free(buf);
+    return 1;
+}
+
+// SWFOC_ListPlanetsT() -> { {obj_addr=, type_name=, owner_slot=, faction=,
+// tech=, buildings=, capital=, destroyed=}, ... }, the rows of
+// SWFOC_ListPlanets; {} outside galactic mode.
+static int Lua_ListPlanetsT(lua_State* L) {
+    static const char* const kKeys[] = {"obj_addr", "type_name", "owner_slot", "faction",
+                                        "tech",     "buildings", "capital",    "destroyed"};
+    LuaRows rows;
+    if (!BeginRowsReply(L, &rows, kKeys, 8, "SWFOC_ListPlanetsT")) return 1;
+    const int count = WalkGalacticPlanets(g_planetRows, RVA::Planet::kMaxPlanets);
+    for (int i = 0; i < count; i++) {
+        const PlanetRow& r = g_planetRows[i];
+        LuaRowOpen(&rows);
+        LuaRowNumber(&rows, 0, (double)r.obj);
+        LuaRowString(&rows, 1, r.name[0] ? r.name : "?");
+        LuaRowNumber(&rows, 2, (double)r.owner);
+        LuaRowString(&rows, 3, r.owner >= 0 ? GetFactionName(r.owner) : "NONE");
+        LuaRowNumber(&rows, 4, (double)r.tech);
+        LuaRowNumber(&rows, 5, (double)r.buildings);
+        LuaRowNumber(&rows, 6, (double)r.capital);
+        LuaRowNumber(&rows, 7, (double)r.destroyed);
+        LuaRowClose(&rows);
+    }
+    LuaRowsEnd(&rows);
     return 1;
 }
 
@@ -3006,8 +5310,9 @@ static int Lua_GetPlanets(lua_State* L) {
 // SWFOC_GetFactionRoster(faction_name) -> CSV "<unit_type>;<category>\n..."
 //                                         or "(empty)" / "ERR: ...".
 //
-// Strategy mirrors iter-296 SWFOC_GetPlanets: DoString into the engine's
-// existing Lua API rather than pinning new RVAs.
+// Strategy mirrors iter-296 SWFOC_GetPlanets: a precompiled Lua helper
+// (HELPER_FACTION_ROSTER) over the engine's existing Lua API rather than
+// pinning new RVAs.
 //
 // Approach: iterate Find_All_Objects_Of_Type for each broad category
 // ('GroundCompany', 'Hero', 'SpaceUnit') and filter by Get_Owner():
@@ -3027,55 +5332,20 @@ static int Lua_GetFactionRoster(lua_State* L) {
         fn_pushstring(L, "ERR: faction name required (arg #1 missing or empty)");
         return 1;
     }
-    // Build a Lua script that filters Find_All_Objects_Of_Type by faction.
-    // Embed the faction name literally; sanitize quotes to prevent injection
-    // (engine names should never contain quotes but we defend anyway).
-    char sanitized[256];
-    int j = 0;
-    for (int i = 0; factionName[i] && j < 250; ++i) {
-        char c = factionName[i];
-        if (c == '\'' || c == '\\' || c == '\n' || c == '\r') continue;
-        sanitized[j++] = c;
+    // The name goes in as the helper's argument, so no quoting or
+    // injection concerns; it is only clipped for the log lines.
+    if (!PushHelperScript(L, HELPER_FACTION_ROSTER)) {
+        fn_pushstring(L, "ERR: SWFOC_GetFactionRoster helper script failed to compile");
+        return 1;
     }
-    sanitized[j] = '\0';
-
-    char script[2048];
-    snprintf(script, sizeof(script),
-        "local cats = { 'GroundCompany', 'Hero', 'SpaceUnit', 'Infantry', 'Vehicle' }\n"
-        "local target = '%s'\n"
-        "local rows = {}\n"
-        "local n = 0\n"
-        "for _, c in pairs(cats) do\n"
-        "  local ok, list = pcall(Find_All_Objects_Of_Type, c)\n"
-        "  if ok and list and type(list) == 'table' then\n"
-        "    for _, u in pairs(list) do\n"
-        "      if u then\n"
-        "        local fac = '?'\n"
-        "        local ok1, ow = pcall(function() return u:Get_Owner() end)\n"
-        "        if ok1 and ow then\n"
-        "          local ok2, fn = pcall(function() return tostring(ow:Get_Faction_Name()) end)\n"
-        "          if ok2 and fn then fac = fn end\n"
-        "        end\n"
-        "        if fac == target then\n"
-        "          local name = '?'\n"
-        "          local ok3, nm = pcall(function() return tostring(u:Get_Type()) end)\n"
-        "          if ok3 and nm then name = nm end\n"
-        "          n = n + 1\n"
-        "          rows[n] = name .. ';' .. c\n"
-        "        end\n"
-        "      end\n"
-        "    end\n"
-        "  end\n"
-        "end\n"
-        "if n == 0 then return '(empty)' end\n"
-        "return table.concat(rows, '\\n')",
-        sanitized);
-
-    int rc = DoString(L, script, "=SWFOC_GetFactionRoster");
+    fn_pushstring(L, factionName);
+    const int64_t t0 = PipeQpcNow();
+    int rc = fn_pcall(L, 1, 1, 0);
+    PerfStageSince(PERF_STAGE_LUA_EXEC, t0);
     if (rc != 0) {
         fn_settop(L, -2);
         fn_pushstring(L, "ERR: SWFOC_GetFactionRoster engine error (Find_All_Objects_Of_Type unavailable?)");
-        Log("[Bridge] GetFactionRoster -- DoString rc=%d for faction='%s'\n", rc, sanitized);
+        Log("[Bridge] GetFactionRoster -- pcall rc=%d for faction='%.64s'\n", rc, factionName);
         return 1;
     }
     const char* resultStr = fn_tostring(L, -1);
@@ -3085,93 +5355,149 @@ static int Lua_GetFactionRoster(lua_State* L) {
         Log("[Bridge] GetFactionRoster -- non-stringable result; returning (empty)\n");
         return 1;
     }
-    Log("[Bridge] GetFactionRoster('%s') -- LIVE returned '%.200s%s'\n",
-        sanitized, resultStr, strlen(resultStr) > 200 ? "..." : "");
+    Log("[Bridge] GetFactionRoster('%.64s') -- LIVE returned '%.200s%s'\n",
+        factionName, resultStr, strlen(resultStr) > 200 ? "..." : "");
     fn_pushstring(L, resultStr);
     return 1;
 }
 
-// SWFOC_GetCurrentMod() -> "<mod_name>;<version>\n<mod_path>" or "vanilla" / "ERR: ...".
-//
-// Strategy: filesystem-based detection (no engine Lua API available for
-// "what mod did the operator launch with?"). Walks process working dir's
-// ./Mods/ subfolder looking for any directory containing a Modinfo.xml.
-// If exactly one mod folder has been recently accessed (mtime within
-// last hour of game launch), that's the active mod. If multiple match,
-// returns the alphabetically first (operator can disambiguate via the
-// returned mod_path — see below).
-//
-// Output format:
-//   "<mod_name>;<version>\n<absolute_mod_path>"
-// Or:
-//   "vanilla"        (no Mods/ folder, or no recently-accessed mod)
-//   "ERR: ..."       (filesystem error)
-//
-// iter-300 will extend this with SWFOC_ListMods() for full enumeration
-// (operator picks via Settings UI). iter-299 ships the simpler
-// "what's loaded right now" probe to satisfy the iter-294 mandate.
-//
-// Sidecar-additive note: this wire READS only. Never writes to disk.
-static int Lua_GetCurrentMod(lua_State* L) {
-    char modsDir[MAX_PATH];
-    DWORD len = GetCurrentDirectoryA(MAX_PATH - 16, modsDir);
-    if (len == 0 || len > MAX_PATH - 16) {
-        fn_pushstring(L, "ERR: GetCurrentDirectory failed");
-        return 1;
-    }
-    strcat_s(modsDir, sizeof(modsDir), "\\Mods\\*");
-
-    WIN32_FIND_DATAA findData;
-    HANDLE hFind = FindFirstFileA(modsDir, &findData);
-    if (hFind == INVALID_HANDLE_VALUE) {
-        fn_pushstring(L, "vanilla");
-        Log("[Bridge] GetCurrentMod -- no Mods/ folder; reporting vanilla\n");
-        return 1;
-    }
+// 2026-10-14: ./Mods discovery (mod_catalog.h). ModWatchThreadProc scans
+// at startup, on change notifications under Mods\ and every
+// MOD_WATCH_RESCAN_MS; the two helpers below answer from g_modCatalog and
+// never touch the filesystem on the game thread once the first scan is in.
+static ModCatalog g_modCatalog;
+static HANDLE g_modWatchThread = nullptr;
+static HANDLE g_modWatchStop = nullptr;
 
-    char latestModName[260] = {0};
-    char latestModPath[MAX_PATH] = {0};
-    FILETIME latestAccess = {0};
-    bool found = false;
+// Every folder under <cwd>\Mods holding a Modinfo.xml, in FindNextFile
+// order. False when the working directory cannot be read.
+static bool ScanModFolders(std::vector<ModEntry>* mods) {
+    mods->clear();
+    char cwd[MAX_PATH];
+    DWORD len = GetCurrentDirectoryA(MAX_PATH - 16, cwd);
+    if (len == 0 || len > MAX_PATH - 16) return false;
+    char pattern[MAX_PATH];
+    snprintf(pattern, sizeof(pattern), "%s\\Mods\\*", cwd);
 
+    WIN32_FIND_DATAA findData;
+    HANDLE hFind = FindFirstFileA(pattern, &findData);
+    if (hFind == INVALID_HANDLE_VALUE) return true;  // no Mods/ folder: vanilla
     do {
         if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) continue;
         if (findData.cFileName[0] == '.') continue;
 
         // Probe for Modinfo.xml inside this candidate folder.
         char modinfoPath[MAX_PATH];
-        char cwdOnly[MAX_PATH];
-        GetCurrentDirectoryA(MAX_PATH, cwdOnly);
-        snprintf(modinfoPath, sizeof(modinfoPath), "%s\\Mods\\%s\\Modinfo.xml",
-                 cwdOnly, findData.cFileName);
-
+        snprintf(modinfoPath, sizeof(modinfoPath), "%s\\Mods\\%s\\Modinfo.xml", cwd, findData.cFileName);
         WIN32_FILE_ATTRIBUTE_DATA attrData;
         if (!GetFileAttributesExA(modinfoPath, GetFileExInfoStandard, &attrData)) continue;
 
-        // Track most-recently-accessed mod folder. Game touches it on launch.
-        if (!found || CompareFileTime(&attrData.ftLastAccessTime, &latestAccess) > 0) {
-            found = true;
-            latestAccess = attrData.ftLastAccessTime;
-            strcpy_s(latestModName, sizeof(latestModName), findData.cFileName);
-            snprintf(latestModPath, sizeof(latestModPath), "%s\\Mods\\%s",
-                     cwdOnly, findData.cFileName);
-        }
+        char absModPath[MAX_PATH];
+        snprintf(absModPath, sizeof(absModPath), "%s\\Mods\\%s", cwd, findData.cFileName);
+        ModEntry m;
+        m.name = findData.cFileName;
+        m.path = absModPath;
+        // The game touches the active mod's Modinfo.xml on launch.
+        m.lastAccess = ((uint64_t)attrData.ftLastAccessTime.dwHighDateTime << 32)
+                       | attrData.ftLastAccessTime.dwLowDateTime;
+        mods->push_back(std::move(m));
     } while (FindNextFileA(hFind, &findData));
     FindClose(hFind);
+    return true;
+}
 
-    if (!found) {
-        fn_pushstring(L, "vanilla");
-        Log("[Bridge] GetCurrentMod -- no valid Mods/* with Modinfo.xml; reporting vanilla\n");
-        return 1;
+static void RescanModCatalog() {
+    std::vector<ModEntry> mods;
+    const bool ok = ScanModFolders(&mods);
+    ModCatalogPublish(&g_modCatalog, mods, !ok);
+    LogDebug("[Bridge] Mod scan #%u: %d mod(s)%s\n", g_modCatalog.scans, (int)mods.size(),
+             ok ? "" : " (GetCurrentDirectory failed)");
+}
+
+// Change notification on <cwd>\Mods and everything below it, or
+// INVALID_HANDLE_VALUE when the folder is missing.
+static HANDLE OpenModsWatch() {
+    char dir[MAX_PATH];
+    DWORD len = GetCurrentDirectoryA(MAX_PATH - 16, dir);
+    if (len == 0 || len > MAX_PATH - 16) return INVALID_HANDLE_VALUE;
+    strcat_s(dir, sizeof(dir), "\\Mods");
+    return FindFirstChangeNotificationA(dir, TRUE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+}
+
+static DWORD WINAPI ModWatchThreadProc(LPVOID) {
+    HANDLE change = INVALID_HANDLE_VALUE;
+    for (;;) {
+        // Watch before scanning so a change during the scan is not lost.
+        if (change == INVALID_HANDLE_VALUE) change = OpenModsWatch();
+        RescanModCatalog();
+        HANDLE waits[2] = {g_modWatchStop, change};
+        const DWORD n = change != INVALID_HANDLE_VALUE ? 2 : 1;
+        DWORD r = WaitForMultipleObjects(n, waits, FALSE, MOD_WATCH_RESCAN_MS);
+        // Let a burst (a mod being copied in) settle into one rescan.
+        while (r == WAIT_OBJECT_0 + 1) {
+            if (!FindNextChangeNotification(change)) {
+                FindCloseChangeNotification(change);
+                change = INVALID_HANDLE_VALUE;
+                break;
+            }
+            r = WaitForMultipleObjects(2, waits, FALSE, MOD_WATCH_SETTLE_MS);
+        }
+        if (r == WAIT_OBJECT_0 || r == WAIT_FAILED) break;
+    }
+    if (change != INVALID_HANDLE_VALUE) FindCloseChangeNotification(change);
+    return 0;
+}
+
+static void StartModWatch() {
+    g_modWatchStop = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!g_modWatchStop) return;
+    g_modWatchThread = CreateThread(nullptr, 0, ModWatchThreadProc, nullptr, 0, nullptr);
+    if (!g_modWatchThread) Log("[Bridge] WARNING: mod watcher thread failed (%lu); mods scan on demand\n", GetLastError());
+}
+
+static void StopModWatch() {
+    if (g_modWatchThread) {
+        SetEvent(g_modWatchStop);
+        WaitForSingleObject(g_modWatchThread, 2000);
+        CloseHandle(g_modWatchThread);
+        g_modWatchThread = nullptr;
     }
+    if (g_modWatchStop) { CloseHandle(g_modWatchStop); g_modWatchStop = nullptr; }
+}
+
+// The published replies; scans here first if the watcher has not published
+// yet (or never started).
+static void ReadModCatalog(std::string* list, std::string* current, std::string* currentName) {
+    if (ModCatalogRead(&g_modCatalog, list, current, currentName)) return;
+    RescanModCatalog();
+    ModCatalogRead(&g_modCatalog, list, current, currentName);
+}
 
-    // Iter-299 ships mod_name + path. Version field is a placeholder until
-    // we parse Modinfo.xml; XML parsing in C++ adds a dependency we want
-    // to defer. Operators can read the path and inspect Modinfo.xml directly.
-    char result[MAX_PATH + 64];
-    snprintf(result, sizeof(result), "%s;unknown\n%s", latestModName, latestModPath);
-    Log("[Bridge] GetCurrentMod -- LIVE returned '%s'\n", result);
-    fn_pushstring(L, result);
+// SWFOC_GetCurrentMod() -> "<mod_name>;<version>\n<mod_path>" or "vanilla" / "ERR: ...".
+//
+// Strategy: filesystem-based detection (no engine Lua API available for
+// "what mod did the operator launch with?"). Looks in the process working
+// dir's ./Mods/ subfolder for directories containing a Modinfo.xml and
+// reports the one whose Modinfo.xml was accessed most recently (the game
+// touches it on launch); on a tie the first one found.
+//
+// Output format:
+//   "<mod_name>;<version>\n<absolute_mod_path>"
+// Or:
+//   "vanilla"        (no Mods/ folder, or no folder with a Modinfo.xml)
+//   "ERR: ..."       (filesystem error)
+//
+// Version is a placeholder ("unknown") until we parse Modinfo.xml; XML
+// parsing in C++ adds a dependency we want to defer. Operators can read
+// the path and inspect Modinfo.xml directly. Served from g_modCatalog.
+//
+// Sidecar-additive note: this wire READS only. Never writes to disk.
+static int Lua_GetCurrentMod(lua_State* L) {
+    std::string current, name;
+    ReadModCatalog(nullptr, &current, &name);
+    if (!name.empty()) NoteCurrentModForTypeCache(name.c_str());
+    fn_pushstring(L, current.c_str());
     return 1;
 }
 
@@ -3179,9 +5505,8 @@ static int Lua_GetCurrentMod(lua_State* L) {
 //                    or "(no_mods)" / "ERR: ...".
 //
 // Iter-300 (2026-05-07; 300th-iter milestone): enumerate ALL mods candidate
-// folders under ./Mods/* that contain a Modinfo.xml. Mirrors iter-299
-// Lua_GetCurrentMod's filesystem walk shape, but emits every match instead
-// of picking the most-recently-accessed one.
+// folders under ./Mods/* that contain a Modinfo.xml — the same scan as
+// GetCurrentMod, emitting every match instead of picking one.
 //
 // Output format (consumer convention matches iter-296 GetPlanets):
 //   <mod_name1>;<absolute_path1>
@@ -3190,6 +5515,7 @@ static int Lua_GetCurrentMod(lua_State* L) {
 //
 // Sentinels: "(no_mods)" when ./Mods/ exists but contains no Modinfo.xml,
 // or when ./Mods/ doesn't exist at all (covers vanilla SWFOC install).
+// The reply is capped at ~16KB; past that the tail is dropped.
 //
 // Operator workflow (per iter-294 Audit B mandate):
 //   1. Settings tab calls SWFOC_ListMods → DataGrid shows all mods
@@ -3197,79 +5523,11 @@ static int Lua_GetCurrentMod(lua_State* L) {
 //      whether that mod is the one currently loaded
 //   3. "Open Mods folder" button (operator-side) opens ./Mods in Explorer
 //
-// Sidecar-additive note: this wire READS only. Never writes to disk.
+// Served from g_modCatalog. Sidecar-additive note: this wire READS only.
 static int Lua_ListMods(lua_State* L) {
-    char modsDir[MAX_PATH];
-    DWORD len = GetCurrentDirectoryA(MAX_PATH - 16, modsDir);
-    if (len == 0 || len > MAX_PATH - 16) {
-        fn_pushstring(L, "ERR: GetCurrentDirectory failed");
-        return 1;
-    }
-    char cwdOnly[MAX_PATH];
-    strcpy_s(cwdOnly, sizeof(cwdOnly), modsDir);
-    strcat_s(modsDir, sizeof(modsDir), "\\Mods\\*");
-
-    WIN32_FIND_DATAA findData;
-    HANDLE hFind = FindFirstFileA(modsDir, &findData);
-    if (hFind == INVALID_HANDLE_VALUE) {
-        fn_pushstring(L, "(no_mods)");
-        Log("[Bridge] ListMods -- no Mods/ folder; reporting (no_mods)\n");
-        return 1;
-    }
-
-    // Buffer caps the response at ~16KB which is plenty for any reasonable
-    // operator's mod collection. If they have >100 mods, the tail is
-    // silently truncated (logged); operator can pivot to filesystem
-    // exploration via the "Open Mods folder" button as fallback.
-    char result[16384] = {0};
-    size_t resultLen = 0;
-    int modCount = 0;
-
-    do {
-        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) continue;
-        if (findData.cFileName[0] == '.') continue;
-
-        // Probe for Modinfo.xml inside this candidate folder.
-        char modinfoPath[MAX_PATH];
-        snprintf(modinfoPath, sizeof(modinfoPath), "%s\\Mods\\%s\\Modinfo.xml",
-                 cwdOnly, findData.cFileName);
-
-        WIN32_FILE_ATTRIBUTE_DATA attrData;
-        if (!GetFileAttributesExA(modinfoPath, GetFileExInfoStandard, &attrData)) continue;
-
-        char absModPath[MAX_PATH];
-        snprintf(absModPath, sizeof(absModPath), "%s\\Mods\\%s",
-                 cwdOnly, findData.cFileName);
-
-        char row[MAX_PATH + 260];
-        int rowLen = snprintf(row, sizeof(row), "%s%s;%s",
-            modCount == 0 ? "" : "\n",
-            findData.cFileName, absModPath);
-        // snprintf returns the size that WOULD have been written (excl. NUL).
-        // Clamp before use as memcpy length so a truncated row can never drive
-        // an out-of-bounds copy (CWE-787). Negative return = encoding error.
-        if (rowLen < 0) continue;
-        if (static_cast<size_t>(rowLen) >= sizeof(row)) rowLen = static_cast<int>(sizeof(row) - 1);
-
-        if (resultLen + rowLen + 1 >= sizeof(result)) {
-            Log("[Bridge] ListMods -- result buffer full at %d mods; truncating\n", modCount);
-            break;
-        }
-        memcpy(result + resultLen, row, static_cast<size_t>(rowLen));
-        resultLen += rowLen;
-        result[resultLen] = '\0';
-        modCount++;
-    } while (FindNextFileA(hFind, &findData));
-    FindClose(hFind);
-
-    if (modCount == 0) {
-        fn_pushstring(L, "(no_mods)");
-        Log("[Bridge] ListMods -- no valid Mods/* with Modinfo.xml; reporting (no_mods)\n");
-        return 1;
-    }
-    Log("[Bridge] ListMods -- LIVE returned %d mod(s); first row: '%.200s%s'\n",
-        modCount, result, resultLen > 200 ? "..." : "");
-    fn_pushstring(L, result);
+    std::string list;
+    ReadModCatalog(&list, nullptr, nullptr);
+    fn_pushstring(L, list.c_str());
     return 1;
 }
 
@@ -3277,9 +5535,25 @@ static int Lua_ListMods(lua_State* L) {
 // Task 142 (2026-04-23) Phase 1. Parameters and response shape match the
 // replay mirror. Live path invokes `Planet:Change_Owner(slot)` through
 // SWFOC_DoString once the engine's galactic API is verified -- for now
-// we just store the requested change in a module-local map so the UI
-// round-trip works against the replay probe suite.
-static std::unordered_map<std::string, int32_t> g_pendingPlanetOwnerWrites;
+// we just journal the requested change so the UI round-trip works against
+// the replay probe suite.
+//
+// The Phase 1 helpers below all record through PendingQueue: one journal
+// push, applied on the next drain pass. On a refused write it pushes the
+// ERR string and returns false.
+static bool PendingQueue(lua_State* L, const char* fn, const PendingWrite& w) {
+    const PendingPushResult r = PendingJournalPush(&g_pendingJournal, w);
+    if (r == PENDING_PUSH_OK) return true;
+    char msg[128];
+    _snprintf_s(msg, sizeof(msg), _TRUNCATE, "ERR: %s: %s", fn,
+        r == PENDING_PUSH_BAD_SLOT ? "slot must be 0..15"
+        : r == PENDING_PUSH_BAD_NAME ? "name too long"
+        : "pending journal full, retry next tick");
+    if (r == PENDING_PUSH_FULL) Log("[Bridge] %s: pending journal full, write dropped\n", fn);
+    fn_pushstring(L, msg);
+    return false;
+}
+// Planet lock is still used by the multi-string Phase 1 queue below.
 static CRITICAL_SECTION g_planetLock;
 static bool g_planetLockInit = false;
 static void EnsurePlanetLock() {
@@ -3290,15 +5564,12 @@ static void EnsurePlanetLock() {
 }
 
 // SWFOC_SetIncomeMultiplier / SetGameSpeed / FreezeCredits.
-// Tasks 122/123/127 Phase 1. All three use module-local pending maps
-// under shared CriticalSections. Phase 2 wires hooks once IDA pins:
+// Tasks 122/123/127 Phase 1. All three journal their intent through
+// PendingQueue. Phase 2 wires hooks once IDA pins:
 //   - income-delta apply function (candidates: xrefs from PlayerList_GetCurrentPlayer)
 //   - SimulationRate global (searched 2026-04-23, no direct string hit)
 //   - credits-field apply site (shares path with Give_Money hits)
-static std::unordered_map<int32_t, float>  g_pendingIncomeMult;
-static std::unordered_map<int32_t, double> g_pendingFrozenCredits;
-static std::unordered_map<int32_t, bool>   g_pendingFreezeEnable;
-static float                               g_pendingGameSpeed = 1.0f;
+// Still guards the variable-length spawn-request queue (SpawnUnit).
 static CRITICAL_SECTION g_economyLock;
 static bool g_economyLockInit = false;
 static void EnsureEconomyLock() {
@@ -3308,20 +5579,17 @@ static void EnsureEconomyLock() {
     }
 }
 
-static std::unordered_map<int32_t, float> g_pendingBuildSpeedMult;
-static std::unordered_map<int32_t, float> g_pendingFactionSpeedMult;
-
 static int Lua_SetBuildSpeed(lua_State* L) {
-    EnsureEconomyLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     double mult = fn_tonumber(L, 2);
     if (mult < 0.0) {
         fn_pushstring(L, "ERR: SWFOC_SetBuildSpeed: multiplier must be >= 0");
         return 1;
     }
-    EnterCriticalSection(&g_economyLock);
-    g_pendingBuildSpeedMult[slot] = static_cast<float>(mult);
-    LeaveCriticalSection(&g_economyLock);
+    if (!SlotModSet(&g_slotMods, slot, SLOT_MOD_BUILD_SPEED, static_cast<float>(mult))) {
+        fn_pushstring(L, "ERR: SWFOC_SetBuildSpeed: slot must be 0..15");
+        return 1;
+    }
     Log("[Bridge] SetBuildSpeed(slot=%d, mult=%.3f) -- Phase 1 pending\n", slot, mult);
     fn_pushstring(L, "OK: build speed recorded (Phase 2 hook pending)");
     return 1;
@@ -3365,14 +5633,13 @@ static float ReadEngineSpeedOverride(uintptr_t addr) {
     if (!IsValidObjAddr(addr)) return -1.0f;
     uintptr_t inner = *reinterpret_cast<uintptr_t*>(addr + 0xA8);
     if (!inner) return -1.0f;
-    if (IsBadReadPtr(reinterpret_cast<void*>(inner + 0x2A4), 1)) return -1.0f;
+    if (!CanReadMem(inner + 0x2A4, 1)) return -1.0f;
     uint8_t activeFlag = *reinterpret_cast<uint8_t*>(inner + 0x29C);
     if (!activeFlag) return -1.0f;
     return *reinterpret_cast<float*>(inner + 0x2A0);
 }
 
 static int Lua_SetPerFactionSpeedMultiplier(lua_State* L) {
-    EnsureEconomyLock();
     EnsureSpeedLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     double absSpeed = fn_tonumber(L, 2);
@@ -3387,9 +5654,8 @@ static int Lua_SetPerFactionSpeedMultiplier(lua_State* L) {
 
     // Cache the per-faction value for replay-harness inspection and so
     // the diagnostics tab can show "what's currently applied per slot".
-    EnterCriticalSection(&g_economyLock);
-    g_pendingFactionSpeedMult[slot] = static_cast<float>(absSpeed);
-    LeaveCriticalSection(&g_economyLock);
+    if (!PendingQueue(L, "SWFOC_SetPerFactionSpeedMultiplier",
+                      PendingSlotValue(PENDING_FACTION_SPEED_MULT, slot, absSpeed))) return 1;
 
     // Enumerate every tactical object once, filter by OwnerPlayerID,
     // call SetSpeedOverride per unit. Mirrors Lua_EnumerateUnits.
@@ -3429,38 +5695,41 @@ static int Lua_SetPerFactionSpeedMultiplier(lua_State* L) {
 }
 
 static int Lua_SetIncomeMultiplier(lua_State* L) {
-    EnsureEconomyLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     double mult = fn_tonumber(L, 2);
     if (mult < 0.0) {
         fn_pushstring(L, "ERR: SWFOC_SetIncomeMultiplier: multiplier must be >= 0");
         return 1;
     }
-    EnterCriticalSection(&g_economyLock);
-    g_pendingIncomeMult[slot] = static_cast<float>(mult);
-    LeaveCriticalSection(&g_economyLock);
-    Log("[Bridge] SetIncomeMultiplier(slot=%d, mult=%.3f) -- Phase 1 pending\n", slot, mult);
-    fn_pushstring(L, "OK: income multiplier recorded (Phase 2 hook pending)");
+    if (mult > 100.0) mult = 100.0;  // same overflow guard as the global knob
+    if (slot == -1) {
+        StoreGlobalCreditsMultiplier(mult);
+        Log("[Bridge] SetIncomeMultiplier(slot=-1, mult=%.3f) -- LIVE (global)\n", mult);
+        fn_pushstring(L, "OK: credit multiplier applied (LIVE -- AddCredits delta scaling)");
+        return 1;
+    }
+    if (!SlotModSet(&g_slotMods, slot, SLOT_MOD_INCOME, static_cast<float>(mult))) {
+        fn_pushstring(L, "ERR: SWFOC_SetIncomeMultiplier: slot must be 0..15");
+        return 1;
+    }
+    Log("[Bridge] SetIncomeMultiplier(slot=%d, mult=%.3f) -- LIVE\n", slot, mult);
+    fn_pushstring(L, "OK: income multiplier applied (LIVE -- AddCredits per-slot delta scaling)");
     return 1;
 }
 
 static int Lua_SetGameSpeed(lua_State* L) {
-    EnsureEconomyLock();
     double speed = fn_tonumber(L, 1);
     if (speed < 0.0) {
         fn_pushstring(L, "ERR: SWFOC_SetGameSpeed: speed must be >= 0");
         return 1;
     }
-    EnterCriticalSection(&g_economyLock);
-    g_pendingGameSpeed = static_cast<float>(speed);
-    LeaveCriticalSection(&g_economyLock);
+    if (!PendingQueue(L, "SWFOC_SetGameSpeed", PendingGlobal(PENDING_GAME_SPEED, speed, false))) return 1;
     Log("[Bridge] SetGameSpeed(%.3f) -- Phase 1 pending\n", speed);
     fn_pushstring(L, "OK: game speed recorded (Phase 2 hook pending)");
     return 1;
 }
 
 static int Lua_SetFreezeCredits(lua_State* L) {
-    EnsureEconomyLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     int enable = static_cast<int>(fn_tonumber(L, 2));
     double target = fn_tonumber(L, 3);
@@ -3472,18 +5741,17 @@ static int Lua_SetFreezeCredits(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_SetFreezeCredits: target must be >= 0 when enabling");
         return 1;
     }
-    EnterCriticalSection(&g_economyLock);
-    if (enable) {
-        g_pendingFreezeEnable[slot] = true;
-        g_pendingFrozenCredits[slot] = target;
-    } else {
-        g_pendingFreezeEnable.erase(slot);
-        g_pendingFrozenCredits.erase(slot);
-    }
-    LeaveCriticalSection(&g_economyLock);
-    Log("[Bridge] SetFreezeCredits(slot=%d, enable=%d, target=%.2f) -- Phase 1 pending\n",
+    // The freeze itself is LIVE (AddCredits drops the slot's deltas, so the
+    // balance holds where it is); pinning it to `target` stays journaled
+    // for Phase 2.
+    if (!PendingQueue(L, "SWFOC_SetFreezeCredits",
+                      PendingSlotValue(PENDING_FREEZE_CREDITS, slot, target, enable != 0))) return 1;
+    SlotModSetFreeze(&g_slotMods, slot, enable != 0);
+    Log("[Bridge] SetFreezeCredits(slot=%d, enable=%d, target=%.2f) -- LIVE freeze, target pin pending\n",
         slot, enable, target);
-    fn_pushstring(L, "OK: freeze-credits state recorded (Phase 2 hook pending)");
+    fn_pushstring(L, enable
+        ? "OK: credits frozen for slot (LIVE -- AddCredits per-slot; target pin pending)"
+        : "OK: credits unfrozen for slot (LIVE)");
     return 1;
 }
 
@@ -3501,21 +5769,9 @@ static int Lua_SetFreezeCredits(lua_State* L) {
 // disable. The replay mirror ReplayMutSetOHK pins the contract for
 // every IDA-blocked edge case (idempotent re-enable, orphan guard on
 // disable, enemy READ-ONLY sweep).
-static CRITICAL_SECTION g_ohkAttackLock;
-static bool g_ohkAttackLockInit = false;
-static bool g_ohkAttackEnabled = false;
-static void EnsureOhkAttackLock() {
-    if (!g_ohkAttackLockInit) {
-        InitializeCriticalSection(&g_ohkAttackLock);
-        g_ohkAttackLockInit = true;
-    }
-}
 static int Lua_ToggleOHKAttackPower(lua_State* L) {
-    EnsureOhkAttackLock();
     int enable = static_cast<int>(fn_tonumber(L, 1));
-    EnterCriticalSection(&g_ohkAttackLock);
-    g_ohkAttackEnabled = (enable != 0);
-    LeaveCriticalSection(&g_ohkAttackLock);
+    if (!PendingQueue(L, "SWFOC_ToggleOHKAttackPower", PendingGlobal(PENDING_OHK_ATTACK, 0.0, enable != 0))) return 1;
     Log("[Bridge] ToggleOHKAttackPower(%d) -- Phase 1 pending (attack_power offset not IDA-pinned)\n",
         enable);
     fn_pushstring(L, enable
@@ -3525,8 +5781,8 @@ static int Lua_ToggleOHKAttackPower(lua_State* L) {
 }
 
 // SWFOC_SetFireRate / SWFOC_SetAreaDamage / SWFOC_SetTargetFilter
-// Tasks 131/132/133 Phase 1. Each helper stores the requested intent
-// into a pending-write map behind g_combatLock. Phase 2 of the contract
+// Tasks 131/132/133 Phase 1. Each helper journals the requested intent
+// through PendingQueue. Phase 2 of the contract
 // generator (#178) will emit the real hook once IDA pins the weapon
 // cooldown-reset function (#131), the Take_Damage_Outer splash branch
 // (#132), and the targeting filter predicate (#133). Enemy-slot writes
@@ -3535,47 +5791,31 @@ static int Lua_ToggleOHKAttackPower(lua_State* L) {
 // owning slot's units, so writing another slot's filter is effectively
 // mutating enemy behavior. The replay mirror DOES accept any slot so
 // tests can assert cross-slot isolation without tripping the gate.
-static CRITICAL_SECTION g_combatLock;
-static bool g_combatLockInit = false;
-static void EnsureCombatLock() {
-    if (!g_combatLockInit) {
-        InitializeCriticalSection(&g_combatLock);
-        g_combatLockInit = true;
-    }
-}
-static std::unordered_map<int32_t, float>    g_pendingFireRateMult;
-static std::unordered_map<int32_t, uint32_t> g_pendingTargetFilter;
-static bool                                  g_pendingAreaDamage = false;
-
 static int Lua_SetFireRate(lua_State* L) {
-    EnsureCombatLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     double mult = fn_tonumber(L, 2);
     if (mult <= 0.0) {
         fn_pushstring(L, "ERR: SWFOC_SetFireRate: multiplier must be > 0");
         return 1;
     }
-    EnterCriticalSection(&g_combatLock);
-    g_pendingFireRateMult[slot] = static_cast<float>(mult);
-    LeaveCriticalSection(&g_combatLock);
+    if (!SlotModSet(&g_slotMods, slot, SLOT_MOD_FIRE_RATE, static_cast<float>(mult))) {
+        fn_pushstring(L, "ERR: SWFOC_SetFireRate: slot must be 0..15");
+        return 1;
+    }
     Log("[Bridge] SetFireRate(slot=%d, mult=%.3f) -- Phase 1 pending\n", slot, mult);
     fn_pushstring(L, "OK: fire-rate multiplier recorded (Phase 2 hook pending)");
     return 1;
 }
 
 static int Lua_SetAreaDamage(lua_State* L) {
-    EnsureCombatLock();
     int enabled = static_cast<int>(fn_tonumber(L, 1));
-    EnterCriticalSection(&g_combatLock);
-    g_pendingAreaDamage = (enabled != 0);
-    LeaveCriticalSection(&g_combatLock);
+    if (!PendingQueue(L, "SWFOC_SetAreaDamage", PendingGlobal(PENDING_AREA_DAMAGE, 0.0, enabled != 0))) return 1;
     Log("[Bridge] SetAreaDamage(%d) -- Phase 1 pending\n", enabled);
     fn_pushstring(L, "OK: area-damage toggle recorded (Phase 2 hook pending)");
     return 1;
 }
 
 static int Lua_SetTargetFilter(lua_State* L) {
-    EnsureCombatLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     uint32_t bitmask = static_cast<uint32_t>(fn_tonumber(L, 2));
     if (slot < 0) {
@@ -3589,9 +5829,8 @@ static int Lua_SetTargetFilter(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_SetTargetFilter: only local slot may set filter (enemy READ-ONLY)");
         return 1;
     }
-    EnterCriticalSection(&g_combatLock);
-    g_pendingTargetFilter[slot] = bitmask & 0x7;
-    LeaveCriticalSection(&g_combatLock);
+    if (!PendingQueue(L, "SWFOC_SetTargetFilter",
+                      PendingSlotValue(PENDING_TARGET_FILTER, slot, bitmask & 0x7))) return 1;
     Log("[Bridge] SetTargetFilter(slot=%d, mask=0x%X) -- Phase 1 pending\n", slot, bitmask & 0x7);
     fn_pushstring(L, "OK: target-filter recorded (Phase 2 hook pending)");
     return 1;
@@ -3601,24 +5840,11 @@ static int Lua_SetTargetFilter(lua_State* L) {
 // Phase 1 record-only toggles. Phase 2 will AOB-scan for the
 // build-progress-increment instruction (#161) and the credits-deduction
 // instruction (#162), patch them with NOPs on enable, restore the
-// original bytes on disable. Both toggles share g_aobPatchLock so the
-// pending state doesn't race during consecutive writes.
-static CRITICAL_SECTION g_aobPatchLock;
-static bool g_aobPatchLockInit = false;
-static bool g_pendingInstantBuild = false;
-static bool g_pendingFreeBuild    = false;
-static void EnsureAobPatchLock() {
-    if (!g_aobPatchLockInit) {
-        InitializeCriticalSection(&g_aobPatchLock);
-        g_aobPatchLockInit = true;
-    }
-}
+// original bytes on disable. Both toggles go through the pending journal,
+// so consecutive writes apply in the order they were made.
 static int Lua_InstantBuild(lua_State* L) {
-    EnsureAobPatchLock();
     int enable = static_cast<int>(fn_tonumber(L, 1));
-    EnterCriticalSection(&g_aobPatchLock);
-    g_pendingInstantBuild = (enable != 0);
-    LeaveCriticalSection(&g_aobPatchLock);
+    if (!PendingQueue(L, "SWFOC_InstantBuild", PendingGlobal(PENDING_INSTANT_BUILD, 0.0, enable != 0))) return 1;
     Log("[Bridge] InstantBuild(%d) -- Phase 1 pending (AOB patch queued)\n", enable);
     fn_pushstring(L, enable
         ? "OK: instant-build enabled (Phase 2 AOB patch pending)"
@@ -3626,11 +5852,8 @@ static int Lua_InstantBuild(lua_State* L) {
     return 1;
 }
 static int Lua_FreeBuild(lua_State* L) {
-    EnsureAobPatchLock();
     int enable = static_cast<int>(fn_tonumber(L, 1));
-    EnterCriticalSection(&g_aobPatchLock);
-    g_pendingFreeBuild = (enable != 0);
-    LeaveCriticalSection(&g_aobPatchLock);
+    if (!PendingQueue(L, "SWFOC_FreeBuild", PendingGlobal(PENDING_FREE_BUILD, 0.0, enable != 0))) return 1;
     Log("[Bridge] FreeBuild(%d) -- Phase 1 pending (AOB patch queued)\n", enable);
     fn_pushstring(L, enable
         ? "OK: free-build enabled (Phase 2 AOB patch pending)"
@@ -3643,7 +5866,7 @@ static int Lua_FreeBuild(lua_State* L) {
 // field→offset table (populated from knowledge-base/verified_facts.json
 // at load time, modulo the fields whose offsets are still IDA-blocked)
 // and writes the resulting memory. Phase 1 just records the intent in
-// g_pendingUnitFieldWrites so UI consumers can see the edit reflected
+// g_pendingState.unitFields so UI consumers can see the edit reflected
 // in a future readback. Enemy READ-ONLY gate: the helper refuses to
 // write to units whose owner_slot != local_slot unless the field is
 // on the allow-list for enemy units (position readbacks, etc.).
@@ -3658,21 +5881,12 @@ static int Lua_FreeBuild(lua_State* L) {
 // Function definition moved below Lua_HeroStatEdit so it can reference
 // the shield/speed primitives (g_shieldLock, pfn_SetFrontShield,
 // g_unitShieldOverrideMap, etc.) that are defined just above
-// HeroStatEdit. The pending struct + lock stay here (data only).
-struct PendingUnitFieldWrite {
-    uint64_t    obj_addr  = 0;
-    std::string field;
-    float       value     = 0.0f;
-};
-static std::vector<PendingUnitFieldWrite> g_pendingUnitFieldWrites;
-static CRITICAL_SECTION g_unitFieldLock;
-static bool g_unitFieldLockInit = false;
-static void EnsureUnitFieldLock() {
-    if (!g_unitFieldLockInit) {
-        InitializeCriticalSection(&g_unitFieldLock);
-        g_unitFieldLockInit = true;
-    }
-}
+// HeroStatEdit.
+//
+// 2026-10-14: the Phase-1 fields go through g_pendingJournal as
+// PENDING_UNIT_FIELD and fold into g_pendingState.unitFields keyed by
+// (obj_addr, field), last writer wins. The old vector grew by one entry
+// per slider step and was never drained.
 static int Lua_SetUnitField(lua_State* L); // moved below Lua_HeroStatEdit (iter 136)
 
 // SWFOC_SpawnUnit / SWFOC_SetBuildCost / SWFOC_SetUnitCapOverride —
@@ -3682,8 +5896,8 @@ static int Lua_SetUnitField(lua_State* L); // moved below Lua_HeroStatEdit (iter
 // count) needs the Phase 2 pipeline to marshal into a SWFOC_DoString
 // call with the correct string escaping. SetBuildCost and
 // SetUnitCapOverride are IDA-blocked pending the credits-deduction site
-// and the unit-cap check, respectively. All three use
-// g_economyLock since they're all production-economy toggles.
+// and the unit-cap check, respectively. Those two journal per-slot values;
+// the spawn queue keeps g_economyLock for its variable-length entries.
 //
 // 2026-05-06 (iter 248 → iter 249 CORRECTION): the Apocalypticx CE
 // community ledger entry `rva_apocalypticx_unit_cap_gc @ 0x28DF6F` was
@@ -3693,8 +5907,6 @@ static int Lua_SetUnitField(lua_State* L); // moved below Lua_HeroStatEdit (iter
 // xref walk identifies the canonical cap reader. See
 // `knowledge-base/iter248_setunitcapoverride_re_kickoff.md` for the
 // correction details + iter 250+ recommendation.
-static std::unordered_map<int32_t, float>   g_pendingBuildCostMult;
-static std::unordered_map<int32_t, int32_t> g_pendingUnitCapOverride;
 struct PendingSpawnRequest {
     std::string type_name;
     int32_t     owner_slot = -1;
@@ -3738,23 +5950,19 @@ static int Lua_SpawnUnit(lua_State* L) {
 }
 
 static int Lua_SetBuildCost(lua_State* L) {
-    EnsureEconomyLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     double mult = fn_tonumber(L, 2);
     if (mult < 0.0) {
         fn_pushstring(L, "ERR: SWFOC_SetBuildCost: multiplier must be >= 0");
         return 1;
     }
-    EnterCriticalSection(&g_economyLock);
-    g_pendingBuildCostMult[slot] = static_cast<float>(mult);
-    LeaveCriticalSection(&g_economyLock);
+    if (!PendingQueue(L, "SWFOC_SetBuildCost", PendingSlotValue(PENDING_BUILD_COST_MULT, slot, mult))) return 1;
     Log("[Bridge] SetBuildCost(slot=%d, mult=%.3f) -- Phase 1 pending\n", slot, mult);
     fn_pushstring(L, "OK: build cost recorded (Phase 2 hook pending)");
     return 1;
 }
 
 static int Lua_SetUnitCapOverride(lua_State* L) {
-    EnsureEconomyLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
     int cap  = static_cast<int>(fn_tonumber(L, 2));
     if (slot < 0) {
@@ -3765,45 +5973,27 @@ static int Lua_SetUnitCapOverride(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_SetUnitCapOverride: cap must be >= -1 (-1 = unlimited)");
         return 1;
     }
-    EnterCriticalSection(&g_economyLock);
-    g_pendingUnitCapOverride[slot] = cap;
-    LeaveCriticalSection(&g_economyLock);
+    if (!PendingQueue(L, "SWFOC_SetUnitCapOverride", PendingSlotValue(PENDING_UNIT_CAP, slot, cap))) return 1;
     Log("[Bridge] SetUnitCapOverride(slot=%d, cap=%d) -- Phase 1 pending\n", slot, cap);
     fn_pushstring(L, "OK: unit-cap override recorded (Phase 2 hook pending)");
     return 1;
 }
 
 // SWFOC_FreezeAI(slot, enable) — Task 114 Phase 1.
-// Records per-slot AI-freeze intent behind g_aiFreezeLock. Phase 2 will
+// Journals per-slot AI-freeze intent. Phase 2 will
 // hook the AI scheduler at the per-frame tick that iterates PlayerArray
 // and skip the ->ai_think() dispatch for frozen slots. Freezing enemy
 // AI is the whole POINT of the feature, not a violation of the READ-ONLY
 // rule — it's a player-facing "hold back the enemy" knob that maps to
 // a global scheduler gate, not per-unit state mutation.
-static CRITICAL_SECTION g_aiFreezeLock;
-static bool g_aiFreezeLockInit = false;
-static std::unordered_map<int32_t, bool> g_pendingFreezeAi;
-static void EnsureAiFreezeLock() {
-    if (!g_aiFreezeLockInit) {
-        InitializeCriticalSection(&g_aiFreezeLock);
-        g_aiFreezeLockInit = true;
-    }
-}
 static int Lua_FreezeAI(lua_State* L) {
-    EnsureAiFreezeLock();
     int slot   = static_cast<int>(fn_tonumber(L, 1));
     int enable = static_cast<int>(fn_tonumber(L, 2));
     if (slot < 0) {
         fn_pushstring(L, "ERR: SWFOC_FreezeAI: slot must be >= 0");
         return 1;
     }
-    EnterCriticalSection(&g_aiFreezeLock);
-    if (enable) {
-        g_pendingFreezeAi[slot] = true;
-    } else {
-        g_pendingFreezeAi.erase(slot);
-    }
-    LeaveCriticalSection(&g_aiFreezeLock);
+    if (!PendingQueue(L, "SWFOC_FreezeAI", PendingSlotValue(PENDING_FREEZE_AI, slot, 0.0, enable != 0))) return 1;
     Log("[Bridge] FreezeAI(slot=%d, enable=%d) -- Phase 1 pending\n", slot, enable);
     fn_pushstring(L, enable
         ? "OK: AI freeze recorded (Phase 2 hook pending)"
@@ -3830,24 +6020,9 @@ static int Lua_FreezeAI(lua_State* L) {
 // constructor for that userdata isn't pinned yet. `Lua_FreeCam` also
 // stays PHASE 2 PENDING — there's no `Free_Cam(enable)` Lua API; the
 // engine implements it as Lua-side script behaviour we'd need to mimic.
-static CRITICAL_SECTION g_cameraLock;
-static bool g_cameraLockInit = false;
-static bool g_pendingFreeCam = false;
-static float g_pendingCamX = 0.0f;
-static float g_pendingCamY = 0.0f;
-static float g_pendingCamZ = 0.0f;
-static void EnsureCameraLock() {
-    if (!g_cameraLockInit) {
-        InitializeCriticalSection(&g_cameraLock);
-        g_cameraLockInit = true;
-    }
-}
 static int Lua_FreeCam(lua_State* L) {
-    EnsureCameraLock();
     int enable = static_cast<int>(fn_tonumber(L, 1));
-    EnterCriticalSection(&g_cameraLock);
-    g_pendingFreeCam = (enable != 0);
-    LeaveCriticalSection(&g_cameraLock);
+    if (!PendingQueue(L, "SWFOC_FreeCam", PendingGlobal(PENDING_FREE_CAM, 0.0, enable != 0))) return 1;
     Log("[Bridge] FreeCam(%d) -- Phase 1 pending\n", enable);
     fn_pushstring(L, enable
         ? "OK: free-cam enabled (Phase 2 hook pending)"
@@ -5564,6 +7739,7 @@ static int Lua_SpawnUnitLua(lua_State* L) {
         return 1;
     }
     fn_settop(L, -2);
+    InvalidateTacticalUnitIndex();  // the new unit is in the list this tick
     Log("[Bridge] SpawnUnitLua(%s, %s, %s) -- LIVE OK\n", playerExpr, typeExpr, posExpr);
     fn_pushstring(L, "OK: Spawn_Unit dispatched (LIVE — engine Lua API)");
     return 1;
@@ -5622,6 +7798,111 @@ static int Lua_GalacticSpawnUnit(lua_State* L) {
     return 1;
 }
 
+// 2026-10-14: batched spawns (spawn_batch.h). SWFOC_SpawnBatch queues a
+// whole fleet in one command; Hook_luaD_call spawns at most the budget per
+// frame through HELPER_SPAWN_UNITS, one helper call per entry chunk, and
+// SWFOC_SpawnBatchStatus reports progress. Main thread only.
+static SpawnQueue g_spawnQueue;
+static volatile LONG g_spawnGuard = 0;  // a spawn re-enters Hook_luaD_call
+
+// The owner slot's faction is what Find_Player takes; an empty slot spawns
+// nothing, which fails the rest of the entry.
+static int SpawnEntryUnits(lua_State* L, const SpawnBatchEntry* e, int n) {
+    const char* faction = PlayerTableRow(GetPlayerTable(), e->owner) ? GetFactionName(e->owner) : nullptr;
+    if (!faction || strcmp(faction, "?") == 0) return 0;
+    const int top = fn_gettop(L);
+    if (!PushHelperScript(L, HELPER_SPAWN_UNITS)) return 0;
+    fn_pushstring(L, faction);
+    fn_pushstring(L, e->type);
+    fn_pushnumber(L, e->x);
+    fn_pushnumber(L, e->y);
+    fn_pushnumber(L, e->z);
+    fn_pushnumber(L, n);
+    int spawned = 0;
+    const int rc = fn_pcall(L, 6, 1, 0);
+    if (rc == 0 && fn_type(L, -1) == LUA_TNUMBER) {
+        spawned = static_cast<int>(fn_tonumber(L, -1));
+    } else {
+        const char* msg = rc != 0 ? fn_tostring(L, -1) : nullptr;
+        Log("[Bridge] SpawnBatch %s x%d for slot %d failed (rc=%d): %s\n", e->type, n, e->owner, rc,
+            msg ? msg : "?");
+    }
+    fn_settop(L, top);
+    return spawned;
+}
+
+static void DrainSpawnQueue(lua_State* L, ULONGLONG now) {
+    const SpawnBatch* active = SpawnQueueActive(&g_spawnQueue);
+    const uint32_t id = active ? active->id : 0;
+    const int used = SpawnQueueStep(&g_spawnQueue, now,
+        [L](const SpawnBatchEntry* e, int n) { return SpawnEntryUnits(L, e, n); });
+    if (used) InvalidateTacticalUnitIndex();
+    const SpawnBatch* b = SpawnQueueFind(&g_spawnQueue, id);
+    if (b && SpawnBatchPending(b) == 0)
+        Log("[Bridge] SpawnBatch %u done: %d spawned, %d failed\n", b->id, b->spawned, b->failed);
+}
+
+// SWFOC_SpawnBatch(spec) -> "OK: batch=<id> entries=<E> units=<N>
+// budget=<B>" or "ERR: ...". spec is "type;count;owner;x;y;z", entries
+// separated by '|' (at most 32 entries, 512 units). The units spawn over
+// the following frames, SWFOC_SetSpawnBudget per frame.
+static int Lua_SpawnBatch(lua_State* L) {
+    const char* spec = fn_tostring(L, 1);
+    static SpawnBatch parsed;  // 2.8 KB; main thread only
+    int bad = -1;
+    const int r = SpawnBatchParse(&parsed, spec, &bad);
+    char buf[160];
+    if (r != SPAWN_PARSE_OK) {
+        if (bad >= 0)
+            SafeAppendFmt(buf, 0, sizeof(buf), "ERR: SWFOC_SpawnBatch: entry %d: %s", bad, SpawnParseError(r));
+        else
+            SafeAppendFmt(buf, 0, sizeof(buf), "ERR: SWFOC_SpawnBatch: %s", SpawnParseError(r));
+        fn_pushstring(L, buf);
+        return 1;
+    }
+    const uint32_t id = SpawnQueuePush(&g_spawnQueue, &parsed);
+    if (!id) {
+        SafeAppendFmt(buf, 0, sizeof(buf), "ERR: SWFOC_SpawnBatch: queue full (%d units pending)",
+                      g_spawnQueue.pending);
+        fn_pushstring(L, buf);
+        return 1;
+    }
+    Log("[Bridge] SpawnBatch %u queued: %d entries, %d units\n", id, parsed.entries, parsed.total);
+    SafeAppendFmt(buf, 0, sizeof(buf), "OK: batch=%u entries=%d units=%d budget=%d", id, parsed.entries,
+                  parsed.total, SpawnQueueBudget(&g_spawnQueue));
+    fn_pushstring(L, buf);
+    return 1;
+}
+
+// SWFOC_SpawnBatchStatus([id]) -> "batch=<id> total=T spawned=S failed=F
+// pending=P queued=Q budget=B"; Q is the units left across every batch.
+// No id means the latest batch (batch=0 before the first). An id whose
+// slot has been reused is an ERR.
+static int Lua_SpawnBatchStatus(lua_State* L) {
+    const uint32_t id = fn_gettop(L) >= 1 ? static_cast<uint32_t>(fn_tonumber(L, 1)) : g_spawnQueue.lastId;
+    const SpawnBatch* b = SpawnQueueFind(&g_spawnQueue, id);
+    char buf[160];
+    if (!b && id != 0) {
+        SafeAppendFmt(buf, 0, sizeof(buf), "ERR: SWFOC_SpawnBatchStatus: unknown batch %u", id);
+    } else {
+        SafeAppendFmt(buf, 0, sizeof(buf), "batch=%u total=%d spawned=%d failed=%d pending=%d queued=%d budget=%d",
+                      id, b ? b->total : 0, b ? b->spawned : 0, b ? b->failed : 0, b ? SpawnBatchPending(b) : 0,
+                      g_spawnQueue.pending, SpawnQueueBudget(&g_spawnQueue));
+    }
+    fn_pushstring(L, buf);
+    return 1;
+}
+
+// SWFOC_SetSpawnBudget(n) -> "OK: budget=<n>". Units per frame for
+// SWFOC_SpawnBatch, clamped to [1, 64]; the default is 4.
+static int Lua_SetSpawnBudget(lua_State* L) {
+    SpawnQueueSetBudget(&g_spawnQueue, static_cast<int>(fn_tonumber(L, 1)));
+    char buf[48];
+    SafeAppendFmt(buf, 0, sizeof(buf), "OK: budget=%d", SpawnQueueBudget(&g_spawnQueue));
+    fn_pushstring(L, buf);
+    return 1;
+}
+
 // 2026-04-28 (iter 108) — LIVE.
 // Calls the engine's `Change_Owner` Lua method on a unit handle. The
 // caller supplies the Lua expressions that resolve to (unit_handle,
@@ -6032,6 +8313,61 @@ static int Lua_GetCameraPos(lua_State* L) {
     return 1;
 }
 
+// 2026-10-14: SWFOC_CameraPath plays a whole fly-through (camera_path.h)
+// from Hook_luaD_call, one pose per CAMERA_PATH_STEP_MS, through the same
+// SetTransformMatrix call as SWFOC_SetCameraPos. Main thread only.
+static CameraPath g_cameraPath;
+
+static void StepCameraPath(ULONGLONG now) {
+    CameraPose pose;
+    if (!CameraPathStep(&g_cameraPath, now, &pose)) return;
+    const __int64 camera = LookupActiveCamera();
+    if (!camera) {
+        g_cameraPath.missed++;
+        return;
+    }
+    float matrix[12];
+    CameraPathMatrix(&g_cameraPath, pose, reinterpret_cast<const float*>(camera + 0x10), matrix);
+    reinterpret_cast<pfn_CameraSetTransformMatrix>(g_base + RVA::CameraSetTransformMatrix)(camera, matrix);
+    if (!g_cameraPath.playing) Log("[Bridge] CameraPath done: frames=%u missed=%u\n", g_cameraPath.frames, g_cameraPath.missed);
+}
+
+// SWFOC_CameraPath([mode [, path [, loop]]]) -> "playing=0|1 keys=N
+// targets=0|1 loop=0|1 t_ms=T duration_ms=D frames=F missed=M".
+// "play" parses path (see camera_path.h) and starts it from its first key,
+// replacing any path already playing; loop non-zero repeats it until
+// "stop". A bare call reports.
+static int Lua_CameraPath(lua_State* L) {
+    const char* mode = fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TSTRING ? fn_tostring(L, 1) : nullptr;
+    if (mode && strcmp(mode, "play") == 0) {
+        const char* spec = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TSTRING ? fn_tostring(L, 2) : nullptr;
+        const int rc = CameraPathParse(&g_cameraPath, spec);
+        if (rc != CAMERA_PATH_PARSE_OK) {
+            char buf[128];
+            SafeAppendFmt(buf, 0, sizeof(buf), "ERR: SWFOC_CameraPath: %s", CameraPathParseError(rc));
+            fn_pushstring(L, buf);
+            return 1;
+        }
+        const bool loop = fn_gettop(L) >= 3 && fn_type(L, 3) == LUA_TNUMBER && fn_tonumber(L, 3) != 0.0;
+        CameraPathStart(&g_cameraPath, GetTickCount64(), loop);
+        Log("[Bridge] CameraPath play: keys=%d duration=%ums loop=%d\n", g_cameraPath.keys,
+            CameraPathDuration(&g_cameraPath), loop ? 1 : 0);
+    } else if (mode && strcmp(mode, "stop") == 0) {
+        g_cameraPath.playing = false;
+    } else if (mode) {
+        fn_pushstring(L, "ERR: SWFOC_CameraPath: mode must be play or stop");
+        return 1;
+    }
+    const uint64_t elapsed = g_cameraPath.playing ? GetTickCount64() - g_cameraPath.startMs : 0;
+    char buf[192];
+    SafeAppendFmt(buf, 0, sizeof(buf), "playing=%d keys=%d targets=%d loop=%d t_ms=%llu duration_ms=%u frames=%u missed=%u",
+                  g_cameraPath.playing ? 1 : 0, g_cameraPath.keys, g_cameraPath.targets ? 1 : 0,
+                  g_cameraPath.loop ? 1 : 0, (unsigned long long)elapsed, CameraPathDuration(&g_cameraPath),
+                  g_cameraPath.frames, g_cameraPath.missed);
+    fn_pushstring(L, buf);
+    return 1;
+}
+
 // SWFOC_ListAbilities(obj_addr) / SWFOC_TriggerAbility(obj_addr, idx).
 // Tasks 139/140 Phase 1. Live detection of per-unit ability catalogues
 // requires walking the SpecialAbility vtable chain off GameObject --
@@ -6096,22 +8432,12 @@ static int Lua_GetPlanetTechAndBuildings(lua_State* L) {
 //                 queued — operator can confirm by calling with
 //                 "neutral" and observing target's stance.)
 //
-// Cache map kept for replay/dev fallback when Resolve<>() returns
-// nullptr (no module loaded).
+// The pair's state code is journaled (PENDING_DIPLOMACY, folded into
+// g_pendingState.diplomacy[lo][hi]) for replay/dev fallback when
+// Resolve<>() returns nullptr (no module loaded).
 typedef __int64 (__fastcall *pfn_MakeAllyEnemy)(__int64 player_a, int target_slot, int state);
 
-static std::unordered_map<std::string, std::string> g_pendingDiplomacyWrites;
-static CRITICAL_SECTION g_diplomacyLock;
-static bool g_diplomacyLockInit = false;
-static void EnsureDiplomacyLock() {
-    if (!g_diplomacyLockInit) {
-        InitializeCriticalSection(&g_diplomacyLock);
-        g_diplomacyLockInit = true;
-    }
-}
-
 static int Lua_SetDiplomacy(lua_State* L) {
-    EnsureDiplomacyLock();
     int slot_a = static_cast<int>(fn_tonumber(L, 1));
     int slot_b = static_cast<int>(fn_tonumber(L, 2));
     const char* state = fn_tostring(L, 3);
@@ -6133,6 +8459,8 @@ static int Lua_SetDiplomacy(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_SetDiplomacy: state must be 'ally', 'enemy', or 'neutral'");
         return 1;
     }
+    PendingWrite pending = PendingSlotValue(PENDING_DIPLOMACY, slot_a, state_code);
+    pending.slot2 = (int16_t)(PendingSlotOk(slot_b) ? slot_b : -1);
 
     // LIVE: walk PlayerArray to resolve slot_a → PlayerClass*, then
     // call engine writer at 0x288800. Same walker pattern as
@@ -6145,14 +8473,9 @@ static int Lua_SetDiplomacy(lua_State* L) {
         uintptr_t player_a = *reinterpret_cast<uintptr_t*>(pa + 8 * slot_a);
         if (player_a) {
             fnWrite(static_cast<__int64>(player_a), slot_b, state_code);
-            // Mirror to cache for legacy read paths.
-            char key[32];
-            int lo = slot_a < slot_b ? slot_a : slot_b;
-            int hi = slot_a < slot_b ? slot_b : slot_a;
-            snprintf(key, sizeof(key), "%d-%d", lo, hi);
-            EnterCriticalSection(&g_diplomacyLock);
-            g_pendingDiplomacyWrites[key] = state;
-            LeaveCriticalSection(&g_diplomacyLock);
+            // Mirror to the journal for legacy read paths; the engine
+            // write already happened, so a refused mirror is not an error.
+            PendingJournalPush(&g_pendingJournal, pending);
             Log("[Bridge] SetDiplomacy(%d, %d, %s) -- LIVE (MakeAllyEnemy "
                 "@ 0x%llX, state_code=%d)\n",
                 slot_a, slot_b, state,
@@ -6166,16 +8489,10 @@ static int Lua_SetDiplomacy(lua_State* L) {
         }
     }
 
-    // Fallback: cache the desired state for replay/dev builds without
-    // the module loaded. Same string-key shape the legacy Phase-1
-    // path used.
-    int lo = slot_a < slot_b ? slot_a : slot_b;
-    int hi = slot_a < slot_b ? slot_b : slot_a;
-    char key[32];
-    snprintf(key, sizeof(key), "%d-%d", lo, hi);
-    EnterCriticalSection(&g_diplomacyLock);
-    g_pendingDiplomacyWrites[key] = state;
-    LeaveCriticalSection(&g_diplomacyLock);
+    // Fallback: journal the desired state for replay/dev builds without
+    // the module loaded, keyed by the unordered slot pair as the legacy
+    // Phase-1 path was.
+    if (!PendingQueue(L, "SWFOC_SetDiplomacy", pending)) return 1;
     Log("[Bridge] SetDiplomacy(%d, %d, %s) -- fallback cache "
         "(no module loaded or slot out of bounds)\n",
         slot_a, slot_b, state);
@@ -6184,7 +8501,6 @@ static int Lua_SetDiplomacy(lua_State* L) {
 }
 
 static int Lua_ChangePlanetOwner(lua_State* L) {
-    EnsurePlanetLock();
     const char* raw = fn_tostring(L, 1);
     int slot = static_cast<int>(fn_tonumber(L, 2));
     if (!raw || !raw[0]) {
@@ -6197,13 +8513,14 @@ static int Lua_ChangePlanetOwner(lua_State* L) {
     }
     // Uppercase the key to match the replay-side case-insensitive lookup
     // so the pending-map reads round-trip with the replay CSV.
-    std::string key = raw;
-    for (char& c : key) {
-        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
-    }
-    EnterCriticalSection(&g_planetLock);
-    g_pendingPlanetOwnerWrites[key] = slot;
-    LeaveCriticalSection(&g_planetLock);
+    PendingWrite pending = PendingSlotValue(PENDING_PLANET_OWNER, slot, 0.0);
+    size_t n = strlen(raw);
+    if (n >= PENDING_NAME_MAX) n = PENDING_NAME_MAX;  // leaves no NUL -> BAD_NAME
+    for (size_t i = 0; i < n; i++) {
+        char c = raw[i];
+        pending.name[i] = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+    if (!PendingQueue(L, "SWFOC_ChangePlanetOwner", pending)) return 1;
     Log("[Bridge] ChangePlanetOwner(%s, %d) -- Phase 1 pending\n", raw, slot);
     fn_pushstring(L, "OK: planet owner change recorded (Phase 2 live wire-through pending)");
     return 1;
@@ -6259,6 +8576,55 @@ static int Lua_ChangePlanetOwnerWithMode(lua_State* L) {
     return 1;
 }
 
+// SWFOC_PlanetBatch("name;owner=N;tech=N;buildings=N|...") -> "OK: ..." or
+// "ERR: ...". 2026-10-14: every planet edit of a scenario in one command
+// (planet_table.h). Names resolve through g_planetIds, built once per
+// galactic session; one unknown name rejects the whole batch, with nothing
+// recorded. The edits then fold into g_pendingState in one pass, after
+// whatever the journal already holds. Owner, tech and buildings stay Phase 1
+// like ChangePlanetOwner: the owner writers are the blocked multi-arg ones
+// above, tech is a per-player value in the engine (SWFOC_SetTechLevel), and
+// RVA::Planet::kBuiltCount only counts structures. Outside galactic mode
+// the edits are recorded by name, unresolved, as ChangePlanetOwner's are.
+static PlanetBatchEdit g_planetBatch[PLANET_BATCH_MAX];
+
+static int Lua_PlanetBatch(lua_State* L) {
+    const char* spec = fn_tostring(L, 1);
+    char msg[160];
+    int n = 0, bad = 0;
+    const int pr = PlanetBatchParse(spec, g_planetBatch, PLANET_BATCH_MAX, &n, &bad);
+    if (pr != PLANET_BATCH_PARSE_OK) {
+        _snprintf_s(msg, sizeof(msg), _TRUNCATE, "ERR: SWFOC_PlanetBatch: entry %d: %s", bad,
+                    PlanetBatchParseError(pr));
+        fn_pushstring(L, msg);
+        return 1;
+    }
+
+    const PlanetTable* t = GetPlanetTable(false);
+    int missing = PlanetBatchResolve(t, g_planetBatch, n);
+    bool stale = false;
+    for (int i = 0; i < n && !stale; i++) stale = g_planetBatch[i].id >= 0 && !PlanetObjLive(g_planetBatch[i].obj);
+    if (t->count && (missing >= 0 || stale)) {
+        t = GetPlanetTable(true);
+        missing = PlanetBatchResolve(t, g_planetBatch, n);
+    }
+    if (t->count && missing >= 0) {
+        _snprintf_s(msg, sizeof(msg), _TRUNCATE, "ERR: SWFOC_PlanetBatch: unknown planet '%s' (entry %d)",
+                    g_planetBatch[missing].name, missing);
+        fn_pushstring(L, msg);
+        return 1;
+    }
+
+    const uint32_t writes = PlanetBatchFold(&g_pendingJournal, &g_pendingState, g_planetBatch, n);
+    Log("[Bridge] PlanetBatch(%d planets, %u writes) -- Phase 1, %s\n", n, writes,
+        t->count ? "resolved" : "by name (no galactic session)");
+    _snprintf_s(msg, sizeof(msg), _TRUNCATE,
+                "OK: planet batch recorded planets=%d writes=%u resolved=%d session_planets=%u", n, writes,
+                t->count ? n : 0, t->count);
+    fn_pushstring(L, msg);
+    return 1;
+}
+
 // SWFOC_SpawnAsStoryArrival(type, planet, faction) — Phase 1 mirror
 // added in iter 137. Same situation as ChangePlanetOwnerWithMode:
 // editor's BridgeGalacticDispatcher.SpawnAsStoryArrivalAsync called
@@ -6326,22 +8692,16 @@ static int Lua_ListHeroes(lua_State* L) {
 }
 
 // SWFOC_SetHeroRespawnTimer / SWFOC_SetPermadeath live stubs. Phase 1
-// stores values in module-local maps keyed by obj_addr so the UI can
-// round-trip without errors; Phase 2 wires through to the engine's
-// hero respawn-timer field (currently UNVERIFIED in re-findings).
-static std::unordered_map<uintptr_t, int32_t> g_pendingRespawnWrites;
-static std::unordered_map<uintptr_t, bool>    g_pendingPermadeathWrites;
-static CRITICAL_SECTION g_heroLock;
-static bool g_heroLockInit = false;
-static void EnsureHeroLock() {
-    if (!g_heroLockInit) {
-        InitializeCriticalSection(&g_heroLock);
-        g_heroLockInit = true;
-    }
+// journals values keyed by obj_addr so the UI can round-trip without
+// errors; Phase 2 wires through to the engine's hero respawn-timer field
+// (currently UNVERIFIED in re-findings).
+static PendingWrite PendingHeroWrite(uint8_t kind, uintptr_t addr, double value, bool flag) {
+    PendingWrite w = PendingGlobal(kind, value, flag);
+    w.key = static_cast<uint64_t>(addr);
+    return w;
 }
 
 static int Lua_SetHeroRespawnTimer(lua_State* L) {
-    EnsureHeroLock();
     double rawAddr = fn_tonumber(L, 1);
     double ms = fn_tonumber(L, 2);
     uintptr_t addr = static_cast<uintptr_t>(static_cast<uint64_t>(rawAddr));
@@ -6355,9 +8715,8 @@ static int Lua_SetHeroRespawnTimer(lua_State* L) {
     }
     int32_t clamped = static_cast<int32_t>(ms);
     if (clamped < 0) clamped = 0;
-    EnterCriticalSection(&g_heroLock);
-    g_pendingRespawnWrites[addr] = clamped;
-    LeaveCriticalSection(&g_heroLock);
+    if (!PendingQueue(L, "SWFOC_SetHeroRespawnTimer",
+                      PendingHeroWrite(PENDING_RESPAWN_TIMER, addr, clamped, false))) return 1;
     Log("[Bridge] SetHeroRespawnTimer(0x%llX, %dms) -- Phase 1 pending\n",
         (unsigned long long)addr, clamped);
     fn_pushstring(L, "OK: respawn timer recorded (Phase 2 live wire-through pending)");
@@ -6365,7 +8724,6 @@ static int Lua_SetHeroRespawnTimer(lua_State* L) {
 }
 
 static int Lua_SetPermadeath(lua_State* L) {
-    EnsureHeroLock();
     double rawAddr = fn_tonumber(L, 1);
     int flag = static_cast<int>(fn_tonumber(L, 2));
     uintptr_t addr = static_cast<uintptr_t>(static_cast<uint64_t>(rawAddr));
@@ -6377,9 +8735,7 @@ static int Lua_SetPermadeath(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_SetPermadeath: enemy heroes READ-ONLY");
         return 1;
     }
-    EnterCriticalSection(&g_heroLock);
-    g_pendingPermadeathWrites[addr] = (flag != 0);
-    LeaveCriticalSection(&g_heroLock);
+    if (!PendingQueue(L, "SWFOC_SetPermadeath", PendingHeroWrite(PENDING_PERMADEATH, addr, 0.0, flag != 0))) return 1;
     Log("[Bridge] SetPermadeath(0x%llX, %d) -- Phase 1 pending\n",
         (unsigned long long)addr, flag);
     fn_pushstring(L, "OK: permadeath flag recorded (Phase 2 live wire-through pending)");
@@ -6646,9 +9002,8 @@ static int Lua_GetUnitShield(lua_State* L) {
 
 // SWFOC_HeroStatEdit(obj_addr, field, value) -> "OK: ..." or "ERR: ...".
 // Task 138 (2026-04-23). Dispatcher placed AFTER every per-field helper
-// so it can reference the shared locks/maps (g_shieldLock, g_speedLock,
-// g_heroLock) and their respective CriticalSections without forward
-// declarations. The live path does NOT gate on is_hero (the bridge
+// so it can reference the shared locks/maps (g_shieldLock, g_speedLock)
+// and PendingHeroWrite without forward declarations. The live path does NOT gate on is_hero (the bridge
 // cannot detect it until Phase 2 of #134); only the replay mirror
 // rejects non-heroes. Enemy READ-ONLY is enforced.
 static int Lua_HeroStatEdit(lua_State* L) {
@@ -6706,12 +9061,10 @@ static int Lua_HeroStatEdit(lua_State* L) {
         return 1;
     }
     if (f == "respawn_ms") {
-        EnsureHeroLock();
-        EnterCriticalSection(&g_heroLock);
         int32_t clamped = static_cast<int32_t>(value);
         if (clamped < 0) clamped = 0;
-        g_pendingRespawnWrites[addr] = clamped;
-        LeaveCriticalSection(&g_heroLock);
+        if (!PendingQueue(L, "SWFOC_HeroStatEdit",
+                          PendingHeroWrite(PENDING_RESPAWN_TIMER, addr, clamped, false))) return 1;
         fn_pushstring(L, "OK: respawn_ms recorded (Phase 2 pending)");
         return 1;
     }
@@ -6722,7 +9075,7 @@ static int Lua_HeroStatEdit(lua_State* L) {
 
 // SWFOC_SetUnitField(addr, field, value) — iter-136 partial-LIVE
 // implementation. Forward-declared at the top of this file (near the
-// PendingUnitFieldWrite struct) so RegisterAll can reference it; defined
+// Phase-1 notes) so RegisterAll can reference it; defined
 // here so it can mirror Lua_HeroStatEdit's per-field LIVE branches that
 // rely on shield/speed primitives defined just above.
 //
@@ -6730,7 +9083,7 @@ static int Lua_HeroStatEdit(lua_State* L) {
 //   hull   → direct write to addr+RVA::GameObj::HP                   (LIVE)
 //   shield → SetFrontShield + SetRearShield (engine helpers)         (LIVE iter 129)
 //   speed  → SetSpeedOverride                                        (LIVE iter 100)
-//   anything else → fall through to g_pendingUnitFieldWrites Phase-1 mirror
+//   anything else → fall through to the PENDING_UNIT_FIELD Phase-1 mirror
 //
 // Safety semantics match Lua_HeroStatEdit:
 //   - IsValidObjAddr gate
@@ -6738,7 +9091,6 @@ static int Lua_HeroStatEdit(lua_State* L) {
 // (The Phase-1 fallback path also gates on these now — was unguarded
 // pre-iter-136. UnitStatEditor edits land on local heroes/units only.)
 static int Lua_SetUnitField(lua_State* L) {
-    EnsureUnitFieldLock();
     uint64_t    addrRaw = static_cast<uint64_t>(fn_tonumber(L, 1));
     const char* raw_f   = fn_tostring(L, 2);
     float       val     = static_cast<float>(fn_tonumber(L, 3));
@@ -6884,21 +9236,144 @@ static int Lua_SetUnitField(lua_State* L) {
         return 1;
     }
 
-    // Phase-1 mirror fall-through for the remaining 6 sub-fields
-    // (max_speed/attack_power/respawn_ms/
-    //  is_hero/respawn_enabled/owner_slot — owner_slot deferred to iter
-    //  247+ per iter-242 design; operator should use iter-108
-    //  SWFOC_ChangeUnitOwnerLua for engine-aware ownership change).
-    PendingUnitFieldWrite w;
-    w.obj_addr = addrRaw;
-    w.field    = raw_f;
-    w.value    = val;
-    EnterCriticalSection(&g_unitFieldLock);
-    g_pendingUnitFieldWrites.push_back(w);
-    LeaveCriticalSection(&g_unitFieldLock);
-    Log("[Bridge] SetUnitField(addr=0x%llX, field=%s, value=%.3f) -- Phase 1 pending\n",
-        (unsigned long long)addr, raw_f, val);
-    fn_pushstring(L, "OK: unit-field write queued (Phase 2 offset-table hook pending)");
+    // Phase-1 mirror fall-through for the remaining 6 sub-fields
+    // (max_speed/attack_power/respawn_ms/
+    //  is_hero/respawn_enabled/owner_slot — owner_slot deferred to iter
+    //  247+ per iter-242 design; operator should use iter-108
+    //  SWFOC_ChangeUnitOwnerLua for engine-aware ownership change).
+    PendingWrite w = PendingHeroWrite(PENDING_UNIT_FIELD, addr, val, false);
+    size_t n = strlen(raw_f);
+    if (n >= PENDING_NAME_MAX) n = PENDING_NAME_MAX;  // leaves no NUL -> BAD_NAME
+    memcpy(w.name, raw_f, n);
+    if (!PendingQueue(L, "SWFOC_SetUnitField", w)) return 1;
+    Log("[Bridge] SetUnitField(addr=0x%llX, field=%s, value=%.3f) -- Phase 1 pending\n",
+        (unsigned long long)addr, raw_f, val);
+    fn_pushstring(L, "OK: unit-field write queued (Phase 2 offset-table hook pending)");
+    return 1;
+}
+
+// ======================================================================
+// Bulk unit mutation (2026-10-14)
+// ----------------------------------------------------------------------
+// One plan (bulk_mutate.h), one pass over the per-tick unit index. Ops use
+// the same primitives as SWFOC_SetUnitField / SWFOC_SetUnitInvuln, and the
+// enemy READ-ONLY rule holds per unit: a matched unit not owned by the
+// local player is reported as "readonly" and left untouched.
+// ======================================================================
+
+static uint8_t ApplyBulkOp(uintptr_t addr, const BulkOp& op) {
+    switch (op.field) {
+        case BULK_HULL:
+            *reinterpret_cast<float*>(addr + RVA::GameObj::HP) = op.value;
+            return BULK_OK;
+        case BULK_INVULN:
+            return CallMakeInvulnerableInline(addr, op.value != 0.0f) ? BULK_OK : BULK_FAIL_INVULN_PATH;
+        case BULK_INVULN_FLAG:
+            *reinterpret_cast<uint8_t*>(addr + RVA::GameObj::InvulnFlag) = (op.value != 0.0f) ? 1 : 0;
+            return BULK_OK;
+        case BULK_PREVENT_DEATH: {
+            uint8_t* flagByte = reinterpret_cast<uint8_t*>(addr + RVA::GameObj::PreventDeath);
+            if (op.value != 0.0f) *flagByte |= static_cast<uint8_t>(0x80);
+            else                  *flagByte &= static_cast<uint8_t>(0x7F);
+            return BULK_OK;
+        }
+        case BULK_SHIELD: {
+            EnsureShieldLock();
+            auto fnSetFront = Resolve<pfn_SetFrontShield>(RVA::SetFrontShield);
+            auto fnSetRear  = Resolve<pfn_SetRearShield>(RVA::SetRearShield);
+            if (!fnSetFront && !fnSetRear) return BULK_FAIL_NO_ENGINE_FN;
+            if (fnSetFront) fnSetFront(reinterpret_cast<void*>(addr), op.value);
+            if (fnSetRear)  fnSetRear(reinterpret_cast<void*>(addr), op.value);
+            EnterCriticalSection(&g_shieldLock);
+            g_unitShieldOverrideMap[addr] = op.value;
+            LeaveCriticalSection(&g_shieldLock);
+            return BULK_OK;
+        }
+        case BULK_SPEED: {
+            auto fnSetOverride = Resolve<pfn_SetSpeedOverride>(RVA::SetSpeedOverride);
+            if (!fnSetOverride) return BULK_FAIL_NO_ENGINE_FN;
+            EnsureSpeedLock();
+            EnterCriticalSection(&g_speedLock);
+            g_unitSpeedOverrideMap[addr] = op.value;
+            LeaveCriticalSection(&g_speedLock);
+            fnSetOverride(reinterpret_cast<void*>(addr), op.value);
+            return BULK_OK;
+        }
+    }
+    return BULK_OK;
+}
+
+// Main thread only. Applies every op of `plan` to each matching unit and
+// records the first failing op per unit.
+static void ApplyBulkPlan(BulkPlan* plan, BulkResult* out) {
+    memset(out, 0, sizeof(*out));
+    BulkFilter& f = plan->filter;
+    if (f.typeOf) {
+        f.typePtr = IsValidObjAddr((uintptr_t)f.typeOf)
+            ? *reinterpret_cast<uintptr_t*>((uintptr_t)f.typeOf + RVA::GameObj::GameObjType) : 0;
+        if (!f.typePtr) return;
+    }
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    const int rows = f.owner >= 0 ? UnitIndexOwnerCount(idx, f.owner) : idx->count;
+    const uint16_t* pos = UnitIndexOwnerUnits(idx, f.owner);
+    for (int r = 0; r < rows; r++) {
+        const int i = f.owner >= 0 ? pos[r] : r;
+        const uintptr_t addr = (uintptr_t)idx->objs[i];
+        BulkUnitView u;
+        u.owner    = idx->owner[i];
+        u.local    = IsObjOwnedByHuman(addr);
+        u.selected = UnitIndexIsSelected(idx, addr);
+        u.typePtr  = f.typeOf ? *reinterpret_cast<uintptr_t*>(addr + RVA::GameObj::GameObjType) : 0;
+        if (!BulkFilterMatches(f, u)) continue;
+        out->matched++;
+        if (!u.local) {
+            BulkResultFail(out, addr, BULK_FAIL_READONLY);
+            continue;
+        }
+        uint8_t code = BULK_OK;
+        for (int k = 0; k < plan->opCount && code == BULK_OK; k++) code = ApplyBulkOp(addr, plan->ops[k]);
+        if (code == BULK_OK) out->applied++;
+        else BulkResultFail(out, addr, code);
+    }
+}
+
+// SWFOC_BulkMutateUnits(filter, ops) -> "count=<applied>;matched=<M>;failed=<F>|<addr>:<code>|..."
+// Example: SWFOC_BulkMutateUnits("local,selected", "hull=99999;prevent_death=1")
+// Filter and op grammar: bulk_mutate.h. Failure codes: readonly,
+// invuln_path, no_engine_fn; at most BULK_MAX_FAILURES are listed, then
+// "...+N". An unresolvable type= unit matches nothing.
+static int Lua_BulkMutateUnits(lua_State* L) {
+    const char* filterArg = (fn_gettop(L) >= 1) ? fn_tostring(L, 1) : nullptr;
+    const char* opsArg    = (fn_gettop(L) >= 2) ? fn_tostring(L, 2) : nullptr;
+    BulkPlan plan;
+    const char* bad = nullptr;
+    char err[160];
+    if (!BulkParseFilter(filterArg, &plan.filter, &bad)) {
+        snprintf(err, sizeof(err), "ERR: SWFOC_BulkMutateUnits: bad filter term '%.40s'", bad ? bad : "");
+        fn_pushstring(L, err);
+        return 1;
+    }
+    if (!BulkParseOps(opsArg, &plan, &bad)) {
+        snprintf(err, sizeof(err), "ERR: SWFOC_BulkMutateUnits: bad op '%.40s'", bad ? bad : "");
+        fn_pushstring(L, err);
+        return 1;
+    }
+    static BulkResult s_result;
+    ApplyBulkPlan(&plan, &s_result);
+
+    char buf[64 + BULK_MAX_FAILURES * 40];
+    size_t off = 0;
+    off = SafeAppendFmt(buf, off, sizeof(buf), "count=%d;matched=%d;failed=%d",
+                        s_result.applied, s_result.matched, s_result.failed);
+    for (int i = 0; i < s_result.listed; i++) {
+        off = SafeAppendFmt(buf, off, sizeof(buf), "|%llu:%s",
+                            (unsigned long long)s_result.failAddr[i], BulkFailureName(s_result.failCode[i]));
+    }
+    if (s_result.failed > s_result.listed)
+        off = SafeAppendFmt(buf, off, sizeof(buf), "|...+%d", s_result.failed - s_result.listed);
+    Log("[Bridge] BulkMutateUnits(%s, %s): matched=%d applied=%d failed=%d\n",
+        filterArg ? filterArg : "", opsArg ? opsArg : "", s_result.matched, s_result.applied, s_result.failed);
+    fn_pushstring(L, buf);
     return 1;
 }
 
@@ -7016,7 +9491,7 @@ static int Lua_ReviveUnit(lua_State* L) {
 //     - g_dmgMult_global (applied to all damage when slot=-1 was passed
 //       to SWFOC_SetDamageMultiplier(-1, mult)) → IMPLEMENTABLE via a
 //       Take_Damage detour at this chokepoint. Reliable. Single hook.
-//     - g_dmgMult_perSlot[slot] (per-attacker semantics) → NOT
+//     - the per-slot multiplier (per-attacker semantics) → NOT
 //       IMPLEMENTABLE at Take_Damage. Needs detours at the ~58 caller
 //       sites that have an attacker context (e.g., weapon-fire paths).
 //       Defer to a future arc that pins those caller layers.
@@ -7038,9 +9513,10 @@ static int Lua_ReviveUnit(lua_State* L) {
 // Until the detour lands, the stored values are inert from the game's
 // perspective -- the replay harness mirror at ReplayObsGetDamageMultiplier
 // provides the full behavioural contract for offline tests.
-static constexpr int kDmgMultMaxSlot = 16;
+//
+// 2026-10-14: the per-slot values moved into g_slotMods (SLOT_MOD_DAMAGE),
+// still inert; 1.0 now means "no override", so 0 is a real per-slot value.
 static float g_dmgMult_global = 1.0f;
-static float g_dmgMult_perSlot[kDmgMultMaxSlot] = {0};
 static CRITICAL_SECTION g_dmgMultLock;
 static bool g_dmgMultLockInit = false;
 
@@ -7048,7 +9524,6 @@ static void EnsureDamageMultiplierLock() {
     if (!g_dmgMultLockInit) {
         InitializeCriticalSection(&g_dmgMultLock);
         g_dmgMultLockInit = true;
-        for (int i = 0; i < kDmgMultMaxSlot; i++) g_dmgMult_perSlot[i] = 0.0f;
     }
 }
 
@@ -7072,16 +9547,14 @@ static int Lua_SetDamageMultiplier(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_SetDamageMultiplier: multiplier must be >= 0");
         return 1;
     }
-    EnterCriticalSection(&g_dmgMultLock);
     if (slot < 0) {
+        EnterCriticalSection(&g_dmgMultLock);
         g_dmgMult_global = static_cast<float>(mult);
-    } else if (slot < kDmgMultMaxSlot) {
-        // Zero is the sentinel "no override" value. Callers who genuinely
-        // want zero damage for this slot should use a very small value
-        // like 0.0001 instead -- safer than colliding with the sentinel.
-        g_dmgMult_perSlot[slot] = (mult == 1.0 ? 0.0f : static_cast<float>(mult));
+        CombatModSet(&g_combatMods, COMBAT_MOD_DAMAGE_MULT, g_dmgMult_global != 1.0f);
+        LeaveCriticalSection(&g_dmgMultLock);
+    } else {
+        SlotModSet(&g_slotMods, slot, SLOT_MOD_DAMAGE, static_cast<float>(mult));
     }
-    LeaveCriticalSection(&g_dmgMultLock);
     Log("[Bridge] SetDamageMultiplier(slot=%d, mult=%.3f)\n", slot, mult);
     fn_pushstring(L, "OK: damage multiplier stored (Phase 2 detour pending)");
     return 1;
@@ -7090,12 +9563,15 @@ static int Lua_SetDamageMultiplier(lua_State* L) {
 static int Lua_GetDamageMultiplier(lua_State* L) {
     EnsureDamageMultiplierLock();
     int slot = static_cast<int>(fn_tonumber(L, 1));
-    float effective = g_dmgMult_global;
-    EnterCriticalSection(&g_dmgMultLock);
-    if (slot >= 0 && slot < kDmgMultMaxSlot && g_dmgMult_perSlot[slot] != 0.0f) {
-        effective = g_dmgMult_perSlot[slot];
+    const SlotModifiers* mods = SlotModActive(&g_slotMods, slot);
+    float effective;
+    if (mods && (mods->active.load(std::memory_order_relaxed) & SLOT_MOD_DAMAGE)) {
+        effective = mods->damage.load(std::memory_order_relaxed);
+    } else {
+        EnterCriticalSection(&g_dmgMultLock);
+        effective = g_dmgMult_global;
+        LeaveCriticalSection(&g_dmgMultLock);
     }
-    LeaveCriticalSection(&g_dmgMultLock);
     fn_pushnumber(L, static_cast<double>(effective));
     return 1;
 }
@@ -7114,6 +9590,7 @@ static int Lua_SetDamageMultiplierGlobal(lua_State* L) {
     }
     EnterCriticalSection(&g_dmgMultLock);
     g_dmgMult_global = static_cast<float>(mult);
+    CombatModSet(&g_combatMods, COMBAT_MOD_DAMAGE_MULT, g_dmgMult_global != 1.0f);
     LeaveCriticalSection(&g_dmgMultLock);
     Log("[Bridge] SetDamageMultiplierGlobal(mult=%.3f) -- LIVE\n", mult);
     fn_pushstring(L, "OK: global damage multiplier applied (LIVE — Take_Damage_Outer detour)");
@@ -7153,6 +9630,7 @@ typedef void (__fastcall *pfn_WeaponTick)(__int64, int);
 static pfn_WeaponTick real_WeaponTick = nullptr;
 
 static void __fastcall Hook_WeaponTick(__int64 a1, int a2) {
+    HookCostTimer cost(HOOK_COST_WEAPON_TICK);
     // Read last_tick from a1 + 96 (per iter-224 RE finding). Scale dt by
     // g_fireRateMult_global before delegating. The original WeaponTick will
     // re-read last_tick from a1+96 and compute dt itself; we synthesize an
@@ -7160,7 +9638,7 @@ static void __fastcall Hook_WeaponTick(__int64 a1, int a2) {
     const float mult = g_fireRateMult_global.load(std::memory_order_relaxed);
     if (mult == 1.0f) {
         // Fast path: no scaling, no overhead.
-        real_WeaponTick(a1, a2);
+        cost.original(real_WeaponTick, a1, a2);
         return;
     }
     const int last_tick = *reinterpret_cast<int*>(a1 + 96);
@@ -7168,7 +9646,7 @@ static void __fastcall Hook_WeaponTick(__int64 a1, int a2) {
     // Scale dt by multiplier; pass synthesized a2 = last_tick + scaled_dt.
     const int scaled_dt = static_cast<int>(static_cast<float>(dt) * mult);
     const int scaled_a2 = last_tick + scaled_dt;
-    real_WeaponTick(a1, scaled_a2);
+    cost.original(real_WeaponTick, a1, scaled_a2);
 }
 
 static int Lua_SetFireRateMultiplierGlobal(lua_State* L) {
@@ -7240,28 +9718,68 @@ extern "C" void SWFOC_TEST_ResetCounters() {
     g_localPlayerDeaths.store(0, std::memory_order_relaxed);
 }
 
+// Valid objects in the tactical list, from the per-tick unit index. Main
+// thread only -- nodes can be freed under a reader on any other thread.
+// Unlike the old raw node count, objects failing IsValidObjAddr are left out.
+static int CountTotalUnitsAlive() {
+    return GetTacticalUnitIndex()->count;
+}
+
 static int Lua_GetTotalUnitsAlive(lua_State* L) {
-    int count = 0;
-    auto inner_ptr = *reinterpret_cast<uintptr_t*>(g_base + RVA::GameModeRoot_Global);
-    if (inner_ptr) {
-        // GameModeRoot_Global -> GameModeClass*; Selection chain at +0x18.
-        auto sel_base = *reinterpret_cast<uintptr_t*>(inner_ptr + 0x18);
-        if (sel_base) {
-            auto list_head = *reinterpret_cast<uintptr_t*>(sel_base + RVA::Selection::kObjectListHead);
-            const uintptr_t sentinel = sel_base + RVA::Selection::kObjectListSentinel;
-            uintptr_t node = list_head;
-            while (node && node != sentinel && count < RVA::Selection::kMaxTacticalObjects) {
-                count++;
-                uintptr_t next = *reinterpret_cast<uintptr_t*>(node + RVA::Selection::kNodeNext);
-                if (next == node) break;  // self-cycle defensive guard
-                node = next;
-            }
-        }
-    }
-    fn_pushnumber(L, static_cast<double>(count));
+    fn_pushnumber(L, static_cast<double>(CountTotalUnitsAlive()));
     return 1;
 }
 
+// ======================================================================
+// 2026-10-14: binary "@telemetry" pipe reply (pipe_protocol.h)
+// ======================================================================
+//
+// The HUD used to fetch these counters as Lua strings and std::stoi them
+// back. "@telemetry" is answered on the pipe thread with a packed
+// PipeTelemetry record instead, so it never enters the VM or waits for a
+// drain. Kills / deaths / multipliers are already atomics. Slot, credits
+// and units-alive come from game memory the pipe thread must not walk, so
+// Hook_luaD_call samples them every TELEMETRY_SAMPLE_MASK + 1 ticks into
+// the atomics below; `sampleTick` tells the client how fresh they are.
+
+#define TELEMETRY_SAMPLE_MASK 0x3FF
+
+static std::atomic<int>      g_telemetrySlot{-1};
+static std::atomic<float>    g_telemetryCredits{0.0f};
+static std::atomic<int>      g_telemetryUnitsAlive{0};
+static std::atomic<LONGLONG> g_telemetrySampleTick{0};
+
+// Main thread (registered state) only.
+static void SampleTelemetry(LONGLONG tick) {
+    const PlayerTable* t = GetPlayerTable();
+    const int slot = t->localSlot;
+    const PlayerRow* r = PlayerTableRow(t, slot);
+    const float credits = r ? r->credits : 0.0f;
+    g_telemetrySlot.store(slot, std::memory_order_relaxed);
+    g_telemetryCredits.store(credits, std::memory_order_relaxed);
+    g_telemetryUnitsAlive.store(CountTotalUnitsAlive(), std::memory_order_relaxed);
+    g_telemetrySampleTick.store(tick, std::memory_order_release);
+    // 2026-10-14: keeps EVT_SELECTION flowing while no reader asks.
+    const ULONGLONG now = GetTickCount64();
+    if (!SelectionTrackerFresh(&g_selection, tick, now)) SampleSelection(tick, now);
+}
+
+static void FillPipeTelemetry(PipeTelemetry* t) {
+    memset(t, 0, sizeof(*t));
+    t->magic        = PIPE_TELEMETRY_MAGIC;
+    t->version      = PIPE_TELEMETRY_VERSION;
+    t->size         = (uint16_t)sizeof(*t);
+    t->sampleTick   = g_telemetrySampleTick.load(std::memory_order_acquire);
+    t->localSlot    = g_telemetrySlot.load(std::memory_order_relaxed);
+    t->credits      = g_telemetryCredits.load(std::memory_order_relaxed);
+    t->unitsAlive   = g_telemetryUnitsAlive.load(std::memory_order_relaxed);
+    t->kills        = g_localPlayerKills.load(std::memory_order_relaxed);
+    t->deaths       = g_localPlayerDeaths.load(std::memory_order_relaxed);
+    t->damageMult   = g_dmgMult_global;  // aligned 32-bit load
+    t->fireRateMult = g_fireRateMult_global.load(std::memory_order_relaxed);
+    t->tick         = g_luaDCallTickCounter;
+}
+
 // ======================================================================
 // 2026-05-06 (iter 230-231): FreezeCredits global-level LIVE wire
 // ======================================================================
@@ -7280,6 +9798,10 @@ static int Lua_GetTotalUnitsAlive(lua_State* L) {
 //
 // Bool freeze wins-over-mult precedence (avoids ambiguity when both are set).
 //
+// 2026-10-14: per-slot knobs (SWFOC_SetIncomeMultiplier, SetFreezeCredits)
+// come from g_slotMods, keyed by PlayerClass+0x48 (SlotIndex). Order: global
+// freeze, slot freeze, then slot income x global mult on positive deltas.
+//
 // Engine semantic caveats (from iter-230 design doc):
 //   - cap at PlayerClass+0x74 still applies (mult=2 doesn't let you exceed cap)
 //   - negative-balance-guard already engine-side (deductions can't push balance < 0)
@@ -7292,6 +9814,7 @@ typedef float (__fastcall *pfn_AddCredits)(__int64, float, char);
 static pfn_AddCredits real_AddCredits = nullptr;
 
 static float __fastcall Hook_AddCredits(__int64 a1, float a2, char a3) {
+    HookCostTimer cost(HOOK_COST_ADD_CREDITS);
     // Bool freeze precedence: short-circuit ENTIRELY. Don't call original;
     // that prevents the +0x70 write, the event notification, and the
     // tracking callback. Returns the unchanged balance the same way the
@@ -7299,6 +9822,12 @@ static float __fastcall Hook_AddCredits(__int64 a1, float a2, char a3) {
     if (g_creditsFreeze_global.load(std::memory_order_relaxed)) {
         return *reinterpret_cast<float*>(a1 + 112);
     }
+    if (g_slotMods.slotsActive.load(std::memory_order_relaxed)) {
+        const int slot = *reinterpret_cast<int32_t*>(a1 + RVA::PlayerObj::SlotIndex);
+        if (!SlotModApplyCredits(&g_slotMods, slot, &a2)) {
+            return *reinterpret_cast<float*>(a1 + 112);
+        }
+    }
 
     // Multiplier mode: scale POSITIVE deltas only (income).
     // 2026-05-20 BUGFIX: previously `a2 * mult` scaled BOTH gains and spends.
@@ -7308,10 +9837,11 @@ static float __fastcall Hook_AddCredits(__int64 a1, float a2, char a3) {
     // Sign-gate: a2 > 0 means credits IN (income/reward), a2 <= 0 means
     // credits OUT (purchase) and stays unmultiplied.
     const float mult = g_creditsMult_global.load(std::memory_order_relaxed);
-    if (mult == 1.0f || a2 <= 0.0f) {
-        return real_AddCredits(a1, a2, a3);
-    }
-    return real_AddCredits(a1, a2 * mult, a3);
+    const float balance = (mult == 1.0f || a2 <= 0.0f)
+        ? cost.original(real_AddCredits, a1, a2, a3)
+        : cost.original(real_AddCredits, a1, a2 * mult, a3);
+    InvalidatePlayerTable();  // the original wrote +0x70
+    return balance;
 }
 
 static int Lua_SetCreditsFreezeGlobal(lua_State* L) {
@@ -7330,11 +9860,17 @@ static int Lua_GetCreditsFreezeGlobal(lua_State* L) {
     return 1;
 }
 
-static int Lua_SetCreditsMultiplierGlobal(lua_State* L) {
-    double mult = fn_tonumber(L, 1);
+static void StoreGlobalCreditsMultiplier(double mult) {
     if (mult < 0.0) mult = 0.0;        // no negative deltas
     if (mult > 100.0) mult = 100.0;    // overflow guard
     g_creditsMult_global.store(static_cast<float>(mult), std::memory_order_relaxed);
+}
+
+static int Lua_SetCreditsMultiplierGlobal(lua_State* L) {
+    double mult = fn_tonumber(L, 1);
+    if (mult < 0.0) mult = 0.0;
+    if (mult > 100.0) mult = 100.0;
+    StoreGlobalCreditsMultiplier(mult);
     Log("[Bridge] SetCreditsMultiplierGlobal(mult=%.3f) -- LIVE\n", mult);
     fn_pushstring(L, "OK: credit multiplier applied (LIVE -- AddCredits delta scaling)");
     return 1;
@@ -7351,77 +9887,160 @@ static int Lua_GetCreditsMultiplierGlobal(lua_State* L) {
 // filters rows by OwnerPlayerID. Same row shape as #104 so the V2
 // Spawning tab (#149) can reuse its parser. Negative slots return
 // "count=0" -- the engine's owner=-1 sentinel is not a valid filter
-// target.
+// target. SWFOC_EnumerateUnits(slot, "bin") fills the shared unit table
+// instead (see PushUnitTable).
 static int Lua_EnumerateUnits(lua_State* L) {
     int slot = static_cast<int>(fn_tonumber(L, 1));
     if (slot < 0) {
         fn_pushstring(L, "count=0");
         return 1;
     }
-    static constexpr int kMax = RVA::Selection::kMaxTacticalObjects;
-    static thread_local uintptr_t s_objs[kMax];
-    int count = WalkAllTacticalObjects(s_objs, kMax);
-    if (count <= 0) {
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    if (IsBinaryUnitMode(L, 2)) return PushUnitTable(L, idx, slot);
+    const int matched = UnitIndexOwnerCount(idx, slot);
+    if (matched <= 0) {
         fn_pushstring(L, "count=0");
         return 1;
     }
-
-    // Pre-resolve selection once for the is_selected column.
-    uintptr_t selVec = 0;
-    uintptr_t selObjs[RVA::Selection::kMaxSelectionCount];
-    int selCount = 0;
-    if (ResolveSelectionVector(selVec)) {
-        selCount = WalkSelectionVector(selVec, selObjs, RVA::Selection::kMaxSelectionCount);
-        if (selCount < 0) selCount = 0;
-    }
-    auto isSelected = [&](uintptr_t obj) {
-        for (int i = 0; i < selCount; i++) if (selObjs[i] == obj) return 1;
-        return 0;
-    };
+    const uint16_t* pos = UnitIndexOwnerUnits(idx, slot);
     int localSlot = FindLocalPlayerSlot();
 
     constexpr size_t kBufCap = 65536;
-    char* buf = reinterpret_cast<char*>(malloc(kBufCap));
+    const size_t cap = std::min(kBufCap, CsvRowCapacity(32, (size_t)matched, CSV_UNIT_ROW_MAX));
+    char* buf = reinterpret_cast<char*>(malloc(cap));
     if (!buf) {
         fn_pushstring(L, "ERR: SWFOC_EnumerateUnits: alloc failed");
         return 1;
     }
 
-    // First pass: count matching rows so the header is accurate.
-    int matched = 0;
-    for (int i = 0; i < count; i++) {
-        uintptr_t obj = s_objs[i];
-        if (!IsValidObjAddr(obj)) continue;
-        int32_t owner = *reinterpret_cast<int32_t*>(obj + RVA::GameObj::OwnerPlayerID);
-        if (owner == slot) matched++;
-    }
-    size_t off = 0;
-    off = SafeAppendFmt(buf, off, kBufCap, "count=%d", matched);
-    for (int i = 0; i < count; i++) {
-        uintptr_t obj = s_objs[i];
-        if (!IsValidObjAddr(obj)) continue;
-        int32_t owner = *reinterpret_cast<int32_t*>(obj + RVA::GameObj::OwnerPlayerID);
-        if (owner != slot) continue;
+    // One pass over the slot's bucket; the header count comes from the index.
+    CsvRow row;
+    CsvRowInit(&row, buf, cap);
+    CsvRowCount(&row, matched);
+    for (int r = 0; r < matched; r++) {
+        const int i = pos[r];
+        uintptr_t obj = (uintptr_t)idx->objs[i];
+        int32_t owner = idx->owner[i];
         float   hull  = *reinterpret_cast<float*>(obj + RVA::GameObj::HP);
         uint8_t iflag = *reinterpret_cast<uint8_t*>(obj + RVA::GameObj::InvulnFlag);
         uint8_t pdb   = (*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::PreventDeath) & 0x80) ? 1 : 0;
         int is_local  = (owner == localSlot) ? 1 : 0;
-        int selected  = isSelected(obj);
-        off = SafeAppendFmt(
-            buf, off, kBufCap,
-            "|%llu;%d;%.3f;%u;%u;%d;%d",
-            (unsigned long long)obj,
-            (int)owner, hull,
-            (unsigned)iflag, (unsigned)pdb,
-            is_local, selected);
-        if (off >= kBufCap - 128) {
-            SafeAppendFmt(buf, off, kBufCap, "|...+truncated");
+        int selected  = UnitIndexIsSelected(idx, obj) ? 1 : 0;
+        CsvRowUnit(&row, (uint64_t)obj, owner, hull, iflag, pdb, is_local, selected);
+        if (row.len >= kBufCap - 128) {
+            CsvRowStr(&row, "|...+truncated");
             break;
         }
     }
     fn_pushstring(L, buf);
     free(buf);
-    Log("[Bridge] EnumerateUnits(slot=%d): matched=%d / %d\n", slot, matched, count);
+    Log("[Bridge] EnumerateUnits(slot=%d): matched=%d / %d\n", slot, matched, idx->count);
+    return 1;
+}
+
+// SWFOC_EnumerateUnitsT(slot) -> the rows of SWFOC_EnumerateUnits(slot) as
+// SWFOC_ListTacticalUnitsT records; {} for a negative or empty slot.
+static int Lua_EnumerateUnitsT(lua_State* L) {
+    const int slot = static_cast<int>(fn_tonumber(L, 1));
+    LuaRows rows;
+    if (!BeginRowsReply(L, &rows, kUnitRowKeys, UNIT_ROW_KEYS, "SWFOC_EnumerateUnitsT")) return 1;
+    if (slot >= 0) {
+        const UnitIndex* idx = GetTacticalUnitIndex();
+        const int matched = UnitIndexOwnerCount(idx, slot);
+        const uint16_t* pos = UnitIndexOwnerUnits(idx, slot);
+        const int localSlot = FindLocalPlayerSlot();
+        for (int r = 0; r < matched; r++) AppendUnitRow(&rows, idx, pos[r], idx->owner[pos[r]] == localSlot);
+    }
+    LuaRowsEnd(&rows);
+    return 1;
+}
+
+// SWFOC_EnumerateUnitsDelta(slot, since) -> only the units that changed.
+//
+// 2026-10-14. Reads the unit index like SWFOC_EnumerateUnits (slot -1 =
+// every unit), folds it into a per-view shadow table (unit_shadow.h) and
+// returns the rows added, changed or removed after generation `since`:
+//
+//   gen=<G>;full=<0|1>;count=<N>|+addr;owner;hull;invuln_flag;prevent_death_bit|-addr|...
+//
+// Clients send back G next time. full=1 means `since` was unknown (first
+// call, 0, or too old after the shadow compacted removals) and the reply
+// lists every live unit: replace the grid instead of patching it. The reply
+// is sized to fit, never truncated.
+static UnitShadow* g_unitShadows[9] = {};  // [0] = every unit, [1 + slot]
+
+static int Lua_EnumerateUnitsDelta(lua_State* L) {
+    const int slot = (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER)
+        ? static_cast<int>(fn_tonumber(L, 1)) : -1;
+    const double sinceArg = (fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TNUMBER) ? fn_tonumber(L, 2) : 0.0;
+    const uint32_t since = (sinceArg > 0.0 && sinceArg < 4294967296.0) ? (uint32_t)sinceArg : 0;
+    if (slot < -1 || slot > 7) {
+        fn_pushstring(L, "ERR: SWFOC_EnumerateUnitsDelta: slot must be -1..7");
+        return 1;
+    }
+    UnitShadow*& sh = g_unitShadows[slot + 1];
+    if (!sh) {
+        sh = static_cast<UnitShadow*>(malloc(sizeof(UnitShadow)));
+        if (!sh) {
+            fn_pushstring(L, "ERR: SWFOC_EnumerateUnitsDelta: alloc failed");
+            return 1;
+        }
+        // Seed from the clock so a generation from an earlier session is
+        // not mistaken for a valid delta base.
+        UnitShadowInit(sh, (GetTickCount() | 1u) & 0x7FFFFFFFu);
+    }
+
+    const UnitIndex* idx = GetTacticalUnitIndex();
+    const int count = slot >= 0 ? UnitIndexOwnerCount(idx, slot) : idx->count;
+    const uint16_t* pos = UnitIndexOwnerUnits(idx, slot);
+    UnitShadowBegin(sh);
+    for (int r = 0; r < count; r++) {
+        const int i = slot >= 0 ? pos[r] : r;
+        uintptr_t obj = (uintptr_t)idx->objs[i];
+        UnitShadowRow row;
+        row.addr   = (uint64_t)obj;
+        row.owner  = idx->owner[i];
+        row.hull   = *reinterpret_cast<float*>(obj + RVA::GameObj::HP);
+        row.invuln = *reinterpret_cast<uint8_t*>(obj + RVA::GameObj::InvulnFlag);
+        row.pdb    = (*reinterpret_cast<uint8_t*>(obj + RVA::GameObj::PreventDeath) & 0x80) ? 1 : 0;
+        UnitShadowObserve(sh, row);
+    }
+    const uint32_t gen = UnitShadowEnd(sh);
+    const bool full = UnitShadowNeedsFull(sh, since);
+    const int rows = UnitShadowForEachSince(sh, since, [](const UnitShadowEntry&) {});
+
+    const size_t kBufCap = 64 + (size_t)rows * 96;  // widest row ~90 bytes
+    char* buf = reinterpret_cast<char*>(malloc(kBufCap));
+    if (!buf) {
+        fn_pushstring(L, "ERR: SWFOC_EnumerateUnitsDelta: alloc failed");
+        return 1;
+    }
+    CsvRow row;
+    CsvRowInit(&row, buf, kBufCap);
+    CsvRowStr(&row, "gen=");
+    CsvRowU64(&row, gen);
+    CsvRowStr(&row, full ? ";full=1;count=" : ";full=0;count=");
+    CsvRowI64(&row, rows);
+    UnitShadowForEachSince(sh, since, [&](const UnitShadowEntry& e) {
+        if (e.alive) {
+            // "|+%llu;%d;%.3f;%u;%u"
+            CsvRowStr(&row, "|+");
+            CsvRowU64(&row, e.addr);
+            CsvRowChar(&row, ';');
+            CsvRowI64(&row, e.owner);
+            CsvRowChar(&row, ';');
+            CsvRowFixed(&row, e.hull, 3);
+            CsvRowChar(&row, ';');
+            CsvRowU64(&row, e.invuln);
+            CsvRowChar(&row, ';');
+            CsvRowU64(&row, e.pdb);
+        } else {
+            CsvRowStr(&row, "|-");
+            CsvRowU64(&row, e.addr);
+        }
+    });
+    fn_pushstring(L, buf);
+    free(buf);
     return 1;
 }
 
@@ -7430,48 +10049,138 @@ static int Lua_EnumerateUnits(lua_State* L) {
 // Task 112 (2026-04-23). Row format (semicolon-separated, rows by '|'):
 //   timestamp_ms;obj_addr;owner_slot;requested_hp;current_hp
 //
-// "count=0" when empty. Draining is destructive: readers consume the
-// ring-buffer range [read_idx, write_idx) and advance read_idx past them.
-// Subsequent drains with no new events return "count=0" — which also
-// means the ring is safely drained before a new batch arrives.
+// "count=0" when empty. Draining is destructive: each call consumes up to
+// kDrainMaxRows events from the per-thread rings, merged by timestamp, and
+// leaves any remainder for the next call. Subsequent drains with no new
+// events return "count=0".
 static int Lua_EventStreamDrain(lua_State* L) {
+    constexpr int    kDrainMaxRows = 400;
+    static DamageEvent s_events[kDrainMaxRows];  // guarded by g_eventRingLock
     EnsureEventRingLock();
     EnterCriticalSection(&g_eventRingLock);
-    LONG write_idx = g_eventWriteIdx;
-    LONG read_idx  = g_eventReadIdx;
-    LONG diff = write_idx - read_idx;
-    if (diff < 0) diff = 0;
-    int count = (diff > kEventRingSize) ? kEventRingSize : static_cast<int>(diff);
-    int first_new = write_idx - count;
-
-    constexpr size_t kBufCap = 32768;
-    char* buf = reinterpret_cast<char*>(malloc(kBufCap));
+    const int count = DamageRingDrain(&g_damageRings, s_events, kDrainMaxRows);
+    // Rings are drained in index order; interleave threads by time.
+    std::stable_sort(s_events, s_events + count,
+        [](const DamageEvent& a, const DamageEvent& b) { return a.timestamp_ms < b.timestamp_ms; });
+
+    // Sized for every drained row: they have left the rings, so a row that
+    // did not fit would be lost.
+    // 400 widest rows stay under one 64 KB pipe reply.
+    const size_t cap = CsvRowCapacity(32, (size_t)count, CSV_EVENT_ROW_MAX);
+    char* buf = reinterpret_cast<char*>(malloc(cap));
     if (!buf) {
         LeaveCriticalSection(&g_eventRingLock);
         fn_pushstring(L, "ERR: SWFOC_EventStreamDrain: alloc failed");
         return 1;
     }
-    size_t off = 0;
-    off = SafeAppendFmt(buf, off, kBufCap, "count=%d", count);
+    CsvRow row;
+    CsvRowInit(&row, buf, cap);
+    CsvRowCount(&row, count);
     for (int i = 0; i < count; i++) {
-        const DamageEvent& ev = g_eventRing[(first_new + i) % kEventRingSize];
-        off = SafeAppendFmt(
-            buf, off, kBufCap,
-            "|%llu;%llu;%d;%.3f;%.3f",
-            (unsigned long long)ev.timestamp_ms,
-            (unsigned long long)ev.obj_addr,
-            (int)ev.owner_slot,
-            ev.requested_hp,
-            ev.current_hp);
-        if (off >= kBufCap - 80) break;
-    }
-    g_eventReadIdx = write_idx;
+        const DamageEvent& ev = s_events[i];
+        CsvRowDamageEvent(&row, ev.timestamp_ms, ev.obj_addr, ev.owner_slot, ev.requested_hp, ev.current_hp);
+    }
     LeaveCriticalSection(&g_eventRingLock);
     fn_pushstring(L, buf);
     free(buf);
     return 1;
 }
 
+// SWFOC_SetDamageEventLogging(enable) -> "OK: damage event logging on|off"
+// Stops (0) or resumes (non-zero) the SetHP damage events that
+// SWFOC_EventStreamDrain returns. With logging off and neither god mode nor
+// OHK on, Detour_SetHP forwards every write untouched. A bare call reports.
+static int Lua_SetDamageEventLogging(lua_State* L) {
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER) {
+        CombatModSet(&g_combatMods, COMBAT_MOD_DAMAGE_EVENTS, fn_tonumber(L, 1) != 0.0);
+    }
+    fn_pushstring(L, CombatModOn(&g_combatMods, COMBAT_MOD_DAMAGE_EVENTS)
+        ? "OK: damage event logging on" : "OK: damage event logging off");
+    return 1;
+}
+
+// SWFOC_CombatStats([mode] [, window_s]) -> "on=0|1 window=W types=N ..."
+// then one line per active slot and per top type (combat_stats.h). mode
+// "on" / "off" starts or stops feeding the rollups from Take_Damage_Outer
+// and DeathHandler, "reset" zeroes them; a bare number is the window
+// (default 10 s, at most COMBAT_STATS_MAX_WINDOW).
+static int Lua_CombatStats(lua_State* L) {
+    int arg = 1;
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TSTRING) {
+        const char* mode = fn_tostring(L, 1);
+        if (strcmp(mode, "on") == 0) {
+            CombatModSet(&g_combatMods, COMBAT_MOD_STATS, true);
+        } else if (strcmp(mode, "off") == 0) {
+            CombatModSet(&g_combatMods, COMBAT_MOD_STATS, false);
+        } else if (strcmp(mode, "reset") == 0) {
+            CombatStatsReset(&g_combatStats);
+        } else {
+            fn_pushstring(L, "ERR: SWFOC_CombatStats: mode must be on, off or reset");
+            return 1;
+        }
+        arg = 2;
+    }
+    const int windowS = fn_gettop(L) >= arg && fn_type(L, arg) == LUA_TNUMBER ? (int)fn_tonumber(L, arg) : 10;
+    const size_t cap = 128 * (2 + COMBAT_STATS_SLOTS + COMBAT_STATS_TOP_TYPES);
+    char* buf = static_cast<char*>(malloc(cap));
+    if (!buf) {
+        fn_pushstring(L, "ERR: SWFOC_CombatStats: out of memory");
+        return 1;
+    }
+    size_t off = SafeAppendFmt(buf, 0, cap, "on=%d ", CombatModOn(&g_combatMods, COMBAT_MOD_STATS) ? 1 : 0);
+    CombatStatsFormat(g_combatStats, GetTickCount64(), windowS,
+                      [](uint64_t type, char* out, size_t outCap) {
+                          ReadObjectTypeName(static_cast<uintptr_t>(type), out, outCap);
+                      },
+                      buf + off, cap - off);
+    fn_pushstring(L, buf);
+    free(buf);
+    return 1;
+}
+
+// SWFOC_SetEventStreamCapacity(n) -> "capacity=<new> previous=<old> dropped=<total>"
+// Sets the per-thread damage-event ring capacity (rounded up to a power of
+// two in [256, 65536]). A ring switches size the next time it is empty.
+// Missing or non-positive n only reports the current values.
+static int Lua_SetEventStreamCapacity(lua_State* L) {
+    uint32_t previous = g_damageRings.capacity.load(std::memory_order_relaxed);
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER) {
+        const double n = fn_tonumber(L, 1);
+        if (n > 0.0) previous = DamageRingSetCapacity(&g_damageRings, (uint32_t)(n > 65536.0 ? 65536.0 : n));
+    }
+    char out[128];
+    snprintf(out, sizeof(out), "capacity=%u previous=%u dropped=%llu",
+             g_damageRings.capacity.load(std::memory_order_relaxed), previous,
+             (unsigned long long)DamageRingDropped(&g_damageRings));
+    fn_pushstring(L, out);
+    return 1;
+}
+
+// SWFOC_SetLogLevel(level, categories) -> "level=<n> categories=0x<mask> dropped=<total>"
+// level: 0 error, 1 warn, 2 info, 3 debug (per-command pipe lines). categories
+// is a LogCategory bit mask (log_ring.h). Arguments that are missing or not
+// numbers keep the current value, so a bare call only reports.
+static int Lua_SetLogLevel(lua_State* L) {
+    const int top = fn_gettop(L);
+    if (top >= 1 && fn_type(L, 1) == LUA_TNUMBER) {
+        const double level = fn_tonumber(L, 1);
+        g_logRing.level.store(level < 0.0 ? LOG_LEVEL_ERROR : level > 3.0 ? LOG_LEVEL_DEBUG : (uint32_t)level,
+                              std::memory_order_relaxed);
+    }
+    if (top >= 2 && fn_type(L, 2) == LUA_TNUMBER) {
+        const double mask = fn_tonumber(L, 2);
+        g_logRing.categories.store(mask < 0.0 ? 0u : mask > 255.0 ? (uint32_t)LOG_CAT_ALL : (uint32_t)mask,
+                                   std::memory_order_relaxed);
+    }
+    char out[128];
+    snprintf(out, sizeof(out), "level=%u categories=0x%02X dropped=%llu",
+             g_logRing.level.load(std::memory_order_relaxed),
+             g_logRing.categories.load(std::memory_order_relaxed),
+             (unsigned long long)g_logRing.dropped.load(std::memory_order_relaxed));
+    fn_pushstring(L, out);
+    return 1;
+}
+
 // SWFOC_GetAllPlayers() -> CSV of per-slot rows.
 // Task 111 (2026-04-23). Row format mirrors Lua_ReplayGetAllPlayers so the
 // V2 Galactic + Diagnostics tabs can consume the same string shape whether
@@ -7479,33 +10188,13 @@ static int Lua_EventStreamDrain(lua_State* L) {
 //   slot;faction;credits;tech_level;is_human;is_local;unit_count
 // Rows separated by '|'. Header "count=N" leads the string.
 //
-// unit_count is derived on the fly from WalkAllTacticalObjects — in
+// unit_count comes from the per-tick unit index (GetTacticalUnitIndex) — in
 // galactic mode the tactical list is empty so every slot shows 0; that's
 // expected and matches the game_mode=2 semantics of SWFOC_DumpState.
 static int Lua_GetAllPlayers(lua_State* L) {
-    uintptr_t pcAddr = g_base + RVA::PlayerCount_Global;
-    int32_t rawCount = 0;
-    if (!IsBadReadPtr(reinterpret_cast<void*>(pcAddr), 4)) {
-        rawCount = static_cast<int32_t>(SafeReadU32(pcAddr));
-    }
-    if (rawCount < 0) rawCount = 0;
-    if (rawCount > 8) rawCount = 8;
-
-    uintptr_t arrBase = SafeReadU64(g_base + RVA::PlayerArray_Global);
-    int localSlot = FindLocalPlayerSlot();
-
-    // Snapshot every tactical obj's owner in a single walk so the per-slot
-    // unit_count loop is O(players + units) instead of O(players * units).
-    static constexpr int kMaxObj = RVA::Selection::kMaxTacticalObjects;
-    static thread_local uintptr_t s_objs[kMaxObj];
-    int objCount = WalkAllTacticalObjects(s_objs, kMaxObj);
-    int unitCountByOwner[16] = {0};
-    for (int i = 0; i < objCount; i++) {
-        uintptr_t o = s_objs[i];
-        if (!IsValidObjAddr(o)) continue;
-        int32_t owner = *reinterpret_cast<int32_t*>(o + RVA::GameObj::OwnerPlayerID);
-        if (owner >= 0 && owner < 16) unitCountByOwner[owner]++;
-    }
+    // Per-slot unit counts are bucket sizes in the per-tick unit index.
+    const PlayerTable* t = GetPlayerTableWithUnits();
+    const int count = t->count;
 
     constexpr size_t kBufCap = 8192;
     char* buf = reinterpret_cast<char*>(malloc(kBufCap));
@@ -7513,49 +10202,31 @@ static int Lua_GetAllPlayers(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_GetAllPlayers: alloc failed");
         return 1;
     }
-    size_t off = 0;
-    off = SafeAppendFmt(buf, off, kBufCap, "count=%d", rawCount);
-
-    for (int32_t i = 0; i < rawCount; i++) {
-        uint64_t pPtr = arrBase ? SafeReadU64(arrBase + i * 8) : 0;
-        const char* faction = pPtr
-            ? SafeReadCStr(pPtr + RVA::PlayerObj::FactionName)
-            : nullptr;
-        float credits = pPtr ? SafeReadF32(pPtr + RVA::PlayerObj::Credits) : 0.0f;
-        int32_t tech = pPtr
-            ? static_cast<int32_t>(SafeReadU32(pPtr + RVA::PlayerObj::TechLevel))
-            : 0;
-        uint8_t lp = pPtr
-            ? *reinterpret_cast<uint8_t*>(pPtr + RVA::PlayerObj::LocalPlayer)
-            : 0;
-        int is_human = (lp == 1) ? 1 : 0;
-        int is_local = (i == localSlot) ? 1 : 0;
-        int uc = (i >= 0 && i < 16) ? unitCountByOwner[i] : 0;
-        off = SafeAppendFmt(
-            buf, off, kBufCap,
-            "|%d;%s;%.3f;%d;%d;%d;%d",
-            i,
-            faction && faction[0] ? faction : "UNKNOWN",
-            credits,
-            tech,
-            is_human,
-            is_local,
-            uc);
-        if (off >= kBufCap - 96) {
-            SafeAppendFmt(buf, off, kBufCap, "|...+truncated");
+    CsvRow row;
+    CsvRowInit(&row, buf, kBufCap);
+    CsvRowCount(&row, count);
+
+    for (int i = 0; i < count; i++) {
+        // An empty slot still gets its row, as UNKNOWN with zeros.
+        const PlayerRow& r = t->rows[i];
+        const char* faction = r.faction && CanReadMem((uintptr_t)r.faction, 1) ? r.faction : nullptr;
+        CsvRowPlayer(&row, i, faction && faction[0] ? faction : "UNKNOWN",
+                     r.credits, r.tech, r.isHuman, r.isLocal, r.units);
+        if (row.len >= kBufCap - 96) {
+            CsvRowStr(&row, "|...+truncated");
             break;
         }
     }
     fn_pushstring(L, buf);
     free(buf);
-    Log("[Bridge] GetAllPlayers: count=%d localSlot=%d\n", rawCount, localSlot);
+    Log("[Bridge] GetAllPlayers: count=%d localSlot=%d\n", count, t->localSlot);
     return 1;
 }
 
 // SWFOC_RevealAll(slot) -> "OK: revealed" or "ERR: ..."
 // Task 113 (2026-04-23). Toggles fog-of-war for the given player slot by
-// invoking the engine's Lua binding `FOW_Object:Reveal_All(player)` via
-// SWFOC_DoString. The engine path (discovered via IDA: the Lua method
+// invoking the engine's Lua binding `FOW_Object:Reveal_All(player)` from
+// the precompiled HELPER_REVEAL_ALL script. The engine path (discovered via IDA: the Lua method
 // registered at sub_1406A5B00 in LuaFOWRevealCommandClass, which calls
 // sub_14035D4F0(TacticalGameManager, player_index)) only works in tactical
 // mode — the engine itself rejects the call in galactic/menu. Two-tier
@@ -7566,24 +10237,14 @@ static int Lua_GetAllPlayers(lua_State* L) {
 // live `Find_Player` idiom the engine exposes.
 static int Lua_RevealAll(lua_State* L) {
     int slot = static_cast<int>(fn_tonumber(L, 1));
-    char script[256];
-    if (slot < 0) {
-        snprintf(script, sizeof(script),
-                 "local p = Find_Player(\"local\"); "
-                 "if p and p.Get_Fog_Of_War then p:Get_Fog_Of_War():Reveal_All(p) end");
-    } else {
-        snprintf(script, sizeof(script),
-                 "local p = Find_Player(%d); "
-                 "if p and p.Get_Fog_Of_War then p:Get_Fog_Of_War():Reveal_All(p) end",
-                 slot);
-    }
-    // Route through the existing SWFOC_DoString path — same execution surface
-    // any editor-driven script would use, so the failure modes are identical.
-    fn_pushstring(L, script);
-    if (Lua_DoString(L) >= 1) {
-        // Discard whatever DoString pushed; replace with our own status.
-        fn_settop(L, 0);
-    }
+    // Errors are discarded like any editor-driven script's; the status
+    // below is returned either way.
+    if (PushHelperScript(L, HELPER_REVEAL_ALL)) {
+        if (slot < 0) fn_pushstring(L, "local");
+        else fn_pushnumber(L, slot);
+        fn_pcall(L, 1, 0, 0);
+    }
+    fn_settop(L, 0);
     Log("[Bridge] RevealAll(slot=%d): dispatched Lua shim\n", slot);
     fn_pushstring(L, "OK: reveal_all dispatched (tactical only)");
     return 1;
@@ -7603,11 +10264,9 @@ static int Lua_CombinedGodOHK(lua_State* L) {
     bool ok = true;
     if (enable) {
         if (!InstallCombatHook()) ok = false;
-        InterlockedExchange(&g_god_mode_enabled, 1);
-        InterlockedExchange(&g_ohk_enabled,       1);
+        CombatModSet(&g_combatMods, COMBAT_MOD_GOD | COMBAT_MOD_OHK, true);
     } else {
-        InterlockedExchange(&g_god_mode_enabled, 0);
-        InterlockedExchange(&g_ohk_enabled,       0);
+        CombatModSet(&g_combatMods, COMBAT_MOD_GOD | COMBAT_MOD_OHK, false);
         RemoveCombatHook();
     }
     LeaveCriticalSection(&g_combat_hook_lock);
@@ -7618,7 +10277,7 @@ static int Lua_CombinedGodOHK(lua_State* L) {
     }
     Log("[Bridge] CombinedGodOHK -> %s (god=%d ohk=%d hook=%d sweep=%d)\n",
         enable ? "ENABLED" : "DISABLED",
-        (int)g_god_mode_enabled, (int)g_ohk_enabled,
+        (int)CombatModOn(&g_combatMods, COMBAT_MOD_GOD), (int)CombatModOn(&g_combatMods, COMBAT_MOD_OHK),
         (int)g_combat_hook_installed, flipped);
     char buf[96];
     snprintf(buf, sizeof(buf),
@@ -7640,10 +10299,10 @@ static int Lua_OneHitKill(lua_State* L) {
     bool ok = true;
     if (enable) {
         if (!InstallCombatHook()) ok = false;
-        InterlockedExchange(&g_ohk_enabled, 1);
+        CombatModSet(&g_combatMods, COMBAT_MOD_OHK, true);
     } else {
-        InterlockedExchange(&g_ohk_enabled, 0);
-        if (!g_god_mode_enabled && !g_ohk_enabled) RemoveCombatHook();
+        CombatModSet(&g_combatMods, COMBAT_MOD_OHK, false);
+        if (!CombatModOn(&g_combatMods, COMBAT_MOD_GOD | COMBAT_MOD_OHK)) RemoveCombatHook();
     }
     LeaveCriticalSection(&g_combat_hook_lock);
     if (!ok) {
@@ -7652,7 +10311,8 @@ static int Lua_OneHitKill(lua_State* L) {
     }
     Log("[Bridge] OneHitKill -> %s (god=%d ohk=%d hook=%d)\n",
         enable ? "ENABLED" : "DISABLED",
-        (int)g_god_mode_enabled, (int)g_ohk_enabled, (int)g_combat_hook_installed);
+        (int)CombatModOn(&g_combatMods, COMBAT_MOD_GOD), (int)CombatModOn(&g_combatMods, COMBAT_MOD_OHK),
+        (int)g_combat_hook_installed);
     fn_pushstring(L, enable ? "OK: one-hit kill enabled" : "OK: one-hit kill disabled");
     return 1;
 }
@@ -7697,6 +10357,7 @@ static int Lua_SetCreditsForSlot(lua_State* L) {
         return 1;
     }
     *reinterpret_cast<float*>(player + RVA::PlayerObj::Credits) = static_cast<float>(amount);
+    InvalidatePlayerTable();
     Log("[Bridge] SetCreditsForSlot(%d, %.0f) OK\n", slot, amount);
     fn_pushstring(L, "OK");
     return 1;
@@ -7712,8 +10373,7 @@ static int Lua_GetCreditsForSlot(lua_State* L) {
         fn_pushnumber(L, -1.0);
         return 1;
     }
-    float c = *reinterpret_cast<float*>(player + RVA::PlayerObj::Credits);
-    fn_pushnumber(L, static_cast<double>(c));
+    fn_pushnumber(L, static_cast<double>(GetPlayerTable()->rows[slot].credits));
     return 1;
 }
 
@@ -7732,6 +10392,7 @@ static int Lua_SetTechForSlot(lua_State* L) {
         return 1;
     }
     *reinterpret_cast<int*>(player + RVA::PlayerObj::TechLevel) = level;
+    InvalidatePlayerTable();
     Log("[Bridge] SetTechForSlot(%d, %d) OK\n", slot, level);
     fn_pushstring(L, "OK");
     return 1;
@@ -7745,8 +10406,7 @@ static int Lua_GetTechForSlot(lua_State* L) {
         fn_pushnumber(L, -1.0);
         return 1;
     }
-    int t = *reinterpret_cast<int*>(player + RVA::PlayerObj::TechLevel);
-    fn_pushnumber(L, static_cast<double>(t));
+    fn_pushnumber(L, static_cast<double>(GetPlayerTable()->rows[slot].tech));
     return 1;
 }
 
@@ -7761,14 +10421,15 @@ static int Lua_DrainEnemyCredits(lua_State* L) {
         fn_pushstring(L, "ERR: SWFOC_DrainEnemyCredits: no players loaded");
         return 1;
     }
+    const PlayerTable* t = GetPlayerTable();
     int drained = 0;
     for (int i = 0; i < count; i++) {
-        uintptr_t p = GetPlayerObj(i);
-        if (!p) continue;
-        if (*reinterpret_cast<uint8_t*>(p + RVA::PlayerObj::LocalPlayer) == 1) continue;
-        *reinterpret_cast<float*>(p + RVA::PlayerObj::Credits) = 0.0f;
+        const PlayerRow* r = PlayerTableRow(t, i);
+        if (!r || r->isHuman) continue;
+        *reinterpret_cast<float*>((uintptr_t)r->player + RVA::PlayerObj::Credits) = 0.0f;
         drained++;
     }
+    InvalidatePlayerTable();
     char buf[64];
     snprintf(buf, sizeof(buf), "OK: drained %d slots", drained);
     Log("[Bridge] DrainEnemyCredits() OK (%d slots)\n", drained);
@@ -7868,18 +10529,50 @@ static int Lua_DiagListRegisteredFunctions(lua_State* L) {
     return 1;
 }
 
-// SWFOC_DiagPipeStats() -> "received=N completed=M errors=K"
-// Counters are atomic (InterlockedIncrement) so the PipeThreadProc writer
+// SWFOC_DiagPipeStats() -> "received=N completed=M errors=K
+//   lat_n=N lat_p50_us=X lat_p99_us=Y lat_hist=b0,b1,..."
+// Counters are atomic (InterlockedIncrement) so the pipe instance writers
 // and the Lua reader race safely. Reader uses plain LONG load — on x86_64
 // aligned 32-bit loads are atomic, and we don't need monotonic ordering
 // across the three values (a diagnostic, not a consistency gate).
+// 2026-10-14: appended the round-trip latency histogram (log2 microsecond
+// buckets, see pipe_queue.h). Percentiles are bucket upper bounds. Existing
+// parsers match "received=(\d+)" so the extra fields are additive.
+// 2026-10-14: also appends the DoString compiled-chunk cache counters
+// (" chunk_hits=N chunk_misses=M"), the precompiled helper-script count
+// (" helper_compiles=N", one per script per RegisterAll) and the drain
+// budget plus the number of drain passes that left work for a later tick
+// (" drain_budget_us=N deferred=M"), then the BatchTypeExists cache
+// (" type_hits=N type_misses=M type_resets=R").
 static int Lua_DiagPipeStats(lua_State* L) {
     LONG received  = g_pipeReceivedCount;
     LONG completed = g_pipeCompletedCount;
     LONG errors    = g_pipeErrorCount;
-    char buf[128];
-    snprintf(buf, sizeof(buf), "received=%ld completed=%ld errors=%ld",
-             (long)received, (long)completed, (long)errors);
+    char buf[512];
+    int off = snprintf(buf, sizeof(buf),
+             "received=%ld completed=%ld errors=%ld lat_n=%llu lat_p50_us=%llu lat_p99_us=%llu lat_hist=",
+             (long)received, (long)completed, (long)errors,
+             (unsigned long long)PipeLatencyCount(&g_pipeLatency),
+             (unsigned long long)PipeLatencyPercentile(&g_pipeLatency, 50),
+             (unsigned long long)PipeLatencyPercentile(&g_pipeLatency, 99));
+    for (int i = 0; i < PIPE_LATENCY_BUCKETS && off > 0 && off < (int)sizeof(buf); i++) {
+        off += snprintf(buf + off, sizeof(buf) - off, "%s%ld", i ? "," : "", (long)g_pipeLatency.buckets[i]);
+    }
+    uint32_t modScans;
+    {
+        std::lock_guard<std::mutex> g(g_modCatalog.lock);
+        modScans = g_modCatalog.scans;
+    }
+    if (off > 0 && off < (int)sizeof(buf)) {
+        snprintf(buf + off, sizeof(buf) - off,
+                 " chunk_hits=%ld chunk_misses=%ld helper_compiles=%ld drain_budget_us=%ld deferred=%ld"
+                 " type_hits=%u type_misses=%u type_resets=%u hp_layout_hits=%u hp_layout_misses=%u"
+                 " hp_layout_types=%u mod_scans=%u",
+                 (long)g_chunkCacheHits, (long)g_chunkCacheMisses, (long)g_helperCompiles,
+                 (long)g_pipeDrainBudgetUs, (long)g_pipeDeferredCount,
+                 g_typeCache.hits, g_typeCache.misses, g_typeCache.resets,
+                 g_hpLayout.hits, g_hpLayout.misses, g_hpLayout.count, modScans);
+    }
     fn_pushstring(L, buf);
     return 1;
 }
@@ -7896,12 +10589,276 @@ static int Lua_DiagGameTick(lua_State* L) {
     return 1;
 }
 
-// SWFOC_DiagSelfTest() -> "passed=N failed=M details=..."
+// SWFOC_DiagPerf(["reset"]) -> JSON blob (perf_hist.h PerfFormatJson):
+// {"stages":{<stage>:{n,mean_ns,p50_ns,p99_ns,max_ns},...},
+//  "functions":{"SWFOC_X":{calls,n,mean_ns,p50_ns,p99_ns,max_ns},...}}
+// Stages: pipe_read, queue_wait (push -> drain pops it), main_wait (push ->
+// reply collected), lua_compile, lua_exec and reply_write; main_wait minus
+// queue_wait and the Lua stages is the drain/wake overhead. Passing "reset"
+// clears every histogram after the snapshot is taken.
+static int Lua_DiagPerf(lua_State* L) {
+    static char buf[PERF_JSON_MAX];  // main thread only
+    PerfFormatJson(&g_perf, buf, sizeof(buf));
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TSTRING) {
+        const char* arg = fn_tostring(L, 1);
+        if (arg && strcmp(arg, "reset") == 0) PerfReset(&g_perf);
+    }
+    fn_pushstring(L, buf);
+    return 1;
+}
+
+// SWFOC_DiagHookCost(["on"|"off"|"reset"]) -> JSON blob:
+// {"enabled":0|1,"tsc_per_us":f,"hooks":{"SetHP":{calls,threads,cycles,
+//  mean_cycles,max_cycles,mean_ns,max_ns},...}}
+// Cycles are spent in the detour itself with the original excluded
+// (hook_cost.h); ns figures use the cycle rate measured against QPC since
+// init. The argument is applied before the report, so "reset" returns zeros
+// and "on" a report with enabled=1.
+static int Lua_DiagHookCost(lua_State* L) {
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TSTRING) {
+        const char* arg = fn_tostring(L, 1);
+        if (arg && strcmp(arg, "on") == 0) {
+            g_hookCost.enabled.store(1, std::memory_order_relaxed);
+        } else if (arg && strcmp(arg, "off") == 0) {
+            g_hookCost.enabled.store(0, std::memory_order_relaxed);
+        } else if (arg && strcmp(arg, "reset") == 0) {
+            HookCostReset(&g_hookCost);
+        }
+    }
+    const uint64_t elapsedUs = PerfTicksToNs(PipeQpcNow() - g_hookCostQpc0) / 1000;
+    const double tscPerUs = elapsedUs ? (double)(__rdtsc() - g_hookCostTsc0) / (double)elapsedUs : 0.0;
+    char buf[2048];
+    int off = snprintf(buf, sizeof(buf), "{\"enabled\":%u,\"tsc_per_us\":%.1f,\"hooks\":{",
+                       g_hookCost.enabled.load(std::memory_order_relaxed), tscPerUs);
+    for (uint32_t h = 0; h < HOOK_COST_COUNT && off > 0 && off < (int)sizeof(buf); h++) {
+        const HookCostTotals t = HookCostSum(&g_hookCost, h);
+        const uint64_t mean = t.calls ? t.cycles / t.calls : 0;
+        off += snprintf(buf + off, sizeof(buf) - off,
+                        "%s\"%s\":{\"calls\":%llu,\"threads\":%u,\"cycles\":%llu,\"mean_cycles\":%llu,"
+                        "\"max_cycles\":%llu,\"mean_ns\":%.0f,\"max_ns\":%.0f}",
+                        h ? "," : "", HookCostName(h), (unsigned long long)t.calls, t.threads,
+                        (unsigned long long)t.cycles, (unsigned long long)mean, (unsigned long long)t.maxCycles,
+                        tscPerUs > 0.0 ? mean * 1000.0 / tscPerUs : 0.0,
+                        tscPerUs > 0.0 ? t.maxCycles * 1000.0 / tscPerUs : 0.0);
+    }
+    if (off > 0 && off < (int)sizeof(buf)) snprintf(buf + off, sizeof(buf) - off, "}}");
+    fn_pushstring(L, buf);
+    return 1;
+}
+
+// SWFOC_SetPipeDrainBudget(us) -> previous budget in microseconds.
+// Caps how long one drain pass may run queued pipe commands on the main
+// thread before deferring the rest to the next tick (0 = unlimited).
+// Negative or missing arguments leave the budget unchanged.
+static int Lua_SetPipeDrainBudget(lua_State* L) {
+    const LONG previous = g_pipeDrainBudgetUs;
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER) {
+        const double us = fn_tonumber(L, 1);
+        if (us >= 0.0) InterlockedExchange(&g_pipeDrainBudgetUs, (LONG)(us > 1e6 ? 1e6 : us));
+    }
+    fn_pushnumber(L, static_cast<double>(previous));
+    return 1;
+}
+
+// ======================================================================
+// Lua API self-test (lua_open)
+// ======================================================================
+//
+// Exercises every Lua API entry point the bridge resolved, on a live
+// state. It used to run inside Hook_lua_open on every state the game
+// opened, hundreds per session, repeating the same dozen Log lines once
+// the first state had passed. It now runs on the first registered state
+// and keeps the verdict; SWFOC_DiagSelfTest reports it and
+// SWFOC_DiagSelfTest(1) re-runs it on the calling state. A state whose
+// SWFOC_GetVersion answers with another build's version (a second bridge
+// DLL, or a script that replaced the global) fails the pcall check, and a
+// failed verdict is re-run on the next state opened. If any call crashes,
+// SEH catches it.
+struct LuaApiSelfTestVerdict {
+    volatile LONG state;   // 0 = not run, 1 = running, 2 = done
+    int   passed;
+    int   failed;
+    void* lua_state;       // state the verdict was taken on
+    char  details[512];    // "tag=OK|FAIL,..." per check
+};
+static LuaApiSelfTestVerdict g_luaApiSelfTest = {};
+
+// Claims the run when none is cached or the cached verdict failed.
+static bool LuaApiSelfTestDue() {
+    if (InterlockedCompareExchange(&g_luaApiSelfTest.state, 1, 0) == 0) return true;
+    if (g_luaApiSelfTest.state == 2 && g_luaApiSelfTest.failed > 0)
+        return InterlockedCompareExchange(&g_luaApiSelfTest.state, 1, 2) == 2;
+    return false;
+}
+
+static void RunLuaApiSelfTest(lua_State* L) {
+    LuaApiSelfTestVerdict& v = g_luaApiSelfTest;
+    v.passed = 0;
+    v.failed = 0;
+    v.lua_state = L;
+    v.details[0] = '\0';
+    size_t doff = 0;
+    auto record = [&](const char* tag, bool ok) {
+        size_t remaining = (doff >= sizeof(v.details) - 1) ? 0 : sizeof(v.details) - doff - 1;
+        if (remaining > 0) {
+            int n = snprintf(v.details + doff, remaining, "%s%s=%s", doff > 0 ? "," : "", tag, ok ? "OK" : "FAIL");
+            if (n > 0 && (size_t)n < remaining) doff += (size_t)n;
+        }
+        if (ok) ++v.passed; else ++v.failed;
+    };
+    Log("[Test] Lua API self-test on state %p\n", L);
+
+    // Test 1: pushnumber + settop (pop)
+    int top0 = fn_gettop(L);
+    fn_pushnumber(L, 42.0);
+    fn_settop(L, -2);
+    record("pushnumber", fn_gettop(L) == top0);
+    Log("[Test] pushnumber + pop: %s\n", fn_gettop(L) == top0 ? "PASSED" : "FAILED");
+
+    // Test 2: tonumber
+    fn_pushstring(L, "12345");
+    double tv = fn_tonumber(L, -1);
+    fn_settop(L, -2);
+    record("tonumber", tv == 12345.0);
+    Log("[Test] tonumber: %.0f %s\n", tv, tv == 12345.0 ? "PASSED" : "FAILED");
+
+    // Test 3: newtable + settable (create a table, add a field)
+    fn_newtable(L);              // push {}
+    fn_pushstring(L, "key");     // push "key"
+    fn_pushnumber(L, 99.0);      // push 99
+    fn_settable(L, -3);          // t["key"] = 99
+    fn_pushstring(L, "key");
+    fn_gettable(L, -2);          // t["key"]
+    double kv = fn_tonumber(L, -1);
+    fn_settop(L, -3);            // pop value + table
+    record("settable", kv == 99.0);
+    Log("[Test] newtable + settable: %s\n", kv == 99.0 ? "PASSED" : "FAILED");
+
+    // Test 4: rawseti (create array-like table)
+    fn_newtable(L);              // push {}
+    fn_pushstring(L, "hello");   // push "hello"
+    fn_rawseti(L, -2, 1);        // t[1] = "hello"
+    fn_settop(L, -2);            // pop table
+    record("rawseti", fn_gettop(L) == top0);
+    Log("[Test] rawseti: PASSED\n");
+
+    // Test 5: type check
+    fn_pushstring(L, "test");
+    int ty = fn_type(L, -1);
+    fn_settop(L, -2);
+    record("type_string", ty == LUA_TSTRING);
+    Log("[Test] type(string) = %d %s\n", ty, ty == LUA_TSTRING ? "PASSED" : "FAILED");
+
+    fn_pushnumber(L, 1.0);
+    ty = fn_type(L, -1);
+    fn_settop(L, -2);
+    record("type_number", ty == LUA_TNUMBER);
+    Log("[Test] type(number) = %d %s\n", ty, ty == LUA_TNUMBER ? "PASSED" : "FAILED");
+
+    // Test 6: tostring (0x7B9CC0 = lua_tolstring — Ghidra confirmed)
+    fn_pushstring(L, "readback");
+    const char* rb = fn_tostring(L, -1);
+    int rbOk = rb && strcmp(rb, "readback") == 0;
+    Log("[Test] tostring readback: %s %s\n", rb ? rb : "null", rbOk ? "PASSED" : "FAILED");
+    fn_settop(L, -2);
+    record("tostring", rbOk != 0);
+
+    // Test 7: gettable (0x7B8E90 = lua_gettable — Ghidra confirmed)
+    fn_pushstring(L, "_SWFOC_TEST");
+    fn_pushnumber(L, 777.0);
+    fn_settable(L, LUA_GLOBALSINDEX);
+    fn_pushstring(L, "_SWFOC_TEST");
+    fn_gettable(L, LUA_GLOBALSINDEX);
+    double gv = fn_tonumber(L, -1);
+    fn_settop(L, -2);
+    record("globals", gv == 777.0);
+    Log("[Test] global set+get: %.0f %s\n", gv, gv == 777.0 ? "PASSED" : "FAILED");
+
+    // Test 8: pcall (0x7B9280 — Ghidra confirmed). The state must answer
+    // with this build's version string.
+    fn_pushstring(L, "SWFOC_GetVersion");
+    fn_gettable(L, LUA_GLOBALSINDEX);
+    ty = fn_type(L, -1);
+    if (ty == LUA_TFUNCTION) {
+        int pcResult = fn_pcall(L, 0, 1, 0);
+        if (pcResult == 0) {
+            const char* ver = fn_tostring(L, -1);
+            const bool same = ver && strcmp(ver, SWFOC_BRIDGE_VERSION) == 0;
+            Log("[Test] pcall SWFOC_GetVersion: '%s' %s\n", ver ? ver : "null",
+                same ? "PASSED" : "FAILED (version mismatch)");
+            fn_settop(L, -2);
+            record("pcall_version", same);
+        } else {
+            const char* err = fn_tostring(L, -1);
+            Log("[Test] pcall SWFOC_GetVersion: error=%s FAILED\n", err ? err : "null");
+            fn_settop(L, -2);
+            record("pcall_version", false);
+        }
+    } else {
+        fn_settop(L, -2);
+        Log("[Test] pcall: function not found (type=%d) — OK for early states\n", ty);
+    }
+
+    // Test 9: pushboolean + pushnil + gettop
+    fn_pushboolean(L, 1);
+    ty = fn_type(L, -1);
+    fn_settop(L, -2);
+    record("pushboolean", ty == LUA_TBOOLEAN);
+    Log("[Test] pushboolean: type=%d %s\n", ty, ty == LUA_TBOOLEAN ? "PASSED" : "FAILED");
+
+    fn_pushnil(L);
+    ty = fn_type(L, -1);
+    fn_settop(L, -2);
+    record("pushnil", ty == LUA_TNIL);
+    Log("[Test] pushnil: type=%d %s\n", ty, ty == LUA_TNIL ? "PASSED" : "FAILED");
+
+    int top_before = fn_gettop(L);
+    fn_pushnumber(L, 1.0);
+    int top_after = fn_gettop(L);
+    fn_settop(L, -2);
+    record("gettop", top_after == top_before + 1);
+    Log("[Test] gettop: before=%d after=%d %s\n", top_before, top_after,
+        (top_after == top_before + 1) ? "PASSED" : "FAILED");
+
+    // Test 10: PlayerArray access (memory read, no Lua). Informational:
+    // menu states have no players yet, so it does not enter the verdict.
+    auto pa = *reinterpret_cast<uintptr_t*>(g_base + RVA::PlayerArray_Global);
+    auto pc = *reinterpret_cast<int*>(g_base + RVA::PlayerCount_Global);
+    int localSlot = FindLocalPlayerSlot();
+    Log("[Test] PlayerArray=0x%p count=%d localSlot=%d %s\n",
+        (void*)pa, pc, localSlot,
+        (pa != 0 && pc > 0) ? "PASSED" : "FAILED (may be OK in menu)");
+
+    if (localSlot >= 0) {
+        Log("[Test] Local player: slot %d, faction '%s'\n",
+            localSlot, GetFactionName(localSlot));
+    }
+
+    // Test 11: DoString (lua_load + pcall)
+    if (fn_load) {
+        int dsErr = DoString(L, "-- bridge dostring self-test", "=selftest");
+        record("dostring", dsErr == 0);
+        Log("[Test] DoString (no-op): %s\n", dsErr == 0 ? "PASSED" : "FAILED");
+    } else {
+        Log("[Test] DoString: SKIPPED (fn_load not resolved)\n");
+    }
+
+    Log("[Test] === ALL SELF-TESTS COMPLETE === passed=%d failed=%d\n", v.passed, v.failed);
+    InterlockedExchange(&v.state, 2);
+}
+
+// SWFOC_DiagSelfTest([rerun]) -> "passed=N failed=M details=... lua_api=..."
 // Offline sanity checks over live game memory. Each check emits one Log
 // line and contributes one token to the details string. Safe: read-only,
 // bounded, no Lua-global probing. Used by the probe harness to confirm
 // the bridge's basic assumptions about game state are still valid.
+// The cached Lua API verdict adds one more check (lua_api) and a
+// "lua_api=P/T@state" field; a non-zero rerun first re-runs that suite
+// on the calling state.
 static int Lua_DiagSelfTest(lua_State* L) {
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER && fn_tonumber(L, 1) != 0.0) {
+        if (InterlockedExchange(&g_luaApiSelfTest.state, 1) != 1) RunLuaApiSelfTest(L);
+    }
     int passed = 0;
     int failed = 0;
     char details[1024];
@@ -7981,9 +10938,19 @@ static int Lua_DiagSelfTest(lua_State* L) {
     Log("[DiagSelfTest] walk_local_player_byte %s\n", walkOk ? "OK" : "FAIL");
     append_detail("lp_byte_valid", walkOk);
 
+    // Check 7: the Lua API verdict from the first registered state.
+    const LuaApiSelfTestVerdict& api = g_luaApiSelfTest;
+    const bool apiDone = api.state == 2;
+    append_detail("lua_api", apiDone && api.failed == 0);
+
     char out[1280];
-    snprintf(out, sizeof(out), "passed=%d failed=%d details=%s",
-             passed, failed, details);
+    if (apiDone) {
+        snprintf(out, sizeof(out), "passed=%d failed=%d details=%s lua_api=%d/%d@%p",
+                 passed, failed, details, api.passed, api.passed + api.failed, api.lua_state);
+    } else {
+        snprintf(out, sizeof(out), "passed=%d failed=%d details=%s lua_api=pending",
+                 passed, failed, details);
+    }
     fn_pushstring(L, out);
     return 1;
 }
@@ -8095,6 +11062,7 @@ typedef void (__fastcall *pfn_VictoryMonitorCounter)(void* this_obj);
 static pfn_VictoryMonitorCounter real_VictoryMonitorCounter = nullptr;
 
 static void __fastcall Hook_VictoryMonitorCounter(void* this_obj) {
+    HookCostTimer cost(HOOK_COST_VICTORY_MONITOR);
     // iter-450a inject-branch placeholder. Will read:
     //
     //   if (g_victoryTriggerPending && this_obj == g_capturedVictoryMonitor) {
@@ -8108,7 +11076,7 @@ static void __fastcall Hook_VictoryMonitorCounter(void* this_obj) {
     // MH_EnableHook was never called, so this function never actually
     // runs except via direct call -- which never happens. The cost is
     // exactly one MH_CreateHook trampoline allocation at module load.
-    real_VictoryMonitorCounter(this_obj);
+    cost.original(real_VictoryMonitorCounter, this_obj);
 }
 
 // ======================================================================
@@ -8132,295 +11100,381 @@ static void __fastcall Hook_VictoryMonitorCounter(void* this_obj) {
 // 2 selection (2026-04-11) = Lua_GetSelectedUnit, Lua_GetSelectedUnits.
 // 1 faction fix (2026-04-11) = Lua_SetHumanPlayer_v2.
 // Total = 37 helpers. The SWFOC_BRIDGE_VERSION macro tracks this count.
-static void RegisterAll(lua_State* L) {
-    struct HelperEntry { const char* name; lua_CFunction func; };
-    static const HelperEntry funcs[] = {
-        // Core / metadata
-        {"SWFOC_GetVersion",         Lua_GetVersion},
-        {"SWFOC_GetBuildInfo",       Lua_GetBuildInfo},
-        {"SWFOC_Log",                Lua_Log},
-        {"SWFOC_DoString",           Lua_DoString},
-        {"SWFOC_DrainPipe",          Lua_DrainPipe},
-        {"SWFOC_StateInfo",          (lua_CFunction)SWFOC_StateInfo},
-        {"SWFOC_EventControl",       Lua_EventControl},
-        {"SWFOC_DumpState",          Lua_DumpState},
-        // Player / economy
-        {"SWFOC_GetLocalPlayer",     Lua_GetLocalPlayer},
-        // 2026-04-25: v1 deleted (silent no-op in galactic mode);
-        // v2 unregistered (manual sweep without AI swap caused the
-        // dual-control bug confirmed live on 2026-04-25). v3 is the
-        // single canonical SetHumanPlayer surface; the v2 function
-        // remains in the source as historical reference but is no
-        // longer dispatchable from Lua.
-        {"SWFOC_SetHumanPlayer_v3",  Lua_SetHumanPlayer_v3},
-        {"SWFOC_GetAiBrain",         Lua_GetAiBrain},
-        {"SWFOC_NullAiBrain",        Lua_NullAiBrain},
-        {"SWFOC_AttachAiBrain",      Lua_AttachAiBrain},
-        {"SWFOC_SetCredits",         Lua_SetCredits},
-        {"SWFOC_GetCredits",         Lua_GetCredits},
-        {"SWFOC_SetTechLevel",       Lua_SetTechLevel},
-        {"SWFOC_UncapCredits",       Lua_UncapCredits},
-        {"SWFOC_HeroInstantRespawn", Lua_HeroInstantRespawn},
-        {"SWFOC_ListFactions",       Lua_ListFactions},
-        // Phase 3.2: combat / inspect helpers ported from CE trainer
-        {"SWFOC_SetUnitInvuln",      Lua_SetUnitInvuln},
-        {"SWFOC_SetUnitHull",        Lua_SetUnitHull},
-        {"SWFOC_InspectUnit",        Lua_InspectUnit},
-        {"SWFOC_GetHardpoints",      Lua_GetHardpoints},
-        {"SWFOC_GetSelectedUnit",    Lua_GetSelectedUnit},
-        {"SWFOC_GetSelectedUnits",   Lua_GetSelectedUnits},
-        {"SWFOC_ListTacticalUnits",  Lua_ListTacticalUnits},
-        {"SWFOC_GodMode",            Lua_GodMode},
-        {"SWFOC_OneHitKill",         Lua_OneHitKill},
-        {"SWFOC_CombinedGodOHK",     Lua_CombinedGodOHK},
-        {"SWFOC_RevealAll",          Lua_RevealAll},
-        {"SWFOC_GetAllPlayers",      Lua_GetAllPlayers},
-        {"SWFOC_EnumerateUnits",     Lua_EnumerateUnits},
-        {"SWFOC_HealAllLocal",       Lua_HealAllLocal},
-        {"SWFOC_KillUnit",           Lua_KillUnit},
-        {"SWFOC_ReviveUnit",         Lua_ReviveUnit},
-        {"SWFOC_SetUnitShield",      Lua_SetUnitShield},
-        {"SWFOC_GetUnitShield",      Lua_GetUnitShield},
-        {"SWFOC_SetUnitSpeed",       Lua_SetUnitSpeed},
-        {"SWFOC_GetUnitSpeed",       Lua_GetUnitSpeed},
-        {"SWFOC_ClearUnitSpeedOverride", Lua_ClearUnitSpeedOverride},
-        {"SWFOC_ListHeroes",         Lua_ListHeroes},
-        {"SWFOC_SetHeroRespawnTimer",Lua_SetHeroRespawnTimer},
-        {"SWFOC_SetPermadeath",      Lua_SetPermadeath},
-        {"SWFOC_HeroStatEdit",       Lua_HeroStatEdit},
-        {"SWFOC_GetPlanets",         Lua_GetPlanets},
-        // 2026-05-07 (iter 299): Faction roster + current-mod enumeration wires.
-        // GetFactionRoster: DoString-driven via Find_All_Objects_Of_Type filter;
-        // mirrors iter-296 GetPlanets shape (engine-already-does-this 5th instance).
-        // GetCurrentMod: filesystem probe of ./Mods/*/Modinfo.xml (no engine Lua API);
-        // returns most-recently-accessed mod folder + path.
-        {"SWFOC_GetFactionRoster",   Lua_GetFactionRoster},
-        {"SWFOC_GetCurrentMod",      Lua_GetCurrentMod},
-        // 2026-05-07 (iter 300; 300th-iter milestone): mod enumeration —
-        // mirrors GetCurrentMod's filesystem walk but emits ALL candidate
-        // mods. Settings tab consumes for the operator-facing mod-picker UI.
-        {"SWFOC_ListMods",           Lua_ListMods},
-        {"SWFOC_ChangePlanetOwner",  Lua_ChangePlanetOwner},
-        {"SWFOC_ChangePlanetOwnerWithMode", Lua_ChangePlanetOwnerWithMode}, // iter 137 Phase-1 mirror
-        {"SWFOC_SpawnAsStoryArrival",       Lua_SpawnAsStoryArrival},        // iter 137 Phase-1 mirror
-        {"SWFOC_GetPlanetTechAndBuildings", Lua_GetPlanetTechAndBuildings},
-        {"SWFOC_SetDiplomacy",       Lua_SetDiplomacy},
-        {"SWFOC_ListAbilities",      Lua_ListAbilities},
-        {"SWFOC_TriggerAbility",     Lua_TriggerAbility},
-        // 2026-05-07 (iter 450 scaffolding): SWFOC_TriggerVictory wrapper.
-        // Validates victory_type vs. 14-of-18 known VictoryType enum names and
-        // stages pending state. The active MinHook detour is DORMANT (iter-450a
-        // will enable it once the AwaitingVictoryTest 48-byte struct layout +
-        // capture-on-CTOR hook are landed).
-        {"SWFOC_TriggerVictory",     Lua_TriggerVictory},
-        {"SWFOC_SetIncomeMultiplier",Lua_SetIncomeMultiplier},
-        {"SWFOC_SetGameSpeed",       Lua_SetGameSpeed},
-        {"SWFOC_FreezeCredits",      Lua_SetFreezeCredits},
-        {"SWFOC_SetBuildSpeed",      Lua_SetBuildSpeed},
-        {"SWFOC_SetPerFactionSpeedMultiplier", Lua_SetPerFactionSpeedMultiplier},
-        {"SWFOC_SetDamageMultiplier", Lua_SetDamageMultiplier},
-        {"SWFOC_GetDamageMultiplier", Lua_GetDamageMultiplier},
-        // 2026-04-28 (iter 96): LIVE-badged global-only siblings.
-        {"SWFOC_SetDamageMultiplierGlobal", Lua_SetDamageMultiplierGlobal},
-        // 2026-05-06 (iter 225): SetFireRate global LIVE wire — WeaponTick MinHook detour scales dt by g_fireRateMult_global
-        {"SWFOC_SetFireRateMultiplierGlobal", Lua_SetFireRateMultiplierGlobal},
-        {"SWFOC_GetFireRateMultiplierGlobal", Lua_GetFireRateMultiplierGlobal},
-        // 2026-05-08 (iter 285): Tier 3 HUD counters via DeathHandler detour extension.
-        {"SWFOC_GetPlayerKills",     Lua_GetPlayerKills},
-        {"SWFOC_GetPlayerDeaths",    Lua_GetPlayerDeaths},
-        {"SWFOC_GetTotalUnitsAlive", Lua_GetTotalUnitsAlive},
-        // 2026-05-06 (iter 230-231): FreezeCredits global LIVE wire — AddCredits MinHook detour. +4 LIVE flips.
-        {"SWFOC_SetCreditsFreezeGlobal", Lua_SetCreditsFreezeGlobal},
-        {"SWFOC_GetCreditsFreezeGlobal", Lua_GetCreditsFreezeGlobal},
-        {"SWFOC_SetCreditsMultiplierGlobal", Lua_SetCreditsMultiplierGlobal},
-        {"SWFOC_GetCreditsMultiplierGlobal", Lua_GetCreditsMultiplierGlobal},
-        {"SWFOC_GetDamageMultiplierGlobal", Lua_GetDamageMultiplierGlobal},
-        {"SWFOC_SetFireRate",        Lua_SetFireRate},
-        {"SWFOC_SetAreaDamage",      Lua_SetAreaDamage},
-        {"SWFOC_SetTargetFilter",    Lua_SetTargetFilter},
-        {"SWFOC_ToggleOHKAttackPower", Lua_ToggleOHKAttackPower},
-        {"SWFOC_FreezeAI",           Lua_FreezeAI},
-        {"SWFOC_FreeCam",            Lua_FreeCam},
-        {"SWFOC_SetCameraPos",       Lua_SetCameraPos},
-        {"SWFOC_GetCameraPos",       Lua_GetCameraPos},
-        // 2026-04-28 (iter 107) — LIVE camera target via engine Lua API.
-        {"SWFOC_ScrollCameraToTarget", Lua_ScrollCameraToTarget},
-        {"SWFOC_CameraFollow",       Lua_CameraFollow},        // iter 143 LIVE
-        {"SWFOC_RotateCameraTo",     Lua_RotateCameraTo},      // iter 144 LIVE
-        {"SWFOC_StartCinematicCamera", Lua_StartCinematicCamera},                  // iter 145 LIVE
-        {"SWFOC_EndCinematicCamera", Lua_EndCinematicCamera},                      // iter 145 LIVE
-        {"SWFOC_SetCinematicCameraKey", Lua_SetCinematicCameraKey},                // iter 145 LIVE
-        {"SWFOC_TransitionCinematicCameraKey", Lua_TransitionCinematicCameraKey},  // iter 145 LIVE
-        {"SWFOC_LetterBoxOn",        Lua_LetterBoxOn},          // iter 150 LIVE
-        {"SWFOC_LetterBoxOff",       Lua_LetterBoxOff},         // iter 150 LIVE
-        {"SWFOC_TeleportUnitLua",    Lua_TeleportUnitLua},      // iter 151 LIVE
-        {"SWFOC_GalacticSpawnUnit",  Lua_GalacticSpawnUnit},    // iter 152 LIVE
-        {"SWFOC_SetCannotBeKilledLua", Lua_SetCannotBeKilledLua}, // iter 153 LIVE
-        {"SWFOC_EnableStealthLua",   Lua_EnableStealthLua},     // iter 153 LIVE
-        {"SWFOC_HealUnitLua",        Lua_HealUnitLua},          // iter 154 LIVE
-        {"SWFOC_TakeDamageLua",      Lua_TakeDamageLua},        // iter 154 LIVE
-        {"SWFOC_SetDamageModifierLua", Lua_SetDamageModifierLua},   // iter 154 LIVE
-        {"SWFOC_SetRateOfFireModifierLua", Lua_SetRateOfFireModifierLua}, // iter 154 LIVE
-        {"SWFOC_PlayerGiveMoneyLua", Lua_PlayerGiveMoneyLua},   // iter 155 LIVE
-        {"SWFOC_PlayerSetTechLevelLua", Lua_PlayerSetTechLevelLua}, // iter 155 LIVE
-        {"SWFOC_PlayerUnlockTechLua", Lua_PlayerUnlockTechLua},  // iter 155 LIVE
-        {"SWFOC_ActivateAbilityLua", Lua_ActivateAbilityLua},    // iter 156 LIVE
-        {"SWFOC_DisableCaptureLua",  Lua_DisableCaptureLua},     // iter 156 LIVE
-        {"SWFOC_SetGarrisonSpawnLua",Lua_SetGarrisonSpawnLua},   // iter 156 LIVE
-        {"SWFOC_CancelHyperspaceLua",Lua_CancelHyperspaceLua},   // iter 156 LIVE
-        {"SWFOC_SetInLimboLua",      Lua_SetInLimboLua},         // iter 157 LIVE
-        {"SWFOC_SetCheckContestedSpaceLua", Lua_SetCheckContestedSpaceLua}, // iter 157 LIVE
-        {"SWFOC_SellUnitLua",        Lua_SellUnitLua},           // iter 157 LIVE
-        {"SWFOC_BribeLua",           Lua_BribeLua},              // iter 157 LIVE
-        {"SWFOC_MoveToLua",          Lua_MoveToLua},             // iter 157 LIVE
-        {"SWFOC_FireSpecialWeaponLua", Lua_FireSpecialWeaponLua},// iter 157 LIVE
-        {"SWFOC_DisableBombingRunLua", Lua_DisableBombingRunLua},// iter 158 LIVE
-        {"SWFOC_FlashGuiObjectLua",  Lua_FlashGuiObjectLua},     // iter 158 LIVE
-        {"SWFOC_HideGuiObjectLua",   Lua_HideGuiObjectLua},      // iter 158 LIVE
-        {"SWFOC_StoryEventLua",      Lua_StoryEventLua},         // iter 159 LIVE
-        {"SWFOC_AddObjectiveLua",    Lua_AddObjectiveLua},       // iter 159 LIVE
-        {"SWFOC_PlayMusicLua",       Lua_PlayMusicLua},          // iter 159 LIVE
-        {"SWFOC_PlaySfxEventLua",    Lua_PlaySfxEventLua},       // iter 159 LIVE
-        {"SWFOC_LockControlsLua",    Lua_LockControlsLua},       // iter 160 LIVE
-        {"SWFOC_DisableOrbitalBombardmentLua", Lua_DisableOrbitalBombardmentLua}, // iter 160 LIVE
-        {"SWFOC_StoryEventTriggerLua", Lua_StoryEventTriggerLua},// iter 160 LIVE
-        {"SWFOC_LockTechLua",        Lua_LockTechLua},           // iter 161 LIVE
-        {"SWFOC_MakeAllyLua",        Lua_MakeAllyLua},           // iter 161 LIVE
-        {"SWFOC_MakeEnemyLua",       Lua_MakeEnemyLua},          // iter 161 LIVE
-        {"SWFOC_OverrideMaxSpeedLua", Lua_OverrideMaxSpeedLua},  // iter 162 LIVE
-        {"SWFOC_SuspendAiLua",       Lua_SuspendAiLua},          // iter 162 LIVE
-        {"SWFOC_FadeScreenInLua",    Lua_FadeScreenInLua},       // iter 162 LIVE
-        {"SWFOC_ZoomCameraLua",      Lua_ZoomCameraLua},         // iter 162 LIVE
-        {"SWFOC_AttackTargetLua",    Lua_AttackTargetLua},       // iter 163 LIVE
-        {"SWFOC_GuardTargetLua",     Lua_GuardTargetLua},        // iter 163 LIVE
-        {"SWFOC_DivertLua",          Lua_DivertLua},             // iter 163 LIVE
-        {"SWFOC_EnableAsActorLua",   Lua_EnableAsActorLua},      // iter 164 LIVE
-        {"SWFOC_ReleaseCreditsForTacticalLua", Lua_ReleaseCreditsForTacticalLua}, // iter 164 LIVE
-        {"SWFOC_SelectObjectLua",    Lua_SelectObjectLua},       // iter 164 LIVE
-        {"SWFOC_FadeScreenOutLua",   Lua_FadeScreenOutLua},      // iter 165 LIVE
-        {"SWFOC_RotateCameraByLua",  Lua_RotateCameraByLua},     // iter 165 LIVE
-        {"SWFOC_PointCameraAtLua",   Lua_PointCameraAtLua},      // iter 165 LIVE
-        {"SWFOC_StopAllMusicLua",    Lua_StopAllMusicLua},       // iter 166 LIVE (new helper)
-        {"SWFOC_ResumeModeBasedMusicLua", Lua_ResumeModeBasedMusicLua}, // iter 166 LIVE (new helper)
-        {"SWFOC_ShowGuiObjectLua",   Lua_ShowGuiObjectLua},      // iter 166 LIVE
-        {"SWFOC_GetHullLua",         Lua_GetHullLua},            // iter 167 LIVE (new getter helper)
-        {"SWFOC_GetHealthLua",       Lua_GetHealthLua},          // iter 167 LIVE (new getter helper)
-        {"SWFOC_GetShieldLua",       Lua_GetUnitShieldLuaGetter},// iter 167 LIVE (new getter helper)
-        {"SWFOC_HasAttackTargetLua", Lua_HasAttackTargetLua},    // iter 168 LIVE
-        {"SWFOC_AreEnginesOnlineLua", Lua_AreEnginesOnlineLua},  // iter 168 LIVE
-        {"SWFOC_GetOwnerLua",        Lua_GetOwnerLua},           // iter 168 LIVE
-        {"SWFOC_GetTypeLua",         Lua_GetUnitTypeLua},        // iter 169 LIVE
-        {"SWFOC_GetCreditsLua",      Lua_GetCreditsLua},         // iter 169 LIVE
-        {"SWFOC_GetFactionLua",      Lua_GetFactionLua},         // iter 169 LIVE
-        {"SWFOC_GetTechLevelLua",    Lua_GetTechLevelLua},       // iter 169 LIVE
-        {"SWFOC_GetNameLua",         Lua_GetNameLua},            // iter 170 LIVE
-        {"SWFOC_IsStealthedLua",     Lua_IsStealthedLua},        // iter 170 LIVE
-        {"SWFOC_IsInLimboLua",       Lua_IsInLimboLua},          // iter 170 LIVE
-        {"SWFOC_IsCapturableLua",    Lua_IsCapturableLua},       // iter 170 LIVE
-        {"SWFOC_GetPositionLua",     Lua_GetPositionLua},        // iter 171 LIVE
-        {"SWFOC_GetParentObjectLua", Lua_GetParentObjectLua},    // iter 171 LIVE
-        {"SWFOC_GetAttackTargetLua", Lua_GetAttackTargetLua},    // iter 171 LIVE
-        {"SWFOC_GetDamageModifierLua", Lua_GetDamageModifierLua},// iter 171 LIVE
-        {"SWFOC_GetGarrisonUnitsLua", Lua_GetGarrisonUnitsLua},  // iter 172 LIVE — 100 milestone
-        {"SWFOC_GetContainedObjectCountLua", Lua_GetContainedObjectCountLua}, // iter 172 LIVE
-        {"SWFOC_GetBehaviorIdLua",   Lua_GetBehaviorIdLua},      // iter 172 LIVE
-        {"SWFOC_GetRateOfFireModifierLua", Lua_GetRateOfFireModifierLua}, // iter 172 LIVE
-        {"SWFOC_IsAbilityActiveLua", Lua_IsAbilityActiveLua},    // iter 173 LIVE (new arg-getter helper)
-        {"SWFOC_HasPropertyLua",     Lua_HasPropertyLua},        // iter 173 LIVE
-        {"SWFOC_IsCategoryLua",      Lua_IsCategoryLua},         // iter 173 LIVE
-        {"SWFOC_GetDistanceLua",     Lua_GetDistanceLua},        // iter 173 LIVE
-        {"SWFOC_GetBonePositionLua", Lua_GetBonePositionLua},    // iter 174 LIVE
-        {"SWFOC_ContainsObjectTypeLua", Lua_ContainsObjectTypeLua}, // iter 174 LIVE
-        {"SWFOC_GetSpaceStationLevelLua", Lua_GetSpaceStationLevelLua}, // iter 174 LIVE
-        {"SWFOC_GetTypeOfUnitLua",   Lua_GetTypeOfUnitLua},      // iter 174 LIVE
-        {"SWFOC_TaskForceMoveToLua", Lua_TaskForceMoveToLua},    // iter 175 LIVE
-        {"SWFOC_TaskForceReinforceLua", Lua_TaskForceReinforceLua}, // iter 175 LIVE
-        {"SWFOC_TaskForceReleaseReinforcementsLua", Lua_TaskForceReleaseReinforcementsLua}, // iter 175 LIVE
-        {"SWFOC_TaskForceLaunchUnitsLua", Lua_TaskForceLaunchUnitsLua}, // iter 175 LIVE
-        {"SWFOC_TaskForceAttackTargetLua", Lua_TaskForceAttackTargetLua}, // iter 176 LIVE
-        {"SWFOC_TaskForceGuardTargetLua", Lua_TaskForceGuardTargetLua}, // iter 176 LIVE
-        {"SWFOC_TaskForceLandUnitsLua", Lua_TaskForceLandUnitsLua}, // iter 176 LIVE
-        {"SWFOC_TaskForceSetAsGoalSystemRemovableLua", Lua_TaskForceSetAsGoalSystemRemovableLua}, // iter 176 LIVE
-        {"SWFOC_FindObjectTypeLua", Lua_FindObjectTypeLua},      // iter 177 LIVE (new global-getter helper)
-        {"SWFOC_FindPlanetLua",     Lua_FindPlanetLua},          // iter 177 LIVE
-        {"SWFOC_FindFirstObjectLua", Lua_FindFirstObjectLua},    // iter 177 LIVE
-        {"SWFOC_GetGameModeLua",    Lua_GetGameModeLua},         // iter 178 LIVE (NEW global-no-arg-getter helper — closes dispatcher matrix)
-        {"SWFOC_GetLocalPlayerLua", Lua_GetLocalPlayerLua},      // iter 178 LIVE
-        {"SWFOC_GetSecondsPerGameMinuteLua", Lua_GetSecondsPerGameMinuteLua}, // iter 178 LIVE
-        {"SWFOC_IsEnemyLua",                 Lua_IsEnemyLua},                 // iter 179 LIVE (player-method via iter-173 helper)
-        {"SWFOC_IsAllyLua",                  Lua_IsAllyLua},                  // iter 179 LIVE
-        {"SWFOC_FindAllObjectsOfTypeLua",    Lua_FindAllObjectsOfTypeLua},    // iter 179 LIVE (global-arg via iter-177 helper)
-        {"SWFOC_TaskForceMoveToTargetLua",   Lua_TaskForceMoveToTargetLua},   // iter 179 LIVE (TaskForce-method via iter-154 helper)
-        {"SWFOC_FOWRevealAllLua",            Lua_FOWRevealAllLua},            // iter 180 LIVE (NAMESPACED via iter-158 — FOWManager.Reveal_All)
-        {"SWFOC_FOWUndoRevealAllLua",        Lua_FOWUndoRevealAllLua},        // iter 180 LIVE
-        {"SWFOC_UnlockControlsLua",          Lua_UnlockControlsLua},          // iter 180 LIVE (pairs with iter-160 LockControls)
-        {"SWFOC_CorruptLua",                 Lua_CorruptLua},                 // iter 180 LIVE (Underworld faction; pairs with iter-157 Bribe)
-        {"SWFOC_ThreadGetCurrentStageLua",   Lua_ThreadGetCurrentStageLua},   // iter 181 LIVE (NAMESPACED via iter-178 — extends iter-180 finding)
-        {"SWFOC_SFXAllowUnitReponseVoLua",   Lua_SFXAllowUnitReponseVoLua},   // iter 181 LIVE (SFXManager namespace; preserves engine "Reponse" typo)
-        {"SWFOC_GlobalMakeAllyLua",          Lua_GlobalMakeAllyLua},          // iter 182 LIVE (NEW global-2-arg helper — 10th in dispatcher set)
-        {"SWFOC_GlobalMakeEnemyLua",         Lua_GlobalMakeEnemyLua},         // iter 182 LIVE
-        {"SWFOC_FOWRevealLua",               Lua_FOWRevealLua},               // iter 184 LIVE (NEW global-3-arg helper — 11th; FOWManager.Reveal partial-reveal)
-        {"SWFOC_ReinforceUnitLua",           Lua_ReinforceUnitLua},           // iter 185 LIVE (3-arg via iter-184; reinforcement-pool spawn)
-        {"SWFOC_SpawnFromReinforcementPoolLua", Lua_SpawnFromReinforcementPoolLua}, // iter 185 LIVE
-        {"SWFOC_CreateGenericObjectLua",     Lua_CreateGenericObjectLua},     // iter 185 LIVE (param order: type, position, player — DIFFERS from Spawn_Unit)
-        {"SWFOC_FindNearestLua",             Lua_FindNearestLua},             // iter 186 LIVE (NEW global-3-arg-getter helper — 12th; symmetric to iter-184)
-        // 2026-04-28 (iter 108) — LIVE per-unit owner change via Change_Owner.
-        {"SWFOC_ChangeUnitOwner",      Lua_ChangeUnitOwner},
-        // 2026-04-28 (iter 109) — LIVE unit spawn via Spawn_Unit Lua API.
-        {"SWFOC_SpawnUnitLua",         Lua_SpawnUnitLua},
-        // 2026-04-28 (iter 110) — LIVE per-unit invuln via Make_Invulnerable.
-        {"SWFOC_MakeUnitInvulnLua",    Lua_MakeUnitInvulnLua},
-        // 2026-04-28 (iter 111) — LIVE per-unit Hide / Prevent_AI_Usage / Set_Selectable.
-        {"SWFOC_HideUnitLua",            Lua_HideUnitLua},
-        {"SWFOC_PreventAiUsageLua",      Lua_PreventAiUsageLua},
-        {"SWFOC_SetUnitSelectableLua",   Lua_SetUnitSelectableLua},
-        // 2026-04-28 (iter 112) — LIVE per-unit Despawn / Stop / Retreat.
-        {"SWFOC_DespawnUnitLua",         Lua_DespawnUnitLua},
-        {"SWFOC_StopUnitLua",            Lua_StopUnitLua},
-        {"SWFOC_RetreatUnitLua",         Lua_RetreatUnitLua},
-        // 2026-04-28 (iter 113) — UNIVERSAL Lua-method dispatcher.
-        {"SWFOC_CallObjMethodLua",       Lua_CallObjMethodLua},
-        {"SWFOC_SpawnUnit",          Lua_SpawnUnit},
-        {"SWFOC_SetBuildCost",       Lua_SetBuildCost},
-        {"SWFOC_SetUnitCapOverride", Lua_SetUnitCapOverride},
-        {"SWFOC_SetUnitField",       Lua_SetUnitField},
-        {"SWFOC_InstantBuild",       Lua_InstantBuild},
-        {"SWFOC_FreeBuild",          Lua_FreeBuild},
-        {"SWFOC_EventStreamDrain",   Lua_EventStreamDrain},
-        // Phase 3.2 (continuation): per-slot writers + observers — these
-        // were previously DEAD. They existed in source but the inline
-        // Hook_lua_open block never registered them, so any live call
-        // hit a nil global. Drift ends here.
-        {"SWFOC_SetCreditsForSlot",  Lua_SetCreditsForSlot},
-        {"SWFOC_GetCreditsForSlot",  Lua_GetCreditsForSlot},
-        {"SWFOC_SetTechForSlot",     Lua_SetTechForSlot},
-        {"SWFOC_GetTechForSlot",     Lua_GetTechForSlot},
-        {"SWFOC_DrainEnemyCredits",  Lua_DrainEnemyCredits},
-        {"SWFOC_SetHeroRespawn",     Lua_SetHeroRespawn},
-        {"SWFOC_PreventUnitDeath",   Lua_PreventUnitDeath},
-        {"SWFOC_GetMaxCredits",      Lua_GetMaxCredits},
-        // 2026-04-10 diagnostic helpers — live self-report of bridge health.
-        {"SWFOC_DiagListRegisteredFunctions", Lua_DiagListRegisteredFunctions},
-        {"SWFOC_DiagPipeStats",               Lua_DiagPipeStats},
-        {"SWFOC_DiagGameTick",                Lua_DiagGameTick},
-        {"SWFOC_DiagSelfTest",                Lua_DiagSelfTest},
-        // 2026-04-23 selection chain diagnostic — dumps every intermediate
-        // pointer so we can empirically verify the two-deref fix against
-        // future game-state shifts.
-        {"SWFOC_DiagSelection",               Lua_DiagSelection},
-        // 2026-04-27 (Spawn-tab live filtering — Task #222):
-        // Returns "1"/"0" flags telling the editor which catalog types
-        // are actually loaded in the current game state. Used to keep
-        // mod A's units from showing up when the operator is running
-        // mod B (or vanilla).
-        {"SWFOC_BatchTypeExists",             Lua_BatchTypeExists},
-    };
-    constexpr int kHelperCount = static_cast<int>(sizeof(funcs)/sizeof(funcs[0]));
-
-    // Build the manifest exactly once — this is the compile-time proof of
-    // what we registered. Safe to rebuild on every lua_open fire because
-    // the table is static and identical each time. Keeps the code simple
-    // and avoids a "populated" flag that could desync.
+// Helper targets by registration index, for Lua_PerfTrampoline. Written
+// once by BindHelpers before any helper can be called.
+static lua_CFunction g_perfTargets[PERF_FUNC_SLOTS] = {};
+
+// Every helper is registered as this closure with its registration index as
+// the one upvalue, so calls are counted and timed in g_perf without touching
+// the helpers. A helper that raises a Lua error longjmps past the timing:
+// it is counted in `calls` but not in the latency histogram.
+static int Lua_PerfTrampoline(lua_State* L) {
+    const int index = (int)fn_tonumber(L, lua_upvalueindex(1));
+    PerfFuncSlot* slot = PerfFuncAt(&g_perf, index);
+    if (!slot || !g_perfTargets[index]) return 0;
+    slot->calls.fetch_add(1, std::memory_order_relaxed);
+    const int64_t t0 = PipeQpcNow();
+    const int results = g_perfTargets[index](L);
+    PerfRecord(&slot->latency, PerfTicksToNs(PipeQpcNow() - t0));
+    return results;
+}
+
+static int Lua_SetCrashDump(lua_State* L);  // with CrashHandler below
+static void LoadCrashDumper();
+
+// 2026-10-14: when set, Hook_lua_open gives a new state only the SWFOC table
+// (RegisterLazy) and the full RegisterAll pass waits for the state's first
+// pipe or shared-memory command. Off by default.
+static volatile LONG g_lazyRegistration = 0;
+
+// SWFOC_SetLazyRegistration(enable) -> "OK: lazy registration on|off"
+// Applies to states opened afterwards; states already open keep their
+// globals. A bare call reports.
+static int Lua_SetLazyRegistration(lua_State* L) {
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER) {
+        InterlockedExchange(&g_lazyRegistration, fn_tonumber(L, 1) != 0.0 ? 1 : 0);
+    }
+    fn_pushstring(L, g_lazyRegistration ? "OK: lazy registration on" : "OK: lazy registration off");
+    return 1;
+}
+
+struct HelperEntry { const char* name; lua_CFunction func; };
+static const HelperEntry kHelpers[] = {
+    // Core / metadata
+    {"SWFOC_GetVersion",         Lua_GetVersion},
+    {"SWFOC_GetBuildInfo",       Lua_GetBuildInfo},
+    {"SWFOC_Log",                Lua_Log},
+    {"SWFOC_DoString",           Lua_DoString},
+    {"SWFOC_DrainPipe",          Lua_DrainPipe},
+    {"SWFOC_StateInfo",          (lua_CFunction)SWFOC_StateInfo},
+    {"SWFOC_EventControl",       Lua_EventControl},
+    {"SWFOC_DumpState",          Lua_DumpState},
+    {"SWFOC_DumpStateAsync",     Lua_DumpStateAsync},
+    {"SWFOC_DumpStatePoll",      Lua_DumpStatePoll},
+    // Player / economy
+    {"SWFOC_GetLocalPlayer",     Lua_GetLocalPlayer},
+    // 2026-04-25: v1 deleted (silent no-op in galactic mode);
+    // v2 unregistered (manual sweep without AI swap caused the
+    // dual-control bug confirmed live on 2026-04-25). v3 is the
+    // single canonical SetHumanPlayer surface; the v2 function
+    // remains in the source as historical reference but is no
+    // longer dispatchable from Lua.
+    {"SWFOC_SetHumanPlayer_v3",  Lua_SetHumanPlayer_v3},
+    {"SWFOC_GetAiBrain",         Lua_GetAiBrain},
+    {"SWFOC_NullAiBrain",        Lua_NullAiBrain},
+    {"SWFOC_AttachAiBrain",      Lua_AttachAiBrain},
+    {"SWFOC_SetCredits",         Lua_SetCredits},
+    {"SWFOC_GetCredits",         Lua_GetCredits},
+    {"SWFOC_SetTechLevel",       Lua_SetTechLevel},
+    {"SWFOC_UncapCredits",       Lua_UncapCredits},
+    {"SWFOC_HeroInstantRespawn", Lua_HeroInstantRespawn},
+    {"SWFOC_ListFactions",       Lua_ListFactions},
+    // Phase 3.2: combat / inspect helpers ported from CE trainer
+    {"SWFOC_SetUnitInvuln",      Lua_SetUnitInvuln},
+    {"SWFOC_SetUnitHull",        Lua_SetUnitHull},
+    {"SWFOC_InspectUnit",        Lua_InspectUnit},
+    {"SWFOC_GetHardpoints",      Lua_GetHardpoints},
+    {"SWFOC_GetSelectedUnit",    Lua_GetSelectedUnit},
+    {"SWFOC_GetSelectedUnits",   Lua_GetSelectedUnits},
+    {"SWFOC_ListTacticalUnits",  Lua_ListTacticalUnits},
+    // 2026-10-14: native-table forms for in-VM callers (lua_table_rows.h).
+    {"SWFOC_GetSelectedUnitsT",  Lua_GetSelectedUnitsT},
+    {"SWFOC_ListTacticalUnitsT", Lua_ListTacticalUnitsT},
+    {"SWFOC_GodMode",            Lua_GodMode},
+    {"SWFOC_OneHitKill",         Lua_OneHitKill},
+    {"SWFOC_CombinedGodOHK",     Lua_CombinedGodOHK},
+    {"SWFOC_RevealAll",          Lua_RevealAll},
+    {"SWFOC_GetAllPlayers",      Lua_GetAllPlayers},
+    {"SWFOC_EnumerateUnits",     Lua_EnumerateUnits},
+    {"SWFOC_EnumerateUnitsT",    Lua_EnumerateUnitsT},
+    {"SWFOC_EnumerateUnitsDelta", Lua_EnumerateUnitsDelta},
+    {"SWFOC_HealAllLocal",       Lua_HealAllLocal},
+    {"SWFOC_BulkMutateUnits",    Lua_BulkMutateUnits},
+    {"SWFOC_KillUnit",           Lua_KillUnit},
+    {"SWFOC_ReviveUnit",         Lua_ReviveUnit},
+    {"SWFOC_SetUnitShield",      Lua_SetUnitShield},
+    {"SWFOC_GetUnitShield",      Lua_GetUnitShield},
+    {"SWFOC_SetUnitSpeed",       Lua_SetUnitSpeed},
+    {"SWFOC_GetUnitSpeed",       Lua_GetUnitSpeed},
+    {"SWFOC_ClearUnitSpeedOverride", Lua_ClearUnitSpeedOverride},
+    {"SWFOC_ListHeroes",         Lua_ListHeroes},
+    {"SWFOC_SetHeroRespawnTimer",Lua_SetHeroRespawnTimer},
+    {"SWFOC_SetPermadeath",      Lua_SetPermadeath},
+    {"SWFOC_HeroStatEdit",       Lua_HeroStatEdit},
+    {"SWFOC_GetPlanets",         Lua_GetPlanets},
+    // 2026-10-14: native planet walk (WalkGalacticPlanets); "bin" fills
+    // the shared planet table.
+    {"SWFOC_ListPlanets",        Lua_ListPlanets},
+    {"SWFOC_ListPlanetsT",       Lua_ListPlanetsT},
+    // 2026-10-14: per-type populations from one list walk.
+    {"SWFOC_TypeCensus",         Lua_TypeCensus},
+    // 2026-10-14: exact-unit handle for the unit-method wires.
+    {"SWFOC_Unit",               Lua_Unit},
+    // 2026-10-14: grid-indexed range queries over the tactical units.
+    {"SWFOC_QueryUnitsInRadius", Lua_QueryUnitsInRadius},
+    {"SWFOC_QueryUnitsInRect",   Lua_QueryUnitsInRect},
+    {"SWFOC_QueryUnitsInRadiusT", Lua_QueryUnitsInRadiusT},
+    {"SWFOC_QueryUnitsInRectT",  Lua_QueryUnitsInRectT},
+    // 2026-10-14: EVT_POSITION streaming for tracked units.
+    {"SWFOC_TrackUnits",         Lua_TrackUnits},
+    // 2026-10-14: session timeline ring file (events + keyframes).
+    {"SWFOC_Timeline",           Lua_Timeline},
+    // 2026-10-14: batched spawns under a per-frame unit budget.
+    {"SWFOC_SpawnBatch",         Lua_SpawnBatch},
+    {"SWFOC_SpawnBatchStatus",   Lua_SpawnBatchStatus},
+    {"SWFOC_SetSpawnBudget",     Lua_SetSpawnBudget},
+    // 2026-05-07 (iter 299): Faction roster + current-mod enumeration wires.
+    // GetFactionRoster: DoString-driven via Find_All_Objects_Of_Type filter;
+    // mirrors iter-296 GetPlanets shape (engine-already-does-this 5th instance).
+    // GetCurrentMod: filesystem probe of ./Mods/*/Modinfo.xml (no engine Lua API);
+    // returns most-recently-accessed mod folder + path.
+    {"SWFOC_GetFactionRoster",   Lua_GetFactionRoster},
+    {"SWFOC_GetCurrentMod",      Lua_GetCurrentMod},
+    // 2026-05-07 (iter 300; 300th-iter milestone): mod enumeration —
+    // mirrors GetCurrentMod's filesystem walk but emits ALL candidate
+    // mods. Settings tab consumes for the operator-facing mod-picker UI.
+    {"SWFOC_ListMods",           Lua_ListMods},
+    {"SWFOC_ChangePlanetOwner",  Lua_ChangePlanetOwner},
+    {"SWFOC_ChangePlanetOwnerWithMode", Lua_ChangePlanetOwnerWithMode}, // iter 137 Phase-1 mirror
+    // 2026-10-14: batched planet edits resolved through the per-session
+    // planet ID table (planet_table.h).
+    {"SWFOC_PlanetBatch",        Lua_PlanetBatch},
+    {"SWFOC_SpawnAsStoryArrival",       Lua_SpawnAsStoryArrival},        // iter 137 Phase-1 mirror
+    {"SWFOC_GetPlanetTechAndBuildings", Lua_GetPlanetTechAndBuildings},
+    {"SWFOC_SetDiplomacy",       Lua_SetDiplomacy},
+    {"SWFOC_ListAbilities",      Lua_ListAbilities},
+    {"SWFOC_TriggerAbility",     Lua_TriggerAbility},
+    // 2026-05-07 (iter 450 scaffolding): SWFOC_TriggerVictory wrapper.
+    // Validates victory_type vs. 14-of-18 known VictoryType enum names and
+    // stages pending state. The active MinHook detour is DORMANT (iter-450a
+    // will enable it once the AwaitingVictoryTest 48-byte struct layout +
+    // capture-on-CTOR hook are landed).
+    {"SWFOC_TriggerVictory",     Lua_TriggerVictory},
+    {"SWFOC_SetIncomeMultiplier",Lua_SetIncomeMultiplier},
+    {"SWFOC_SetGameSpeed",       Lua_SetGameSpeed},
+    {"SWFOC_FreezeCredits",      Lua_SetFreezeCredits},
+    {"SWFOC_SetBuildSpeed",      Lua_SetBuildSpeed},
+    {"SWFOC_SetPerFactionSpeedMultiplier", Lua_SetPerFactionSpeedMultiplier},
+    {"SWFOC_SetDamageMultiplier", Lua_SetDamageMultiplier},
+    {"SWFOC_GetDamageMultiplier", Lua_GetDamageMultiplier},
+    // 2026-04-28 (iter 96): LIVE-badged global-only siblings.
+    {"SWFOC_SetDamageMultiplierGlobal", Lua_SetDamageMultiplierGlobal},
+    // 2026-05-06 (iter 225): SetFireRate global LIVE wire — WeaponTick MinHook detour scales dt by g_fireRateMult_global
+    {"SWFOC_SetFireRateMultiplierGlobal", Lua_SetFireRateMultiplierGlobal},
+    {"SWFOC_GetFireRateMultiplierGlobal", Lua_GetFireRateMultiplierGlobal},
+    // 2026-05-08 (iter 285): Tier 3 HUD counters via DeathHandler detour extension.
+    {"SWFOC_GetPlayerKills",     Lua_GetPlayerKills},
+    {"SWFOC_GetPlayerDeaths",    Lua_GetPlayerDeaths},
+    {"SWFOC_GetTotalUnitsAlive", Lua_GetTotalUnitsAlive},
+    // 2026-05-06 (iter 230-231): FreezeCredits global LIVE wire — AddCredits MinHook detour. +4 LIVE flips.
+    {"SWFOC_SetCreditsFreezeGlobal", Lua_SetCreditsFreezeGlobal},
+    {"SWFOC_GetCreditsFreezeGlobal", Lua_GetCreditsFreezeGlobal},
+    {"SWFOC_SetCreditsMultiplierGlobal", Lua_SetCreditsMultiplierGlobal},
+    {"SWFOC_GetCreditsMultiplierGlobal", Lua_GetCreditsMultiplierGlobal},
+    {"SWFOC_GetDamageMultiplierGlobal", Lua_GetDamageMultiplierGlobal},
+    {"SWFOC_SetFireRate",        Lua_SetFireRate},
+    {"SWFOC_SetAreaDamage",      Lua_SetAreaDamage},
+    {"SWFOC_SetTargetFilter",    Lua_SetTargetFilter},
+    {"SWFOC_ToggleOHKAttackPower", Lua_ToggleOHKAttackPower},
+    {"SWFOC_FreezeAI",           Lua_FreezeAI},
+    {"SWFOC_FreeCam",            Lua_FreeCam},
+    {"SWFOC_SetCameraPos",       Lua_SetCameraPos},
+    {"SWFOC_GetCameraPos",       Lua_GetCameraPos},
+    // 2026-04-28 (iter 107) — LIVE camera target via engine Lua API.
+    {"SWFOC_ScrollCameraToTarget", Lua_ScrollCameraToTarget},
+    {"SWFOC_CameraFollow",       Lua_CameraFollow},        // iter 143 LIVE
+    {"SWFOC_RotateCameraTo",     Lua_RotateCameraTo},      // iter 144 LIVE
+    {"SWFOC_StartCinematicCamera", Lua_StartCinematicCamera},                  // iter 145 LIVE
+    {"SWFOC_EndCinematicCamera", Lua_EndCinematicCamera},                      // iter 145 LIVE
+    {"SWFOC_SetCinematicCameraKey", Lua_SetCinematicCameraKey},                // iter 145 LIVE
+    {"SWFOC_TransitionCinematicCameraKey", Lua_TransitionCinematicCameraKey},  // iter 145 LIVE
+    // 2026-10-14: whole-path camera playback from Hook_luaD_call.
+    {"SWFOC_CameraPath", Lua_CameraPath},
+    {"SWFOC_LetterBoxOn",        Lua_LetterBoxOn},          // iter 150 LIVE
+    {"SWFOC_LetterBoxOff",       Lua_LetterBoxOff},         // iter 150 LIVE
+    {"SWFOC_TeleportUnitLua",    Lua_TeleportUnitLua},      // iter 151 LIVE
+    {"SWFOC_GalacticSpawnUnit",  Lua_GalacticSpawnUnit},    // iter 152 LIVE
+    {"SWFOC_SetCannotBeKilledLua", Lua_SetCannotBeKilledLua}, // iter 153 LIVE
+    {"SWFOC_EnableStealthLua",   Lua_EnableStealthLua},     // iter 153 LIVE
+    {"SWFOC_HealUnitLua",        Lua_HealUnitLua},          // iter 154 LIVE
+    {"SWFOC_TakeDamageLua",      Lua_TakeDamageLua},        // iter 154 LIVE
+    {"SWFOC_SetDamageModifierLua", Lua_SetDamageModifierLua},   // iter 154 LIVE
+    {"SWFOC_SetRateOfFireModifierLua", Lua_SetRateOfFireModifierLua}, // iter 154 LIVE
+    {"SWFOC_PlayerGiveMoneyLua", Lua_PlayerGiveMoneyLua},   // iter 155 LIVE
+    {"SWFOC_PlayerSetTechLevelLua", Lua_PlayerSetTechLevelLua}, // iter 155 LIVE
+    {"SWFOC_PlayerUnlockTechLua", Lua_PlayerUnlockTechLua},  // iter 155 LIVE
+    {"SWFOC_ActivateAbilityLua", Lua_ActivateAbilityLua},    // iter 156 LIVE
+    {"SWFOC_DisableCaptureLua",  Lua_DisableCaptureLua},     // iter 156 LIVE
+    {"SWFOC_SetGarrisonSpawnLua",Lua_SetGarrisonSpawnLua},   // iter 156 LIVE
+    {"SWFOC_CancelHyperspaceLua",Lua_CancelHyperspaceLua},   // iter 156 LIVE
+    {"SWFOC_SetInLimboLua",      Lua_SetInLimboLua},         // iter 157 LIVE
+    {"SWFOC_SetCheckContestedSpaceLua", Lua_SetCheckContestedSpaceLua}, // iter 157 LIVE
+    {"SWFOC_SellUnitLua",        Lua_SellUnitLua},           // iter 157 LIVE
+    {"SWFOC_BribeLua",           Lua_BribeLua},              // iter 157 LIVE
+    {"SWFOC_MoveToLua",          Lua_MoveToLua},             // iter 157 LIVE
+    {"SWFOC_FireSpecialWeaponLua", Lua_FireSpecialWeaponLua},// iter 157 LIVE
+    {"SWFOC_DisableBombingRunLua", Lua_DisableBombingRunLua},// iter 158 LIVE
+    {"SWFOC_FlashGuiObjectLua",  Lua_FlashGuiObjectLua},     // iter 158 LIVE
+    {"SWFOC_HideGuiObjectLua",   Lua_HideGuiObjectLua},      // iter 158 LIVE
+    {"SWFOC_StoryEventLua",      Lua_StoryEventLua},         // iter 159 LIVE
+    {"SWFOC_AddObjectiveLua",    Lua_AddObjectiveLua},       // iter 159 LIVE
+    {"SWFOC_PlayMusicLua",       Lua_PlayMusicLua},          // iter 159 LIVE
+    {"SWFOC_PlaySfxEventLua",    Lua_PlaySfxEventLua},       // iter 159 LIVE
+    {"SWFOC_LockControlsLua",    Lua_LockControlsLua},       // iter 160 LIVE
+    {"SWFOC_DisableOrbitalBombardmentLua", Lua_DisableOrbitalBombardmentLua}, // iter 160 LIVE
+    {"SWFOC_StoryEventTriggerLua", Lua_StoryEventTriggerLua},// iter 160 LIVE
+    {"SWFOC_LockTechLua",        Lua_LockTechLua},           // iter 161 LIVE
+    {"SWFOC_MakeAllyLua",        Lua_MakeAllyLua},           // iter 161 LIVE
+    {"SWFOC_MakeEnemyLua",       Lua_MakeEnemyLua},          // iter 161 LIVE
+    {"SWFOC_OverrideMaxSpeedLua", Lua_OverrideMaxSpeedLua},  // iter 162 LIVE
+    {"SWFOC_SuspendAiLua",       Lua_SuspendAiLua},          // iter 162 LIVE
+    {"SWFOC_FadeScreenInLua",    Lua_FadeScreenInLua},       // iter 162 LIVE
+    {"SWFOC_ZoomCameraLua",      Lua_ZoomCameraLua},         // iter 162 LIVE
+    {"SWFOC_AttackTargetLua",    Lua_AttackTargetLua},       // iter 163 LIVE
+    {"SWFOC_GuardTargetLua",     Lua_GuardTargetLua},        // iter 163 LIVE
+    {"SWFOC_DivertLua",          Lua_DivertLua},             // iter 163 LIVE
+    {"SWFOC_EnableAsActorLua",   Lua_EnableAsActorLua},      // iter 164 LIVE
+    {"SWFOC_ReleaseCreditsForTacticalLua", Lua_ReleaseCreditsForTacticalLua}, // iter 164 LIVE
+    {"SWFOC_SelectObjectLua",    Lua_SelectObjectLua},       // iter 164 LIVE
+    {"SWFOC_FadeScreenOutLua",   Lua_FadeScreenOutLua},      // iter 165 LIVE
+    {"SWFOC_RotateCameraByLua",  Lua_RotateCameraByLua},     // iter 165 LIVE
+    {"SWFOC_PointCameraAtLua",   Lua_PointCameraAtLua},      // iter 165 LIVE
+    {"SWFOC_StopAllMusicLua",    Lua_StopAllMusicLua},       // iter 166 LIVE (new helper)
+    {"SWFOC_ResumeModeBasedMusicLua", Lua_ResumeModeBasedMusicLua}, // iter 166 LIVE (new helper)
+    {"SWFOC_ShowGuiObjectLua",   Lua_ShowGuiObjectLua},      // iter 166 LIVE
+    {"SWFOC_GetHullLua",         Lua_GetHullLua},            // iter 167 LIVE (new getter helper)
+    {"SWFOC_GetHealthLua",       Lua_GetHealthLua},          // iter 167 LIVE (new getter helper)
+    {"SWFOC_GetShieldLua",       Lua_GetUnitShieldLuaGetter},// iter 167 LIVE (new getter helper)
+    {"SWFOC_HasAttackTargetLua", Lua_HasAttackTargetLua},    // iter 168 LIVE
+    {"SWFOC_AreEnginesOnlineLua", Lua_AreEnginesOnlineLua},  // iter 168 LIVE
+    {"SWFOC_GetOwnerLua",        Lua_GetOwnerLua},           // iter 168 LIVE
+    {"SWFOC_GetTypeLua",         Lua_GetUnitTypeLua},        // iter 169 LIVE
+    {"SWFOC_GetCreditsLua",      Lua_GetCreditsLua},         // iter 169 LIVE
+    {"SWFOC_GetFactionLua",      Lua_GetFactionLua},         // iter 169 LIVE
+    {"SWFOC_GetTechLevelLua",    Lua_GetTechLevelLua},       // iter 169 LIVE
+    {"SWFOC_GetNameLua",         Lua_GetNameLua},            // iter 170 LIVE
+    {"SWFOC_IsStealthedLua",     Lua_IsStealthedLua},        // iter 170 LIVE
+    {"SWFOC_IsInLimboLua",       Lua_IsInLimboLua},          // iter 170 LIVE
+    {"SWFOC_IsCapturableLua",    Lua_IsCapturableLua},       // iter 170 LIVE
+    {"SWFOC_GetPositionLua",     Lua_GetPositionLua},        // iter 171 LIVE
+    {"SWFOC_GetParentObjectLua", Lua_GetParentObjectLua},    // iter 171 LIVE
+    {"SWFOC_GetAttackTargetLua", Lua_GetAttackTargetLua},    // iter 171 LIVE
+    {"SWFOC_GetDamageModifierLua", Lua_GetDamageModifierLua},// iter 171 LIVE
+    {"SWFOC_GetGarrisonUnitsLua", Lua_GetGarrisonUnitsLua},  // iter 172 LIVE — 100 milestone
+    {"SWFOC_GetContainedObjectCountLua", Lua_GetContainedObjectCountLua}, // iter 172 LIVE
+    {"SWFOC_GetBehaviorIdLua",   Lua_GetBehaviorIdLua},      // iter 172 LIVE
+    {"SWFOC_GetRateOfFireModifierLua", Lua_GetRateOfFireModifierLua}, // iter 172 LIVE
+    {"SWFOC_IsAbilityActiveLua", Lua_IsAbilityActiveLua},    // iter 173 LIVE (new arg-getter helper)
+    {"SWFOC_HasPropertyLua",     Lua_HasPropertyLua},        // iter 173 LIVE
+    {"SWFOC_IsCategoryLua",      Lua_IsCategoryLua},         // iter 173 LIVE
+    {"SWFOC_GetDistanceLua",     Lua_GetDistanceLua},        // iter 173 LIVE
+    {"SWFOC_GetBonePositionLua", Lua_GetBonePositionLua},    // iter 174 LIVE
+    {"SWFOC_ContainsObjectTypeLua", Lua_ContainsObjectTypeLua}, // iter 174 LIVE
+    {"SWFOC_GetSpaceStationLevelLua", Lua_GetSpaceStationLevelLua}, // iter 174 LIVE
+    {"SWFOC_GetTypeOfUnitLua",   Lua_GetTypeOfUnitLua},      // iter 174 LIVE
+    {"SWFOC_TaskForceMoveToLua", Lua_TaskForceMoveToLua},    // iter 175 LIVE
+    {"SWFOC_TaskForceReinforceLua", Lua_TaskForceReinforceLua}, // iter 175 LIVE
+    {"SWFOC_TaskForceReleaseReinforcementsLua", Lua_TaskForceReleaseReinforcementsLua}, // iter 175 LIVE
+    {"SWFOC_TaskForceLaunchUnitsLua", Lua_TaskForceLaunchUnitsLua}, // iter 175 LIVE
+    {"SWFOC_TaskForceAttackTargetLua", Lua_TaskForceAttackTargetLua}, // iter 176 LIVE
+    {"SWFOC_TaskForceGuardTargetLua", Lua_TaskForceGuardTargetLua}, // iter 176 LIVE
+    {"SWFOC_TaskForceLandUnitsLua", Lua_TaskForceLandUnitsLua}, // iter 176 LIVE
+    {"SWFOC_TaskForceSetAsGoalSystemRemovableLua", Lua_TaskForceSetAsGoalSystemRemovableLua}, // iter 176 LIVE
+    {"SWFOC_FindObjectTypeLua", Lua_FindObjectTypeLua},      // iter 177 LIVE (new global-getter helper)
+    {"SWFOC_FindPlanetLua",     Lua_FindPlanetLua},          // iter 177 LIVE
+    {"SWFOC_FindFirstObjectLua", Lua_FindFirstObjectLua},    // iter 177 LIVE
+    {"SWFOC_GetGameModeLua",    Lua_GetGameModeLua},         // iter 178 LIVE (NEW global-no-arg-getter helper — closes dispatcher matrix)
+    {"SWFOC_GetLocalPlayerLua", Lua_GetLocalPlayerLua},      // iter 178 LIVE
+    {"SWFOC_GetSecondsPerGameMinuteLua", Lua_GetSecondsPerGameMinuteLua}, // iter 178 LIVE
+    {"SWFOC_IsEnemyLua",                 Lua_IsEnemyLua},                 // iter 179 LIVE (player-method via iter-173 helper)
+    {"SWFOC_IsAllyLua",                  Lua_IsAllyLua},                  // iter 179 LIVE
+    {"SWFOC_FindAllObjectsOfTypeLua",    Lua_FindAllObjectsOfTypeLua},    // iter 179 LIVE (global-arg via iter-177 helper)
+    {"SWFOC_TaskForceMoveToTargetLua",   Lua_TaskForceMoveToTargetLua},   // iter 179 LIVE (TaskForce-method via iter-154 helper)
+    {"SWFOC_FOWRevealAllLua",            Lua_FOWRevealAllLua},            // iter 180 LIVE (NAMESPACED via iter-158 — FOWManager.Reveal_All)
+    {"SWFOC_FOWUndoRevealAllLua",        Lua_FOWUndoRevealAllLua},        // iter 180 LIVE
+    {"SWFOC_UnlockControlsLua",          Lua_UnlockControlsLua},          // iter 180 LIVE (pairs with iter-160 LockControls)
+    {"SWFOC_CorruptLua",                 Lua_CorruptLua},                 // iter 180 LIVE (Underworld faction; pairs with iter-157 Bribe)
+    {"SWFOC_ThreadGetCurrentStageLua",   Lua_ThreadGetCurrentStageLua},   // iter 181 LIVE (NAMESPACED via iter-178 — extends iter-180 finding)
+    {"SWFOC_SFXAllowUnitReponseVoLua",   Lua_SFXAllowUnitReponseVoLua},   // iter 181 LIVE (SFXManager namespace; preserves engine "Reponse" typo)
+    {"SWFOC_GlobalMakeAllyLua",          Lua_GlobalMakeAllyLua},          // iter 182 LIVE (NEW global-2-arg helper — 10th in dispatcher set)
+    {"SWFOC_GlobalMakeEnemyLua",         Lua_GlobalMakeEnemyLua},         // iter 182 LIVE
+    {"SWFOC_FOWRevealLua",               Lua_FOWRevealLua},               // iter 184 LIVE (NEW global-3-arg helper — 11th; FOWManager.Reveal partial-reveal)
+    {"SWFOC_ReinforceUnitLua",           Lua_ReinforceUnitLua},           // iter 185 LIVE (3-arg via iter-184; reinforcement-pool spawn)
+    {"SWFOC_SpawnFromReinforcementPoolLua", Lua_SpawnFromReinforcementPoolLua}, // iter 185 LIVE
+    {"SWFOC_CreateGenericObjectLua",     Lua_CreateGenericObjectLua},     // iter 185 LIVE (param order: type, position, player — DIFFERS from Spawn_Unit)
+    {"SWFOC_FindNearestLua",             Lua_FindNearestLua},             // iter 186 LIVE (NEW global-3-arg-getter helper — 12th; symmetric to iter-184)
+    // 2026-04-28 (iter 108) — LIVE per-unit owner change via Change_Owner.
+    {"SWFOC_ChangeUnitOwner",      Lua_ChangeUnitOwner},
+    // 2026-04-28 (iter 109) — LIVE unit spawn via Spawn_Unit Lua API.
+    {"SWFOC_SpawnUnitLua",         Lua_SpawnUnitLua},
+    // 2026-04-28 (iter 110) — LIVE per-unit invuln via Make_Invulnerable.
+    {"SWFOC_MakeUnitInvulnLua",    Lua_MakeUnitInvulnLua},
+    // 2026-04-28 (iter 111) — LIVE per-unit Hide / Prevent_AI_Usage / Set_Selectable.
+    {"SWFOC_HideUnitLua",            Lua_HideUnitLua},
+    {"SWFOC_PreventAiUsageLua",      Lua_PreventAiUsageLua},
+    {"SWFOC_SetUnitSelectableLua",   Lua_SetUnitSelectableLua},
+    // 2026-04-28 (iter 112) — LIVE per-unit Despawn / Stop / Retreat.
+    {"SWFOC_DespawnUnitLua",         Lua_DespawnUnitLua},
+    {"SWFOC_StopUnitLua",            Lua_StopUnitLua},
+    {"SWFOC_RetreatUnitLua",         Lua_RetreatUnitLua},
+    // 2026-04-28 (iter 113) — UNIVERSAL Lua-method dispatcher.
+    {"SWFOC_CallObjMethodLua",       Lua_CallObjMethodLua},
+    {"SWFOC_SpawnUnit",          Lua_SpawnUnit},
+    {"SWFOC_SetBuildCost",       Lua_SetBuildCost},
+    {"SWFOC_SetUnitCapOverride", Lua_SetUnitCapOverride},
+    {"SWFOC_SetUnitField",       Lua_SetUnitField},
+    {"SWFOC_InstantBuild",       Lua_InstantBuild},
+    {"SWFOC_FreeBuild",          Lua_FreeBuild},
+    {"SWFOC_EventStreamDrain",   Lua_EventStreamDrain},
+    {"SWFOC_SetEventStreamCapacity", Lua_SetEventStreamCapacity},
+    {"SWFOC_SetDamageEventLogging",  Lua_SetDamageEventLogging},
+    // 2026-10-14: per-slot / per-type damage and kill rollups.
+    {"SWFOC_CombatStats",            Lua_CombatStats},
+    {"SWFOC_SetLogLevel",            Lua_SetLogLevel},
+    {"SWFOC_DiagPerf",               Lua_DiagPerf},
+    {"SWFOC_DiagHookCost",           Lua_DiagHookCost},
+    {"SWFOC_SetCrashDump",           Lua_SetCrashDump},
+    // Phase 3.2 (continuation): per-slot writers + observers — these
+    // were previously DEAD. They existed in source but the inline
+    // Hook_lua_open block never registered them, so any live call
+    // hit a nil global. Drift ends here.
+    {"SWFOC_SetCreditsForSlot",  Lua_SetCreditsForSlot},
+    {"SWFOC_GetCreditsForSlot",  Lua_GetCreditsForSlot},
+    {"SWFOC_SetTechForSlot",     Lua_SetTechForSlot},
+    {"SWFOC_GetTechForSlot",     Lua_GetTechForSlot},
+    {"SWFOC_DrainEnemyCredits",  Lua_DrainEnemyCredits},
+    {"SWFOC_SetHeroRespawn",     Lua_SetHeroRespawn},
+    {"SWFOC_PreventUnitDeath",   Lua_PreventUnitDeath},
+    {"SWFOC_GetMaxCredits",      Lua_GetMaxCredits},
+    // 2026-04-10 diagnostic helpers — live self-report of bridge health.
+    {"SWFOC_DiagListRegisteredFunctions", Lua_DiagListRegisteredFunctions},
+    {"SWFOC_DiagPipeStats",               Lua_DiagPipeStats},
+    {"SWFOC_DiagGameTick",                Lua_DiagGameTick},
+    {"SWFOC_SetPipeDrainBudget",          Lua_SetPipeDrainBudget},
+    {"SWFOC_DiagSelfTest",                Lua_DiagSelfTest},
+    // 2026-04-23 selection chain diagnostic — dumps every intermediate
+    // pointer so we can empirically verify the two-deref fix against
+    // future game-state shifts.
+    {"SWFOC_DiagSelection",               Lua_DiagSelection},
+    // 2026-04-27 (Spawn-tab live filtering — Task #222):
+    // Returns "1"/"0" flags telling the editor which catalog types
+    // are actually loaded in the current game state. Used to keep
+    // mod A's units from showing up when the operator is running
+    // mod B (or vanilla).
+    {"SWFOC_BatchTypeExists",             Lua_BatchTypeExists},
+    // 2026-10-14: SWFOC table instead of globals on new states.
+    {"SWFOC_SetLazyRegistration",         Lua_SetLazyRegistration},
+};
+static constexpr int kHelperCount = static_cast<int>(sizeof(kHelpers)/sizeof(kHelpers[0]));
+// kHelpers positions sorted by short name, for Lua_SwfocIndex.
+static HelperIndex g_helperIndex;
+static LONG g_helpersBound = 0;
+
+// One time, before the first state is registered: the manifest, the perf
+// slots and the name index. The table is static, so a second pass would
+// only produce the same result.
+static void BindHelpers() {
+    if (InterlockedCompareExchange(&g_helpersBound, 1, 0) != 0) return;
     size_t moff = 0;
     g_registeredFunctionManifest[0] = '\0';
     for (int i = 0; i < kHelperCount; i++) {
@@ -8428,21 +11482,94 @@ static void RegisterAll(lua_State* L) {
             ? 0 : sizeof(g_registeredFunctionManifest) - moff - 1;
         if (remaining == 0) break;
         int n = snprintf(g_registeredFunctionManifest + moff, remaining,
-                         "%s%s", i > 0 ? "," : "", funcs[i].name);
+                         "%s%s", i > 0 ? "," : "", kHelpers[i].name);
         if (n <= 0 || (size_t)n >= remaining) break;
         moff += (size_t)n;
     }
     g_registeredFunctionCount = kHelperCount;
+    for (int i = 0; i < kHelperCount; i++) {
+        if (PerfFuncBind(&g_perf, i, kHelpers[i].name)) g_perfTargets[i] = kHelpers[i].func;
+    }
+    HelperIndexBuild(&g_helperIndex, kHelpers, (size_t)kHelperCount);
+}
+
+// Pushes helper `i` as registered: through Lua_PerfTrampoline (index as
+// upvalue) when it fits in g_perf, bound directly and untimed otherwise.
+static void PushHelper(lua_State* L, int i) {
+    if (g_perfTargets[i]) {
+        fn_pushnumber(L, i);
+        fn_pushcclosure(L, Lua_PerfTrampoline, 1);
+    } else {
+        fn_pushcclosure(L, kHelpers[i].func, 0);
+    }
+}
+
+// __index(t, key) of the SWFOC table: the helper named key (GetCredits or
+// SWFOC_GetCredits), cached into t with rawset so the next read is a plain
+// table hit; nil for any other key.
+static int Lua_SwfocIndex(lua_State* L) {
+    const char* key = fn_type(L, 2) == LUA_TSTRING ? fn_tostring(L, 2) : nullptr;
+    const int i = HelperIndexFind(g_helperIndex, kHelpers, key);
+    if (i < 0) {
+        fn_pushnil(L);
+        return 1;
+    }
+    fn_pushvalue(L, 2);
+    PushHelper(L, i);
+    fn_rawset(L, 1);
+    fn_pushvalue(L, 2);
+    fn_gettable(L, 1);
+    return 1;
+}
+
+// Lazy registration: one global, SWFOC = setmetatable({}, {__index =
+// Lua_SwfocIndex}), in place of one global per helper.
+static void RegisterLazy(lua_State* L) {
+    BindHelpers();
+    fn_pushstring(L, "SWFOC");
+    fn_newtable(L);
+    fn_newtable(L);
+    fn_pushstring(L, "__index");
+    fn_pushcclosure(L, Lua_SwfocIndex, 0);
+    fn_settable(L, -3);
+    fn_setmetatable(L, -2);
+    fn_settable(L, LUA_GLOBALSINDEX);
+    LogDebug("[Bridge] SWFOC table registered (%d helpers, lazy)\n", kHelperCount);
+}
+
+static void RegisterAll(lua_State* L) {
+    BindHelpers();
 
     // Register every helper via the canonical Lua 5.0.2 triad:
     // push name (key) -> push cclosure (value) -> settable GLOBALSINDEX.
     for (int i = 0; i < kHelperCount; i++) {
-        fn_pushstring(L, funcs[i].name);
-        fn_pushcclosure(L, funcs[i].func, 0);
+        fn_pushstring(L, kHelpers[i].name);
+        PushHelper(L, i);
         fn_settable(L, LUA_GLOBALSINDEX);
-        Log("[Bridge] Registered %s\n", funcs[i].name);
+        LogDebug("[Bridge] Registered %s\n", kHelpers[i].name);
     }
     Log("[Bridge] Total helpers registered: %d\n", kHelperCount);
+
+    // Compile the embedded helper scripts into this state once, so the
+    // helpers that use them only pcall a closure.
+    int compiled = 0;
+    for (int id = 0; id < HELPER_SCRIPT_COUNT; id++) compiled += CompileHelperScript(L, id) ? 1 : 0;
+    Log("[Bridge] Helper scripts compiled: %d/%d\n", compiled, (int)HELPER_SCRIPT_COUNT);
+}
+
+// A state opened under lazy registration gets the full RegisterAll pass
+// before the first command it runs, so pipe and shared-memory scripts keep
+// calling SWFOC_* globals. Once per state; a state registered in full at
+// lua_open is already in g_fullRegisteredSet.
+static void EnsureFullRegistration(lua_State* L) {
+    if (StateSetContains(&g_fullRegisteredSet, L)) return;
+    EnterCriticalSection(&csRegistered);
+    const bool full = StateSetContains(&g_fullRegisteredSet, L);
+    if (!full) StateSetInsert(&g_fullRegisteredSet, L);
+    LeaveCriticalSection(&csRegistered);
+    if (full) return;
+    Log("[Bridge] Full registration on first command, state=%p\n", L);
+    RegisterAll(L);
 }
 
 // ======================================================================
@@ -8468,23 +11595,40 @@ static void RegisterAll(lua_State* L) {
 // slow enough that the timer callback is a negligible fraction of CPU
 // when the game is active (luaD_call is the primary drain path; the
 // timer only matters when the game is paused / defocused).
+//
+// 2026-10-14: on-demand wake. A paused-game command used to wait for the
+// next 100ms tick (50ms on average). The timer now hangs off a message-only
+// window owned by the main thread, and a pipe instance that queues a command
+// posts WM_SWFOC_DRAIN to it, so the drain runs on the very next message
+// pump. Posts are coalesced through g_drainWakePosted; a pass that leaves
+// work behind (drain budget) re-posts itself. The 100ms timer stays as the
+// fallback, and if the window cannot be created we keep the old windowless
+// timer.
+
+#define WM_SWFOC_DRAIN (WM_APP + 0x5F0)
 
 static volatile LONG g_drainGuard = 0; // prevent re-entrancy (shared by both drain paths)
 static UINT_PTR g_focusDrainTimerId = 0;
 static DWORD g_focusDrainThreadId = 0;
+static HWND g_drainHwnd = nullptr;
+static volatile LONG g_drainWakePosted = 0;
 
-static VOID CALLBACK FocusDrainTimerProc(HWND /*hwnd*/, UINT /*msg*/, UINT_PTR /*idEvent*/, DWORD /*dwTime*/) {
-    // Fires on the main thread via WM_TIMER dispatch. When the game is
+// Any thread: asks the main thread's message pump to run a drain pass.
+static void PipeWakeMainThread() {
+    HWND hwnd = g_drainHwnd;
+    if (!hwnd || InterlockedCompareExchange(&g_drainWakePosted, 1, 0) != 0) return;
+    if (!PostMessageA(hwnd, WM_SWFOC_DRAIN, 0, 0)) InterlockedExchange(&g_drainWakePosted, 0);
+}
+
+static void DrainFromMessagePump() {
+    // Runs on the main thread via message dispatch. When the game is
     // focused, Hook_luaD_call usually drains first and we're a no-op;
     // when the game is paused, this is the only path that runs.
-    if (!g_pipeCmdPending) return;
+    if (!PipeHasPendingWork()) return;
     if (InterlockedCompareExchange(&g_drainGuard, 1, 0) != 0) return;
 
-    lua_State* pickedState = nullptr;
     EnterCriticalSection(&csRegistered);
-    if (!registered_states.empty()) {
-        pickedState = reinterpret_cast<lua_State*>(registered_states[0]);
-    }
+    lua_State* pickedState = reinterpret_cast<lua_State*>(StateRegistryOldest(&registered_states));
     LeaveCriticalSection(&csRegistered);
 
     if (pickedState) {
@@ -8493,12 +11637,43 @@ static VOID CALLBACK FocusDrainTimerProc(HWND /*hwnd*/, UINT /*msg*/, UINT_PTR /
     InterlockedExchange(&g_drainGuard, 0);
 }
 
+static VOID CALLBACK FocusDrainTimerProc(HWND /*hwnd*/, UINT /*msg*/, UINT_PTR /*idEvent*/, DWORD /*dwTime*/) {
+    DrainFromMessagePump();
+}
+
+static LRESULT CALLBACK DrainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    if (msg != WM_SWFOC_DRAIN) return DefWindowProcA(hwnd, msg, wParam, lParam);
+    InterlockedExchange(&g_drainWakePosted, 0);  // later pushes post again
+    DrainFromMessagePump();
+    if (PipeHasPendingWork()) PipeWakeMainThread();
+    return 0;
+}
+
+// Message-only window for WM_SWFOC_DRAIN. Must run on the main thread.
+static HWND CreateDrainWindow() {
+    WNDCLASSA wc = {};
+    wc.lpfnWndProc   = DrainWndProc;
+    wc.hInstance     = GetModuleHandleA(nullptr);
+    wc.lpszClassName = "SWFOC_BridgeDrain";
+    if (!RegisterClassA(&wc) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) return nullptr;
+    return CreateWindowExA(0, wc.lpszClassName, "", 0, 0, 0, 0, 0, HWND_MESSAGE,
+                           nullptr, wc.hInstance, nullptr);
+}
+
 static void InstallFocusDrainTimer() {
     if (g_focusDrainTimerId != 0) return; // already installed
-    // Windowless timer — callback runs via the thread's WM_TIMER dispatch.
-    // The main thread MUST pump messages for this to fire; SWFOC does.
-    g_focusDrainTimerId = SetTimer(nullptr, 0, 100, FocusDrainTimerProc);
     g_focusDrainThreadId = GetCurrentThreadId();
+    HWND hwnd = CreateDrainWindow();
+    if (hwnd) {
+        g_focusDrainTimerId = SetTimer(hwnd, 1, 100, FocusDrainTimerProc);
+        g_drainHwnd = hwnd;  // publish last: pipe threads may post from now on
+        Log("[Bridge] Drain window %p installed (on-demand wake + 100ms fallback timer)\n", hwnd);
+    } else {
+        // Windowless timer — callback runs via the thread's WM_TIMER dispatch.
+        // The main thread MUST pump messages for this to fire; SWFOC does.
+        Log("[Bridge] Drain window FAILED (err=%lu) — timer-only drain\n", GetLastError());
+        g_focusDrainTimerId = SetTimer(nullptr, 0, 100, FocusDrainTimerProc);
+    }
     if (g_focusDrainTimerId != 0) {
         Log("[Bridge] Focus-drain timer installed (id=%zu, thread=%lu, period=100ms)\n",
             (size_t)g_focusDrainTimerId, g_focusDrainThreadId);
@@ -8508,60 +11683,145 @@ static void InstallFocusDrainTimer() {
     }
 }
 
-// ======================================================================
-// luaD_call hook — drains pipe commands on the MAIN THREAD
-// luaD_call is called on every Lua function invocation during gameplay,
-// so this gives us a frequent, safe execution point. The focus-drain
-// timer above handles the "game is paused" case.
-// ======================================================================
+// ======================================================================
+// luaD_call hook — drains pipe commands on the MAIN THREAD
+// luaD_call is called on every Lua function invocation during gameplay,
+// so this gives us a frequent, safe execution point. The focus-drain
+// timer above handles the "game is paused" case.
+// ======================================================================
+
+// Runs one shared-memory command and writes its reply (return value, "OK"
+// for nil/empty, or "ERR: msg") into result[0..cap]. Returns the reply
+// length. Leaves the Lua stack as it found it.
+static uint32_t ExecuteShmemCommand(lua_State* L, const char* cmd, char* result, size_t cap) {
+    CrashTrailCommand trail(CRASH_TRAIL_SHM, cmd);
+    EnsureFullRegistration(L);
+    int savedTop = fn_gettop(L);  // Stack guard
+    int err = DoString(L, cmd, "=shmem");
+    if (err == 0) {
+        // Capture return value (DoString requests 1 result)
+        const char* retVal = fn_tostring(L, -1);
+        if (retVal && retVal[0]) {
+            snprintf(result, cap, "%s", retVal);
+        } else {
+            snprintf(result, cap, "OK");
+        }
+    } else {
+        const char* msg = fn_tostring(L, -1);
+        snprintf(result, cap, "ERR: %s", msg ? msg : "unknown");
+    }
+    fn_settop(L, savedTop);  // Restore stack regardless
+    return (uint32_t)strlen(result);
+}
+
+// Runs up to SHMEM_RING_DRAIN_MAX ring commands, oldest first, straight out
+// of their slots (no staging copy), and wakes each waiting client.
+static void DrainSharedCmdRing(lua_State* L) {
+    for (int n = 0; n < SHMEM_RING_DRAIN_MAX; n++) {
+        int i = ShmRingPop(g_cmdRing);
+        if (i < 0) break;
+        SharedCmdRingSlot* slot = &g_cmdRing->slots[i];
+        slot->cmd[SHMEM_RING_CMD_MAX - 1] = '\0';  // client-written; never trust cmd_len
+        Log("[SHM] Ring slot %d seq=%u: %.64s%s\n", i, slot->seq, slot->cmd, strlen(slot->cmd) > 64 ? "..." : "");
+        slot->result_len = ExecuteShmemCommand(L, slot->cmd, slot->result, SHMEM_RING_RESULT_MAX);
+        if (ShmRingComplete(g_cmdRing, i) && g_ringDone[i]) SetEvent(g_ringDone[i]);
+    }
+}
+
+// True when this state has our SWFOC_* functions registered (safe — no
+// stack probing). Lock-free unless the registered-state set overflowed.
+static bool IsRegisteredState(lua_State* L) {
+    if (!registered_states.set.overflow.load(std::memory_order_acquire))
+        return StateSetContains(&registered_states.set, L);
+    EnterCriticalSection(&csRegistered);
+    bool found = StateRegistryHas(&registered_states, L);
+    LeaveCriticalSection(&csRegistered);
+    return found;
+}
+
+// Anything for Hook_luaD_call to do on this tick? Relaxed loads only; each
+// branch below re-reads its source with the ordering it needs.
+static inline bool BridgeHasWork(LONGLONG tick) {
+    return PipeHasPendingWork()
+        || PendingJournalHasWork(&g_pendingJournal)
+        || (tick & TELEMETRY_SAMPLE_MASK) == 0
+        || (g_cmdBuf && g_cmdBuf->cmd_seq.load(std::memory_order_relaxed) != g_lastCmdSeq)
+        || (g_cmdRing && g_cmdRing->pending.load(std::memory_order_relaxed) != 0)
+        || (g_positionTrack.hz && PositionTrackDue(&g_positionTrack, GetTickCount64()))
+        || (g_spawnQueue.pending > 0 && SpawnQueueDue(&g_spawnQueue, GetTickCount64()))
+        || (g_timelineOn.load(std::memory_order_relaxed) && GetTickCount64() >= g_timelineNextSample)
+        || (g_cameraPath.playing && GetTickCount64() >= g_cameraPath.nextMs)
+        || (g_evtCompact.staged.load(std::memory_order_relaxed) && GetTickCount64() >= g_evtCompactFlushTick);
+}
 
 static void Hook_luaD_call(lua_State* L, void* func, int nResults) {
     // SWFOC_DiagGameTick: increment BEFORE any other work so the counter
     // reflects every single luaD_call entry, including ones that skip the
     // drain branches (menu states, unregistered states, etc).
-    InterlockedIncrement64((LONG64*)&g_luaDCallTickCounter);
+    const LONGLONG tick = InterlockedIncrement64((LONG64*)&g_luaDCallTickCounter);
 
-    // Check if this state has our SWFOC_* functions registered (safe — no stack probing)
-    EnterCriticalSection(&csRegistered);
-    bool is_registered = std::find(registered_states.begin(), registered_states.end(), (void*)L) != registered_states.end();
-    LeaveCriticalSection(&csRegistered);
+    // 2026-10-14: idle fast path — no lock, no registered-state lookup.
+    if (!BridgeHasWork(tick)) {
+        real_luaD_call(L, func, nResults);
+        return;
+    }
+    const bool is_registered = IsRegisteredState(L);
 
     // Pipe command drain — execute on any registered state
-    if (g_pipeCmdPending && is_registered && InterlockedCompareExchange(&g_drainGuard, 1, 0) == 0) {
+    if (PipeHasPendingWork() && is_registered && InterlockedCompareExchange(&g_drainGuard, 1, 0) == 0) {
         DrainPipeCommand(L);
         InterlockedExchange(&g_drainGuard, 0);
     }
 
+    // "@telemetry" game-memory sample (see FillPipeTelemetry).
+    if ((tick & TELEMETRY_SAMPLE_MASK) == 0 && is_registered) SampleTelemetry(tick);
+
+    // 2026-10-14: compact HP batches older than EVT_COMPACT_MAX_AGE_MS.
+    if (g_evtCompact.staged.load(std::memory_order_relaxed) && GetTickCount64() >= g_evtCompactFlushTick)
+        FlushCompactEvents(EVT_COMPACT_MAX_AGE_MS);
+
+    // 2026-10-14: EVT_POSITION batches for SWFOC_TrackUnits.
+    if (is_registered && g_positionTrack.hz) {
+        const ULONGLONG now = GetTickCount64();
+        if (PositionTrackDue(&g_positionTrack, now)) SamplePositionTrack(now);
+    }
+
+    // 2026-10-14: selection and keyframes for SWFOC_Timeline.
+    if (is_registered && g_timelineOn.load(std::memory_order_relaxed)) {
+        const ULONGLONG now = GetTickCount64();
+        if (now >= g_timelineNextSample) SampleTimeline(tick, now);
+    }
+
+    // 2026-10-14: SWFOC_CameraPath poses.
+    if (is_registered && g_cameraPath.playing) StepCameraPath(GetTickCount64());
+
+    // 2026-10-14: SWFOC_SpawnBatch units, SWFOC_SetSpawnBudget per frame.
+    if (is_registered && g_spawnQueue.pending > 0 && InterlockedCompareExchange(&g_spawnGuard, 1, 0) == 0) {
+        const ULONGLONG now = GetTickCount64();
+        if (SpawnQueueDue(&g_spawnQueue, now)) DrainSpawnQueue(L, now);
+        InterlockedExchange(&g_spawnGuard, 0);
+    }
+
     // Shared memory command drain (for CE)
     if (g_cmdBuf && is_registered) {
             uint32_t seq = g_cmdBuf->cmd_seq.load(std::memory_order_acquire);
             if (seq != g_lastCmdSeq) {
                 g_lastCmdSeq = seq;
-                int savedTop = fn_gettop(L);  // Stack guard
                 char localCmd[4096];
                 memcpy(localCmd, g_cmdBuf->cmd, g_cmdBuf->cmd_len + 1);
                 Log("[SHM] Executing cmd seq=%u: %.64s%s\n", seq, localCmd, strlen(localCmd) > 64 ? "..." : "");
-
-                int err = DoString(L, localCmd, "=shmem");
-                if (err == 0) {
-                    // Capture return value (DoString now requests 1 result)
-                    const char* retVal = fn_tostring(L, -1);
-                    if (retVal && retVal[0]) {
-                        snprintf(g_cmdBuf->result, 4095, "%s", retVal);
-                    } else {
-                        strncpy(g_cmdBuf->result, "OK", 4095);
-                    }
-                    g_cmdBuf->result_len = (uint32_t)strlen(g_cmdBuf->result);
-                } else {
-                    const char* msg = fn_tostring(L, -1);
-                    snprintf(g_cmdBuf->result, 4095, "ERR: %s", msg ? msg : "unknown");
-                    g_cmdBuf->result_len = (uint32_t)strlen(g_cmdBuf->result);
-                }
-                fn_settop(L, savedTop);  // Restore stack regardless
+                g_cmdBuf->result_len = ExecuteShmemCommand(L, localCmd, g_cmdBuf->result, 4095);
                 g_cmdBuf->result_seq.store(seq, std::memory_order_release);
             }
     }
 
+    // Shared memory command ring v2 — `pending` is the doorbell
+    if (g_cmdRing && is_registered && g_cmdRing->pending.load(std::memory_order_acquire) != 0
+        && InterlockedCompareExchange(&g_ringDrainGuard, 1, 0) == 0) {
+        DrainSharedCmdRing(L);
+        InterlockedExchange(&g_ringDrainGuard, 0);
+    }
+
     // Call original luaD_call
     real_luaD_call(L, func, nResults);
 }
@@ -8574,6 +11834,7 @@ static lua_State* Hook_lua_open() {
 
     g_stateCount++;
     Log("[Bridge] lua_open called (#%d), state=%p\n", g_stateCount, L);
+    InvalidateTypeCache();
 
     if (!g_mainState) {
         g_mainState = L;
@@ -8582,137 +11843,34 @@ static lua_State* Hook_lua_open() {
 
     // Canonical registration — every SWFOC_* helper goes through RegisterAll.
     // Do NOT add any fn_pushcclosure calls here. If you need to add a new
-    // helper, add it to the funcs[] table inside RegisterAll and the drift
+    // helper, add it to the kHelpers[] table above RegisterAll and the drift
     // guard test in test_harness.cpp will keep everything consistent.
+    // With lazy registration on, the state gets only the SWFOC table now
+    // and the globals on its first drained command (EnsureFullRegistration).
     if (fn_pushstring && fn_pushcclosure && fn_settable) {
-        Log("[Bridge] Attempting canonical RegisterAll on state #%d...\n", g_stateCount);
-        RegisterAll(L);
+        if (g_lazyRegistration && fn_setmetatable && fn_rawset) {
+            RegisterLazy(L);
+        } else {
+            Log("[Bridge] Attempting canonical RegisterAll on state #%d...\n", g_stateCount);
+            RegisterAll(L);
+            EnterCriticalSection(&csRegistered);
+            StateSetInsert(&g_fullRegisteredSet, L);
+            LeaveCriticalSection(&csRegistered);
+        }
 
         // Track this state as registered for pipe/shmem drain in luaD_call
         EnterCriticalSection(&csRegistered);
-        if (std::find(registered_states.begin(), registered_states.end(), (void*)L) == registered_states.end()) {
-            registered_states.push_back((void*)L);
-            Log("[Bridge] Registered state %p for command drain (total: %d)\n", L, (int)registered_states.size());
+        if (StateRegistryInsert(&registered_states, L)) {
+            if (!StateSetContains(&registered_states.set, L))
+                Log("[Bridge] Registered-state set full; luaD_call falls back to the locked lookup\n");
+            Log("[Bridge] Registered state %p for command drain (total: %d)\n", L, (int)registered_states.states.size());
         }
         LeaveCriticalSection(&csRegistered);
 
         // === COMPREHENSIVE SELF-TEST SUITE ===
-        // Test every Lua API function we use. If any crash, SEH catches it.
-
-        // Test 1: pushnumber + settop (pop)
-        fn_pushnumber(L, 42.0);
-        fn_settop(L, -2);
-        Log("[Test] pushnumber + pop: PASSED\n");
-
-        // Test 2: tonumber
-        fn_pushstring(L, "12345");
-        double tv = fn_tonumber(L, -1);
-        fn_settop(L, -2);
-        Log("[Test] tonumber: %.0f %s\n", tv, tv == 12345.0 ? "PASSED" : "FAILED");
-
-        // Test 3: newtable + settable (create a table, add a field)
-        fn_newtable(L);              // push {}
-        fn_pushstring(L, "key");     // push "key"
-        fn_pushnumber(L, 99.0);      // push 99
-        fn_settable(L, -3);          // t["key"] = 99
-        fn_settop(L, -2);            // pop table
-        Log("[Test] newtable + settable: PASSED\n");
-
-        // Test 4: rawseti (create array-like table)
-        fn_newtable(L);              // push {}
-        fn_pushstring(L, "hello");   // push "hello"
-        fn_rawseti(L, -2, 1);        // t[1] = "hello"
-        fn_settop(L, -2);            // pop table
-        Log("[Test] rawseti: PASSED\n");
-
-        // Test 5: type check
-        fn_pushstring(L, "test");
-        int ty = fn_type(L, -1);
-        fn_settop(L, -2);
-        Log("[Test] type(string) = %d %s\n", ty, ty == LUA_TSTRING ? "PASSED" : "FAILED");
-
-        fn_pushnumber(L, 1.0);
-        ty = fn_type(L, -1);
-        fn_settop(L, -2);
-        Log("[Test] type(number) = %d %s\n", ty, ty == LUA_TNUMBER ? "PASSED" : "FAILED");
-
-        // Test 6: tostring (0x7B9CC0 = lua_tolstring — Ghidra confirmed)
-        fn_pushstring(L, "readback");
-        const char* rb = fn_tostring(L, -1);
-        int rbOk = rb && strcmp(rb, "readback") == 0;
-        fn_settop(L, -2);
-        Log("[Test] tostring readback: %s %s\n", rb ? rb : "null", rbOk ? "PASSED" : "FAILED");
-
-        // Test 7: gettable (0x7B8E90 = lua_gettable — Ghidra confirmed)
-        fn_pushstring(L, "_SWFOC_TEST");
-        fn_pushnumber(L, 777.0);
-        fn_settable(L, LUA_GLOBALSINDEX);
-        fn_pushstring(L, "_SWFOC_TEST");
-        fn_gettable(L, LUA_GLOBALSINDEX);
-        double gv = fn_tonumber(L, -1);
-        fn_settop(L, -2);
-        Log("[Test] global set+get: %.0f %s\n", gv, gv == 777.0 ? "PASSED" : "FAILED");
-
-        // Test 8: pcall (0x7B9280 — Ghidra confirmed)
-        fn_pushstring(L, "SWFOC_GetVersion");
-        fn_gettable(L, LUA_GLOBALSINDEX);
-        ty = fn_type(L, -1);
-        if (ty == LUA_TFUNCTION) {
-            int pcResult = fn_pcall(L, 0, 1, 0);
-            if (pcResult == 0) {
-                const char* ver = fn_tostring(L, -1);
-                fn_settop(L, -2);
-                Log("[Test] pcall SWFOC_GetVersion: '%s' PASSED\n", ver ? ver : "null");
-            } else {
-                const char* err = fn_tostring(L, -1);
-                fn_settop(L, -2);
-                Log("[Test] pcall SWFOC_GetVersion: error=%s FAILED\n", err ? err : "null");
-            }
-        } else {
-            fn_settop(L, -2);
-            Log("[Test] pcall: function not found (type=%d) — OK for early states\n", ty);
-        }
-
-        // Test 9: pushboolean + pushnil + gettop
-        fn_pushboolean(L, 1);
-        ty = fn_type(L, -1);
-        fn_settop(L, -2);
-        Log("[Test] pushboolean: type=%d %s\n", ty, ty == LUA_TBOOLEAN ? "PASSED" : "FAILED");
-
-        fn_pushnil(L);
-        ty = fn_type(L, -1);
-        fn_settop(L, -2);
-        Log("[Test] pushnil: type=%d %s\n", ty, ty == LUA_TNIL ? "PASSED" : "FAILED");
-
-        int top_before = fn_gettop(L);
-        fn_pushnumber(L, 1.0);
-        int top_after = fn_gettop(L);
-        fn_settop(L, -2);
-        Log("[Test] gettop: before=%d after=%d %s\n", top_before, top_after,
-            (top_after == top_before + 1) ? "PASSED" : "FAILED");
-
-        // Test 10: PlayerArray access (memory read, no Lua)
-        auto pa = *reinterpret_cast<uintptr_t*>(g_base + RVA::PlayerArray_Global);
-        auto pc = *reinterpret_cast<int*>(g_base + RVA::PlayerCount_Global);
-        int localSlot = FindLocalPlayerSlot();
-        Log("[Test] PlayerArray=0x%p count=%d localSlot=%d %s\n",
-            (void*)pa, pc, localSlot,
-            (pa != 0 && pc > 0) ? "PASSED" : "FAILED (may be OK in menu)");
-
-        if (localSlot >= 0) {
-            Log("[Test] Local player: slot %d, faction '%s'\n",
-                localSlot, GetFactionName(localSlot));
-        }
-
-        Log("[Test] === ALL SELF-TESTS COMPLETE ===\n");
-
-        // Test 11: DoString (lua_load + pcall)
-        if (fn_load) {
-            int dsErr = DoString(L, "-- bridge dostring self-test", "=selftest");
-            Log("[Test] DoString (no-op): %s\n", dsErr == 0 ? "PASSED" : "FAILED");
-        } else {
-            Log("[Test] DoString: SKIPPED (fn_load not resolved)\n");
-        }
+        // Once per session: the first registered state runs it and the
+        // verdict is cached for SWFOC_DiagSelfTest (see LuaApiSelfTestDue).
+        if (LuaApiSelfTestDue()) RunLuaApiSelfTest(L);
     } else {
         Log("[Bridge] ERROR: Core Lua API functions not resolved, skipping registration\n");
     }
@@ -8726,10 +11884,8 @@ static lua_State* Hook_lua_open() {
         fn_gettable(L, LUA_GLOBALSINDEX);
         if (fn_type(L, -1) == LUA_TFUNCTION) {
             EnterCriticalSection(&csGameStates);
-            if (std::find(cached_game_states.begin(), cached_game_states.end(), (void*)L) == cached_game_states.end()) {
-                cached_game_states.push_back((void*)L);
-                Log("Cached game state: %p (total: %d)\n", L, (int)cached_game_states.size());
-            }
+            if (StateRegistryInsert(&cached_game_states, L))
+                Log("Cached game state: %p (total: %d)\n", L, (int)cached_game_states.states.size());
             LeaveCriticalSection(&csGameStates);
         }
         fn_settop(L, top); // restore stack
@@ -8739,11 +11895,15 @@ static lua_State* Hook_lua_open() {
     DrainPipeCommand(L);
 
     // Install the focus-drain timer exactly once, on the main thread.
-    // After this call, pipe commands drain every 100ms via WM_TIMER,
-    // even when the game is unfocused/paused and luaD_call stops firing.
+    // After this call, pipe commands drain on the next message pump
+    // (WM_SWFOC_DRAIN) or at worst every 100ms via WM_TIMER, even when the
+    // game is unfocused/paused and luaD_call stops firing.
     // See the "Focus-loss drain fallback" comment block for rationale.
     InstallFocusDrainTimer();
 
+    // dbghelp for crash minidumps, now that we are outside the loader lock.
+    LoadCrashDumper();
+
     return L;
 }
 
@@ -8752,9 +11912,15 @@ static lua_State* Hook_lua_open() {
 // ======================================================================
 // Crash Dump Analyzer — unhandled exception filter
 // ======================================================================
-// SAFETY: No Lua calls, no heap allocation, stack buffers only.
+// SAFETY: No Lua calls, no heap allocation, stack or static buffers only.
+//
+// 2026-10-14: knownFuncs is copied into g_crashSymbols and sorted once at
+// init, so each address lookup is a binary search (crash_trail.h). The report
+// now also lists the detours the crashing thread was inside and the last
+// CRASH_TRAIL_SLOTS commands, and a minidump is written next to it unless
+// SWFOC_SetCrashDump("off") turned that off.
 
-struct FuncEntry { uintptr_t rva; const char* name; };
+typedef CrashSymbol FuncEntry;
 
 static const FuncEntry knownFuncs[] = {
     // Lua 5.0.2 C API — state management
@@ -8861,19 +12027,83 @@ static const FuncEntry knownFuncs[] = {
 };
 
 static const int knownFuncsCount = sizeof(knownFuncs) / sizeof(knownFuncs[0]);
+static FuncEntry g_crashSymbols[knownFuncsCount];
+
+static void InitCrashSymbols() {
+    memcpy(g_crashSymbols, knownFuncs, sizeof(knownFuncs));
+    CrashSymbolSort(g_crashSymbols, knownFuncsCount);
+}
 
 // Find the nearest known function at or below the given RVA.
 // Returns nullptr if no function is at or below the address.
 static const FuncEntry* FindNearestFunc(uintptr_t rva) {
-    const FuncEntry* best = nullptr;
-    for (int i = 0; i < knownFuncsCount; i++) {
-        if (knownFuncs[i].rva <= rva) {
-            if (!best || knownFuncs[i].rva > best->rva) {
-                best = &knownFuncs[i];
-            }
-        }
+    return CrashSymbolFind(g_crashSymbols, knownFuncsCount, rva);
+}
+
+// Minidump flavour written next to the text report.
+enum CrashDumpMode : LONG {
+    CRASH_DUMP_OFF  = 0,
+    CRASH_DUMP_MINI = 1,  // threads, stacks and the memory they point at
+    CRASH_DUMP_FULL = 2,  // the whole address space (hundreds of MB)
+};
+static volatile LONG g_crashDumpMode = CRASH_DUMP_MINI;
+
+typedef BOOL (WINAPI *pfn_MiniDumpWriteDump)(HANDLE, DWORD, HANDLE, MINIDUMP_TYPE,
+                                             PMINIDUMP_EXCEPTION_INFORMATION,
+                                             PMINIDUMP_USER_STREAM_INFORMATION,
+                                             PMINIDUMP_CALLBACK_INFORMATION);
+static pfn_MiniDumpWriteDump g_miniDumpWriteDump = nullptr;
+
+// Loads dbghelp outside the loader lock (called from Hook_lua_open); the
+// crash handler only retries the load if this never ran.
+static void LoadCrashDumper() {
+    if (g_miniDumpWriteDump) return;
+    HMODULE dbghelp = LoadLibraryA("dbghelp.dll");
+    if (dbghelp) {
+        g_miniDumpWriteDump = reinterpret_cast<pfn_MiniDumpWriteDump>(
+            reinterpret_cast<void*>(GetProcAddress(dbghelp, "MiniDumpWriteDump")));
+    }
+}
+
+// Writes crash_<time>.dmp; returns false when off or it could not be written.
+static bool WriteCrashMinidump(EXCEPTION_POINTERS* ep, const char* path) {
+    const LONG mode = g_crashDumpMode;
+    if (mode == CRASH_DUMP_OFF) return false;
+    if (!g_miniDumpWriteDump) LoadCrashDumper();
+    if (!g_miniDumpWriteDump) return false;
+    HANDLE hDump = CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hDump == INVALID_HANDLE_VALUE) return false;
+    MINIDUMP_EXCEPTION_INFORMATION info;
+    info.ThreadId          = GetCurrentThreadId();
+    info.ExceptionPointers = ep;
+    info.ClientPointers    = FALSE;
+    const MINIDUMP_TYPE type = mode == CRASH_DUMP_FULL
+        ? static_cast<MINIDUMP_TYPE>(MiniDumpWithFullMemory | MiniDumpWithHandleData | MiniDumpWithThreadInfo)
+        : static_cast<MINIDUMP_TYPE>(MiniDumpWithIndirectlyReferencedMemory | MiniDumpWithThreadInfo |
+                                     MiniDumpScanMemory);
+    const BOOL ok = g_miniDumpWriteDump(GetCurrentProcess(), GetCurrentProcessId(), hDump, type, &info,
+                                        nullptr, nullptr);
+    CloseHandle(hDump);
+    return ok != FALSE;
+}
+
+// SWFOC_SetCrashDump("off"|"mini"|"full") -> "OK: crash dump <mode>".
+static int Lua_SetCrashDump(lua_State* L) {
+    const char* mode = fn_tostring(L, 1);
+    LONG value;
+    if (mode && strcmp(mode, "off") == 0) value = CRASH_DUMP_OFF;
+    else if (mode && strcmp(mode, "mini") == 0) value = CRASH_DUMP_MINI;
+    else if (mode && strcmp(mode, "full") == 0) value = CRASH_DUMP_FULL;
+    else {
+        fn_pushstring(L, "ERR: SWFOC_SetCrashDump: mode must be 'off', 'mini' or 'full'");
+        return 1;
     }
-    return best;
+    InterlockedExchange(&g_crashDumpMode, value);
+    Log("[Bridge] SetCrashDump(%s)\n", mode);
+    char msg[64];
+    _snprintf_s(msg, sizeof(msg), _TRUNCATE, "OK: crash dump %s", mode);
+    fn_pushstring(L, msg);
+    return 1;
 }
 
 // Format a single address as "RVA 0xXXXXXX — FuncName (+0xNN)" or "RVA 0xXXXXXX (unknown)"
@@ -8923,6 +12153,10 @@ static LONG WINAPI CrashHandler(EXCEPTION_POINTERS* ep) {
     EXCEPTION_RECORD* rec = ep->ExceptionRecord;
     uintptr_t base = g_base;
 
+    // Lines still queued for the writer thread are the last thing before
+    // the crash; put them in swfoc_bridge.log first.
+    LogFlush();
+
     // Build timestamp string (stack buffer)
     SYSTEMTIME st;
     GetLocalTime(&st);
@@ -8945,8 +12179,9 @@ static LONG WINAPI CrashHandler(EXCEPTION_POINTERS* ep) {
                             CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
     }
 
-    // Large stack buffer for formatting the report
-    char report[8192];
+    // Report buffer is static, not on the stack: the crash may be a stack
+    // overflow. One crash is handled at a time.
+    static char report[16384];
     int pos = 0;
     int rem = sizeof(report) - 1;
 
@@ -9024,6 +12259,25 @@ static LONG WINAPI CrashHandler(EXCEPTION_POINTERS* ep) {
         if (n > 0) { pos += n; rem -= n; }
     }
 
+    // Detours this thread was inside and the recent command trail; ticks are
+    // TSC, converted with the init-time calibration.
+    const int64_t qpcElapsed = PipeQpcNow() - g_hookCostQpc0;
+    const uint64_t tscNow = __rdtsc();
+    const int64_t tscFreq = (qpcElapsed > 0 && g_qpcFreq.QuadPart > 0)
+        ? (int64_t)((double)(tscNow - g_hookCostTsc0) * (double)g_qpcFreq.QuadPart / (double)qpcElapsed)
+        : 0;
+    CrashAppend(report, (int)sizeof(report), &pos, "\r\n");
+    CrashFormatTrail(report, (int)sizeof(report), &pos, &t_crashCrumbs, &g_crashTrail, (int64_t)tscNow,
+                     tscFreq, [](uint32_t hook) { return HookCostName(hook); });
+
+    // Minidump next to the report.
+    char dumpPath[MAX_PATH];
+    _snprintf(dumpPath, sizeof(dumpPath), "%s\\crash_%s.dmp", g_crashDir, timeStr);
+    dumpPath[sizeof(dumpPath) - 1] = '\0';
+    const bool dumped = WriteCrashMinidump(ep, dumpPath);
+    CrashAppend(report, (int)sizeof(report), &pos, "\r\nMinidump: %s\r\n",
+                dumped ? dumpPath : (g_crashDumpMode == CRASH_DUMP_OFF ? "off" : "not written"));
+
     report[pos] = '\0';
 
     // Write to file
@@ -9039,9 +12293,9 @@ static LONG WINAPI CrashHandler(EXCEPTION_POINTERS* ep) {
         "SWFOC Bridge Crash!\n\n"
         "Exception: 0x%08lX (%s)\n"
         "Crash at: %s\n\n"
-        "Full report saved to:\n%s",
+        "Full report saved to:\n%s%s%s",
         rec->ExceptionCode, ExceptionCodeName(rec->ExceptionCode),
-        addrBuf, filePath);
+        addrBuf, filePath, dumped ? "\n\nMinidump:\n" : "", dumped ? dumpPath : "");
     msgBuf[sizeof(msgBuf) - 1] = '\0';
 
     MessageBoxA(nullptr, msgBuf, "SWFOC Bridge - Crash Report", MB_OK | MB_ICONERROR);
@@ -9055,10 +12309,154 @@ static LONG WINAPI CrashHandler(EXCEPTION_POINTERS* ep) {
 
 extern bool Proxy_Init();
 extern void Proxy_Shutdown();
+extern int  Proxy_ExportStatus(char* buf, size_t cap);
+
+// Background init phase: everything the first lua_open does not need.
+// Runs on its own thread once the loader lock is released, while the game
+// continues to its menu.
+static HANDLE g_initThread = nullptr;
+
+static void BridgeInitBackground() {
+    const int64_t t0 = PipeQpcNow();
+
+    // Create crash_reports/ (path set by the critical phase)
+    if (CreateDirectoryA(g_crashDir, nullptr) || GetLastError() == ERROR_ALREADY_EXISTS) {
+        InterlockedOr(&g_initReady, BRIDGE_INIT_CRASH_DIR);
+        Log("[Bridge] Crash report dir: %s\n", g_crashDir);
+    } else {
+        Log("[Bridge] WARNING: crash report dir %s unavailable: %lu\n", g_crashDir, GetLastError());
+    }
+
+    InitEventSharedMemory();
+    if (g_evtBuf) InterlockedOr(&g_initReady, BRIDGE_INIT_EVENT_SHM);
+
+    // Event stream hooks (written to shared memory ring buffer)
+    // Only installed if event buffer was created successfully
+    LONG combat = 0;
+    if (g_evtBuf) {
+        void* tdoTarget = reinterpret_cast<void*>(g_base + RVA::Take_Damage_Outer);
+        if (MH_CreateHook(tdoTarget, (void*)&Hook_TakeDamageOuter, (void**)&real_TakeDamageOuter) == MH_OK
+            && MH_EnableHook(tdoTarget) == MH_OK) {
+            Log("[Bridge] Take_Damage_Outer hooked at 0x%p (event stream)\n", tdoTarget);
+            combat++;
+        } else {
+            Log("[Bridge] WARNING: Take_Damage_Outer hook failed\n");
+        }
+
+        void* dhTarget = reinterpret_cast<void*>(g_base + RVA::DeathHandler);
+        if (MH_CreateHook(dhTarget, (void*)&Hook_DeathHandler, (void**)&real_DeathHandler) == MH_OK
+            && MH_EnableHook(dhTarget) == MH_OK) {
+            Log("[Bridge] DeathHandler hooked at 0x%p (event stream)\n", dhTarget);
+            combat++;
+        } else {
+            Log("[Bridge] WARNING: DeathHandler hook failed\n");
+        }
+    } else {
+        Log("[Bridge] Event buffer unavailable, skipping combat event hooks\n");
+    }
+
+    // 2026-05-06 (iter 225): WeaponTick detour for SetFireRate global LIVE wire.
+    // Installs unconditionally (not gated on g_evtBuf — fire-rate scaling
+    // is a separate concern from event stream). Pattern matches iter-96
+    // Take_Damage_Outer detour. iter-224 RE doc + iter-225 implementation
+    // close A1.3 after 124-day deferral.
+    {
+        void* wtTarget = reinterpret_cast<void*>(g_base + RVA::Weapon_Tick);
+        if (MH_CreateHook(wtTarget, (void*)&Hook_WeaponTick, (void**)&real_WeaponTick) == MH_OK
+            && MH_EnableHook(wtTarget) == MH_OK) {
+            Log("[Bridge] WeaponTick hooked at 0x%p (SetFireRate global LIVE)\n", wtTarget);
+            combat++;
+        } else {
+            Log("[Bridge] WARNING: WeaponTick hook failed (SetFireRate global won't apply)\n");
+        }
+    }
+
+    if (combat == (g_evtBuf ? 3 : 1)) InterlockedOr(&g_initReady, BRIDGE_INIT_COMBAT);
+
+    // 2026-05-06 (iter 230-231): AddCredits detour for FreezeCredits + CreditsMultiplier
+    // global LIVE wires. Pattern matches iter-96 + iter-225. AddCredits is the
+    // universal engine credit-adjust function (47 callers, gains AND spends route
+    // through it). Single MinHook detour covers economy-wide control. iter-230
+    // RE design + iter-231 implementation close A1.x FreezeCredits.
+    {
+        void* acTarget = reinterpret_cast<void*>(g_base + RVA::AddCredits);
+        if (MH_CreateHook(acTarget, (void*)&Hook_AddCredits, (void**)&real_AddCredits) == MH_OK
+            && MH_EnableHook(acTarget) == MH_OK) {
+            Log("[Bridge] AddCredits hooked at 0x%p (FreezeCredits + CreditsMultiplier global LIVE)\n", acTarget);
+            InterlockedOr(&g_initReady, BRIDGE_INIT_ECONOMY);
+        } else {
+            Log("[Bridge] WARNING: AddCredits hook failed (Freeze/Mult won't apply)\n");
+        }
+    }
+
+    // 2026-05-07 (iter 450 scaffolding): VictoryMonitor counter_inc DORMANT
+    // detour for SWFOC_TriggerVictory. MH_CreateHook installs the trampoline
+    // so iter-450a can flip MH_EnableHook on after RE'ing AwaitingVictoryTest
+    // struct layout + capture-on-CTOR discriminator. The trampoline never
+    // runs in iter-450 (MH_EnableHook is intentionally skipped) -- cost is
+    // exactly one trampoline allocation at module load.
+    // See knowledge-base/iter449_breakthrough_disambiguation_parent_tick_inlines.md.
+    {
+        void* vmcTarget = reinterpret_cast<void*>(g_base + RVA::VictoryMonitor_CounterInc);
+        if (MH_CreateHook(vmcTarget, (void*)&Hook_VictoryMonitorCounter,
+                          (void**)&real_VictoryMonitorCounter) == MH_OK) {
+            // INTENTIONALLY NOT calling MH_EnableHook here -- iter-450 ships
+            // scaffolding only. iter-450a flips this on after struct + capture
+            // hook land. Operator-visible: SWFOC_TriggerVictory currently
+            // returns PHASE2_PENDING with the validated type staged.
+            Log("[Bridge] VictoryMonitor counter_inc hook CREATED but DORMANT "
+                "at 0x%p (iter-450 scaffolding; iter-450a will enable)\n", vmcTarget);
+            InterlockedOr(&g_initReady, BRIDGE_INIT_VICTORY);
+        } else {
+            Log("[Bridge] WARNING: VictoryMonitor counter_inc hook creation failed "
+                "(iter-450a will need to retry CreateHook + RE the missing pieces)\n");
+        }
+    }
+
+    // Start named pipe listener threads. The queue, the QPC frequency and
+    // the shutdown event were set up by the critical phase.
+    int pipeThreads = 0;
+    for (int i = 0; i < PIPE_INSTANCE_COUNT && g_pipeShutdownEvent; i++) {
+        g_pipeThreads[i] = CreateThread(nullptr, 0, PipeInstanceThreadProc, (LPVOID)(intptr_t)i, 0, nullptr);
+        if (g_pipeThreads[i]) pipeThreads++;
+    }
+    if (pipeThreads > 0) {
+        Log("[Bridge] Pipe listener started (%d/%d instances)\n", pipeThreads, PIPE_INSTANCE_COUNT);
+        InterlockedOr(&g_initReady, BRIDGE_INIT_PIPE);
+
+        // Announce the pipe in the instance registry for test-farm discovery.
+        InstanceRecord rec;
+        rec.kind = "bridge";
+        rec.pid = GetCurrentProcessId();
+        rec.tag = g_instanceTag;
+        rec.pipe = g_pipeName;
+        rec.started = (int64_t)time(nullptr);
+        char exe[MAX_PATH];
+        GetModuleFileNameA(nullptr, exe, MAX_PATH);
+        rec.source = exe;
+        g_instanceRecordPath = InstanceRegistryAdd(rec);
+        if (g_instanceRecordPath.empty()) Log("[Bridge] WARNING: instance registry record not written\n");
+    } else {
+        Log("[Bridge] WARNING: Pipe listener threads failed to start: %lu\n", GetLastError());
+    }
+
+    StartModWatch();
+
+    InterlockedExchange(&g_initBackgroundUs, (LONG)((PipeQpcNow() - t0) * 1000000 / g_qpcFreq.QuadPart));
+    InterlockedOr(&g_initReady, BRIDGE_INIT_DONE);
+    Log("[Bridge] Background init done in %ld us (ready=0x%02lX)\n", (long)g_initBackgroundUs, (long)g_initReady);
+}
+
+static DWORD WINAPI BridgeInitBackgroundProc(LPVOID) {
+    BridgeInitBackground();
+    return 0;
+}
 
 bool LuaBridge_Init() {
     g_base = reinterpret_cast<uintptr_t>(GetModuleHandleA(nullptr));
     if (!g_base) return false;
+    QueryPerformanceFrequency(&g_qpcFreq);
+    const int64_t initT0 = PipeQpcNow();
 
     // Open log
     char logPath[MAX_PATH];
@@ -9067,10 +12465,16 @@ bool LuaBridge_Init() {
     if (slash) strcpy(slash + 1, "swfoc_bridge.log");
     else strcpy(logPath, "swfoc_bridge.log");
     g_log = fopen(logPath, "w");
+    LogStartWriter();
 
     Log("[Bridge] %s\n", SWFOC_BRIDGE_VERSION);
     Log("[Bridge] Built: %s %s\n", __DATE__, __TIME__);
     Log("[Bridge] Base: 0x%p\n", (void*)g_base);
+    {
+        char proxyStatus[256];
+        const int resolved = Proxy_ExportStatus(proxyStatus, sizeof(proxyStatus));
+        Log("[Bridge] %s%s\n", proxyStatus, resolved < 6 ? " (missing exports return their fallback code)" : "");
+    }
 
     // Verify process
     char exe[MAX_PATH];
@@ -9080,20 +12484,21 @@ bool LuaBridge_Init() {
         return false;
     }
 
-    // Create crash_reports/ directory next to the exe
+    // crash_reports/ next to the exe. Only the path here; the background
+    // phase creates the directory (CrashHandler falls back to the exe dir).
     {
         char dirPath[MAX_PATH];
         GetModuleFileNameA(nullptr, dirPath, MAX_PATH);
         char* dirSlash = strrchr(dirPath, '\\');
         if (dirSlash) strcpy(dirSlash + 1, "crash_reports");
         else strcpy(dirPath, "crash_reports");
-        CreateDirectoryA(dirPath, nullptr); // OK if already exists
         strncpy(g_crashDir, dirPath, MAX_PATH - 1);
         g_crashDir[MAX_PATH - 1] = '\0';
-        Log("[Bridge] Crash report dir: %s\n", g_crashDir);
     }
 
     // Install unhandled exception filter (crash dump analyzer)
+    InitCrashSymbols();
+    CrashTrailInit(&g_crashTrail);
     SetUnhandledExceptionFilter(CrashHandler);
     Log("[Bridge] Crash handler installed\n");
 
@@ -9114,6 +12519,11 @@ bool LuaBridge_Init() {
     fn_gettop       = Resolve<pfn_lua_gettop>(RVA::lua_gettop);
     fn_pcall        = Resolve<pfn_lua_pcall>(RVA::lua_pcall);         // 0x7B9280 — safe calls!
     fn_load         = Resolve<pfn_lua_load>(RVA::lua_load);          // 0x7B90F0 — parser/compiler
+    fn_pushvalue    = Resolve<pfn_lua_pushvalue>(RVA::lua_pushvalue);
+    fn_remove       = Resolve<pfn_lua_remove>(RVA::lua_remove);
+    fn_touserdata   = Resolve<pfn_lua_touserdata>(RVA::lua_touserdata);
+    fn_rawset       = Resolve<pfn_lua_rawset>(RVA::lua_rawset);
+    fn_setmetatable = Resolve<pfn_lua_setmetatable>(RVA::lua_setmetatable);
 
     Log("[Bridge] All Lua API RVAs resolved (Ghidra-verified):\n");
     Log("[Bridge]   settop=0x%X gettable=0x%X tostring=0x%X pcall=0x%X\n",
@@ -9124,6 +12534,16 @@ bool LuaBridge_Init() {
     // Initialize game state cache critical section (before any hooks fire)
     InitializeCriticalSection(&csGameStates);
     InitializeCriticalSection(&csRegistered);
+    StateRegistryReset(&cached_game_states);
+    StateRegistryReset(&registered_states);
+    StateSetReset(&g_fullRegisteredSet);
+    DamageRingSetInit(&g_damageRings);
+    HookCostInit(&g_hookCost);
+    PendingJournalInit(&g_pendingJournal);
+    SlotModInit(&g_slotMods);
+    PendingStateInit(&g_pendingState);
+    g_hookCostTsc0 = __rdtsc();
+    g_hookCostQpc0 = PipeQpcNow();
 
     // Hook lua_open
     if (MH_Initialize() != MH_OK) {
@@ -9165,132 +12585,91 @@ bool LuaBridge_Init() {
     }
 
     // Initialize shared memory command buffer (before pipe thread)
+    BridgeResolveInstance();
     if (!InitSharedMemory()) {
         Log("[Bridge] WARNING: Shared memory init failed (CE communication unavailable)\n");
     }
 
-    // Event stream hooks (written to shared memory ring buffer)
-    // Only installed if event buffer was created successfully
-    if (g_evtBuf) {
-        void* tdoTarget = reinterpret_cast<void*>(g_base + RVA::Take_Damage_Outer);
-        if (MH_CreateHook(tdoTarget, (void*)&Hook_TakeDamageOuter, (void**)&real_TakeDamageOuter) == MH_OK
-            && MH_EnableHook(tdoTarget) == MH_OK) {
-            Log("[Bridge] Take_Damage_Outer hooked at 0x%p (event stream)\n", tdoTarget);
-        } else {
-            Log("[Bridge] WARNING: Take_Damage_Outer hook failed\n");
-        }
-
-        void* dhTarget = reinterpret_cast<void*>(g_base + RVA::DeathHandler);
-        if (MH_CreateHook(dhTarget, (void*)&Hook_DeathHandler, (void**)&real_DeathHandler) == MH_OK
-            && MH_EnableHook(dhTarget) == MH_OK) {
-            Log("[Bridge] DeathHandler hooked at 0x%p (event stream)\n", dhTarget);
-        } else {
-            Log("[Bridge] WARNING: DeathHandler hook failed\n");
-        }
-    } else {
-        Log("[Bridge] Event buffer unavailable, skipping combat event hooks\n");
-    }
-
-    // 2026-05-06 (iter 225): WeaponTick detour for SetFireRate global LIVE wire.
-    // Installs unconditionally (not gated on g_evtBuf — fire-rate scaling
-    // is a separate concern from event stream). Pattern matches iter-96
-    // Take_Damage_Outer detour. iter-224 RE doc + iter-225 implementation
-    // close A1.3 after 124-day deferral.
-    {
-        void* wtTarget = reinterpret_cast<void*>(g_base + RVA::Weapon_Tick);
-        if (MH_CreateHook(wtTarget, (void*)&Hook_WeaponTick, (void**)&real_WeaponTick) == MH_OK
-            && MH_EnableHook(wtTarget) == MH_OK) {
-            Log("[Bridge] WeaponTick hooked at 0x%p (SetFireRate global LIVE)\n", wtTarget);
-        } else {
-            Log("[Bridge] WARNING: WeaponTick hook failed (SetFireRate global won't apply)\n");
-        }
-    }
-
-    // 2026-05-06 (iter 230-231): AddCredits detour for FreezeCredits + CreditsMultiplier
-    // global LIVE wires. Pattern matches iter-96 + iter-225. AddCredits is the
-    // universal engine credit-adjust function (47 callers, gains AND spends route
-    // through it). Single MinHook detour covers economy-wide control. iter-230
-    // RE design + iter-231 implementation close A1.x FreezeCredits.
-    {
-        void* acTarget = reinterpret_cast<void*>(g_base + RVA::AddCredits);
-        if (MH_CreateHook(acTarget, (void*)&Hook_AddCredits, (void**)&real_AddCredits) == MH_OK
-            && MH_EnableHook(acTarget) == MH_OK) {
-            Log("[Bridge] AddCredits hooked at 0x%p (FreezeCredits + CreditsMultiplier global LIVE)\n", acTarget);
-        } else {
-            Log("[Bridge] WARNING: AddCredits hook failed (Freeze/Mult won't apply)\n");
-        }
-    }
+    PipeQueueInit(&g_pipeQueue);
+    g_pipeShutdown = false;
+    g_pipeShutdownEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
 
-    // 2026-05-07 (iter 450 scaffolding): VictoryMonitor counter_inc DORMANT
-    // detour for SWFOC_TriggerVictory. MH_CreateHook installs the trampoline
-    // so iter-450a can flip MH_EnableHook on after RE'ing AwaitingVictoryTest
-    // struct layout + capture-on-CTOR discriminator. The trampoline never
-    // runs in iter-450 (MH_EnableHook is intentionally skipped) -- cost is
-    // exactly one trampoline allocation at module load.
-    // See knowledge-base/iter449_breakthrough_disambiguation_parent_tick_inlines.md.
-    {
-        void* vmcTarget = reinterpret_cast<void*>(g_base + RVA::VictoryMonitor_CounterInc);
-        if (MH_CreateHook(vmcTarget, (void*)&Hook_VictoryMonitorCounter,
-                          (void**)&real_VictoryMonitorCounter) == MH_OK) {
-            // INTENTIONALLY NOT calling MH_EnableHook here -- iter-450 ships
-            // scaffolding only. iter-450a flips this on after struct + capture
-            // hook land. Operator-visible: SWFOC_TriggerVictory currently
-            // returns PHASE2_PENDING with the validated type staged.
-            Log("[Bridge] VictoryMonitor counter_inc hook CREATED but DORMANT "
-                "at 0x%p (iter-450 scaffolding; iter-450a will enable)\n", vmcTarget);
-        } else {
-            Log("[Bridge] WARNING: VictoryMonitor counter_inc hook creation failed "
-                "(iter-450a will need to retry CreateHook + RE the missing pieces)\n");
-        }
-    }
+    InterlockedExchange(&g_initCoreUs, (LONG)((PipeQpcNow() - initT0) * 1000000 / g_qpcFreq.QuadPart));
+    InterlockedOr(&g_initReady, BRIDGE_INIT_CORE);
+    Log("[Bridge] Critical init done in %ld us\n", (long)g_initCoreUs);
 
-    // Start named pipe listener thread
-    InitializeCriticalSection(&g_pipeLock);
-    g_pipeShutdown = false;
-    g_pipeThread = CreateThread(nullptr, 0, PipeThreadProc, nullptr, 0, nullptr);
-    if (g_pipeThread) {
-        Log("[Bridge] Pipe listener thread started\n");
-    } else {
-        Log("[Bridge] WARNING: Pipe listener thread failed to start: %lu\n", GetLastError());
+    // Everything else waits for the loader lock to drop: the thread starts
+    // running once DllMain returns. Inline if the thread cannot be created.
+    g_initThread = CreateThread(nullptr, 0, BridgeInitBackgroundProc, nullptr, 0, nullptr);
+    if (!g_initThread) {
+        Log("[Bridge] WARNING: background init thread failed (%lu), running it inline\n", GetLastError());
+        BridgeInitBackground();
     }
-
     Log("[Bridge] Ready. Lua functions will be injected when game creates Lua states.\n");
-    Log("[Bridge] Named pipe: %s\n", PIPE_NAME);
+    Log("[Bridge] Named pipe: %s\n", g_pipeName);
     return true;
 }
 
 void LuaBridge_Shutdown() {
-    // Stop pipe listener thread
+    // Let the background init phase finish installing before tearing down.
+    if (g_initThread) {
+        WaitForSingleObject(g_initThread, 2000);
+        CloseHandle(g_initThread);
+        g_initThread = nullptr;
+    }
+
+    // Stop pipe listener threads. The shutdown event wakes every instance
+    // out of its pending overlapped ConnectNamedPipe/ReadFile.
     g_pipeShutdown = true;
-    if (g_pipeThread) {
-        // Create a dummy connection to unblock ConnectNamedPipe
-        HANDLE hDummy = CreateFileA(PIPE_NAME, GENERIC_READ | GENERIC_WRITE,
-            0, nullptr, OPEN_EXISTING, 0, nullptr);
-        if (hDummy != INVALID_HANDLE_VALUE) CloseHandle(hDummy);
-        WaitForSingleObject(g_pipeThread, 2000);
-        CloseHandle(g_pipeThread);
-        g_pipeThread = nullptr;
-        Log("[Bridge] Pipe thread stopped\n");
-    }
-    DeleteCriticalSection(&g_pipeLock);
+    g_drainHwnd = nullptr;  // no more WM_SWFOC_DRAIN posts
+    if (g_pipeShutdownEvent) {
+        SetEvent(g_pipeShutdownEvent);
+        HANDLE live[PIPE_INSTANCE_COUNT];
+        DWORD liveCount = 0;
+        for (int i = 0; i < PIPE_INSTANCE_COUNT; i++) {
+            if (g_pipeThreads[i]) live[liveCount++] = g_pipeThreads[i];
+        }
+        if (liveCount > 0) WaitForMultipleObjects(liveCount, live, TRUE, 2000);
+        for (int i = 0; i < PIPE_INSTANCE_COUNT; i++) {
+            if (g_pipeThreads[i]) { CloseHandle(g_pipeThreads[i]); g_pipeThreads[i] = nullptr; }
+        }
+        CloseHandle(g_pipeShutdownEvent);
+        g_pipeShutdownEvent = nullptr;
+        Log("[Bridge] Pipe threads stopped\n");
+    }
+    StopModWatch();
+    StopTimeline();
+    InstanceRegistryRemove(g_instanceRecordPath);
+    g_instanceRecordPath.clear();
+    PipeQueueDestroy(&g_pipeQueue);
 
     // Clean up game state cache
     EnterCriticalSection(&csGameStates);
-    cached_game_states.clear();
+    StateRegistryReset(&cached_game_states);
     LeaveCriticalSection(&csGameStates);
     DeleteCriticalSection(&csGameStates);
 
     // Clean up registered states
     EnterCriticalSection(&csRegistered);
-    registered_states.clear();
+    StateRegistryReset(&registered_states);
+    StateSetReset(&g_fullRegisteredSet);
     LeaveCriticalSection(&csRegistered);
     DeleteCriticalSection(&csRegistered);
 
     // Clean up shared memory
     if (g_cmdBuf) { UnmapViewOfFile(g_cmdBuf); g_cmdBuf = nullptr; }
     if (g_hCmdMap) { CloseHandle(g_hCmdMap); g_hCmdMap = nullptr; }
+    if (g_cmdRing) { UnmapViewOfFile(g_cmdRing); g_cmdRing = nullptr; }
+    if (g_hRingMap) { CloseHandle(g_hRingMap); g_hRingMap = nullptr; }
+    for (int i = 0; i < SHMEM_RING_SLOTS; i++) {
+        if (g_ringDone[i]) { CloseHandle(g_ringDone[i]); g_ringDone[i] = nullptr; }
+    }
     if (g_evtBuf) { UnmapViewOfFile(g_evtBuf); g_evtBuf = nullptr; }
     if (g_hEvtMap) { CloseHandle(g_hEvtMap); g_hEvtMap = nullptr; }
+    if (g_unitTable) { UnmapViewOfFile(g_unitTable); g_unitTable = nullptr; }
+    if (g_hUnitsMap) { CloseHandle(g_hUnitsMap); g_hUnitsMap = nullptr; }
+    if (g_planetTable) { UnmapViewOfFile(g_planetTable); g_planetTable = nullptr; }
+    if (g_hPlanetsMap) { CloseHandle(g_hPlanetsMap); g_hPlanetsMap = nullptr; }
 
     // Tear down combat hook lock if it was initialized via SWFOC_GodMode/OHK
     if (g_combat_hook_lock_initialized) {
@@ -9301,6 +12680,7 @@ void LuaBridge_Shutdown() {
     MH_DisableHook(MH_ALL_HOOKS);
     MH_Uninitialize();
     Log("[Bridge] Shutdown\n");
+    LogStopWriter();
     if (g_log) { fclose(g_log); g_log = nullptr; }
     g_mainState = nullptr;
 }
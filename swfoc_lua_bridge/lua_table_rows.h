@@ -0,0 +1,103 @@
+#pragma once
+// lua_table_rows.h -- list replies as native Lua tables, for callers inside
+// the VM.
+//
+// The list helpers answer pipe clients in CSV (csv_row.h) or through the
+// shared tables (shared_memory.h). Story scripts and helper Lua calling
+// the same helpers paid twice: the bridge formatted a string, then Lua
+// 5.0's string library (no gmatch, no split) cut it up again. The *T
+// variants (SWFOC_ListTacticalUnitsT and friends) build the table instead:
+//
+//   { {obj_addr=..., owner_slot=..., ...}, {...}, ... }
+//
+// one record per row in an array from 1, or a flat array of numbers for
+// the id lists (LuaRowsNumber). Nothing is truncated; a Lua caller has no
+// 64 KB reply limit.
+//
+// Lua 5.0 has no lua_createtable, so tables still grow as they fill; what
+// this file saves is the field names. LuaRowsBegin pushes each name once,
+// above the result array, and every record copies it with lua_pushvalue
+// instead of lua_pushstring, which hashes and interns the name again.
+// LuaRowsEnd drops the names and leaves the array on top. Peak stack use
+// is the array, LUA_ROWS_MAX_KEYS names, a record, a key and a value,
+// inside the LUA_MINSTACK slots Lua guarantees a C function.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include "lua_types.h"
+
+#define LUA_ROWS_MAX_KEYS 12
+#define LUA_ROWS_MINSTACK 20  // LUA_MINSTACK in Lua 5.0.2
+
+static_assert(1 + LUA_ROWS_MAX_KEYS + 3 <= LUA_ROWS_MINSTACK, "row names must fit the C function stack");
+
+// The Lua API the builder calls; the bridge fills it from its resolved
+// fn_* pointers.
+struct LuaRowsApi {
+    pfn_lua_gettop     gettop;
+    pfn_lua_settop     settop;
+    pfn_lua_newtable   newtable;
+    pfn_lua_pushvalue  pushvalue;
+    pfn_lua_pushstring pushstring;
+    pfn_lua_pushnumber pushnumber;
+    pfn_lua_settable   settable;
+    pfn_lua_rawseti    rawseti;
+};
+
+inline bool LuaRowsApiReady(const LuaRowsApi& a) {
+    return a.gettop && a.settop && a.newtable && a.pushvalue && a.pushstring && a.pushnumber && a.settable
+        && a.rawseti;
+}
+
+struct LuaRows {
+    LuaRowsApi api;
+    lua_State* L;
+    int        result;  // absolute index of the array
+    int        keys;    // absolute index of the first name
+    int        nkeys;
+    int        rows;
+};
+
+// Pushes the result array, then `nkeys` field names (0 for a flat array).
+// False, with nothing pushed, when nkeys is over LUA_ROWS_MAX_KEYS.
+inline bool LuaRowsBegin(LuaRows* r, const LuaRowsApi& api, lua_State* L, const char* const* keys, int nkeys) {
+    if (nkeys < 0 || nkeys > LUA_ROWS_MAX_KEYS) return false;
+    r->api = api;
+    r->L = L;
+    r->nkeys = nkeys;
+    r->rows = 0;
+    api.newtable(L);
+    r->result = api.gettop(L);
+    r->keys = r->result + 1;
+    for (int i = 0; i < nkeys; i++) api.pushstring(L, keys[i]);
+    return true;
+}
+
+inline void LuaRowOpen(LuaRows* r) { r->api.newtable(r->L); }
+
+inline void LuaRowNumber(LuaRows* r, int key, double v) {
+    r->api.pushvalue(r->L, r->keys + key);
+    r->api.pushnumber(r->L, v);
+    r->api.settable(r->L, -3);
+}
+
+inline void LuaRowString(LuaRows* r, int key, const char* s) {
+    r->api.pushvalue(r->L, r->keys + key);
+    r->api.pushstring(r->L, s ? s : "");
+    r->api.settable(r->L, -3);
+}
+
+// Appends the open record to the array.
+inline void LuaRowClose(LuaRows* r) { r->api.rawseti(r->L, r->result, ++r->rows); }
+
+// Appends a bare number (flat arrays).
+inline void LuaRowsNumber(LuaRows* r, double v) {
+    r->api.pushnumber(r->L, v);
+    r->api.rawseti(r->L, r->result, ++r->rows);
+}
+
+// Drops the names; the array is left on top. Returns the rows appended.
+inline int LuaRowsEnd(LuaRows* r) {
+    r->api.settop(r->L, r->result);
+    return r->rows;
+}
@@ -21,6 +21,7 @@ typedef struct lua_State lua_State;
 // Lua pseudo-indices (Lua 5.0.2)
 #define LUA_REGISTRYINDEX  (-10000)
 #define LUA_GLOBALSINDEX   (-10001)
+#define lua_upvalueindex(i) (LUA_GLOBALSINDEX - (i))
 
 // Lua C function type
 typedef int (*lua_CFunction)(lua_State* L);
@@ -48,6 +49,11 @@ typedef void       (*pfn_lua_pushnil)(lua_State* L);
 typedef int        (*pfn_lua_isstring)(lua_State* L, int index);
 typedef int        (*pfn_lua_isnumber)(lua_State* L, int index);
 typedef int        (*pfn_lua_gettop)(lua_State* L);
+typedef void       (*pfn_lua_pushvalue)(lua_State* L, int index);
+typedef void       (*pfn_lua_remove)(lua_State* L, int index);
+typedef void*      (*pfn_lua_touserdata)(lua_State* L, int index);
+typedef void       (*pfn_lua_rawset)(lua_State* L, int index);
+typedef int        (*pfn_lua_setmetatable)(lua_State* L, int index);
 
 // lua_load reader callback (Lua 5.0.2)
 typedef const char* (*lua_Chunkreader)(lua_State* L, void* ud, size_t* sz);
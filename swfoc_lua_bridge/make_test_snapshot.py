@@ -25,10 +25,41 @@ Format versions
   See ``swfoc_lua_bridge/SNAPSHOT_FORMAT.md`` for the byte layouts and
   ``knowledge-base/replay_stub_gaps.md`` for the helper-by-helper map.
 
+- v3 (2026-10-14, ``SWFOC_DumpState(path, "lz4")``): the v2 layout with
+  each section optionally LZ4-compressed. A compressed section carries
+  ``SNAP_SECTION_LZ4`` in its ``section_id`` and a payload of
+  ``raw_length: uint32`` + LZ4 block. The CRC covers the uncompressed
+  (v2-framed) stream. ``lz4_block_compress`` is the same greedy matcher as
+  ``snap_lz4.h``, so both produce the same bytes.
+- v4 (2026-10-14, ``SWFOC_DumpState(path, "delta")``): a delta against a
+  base capture, named by section 0 (``delta_base``: the base's timestamp
+  and CRC). Unchanged sections are omitted, keyed sections may be stored as
+  record patches (``SNAP_SECTION_PATCH``), and a vanished base section is
+  an empty ``SNAP_SECTION_DROP``. The CRC covers the reconstructed stream.
+  ``make_delta`` / ``reconstruct`` mirror ``snap_delta.h``.
+
+Any version may end with a section index after its CRC (2026-10-14, always
+written by ``SWFOC_DumpState``): a trailer listing each section's id, file
+offset, length and CRC32 so a reader seeks to the sections it needs.
+``add_index`` / ``read_index`` mirror ``snap_index.h``; ``--check``
+validates the index when present.
+
 CLI:
     python make_test_snapshot.py <out>              # writes v2 (extended)
     python make_test_snapshot.py <out> --v2-early   # writes v2 WITHOUT sections 6-10
     python make_test_snapshot.py <out> --v1         # writes legacy v1
+    python make_test_snapshot.py <out> --v3         # writes v3 (extended, compressed)
+    python make_test_snapshot.py <out> --scale N [--planets M]
+                                                    # writes v2 with N generated units
+                                                    # (sections 11-14) and M planets
+                                                    # (replay_bench.cpp fixtures)
+    python make_test_snapshot.py <out> --delta <base> [--tick N] [--lz4] [--base <p> ...]
+                                                    # writes a v4 delta of the
+                                                    # fixture N ticks after <base>
+    python make_test_snapshot.py --check <path> [--base <p> ...]
+                                                    # expands / rebuilds + CRC-checks
+    python make_test_snapshot.py --list <path>      # prints the section index
+    Either writer form takes ``--index`` to append a section index.
 
 The ``--v2-early`` flag models a snapshot captured during the brief window
 after the v2 magic was introduced but before sections 6-10 landed. It lets
@@ -48,8 +79,454 @@ def fixed_str(s: str, width: int) -> bytes:
     return b + b"\x00" * (width - len(b))
 
 
-def build_snapshot(version: int = 2, include_extended_sections: bool = True) -> bytes:
-    if version not in (1, 2):
+SNAP_END_SECTION_ID = 0xFFFFFFFF
+SNAP_SECTION_LZ4 = 0x01000000
+SNAP_SECTION_ID_MASK = 0x00FFFFFF
+SNAP_LZ4_MIN_SECTION = 64
+SNAP_SECTION_PATCH = 0x02000000
+SNAP_SECTION_DROP = 0x04000000
+SNAP_DELTA_BASE_ID = 0
+SNAP_INDEX_SECTION_ID = 0xFFFFFFFE
+SNAP_INDEX_FIXED_BYTES = 20
+HEADER_BYTES = 68
+
+# snap_delta.h SnapFindKeyedLayout:
+#   id: (prefix, fixed, var_count_off, var_elem, key_len)
+KEYED_LAYOUTS = {
+    1: (8, 144, 0, 0, 4),     # player_array by slot
+    3: (4, 68, 0, 0, 64),     # object_catalog by type_name
+    4: (4, 80, 0, 0, 64),     # global_registry by name
+    6: (4, 72, 0, 0, 64),     # planet_state by planet name
+    12: (4, 92, 88, 4, 8),    # unit_detail by obj_addr
+    14: (4, 20, 0, 0, 8),     # unit_position by obj_addr
+}
+
+
+def _lz4_length(out: bytearray, n: int) -> None:
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def _lz4_sequence(out: bytearray, literals: bytes, offset: int, match_len: int) -> None:
+    ml = match_len - 4 if match_len else 0
+    out.append((min(len(literals), 15) << 4) | min(ml, 15))
+    if len(literals) >= 15:
+        _lz4_length(out, len(literals) - 15)
+    out += literals
+    if match_len:
+        out += struct.pack("<H", offset)
+        if ml >= 15:
+            _lz4_length(out, ml - 15)
+
+
+def lz4_block_compress(data: bytes) -> bytes:
+    """LZ4 block format, same greedy 4096-entry matcher as SnapLz4Compress."""
+    n = len(data)
+    table = {}
+    out = bytearray()
+    anchor = ip = 0
+    while ip + 12 <= n:
+        seq = data[ip:ip + 4]
+        h = ((struct.unpack("<I", seq)[0] * 2654435761) & 0xFFFFFFFF) >> 20
+        ref = table.get(h)
+        table[h] = ip
+        if ref is not None and ip - ref <= 0xFFFF and data[ref:ref + 4] == seq:
+            length = 4
+            while ip + length < n - 5 and data[ref + length] == data[ip + length]:
+                length += 1
+            _lz4_sequence(out, data[anchor:ip], ip - ref, length)
+            ip += length
+            anchor = ip
+            continue
+        ip += 1
+    _lz4_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def lz4_block_decompress(block: bytes, raw_len: int) -> bytes:
+    out = bytearray()
+    ip = 0
+    while ip < len(block):
+        token = block[ip]
+        ip += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = block[ip]
+                ip += 1
+                lit += b
+                if b != 255:
+                    break
+        if ip + lit > len(block):
+            raise ValueError("LZ4 literals run past the block")
+        out += block[ip:ip + lit]
+        ip += lit
+        if ip == len(block):
+            break
+        offset = struct.unpack_from("<H", block, ip)[0]
+        ip += 2
+        if offset == 0 or offset > len(out):
+            raise ValueError("LZ4 match offset before the output start")
+        ml = token & 15
+        if ml == 15:
+            while True:
+                b = block[ip]
+                ip += 1
+                ml += b
+                if b != 255:
+                    break
+        for _ in range(ml + 4):
+            out.append(out[-offset])
+    if len(out) != raw_len:
+        raise ValueError(f"LZ4 block decoded to {len(out)} bytes, expected {raw_len}")
+    return bytes(out)
+
+
+def compress_sections(stream: bytes) -> bytes:
+    """v2-framed stream (header .. CRC) -> v3 file, as the bridge writes it."""
+    out = bytearray(stream[:HEADER_BYTES])
+    pos = HEADER_BYTES
+    while True:
+        section_id, length = struct.unpack_from("<II", stream, pos)
+        if section_id == SNAP_END_SECTION_ID:
+            return bytes(out + stream[pos:])
+        payload = stream[pos + 8:pos + 8 + length]
+        packed = lz4_block_compress(payload) if length >= SNAP_LZ4_MIN_SECTION else b""
+        if packed and len(packed) + 4 < length:
+            out += struct.pack("<III", section_id | SNAP_SECTION_LZ4, len(packed) + 4, length)
+            out += packed
+        else:
+            out += stream[pos:pos + 8 + length]
+        pos += 8 + length
+
+
+def expand_sections(blob: bytes) -> bytes:
+    """v3 / v4 file -> the stream its CRC covers (SnapLz4ExpandSections)."""
+    out = bytearray(blob[:HEADER_BYTES])
+    pos = HEADER_BYTES
+    while pos + 8 <= len(blob):
+        section_id, length = struct.unpack_from("<II", blob, pos)
+        if section_id == SNAP_END_SECTION_ID:
+            return bytes(out + blob[pos:pos + 12])  # any section index stays behind
+        payload = blob[pos + 8:pos + 8 + length]
+        if len(payload) != length:
+            raise ValueError("section payload runs past end of file")
+        if section_id & SNAP_SECTION_LZ4:
+            raw_len = struct.unpack_from("<I", payload)[0]
+            raw = lz4_block_decompress(payload[4:], raw_len)
+            out += struct.pack("<II", section_id & ~SNAP_SECTION_LZ4, raw_len) + raw
+        else:
+            out += blob[pos:pos + 8 + length]
+        pos += 8 + length
+    raise ValueError("end marker missing")
+
+
+def _split_records(layout, payload: bytes):
+    """Keyed section payload -> (prefix, [record bytes]), or None if it does not split."""
+    prefix, fixed, var_off, var_elem, _ = layout
+    if len(payload) < prefix:
+        return None
+    records = []
+    pos = prefix
+    while pos < len(payload):
+        length = fixed
+        if pos + fixed > len(payload):
+            return None
+        if var_off:
+            length += struct.unpack_from("<I", payload, pos + var_off)[0] * var_elem
+        if pos + length > len(payload):
+            return None
+        records.append(payload[pos:pos + length])
+        pos += length
+    return payload[:prefix], records
+
+
+def delta_patch(layout, base: bytes, cur: bytes):
+    """PATCH payload turning base into cur (SnapDeltaPatch), or None."""
+    split_base, split_cur = _split_records(layout, base), _split_records(layout, cur)
+    if split_base is None or split_cur is None:
+        return None
+    key_len = layout[4]
+    index = {}
+    for rec in split_base[1]:
+        index.setdefault(rec[:key_len], rec)
+    out = bytearray(split_cur[0])
+    for rec in split_cur[1]:
+        if index.get(rec[:key_len]) == rec:
+            out += b"\x00" + rec[:key_len]
+        else:
+            out += b"\x01" + rec
+    return bytes(out)
+
+
+def apply_patch(layout, base: bytes, patch: bytes) -> bytes:
+    split_base = _split_records(layout, base)
+    if split_base is None:
+        raise ValueError("patched base section does not split into records")
+    prefix, fixed, var_off, var_elem, key_len = layout
+    index = {}
+    for rec in split_base[1]:
+        index.setdefault(rec[:key_len], rec)
+    out = bytearray(patch[:prefix])
+    pos = prefix
+    while pos < len(patch):
+        op = patch[pos]
+        pos += 1
+        if op == 0:
+            key = patch[pos:pos + key_len]
+            if key not in index:
+                raise ValueError("patch copies a key the base does not have")
+            out += index[key]
+            pos += key_len
+        elif op == 1:
+            length = fixed
+            if var_off:
+                length += struct.unpack_from("<I", patch, pos + var_off)[0] * var_elem
+            out += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError("unknown patch op")
+    return bytes(out)
+
+
+def add_index(blob: bytes) -> bytes:
+    """Any snapshot file -> the same file with a section index after its CRC
+    (SnapPutIndex): one (section_id, offset, length, CRC32) entry per
+    section as stored."""
+    entries = []
+    pos = HEADER_BYTES
+    while True:
+        section_id, length = struct.unpack_from("<II", blob, pos)
+        if section_id == SNAP_END_SECTION_ID:
+            break
+        payload = blob[pos + 8:pos + 8 + length]
+        entries.append(struct.pack("<IIII", section_id, pos, length, zlib.crc32(payload) & 0xFFFFFFFF))
+        pos += 8 + length
+    size = SNAP_INDEX_FIXED_BYTES + 16 * len(entries)
+    index = (struct.pack("<III", SNAP_INDEX_SECTION_ID, size - 8,
+                         zlib.crc32(blob[:HEADER_BYTES]) & 0xFFFFFFFF) + b"".join(entries))
+    index += struct.pack("<II", zlib.crc32(index) & 0xFFFFFFFF, size)
+    return blob[:pos + 12] + index
+
+
+def index_length(blob: bytes) -> int:
+    """Size of the section index the file ends with, or 0 (SnapIndexLength)."""
+    if len(blob) < HEADER_BYTES + 12 + SNAP_INDEX_FIXED_BYTES:
+        return 0
+    size = struct.unpack("<I", blob[-4:])[0]
+    if (size < SNAP_INDEX_FIXED_BYTES or size > len(blob) - HEADER_BYTES - 12
+            or (size - SNAP_INDEX_FIXED_BYTES) % 16):
+        return 0
+    section_id, length = struct.unpack_from("<II", blob, len(blob) - size)
+    return size if section_id == SNAP_INDEX_SECTION_ID and length == size - 8 else 0
+
+
+def _parse_index(index: bytes, file_len: int):
+    """The index a file_len-byte file ends with -> (header_crc32, entries)."""
+    size = len(index)
+    if zlib.crc32(index[:-8]) & 0xFFFFFFFF != struct.unpack_from("<I", index, size - 8)[0]:
+        raise ValueError("section index CRC32 mismatch")
+    entries = [struct.unpack_from("<IIII", index, 12 + 16 * i)
+               for i in range((size - SNAP_INDEX_FIXED_BYTES) // 16)]
+    for _, offset, length, _ in entries:
+        if offset < HEADER_BYTES or offset + 8 + length > file_len - size:
+            raise ValueError("section index entry lies outside the file")
+    return struct.unpack_from("<I", index, 8)[0], entries
+
+
+def read_index(blob: bytes):
+    """Checked section index -> (header_crc32, [(section_id, offset, length, crc32)]),
+    or None if the file has none (SnapReadIndex)."""
+    size = index_length(blob)
+    return _parse_index(blob[len(blob) - size:], len(blob)) if size else None
+
+
+def check_index(blob: bytes, index) -> None:
+    """Every index entry against the section it points at."""
+    header_crc, entries = index
+    if zlib.crc32(blob[:HEADER_BYTES]) & 0xFFFFFFFF != header_crc:
+        raise ValueError("header CRC32 does not match the section index")
+    for section_id, offset, length, crc in entries:
+        payload = blob[offset + 8:offset + 8 + length]
+        if (struct.unpack_from("<II", blob, offset) != (section_id, length)
+                or zlib.crc32(payload) & 0xFFFFFFFF != crc):
+            raise ValueError(f"section {section_id & SNAP_SECTION_ID_MASK} does not match "
+                             "its section index entry")
+
+
+def index_sections(stream: bytes):
+    """Expanded stream -> ([(section_id, payload)], end-marker offset)."""
+    sections = []
+    pos = HEADER_BYTES
+    while pos + 8 <= len(stream):
+        section_id, length = struct.unpack_from("<II", stream, pos)
+        if section_id == SNAP_END_SECTION_ID:
+            return sections, pos
+        sections.append((section_id, stream[pos + 8:pos + 8 + length]))
+        pos += 8 + length
+    raise ValueError("end marker missing")
+
+
+def _section(section_id: int, payload: bytes) -> bytes:
+    return struct.pack("<II", section_id, len(payload)) + payload
+
+
+def make_delta(base_stream: bytes, stream: bytes) -> bytes:
+    """Full v4 stream (section 0 first) -> the uncompressed delta file the
+    bridge writes against base_stream (SnapIoEmitDelta)."""
+    base = [s for s in index_sections(base_stream)[0] if s[0] != SNAP_DELTA_BASE_ID]
+    sections, end = index_sections(stream)
+    out = bytearray(stream[:HEADER_BYTES])
+    i = 0
+    for section_id, payload in sections:
+        if section_id == SNAP_DELTA_BASE_ID:
+            out += _section(section_id, payload)
+            continue
+        while i < len(base) and base[i][0] < section_id:
+            out += _section(base[i][0] | SNAP_SECTION_DROP, b"")
+            i += 1
+        if i < len(base) and base[i][0] == section_id:
+            base_payload = base[i][1]
+            i += 1
+            if base_payload == payload:
+                continue
+            layout = KEYED_LAYOUTS.get(section_id)
+            patch = delta_patch(layout, base_payload, payload) if layout else None
+            if patch is not None and len(patch) < len(payload):
+                out += _section(section_id | SNAP_SECTION_PATCH, patch)
+                continue
+        out += _section(section_id, payload)
+    for section_id, _ in base[i:]:
+        out += _section(section_id | SNAP_SECTION_DROP, b"")
+    return bytes(out + stream[end:])
+
+
+def reconstruct(base_stream: bytes, delta: bytes) -> bytes:
+    """Expanded v4 delta + its base's full stream -> full stream (SnapDeltaReconstruct)."""
+    base, _ = index_sections(base_stream)
+    sections, end = index_sections(delta)
+    if not sections or sections[0][0] != SNAP_DELTA_BASE_ID or len(sections[0][1]) != 12:
+        raise ValueError("delta_base section missing")
+    base_ts, base_crc = struct.unpack("<QI", sections[0][1])
+    if (base_ts != struct.unpack_from("<Q", base_stream, 0x14)[0]
+            or base_crc != struct.unpack("<I", base_stream[-4:])[0]
+            or base_stream[0x1C:0x3C] != delta[0x1C:0x3C]):
+        raise ValueError("base capture does not match the delta's reference")
+    merged = {sid: payload for sid, payload in base if sid != SNAP_DELTA_BASE_ID}
+    for section_id, payload in sections:
+        bare = section_id & SNAP_SECTION_ID_MASK
+        if section_id & SNAP_SECTION_DROP:
+            if bare not in merged:
+                raise ValueError("delta drops a section the base does not have")
+            del merged[bare]
+        elif section_id & SNAP_SECTION_PATCH:
+            if bare not in merged or bare not in KEYED_LAYOUTS:
+                raise ValueError("delta patches a section the base does not have")
+            merged[bare] = apply_patch(KEYED_LAYOUTS[bare], merged[bare], payload)
+        else:
+            merged[bare] = payload
+    out = bytearray(delta[:HEADER_BYTES])
+    for section_id in sorted(merged):
+        out += _section(section_id, merged[section_id])
+    return bytes(out + delta[end:])
+
+
+def read_stream(blob: bytes, bases=(), depth: int = 0) -> bytes:
+    """Any snapshot file -> its full uncompressed stream; a v4 delta is rebuilt
+    on whichever of `bases` (file contents) it references."""
+    version = struct.unpack_from("<I", blob, 16)[0]
+    if blob[:16] != f"SWFOCSNAPv{version}".encode("ascii") + b"\x00" * 5:
+        raise ValueError("magic/format_version mismatch")
+    if version < 3:
+        return blob[:len(blob) - index_length(blob)]
+    stream = expand_sections(blob)
+    if version == 3:
+        return stream
+    if depth >= 16:
+        raise ValueError("delta chain is deeper than 16")
+    last = "no --base snapshot given"
+    for base_blob in bases:
+        if base_blob is blob:
+            continue
+        try:
+            return reconstruct(read_stream(base_blob, bases, depth + 1), stream)
+        except (ValueError, struct.error) as e:
+            last = str(e)
+    raise ValueError(f"delta base not found ({last})")
+
+
+def check_snapshot(blob: bytes, bases=()) -> str:
+    """Validate magic, framing and CRC of any snapshot version; returns a summary."""
+    version = struct.unpack_from("<I", blob, 16)[0]
+    stream = read_stream(blob, bases)
+    index = read_index(blob)
+    if index is not None:
+        check_index(blob, index)
+    body, (crc,) = stream[:-4], struct.unpack("<I", stream[-4:])
+    if zlib.crc32(body) & 0xFFFFFFFF != crc:
+        raise ValueError(f"CRC32 mismatch (file=0x{crc:08X})")
+    sections = []
+    pos = HEADER_BYTES
+    while True:
+        section_id, length = struct.unpack_from("<II", stream, pos)
+        if section_id == SNAP_END_SECTION_ID:
+            break
+        sections.append(section_id)
+        pos += 8 + length
+    indexed = f", indexed ({len(index[1])} entries)" if index is not None else ""
+    return (f"v{version}, {len(blob)} bytes ({len(stream)} uncompressed), "
+            f"sections {sections}{indexed}")
+
+
+def list_index(path: str) -> str:
+    """The section index of the file at path, read by seeking to its tail
+    rather than loading the file."""
+    with open(path, "rb") as f:
+        f.seek(0, 2)
+        n = f.tell()
+        if n < HEADER_BYTES + 12 + SNAP_INDEX_FIXED_BYTES:
+            raise ValueError("no section index")
+        f.seek(n - 4)
+        size = struct.unpack("<I", f.read(4))[0]
+        if size < SNAP_INDEX_FIXED_BYTES or size > n - HEADER_BYTES - 12:
+            raise ValueError("no section index")
+        f.seek(n - size)
+        tail = f.read(size)
+    if index_length(b"\x00" * (HEADER_BYTES + 12) + tail) != size:
+        raise ValueError("no section index")
+    index = _parse_index(tail, n)
+    lines = [f"{len(index[1])} sections, header CRC32 0x{index[0]:08X}"]
+    for section_id, offset, length, crc in index[1]:
+        flags = "".join(tag for bit, tag in ((SNAP_SECTION_LZ4, " lz4"), (SNAP_SECTION_PATCH, " patch"),
+                                             (SNAP_SECTION_DROP, " drop")) if section_id & bit)
+        lines.append(f"  section {section_id & SNAP_SECTION_ID_MASK:3d} at {offset:8d}, "
+                     f"{length:8d} bytes, CRC32 0x{crc:08X}{flags}")
+    return "\n".join(lines)
+
+
+def scaled_planets(count: int):
+    """``count`` generated planets for section 6: (name, corruption, owner)."""
+    return [(f"PLANET_{i:04d}", (i % 20) / 20.0, i % 3) for i in range(count)]
+
+
+def scaled_units(count: int):
+    """``count`` generated unit rows in the --units row shape, on a 25-unit
+    grid 100 wide, owners and types round-robin."""
+    types = ("X_Wing", "TIE_Fighter", "Star_Destroyer")
+    rows = []
+    for i in range(count):
+        max_hull = 100.0 + 50.0 * (i % 3)
+        rows.append((0x100000 + i * 0x400, types[i % 3], i % 3, max_hull - (i % 7), max_hull,
+                     0, 0, [], (i % 100) * 25.0, (i // 100) * 25.0, 0.0))
+    return rows
+
+
+def build_snapshot(version: int = 2, include_extended_sections: bool = True,
+                   tick: int = 0, units: bool = False, scale_units: int = 0,
+                   scale_planets: int = 0) -> bytes:
+    if version not in (1, 2, 3):
         raise ValueError(f"unsupported snapshot version: {version}")
     if version == 1 and include_extended_sections:
         # v1 has no extended sections by definition; silently coerce.
@@ -57,10 +534,10 @@ def build_snapshot(version: int = 2, include_extended_sections: bool = True) ->
     parts = []
 
     # ---- Header (68 bytes) ----
-    magic = (b"SWFOCSNAPv2" if version == 2 else b"SWFOCSNAPv1") + b"\x00" * 5
+    magic = f"SWFOCSNAPv{version}".encode("ascii") + b"\x00" * 5
     parts.append(magic)                                  # 16 bytes magic
     parts.append(struct.pack("<I", version))             # format_version
-    parts.append(struct.pack("<Q", 0x1234567890ABCDEF))  # capture_timestamp_ms
+    parts.append(struct.pack("<Q", 0x1234567890ABCDEF + 5000 * tick))  # capture_timestamp_ms
     parts.append(b"\x00" * 32)                           # engine_build_hash
     parts.append(struct.pack("<B", 1))                   # game_mode = galactic
     parts.append(b"\x00" * 7)                            # reserved padding
@@ -70,7 +547,7 @@ def build_snapshot(version: int = 2, include_extended_sections: bool = True) ->
     sec1 = bytearray()
     players = [
         # (slot, faction, credits, tech_level, name)
-        (0, "REBEL", 12345.0, 3, ""),
+        (0, "REBEL", 12345.0 + 250.0 * tick, 3, ""),  # one timeline tick = +250 credits
         (1, "EMPIRE", 99999.0, 5, ""),
         (2, "UNDERWORLD", 5000.0, 1, ""),
     ]
@@ -168,6 +645,8 @@ def build_snapshot(version: int = 2, include_extended_sections: bool = True) ->
             ("KASHYYYK",  0.40, 2),  # UNDERWORLD foothold
             ("NABOO",     0.75, 2),  # heavily corrupted
         ]
+        if scale_planets:
+            planets = scaled_planets(scale_planets)
         sec6 = bytearray()
         sec6 += struct.pack("<I", len(planets))
         for pname, corruption, owner in planets:
@@ -242,27 +721,144 @@ def build_snapshot(version: int = 2, include_extended_sections: bool = True) ->
         parts.append(struct.pack("<II", 10, len(sec10)))
         parts.append(bytes(sec10))
 
+    if version >= 2 and units:
+        # ---- Sections 11-14: selected_units, unit_detail, behavior_attach,
+        # unit_position (2026-10-14, --units) ----
+        # obj_addr, type_name, owner_slot, hull, max_hull, invuln_flag,
+        # prevent_death, hardpoint indices
+        unit_rows = [
+            (0x1000, "X_Wing",         0,  80.0,  100.0, 0, 0, [0, 1]),
+            (0x2000, "TIE_Fighter",    1,  40.0,   40.0, 1, 0, []),
+            (0x3000, "Star_Destroyer", 1, 900.0, 1000.0, 0, 1, [0, 1, 2]),
+        ]
+        sec11 = struct.pack("<I", 2) + struct.pack("<QQ", 0x1000, 0x3000)
+        parts.append(struct.pack("<II", 11, len(sec11)))
+        parts.append(sec11)
+        sec12 = bytearray(struct.pack("<I", len(unit_rows)))
+        for obj, type_name, owner, hull, max_hull, invuln, prevent, hps in unit_rows:
+            sec12 += struct.pack("<Q", obj) + fixed_str(type_name, 64)
+            sec12 += struct.pack("<iffBB", owner, hull, max_hull, invuln, prevent) + b"\x00" * 6
+            sec12 += struct.pack("<I", len(hps)) + b"".join(struct.pack("<I", i) for i in hps)
+        parts.append(struct.pack("<II", 12, len(sec12)))
+        parts.append(bytes(sec12))
+        attach = [(0x1000, 1, "SHIELD"), (0x3000, 0, "INVULNERABLE"), (0x3000, 2, "INVULNERABLE")]
+        sec13 = bytearray(struct.pack("<I", len(attach)))
+        for obj, hp, behavior in attach:
+            sec13 += struct.pack("<QI", obj, hp) + fixed_str(behavior, 32)
+        parts.append(struct.pack("<II", 13, len(sec13)))
+        parts.append(bytes(sec13))
+        sec14 = struct.pack("<I", 2) + struct.pack("<Qfff", 0x1000, 10.0, 20.0, 0.0) \
+            + struct.pack("<Qfff", 0x3000, -50.0, 5.0, 1.5)
+        parts.append(struct.pack("<II", 14, len(sec14)))
+        parts.append(sec14)
+
+    if version >= 2 and scale_units and not units:
+        # ---- Sections 11, 12, 14 at bench scale (--scale N) ----
+        rows = scaled_units(scale_units)
+        selected = [r[0] for r in rows[:8]]
+        sec11 = struct.pack("<I", len(selected)) + b"".join(struct.pack("<Q", a) for a in selected)
+        parts.append(struct.pack("<II", 11, len(sec11)))
+        parts.append(sec11)
+        sec12 = bytearray(struct.pack("<I", len(rows)))
+        sec14 = bytearray(struct.pack("<I", len(rows)))
+        for obj, type_name, owner, hull, max_hull, invuln, prevent, hps, x, y, z in rows:
+            sec12 += struct.pack("<Q", obj) + fixed_str(type_name, 64)
+            sec12 += struct.pack("<iffBB", owner, hull, max_hull, invuln, prevent) + b"\x00" * 6
+            sec12 += struct.pack("<I", len(hps))
+            sec14 += struct.pack("<Qfff", obj, x, y, z)
+        parts.append(struct.pack("<II", 12, len(sec12)))
+        parts.append(bytes(sec12))
+        parts.append(struct.pack("<II", 14, len(sec14)))
+        parts.append(bytes(sec14))
+
     # ---- End marker ----
     parts.append(struct.pack("<II", 0xFFFFFFFF, 4))
 
     body = b"".join(parts)
     crc = zlib.crc32(body) & 0xFFFFFFFF
-    return body + struct.pack("<I", crc)
+    stream = body + struct.pack("<I", crc)
+    return compress_sections(stream) if version == 3 else stream
+
+
+def build_delta(base_blob: bytes, tick: int = 1, lz4: bool = False, bases=()) -> bytes:
+    """v4 delta of the fixture at `tick` against base_blob, a fixture or a
+    delta of one (rebuilt from `bases`)."""
+    base_stream = read_stream(base_blob, bases)
+    full = build_snapshot(2, True, tick)
+    base_ref = struct.pack("<QI", struct.unpack_from("<Q", base_stream, 0x14)[0],
+                           struct.unpack("<I", base_stream[-4:])[0])
+    body = (b"SWFOCSNAPv4" + b"\x00" * 5 + struct.pack("<I", 4) + full[20:HEADER_BYTES]
+            + _section(SNAP_DELTA_BASE_ID, base_ref) + full[HEADER_BYTES:-4])
+    stream = body + struct.pack("<I", zlib.crc32(body) & 0xFFFFFFFF)
+    delta = make_delta(base_stream, stream)
+    return compress_sections(delta) if lz4 else delta
 
 
 def main() -> int:
     if len(sys.argv) < 2:
         print(
-            "usage: make_test_snapshot.py <output-path> [--v1 | --v2-early]",
+            "usage: make_test_snapshot.py <output-path> [--v1 | --v2-early | --v3] [--units]\n"
+            "                             [--scale N] [--planets M]\n"
+            "       make_test_snapshot.py <output-path> --delta <base-path> [--tick N] [--lz4]\n"
+            "                             [--base <path> ...]\n"
+            "       make_test_snapshot.py --check <snapshot-path> [--base <path> ...]\n"
+            "       make_test_snapshot.py --list <snapshot-path>\n"
+            "       (either writer form takes --index to append a section index)",
             file=sys.stderr,
         )
         return 2
+    bases = []
+    for i, arg in enumerate(sys.argv):
+        if arg == "--base" and i + 1 < len(sys.argv):
+            with open(sys.argv[i + 1], "rb") as f:
+                bases.append(f.read())
+    if sys.argv[1] == "--check":
+        if len(sys.argv) < 3:
+            print("usage: make_test_snapshot.py --check <snapshot-path> [--base <path> ...]",
+                  file=sys.stderr)
+            return 2
+        with open(sys.argv[2], "rb") as f:
+            blob = f.read()
+        try:
+            print(f"{sys.argv[2]}: {check_snapshot(blob, bases)}")
+        except (ValueError, struct.error) as e:
+            print(f"{sys.argv[2]}: INVALID: {e}", file=sys.stderr)
+            return 1
+        return 0
+    if sys.argv[1] == "--list":
+        if len(sys.argv) < 3:
+            print("usage: make_test_snapshot.py --list <snapshot-path>", file=sys.stderr)
+            return 2
+        try:
+            print(f"{sys.argv[2]}: {list_index(sys.argv[2])}")
+        except (ValueError, struct.error) as e:
+            print(f"{sys.argv[2]}: {e}", file=sys.stderr)
+            return 1
+        return 0
     out_path = sys.argv[1]
     flags = sys.argv[2:]
+    if "--delta" in flags:
+        at = flags.index("--delta")
+        if at + 1 >= len(flags):
+            print("--delta requires a base snapshot path", file=sys.stderr)
+            return 2
+        tick = int(flags[flags.index("--tick") + 1]) if "--tick" in flags else 1
+        with open(flags[at + 1], "rb") as f:
+            blob = build_delta(f.read(), tick=tick, lz4="--lz4" in flags, bases=bases)
+        if "--index" in flags:
+            blob = add_index(blob)
+        with open(out_path, "wb") as f:
+            f.write(blob)
+        print(f"wrote {len(blob)} bytes to {out_path} (v4 delta, tick {tick})")
+        return 0
     if "--v1" in flags:
         version = 1
         extended = False
         label = "v1"
+    elif "--v3" in flags:
+        version = 3
+        extended = True
+        label = "v3"
     elif "--v2-early" in flags:
         version = 2
         extended = False
@@ -271,7 +867,20 @@ def main() -> int:
         version = 2
         extended = True
         label = "v2"
-    blob = build_snapshot(version=version, include_extended_sections=extended)
+    units = "--units" in flags and version >= 2
+    scale_units = int(flags[flags.index("--scale") + 1]) if "--scale" in flags and version >= 2 else 0
+    scale_planets = int(flags[flags.index("--planets") + 1]) if "--planets" in flags and extended else 0
+    blob = build_snapshot(version=version, include_extended_sections=extended, units=units,
+                          scale_units=scale_units, scale_planets=scale_planets)
+    if units:
+        label += ", units"
+    if scale_units:
+        label += f", {scale_units} units"
+    if scale_planets:
+        label += f", {scale_planets} planets"
+    if "--index" in flags:
+        blob = add_index(blob)
+        label += ", indexed"
     with open(out_path, "wb") as f:
         f.write(blob)
     print(f"wrote {len(blob)} bytes to {out_path} ({label})")
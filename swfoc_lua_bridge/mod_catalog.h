@@ -0,0 +1,110 @@
+#pragma once
+// mod_catalog.h -- the ./Mods scan behind SWFOC_ListMods / SWFOC_GetCurrentMod,
+// published by a watcher thread.
+//
+// Both helpers used to walk Mods\* with FindFirstFileA and probe every
+// folder's Modinfo.xml on each call, on the game's main thread, and the
+// editor's mod panel calls them on every refresh. The bridge now scans from
+// a background thread: once at startup, again whenever a change
+// notification fires under Mods\ (after it has been quiet for
+// MOD_WATCH_SETTLE_MS, so a mod being copied in is scanned once), and every
+// MOD_WATCH_RESCAN_MS regardless (last-access times raise no notification,
+// and Mods\ may not exist yet). Each scan is published here as the two
+// finished reply strings; a helper call copies one out under the lock.
+//
+//   * ListMods: "<name>;<path>" rows joined by '\n', at most MOD_LIST_MAX
+//     bytes (the tail is dropped, as before), or "(no_mods)".
+//   * GetCurrentMod: the most recently accessed mod (the first one found
+//     on a tie) as "<name>;unknown\n<path>", or "vanilla".
+//   * A scan that could not read the working directory publishes "ERR:
+//     GetCurrentDirectory failed" for both.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define MOD_LIST_MAX        16384  // ListMods reply, NUL included
+#define MOD_WATCH_SETTLE_MS 250
+#define MOD_WATCH_RESCAN_MS 30000
+
+#define MOD_SCAN_ERR_CWD "ERR: GetCurrentDirectory failed"
+
+struct ModEntry {
+    std::string name;        // folder name
+    std::string path;        // absolute folder path
+    uint64_t    lastAccess;  // Modinfo.xml last-access FILETIME
+};
+
+struct ModCatalog {
+    std::mutex  lock;
+    bool        ready;        // a scan has been published
+    uint32_t    scans;
+    std::string list;         // SWFOC_ListMods reply
+    std::string current;      // SWFOC_GetCurrentMod reply
+    std::string currentName;  // its mod name, "vanilla" when none
+    int         listed;       // rows in `list`
+};
+
+inline std::string ModFormatList(const std::vector<ModEntry>& mods, int* listed) {
+    std::string out;
+    int n = 0;
+    for (const ModEntry& m : mods) {
+        const size_t row = (n ? 1 : 0) + m.name.size() + 1 + m.path.size();
+        if (out.size() + row + 1 >= MOD_LIST_MAX) break;
+        if (n) out += '\n';
+        out += m.name;
+        out += ';';
+        out += m.path;
+        n++;
+    }
+    if (listed) *listed = n;
+    return n ? out : std::string("(no_mods)");
+}
+
+// Index of the most recently accessed mod (the first on a tie), -1 if none.
+inline int ModPickCurrent(const std::vector<ModEntry>& mods) {
+    int best = -1;
+    for (size_t i = 0; i < mods.size(); i++)
+        if (best < 0 || mods[i].lastAccess > mods[(size_t)best].lastAccess) best = (int)i;
+    return best;
+}
+
+// Builds both replies outside the lock and swaps them in. cwdFailed
+// publishes the working-directory error instead.
+inline void ModCatalogPublish(ModCatalog* c, const std::vector<ModEntry>& mods, bool cwdFailed) {
+    std::string list, current, name;
+    int listed = 0;
+    if (cwdFailed) {
+        list = current = MOD_SCAN_ERR_CWD;
+    } else {
+        list = ModFormatList(mods, &listed);
+        const int pick = ModPickCurrent(mods);
+        if (pick < 0) {
+            current = name = "vanilla";
+        } else {
+            name = mods[(size_t)pick].name;
+            current = name + ";unknown\n" + mods[(size_t)pick].path;
+        }
+    }
+    std::lock_guard<std::mutex> g(c->lock);
+    c->list.swap(list);
+    c->current.swap(current);
+    c->currentName.swap(name);
+    c->listed = listed;
+    c->ready = true;
+    c->scans++;
+}
+
+// Copies the published replies (any pointer may be null). False before the
+// first publish.
+inline bool ModCatalogRead(ModCatalog* c, std::string* list, std::string* current, std::string* currentName) {
+    std::lock_guard<std::mutex> g(c->lock);
+    if (!c->ready) return false;
+    if (list) *list = c->list;
+    if (current) *current = c->current;
+    if (currentName) *currentName = c->currentName;
+    return true;
+}
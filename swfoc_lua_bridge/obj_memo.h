@@ -0,0 +1,63 @@
+#pragma once
+// obj_memo.h -- per-tick memo of resolved GameObj fields.
+//
+// IsObjOwnedByHuman, WalkToRootUnit, GetOwnerPlayerObj, InspectUnit and
+// GetHardpoints chase the same chains (components -> parent index -> root
+// -> owner player -> PlayerObj::LocalPlayer), often several times per unit
+// in one command. The bridge resolves them once per object and epoch and
+// keeps the answers here:
+//
+//   * Direct-mapped on a hash of obj_addr; a collision simply replaces the
+//     older entry, so a lookup is one probe.
+//   * Entries carry the epoch they were resolved in and only match that
+//     epoch. Advancing the epoch (the bridge uses the luaD_call tick plus a
+//     short wall-clock window, like CanReadMem) invalidates everything
+//     without touching the table.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge keeps one memo per thread.
+
+#include <cstdint>
+
+#define OBJ_MEMO_SLOTS 1024  // power of two
+
+struct ObjMemoEntry {
+    uint64_t obj;         // 0 = empty
+    uint64_t epoch;
+    uint64_t root;        // WalkToRootUnit(obj), 0 when obj is invalid
+    uint64_t player;      // owner PlayerObject* of root, 0 when unresolved
+    uint64_t components;  // obj's component array pointer
+    uint8_t  valid;       // IsValidObjAddr(obj)
+    uint8_t  isHuman;     // player's LocalPlayer byte == 1
+};
+
+struct ObjMemo {
+    ObjMemoEntry entries[OBJ_MEMO_SLOTS];
+    uint32_t     hits;
+    uint32_t     misses;
+};
+
+inline uint32_t ObjMemoHash(uint64_t obj) {
+    obj >>= 4;  // engine objects are at least 16-byte aligned
+    obj ^= obj >> 31;
+    obj *= 0x9e3779b97f4a7c15ull;
+    return (uint32_t)(obj >> 32) & (OBJ_MEMO_SLOTS - 1);
+}
+
+// Returns the entry for obj resolved in `epoch`, or nullptr.
+inline const ObjMemoEntry* ObjMemoLookup(ObjMemo* m, uint64_t obj, uint64_t epoch) {
+    const ObjMemoEntry* e = &m->entries[ObjMemoHash(obj)];
+    if (obj && e->obj == obj && e->epoch == epoch) {
+        m->hits++;
+        return e;
+    }
+    m->misses++;
+    return nullptr;
+}
+
+// Stores a freshly resolved entry for its obj and epoch and returns it.
+inline const ObjMemoEntry* ObjMemoStore(ObjMemo* m, const ObjMemoEntry& fresh) {
+    ObjMemoEntry* e = &m->entries[ObjMemoHash(fresh.obj)];
+    *e = fresh;
+    return e;
+}
@@ -0,0 +1,325 @@
+#pragma once
+// pending_journal.h -- the one journal every Phase 1 "record intent" helper
+// writes into, and the per-slot state it folds into.
+//
+// The record-only helpers (SetBuildCost, SetUnitCapOverride, FreezeAI,
+// InstantBuild, ChangePlanetOwner, SetHeroRespawnTimer, ...) each kept
+// their own CRITICAL_SECTION, a lazy Ensure*Lock initializer and a
+// std::unordered_map keyed by player slot. They now push a typed
+// PendingWrite instead:
+//
+//   * Producers (any thread): claim a ring slot with one CAS on `head`,
+//     fill it and publish it with a release store of the slot's sequence
+//     (the log_ring.h scheme). No lock, no heap. A full ring refuses the
+//     write and counts it in `dropped`; the helper answers ERR.
+//   * The main thread applies everything published, in claim order, once
+//     per tick (end of DrainPipeCommand). Two writes to the same slot thus
+//     land in the order the helpers ran, whichever thread ran them.
+//   * Knobs an engine detour reads live in slot_mods.h instead; this journal
+//     only carries intent nothing in the hot path consults.
+//   * Slot-keyed values live in fixed arrays of PENDING_PLAYER_SLOTS with a
+//     presence bit per slot; a write for a slot outside 0..15 is refused at
+//     push time. Only the writes whose key is not a slot (planet name,
+//     hero object address, unit + field) still fold into maps, and only the
+//     applier touches those.
+//   * SetUnitField's record-only fields fold by (obj_addr, field name), last
+//     writer wins, so a slider dragged over one unit keeps one entry. The
+//     map holds at most PENDING_UNIT_FIELDS_MAX; a new key past that evicts
+//     the least recently written one (counted in unitFieldsEvicted).
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#define PENDING_JOURNAL_SLOTS 256  // power of two
+#define PENDING_PLAYER_SLOTS  16   // slot-keyed arrays; bit s of a presence mask = slot s
+#define PENDING_NAME_MAX      40   // planet or field name, NUL included
+#define PENDING_UNIT_FIELDS_MAX 512  // distinct (obj_addr, field) writes kept
+
+enum PendingKind : uint8_t {
+    // Per-slot values: `slot` + `value`.
+    PENDING_FACTION_SPEED_MULT = 0,
+    PENDING_BUILD_COST_MULT,
+    PENDING_UNIT_CAP,
+    PENDING_TARGET_FILTER,
+    // Per-slot set/clear: `slot` + `flag` (+ `value` for the frozen amount).
+    PENDING_FREEZE_CREDITS,
+    PENDING_FREEZE_AI,
+    // Global: `value` / `flag`.
+    PENDING_GAME_SPEED,
+    PENDING_AREA_DAMAGE,
+    PENDING_INSTANT_BUILD,
+    PENDING_FREE_BUILD,
+    PENDING_FREE_CAM,
+    PENDING_OHK_ATTACK,
+    // Keyed: slot pair, planet name, hero object.
+    PENDING_DIPLOMACY,      // slot, slot2, value = state code
+    PENDING_PLANET_OWNER,   // name, slot
+    PENDING_RESPAWN_TIMER,  // key = obj_addr, value = ms
+    PENDING_PERMADEATH,     // key = obj_addr, flag
+    PENDING_UNIT_FIELD,     // key = obj_addr, name = field, value
+    PENDING_PLANET_TECH,       // name, value (planet_table.h batches)
+    PENDING_PLANET_BUILDINGS,  // name, value
+    PENDING_KIND_COUNT,
+};
+
+struct PendingWrite {
+    uint8_t  kind;
+    uint8_t  flag;
+    int16_t  slot;
+    int16_t  slot2;
+    uint64_t key;
+    double   value;
+    char     name[PENDING_NAME_MAX];
+};
+
+enum PendingPushResult {
+    PENDING_PUSH_OK = 0,
+    PENDING_PUSH_FULL,      // ring full, write dropped
+    PENDING_PUSH_BAD_SLOT,  // slot (or slot2) outside 0..PENDING_PLAYER_SLOTS-1
+    PENDING_PUSH_BAD_NAME,  // planet or field name empty or too long
+};
+
+struct PendingJournalSlot {
+    std::atomic<uint32_t> seq;  // == position when free, position + 1 once published
+    PendingWrite          write;
+};
+
+struct PendingJournal {
+    PendingJournalSlot    slots[PENDING_JOURNAL_SLOTS];
+    std::atomic<uint32_t> head;      // next position a producer claims
+    std::atomic<uint32_t> tail;      // next position the applier reads
+    std::atomic<uint32_t> applying;  // 1 while the applier holds the ring
+    std::atomic<uint64_t> dropped;   // writes refused because the ring was full
+    std::atomic<uint64_t> applied;
+};
+
+struct PendingUnitField {
+    float    value;
+    uint32_t stamp;  // fold order, for eviction
+};
+
+// Folded result of every applied write. Owned by the applier thread.
+struct PendingState {
+    float    factionSpeedMult[PENDING_PLAYER_SLOTS];
+    float    buildCostMult[PENDING_PLAYER_SLOTS];
+    int32_t  unitCap[PENDING_PLAYER_SLOTS];
+    uint32_t targetFilter[PENDING_PLAYER_SLOTS];
+    double   frozenCredits[PENDING_PLAYER_SLOTS];
+    uint16_t present[PENDING_KIND_COUNT];    // per-slot kinds: which slots hold a value
+    uint32_t toggles;                        // global flag kinds: bit (1 << kind) = on
+    float    gameSpeed;
+    int8_t   diplomacy[PENDING_PLAYER_SLOTS][PENDING_PLAYER_SLOTS];  // [lo][hi], -1 = none
+    std::unordered_map<std::string, int32_t> planetOwners;  // uppercased name -> slot
+    std::unordered_map<std::string, int32_t> planetTech;       // uppercased name -> level
+    std::unordered_map<std::string, int32_t> planetBuildings;  // uppercased name -> count
+    std::unordered_map<uint64_t, int32_t>    respawnMs;     // obj_addr -> ms
+    std::unordered_map<uint64_t, bool>       permadeath;    // obj_addr -> flag
+    std::map<std::pair<uint64_t, std::string>, PendingUnitField> unitFields;  // (obj_addr, field)
+    uint32_t unitFieldStamp;
+    uint64_t unitFieldsEvicted;
+};
+
+// Only call while no producer or applier can run (startup / tests).
+inline void PendingJournalInit(PendingJournal* j) {
+    for (uint32_t i = 0; i < PENDING_JOURNAL_SLOTS; i++) j->slots[i].seq.store(i, std::memory_order_relaxed);
+    j->head.store(0, std::memory_order_relaxed);
+    j->tail.store(0, std::memory_order_relaxed);
+    j->applying.store(0, std::memory_order_relaxed);
+    j->dropped.store(0, std::memory_order_relaxed);
+    j->applied.store(0, std::memory_order_relaxed);
+}
+
+inline void PendingStateInit(PendingState* s) {
+    for (int i = 0; i < PENDING_PLAYER_SLOTS; i++) {
+        s->factionSpeedMult[i] = s->buildCostMult[i] = 1.0f;
+        s->unitCap[i] = -1;
+        s->targetFilter[i] = 0;
+        s->frozenCredits[i] = 0.0;
+        for (int k = 0; k < PENDING_PLAYER_SLOTS; k++) s->diplomacy[i][k] = -1;
+    }
+    memset(s->present, 0, sizeof(s->present));
+    s->toggles = 0;
+    s->gameSpeed = 1.0f;
+    s->planetOwners.clear();
+    s->planetTech.clear();
+    s->planetBuildings.clear();
+    s->respawnMs.clear();
+    s->permadeath.clear();
+    s->unitFields.clear();
+    s->unitFieldStamp = 0;
+    s->unitFieldsEvicted = 0;
+}
+
+inline bool PendingSlotOk(int slot) { return slot >= 0 && slot < PENDING_PLAYER_SLOTS; }
+
+inline bool PendingKindUsesName(uint8_t kind) {
+    return kind == PENDING_PLANET_OWNER || kind == PENDING_UNIT_FIELD || kind == PENDING_PLANET_TECH
+        || kind == PENDING_PLANET_BUILDINGS;
+}
+
+inline bool PendingKindUsesSlot(uint8_t kind) {
+    return kind <= PENDING_FREEZE_AI || kind == PENDING_DIPLOMACY || kind == PENDING_PLANET_OWNER;
+}
+
+inline bool PendingStateHas(const PendingState* s, uint8_t kind, int slot) {
+    return kind < PENDING_KIND_COUNT && PendingSlotOk(slot) && (s->present[kind] >> slot) & 1u;
+}
+
+inline bool PendingToggleOn(const PendingState* s, uint8_t kind) {
+    return kind < 32 && (s->toggles >> kind) & 1u;
+}
+
+inline bool PendingJournalHasWork(const PendingJournal* j) {
+    return j->head.load(std::memory_order_relaxed) != j->tail.load(std::memory_order_relaxed);
+}
+
+inline PendingPushResult PendingJournalPush(PendingJournal* j, const PendingWrite& w) {
+    if (PendingKindUsesSlot(w.kind) && !PendingSlotOk(w.slot)) return PENDING_PUSH_BAD_SLOT;
+    if (w.kind == PENDING_DIPLOMACY && !PendingSlotOk(w.slot2)) return PENDING_PUSH_BAD_SLOT;
+    if (PendingKindUsesName(w.kind)
+        && (!w.name[0] || !memchr(w.name, '\0', PENDING_NAME_MAX)))
+        return PENDING_PUSH_BAD_NAME;
+
+    uint32_t pos = j->head.load(std::memory_order_relaxed);
+    PendingJournalSlot* s;
+    for (;;) {
+        s = &j->slots[pos & (PENDING_JOURNAL_SLOTS - 1)];
+        const uint32_t seq = s->seq.load(std::memory_order_acquire);
+        const int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (j->head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            j->dropped.fetch_add(1, std::memory_order_relaxed);
+            return PENDING_PUSH_FULL;
+        } else {
+            pos = j->head.load(std::memory_order_relaxed);
+        }
+    }
+    s->write = w;
+    s->seq.store(pos + 1, std::memory_order_release);
+    return PENDING_PUSH_OK;
+}
+
+// Convenience builders for the common shapes.
+inline PendingWrite PendingSlotValue(uint8_t kind, int slot, double value, bool flag = false) {
+    PendingWrite w = {};
+    w.kind  = kind;
+    w.slot  = (int16_t)(PendingSlotOk(slot) ? slot : -1);
+    w.value = value;
+    w.flag  = flag ? 1 : 0;
+    return w;
+}
+
+inline PendingWrite PendingGlobal(uint8_t kind, double value, bool flag) {
+    PendingWrite w = {};
+    w.kind  = kind;
+    w.value = value;
+    w.flag  = flag ? 1 : 0;
+    return w;
+}
+
+// Last writer wins per (obj_addr, field); a new key on a full map evicts
+// the entry written longest ago.
+inline void PendingFoldUnitField(PendingState* s, const PendingWrite& w) {
+    auto key = std::make_pair(w.key, std::string(w.name));
+    auto it = s->unitFields.find(key);
+    if (it == s->unitFields.end()) {
+        if (s->unitFields.size() >= PENDING_UNIT_FIELDS_MAX) {
+            auto oldest = s->unitFields.begin();
+            for (auto e = s->unitFields.begin(); e != s->unitFields.end(); ++e)
+                if (e->second.stamp - s->unitFieldStamp < oldest->second.stamp - s->unitFieldStamp) oldest = e;
+            s->unitFields.erase(oldest);
+            s->unitFieldsEvicted++;
+        }
+        it = s->unitFields.emplace(std::move(key), PendingUnitField()).first;
+    }
+    it->second.value = (float)w.value;
+    it->second.stamp = s->unitFieldStamp++;
+}
+
+inline void PendingFold(PendingState* s, const PendingWrite& w) {
+    const uint16_t bit = PendingSlotOk(w.slot) ? (uint16_t)(1u << w.slot) : 0;
+    const float f = (float)w.value;
+    switch (w.kind) {
+    case PENDING_FACTION_SPEED_MULT: s->factionSpeedMult[w.slot] = f; break;
+    case PENDING_BUILD_COST_MULT:    s->buildCostMult[w.slot] = f; break;
+    case PENDING_UNIT_CAP:           s->unitCap[w.slot] = (int32_t)w.value; break;
+    case PENDING_TARGET_FILTER:      s->targetFilter[w.slot] = (uint32_t)w.value; break;
+    case PENDING_FREEZE_CREDITS:
+        s->frozenCredits[w.slot] = w.flag ? w.value : 0.0;
+        break;
+    case PENDING_FREEZE_AI:
+        break;
+    case PENDING_GAME_SPEED:
+        s->gameSpeed = f;
+        return;
+    case PENDING_AREA_DAMAGE:
+    case PENDING_INSTANT_BUILD:
+    case PENDING_FREE_BUILD:
+    case PENDING_FREE_CAM:
+    case PENDING_OHK_ATTACK:
+        if (w.flag) s->toggles |= 1u << w.kind;
+        else        s->toggles &= ~(1u << w.kind);
+        return;
+    case PENDING_DIPLOMACY: {
+        const int lo = w.slot < w.slot2 ? w.slot : w.slot2;
+        const int hi = w.slot < w.slot2 ? w.slot2 : w.slot;
+        s->diplomacy[lo][hi] = (int8_t)w.value;
+        return;
+    }
+    case PENDING_PLANET_OWNER:
+        s->planetOwners[w.name] = w.slot;
+        return;
+    case PENDING_PLANET_TECH:
+        s->planetTech[w.name] = (int32_t)w.value;
+        return;
+    case PENDING_PLANET_BUILDINGS:
+        s->planetBuildings[w.name] = (int32_t)w.value;
+        return;
+    case PENDING_RESPAWN_TIMER:
+        s->respawnMs[w.key] = (int32_t)w.value;
+        return;
+    case PENDING_PERMADEATH:
+        s->permadeath[w.key] = w.flag != 0;
+        return;
+    case PENDING_UNIT_FIELD:
+        PendingFoldUnitField(s, w);
+        return;
+    default:
+        return;
+    }
+    // Per-slot kinds: set/clear kinds clear the slot on flag == 0.
+    const bool setClear = w.kind == PENDING_FREEZE_CREDITS || w.kind == PENDING_FREEZE_AI;
+    if (!setClear || w.flag) s->present[w.kind] |= bit;
+    else                     s->present[w.kind] &= (uint16_t)~bit;
+}
+
+// Folds every published write into `state`, in claim order. Returns the
+// number applied; 0 when another applier holds the journal. Stops at the
+// first slot still being filled -- it and those after it go on the next
+// pass.
+inline uint32_t PendingJournalApply(PendingJournal* j, PendingState* state) {
+    uint32_t expected = 0;
+    if (!j->applying.compare_exchange_strong(expected, 1, std::memory_order_acquire)) return 0;
+    uint32_t pos = j->tail.load(std::memory_order_relaxed);
+    uint32_t n = 0;
+    for (;;) {
+        PendingJournalSlot* s = &j->slots[pos & (PENDING_JOURNAL_SLOTS - 1)];
+        if (s->seq.load(std::memory_order_acquire) != pos + 1) break;
+        PendingFold(state, s->write);
+        s->seq.store(pos + PENDING_JOURNAL_SLOTS, std::memory_order_release);
+        pos++;
+        n++;
+    }
+    j->tail.store(pos, std::memory_order_relaxed);
+    j->applied.fetch_add(n, std::memory_order_relaxed);
+    j->applying.store(0, std::memory_order_release);
+    return n;
+}
@@ -0,0 +1,197 @@
+#pragma once
+// perf_hist.h -- per-stage and per-helper latency histograms behind
+// SWFOC_DiagPerf.
+//
+// SWFOC_DiagPipeStats reports one push-to-collect round trip per command,
+// which cannot say whether a slow trainer click sat in the pipe, in the
+// queue or in the engine. The bridge now times each stage of a command
+// separately and every registered SWFOC_* helper call:
+//
+//   * A histogram has PERF_HIST_BUCKETS log2 buckets of nanoseconds: bucket
+//     i counts samples in [2^i, 2^(i+1)) ns (bucket 0 also takes 0 and 1),
+//     the last bucket is open-ended. Next to the buckets it keeps the sample
+//     count, sum and maximum.
+//   * Recording is three relaxed fetch_adds and a CAS loop on the maximum
+//     that only runs for a new maximum. Pipe threads and the main thread
+//     record into the same histograms without a lock; readers tolerate a
+//     slightly torn snapshot, as PipeLatencyHistogram readers already do.
+//   * Percentiles are the upper bound of the bucket holding the rank,
+//     capped at the recorded maximum, so a p99 is at most 2x too high.
+//   * Helper slots are bound to names once, at RegisterAll time, by index
+//     into the registration table; the call trampoline records into the
+//     slot its Lua upvalue names.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#define PERF_HIST_BUCKETS 32    // 2^32 ns ~ 4.3 s before the open bucket
+#define PERF_FUNC_SLOTS   256   // helpers past this run untimed
+#define PERF_JSON_MAX     49152
+#define PERF_JSON_MIN     1024    // stages alone, at their widest
+
+enum PerfStage : uint32_t {
+    PERF_STAGE_PIPE_READ = 0,  // rest of a frame arriving after its first bytes
+    PERF_STAGE_QUEUE_WAIT,     // PipeQueuePush -> main thread pops the slot
+    PERF_STAGE_MAIN_WAIT,      // pipe thread push -> reply collected
+    PERF_STAGE_LUA_COMPILE,    // LoadChunkCached (chunk cache hit or luaL_loadbuffer)
+    PERF_STAGE_LUA_EXEC,       // lua_pcall of the loaded chunk
+    PERF_STAGE_REPLY_WRITE,    // reply WriteFile on the pipe
+    PERF_STAGE_COUNT,
+};
+
+struct PerfHistogram {
+    std::atomic<uint32_t> buckets[PERF_HIST_BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sumNs;
+    std::atomic<uint64_t> maxNs;
+};
+
+struct PerfFuncSlot {
+    const char*           name;   // nullptr = unbound; set before the helper is callable
+    std::atomic<uint64_t> calls;  // entries, including calls that raised a Lua error
+    PerfHistogram         latency;
+};
+
+struct PerfCounters {
+    PerfHistogram stages[PERF_STAGE_COUNT];
+    PerfFuncSlot  funcs[PERF_FUNC_SLOTS];
+};
+
+inline const char* PerfStageName(uint32_t stage) {
+    static const char* const kNames[PERF_STAGE_COUNT] = {
+        "pipe_read", "queue_wait", "main_wait", "lua_compile", "lua_exec", "reply_write",
+    };
+    return stage < PERF_STAGE_COUNT ? kNames[stage] : "unknown";
+}
+
+inline uint32_t PerfBucket(uint64_t ns) {
+    uint32_t b = 0;
+    while (ns > 1 && b < PERF_HIST_BUCKETS - 1) { ns >>= 1; b++; }
+    return b;
+}
+
+inline void PerfRecord(PerfHistogram* h, uint64_t ns) {
+    h->buckets[PerfBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    h->count.fetch_add(1, std::memory_order_relaxed);
+    h->sumNs.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t seen = h->maxNs.load(std::memory_order_relaxed);
+    while (ns > seen && !h->maxNs.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {}
+}
+
+inline void PerfHistReset(PerfHistogram* h) {
+    for (auto& b : h->buckets) b.store(0, std::memory_order_relaxed);
+    h->count.store(0, std::memory_order_relaxed);
+    h->sumNs.store(0, std::memory_order_relaxed);
+    h->maxNs.store(0, std::memory_order_relaxed);
+}
+
+// Upper bound in nanoseconds of the bucket holding the given percentile
+// (0..100), capped at the recorded maximum. 0 when nothing was recorded.
+inline uint64_t PerfPercentile(const PerfHistogram* h, int pct) {
+    uint64_t total = 0;
+    for (const auto& b : h->buckets) total += b.load(std::memory_order_relaxed);
+    if (total == 0) return 0;
+    uint64_t rank = (total * (uint64_t)pct + 99) / 100;
+    if (rank == 0) rank = 1;
+    const uint64_t maxNs = h->maxNs.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < PERF_HIST_BUCKETS; i++) {
+        seen += h->buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            const uint64_t bound = 1ull << (i + 1);
+            return i + 1 < PERF_HIST_BUCKETS && bound < maxNs ? bound : maxNs;
+        }
+    }
+    return maxNs;
+}
+
+// Clears every histogram and call count; helper names stay bound.
+inline void PerfReset(PerfCounters* c) {
+    for (auto& s : c->stages) PerfHistReset(&s);
+    for (auto& f : c->funcs) {
+        f.calls.store(0, std::memory_order_relaxed);
+        PerfHistReset(&f.latency);
+    }
+}
+
+// Binds slot `index` to a helper name. False when the table is full.
+inline bool PerfFuncBind(PerfCounters* c, int index, const char* name) {
+    if (index < 0 || index >= PERF_FUNC_SLOTS) return false;
+    c->funcs[index].name = name;
+    return true;
+}
+
+inline PerfFuncSlot* PerfFuncAt(PerfCounters* c, int index) {
+    return index >= 0 && index < PERF_FUNC_SLOTS && c->funcs[index].name ? &c->funcs[index] : nullptr;
+}
+
+inline bool PerfAppend(char* buf, size_t cap, size_t* off, const char* fmt, ...) {
+    if (*off >= cap) return false;
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(buf + *off, cap - *off, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= cap - *off) {
+        buf[*off] = '\0';  // drop the partial entry
+        return false;
+    }
+    *off += (size_t)n;
+    return true;
+}
+
+inline bool PerfAppendHist(char* buf, size_t cap, size_t* off, const PerfHistogram* h) {
+    const uint64_t n = h->count.load(std::memory_order_relaxed);
+    return PerfAppend(buf, cap, off, "\"n\":%llu,\"mean_ns\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu,\"max_ns\":%llu",
+                      (unsigned long long)n,
+                      (unsigned long long)(n ? h->sumNs.load(std::memory_order_relaxed) / n : 0),
+                      (unsigned long long)PerfPercentile(h, 50),
+                      (unsigned long long)PerfPercentile(h, 99),
+                      (unsigned long long)h->maxNs.load(std::memory_order_relaxed));
+}
+
+// One JSON object:
+//   {"stages":{"pipe_read":{n,mean_ns,p50_ns,p99_ns,max_ns},...},
+//    "functions":{"SWFOC_X":{"calls":c,n,mean_ns,...},...},"truncated":false}
+// Helpers never called are left out. When `cap` runs short the remaining
+// helpers are dropped and "truncated" is true; the object is always closed.
+// Returns the length written (excluding the NUL); 0 when `cap` cannot even
+// hold the stages (PERF_JSON_MIN).
+inline size_t PerfFormatJson(const PerfCounters* c, char* buf, size_t cap) {
+    static const char kTail[] = "},\"truncated\":true}";
+    if (cap < PERF_JSON_MIN) {
+        if (cap) buf[0] = '\0';
+        return 0;
+    }
+    const size_t room = cap - sizeof(kTail);  // always leave space to close the object
+    size_t off = 0;
+    bool ok = PerfAppend(buf, room, &off, "{\"stages\":{");
+    for (uint32_t s = 0; ok && s < PERF_STAGE_COUNT; s++) {
+        ok = PerfAppend(buf, room, &off, "%s\"%s\":{", s ? "," : "", PerfStageName(s)) &&
+             PerfAppendHist(buf, room, &off, &c->stages[s]) &&
+             PerfAppend(buf, room, &off, "}");
+    }
+    ok = ok && PerfAppend(buf, room, &off, "},\"functions\":{");
+    bool first = true;
+    for (uint32_t i = 0; ok && i < PERF_FUNC_SLOTS; i++) {
+        const PerfFuncSlot* f = &c->funcs[i];
+        const uint64_t calls = f->calls.load(std::memory_order_relaxed);
+        if (!f->name || calls == 0) continue;
+        const size_t mark = off;
+        ok = PerfAppend(buf, room, &off, "%s\"%s\":{\"calls\":%llu,", first ? "" : ",", f->name,
+                        (unsigned long long)calls) &&
+             PerfAppendHist(buf, room, &off, &f->latency) &&
+             PerfAppend(buf, room, &off, "}");
+        if (!ok) {
+            off = mark;
+            buf[off] = '\0';
+        }
+        first = false;
+    }
+    PerfAppend(buf, cap, &off, ok ? "},\"truncated\":false}" : kTail);
+    return off;
+}
@@ -0,0 +1,640 @@
+// pipe_loadgen.cpp -- end-to-end load generator for the bridge command pipe.
+//
+// Drives \\.\pipe\swfoc_bridge (the live bridge) or swfoc_replay.exe's
+// \\.\pipe\swfoc_bridge_replay with N concurrent clients and reports what a
+// client sees: sustained commands/sec, latency percentiles and how often
+// the bridge refused or dropped work. Run it against swfoc_replay.exe to
+// compare transport changes without the game; run it against the live
+// bridge to see the real main-thread drain.
+//
+//   * Mixes are weighted command lists. "hud" is the overlay HUD's probe
+//     set (hud_state.cpp), "actions" bursts of multiplier writes with a
+//     pause between bursts, "editor" the enumerate-heavy unit-grid polling.
+//     --mix-file replaces them: one Lua chunk per line, repeat a line to
+//     weight it, '#' starts a comment. The built-in mixes call live-bridge
+//     helpers; swfoc_replay.exe registers a subset (SWFOC_GetCredits,
+//     SWFOC_StateInfo, the SWFOC_Replay* set) and the rest come back as
+//     errors, so give it a --mix-file.
+//   * Transports follow pipe_protocol.h: "oneshot" opens a connection per
+//     command (the legacy dialect every client speaks), "persist" keeps one
+//     "@persist" session per client, "batch:N" sends N commands per
+//     "@batch N" frame on a persistent session. swfoc_replay.exe only
+//     speaks oneshot.
+//   * Latency is measured per request: connect + write + reply for oneshot,
+//     write + reply otherwise; a batch is one sample. With --rate the
+//     latency of each request is taken from when it was scheduled, not from
+//     when a late client finally sent it, so a stalled bridge shows up in
+//     the tail instead of being hidden by the pause.
+//   * Replies are sorted with PipeClassifyReply: "queue full" rejections
+//     and bridge-side timeouts are counted apart from Lua / helper errors.
+//     I/O failures (connect, write, read, client-side timeout) are counted
+//     separately and carry no latency sample.
+//
+// Build:
+//   x86_64-w64-mingw32-g++ -O2 -std=c++17 -DWIN32_LEAN_AND_MEAN -I. -static
+//       -o pipe_loadgen.exe pipe_loadgen.cpp
+// (or build_pipe_loadgen.bat).
+//
+// Usage:
+//   pipe_loadgen.exe [--pipe live|replay|<name>] [--clients N]
+//                    [--duration S] [--warmup S] [--mix hud|actions|editor]
+//                    [--mix-file <path>] [--transport oneshot|persist|batch:N]
+//                    [--rate R] [--think MS] [--timeout MS]
+//                    [--format text|jsonl] [--instance <tag>]
+//
+// --instance targets the tagged server (instance_names.h): live and replay
+// become \\.\pipe\swfoc_bridge_<tag> and \\.\pipe\swfoc_bridge_replay_<tag>.
+// `swfoc_replay.exe --list-instances` shows the tags that are up.
+//
+// jsonl prints one "summary" record and one "command" record per mix line.
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include "instance_names.h"
+#include "pipe_protocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define LOADGEN_LIVE_PIPE   "\\\\.\\pipe\\swfoc_bridge"         // PIPE_NAME in lua_bridge.cpp
+#define LOADGEN_REPLAY_PIPE "\\\\.\\pipe\\swfoc_bridge_replay"  // REPLAY_PIPE_NAME in replay_harness.cpp
+#define LOADGEN_REPLY_MAX   (256 * 1024)
+
+// ======================================================================
+// Command mixes
+// ======================================================================
+
+struct MixEntry {
+    const char* lua;
+    int         weight;
+};
+
+// hud_state.cpp's probe set, in the same proportions (one of each per poll).
+static const MixEntry kHudMix[] = {
+    {"return SWFOC_GetLocalPlayer()", 1},
+    {"local s = SWFOC_GetLocalPlayer() if s and s >= 0 then return SWFOC_GetCredits(s) end", 1},
+    {"local s = SWFOC_GetLocalPlayer() if s and s >= 0 then return SWFOC_CountUnits(s) end", 1},
+    {"return SWFOC_GetCurrentScene()", 1},
+    {"return SWFOC_GetDamageMultiplierGlobal()", 1},
+    {"return SWFOC_GetFireRateMultiplierGlobal()", 1},
+    {"return SWFOC_GetPlayerKills()", 1},
+    {"return SWFOC_GetPlayerDeaths()", 1},
+    {"return SWFOC_GetTotalUnitsAlive()", 1},
+    {"return SWFOC_ListTacticalUnits(\"bin\")", 1},
+};
+
+// Trainer clicks: writes that leave the game as it was (neutral values).
+static const MixEntry kActionMix[] = {
+    {"return SWFOC_SetDamageMultiplierGlobal(1.0)", 3},
+    {"return SWFOC_SetFireRateMultiplierGlobal(1.0)", 3},
+    {"return SWFOC_SetIncomeMultiplier(-1, 1.0)", 2},
+    {"return SWFOC_GodMode(0)", 1},
+    {"return SWFOC_GetSelectedUnits()", 1},
+};
+
+// Unit editor grid: full lists, per-slot lists and delta polls.
+static const MixEntry kEditorMix[] = {
+    {"return SWFOC_ListTacticalUnits()", 2},
+    {"return SWFOC_EnumerateUnits(0)", 2},
+    {"return SWFOC_EnumerateUnits(1)", 2},
+    {"return SWFOC_EnumerateUnitsDelta(-1, 0)", 1},
+    {"return SWFOC_GetSelectedUnits()", 1},
+};
+
+struct MixSpec {
+    const char*     name;
+    const MixEntry* entries;
+    size_t          count;
+    int             burst;    // commands sent back to back before thinking
+    int             thinkMs;  // pause after each burst
+};
+
+static const MixSpec kMixes[] = {
+    {"hud",     kHudMix,    sizeof(kHudMix) / sizeof(kHudMix[0]),       1, 0},
+    {"actions", kActionMix, sizeof(kActionMix) / sizeof(kActionMix[0]), 8, 200},
+    {"editor",  kEditorMix, sizeof(kEditorMix) / sizeof(kEditorMix[0]), 1, 0},
+};
+
+// The mix a run draws from: one string per mix line, and a pick table in
+// which each line appears `weight` times.
+struct Mix {
+    std::string              name;
+    std::vector<std::string> lines;
+    std::vector<uint32_t>    picks;
+    int                      burst = 1;
+    int                      thinkMs = 0;
+};
+
+static void MixAdd(Mix* m, const std::string& lua, int weight) {
+    for (size_t i = 0; i < m->lines.size(); i++) {
+        if (m->lines[i] == lua) {
+            for (int w = 0; w < weight; w++) m->picks.push_back((uint32_t)i);
+            return;
+        }
+    }
+    m->lines.push_back(lua);
+    for (int w = 0; w < weight; w++) m->picks.push_back((uint32_t)(m->lines.size() - 1));
+}
+
+static bool MixFromFile(Mix* m, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        size_t n = strlen(line);
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' || line[n - 1] == ' ')) line[--n] = '\0';
+        const char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (!*p || *p == '#') continue;
+        MixAdd(m, p, 1);
+    }
+    fclose(f);
+    m->name = path;
+    return !m->lines.empty();
+}
+
+// ======================================================================
+// Statistics
+// ======================================================================
+
+struct CommandStats {
+    uint64_t              sent = 0;
+    uint64_t              classes[4] = {};  // PipeReplyClass
+    std::vector<uint32_t> latencyUs;
+};
+
+struct ClientStats {
+    std::vector<CommandStats> perCommand;  // indexed like Mix::lines
+    std::vector<uint32_t>     latencyUs;   // every request (a batch counts once)
+    uint64_t                  ioFailures = 0;
+    uint64_t                  busyWaits = 0;   // ERROR_PIPE_BUSY on connect
+    uint64_t                  reconnects = 0;  // persistent sessions reopened
+};
+
+static uint32_t Percentile(const std::vector<uint32_t>& sorted, double pct) {
+    if (sorted.empty()) return 0;
+    size_t rank = (size_t)(pct / 100.0 * (double)sorted.size());
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+    return sorted[rank];
+}
+
+// ======================================================================
+// Pipe client
+// ======================================================================
+
+struct LoadConfig {
+    const char* pipe = LOADGEN_LIVE_PIPE;
+    int         clients = 4;
+    double      durationS = 10.0;
+    double      warmupS = 1.0;
+    int         batch = 0;  // 0 = no batching
+    bool        persist = false;
+    double      rate = 0.0;  // per client, 0 = closed loop
+    int         thinkMs = -1;  // -1 = the mix's own
+    DWORD       timeoutMs = 15000;  // above the bridge's 10 s main-thread wait
+};
+
+struct PipeConn {
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+    HANDLE event = nullptr;
+    bool   message = false;  // message read mode took (the live bridge's pipe type)
+};
+
+static void ConnClose(PipeConn* c) {
+    if (c->pipe != INVALID_HANDLE_VALUE) CloseHandle(c->pipe);
+    c->pipe = INVALID_HANDLE_VALUE;
+}
+
+// Waits for an overlapped ReadFile / WriteFile. Returns ERROR_SUCCESS,
+// ERROR_MORE_DATA, WAIT_TIMEOUT (I/O cancelled) or the failing error.
+static DWORD AwaitIo(PipeConn* c, OVERLAPPED* ov, BOOL started, ULONGLONG deadline, DWORD* bytes) {
+    *bytes = 0;
+    if (!started) {
+        const DWORD err = GetLastError();
+        if (err != ERROR_IO_PENDING) return err;
+        const ULONGLONG now = GetTickCount64();
+        if (WaitForSingleObject(ov->hEvent, now < deadline ? (DWORD)(deadline - now) : 0) != WAIT_OBJECT_0) {
+            CancelIo(c->pipe);
+            GetOverlappedResult(c->pipe, ov, bytes, TRUE);
+            return WAIT_TIMEOUT;
+        }
+    }
+    if (!GetOverlappedResult(c->pipe, ov, bytes, FALSE)) return GetLastError();
+    return ERROR_SUCCESS;
+}
+
+static bool ConnOpen(PipeConn* c, const char* name, ULONGLONG deadline, ClientStats* st) {
+    if (!c->event) c->event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!c->event) return false;
+    for (;;) {
+        c->pipe = CreateFileA(name, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_OVERLAPPED, nullptr);
+        if (c->pipe != INVALID_HANDLE_VALUE) break;
+        const ULONGLONG now = GetTickCount64();
+        if (GetLastError() != ERROR_PIPE_BUSY || now >= deadline) return false;
+        st->busyWaits++;
+        WaitNamedPipeA(name, (DWORD)std::min<ULONGLONG>(deadline - now, 1000));
+    }
+    DWORD mode = PIPE_READMODE_MESSAGE;
+    c->message = SetNamedPipeHandleState(c->pipe, &mode, nullptr, nullptr) != FALSE;
+    return true;
+}
+
+static bool ConnWrite(PipeConn* c, const std::string& data, ULONGLONG deadline) {
+    OVERLAPPED ov = {};
+    ov.hEvent = c->event;
+    ResetEvent(c->event);
+    const BOOL ok = WriteFile(c->pipe, data.data(), (DWORD)data.size(), nullptr, &ov);
+    DWORD written = 0;
+    return AwaitIo(c, &ov, ok, deadline, &written) == ERROR_SUCCESS && written == data.size();
+}
+
+// Reads one reply. In message mode that is one message; in byte mode the
+// server's disconnect ends it (oneshot only).
+static bool ConnRead(PipeConn* c, std::string* reply, ULONGLONG deadline) {
+    reply->clear();
+    static thread_local char buf[16384];
+    for (;;) {
+        OVERLAPPED ov = {};
+        ov.hEvent = c->event;
+        ResetEvent(c->event);
+        const BOOL ok = ReadFile(c->pipe, buf, sizeof(buf), nullptr, &ov);
+        DWORD got = 0;
+        const DWORD err = AwaitIo(c, &ov, ok, deadline, &got);
+        reply->append(buf, got);
+        if (reply->size() > LOADGEN_REPLY_MAX) return false;
+        if (err == ERROR_MORE_DATA) continue;
+        if (err == ERROR_SUCCESS) {
+            if (c->message) return true;
+            continue;
+        }
+        // Byte mode: the one-shot server hangs up after its reply.
+        return err == ERROR_BROKEN_PIPE && !c->message && !reply->empty();
+    }
+}
+
+static bool ConnStartSession(PipeConn* c, const LoadConfig& cfg, ClientStats* st) {
+    const ULONGLONG deadline = GetTickCount64() + cfg.timeoutMs;
+    if (!ConnOpen(c, cfg.pipe, deadline, st)) return false;
+    std::string ack;
+    if (!c->message || !ConnWrite(c, PIPE_DIRECTIVE_PERSIST "\n", deadline) || !ConnRead(c, &ack, deadline) ||
+        ack != "OK\n") {
+        ConnClose(c);
+        return false;
+    }
+    return true;
+}
+
+// ======================================================================
+// Workers
+// ======================================================================
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<bool> g_sessionRefused{false};
+
+static void Account(ClientStats* st, uint32_t cmd, PipeReplyClass cls, bool record, uint32_t us) {
+    CommandStats& cs = st->perCommand[cmd];
+    cs.sent++;
+    cs.classes[cls]++;
+    if (record) cs.latencyUs.push_back(us);
+}
+
+static void RunClient(int id, const LoadConfig& cfg, const Mix& mix, Clock::time_point start, ClientStats* st) {
+    st->perCommand.resize(mix.lines.size());
+    const Clock::time_point measureFrom = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(cfg.warmupS));
+    const Clock::time_point stopAt = measureFrom + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(cfg.durationS));
+    const int thinkMs = cfg.thinkMs >= 0 ? cfg.thinkMs : mix.thinkMs;
+    const int perRequest = cfg.batch > 0 ? cfg.batch : 1;
+    const Clock::duration interval = cfg.rate > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(perRequest / cfg.rate))
+        : Clock::duration::zero();
+
+    uint64_t rng = 0x9E3779B97F4A7C15ull * (uint64_t)(id + 1);
+    auto pick = [&rng, &mix]() {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return mix.picks[(size_t)(rng % mix.picks.size())];
+    };
+
+    PipeConn conn;
+    bool opened = false;
+    Clock::time_point scheduled = start;
+    int inBurst = 0;
+    std::vector<uint32_t> cmds((size_t)perRequest);
+    std::string request, reply;
+
+    while (Clock::now() < stopAt) {
+        if (cfg.rate > 0.0) {
+            scheduled += interval;
+            std::this_thread::sleep_until(scheduled);
+        } else {
+            scheduled = Clock::now();
+        }
+        if (Clock::now() >= stopAt) break;
+
+        for (int i = 0; i < perRequest; i++) cmds[(size_t)i] = pick();
+        const ULONGLONG deadline = GetTickCount64() + cfg.timeoutMs;
+        bool io = false;
+
+        if (!cfg.persist) {
+            request = mix.lines[cmds[0]];
+            request.push_back('\0');
+            io = ConnOpen(&conn, cfg.pipe, deadline, st) && ConnWrite(&conn, request, deadline) &&
+                 ConnRead(&conn, &reply, deadline);
+            ConnClose(&conn);
+        } else {
+            if (conn.pipe == INVALID_HANDLE_VALUE) {
+                if (!ConnStartSession(&conn, cfg, st)) {
+                    g_sessionRefused.store(true);
+                    if (Clock::now() >= measureFrom) st->ioFailures++;
+                    Sleep(100);
+                    continue;
+                }
+                if (opened) st->reconnects++;
+                opened = true;
+            }
+            request.clear();
+            if (cfg.batch > 0) {
+                char head[32];
+                snprintf(head, sizeof(head), PIPE_DIRECTIVE_BATCH " %d\n", cfg.batch);
+                request = head;
+            }
+            for (int i = 0; i < perRequest; i++) {
+                request += mix.lines[cmds[(size_t)i]];
+                request.push_back('\n');
+            }
+            io = ConnWrite(&conn, request, deadline) && ConnRead(&conn, &reply, deadline);
+            if (!io) ConnClose(&conn);
+        }
+
+        const Clock::time_point done = Clock::now();
+        const bool record = scheduled >= measureFrom && done < stopAt;
+        if (!io) {
+            if (record) st->ioFailures++;
+            continue;
+        }
+        const uint32_t us = (uint32_t)std::min<int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(done - scheduled).count(), UINT32_MAX);
+        if (record) st->latencyUs.push_back(us);
+
+        size_t pos = 0;
+        const uint32_t entries = cfg.batch > 0 ? PipeBatchHeaderCount(reply.data(), reply.size(), &pos) : 0;
+        if (cfg.batch > 0 && entries == (uint32_t)cfg.batch) {
+            for (int i = 0; i < perRequest; i++) {
+                bool ok = false;
+                const char* payload = nullptr;
+                size_t plen = 0;
+                PipeReplyClass cls = PIPE_REPLY_ERROR;  // malformed entry
+                if (PipeBatchNext(reply.data(), reply.size(), &pos, &ok, &payload, &plen)) {
+                    cls = ok ? PIPE_REPLY_OK : PipeClassifyReply(payload, plen);
+                    if (!ok && cls == PIPE_REPLY_OK) cls = PIPE_REPLY_ERROR;
+                }
+                if (record) Account(st, cmds[(size_t)i], cls, true, us);
+            }
+        } else if (record) {
+            // A text reply, or one "ERR: ..." line for a whole batch.
+            const PipeReplyClass cls = PipeClassifyReply(reply.data(), reply.size());
+            for (int i = 0; i < perRequest; i++) Account(st, cmds[(size_t)i], cls, true, us);
+        }
+
+        if (thinkMs > 0 && ++inBurst >= mix.burst) {
+            inBurst = 0;
+            Sleep((DWORD)thinkMs);
+        }
+    }
+    ConnClose(&conn);
+    if (conn.event) CloseHandle(conn.event);
+}
+
+// ======================================================================
+// Report
+// ======================================================================
+
+static const char* TransportName(const LoadConfig& cfg, char* buf, size_t cap) {
+    if (cfg.batch > 0) snprintf(buf, cap, "batch:%d", cfg.batch);
+    else snprintf(buf, cap, "%s", cfg.persist ? "persist" : "oneshot");
+    return buf;
+}
+
+static void Report(const LoadConfig& cfg, const Mix& mix, std::vector<ClientStats>& clients, bool jsonl) {
+    ClientStats total;
+    total.perCommand.resize(mix.lines.size());
+    for (auto& c : clients) {
+        total.latencyUs.insert(total.latencyUs.end(), c.latencyUs.begin(), c.latencyUs.end());
+        total.ioFailures += c.ioFailures;
+        total.busyWaits += c.busyWaits;
+        total.reconnects += c.reconnects;
+        for (size_t i = 0; i < mix.lines.size() && i < c.perCommand.size(); i++) {
+            CommandStats& dst = total.perCommand[i];
+            const CommandStats& src = c.perCommand[i];
+            dst.sent += src.sent;
+            for (int k = 0; k < 4; k++) dst.classes[k] += src.classes[k];
+            dst.latencyUs.insert(dst.latencyUs.end(), src.latencyUs.begin(), src.latencyUs.end());
+        }
+    }
+    std::sort(total.latencyUs.begin(), total.latencyUs.end());
+    uint64_t sent = 0, classes[4] = {};
+    for (auto& cs : total.perCommand) {
+        sent += cs.sent;
+        for (int k = 0; k < 4; k++) classes[k] += cs.classes[k];
+        std::sort(cs.latencyUs.begin(), cs.latencyUs.end());
+    }
+    const double perSec = cfg.durationS > 0 ? (double)sent / cfg.durationS : 0.0;
+    const double okPerSec = cfg.durationS > 0 ? (double)classes[PIPE_REPLY_OK] / cfg.durationS : 0.0;
+    auto pct = [sent](uint64_t n) { return sent ? 100.0 * (double)n / (double)sent : 0.0; };
+    const std::vector<uint32_t>& lat = total.latencyUs;
+    char transport[32];
+    TransportName(cfg, transport, sizeof(transport));
+
+    if (jsonl) {
+        printf("{\"type\":\"summary\",\"pipe\":\"%s\",\"mix\":\"%s\",\"transport\":\"%s\",\"clients\":%d,"
+               "\"duration_s\":%.1f,\"rate\":%.1f,\"commands\":%llu,\"commands_per_s\":%.1f,\"ok_per_s\":%.1f,"
+               "\"ok\":%llu,\"queue_full\":%llu,\"bridge_timeouts\":%llu,\"errors\":%llu,\"io_failures\":%llu,"
+               "\"busy_waits\":%llu,\"reconnects\":%llu,\"queue_full_pct\":%.3f,\"requests\":%zu,\"p50_us\":%u,\"p90_us\":%u,"
+               "\"p99_us\":%u,\"p999_us\":%u,\"max_us\":%u}\n",
+               cfg.pipe[0] == '\\' ? strrchr(cfg.pipe, '\\') + 1 : cfg.pipe, mix.name.c_str(), transport,
+               cfg.clients, cfg.durationS, cfg.rate, (unsigned long long)sent, perSec, okPerSec,
+               (unsigned long long)classes[PIPE_REPLY_OK], (unsigned long long)classes[PIPE_REPLY_REJECTED],
+               (unsigned long long)classes[PIPE_REPLY_TIMED_OUT], (unsigned long long)classes[PIPE_REPLY_ERROR],
+               (unsigned long long)total.ioFailures, (unsigned long long)total.busyWaits,
+               (unsigned long long)total.reconnects, pct(classes[PIPE_REPLY_REJECTED]), lat.size(), Percentile(lat, 50), Percentile(lat, 90),
+               Percentile(lat, 99), Percentile(lat, 99.9), lat.empty() ? 0 : lat.back());
+        for (size_t i = 0; i < mix.lines.size(); i++) {
+            const CommandStats& cs = total.perCommand[i];
+            std::string lua;
+            for (char ch : mix.lines[i]) {
+                if (ch == '"' || ch == '\\') lua.push_back('\\');
+                lua.push_back(ch);
+            }
+            printf("{\"type\":\"command\",\"lua\":\"%s\",\"sent\":%llu,\"ok\":%llu,\"queue_full\":%llu,"
+                   "\"bridge_timeouts\":%llu,\"errors\":%llu,\"p50_us\":%u,\"p99_us\":%u}\n",
+                   lua.c_str(), (unsigned long long)cs.sent, (unsigned long long)cs.classes[PIPE_REPLY_OK],
+                   (unsigned long long)cs.classes[PIPE_REPLY_REJECTED],
+                   (unsigned long long)cs.classes[PIPE_REPLY_TIMED_OUT],
+                   (unsigned long long)cs.classes[PIPE_REPLY_ERROR], Percentile(cs.latencyUs, 50),
+                   Percentile(cs.latencyUs, 99));
+        }
+        return;
+    }
+
+    printf("=== Pipe load: %s mix, %s, %d clients, %.1f s after %.1f s warm-up (%s) ===\n", mix.name.c_str(),
+           transport, cfg.clients, cfg.durationS, cfg.warmupS, cfg.pipe);
+    printf("  commands        %10llu  %9.1f/s sustained (%.1f/s OK)\n", (unsigned long long)sent, perSec, okPerSec);
+    printf("  ok              %10llu  %6.2f%%\n", (unsigned long long)classes[PIPE_REPLY_OK], pct(classes[PIPE_REPLY_OK]));
+    printf("  queue full      %10llu  %6.2f%%\n", (unsigned long long)classes[PIPE_REPLY_REJECTED],
+           pct(classes[PIPE_REPLY_REJECTED]));
+    printf("  bridge timeout  %10llu  %6.2f%%\n", (unsigned long long)classes[PIPE_REPLY_TIMED_OUT],
+           pct(classes[PIPE_REPLY_TIMED_OUT]));
+    printf("  errors          %10llu  %6.2f%%\n", (unsigned long long)classes[PIPE_REPLY_ERROR],
+           pct(classes[PIPE_REPLY_ERROR]));
+    printf("  io failures     %10llu\n", (unsigned long long)total.ioFailures);
+    printf("  pipe busy waits %10llu\n", (unsigned long long)total.busyWaits);
+    if (cfg.persist) printf("  reconnects      %10llu\n", (unsigned long long)total.reconnects);
+    printf("  latency us (%zu requests): p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n", lat.size(),
+           Percentile(lat, 50), Percentile(lat, 90), Percentile(lat, 99), Percentile(lat, 99.9),
+           lat.empty() ? 0 : lat.back());
+    printf("  per command (sent / queue full / errors, p50 / p99 us):\n");
+    for (size_t i = 0; i < mix.lines.size(); i++) {
+        const CommandStats& cs = total.perCommand[i];
+        printf("    %8llu %6llu %6llu %8u %8u  %.60s\n", (unsigned long long)cs.sent,
+               (unsigned long long)cs.classes[PIPE_REPLY_REJECTED], (unsigned long long)cs.classes[PIPE_REPLY_ERROR],
+               Percentile(cs.latencyUs, 50), Percentile(cs.latencyUs, 99), mix.lines[i].c_str());
+    }
+}
+
+// ======================================================================
+// main
+// ======================================================================
+
+static int Usage(const char* argv0) {
+    fprintf(stderr,
+            "usage: %s [--pipe live|replay|<name>] [--clients N] [--duration S] [--warmup S]\n"
+            "          [--mix hud|actions|editor] [--mix-file <path>] [--transport oneshot|persist|batch:N]\n"
+            "          [--rate R] [--think MS] [--timeout MS] [--format text|jsonl] [--instance <tag>]\n",
+            argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    LoadConfig cfg;
+    const char* mixName = "hud";
+    const char* mixFile = nullptr;
+    bool jsonl = false;
+    const char* instanceTag = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!v) return Usage(argv[0]);
+        i++;
+        if (strcmp(a, "--pipe") == 0) {
+            cfg.pipe = strcmp(v, "live") == 0 ? LOADGEN_LIVE_PIPE : strcmp(v, "replay") == 0 ? LOADGEN_REPLAY_PIPE : v;
+        } else if (strcmp(a, "--clients") == 0) {
+            cfg.clients = atoi(v);
+        } else if (strcmp(a, "--duration") == 0) {
+            cfg.durationS = atof(v);
+        } else if (strcmp(a, "--warmup") == 0) {
+            cfg.warmupS = atof(v);
+        } else if (strcmp(a, "--mix") == 0) {
+            mixName = v;
+        } else if (strcmp(a, "--mix-file") == 0) {
+            mixFile = v;
+        } else if (strcmp(a, "--transport") == 0) {
+            if (strcmp(v, "oneshot") == 0) {
+                cfg.persist = false;
+            } else if (strcmp(v, "persist") == 0) {
+                cfg.persist = true;
+            } else if (strncmp(v, "batch:", 6) == 0) {
+                cfg.persist = true;
+                cfg.batch = atoi(v + 6);
+                if (cfg.batch < 1 || cfg.batch > PIPE_BATCH_MAX) {
+                    fprintf(stderr, "batch size must be 1..%d\n", PIPE_BATCH_MAX);
+                    return 2;
+                }
+            } else {
+                return Usage(argv[0]);
+            }
+        } else if (strcmp(a, "--rate") == 0) {
+            cfg.rate = atof(v);
+        } else if (strcmp(a, "--think") == 0) {
+            cfg.thinkMs = atoi(v);
+        } else if (strcmp(a, "--timeout") == 0) {
+            cfg.timeoutMs = (DWORD)atoi(v);
+        } else if (strcmp(a, "--format") == 0) {
+            if (strcmp(v, "jsonl") == 0) jsonl = true;
+            else if (strcmp(v, "text") != 0) return Usage(argv[0]);
+        } else if (strcmp(a, "--instance") == 0) {
+            // The server's tag, not "pid": our PID names no server.
+            if (!InstanceTagValid(v)) {
+                fprintf(stderr, "--instance requires 1..%d of [A-Za-z0-9_-]\n", INSTANCE_TAG_MAX - 1);
+                return 2;
+            }
+            instanceTag = v;
+        } else {
+            return Usage(argv[0]);
+        }
+    }
+    if (cfg.clients < 1 || cfg.clients > 256 || cfg.durationS <= 0.0 || cfg.warmupS < 0.0) return Usage(argv[0]);
+    static char instancePipe[INSTANCE_NAME_MAX];
+    if (instanceTag) {
+        if (strcmp(cfg.pipe, LOADGEN_LIVE_PIPE) != 0 && strcmp(cfg.pipe, LOADGEN_REPLAY_PIPE) != 0) {
+            fprintf(stderr, "--instance takes --pipe live or replay, not a full pipe name\n");
+            return 2;
+        }
+        InstanceName(cfg.pipe, instanceTag, instancePipe, sizeof(instancePipe));
+        cfg.pipe = instancePipe;
+    }
+
+    Mix mix;
+    if (mixFile) {
+        if (!MixFromFile(&mix, mixFile)) {
+            fprintf(stderr, "cannot read a command from %s\n", mixFile);
+            return 2;
+        }
+    } else {
+        const MixSpec* spec = nullptr;
+        for (const auto& m : kMixes) {
+            if (strcmp(m.name, mixName) == 0) spec = &m;
+        }
+        if (!spec) return Usage(argv[0]);
+        mix.name = spec->name;
+        mix.burst = spec->burst;
+        mix.thinkMs = spec->thinkMs;
+        for (size_t i = 0; i < spec->count; i++) MixAdd(&mix, spec->entries[i].lua, spec->entries[i].weight);
+    }
+    if (cfg.persist) {
+        for (const auto& line : mix.lines) {
+            if (line.find('\n') != std::string::npos) {
+                fprintf(stderr, "persistent sessions are newline-framed; use oneshot for multi-line chunks\n");
+                return 2;
+            }
+        }
+    }
+
+    std::vector<ClientStats> stats((size_t)cfg.clients);
+    std::vector<std::thread> threads;
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < cfg.clients; i++) {
+        threads.emplace_back(RunClient, i, std::cref(cfg), std::cref(mix), start, &stats[(size_t)i]);
+    }
+    for (auto& t : threads) t.join();
+
+    Report(cfg, mix, stats, jsonl);
+    if (g_sessionRefused.load()) {
+        fprintf(stderr, "note: some \"@persist\" sessions could not be opened (server down or one-shot only)\n");
+    }
+    return 0;
+}
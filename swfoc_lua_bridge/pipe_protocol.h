@@ -0,0 +1,228 @@
+#pragma once
+// pipe_protocol.h -- framing rules for the \\.\pipe\swfoc_bridge command pipe.
+//
+// The listener in lua_bridge.cpp speaks two dialects on the same pipe name:
+//
+//   * Legacy one-shot (default): the client writes one Lua chunk, optionally
+//     NUL-terminated, in a single WriteFile, reads the reply and the server
+//     disconnects. bridge/*.py, the PowerShell scripts and the overlay HUD
+//     all depend on this, so it is what every connection gets unless the
+//     first frame opts out.
+//   * Persistent: the first frame is the "@persist" directive. The server
+//     acks with "OK\n" and then answers one reply per frame on the same
+//     connection until the client hangs up. Frames end at '\n' or NUL
+//     ("@persist") or at NUL only ("@persist nul", for multi-line chunks).
+//     Empty frames are skipped so "cmd\n\0" or CRLF endings do not produce
+//     stray replies.
+//   * Batch: an "@batch N" frame (one-shot or inside a persistent session)
+//     is followed by N chunk frames. All N run back to back in one main-thread
+//     drain pass and come back as a single length-prefixed reply:
+//         "@batch N\n" then per chunk "OK <len>\n<len bytes>" or
+//         "ERR <len>\n<len bytes>"
+//     Payloads carry no trailing newline; a nil result is an empty OK
+//     payload. One-shot batches use newline framing unless the directive is
+//     "@batch N nul".
+//   * Telemetry: an "@telemetry" frame (one-shot or persistent) is answered
+//     straight from the pipe thread with one binary PipeTelemetry record --
+//     no queue slot, no Lua. Fields are little-endian (x86) and the record
+//     starts with PIPE_TELEMETRY_MAGIC, so a client can tell it from an
+//     "ERR: ..." text reply by an older bridge.
+//
+// '@' can never start a valid Lua chunk, so directives cannot collide with
+// commands. Keep this header header-only and Win32-free so test_harness.cpp
+// can pin the framing rules without a live pipe.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#define PIPE_DIRECTIVE_PREFIX  '@'
+#define PIPE_DIRECTIVE_PERSIST "@persist"
+#define PIPE_DIRECTIVE_BATCH   "@batch"
+#define PIPE_BATCH_MAX         64
+#define PIPE_DIRECTIVE_TELEMETRY "@telemetry"
+#define PIPE_TELEMETRY_MAGIC   0x4D545753u  // "SWTM" little-endian
+#define PIPE_TELEMETRY_VERSION 1
+
+// Text replies the pipe thread sends when a command never reached Lua.
+// Clients (pipe_loadgen.cpp) match on these prefixes; keep them stable.
+#define PIPE_REPLY_QUEUE_FULL  "ERR: queue full"
+#define PIPE_REPLY_TIMEOUT     "ERR: timeout"
+
+// Reply to "@telemetry". Append-only: bump PIPE_TELEMETRY_VERSION and grow
+// `size` when adding fields so version-1 readers keep working. Unknown
+// values use the same sentinels as the Lua getters (-1 slot, 0 counts).
+#pragma pack(push, 1)
+struct PipeTelemetry {
+    uint32_t magic;         // PIPE_TELEMETRY_MAGIC
+    uint16_t version;       // PIPE_TELEMETRY_VERSION
+    uint16_t size;          // sizeof(PipeTelemetry)
+    int32_t  localSlot;     // -1 when no local player
+    float    credits;       // local player's credits
+    int32_t  unitsAlive;    // SWFOC_GetTotalUnitsAlive
+    int32_t  kills;         // SWFOC_GetPlayerKills
+    int32_t  deaths;        // SWFOC_GetPlayerDeaths
+    float    damageMult;    // SWFOC_GetDamageMultiplierGlobal
+    float    fireRateMult;  // SWFOC_GetFireRateMultiplierGlobal
+    uint32_t reserved;      // 0; keeps the tick fields 8-aligned
+    int64_t  tick;          // luaD_call tick when the reply was built
+    int64_t  sampleTick;    // luaD_call tick when slot/credits/units were sampled
+};
+#pragma pack(pop)
+static_assert(sizeof(PipeTelemetry) == 56, "PipeTelemetry wire layout changed");
+
+// True when the frame is a control directive rather than a Lua chunk.
+inline bool PipeIsDirective(const char* frame, size_t len) {
+    return len > 0 && frame[0] == PIPE_DIRECTIVE_PREFIX;
+}
+
+// Parses "@persist" / "@persist nul". On success sets *nulOnly to whether
+// frames are NUL-terminated only. Trailing whitespace is ignored.
+inline bool PipeParsePersist(const char* frame, size_t len, bool* nulOnly) {
+    const size_t n = sizeof(PIPE_DIRECTIVE_PERSIST) - 1;
+    if (len < n || memcmp(frame, PIPE_DIRECTIVE_PERSIST, n) != 0) return false;
+    while (len > n && (frame[len - 1] == ' ' || frame[len - 1] == '\t' || frame[len - 1] == '\r'))
+        len--;
+    if (len == n) { *nulOnly = false; return true; }
+    if (len == n + 4 && memcmp(frame + n, " nul", 4) == 0) { *nulOnly = true; return true; }
+    return false;
+}
+
+// True for "@telemetry" (trailing whitespace ignored).
+inline bool PipeIsTelemetry(const char* frame, size_t len) {
+    const size_t n = sizeof(PIPE_DIRECTIVE_TELEMETRY) - 1;
+    if (len < n || memcmp(frame, PIPE_DIRECTIVE_TELEMETRY, n) != 0) return false;
+    while (len > n && (frame[len - 1] == ' ' || frame[len - 1] == '\t' || frame[len - 1] == '\r'))
+        len--;
+    return len == n;
+}
+
+// Parses "@batch N" / "@batch N nul" with 1 <= N <= PIPE_BATCH_MAX.
+// *nulOnly is only set when the "nul" suffix is present.
+inline bool PipeParseBatch(const char* frame, size_t len, uint32_t* count, bool* nulOnly) {
+    const size_t n = sizeof(PIPE_DIRECTIVE_BATCH) - 1;
+    if (len <= n + 1 || memcmp(frame, PIPE_DIRECTIVE_BATCH, n) != 0 || frame[n] != ' ') return false;
+    while (len > n && (frame[len - 1] == ' ' || frame[len - 1] == '\t' || frame[len - 1] == '\r'))
+        len--;
+    size_t i = n + 1;
+    uint32_t value = 0;
+    size_t digits = 0;
+    while (i < len && frame[i] >= '0' && frame[i] <= '9' && digits < 4) {
+        value = value * 10 + (uint32_t)(frame[i] - '0');
+        i++;
+        digits++;
+    }
+    if (digits == 0 || value == 0 || value > PIPE_BATCH_MAX) return false;
+    bool nul = false;
+    if (i != len) {
+        if (len - i != 4 || memcmp(frame + i, " nul", 4) != 0) return false;
+        nul = true;
+    }
+    *count = value;
+    if (nul) *nulOnly = true;
+    return true;
+}
+
+// Writes the "@batch N\n" reply header at out[0]. Returns bytes written.
+inline size_t PipeBatchBegin(char* out, size_t cap, uint32_t count) {
+    int n = snprintf(out, cap, PIPE_DIRECTIVE_BATCH " %u\n", (unsigned)count);
+    return (n > 0 && (size_t)n < cap) ? (size_t)n : 0;
+}
+
+// Appends one "<OK|ERR> <len>\n<payload>" entry at out[*off]. Returns false,
+// leaving *off untouched, if the entry does not fit within `cap` bytes
+// (a NUL terminator is always kept after the last entry).
+inline bool PipeBatchAppend(char* out, size_t cap, size_t* off, bool ok,
+                            const char* payload, size_t plen) {
+    char head[32];
+    int hn = snprintf(head, sizeof(head), "%s %zu\n", ok ? "OK" : "ERR", plen);
+    if (hn <= 0 || *off + (size_t)hn + plen + 1 > cap) return false;
+    memcpy(out + *off, head, (size_t)hn);
+    memcpy(out + *off + hn, payload, plen);
+    *off += (size_t)hn + plen;
+    out[*off] = '\0';
+    return true;
+}
+
+// Client-side reader for batch replies. Call once with *pos = 0 to validate
+// the header (returns the entry count, 0 if `reply` is not a batch reply),
+// then PipeBatchNext until it returns false.
+inline uint32_t PipeBatchHeaderCount(const char* reply, size_t len, size_t* pos) {
+    const size_t n = sizeof(PIPE_DIRECTIVE_BATCH) - 1;
+    if (len <= n + 1 || memcmp(reply, PIPE_DIRECTIVE_BATCH, n) != 0 || reply[n] != ' ') return 0;
+    uint32_t value = 0;
+    size_t i = n + 1;
+    while (i < len && reply[i] >= '0' && reply[i] <= '9') value = value * 10 + (uint32_t)(reply[i++] - '0');
+    if (i >= len || reply[i] != '\n') return 0;
+    *pos = i + 1;
+    return value;
+}
+
+inline bool PipeBatchNext(const char* reply, size_t len, size_t* pos, bool* ok,
+                          const char** payload, size_t* plen) {
+    size_t i = *pos;
+    if (i >= len) return false;
+    if (len - i >= 3 && memcmp(reply + i, "OK ", 3) == 0) { *ok = true; i += 3; }
+    else if (len - i >= 4 && memcmp(reply + i, "ERR ", 4) == 0) { *ok = false; i += 4; }
+    else return false;
+    size_t value = 0;
+    size_t digits = 0;
+    while (i < len && reply[i] >= '0' && reply[i] <= '9') { value = value * 10 + (size_t)(reply[i++] - '0'); digits++; }
+    if (digits == 0 || i >= len || reply[i] != '\n' || len - (i + 1) < value) return false;
+    *payload = reply + i + 1;
+    *plen = value;
+    *pos = i + 1 + value;
+    return true;
+}
+
+enum PipeReplyClass {
+    PIPE_REPLY_OK = 0,     // anything that is not an "ERR" reply
+    PIPE_REPLY_REJECTED,   // queue full: the bridge refused the command
+    PIPE_REPLY_TIMED_OUT,  // queued, but the main thread never ran it in time
+    PIPE_REPLY_ERROR,      // Lua error or a helper's own "ERR: ..." string
+};
+
+// Sorts one text reply (or one batch entry payload) for client accounting.
+inline PipeReplyClass PipeClassifyReply(const char* reply, size_t len) {
+    auto starts = [reply, len](const char* prefix) {
+        const size_t n = strlen(prefix);
+        return len >= n && memcmp(reply, prefix, n) == 0;
+    };
+    if (starts(PIPE_REPLY_QUEUE_FULL)) return PIPE_REPLY_REJECTED;
+    if (starts(PIPE_REPLY_TIMEOUT)) return PIPE_REPLY_TIMED_OUT;
+    if (starts("ERR")) return PIPE_REPLY_ERROR;
+    return PIPE_REPLY_OK;
+}
+
+// Pops the next non-empty frame out of buf[0..*len). The frame is copied to
+// `out` without its terminator (and without a trailing '\r' in newline
+// mode), NUL-terminated, and the remaining bytes are shifted to the front of
+// `buf`. Returns false, leaving any partial frame in place, when no complete
+// frame is buffered yet. `outCap` must be at least the capacity of `buf` so a
+// buffered frame always fits.
+inline bool PipeTakeFrame(char* buf, size_t* len, bool nulOnly,
+                          char* out, size_t outCap, size_t* outLen) {
+    size_t start = 0;
+    for (size_t i = 0; i < *len; i++) {
+        const char c = buf[i];
+        if (c != '\0' && (nulOnly || c != '\n')) continue;
+        size_t flen = i - start;
+        if (!nulOnly && flen > 0 && buf[start + flen - 1] == '\r') flen--;
+        if (flen == 0) { start = i + 1; continue; }
+        if (flen >= outCap) flen = outCap - 1;
+        memcpy(out, buf + start, flen);
+        out[flen] = '\0';
+        *outLen = flen;
+        const size_t consumed = i + 1;
+        memmove(buf, buf + consumed, *len - consumed);
+        *len -= consumed;
+        return true;
+    }
+    // Drop any skipped empty frames so they are not rescanned next call.
+    if (start > 0) {
+        memmove(buf, buf + start, *len - start);
+        *len -= start;
+    }
+    return false;
+}
@@ -0,0 +1,271 @@
+#pragma once
+// pipe_queue.h -- bounded multi-producer / single-consumer command queue
+// between the pipe instance threads and the game's main thread.
+//
+// Each pipe instance pushes its command into the next free slot and gets a
+// ticket back; the main thread (Hook_luaD_call / focus-drain timer) pops
+// queued slots in ticket order, executes them and writes the reply into the
+// slot's own result buffer. The producer then collects its reply by ticket,
+// which frees the slot. Completion is signalled through the slot's
+// auto-reset `done` event so the producer wakes as soon as the main thread
+// finishes instead of polling. A producer that gives up (timeout, shutdown)
+// abandons its ticket; the consumer skips or frees abandoned slots, so a late
+// result can never be handed to the next command that reuses the slot.
+//
+// Shared by lua_bridge.cpp and test_harness.cpp so the harness drives the
+// live queue logic rather than a replica.
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifndef PIPE_CMD_MAX
+#define PIPE_CMD_MAX 16384
+#endif
+
+// Power of two so ticket % PIPE_QUEUE_SLOTS stays stable across uint32 wrap.
+#define PIPE_QUEUE_SLOTS 8
+
+enum PipeSlotState : uint8_t {
+    PIPE_SLOT_FREE = 0,
+    PIPE_SLOT_QUEUED,     // waiting for the main thread
+    PIPE_SLOT_RUNNING,    // popped; the main thread owns cmd/result
+    PIPE_SLOT_DONE,       // result ready for the producer to collect
+    PIPE_SLOT_ABANDONED,  // producer gave up; consumer frees the slot
+};
+
+struct PipeCmdSlot {
+    char     cmd[PIPE_CMD_MAX];
+    char     result[PIPE_CMD_MAX];
+    uint32_t ticket;
+    uint32_t batchCount;  // 0 = single chunk; N = N NUL-separated chunks (pipe_protocol.h)
+    int64_t  queuedAt;    // producer's clock at push (QPC ticks in the bridge); 0 = not timed
+    uint8_t  state;
+    HANDLE   done;    // auto-reset; set when the slot reaches PIPE_SLOT_DONE
+};
+
+struct PipeCmdQueue {
+    CRITICAL_SECTION lock;
+    uint32_t         head;    // next ticket the consumer drains
+    uint32_t         tail;    // next ticket handed to a producer
+    volatile LONG    queued;  // QUEUED slots; lock-free "any work?" hint
+    PipeCmdSlot      slots[PIPE_QUEUE_SLOTS];
+};
+
+// Frees every slot. Only call while no producer holds a ticket.
+inline void PipeQueueReset(PipeCmdQueue* q) {
+    q->head = 0;
+    q->tail = 0;
+    q->queued = 0;
+    for (int i = 0; i < PIPE_QUEUE_SLOTS; i++) {
+        q->slots[i].state = PIPE_SLOT_FREE;
+        q->slots[i].ticket = 0;
+        q->slots[i].batchCount = 0;
+        q->slots[i].queuedAt = 0;
+        q->slots[i].cmd[0] = '\0';
+        q->slots[i].result[0] = '\0';
+    }
+}
+
+inline void PipeQueueInit(PipeCmdQueue* q) {
+    InitializeCriticalSection(&q->lock);
+    for (int i = 0; i < PIPE_QUEUE_SLOTS; i++)
+        q->slots[i].done = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+    PipeQueueReset(q);
+}
+
+inline void PipeQueueDestroy(PipeCmdQueue* q) {
+    for (int i = 0; i < PIPE_QUEUE_SLOTS; i++) {
+        if (q->slots[i].done) { CloseHandle(q->slots[i].done); q->slots[i].done = nullptr; }
+    }
+    DeleteCriticalSection(&q->lock);
+}
+
+inline bool PipeQueueHasWork(const PipeCmdQueue* q) {
+    return q->queued > 0;
+}
+
+// Copies `cmd` (len bytes, truncated to PIPE_CMD_MAX - 1) into the next
+// slot. Returns false when all slots are in flight. A non-zero batchCount
+// marks `cmd` as that many NUL-separated chunks run in one drain pass.
+// `queuedAt` is stored for the consumer's queue-wait timing.
+inline bool PipeQueuePush(PipeCmdQueue* q, const char* cmd, size_t len, uint32_t* ticket,
+                          uint32_t batchCount = 0, int64_t queuedAt = 0) {
+    if (len >= PIPE_CMD_MAX) len = PIPE_CMD_MAX - 1;
+    EnterCriticalSection(&q->lock);
+    PipeCmdSlot* slot = &q->slots[q->tail % PIPE_QUEUE_SLOTS];
+    if (q->tail - q->head >= PIPE_QUEUE_SLOTS || slot->state != PIPE_SLOT_FREE) {
+        LeaveCriticalSection(&q->lock);
+        return false;
+    }
+    memcpy(slot->cmd, cmd, len);
+    slot->cmd[len] = '\0';
+    slot->result[0] = '\0';
+    slot->batchCount = batchCount;
+    slot->queuedAt = queuedAt;
+    slot->ticket = q->tail++;
+    slot->state = PIPE_SLOT_QUEUED;
+    InterlockedIncrement(&q->queued);
+    *ticket = slot->ticket;
+    LeaveCriticalSection(&q->lock);
+    return true;
+}
+
+// Consumer side: returns the oldest queued slot (now RUNNING, owned by the
+// caller until PipeQueueComplete) or nullptr when nothing is queued.
+inline PipeCmdSlot* PipeQueuePop(PipeCmdQueue* q) {
+    PipeCmdSlot* out = nullptr;
+    EnterCriticalSection(&q->lock);
+    while (q->head != q->tail) {
+        PipeCmdSlot* slot = &q->slots[q->head % PIPE_QUEUE_SLOTS];
+        if (slot->state == PIPE_SLOT_ABANDONED) {
+            slot->state = PIPE_SLOT_FREE;
+            q->head++;
+            InterlockedDecrement(&q->queued);
+            continue;
+        }
+        if (slot->state == PIPE_SLOT_QUEUED) {
+            slot->state = PIPE_SLOT_RUNNING;
+            q->head++;
+            InterlockedDecrement(&q->queued);
+            out = slot;
+        }
+        break;
+    }
+    LeaveCriticalSection(&q->lock);
+    return out;
+}
+
+// Consumer side: publishes slot->result to the producer and wakes it.
+inline void PipeQueueComplete(PipeCmdQueue* q, PipeCmdSlot* slot) {
+    EnterCriticalSection(&q->lock);
+    if (slot->state == PIPE_SLOT_ABANDONED) {
+        slot->state = PIPE_SLOT_FREE;
+    } else {
+        slot->state = PIPE_SLOT_DONE;
+        if (slot->done) SetEvent(slot->done);
+    }
+    LeaveCriticalSection(&q->lock);
+}
+
+// Event the producer holding `ticket` waits on. The event can carry a stale
+// signal from an earlier ticket that was abandoned after completing, so
+// waiters must re-check PipeQueueCollect after every wake.
+inline HANDLE PipeQueueDoneEvent(PipeCmdQueue* q, uint32_t ticket) {
+    return q->slots[ticket % PIPE_QUEUE_SLOTS].done;
+}
+
+// Producer side: if the ticket's result is ready, copies it into `reply`,
+// frees the slot and returns true.
+inline bool PipeQueueCollect(PipeCmdQueue* q, uint32_t ticket, char* reply, size_t cap) {
+    bool done = false;
+    EnterCriticalSection(&q->lock);
+    PipeCmdSlot* slot = &q->slots[ticket % PIPE_QUEUE_SLOTS];
+    if (slot->ticket == ticket && slot->state == PIPE_SLOT_DONE) {
+        snprintf(reply, cap, "%s", slot->result);
+        slot->state = PIPE_SLOT_FREE;
+        done = true;
+    }
+    LeaveCriticalSection(&q->lock);
+    return done;
+}
+
+// Producer side: gives up on a ticket. A slot still queued or running is
+// left for the consumer to free; a finished one is freed here.
+inline void PipeQueueAbandon(PipeCmdQueue* q, uint32_t ticket) {
+    EnterCriticalSection(&q->lock);
+    PipeCmdSlot* slot = &q->slots[ticket % PIPE_QUEUE_SLOTS];
+    if (slot->ticket == ticket) {
+        if (slot->state == PIPE_SLOT_DONE) {
+            slot->state = PIPE_SLOT_FREE;
+        } else if (slot->state == PIPE_SLOT_QUEUED || slot->state == PIPE_SLOT_RUNNING) {
+            slot->state = PIPE_SLOT_ABANDONED;
+        }
+    }
+    LeaveCriticalSection(&q->lock);
+}
+
+// ----- Main-thread drain budget -----
+//
+// The consumer runs Lua inline inside Hook_luaD_call, so an expensive
+// command shows up as a frame hitch. A drain pass opens a budget and stops
+// popping once it is spent; leftover commands wait for the next luaD_call
+// or focus-drain tick. Batches resume chunk by chunk through a
+// PipeBatchCursor, so a long batch is spread over several ticks instead of
+// running in one pass. A single chunk or command always runs to completion:
+// native helpers cannot be paused mid-call.
+
+#define PIPE_DRAIN_BUDGET_US_DEFAULT 2000
+
+struct PipeDrainBudget {
+    int64_t start;  // QPC ticks when the pass began
+    int64_t limit;  // QPC ticks allowed; 0 = unlimited
+};
+
+inline void PipeBudgetBegin(PipeDrainBudget* b, int64_t now, int64_t qpcFreq, uint32_t budgetUs) {
+    b->start = now;
+    b->limit = budgetUs ? (int64_t)((uint64_t)qpcFreq * budgetUs / 1000000) : 0;
+    if (budgetUs && b->limit == 0) b->limit = 1;
+}
+
+inline bool PipeBudgetSpent(const PipeDrainBudget* b, int64_t now) {
+    return b->limit != 0 && now - b->start >= b->limit;
+}
+
+// In-progress "@batch" slot (RUNNING, owned by the consumer).
+struct PipeBatchCursor {
+    PipeCmdSlot* slot;   // nullptr when no batch is in progress
+    const char*  next;   // next NUL-terminated chunk within slot->cmd
+    uint32_t     index;  // chunks already run
+    size_t       off;    // bytes of slot->result written so far
+};
+
+// ----- Round-trip latency histogram -----
+//
+// Bucket i counts round trips that took [2^i, 2^(i+1)) microseconds
+// (bucket 0 also takes anything under 1 us); the last bucket is open-ended.
+// Writers are the pipe instance threads, so buckets are bumped with
+// InterlockedIncrement and readers tolerate slightly torn snapshots.
+
+#define PIPE_LATENCY_BUCKETS 24
+
+struct PipeLatencyHistogram {
+    volatile LONG buckets[PIPE_LATENCY_BUCKETS];
+};
+
+inline int PipeLatencyBucket(uint64_t micros) {
+    int b = 0;
+    while (micros > 1 && b < PIPE_LATENCY_BUCKETS - 1) { micros >>= 1; b++; }
+    return b;
+}
+
+inline void PipeLatencyRecord(PipeLatencyHistogram* h, uint64_t micros) {
+    InterlockedIncrement(&h->buckets[PipeLatencyBucket(micros)]);
+}
+
+inline void PipeLatencyReset(PipeLatencyHistogram* h) {
+    for (int i = 0; i < PIPE_LATENCY_BUCKETS; i++) h->buckets[i] = 0;
+}
+
+inline uint64_t PipeLatencyCount(const PipeLatencyHistogram* h) {
+    uint64_t n = 0;
+    for (int i = 0; i < PIPE_LATENCY_BUCKETS; i++) n += (uint64_t)h->buckets[i];
+    return n;
+}
+
+// Upper bound (exclusive, in microseconds) of the bucket holding the given
+// percentile (0..100). Returns 0 when nothing has been recorded.
+inline uint64_t PipeLatencyPercentile(const PipeLatencyHistogram* h, int pct) {
+    const uint64_t total = PipeLatencyCount(h);
+    if (total == 0) return 0;
+    uint64_t rank = (total * (uint64_t)pct + 99) / 100;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < PIPE_LATENCY_BUCKETS; i++) {
+        seen += (uint64_t)h->buckets[i];
+        if (seen >= rank) return 1ull << (i + 1);
+    }
+    return 1ull << PIPE_LATENCY_BUCKETS;
+}
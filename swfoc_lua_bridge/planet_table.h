@@ -0,0 +1,269 @@
+#pragma once
+// planet_table.h -- planet name -> ID resolution, built once per galactic
+// session, and the batched ownership / tech / buildings edit that uses it.
+//
+// SWFOC_ChangePlanetOwner takes one planet per pipe command, so a
+// galaxy-wide scenario that flips 50 planets is 50 round trips, each
+// matching its planet by name on its own. Two pieces replace that:
+//
+//   * PlanetTable maps every planet's type name to a dense ID (its place in
+//     the walk) and the planet object. The bridge fills it from one
+//     WalkGalacticPlanets pass and keeps it for as long as the galactic
+//     mode object -- the session key -- stays the same; a new campaign or
+//     a loaded save builds a new one. Lookups ignore ASCII case: an FNV-1a
+//     hash of the folded name into an open-addressed index of
+//     PLANET_TABLE_SLOTS (linear probe), then one compare.
+//   * SWFOC_PlanetBatch takes every edit at once:
+//
+//       "Coruscant;owner=2;tech=3|Kuat;owner=2;buildings=4|..."
+//
+//     one planet per '|', then at least one of owner=, tech= and
+//     buildings=. PlanetBatchParse checks the whole spec before any name is
+//     resolved; the bridge then resolves every name and, only when all of
+//     them resolve, folds the edits in one pass (PlanetBatchFold). A later
+//     edit of the same planet wins, field by field.
+//
+// The edits fold into the same PendingState maps SWFOC_ChangePlanetOwner's
+// journal writes do, uppercased, so both paths read back alike.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge builds, reads and folds on the main thread.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "pending_journal.h"
+
+#define PLANET_TABLE_MAX   512   // RVA::Planet::kMaxPlanets
+#define PLANET_TABLE_SLOTS 1024  // power of two, over PLANET_TABLE_MAX so a probe always ends
+#define PLANET_TABLE_NAME  48    // SHMEM_PLANETS_NAME_LEN, NUL included
+#define PLANET_BATCH_MAX   PLANET_TABLE_MAX
+#define PLANET_BATCH_TECH_MAX      10
+#define PLANET_BATCH_BUILDINGS_MAX 99
+
+static_assert((PLANET_TABLE_SLOTS & (PLANET_TABLE_SLOTS - 1)) == 0, "index size must be a power of two");
+static_assert(PLANET_TABLE_SLOTS > PLANET_TABLE_MAX && PLANET_TABLE_MAX <= 32767, "index must keep a free slot");
+
+struct PlanetTable {
+    uint64_t session;  // galactic mode object the table was built for, 0 = none
+    uint32_t count;
+    uint64_t obj[PLANET_TABLE_MAX];
+    uint32_t hash[PLANET_TABLE_MAX];
+    char     name[PLANET_TABLE_MAX][PLANET_TABLE_NAME];  // uppercased
+    int16_t  index[PLANET_TABLE_SLOTS];                  // -1 = free, else an ID
+    uint32_t builds;
+    uint32_t skipped;  // planets not added: empty, too long or duplicate name
+};
+
+inline char PlanetTableFold(char c) { return c >= 'a' && c <= 'z' ? (char)(c - 'a' + 'A') : c; }
+
+inline uint32_t PlanetTableHash(const char* s, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (uint8_t)PlanetTableFold(s[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Empties the table for a new session.
+inline void PlanetTableBegin(PlanetTable* t, uint64_t session) {
+    t->session = session;
+    t->count = 0;
+    t->skipped = 0;
+    memset(t->index, 0xFF, sizeof(t->index));
+    t->builds++;
+}
+
+// The ID of the planet named s[0..n), or -1.
+inline int PlanetTableFindN(const PlanetTable* t, const char* s, size_t n) {
+    if (!n || n >= PLANET_TABLE_NAME) return -1;
+    const uint32_t h = PlanetTableHash(s, n);
+    for (uint32_t i = h & (PLANET_TABLE_SLOTS - 1);; i = (i + 1) & (PLANET_TABLE_SLOTS - 1)) {
+        const int id = t->index[i];
+        if (id < 0) return -1;
+        if (t->hash[id] != h || t->name[id][n]) continue;
+        size_t k = 0;
+        while (k < n && t->name[id][k] == PlanetTableFold(s[k])) k++;
+        if (k == n) return id;
+    }
+}
+
+inline int PlanetTableFind(const PlanetTable* t, const char* name) {
+    return name ? PlanetTableFindN(t, name, strlen(name)) : -1;
+}
+
+// Adds a planet and returns its ID; -1, counted in skipped, when the table
+// is full or the name is empty, too long or already present.
+inline int PlanetTableAdd(PlanetTable* t, uint64_t obj, const char* name) {
+    const size_t n = name ? strlen(name) : 0;
+    if (t->count >= PLANET_TABLE_MAX || !n || n >= PLANET_TABLE_NAME || PlanetTableFindN(t, name, n) >= 0) {
+        t->skipped++;
+        return -1;
+    }
+    const int id = (int)t->count++;
+    t->obj[id] = obj;
+    t->hash[id] = PlanetTableHash(name, n);
+    for (size_t k = 0; k <= n; k++) t->name[id][k] = PlanetTableFold(name[k]);
+    uint32_t i = t->hash[id] & (PLANET_TABLE_SLOTS - 1);
+    while (t->index[i] >= 0) i = (i + 1) & (PLANET_TABLE_SLOTS - 1);
+    t->index[i] = (int16_t)id;
+    return id;
+}
+
+enum PlanetBatchField : uint8_t {
+    PLANET_EDIT_OWNER     = 1,
+    PLANET_EDIT_TECH      = 2,
+    PLANET_EDIT_BUILDINGS = 4,
+};
+
+struct PlanetBatchEdit {
+    char     name[PENDING_NAME_MAX];  // as given
+    uint8_t  fields;                  // PlanetBatchField bits
+    int32_t  owner;
+    int32_t  tech;
+    int32_t  buildings;
+    int32_t  id;                      // PlanetTable ID, -1 until resolved
+    uint64_t obj;
+};
+
+enum PlanetBatchParseResult {
+    PLANET_BATCH_PARSE_OK = 0,
+    PLANET_BATCH_PARSE_EMPTY,     // no entry
+    PLANET_BATCH_PARSE_TOO_MANY,  // over maxOut entries
+    PLANET_BATCH_PARSE_NAME,      // planet name empty or too long
+    PLANET_BATCH_PARSE_FIELD,     // not owner= / tech= / buildings=, or an entry with none
+    PLANET_BATCH_PARSE_NUMBER,    // not an integer, or out of range
+};
+
+inline const char* PlanetBatchParseError(int r) {
+    switch (r) {
+    case PLANET_BATCH_PARSE_OK:       return "ok";
+    case PLANET_BATCH_PARSE_EMPTY:    return "no planets";
+    case PLANET_BATCH_PARSE_TOO_MANY: return "too many planets";
+    case PLANET_BATCH_PARSE_NAME:     return "planet name empty or too long";
+    case PLANET_BATCH_PARSE_FIELD:    return "expected name;owner=N;tech=N;buildings=N (at least one field)";
+    case PLANET_BATCH_PARSE_NUMBER:   return "owner 0..15, tech 0..10, buildings 0..99";
+    }
+    return "?";
+}
+
+inline bool PlanetBatchParseInt(const char* s, const char* e, int lo, int hi, int32_t* out) {
+    char buf[16];
+    const size_t n = (size_t)(e - s);
+    if (!n || n >= sizeof(buf)) return false;
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    char* end = nullptr;
+    const long v = strtol(buf, &end, 10);
+    if (*end != '\0' || v < lo || v > hi) return false;
+    *out = (int32_t)v;
+    return true;
+}
+
+// Parses spec into out[0..*count). On failure *badEntry is the 0-based
+// entry at fault and out holds only the entries before it.
+inline int PlanetBatchParse(const char* spec, PlanetBatchEdit* out, int maxOut, int* count, int* badEntry) {
+    *count = 0;
+    *badEntry = 0;
+    const char* s = spec ? spec : "";
+    while (*s) {
+        const char* e = strchr(s, '|');
+        if (!e) e = s + strlen(s);
+        if (e > s) {
+            *badEntry = *count;
+            if (*count == maxOut) return PLANET_BATCH_PARSE_TOO_MANY;
+            PlanetBatchEdit ed;
+            memset(&ed, 0, sizeof(ed));
+            ed.id = -1;
+            const char* f = s;
+            while (f < e && *f != ';') f++;
+            const size_t n = (size_t)(f - s);
+            if (!n || n >= PENDING_NAME_MAX) return PLANET_BATCH_PARSE_NAME;
+            memcpy(ed.name, s, n);
+            while (f < e) {
+                const char* k = f + 1;
+                const char* fe = k;
+                while (fe < e && *fe != ';') fe++;
+                const char* eq = (const char*)memchr(k, '=', (size_t)(fe - k));
+                if (!eq) return PLANET_BATCH_PARSE_FIELD;
+                const size_t kn = (size_t)(eq - k);
+                bool ok;
+                if (kn == 5 && !memcmp(k, "owner", 5)) {
+                    ok = PlanetBatchParseInt(eq + 1, fe, 0, PENDING_PLAYER_SLOTS - 1, &ed.owner);
+                    ed.fields |= PLANET_EDIT_OWNER;
+                } else if (kn == 4 && !memcmp(k, "tech", 4)) {
+                    ok = PlanetBatchParseInt(eq + 1, fe, 0, PLANET_BATCH_TECH_MAX, &ed.tech);
+                    ed.fields |= PLANET_EDIT_TECH;
+                } else if (kn == 9 && !memcmp(k, "buildings", 9)) {
+                    ok = PlanetBatchParseInt(eq + 1, fe, 0, PLANET_BATCH_BUILDINGS_MAX, &ed.buildings);
+                    ed.fields |= PLANET_EDIT_BUILDINGS;
+                } else {
+                    return PLANET_BATCH_PARSE_FIELD;
+                }
+                if (!ok) return PLANET_BATCH_PARSE_NUMBER;
+                f = fe;
+            }
+            if (!ed.fields) return PLANET_BATCH_PARSE_FIELD;
+            out[(*count)++] = ed;
+        }
+        s = *e ? e + 1 : e;
+    }
+    if (!*count) return PLANET_BATCH_PARSE_EMPTY;
+    return PLANET_BATCH_PARSE_OK;
+}
+
+// Resolves every edit through the table. Returns the index of the first
+// name the table does not hold, or -1 when all resolve.
+inline int PlanetBatchResolve(const PlanetTable* t, PlanetBatchEdit* e, int n) {
+    int missing = -1;
+    for (int i = 0; i < n; i++) {
+        e[i].id = PlanetTableFind(t, e[i].name);
+        e[i].obj = e[i].id >= 0 ? t->obj[e[i].id] : 0;
+        if (e[i].id < 0 && missing < 0) missing = i;
+    }
+    return missing;
+}
+
+// The journal writes for one edit, in owner / tech / buildings order: the
+// name uppercased as SWFOC_ChangePlanetOwner records it, key = the planet
+// object once resolved. Returns how many (at most 3).
+inline int PlanetBatchWrites(const PlanetBatchEdit& e, PendingWrite out[3]) {
+    PendingWrite w = {};
+    for (size_t k = 0; k < PENDING_NAME_MAX && e.name[k]; k++) w.name[k] = PlanetTableFold(e.name[k]);
+    w.key = e.obj;
+    int n = 0;
+    if (e.fields & PLANET_EDIT_OWNER) {
+        out[n] = w;
+        out[n].kind = PENDING_PLANET_OWNER;
+        out[n++].slot = (int16_t)e.owner;
+    }
+    if (e.fields & PLANET_EDIT_TECH) {
+        out[n] = w;
+        out[n].kind = PENDING_PLANET_TECH;
+        out[n++].value = e.tech;
+    }
+    if (e.fields & PLANET_EDIT_BUILDINGS) {
+        out[n] = w;
+        out[n].kind = PENDING_PLANET_BUILDINGS;
+        out[n++].value = e.buildings;
+    }
+    return n;
+}
+
+// Folds the whole batch into `state` in one pass, after whatever the
+// journal already holds, so earlier single-planet helpers land first.
+// Call on the applier (main) thread. Returns the writes folded.
+inline uint32_t PlanetBatchFold(PendingJournal* j, PendingState* state, const PlanetBatchEdit* e, int n) {
+    PendingJournalApply(j, state);
+    uint32_t folded = 0;
+    PendingWrite w[3];
+    for (int i = 0; i < n; i++) {
+        const int k = PlanetBatchWrites(e[i], w);
+        for (int m = 0; m < k; m++) PendingFold(state, w[m]);
+        folded += (uint32_t)k;
+    }
+    j->applied.fetch_add(folded, std::memory_order_relaxed);
+    return folded;
+}
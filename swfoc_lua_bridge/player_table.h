@@ -0,0 +1,82 @@
+#pragma once
+// player_table.h -- the player list, read once per game tick.
+//
+// GetPlayerObj, GetFactionName, FindLocalPlayerSlot,
+// ReadCurrentHumanPlayerSlot and ResolveSlotPlayer each re-read the player
+// array (or PlayerListClass) from g_base on every call, and the HUD refresh
+// alone calls several of them per frame. The bridge now reads the list into
+// a PlayerTable once per tick and the player getters answer from it:
+//
+//   * rows[0, count) hold the player pointer, faction name pointer, credits,
+//     tech level and LocalPlayer flag of each slot. count is
+//     PlayerCount_Global clamped to PLAYER_TABLE_SLOTS; a slot at or past
+//     it has no player.
+//   * localSlot is the first slot whose LocalPlayer byte is 1 (the old
+//     FindLocalPlayerSlot scan); humanSlot is the PlayerListClass+0x30 slot
+//     (the old ReadCurrentHumanPlayerSlot). Either is -1 when absent.
+//   * units[] comes from the per-tick unit index and is only filled where
+//     the index may be read (main thread); unitsValid says whether it is.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// The bridge owns the reads and the refresh policy (GetPlayerTable): a new
+// tick, an age limit for paused-game drains, and a generation bump from
+// every helper that writes credits, tech or the local-player flag.
+
+#include <cstdint>
+#include <cstring>
+
+#define PLAYER_TABLE_SLOTS 8  // the engine's player slots
+
+struct PlayerRow {
+    uint64_t    player;   // PlayerObject*, 0 = empty slot
+    const char* faction;  // engine-owned name, nullptr when unreadable
+    float       credits;
+    int32_t     tech;
+    uint8_t     isHuman;  // LocalPlayer byte == 1
+    uint8_t     isLocal;  // slot == localSlot
+    int32_t     units;    // owned units in the unit index (see unitsValid)
+};
+
+struct PlayerTable {
+    int       count;
+    int       localSlot;
+    int       humanSlot;
+    bool      unitsValid;
+    PlayerRow rows[PLAYER_TABLE_SLOTS];
+};
+
+inline void PlayerTableReset(PlayerTable* t, int count) {
+    memset(t, 0, sizeof(*t));
+    t->count = count < 0 ? 0 : count > PLAYER_TABLE_SLOTS ? PLAYER_TABLE_SLOTS : count;
+    t->localSlot = -1;
+    t->humanSlot = -1;
+}
+
+// After the rows are filled: localSlot and the per-row isLocal flags.
+inline void PlayerTableFinish(PlayerTable* t) {
+    t->localSlot = -1;
+    for (int i = 0; i < t->count; i++) {
+        if (t->rows[i].player && t->rows[i].isHuman) {
+            t->localSlot = i;
+            break;
+        }
+    }
+    for (int i = 0; i < t->count; i++) t->rows[i].isLocal = (i == t->localSlot) ? 1 : 0;
+}
+
+// Row for `slot`, or nullptr when the slot is out of range or empty.
+inline const PlayerRow* PlayerTableRow(const PlayerTable* t, int slot) {
+    if (slot < 0 || slot >= t->count || !t->rows[slot].player) return nullptr;
+    return &t->rows[slot];
+}
+
+inline uint64_t PlayerTablePlayer(const PlayerTable* t, int slot) {
+    const PlayerRow* r = PlayerTableRow(t, slot);
+    return r ? r->player : 0;
+}
+
+// Faction name for `slot`; "?" for an empty slot or an unreadable name.
+inline const char* PlayerTableFaction(const PlayerTable* t, int slot) {
+    const PlayerRow* r = PlayerTableRow(t, slot);
+    return r && r->faction ? r->faction : "?";
+}
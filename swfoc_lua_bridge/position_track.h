@@ -0,0 +1,185 @@
+#pragma once
+// position_track.h -- native position sampling for tracked units, published
+// as batched EVT_POSITION records.
+//
+// A camera-follow or minimap client used to poll SWFOC_GetPositionLua per
+// unit through Lua. SWFOC_TrackUnits registers up to POSITION_TRACK_MAX
+// obj_addrs (or "selected", which follows the local selection) and a rate;
+// Hook_luaD_call then samples them here at that rate and writes one record
+// per sample into the event ring:
+//
+//   * Record = EvtPositionBatch header + `count` EvtPositionEntry. Positions
+//     are int16 multiples of `step` world units (POSITION_TRACK_STEP covers
+//     +-16 km); a coordinate outside that range is clamped and flagged.
+//   * Only units whose quantized position changed are sent, except every
+//     POSITION_TRACK_KEYFRAME-th sample, which sends every placed unit so a
+//     consumer that joined late or missed records (EVT_RESYNC) catches up.
+//   * A unit whose object is gone is sent once with POS_ENTRY_GONE and then
+//     dropped from the set. A unit with no readable position is counted in
+//     the header's `unplaced` and not sent.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge configures and samples it on the main thread.
+
+#include <cstdint>
+#include <cstring>
+
+#define POSITION_TRACK_MAX        64      // tracked units
+#define POSITION_TRACK_MAX_HZ     60
+#define POSITION_TRACK_DEFAULT_HZ 10
+#define POSITION_TRACK_STEP       0.5f    // world units per quantum
+#define POSITION_TRACK_KEYFRAME   16      // every Nth sample sends everyone
+
+#define POS_ENTRY_CLAMPED 0x01  // a coordinate was outside the int16 range
+#define POS_ENTRY_GONE    0x02  // the object is gone; it leaves the set
+
+#define POS_BATCH_KEYFRAME 0x01  // every tracked, placed unit is in the batch
+#define POS_BATCH_FOLLOW   0x02  // the set follows the local selection
+
+#pragma pack(push, 1)
+struct EvtPositionBatch {
+    uint32_t seq;       // sample number, per tracker
+    uint16_t count;     // entries that follow
+    uint8_t  flags;     // POS_BATCH_*
+    uint8_t  unplaced;  // tracked units with no readable position
+    float    step;      // world units per quantum
+};
+
+struct EvtPositionEntry {
+    uint64_t obj;       // GameObjectClass*
+    int16_t  x, y, z;   // world position / step
+    uint16_t flags;     // POS_ENTRY_*
+};
+#pragma pack(pop)
+
+#define POSITION_TRACK_RECORD_MAX (sizeof(EvtPositionBatch) + POSITION_TRACK_MAX * sizeof(EvtPositionEntry))
+
+// Sampler answers for one unit.
+enum PositionReadResult { POS_READ_OK = 0, POS_READ_UNPLACED = 1, POS_READ_GONE = 2 };
+
+struct PositionTracker {
+    uint64_t objs[POSITION_TRACK_MAX];
+    int16_t  last[POSITION_TRACK_MAX][3];
+    bool     sent[POSITION_TRACK_MAX];  // last[] holds what was published
+    int32_t  count;
+    bool     follow;                    // objs mirror the local selection
+    uint32_t followSeq;                 // SelectionTracker::seq objs came from
+    uint32_t hz;                        // 0 = off
+    uint64_t nextMs;
+    uint32_t seq;
+    uint32_t records;
+    uint32_t entries;
+    uint32_t gone;
+};
+
+inline void PositionTrackReset(PositionTracker* t) {
+    memset(t, 0, sizeof(*t));
+}
+
+// Replaces the tracked set (duplicates and zeros are skipped; at most
+// POSITION_TRACK_MAX are kept). Returns the number tracked.
+inline int PositionTrackSetUnits(PositionTracker* t, const uint64_t* objs, int n) {
+    int kept = 0;
+    for (int i = 0; i < n && kept < POSITION_TRACK_MAX; i++) {
+        if (!objs[i]) continue;
+        bool dup = false;
+        for (int k = 0; k < kept && !dup; k++) dup = t->objs[k] == objs[i];
+        if (dup) continue;
+        t->objs[kept] = objs[i];
+        t->sent[kept] = false;
+        kept++;
+    }
+    t->count = kept;
+    return kept;
+}
+
+// hz is clamped to [0, POSITION_TRACK_MAX_HZ]; 0 stops sampling.
+inline void PositionTrackSetRate(PositionTracker* t, int hz) {
+    if (hz < 0) hz = 0;
+    if (hz > POSITION_TRACK_MAX_HZ) hz = POSITION_TRACK_MAX_HZ;
+    t->hz = (uint32_t)hz;
+    t->nextMs = 0;
+}
+
+inline bool PositionTrackActive(const PositionTracker* t) {
+    return t->hz && (t->count > 0 || t->follow);
+}
+
+inline bool PositionTrackDue(const PositionTracker* t, uint64_t nowMs) {
+    return PositionTrackActive(t) && nowMs >= t->nextMs;
+}
+
+inline int16_t PositionQuantize(float v, float step, bool* clamped) {
+    const float q = v / step;
+    if (!(q > -32767.0f)) { *clamped = true; return -32767; }  // also NaN
+    if (q > 32767.0f) { *clamped = true; return 32767; }
+    return (int16_t)(q < 0.0f ? q - 0.5f : q + 0.5f);
+}
+
+// Samples every tracked unit through read(obj, float xyz[3]) ->
+// PositionReadResult and writes one EVT_POSITION payload to `out`
+// (POSITION_TRACK_RECORD_MAX bytes). Returns the payload size, or 0 when the
+// batch would be empty and is not a keyframe worth announcing.
+template<typename Read>
+inline uint32_t PositionTrackSample(PositionTracker* t, uint64_t nowMs, Read&& read, uint8_t* out) {
+    const uint32_t period = t->hz ? 1000u / t->hz : 1000u;
+    t->nextMs = nowMs + (period ? period : 1);
+    const bool keyframe = t->seq % POSITION_TRACK_KEYFRAME == 0;
+    t->seq++;
+
+    EvtPositionBatch hdr;
+    hdr.seq = t->seq;
+    hdr.count = 0;
+    hdr.flags = (uint8_t)((keyframe ? POS_BATCH_KEYFRAME : 0) | (t->follow ? POS_BATCH_FOLLOW : 0));
+    hdr.unplaced = 0;
+    hdr.step = POSITION_TRACK_STEP;
+    EvtPositionEntry* entries = reinterpret_cast<EvtPositionEntry*>(out + sizeof(hdr));
+
+    int keep = 0;
+    for (int i = 0; i < t->count; i++) {
+        float p[3] = {0.0f, 0.0f, 0.0f};
+        const int r = read(t->objs[i], p);
+        EvtPositionEntry e;
+        e.obj = t->objs[i];
+        e.flags = 0;
+        if (r == POS_READ_GONE) {
+            e.x = e.y = e.z = 0;
+            e.flags = POS_ENTRY_GONE;
+            memcpy(&entries[hdr.count++], &e, sizeof(e));
+            t->gone++;
+            continue;  // dropped from the set
+        }
+        // Compact the survivors in place.
+        t->objs[keep] = t->objs[i];
+        t->sent[keep] = t->sent[i];
+        memcpy(t->last[keep], t->last[i], sizeof(t->last[i]));
+        if (r != POS_READ_OK) {
+            if (hdr.unplaced < 0xFF) hdr.unplaced++;
+            t->sent[keep] = false;
+            keep++;
+            continue;
+        }
+        bool clamped = false;
+        e.x = PositionQuantize(p[0], POSITION_TRACK_STEP, &clamped);
+        e.y = PositionQuantize(p[1], POSITION_TRACK_STEP, &clamped);
+        e.z = PositionQuantize(p[2], POSITION_TRACK_STEP, &clamped);
+        if (clamped) e.flags |= POS_ENTRY_CLAMPED;
+        const bool moved = !t->sent[keep] || t->last[keep][0] != e.x || t->last[keep][1] != e.y
+                           || t->last[keep][2] != e.z;
+        if (keyframe || moved) {
+            memcpy(&entries[hdr.count++], &e, sizeof(e));
+            t->last[keep][0] = e.x;
+            t->last[keep][1] = e.y;
+            t->last[keep][2] = e.z;
+            t->sent[keep] = true;
+        }
+        keep++;
+    }
+    t->count = keep;
+
+    if (hdr.count == 0 && !keyframe) return 0;
+    memcpy(out, &hdr, sizeof(hdr));
+    t->records++;
+    t->entries += hdr.count;
+    return (uint32_t)(sizeof(hdr) + hdr.count * sizeof(EvtPositionEntry));
+}
@@ -1,6 +1,13 @@
 // powrprof.dll proxy — forwards real exports to system DLL
 // Drop this DLL in the game's /corruption folder. Windows loads it
 // before the system powrprof.dll due to DLL search order.
+//
+// 2026-10-14: all six forwarded exports are resolved once, in Proxy_Init
+// (DLL_PROCESS_ATTACH), into g_realExports. A call is one table load and an
+// indirect jump: no function-local static, so no thread-safe-init guard on
+// every CallNtPowerInformation the engine makes. An export the system DLL
+// lacks stays null and its proxy returns the fallback code listed below;
+// Proxy_ExportStatus reports which ones that is.
 
 #include <windows.h>
 #include <cstdio>
@@ -9,43 +16,69 @@ static HMODULE g_realDll = nullptr;
 
 // The 6 exports that StarWarsG.exe imports from powrprof.dll
 // We forward them to the real system DLL.
+enum ProxyExport {
+    PROXY_CALL_NT_POWER_INFORMATION = 0,
+    PROXY_POWER_READ_AC_VALUE_INDEX,
+    PROXY_POWER_READ_DC_VALUE_INDEX,
+    PROXY_POWER_GET_ACTIVE_SCHEME,
+    PROXY_POWER_SETTING_REGISTER_NOTIFICATION,
+    PROXY_POWER_SETTING_UNREGISTER_NOTIFICATION,
+    PROXY_EXPORT_COUNT
+};
+
+static const char* const kProxyExportNames[PROXY_EXPORT_COUNT] = {
+    "CallNtPowerInformation",
+    "PowerReadACValueIndex",
+    "PowerReadDCValueIndex",
+    "PowerGetActiveScheme",
+    "PowerSettingRegisterNotification",
+    "PowerSettingUnregisterNotification",
+};
+
+static FARPROC g_realExports[PROXY_EXPORT_COUNT] = {};
+
+// Returned when the real export is missing: STATUS_SUCCESS for
+// CallNtPowerInformation (as before: the engine polls it and ignores the
+// buffer on a zeroed result), ERROR_INVALID_FUNCTION for the rest.
+#define PROXY_FALLBACK_NTSTATUS 0
+#define PROXY_FALLBACK_WIN32    ERROR_INVALID_FUNCTION
 
 extern "C" {
 
 LONG WINAPI Proxy_CallNtPowerInformation(ULONG a, PVOID b, ULONG c, PVOID d, ULONG e) {
     typedef LONG(WINAPI* fn_t)(ULONG, PVOID, ULONG, PVOID, ULONG);
-    static auto real = (fn_t)GetProcAddress(g_realDll, "CallNtPowerInformation");
-    return real ? real(a, b, c, d, e) : 0;
+    auto real = (fn_t)g_realExports[PROXY_CALL_NT_POWER_INFORMATION];
+    return real ? real(a, b, c, d, e) : PROXY_FALLBACK_NTSTATUS;
 }
 
 DWORD WINAPI Proxy_PowerReadACValueIndex(HKEY a, const GUID* b, const GUID* c, const GUID* d, DWORD* e) {
     typedef DWORD(WINAPI* fn_t)(HKEY, const GUID*, const GUID*, const GUID*, DWORD*);
-    static auto real = (fn_t)GetProcAddress(g_realDll, "PowerReadACValueIndex");
-    return real ? real(a, b, c, d, e) : 1;
+    auto real = (fn_t)g_realExports[PROXY_POWER_READ_AC_VALUE_INDEX];
+    return real ? real(a, b, c, d, e) : PROXY_FALLBACK_WIN32;
 }
 
 DWORD WINAPI Proxy_PowerReadDCValueIndex(HKEY a, const GUID* b, const GUID* c, const GUID* d, DWORD* e) {
     typedef DWORD(WINAPI* fn_t)(HKEY, const GUID*, const GUID*, const GUID*, DWORD*);
-    static auto real = (fn_t)GetProcAddress(g_realDll, "PowerReadDCValueIndex");
-    return real ? real(a, b, c, d, e) : 1;
+    auto real = (fn_t)g_realExports[PROXY_POWER_READ_DC_VALUE_INDEX];
+    return real ? real(a, b, c, d, e) : PROXY_FALLBACK_WIN32;
 }
 
 DWORD WINAPI Proxy_PowerGetActiveScheme(HKEY a, GUID** b) {
     typedef DWORD(WINAPI* fn_t)(HKEY, GUID**);
-    static auto real = (fn_t)GetProcAddress(g_realDll, "PowerGetActiveScheme");
-    return real ? real(a, b) : 1;
+    auto real = (fn_t)g_realExports[PROXY_POWER_GET_ACTIVE_SCHEME];
+    return real ? real(a, b) : PROXY_FALLBACK_WIN32;
 }
 
 DWORD WINAPI Proxy_PowerSettingRegisterNotification(const GUID* a, DWORD b, HANDLE c, PHPOWERNOTIFY d) {
     typedef DWORD(WINAPI* fn_t)(const GUID*, DWORD, HANDLE, PHPOWERNOTIFY);
-    static auto real = (fn_t)GetProcAddress(g_realDll, "PowerSettingRegisterNotification");
-    return real ? real(a, b, c, d) : 1;
+    auto real = (fn_t)g_realExports[PROXY_POWER_SETTING_REGISTER_NOTIFICATION];
+    return real ? real(a, b, c, d) : PROXY_FALLBACK_WIN32;
 }
 
 DWORD WINAPI Proxy_PowerSettingUnregisterNotification(HPOWERNOTIFY a) {
     typedef DWORD(WINAPI* fn_t)(HPOWERNOTIFY);
-    static auto real = (fn_t)GetProcAddress(g_realDll, "PowerSettingUnregisterNotification");
-    return real ? real(a) : 1;
+    auto real = (fn_t)g_realExports[PROXY_POWER_SETTING_UNREGISTER_NOTIFICATION];
+    return real ? real(a) : PROXY_FALLBACK_WIN32;
 }
 
 } // extern "C"
@@ -56,10 +89,29 @@ bool Proxy_Init() {
     char dllPath[MAX_PATH];
     snprintf(dllPath, MAX_PATH, "%s\\powrprof.dll", systemDir);
     g_realDll = LoadLibraryA(dllPath);
-    return g_realDll != nullptr;
+    if (!g_realDll) return false;
+    for (int i = 0; i < PROXY_EXPORT_COUNT; i++) g_realExports[i] = GetProcAddress(g_realDll, kProxyExportNames[i]);
+    return true;
+}
+
+// "powrprof: 6/6 exports" or "powrprof: 5/6 exports, missing PowerGetActiveScheme"
+// into buf. Returns the number resolved.
+int Proxy_ExportStatus(char* buf, size_t cap) {
+    int resolved = 0;
+    for (int i = 0; i < PROXY_EXPORT_COUNT; i++) resolved += g_realExports[i] ? 1 : 0;
+    if (!buf || cap == 0) return resolved;
+    int off = snprintf(buf, cap, "powrprof: %d/%d exports", resolved, (int)PROXY_EXPORT_COUNT);
+    const char* sep = ", missing ";
+    for (int i = 0; i < PROXY_EXPORT_COUNT && off > 0 && (size_t)off < cap; i++) {
+        if (g_realExports[i]) continue;
+        off += snprintf(buf + off, cap - off, "%s%s", sep, kProxyExportNames[i]);
+        sep = ",";
+    }
+    return resolved;
 }
 
 void Proxy_Shutdown() {
+    for (int i = 0; i < PROXY_EXPORT_COUNT; i++) g_realExports[i] = nullptr;
     if (g_realDll) {
         FreeLibrary(g_realDll);
         g_realDll = nullptr;
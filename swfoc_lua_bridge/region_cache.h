@@ -0,0 +1,108 @@
+#pragma once
+// region_cache.h -- cached readability checks for engine pointer hops.
+//
+// Every hop in the bridge used to be guarded by IsBadReadPtr, including the
+// per-node loops of the tactical-list and selection walks and a 0x400-byte
+// probe per object in IsValidObjAddr. IsBadReadPtr is slow (it touches the
+// pages under a private exception handler) and can trip guard pages. The
+// MinGW build has no SEH to wrap a whole walk in, so the bridge asks
+// VirtualQuery instead and keeps the answers:
+//
+//   * A sorted set of non-overlapping [start, end) regions, each tagged
+//     readable or not. A lookup is a binary search; a range spanning
+//     adjacent regions is checked region by region.
+//   * Filled lazily: a miss costs one query for the region holding the
+//     address, and the whole region (often a full heap segment) is cached.
+//   * Invalidated when the caller's epoch changes (the bridge uses the
+//     luaD_call tick plus a short wall-clock window), so a region freed or
+//     re-protected by the engine is forgotten quickly. A full set is
+//     cleared and refilled rather than evicted entry by entry.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code; the
+// bridge supplies the VirtualQuery-backed query. Not thread-safe: the
+// bridge keeps one cache per thread.
+
+#include <cstdint>
+#include <cstring>
+
+#define REGION_CACHE_MAX 128
+
+struct RegionCacheEntry {
+    uint64_t start;
+    uint64_t end;       // exclusive
+    uint8_t  readable;
+};
+
+struct RegionCache {
+    uint64_t         epoch;
+    int              count;
+    uint32_t         hits;
+    uint32_t         misses;  // queries issued
+    RegionCacheEntry entries[REGION_CACHE_MAX];
+};
+
+inline void RegionCacheReset(RegionCache* c, uint64_t epoch) {
+    c->epoch = epoch;
+    c->count = 0;
+}
+
+// Index of the entry containing addr, or -1.
+inline int RegionCacheFind(const RegionCache* c, uint64_t addr) {
+    int lo = 0, hi = c->count;
+    while (lo < hi) {
+        const int mid = (lo + hi) >> 1;
+        if (c->entries[mid].end <= addr) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < c->count && c->entries[lo].start <= addr) ? lo : -1;
+}
+
+// Inserts [start, end), replacing any entries it overlaps.
+inline void RegionCacheInsert(RegionCache* c, uint64_t start, uint64_t end, bool readable) {
+    if (end <= start) return;
+    int first = 0;
+    while (first < c->count && c->entries[first].end <= start) first++;
+    int last = first;
+    while (last < c->count && c->entries[last].start < end) last++;
+    const int removed = last - first;
+    if (removed == 0 && c->count >= REGION_CACHE_MAX) {
+        c->count = 0;
+        first = last = 0;
+    }
+    const int tail = c->count - last;
+    if (removed != 1 && tail > 0) {
+        memmove(&c->entries[first + 1], &c->entries[last], sizeof(RegionCacheEntry) * tail);
+    }
+    c->entries[first].start = start;
+    c->entries[first].end = end;
+    c->entries[first].readable = readable ? 1 : 0;
+    c->count += 1 - removed;
+}
+
+// True when [addr, addr + len) is readable. query(uint64_t addr,
+// uint64_t* start, uint64_t* end, bool* readable) describes the region
+// holding addr and returns false when it cannot (treated as unreadable).
+template <typename Query>
+inline bool RegionCacheCanRead(RegionCache* c, uint64_t epoch, uint64_t addr, uint64_t len, Query query) {
+    if (len == 0) len = 1;
+    const uint64_t stop = addr + len;
+    if (stop < addr) return false;
+    if (c->epoch != epoch) RegionCacheReset(c, epoch);
+    while (addr < stop) {
+        int i = RegionCacheFind(c, addr);
+        if (i >= 0) {
+            c->hits++;
+        } else {
+            c->misses++;
+            uint64_t start = 0, end = 0;
+            bool readable = false;
+            if (!query(addr, &start, &end, &readable) || end <= addr || start > addr) return false;
+            RegionCacheInsert(c, start, end, readable);
+            i = RegionCacheFind(c, addr);
+            if (i < 0) return false;
+        }
+        if (!c->entries[i].readable) return false;
+        addr = c->entries[i].end;
+    }
+    return true;
+}
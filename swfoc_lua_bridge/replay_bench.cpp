@@ -0,0 +1,236 @@
+// replay_bench.cpp -- replay-path performance regression suite.
+//
+// bridge_bench.cpp reports numbers for a human to compare; this one fails.
+// It loads make_test_snapshot.py fixtures at three scales (10, 1000 and
+// 10000 units; 200 planets each) through the harness's own LoadSnapshot,
+// times the replay calls operators lean on, and checks every median
+// against replay_bench_budgets.txt:
+//
+//   load_snapshot        LoadSnapshot of the whole file into a fresh state
+//   find_unit            ReplayFindUnit of every unit            (per unit)
+//   set_hull             ReplayMutSetUnitHull of every unit      (per unit)
+//   set_position         ReplayMutSetUnitPosition of every unit  (per unit)
+//   units_in_radius      ReplayObsUnitsInRadius, grid rebuilt after a move
+//   list_tactical_units  ReplayObsListTacticalUnits CSV
+//   enumerate_units      ReplayObsEnumerateUnitsForSlot CSV, one slot
+//   list_planets         ReplayObsListPlanets CSV (200 planets)
+//   event_drain_csv      REPLAY_EVENT_DRAIN_ROWS hits, then the CSV drain
+//   event_drain_binary   the same hits, then the binary drain
+//
+// A case fails when its median ns/op is over budget * (1 + tolerance)
+// (--tolerance, default 0.5). The budgets only have to be right within a
+// few times -- they exist to catch a lookup turning linear or a container
+// reallocating per row -- so a second check is machine-independent: for
+// every per-item case the ns per item at 10000 units may be at most
+// REPLAY_BENCH_SCALE_MAX times the ns per item at 1000.
+//
+// Build + run via build_replay_bench.bat (it writes the fixtures first).
+//
+// Usage:
+//   replay_bench.exe [--dir <fixtures>] [--budgets <path>] [--tolerance <f>]
+//                    [--write-budgets <path>] [--filter <name>]
+//
+// --write-budgets records the current medians times REPLAY_BENCH_HEADROOM
+// as a new budgets file instead of checking. Exit status is 0 when every
+// case is within budget, 1 on any regression, 2 on a usage or fixture
+// error.
+
+#define REPLAY_HARNESS_NO_MAIN
+#include "replay_harness.cpp"
+
+#include <chrono>
+
+#define REPLAY_BENCH_SCALE_MAX 3.0  // ns/item at 10000 over ns/item at 1000
+#define REPLAY_BENCH_HEADROOM  3.0  // --write-budgets: budget = median * this
+#define REPLAY_BENCH_PLANETS   200
+
+static const int    kSamples  = 5;
+static const double kSampleMs = 20.0;
+static const int    kScales[] = {10, 1000, 10000};
+
+struct BenchResult {
+    std::string name;
+    int         n;
+    double      ns_op;
+    uint64_t    items;  // per op
+    bool        scales; // items grow with the fixture (the scaling check)
+};
+
+static std::vector<BenchResult> g_results;
+static const char* g_filter = nullptr;
+
+// Runs `op` until one sample lasts kSampleMs, then keeps the median of
+// kSamples samples, as bridge_bench.cpp's BenchRun.
+template <typename Op>
+static void BenchRun(const char* name, int n, uint64_t items, bool scales, Op&& op) {
+    if (g_filter && !strstr(name, g_filter)) return;
+    using Clock = std::chrono::steady_clock;
+    uint64_t calls = 1;
+    for (;;) {
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < calls; i++) op();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms >= kSampleMs / 4 || calls >= (1ull << 30)) {
+            calls = ms > 0.0 ? (uint64_t)(calls * kSampleMs / ms) + 1 : calls * 4;
+            break;
+        }
+        calls *= 2;
+    }
+    double ns[kSamples];
+    for (int s = 0; s < kSamples; s++) {
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < calls; i++) op();
+        ns[s] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (double)calls;
+    }
+    std::sort(ns, ns + kSamples);
+    g_results.push_back({name, n, ns[kSamples / 2], items, scales});
+}
+
+static void BenchScale(const std::string& path, int n) {
+    ReplayState loaded;
+    const SnapshotLoadResult r = LoadSnapshot(path.c_str(), loaded);
+    if (!r.ok || (int)loaded.units.size() != n || loaded.planets.size() != REPLAY_BENCH_PLANETS) {
+        fprintf(stderr, "%s: not a --scale %d --planets %d fixture (%s)\n", path.c_str(), n,
+                REPLAY_BENCH_PLANETS, r.ok ? "wrong counts" : r.error.c_str());
+        exit(2);
+    }
+    volatile size_t sink = 0;
+    BenchRun("load_snapshot", n, (uint64_t)n, true, [&]() {
+        ReplayState s;
+        sink = sink + LoadSnapshot(path.c_str(), s).total_bytes;
+    });
+
+    ReplayState s = loaded;
+    s.units.mut();  // the copy above shares the table; take it once, untimed
+    std::vector<uint64_t> objs;
+    for (const auto& entry : s.units) objs.push_back(entry.first);
+
+    BenchRun("find_unit", n, (uint64_t)n, true, [&]() {
+        for (uint64_t obj : objs) sink = sink + (ReplayFindUnit(s, obj) != nullptr);
+    });
+    BenchRun("set_hull", n, (uint64_t)n, true, [&]() {
+        for (uint64_t obj : objs) sink = sink + ReplayMutSetUnitHull(s, obj, 50.0f);
+    });
+    float step = 0.0f;
+    BenchRun("set_position", n, (uint64_t)n, true, [&]() {
+        step = step == 0.0f ? 1.0f : 0.0f;
+        for (size_t i = 0; i < objs.size(); i++)
+            sink = sink + ReplayMutSetUnitPosition(s, objs[i], (float)(i % 100) * 25.0f + step,
+                                                   (float)(i / 100) * 25.0f, 0.0f);
+    });
+    std::vector<uint64_t> hits;
+    BenchRun("units_in_radius", n, (uint64_t)n, true, [&]() {
+        ReplayMutSetUnitPosition(s, objs[0], step, 0.0f, 0.0f);
+        sink = sink + ReplayObsUnitsInRadius(s, 250.0f, 250.0f, 200.0f, &hits);
+    });
+    BenchRun("list_tactical_units", n, (uint64_t)n, true, [&]() { sink = sink + ReplayObsListTacticalUnits(s).size(); });
+    BenchRun("enumerate_units", n, (uint64_t)n, true, [&]() { sink = sink + ReplayObsEnumerateUnitsForSlot(s, 1).size(); });
+    BenchRun("list_planets", n, REPLAY_BENCH_PLANETS, false, [&]() { sink = sink + ReplayObsListPlanets(s).size(); });
+
+    const int rows = REPLAY_EVENT_DRAIN_ROWS;
+    BenchRun("event_drain_csv", n, rows, false, [&]() {
+        for (int i = 0; i < rows; i++) ReplayMutApplyDamage(s, objs[i % objs.size()], 0.0f);
+        sink = sink + ReplayObsEventStreamDrain(s).size();
+    });
+    std::vector<uint8_t> page;
+    BenchRun("event_drain_binary", n, rows, false, [&]() {
+        for (int i = 0; i < rows; i++) ReplayMutApplyDamage(s, objs[i % objs.size()], 0.0f);
+        page.clear();
+        sink = sink + ReplayObsEventStreamDrainBinary(s, &page);
+    });
+}
+
+// "<case> <n> <budget_ns_op>" lines; '#' starts a comment.
+static bool LoadBudgets(const char* path, std::map<std::pair<std::string, int>, double>* out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (char* hash = strchr(line, '#')) *hash = '\0';
+        char name[64];
+        int n;
+        double budget;
+        if (sscanf(line, "%63s %d %lf", name, &n, &budget) == 3) (*out)[{name, n}] = budget;
+    }
+    fclose(f);
+    return true;
+}
+
+static bool WriteBudgets(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# replay_bench.cpp budgets: <case> <units> <ns per op>.\n"
+               "# Written by replay_bench.exe --write-budgets (median x %.1f); a case\n"
+               "# fails above budget x (1 + --tolerance).\n", REPLAY_BENCH_HEADROOM);
+    for (const BenchResult& r : g_results) {
+        double budget = r.ns_op * REPLAY_BENCH_HEADROOM;
+        const double mag = std::pow(10.0, std::floor(std::log10(budget > 1.0 ? budget : 1.0)) - 1);
+        budget = std::ceil(budget / mag) * mag;  // two significant digits
+        fprintf(f, "%-20s %6d %12.0f\n", r.name.c_str(), r.n, budget);
+    }
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string dir = ".";
+    const char* budgetsPath = "replay_bench_budgets.txt";
+    const char* writePath = nullptr;
+    double tolerance = 0.5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) dir = argv[++i];
+        else if (strcmp(argv[i], "--budgets") == 0 && i + 1 < argc) budgetsPath = argv[++i];
+        else if (strcmp(argv[i], "--write-budgets") == 0 && i + 1 < argc) writePath = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) g_filter = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--dir <fixtures>] [--budgets <path>] [--tolerance <f>]\n"
+                            "          [--write-budgets <path>] [--filter <name>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::map<std::pair<std::string, int>, double> budgets;
+    if (!writePath && !LoadBudgets(budgetsPath, &budgets)) {
+        fprintf(stderr, "cannot read budgets %s (--write-budgets makes one)\n", budgetsPath);
+        return 2;
+    }
+    for (int n : kScales) BenchScale(dir + "/replay_bench_" + std::to_string(n) + ".swfocsnap", n);
+
+    if (writePath) {
+        if (!WriteBudgets(writePath)) {
+            fprintf(stderr, "cannot write %s\n", writePath);
+            return 2;
+        }
+        printf("wrote %zu budgets to %s\n", g_results.size(), writePath);
+        return 0;
+    }
+
+    printf("=== Replay regression suite (%d samples of >= %.0f ms, median; tolerance %.0f%%) ===\n", kSamples,
+           kSampleMs, tolerance * 100.0);
+    int failures = 0;
+    std::map<std::string, double> perItem1000;
+    for (const BenchResult& r : g_results) {
+        const auto it = budgets.find({r.name, r.n});
+        const char* verdict = "no budget";
+        if (it != budgets.end()) {
+            const bool over = r.ns_op > it->second * (1.0 + tolerance);
+            verdict = over ? "OVER BUDGET" : "ok";
+            if (over) failures++;
+        }
+        printf("  %-20s n=%-6d %12.0f ns/op  budget %10.0f  %s\n", r.name.c_str(), r.n, r.ns_op,
+               it != budgets.end() ? it->second : 0.0, verdict);
+        if (r.n == 1000 && r.scales) perItem1000[r.name] = r.ns_op / (double)r.items;
+    }
+    for (const BenchResult& r : g_results) {
+        if (r.n != 10000 || !r.scales || !perItem1000.count(r.name)) continue;
+        const double ratio = (r.ns_op / (double)r.items) / perItem1000[r.name];
+        if (ratio > REPLAY_BENCH_SCALE_MAX) {
+            printf("  %-20s ns/item grew %.1fx from 1000 to 10000 units (max %.1fx)  SCALING\n", r.name.c_str(),
+                   ratio, REPLAY_BENCH_SCALE_MAX);
+            failures++;
+        }
+    }
+    printf("=== %s: %d regression(s) ===\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? 1 : 0;
+}
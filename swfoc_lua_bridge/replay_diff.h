@@ -0,0 +1,390 @@
+#pragma once
+// replay_diff.h -- field-level diff of two snapshots for
+// `swfoc_replay.exe --diff <a> <b>`.
+//
+// Comparing two captures (before and after a trainer action, or across
+// game versions) used to mean two --dump runs and eyeballing. The diff runs
+// one section group at a time: the harness loads just that group's
+// sections of both files into two fresh ReplayStates, ReplayDiffSection
+// appends a JSON line per difference, and both states are dropped before
+// the next group, so a late-game capture never has both files decoded at
+// once.
+//
+//   * Records are matched by key: players by slot, objects / globals /
+//     metadata / planets / cooldowns / object owners by name, diplomacy by
+//     faction pair, units by obj_addr; Lua states and task forces, which
+//     carry no key, by position. Every table but players is already in key
+//     order (ReplayFlatMap), so matching is one merge pass.
+//   * A record in one file only is {"change":"added"|"removed"}; a record
+//     in both yields one {"field","a","b"} line per field that differs. A
+//     group one file has no sections for is reported once, key-less.
+//   * Floats print with 9 significant digits and doubles with 17, so
+//     values that differ never print alike. Lists (cooldowns, owners, the
+//     selection, a hardpoint's behaviors) are compared and printed whole.
+//   * Only what the snapshot sections carry is compared; runtime-only
+//     ReplayState fields (multipliers, abilities, the tick clock) are
+//     equal after a load and are skipped.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code; the
+// harness owns file loading and the CLI.
+// Not thread-safe: one sink per caller.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "replay_state.h"
+
+// Section groups, in output order. Sections 11-14 load together: 13 and 14
+// attach to the units section 12 defines.
+enum ReplayDiffGroupId {
+    REPLAY_DIFF_PLAYERS = 0,
+    REPLAY_DIFF_LUA_STATES,
+    REPLAY_DIFF_OBJECTS,
+    REPLAY_DIFF_GLOBALS,
+    REPLAY_DIFF_METADATA,
+    REPLAY_DIFF_PLANETS,
+    REPLAY_DIFF_DIPLOMACY,
+    REPLAY_DIFF_COOLDOWNS,
+    REPLAY_DIFF_TASK_FORCES,
+    REPLAY_DIFF_OBJECT_OWNERS,
+    REPLAY_DIFF_UNITS,
+    REPLAY_DIFF_GROUPS
+};
+
+struct ReplayDiffGroupInfo {
+    const char* name;
+    uint32_t    sections;  // LoadSnapshot mask: bit `id` = section id
+};
+
+inline const ReplayDiffGroupInfo& ReplayDiffGroup(int group) {
+    static const ReplayDiffGroupInfo kGroups[REPLAY_DIFF_GROUPS] = {
+        {"players",       1u << 1},
+        {"lua_states",    1u << 2},
+        {"objects",       1u << 3},
+        {"globals",       1u << 4},
+        {"metadata",      1u << 5},
+        {"planets",       1u << 6},
+        {"diplomacy",     1u << 7},
+        {"cooldowns",     1u << 8},
+        {"task_forces",   1u << 9},
+        {"object_owners", 1u << 10},
+        {"units",         (1u << 11) | (1u << 12) | (1u << 13) | (1u << 14)},
+    };
+    return kGroups[group];
+}
+
+// ---- JSON output -----------------------------------------------------------
+
+inline void ReplayJsonString(std::string* out, std::string_view s) {
+    out->push_back('"');
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            out->push_back('\\');
+            out->push_back(static_cast<char>(c));
+        } else if (c == '\n') {
+            out->append("\\n");
+        } else if (c == '\r') {
+            out->append("\\r");
+        } else if (c == '\t') {
+            out->append("\\t");
+        } else if (c < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out->append(esc);
+        } else {
+            out->push_back(static_cast<char>(c));
+        }
+    }
+    out->push_back('"');
+}
+
+// JSON number, or a string for the non-finite values JSON has no literal
+// for.
+inline std::string ReplayDiffReal(double v, int digits) {
+    if (std::isnan(v)) return "\"nan\"";
+    if (std::isinf(v)) return v < 0 ? "\"-inf\"" : "\"inf\"";
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%.*g", digits, v);
+    return buf;
+}
+
+inline std::string ReplayDiffText(std::string_view s) {
+    std::string out;
+    ReplayJsonString(&out, s);
+    return out;
+}
+
+inline std::string ReplayDiffHex(uint64_t v) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(v));
+    return buf;
+}
+
+template <typename List, typename Encode>
+inline std::string ReplayDiffList(const List& v, Encode&& encode) {
+    std::string out = "[";
+    for (size_t i = 0; i < v.size(); i++) {
+        if (i) out.push_back(',');
+        out += encode(v[i]);
+    }
+    out.push_back(']');
+    return out;
+}
+
+// Appends the JSON lines of one section group and counts them.
+struct ReplayDiffSink {
+    std::string* out     = nullptr;
+    const char*  section = "";
+    size_t       changes = 0;
+};
+
+inline void ReplayDiffOpen(ReplayDiffSink* d, const std::string* key) {
+    d->out->append("{\"section\":\"");
+    d->out->append(d->section);
+    d->out->push_back('"');
+    if (key) {
+        d->out->append(",\"key\":");
+        ReplayJsonString(d->out, *key);
+    }
+    d->changes++;
+}
+
+// A record (or, with key == nullptr, the whole group) only one file has.
+inline void ReplayDiffPresence(ReplayDiffSink* d, const std::string* key, bool added) {
+    ReplayDiffOpen(d, key);
+    d->out->append(added ? ",\"change\":\"added\"}\n" : ",\"change\":\"removed\"}\n");
+}
+
+// One differing field; a and b are JSON values.
+inline void ReplayDiffEmit(ReplayDiffSink* d, const std::string& key, const char* field,
+                           const std::string& a, const std::string& b) {
+    ReplayDiffOpen(d, &key);
+    d->out->append(",\"field\":\"");
+    d->out->append(field);
+    d->out->append("\",\"a\":");
+    d->out->append(a);
+    d->out->append(",\"b\":");
+    d->out->append(b);
+    d->out->append("}\n");
+}
+
+inline void ReplayDiffInt(ReplayDiffSink* d, const std::string& key, const char* field, long long a, long long b) {
+    if (a != b) ReplayDiffEmit(d, key, field, std::to_string(a), std::to_string(b));
+}
+
+inline void ReplayDiffFloat(ReplayDiffSink* d, const std::string& key, const char* field, double a, double b,
+                            int digits = 9) {
+    if (a == b || (std::isnan(a) && std::isnan(b))) return;
+    ReplayDiffEmit(d, key, field, ReplayDiffReal(a, digits), ReplayDiffReal(b, digits));
+}
+
+inline void ReplayDiffString(ReplayDiffSink* d, const std::string& key, const char* field, std::string_view a,
+                             std::string_view b) {
+    if (a != b) ReplayDiffEmit(d, key, field, ReplayDiffText(a), ReplayDiffText(b));
+}
+
+// Merge-joins two key-ordered ranges of (key, value) pairs: keyText(key)
+// names a record, same(name, va, vb) compares a matched pair.
+template <typename Range, typename KeyText, typename Same>
+inline void ReplayDiffJoin(ReplayDiffSink* d, const Range& a, const Range& b, KeyText&& keyText, Same&& same) {
+    auto ia = a.begin(), ib = b.begin();
+    while (ia != a.end() || ib != b.end()) {
+        if (ib == b.end() || (ia != a.end() && ia->first < ib->first)) {
+            const std::string k = keyText(ia->first);
+            ReplayDiffPresence(d, &k, false);
+            ++ia;
+        } else if (ia == a.end() || ib->first < ia->first) {
+            const std::string k = keyText(ib->first);
+            ReplayDiffPresence(d, &k, true);
+            ++ib;
+        } else {
+            same(keyText(ia->first), ia->second, ib->second);
+            ++ia;
+            ++ib;
+        }
+    }
+}
+
+// (index, element) pairs for the tables matched by position.
+template <typename T>
+inline std::vector<std::pair<size_t, const T*>> ReplayDiffByIndex(const std::vector<T>& v) {
+    std::vector<std::pair<size_t, const T*>> out;
+    out.reserve(v.size());
+    for (size_t i = 0; i < v.size(); i++) out.emplace_back(i, &v[i]);
+    return out;
+}
+
+// ---- Groups ----------------------------------------------------------------
+
+// Header fields: format, capture time, build hash, game mode.
+inline size_t ReplayDiffHeader(const ReplayState& a, const ReplayState& b, std::string* out) {
+    ReplayDiffSink d;
+    d.out = out;
+    d.section = "header";
+    const std::string k;
+    ReplayDiffInt(&d, k, "format_version", a.format_version, b.format_version);
+    ReplayDiffInt(&d, k, "capture_timestamp_ms", static_cast<long long>(a.capture_timestamp_ms),
+                  static_cast<long long>(b.capture_timestamp_ms));
+    if (memcmp(a.engine_build_hash, b.engine_build_hash, sizeof(a.engine_build_hash)) != 0) {
+        auto hex = [](const uint8_t* h) {
+            std::string s = "\"";
+            char byte[4];
+            for (int i = 0; i < 32; i++) {
+                snprintf(byte, sizeof(byte), "%02x", h[i]);
+                s += byte;
+            }
+            return s + "\"";
+        };
+        ReplayDiffEmit(&d, k, "engine_build_hash", hex(a.engine_build_hash), hex(b.engine_build_hash));
+    }
+    ReplayDiffInt(&d, k, "game_mode", a.game_mode, b.game_mode);
+    return d.changes;
+}
+
+// Diffs group `group` of two states that hold (at least) its sections.
+// `loadedA` / `loadedB` say whether each file had any of them. Returns the
+// lines appended.
+inline size_t ReplayDiffSection(int group, const ReplayState& a, bool loadedA, const ReplayState& b, bool loadedB,
+                              std::string* out) {
+    ReplayDiffSink d;
+    d.out = out;
+    d.section = ReplayDiffGroup(group).name;
+    if (loadedA != loadedB) ReplayDiffPresence(&d, nullptr, loadedB);
+    auto name = [](const std::string& s) { return s; };
+    auto num = [](size_t i) { return std::to_string(i); };
+    switch (group) {
+    case REPLAY_DIFF_PLAYERS: {
+        ReplayDiffInt(&d, "", "local_slot", a.local_slot, b.local_slot);
+        auto bySlot = [](const ReplayState& s) {
+            std::vector<std::pair<uint32_t, const ReplayPlayer*>> v;
+            for (const auto& p : s.players) v.emplace_back(p.slot, &p);
+            std::stable_sort(v.begin(), v.end(),
+                             [](const std::pair<uint32_t, const ReplayPlayer*>& x,
+                                const std::pair<uint32_t, const ReplayPlayer*>& y) { return x.first < y.first; });
+            return v;
+        };
+        ReplayDiffJoin(&d, bySlot(a), bySlot(b), [](uint32_t slot) { return std::to_string(slot); },
+                       [&d](const std::string& k, const ReplayPlayer* x, const ReplayPlayer* y) {
+                           ReplayDiffString(&d, k, "faction_name", x->faction_name, y->faction_name);
+                           ReplayDiffFloat(&d, k, "credits", x->credits, y->credits, 17);
+                           ReplayDiffInt(&d, k, "tech_level", x->tech_level, y->tech_level);
+                           ReplayDiffString(&d, k, "player_name", x->player_name, y->player_name);
+                       });
+        break;
+    }
+    case REPLAY_DIFF_LUA_STATES:
+        ReplayDiffJoin(&d, ReplayDiffByIndex(a.lua_state_ptrs), ReplayDiffByIndex(b.lua_state_ptrs), num,
+                       [&d](const std::string& k, const uint64_t* x, const uint64_t* y) {
+                           if (*x != *y) ReplayDiffEmit(&d, k, "ptr", ReplayDiffText(ReplayDiffHex(*x)),
+                                                        ReplayDiffText(ReplayDiffHex(*y)));
+                       });
+        break;
+    case REPLAY_DIFF_OBJECTS:
+        ReplayDiffJoin(&d, a.objects.get(), b.objects.get(), name,
+                       [&d](const std::string& k, uint32_t x, uint32_t y) { ReplayDiffInt(&d, k, "count", x, y); });
+        break;
+    case REPLAY_DIFF_GLOBALS:
+        ReplayDiffJoin(&d, a.globals.get(), b.globals.get(), name,
+                       [&d](const std::string& k, const ReplayGlobal& x, const ReplayGlobal& y) {
+                           ReplayDiffInt(&d, k, "lua_type", x.lua_type, y.lua_type);
+                           if (x.raw_value_or_ptr != y.raw_value_or_ptr) {
+                               ReplayDiffEmit(&d, k, "raw_value_or_ptr", ReplayDiffText(ReplayDiffHex(x.raw_value_or_ptr)),
+                                              ReplayDiffText(ReplayDiffHex(y.raw_value_or_ptr)));
+                           }
+                       });
+        break;
+    case REPLAY_DIFF_METADATA:
+        ReplayDiffJoin(&d, a.metadata.get(), b.metadata.get(), name,
+                       [&d](const std::string& k, const std::string& x, const std::string& y) {
+                           ReplayDiffString(&d, k, "value", x, y);
+                       });
+        break;
+    case REPLAY_DIFF_PLANETS:
+        ReplayDiffJoin(&d, a.planets.get(), b.planets.get(), name,
+                       [&d](const std::string& k, const ReplayPlanetInfo& x, const ReplayPlanetInfo& y) {
+                           ReplayDiffFloat(&d, k, "corruption", x.corruption, y.corruption);
+                           ReplayDiffInt(&d, k, "owner_slot", x.owner_slot, y.owner_slot);
+                           ReplayDiffInt(&d, k, "tech_level", x.tech_level, y.tech_level);
+                           ReplayDiffInt(&d, k, "building_count", x.building_count, y.building_count);
+                           ReplayDiffInt(&d, k, "is_capital", x.is_capital, y.is_capital);
+                       });
+        break;
+    case REPLAY_DIFF_DIPLOMACY:
+        // Keys are interned-symbol pairs; both states share the process's
+        // symbol table, so equal faction pairs have equal keys.
+        ReplayDiffJoin(&d, a.diplomacy.get(), b.diplomacy.get(),
+                       [](uint64_t key) {
+                           return ReplaySymbolName(static_cast<ReplaySymbol>(key >> 32)) + "|"
+                                  + ReplaySymbolName(static_cast<ReplaySymbol>(key & 0xFFFFFFFFu));
+                       },
+                       [&d](const std::string& k, const std::string& x, const std::string& y) {
+                           ReplayDiffString(&d, k, "state", x, y);
+                       });
+        break;
+    case REPLAY_DIFF_COOLDOWNS:
+        ReplayDiffJoin(&d, a.cooldowns.get(), b.cooldowns.get(), name,
+                       [&d](const std::string& k, const std::vector<float>& x, const std::vector<float>& y) {
+                           if (x == y) return;
+                           auto f = [](float v) { return ReplayDiffReal(v, 9); };
+                           ReplayDiffEmit(&d, k, "values", ReplayDiffList(x, f), ReplayDiffList(y, f));
+                       });
+        break;
+    case REPLAY_DIFF_TASK_FORCES:
+        ReplayDiffJoin(&d, ReplayDiffByIndex(a.task_forces.get()), ReplayDiffByIndex(b.task_forces.get()), num,
+                       [&d](const std::string& k, const ReplayTaskForceRecord* x, const ReplayTaskForceRecord* y) {
+                           ReplayDiffInt(&d, k, "owner_slot", x->owner_slot, y->owner_slot);
+                           ReplayDiffString(&d, k, "name", x->name, y->name);
+                       });
+        break;
+    case REPLAY_DIFF_OBJECT_OWNERS:
+        ReplayDiffJoin(&d, a.object_owners.get(), b.object_owners.get(), name,
+                       [&d](const std::string& k, const std::vector<int32_t>& x, const std::vector<int32_t>& y) {
+                           if (x == y) return;
+                           auto i = [](int32_t v) { return std::to_string(v); };
+                           ReplayDiffEmit(&d, k, "slots", ReplayDiffList(x, i), ReplayDiffList(y, i));
+                       });
+        break;
+    case REPLAY_DIFF_UNITS: {
+        if (a.selected_units != b.selected_units) {
+            auto h = [](uint64_t v) { return ReplayDiffText(ReplayDiffHex(v)); };
+            ReplayDiffEmit(&d, "", "selected", ReplayDiffList(a.selected_units, h), ReplayDiffList(b.selected_units, h));
+        }
+        ReplayDiffJoin(&d, a.units.get(), b.units.get(), ReplayDiffHex,
+                       [&d](const std::string& k, const ReplayUnitDetail& x, const ReplayUnitDetail& y) {
+                           ReplayDiffString(&d, k, "type_name", x.type_name, y.type_name);
+                           ReplayDiffInt(&d, k, "owner_slot", x.owner_slot, y.owner_slot);
+                           ReplayDiffFloat(&d, k, "hull", x.hull, y.hull);
+                           ReplayDiffFloat(&d, k, "max_hull", x.max_hull, y.max_hull);
+                           ReplayDiffInt(&d, k, "invuln_flag", x.invuln_flag, y.invuln_flag);
+                           ReplayDiffInt(&d, k, "prevent_death", x.prevent_death, y.prevent_death);
+                           ReplayDiffInt(&d, k, "has_pos", x.has_pos, y.has_pos);
+                           ReplayDiffFloat(&d, k, "pos_x", x.pos_x, y.pos_x);
+                           ReplayDiffFloat(&d, k, "pos_y", x.pos_y, y.pos_y);
+                           ReplayDiffFloat(&d, k, "pos_z", x.pos_z, y.pos_z);
+                           ReplayDiffInt(&d, k, "hardpoint_count", static_cast<long long>(x.hardpoints.size()),
+                                         static_cast<long long>(y.hardpoints.size()));
+                           const size_t n = std::min(x.hardpoints.size(), y.hardpoints.size());
+                           for (size_t i = 0; i < n; i++) {
+                               const ReplayHardpoint& hx = x.hardpoints[i];
+                               const ReplayHardpoint& hy = y.hardpoints[i];
+                               const std::string hk = k + "/hp" + std::to_string(i);
+                               ReplayDiffInt(&d, hk, "index", hx.index, hy.index);
+                               if (hx.behaviors != hy.behaviors) {
+                                   auto s = [](ReplaySymbol v) { return ReplayDiffText(ReplaySymbolName(v)); };
+                                   ReplayDiffEmit(&d, hk, "behaviors", ReplayDiffList(hx.behaviors, s),
+                                                  ReplayDiffList(hy.behaviors, s));
+                               }
+                           }
+                       });
+        break;
+    }
+    }
+    return d.changes;
+}
@@ -0,0 +1,208 @@
+#pragma once
+// replay_flat.h -- flat containers behind ReplayState.
+//
+// ReplayState kept every keyed table in a std::map, so each ReplayFindUnit
+// and ReplayObs* lookup chased tree nodes scattered over the heap. The
+// tables are written at load time and by the odd mutation, then read on
+// every helper call, so they now sit in contiguous storage:
+//
+//   * ReplayFlatMap: a vector of (key, value) pairs sorted by key, plus a
+//     dense copy of the keys that the binary search runs over. Iteration
+//     stays in key order, so replies that list a table (ListPlanets, unit
+//     dumps) keep their byte-exact order. Inserting a key past the last one
+//     appends; anything else shifts the tail.
+//   * ReplaySlotTable: one inline cell per player slot plus a presence
+//     mask, for the per-slot override tables. Slots outside
+//     [0, REPLAY_SLOTS) are never present; the mutators reject them.
+//
+// Both keep the std::map subset the helpers use (find / count / [] /
+// try_emplace / erase / clear / size / empty), so call sites read as
+// before. Unlike std::map, inserting or erasing moves elements: do not
+// hold a reference or ReplayFindUnit pointer across an insertion into the
+// same table.
+//
+// The snapshot-sized tables are further held in a ReplayCow, so copying a
+// ReplayState (SWFOC_ReplayFork) shares them instead of copying them:
+//
+//   * Reads go through the const forwarders (find / count / size / empty /
+//     begin / end / [] / front / back) or get(), and never copy.
+//   * Writes go through mut(), which first copies the table if another
+//     state still shares it -- so a fork pays only for the tables that
+//     change after it, once each. Hold what mut() returns no longer than
+//     the write: a later copy of the state shares the table again.
+//   * A default-constructed ReplayCow allocates nothing; it reads as an
+//     empty table until the first mut().
+//
+// Header-only and std-only; included by replay_state.h.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#define REPLAY_SLOTS 16  // player slots the per-slot tables hold (the engine caps players at 8)
+
+template <typename K, typename V>
+class ReplayFlatMap {
+public:
+    typedef std::pair<K, V>                        value_type;
+    typedef typename std::vector<value_type>::iterator       iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    iterator       begin()       { return items_.begin(); }
+    iterator       end()         { return items_.end(); }
+    const_iterator begin() const { return items_.begin(); }
+    const_iterator end()   const { return items_.end(); }
+
+    size_t size()  const { return items_.size(); }
+    bool   empty() const { return items_.empty(); }
+    void   clear()           { keys_.clear(); items_.clear(); }
+    void   reserve(size_t n) { keys_.reserve(n); items_.reserve(n); }
+
+    iterator       lower_bound(const K& key)       { return items_.begin() + Lower(key); }
+    const_iterator lower_bound(const K& key) const { return items_.begin() + Lower(key); }
+
+    iterator find(const K& key) {
+        const size_t i = Lower(key);
+        return (i < keys_.size() && !(key < keys_[i])) ? items_.begin() + i : items_.end();
+    }
+    const_iterator find(const K& key) const {
+        const size_t i = Lower(key);
+        return (i < keys_.size() && !(key < keys_[i])) ? items_.begin() + i : items_.end();
+    }
+
+    size_t count(const K& key) const { return find(key) != end() ? 1 : 0; }
+
+    V& operator[](const K& key) { return try_emplace(key); }
+
+    // The value for `key`, constructed from `args` when the key is new.
+    template <typename... A>
+    V& try_emplace(const K& key, A&&... args) {
+        size_t i = keys_.size();
+        if (!keys_.empty() && !(keys_.back() < key)) {
+            i = Lower(key);
+            if (!(key < keys_[i])) return items_[i].second;
+        }
+        keys_.insert(keys_.begin() + i, key);
+        return items_.emplace(items_.begin() + i, std::piecewise_construct, std::forward_as_tuple(key),
+                              std::forward_as_tuple(std::forward<A>(args)...))->second;
+    }
+
+    V& at(const K& key) {
+        iterator it = find(key);
+        if (it == items_.end()) throw std::out_of_range("ReplayFlatMap::at");
+        return it->second;
+    }
+    const V& at(const K& key) const {
+        const_iterator it = find(key);
+        if (it == items_.end()) throw std::out_of_range("ReplayFlatMap::at");
+        return it->second;
+    }
+
+    size_t erase(const K& key) {
+        iterator it = find(key);
+        if (it == items_.end()) return 0;
+        erase(it);
+        return 1;
+    }
+    iterator erase(iterator it) {
+        keys_.erase(keys_.begin() + (it - items_.begin()));
+        return items_.erase(it);
+    }
+
+private:
+    size_t Lower(const K& key) const {
+        return static_cast<size_t>(std::lower_bound(keys_.begin(), keys_.end(), key) - keys_.begin());
+    }
+    // keys_[i] == items_[i].first. The search runs over keys_ alone, so a
+    // lookup in a table of large records touches a few dense cache lines
+    // instead of one line per record probed.
+    std::vector<K>          keys_;
+    std::vector<value_type> items_;
+};
+
+// find() hands back a pointer to the (slot, value) cell, or end() (nullptr),
+// so `it != t.end()` / `it->second` read as they do for a std::map.
+template <typename V>
+class ReplaySlotTable {
+public:
+    typedef std::pair<int32_t, V> value_type;
+
+    value_type*       end()       { return nullptr; }
+    const value_type* end() const { return nullptr; }
+
+    size_t size()  const {
+        size_t n = 0;
+        for (uint32_t m = present_; m; m &= m - 1) n++;
+        return n;
+    }
+    bool empty() const { return present_ == 0; }
+    void clear()       { present_ = 0; }
+
+    value_type* find(int32_t slot) {
+        return Has(slot) ? &cells_[slot] : nullptr;
+    }
+    const value_type* find(int32_t slot) const {
+        return Has(slot) ? &cells_[slot] : nullptr;
+    }
+
+    size_t count(int32_t slot) const { return Has(slot) ? 1 : 0; }
+
+    // slot must lie in [0, REPLAY_SLOTS).
+    V& operator[](int32_t slot) {
+        if (!Has(slot)) {
+            cells_[slot] = value_type(slot, V());
+            present_ |= 1u << slot;
+        }
+        return cells_[slot].second;
+    }
+
+    size_t erase(int32_t slot) {
+        if (!Has(slot)) return 0;
+        present_ &= ~(1u << slot);
+        return 1;
+    }
+
+private:
+    bool Has(int32_t slot) const {
+        return slot >= 0 && slot < REPLAY_SLOTS && (present_ & (1u << slot));
+    }
+    value_type cells_[REPLAY_SLOTS];
+    uint32_t   present_ = 0;
+};
+
+template <typename T>
+class ReplayCow {
+public:
+    const T& get() const { return p_ ? *p_ : Empty(); }
+
+    T& mut() {
+        if (!p_) p_ = std::make_shared<T>();
+        else if (p_.use_count() > 1) p_ = std::make_shared<T>(*p_);
+        return *p_;
+    }
+
+    // True while `o` still reads the same table (a fork not yet written).
+    bool SharedWith(const ReplayCow& o) const { return p_ && p_ == o.p_; }
+
+    decltype(auto) begin() const { return get().begin(); }
+    decltype(auto) end()   const { return get().end(); }
+    size_t size()  const { return get().size(); }
+    bool   empty() const { return get().empty(); }
+    decltype(auto) front() const { return get().front(); }
+    decltype(auto) back()  const { return get().back(); }
+    template <typename K> decltype(auto) find(const K& k) const { return get().find(k); }
+    template <typename K> size_t count(const K& k) const { return get().count(k); }
+    template <typename I> decltype(auto) operator[](const I& i) const { return get()[i]; }
+
+private:
+    static const T& Empty() {
+        static const T e;
+        return e;
+    }
+    std::shared_ptr<T> p_;
+};
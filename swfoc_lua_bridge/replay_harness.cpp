@@ -13,11 +13,17 @@
 //       replay_harness.cpp fake_lua.cpp fake_memory.cpp -lws2_32
 //
 // Usage:
-//   swfoc_replay.exe <path-to-snapshot.swfocsnap>
+//   swfoc_replay.exe <path-to-snapshot.swfocsnap> [--base <snapshot> ...]
+//   swfoc_replay.exe --corpus <dir|list> --exec "<lua>" [...] [--jobs <n>]
+//                    [--format jsonl|csv]
+//   swfoc_replay.exe <path-to-snapshot.swfocsnap> --instance <tag|pid>
+//   swfoc_replay.exe --list-instances
 //
 // The live bridge continues to own `\\.\pipe\swfoc_bridge`; this harness
 // uses a distinct pipe name so it can run alongside the live game without
-// competing for the same pipe.
+// competing for the same pipe. --instance suffixes that name so many
+// servers can share a machine; each registers in %TEMP%\swfoc_instances
+// (instance_names.h) for --list-instances.
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -28,6 +34,8 @@
 #include <cstring>
 #include <cstdint>
 #include <cstdarg>
+#include <ctime>
+#include <cctype>
 #include <string>
 #include <vector>
 #include <map>
@@ -38,6 +46,16 @@
 #include "lua_types.h"
 #include "fake_lua.h"
 #include "replay_state.h"
+#include "replay_diff.h"
+#include "replay_sweep.h"
+#include "replay_tick.h"
+#include "crc32.h"
+#include "snap_lz4.h"
+#include "snap_delta.h"
+#include "snap_index.h"
+#include "snap_reader.h"
+#include "instance_names.h"
+#include "timeline_replay.h"
 
 // ======================================================================
 // Pipe protocol constants
@@ -46,15 +64,25 @@
 #define REPLAY_PIPE_NAME "\\\\.\\pipe\\swfoc_bridge_replay"
 #define PIPE_CMD_MAX     4096
 
+// REPLAY_PIPE_NAME, or REPLAY_PIPE_NAME_<tag> under --instance
+// (instance_names.h), so many replay servers can listen on one machine.
+static char g_replayPipeName[INSTANCE_NAME_MAX] = REPLAY_PIPE_NAME;
+
 // ======================================================================
 // ReplayState -- the in-memory projection of a decoded .swfocsnap file
 // ======================================================================
 
 // ReplayPlayer / ReplayGlobal / ReplayState etc. are defined in
 // replay_state.h so the bridge test harness can include them too.
-// `g_replay` is the single in-memory snapshot the pipe listener mutates.
+// `g_replay` is the in-memory snapshot the helpers read and mutate. It is
+// per thread: the main thread's serves --dump, --exec and the pipe listener
+// (which runs on the main thread), and each --corpus worker loads its own.
 
-static ReplayState g_replay;
+static thread_local ReplayState g_replay;
+static thread_local ReplayForkTable g_replayForks;  // SWFOC_ReplayFork, per g_replay
+// Read-only access to g_replay: lookups through it pick the const overloads,
+// which leave tables shared with a fork instead of detaching them.
+static const ReplayState& ReplayView() { return g_replay; }
 
 // File-local convenience aliases so existing call sites stay readable.
 // (The test harness uses Replay* prefixed names from replay_state.h.)
@@ -62,7 +90,7 @@ static inline std::string ToUpperAscii(const std::string& s) {
     return ReplayUpper(s);
 }
 
-static inline std::pair<std::string, std::string>
+static inline uint64_t
 MakeDiplomacyKey(const std::string& a, const std::string& b) {
     return ReplayDiplomacyKey(a, b);
 }
@@ -88,526 +116,245 @@ static void LogOut(const char* fmt, ...) {
 }
 
 // ======================================================================
-// CRC32 (matches the live bridge writer: polynomial 0xEDB88320, reflected,
-// init/xor 0xFFFFFFFF -- the zlib/PKZIP variant).
+// Snapshot reader (matches SNAPSHOT_FORMAT.md byte layout exactly). The
+// parser itself is snap_reader.h; this is the file layer around it.
 // ======================================================================
 
-static uint32_t g_crc32Table[256];
-static bool     g_crc32TableReady = false;
-
-static void Crc32_BuildTable() {
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t c = i;
-        for (int k = 0; k < 8; k++)
-            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
-        g_crc32Table[i] = c;
-    }
-    g_crc32TableReady = true;
-}
-
-static uint32_t Crc32_Compute(const void* data, size_t len) {
-    if (!g_crc32TableReady) Crc32_BuildTable();
-    uint32_t crc = 0xFFFFFFFFu;
-    const uint8_t* p = static_cast<const uint8_t*>(data);
-    for (size_t i = 0; i < len; i++)
-        crc = g_crc32Table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
-    return crc ^ 0xFFFFFFFFu;
-}
-
-// ======================================================================
-// Snapshot reader (matches SNAPSHOT_FORMAT.md byte layout exactly)
-// ======================================================================
-
-// Small cursor over a raw byte buffer, little-endian reads.
-class SnapCursor {
+// Read-only mapping of a whole file. A v1 / v2 snapshot is parsed straight
+// out of the view: no read into a buffer, no copy.
+class SnapMappedFile {
 public:
-    SnapCursor(const uint8_t* data, size_t size) : p_(data), size_(size) {}
-
-    bool ok() const { return ok_; }
-    size_t pos() const { return off_; }
-    size_t remaining() const { return off_ < size_ ? size_ - off_ : 0; }
-
-    bool read_bytes(void* out, size_t n) {
-        if (!ok_) return false;
-        if (off_ + n > size_) { ok_ = false; return false; }
-        memcpy(out, p_ + off_, n);
-        off_ += n;
-        return true;
-    }
-
-    bool read_u8 (uint8_t*  v) { return read_bytes(v, 1); }
-    bool read_u16(uint16_t* v) { return read_bytes(v, 2); }
-    bool read_u32(uint32_t* v) { return read_bytes(v, 4); }
-    bool read_u64(uint64_t* v) { return read_bytes(v, 8); }
-    bool read_i32(int32_t*  v) { return read_bytes(v, 4); }
-    bool read_f64(double*   v) { return read_bytes(v, 8); }
-
-    bool skip(size_t n) {
-        if (!ok_) return false;
-        if (off_ + n > size_) { ok_ = false; return false; }
-        off_ += n;
+    SnapMappedFile() = default;
+    SnapMappedFile(const SnapMappedFile&) = delete;
+    SnapMappedFile& operator=(const SnapMappedFile&) = delete;
+    ~SnapMappedFile() { Close(); }
+
+    const uint8_t* data() const { return view_; }
+    size_t size() const { return size_; }
+
+    // Closes any file already open first.
+    bool Open(const std::string& path, std::string* err) {
+        Close();
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            *err = "could not open snapshot file: " + path;
+            return false;
+        }
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file_, &sz) || sz.QuadPart < 68 + 12) {  // header + minimal end marker
+            *err = "snapshot file is smaller than the minimum valid size (80 bytes)";
+            return false;
+        }
+        map_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        view_ = map_ ? static_cast<const uint8_t*>(MapViewOfFile(map_, FILE_MAP_READ, 0, 0, 0))
+                     : nullptr;
+        if (!view_) {
+            *err = "could not map snapshot file: " + path;
+            return false;
+        }
+        size_ = static_cast<size_t>(sz.QuadPart);
         return true;
     }
 
-    // Read a fixed-width, null-padded ASCII field and trim at the first null.
-    bool read_fixed_str(std::string* out, size_t width) {
-        std::vector<char> tmp(width + 1, 0);
-        if (!read_bytes(tmp.data(), width)) return false;
-        tmp[width] = '\0';
-        *out = std::string(tmp.data());
-        return true;
+private:
+    void Close() {
+        if (view_) UnmapViewOfFile(view_);
+        if (map_) CloseHandle(map_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+        map_ = nullptr;
+        view_ = nullptr;
+        size_ = 0;
     }
 
-private:
-    const uint8_t* p_;
+    HANDLE         file_ = INVALID_HANDLE_VALUE;
+    HANDLE         map_  = nullptr;
+    const uint8_t* view_ = nullptr;
     size_t         size_ = 0;
-    size_t         off_  = 0;
-    bool           ok_   = true;
 };
 
-struct SnapshotLoadResult {
-    bool        ok = false;
-    std::string error;
-    size_t      total_bytes = 0;
+// The full, uncompressed stream of one snapshot: the mapped file itself for
+// v1 / v2 (less any section index after its CRC), or `rebuilt` once v3 / v4
+// sections are expanded or a delta is applied.
+struct SnapshotStream {
+    SnapMappedFile       file;
+    std::vector<uint8_t> rebuilt;
+    const uint8_t*       data = nullptr;
+    size_t               size = 0;
 };
 
-static SnapshotLoadResult LoadSnapshot(const char* path, ReplayState& out) {
-    SnapshotLoadResult r;
-
-    FILE* f = fopen(path, "rb");
-    if (!f) {
-        r.error = std::string("could not open snapshot file: ") + path;
-        return r;
-    }
+// Sections a LoadSnapshot left undecoded, kept with the file they live in
+// so DecodePendingSections can decode each on first use. The header and
+// the stream CRC were checked at load; an indexed entry is as stored and
+// its own CRC is checked when it is decoded.
+struct SnapshotPending {
+    SnapshotStream              stream;
+    std::vector<SnapIndexEntry> sections;         // in file order
+    bool                        indexed = false;  // offsets into stream.file
+};
 
-    fseek(f, 0, SEEK_END);
-    long sz = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    if (sz < 68 + 12) {                 // header + minimal end marker
-        r.error = "snapshot file is smaller than the minimum valid size (80 bytes)";
-        fclose(f);
-        return r;
+// Deepest base + delta chain ReadSnapshotStream follows.
+#define SNAP_MAX_DELTA_DEPTH 16
+
+// Maps a snapshot and produces the full, uncompressed stream the parser
+// below takes. v3 / v4 sections are expanded first (the CRC covers the
+// expanded stream); a v4 delta is then rebuilt on top of whichever of
+// `bases` it references, that base itself rebuilt first when it is a delta
+// too. The CRC is left to the parser, so a wrong rebuild fails there.
+static bool ReadSnapshotStream(const std::string& path, const std::vector<std::string>& bases,
+                               int depth, SnapshotStream* out, std::string* err) {
+    if (!out->file.Open(path, err)) return false;
+    out->data = out->file.data();
+    out->size = out->file.size() - SnapIndexLength(out->file.data(), out->file.size());
+
+    // v3 = v2 with optionally LZ4-compressed sections; v4 = a delta whose
+    // sections may be compressed too.
+    const bool isV3 = memcmp(out->data, "SWFOCSNAPv3\0\0\0\0\0", 16) == 0;
+    const bool isV4 = memcmp(out->data, "SWFOCSNAPv4\0\0\0\0\0", 16) == 0;
+    if (!isV3 && !isV4) return true;
+    if (const char* e = SnapLz4ExpandSections(out->data, out->size, 68, &out->rebuilt)) {
+        *err = std::string("section expand failed: ") + e;
+        return false;
     }
+    out->data = out->rebuilt.data();
+    out->size = out->rebuilt.size();
+    if (!isV4) return true;
 
-    std::vector<uint8_t> bytes(static_cast<size_t>(sz));
-    size_t got = fread(bytes.data(), 1, bytes.size(), f);
-    fclose(f);
-    if (got != bytes.size()) {
-        r.error = "short read of snapshot file";
-        return r;
+    if (depth >= SNAP_MAX_DELTA_DEPTH) {
+        *err = "delta chain is deeper than SNAP_MAX_DELTA_DEPTH";
+        return false;
     }
-    r.total_bytes = bytes.size();
-
-    SnapCursor c(bytes.data(), bytes.size());
-
-    // ---- Header ----
-    uint8_t magic[16];
-    if (!c.read_bytes(magic, 16)) { r.error = "header truncated"; return r; }
-    const uint8_t kMagicV1[16] = {
-        'S','W','F','O','C','S','N','A','P','v','1', 0, 0, 0, 0, 0
-    };
-    const uint8_t kMagicV2[16] = {
-        'S','W','F','O','C','S','N','A','P','v','2', 0, 0, 0, 0, 0
-    };
-    bool isV1 = memcmp(magic, kMagicV1, 16) == 0;
-    bool isV2 = memcmp(magic, kMagicV2, 16) == 0;
-    if (!isV1 && !isV2) {
-        r.error = "magic mismatch (expected 'SWFOCSNAPv1' or 'SWFOCSNAPv2')";
-        return r;
+    std::string lastErr = "no --base snapshot given";
+    for (const std::string& basePath : bases) {
+        if (basePath == path) continue;
+        SnapshotStream base;
+        std::string baseErr;
+        if (!ReadSnapshotStream(basePath, bases, depth + 1, &base, &baseErr)) {
+            lastErr = basePath + ": " + baseErr;
+            continue;
+        }
+        std::vector<uint8_t> rebuilt;
+        if (const char* e = SnapDeltaReconstruct(base.data, base.size, out->data, out->size,
+                                                 68, &rebuilt)) {
+            lastErr = basePath + ": " + e;
+            continue;
+        }
+        out->rebuilt.swap(rebuilt);
+        out->data = out->rebuilt.data();
+        out->size = out->rebuilt.size();
+        return true;
     }
+    *err = "delta base not found (" + lastErr + ")";
+    return false;
+}
 
-    if (!c.read_u32(&out.format_version)) { r.error = "format_version truncated"; return r; }
-    // v1 = legacy (no explicit local_slot in section 1; derived from first player)
-    // v2 = current (explicit local_slot in section 1, added 2026-04-08)
-    if (out.format_version != 1 && out.format_version != 2) {
-        char buf[128];
-        snprintf(buf, sizeof(buf),
-                 "unsupported format_version=%u (expected 1 or 2)",
-                 out.format_version);
-        r.error = buf;
-        return r;
+// Selective load of a v1 .. v3 file through its section index
+// (snap_index.h): only the header, the index and the selected sections are
+// read from the mapped view, each checked against its index CRC. Returns
+// false when the file has no usable index and the caller walks the stream
+// instead; otherwise *r reports the load. With `pending`, the sections
+// not selected are listed there.
+static bool LoadIndexedSections(const SnapMappedFile& file, ReplayState& out, uint32_t sections,
+                                SnapshotLoadResult* r, SnapshotPending* pending) {
+    const uint8_t* bytes = file.data();
+    uint32_t headerCrc = 0;
+    std::vector<SnapIndexEntry> entries;
+    if (memcmp(bytes, "SWFOCSNAPv4", 12) == 0) return false;  // rebuilt from its base chain
+    if (SnapReadIndex(bytes, file.size(), Crc32_Update, &headerCrc, &entries)) return false;
+
+    r->indexed = true;
+    r->total_bytes = file.size();
+    if (Crc32_Compute(bytes, 68) != headerCrc) {
+        r->error = "header CRC32 does not match the section index";
+        return true;
     }
-    // Cross-check: magic and format_version must agree.
-    if ((isV1 && out.format_version != 1) || (isV2 && out.format_version != 2)) {
-        r.error = "magic/format_version mismatch";
-        return r;
+    if (!ParseSnapshotHeader(bytes, 68, out, &r->error)) return true;
+
+    r->sections_total = entries.size();
+    std::vector<uint8_t> inflated;
+    for (const SnapIndexEntry& e : entries) {
+        const uint32_t id = e.id & SNAP_SECTION_ID_MASK;
+        if (id >= 32) continue;
+        if (!(sections & REPLAY_SECTION(id))) {
+            if (pending) pending->sections.push_back(e);
+            continue;
+        }
+        if (!DecodeIndexedSection(bytes, e, &inflated, out, &r->error)) return true;
+        r->sections_loaded++;
     }
+    if (pending) pending->indexed = true;
+    r->ok = true;
+    return true;
+}
 
-    if (!c.read_u64(&out.capture_timestamp_ms)) { r.error = "timestamp truncated"; return r; }
-    if (!c.read_bytes(out.engine_build_hash, 32)) { r.error = "engine_build_hash truncated"; return r; }
-    if (!c.read_u8(&out.game_mode)) { r.error = "game_mode truncated"; return r; }
-    if (!c.skip(7)) { r.error = "reserved header padding truncated"; return r; }
+// Loads a snapshot. The file is mapped, its sections indexed and its CRC
+// checked in one pass over the stream; then only the sections selected in
+// `sections` are decoded into `out`, each straight from the mapped view.
+// The rest leave their ReplayState members empty. A selective load of a
+// file with a section index seeks to those sections instead; a full load
+// checks the end-marker CRC over every byte anyway. With `pending`, the
+// file stays mapped there with the sections not selected, for
+// DecodePendingSections to decode later.
+static SnapshotLoadResult LoadSnapshot(const char* path, ReplayState& out,
+                                       const std::vector<std::string>& bases = {},
+                                       uint32_t sections = REPLAY_ALL_SECTIONS,
+                                       SnapshotPending* pending = nullptr) {
+    SnapshotLoadResult r;
+    SnapshotStream local;
+    SnapshotStream& stream = pending ? pending->stream : local;
+    if (pending) pending->sections.clear();
+
+    if (sections != REPLAY_ALL_SECTIONS) {
+        if (!stream.file.Open(path, &r.error)) return r;
+        if (LoadIndexedSections(stream.file, out, sections, &r, pending)) return r;
+        if (pending) pending->sections.clear();
+    }
 
-    // Header should be exactly 68 bytes.
-    if (c.pos() != 68) {
-        r.error = "header did not end at offset 68";
+    if (!ReadSnapshotStream(path, bases, 0, &stream, &r.error)) return r;
+    r.total_bytes = stream.file.size();
+    std::vector<SnapSectionRef> refs;
+    if (!SnapDecodeStream(stream.data, stream.size, out, sections, &refs, &r,
+                          pending ? &pending->sections : nullptr)) {
         return r;
     }
+    if (pending) pending->indexed = false;
+    return r;
+}
 
-    // ---- Sections ----
-    while (c.remaining() >= 8) {
-        size_t sectionStart = c.pos();
-        uint32_t section_id = 0;
-        uint32_t section_len = 0;
-        if (!c.read_u32(&section_id))  { r.error = "section header id truncated"; return r; }
-        if (!c.read_u32(&section_len)) { r.error = "section header length truncated"; return r; }
-
-        if (section_id == 0xFFFFFFFFu) {
-            // End marker: payload is the 4-byte CRC32 over everything before it.
-            if (section_len != 4) {
-                r.error = "end marker section_length != 4";
-                return r;
-            }
-            if (c.remaining() < 4) { r.error = "CRC32 truncated"; return r; }
-            uint32_t fileCrc = 0;
-            if (!c.read_u32(&fileCrc)) { r.error = "CRC32 read failed"; return r; }
-            // CRC covers [0 .. sectionStart + 8), i.e. end-marker header included.
-            uint32_t expected = Crc32_Compute(bytes.data(), sectionStart + 8);
-            if (expected != fileCrc) {
-                char buf[128];
-                snprintf(buf, sizeof(buf),
-                         "CRC32 mismatch (file=0x%08X computed=0x%08X)",
-                         fileCrc, expected);
-                r.error = buf;
-                return r;
-            }
-            // Success.
-            r.ok = true;
-            return r;
-        }
-
-        // Defensive: bound the section length
-        if (c.remaining() < section_len) {
-            r.error = "section payload runs past end of file";
-            return r;
-        }
-        size_t bodyStart = c.pos();
-
-        if (section_id == 1) {
-            // player_array
-            uint32_t player_count = 0;
-            if (!c.read_u32(&player_count)) { r.error = "player_count truncated"; return r; }
-            // Defensive clamp (capture already clamps to 8).
-            if (player_count > 4096) {
-                r.error = "player_count out of sane bound (>4096)";
-                return r;
-            }
-            // v2 addition: explicit local_slot. Read only when format_version
-            // says so. v1 snapshots derive the local slot from the first
-            // player after the loop.
-            uint32_t explicit_local_slot = 0xFFFFFFFFu;
-            if (out.format_version >= 2) {
-                if (!c.read_u32(&explicit_local_slot)) {
-                    r.error = "local_slot truncated (v2)";
-                    return r;
-                }
-            }
-            out.players.clear();
-            out.players.reserve(player_count);
-            for (uint32_t i = 0; i < player_count; i++) {
-                ReplayPlayer p;
-                if (!c.read_u32(&p.slot))                     { r.error = "player slot truncated"; return r; }
-                if (!c.read_fixed_str(&p.faction_name, 64))   { r.error = "player faction truncated"; return r; }
-                if (!c.read_f64(&p.credits))                  { r.error = "player credits truncated"; return r; }
-                if (!c.read_i32(&p.tech_level))               { r.error = "player tech_level truncated"; return r; }
-                if (!c.read_fixed_str(&p.player_name, 64))    { r.error = "player name truncated"; return r; }
-                out.players.push_back(std::move(p));
-            }
-            // Resolve local_slot: v2 uses the explicit field; v1 falls back
-            // to the first player. UINT32_MAX means "no local player".
-            if (out.format_version >= 2) {
-                if (explicit_local_slot == 0xFFFFFFFFu) {
-                    out.local_slot = -1;
-                } else {
-                    out.local_slot = static_cast<int>(explicit_local_slot);
-                }
-            } else {
-                out.local_slot = out.players.empty()
-                    ? -1
-                    : static_cast<int>(out.players.front().slot);
-            }
-        } else if (section_id == 2) {
-            uint32_t state_count = 0;
-            if (!c.read_u32(&state_count)) { r.error = "state_count truncated"; return r; }
-            if (state_count > 1024 * 64) {
-                r.error = "state_count out of sane bound";
-                return r;
-            }
-            out.lua_state_ptrs.clear();
-            out.lua_state_ptrs.reserve(state_count);
-            for (uint32_t i = 0; i < state_count; i++) {
-                uint64_t ptr = 0;
-                if (!c.read_u64(&ptr)) { r.error = "lua_state pointer truncated"; return r; }
-                out.lua_state_ptrs.push_back(ptr);
-            }
-        } else if (section_id == 3) {
-            uint32_t type_count = 0;
-            if (!c.read_u32(&type_count)) { r.error = "object type_count truncated"; return r; }
-            if (type_count > 1024 * 1024) { r.error = "object type_count out of sane bound"; return r; }
-            out.objects.clear();
-            for (uint32_t i = 0; i < type_count; i++) {
-                std::string name;
-                uint32_t count = 0;
-                if (!c.read_fixed_str(&name, 64)) { r.error = "object type name truncated"; return r; }
-                if (!c.read_u32(&count))          { r.error = "object instance_count truncated"; return r; }
-                out.objects[name] = count;
-            }
-        } else if (section_id == 4) {
-            uint32_t global_count = 0;
-            if (!c.read_u32(&global_count)) { r.error = "global_count truncated"; return r; }
-            if (global_count > 1024 * 1024) { r.error = "global_count out of sane bound"; return r; }
-            out.globals.clear();
-            for (uint32_t i = 0; i < global_count; i++) {
-                std::string name;
-                ReplayGlobal g{};
-                uint8_t pad[7];
-                if (!c.read_fixed_str(&name, 64)) { r.error = "global name truncated"; return r; }
-                if (!c.read_u8(&g.lua_type))      { r.error = "global lua_type truncated"; return r; }
-                if (!c.read_bytes(pad, 7))        { r.error = "global pad truncated"; return r; }
-                if (!c.read_u64(&g.raw_value_or_ptr)) { r.error = "global raw_value truncated"; return r; }
-                out.globals[name] = g;
-            }
-        } else if (section_id == 5) {
-            uint32_t entry_count = 0;
-            if (!c.read_u32(&entry_count)) { r.error = "metadata entry_count truncated"; return r; }
-            if (entry_count > 65536) { r.error = "metadata entry_count out of sane bound"; return r; }
-            out.metadata.clear();
-            for (uint32_t i = 0; i < entry_count; i++) {
-                uint16_t kl = 0, vl = 0;
-                if (!c.read_u16(&kl)) { r.error = "metadata key_length truncated"; return r; }
-                std::string k(kl, '\0');
-                if (kl && !c.read_bytes(&k[0], kl)) { r.error = "metadata key truncated"; return r; }
-                if (!c.read_u16(&vl)) { r.error = "metadata value_length truncated"; return r; }
-                std::string v(vl, '\0');
-                if (vl && !c.read_bytes(&v[0], vl)) { r.error = "metadata value truncated"; return r; }
-                out.metadata[k] = v;
-            }
-        } else if (section_id == 6) {
-            // section 6: planet_state (added v2 extension, 2026-04-08)
-            // Layout:
-            //   uint32 planet_count
-            //   for i in 0..planet_count:
-            //       char    name[64]
-            //       float32 corruption
-            //       int32   owner_slot   (-1 = no owner)
-            uint32_t planet_count = 0;
-            if (!c.read_u32(&planet_count)) { r.error = "planet_count truncated"; return r; }
-            if (planet_count > 4096) { r.error = "planet_count out of sane bound"; return r; }
-            out.planets.clear();
-            for (uint32_t i = 0; i < planet_count; i++) {
-                std::string name;
-                if (!c.read_fixed_str(&name, 64)) { r.error = "planet name truncated"; return r; }
-                uint32_t corr_bits = 0;
-                if (!c.read_u32(&corr_bits)) { r.error = "planet corruption truncated"; return r; }
-                int32_t owner = 0;
-                if (!c.read_i32(&owner))     { r.error = "planet owner truncated"; return r; }
-                ReplayPlanetInfo info;
-                info.name = name;
-                memcpy(&info.corruption, &corr_bits, 4);
-                info.owner_slot = owner;
-                out.planets[ToUpperAscii(name)] = info;
-            }
-        } else if (section_id == 7) {
-            // section 7: diplomacy (added v2 extension, 2026-04-08)
-            // Layout:
-            //   uint32 pair_count
-            //   for i in 0..pair_count:
-            //       char  faction_a[32]
-            //       char  faction_b[32]
-            //       char  state[16]      // "allied" / "hostile" / "neutral"
-            uint32_t pair_count = 0;
-            if (!c.read_u32(&pair_count)) { r.error = "diplomacy pair_count truncated"; return r; }
-            if (pair_count > 4096) { r.error = "diplomacy pair_count out of sane bound"; return r; }
-            out.diplomacy.clear();
-            for (uint32_t i = 0; i < pair_count; i++) {
-                std::string fa, fb, st;
-                if (!c.read_fixed_str(&fa, 32)) { r.error = "diplomacy faction_a truncated"; return r; }
-                if (!c.read_fixed_str(&fb, 32)) { r.error = "diplomacy faction_b truncated"; return r; }
-                if (!c.read_fixed_str(&st, 16)) { r.error = "diplomacy state truncated"; return r; }
-                out.diplomacy[MakeDiplomacyKey(fa, fb)] = st;
-            }
-        } else if (section_id == 8) {
-            // section 8: cooldowns (added v2 extension, 2026-04-08)
-            // Layout:
-            //   uint32 type_count
-            //   for i in 0..type_count:
-            //       char     type_name[64]
-            //       uint32   ability_count
-            //       float32  cooldown[ability_count]
-            uint32_t type_count = 0;
-            if (!c.read_u32(&type_count)) { r.error = "cooldown type_count truncated"; return r; }
-            if (type_count > 4096) { r.error = "cooldown type_count out of sane bound"; return r; }
-            out.cooldowns.clear();
-            for (uint32_t i = 0; i < type_count; i++) {
-                std::string name;
-                uint32_t ability_count = 0;
-                if (!c.read_fixed_str(&name, 64)) { r.error = "cooldown type name truncated"; return r; }
-                if (!c.read_u32(&ability_count)) { r.error = "cooldown ability_count truncated"; return r; }
-                if (ability_count > 256) { r.error = "cooldown ability_count out of sane bound"; return r; }
-                std::vector<float> values;
-                values.reserve(ability_count);
-                for (uint32_t j = 0; j < ability_count; j++) {
-                    uint32_t bits = 0;
-                    if (!c.read_u32(&bits)) { r.error = "cooldown value truncated"; return r; }
-                    float v = 0.0f;
-                    memcpy(&v, &bits, 4);
-                    values.push_back(v);
-                }
-                out.cooldowns[name] = std::move(values);
-            }
-        } else if (section_id == 9) {
-            // section 9: task_forces (added v2 extension, 2026-04-08)
-            // Layout:
-            //   uint32 force_count
-            //   for i in 0..force_count:
-            //       int32 owner_slot
-            //       char  name[64]
-            uint32_t force_count = 0;
-            if (!c.read_u32(&force_count)) { r.error = "task_force count truncated"; return r; }
-            if (force_count > 4096) { r.error = "task_force count out of sane bound"; return r; }
-            out.task_forces.clear();
-            for (uint32_t i = 0; i < force_count; i++) {
-                int32_t owner = 0;
-                std::string name;
-                if (!c.read_i32(&owner)) { r.error = "task_force owner truncated"; return r; }
-                if (!c.read_fixed_str(&name, 64)) { r.error = "task_force name truncated"; return r; }
-                ReplayTaskForceRecord rec;
-                rec.owner_slot = owner;
-                rec.name = name;
-                out.task_forces.push_back(std::move(rec));
-            }
-        } else if (section_id == 10) {
-            // section 10: object_owners (added v2 extension, 2026-04-08)
-            // Layout:
-            //   uint32 type_count
-            //   for i in 0..type_count:
-            //       char    type_name[64]
-            //       uint32  instance_count
-            //       int32   owner_slot[instance_count]
-            uint32_t type_count = 0;
-            if (!c.read_u32(&type_count)) { r.error = "object_owners type_count truncated"; return r; }
-            if (type_count > 4096) { r.error = "object_owners type_count out of sane bound"; return r; }
-            out.object_owners.clear();
-            for (uint32_t i = 0; i < type_count; i++) {
-                std::string name;
-                uint32_t instance_count = 0;
-                if (!c.read_fixed_str(&name, 64)) { r.error = "object_owners type name truncated"; return r; }
-                if (!c.read_u32(&instance_count)) { r.error = "object_owners instance_count truncated"; return r; }
-                if (instance_count > 65536) { r.error = "object_owners instance_count out of sane bound"; return r; }
-                std::vector<int32_t> owners;
-                owners.reserve(instance_count);
-                for (uint32_t j = 0; j < instance_count; j++) {
-                    int32_t s = 0;
-                    if (!c.read_i32(&s)) { r.error = "object_owners owner truncated"; return r; }
-                    owners.push_back(s);
-                }
-                out.object_owners[ToUpperAscii(name)] = std::move(owners);
-            }
-        } else if (section_id == 11) {
-            // section 11: selected_units (added 2026-04-23 for Task 101)
-            // Layout:
-            //   uint32 count
-            //   uint64 obj_addr[count]
-            uint32_t count = 0;
-            if (!c.read_u32(&count)) { r.error = "selected_units count truncated"; return r; }
-            if (count > 4096) { r.error = "selected_units count out of sane bound"; return r; }
-            out.selected_units.clear();
-            out.selected_units.reserve(count);
-            for (uint32_t i = 0; i < count; i++) {
-                uint64_t obj = 0;
-                if (!c.read_u64(&obj)) { r.error = "selected_units obj_addr truncated"; return r; }
-                out.selected_units.push_back(obj);
-            }
-        } else if (section_id == 12) {
-            // section 12: unit_detail (added 2026-04-23 for Task 101)
-            // Layout per unit: 102 bytes fixed + hardpoint indices.
-            //   uint64  obj_addr
-            //   char    type_name[64]
-            //   int32   owner_slot
-            //   float32 hull
-            //   float32 max_hull
-            //   uint8   invuln_flag
-            //   uint8   prevent_death
-            //   uint8   reserved[6]
-            //   uint32  hardpoint_count
-            //   uint32  hardpoint_indices[hardpoint_count]
-            // Section 13 (behavior_attach) is responsible for the per-HP
-            // behavior name lists.
-            uint32_t unit_count = 0;
-            if (!c.read_u32(&unit_count)) { r.error = "unit_detail count truncated"; return r; }
-            if (unit_count > 4096) { r.error = "unit_detail count out of sane bound"; return r; }
-            for (uint32_t i = 0; i < unit_count; i++) {
-                uint64_t obj_addr = 0;
-                std::string type_name;
-                int32_t owner_slot = 0;
-                uint32_t hull_bits = 0, max_hull_bits = 0;
-                uint8_t invuln_flag = 0, prevent_death = 0;
-                uint8_t reserved[6];
-                if (!c.read_u64(&obj_addr))               { r.error = "unit_detail obj_addr truncated"; return r; }
-                if (!c.read_fixed_str(&type_name, 64))    { r.error = "unit_detail type_name truncated"; return r; }
-                if (!c.read_i32(&owner_slot))             { r.error = "unit_detail owner_slot truncated"; return r; }
-                if (!c.read_u32(&hull_bits))              { r.error = "unit_detail hull truncated"; return r; }
-                if (!c.read_u32(&max_hull_bits))          { r.error = "unit_detail max_hull truncated"; return r; }
-                if (!c.read_u8(&invuln_flag))             { r.error = "unit_detail invuln_flag truncated"; return r; }
-                if (!c.read_u8(&prevent_death))           { r.error = "unit_detail prevent_death truncated"; return r; }
-                if (!c.read_bytes(reserved, 6))           { r.error = "unit_detail reserved truncated"; return r; }
-                uint32_t hp_count = 0;
-                if (!c.read_u32(&hp_count))               { r.error = "unit_detail hp_count truncated"; return r; }
-                if (hp_count > 1024) { r.error = "unit_detail hp_count out of sane bound"; return r; }
-                float hull = 0.0f, max_hull = 0.0f;
-                memcpy(&hull, &hull_bits, 4);
-                memcpy(&max_hull, &max_hull_bits, 4);
-                auto& u = ReplayMutMockUnit(out, obj_addr, type_name, owner_slot, hull, max_hull, hp_count);
-                u.invuln_flag = invuln_flag;
-                u.prevent_death = prevent_death;
-                for (uint32_t j = 0; j < hp_count; j++) {
-                    uint32_t hp_index = 0;
-                    if (!c.read_u32(&hp_index)) { r.error = "unit_detail hp_index truncated"; return r; }
-                    if (j < u.hardpoints.size()) u.hardpoints[j].index = hp_index;
-                }
-            }
-        } else if (section_id == 13) {
-            // section 13: behavior_attach (added 2026-04-23 for Task 101)
-            // Flat list of (obj_addr, hp_index, behavior_name) triples.
-            //   uint32 entry_count
-            //   for i in 0..entry_count:
-            //       uint64 obj_addr
-            //       uint32 hp_index
-            //       char   behavior_name[32]
-            // Entries referring to units not present in section 12 are
-            // ignored (forward-compat: a capture that emits behaviors for
-            // units outside the selection should not fail loading).
-            uint32_t entry_count = 0;
-            if (!c.read_u32(&entry_count)) { r.error = "behavior_attach count truncated"; return r; }
-            if (entry_count > 65536) { r.error = "behavior_attach count out of sane bound"; return r; }
-            for (uint32_t i = 0; i < entry_count; i++) {
-                uint64_t obj_addr = 0;
-                uint32_t hp_index = 0;
-                std::string behavior;
-                if (!c.read_u64(&obj_addr))             { r.error = "behavior_attach obj_addr truncated"; return r; }
-                if (!c.read_u32(&hp_index))             { r.error = "behavior_attach hp_index truncated"; return r; }
-                if (!c.read_fixed_str(&behavior, 32))   { r.error = "behavior_attach name truncated"; return r; }
-                // Silently skip entries that do not match a loaded unit.
-                ReplayMutAttachBehavior(out, obj_addr, static_cast<int>(hp_index), behavior);
+// Decodes the sections of `pending` that `sections` selects into `out` and
+// drops them from the list. Sections 13 and 14 attach to the units of
+// section 12, so selecting either decodes 12 too. Returns the sections
+// decoded, or -1 with *err set when one fails its CRC or does not parse
+// (it stays pending).
+static int DecodePendingSections(SnapshotPending* pending, uint32_t sections, ReplayState& out,
+                                 std::string* err) {
+    if (sections & (REPLAY_SECTION(13) | REPLAY_SECTION(14))) sections |= REPLAY_SECTION(12);
+    std::vector<uint8_t> inflated;
+    int decoded = 0;
+    bool ok = true;
+    size_t kept = 0;
+    for (size_t i = 0; i < pending->sections.size(); i++) {
+        const SnapIndexEntry e = pending->sections[i];
+        const uint32_t id = e.id & SNAP_SECTION_ID_MASK;
+        if (ok && (sections & REPLAY_SECTION(id))) {
+            ok = pending->indexed
+                     ? DecodeIndexedSection(pending->stream.file.data(), e, &inflated, out, err)
+                     : ParseSnapshotSection(id, pending->stream.data + e.off + 8, e.len, out, err);
+            if (ok) {
+                decoded++;
+                continue;
             }
-        } else {
-            // Unknown / forward-compatible section: skip payload.
-            if (!c.skip(section_len)) { r.error = "unknown section skip failed"; return r; }
-        }
-
-        // Make sure we consumed exactly section_len bytes.
-        size_t bodyEnd = c.pos();
-        if (bodyEnd - bodyStart != section_len) {
-            // Advance to end of the declared payload if we under-consumed it.
-            size_t delta = (bodyStart + section_len) - bodyEnd;
-            if (!c.skip(delta)) { r.error = "section payload alignment failed"; return r; }
         }
+        pending->sections[kept++] = e;
     }
-
-    r.error = "reached end of file without seeing end marker";
-    return r;
+    pending->sections.resize(kept);
+    return ok ? decoded : -1;
 }
 
+// The pipe listener's g_replay sections not decoded yet (main thread).
+static SnapshotPending g_replayPending;
+
 // ======================================================================
 // Embedded fake Lua VM + function pointer wiring
 // ======================================================================
@@ -835,9 +582,8 @@ static int Lua_ReplayPlayerCount(lua_State* L) {
 static int Lua_ReplayPlayerCredits(lua_State* L) {
     const char* faction = fn_tostring(L, 1);
     if (!faction) { fn_pushnumber(L, -1.0); return 1; }
-    std::string needle = ToUpperAscii(faction);
     for (const auto& p : g_replay.players) {
-        if (ToUpperAscii(p.faction_name) == needle) {
+        if (ReplaySameName(p.faction_name, faction)) {
             fn_pushnumber(L, p.credits);
             return 1;
         }
@@ -851,9 +597,8 @@ static int Lua_ReplayPlayerCredits(lua_State* L) {
 static int Lua_ReplayPlayerTechLevel(lua_State* L) {
     const char* faction = fn_tostring(L, 1);
     if (!faction) { fn_pushnumber(L, -1.0); return 1; }
-    std::string needle = ToUpperAscii(faction);
     for (const auto& p : g_replay.players) {
-        if (ToUpperAscii(p.faction_name) == needle) {
+        if (ReplaySameName(p.faction_name, faction)) {
             fn_pushnumber(L, static_cast<double>(p.tech_level));
             return 1;
         }
@@ -885,13 +630,7 @@ static int Lua_ReplayDiplomaticState(lua_State* L) {
     const char* a = fn_tostring(L, 1);
     const char* b = fn_tostring(L, 2);
     if (!a || !b) { fn_pushstring(L, "hostile"); return 1; }
-    auto key = MakeDiplomacyKey(a, b);
-    auto it = g_replay.diplomacy.find(key);
-    if (it == g_replay.diplomacy.end()) {
-        fn_pushstring(L, "hostile");
-        return 1;
-    }
-    fn_pushstring(L, it->second.c_str());
+    fn_pushstring(L, ReplayObsDiplomaticState(g_replay, a, b).c_str());
     return 1;
 }
 
@@ -902,7 +641,7 @@ static int Lua_ReplaySetDiplomacy(lua_State* L) {
     const char* b = fn_tostring(L, 2);
     const char* st = fn_tostring(L, 3);
     if (!a || !b || !st) { fn_pushnumber(L, 0); return 1; }
-    g_replay.diplomacy[MakeDiplomacyKey(a, b)] = st;
+    g_replay.diplomacy.mut()[MakeDiplomacyKey(a, b)] = st;
     fn_pushnumber(L, 1);
     return 1;
 }
@@ -927,7 +666,7 @@ static int Lua_ReplaySetPlanetCorruption(lua_State* L) {
     if (!planet) { fn_pushnumber(L, 0); return 1; }
     double value = fn_tonumber(L, 2);
     std::string key = ToUpperAscii(planet);
-    auto& info = g_replay.planets[key];
+    auto& info = g_replay.planets.mut()[key];
     if (info.name.empty()) info.name = planet;
     info.corruption = static_cast<float>(value);
     fn_pushnumber(L, 1);
@@ -963,20 +702,19 @@ static int Lua_ReplaySpawnUnit(lua_State* L) {
     if (count <= 0) { fn_pushnumber(L, 0); return 1; }
 
     int32_t owner_slot = -1;
-    std::string needle = ToUpperAscii(faction);
     for (const auto& p : g_replay.players) {
-        if (ToUpperAscii(p.faction_name) == needle) {
+        if (ReplaySameName(p.faction_name, faction)) {
             owner_slot = static_cast<int32_t>(p.slot);
             break;
         }
     }
 
     std::string type_key = ToUpperAscii(type_name);
-    auto& owners = g_replay.object_owners[type_key];
+    auto& owners = g_replay.object_owners.mut()[type_key];
     for (int i = 0; i < count; i++) owners.push_back(owner_slot);
 
     // Keep the section-3 catalog in sync so existing observers still work.
-    g_replay.objects[type_name] += static_cast<uint32_t>(count);
+    g_replay.objects.mut()[type_name] += static_cast<uint32_t>(count);
 
     fn_pushnumber(L, 1);
     return 1;
@@ -1007,7 +745,7 @@ static int Lua_ReplaySetCooldown(lua_State* L) {
     int ability_idx = static_cast<int>(fn_tonumber(L, 2));
     double value = fn_tonumber(L, 3);
     if (ability_idx < 0 || ability_idx > 256) { fn_pushnumber(L, 0); return 1; }
-    auto& slots = g_replay.cooldowns[unit_type];
+    auto& slots = g_replay.cooldowns.mut()[unit_type];
     if (static_cast<int>(slots.size()) <= ability_idx) {
         slots.resize(static_cast<size_t>(ability_idx) + 1, 0.0f);
     }
@@ -1036,7 +774,7 @@ static int Lua_ReplayAddTaskForce(lua_State* L) {
     ReplayTaskForceRecord rec;
     rec.owner_slot = slot;
     rec.name = name;
-    g_replay.task_forces.push_back(std::move(rec));
+    g_replay.task_forces.mut().push_back(std::move(rec));
     fn_pushnumber(L, 1);
     return 1;
 }
@@ -1108,7 +846,7 @@ static int Lua_ReplayMockUnit(lua_State* L) {
 // SWFOC_ReplayUnitHull(obj_addr) -> current hull, or -1 if unknown unit.
 static int Lua_ReplayUnitHull(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     fn_pushnumber(L, u ? static_cast<double>(u->hull) : -1.0);
     return 1;
 }
@@ -1116,7 +854,7 @@ static int Lua_ReplayUnitHull(lua_State* L) {
 // SWFOC_ReplayUnitMaxHull(obj_addr) -> max_hull, or -1 if unknown unit.
 static int Lua_ReplayUnitMaxHull(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     fn_pushnumber(L, u ? static_cast<double>(u->max_hull) : -1.0);
     return 1;
 }
@@ -1124,7 +862,7 @@ static int Lua_ReplayUnitMaxHull(lua_State* L) {
 // SWFOC_ReplayUnitOwnerSlot(obj_addr) -> slot index, or -1 if unknown unit.
 static int Lua_ReplayUnitOwnerSlot(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     fn_pushnumber(L, u ? static_cast<double>(u->owner_slot) : -1.0);
     return 1;
 }
@@ -1135,7 +873,7 @@ static int Lua_ReplayUnitOwnerSlot(lua_State* L) {
 // applied" (i.e. the byte write is a no-op for gameplay).
 static int Lua_ReplayUnitInvulnFlag(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     fn_pushnumber(L, u ? static_cast<double>(u->invuln_flag) : -1.0);
     return 1;
 }
@@ -1143,7 +881,7 @@ static int Lua_ReplayUnitInvulnFlag(lua_State* L) {
 // SWFOC_ReplayUnitPreventDeath(obj_addr) -> bit-0x80 of +0x3A1 (0/1), -1 if unknown.
 static int Lua_ReplayUnitPreventDeath(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     if (!u) { fn_pushnumber(L, -1.0); return 1; }
     fn_pushnumber(L, (u->prevent_death & 0x80) ? 1.0 : 0.0);
     return 1;
@@ -1152,7 +890,7 @@ static int Lua_ReplayUnitPreventDeath(lua_State* L) {
 // SWFOC_ReplayHardpointCount(obj_addr) -> hardpoint count, -1 if unknown unit.
 static int Lua_ReplayHardpointCount(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     fn_pushnumber(L, u ? static_cast<double>(u->hardpoints.size()) : -1.0);
     return 1;
 }
@@ -1162,7 +900,7 @@ static int Lua_ReplayHardpointHasBehavior(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
     int hp_index = static_cast<int>(fn_tonumber(L, 2));
     const char* behavior = fn_tostring(L, 3);
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     if (!u || !behavior) { fn_pushnumber(L, -1.0); return 1; }
     if (hp_index < 0 || hp_index >= static_cast<int>(u->hardpoints.size())) {
         fn_pushnumber(L, -1.0);
@@ -1179,9 +917,9 @@ static int Lua_ReplayHardpointHasBehavior(lua_State* L) {
 // as the gating assertion.
 static int Lua_ReplayUnitIsInvulnerable(lua_State* L) {
     uint64_t obj_addr = static_cast<uint64_t>(fn_tonumber(L, 1));
-    const auto* u = ReplayFindUnit(g_replay, obj_addr);
+    const auto* u = ReplayFindUnit(ReplayView(), obj_addr);
     if (!u) { fn_pushnumber(L, -1.0); return 1; }
-    bool inv = ReplayUnitAnyHardpointHasBehavior(*u, "INVULNERABLE");
+    bool inv = ReplayUnitAnyHardpointHasBehavior(*u, ReplayInvulnerableSymbol());
     fn_pushnumber(L, inv ? 1.0 : 0.0);
     return 1;
 }
@@ -1450,6 +1188,26 @@ static int Lua_ReplayTickIncome(lua_State* L) {
     return 1;
 }
 
+// SWFOC_ReplayFork() -> id (0 = REPLAY_FORK_MAX forks held);
+// SWFOC_ReplayRestore(id) -> 1 / 0 (unknown id);
+// SWFOC_ReplayDropFork(id) -> forks dropped (id 0 drops every fork).
+static int Lua_ReplayFork(lua_State* L) {
+    fn_pushnumber(L, static_cast<double>(ReplayFork(g_replay, &g_replayForks)));
+    return 1;
+}
+
+static int Lua_ReplayRestore(lua_State* L) {
+    fn_pushnumber(L, static_cast<double>(ReplayRestore(g_replay, g_replayForks,
+        static_cast<uint32_t>(fn_tonumber(L, 1)))));
+    return 1;
+}
+
+static int Lua_ReplayDropFork(lua_State* L) {
+    fn_pushnumber(L, static_cast<double>(ReplayDropFork(&g_replayForks,
+        static_cast<uint32_t>(fn_tonumber(L, 1)))));
+    return 1;
+}
+
 // SWFOC_ReplaySetFireRate / GetFireRate / ApplyFireRate (Task 131).
 // SWFOC_ReplaySetAreaDamage / IsAreaDamage / ApplyAreaSplash (Task 132).
 // SWFOC_ReplaySetTargetFilter / GetTargetFilter / IsTargetAllowed (Task 133).
@@ -1484,6 +1242,14 @@ static int Lua_ReplayIsAreaDamage(lua_State* L) {
     return 1;
 }
 
+// SWFOC_ReplaySetAreaDamageShape(radius, falloff, edge) -> 1 / 0 (out of range).
+static int Lua_ReplaySetAreaDamageShape(lua_State* L) {
+    fn_pushnumber(L, static_cast<double>(ReplayMutSetAreaDamageShape(g_replay,
+        static_cast<float>(fn_tonumber(L, 1)), static_cast<float>(fn_tonumber(L, 2)),
+        static_cast<float>(fn_tonumber(L, 3)))));
+    return 1;
+}
+
 static int Lua_ReplayApplyAreaSplash(lua_State* L) {
     uint64_t primary = static_cast<uint64_t>(fn_tonumber(L, 1));
     float amount = static_cast<float>(fn_tonumber(L, 2));
@@ -1491,6 +1257,25 @@ static int Lua_ReplayApplyAreaSplash(lua_State* L) {
     return 1;
 }
 
+// SWFOC_ReplaySetUnitPosition(obj_addr, x, y, z) -> 1 / 0 (unknown unit).
+// SWFOC_ReplayUnitsInRadius(x, y, radius) -> positioned units in range,
+// through the same spatial grid as the live SWFOC_QueryUnitsInRadius.
+static int Lua_ReplaySetUnitPosition(lua_State* L) {
+    uint64_t addr = static_cast<uint64_t>(fn_tonumber(L, 1));
+    fn_pushnumber(L, static_cast<double>(ReplayMutSetUnitPosition(g_replay, addr,
+        static_cast<float>(fn_tonumber(L, 2)), static_cast<float>(fn_tonumber(L, 3)),
+        static_cast<float>(fn_tonumber(L, 4)))));
+    return 1;
+}
+
+static int Lua_ReplayUnitsInRadius(lua_State* L) {
+    std::vector<uint64_t> hits;
+    fn_pushnumber(L, static_cast<double>(ReplayObsUnitsInRadius(g_replay,
+        static_cast<float>(fn_tonumber(L, 1)), static_cast<float>(fn_tonumber(L, 2)),
+        static_cast<float>(fn_tonumber(L, 3)), &hits)));
+    return 1;
+}
+
 static int Lua_ReplaySetTargetFilter(lua_State* L) {
     int slot = static_cast<int>(fn_tonumber(L, 1));
     uint32_t bitmask = static_cast<uint32_t>(fn_tonumber(L, 2));
@@ -1932,13 +1717,38 @@ static int Lua_ReplayEnumerateUnits(lua_State* L) {
     return 1;
 }
 
-// SWFOC_ReplayEventStreamDrain() -> CSV. Task 112 observer/drain.
+// SWFOC_ReplayEventStreamDrain([max_rows]) -> CSV. Task 112 observer/drain.
+// Pages like the live drain: at most max_rows (default
+// REPLAY_EVENT_DRAIN_ROWS) per call, the rest left queued.
 static int Lua_ReplayEventStreamDrain(lua_State* L) {
-    std::string out = ReplayObsEventStreamDrain(g_replay);
+    size_t rows = REPLAY_EVENT_DRAIN_ROWS;
+    if (fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER && fn_tonumber(L, 1) >= 1.0) {
+        rows = static_cast<size_t>(fn_tonumber(L, 1));
+    }
+    std::string out = ReplayObsEventStreamDrain(g_replay, rows);
     fn_pushstring(L, out.c_str());
     return 1;
 }
 
+// SWFOC_ReplaySetEventStreamCapacity([n]) -> "capacity=<new> previous=<old> dropped=<total>",
+// as SWFOC_SetEventStreamCapacity reports the live rings. A missing or
+// non-positive n only reports.
+static std::string ReplayEventCapacityReport(double n) {
+    uint32_t previous = g_replay.damage_event_log.get().capacity;
+    if (n > 0.0) previous = ReplayMutSetEventLogCapacity(g_replay, static_cast<uint32_t>(n > 65536.0 ? 65536.0 : n));
+    char out[128];
+    snprintf(out, sizeof(out), "capacity=%u previous=%u dropped=%llu",
+             g_replay.damage_event_log.get().capacity, previous,
+             static_cast<unsigned long long>(ReplayObsEventLogDropped(g_replay)));
+    return out;
+}
+
+static int Lua_ReplaySetEventStreamCapacity(lua_State* L) {
+    const double n = fn_gettop(L) >= 1 && fn_type(L, 1) == LUA_TNUMBER ? fn_tonumber(L, 1) : 0.0;
+    fn_pushstring(L, ReplayEventCapacityReport(n).c_str());
+    return 1;
+}
+
 // SWFOC_ReplayEventLogCount() -> number of queued events.
 static int Lua_ReplayEventLogCount(lua_State* L) {
     (void)L;
@@ -2282,10 +2092,9 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
         {
             std::string arg;
             if (expr.rfind("SWFOC_ReplayPlayerCredits(", 0) == 0 && ExtractStringArg(expr, &arg)) {
-                std::string needle = ToUpperAscii(arg);
                 StackEntry e; e.type = LUA_TNUMBER; e.numval = -1.0;
                 for (const auto& p : g_replay.players) {
-                    if (ToUpperAscii(p.faction_name) == needle) {
+                    if (ReplaySameName(p.faction_name, arg)) {
                         e.numval = p.credits;
                         break;
                     }
@@ -2294,10 +2103,9 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                 return 9999;
             }
             if (expr.rfind("SWFOC_ReplayPlayerTechLevel(", 0) == 0 && ExtractStringArg(expr, &arg)) {
-                std::string needle = ToUpperAscii(arg);
                 StackEntry e; e.type = LUA_TNUMBER; e.numval = -1.0;
                 for (const auto& p : g_replay.players) {
-                    if (ToUpperAscii(p.faction_name) == needle) {
+                    if (ReplaySameName(p.faction_name, arg)) {
                         e.numval = static_cast<double>(p.tech_level);
                         break;
                     }
@@ -2327,10 +2135,8 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
             if (expr.rfind("SWFOC_ReplayDiplomaticState(", 0) == 0 && ExtractArgs(expr, &args) && args.size() == 2) {
                 std::string a, b;
                 if (UnquoteString(args[0], &a) && UnquoteString(args[1], &b)) {
-                    auto key = MakeDiplomacyKey(a, b);
-                    auto it = g_replay.diplomacy.find(key);
                     StackEntry e; e.type = LUA_TSTRING;
-                    e.strval = (it == g_replay.diplomacy.end()) ? "hostile" : it->second;
+                    e.strval = ReplayObsDiplomaticState(g_replay, a, b);
                     fake->stack.push_back(e);
                     return 9999;
                 }
@@ -2338,7 +2144,7 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
             if (expr.rfind("SWFOC_ReplaySetDiplomacy(", 0) == 0 && ExtractArgs(expr, &args) && args.size() == 3) {
                 std::string a, b, st;
                 if (UnquoteString(args[0], &a) && UnquoteString(args[1], &b) && UnquoteString(args[2], &st)) {
-                    g_replay.diplomacy[MakeDiplomacyKey(a, b)] = st;
+                    g_replay.diplomacy.mut()[MakeDiplomacyKey(a, b)] = st;
                     StackEntry e; e.type = LUA_TNUMBER; e.numval = 1.0;
                     fake->stack.push_back(e);
                     return 9999;
@@ -2349,7 +2155,7 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                 double value = 0.0;
                 if (UnquoteString(args[0], &planet) && ParseNumber(args[1], &value)) {
                     std::string key = ToUpperAscii(planet);
-                    auto& info = g_replay.planets[key];
+                    auto& info = g_replay.planets.mut()[key];
                     if (info.name.empty()) info.name = planet;
                     info.corruption = static_cast<float>(value);
                     StackEntry e; e.type = LUA_TNUMBER; e.numval = 1.0;
@@ -2379,17 +2185,16 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                     int count = static_cast<int>(count_d);
                     if (count > 0) {
                         int32_t owner_slot = -1;
-                        std::string needle = ToUpperAscii(faction);
                         for (const auto& p : g_replay.players) {
-                            if (ToUpperAscii(p.faction_name) == needle) {
+                            if (ReplaySameName(p.faction_name, faction)) {
                                 owner_slot = static_cast<int32_t>(p.slot);
                                 break;
                             }
                         }
                         std::string type_key = ToUpperAscii(type_name);
-                        auto& owners = g_replay.object_owners[type_key];
+                        auto& owners = g_replay.object_owners.mut()[type_key];
                         for (int i = 0; i < count; i++) owners.push_back(owner_slot);
-                        g_replay.objects[type_name] += static_cast<uint32_t>(count);
+                        g_replay.objects.mut()[type_name] += static_cast<uint32_t>(count);
                         StackEntry e; e.type = LUA_TNUMBER; e.numval = 1.0;
                         fake->stack.push_back(e);
                         return 9999;
@@ -2421,7 +2226,7 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                 if (UnquoteString(args[0], &unit_type) && ParseNumber(args[1], &idx_d) && ParseNumber(args[2], &value)) {
                     int idx = static_cast<int>(idx_d);
                     if (idx >= 0 && idx <= 256) {
-                        auto& slots = g_replay.cooldowns[unit_type];
+                        auto& slots = g_replay.cooldowns.mut()[unit_type];
                         if (static_cast<int>(slots.size()) <= idx) {
                             slots.resize(static_cast<size_t>(idx) + 1, 0.0f);
                         }
@@ -2455,7 +2260,7 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                     ReplayTaskForceRecord rec;
                     rec.owner_slot = static_cast<int32_t>(slot_d);
                     rec.name = name;
-                    g_replay.task_forces.push_back(std::move(rec));
+                    g_replay.task_forces.mut().push_back(std::move(rec));
                     StackEntry e; e.type = LUA_TNUMBER; e.numval = 1.0;
                     fake->stack.push_back(e);
                     return 9999;
@@ -2542,6 +2347,24 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
             fake->stack.push_back(e);
             return 9999;
         }
+        {
+            std::vector<std::string> args;
+            double n = 0.0;
+            if (expr.rfind("SWFOC_ReplayEventStreamDrain(", 0) == 0 && ExtractArgs(expr, &args) && args.size() == 1
+                && ParseNumber(args[0], &n)) {
+                StackEntry e; e.type = LUA_TSTRING;
+                e.strval = ReplayObsEventStreamDrain(g_replay, n >= 1.0 ? static_cast<size_t>(n) : REPLAY_EVENT_DRAIN_ROWS);
+                fake->stack.push_back(e);
+                return 9999;
+            }
+            if (expr.rfind("SWFOC_ReplaySetEventStreamCapacity(", 0) == 0 && ExtractArgs(expr, &args)
+                && args.size() <= 1 && (args.empty() || ParseNumber(args[0], &n))) {
+                StackEntry e; e.type = LUA_TSTRING;
+                e.strval = ReplayEventCapacityReport(n);
+                fake->stack.push_back(e);
+                return 9999;
+            }
+        }
         if (expr == "SWFOC_ReplayEventLogCount()") {
             push_num(static_cast<double>(ReplayObsEventLogCount(g_replay)));
             return 9999;
@@ -2647,6 +2470,15 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                     return 9999;
                 }
             }
+            if (expr.rfind("SWFOC_ReplaySetAreaDamageShape(", 0) == 0
+                && ExtractArgs(expr, &args) && args.size() == 3) {
+                double r_d = 0.0, f_d = 0.0, e_d = 0.0;
+                if (ParseNumber(args[0], &r_d) && ParseNumber(args[1], &f_d) && ParseNumber(args[2], &e_d)) {
+                    push_num(static_cast<double>(ReplayMutSetAreaDamageShape(
+                        g_replay, static_cast<float>(r_d), static_cast<float>(f_d), static_cast<float>(e_d))));
+                    return 9999;
+                }
+            }
             if (expr.rfind("SWFOC_ReplayIsAreaDamage(", 0) == 0) {
                 push_num(ReplayObsIsAreaDamageEnabled(g_replay) ? 1.0 : 0.0);
                 return 9999;
@@ -2660,6 +2492,28 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                     return 9999;
                 }
             }
+            if (expr.rfind("SWFOC_ReplaySetUnitPosition(", 0) == 0
+                && ExtractArgs(expr, &args) && args.size() == 4) {
+                double a_d = 0.0, x_d = 0.0, y_d = 0.0, z_d = 0.0;
+                if (ParseNumber(args[0], &a_d) && ParseNumber(args[1], &x_d)
+                    && ParseNumber(args[2], &y_d) && ParseNumber(args[3], &z_d)) {
+                    push_num(static_cast<double>(ReplayMutSetUnitPosition(
+                        g_replay, static_cast<uint64_t>(a_d), static_cast<float>(x_d),
+                        static_cast<float>(y_d), static_cast<float>(z_d))));
+                    return 9999;
+                }
+            }
+            if (expr.rfind("SWFOC_ReplayUnitsInRadius(", 0) == 0
+                && ExtractArgs(expr, &args) && args.size() == 3) {
+                double x_d = 0.0, y_d = 0.0, r_d = 0.0;
+                if (ParseNumber(args[0], &x_d) && ParseNumber(args[1], &y_d) && ParseNumber(args[2], &r_d)) {
+                    std::vector<uint64_t> hits;
+                    push_num(static_cast<double>(ReplayObsUnitsInRadius(
+                        g_replay, static_cast<float>(x_d), static_cast<float>(y_d),
+                        static_cast<float>(r_d), &hits)));
+                    return 9999;
+                }
+            }
             if (expr.rfind("SWFOC_ReplaySetTargetFilter(", 0) == 0
                 && ExtractArgs(expr, &args) && args.size() == 2) {
                 double s_d = 0.0, b_d = 0.0;
@@ -2775,6 +2629,27 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                     return 9999;
                 }
             }
+            if (expr.rfind("SWFOC_ReplayFork(", 0) == 0) {
+                push_num(static_cast<double>(ReplayFork(g_replay, &g_replayForks)));
+                return 9999;
+            }
+            if (expr.rfind("SWFOC_ReplayRestore(", 0) == 0
+                && ExtractArgs(expr, &args) && args.size() == 1) {
+                double id_d = 0.0;
+                if (ParseNumber(args[0], &id_d)) {
+                    push_num(static_cast<double>(ReplayRestore(g_replay, g_replayForks,
+                        static_cast<uint32_t>(id_d))));
+                    return 9999;
+                }
+            }
+            if (expr.rfind("SWFOC_ReplayDropFork(", 0) == 0
+                && ExtractArgs(expr, &args) && args.size() == 1) {
+                double id_d = 0.0;
+                if (ParseNumber(args[0], &id_d)) {
+                    push_num(static_cast<double>(ReplayDropFork(&g_replayForks, static_cast<uint32_t>(id_d))));
+                    return 9999;
+                }
+            }
             if (expr.rfind("SWFOC_ReplayListAbilities(", 0) == 0
                 && ExtractArgs(expr, &args) && args.size() == 1) {
                 double addr_d = 0.0;
@@ -3118,13 +2993,13 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                 std::function<double(uint64_t)>          fn;
             };
             OneArgObserver one_arg[] = {
-                {"SWFOC_ReplayUnitHull(",         [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); return u ? static_cast<double>(u->hull)        : -1.0; }},
-                {"SWFOC_ReplayUnitMaxHull(",      [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); return u ? static_cast<double>(u->max_hull)    : -1.0; }},
-                {"SWFOC_ReplayUnitOwnerSlot(",    [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); return u ? static_cast<double>(u->owner_slot)  : -1.0; }},
-                {"SWFOC_ReplayUnitInvulnFlag(",   [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); return u ? static_cast<double>(u->invuln_flag) : -1.0; }},
-                {"SWFOC_ReplayUnitPreventDeath(", [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); if (!u) return -1.0; return (u->prevent_death & 0x80) ? 1.0 : 0.0; }},
-                {"SWFOC_ReplayHardpointCount(",   [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); return u ? static_cast<double>(u->hardpoints.size()) : -1.0; }},
-                {"SWFOC_ReplayUnitIsInvulnerable(", [](uint64_t a) { auto* u = ReplayFindUnit(g_replay, a); if (!u) return -1.0; return ReplayUnitAnyHardpointHasBehavior(*u, "INVULNERABLE") ? 1.0 : 0.0; }},
+                {"SWFOC_ReplayUnitHull(",         [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); return u ? static_cast<double>(u->hull)        : -1.0; }},
+                {"SWFOC_ReplayUnitMaxHull(",      [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); return u ? static_cast<double>(u->max_hull)    : -1.0; }},
+                {"SWFOC_ReplayUnitOwnerSlot(",    [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); return u ? static_cast<double>(u->owner_slot)  : -1.0; }},
+                {"SWFOC_ReplayUnitInvulnFlag(",   [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); return u ? static_cast<double>(u->invuln_flag) : -1.0; }},
+                {"SWFOC_ReplayUnitPreventDeath(", [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); if (!u) return -1.0; return (u->prevent_death & 0x80) ? 1.0 : 0.0; }},
+                {"SWFOC_ReplayHardpointCount(",   [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); return u ? static_cast<double>(u->hardpoints.size()) : -1.0; }},
+                {"SWFOC_ReplayUnitIsInvulnerable(", [](uint64_t a) { auto* u = ReplayFindUnit(ReplayView(), a); if (!u) return -1.0; return ReplayUnitAnyHardpointHasBehavior(*u, ReplayInvulnerableSymbol()) ? 1.0 : 0.0; }},
                 {"SWFOC_ReplaySetSelected(",      [](uint64_t a) { return static_cast<double>(ReplayMutSetSelected(g_replay, a)); }},
                 {"SWFOC_ReplayAppendSelected(",   [](uint64_t a) { return static_cast<double>(ReplayMutAppendSelected(g_replay, a)); }},
             };
@@ -3203,7 +3078,7 @@ static int ReplayLoad(lua_State* L, lua_Chunkreader reader, void* data, const ch
                 double addr_d = 0.0, hp_d = 0.0;
                 std::string behavior;
                 if (ParseNumber(args[0], &addr_d) && ParseNumber(args[1], &hp_d) && UnquoteString(args[2], &behavior)) {
-                    auto* u = ReplayFindUnit(g_replay, static_cast<uint64_t>(addr_d));
+                    auto* u = ReplayFindUnit(ReplayView(), static_cast<uint64_t>(addr_d));
                     int hp_index = static_cast<int>(hp_d);
                     if (!u || hp_index < 0 || hp_index >= static_cast<int>(u->hardpoints.size())) {
                         push_num(-1.0);
@@ -3333,6 +3208,7 @@ static void RegisterAll(lua_State* L) {
         {"SWFOC_ReplayGetAllPlayers",        Lua_ReplayGetAllPlayers},
         {"SWFOC_ReplayEventStreamDrain",     Lua_ReplayEventStreamDrain},
         {"SWFOC_ReplayEventLogCount",        Lua_ReplayEventLogCount},
+        {"SWFOC_ReplaySetEventStreamCapacity", Lua_ReplaySetEventStreamCapacity},
         {"SWFOC_ReplayEnumerateUnits",       Lua_ReplayEnumerateUnits},
         {"SWFOC_ReplayHealAllLocal",         Lua_ReplayHealAllLocal},
         {"SWFOC_ReplaySetDamageMultiplier",  Lua_ReplaySetDamageMultiplier},
@@ -3377,6 +3253,9 @@ static void RegisterAll(lua_State* L) {
         {"SWFOC_ReplayIsFreezeCredits",      Lua_ReplayIsFreezeCredits},
         {"SWFOC_ReplayFreezeCreditsTarget",  Lua_ReplayFreezeCreditsTarget},
         {"SWFOC_ReplayTickIncome",           Lua_ReplayTickIncome},
+        {"SWFOC_ReplayFork",                 Lua_ReplayFork},
+        {"SWFOC_ReplayRestore",              Lua_ReplayRestore},
+        {"SWFOC_ReplayDropFork",             Lua_ReplayDropFork},
         {"SWFOC_ReplaySetBuildSpeed",        Lua_ReplaySetBuildSpeed},
         {"SWFOC_ReplayGetBuildSpeed",        Lua_ReplayGetBuildSpeed},
         {"SWFOC_ReplaySetFactionSpeedMult",  Lua_ReplaySetFactionSpeedMult},
@@ -3385,8 +3264,11 @@ static void RegisterAll(lua_State* L) {
         {"SWFOC_ReplayGetFireRate",          Lua_ReplayGetFireRate},
         {"SWFOC_ReplayApplyFireRate",        Lua_ReplayApplyFireRate},
         {"SWFOC_ReplaySetAreaDamage",        Lua_ReplaySetAreaDamage},
+        {"SWFOC_ReplaySetAreaDamageShape",   Lua_ReplaySetAreaDamageShape},
         {"SWFOC_ReplayIsAreaDamage",         Lua_ReplayIsAreaDamage},
         {"SWFOC_ReplayApplyAreaSplash",      Lua_ReplayApplyAreaSplash},
+        {"SWFOC_ReplaySetUnitPosition",      Lua_ReplaySetUnitPosition},
+        {"SWFOC_ReplayUnitsInRadius",        Lua_ReplayUnitsInRadius},
         {"SWFOC_ReplaySetTargetFilter",      Lua_ReplaySetTargetFilter},
         {"SWFOC_ReplayGetTargetFilter",      Lua_ReplayGetTargetFilter},
         {"SWFOC_ReplayIsTargetAllowed",      Lua_ReplayIsTargetAllowed},
@@ -3428,6 +3310,103 @@ static void RegisterAll(lua_State* L) {
     }
 }
 
+// Snapshot sections each helper reads or writes, so `--exec` decodes only
+// what its scripts touch. A script naming any SWFOC_* helper missing here
+// (SWFOC_DoString included) gets every section; add a helper only once its
+// body, and the ReplayMut* / ReplayObs* calls under it, are known to stay
+// inside the listed sections.
+#define REPLAY_UNIT_SECTIONS (REPLAY_SECTION(11) | REPLAY_SECTION(12) | REPLAY_SECTION(13) | REPLAY_SECTION(14))
+// What the load summary counts: players, object types, globals, metadata,
+// units and the selection.
+#define REPLAY_SUMMARY_SECTIONS (REPLAY_SECTION(1) | REPLAY_SECTION(3) | REPLAY_SECTION(4) | REPLAY_SECTION(5) \
+                                 | REPLAY_SECTION(11) | REPLAY_SECTION(12))
+
+static const struct { const char* name; uint32_t sections; } kReplayHelperSections[] = {
+    {"SWFOC_GetVersion",                 0},
+    {"SWFOC_Log",                        0},
+    {"SWFOC_EventControl",               0},
+    {"SWFOC_UncapCredits",               0},
+    {"SWFOC_HeroInstantRespawn",         0},
+    {"SWFOC_ReplayGameMode",             0},  // header field
+    {"SWFOC_ReplayLastStoryEvent",       0},
+    {"SWFOC_ReplayPushStoryEvent",       0},
+    {"SWFOC_ReplayEventStreamDrain",     0},  // the log starts empty at load
+    {"SWFOC_ReplayEventLogCount",        0},
+    {"SWFOC_ReplaySetEventStreamCapacity", 0},
+    {"SWFOC_GetLocalPlayer",             REPLAY_SECTION(1)},
+    {"SWFOC_GetCredits",                 REPLAY_SECTION(1)},
+    {"SWFOC_SetCredits",                 REPLAY_SECTION(1)},
+    {"SWFOC_SetTechLevel",               REPLAY_SECTION(1)},
+    {"SWFOC_ListFactions",               REPLAY_SECTION(1)},
+    {"SWFOC_GetLocalFaction",            REPLAY_SECTION(1)},
+    {"SWFOC_ReplayPlayerCount",          REPLAY_SECTION(1)},
+    {"SWFOC_ReplayPlayerCredits",        REPLAY_SECTION(1)},
+    {"SWFOC_ReplayPlayerTechLevel",      REPLAY_SECTION(1)},
+    {"SWFOC_ReplayHumanPlayerSlot",      REPLAY_SECTION(1)},
+    {"SWFOC_ReplaySwitchLocalPlayer",    REPLAY_SECTION(1)},
+    {"SWFOC_StateInfo",                  REPLAY_SECTION(2)},
+    {"SWFOC_ReplayObjectCount",          REPLAY_SECTION(3)},
+    {"SWFOC_ReplayMetadata",             REPLAY_SECTION(5)},
+    {"SWFOC_ReplayPlanetCorruption",     REPLAY_SECTION(6)},
+    {"SWFOC_ReplaySetPlanetCorruption",  REPLAY_SECTION(6)},
+    {"SWFOC_ReplayDiplomaticState",      REPLAY_SECTION(7)},
+    {"SWFOC_ReplaySetDiplomacy",         REPLAY_SECTION(7)},
+    {"SWFOC_ReplayCooldownState",        REPLAY_SECTION(8)},
+    {"SWFOC_ReplaySetCooldown",          REPLAY_SECTION(8)},
+    {"SWFOC_ReplayTaskForceCount",       REPLAY_SECTION(9)},
+    {"SWFOC_ReplayAddTaskForce",         REPLAY_SECTION(9)},
+    {"SWFOC_ReplayUnitOwner",            REPLAY_SECTION(10)},
+    {"SWFOC_ReplaySpawnUnit",            REPLAY_SECTION(1) | REPLAY_SECTION(3) | REPLAY_SECTION(10)},
+    {"SWFOC_ReplayMockUnit",             REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitCount",            REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitHull",             REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitMaxHull",          REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitOwnerSlot",        REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitInvulnFlag",       REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitPreventDeath",     REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayHardpointCount",       REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayHardpointHasBehavior", REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitIsInvulnerable",   REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayAttachBehavior",       REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayDetachBehavior",       REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayMakeInvulnerable",     REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplaySetUnitInvulnFlag",    REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplaySetPreventDeathBit",   REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplaySetUnitHull",          REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayApplyDamage",          REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplaySetSelected",          REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayAppendSelected",       REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayClearSelected",        REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayGetSelectedUnit",      REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplaySelectedCount",        REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplaySetUnitPosition",      REPLAY_UNIT_SECTIONS},
+    {"SWFOC_ReplayUnitsInRadius",        REPLAY_UNIT_SECTIONS},
+};
+
+// Union of the sections the SWFOC_* helpers named in `code` touch.
+static uint32_t ReplaySectionsTouchedBy(const std::string& code) {
+    uint32_t sections = 0;
+    for (size_t pos = code.find("SWFOC_"); pos != std::string::npos;
+         pos = code.find("SWFOC_", pos)) {
+        size_t end = pos;
+        while (end < code.size() && (isalnum(static_cast<unsigned char>(code[end])) || code[end] == '_')) {
+            end++;
+        }
+        const std::string name = code.substr(pos, end - pos);
+        pos = end;
+        bool known = false;
+        for (const auto& h : kReplayHelperSections) {
+            if (name == h.name) {
+                sections |= h.sections;
+                known = true;
+                break;
+            }
+        }
+        if (!known) return REPLAY_ALL_SECTIONS;
+    }
+    return sections;
+}
+
 // ======================================================================
 // Pipe listener -- COPY of lua_bridge.cpp's PipeThreadProc/DrainPipeCommand,
 // adapted to use the replay pipe name and to drive DoString directly on the
@@ -3445,6 +3424,18 @@ static void ReplayExecute(const char* cmd, std::string* response) {
     LogErr("[Replay] Executing: %.120s%s\n", cmd,
            strlen(cmd) > 120 ? "..." : "");
 
+    // Decode the sections this command touches on its first use of them.
+    // Helpers kReplayHelperSections does not list (SWFOC_ReplayFork among
+    // them) decode everything, so a fork never misses a later section.
+    if (!g_replayPending.sections.empty()) {
+        std::string decodeErr;
+        if (DecodePendingSections(&g_replayPending, ReplaySectionsTouchedBy(cmd), g_replay, &decodeErr) < 0) {
+            *response = "ERR: " + decodeErr + "\n";
+            LeaveCriticalSection(&g_replayLock);
+            return;
+        }
+    }
+
     int savedTop = fn_gettop(LS(&g_replayLua));
     int err = DoString(LS(&g_replayLua), cmd, "=replay_pipe");
 
@@ -3466,12 +3457,13 @@ static void ReplayExecute(const char* cmd, std::string* response) {
     LeaveCriticalSection(&g_replayLock);
 }
 
-static DWORD WINAPI ReplayPipeThreadProc(LPVOID) {
-    LogErr("[Replay] Pipe listener thread started on %s\n", REPLAY_PIPE_NAME);
+// Runs on the main thread, whose g_replay holds the loaded snapshot.
+static void ReplayPipeListen() {
+    LogErr("[Replay] Pipe listener started on %s\n", g_replayPipeName);
 
     while (!g_pipeShutdown) {
         HANDLE hPipe = CreateNamedPipeA(
-            REPLAY_PIPE_NAME,
+            g_replayPipeName,
             PIPE_ACCESS_DUPLEX,
             PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT,
             1,             // max instances
@@ -3522,8 +3514,7 @@ static DWORD WINAPI ReplayPipeThreadProc(LPVOID) {
         LogErr("[Replay] Client disconnected\n");
     }
 
-    LogErr("[Replay] Pipe listener thread exiting\n");
-    return 0;
+    LogErr("[Replay] Pipe listener exiting\n");
 }
 
 // ======================================================================
@@ -3537,7 +3528,7 @@ static BOOL WINAPI CtrlHandler(DWORD ctrl) {
         g_pipeShutdown = true;
         // Kick the listener out of its blocking ConnectNamedPipe by opening a
         // throwaway handle to our own pipe.
-        HANDLE h = CreateFileA(REPLAY_PIPE_NAME, GENERIC_READ | GENERIC_WRITE,
+        HANDLE h = CreateFileA(g_replayPipeName, GENERIC_READ | GENERIC_WRITE,
                                0, nullptr, OPEN_EXISTING, 0, nullptr);
         if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
         return TRUE;
@@ -3546,9 +3537,25 @@ static BOOL WINAPI CtrlHandler(DWORD ctrl) {
 }
 
 // ======================================================================
-// main
+// --exec and --corpus script runs
 // ======================================================================
 
+// Runs one snippet on vm. True with the value it returned ("OK" for none)
+// in *out, or false with the error message.
+static bool RunReplayScript(FakeLuaState* vm, const std::string& code, std::string* out) {
+    int savedTop = fn_gettop(LS(vm));
+    int err = DoString(LS(vm), code.c_str(), "=replay_exec");
+    const char* text = fn_tostring(LS(vm), -1);
+    const bool ok = err == 0 || err == 9999;
+    if (ok) {
+        *out = (text && text[0]) ? text : "OK";
+    } else {
+        *out = text ? text : "unknown error";
+    }
+    fn_settop(LS(vm), savedTop);
+    return ok;
+}
+
 static int RunExecScript(const std::vector<std::string>& scripts) {
     // Execute one or more Lua snippets directly against the already-loaded
     // replay VM and print each result on its own line. No pipe. This is the
@@ -3557,72 +3564,816 @@ static int RunExecScript(const std::vector<std::string>& scripts) {
     // read the answer on stdout without setting up a named-pipe client.
     int failures = 0;
     for (const auto& code : scripts) {
-        int savedTop = fn_gettop(LS(&g_replayLua));
-        int err = DoString(LS(&g_replayLua), code.c_str(), "=replay_exec");
-        if (err == 0 || err == 9999) {
-            const char* ret = fn_tostring(LS(&g_replayLua), -1);
-            if (ret && ret[0]) {
-                printf("%s\n", ret);
-            } else {
-                printf("OK\n");
-            }
+        std::string result;
+        if (RunReplayScript(&g_replayLua, code, &result)) {
+            printf("%s\n", result.c_str());
         } else {
-            const char* errMsg = fn_tostring(LS(&g_replayLua), -1);
-            fprintf(stderr, "ERR: %s\n", errMsg ? errMsg : "unknown error");
+            fprintf(stderr, "ERR: %s\n", result.c_str());
             failures++;
         }
-        fn_settop(LS(&g_replayLua), savedTop);
     }
     return failures == 0 ? 0 : 5;
 }
 
+// --simulate advances g_replay with the tick engine (replay_tick.h) and
+// prints one JSON line per observer sample and per checkpoint on stdout,
+// then a summary on the log. Any --exec scripts then run against the
+// advanced state.
+static void PrintTickSample(const ReplayState& s) {
+    int dead_heroes = 0, cooling = 0;
+    for (const auto& entry : s.units) {
+        const ReplayUnitDetail& u = entry.second;
+        dead_heroes += (u.is_hero && u.hull <= 0.0f) ? 1 : 0;
+        for (const auto& a : u.abilities) cooling += a.cooldown_remaining_ms > 0 ? 1 : 0;
+    }
+    printf("{\"tick\":%llu,\"ms\":%llu,\"credits\":[",
+           static_cast<unsigned long long>(s.sim_tick), static_cast<unsigned long long>(s.sim_time_ms));
+    for (size_t i = 0; i < s.players.size(); i++) {
+        printf("%s%.3f", i ? "," : "", s.players[i].credits);
+    }
+    printf("],\"queued\":%zu,\"built\":%u,\"dead_heroes\":%d,\"cooling\":%d}\n",
+           s.build_queue.size(), s.builds_completed, dead_heroes, cooling);
+}
+
+// --events-out: drains what is still queued in g_replay's damage-event log
+// to `path` as binary pages (ReplayObsEventStreamDrainBinary). Returns the
+// events written, or -1 when the file cannot be written.
+static long long WriteEventsOut(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return -1;
+    std::vector<uint8_t> page;
+    long long total = 0;
+    bool ok = true;
+    do {
+        page.clear();
+        total += static_cast<long long>(ReplayObsEventStreamDrainBinary(g_replay, &page));
+        ok = fwrite(page.data(), 1, page.size(), f) == page.size();
+    } while (ok && !g_replay.damage_event_log.empty());
+    ok = fclose(f) == 0 && ok;
+    return ok ? total : -1;
+}
+
+// --timeline: rebuilds g_replay at one point of a session timeline file
+// (timeline_ring.h). atMs 0 means the newest record, less agoSec seconds.
+// The file is read whole first, so a bridge still recording into it cannot
+// change records under the loader.
+static bool LoadTimeline(const char* path, uint64_t atMs, double agoSec, std::string* err) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        *err = std::string("could not open timeline file: ") + path;
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[1 << 16];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    fclose(f);
+
+    TimelineView view;
+    if (const char* e = TimelineOpen(bytes.data(), bytes.size(), &view)) {
+        *err = e;
+        return false;
+    }
+    const TimelineSpan span = TimelineScan(view);
+    if (!span.keyframes) {
+        *err = "timeline holds no keyframe";
+        return false;
+    }
+    if (!atMs) {
+        const uint64_t back = agoSec > 0.0 ? static_cast<uint64_t>(agoSec * 1000.0) : 0;
+        atMs = span.last_ms > back ? span.last_ms - back : 0;
+    }
+    LogOut("[Replay] Timeline pid=%u: %u records from %llu to %llu ms (first keyframe %llu), %llu dropped\n",
+           view.pid, span.records, static_cast<unsigned long long>(span.first_ms),
+           static_cast<unsigned long long>(span.last_ms), static_cast<unsigned long long>(span.first_keyframe_ms),
+           static_cast<unsigned long long>(view.dropped));
+    const TimelineLoadResult r = TimelineLoadState(view, atMs, g_replay);
+    if (!r.ok) {
+        *err = r.error + " (at " + std::to_string(atMs) + " ms)";
+        return false;
+    }
+    LogOut("[Replay] State at %llu ms: keyframe %llu ms + %u events (%u for unknown units, %u gaps)\n",
+           static_cast<unsigned long long>(r.at_ms), static_cast<unsigned long long>(r.keyframe_ms),
+           r.events_applied, r.unknown_units, r.gaps);
+    return true;
+}
+
+static void RunSimulation(uint64_t ticks, const ReplayTickConfig& cfg) {
+    std::vector<ReplayTickCheckpoint> checkpoints;
+    ReplayTickStats st;
+    ReplayTickRun(g_replay, cfg, ticks, PrintTickSample, cfg.checkpoint_every ? &checkpoints : nullptr, &st);
+    for (const auto& cp : checkpoints) {
+        printf("{\"checkpoint\":%llu,\"digest\":\"%016llx\"}\n",
+               static_cast<unsigned long long>(cp.tick), static_cast<unsigned long long>(cp.digest));
+    }
+    LogOut("[Replay] Simulated %llu ticks of %d ms: %llu income ticks, %llu abilities ready, "
+           "%llu builds, %llu respawns, digest %016llx\n",
+           static_cast<unsigned long long>(st.ticks), cfg.dt_ms,
+           static_cast<unsigned long long>(st.income_touches),
+           static_cast<unsigned long long>(st.abilities_ready),
+           static_cast<unsigned long long>(st.builds_completed),
+           static_cast<unsigned long long>(st.heroes_revived),
+           static_cast<unsigned long long>(ReplayTickDigest(g_replay)));
+}
+
+// --corpus runs the --exec scripts against every snapshot of a directory or
+// list file on a pool of worker threads. Each worker owns a FakeLuaState and
+// its own g_replay, and loads one snapshot at a time into them; the helpers,
+// fn_* pointers and CRC table are shared read-only. Records reach stdout in
+// corpus order, each snapshot's as soon as it and every snapshot ahead of it
+// are done, so memory holds only the results of snapshots finished early.
+
+static bool CorpusIsSnapshotName(const char* name) {
+    static const char kExt[] = ".swfocsnap";
+    const size_t n = strlen(name), e = sizeof(kExt) - 1;
+    if (n <= e) return false;
+    for (size_t i = 0; i < e; i++) {
+        if (tolower(static_cast<unsigned char>(name[n - e + i])) != kExt[i]) return false;
+    }
+    return true;
+}
+
+// Fills *paths from a directory (its *.swfocsnap files, sorted by name) or a
+// list file (one path per line; blank lines and `#` comments skipped).
+// Returns false, with what was wrong in *error.
+static bool ListCorpus(const char* source, std::vector<std::string>* paths, std::string* error) {
+    const DWORD attrs = GetFileAttributesA(source);
+    if (attrs == INVALID_FILE_ATTRIBUTES) {
+        *error = "not found";
+        return false;
+    }
+    if (attrs & FILE_ATTRIBUTE_DIRECTORY) {
+        const std::string dir = source;
+        WIN32_FIND_DATAA fd;
+        HANDLE h = FindFirstFileA((dir + "\\*").c_str(), &fd);
+        if (h != INVALID_HANDLE_VALUE) {
+            do {
+                if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && CorpusIsSnapshotName(fd.cFileName)) {
+                    paths->push_back(dir + "\\" + fd.cFileName);
+                }
+            } while (FindNextFileA(h, &fd));
+            FindClose(h);
+        }
+        std::sort(paths->begin(), paths->end());
+        return true;
+    }
+    FILE* f = fopen(source, "rb");
+    if (!f) {
+        *error = "cannot open list file";
+        return false;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        std::string path = line;
+        const size_t b = path.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos || path[b] == '#') continue;
+        path.erase(path.find_last_not_of(" \t\r\n") + 1);
+        paths->push_back(path.substr(b));
+    }
+    fclose(f);
+    return true;
+}
+
+static void AppendCsvField(std::string* out, const std::string& s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos) {
+        out->append(s);
+        return;
+    }
+    out->push_back('"');
+    for (char c : s) {
+        if (c == '"') out->push_back('"');
+        out->push_back(c);
+    }
+    out->push_back('"');
+}
+
+// One output line. script < 0: the snapshot itself failed to load.
+static void AppendCorpusRecord(std::string* out, bool csv, const std::string& path,
+                               int script, bool ok, const std::string& text) {
+    if (csv) {
+        AppendCsvField(out, path);
+        out->push_back(',');
+        if (script >= 0) out->append(std::to_string(script));
+        out->append(ok ? ",ok," : ",error,");
+        AppendCsvField(out, text);
+    } else {
+        out->append("{\"snapshot\":");
+        ReplayJsonString(out, path);
+        out->append(",\"script\":");
+        out->append(script >= 0 ? std::to_string(script) : "null");
+        out->append(ok ? ",\"ok\":true,\"result\":" : ",\"ok\":false,\"error\":");
+        ReplayJsonString(out, text);
+        out->push_back('}');
+    }
+    out->push_back('\n');
+}
+
+struct CorpusRun {
+    const std::vector<std::string>* paths;
+    const std::vector<std::string>* scripts;
+    const std::vector<std::string>* bases;
+    uint32_t sections;
+    bool     csv;
+
+    volatile LONG            claimed = 0;  // snapshots handed to workers
+    CRITICAL_SECTION         lock;         // guards the fields below and stdout
+    std::vector<std::string> records;      // per snapshot, until flushed
+    std::vector<char>        finished;
+    size_t                   flushed = 0;  // snapshots [0, flushed) are on stdout
+    int                      failures = 0;
+};
+
+static DWORD WINAPI CorpusWorkerProc(LPVOID param) {
+    CorpusRun* run = static_cast<CorpusRun*>(param);
+    FakeLuaState vm;
+    RegisterAll(LS(&vm));
+    fake_checkpoint(&vm);  // each snapshot starts from the registered helpers
+    for (;;) {
+        const size_t i = static_cast<size_t>(InterlockedIncrement(&run->claimed)) - 1;
+        if (i >= run->paths->size()) break;
+        const std::string& path = (*run->paths)[i];
+
+        std::string out;
+        int failures = 0;
+        g_replay = ReplayState();
+        ReplayDropFork(&g_replayForks, 0);
+        auto r = LoadSnapshot(path.c_str(), g_replay, *run->bases, run->sections);
+        if (!r.ok) {
+            AppendCorpusRecord(&out, run->csv, path, -1, false, r.error);
+            failures++;
+        } else {
+            fake_restore(&vm);
+            for (size_t k = 0; k < run->scripts->size(); k++) {
+                std::string result;
+                const bool ok = RunReplayScript(&vm, (*run->scripts)[k], &result);
+                AppendCorpusRecord(&out, run->csv, path, static_cast<int>(k), ok, result);
+                if (!ok) failures++;
+            }
+        }
+
+        EnterCriticalSection(&run->lock);
+        run->records[i] = std::move(out);
+        run->finished[i] = 1;
+        run->failures += failures;
+        while (run->flushed < run->finished.size() && run->finished[run->flushed]) {
+            fputs(run->records[run->flushed].c_str(), stdout);
+            std::string().swap(run->records[run->flushed]);
+            run->flushed++;
+        }
+        fflush(stdout);
+        LeaveCriticalSection(&run->lock);
+    }
+    g_replay = ReplayState();
+    ReplayDropFork(&g_replayForks, 0);
+    return 0;
+}
+
+// Expects WireFakes() and the fn_load override to be in place.
+static int RunCorpus(const std::vector<std::string>& paths, const std::vector<std::string>& scripts,
+                     const std::vector<std::string>& bases, uint32_t sections, bool csv, int jobs) {
+    CorpusRun run;
+    run.paths = &paths;
+    run.scripts = &scripts;
+    run.bases = &bases;
+    run.sections = sections;
+    run.csv = csv;
+    run.records.resize(paths.size());
+    run.finished.assign(paths.size(), 0);
+    InitializeCriticalSection(&run.lock);
+
+    if (csv) printf("snapshot,script,status,value\n");
+    if (jobs > static_cast<int>(paths.size())) jobs = static_cast<int>(paths.size());
+    std::vector<HANDLE> threads;
+    for (int t = 0; t < jobs; t++) {
+        HANDLE h = CreateThread(nullptr, 0, CorpusWorkerProc, &run, 0, nullptr);
+        if (!h) break;
+        threads.push_back(h);
+    }
+    if (threads.empty()) {
+        LogErr("[Replay] Failed to create corpus worker threads: %lu\n", GetLastError());
+        DeleteCriticalSection(&run.lock);
+        return 4;
+    }
+    WaitForMultipleObjects(static_cast<DWORD>(threads.size()), threads.data(), TRUE, INFINITE);
+    for (HANDLE h : threads) CloseHandle(h);
+    DeleteCriticalSection(&run.lock);
+
+    LogErr("[Replay] Corpus: %zu snapshots, %zu scripts, %zu threads, %d failures\n",
+           paths.size(), scripts.size(), threads.size(), run.failures);
+    return run.failures == 0 ? 0 : 5;
+}
+
+// --sweep simulates every point of a parameter grid (replay_sweep.h) on a
+// pool of worker threads. Each worker copies g_replay once and rearms its
+// copy between runs; rows reach stdout in run order, as --corpus records do.
+struct SweepRun {
+    const ReplayState*                  base;
+    const std::vector<ReplaySweepAxis>* axes;
+    ReplayTickConfig                    cfg;
+    uint64_t                            ticks;
+    bool                                csv;
+    size_t                              runs;
+
+    volatile LONG            claimed = 0;  // runs handed to workers
+    CRITICAL_SECTION         lock;         // guards the fields below and stdout
+    std::vector<std::string> rows;         // per run, until flushed
+    std::vector<char>        finished;
+    size_t                   flushed = 0;
+};
+
+static void AppendSweepRow(std::string* out, const SweepRun& run, size_t r, const ReplaySweepResult& res) {
+    char buf[64];
+    const auto& axes = *run.axes;
+    if (run.csv) {
+        out->append(std::to_string(r));
+        for (size_t k = 0; k < axes.size(); k++) {
+            snprintf(buf, sizeof(buf), ",%g", static_cast<double>(ReplaySweepValue(axes, r, k)));
+            out->append(buf);
+        }
+        for (double c : res.credits) {
+            snprintf(buf, sizeof(buf), ",%.3f", c);
+            out->append(buf);
+        }
+        for (uint32_t a : res.alive) out->append("," + std::to_string(a));
+        snprintf(buf, sizeof(buf), ",%llu,%llu,%016llx",
+                 static_cast<unsigned long long>(res.stats.builds_completed),
+                 static_cast<unsigned long long>(res.stats.units_lost),
+                 static_cast<unsigned long long>(res.digest));
+        out->append(buf);
+    } else {
+        out->append("{\"run\":" + std::to_string(r));
+        for (size_t k = 0; k < axes.size(); k++) {
+            out->push_back(',');
+            ReplayJsonString(out, axes[k].label);
+            snprintf(buf, sizeof(buf), ":%g", static_cast<double>(ReplaySweepValue(axes, r, k)));
+            out->append(buf);
+        }
+        out->append(",\"credits\":[");
+        for (size_t i = 0; i < res.credits.size(); i++) {
+            snprintf(buf, sizeof(buf), "%s%.3f", i ? "," : "", res.credits[i]);
+            out->append(buf);
+        }
+        out->append("],\"alive\":[");
+        for (size_t i = 0; i < res.alive.size(); i++) {
+            out->append((i ? "," : "") + std::to_string(res.alive[i]));
+        }
+        snprintf(buf, sizeof(buf), "],\"built\":%llu,\"lost\":%llu,\"digest\":\"%016llx\"}",
+                 static_cast<unsigned long long>(res.stats.builds_completed),
+                 static_cast<unsigned long long>(res.stats.units_lost),
+                 static_cast<unsigned long long>(res.digest));
+        out->append(buf);
+    }
+    out->push_back('\n');
+}
+
+static DWORD WINAPI SweepWorkerProc(LPVOID param) {
+    SweepRun* run = static_cast<SweepRun*>(param);
+    ReplayState work = *run->base;
+    ReplaySweepResult res;
+    for (;;) {
+        const size_t r = static_cast<size_t>(InterlockedIncrement(&run->claimed)) - 1;
+        if (r >= run->runs) break;
+        ReplaySweepRun(work, *run->base, *run->axes, r, run->cfg, run->ticks, &res);
+        std::string row;
+        AppendSweepRow(&row, *run, r, res);
+
+        EnterCriticalSection(&run->lock);
+        run->rows[r] = std::move(row);
+        run->finished[r] = 1;
+        while (run->flushed < run->finished.size() && run->finished[run->flushed]) {
+            fputs(run->rows[run->flushed].c_str(), stdout);
+            std::string().swap(run->rows[run->flushed]);
+            run->flushed++;
+        }
+        fflush(stdout);
+        LeaveCriticalSection(&run->lock);
+    }
+    return 0;
+}
+
+static int RunSweep(const std::vector<ReplaySweepAxis>& axes, const ReplayTickConfig& cfg, uint64_t ticks,
+                    bool csv, int jobs) {
+    SweepRun run;
+    run.base = &g_replay;
+    run.axes = &axes;
+    run.cfg = cfg;
+    run.ticks = ticks;
+    run.csv = csv;
+    run.runs = ReplaySweepRuns(axes);
+    run.rows.resize(run.runs);
+    run.finished.assign(run.runs, 0);
+    InitializeCriticalSection(&run.lock);
+
+    if (csv) {
+        std::string header = "run";
+        for (const auto& a : axes) header += "," + a.label;
+        for (const auto& p : g_replay.players) header += ",credits_" + std::to_string(p.slot);
+        for (const auto& p : g_replay.players) header += ",alive_" + std::to_string(p.slot);
+        printf("%s,built,lost,digest\n", header.c_str());
+    }
+    if (jobs > static_cast<int>(run.runs)) jobs = static_cast<int>(run.runs);
+    std::vector<HANDLE> threads;
+    for (int t = 0; t < jobs; t++) {
+        HANDLE h = CreateThread(nullptr, 0, SweepWorkerProc, &run, 0, nullptr);
+        if (!h) break;
+        threads.push_back(h);
+    }
+    if (threads.empty()) {
+        LogErr("[Replay] Failed to create sweep worker threads: %lu\n", GetLastError());
+        DeleteCriticalSection(&run.lock);
+        return 4;
+    }
+    WaitForMultipleObjects(static_cast<DWORD>(threads.size()), threads.data(), TRUE, INFINITE);
+    for (HANDLE h : threads) CloseHandle(h);
+    DeleteCriticalSection(&run.lock);
+
+    LogErr("[Replay] Sweep: %zu runs of %llu ticks, %zu threads\n",
+           run.runs, static_cast<unsigned long long>(ticks), threads.size());
+    return 0;
+}
+
+// --diff compares two snapshots one section group at a time (replay_diff.h):
+// each group's sections of both files are decoded into fresh states,
+// diffed to stdout and dropped before the next group. Returns 0 when the
+// files match, 1 when they differ, 3 when either fails to load.
+static int RunDiff(const char* pathA, const char* pathB, const std::vector<std::string>& bases) {
+    size_t changes = 0;
+    std::string out;
+    {
+        ReplayState a, b;
+        auto ra = LoadSnapshot(pathA, a, bases, 0);
+        auto rb = ra.ok ? LoadSnapshot(pathB, b, bases, 0) : SnapshotLoadResult();
+        if (!ra.ok || !rb.ok) {
+            LogErr("[Replay] Failed to load '%s': %s\n", ra.ok ? pathB : pathA, (ra.ok ? rb : ra).error.c_str());
+            return 3;
+        }
+        changes += ReplayDiffHeader(a, b, &out);
+    }
+    for (int g = 0; g < REPLAY_DIFF_GROUPS; g++) {
+        ReplayState a, b;
+        const uint32_t sections = ReplayDiffGroup(g).sections;
+        auto ra = LoadSnapshot(pathA, a, bases, sections);
+        auto rb = ra.ok ? LoadSnapshot(pathB, b, bases, sections) : SnapshotLoadResult();
+        if (!ra.ok || !rb.ok) {
+            LogErr("[Replay] Failed to load the %s of '%s': %s\n", ReplayDiffGroup(g).name,
+                   ra.ok ? pathB : pathA, (ra.ok ? rb : ra).error.c_str());
+            return 3;
+        }
+        changes += ReplayDiffSection(g, a, ra.sections_loaded > 0, b, rb.sections_loaded > 0, &out);
+        fwrite(out.data(), 1, out.size(), stdout);
+        out.clear();
+    }
+    fflush(stdout);
+    LogErr("[Replay] Diff: %zu changes\n", changes);
+    return changes ? 1 : 0;
+}
+
+// --jobs, or one worker per CPU, within [1, MAXIMUM_WAIT_OBJECTS].
+static int WorkerCount(int jobs) {
+    if (!jobs) {
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        jobs = static_cast<int>(si.dwNumberOfProcessors);
+    }
+    if (jobs < 1) jobs = 1;
+    if (jobs > MAXIMUM_WAIT_OBJECTS) jobs = MAXIMUM_WAIT_OBJECTS;
+    return jobs;
+}
+
+// ======================================================================
+// main
+// ======================================================================
+
+// replay_bench.cpp includes this file for LoadSnapshot and brings its own
+// main.
+#ifndef REPLAY_HARNESS_NO_MAIN
 int main(int argc, char** argv) {
     // CLI:
     //   swfoc_replay.exe <snapshot>                     — host the pipe listener
     //   swfoc_replay.exe <snapshot> --exec "<lua>" [...] — run one or more Lua
     //                                                     snippets offline and exit
     //   swfoc_replay.exe <snapshot> --dump              — print summary and exit
+    //   swfoc_replay.exe <delta> --base <snapshot> [...] — rebuild a v4 delta
+    //                                                     from its base chain
+    //   swfoc_replay.exe --corpus <dir|list> --exec "<lua>" [...]
+    //                                                   — run the snippets
+    //                                                     against every snapshot
+    //   swfoc_replay.exe <snapshot> --simulate <n> [--dt <ms>] [...]
+    //                                                   — advance the state n
+    //                                                     fixed-step ticks
+    //   swfoc_replay.exe <snapshot> --simulate <n> --sweep "<grid>" [...]
+    //                                                   — simulate every point
+    //                                                     of a parameter grid
+    //   swfoc_replay.exe --diff <a> <b> [--base <snapshot> ...]
+    //                                                   — field-level changes
+    //                                                     between two captures
+    //   swfoc_replay.exe <snapshot> --instance <tag|pid> — host the pipe at
+    //                                                     an instance-scoped name
+    //   swfoc_replay.exe --list-instances               — running servers
+    //   swfoc_replay.exe --timeline <file> [--at <ms> | --ago <s>] [...]
+    //                                                   — a point of a session
+    //                                                     timeline instead of
+    //                                                     a snapshot
     if (argc < 2) {
         fprintf(stderr,
             "Usage: %s <path-to-snapshot.swfocsnap> [--exec \"<lua>\" ...] [--dump]\n"
+            "       [--base <snapshot> ...]\n"
+            "       %s --corpus <dir|list> --exec \"<lua>\" [...] [--jobs <n>]\n"
+            "       [--format jsonl|csv] [--base <snapshot> ...]\n"
+            "       %s <path-to-snapshot.swfocsnap> --simulate <n> [--dt <ms>]\n"
+            "       [--income <credits/s>] [--attrition <hull/s>] [--every <k>]\n"
+            "       [--checkpoint <k>] [--exec ...] [--events-out <file>]\n"
+            "       %s <path-to-snapshot.swfocsnap> --simulate <n> --sweep \"<grid>\"\n"
+            "       [--dt <ms>] [--income ...] [--attrition ...] [--jobs <n>] [--format ...]\n"
+            "       %s --diff <a.swfocsnap> <b.swfocsnap> [--base <snapshot> ...]\n"
+            "       %s <path-to-snapshot.swfocsnap> [--instance <tag|pid>]\n"
+            "       %s --list-instances\n"
+            "       %s --timeline <file.swfoctl> [--at <unix ms> | --ago <seconds>] [--exec ...]\n"
             "\n"
             "Default: load the snapshot and host the replay pipe at %s.\n"
             "--exec   Run the given Lua snippets, print each result on stdout, exit.\n"
-            "         Use `return <expr>` so the snippet pushes a value.\n"
-            "--dump   Print a one-line summary of the loaded state and exit.\n",
+            "         Use `return <expr>` so the snippet pushes a value. Only the\n"
+            "         snapshot sections the named helpers touch are decoded.\n"
+            "--dump   Print a one-line summary of the loaded state and exit.\n"
+            "--base   A capture a v4 delta may be based on; repeat for a chain, in\n"
+            "         any order.\n"
+            "--corpus Run the --exec snippets against every *.swfocsnap in a\n"
+            "         directory, or every path listed in a file (one per line, `#`\n"
+            "         comments), and print one record per snapshot and snippet.\n"
+            "--jobs   Corpus or sweep worker threads (default: one per CPU, at most\n"
+            "         %d).\n"
+            "--format Corpus records or sweep rows as JSON lines (default) or CSV.\n"
+            "--simulate Advance income, ability cooldowns, build queues, hero\n"
+            "         respawns and frozen credits n ticks of --dt ms (default %d),\n"
+            "         then run any --exec snippets against the result.\n"
+            "--income Base credits per game second per player (default 0).\n"
+            "--attrition Hull every unit loses per game second, times the fire rate\n"
+            "         and its damage multiplier (default 0).\n"
+            "--every  Print the state as a JSON line every k ticks.\n"
+            "--checkpoint Keep the state every k ticks; print each one's digest.\n"
+            "--events-out Write the damage events still queued after --simulate and\n"
+            "         --exec to a file: pages of a 16-byte header (count, remaining,\n"
+            "         dropped) and count 32-byte damage_ring.h DamageEvent records.\n"
+            "--sweep  Simulate once per point of the grid and print one row per run,\n"
+            "         e.g. \"income=0.5,1,2;damage@1=1,2;fire_rate=1,1.5\". Axes:\n"
+            "         income, damage, fire_rate, build_speed (`@slot` for a per-slot\n"
+            "         override) and game_speed.\n"
+            "--diff   Print what changed from a to b as JSON lines: players by slot,\n"
+            "         planets and other named records by name, units by obj_addr.\n"
+            "         Exit code 0 when they match, 1 when they differ.\n"
+            "--instance Host the pipe at %s_<tag> instead, so several\n"
+            "         servers can run at once; `pid` uses this process's PID.\n"
+            "--list-instances Print every running bridge and replay server as\n"
+            "         JSON lines (kind, pid, tag, pipe, started, source).\n"
+            "--timeline Load the state at one point of a SWFOC_Timeline ring file\n"
+            "         (its newest record by default) in place of a snapshot; every\n"
+            "         mode but --corpus, --diff and --base takes it.\n"
+            "--at     Timeline point as Unix ms.\n"
+            "--ago    Timeline point as seconds before its newest record.\n",
+            argv[0] ? argv[0] : "swfoc_replay.exe",
+            argv[0] ? argv[0] : "swfoc_replay.exe",
+            argv[0] ? argv[0] : "swfoc_replay.exe",
+            argv[0] ? argv[0] : "swfoc_replay.exe",
             argv[0] ? argv[0] : "swfoc_replay.exe",
-            REPLAY_PIPE_NAME);
+            argv[0] ? argv[0] : "swfoc_replay.exe",
+            argv[0] ? argv[0] : "swfoc_replay.exe",
+            argv[0] ? argv[0] : "swfoc_replay.exe",
+            REPLAY_PIPE_NAME, MAXIMUM_WAIT_OBJECTS, REPLAY_TICK_DEFAULT_DT_MS, REPLAY_PIPE_NAME);
         return 2;
     }
 
-    const char* snapPath = argv[1];
+    const char* snapPath = nullptr;
+    const char* corpusPath = nullptr;
     bool dumpOnly = false;
+    bool csv = false;
+    int jobs = 0;
     std::vector<std::string> execScripts;
-    for (int i = 2; i < argc; ++i) {
+    std::vector<std::string> basePaths;
+    long long simTicks = -1;
+    ReplayTickConfig simCfg;
+    const char* sweepSpec = nullptr;
+    const char* eventsOut = nullptr;
+    const char* diffA = nullptr;
+    const char* diffB = nullptr;
+    const char* instanceSpec = nullptr;
+    bool listInstances = false;
+    const char* timelinePath = nullptr;
+    uint64_t timelineAtMs = 0;
+    double timelineAgoSec = 0.0;
+    for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--dump") {
             dumpOnly = true;
+        } else if (arg == "--list-instances") {
+            listInstances = true;
+        } else if (arg == "--timeline") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "--timeline requires a timeline file\n");
+                return 2;
+            }
+            timelinePath = argv[++i];
+        } else if (arg == "--at" || arg == "--ago") {
+            const double v = i + 1 < argc ? atof(argv[++i]) : 0.0;
+            if (v <= 0.0) {
+                fprintf(stderr, "%s requires a positive value\n", arg.c_str());
+                return 2;
+            }
+            if (arg == "--at") timelineAtMs = static_cast<uint64_t>(v);
+            else timelineAgoSec = v;
+        } else if (arg == "--instance") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "--instance requires a tag or `pid`\n");
+                return 2;
+            }
+            instanceSpec = argv[++i];
+        } else if (arg == "--base") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "--base requires a snapshot path\n");
+                return 2;
+            }
+            basePaths.emplace_back(argv[++i]);
         } else if (arg == "--exec") {
             if (i + 1 >= argc) {
                 fprintf(stderr, "--exec requires a Lua snippet\n");
                 return 2;
             }
             execScripts.emplace_back(argv[++i]);
+        } else if (arg == "--corpus") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "--corpus requires a directory or list file\n");
+                return 2;
+            }
+            corpusPath = argv[++i];
+        } else if (arg == "--jobs") {
+            jobs = i + 1 < argc ? atoi(argv[++i]) : 0;
+            if (jobs < 1) {
+                fprintf(stderr, "--jobs requires a positive thread count\n");
+                return 2;
+            }
+        } else if (arg == "--format") {
+            std::string fmt = i + 1 < argc ? argv[++i] : "";
+            if (fmt != "jsonl" && fmt != "csv") {
+                fprintf(stderr, "--format requires jsonl or csv\n");
+                return 2;
+            }
+            csv = fmt == "csv";
+        } else if (arg == "--simulate") {
+            simTicks = i + 1 < argc ? atoll(argv[++i]) : -1;
+            if (simTicks < 0) {
+                fprintf(stderr, "--simulate requires a tick count\n");
+                return 2;
+            }
+        } else if (arg == "--dt") {
+            simCfg.dt_ms = i + 1 < argc ? atoi(argv[++i]) : 0;
+            if (simCfg.dt_ms < 1 || simCfg.dt_ms > REPLAY_TICK_MAX_DT_MS) {
+                fprintf(stderr, "--dt requires 1..%d ms\n", REPLAY_TICK_MAX_DT_MS);
+                return 2;
+            }
+        } else if (arg == "--income") {
+            simCfg.income_per_sec = i + 1 < argc ? atof(argv[++i]) : 0.0;
+        } else if (arg == "--attrition") {
+            simCfg.attrition_per_sec = i + 1 < argc ? static_cast<float>(atof(argv[++i])) : 0.0f;
+        } else if (arg == "--sweep") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "--sweep requires a parameter grid\n");
+                return 2;
+            }
+            sweepSpec = argv[++i];
+        } else if (arg == "--diff") {
+            if (i + 2 >= argc) {
+                fprintf(stderr, "--diff requires two snapshot paths\n");
+                return 2;
+            }
+            diffA = argv[++i];
+            diffB = argv[++i];
+        } else if (arg == "--events-out") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "--events-out requires a file path\n");
+                return 2;
+            }
+            eventsOut = argv[++i];
+        } else if (arg == "--every" || arg == "--checkpoint") {
+            const int k = i + 1 < argc ? atoi(argv[++i]) : 0;
+            if (k < 1) {
+                fprintf(stderr, "%s requires a positive tick count\n", arg.c_str());
+                return 2;
+            }
+            (arg == "--every" ? simCfg.sample_every : simCfg.checkpoint_every) = static_cast<uint32_t>(k);
+        } else if (i == 1 && arg.compare(0, 2, "--") != 0) {
+            snapPath = argv[i];
         } else {
             fprintf(stderr, "unknown flag: %s\n", arg.c_str());
             return 2;
         }
     }
+    if (listInstances) {
+        if (argc != 2) {
+            fprintf(stderr, "--list-instances takes no other arguments\n");
+            return 2;
+        }
+        for (const InstanceRecord& r : InstanceRegistryList()) printf("%s\n", InstanceRecordJson(r).c_str());
+        return 0;
+    }
+    char instanceTag[INSTANCE_TAG_MAX] = "";
+    if (!InstanceTagResolve(instanceSpec, GetCurrentProcessId(), instanceTag, sizeof(instanceTag))) {
+        fprintf(stderr, "--instance requires `pid` or 1..%d of [A-Za-z0-9_-]\n", INSTANCE_TAG_MAX - 1);
+        return 2;
+    }
+    InstanceName(REPLAY_PIPE_NAME, instanceTag, g_replayPipeName, sizeof(g_replayPipeName));
+    if (diffA) {
+        if (snapPath || corpusPath || dumpOnly || !execScripts.empty() || simTicks >= 0 || eventsOut) {
+            fprintf(stderr, "--diff takes two snapshot paths and --base only\n");
+            return 2;
+        }
+        return RunDiff(diffA, diffB, basePaths);
+    }
+    if (timelinePath) {
+        if (snapPath || corpusPath || !basePaths.empty()) {
+            fprintf(stderr, "--timeline replaces the snapshot path; it takes no --corpus or --base\n");
+            return 2;
+        }
+        snapPath = timelinePath;
+    } else if (timelineAtMs || timelineAgoSec > 0.0) {
+        fprintf(stderr, "--at and --ago pick a point of a --timeline file\n");
+        return 2;
+    }
+    if (timelineAtMs && timelineAgoSec > 0.0) {
+        fprintf(stderr, "--at and --ago are exclusive\n");
+        return 2;
+    }
+    if (corpusPath ? (snapPath || dumpOnly || execScripts.empty()) : !snapPath) {
+        fprintf(stderr, corpusPath ? "--corpus takes --exec snippets and no snapshot path\n"
+                                   : "a snapshot path or --corpus is required\n");
+        return 2;
+    }
+    if (simTicks >= 0 && (corpusPath || dumpOnly)) {
+        fprintf(stderr, "--simulate takes a snapshot path, not --corpus or --dump\n");
+        return 2;
+    }
+    if (eventsOut && (corpusPath || sweepSpec || (simTicks < 0 && execScripts.empty()))) {
+        fprintf(stderr, "--events-out takes --simulate or --exec, not --corpus or --sweep\n");
+        return 2;
+    }
+    std::vector<ReplaySweepAxis> sweepAxes;
+    if (sweepSpec) {
+        std::string error;
+        if (simTicks < 0 || !execScripts.empty() || simCfg.sample_every || simCfg.checkpoint_every) {
+            fprintf(stderr, "--sweep takes --simulate and no --exec, --every or --checkpoint\n");
+            return 2;
+        }
+        if (!ReplaySweepParse(sweepSpec, &sweepAxes, &error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
 
-    // --- 1. Load the snapshot ---
-    auto r = LoadSnapshot(snapPath, g_replay);
-    if (!r.ok) {
-        LogErr("[Replay] Failed to load '%s': %s\n", snapPath, r.error.c_str());
-        return 3;
+    // --exec decodes only the sections its scripts touch and --dump only
+    // those its summary counts; --simulate decodes all. The pipe listener,
+    // whose commands are not known up front, decodes the summary's sections
+    // at load and each other section when a command first touches it.
+    uint32_t sections = REPLAY_ALL_SECTIONS;
+    const bool listen = !dumpOnly && simTicks < 0 && execScripts.empty() && !corpusPath;
+    if (instanceSpec && !listen) {
+        fprintf(stderr, "--instance names the pipe; it takes a snapshot path and no other mode\n");
+        return 2;
+    }
+    if (simTicks < 0) {
+        sections = dumpOnly || listen ? REPLAY_SUMMARY_SECTIONS : 0;
+        for (const auto& code : execScripts) sections |= ReplaySectionsTouchedBy(code);
+    }
+
+    if (corpusPath) {
+        std::vector<std::string> paths;
+        std::string error;
+        if (!ListCorpus(corpusPath, &paths, &error)) {
+            LogErr("[Replay] Failed to list corpus '%s': %s\n", corpusPath, error.c_str());
+            return 3;
+        }
+        if (paths.empty()) {
+            LogErr("[Replay] Corpus '%s' lists no snapshots\n", corpusPath);
+            return 3;
+        }
+        WireFakes();
+        fn_load = reinterpret_cast<pfn_lua_load>(&ReplayLoad);
+        return RunCorpus(paths, execScripts, basePaths, sections, csv, WorkerCount(jobs));
     }
 
-    LogOut("[Replay] Loaded %zu bytes, magic OK, version=%u\n",
-           r.total_bytes, g_replay.format_version);
+    // --- 1. Load the snapshot (or the timeline point) ---
+    SnapshotLoadResult r;
+    if (timelinePath) {
+        if (!LoadTimeline(timelinePath, timelineAtMs, timelineAgoSec, &r.error)) {
+            LogErr("[Replay] Failed to load timeline '%s': %s\n", timelinePath, r.error.c_str());
+            return 3;
+        }
+    } else {
+        r = LoadSnapshot(snapPath, g_replay, basePaths, sections, listen ? &g_replayPending : nullptr);
+        if (!r.ok) {
+            LogErr("[Replay] Failed to load '%s': %s\n", snapPath, r.error.c_str());
+            return 3;
+        }
+        LogOut("[Replay] Loaded %zu bytes, magic OK, version=%u\n",
+               r.total_bytes, g_replay.format_version);
+    }
     LogOut("[Replay] %zu players, %zu object types, %zu globals, %zu metadata entries\n",
            g_replay.players.size(),
            g_replay.objects.size(),
@@ -3631,12 +4382,21 @@ int main(int argc, char** argv) {
     LogOut("[Replay] %zu units, %zu selected\n",
            g_replay.units.size(),
            g_replay.selected_units.size());
+    if (r.sections_loaded != r.sections_total) {
+        LogOut("[Replay] %zu of %zu sections decoded%s (the rest are %s)\n",
+               r.sections_loaded, r.sections_total, r.indexed ? " via the section index" : "",
+               listen ? "decoded on first use" : execScripts.empty() ? "not in the summary" : "untouched by --exec");
+    }
 
     if (dumpOnly && execScripts.empty()) {
         // Nothing else to do; the LogOut lines above are the summary.
         return 0;
     }
 
+    if (sweepSpec) {
+        return RunSweep(sweepAxes, simCfg, static_cast<uint64_t>(simTicks), csv, WorkerCount(jobs));
+    }
+
     // --- 2. Wire up fake Lua + register SWFOC_* helpers ---
     WireFakes();
     InitializeCriticalSection(&g_replayLock);
@@ -3647,30 +4407,50 @@ int main(int argc, char** argv) {
     // commands return real values instead of "nil" stubs.
     fn_load = reinterpret_cast<pfn_lua_load>(&ReplayLoad);
 
-    // --- 3. If --exec was supplied, run scripts and exit.
-    if (!execScripts.empty()) {
-        int rc = RunExecScript(execScripts);
+    // --- 3. If --simulate was supplied, advance the state first; then, if
+    // --exec was supplied, run scripts and exit.
+    // With --events-out, the events still queued afterwards go to the file.
+    if (simTicks >= 0 || !execScripts.empty()) {
+        int rc = 0;
+        if (simTicks >= 0) RunSimulation(static_cast<uint64_t>(simTicks), simCfg);
+        if (!execScripts.empty()) rc = RunExecScript(execScripts);
+        if (eventsOut) {
+            const long long n = WriteEventsOut(eventsOut);
+            if (n < 0) {
+                LogErr("[Replay] Failed to write events to '%s'\n", eventsOut);
+                rc = rc ? rc : 3;
+            } else {
+                LogOut("[Replay] Wrote %lld damage events to %s (%llu dropped)\n", n, eventsOut,
+                       static_cast<unsigned long long>(ReplayObsEventLogDropped(g_replay)));
+            }
+        }
         DeleteCriticalSection(&g_replayLock);
         return rc;
     }
 
-    // --- 4. Otherwise, start the pipe listener.
+    // --- 4. Otherwise, host the pipe listener until Ctrl-C. It runs on
+    // this thread, which holds the loaded g_replay.
     SetConsoleCtrlHandler(CtrlHandler, TRUE);
-    HANDLE hThread = CreateThread(nullptr, 0, ReplayPipeThreadProc, nullptr, 0, nullptr);
-    if (!hThread) {
-        LogErr("[Replay] Failed to create pipe listener thread: %lu\n", GetLastError());
-        DeleteCriticalSection(&g_replayLock);
-        return 4;
-    }
-
-    LogOut("[Replay] Listening on %s\n", REPLAY_PIPE_NAME);
+    LogOut("[Replay] Listening on %s\n", g_replayPipeName);
     LogOut("[Replay] Press Ctrl-C to exit\n");
 
-    // Block until Ctrl-C or thread exits on its own.
-    WaitForSingleObject(hThread, INFINITE);
-    CloseHandle(hThread);
+    // Announce the pipe in the instance registry (--list-instances). A
+    // server killed before it gets here is dropped by the next listing.
+    InstanceRecord rec;
+    rec.kind = "replay";
+    rec.pid = GetCurrentProcessId();
+    rec.tag = instanceTag;
+    rec.pipe = g_replayPipeName;
+    rec.started = static_cast<int64_t>(time(nullptr));
+    rec.source = snapPath;
+    const std::string recordPath = InstanceRegistryAdd(rec);
+    if (recordPath.empty()) LogErr("[Replay] Instance registry record not written\n");
+
+    ReplayPipeListen();
+    InstanceRegistryRemove(recordPath);
     DeleteCriticalSection(&g_replayLock);
 
     LogOut("[Replay] Bye\n");
     return 0;
 }
+#endif  // REPLAY_HARNESS_NO_MAIN
@@ -0,0 +1,190 @@
+#pragma once
+// replay_sim.h -- struct-of-arrays combat core for the replay model.
+//
+// ReplayMutApplyAreaSplash used to walk ReplayState::units entry by entry:
+// per victim a scan of every hardpoint's behavior list, a per-slot table
+// lookup for the damage multiplier, and a push into damage_event_log. A
+// balance sweep that splashes the same roster thousands of times paid all
+// of that again on every call. ReplaySim holds the combat columns densely
+// instead:
+//
+//   * One entry per unit, in obj_addr order (the units table's order), so
+//     kernels emit events in the order the map walk did.
+//   * hull / mult / x / y are float columns; `mult` is the effective
+//     incoming damage multiplier resolved once at load. Behaviors the
+//     damage path tests (INVULNERABLE on any hardpoint, a placed position)
+//     are bits in 64-unit words, so a kernel tests a unit with a shift.
+//   * Kernels select victims into a scratch index list, then apply damage
+//     to that list in a branch-free loop; events are appended to flat
+//     columns and only turned into DamageEventRecords when the caller
+//     stores the sim back (ReplaySimStore in replay_state.h).
+//
+// Load once, run any number of kernels, store once: hulls and the event
+// stream then match what the same calls on ReplayState would produce.
+//
+// Header-only and std-only so test_harness.cpp drives the real code.
+// Not thread-safe: one sim per caller.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define REPLAY_SIM_INVULN 0  // bit plane: INVULNERABLE on any hardpoint
+#define REPLAY_SIM_PLACED 1  // bit plane: has_pos
+#define REPLAY_SIM_PLANES 2
+
+struct ReplaySim {
+    std::vector<uint64_t> obj;
+    std::vector<int32_t>  owner;
+    std::vector<float>    hull;
+    std::vector<float>    mult;       // effective incoming damage multiplier
+    std::vector<float>    x, y;       // ground position; 0 when unplaced
+    std::vector<uint64_t> bits[REPLAY_SIM_PLANES];  // one bit per unit
+    // Damage events since load, in emission order.
+    std::vector<uint32_t> evUnit;
+    std::vector<float>    evRequested;
+    std::vector<float>    evCurrent;
+    std::vector<uint32_t> scratch;    // victim indices of the running kernel
+    std::vector<float>    scratchScale;  // their distance falloff, ranged kernels only
+};
+
+inline void ReplaySimResize(ReplaySim* sim, size_t n) {
+    sim->obj.assign(n, 0);
+    sim->owner.assign(n, -1);
+    sim->hull.assign(n, 0.0f);
+    sim->mult.assign(n, 1.0f);
+    sim->x.assign(n, 0.0f);
+    sim->y.assign(n, 0.0f);
+    for (auto& plane : sim->bits) plane.assign((n + 63) / 64, 0);
+    sim->evUnit.clear();
+    sim->evRequested.clear();
+    sim->evCurrent.clear();
+}
+
+inline size_t ReplaySimCount(const ReplaySim* sim) {
+    return sim->obj.size();
+}
+
+inline bool ReplaySimBit(const ReplaySim* sim, int plane, size_t i) {
+    return (sim->bits[plane][i >> 6] >> (i & 63)) & 1;
+}
+
+inline void ReplaySimSetBit(ReplaySim* sim, int plane, size_t i, bool on) {
+    const uint64_t m = 1ull << (i & 63);
+    if (on) sim->bits[plane][i >> 6] |= m;
+    else    sim->bits[plane][i >> 6] &= ~m;
+}
+
+// Index of obj (binary search over the obj_addr-ordered column), or -1.
+inline int64_t ReplaySimFind(const ReplaySim* sim, uint64_t obj) {
+    size_t lo = 0, hi = sim->obj.size();
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (sim->obj[mid] < obj) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < sim->obj.size() && sim->obj[lo] == obj ? (int64_t)lo : -1;
+}
+
+// Share of the splash a victim `dist` from the impact takes: 1 at the
+// centre, falling linearly to `edge` at `radius`.
+inline float ReplayAreaSplashScale(float dist, float radius, float edge) {
+    if (!(radius > 0.0f)) return 1.0f;
+    const float f = 1.0f - (1.0f - edge) * (dist / radius);
+    return f > 0.0f ? f : 0.0f;
+}
+
+// Applies `amount` (before multipliers; times scale[k] when scale is given)
+// to every unit in sim->scratch: invulnerable units keep their hull, the
+// rest lose amount * mult clamped to [0, hull]. Logs one event per victim.
+// Returns the units damaged.
+inline int ReplaySimDamageScratch(ReplaySim* sim, float amount, const float* scale = nullptr) {
+    const size_t n = sim->scratch.size();
+    const size_t base = sim->evUnit.size();
+    sim->evUnit.resize(base + n);
+    sim->evRequested.resize(base + n);
+    sim->evCurrent.resize(base + n);
+    const uint32_t* idx = sim->scratch.data();
+    const uint64_t* inv = sim->bits[REPLAY_SIM_INVULN].data();
+    float* hull = sim->hull.data();
+    const float* mult = sim->mult.data();
+    int damaged = 0;
+    for (size_t k = 0; k < n; k++) {
+        const uint32_t i = idx[k];
+        const float before = hull[i];
+        const float hit = scale ? amount * scale[k] : amount;
+        const int live = (int)(1 - ((inv[i >> 6] >> (i & 63)) & 1));
+        float scaled = hit * mult[i];
+        scaled = scaled < 0.0f ? 0.0f : scaled;
+        float after = before - scaled;
+        after = after < 0.0f ? 0.0f : after;
+        after = live ? after : before;
+        hull[i] = after;
+        sim->evUnit[base + k] = i;
+        sim->evRequested[base + k] = before - hit;
+        sim->evCurrent[base + k] = after;
+        damaged += live;
+    }
+    return damaged;
+}
+
+// Single-target kernel with ReplayMutApplyDamage's contract: a non-positive
+// amount logs an unchanged hull. Returns the post-hit hull, or -1 for i < 0.
+inline float ReplaySimDamage(ReplaySim* sim, int64_t i, float amount) {
+    if (i < 0) return -1.0f;
+    if (amount <= 0.0f) {
+        sim->evUnit.push_back((uint32_t)i);
+        sim->evRequested.push_back(sim->hull[(size_t)i]);
+        sim->evCurrent.push_back(sim->hull[(size_t)i]);
+        return sim->hull[(size_t)i];
+    }
+    sim->scratch.assign(1, (uint32_t)i);
+    ReplaySimDamageScratch(sim, amount);
+    return sim->hull[(size_t)i];
+}
+
+// Splash kernel: `amount` onto every unit other than `primary` (an index,
+// or -1). With `ranged`, only placed units whose (x, y) lies within
+// `radius` of (cx, cy), boundary included, are hit, scaled by
+// ReplayAreaSplashScale(distance, radius, edge) -- a negative or NaN radius
+// hits nobody. Returns the units damaged (invulnerable victims log an event
+// but are not counted).
+inline int ReplaySimSplash(ReplaySim* sim, int64_t primary, bool ranged, float cx, float cy, float radius,
+                           float edge, float amount) {
+    const size_t n = ReplaySimCount(sim);
+    sim->scratch.resize(n);
+    uint32_t* out = sim->scratch.data();
+    size_t hits = 0;
+    if (ranged) {
+        if (!(radius >= 0.0f)) {
+            sim->scratch.clear();
+            return 0;
+        }
+        const float r2 = radius * radius;
+        const uint64_t* placed = sim->bits[REPLAY_SIM_PLACED].data();
+        const float* xs = sim->x.data();
+        const float* ys = sim->y.data();
+        for (size_t i = 0; i < n; i++) {
+            const float dx = xs[i] - cx, dy = ys[i] - cy;
+            const bool in = ((placed[i >> 6] >> (i & 63)) & 1) && dx * dx + dy * dy <= r2
+                            && (int64_t)i != primary;
+            out[hits] = (uint32_t)i;
+            hits += in;
+        }
+        sim->scratch.resize(hits);
+        sim->scratchScale.resize(hits);
+        for (size_t k = 0; k < hits; k++) {
+            const float dx = xs[out[k]] - cx, dy = ys[out[k]] - cy;
+            sim->scratchScale[k] = ReplayAreaSplashScale(sqrtf(dx * dx + dy * dy), radius, edge);
+        }
+        return ReplaySimDamageScratch(sim, amount, sim->scratchScale.data());
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            out[hits] = (uint32_t)i;
+            hits += (int64_t)i != primary;
+        }
+    }
+    sim->scratch.resize(hits);
+    return ReplaySimDamageScratch(sim, amount);
+}
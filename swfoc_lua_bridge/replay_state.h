@@ -11,13 +11,26 @@
 // units can include it without changing the existing build commands.
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <limits>
+#include <memory>
+#include <memory_resource>
 #include <cstdint>
-#include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "csv_row.h"
+#include "damage_ring.h"
+#include "replay_flat.h"
+#include "replay_sim.h"
+#include "replay_symbols.h"
+#include "spatial_grid.h"
+
+#define REPLAY_EVENT_DRAIN_ROWS 400  // rows per drain, as SWFOC_EventStreamDrain's kDrainMaxRows
+
 // ----- Shared replay record types -----
 
 struct ReplayPlayer {
@@ -59,24 +72,66 @@ struct ReplayTaskForceRecord {
 // to 0 (engine does the ticking; replay fixtures pin snapshot values);
 // usable tracks whether the game lets the player activate it now (may
 // be false even at cooldown=0 if target conditions aren't met).
+//
+// ReplayAbility, ReplayHardpoint and ReplayUnitDetail keep their strings and
+// lists in std::pmr containers so a units table can hand every row its arena
+// (ReplayUnitTable below). The allocator-extended constructors are what the
+// pmr vectors call to build an element with the vector's own resource.
 struct ReplayAbility {
-    int32_t     index                  = 0;
-    std::string name;
-    int32_t     cooldown_remaining_ms  = 0;
-    bool        usable                 = true;
+    typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+    int32_t          index                  = 0;
+    std::pmr::string name;
+    int32_t          cooldown_remaining_ms  = 0;
+    bool             usable                 = true;
+
+    ReplayAbility() = default;
+    ReplayAbility(const ReplayAbility&) = default;
+    ReplayAbility(ReplayAbility&&) = default;
+    ReplayAbility& operator=(const ReplayAbility&) = default;
+    ReplayAbility& operator=(ReplayAbility&&) = default;
+    explicit ReplayAbility(const allocator_type& a) : name(a) {}
+    ReplayAbility(const ReplayAbility& o, const allocator_type& a)
+        : index(o.index), name(o.name, a), cooldown_remaining_ms(o.cooldown_remaining_ms), usable(o.usable) {}
+    ReplayAbility(ReplayAbility&& o, const allocator_type& a)
+        : index(o.index), name(std::move(o.name), a), cooldown_remaining_ms(o.cooldown_remaining_ms),
+          usable(o.usable) {}
+};
+
+// One production order (2026-10-14). ReplayMutTickBuildProgress advances
+// the head order of each slot's queue; elapsed_ms is build-speed-scaled
+// time, so it compares directly with queue_time_ms.
+struct ReplayBuildOrder {
+    int32_t     slot          = -1;
+    std::string type_name;
+    int32_t     queue_time_ms = 0;
+    double      elapsed_ms    = 0.0;
 };
 
 // Per-hardpoint record used to model the SWFOC engine's per-hardpoint
 // behavior-object chain. `Make_Invulnerable` in the real engine iterates
 // hardpoints and calls BehaviorAttach(hp, "INVULNERABLE", 0) per entry
 // (see ledger: fact_make_invulnerable_hardpoint_propagation). In the replay
-// harness we mirror that by storing an ordered behavior-name list per
-// hardpoint; damage simulation checks for "INVULNERABLE" to decide if the
-// hardpoint short-circuits hull decrement. Section 12 carries these in
-// fixtures captured with bridge v1.5-dev+b or later.
+// harness we mirror that by storing an ordered behavior list per hardpoint,
+// as interned names (replay_symbols.h); damage simulation checks for
+// "INVULNERABLE" to decide if the hardpoint short-circuits hull decrement.
+// Section 12 carries these in fixtures captured with bridge v1.5-dev+b or
+// later.
 struct ReplayHardpoint {
-    uint32_t                  index         = 0;    // hardpoint slot as returned by HardpointGet
-    std::vector<std::string>  behaviors;             // active behavior type names (e.g. "INVULNERABLE")
+    typedef std::pmr::polymorphic_allocator<ReplaySymbol> allocator_type;
+
+    uint32_t                        index = 0;  // hardpoint slot as returned by HardpointGet
+    std::pmr::vector<ReplaySymbol>  behaviors;  // active behavior type names (e.g. "INVULNERABLE")
+
+    ReplayHardpoint() = default;
+    ReplayHardpoint(const ReplayHardpoint&) = default;
+    ReplayHardpoint(ReplayHardpoint&&) = default;
+    ReplayHardpoint& operator=(const ReplayHardpoint&) = default;
+    ReplayHardpoint& operator=(ReplayHardpoint&&) = default;
+    explicit ReplayHardpoint(const allocator_type& a) : behaviors(a) {}
+    ReplayHardpoint(const ReplayHardpoint& o, const allocator_type& a) : index(o.index), behaviors(o.behaviors, a) {}
+    ReplayHardpoint(ReplayHardpoint&& o, const allocator_type& a)
+        : index(o.index), behaviors(std::move(o.behaviors), a) {}
 };
 
 // Per-unit record used by the replay harness to model a selected unit's
@@ -89,7 +144,7 @@ struct ReplayHardpoint {
 // carry these.
 struct ReplayUnitDetail {
     uint64_t                      obj_addr          = 0;
-    std::string                   type_name;                     // e.g. "Aggressor_Destroyer"
+    std::pmr::string              type_name;                     // e.g. "Aggressor_Destroyer"
     int32_t                       owner_slot        = -1;
     float                         hull              = 0.0f;
     float                         max_hull          = 0.0f;
@@ -110,7 +165,7 @@ struct ReplayUnitDetail {
     float                         speed             = 0.0f;
     float                         max_speed         = 0.0f;
     // Task 139/140 (2026-04-23). Per-unit ability catalogue.
-    std::vector<ReplayAbility> abilities;
+    std::pmr::vector<ReplayAbility> abilities;
     // Task 134 (2026-04-23). Hero flag. No IDA-pinned GameObject field
     // yet; the replay mirror flags heroes explicitly so Phase 1 of the
     // Hero Lab UI can filter. Phase 2 will correlate this with a live
@@ -129,7 +184,73 @@ struct ReplayUnitDetail {
     // disable. Default 100 is a neutral mid-range value so fixtures
     // without an explicit attack_power still round-trip cleanly.
     float                         attack_power      = 100.0f;
-    std::vector<ReplayHardpoint>  hardpoints;
+    // 2026-10-14. World position for the spatial grid (spatial_grid.h).
+    // Snapshots carry none yet -- the live bridge has no RE'd position
+    // field -- so only fixtures place units, via ReplayMutSetUnitPosition.
+    bool                          has_pos           = false;
+    float                         pos_x             = 0.0f;
+    float                         pos_y             = 0.0f;
+    float                         pos_z             = 0.0f;
+    std::pmr::vector<ReplayHardpoint> hardpoints;
+    // 2026-10-14. Hardpoints carrying INVULNERABLE, kept by the behavior
+    // mutators below so the damage paths test one field instead of every
+    // behavior list. Change `behaviors` only through those mutators.
+    uint32_t                      invuln_hardpoints = 0;
+
+    ReplayUnitDetail() = default;
+    // A row whose name and lists allocate from `r` (ReplayUnitTable's arena).
+    explicit ReplayUnitDetail(std::pmr::memory_resource* r) : type_name(r), abilities(r), hardpoints(r) {}
+};
+
+// 2026-10-14. The units table (sections 11-14). A 10000-unit section 12/13
+// used to cost a heap allocation per type name, hardpoint list and behavior
+// list on load and as many frees on unload; every row a table inserts now
+// allocates from the table's own monotonic arena, so a load is a handful
+// of block allocations and clear() / destruction hands them back at once.
+//
+//   * The arena only grows: space a row gives up (a detached behavior, an
+//     erased unit) comes back at the next clear().
+//   * A copied table (ReplayCow::mut on a forked state) starts a new arena
+//     and its copied rows live on the heap, so nothing points into another
+//     table's arena. Moving a row out of its table keeps it in the arena;
+//     do not let one outlive the table.
+//   * The arena base is declared first so it outlives the rows.
+struct ReplayUnitArena {
+    std::pmr::monotonic_buffer_resource arena{64 * 1024};
+};
+
+class ReplayUnitTable : private ReplayUnitArena, public ReplayFlatMap<uint64_t, ReplayUnitDetail> {
+public:
+    ReplayUnitTable() = default;
+    ReplayUnitTable(const ReplayUnitTable& o) : ReplayUnitArena(), ReplayFlatMap<uint64_t, ReplayUnitDetail>(o) {}
+    // Rows keep their own storage (ReplaySweepRearm reuses a worker's
+    // table), so the arena stays as it is.
+    ReplayUnitTable& operator=(const ReplayUnitTable& o) {
+        ReplayFlatMap<uint64_t, ReplayUnitDetail>::operator=(o);
+        return *this;
+    }
+
+    ReplayUnitDetail& operator[](uint64_t obj_addr) { return try_emplace(obj_addr, &arena); }
+
+    void clear() {
+        ReplayFlatMap<uint64_t, ReplayUnitDetail>::clear();
+        arena.release();
+    }
+};
+
+// Spatial grid over the placed units (spatial_grid.h), built on first use
+// after a position changes. A copied state starts with no grid and builds
+// its own, so copies never share one.
+struct ReplayUnitGrid {
+    std::unique_ptr<SpatialGrid> grid;
+    bool                         valid = false;
+
+    ReplayUnitGrid() = default;
+    ReplayUnitGrid(const ReplayUnitGrid&) {}
+    ReplayUnitGrid& operator=(const ReplayUnitGrid&) {
+        valid = false;
+        return *this;
+    }
 };
 
 struct ReplayState {
@@ -140,16 +261,19 @@ struct ReplayState {
 
     std::vector<ReplayPlayer>          players;
     std::vector<uint64_t>              lua_state_ptrs;
-    std::map<std::string, uint32_t>    objects;
-    std::map<std::string, ReplayGlobal> globals;
-    std::map<std::string, std::string> metadata;
+    // 2026-10-14. The snapshot-sized tables (these, sections 6-12 and the
+    // damage event log) are ReplayCow (replay_flat.h): a copy of the state
+    // shares them until one side writes. Write them through mut().
+    ReplayCow<ReplayFlatMap<std::string, uint32_t>>     objects;
+    ReplayCow<ReplayFlatMap<std::string, ReplayGlobal>> globals;
+    ReplayCow<ReplayFlatMap<std::string, std::string>>  metadata;
 
     // v2 section extensions (sections 6-10) -- all OPTIONAL.
-    std::map<std::string, ReplayPlanetInfo>                       planets;
-    std::map<std::pair<std::string, std::string>, std::string>    diplomacy;
-    std::map<std::string, std::vector<float>>                     cooldowns;
-    std::vector<ReplayTaskForceRecord>                            task_forces;
-    std::map<std::string, std::vector<int32_t>>                   object_owners;
+    ReplayCow<ReplayFlatMap<std::string, ReplayPlanetInfo>>         planets;
+    ReplayCow<ReplayFlatMap<uint64_t, std::string>>                 diplomacy;  // ReplayDiplomacyKey
+    ReplayCow<ReplayFlatMap<std::string, std::vector<float>>>       cooldowns;
+    ReplayCow<std::vector<ReplayTaskForceRecord>>                   task_forces;
+    ReplayCow<ReplayFlatMap<std::string, std::vector<int32_t>>>     object_owners;
 
     // v2 section extensions (sections 11-13) — unit detail for Tasks 99/100.
     //
@@ -164,8 +288,8 @@ struct ReplayState {
     // Section 12: `unit_detail`        per-unit hull/flags/hardpoints
     // Section 13: `behavior_attach`    per-hardpoint behavior name lists
     //                                  (merged into units[].hardpoints on load)
-    std::vector<uint64_t>                                         selected_units;
-    std::map<uint64_t, ReplayUnitDetail>                          units;
+    std::vector<uint64_t>                                            selected_units;
+    ReplayCow<ReplayUnitTable>                                       units;
 
     // Mutation seam state (not in any snapshot section).
     std::string last_story_event;
@@ -183,26 +307,26 @@ struct ReplayState {
     // setting slot=1 to 2.0 makes enemies take 2x damage, which is the
     // combat-demo expectation from the V2 UI.
     float                         global_damage_mult = 1.0f;
-    std::map<int32_t, float>      per_slot_damage_mult;
+    ReplaySlotTable<float>        per_slot_damage_mult;
 
     // Task 123 (2026-04-23) — income multiplier. Same shape as damage
     // mult but applied to per-tick credits delta in ReplayMutTickIncome.
     float                         global_income_mult = 1.0f;
-    std::map<int32_t, float>      per_slot_income_mult;
+    ReplaySlotTable<float>        per_slot_income_mult;
 
     // Task 124 (2026-04-23) — build-speed multiplier. Applied per-tick to
-    // production queues via ReplayMutTickBuildProgress (future helper) or
+    // production queues via ReplayMutTickBuildProgress or
     // read directly by the Inspector / Economy tabs. Same global +
     // per-slot shape.
     float                         global_build_speed_mult = 1.0f;
-    std::map<int32_t, float>      per_slot_build_speed_mult;
+    ReplaySlotTable<float>        per_slot_build_speed_mult;
 
     // Task 126 (2026-04-23) — per-faction move-speed multiplier.
     // Distinct from Task 125's per-UNIT speed: this scales every unit
     // owned by `slot` on the next tick without overwriting each unit's
     // individual speed. Global fallback supported.
     float                         global_faction_speed_mult = 1.0f;
-    std::map<int32_t, float>      per_faction_speed_mult;
+    ReplaySlotTable<float>        per_faction_speed_mult;
 
     // Task 127 (2026-04-23) — global game speed (simulation rate). Only
     // a global value; there is no per-slot game speed in the engine.
@@ -215,7 +339,7 @@ struct ReplayState {
     // every income tick restores credits to the frozen value. Absence of
     // the slot means "not frozen". Combines with income_mult so a frozen
     // slot ignores the mult entirely (frozen wins).
-    std::map<int32_t, double>     frozen_credits_targets;
+    ReplaySlotTable<double>       frozen_credits_targets;
 
     // Task 131 (2026-04-23) — weapon fire-rate multiplier. Shape mirrors
     // damage_mult (global + per-slot with clear-on-1.0). Applied by
@@ -223,7 +347,7 @@ struct ReplayState {
     // effective multiplier, so higher multiplier = faster fire. Default
     // 1.0 everywhere means "no scaling" and is the Phase 1 safe state.
     float                         global_fire_rate_mult = 1.0f;
-    std::map<int32_t, float>      per_slot_fire_rate_mult;
+    ReplaySlotTable<float>        per_slot_fire_rate_mult;
 
     // Task 132 (2026-04-23) — Area-damage toggle. When enabled, every
     // damage application also splashes a fraction of the amount onto
@@ -235,6 +359,12 @@ struct ReplayState {
     bool                          area_damage_enabled = false;
     float                         area_damage_radius  = 150.0f;    // synthetic tactical tiles
     float                         area_damage_falloff = 0.5f;      // splash = primary * falloff
+    // 2026-10-14. With a placed primary, splash falls off linearly with
+    // distance, from the full splash at the impact to splash * edge at
+    // area_damage_radius (ReplayAreaSplashScale).
+    float                         area_damage_edge    = 0.0f;
+    // Grid over the placed units; ReplayMutSetUnitPosition invalidates it.
+    mutable ReplayUnitGrid        unit_grid;
 
     // Task 161 (2026-04-23) — Instant-build toggle. When enabled, the
     // Phase 2 AOB patch NOPs the per-tick build-progress increment and
@@ -243,6 +373,16 @@ struct ReplayState {
     // Default false (normal build times).
     bool                          instant_build_enabled = false;
 
+    // 2026-10-14. Production queue, in submit order; each slot builds its
+    // first order only. Completed orders spawn their unit and are removed.
+    std::vector<ReplayBuildOrder> build_queue;
+    uint32_t                      builds_completed = 0;
+
+    // 2026-10-14. Fixed-step clock of the tick engine (replay_tick.h).
+    // Snapshots start at 0; only ReplayTickStep advances it.
+    uint64_t                      sim_tick    = 0;
+    uint64_t                      sim_time_ms = 0;
+
     // Task 162 (2026-04-23) — Free-build toggle. When enabled, the
     // Phase 2 AOB patch NOPs the credits-deduction instruction in the
     // build-submit path. Complement to #160 SetBuildCost(slot, 0.0): both
@@ -262,7 +402,7 @@ struct ReplayState {
     // in the engine's build-progress tick and scales by the effective
     // multiplier. Negative values rejected (no "refund" via negative).
     float                         global_build_cost_mult = 1.0f;
-    std::map<int32_t, float>      per_slot_build_cost_mult;
+    ReplaySlotTable<float>        per_slot_build_cost_mult;
 
     // Task 163 (2026-04-23) — per-slot unit-cap override. When a slot is
     // in the map, the live unit-cap check returns the override value
@@ -272,7 +412,7 @@ struct ReplayState {
     // reads the engine-default via separate query. Negative values
     // ≠ -1 are rejected (only -1 is a sentinel; other negatives would
     // confuse the live hook).
-    std::map<int32_t, int32_t>    per_slot_unit_cap_override;
+    ReplaySlotTable<int32_t>      per_slot_unit_cap_override;
 
     // Task 114 (2026-04-23) — per-slot AI freeze. When a slot is in the
     // set, the Phase 2 hook will bypass that slot's AI decision-loop tick
@@ -300,7 +440,7 @@ struct ReplayState {
     // 1 = orbital/space. The Phase 2 hook will pin the engine's
     // orbital-phase flag offset; until then the mirror keeps a per-slot
     // map so V2 UIs can toggle and read back the intended state.
-    std::map<int32_t, uint8_t>    per_slot_orbital_phase;
+    ReplaySlotTable<uint8_t>      per_slot_orbital_phase;
 
     // Task 173 (2026-04-24) — music subsystem state. The engine's music
     // system has separate volume + currently-playing-track surfaces;
@@ -314,7 +454,7 @@ struct ReplayState {
     // unknown until a veterancy field RE pass; Phase 1 stores rank
     // 0..3 in a per-obj_addr map so the Veterancy Manager VM can stage
     // edits today.
-    std::map<uint64_t, uint8_t>   per_unit_veterancy;
+    ReplayFlatMap<uint64_t, uint8_t> per_unit_veterancy;
 
     // Task 175 (2026-04-24) — map-hint sprite system. The engine's
     // hint-system pins minimap markers (objective dots, "go here"
@@ -342,7 +482,7 @@ struct ReplayState {
     // where a toggle is a one-shot action, not a reactive daemon.
     bool                          ohk_enabled = false;
     static constexpr float        kOhkInflatedAttackPower = 99999.0f;
-    std::map<uint64_t, float>     ohk_saved_attack_powers;
+    ReplayFlatMap<uint64_t, float> ohk_saved_attack_powers;
 
     // Task 133 (2026-04-23) — per-slot target filter bitmask. Bit 0 =
     // ENEMY, Bit 1 = FRIENDLY, Bit 2 = NEUTRAL. Default 0x7 (all). A
@@ -354,7 +494,7 @@ struct ReplayState {
     static constexpr uint32_t TARGET_FRIENDLY = 0x2;
     static constexpr uint32_t TARGET_NEUTRAL  = 0x4;
     static constexpr uint32_t TARGET_ALL      = TARGET_ENEMY | TARGET_FRIENDLY | TARGET_NEUTRAL;
-    std::map<int32_t, uint32_t>   per_slot_target_filter;
+    ReplaySlotTable<uint32_t>     per_slot_target_filter;
 
     // Task 112 (2026-04-23) — damage-event ring buffer (pure-state mirror
     // of the live g_eventRing in lua_bridge.cpp). Pushed by the replay
@@ -366,11 +506,95 @@ struct ReplayState {
         float    requested_hp = 0.0f;
         float    current_hp   = 0.0f;
     };
-    std::vector<DamageEventRecord> damage_event_log;
+    // 2026-10-14. Bounded like one live DamageThreadRing: at most `capacity`
+    // unread events (DAMAGE_RING_CAP_DEFAULT, rounded as
+    // DamageRingSetCapacity does); a full log drops the NEW event and
+    // counts it, and a new capacity is adopted the next time the log is
+    // empty. Storage grows to the capacity and then wraps, so a long battle
+    // holds at most capacity records. [k] is the k-th unread event, oldest
+    // first.
+    struct DamageEventLog {
+        std::vector<DamageEventRecord> buf;
+        uint32_t mask     = DAMAGE_RING_CAP_DEFAULT - 1;  // storage in use - 1
+        uint32_t capacity = DAMAGE_RING_CAP_DEFAULT;      // applied when next empty
+        uint32_t head     = 0;  // monotonic, like DamageThreadRing
+        uint32_t tail     = 0;
+        uint64_t dropped  = 0;
+
+        size_t size() const { return head - tail; }
+        bool   empty() const { return head == tail; }
+        const DamageEventRecord& operator[](size_t k) const { return buf[(tail + k) & mask]; }
+
+        bool push(const DamageEventRecord& ev) {
+            if (head == tail && mask + 1 != capacity) {
+                std::vector<DamageEventRecord>().swap(buf);
+                mask = capacity - 1;
+                head = tail = 0;
+            }
+            if (head - tail > mask) {
+                dropped++;
+                return false;
+            }
+            const uint32_t i = head & mask;
+            if (i == buf.size()) buf.push_back(ev);  // still growing: head < capacity
+            else buf[i] = ev;
+            head++;
+            return true;
+        }
+
+        void pop(size_t n) { tail += static_cast<uint32_t>(n < size() ? n : size()); }
+    };
+    ReplayCow<DamageEventLog> damage_event_log;
 
     int local_slot = -1;
 };
 
+// 2026-10-14. What-if branches (SWFOC_ReplayFork / SWFOC_ReplayRestore).
+// A fork is a copy of the state, so it shares every ReplayCow table with the
+// live state; the first write to a table on either side after the fork
+// copies that table alone. Forking and restoring cost the small by-value
+// fields plus one reference per shared table -- on a loaded snapshot, a
+// fraction of the deep copy or reload a script paid before. A fork stays
+// until dropped, so one fork can be restored any number of times.
+#define REPLAY_FORK_MAX 64
+
+struct ReplayForkTable {
+    std::vector<std::pair<uint32_t, ReplayState>> forks;  // (id, state), ids ascending
+    uint32_t                                      next_id = 1;
+};
+
+// Returns the new fork's id, or 0 when REPLAY_FORK_MAX forks are held.
+inline uint32_t ReplayFork(const ReplayState& s, ReplayForkTable* t) {
+    if (t->forks.size() >= REPLAY_FORK_MAX) return 0;
+    const uint32_t id = t->next_id++;
+    t->forks.emplace_back(id, s);
+    return id;
+}
+
+// Puts `s` back to fork `id`. Returns 0 for an unknown id.
+inline int ReplayRestore(ReplayState& s, const ReplayForkTable& t, uint32_t id) {
+    for (const auto& f : t.forks) {
+        if (f.first == id) {
+            s = f.second;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Drops fork `id`, or every fork for id 0. Returns the forks dropped.
+inline int ReplayDropFork(ReplayForkTable* t, uint32_t id) {
+    const size_t before = t->forks.size();
+    if (id == 0) {
+        t->forks.clear();
+    } else {
+        t->forks.erase(std::remove_if(t->forks.begin(), t->forks.end(),
+                                      [id](const std::pair<uint32_t, ReplayState>& f) { return f.first == id; }),
+                       t->forks.end());
+    }
+    return static_cast<int>(before - t->forks.size());
+}
+
 // ----- Shared helpers -----
 
 inline std::string ReplayUpper(const std::string& s) {
@@ -384,12 +608,21 @@ inline std::string ReplayUpper(const std::string& s) {
     return out;
 }
 
-inline std::pair<std::string, std::string>
-ReplayDiplomacyKey(const std::string& a, const std::string& b) {
-    std::string ua = ReplayUpper(a);
-    std::string ub = ReplayUpper(b);
-    if (ua <= ub) return {ua, ub};
-    return {ub, ua};
+// Order-free key of a faction pair: the two faction symbols, smaller
+// first. The string form interns both names, so use it to store; lookups
+// go through ReplayObsDiplomaticState, which never interns.
+inline uint64_t ReplayDiplomacyKey(ReplaySymbol a, ReplaySymbol b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+inline uint64_t ReplayDiplomacyKey(const std::string& a, const std::string& b) {
+    return ReplayDiplomacyKey(ReplayIntern(a), ReplayIntern(b));
+}
+
+inline ReplaySymbol ReplayInvulnerableSymbol() {
+    static const ReplaySymbol id = ReplayIntern("INVULNERABLE");
+    return id;
 }
 
 // ----- Pure-state observer implementations (no Lua dependency) -----
@@ -399,17 +632,15 @@ ReplayDiplomacyKey(const std::string& a, const std::string& b) {
 // without going through the fake Lua stack.
 
 inline double ReplayObsPlayerCredits(const ReplayState& s, const std::string& faction) {
-    std::string needle = ReplayUpper(faction);
     for (const auto& p : s.players) {
-        if (ReplayUpper(p.faction_name) == needle) return p.credits;
+        if (ReplaySameName(p.faction_name, faction)) return p.credits;
     }
     return -1.0;
 }
 
 inline double ReplayObsPlayerTechLevel(const ReplayState& s, const std::string& faction) {
-    std::string needle = ReplayUpper(faction);
     for (const auto& p : s.players) {
-        if (ReplayUpper(p.faction_name) == needle) return static_cast<double>(p.tech_level);
+        if (ReplaySameName(p.faction_name, faction)) return static_cast<double>(p.tech_level);
     }
     return -1.0;
 }
@@ -420,8 +651,10 @@ inline std::string ReplayObsLastStoryEvent(const ReplayState& s) {
 
 inline std::string
 ReplayObsDiplomaticState(const ReplayState& s, const std::string& a, const std::string& b) {
-    auto key = ReplayDiplomacyKey(a, b);
-    auto it = s.diplomacy.find(key);
+    const ReplaySymbol sa = ReplayFindSymbol(a);
+    const ReplaySymbol sb = ReplayFindSymbol(b);
+    if (!sa || !sb) return "hostile";  // a faction never named cannot have been set
+    auto it = s.diplomacy.find(ReplayDiplomacyKey(sa, sb));
     if (it == s.diplomacy.end()) return "hostile";
     return it->second;
 }
@@ -473,14 +706,14 @@ inline int ReplayMutPushStoryEvent(ReplayState& s, const std::string& event) {
 
 inline int
 ReplayMutSetDiplomacy(ReplayState& s, const std::string& a, const std::string& b, const std::string& state) {
-    s.diplomacy[ReplayDiplomacyKey(a, b)] = state;
+    s.diplomacy.mut()[ReplayDiplomacyKey(a, b)] = state;
     return 1;
 }
 
 inline int
 ReplayMutSetPlanetCorruption(ReplayState& s, const std::string& planet, double value) {
     std::string key = ReplayUpper(planet);
-    auto& info = s.planets[key];
+    auto& info = s.planets.mut()[key];
     if (info.name.empty()) info.name = planet;
     info.corruption = static_cast<float>(value);
     return 1;
@@ -490,24 +723,23 @@ inline int
 ReplayMutSpawnUnit(ReplayState& s, const std::string& faction, const std::string& type_name, int count) {
     if (count <= 0) return 0;
     int32_t owner_slot = -1;
-    std::string needle = ReplayUpper(faction);
     for (const auto& p : s.players) {
-        if (ReplayUpper(p.faction_name) == needle) {
+        if (ReplaySameName(p.faction_name, faction)) {
             owner_slot = static_cast<int32_t>(p.slot);
             break;
         }
     }
     std::string type_key = ReplayUpper(type_name);
-    auto& owners = s.object_owners[type_key];
+    auto& owners = s.object_owners.mut()[type_key];
     for (int i = 0; i < count; i++) owners.push_back(owner_slot);
-    s.objects[type_name] += static_cast<uint32_t>(count);
+    s.objects.mut()[type_name] += static_cast<uint32_t>(count);
     return 1;
 }
 
 inline int
 ReplayMutSetCooldown(ReplayState& s, const std::string& unit_type, int ability_idx, double value) {
     if (ability_idx < 0 || ability_idx > 256) return 0;
-    auto& slots = s.cooldowns[unit_type];
+    auto& slots = s.cooldowns.mut()[unit_type];
     if (static_cast<int>(slots.size()) <= ability_idx) {
         slots.resize(static_cast<size_t>(ability_idx) + 1, 0.0f);
     }
@@ -520,7 +752,7 @@ ReplayMutAddTaskForce(ReplayState& s, int slot, const std::string& name) {
     ReplayTaskForceRecord rec;
     rec.owner_slot = slot;
     rec.name = name;
-    s.task_forces.push_back(std::move(rec));
+    s.task_forces.mut().push_back(std::move(rec));
     return 1;
 }
 
@@ -554,32 +786,47 @@ inline int ReplayMutSwitchLocalPlayer(ReplayState& s, int slot) {
 // with no gameplay effect — the test surface must prove that writing
 // those bytes does NOT stop hull loss in the simulated damage tick.
 
-inline bool ReplayHardpointHasBehavior(const ReplayHardpoint& hp, const std::string& name) {
-    std::string needle = ReplayUpper(name);
-    for (const auto& b : hp.behaviors) {
-        if (ReplayUpper(b) == needle) return true;
-    }
-    return false;
+inline bool ReplayHardpointHasBehavior(const ReplayHardpoint& hp, ReplaySymbol behavior) {
+    return std::find(hp.behaviors.begin(), hp.behaviors.end(), behavior) != hp.behaviors.end();
 }
 
-inline bool ReplayUnitAnyHardpointHasBehavior(const ReplayUnitDetail& u, const std::string& name) {
+inline bool ReplayUnitAnyHardpointHasBehavior(const ReplayUnitDetail& u, ReplaySymbol behavior) {
     for (const auto& hp : u.hardpoints) {
-        if (ReplayHardpointHasBehavior(hp, name)) return true;
+        if (ReplayHardpointHasBehavior(hp, behavior)) return true;
     }
     return false;
 }
 
-inline bool ReplayUnitAllHardpointsHaveBehavior(const ReplayUnitDetail& u, const std::string& name) {
+inline bool ReplayUnitAllHardpointsHaveBehavior(const ReplayUnitDetail& u, ReplaySymbol behavior) {
     if (u.hardpoints.empty()) return false;
     for (const auto& hp : u.hardpoints) {
-        if (!ReplayHardpointHasBehavior(hp, name)) return false;
+        if (!ReplayHardpointHasBehavior(hp, behavior)) return false;
     }
     return true;
 }
 
+// String-facing forms for the Lua helpers. A name never interned is on no
+// hardpoint, and the lookup does not intern it.
+inline bool ReplayHardpointHasBehavior(const ReplayHardpoint& hp, const std::string& name) {
+    const ReplaySymbol id = ReplayFindSymbol(name);
+    return id && ReplayHardpointHasBehavior(hp, id);
+}
+
+inline bool ReplayUnitAnyHardpointHasBehavior(const ReplayUnitDetail& u, const std::string& name) {
+    const ReplaySymbol id = ReplayFindSymbol(name);
+    return id && ReplayUnitAnyHardpointHasBehavior(u, id);
+}
+
+inline bool ReplayUnitAllHardpointsHaveBehavior(const ReplayUnitDetail& u, const std::string& name) {
+    const ReplaySymbol id = ReplayFindSymbol(name);
+    return id && ReplayUnitAllHardpointsHaveBehavior(u, id);
+}
+
+// The mutable lookup detaches a forked units table (ReplayCow::mut), but
+// not for an obj_addr the table does not hold.
 inline ReplayUnitDetail* ReplayFindUnit(ReplayState& s, uint64_t obj_addr) {
-    auto it = s.units.find(obj_addr);
-    return it == s.units.end() ? nullptr : &it->second;
+    if (!s.units.count(obj_addr)) return nullptr;
+    return &s.units.mut().find(obj_addr)->second;
 }
 
 inline const ReplayUnitDetail* ReplayFindUnit(const ReplayState& s, uint64_t obj_addr) {
@@ -598,7 +845,7 @@ inline ReplayUnitDetail& ReplayMutMockUnit(
     float max_hull,
     uint32_t hardpoint_count
 ) {
-    auto& u = s.units[obj_addr];
+    auto& u = s.units.mut()[obj_addr];
     u.obj_addr = obj_addr;
     u.type_name = type_name;
     u.owner_slot = owner_slot;
@@ -606,12 +853,9 @@ inline ReplayUnitDetail& ReplayMutMockUnit(
     u.max_hull = max_hull;
     if (u.hardpoints.size() != hardpoint_count) {
         u.hardpoints.clear();
+        u.invuln_hardpoints = 0;
         u.hardpoints.reserve(hardpoint_count);
-        for (uint32_t i = 0; i < hardpoint_count; i++) {
-            ReplayHardpoint hp;
-            hp.index = i;
-            u.hardpoints.push_back(std::move(hp));
-        }
+        for (uint32_t i = 0; i < hardpoint_count; i++) u.hardpoints.emplace_back().index = i;
     }
     return u;
 }
@@ -621,8 +865,10 @@ inline int ReplayMutAttachBehavior(ReplayState& s, uint64_t obj_addr, int hp_ind
     if (!u) return 0;
     if (hp_index < 0 || hp_index >= static_cast<int>(u->hardpoints.size())) return 0;
     auto& hp = u->hardpoints[static_cast<size_t>(hp_index)];
-    if (!ReplayHardpointHasBehavior(hp, behavior)) {
-        hp.behaviors.push_back(behavior);
+    const ReplaySymbol id = ReplayIntern(behavior);
+    if (!ReplayHardpointHasBehavior(hp, id)) {
+        hp.behaviors.push_back(id);
+        if (id == ReplayInvulnerableSymbol()) u->invuln_hardpoints++;
     }
     return 1;
 }
@@ -632,15 +878,12 @@ inline int ReplayMutDetachBehavior(ReplayState& s, uint64_t obj_addr, int hp_ind
     if (!u) return 0;
     if (hp_index < 0 || hp_index >= static_cast<int>(u->hardpoints.size())) return 0;
     auto& hp = u->hardpoints[static_cast<size_t>(hp_index)];
-    std::string needle = ReplayUpper(behavior);
+    const ReplaySymbol id = ReplayFindSymbol(behavior);
     auto before = hp.behaviors.size();
-    hp.behaviors.erase(
-        std::remove_if(
-            hp.behaviors.begin(),
-            hp.behaviors.end(),
-            [&needle](const std::string& b) { return ReplayUpper(b) == needle; }),
-        hp.behaviors.end());
-    return hp.behaviors.size() != before ? 1 : 0;
+    hp.behaviors.erase(std::remove(hp.behaviors.begin(), hp.behaviors.end(), id), hp.behaviors.end());
+    if (hp.behaviors.size() == before) return 0;
+    if (id == ReplayInvulnerableSymbol()) u->invuln_hardpoints--;
+    return 1;
 }
 
 // Simulate the real engine's Make_Invulnerable Lua wrapper:
@@ -651,22 +894,18 @@ inline int ReplayMutDetachBehavior(ReplayState& s, uint64_t obj_addr, int hp_ind
 inline int ReplayMutMakeInvulnerable(ReplayState& s, uint64_t obj_addr, bool flag) {
     auto* u = ReplayFindUnit(s, obj_addr);
     if (!u) return 0;
-    static const std::string kBehavior = "INVULNERABLE";
+    const ReplaySymbol invulnerable = ReplayInvulnerableSymbol();
     for (auto& hp : u->hardpoints) {
         if (flag) {
-            if (!ReplayHardpointHasBehavior(hp, kBehavior)) {
-                hp.behaviors.push_back(kBehavior);
+            if (!ReplayHardpointHasBehavior(hp, invulnerable)) {
+                hp.behaviors.push_back(invulnerable);
             }
         } else {
-            std::string needle = ReplayUpper(kBehavior);
-            hp.behaviors.erase(
-                std::remove_if(
-                    hp.behaviors.begin(),
-                    hp.behaviors.end(),
-                    [&needle](const std::string& b) { return ReplayUpper(b) == needle; }),
-                hp.behaviors.end());
+            hp.behaviors.erase(std::remove(hp.behaviors.begin(), hp.behaviors.end(), invulnerable),
+                               hp.behaviors.end());
         }
     }
+    u->invuln_hardpoints = flag ? static_cast<uint32_t>(u->hardpoints.size()) : 0;
     return 1;
 }
 
@@ -716,38 +955,85 @@ inline void ReplayMutLogDamageEvent(
     ev.owner_slot   = owner_slot;
     ev.requested_hp = requested_hp;
     ev.current_hp   = current_hp;
-    s.damage_event_log.push_back(ev);
+    s.damage_event_log.mut().push(ev);
+}
+
+// Consumes up to `max_rows` queued events (oldest first) as CSV, leaving the
+// rest for the next call, as SWFOC_EventStreamDrain pages the live rings.
+// "count=N" counts the rows returned; ReplayObsEventLogCount tells what is
+// left.
+inline std::string ReplayObsEventStreamDrain(ReplayState& s, size_t max_rows = REPLAY_EVENT_DRAIN_ROWS) {
+    const size_t count = s.damage_event_log.size() < max_rows ? s.damage_event_log.size() : max_rows;
+    std::string out = CsvRowBuildString(CsvRowCapacity(32, count, CSV_EVENT_ROW_MAX), [&](CsvRow* r) {
+        CsvRowCount(r, static_cast<int64_t>(count));
+        for (size_t k = 0; k < count; k++) {
+            const auto& ev = s.damage_event_log[k];
+            CsvRowDamageEvent(r, ev.timestamp_ms, ev.obj_addr, ev.owner_slot, ev.requested_hp, ev.current_hp);
+        }
+    });
+    if (count) s.damage_event_log.mut().pop(count);
+    return out;
 }
 
-inline std::string ReplayObsEventStreamDrain(ReplayState& s) {
-    if (s.damage_event_log.empty()) return "count=0";
-    std::string out;
-    char header[32];
-    int hlen = std::snprintf(header, sizeof(header), "count=%zu", s.damage_event_log.size());
-    if (hlen > 0) out.append(header, static_cast<size_t>(hlen));
-    for (const auto& ev : s.damage_event_log) {
-        char row[192];
-        int n = std::snprintf(
-            row, sizeof(row),
-            "|%llu;%llu;%d;%.3f;%.3f",
-            static_cast<unsigned long long>(ev.timestamp_ms),
-            static_cast<unsigned long long>(ev.obj_addr),
-            static_cast<int>(ev.owner_slot),
-            ev.requested_hp,
-            ev.current_hp);
-        if (n > 0) out.append(row, static_cast<size_t>(n));
+// 2026-10-14. Binary drain for native consumers (--events-out): one
+// ReplayEventDrainHeader, then `count` DamageEvent records (damage_ring.h,
+// the live ring's layout) appended to *out. Consumes like
+// ReplayObsEventStreamDrain; returns the records written.
+struct ReplayEventDrainHeader {
+    uint32_t count;      // DamageEvent records that follow
+    uint32_t remaining;  // still queued after this page
+    uint64_t dropped;    // refused by a full log since the state was made
+};
+
+inline size_t ReplayObsEventStreamDrainBinary(ReplayState& s, std::vector<uint8_t>* out,
+                                              size_t max_rows = REPLAY_EVENT_DRAIN_ROWS) {
+    const size_t count = s.damage_event_log.size() < max_rows ? s.damage_event_log.size() : max_rows;
+    ReplayEventDrainHeader hdr;
+    hdr.count = static_cast<uint32_t>(count);
+    hdr.remaining = static_cast<uint32_t>(s.damage_event_log.size() - count);
+    hdr.dropped = s.damage_event_log.get().dropped;
+    const size_t base = out->size();
+    out->resize(base + sizeof(hdr) + count * sizeof(DamageEvent));
+    uint8_t* p = out->data() + base;
+    std::memcpy(p, &hdr, sizeof(hdr));
+    p += sizeof(hdr);
+    for (size_t k = 0; k < count; k++) {
+        const auto& r = s.damage_event_log[k];
+        DamageEvent ev;
+        std::memset(&ev, 0, sizeof(ev));  // padding too: the bytes are compared
+        ev.timestamp_ms = r.timestamp_ms;
+        ev.obj_addr     = r.obj_addr;
+        ev.owner_slot   = r.owner_slot;
+        ev.requested_hp = r.requested_hp;
+        ev.current_hp   = r.current_hp;
+        std::memcpy(p, &ev, sizeof(ev));
+        p += sizeof(ev);
     }
-    s.damage_event_log.clear();
-    return out;
+    if (count) s.damage_event_log.mut().pop(count);
+    return count;
 }
 
 inline int ReplayObsEventLogCount(const ReplayState& s) {
     return static_cast<int>(s.damage_event_log.size());
 }
 
+inline uint64_t ReplayObsEventLogDropped(const ReplayState& s) {
+    return s.damage_event_log.get().dropped;
+}
+
+// Sets the log capacity (rounded as DamageRingSetCapacity rounds; adopted
+// when the log is next empty). Returns the previous capacity.
+inline uint32_t ReplayMutSetEventLogCapacity(ReplayState& s, uint32_t n) {
+    const uint32_t previous = s.damage_event_log.get().capacity;
+    const uint32_t cap = DamageRingRoundCapacity(n);
+    if (cap != previous) s.damage_event_log.mut().capacity = cap;
+    return previous;
+}
+
 // Task 129 (2026-04-23) — per-slot and global damage multiplier mutation +
-// observers. A negative slot selects the global value; any non-negative
-// slot stores (or clears when mult == 1.0) the per-slot override.
+// observers. A negative slot selects the global value; a slot in
+// [0, REPLAY_SLOTS) stores (or clears when mult == 1.0) the per-slot
+// override. Larger slots are rejected, as by every per-slot mutation below.
 // Declared BEFORE ReplayMutApplyDamage so damage application can call
 // ReplayObsGetDamageMultiplier without a forward declaration.
 inline int ReplayMutSetDamageMultiplier(ReplayState& s, int32_t slot, float mult) {
@@ -756,6 +1042,7 @@ inline int ReplayMutSetDamageMultiplier(ReplayState& s, int32_t slot, float mult
         s.global_damage_mult = mult;
         return 1;
     }
+    if (slot >= REPLAY_SLOTS) return 0;
     if (mult == 1.0f) {
         s.per_slot_damage_mult.erase(slot);
     } else {
@@ -792,7 +1079,7 @@ inline float ReplayMutApplyDamage(ReplayState& s, uint64_t obj_addr, float amoun
         ReplayMutLogDamageEvent(s, obj_addr, u->owner_slot, before, before);
         return before;
     }
-    if (ReplayUnitAnyHardpointHasBehavior(*u, "INVULNERABLE")) {
+    if (u->invuln_hardpoints) {
         ReplayMutLogDamageEvent(s, obj_addr, u->owner_slot, before - amount, before);
         return before;
     }
@@ -845,30 +1132,23 @@ inline size_t ReplayObsSelectedCount(const ReplayState& s) {
 // deliberately collapses the two so a future UI gets a consistent shape.
 inline std::string ReplayObsListAllPlayers(const ReplayState& s) {
     if (s.players.empty()) return "count=0";
-    std::string out;
-    char header[32];
-    int hlen = std::snprintf(header, sizeof(header), "count=%zu", s.players.size());
-    if (hlen > 0) out.append(header, static_cast<size_t>(hlen));
-    for (const auto& p : s.players) {
-        int is_local = (static_cast<int32_t>(p.slot) == s.local_slot) ? 1 : 0;
-        int unit_count = 0;
-        for (const auto& u : s.units) {
-            if (u.second.owner_slot == static_cast<int32_t>(p.slot)) unit_count++;
+    size_t estimate = CsvRowCapacity(32, s.players.size(), CSV_PLAYER_ROW_MAX);
+    for (const auto& p : s.players) estimate += p.faction_name.size();
+    return CsvRowBuildString(estimate, [&](CsvRow* r) {
+        CsvRowCount(r, static_cast<int64_t>(s.players.size()));
+        for (const auto& p : s.players) {
+            int is_local = (static_cast<int32_t>(p.slot) == s.local_slot) ? 1 : 0;
+            int unit_count = 0;
+            for (const auto& u : s.units) {
+                if (u.second.owner_slot == static_cast<int32_t>(p.slot)) unit_count++;
+            }
+            CsvRowPlayer(r, p.slot, p.faction_name.empty() ? "UNKNOWN" : p.faction_name.c_str(),
+                         p.credits, p.tech_level,
+                         is_local,  // is_human (harness collapses)
+                         is_local,  // is_local
+                         unit_count);
         }
-        char row[256];
-        int n = std::snprintf(
-            row, sizeof(row),
-            "|%u;%s;%.3f;%d;%d;%d;%d",
-            static_cast<unsigned>(p.slot),
-            p.faction_name.empty() ? "UNKNOWN" : p.faction_name.c_str(),
-            p.credits,
-            p.tech_level,
-            is_local,  // is_human (harness collapses)
-            is_local,  // is_local
-            unit_count);
-        if (n > 0) out.append(row, static_cast<size_t>(n));
-    }
-    return out;
+    });
 }
 
 // Task 113 (2026-04-23). Pure-state mutation for fog-of-war reveal. The
@@ -906,7 +1186,7 @@ inline int ReplayObsRevealedCount(const ReplayState& s) {
 inline int ReplayMutSweepGodMode(ReplayState& s, bool enable) {
     if (s.local_slot < 0) return 0;
     int flipped = 0;
-    for (auto& entry : s.units) {
+    for (auto& entry : s.units.mut()) {
         ReplayUnitDetail& u = entry.second;
         if (u.owner_slot != s.local_slot) continue;
         if (ReplayMutMakeInvulnerable(s, u.obj_addr, enable)) flipped++;
@@ -925,7 +1205,7 @@ inline int ReplayObsGodModeFullyActive(const ReplayState& s) {
         if (u.owner_slot != s.local_slot) continue;
         local_count++;
         if (u.hardpoints.empty()) return 0;
-        if (!ReplayUnitAllHardpointsHaveBehavior(u, "INVULNERABLE")) return 0;
+        if (!ReplayUnitAllHardpointsHaveBehavior(u, ReplayInvulnerableSymbol())) return 0;
     }
     return local_count > 0 ? 1 : 0;
 }
@@ -993,28 +1273,28 @@ inline std::string ReplayObsListHeroes(const ReplayState& s) {
         if (entry.second.is_hero) count++;
     }
     if (count == 0) return "count=0";
-    std::string out;
-    char header[32];
-    int hlen = std::snprintf(header, sizeof(header), "count=%d", count);
-    if (hlen > 0) out.append(header, static_cast<size_t>(hlen));
-    for (const auto& entry : s.units) {
-        const ReplayUnitDetail& u = entry.second;
-        if (!u.is_hero) continue;
-        bool alive = u.hull > 0.0f;
-        char row[192];
-        int n = std::snprintf(
-            row, sizeof(row),
-            "|%llu;%d;%.3f;%.3f;%d;%d;%d",
-            static_cast<unsigned long long>(u.obj_addr),
-            static_cast<int>(u.owner_slot),
-            static_cast<double>(u.hull),
-            static_cast<double>(u.max_hull),
-            static_cast<int>(u.respawn_remaining_ms),
-            alive ? 1 : 0,
-            u.respawn_enabled ? 1 : 0);
-        if (n > 0) out.append(row, static_cast<size_t>(n));
-    }
-    return out;
+    // "|%llu;%d;%.3f;%.3f;%d;%d;%d"
+    const size_t rowMax = 1 + CSV_U64_MAX + 2 * (1 + CSV_FLOAT_FIXED_MAX) + 4 * (1 + CSV_I64_MAX);
+    return CsvRowBuildString(CsvRowCapacity(32, static_cast<size_t>(count), rowMax), [&](CsvRow* r) {
+        CsvRowCount(r, count);
+        for (const auto& entry : s.units) {
+            const ReplayUnitDetail& u = entry.second;
+            if (!u.is_hero) continue;
+            bool alive = u.hull > 0.0f;
+            CsvRowChar(r, '|');
+            CsvRowU64(r, u.obj_addr);
+            CsvRowChar(r, ';');
+            CsvRowI64(r, u.owner_slot);
+            CsvRowChar(r, ';');
+            CsvRowFixed(r, u.hull, 3);
+            CsvRowChar(r, ';');
+            CsvRowFixed(r, u.max_hull, 3);
+            CsvRowChar(r, ';');
+            CsvRowI64(r, u.respawn_remaining_ms);
+            CsvRowStr(r, alive ? ";1;" : ";0;");
+            CsvRowChar(r, u.respawn_enabled ? '1' : '0');
+        }
+    });
 }
 
 // Task 135 (2026-04-23) — respawn-timer set/get for heroes. The replay
@@ -1053,6 +1333,25 @@ inline int ReplayObsIsPermadeath(const ReplayState& s, uint64_t obj_addr) {
     return u->respawn_enabled ? 0 : 1;
 }
 
+// 2026-10-14. Advances every dead hero's respawn timer by delta_ms. A hero
+// whose timer runs out comes back at max_hull, unless permadeath was set
+// meanwhile; a dead hero with no timer running stays down. Returns the
+// heroes revived.
+inline int ReplayMutTickRespawn(ReplayState& s, int32_t delta_ms) {
+    int revived = 0;
+    for (auto& entry : s.units.mut()) {
+        ReplayUnitDetail& u = entry.second;
+        if (!u.is_hero || u.hull > 0.0f || u.respawn_remaining_ms <= 0) continue;
+        u.respawn_remaining_ms -= delta_ms;
+        if (u.respawn_remaining_ms > 0) continue;
+        u.respawn_remaining_ms = 0;
+        if (!u.respawn_enabled) continue;
+        u.hull = u.max_hull;
+        revived++;
+    }
+    return revived;
+}
+
 // Task 125 (2026-04-23) — locomotor speed set/get. Mirrors the shield
 // pair in shape: clamp-to-max, floor-at-0, lowering max snaps current
 // down. Kept as its own primitive (separate from SetUnitField-style
@@ -1165,6 +1464,23 @@ inline int ReplayMutTriggerAbility(
     return 0;
 }
 
+// Counts every cooling ability of `u` down by delta_ms. Returns the
+// abilities that came off cooldown.
+inline int ReplayTickUnitAbilities(ReplayUnitDetail& u, int32_t delta_ms) {
+    int ready = 0;
+    for (auto& a : u.abilities) {
+        if (a.cooldown_remaining_ms > 0) {
+            a.cooldown_remaining_ms -= delta_ms;
+            if (a.cooldown_remaining_ms < 0) a.cooldown_remaining_ms = 0;
+            if (a.cooldown_remaining_ms == 0) {
+                a.usable = true;
+                ready++;
+            }
+        }
+    }
+    return ready;
+}
+
 inline int ReplayMutTickAbilityCooldown(
     ReplayState& s,
     uint64_t obj_addr,
@@ -1172,13 +1488,7 @@ inline int ReplayMutTickAbilityCooldown(
 ) {
     auto* u = ReplayFindUnit(s, obj_addr);
     if (!u) return 0;
-    for (auto& a : u->abilities) {
-        if (a.cooldown_remaining_ms > 0) {
-            a.cooldown_remaining_ms -= delta_ms;
-            if (a.cooldown_remaining_ms < 0) a.cooldown_remaining_ms = 0;
-            if (a.cooldown_remaining_ms == 0) a.usable = true;
-        }
-    }
+    ReplayTickUnitAbilities(*u, delta_ms);
     return 1;
 }
 
@@ -1230,9 +1540,8 @@ inline std::string ReplayObsListPlanets(const ReplayState& s) {
 inline int ReplayMutChangePlanetOwner(ReplayState& s, const std::string& planet_name, int32_t new_slot) {
     if (new_slot < 0) return 0;
     std::string key = ReplayUpper(planet_name);
-    auto it = s.planets.find(key);
-    if (it == s.planets.end()) return 0;
-    it->second.owner_slot = new_slot;
+    if (!s.planets.count(key)) return 0;
+    s.planets.mut().find(key)->second.owner_slot = new_slot;
     return 1;
 }
 
@@ -1250,24 +1559,24 @@ inline int32_t ReplayObsGetPlanetOwner(const ReplayState& s, const std::string&
 // on unknown planet so case-insensitive keying stays consistent with
 // ReplayMutChangePlanetOwner.
 inline int ReplayMutSetPlanetTech(ReplayState& s, const std::string& planet_name, int32_t tech) {
-    auto it = s.planets.find(ReplayUpper(planet_name));
-    if (it == s.planets.end()) return 0;
-    it->second.tech_level = tech;
+    const std::string key = ReplayUpper(planet_name);
+    if (!s.planets.count(key)) return 0;
+    s.planets.mut().find(key)->second.tech_level = tech;
     return 1;
 }
 
 inline int ReplayMutSetPlanetBuildings(ReplayState& s, const std::string& planet_name, int32_t count) {
     if (count < 0) return 0;
-    auto it = s.planets.find(ReplayUpper(planet_name));
-    if (it == s.planets.end()) return 0;
-    it->second.building_count = count;
+    const std::string key = ReplayUpper(planet_name);
+    if (!s.planets.count(key)) return 0;
+    s.planets.mut().find(key)->second.building_count = count;
     return 1;
 }
 
 inline int ReplayMutSetPlanetCapital(ReplayState& s, const std::string& planet_name, bool is_capital) {
-    auto it = s.planets.find(ReplayUpper(planet_name));
-    if (it == s.planets.end()) return 0;
-    it->second.is_capital = is_capital;
+    const std::string key = ReplayUpper(planet_name);
+    if (!s.planets.count(key)) return 0;
+    s.planets.mut().find(key)->second.is_capital = is_capital;
     return 1;
 }
 
@@ -1475,6 +1784,7 @@ inline int ReplayMutSetIncomeMultiplier(ReplayState& s, int32_t slot, float mult
         s.global_income_mult = mult;
         return 1;
     }
+    if (slot >= REPLAY_SLOTS) return 0;
     if (mult == 1.0f) s.per_slot_income_mult.erase(slot);
     else              s.per_slot_income_mult[slot] = mult;
     return 1;
@@ -1495,6 +1805,7 @@ inline int ReplayMutSetBuildSpeed(ReplayState& s, int32_t slot, float mult) {
         s.global_build_speed_mult = mult;
         return 1;
     }
+    if (slot >= REPLAY_SLOTS) return 0;
     if (mult == 1.0f) s.per_slot_build_speed_mult.erase(slot);
     else              s.per_slot_build_speed_mult[slot] = mult;
     return 1;
@@ -1518,6 +1829,7 @@ inline int ReplayMutSetFactionSpeedMult(ReplayState& s, int32_t slot, float mult
         s.global_faction_speed_mult = mult;
         return 1;
     }
+    if (slot >= REPLAY_SLOTS) return 0;
     if (mult == 1.0f) s.per_faction_speed_mult.erase(slot);
     else              s.per_faction_speed_mult[slot] = mult;
     return 1;
@@ -1547,7 +1859,7 @@ inline float ReplayObsGetGameSpeed(const ReplayState& s) {
 // the frozen target; passing `false` for `enable` removes the freeze and
 // discards the stored target.
 inline int ReplayMutSetFreezeCredits(ReplayState& s, int32_t slot, bool enable, double target) {
-    if (slot < 0) return 0;
+    if (slot < 0 || slot >= REPLAY_SLOTS) return 0;
     if (enable) {
         if (target < 0.0) return 0;
         s.frozen_credits_targets[slot] = target;
@@ -1568,31 +1880,56 @@ inline double ReplayObsGetFreezeCreditsTarget(const ReplayState& s, int32_t slot
     return (it == s.frozen_credits_targets.end()) ? -1.0 : it->second;
 }
 
+// 2026-10-14. One income tick resolved per slot up front: rate[k] is the
+// credits a player in slot k gains per tick (base * income multiplier *
+// game speed, the product ReplayMutTickIncome always used), frozen[k] /
+// target[k] the freeze. Index REPLAY_SLOTS stands for every slot past the
+// per-slot tables (global multiplier, never frozen). ReplayTickRun builds a
+// plan once per run -- nothing a tick does changes these settings -- so
+// the per-player loop is a select and an add with no table lookups.
+struct ReplayIncomePlan {
+    double  rate[REPLAY_SLOTS + 1];
+    double  target[REPLAY_SLOTS + 1];
+    uint8_t frozen[REPLAY_SLOTS + 1];
+    uint8_t touches[REPLAY_SLOTS + 1];  // frozen, or a non-zero rate
+};
+
+inline void ReplayIncomePlanBuild(const ReplayState& s, double base_income_per_tick, ReplayIncomePlan* plan) {
+    for (int32_t k = 0; k <= REPLAY_SLOTS; k++) {
+        const float mult = ReplayObsGetIncomeMultiplier(s, k);  // slot REPLAY_SLOTS: the global
+        plan->rate[k] = base_income_per_tick
+                      * static_cast<double>(mult)
+                      * static_cast<double>(s.global_game_speed);
+        const auto* frozen = s.frozen_credits_targets.find(k);
+        plan->frozen[k] = frozen ? 1 : 0;
+        plan->target[k] = frozen ? frozen->second : 0.0;
+        plan->touches[k] = static_cast<uint8_t>(frozen || plan->rate[k] != 0.0);
+    }
+}
+
+// Applies one tick of `plan` to every player. Returns the players touched.
+inline int ReplayIncomePlanApply(ReplayState& s, const ReplayIncomePlan& plan) {
+    int touched = 0;
+    ReplayPlayer* p = s.players.data();
+    const size_t n = s.players.size();
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t k = p[i].slot < REPLAY_SLOTS ? p[i].slot : REPLAY_SLOTS;
+        const double grown = p[i].credits + plan.rate[k];
+        p[i].credits = plan.frozen[k] ? plan.target[k] : grown;
+        touched += plan.touches[k];
+    }
+    return touched;
+}
+
 // Apply one simulated income tick: for each player, add
 // base_income_per_tick * effective_income_multiplier(slot) * game_speed
 // to the player's credits, UNLESS that slot is frozen (in which case
 // credits snap back to the frozen target). Returns the number of
 // players whose credits were touched.
 inline int ReplayMutTickIncome(ReplayState& s, double base_income_per_tick) {
-    int touched = 0;
-    for (auto& p : s.players) {
-        int32_t slot = static_cast<int32_t>(p.slot);
-        auto frozen_it = s.frozen_credits_targets.find(slot);
-        if (frozen_it != s.frozen_credits_targets.end()) {
-            p.credits = frozen_it->second;
-            touched++;
-            continue;
-        }
-        float mult = ReplayObsGetIncomeMultiplier(s, slot);
-        double delta = base_income_per_tick
-                     * static_cast<double>(mult)
-                     * static_cast<double>(s.global_game_speed);
-        if (delta != 0.0) {
-            p.credits += delta;
-            touched++;
-        }
-    }
-    return touched;
+    ReplayIncomePlan plan;
+    ReplayIncomePlanBuild(s, base_income_per_tick, &plan);
+    return ReplayIncomePlanApply(s, plan);
 }
 
 // Task 131 (2026-04-23) — weapon fire-rate multiplier. Same shape as
@@ -1609,6 +1946,7 @@ inline int ReplayMutSetFireRate(ReplayState& s, int32_t slot, float mult) {
         s.global_fire_rate_mult = mult;
         return 1;
     }
+    if (slot >= REPLAY_SLOTS) return 0;
     if (mult == 1.0f) {
         s.per_slot_fire_rate_mult.erase(slot);
     } else {
@@ -1637,8 +1975,9 @@ inline float ReplayMutApplyFireRate(const ReplayState& s, int32_t slot, float ba
 
 // Task 132 (2026-04-23) — area-damage toggle. Global bool with a
 // configurable falloff factor (splash_amount = primary_amount * falloff).
-// radius is carried for Phase 2 when position data lands in the replay
-// state; Phase 1 treats every OTHER unit on the map as in-range.
+// When the primary unit has a position, splash reaches the positioned
+// units within area_damage_radius of it (the spatial grid below);
+// otherwise every OTHER unit on the map is in range, as in Phase 1.
 inline int ReplayMutSetAreaDamageEnabled(ReplayState& s, bool enabled) {
     s.area_damage_enabled = enabled;
     return 1;
@@ -1648,37 +1987,190 @@ inline bool ReplayObsIsAreaDamageEnabled(const ReplayState& s) {
     return s.area_damage_enabled;
 }
 
-// Splash the primary damage amount onto every OTHER unit on the map.
-// Honours hardpoint invulnerability (same INVULNERABLE shortcut as
+// Splash reach and strength: radius >= 0 (world units), falloff >= 0
+// (splash = primary * falloff at the impact) and edge in [0, 1] (share of
+// that splash left at the radius). Returns 0 and changes nothing when any
+// is out of range.
+inline int ReplayMutSetAreaDamageShape(ReplayState& s, float radius, float falloff, float edge) {
+    if (!(radius >= 0.0f) || !(falloff >= 0.0f) || !(edge >= 0.0f && edge <= 1.0f)) return 0;
+    s.area_damage_radius  = radius;
+    s.area_damage_falloff = falloff;
+    s.area_damage_edge    = edge;
+    return 1;
+}
+
+// Places a unit for the spatial queries. Returns 0 for an unknown unit.
+inline int ReplayMutSetUnitPosition(ReplayState& s, uint64_t obj_addr, float x, float y, float z) {
+    ReplayUnitDetail* u = ReplayFindUnit(s, obj_addr);
+    if (!u) return 0;
+    u->has_pos = true;
+    u->pos_x = x;
+    u->pos_y = y;
+    u->pos_z = z;
+    s.unit_grid.valid = false;
+    return 1;
+}
+
+// The grid over every placed unit, rebuilt when a position changed since
+// the last call. nullptr when more units are placed than the grid holds.
+inline const SpatialGrid* ReplayObsUnitGrid(const ReplayState& s) {
+    ReplayUnitGrid& cache = s.unit_grid;
+    if (!cache.valid) {
+        std::vector<uint64_t> objs;
+        std::vector<int32_t>  owner;
+        std::vector<float>    xs, ys;
+        for (const auto& entry : s.units) {
+            const ReplayUnitDetail& u = entry.second;
+            if (!u.has_pos) continue;
+            objs.push_back(entry.first);
+            owner.push_back(u.owner_slot);
+            xs.push_back(u.pos_x);
+            ys.push_back(u.pos_y);
+        }
+        if (objs.size() > SPATIAL_GRID_MAX) {
+            cache.grid.reset();
+        } else {
+            if (!cache.grid) cache.grid.reset(new SpatialGrid());
+            cache.grid->count = 0;  // re-sort: entries index the new walk
+            SpatialGridUpdate(cache.grid.get(), objs.data(), owner.data(), xs.data(), ys.data(),
+                              (int)objs.size());
+        }
+        cache.valid = true;
+    }
+    return cache.grid.get();
+}
+
+// Units whose ground (x, y) position is within `radius` of (x, y), in
+// obj_addr order, via the same grid the live bridge queries (kept across
+// calls, see ReplayObsUnitGrid). Unpositioned units never match. More
+// positioned units than the grid holds fall back to a linear scan. Returns
+// the match count.
+inline int ReplayObsUnitsInRadius(const ReplayState& s, float x, float y, float radius,
+                                  std::vector<uint64_t>* out) {
+    out->clear();
+    const SpatialGrid* g = ReplayObsUnitGrid(s);
+    if (!g) {
+        for (const auto& entry : s.units) {
+            const ReplayUnitDetail& u = entry.second;
+            const float dx = u.pos_x - x, dy = u.pos_y - y;
+            if (u.has_pos && radius >= 0.0f && dx * dx + dy * dy <= radius * radius) out->push_back(entry.first);
+        }
+        return (int)out->size();
+    }
+    std::vector<uint16_t> hits(g->count);
+    const int n = SpatialGridQueryRadius(g, x, y, radius, hits.data(), (int)hits.size());
+    for (int k = 0; k < n; k++) out->push_back(g->obj[hits[k]]);
+    std::sort(out->begin(), out->end());
+    return n;
+}
+
+// Loads the combat columns of every unit into `sim` (replay_sim.h), in
+// obj_addr order, with each unit's invulnerability and damage multiplier
+// resolved once.
+inline void ReplaySimLoad(const ReplayState& s, ReplaySim* sim) {
+    ReplaySimResize(sim, s.units.size());
+    float slotMult[REPLAY_SLOTS];
+    for (int32_t slot = 0; slot < REPLAY_SLOTS; slot++) slotMult[slot] = ReplayObsGetDamageMultiplier(s, slot);
+    size_t i = 0;
+    for (const auto& entry : s.units) {
+        const ReplayUnitDetail& u = entry.second;
+        sim->obj[i] = entry.first;
+        sim->owner[i] = u.owner_slot;
+        sim->hull[i] = u.hull;
+        sim->mult[i] = u.owner_slot >= 0 && u.owner_slot < REPLAY_SLOTS ? slotMult[u.owner_slot]
+                                                                         : s.global_damage_mult;
+        if (u.has_pos) {
+            sim->x[i] = u.pos_x;
+            sim->y[i] = u.pos_y;
+            ReplaySimSetBit(sim, REPLAY_SIM_PLACED, i, true);
+        }
+        if (u.invuln_hardpoints) ReplaySimSetBit(sim, REPLAY_SIM_INVULN, i, true);
+        i++;
+    }
+}
+
+// Writes the sim's hulls back and appends its events to damage_event_log,
+// then clears them so the sim can keep running. Units removed since the
+// load are skipped.
+inline void ReplaySimStore(ReplaySim* sim, ReplayState& s) {
+    const size_t n = ReplaySimCount(sim);
+    auto& units = s.units.mut();
+    const bool aligned = units.size() == n;
+    auto it = units.begin();
+    for (size_t i = 0; i < n; i++) {
+        // Same table as at load: walk it in step instead of searching.
+        ReplayUnitDetail* u = aligned && it->first == sim->obj[i] ? &it->second : ReplayFindUnit(s, sim->obj[i]);
+        if (aligned) ++it;
+        if (u) u->hull = sim->hull[i];
+    }
+    if (!sim->evUnit.empty()) {
+        auto& log = s.damage_event_log.mut();
+        ReplayState::DamageEventRecord ev;
+        for (size_t k = 0; k < sim->evUnit.size(); k++) {
+            const uint32_t i = sim->evUnit[k];
+            ev.obj_addr     = sim->obj[i];
+            ev.owner_slot   = sim->owner[i];
+            ev.requested_hp = sim->evRequested[k];
+            ev.current_hp   = sim->evCurrent[k];
+            log.push(ev);
+        }
+    }
+    sim->evUnit.clear();
+    sim->evRequested.clear();
+    sim->evCurrent.clear();
+}
+
+// Splash the primary damage amount onto every OTHER unit in range (see
+// ReplayMutSetAreaDamageEnabled). Honours hardpoint invulnerability (same INVULNERABLE shortcut as
 // ReplayMutApplyDamage) AND the damage multiplier of each splash target
 // (so enabling both 2× damage and area damage causes splash scaled at
 // 2× per victim). Emits a damage-stream event per victim with
 // requested_hp reflecting the UNSCALED splash intent. Returns the
 // number of units that actually took splash damage. When area damage
 // is disabled this is a no-op that returns 0.
+//
+// A placed primary reaches only the placed units within
+// area_damage_radius, found through the unit grid, so the cost follows the
+// units near the impact rather than the map; each takes the splash scaled
+// by its distance (area_damage_edge). An unplaced primary splashes every
+// unit, on a ReplaySim loaded for the call. Sweeps that splash repeatedly
+// should load one sim themselves and call ReplaySimSplash directly.
 inline int ReplayMutApplyAreaSplash(ReplayState& s, uint64_t primary_obj_addr, float primary_amount) {
     if (!s.area_damage_enabled) return 0;
     if (primary_amount <= 0.0f) return 0;
     float splash = primary_amount * s.area_damage_falloff;
     if (splash <= 0.0f) return 0;
-    int affected = 0;
-    for (auto& entry : s.units) {
-        uint64_t addr = entry.first;
-        if (addr == primary_obj_addr) continue;     // primary target already took damage
-        ReplayUnitDetail& u = entry.second;
-        float before = u.hull;
-        if (ReplayUnitAnyHardpointHasBehavior(u, "INVULNERABLE")) {
-            ReplayMutLogDamageEvent(s, addr, u.owner_slot, before - splash, before);
-            continue;
+    const ReplayUnitDetail* primary = ReplayFindUnit(static_cast<const ReplayState&>(s), primary_obj_addr);
+    if (primary && primary->has_pos) {
+        const float cx = primary->pos_x, cy = primary->pos_y;
+        std::vector<uint64_t> victims;
+        ReplayObsUnitsInRadius(s, cx, cy, s.area_damage_radius, &victims);
+        int affected = 0;
+        for (uint64_t addr : victims) {
+            if (addr == primary_obj_addr) continue;
+            ReplayUnitDetail& u = *ReplayFindUnit(s, addr);
+            const float dx = u.pos_x - cx, dy = u.pos_y - cy;
+            const float hit = splash * ReplayAreaSplashScale(sqrtf(dx * dx + dy * dy), s.area_damage_radius,
+                                                             s.area_damage_edge);
+            const float before = u.hull;
+            if (u.invuln_hardpoints) {
+                ReplayMutLogDamageEvent(s, addr, u.owner_slot, before - hit, before);
+                continue;
+            }
+            float scaled = hit * ReplayObsGetDamageMultiplier(s, u.owner_slot);
+            if (scaled < 0.0f) scaled = 0.0f;
+            u.hull = before - scaled;
+            if (u.hull < 0.0f) u.hull = 0.0f;
+            ReplayMutLogDamageEvent(s, addr, u.owner_slot, before - hit, u.hull);
+            affected++;
         }
-        float mult = ReplayObsGetDamageMultiplier(s, u.owner_slot);
-        float scaled = splash * mult;
-        if (scaled < 0.0f) scaled = 0.0f;
-        u.hull -= scaled;
-        if (u.hull < 0.0f) u.hull = 0.0f;
-        ReplayMutLogDamageEvent(s, addr, u.owner_slot, before - splash, u.hull);
-        affected++;
+        return affected;
     }
+    static thread_local ReplaySim sim;
+    ReplaySimLoad(s, &sim);
+    const int affected = ReplaySimSplash(&sim, ReplaySimFind(&sim, primary_obj_addr), false, 0.0f, 0.0f, 0.0f,
+                                         0.0f, splash);
+    ReplaySimStore(&sim, s);
     return affected;
 }
 
@@ -1688,7 +2180,7 @@ inline int ReplayMutApplyAreaSplash(ReplayState& s, uint64_t primary_obj_addr, f
 // bitmask value stores the override. Bitmask values outside the 3-bit
 // space are masked down to the known bits — passing 0xFF becomes 0x7.
 inline int ReplayMutSetTargetFilter(ReplayState& s, int32_t slot, uint32_t bitmask) {
-    if (slot < 0) return 0;
+    if (slot < 0 || slot >= REPLAY_SLOTS) return 0;
     uint32_t masked = bitmask & ReplayState::TARGET_ALL;
     if (masked == ReplayState::TARGET_ALL) {
         s.per_slot_target_filter.erase(slot);
@@ -1759,6 +2251,7 @@ inline int ReplayMutSetBuildCost(ReplayState& s, int32_t slot, float mult) {
         s.global_build_cost_mult = mult;
         return 1;
     }
+    if (slot >= REPLAY_SLOTS) return 0;
     if (mult == 1.0f) {
         s.per_slot_build_cost_mult.erase(slot);
     } else {
@@ -1781,14 +2274,14 @@ inline float ReplayObsGetBuildCost(const ReplayState& s, int32_t slot) {
 // specific cap value as "clear" because any engine-meaningful cap is
 // potentially valid.
 inline int ReplayMutSetUnitCapOverride(ReplayState& s, int32_t slot, int32_t cap) {
-    if (slot < 0) return 0;
+    if (slot < 0 || slot >= REPLAY_SLOTS) return 0;
     if (cap < -1) return 0;  // only -1 is the unlimited sentinel
     s.per_slot_unit_cap_override[slot] = cap;
     return 1;
 }
 
 inline int ReplayMutClearUnitCapOverride(ReplayState& s, int32_t slot) {
-    if (slot < 0) return 0;
+    if (slot < 0 || slot >= REPLAY_SLOTS) return 0;
     s.per_slot_unit_cap_override.erase(slot);
     return 1;
 }
@@ -1829,6 +2322,57 @@ inline bool ReplayObsShouldBuildComplete(
     return elapsed_ms >= queue_time_ms;
 }
 
+// 2026-10-14. Appends an order to the production queue. Rejects a slot
+// outside [0, REPLAY_SLOTS), an empty type and a negative build time.
+inline int ReplayMutQueueBuild(ReplayState& s, int32_t slot, const std::string& type_name,
+                               int32_t queue_time_ms) {
+    if (slot < 0 || slot >= REPLAY_SLOTS) return 0;
+    if (type_name.empty() || queue_time_ms < 0) return 0;
+    ReplayBuildOrder o;
+    o.slot = slot;
+    o.type_name = type_name;
+    o.queue_time_ms = queue_time_ms;
+    s.build_queue.push_back(std::move(o));
+    return 1;
+}
+
+inline int ReplayObsBuildQueueLength(const ReplayState& s, int32_t slot) {
+    int n = 0;
+    for (const auto& o : s.build_queue) n += (slot < 0 || o.slot == slot) ? 1 : 0;
+    return n;
+}
+
+// Advances the head order of every slot by delta_ms * build speed(slot).
+// An order that ReplayObsShouldBuildComplete passes spawns its unit
+// (ReplayMutSpawnUnits) and leaves the queue -- unless the slot's unit-cap
+// override is reached, in which case it waits, complete, at the head.
+// One completion per slot per call. Returns the orders completed.
+inline int ReplayMutTickBuildProgress(ReplayState& s, int32_t delta_ms) {
+    uint32_t seen = 0;  // slots whose head order was visited
+    int completed = 0;
+    for (size_t i = 0; i < s.build_queue.size();) {
+        ReplayBuildOrder& o = s.build_queue[i];
+        const uint32_t bit = 1u << o.slot;
+        if (seen & bit) { i++; continue; }
+        seen |= bit;
+        o.elapsed_ms += static_cast<double>(delta_ms) * ReplayObsGetBuildSpeed(s, o.slot);
+        const int32_t elapsed = o.elapsed_ms >= static_cast<double>(o.queue_time_ms)
+            ? o.queue_time_ms : static_cast<int32_t>(o.elapsed_ms);
+        if (!ReplayObsShouldBuildComplete(s, o.queue_time_ms, elapsed)) { i++; continue; }
+        const int32_t cap = ReplayObsGetUnitCapOverride(s, o.slot);
+        if (cap >= 0) {
+            int32_t owned = 0;
+            for (const auto& entry : s.units) owned += entry.second.owner_slot == o.slot ? 1 : 0;
+            if (owned >= cap) { i++; continue; }
+        }
+        ReplayMutSpawnUnits(s, o.type_name, o.slot, 1);
+        s.build_queue.erase(s.build_queue.begin() + static_cast<std::ptrdiff_t>(i));
+        s.builds_completed++;
+        completed++;
+    }
+    return completed;
+}
+
 // Task 162 (2026-04-23) — Free-build toggle + cost-computation observer.
 // Free-build wins over the per-slot multiplier (#160) so the engine
 // tick shortcut-path doesn't even evaluate the mult. Returns the
@@ -1937,7 +2481,7 @@ inline int ReplayMutSetOHK(ReplayState& s, bool enable) {
     int flipped = 0;
     if (enable) {
         s.ohk_saved_attack_powers.clear();
-        for (auto& entry : s.units) {
+        for (auto& entry : s.units.mut()) {
             ReplayUnitDetail& u = entry.second;
             if (u.owner_slot != s.local_slot) continue;
             s.ohk_saved_attack_powers[u.obj_addr] = u.attack_power;
@@ -1975,7 +2519,7 @@ inline float ReplayObsGetAttackPower(const ReplayState& s, uint64_t obj_addr) {
 // phase — each slot has its own). Phase 2 hooks into the engine's
 // orbital-phase flag once the IDA pass lands its offset.
 inline int ReplayMutSetOrbitalPhase(ReplayState& s, int32_t slot, uint8_t phase) {
-    if (slot < 0) return 0;
+    if (slot < 0 || slot >= REPLAY_SLOTS) return 0;
     if (phase > 1) return 0;       // only 0/1 valid in Phase 1
     s.per_slot_orbital_phase[slot] = phase;
     return 1;
@@ -2076,7 +2620,7 @@ inline int ReplayMutClearMapHints(ReplayState& s) {
 inline int ReplayMutHealAllLocal(ReplayState& s) {
     if (s.local_slot < 0) return 0;
     int healed = 0;
-    for (auto& entry : s.units) {
+    for (auto& entry : s.units.mut()) {
         ReplayUnitDetail& u = entry.second;
         if (u.owner_slot != s.local_slot) continue;
         if (u.max_hull <= 0.0f) continue;  // guard against mocked-without-max units
@@ -2095,37 +2639,25 @@ inline int ReplayMutHealAllLocal(ReplayState& s) {
 // IsValidObjAddr + OwnerPlayerID read path.
 inline std::string ReplayObsEnumerateUnitsForSlot(const ReplayState& s, int32_t faction_slot) {
     if (s.units.empty() || faction_slot < 0) return "count=0";
-    std::string out;
     int emit_count = 0;
     for (const auto& entry : s.units) {
         if (entry.second.owner_slot == faction_slot) emit_count++;
     }
-    char header[32];
-    int hlen = std::snprintf(header, sizeof(header), "count=%d", emit_count);
-    if (hlen > 0) out.append(header, static_cast<size_t>(hlen));
-    if (emit_count == 0) return out;
-    for (const auto& entry : s.units) {
-        const ReplayUnitDetail& u = entry.second;
-        if (u.owner_slot != faction_slot) continue;
-        bool is_local = (s.local_slot >= 0 && u.owner_slot == s.local_slot);
-        bool is_sel = false;
-        for (uint64_t a : s.selected_units) {
-            if (a == u.obj_addr) { is_sel = true; break; }
+    if (emit_count == 0) return "count=0";
+    return CsvRowBuildString(CsvRowCapacity(32, static_cast<size_t>(emit_count), CSV_UNIT_ROW_MAX), [&](CsvRow* r) {
+        CsvRowCount(r, emit_count);
+        for (const auto& entry : s.units) {
+            const ReplayUnitDetail& u = entry.second;
+            if (u.owner_slot != faction_slot) continue;
+            bool is_local = (s.local_slot >= 0 && u.owner_slot == s.local_slot);
+            bool is_sel = false;
+            for (uint64_t a : s.selected_units) {
+                if (a == u.obj_addr) { is_sel = true; break; }
+            }
+            CsvRowUnit(r, u.obj_addr, u.owner_slot, u.hull, u.invuln_flag, (u.prevent_death & 0x80) ? 1 : 0,
+                       is_local ? 1 : 0, is_sel ? 1 : 0);
         }
-        char row[192];
-        int n = std::snprintf(
-            row, sizeof(row),
-            "|%llu;%d;%.3f;%u;%u;%d;%d",
-            static_cast<unsigned long long>(u.obj_addr),
-            static_cast<int>(u.owner_slot),
-            static_cast<double>(u.hull),
-            static_cast<unsigned>(u.invuln_flag),
-            static_cast<unsigned>((u.prevent_death & 0x80) ? 1 : 0),
-            is_local ? 1 : 0,
-            is_sel ? 1 : 0);
-        if (n > 0) out.append(row, static_cast<size_t>(n));
-    }
-    return out;
+    });
 }
 
 // Pure-state observer for SWFOC_ListTacticalUnits (Task 104, 2026-04-23).
@@ -2149,29 +2681,17 @@ inline std::string ReplayObsEnumerateUnitsForSlot(const ReplayState& s, int32_t
 // as "no tactical units / not in tactical mode" rather than an error.
 inline std::string ReplayObsListTacticalUnits(const ReplayState& s) {
     if (s.units.empty()) return "count=0";
-    std::string out;
-    char header[32];
-    int hlen = std::snprintf(header, sizeof(header), "count=%zu", s.units.size());
-    if (hlen > 0) out.append(header, static_cast<size_t>(hlen));
-    for (const auto& entry : s.units) {
-        const ReplayUnitDetail& u = entry.second;
-        bool is_local = (s.local_slot >= 0 && u.owner_slot == s.local_slot);
-        bool is_sel = false;
-        for (uint64_t a : s.selected_units) {
-            if (a == u.obj_addr) { is_sel = true; break; }
+    return CsvRowBuildString(CsvRowCapacity(32, s.units.size(), CSV_UNIT_ROW_MAX), [&](CsvRow* r) {
+        CsvRowCount(r, static_cast<int64_t>(s.units.size()));
+        for (const auto& entry : s.units) {
+            const ReplayUnitDetail& u = entry.second;
+            bool is_local = (s.local_slot >= 0 && u.owner_slot == s.local_slot);
+            bool is_sel = false;
+            for (uint64_t a : s.selected_units) {
+                if (a == u.obj_addr) { is_sel = true; break; }
+            }
+            CsvRowUnit(r, u.obj_addr, u.owner_slot, u.hull, u.invuln_flag, (u.prevent_death & 0x80) ? 1 : 0,
+                       is_local ? 1 : 0, is_sel ? 1 : 0);
         }
-        char row[192];
-        int n = std::snprintf(
-            row, sizeof(row),
-            "|%llu;%d;%.3f;%u;%u;%d;%d",
-            static_cast<unsigned long long>(u.obj_addr),
-            static_cast<int>(u.owner_slot),
-            static_cast<double>(u.hull),
-            static_cast<unsigned>(u.invuln_flag),
-            static_cast<unsigned>((u.prevent_death & 0x80) ? 1 : 0),
-            is_local ? 1 : 0,
-            is_sel ? 1 : 0);
-        if (n > 0) out.append(row, static_cast<size_t>(n));
-    }
-    return out;
+    });
 }
@@ -0,0 +1,201 @@
+#pragma once
+// replay_sweep.h -- parameter grids for `swfoc_replay.exe --sweep`.
+//
+// Balance tuning runs one snapshot many times under different multiplier
+// settings. A sweep spec names the axes and their values,
+//
+//     income=0.5,1,2;damage@1=1,2;fire_rate=1,1.5
+//
+// and the runner simulates every point of their product (run r picks value
+// r % n0 of the first axis, (r / n0) % n1 of the second, ...):
+//
+//   * Axes: income, damage, fire_rate, build_speed (the global multiplier,
+//     or the per-slot override with `@slot`) and game_speed (global only).
+//     Each value goes through the axis's ReplayMutSet* mutator, so a value
+//     that mutator rejects fails the parse instead of the run.
+//   * Each worker copies the loaded state once; the snapshot tables stay
+//     shared with it (ReplayCow). Between runs ReplaySweepRearm puts back,
+//     by element-wise assignment into the worker's copy, only what a run
+//     writes: players, units, the build queue, the tick clock and the
+//     multiplier tables. The tables nothing in a run writes (objects,
+//     globals, metadata, planets, ...) are never copied, and the units'
+//     strings reuse their buffers, so a run allocates nothing once the
+//     worker has warmed up.
+//     Rearm must cover every field ReplayTickStep or ReplaySweepApply
+//     writes.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code; the
+// thread pool lives in replay_harness.cpp.
+// Not thread-safe: one state per worker.
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "replay_tick.h"
+
+#define REPLAY_SWEEP_MAX_AXES 8
+#define REPLAY_SWEEP_MAX_RUNS 100000
+
+enum ReplaySweepParam {
+    SWEEP_INCOME = 0,
+    SWEEP_DAMAGE,
+    SWEEP_FIRE_RATE,
+    SWEEP_BUILD_SPEED,
+    SWEEP_GAME_SPEED,
+};
+
+struct ReplaySweepAxis {
+    int                param = SWEEP_INCOME;
+    int32_t            slot  = -1;  // -1 = the global multiplier
+    std::string        label;       // as written in the spec, e.g. "damage@1"
+    std::vector<float> values;
+};
+
+inline int ReplaySweepSet(ReplayState& s, int param, int32_t slot, float v) {
+    switch (param) {
+        case SWEEP_INCOME:      return ReplayMutSetIncomeMultiplier(s, slot, v);
+        case SWEEP_DAMAGE:      return ReplayMutSetDamageMultiplier(s, slot, v);
+        case SWEEP_FIRE_RATE:   return ReplayMutSetFireRate(s, slot, v);
+        case SWEEP_BUILD_SPEED: return ReplayMutSetBuildSpeed(s, slot, v);
+        case SWEEP_GAME_SPEED:  return slot < 0 ? ReplayMutSetGameSpeed(s, v) : 0;
+    }
+    return 0;
+}
+
+// Parses `spec` into axes. Returns false with *error set on an unknown
+// axis, a bad slot or value, an empty axis, or a grid over
+// REPLAY_SWEEP_MAX_RUNS points.
+inline bool ReplaySweepParse(const std::string& spec, std::vector<ReplaySweepAxis>* axes, std::string* error) {
+    static const char* const kNames[] = {"income", "damage", "fire_rate", "build_speed", "game_speed"};
+    axes->clear();
+    size_t runs = 1;
+    size_t pos = 0;
+    while (pos < spec.size()) {
+        size_t end = spec.find(';', pos);
+        if (end == std::string::npos) end = spec.size();
+        const std::string part = spec.substr(pos, end - pos);
+        pos = end + 1;
+        if (part.empty()) continue;
+        const size_t eq = part.find('=');
+        if (eq == std::string::npos) {
+            *error = "sweep axis '" + part + "' has no '='";
+            return false;
+        }
+        ReplaySweepAxis axis;
+        axis.label = part.substr(0, eq);
+        std::string name = axis.label;
+        const size_t at = name.find('@');
+        if (at != std::string::npos) {
+            char* tail = nullptr;
+            const long slot = strtol(name.c_str() + at + 1, &tail, 10);
+            if (at + 1 == name.size() || *tail || slot < 0 || slot >= REPLAY_SLOTS) {
+                *error = "sweep axis '" + axis.label + "' has a bad slot";
+                return false;
+            }
+            axis.slot = static_cast<int32_t>(slot);
+            name.resize(at);
+        }
+        axis.param = -1;
+        for (int k = 0; k < static_cast<int>(sizeof(kNames) / sizeof(kNames[0])); k++) {
+            if (name == kNames[k]) axis.param = k;
+        }
+        if (axis.param < 0) {
+            *error = "unknown sweep axis '" + name + "'";
+            return false;
+        }
+        const char* p = part.c_str() + eq + 1;
+        while (*p) {
+            char* tail = nullptr;
+            const float v = strtof(p, &tail);
+            ReplayState probe;
+            if (tail == p || (*tail && *tail != ',') || !ReplaySweepSet(probe, axis.param, axis.slot, v)) {
+                *error = "sweep axis '" + axis.label + "' has a bad value at '" + std::string(p) + "'";
+                return false;
+            }
+            axis.values.push_back(v);
+            p = *tail ? tail + 1 : tail;
+        }
+        if (axis.values.empty()) {
+            *error = "sweep axis '" + axis.label + "' has no values";
+            return false;
+        }
+        runs *= axis.values.size();
+        if (axes->size() >= REPLAY_SWEEP_MAX_AXES || runs > REPLAY_SWEEP_MAX_RUNS) {
+            *error = "sweep grid is too large";
+            return false;
+        }
+        axes->push_back(std::move(axis));
+    }
+    if (axes->empty()) {
+        *error = "sweep spec names no axes";
+        return false;
+    }
+    return true;
+}
+
+inline size_t ReplaySweepRuns(const std::vector<ReplaySweepAxis>& axes) {
+    size_t runs = 1;
+    for (const auto& a : axes) runs *= a.values.size();
+    return runs;
+}
+
+// Value axis `k` takes in run `run`.
+inline float ReplaySweepValue(const std::vector<ReplaySweepAxis>& axes, size_t run, size_t k) {
+    for (size_t i = 0; i < k; i++) run /= axes[i].values.size();
+    return axes[k].values[run % axes[k].values.size()];
+}
+
+// Applies run `run`'s settings to `s`.
+inline void ReplaySweepApply(ReplayState& s, const std::vector<ReplaySweepAxis>& axes, size_t run) {
+    for (size_t k = 0; k < axes.size(); k++) {
+        ReplaySweepSet(s, axes[k].param, axes[k].slot, ReplaySweepValue(axes, run, k));
+    }
+}
+
+// Resets the fields a run writes in `dst` (a copy of `base`) back to base.
+inline void ReplaySweepRearm(ReplayState& dst, const ReplayState& base) {
+    dst.players = base.players;
+    dst.units.mut() = base.units.get();  // into the worker's own table: no new buffers
+    dst.build_queue = base.build_queue;
+    dst.builds_completed = base.builds_completed;
+    dst.sim_tick = base.sim_tick;
+    dst.sim_time_ms = base.sim_time_ms;
+    dst.global_income_mult = base.global_income_mult;
+    dst.per_slot_income_mult = base.per_slot_income_mult;
+    dst.global_damage_mult = base.global_damage_mult;
+    dst.per_slot_damage_mult = base.per_slot_damage_mult;
+    dst.global_fire_rate_mult = base.global_fire_rate_mult;
+    dst.per_slot_fire_rate_mult = base.per_slot_fire_rate_mult;
+    dst.global_build_speed_mult = base.global_build_speed_mult;
+    dst.per_slot_build_speed_mult = base.per_slot_build_speed_mult;
+    dst.global_game_speed = base.global_game_speed;
+}
+
+// One run's outcome, per player in base.players order.
+struct ReplaySweepResult {
+    std::vector<double>   credits;
+    std::vector<uint32_t> alive;  // units with hull > 0, by player
+    ReplayTickStats       stats;
+    uint64_t              digest = 0;
+};
+
+// Rearms `work`, applies run `run` and simulates it.
+inline void ReplaySweepRun(ReplayState& work, const ReplayState& base, const std::vector<ReplaySweepAxis>& axes,
+                           size_t run, const ReplayTickConfig& cfg, uint64_t ticks, ReplaySweepResult* out) {
+    ReplaySweepRearm(work, base);
+    ReplaySweepApply(work, axes, run);
+    out->stats = ReplayTickStats();
+    ReplayTickRun(work, cfg, ticks, [](const ReplayState&) {}, nullptr, &out->stats);
+    out->credits.resize(work.players.size());
+    out->alive.assign(work.players.size(), 0);
+    for (size_t i = 0; i < work.players.size(); i++) out->credits[i] = work.players[i].credits;
+    for (const auto& entry : work.units) {
+        if (entry.second.hull <= 0.0f) continue;
+        for (size_t i = 0; i < work.players.size(); i++) {
+            if (static_cast<int32_t>(work.players[i].slot) == entry.second.owner_slot) out->alive[i]++;
+        }
+    }
+    out->digest = ReplayTickDigest(work);
+}
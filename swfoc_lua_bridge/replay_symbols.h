@@ -0,0 +1,127 @@
+#pragma once
+// replay_symbols.h -- process-wide interned names for the replay model.
+//
+// Behavior lists, diplomacy keys and faction lookups compared names with
+// ReplayUpper(a) == ReplayUpper(b), which builds two strings per test and
+// runs inside the damage / god-mode sweeps once per hardpoint. Names are
+// now interned once, at load or mutation time, into a 32-bit ReplaySymbol:
+//
+//   * Names are case-folded (ASCII) before interning, so one symbol stands
+//     for every spelling the old ReplayUpper comparisons treated as equal.
+//     ReplaySymbolName returns the folded spelling.
+//   * ReplayIntern adds a name the first time it is seen; ReplayFindSymbol
+//     only looks, and returns 0 for a name never interned, so a query with
+//     an unknown name can neither grow the table nor match anything.
+//   * Symbols are never freed. The table holds what fixtures and mutations
+//     name (factions, behaviors, a few hundred at most), so this is bounded
+//     by the data, not by the number of calls.
+//   * The table is shared by every ReplayState and takes a lock, so the
+//     replay pipe thread and the test harness may both intern.
+//
+// ReplaySameName is the allocation-free case-insensitive compare for names
+// that stay strings (faction_name, which fixtures and tests fill in
+// directly). Header-only and std-only; included by replay_state.h.
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef uint32_t ReplaySymbol;  // 0 = no name
+
+inline char ReplayFoldChar(char c) {
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+}
+
+inline bool ReplaySameName(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (ReplayFoldChar(a[i]) != ReplayFoldChar(b[i])) return false;
+    }
+    return true;
+}
+
+struct ReplaySymbolTable {
+    std::mutex              lock;
+    std::deque<std::string> names;  // names[id - 1], folded; a deque keeps references stable
+    std::vector<uint32_t>   slots;  // open-addressed ids, 0 = empty; size is a power of two
+};
+
+inline ReplaySymbolTable& ReplaySymbols() {
+    static ReplaySymbolTable t;
+    return t;
+}
+
+inline uint32_t ReplaySymbolHash(const char* s, size_t n) {
+    uint32_t h = 2166136261u;  // FNV-1a over the folded bytes
+    for (size_t i = 0; i < n; i++) {
+        h ^= static_cast<uint8_t>(ReplayFoldChar(s[i]));
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Slot holding name, or the empty slot where it would go. Caller holds the lock.
+inline size_t ReplaySymbolProbe(const ReplaySymbolTable& t, const char* s, size_t n) {
+    const size_t mask = t.slots.size() - 1;
+    for (size_t i = ReplaySymbolHash(s, n) & mask;; i = (i + 1) & mask) {
+        const uint32_t id = t.slots[i];
+        if (!id) return i;
+        const std::string& name = t.names[id - 1];
+        if (name.size() != n) continue;
+        size_t k = 0;
+        while (k < n && name[k] == ReplayFoldChar(s[k])) k++;
+        if (k == n) return i;
+    }
+}
+
+inline ReplaySymbol ReplayFindSymbol(const char* s, size_t n) {
+    ReplaySymbolTable& t = ReplaySymbols();
+    std::lock_guard<std::mutex> g(t.lock);
+    if (t.slots.empty()) return 0;
+    return t.slots[ReplaySymbolProbe(t, s, n)];
+}
+
+inline ReplaySymbol ReplayFindSymbol(const std::string& name) {
+    return ReplayFindSymbol(name.data(), name.size());
+}
+
+inline ReplaySymbol ReplayIntern(const char* s, size_t n) {
+    ReplaySymbolTable& t = ReplaySymbols();
+    std::lock_guard<std::mutex> g(t.lock);
+    if ((t.names.size() + 1) * 2 > t.slots.size()) {  // keep the load under 1/2
+        t.slots.assign(t.slots.empty() ? 64 : t.slots.size() * 2, 0);
+        for (size_t id = 1; id <= t.names.size(); id++) {
+            const std::string& name = t.names[id - 1];
+            t.slots[ReplaySymbolProbe(t, name.data(), name.size())] = static_cast<uint32_t>(id);
+        }
+    }
+    const size_t slot = ReplaySymbolProbe(t, s, n);
+    if (!t.slots[slot]) {
+        std::string folded(s, n);
+        for (char& c : folded) c = ReplayFoldChar(c);
+        t.names.push_back(std::move(folded));
+        t.slots[slot] = static_cast<uint32_t>(t.names.size());
+    }
+    return t.slots[slot];
+}
+
+inline ReplaySymbol ReplayIntern(const std::string& name) {
+    return ReplayIntern(name.data(), name.size());
+}
+
+// The folded spelling of id; empty for 0 or an id never handed out.
+inline const std::string& ReplaySymbolName(ReplaySymbol id) {
+    static const std::string kNone;
+    ReplaySymbolTable& t = ReplaySymbols();
+    std::lock_guard<std::mutex> g(t.lock);
+    return (id && id <= t.names.size()) ? t.names[id - 1] : kNone;
+}
+
+inline size_t ReplaySymbolCount() {
+    ReplaySymbolTable& t = ReplaySymbols();
+    std::lock_guard<std::mutex> g(t.lock);
+    return t.names.size();
+}
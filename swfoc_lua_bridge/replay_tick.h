@@ -0,0 +1,177 @@
+#pragma once
+// replay_tick.h -- deterministic fixed-step tick engine for the replay model.
+//
+// Time used to move in replay only through separate helpers
+// (ReplayMutTickIncome, ReplayMutTickAbilityCooldown, ...) that a script
+// called by hand, one pipe or --exec call at a time, so a long-horizon
+// economy test cost thousands of Lua calls. ReplayTickRun advances the
+// state N ticks in one native loop instead (swfoc_replay.exe --simulate):
+//
+//   * Every tick is dt_ms of game time. Income is income_per_sec scaled
+//     to the tick (a ReplayIncomePlan, resolved per slot once per run,
+//     applies the income multiplier, game speed and frozen credits);
+//     cooldowns, build progress and hero respawn timers advance by
+//     dt_ms * game speed, rounded to whole ms once per run so every tick
+//     moves them by the same amount. At game speed 0 (paused) only
+//     frozen credits still apply.
+//   * attrition_per_sec, when set, stands in for combat: every live unit
+//     without an INVULNERABLE hardpoint loses that much hull per game
+//     second, times the global fire rate and its slot's damage multiplier
+//     (not logged as damage events), so sweeps over those settings move.
+//   * Order within a tick is fixed: income, attrition, abilities, build
+//     queue, respawns. Same state + same config = same result, bit for bit;
+//     nothing reads a wall clock.
+//   * The observer sees the state after every sample_every-th tick, and
+//     every checkpoint_every-th tick a copy of the state is kept with its
+//     digest, so a test can rewind (ReplayTickRestore) and re-run a branch.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: one state per caller.
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "replay_state.h"
+
+#define REPLAY_TICK_DEFAULT_DT_MS 33       // one engine logic frame at 30 Hz
+#define REPLAY_TICK_MAX_DT_MS     60000
+
+struct ReplayTickConfig {
+    int32_t  dt_ms             = REPLAY_TICK_DEFAULT_DT_MS;
+    double   income_per_sec    = 0.0;   // base credits per game second, per player
+    float    attrition_per_sec = 0.0f;  // hull per game second, per unit
+    uint32_t sample_every      = 0;     // observer cadence in ticks, 0 = never
+    uint32_t checkpoint_every  = 0;     // checkpoint cadence in ticks, 0 = never
+};
+
+// Totals over a run.
+struct ReplayTickStats {
+    uint64_t ticks            = 0;
+    uint64_t income_touches   = 0;  // player-ticks whose credits changed or were frozen
+    uint64_t abilities_ready  = 0;  // abilities that came off cooldown
+    uint64_t builds_completed = 0;
+    uint64_t heroes_revived   = 0;
+    uint64_t units_lost       = 0;  // hulls attrition took to 0
+};
+
+struct ReplayTickCheckpoint {
+    uint64_t    tick   = 0;
+    uint64_t    digest = 0;
+    ReplayState state;
+};
+
+// FNV-1a over what the tick engine moves: the clock, credits, hulls,
+// cooldowns, respawn timers and the build queue. Two runs agree when
+// their digests do.
+inline uint64_t ReplayTickDigest(const ReplayState& s) {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void* p, size_t n) {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; i++) {
+            h ^= b[i];
+            h *= 1099511628211ull;
+        }
+    };
+    mix(&s.sim_tick, sizeof(s.sim_tick));
+    mix(&s.sim_time_ms, sizeof(s.sim_time_ms));
+    for (const auto& p : s.players) mix(&p.credits, sizeof(p.credits));
+    for (const auto& entry : s.units) {
+        const ReplayUnitDetail& u = entry.second;
+        mix(&u.obj_addr, sizeof(u.obj_addr));
+        mix(&u.hull, sizeof(u.hull));
+        mix(&u.respawn_remaining_ms, sizeof(u.respawn_remaining_ms));
+        for (const auto& a : u.abilities) mix(&a.cooldown_remaining_ms, sizeof(a.cooldown_remaining_ms));
+    }
+    for (const auto& o : s.build_queue) {
+        mix(&o.slot, sizeof(o.slot));
+        mix(&o.elapsed_ms, sizeof(o.elapsed_ms));
+    }
+    return h;
+}
+
+// Game milliseconds one tick of `cfg` moves the timers by.
+inline int32_t ReplayTickScaledMs(const ReplayState& s, const ReplayTickConfig& cfg) {
+    return static_cast<int32_t>(std::lround(static_cast<double>(cfg.dt_ms) * s.global_game_speed));
+}
+
+// Income plan for one tick of `cfg` (ReplayIncomePlanBuild).
+inline void ReplayTickIncomePlan(const ReplayState& s, const ReplayTickConfig& cfg, ReplayIncomePlan* plan) {
+    ReplayIncomePlanBuild(s, cfg.income_per_sec * cfg.dt_ms / 1000.0, plan);
+}
+
+// One tick. `scaled_ms` is ReplayTickScaledMs(s, cfg) and `income`
+// ReplayTickIncomePlan(s, cfg).
+inline void ReplayTickStep(ReplayState& s, const ReplayTickConfig& cfg, int32_t scaled_ms,
+                           const ReplayIncomePlan& income, ReplayTickStats* st) {
+    const int touched = ReplayIncomePlanApply(s, income);
+    int lost = 0;
+    if (cfg.attrition_per_sec > 0.0f && scaled_ms > 0) {
+        const float hit = cfg.attrition_per_sec * static_cast<float>(scaled_ms) / 1000.0f * s.global_fire_rate_mult;
+        for (auto& entry : s.units.mut()) {
+            ReplayUnitDetail& u = entry.second;
+            if (u.hull <= 0.0f || u.invuln_hardpoints) continue;
+            u.hull -= hit * ReplayObsGetDamageMultiplier(s, u.owner_slot);
+            if (u.hull <= 0.0f) {
+                u.hull = 0.0f;
+                lost++;
+            }
+        }
+    }
+    int ready = 0;
+    if (scaled_ms > 0) {
+        for (auto& entry : s.units.mut()) ready += ReplayTickUnitAbilities(entry.second, scaled_ms);
+    }
+    const int built = scaled_ms > 0 ? ReplayMutTickBuildProgress(s, scaled_ms) : 0;
+    const int revived = scaled_ms > 0 ? ReplayMutTickRespawn(s, scaled_ms) : 0;
+    s.sim_tick++;
+    s.sim_time_ms += static_cast<uint64_t>(cfg.dt_ms);
+    if (st) {
+        st->ticks++;
+        st->income_touches += static_cast<uint64_t>(touched);
+        st->abilities_ready += static_cast<uint64_t>(ready);
+        st->builds_completed += static_cast<uint64_t>(built);
+        st->heroes_revived += static_cast<uint64_t>(revived);
+        st->units_lost += static_cast<uint64_t>(lost);
+    }
+}
+
+// Runs `ticks` ticks. observe(const ReplayState&) is called after every
+// sample_every-th tick (counted on s.sim_tick, so a resumed run keeps the
+// cadence); checkpoints, when given, receive a copy every
+// checkpoint_every-th tick. Returns 0 for a dt_ms outside
+// [1, REPLAY_TICK_MAX_DT_MS], else the ticks run.
+template<typename Observe>
+inline uint64_t ReplayTickRun(ReplayState& s, const ReplayTickConfig& cfg, uint64_t ticks, Observe&& observe,
+                              std::vector<ReplayTickCheckpoint>* checkpoints = nullptr,
+                              ReplayTickStats* st = nullptr) {
+    if (cfg.dt_ms < 1 || cfg.dt_ms > REPLAY_TICK_MAX_DT_MS) return 0;
+    const int32_t scaled_ms = ReplayTickScaledMs(s, cfg);
+    ReplayIncomePlan income;
+    ReplayTickIncomePlan(s, cfg, &income);
+    for (uint64_t i = 0; i < ticks; i++) {
+        ReplayTickStep(s, cfg, scaled_ms, income, st);
+        if (cfg.sample_every && s.sim_tick % cfg.sample_every == 0) observe(static_cast<const ReplayState&>(s));
+        if (checkpoints && cfg.checkpoint_every && s.sim_tick % cfg.checkpoint_every == 0) {
+            ReplayTickCheckpoint cp;
+            cp.tick = s.sim_tick;
+            cp.digest = ReplayTickDigest(s);
+            cp.state = s;
+            checkpoints->push_back(std::move(cp));
+        }
+    }
+    return ticks;
+}
+
+// Puts `s` back to the checkpoint taken at `tick`. Returns 0 when there is
+// none.
+inline int ReplayTickRestore(ReplayState& s, const std::vector<ReplayTickCheckpoint>& checkpoints,
+                             uint64_t tick) {
+    for (const auto& cp : checkpoints) {
+        if (cp.tick == tick) {
+            s = cp.state;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -327,6 +327,50 @@ namespace UnitType {
     constexpr int MaxHull        = 0xDCC; // float — base max-hull, before damage/diff multipliers
     constexpr int MaxFrontShield = 0xDD0; // float — base max-front-shield
     constexpr int MaxRearShield  = 0xDD4; // float — base max-rear-shield
+    // Type name (e.g. "AT_AT"): MSVC std::string at +0xF8 — size at +0x108,
+    // capacity at +0x110, characters inline while capacity < 16, else via
+    // the pointer at +0xF8. Read this way by the planet getters' error path
+    // (sub_140578D40).
+    constexpr int Name           = 0xF8;
+    constexpr int NameSize       = 0x108;
+    constexpr int NameCapacity   = 0x110;
+}
+
+// ======================================================================
+// Galactic planets (2026-10-14). Planets are ordinary entries of the active
+// mode's object list -- the same chain WalkAllTacticalObjects follows, which
+// galactic Find_All_Objects_Of_Type walks too. Verified against the
+// engine's planet-only Lua getters and the data-pack code:
+//   * sub_14057C2E0 (GameObjectWrapper::Is_Planet_Destroyed) and
+//     sub_140578D40 (Get_Is_Planet_AI_Usable) reject an object whose byte
+//     at +0x335 is 0xFF (logging the type name below), then read
+//     *(obj + 0xB8) + 0x2C8 as the destroyed flag.
+//   * PlanetaryBehaviorClass::dtor (0x3F3340) reaches the same
+//     PlanetaryDataPackClass through parent[0x17] (byte 0xB8).
+//   * PlanetaryDataPackClass ctor (0x4B5700): DynamicVectorClass<
+//     PersistentTacticalBuiltObjectStruct> at +0x08 (vtable), data +0x10,
+//     count +0x18.
+//   * The PlanetFactionChange writers (0x3FA160 / 0x3FB040) own +0x6C
+//     (knowledge-base/alamo_engine_reference.md, PlanetaryDataPackClass).
+// No capital flag is pinned yet; kCapitalFlag < 0 means "not known".
+// ======================================================================
+// GameObjectWrapper (the C++ object behind an engine unit's Lua value):
+// every GameObjectWrapper Lua method reads its GameObjectClass* at +0x60 and
+// bails out when it is null (e.g. sub_14057C2E0 Is_Planet_Destroyed,
+// sub_140578D40 Get_Is_Planet_AI_Usable). Used by SWFOC_Unit to match the
+// wrappers Find_All_Objects_Of_Type returns against an obj_addr.
+namespace LuaWrapper {
+    constexpr int GameObject = 0x60; // GameObjectClass*, 0 once the object is gone
+}
+
+namespace Planet {
+    constexpr int kBehaviorSlot  = 0x335; // uint8 — 0xFF on every non-planet (the byte GameObj::ParentIndex reads)
+    constexpr int kDataPack      = 0xB8;  // PlanetaryDataPackClass*
+    constexpr int kOwnerPlayerID = 0x6C;  // int32 in the data pack — owning player, -1 = neutral
+    constexpr int kBuiltCount    = 0x18;  // int32 in the data pack — persistent tactical structures
+    constexpr int kDestroyed     = 0x2C8; // uint8 in the data pack
+    constexpr int kCapitalFlag   = -1;    // not RE'd yet
+    constexpr int kMaxPlanets    = 512;   // rows kept per walk
 }
 
 // ======================================================================
@@ -363,6 +407,9 @@ namespace Selection {
     constexpr int kObjectListSentinel    = 0x40; // &inner->tail_sentinel
     constexpr int kObjectListHead        = 0x48; // *(inner+0x48) → first live node
     constexpr int kMaxTacticalObjects    = 2048; // hard cap for safety
+    // Whole-list walks (planets, type census): galactic lists hold every
+    // fleet and garrisoned unit as well, so they follow more nodes.
+    constexpr int kMaxModeListWalk       = 16384;
     // Hard cap on per-player selection iteration. The engine uses ring-buffer
     // growth so anything beyond this is either corruption or a test rig.
     constexpr int kMaxSelectionCount     = 64;
@@ -0,0 +1,96 @@
+#pragma once
+// selection_tracker.h -- the local player's selection, sampled once per tick.
+//
+// SWFOC_GetSelectedUnit, SWFOC_GetSelectedUnits, the unit index's
+// is_selected column and the snapshot writer each used to resolve the
+// selection-vector chain and walk its list on every call, and a client that
+// wanted to notice a new selection had to keep asking. The bridge now walks
+// the list in one place (GetSelection in lua_bridge.cpp) at most once per
+// luaD_call tick, keeps the result here, and publishes EVT_SELECTION into
+// the event ring whenever it changes:
+//
+//   * The list is bounded by kMaxSelectionCount (64 nodes), so a sample is
+//     the pointer chain plus one short walk. Its hash covers the vector
+//     header, the count and every object in order -- a reordered or
+//     re-clicked selection of the same size still counts as a change.
+//   * `seq` is bumped on every change and travels in the event, so a
+//     consumer that missed records (EVT_RESYNC) can still tell whether the
+//     selection it holds is current.
+//   * A sample is fresh for SELECTION_MAX_AGE_MS within the same tick, like
+//     the unit index; Hook_luaD_call also samples on the telemetry cadence,
+//     so events flow while nothing is asking.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge samples and reads it on the main thread.
+
+#include <cstdint>
+
+#define SELECTION_TRACK_MAX  64   // RVA::Selection::kMaxSelectionCount
+#define SELECTION_MAX_AGE_MS 100  // ms a same-tick sample stays fresh
+
+struct SelectionTracker {
+    uint64_t objs[SELECTION_TRACK_MAX];  // selection order
+    int32_t  count;
+    uint64_t vec;                        // selection-vector header, 0 = unresolved
+    uint64_t hash;                       // 0 = never sampled
+    int64_t  tick;                       // luaD_call tick of the sample, -1 = none
+    uint64_t ms;
+    uint32_t seq;                        // bumped on every change
+    uint32_t samples;
+    uint32_t changes;
+};
+
+inline void SelectionTrackerReset(SelectionTracker* t) {
+    t->count = 0;
+    t->vec = 0;
+    t->hash = 0;
+    t->tick = -1;
+    t->ms = 0;
+}
+
+inline uint64_t SelectionHash(uint64_t vec, const uint64_t* objs, int n) {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](uint64_t v) {
+        h ^= v;
+        h *= 1099511628211ull;
+    };
+    mix(vec);
+    mix((uint64_t)n);
+    for (int i = 0; i < n; i++) mix(objs[i]);
+    return h | 1;
+}
+
+// A sample taken this tick, less than SELECTION_MAX_AGE_MS ago.
+inline bool SelectionTrackerFresh(const SelectionTracker* t, int64_t tick, uint64_t nowMs) {
+    return t->tick == tick && nowMs - t->ms < SELECTION_MAX_AGE_MS;
+}
+
+// Records one sample (n is clamped to SELECTION_TRACK_MAX; vec 0 = the
+// chain did not resolve, which reads as an empty selection). Returns true
+// when the selection differs from the previous sample.
+inline bool SelectionTrackerUpdate(SelectionTracker* t, uint64_t vec, const uint64_t* objs, int n,
+                                   int64_t tick, uint64_t nowMs) {
+    if (n < 0 || !vec) n = 0;
+    if (n > SELECTION_TRACK_MAX) n = SELECTION_TRACK_MAX;
+    const uint64_t h = SelectionHash(vec, objs, n);
+    const bool changed = h != t->hash;
+    if (changed) {
+        for (int i = 0; i < n; i++) t->objs[i] = objs[i];
+        t->count = n;
+        t->vec = vec;
+        t->hash = h;
+        t->seq++;
+        t->changes++;
+    }
+    t->tick = tick;
+    t->ms = nowMs;
+    t->samples++;
+    return changed;
+}
+
+inline bool SelectionTrackerContains(const SelectionTracker* t, uint64_t obj) {
+    for (int i = 0; i < t->count; i++) {
+        if (t->objs[i] == obj) return true;
+    }
+    return false;
+}
@@ -2,6 +2,9 @@
 #include <windows.h>
 #include <atomic>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <thread>
 
 #define SHMEM_CMD_NAME  "Local\\SWFOC_Bridge_Cmd"
 #define SHMEM_CMD_SIZE  8192
@@ -15,16 +18,225 @@ struct SharedCmdBuffer {
     char result[4096];                  // Result text (null-terminated)
 };
 
-// Event ring buffer for high-frequency data (Wave 1D)
-#define SHMEM_EVT_NAME "Local\\SWFOC_Bridge_Events"
-#define SHMEM_EVT_SIZE (64 * 1024)
+// ----- Command ring v2 (2026-10-14) -----
+//
+// SharedCmdBuffer above holds one command at a time: clients spin on
+// result_seq and a second writer overwrites an unfinished command. The v2
+// ring lives in its own mapping so v1 scripts keep working unchanged.
+//
+// Client:  ShmRingClaim -> write slots[i].cmd in place -> ShmRingSubmit,
+//          wait on the slot's auto-reset done event
+//          (SHMEM_RING_EVENT_PREFIX + "<i>"), then ShmRingCollect, which
+//          frees the slot. Give up with ShmRingAbandon.
+// Bridge:  Hook_luaD_call checks `pending`, then ShmRingPop (oldest seq
+//          first), runs the command straight out of the slot, writes the
+//          result into it and calls ShmRingComplete before signalling.
+//
+// Several clients (or one pipelining client) can keep up to
+// SHMEM_RING_SLOTS commands in flight. A done event can carry a stale
+// signal from an abandoned earlier use of the slot, so clients re-check
+// ShmRingCollect after every wake. Pure atomics, no Win32 calls, so
+// test_harness.cpp drives these helpers directly.
+
+#define SHMEM_RING_NAME          "Local\\SWFOC_Bridge_CmdRing"
+#define SHMEM_RING_EVENT_PREFIX  "Local\\SWFOC_Bridge_CmdRing_Done"
+#define SHMEM_RING_MAGIC         0x474E5253u  // "SRNG" little-endian
+#define SHMEM_RING_VERSION       2
+#define SHMEM_RING_SLOTS         16
+#define SHMEM_RING_CMD_MAX       4096
+#define SHMEM_RING_RESULT_MAX    4096
+
+enum ShmRingSlotState : uint32_t {
+    SHM_SLOT_FREE = 0,
+    SHM_SLOT_CLAIMED,     // a client is writing cmd
+    SHM_SLOT_QUEUED,      // waiting for the main thread
+    SHM_SLOT_RUNNING,     // the bridge owns cmd/result
+    SHM_SLOT_DONE,        // result ready for the client
+    SHM_SLOT_ABANDONED,   // client gave up; bridge frees the slot
+};
+
+struct SharedCmdRingSlot {
+    std::atomic<uint32_t> state;    // ShmRingSlotState
+    uint32_t seq;                   // submit order, echoed back with the result
+    uint32_t cmd_len;
+    uint32_t result_len;
+    char cmd[SHMEM_RING_CMD_MAX];       // NUL-terminated by ShmRingSubmit
+    char result[SHMEM_RING_RESULT_MAX]; // "ERR: ..." on Lua errors, like v1
+};
+
+struct SharedCmdRing {
+    uint32_t magic;                 // SHMEM_RING_MAGIC once the bridge is up
+    uint32_t version;               // SHMEM_RING_VERSION
+    uint32_t slot_count;            // SHMEM_RING_SLOTS
+    uint32_t slot_size;             // sizeof(SharedCmdRingSlot)
+    std::atomic<uint32_t> next_seq; // clients fetch_add on submit
+    std::atomic<uint32_t> pending;  // QUEUED slots; the bridge's doorbell
+    std::atomic<uint32_t> completed;
+    uint32_t reserved;
+    SharedCmdRingSlot slots[SHMEM_RING_SLOTS];
+};
+
+inline void ShmRingInit(SharedCmdRing* r) {
+    memset(r, 0, sizeof(*r));
+    r->magic = SHMEM_RING_MAGIC;
+    r->version = SHMEM_RING_VERSION;
+    r->slot_count = SHMEM_RING_SLOTS;
+    r->slot_size = sizeof(SharedCmdRingSlot);
+}
+
+// Client: takes a free slot for writing. Returns its index or -1 when the
+// ring is full.
+inline int ShmRingClaim(SharedCmdRing* r) {
+    for (int i = 0; i < SHMEM_RING_SLOTS; i++) {
+        uint32_t expected = SHM_SLOT_FREE;
+        if (r->slots[i].state.compare_exchange_strong(expected, SHM_SLOT_CLAIMED,
+                                                      std::memory_order_acquire))
+            return i;
+    }
+    return -1;
+}
+
+// Client: publishes slots[i].cmd (cmd_len bytes, clamped) and returns the
+// sequence number to collect it by.
+inline uint32_t ShmRingSubmit(SharedCmdRing* r, int i, uint32_t cmd_len) {
+    SharedCmdRingSlot* s = &r->slots[i];
+    if (cmd_len >= SHMEM_RING_CMD_MAX) cmd_len = SHMEM_RING_CMD_MAX - 1;
+    s->cmd[cmd_len] = '\0';
+    s->cmd_len = cmd_len;
+    s->result_len = 0;
+    s->seq = r->next_seq.fetch_add(1, std::memory_order_relaxed);
+    s->state.store(SHM_SLOT_QUEUED, std::memory_order_release);
+    r->pending.fetch_add(1, std::memory_order_release);
+    return s->seq;
+}
+
+// Bridge: claims the oldest queued slot (now RUNNING) or returns -1.
+inline int ShmRingPop(SharedCmdRing* r) {
+    for (;;) {
+        int best = -1;
+        for (int i = 0; i < SHMEM_RING_SLOTS; i++) {
+            if (r->slots[i].state.load(std::memory_order_acquire) != SHM_SLOT_QUEUED) continue;
+            if (best < 0 || (int32_t)(r->slots[i].seq - r->slots[best].seq) < 0) best = i;
+        }
+        if (best < 0) return -1;
+        uint32_t expected = SHM_SLOT_QUEUED;
+        if (r->slots[best].state.compare_exchange_strong(expected, SHM_SLOT_RUNNING,
+                                                         std::memory_order_acq_rel)) {
+            r->pending.fetch_sub(1, std::memory_order_relaxed);
+            return best;
+        }
+        // Lost to a client abandoning it; rescan.
+    }
+}
+
+// Bridge: publishes the result. Returns false when the client abandoned the
+// slot meanwhile (the slot is freed and nobody needs waking).
+inline bool ShmRingComplete(SharedCmdRing* r, int i) {
+    uint32_t expected = SHM_SLOT_RUNNING;
+    if (r->slots[i].state.compare_exchange_strong(expected, SHM_SLOT_DONE,
+                                                  std::memory_order_release)) {
+        r->completed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    r->slots[i].state.store(SHM_SLOT_FREE, std::memory_order_release);
+    return false;
+}
+
+// Client: if `seq` finished in slot i, copies its result (NUL-terminated,
+// truncated to cap), frees the slot and returns true.
+inline bool ShmRingCollect(SharedCmdRing* r, int i, uint32_t seq, char* out, size_t cap) {
+    SharedCmdRingSlot* s = &r->slots[i];
+    if (s->state.load(std::memory_order_acquire) != SHM_SLOT_DONE || s->seq != seq) return false;
+    if (out && cap) {
+        size_t n = s->result_len < cap ? s->result_len : cap - 1;
+        memcpy(out, s->result, n);
+        out[n] = '\0';
+    }
+    s->state.store(SHM_SLOT_FREE, std::memory_order_release);
+    return true;
+}
+
+// Client: gives up on slot i. A claimed or queued slot is freed at once, a
+// running one is left for the bridge to free, a finished one is freed here.
+inline void ShmRingAbandon(SharedCmdRing* r, int i) {
+    SharedCmdRingSlot* s = &r->slots[i];
+    uint32_t expected = SHM_SLOT_CLAIMED;
+    if (s->state.compare_exchange_strong(expected, SHM_SLOT_FREE, std::memory_order_acq_rel))
+        return;
+    expected = SHM_SLOT_QUEUED;
+    if (s->state.compare_exchange_strong(expected, SHM_SLOT_FREE, std::memory_order_acq_rel)) {
+        r->pending.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    expected = SHM_SLOT_RUNNING;
+    if (s->state.compare_exchange_strong(expected, SHM_SLOT_ABANDONED, std::memory_order_acq_rel))
+        return;
+    expected = SHM_SLOT_DONE;
+    s->state.compare_exchange_strong(expected, SHM_SLOT_FREE, std::memory_order_acq_rel);
+}
+
+// ----- Event ring (Wave 1D, v2 2026-10-14) -----
+//
+// Byte ring of [uint16 type][uint16 payload_size][payload] records fed by
+// the damage / death hooks, which run on several engine threads. v1 was a
+// single-writer ring that never looked at read_pos, so concurrent hooks
+// interleaved bytes and a slow reader was lapped into torn records.
+//
+// Producers (ShmEvtWrite) claim space with a CAS on reserve_pos, fill it,
+// then commit in claim order by advancing write_pos. Between claim and
+// commit a producer only copies bytes, so a successor waits at most for
+// that copy. A record that does not fit in front of read_pos is dropped and
+// counted; the next record that fits is preceded by an EVT_RESYNC marker
+// carrying the number lost, so the reader sees a clean gap instead of
+// garbage.
+//
+// Reader: while read_pos != write_pos, parse the record at
+// ring[read_pos % SHMEM_EVT_RING_SIZE], then advance read_pos by
+// ShmEvtRecordSize(payload_size) (4 + payload_size rounded up to 8).
+// Cursors are free-running uint32 byte counts; the ring size is a power of
+// two so they wrap cleanly. The 16-byte v1 header offsets are unchanged;
+// the ring itself now starts at +32.
+//
+// Records start 8-byte aligned, so the header never straddles the ring end
+// and a reader can cast a record in place unless its payload wraps
+// (offset + ShmEvtRecordSize(size) > SHMEM_EVT_RING_SIZE). Copies are one
+// memcpy, or two split at the wrap point; evt_ring_bench.cpp measures the
+// per-event cost.
+
+#define SHMEM_EVT_NAME      "Local\\SWFOC_Bridge_Events"
+#define SHMEM_EVT_VERSION   2
+#define SHMEM_EVT_RING_SIZE (64 * 1024)  // power of two
+#define SHMEM_EVT_HDR_SIZE  4            // uint16 type + uint16 payload_size
+#define SHMEM_EVT_ALIGN     8
+
+// 2026-10-14: compact HP encoding (event_compact.h). Set together with bit 0
+// by SWFOC_EventControl(1, "compact"); while it is set HP changes arrive as
+// EVT_HP_BATCH records, each packing up to EVT_COMPACT_BATCH_EVENTS events:
+//
+//   u8 count, varint ms since EvtStreamInfo::base_ms of the first event,
+//   then per event: varint ms since the previous event (0 for the first),
+//   u16 session id, u16 old hp, u16 damage, u8 damage type.
+//
+// HP and damage are fractions of the unit's max hull (EvtUnitKey) scaled
+// by EVT_COMPACT_HP_SCALE, 0xFFFF = unknown. Varints are LEB128. A session
+// id is bound by an EVT_UNIT_KEY record that precedes its first use; an
+// event that cannot get one is written as a plain EVT_HP_CHANGE. Deaths
+// stay EVT_UNIT_DIED in both modes.
+#define SHMEM_EVT_FLAG_COMPACT   0x2
+#define EVT_COMPACT_ENCODING     1
+#define EVT_COMPACT_HP_SCALE     32767.0f  // 1.0 of max hull; covers [0, 2)
+#define EVT_COMPACT_HP_UNKNOWN   0xFFFF
 
 struct SharedEvtBuffer {
-    std::atomic<uint32_t> write_pos;
-    std::atomic<uint32_t> read_pos;
-    std::atomic<uint32_t> event_count;
-    std::atomic<uint32_t> flags;        // Bit 0: events enabled
-    uint8_t ring[SHMEM_EVT_SIZE - 16];
+    std::atomic<uint32_t> write_pos;        // +0  commit cursor: [read_pos, write_pos) is readable
+    std::atomic<uint32_t> read_pos;         // +4  reader-owned
+    std::atomic<uint32_t> event_count;      // +8  records committed (markers excluded)
+    std::atomic<uint32_t> flags;            // +12 bit 0: events enabled, bit 1: compact HP (SHMEM_EVT_FLAG_COMPACT)
+    std::atomic<uint32_t> reserve_pos;      // +16 producer claim cursor
+    std::atomic<uint32_t> dropped;          // +20 records lost to a full ring, total
+    std::atomic<uint32_t> dropped_pending;  // +24 losses not yet reported by EVT_RESYNC
+    uint32_t              version;          // +28 SHMEM_EVT_VERSION
+    alignas(SHMEM_EVT_ALIGN) uint8_t ring[SHMEM_EVT_RING_SIZE];  // +32
 };
 
 enum EventType : uint16_t {
@@ -32,6 +244,319 @@ enum EventType : uint16_t {
     EVT_UNIT_DIED   = 0x02,
     EVT_PRODUCTION  = 0x03,
     EVT_STORY       = 0x04,
+    EVT_UNIT_KEY    = 0x05,  // compact mode: session id -> unit_id binding
+    EVT_HP_BATCH    = 0x06,  // compact mode: batched, quantized HP changes
+    EVT_STREAM_INFO = 0x07,  // compact mode: encoding + time base, first record
     EVT_POSITION    = 0x10,
     EVT_SELECTION   = 0x20,
+    EVT_RESYNC      = 0xFF,  // payload: uint32 records dropped since the last marker
+};
+
+// Record payloads. Fields are only ever appended: readers take the size from
+// the record header and ignore trailing bytes they do not know.
+#pragma pack(push, 1)
+struct EvtHPChange {
+    uint32_t unit_id;     // GameObj+0x50
+    float    old_hp;      // GameObj+0x5C (before damage)
+    float    damage;      // from damageParams[0]
+    int      damage_type; // damageType arg
+};
+
+struct EvtUnitDied {
+    uint32_t unit_id;     // GameObj+0x50
+    int      death_cause; // deathCause arg
+    // 2026-10-14: owner slots, so a client (the overlay HUD) can keep its
+    // kill / death / alive counters from the stream alone. -1 = unknown:
+    // no killer object, or no local player (galactic transitions).
+    int32_t  victim_owner;
+    int32_t  killer_owner;
+    int32_t  local_slot;
+};
+
+// 2026-10-14: published by GetSelection (selection_tracker.h) when the local
+// player's selection changes. first_obj = 0 when nothing is selected.
+struct EvtSelection {
+    uint32_t seq;         // SelectionTracker::seq, bumped per change
+    int32_t  count;       // selected objects
+    uint64_t first_obj;   // GameObjectClass* of the first selected object
+    uint64_t hash;        // SelectionHash of the whole list
+};
+
+struct EvtUnitKey {
+    uint16_t sid;         // session id used by EVT_HP_BATCH
+    uint32_t unit_id;     // GameObj+0x50
+    float    max_hull;    // GameObj+0xDCC when bound, the HP fractions' base
+};
+
+struct EvtStreamInfo {
+    uint32_t encoding;    // EVT_COMPACT_ENCODING
+    uint64_t base_ms;     // Unix ms the batch timestamps count from
+};
+#pragma pack(pop)
+
+#define EVT_UNIT_DIED_V1_SIZE 8  // unit_id + death_cause only
+static_assert(sizeof(EvtSelection) == 24, "EvtSelection layout is mirrored by the overlay");
+
+// Only call while no producer can run (mapping creation / tests).
+inline void ShmEvtInit(SharedEvtBuffer* b) {
+    memset(b, 0, sizeof(*b));
+    b->version = SHMEM_EVT_VERSION;
+}
+
+// Discards everything unread and clears the counters. Safe with producers
+// in flight: cursors are never moved backwards.
+inline void ShmEvtDiscard(SharedEvtBuffer* b) {
+    b->read_pos.store(b->write_pos.load(std::memory_order_acquire), std::memory_order_release);
+    b->event_count.store(0, std::memory_order_relaxed);
+    b->dropped.store(0, std::memory_order_relaxed);
+    b->dropped_pending.store(0, std::memory_order_relaxed);
+}
+
+inline uint32_t ShmEvtRecordSize(uint32_t payloadSize) {
+    return (SHMEM_EVT_HDR_SIZE + payloadSize + SHMEM_EVT_ALIGN - 1) & ~(uint32_t)(SHMEM_EVT_ALIGN - 1);
+}
+
+inline void ShmEvtCopy(SharedEvtBuffer* b, uint32_t pos, const void* src, uint32_t n) {
+    const uint32_t off = pos & (SHMEM_EVT_RING_SIZE - 1);
+    const uint32_t first = (n < SHMEM_EVT_RING_SIZE - off) ? n : SHMEM_EVT_RING_SIZE - off;
+    memcpy(b->ring + off, src, first);
+    if (first < n) memcpy(b->ring, static_cast<const uint8_t*>(src) + first, n - first);
+}
+
+// `pos` is 8-byte aligned, so the 4-byte header is always contiguous.
+inline void ShmEvtPutRecord(SharedEvtBuffer* b, uint32_t pos, uint16_t type,
+                            const void* payload, uint16_t size) {
+    const uint32_t header = (uint32_t)type | ((uint32_t)size << 16);
+    memcpy(b->ring + (pos & (SHMEM_EVT_RING_SIZE - 1)), &header, SHMEM_EVT_HDR_SIZE);
+    ShmEvtCopy(b, pos + SHMEM_EVT_HDR_SIZE, payload, size);
+}
+
+// Producer side, any thread. Returns false when the record was dropped
+// because the reader is too far behind.
+inline bool ShmEvtWrite(SharedEvtBuffer* b, uint16_t type, const void* payload, uint16_t size) {
+    const uint32_t markerSize = ShmEvtRecordSize(sizeof(uint32_t));
+    uint32_t lost = 0;
+    if (b->dropped_pending.load(std::memory_order_relaxed))
+        lost = b->dropped_pending.exchange(0, std::memory_order_acq_rel);
+    const uint32_t total = ShmEvtRecordSize(size) + (lost ? markerSize : 0);
+
+    uint32_t start = b->reserve_pos.load(std::memory_order_relaxed);
+    do {
+        if (start + total - b->read_pos.load(std::memory_order_acquire) > SHMEM_EVT_RING_SIZE) {
+            b->dropped.fetch_add(1, std::memory_order_relaxed);
+            b->dropped_pending.fetch_add(lost + 1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!b->reserve_pos.compare_exchange_weak(start, start + total,
+                 std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    uint32_t pos = start;
+    if (lost) {
+        ShmEvtPutRecord(b, pos, EVT_RESYNC, &lost, sizeof(lost));
+        pos += markerSize;
+    }
+    ShmEvtPutRecord(b, pos, type, payload, size);
+
+    // Commit in claim order: wait for every earlier claim to publish.
+    for (uint32_t spins = 0; b->write_pos.load(std::memory_order_acquire) != start; spins++) {
+        if (spins >= 64) std::this_thread::yield();
+    }
+    b->write_pos.store(start + total, std::memory_order_release);
+    b->event_count.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Reader side (single consumer). Copies up to `cap` payload bytes into
+// `out`, reports the full payload size and advances read_pos. Returns false
+// when nothing is committed.
+inline bool ShmEvtRead(SharedEvtBuffer* b, uint16_t* type, void* out, uint32_t cap, uint16_t* size) {
+    const uint32_t rp = b->read_pos.load(std::memory_order_relaxed);
+    if (rp == b->write_pos.load(std::memory_order_acquire)) return false;
+    uint32_t header;
+    memcpy(&header, b->ring + (rp & (SHMEM_EVT_RING_SIZE - 1)), SHMEM_EVT_HDR_SIZE);
+    *type = (uint16_t)(header & 0xFFFF);
+    *size = (uint16_t)(header >> 16);
+    const uint32_t n = (*size < cap) ? *size : cap;
+    const uint32_t off = (rp + SHMEM_EVT_HDR_SIZE) & (SHMEM_EVT_RING_SIZE - 1);
+    const uint32_t first = (n < SHMEM_EVT_RING_SIZE - off) ? n : SHMEM_EVT_RING_SIZE - off;
+    memcpy(out, b->ring + off, first);
+    if (first < n) memcpy(static_cast<uint8_t*>(out) + first, b->ring, n - first);
+    b->read_pos.store(rp + ShmEvtRecordSize(*size), std::memory_order_release);
+    return true;
+}
+
+// ----- Unit table (2026-10-14) -----
+//
+// Binary output of SWFOC_ListTacticalUnits("bin") / SWFOC_EnumerateUnits(
+// slot, "bin"). Instead of a "|addr;owner;hull;..." string capped at 64 KB,
+// the helper fills this struct-of-arrays block and replies
+// "bin count=N seq=S bounds=B". Clients map it and read the columns
+// directly: no float formatting or parsing, and every walked unit fits.
+//
+// Offsets: header 32 bytes, then obj_addr[MAX] (u64), owner[MAX] (i32),
+// hull[MAX] (f32), flags[MAX] (u8, ShmUnitFlag bits). Only the first
+// `count` entries of each column are meaningful.
+//
+// Version 2 appends pos[MAX][3] and half_extent[MAX][3] (f32, world space)
+// for the overlay's click picking; a row's bounds are valid only when it
+// carries SHM_UNIT_HAS_BOUNDS. Version-1 readers never look past flags[].
+//
+// `seq` is a seqlock: odd while the bridge is writing. Readers copy what they
+// need, then re-read seq; a changed or odd value means retry (ShmUnitsRead).
+
+#define SHMEM_UNITS_NAME    "Local\\SWFOC_Bridge_Units"
+#define SHMEM_UNITS_MAGIC   0x54494E55u  // "UNIT"
+#define SHMEM_UNITS_VERSION 2
+#define SHMEM_UNITS_MAX     2048         // RVA::Selection::kMaxTacticalObjects
+
+enum ShmUnitFlag : uint8_t {
+    SHM_UNIT_INVULN        = 0x01,  // display byte at +0x3A7
+    SHM_UNIT_PREVENT_DEATH = 0x02,  // bit 0x80 of +0x3A1
+    SHM_UNIT_LOCAL_OWNER   = 0x04,
+    SHM_UNIT_SELECTED      = 0x08,
+    SHM_UNIT_HAS_BOUNDS    = 0x10,  // pos / half_extent filled (version 2)
+};
+
+struct SharedUnitTable {
+    uint32_t              magic;        // +0  SHMEM_UNITS_MAGIC
+    uint16_t              version;      // +4
+    uint16_t              header_size;  // +6  offset of obj_addr[]
+    std::atomic<uint32_t> seq;          // +8  odd while writing
+    uint32_t              count;        // +12
+    int32_t               slot_filter;  // +16 owner slot, -1 = every unit
+    uint32_t              capacity;     // +20 SHMEM_UNITS_MAX
+    uint64_t              tick;         // +24 luaD_call tick when written
+    uint64_t              obj_addr[SHMEM_UNITS_MAX];
+    int32_t               owner[SHMEM_UNITS_MAX];
+    float                 hull[SHMEM_UNITS_MAX];
+    uint8_t               flags[SHMEM_UNITS_MAX];
+    float                 pos[SHMEM_UNITS_MAX][3];          // version 2
+    float                 half_extent[SHMEM_UNITS_MAX][3];  // version 2
 };
+
+inline void ShmUnitsInit(SharedUnitTable* t) {
+    memset((void*)t, 0, sizeof(*t));
+    t->magic = SHMEM_UNITS_MAGIC;
+    t->version = SHMEM_UNITS_VERSION;
+    t->header_size = (uint16_t)offsetof(SharedUnitTable, obj_addr);
+    t->capacity = SHMEM_UNITS_MAX;
+    t->slot_filter = -1;
+}
+
+// Single writer (the game's main thread). Rows go between Begin and End.
+inline void ShmUnitsBeginWrite(SharedUnitTable* t) {
+    t->seq.store(t->seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline uint32_t ShmUnitsEndWrite(SharedUnitTable* t) {
+    const uint32_t seq = t->seq.load(std::memory_order_relaxed) + 1;
+    t->seq.store(seq, std::memory_order_release);
+    return seq;
+}
+
+// Reader side. Copies up to `cap` rows into the caller's columns (any may be
+// nullptr) and returns the row count, or -1 if the table kept changing
+// underneath after `retries` attempts.
+inline int ShmUnitsRead(const SharedUnitTable* t, uint64_t* obj, int32_t* owner, float* hull,
+                        uint8_t* flags, uint32_t cap, int retries = 8) {
+    for (int attempt = 0; attempt < retries; attempt++) {
+        const uint32_t before = t->seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        uint32_t n = t->count;
+        if (n > SHMEM_UNITS_MAX) n = SHMEM_UNITS_MAX;
+        if (n > cap) n = cap;
+        if (obj)   memcpy(obj, t->obj_addr, n * sizeof(uint64_t));
+        if (owner) memcpy(owner, t->owner, n * sizeof(int32_t));
+        if (hull)  memcpy(hull, t->hull, n * sizeof(float));
+        if (flags) memcpy(flags, t->flags, n);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (t->seq.load(std::memory_order_relaxed) == before) return (int)n;
+    }
+    return -1;
+}
+
+// ----- Planet table (2026-10-14) -----
+//
+// Binary output of SWFOC_ListPlanets("bin"): one row per galactic planet,
+// filled by the native walker (WalkGalacticPlanets) in a single pass over
+// the mode's object list. Same header shape and seqlock as the unit table;
+// the reply is "bin count=N seq=S".
+//
+// Offsets: header 32 bytes, then obj_addr[MAX] (u64), owner[MAX] (i32, -1 =
+// neutral), tech[MAX] (i32, owner's tech level, 0 when neutral),
+// buildings[MAX] (i32, persistent tactical structures), flags[MAX] (u8,
+// ShmPlanetFlag bits), name[MAX][SHMEM_PLANETS_NAME_LEN] (NUL-terminated
+// type name, clipped).
+//
+// SHM_PLANET_CAPITAL is only meaningful with SHM_PLANET_CAPITAL_KNOWN; the
+// capital byte is not RE'd yet, so the bridge never sets either.
+
+#define SHMEM_PLANETS_NAME     "Local\\SWFOC_Bridge_Planets"
+#define SHMEM_PLANETS_MAGIC    0x544E4C50u  // "PLNT"
+#define SHMEM_PLANETS_VERSION  1
+#define SHMEM_PLANETS_MAX      512          // RVA::Planet::kMaxPlanets
+#define SHMEM_PLANETS_NAME_LEN 48
+
+enum ShmPlanetFlag : uint8_t {
+    SHM_PLANET_DESTROYED     = 0x01,
+    SHM_PLANET_CAPITAL       = 0x02,
+    SHM_PLANET_CAPITAL_KNOWN = 0x04,
+    SHM_PLANET_LOCAL_OWNER   = 0x08,
+};
+
+struct SharedPlanetTable {
+    uint32_t              magic;        // +0  SHMEM_PLANETS_MAGIC
+    uint16_t              version;      // +4
+    uint16_t              header_size;  // +6  offset of obj_addr[]
+    std::atomic<uint32_t> seq;          // +8  odd while writing
+    uint32_t              count;        // +12
+    uint32_t              capacity;     // +16 SHMEM_PLANETS_MAX
+    uint32_t              reserved;     // +20
+    uint64_t              tick;         // +24 luaD_call tick when written
+    uint64_t              obj_addr[SHMEM_PLANETS_MAX];
+    int32_t               owner[SHMEM_PLANETS_MAX];
+    int32_t               tech[SHMEM_PLANETS_MAX];
+    int32_t               buildings[SHMEM_PLANETS_MAX];
+    uint8_t               flags[SHMEM_PLANETS_MAX];
+    char                  name[SHMEM_PLANETS_MAX][SHMEM_PLANETS_NAME_LEN];
+};
+
+inline void ShmPlanetsInit(SharedPlanetTable* t) {
+    memset((void*)t, 0, sizeof(*t));
+    t->magic = SHMEM_PLANETS_MAGIC;
+    t->version = SHMEM_PLANETS_VERSION;
+    t->header_size = (uint16_t)offsetof(SharedPlanetTable, obj_addr);
+    t->capacity = SHMEM_PLANETS_MAX;
+}
+
+inline void ShmPlanetsBeginWrite(SharedPlanetTable* t) {
+    t->seq.store(t->seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline uint32_t ShmPlanetsEndWrite(SharedPlanetTable* t) {
+    const uint32_t seq = t->seq.load(std::memory_order_relaxed) + 1;
+    t->seq.store(seq, std::memory_order_release);
+    return seq;
+}
+
+// Reader side, as ShmUnitsRead. Any column may be nullptr.
+inline int ShmPlanetsRead(const SharedPlanetTable* t, uint64_t* obj, int32_t* owner, int32_t* tech,
+                          int32_t* buildings, uint8_t* flags, uint32_t cap, int retries = 8) {
+    for (int attempt = 0; attempt < retries; attempt++) {
+        const uint32_t before = t->seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        uint32_t n = t->count;
+        if (n > SHMEM_PLANETS_MAX) n = SHMEM_PLANETS_MAX;
+        if (n > cap) n = cap;
+        if (obj)       memcpy(obj, t->obj_addr, n * sizeof(uint64_t));
+        if (owner)     memcpy(owner, t->owner, n * sizeof(int32_t));
+        if (tech)      memcpy(tech, t->tech, n * sizeof(int32_t));
+        if (buildings) memcpy(buildings, t->buildings, n * sizeof(int32_t));
+        if (flags)     memcpy(flags, t->flags, n);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (t->seq.load(std::memory_order_relaxed) == before) return (int)n;
+    }
+    return -1;
+}
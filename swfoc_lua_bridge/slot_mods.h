@@ -0,0 +1,131 @@
+#pragma once
+// slot_mods.h -- per-player-slot economy and combat modifiers that engine
+// detours consult directly.
+//
+// The LIVE hot-path knobs were globals (g_creditsMult_global,
+// g_creditsFreeze_global, g_fireRateMult_global); their per-slot
+// counterparts sat in lock-guarded maps no detour could afford to touch.
+// This table gives every slot one cache-line-aligned block of atomics:
+//
+//   * A detour that knows the owner slot does one relaxed load of
+//     `slotsActive` (bit s = slot s has something non-neutral) and, only
+//     when that bit is set, indexes the slot's block. No lock, no hashing,
+//     and a write to one slot never shares a line with another slot.
+//   * Writers (Lua helpers, any thread) store the value first and only then
+//     publish the presence bits (sequentially consistent RMWs -- writes are
+//     rare), so a detour that sees a bit also sees a value at least that
+//     new. A detour racing a write sees the old or the new multiplier.
+//   * Multipliers use 1.0 as "no override"; freeze is a flag bit only.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdint>
+
+#define SLOT_MODS_SLOTS 16
+
+enum SlotModField : uint32_t {
+    SLOT_MOD_INCOME         = 1u << 0,  // AddCredits: positive deltas scaled
+    SLOT_MOD_BUILD_SPEED    = 1u << 1,
+    SLOT_MOD_FIRE_RATE      = 1u << 2,
+    SLOT_MOD_DAMAGE         = 1u << 3,
+    SLOT_MOD_FREEZE_CREDITS = 1u << 4,  // AddCredits: every delta dropped
+};
+
+struct alignas(64) SlotModifiers {
+    std::atomic<float>    income;
+    std::atomic<float>    buildSpeed;
+    std::atomic<float>    fireRate;
+    std::atomic<float>    damage;
+    std::atomic<uint32_t> active;  // SlotModField bits that are non-neutral
+};
+
+struct SlotModifierTable {
+    std::atomic<uint32_t> slotsActive;  // bit s = slots[s].active != 0
+    SlotModifiers         slots[SLOT_MODS_SLOTS];
+};
+
+inline void SlotModInit(SlotModifierTable* t) {
+    for (auto& s : t->slots) {
+        s.income.store(1.0f, std::memory_order_relaxed);
+        s.buildSpeed.store(1.0f, std::memory_order_relaxed);
+        s.fireRate.store(1.0f, std::memory_order_relaxed);
+        s.damage.store(1.0f, std::memory_order_relaxed);
+        s.active.store(0, std::memory_order_relaxed);
+    }
+    t->slotsActive.store(0, std::memory_order_relaxed);
+}
+
+inline bool SlotModSlotOk(int slot) { return slot >= 0 && slot < SLOT_MODS_SLOTS; }
+
+inline std::atomic<float>* SlotModValue(SlotModifiers* s, uint32_t field) {
+    switch (field) {
+    case SLOT_MOD_INCOME:      return &s->income;
+    case SLOT_MOD_BUILD_SPEED: return &s->buildSpeed;
+    case SLOT_MOD_FIRE_RATE:   return &s->fireRate;
+    case SLOT_MOD_DAMAGE:      return &s->damage;
+    default:                   return nullptr;
+    }
+}
+
+// A writer that clears the slot's last field re-checks after dropping the
+// slot bit, so a concurrent writer setting another field never ends up
+// with its field hidden behind a clear slot bit.
+inline void SlotModPublish(SlotModifierTable* t, int slot, uint32_t field, bool on) {
+    SlotModifiers* s = &t->slots[slot];
+    const uint32_t bit = 1u << slot;
+    if (on) {
+        s->active.fetch_or(field);
+        t->slotsActive.fetch_or(bit);
+        return;
+    }
+    if ((s->active.fetch_and(~field) & ~field) != 0) return;
+    t->slotsActive.fetch_and(~bit);
+    if (s->active.load() != 0) t->slotsActive.fetch_or(bit);
+}
+
+// Sets one multiplier field. False for a bad slot or a non-multiplier field.
+inline bool SlotModSet(SlotModifierTable* t, int slot, uint32_t field, float value) {
+    if (!SlotModSlotOk(slot)) return false;
+    std::atomic<float>* v = SlotModValue(&t->slots[slot], field);
+    if (!v) return false;
+    v->store(value, std::memory_order_relaxed);
+    SlotModPublish(t, slot, field, value != 1.0f);
+    return true;
+}
+
+inline bool SlotModSetFreeze(SlotModifierTable* t, int slot, bool frozen) {
+    if (!SlotModSlotOk(slot)) return false;
+    SlotModPublish(t, slot, SLOT_MOD_FREEZE_CREDITS, frozen);
+    return true;
+}
+
+inline float SlotModGet(const SlotModifierTable* t, int slot, uint32_t field) {
+    if (!SlotModSlotOk(slot)) return 1.0f;
+    const std::atomic<float>* v = SlotModValue(const_cast<SlotModifiers*>(&t->slots[slot]), field);
+    return v ? v->load(std::memory_order_relaxed) : 1.0f;
+}
+
+inline bool SlotModFrozen(const SlotModifierTable* t, int slot) {
+    return SlotModSlotOk(slot) &&
+           (t->slots[slot].active.load(std::memory_order_relaxed) & SLOT_MOD_FREEZE_CREDITS) != 0;
+}
+
+// Detour fast path: the slot's block when it has any modifier, else nullptr.
+inline const SlotModifiers* SlotModActive(const SlotModifierTable* t, int slot) {
+    if (!SlotModSlotOk(slot)) return nullptr;
+    if (!((t->slotsActive.load(std::memory_order_acquire) >> slot) & 1u)) return nullptr;
+    return &t->slots[slot];
+}
+
+// AddCredits rule for one slot: false when the slot's credits are frozen
+// (drop the call); otherwise a positive *delta is scaled by the slot's
+// income multiplier. Spends are never scaled, as for the global knob.
+inline bool SlotModApplyCredits(const SlotModifierTable* t, int slot, float* delta) {
+    const SlotModifiers* s = SlotModActive(t, slot);
+    if (!s) return true;
+    const uint32_t active = s->active.load(std::memory_order_acquire);
+    if (active & SLOT_MOD_FREEZE_CREDITS) return false;
+    if ((active & SLOT_MOD_INCOME) && *delta > 0.0f) *delta *= s->income.load(std::memory_order_relaxed);
+    return true;
+}
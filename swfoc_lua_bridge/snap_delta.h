@@ -0,0 +1,240 @@
+#pragma once
+// snap_delta.h -- v4 delta .swfocsnap files against a base capture.
+//
+// Timeline captures a few seconds apart differ in a handful of credits, hull
+// values and selections, so a delta stores only what changed since a base
+// capture (see SNAPSHOT_FORMAT.md, "v4 Delta Snapshots"):
+//
+//   * Section 0 (delta_base) names the base: its capture_timestamp_ms and the
+//     CRC32 from its end marker. The engine_build_hash in the header must
+//     equal the base's.
+//   * A section identical to the base's is omitted. A base section the new
+//     capture no longer has is listed as an empty SNAP_SECTION_DROP section.
+//   * A keyed section (SnapFindKeyedLayout) may be stored as a
+//     SNAP_SECTION_PATCH: the new prefix (record counts), then one op per new
+//     record -- copy the base record with this key, or a literal record.
+//     Anything else that changed is stored whole, as in v2.
+//
+// The end-marker CRC covers the reconstructed full stream, so a reader that
+// applies the delta to the wrong base, or applies it wrongly, fails the CRC.
+// A base may itself be a delta: reconstruct it first.
+//
+// SnapDeltaPatch and SnapDeltaReconstruct run on expanded (LZ4-free)
+// streams. make_test_snapshot.py carries a Python twin. Header-only and
+// Win32-free; shared by lua_bridge.cpp, replay_harness.cpp and
+// test_harness.cpp.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "snap_lz4.h"
+
+#define SNAP_SECTION_PATCH    0x02000000u  // payload: new prefix, then record ops
+#define SNAP_SECTION_DROP     0x04000000u  // empty payload: the base section is gone
+#define SNAP_DELTA_BASE_ID    0u           // u64 base_timestamp_ms, u32 base_crc32
+#define SNAP_DELTA_OP_COPY    0            // + key[keyLen]: the base record with this key
+#define SNAP_DELTA_OP_LITERAL 1            // + the record itself
+
+// Record layout of a section whose records carry a key in their first bytes.
+struct SnapKeyedLayout {
+    uint32_t id;
+    size_t   prefix;       // bytes ahead of the first record (counts)
+    size_t   fixed;        // fixed bytes per record
+    size_t   varCountOff;  // u32 element count inside the record; 0 = none
+    size_t   varElem;      // bytes per variable element
+    size_t   keyLen;       // the key is the record's first keyLen bytes
+};
+
+inline const SnapKeyedLayout* SnapFindKeyedLayout(uint32_t id) {
+    static const SnapKeyedLayout kLayouts[] = {
+        {  1, 8, 144,  0, 0,  4 },  // player_array by slot (count + local_slot)
+        {  3, 4,  68,  0, 0, 64 },  // object_catalog by type_name
+        {  4, 4,  80,  0, 0, 64 },  // global_registry by name
+        {  6, 4,  72,  0, 0, 64 },  // planet_state by planet name
+        { 12, 4,  92, 88, 4,  8 },  // unit_detail by obj_addr
+        { 14, 4,  20,  0, 0,  8 },  // unit_position by obj_addr
+    };
+    for (const SnapKeyedLayout& l : kLayouts) {
+        if (l.id == id) return &l;
+    }
+    return nullptr;
+}
+
+// Length of the record at p, or 0 if it does not fit in avail bytes.
+inline size_t SnapKeyedRecordLen(const SnapKeyedLayout& l, const uint8_t* p, size_t avail) {
+    if (avail < l.fixed) return 0;
+    size_t len = l.fixed;
+    if (l.varCountOff) {
+        uint32_t n;
+        memcpy(&n, p + l.varCountOff, 4);
+        if ((avail - l.fixed) / l.varElem < n) return 0;
+        len += static_cast<size_t>(n) * l.varElem;
+    }
+    return len;
+}
+
+// Maps each key to its first record's payload offset. False if the payload
+// does not split into whole records.
+inline bool SnapIndexRecords(const SnapKeyedLayout& l, const uint8_t* p, size_t n,
+                             std::map<std::string, size_t>* out) {
+    if (n < l.prefix) return false;
+    for (size_t pos = l.prefix; pos < n;) {
+        const size_t len = SnapKeyedRecordLen(l, p + pos, n - pos);
+        if (!len) return false;
+        out->emplace(std::string(reinterpret_cast<const char*>(p + pos), l.keyLen), pos);
+        pos += len;
+    }
+    return true;
+}
+
+// Builds the PATCH payload that turns base into cur. False if either payload
+// does not split into records.
+inline bool SnapDeltaPatch(const SnapKeyedLayout& l, const uint8_t* base, size_t baseLen,
+                           const uint8_t* cur, size_t curLen, std::vector<uint8_t>* out) {
+    std::map<std::string, size_t> index;
+    if (!SnapIndexRecords(l, base, baseLen, &index) || curLen < l.prefix) return false;
+    out->assign(cur, cur + l.prefix);
+    for (size_t pos = l.prefix; pos < curLen;) {
+        const size_t len = SnapKeyedRecordLen(l, cur + pos, curLen - pos);
+        if (!len) return false;
+        auto it = index.find(std::string(reinterpret_cast<const char*>(cur + pos), l.keyLen));
+        const bool same = it != index.end()
+            && SnapKeyedRecordLen(l, base + it->second, baseLen - it->second) == len
+            && memcmp(base + it->second, cur + pos, len) == 0;
+        out->push_back(same ? SNAP_DELTA_OP_COPY : SNAP_DELTA_OP_LITERAL);
+        out->insert(out->end(), cur + pos, cur + pos + (same ? l.keyLen : len));
+        pos += len;
+    }
+    return true;
+}
+
+// Appends base with the PATCH payload applied. Returns nullptr, or what was
+// wrong.
+inline const char* SnapDeltaApplyPatch(const SnapKeyedLayout& l, const uint8_t* base, size_t baseLen,
+                                       const uint8_t* patch, size_t patchLen,
+                                       std::vector<uint8_t>* out) {
+    std::map<std::string, size_t> index;
+    if (!SnapIndexRecords(l, base, baseLen, &index)) return "patched base section does not split into records";
+    if (patchLen < l.prefix) return "patch shorter than its section prefix";
+    out->insert(out->end(), patch, patch + l.prefix);
+    for (size_t pos = l.prefix; pos < patchLen;) {
+        const uint8_t op = patch[pos++];
+        if (op == SNAP_DELTA_OP_COPY) {
+            if (patchLen - pos < l.keyLen) return "patch copy op truncated";
+            auto it = index.find(std::string(reinterpret_cast<const char*>(patch + pos), l.keyLen));
+            if (it == index.end()) return "patch copies a key the base does not have";
+            const uint8_t* rec = base + it->second;
+            out->insert(out->end(), rec, rec + SnapKeyedRecordLen(l, rec, baseLen - it->second));
+            pos += l.keyLen;
+        } else if (op == SNAP_DELTA_OP_LITERAL) {
+            const size_t len = SnapKeyedRecordLen(l, patch + pos, patchLen - pos);
+            if (!len) return "patch literal record truncated";
+            out->insert(out->end(), patch + pos, patch + pos + len);
+            pos += len;
+        } else {
+            return "unknown patch op";
+        }
+    }
+    return nullptr;
+}
+
+struct SnapSectionRef {
+    uint32_t id;   // as stored, flags included
+    size_t   off;  // offset of the section header
+    uint32_t len;  // payload bytes
+};
+
+// Lists the sections of an expanded stream up to its end marker, whose
+// offset lands in *endOff. Returns nullptr, or what was wrong.
+inline const char* SnapIndexSections(const uint8_t* s, size_t n, size_t headerBytes,
+                                     std::vector<SnapSectionRef>* out, size_t* endOff) {
+    out->clear();
+    for (size_t pos = headerBytes; n >= pos + 8;) {
+        SnapSectionRef ref;
+        memcpy(&ref.id, s + pos, 4);
+        memcpy(&ref.len, s + pos + 4, 4);
+        if (ref.id == SNAP_END_SECTION_ID) {
+            if (n - pos < 12) return "CRC32 truncated";
+            *endOff = pos;
+            return nullptr;
+        }
+        if (n - pos - 8 < ref.len) return "section payload runs past end of stream";
+        ref.off = pos;
+        out->push_back(ref);
+        pos += 8 + static_cast<size_t>(ref.len);
+    }
+    return "end marker missing";
+}
+
+inline uint64_t SnapStreamTimestamp(const uint8_t* s) {
+    uint64_t ts;
+    memcpy(&ts, s + 0x14, 8);
+    return ts;
+}
+
+// The CRC32 stored after the end marker of a full stream of n bytes.
+inline uint32_t SnapStreamCrc(const uint8_t* s, size_t n) {
+    uint32_t crc;
+    memcpy(&crc, s + n - 4, 4);
+    return crc;
+}
+
+// Rebuilds the full stream of an expanded v4 delta from its base's full
+// stream. Checks the base reference, not the CRC. Returns nullptr, or what
+// was wrong.
+inline const char* SnapDeltaReconstruct(const uint8_t* base, size_t baseLen,
+                                        const uint8_t* delta, size_t deltaLen,
+                                        size_t headerBytes, std::vector<uint8_t>* out) {
+    std::vector<SnapSectionRef> bs, ds;
+    size_t baseEnd = 0, deltaEnd = 0;
+    if (baseLen < headerBytes || deltaLen < headerBytes) return "header truncated";
+    if (const char* err = SnapIndexSections(base, baseLen, headerBytes, &bs, &baseEnd)) return err;
+    if (const char* err = SnapIndexSections(delta, deltaLen, headerBytes, &ds, &deltaEnd)) return err;
+    if (ds.empty() || ds[0].id != SNAP_DELTA_BASE_ID || ds[0].len != 12) return "delta_base section missing";
+    uint64_t baseTs;
+    uint32_t baseCrc;
+    memcpy(&baseTs, delta + ds[0].off + 8, 8);
+    memcpy(&baseCrc, delta + ds[0].off + 16, 4);
+    if (baseTs != SnapStreamTimestamp(base) || baseCrc != SnapStreamCrc(base, baseLen)
+        || memcmp(base + 0x1C, delta + 0x1C, 32) != 0) {
+        return "base capture does not match the delta's reference";
+    }
+
+    out->assign(delta, delta + headerBytes);
+    size_t i = 0, j = 0;
+    while (i < bs.size() && bs[i].id == SNAP_DELTA_BASE_ID) i++;  // a delta base's own reference
+    while (i < bs.size() || j < ds.size()) {
+        const uint32_t dId = j < ds.size() ? (ds[j].id & SNAP_SECTION_ID_MASK) : SNAP_END_SECTION_ID;
+        if (i < bs.size() && bs[i].id < dId) {  // unchanged
+            const uint8_t* sec = base + bs[i].off;
+            out->insert(out->end(), sec, sec + 8 + bs[i].len);
+            i++;
+            continue;
+        }
+        const SnapSectionRef& d = ds[j++];
+        const SnapSectionRef* b = (i < bs.size() && bs[i].id == dId) ? &bs[i++] : nullptr;
+        const uint8_t* payload = delta + d.off + 8;
+        if (d.id & SNAP_SECTION_DROP) {
+            if (!b) return "delta drops a section the base does not have";
+        } else if (d.id & SNAP_SECTION_PATCH) {
+            const SnapKeyedLayout* l = SnapFindKeyedLayout(dId);
+            if (!b || !l) return "delta patches a section the base does not have";
+            const size_t at = out->size();
+            out->resize(at + 8);
+            if (const char* err = SnapDeltaApplyPatch(*l, base + b->off + 8, b->len, payload, d.len, out)) {
+                return err;
+            }
+            const uint32_t len = static_cast<uint32_t>(out->size() - at - 8);
+            memcpy(out->data() + at, &dId, 4);
+            memcpy(out->data() + at + 4, &len, 4);
+        } else {
+            out->insert(out->end(), payload - 8, payload + d.len);
+        }
+    }
+    out->insert(out->end(), delta + deltaEnd, delta + deltaEnd + 12);  // end marker + CRC
+    return nullptr;
+}
@@ -0,0 +1,102 @@
+#pragma once
+// snap_index.h -- optional section index after a .swfocsnap's CRC.
+//
+// Sections chain with no table of contents, so a reader after section 12
+// walks, and CRCs, everything ahead of it. SWFOC_DumpState appends a section
+// index after the end marker's CRC32 (see SNAPSHOT_FORMAT.md, "Section
+// Index"):
+//
+//   u32 section_id = SNAP_INDEX_SECTION_ID, u32 section_length
+//   u32 header_crc32   CRC32 of the file bytes ahead of the first section
+//   entry[n]           u32 section_id (as stored, flags included), u32 file
+//                      offset of the section header, u32 payload length,
+//                      u32 CRC32 of the payload as stored
+//   u32 index_crc32    CRC32 of the index, section_id up to this field
+//   u32 index_bytes    size of the index, section_id up to and including this
+//
+// A reader takes index_bytes from the last 4 bytes of the file, checks the
+// index, then seeks straight to the sections it wants and checks each
+// against its entry. The index lies outside the stream the end-marker CRC
+// covers: readers that stop at the end marker never see it, and a v3 / v4
+// image expands without it (its offsets describe the file as stored).
+//
+// The caller supplies the CRC function. make_test_snapshot.py carries a
+// Python twin. Header-only and Win32-free; shared by lua_bridge.cpp,
+// replay_harness.cpp and test_harness.cpp.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define SNAP_INDEX_SECTION_ID  0xFFFFFFFEu
+#define SNAP_INDEX_ENTRY_BYTES 16
+#define SNAP_INDEX_FIXED_BYTES 20  // section header + header_crc32 + index_crc32 + index_bytes
+
+typedef uint32_t (*SnapCrcFn)(uint32_t crc, const void* data, size_t len);
+
+struct SnapIndexEntry {
+    uint32_t id;   // as stored, flags included
+    uint32_t off;  // offset of the section header in the file
+    uint32_t len;  // payload bytes as stored
+    uint32_t crc;  // CRC32 of the payload as stored
+};
+
+// Appends the index for entries to out.
+inline void SnapPutIndex(SnapCrcFn crcFn, uint32_t headerCrc,
+                         const std::vector<SnapIndexEntry>& entries, std::vector<uint8_t>* out) {
+    const size_t at = out->size();
+    const uint32_t bytes = static_cast<uint32_t>(SNAP_INDEX_FIXED_BYTES
+                                                 + entries.size() * SNAP_INDEX_ENTRY_BYTES);
+    const uint32_t head[3] = { SNAP_INDEX_SECTION_ID, bytes - 8, headerCrc };
+    out->resize(at + bytes);
+    uint8_t* p = out->data() + at;
+    memcpy(p, head, sizeof(head));
+    for (size_t i = 0; i < entries.size(); i++) {
+        const uint32_t e[4] = { entries[i].id, entries[i].off, entries[i].len, entries[i].crc };
+        memcpy(p + 12 + i * SNAP_INDEX_ENTRY_BYTES, e, sizeof(e));
+    }
+    const uint32_t crc = crcFn(0, p, bytes - 8);
+    memcpy(p + bytes - 8, &crc, 4);
+    memcpy(p + bytes - 4, &bytes, 4);
+}
+
+// Size of the index the n-byte file ends with, or 0 if it does not end with
+// one. Checks the framing only, not the CRCs.
+inline size_t SnapIndexLength(const uint8_t* file, size_t n) {
+    if (n < 68 + 12 + SNAP_INDEX_FIXED_BYTES) return 0;
+    uint32_t bytes, id, len;
+    memcpy(&bytes, file + n - 4, 4);
+    if (bytes < SNAP_INDEX_FIXED_BYTES || bytes > n - 68 - 12
+        || (bytes - SNAP_INDEX_FIXED_BYTES) % SNAP_INDEX_ENTRY_BYTES != 0) {
+        return 0;
+    }
+    memcpy(&id, file + n - bytes, 4);
+    memcpy(&len, file + n - bytes + 4, 4);
+    return id == SNAP_INDEX_SECTION_ID && len == bytes - 8 ? bytes : 0;
+}
+
+// Reads and checks the index of an n-byte file: its own CRC, and that every
+// entry lies ahead of it. Returns nullptr, or what was wrong.
+inline const char* SnapReadIndex(const uint8_t* file, size_t n, SnapCrcFn crcFn,
+                                 uint32_t* headerCrc, std::vector<SnapIndexEntry>* out) {
+    out->clear();
+    const size_t bytes = SnapIndexLength(file, n);
+    if (!bytes) return "no section index";
+    const uint8_t* p = file + n - bytes;
+    uint32_t crc;
+    memcpy(&crc, p + bytes - 8, 4);
+    if (crcFn(0, p, bytes - 8) != crc) return "section index CRC32 mismatch";
+    memcpy(headerCrc, p + 8, 4);
+    const size_t count = (bytes - SNAP_INDEX_FIXED_BYTES) / SNAP_INDEX_ENTRY_BYTES;
+    for (size_t i = 0; i < count; i++) {
+        SnapIndexEntry e;
+        memcpy(&e, p + 12 + i * SNAP_INDEX_ENTRY_BYTES, sizeof(e));
+        if (e.off < 68 || static_cast<size_t>(e.off) + 8 + e.len > n - bytes) {
+            out->clear();
+            return "section index entry lies outside the file";
+        }
+        out->push_back(e);
+    }
+    return nullptr;
+}
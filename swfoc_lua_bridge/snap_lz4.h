@@ -0,0 +1,185 @@
+#pragma once
+// snap_lz4.h -- LZ4 block codec for v3 .swfocsnap sections.
+//
+// v3 snapshots may store a section's payload LZ4-compressed (see
+// SNAPSHOT_FORMAT.md, "v3 compressed sections"). Unit-detail and hardpoint
+// records are mostly zero padding and repeated pointers, which LZ4 packs
+// well, and the block format is small enough to carry here instead of
+// vendoring a library into both the DLL and the replay harness:
+//
+//   * SnapLz4Compress: greedy single-pass matcher over a 4096-entry hash of
+//     4-byte sequences. Emits standard LZ4 block format (the last 5 bytes are
+//     literals, no match starts in the last 12), so any LZ4 decoder reads it.
+//     Returns 0 when the output would not fit in `cap`.
+//   * SnapLz4Decompress: bounds-checked decoder. Fails on a truncated
+//     stream, an offset before the output start, or a size other than
+//     `rawLen`. Never writes past `rawLen`.
+//
+//   * SnapLz4ExpandSections: turns a v3 file image back into the v2-framed
+//     stream the CRC covers, so readers parse v3 with their v2 code.
+//
+// make_test_snapshot.py carries a Python twin of all three. Header-only and
+// Win32-free; shared by lua_bridge.cpp, replay_harness.cpp and
+// test_harness.cpp.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define SNAP_LZ4_HASH_BITS 12
+#define SNAP_END_SECTION_ID  0xFFFFFFFFu
+#define SNAP_SECTION_LZ4     0x01000000u  // section_id flag: payload is u32 raw_length + LZ4 block
+#define SNAP_SECTION_ID_MASK 0x00FFFFFFu
+#define SNAP_LZ4_MIN_SECTION 64           // smaller payloads are always stored raw
+
+// Worst-case compressed size for n input bytes.
+inline size_t SnapLz4Bound(size_t n) { return n + n / 255 + 16; }
+
+inline bool SnapLz4PutLength(uint8_t*& op, const uint8_t* end, size_t len) {
+    while (len >= 255) {
+        if (op >= end) return false;
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= end) return false;
+    *op++ = static_cast<uint8_t>(len);
+    return true;
+}
+
+// One sequence: literals [lit, lit + litLen), then a match of matchLen
+// bytes at `offset` back (matchLen == 0: final literals-only sequence).
+inline bool SnapLz4PutSequence(uint8_t*& op, const uint8_t* end, const uint8_t* lit,
+                               size_t litLen, uint32_t offset, size_t matchLen) {
+    if (op >= end) return false;
+    uint8_t* token = op++;
+    const size_t ml = matchLen ? matchLen - 4 : 0;
+    *token = static_cast<uint8_t>(((litLen >= 15 ? 15 : litLen) << 4) | (ml >= 15 ? 15 : ml));
+    if (litLen >= 15 && !SnapLz4PutLength(op, end, litLen - 15)) return false;
+    if (static_cast<size_t>(end - op) < litLen) return false;
+    memcpy(op, lit, litLen);
+    op += litLen;
+    if (!matchLen) return true;
+    if (end - op < 2) return false;
+    *op++ = static_cast<uint8_t>(offset & 0xFF);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    return ml < 15 || SnapLz4PutLength(op, end, ml - 15);
+}
+
+inline size_t SnapLz4Compress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap) {
+    const size_t kLastLiterals = 5;
+    const size_t kMatchLimit = 12;  // no match may start in the last 12 bytes
+    uint32_t table[1u << SNAP_LZ4_HASH_BITS];
+    memset(table, 0, sizeof(table));  // entries are position + 1; 0 = empty
+
+    uint8_t* op = dst;
+    const uint8_t* end = dst + cap;
+    size_t anchor = 0;
+    size_t ip = 0;
+    while (ip + kMatchLimit <= n) {
+        uint32_t seq;
+        memcpy(&seq, src + ip, 4);
+        const uint32_t h = (seq * 2654435761u) >> (32 - SNAP_LZ4_HASH_BITS);
+        const uint32_t slot = table[h];
+        table[h] = static_cast<uint32_t>(ip + 1);
+        if (slot) {
+            const size_t ref = slot - 1;
+            uint32_t refSeq;
+            memcpy(&refSeq, src + ref, 4);
+            if (ip - ref <= 0xFFFF && refSeq == seq) {
+                size_t len = 4;
+                while (ip + len < n - kLastLiterals && src[ref + len] == src[ip + len]) len++;
+                if (!SnapLz4PutSequence(op, end, src + anchor, ip - anchor,
+                                        static_cast<uint32_t>(ip - ref), len)) {
+                    return 0;
+                }
+                ip += len;
+                anchor = ip;
+                continue;
+            }
+        }
+        ip++;
+    }
+    if (!SnapLz4PutSequence(op, end, src + anchor, n - anchor, 0, 0)) return 0;
+    return static_cast<size_t>(op - dst);
+}
+
+inline bool SnapLz4GetLength(const uint8_t*& ip, const uint8_t* end, size_t* len) {
+    uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        *len += b;
+    } while (b == 255);
+    return true;
+}
+
+inline bool SnapLz4Decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t rawLen) {
+    const uint8_t* ip = src;
+    const uint8_t* end = src + n;
+    size_t out = 0;
+    while (ip < end) {
+        const uint8_t token = *ip++;
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !SnapLz4GetLength(ip, end, &litLen)) return false;
+        if (static_cast<size_t>(end - ip) < litLen || rawLen - out < litLen) return false;
+        memcpy(dst + out, ip, litLen);
+        ip += litLen;
+        out += litLen;
+        if (ip == end) break;  // final sequence carries literals only
+
+        if (end - ip < 2) return false;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > out) return false;
+        size_t matchLen = token & 15;
+        if (matchLen == 15 && !SnapLz4GetLength(ip, end, &matchLen)) return false;
+        matchLen += 4;
+        if (rawLen - out < matchLen) return false;
+        for (size_t i = 0; i < matchLen; i++, out++) dst[out] = dst[out - offset];
+    }
+    return out == rawLen;
+}
+
+// Copies the file header and every section of a v3 / v4 image into out,
+// inflating compressed payloads and clearing their flag, up to and including the end
+// marker and the CRC after it; a section index after the CRC (snap_index.h)
+// describes the file, not the expanded stream, and is left out. Returns
+// nullptr, or what was wrong.
+inline const char* SnapLz4ExpandSections(const uint8_t* file, size_t n, size_t headerBytes,
+                                         std::vector<uint8_t>* out) {
+    if (n < headerBytes) return "header truncated";
+    out->assign(file, file + headerBytes);
+    size_t pos = headerBytes;
+    while (n - pos >= 8) {
+        uint32_t id, len;
+        memcpy(&id, file + pos, 4);
+        memcpy(&len, file + pos + 4, 4);
+        if (id == SNAP_END_SECTION_ID) {
+            out->insert(out->end(), file + pos, file + pos + (n - pos < 12 ? n - pos : 12));
+            return nullptr;
+        }
+        if (n - pos - 8 < len) return "section payload runs past end of file";
+        const uint8_t* payload = file + pos + 8;
+        if (!(id & SNAP_SECTION_LZ4)) {
+            out->insert(out->end(), file + pos, payload + len);
+        } else {
+            uint32_t rawLen;
+            if (len < 4) return "compressed section shorter than its raw_length";
+            memcpy(&rawLen, payload, 4);
+            if (rawLen > static_cast<size_t>(len - 4) * 255) {  // LZ4 inflates at most ~255x
+                return "compressed section claims an impossible raw_length";
+            }
+            const uint32_t bare = id & ~SNAP_SECTION_LZ4;  // v4 keeps its delta flags
+            const size_t at = out->size();
+            out->resize(at + 8 + rawLen);
+            memcpy(out->data() + at, &bare, 4);
+            memcpy(out->data() + at + 4, &rawLen, 4);
+            if (!SnapLz4Decompress(payload + 4, len - 4, out->data() + at + 8, rawLen)) {
+                return "compressed section does not decode to its raw_length";
+            }
+        }
+        pos += 8 + static_cast<size_t>(len);
+    }
+    return "end marker missing";
+}
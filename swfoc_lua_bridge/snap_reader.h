@@ -0,0 +1,598 @@
+#pragma once
+// snap_reader.h -- the .swfocsnap parser, from bytes in memory.
+//
+// swfoc_replay.exe maps a file (or rebuilds its stream) and hands the bytes
+// here; snapshot_fuzz.cpp hands them straight from the fuzzer. Nothing in
+// this file opens, maps or allocates a file, so a fuzz iteration is the
+// parse and nothing else:
+//
+//   * ParseSnapshotHeader / ParseSnapshotSection decode the 68-byte header
+//     and one section payload (SNAPSHOT_FORMAT.md). Every count and length
+//     is checked against what is left of the buffer before it is used.
+//   * SnapDecodeStream walks an expanded v1 .. v4 stream: header, section
+//     list, end-marker CRC, then the selected sections. DecodeIndexedSection
+//     decodes one section through its section index entry (snap_index.h).
+//   * Tables a section fills are cleared and refilled in place, so one
+//     ReplayState reused across loads keeps its storage;
+//     ReplayClearSnapshot empties them all the same way between loads.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code; file
+// mapping, v3 / v4 expansion and the CLI stay in replay_harness.cpp.
+// Not thread-safe: one state per caller.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "crc32.h"
+#include "replay_state.h"
+#include "snap_delta.h"
+#include "snap_index.h"
+#include "snap_lz4.h"
+
+// Crc32_Update comes from crc32.h, the same code the live bridge writer
+// uses (polynomial 0xEDB88320, reflected, init/xor 0xFFFFFFFF).
+inline uint32_t Crc32_Compute(const void* data, size_t len) {
+    return Crc32_Update(0, data, len);
+}
+
+// Small cursor over a raw byte buffer, little-endian reads.
+class SnapCursor {
+public:
+    SnapCursor(const uint8_t* data, size_t size) : p_(data), size_(size) {}
+
+    bool ok() const { return ok_; }
+    size_t pos() const { return off_; }
+    size_t remaining() const { return off_ < size_ ? size_ - off_ : 0; }
+
+    bool read_bytes(void* out, size_t n) {
+        if (!ok_) return false;
+        if (off_ + n > size_) { ok_ = false; return false; }
+        memcpy(out, p_ + off_, n);
+        off_ += n;
+        return true;
+    }
+
+    bool read_u8 (uint8_t*  v) { return read_bytes(v, 1); }
+    bool read_u16(uint16_t* v) { return read_bytes(v, 2); }
+    bool read_u32(uint32_t* v) { return read_bytes(v, 4); }
+    bool read_u64(uint64_t* v) { return read_bytes(v, 8); }
+    bool read_i32(int32_t*  v) { return read_bytes(v, 4); }
+    bool read_f64(double*   v) { return read_bytes(v, 8); }
+
+    bool skip(size_t n) {
+        if (!ok_) return false;
+        if (off_ + n > size_) { ok_ = false; return false; }
+        off_ += n;
+        return true;
+    }
+
+    // Read a fixed-width, null-padded ASCII field and trim at the first null.
+    // A NUL-padded field of `width` bytes, assigned in place so a reused
+    // `out` keeps its buffer.
+    bool read_fixed_str(std::string* out, size_t width) {
+        if (!ok_) return false;
+        if (off_ + width > size_) { ok_ = false; return false; }
+        const char* s = reinterpret_cast<const char*>(p_ + off_);
+        out->assign(s, strnlen(s, width));
+        off_ += width;
+        return true;
+    }
+
+private:
+    const uint8_t* p_;
+    size_t         size_ = 0;
+    size_t         off_  = 0;
+    bool           ok_   = true;
+};
+
+struct SnapshotLoadResult {
+    bool        ok = false;
+    std::string error;
+    size_t      total_bytes = 0;
+    size_t      sections_total = 0;   // sections in the stream
+    size_t      sections_loaded = 0;  // of those, decoded into ReplayState
+    bool        indexed = false;      // read through the section index
+};
+
+// Bit `id` of a LoadSnapshot section mask selects section `id`.
+#define REPLAY_SECTION(id)   (1u << (id))
+#define REPLAY_ALL_SECTIONS  0xFFFFFFFFu
+
+// Decodes one section payload into `out`. Unknown ids are skipped. Returns
+// false with *err set when the payload is malformed.
+inline bool ParseSnapshotSection(uint32_t section_id, const uint8_t* payload, uint32_t section_len,
+                                 ReplayState& out, std::string* err) {
+    SnapCursor c(payload, section_len);
+    if (section_id == 1) {
+        // player_array
+        uint32_t player_count = 0;
+        if (!c.read_u32(&player_count)) { *err = "player_count truncated"; return false; }
+        // Defensive clamp (capture already clamps to 8).
+        if (player_count > 4096) {
+            *err = "player_count out of sane bound (>4096)";
+            return false;
+        }
+        // v2 addition: explicit local_slot. Read only when format_version
+        // says so. v1 snapshots derive the local slot from the first
+        // player after the loop.
+        uint32_t explicit_local_slot = 0xFFFFFFFFu;
+        if (out.format_version >= 2) {
+            if (!c.read_u32(&explicit_local_slot)) {
+                *err = "local_slot truncated (v2)";
+                return false;
+            }
+        }
+        out.players.clear();
+        out.players.reserve(player_count);
+        for (uint32_t i = 0; i < player_count; i++) {
+            ReplayPlayer p;
+            if (!c.read_u32(&p.slot))                     { *err = "player slot truncated"; return false; }
+            if (!c.read_fixed_str(&p.faction_name, 64))   { *err = "player faction truncated"; return false; }
+            if (!c.read_f64(&p.credits))                  { *err = "player credits truncated"; return false; }
+            if (!c.read_i32(&p.tech_level))               { *err = "player tech_level truncated"; return false; }
+            if (!c.read_fixed_str(&p.player_name, 64))    { *err = "player name truncated"; return false; }
+            out.players.push_back(std::move(p));
+        }
+        // Resolve local_slot: v2 uses the explicit field; v1 falls back
+        // to the first player. UINT32_MAX means "no local player".
+        if (out.format_version >= 2) {
+            if (explicit_local_slot == 0xFFFFFFFFu) {
+                out.local_slot = -1;
+            } else {
+                out.local_slot = static_cast<int>(explicit_local_slot);
+            }
+        } else {
+            out.local_slot = out.players.empty()
+                ? -1
+                : static_cast<int>(out.players.front().slot);
+        }
+    } else if (section_id == 2) {
+        uint32_t state_count = 0;
+        if (!c.read_u32(&state_count)) { *err = "state_count truncated"; return false; }
+        if (state_count > 1024 * 64) {
+            *err = "state_count out of sane bound";
+            return false;
+        }
+        out.lua_state_ptrs.clear();
+        out.lua_state_ptrs.reserve(state_count);
+        for (uint32_t i = 0; i < state_count; i++) {
+            uint64_t ptr = 0;
+            if (!c.read_u64(&ptr)) { *err = "lua_state pointer truncated"; return false; }
+            out.lua_state_ptrs.push_back(ptr);
+        }
+    } else if (section_id == 3) {
+        uint32_t type_count = 0;
+        if (!c.read_u32(&type_count)) { *err = "object type_count truncated"; return false; }
+        if (type_count > 1024 * 1024) { *err = "object type_count out of sane bound"; return false; }
+        out.objects.mut().clear();
+        for (uint32_t i = 0; i < type_count; i++) {
+            std::string name;
+            uint32_t count = 0;
+            if (!c.read_fixed_str(&name, 64)) { *err = "object type name truncated"; return false; }
+            if (!c.read_u32(&count))          { *err = "object instance_count truncated"; return false; }
+            out.objects.mut()[name] = count;
+        }
+    } else if (section_id == 4) {
+        uint32_t global_count = 0;
+        if (!c.read_u32(&global_count)) { *err = "global_count truncated"; return false; }
+        if (global_count > 1024 * 1024) { *err = "global_count out of sane bound"; return false; }
+        out.globals.mut().clear();
+        for (uint32_t i = 0; i < global_count; i++) {
+            std::string name;
+            ReplayGlobal g{};
+            uint8_t pad[7];
+            if (!c.read_fixed_str(&name, 64)) { *err = "global name truncated"; return false; }
+            if (!c.read_u8(&g.lua_type))      { *err = "global lua_type truncated"; return false; }
+            if (!c.read_bytes(pad, 7))        { *err = "global pad truncated"; return false; }
+            if (!c.read_u64(&g.raw_value_or_ptr)) { *err = "global raw_value truncated"; return false; }
+            out.globals.mut()[name] = g;
+        }
+    } else if (section_id == 5) {
+        uint32_t entry_count = 0;
+        if (!c.read_u32(&entry_count)) { *err = "metadata entry_count truncated"; return false; }
+        if (entry_count > 65536) { *err = "metadata entry_count out of sane bound"; return false; }
+        out.metadata.mut().clear();
+        for (uint32_t i = 0; i < entry_count; i++) {
+            uint16_t kl = 0, vl = 0;
+            if (!c.read_u16(&kl)) { *err = "metadata key_length truncated"; return false; }
+            std::string k(kl, '\0');
+            if (kl && !c.read_bytes(&k[0], kl)) { *err = "metadata key truncated"; return false; }
+            if (!c.read_u16(&vl)) { *err = "metadata value_length truncated"; return false; }
+            std::string v(vl, '\0');
+            if (vl && !c.read_bytes(&v[0], vl)) { *err = "metadata value truncated"; return false; }
+            out.metadata.mut()[k] = v;
+        }
+    } else if (section_id == 6) {
+        // section 6: planet_state (added v2 extension, 2026-04-08)
+        // Layout:
+        //   uint32 planet_count
+        //   for i in 0..planet_count:
+        //       char    name[64]
+        //       float32 corruption
+        //       int32   owner_slot   (-1 = no owner)
+        uint32_t planet_count = 0;
+        if (!c.read_u32(&planet_count)) { *err = "planet_count truncated"; return false; }
+        if (planet_count > 4096) { *err = "planet_count out of sane bound"; return false; }
+        out.planets.mut().clear();
+        for (uint32_t i = 0; i < planet_count; i++) {
+            std::string name;
+            if (!c.read_fixed_str(&name, 64)) { *err = "planet name truncated"; return false; }
+            uint32_t corr_bits = 0;
+            if (!c.read_u32(&corr_bits)) { *err = "planet corruption truncated"; return false; }
+            int32_t owner = 0;
+            if (!c.read_i32(&owner))     { *err = "planet owner truncated"; return false; }
+            ReplayPlanetInfo info;
+            info.name = name;
+            memcpy(&info.corruption, &corr_bits, 4);
+            info.owner_slot = owner;
+            out.planets.mut()[ReplayUpper(name)] = info;
+        }
+    } else if (section_id == 7) {
+        // section 7: diplomacy (added v2 extension, 2026-04-08)
+        // Layout:
+        //   uint32 pair_count
+        //   for i in 0..pair_count:
+        //       char  faction_a[32]
+        //       char  faction_b[32]
+        //       char  state[16]      // "allied" / "hostile" / "neutral"
+        uint32_t pair_count = 0;
+        if (!c.read_u32(&pair_count)) { *err = "diplomacy pair_count truncated"; return false; }
+        if (pair_count > 4096) { *err = "diplomacy pair_count out of sane bound"; return false; }
+        out.diplomacy.mut().clear();
+        for (uint32_t i = 0; i < pair_count; i++) {
+            std::string fa, fb, st;
+            if (!c.read_fixed_str(&fa, 32)) { *err = "diplomacy faction_a truncated"; return false; }
+            if (!c.read_fixed_str(&fb, 32)) { *err = "diplomacy faction_b truncated"; return false; }
+            if (!c.read_fixed_str(&st, 16)) { *err = "diplomacy state truncated"; return false; }
+            out.diplomacy.mut()[ReplayDiplomacyKey(fa, fb)] = st;
+        }
+    } else if (section_id == 8) {
+        // section 8: cooldowns (added v2 extension, 2026-04-08)
+        // Layout:
+        //   uint32 type_count
+        //   for i in 0..type_count:
+        //       char     type_name[64]
+        //       uint32   ability_count
+        //       float32  cooldown[ability_count]
+        uint32_t type_count = 0;
+        if (!c.read_u32(&type_count)) { *err = "cooldown type_count truncated"; return false; }
+        if (type_count > 4096) { *err = "cooldown type_count out of sane bound"; return false; }
+        out.cooldowns.mut().clear();
+        for (uint32_t i = 0; i < type_count; i++) {
+            std::string name;
+            uint32_t ability_count = 0;
+            if (!c.read_fixed_str(&name, 64)) { *err = "cooldown type name truncated"; return false; }
+            if (!c.read_u32(&ability_count)) { *err = "cooldown ability_count truncated"; return false; }
+            if (ability_count > 256) { *err = "cooldown ability_count out of sane bound"; return false; }
+            std::vector<float> values;
+            values.reserve(ability_count);
+            for (uint32_t j = 0; j < ability_count; j++) {
+                uint32_t bits = 0;
+                if (!c.read_u32(&bits)) { *err = "cooldown value truncated"; return false; }
+                float v = 0.0f;
+                memcpy(&v, &bits, 4);
+                values.push_back(v);
+            }
+            out.cooldowns.mut()[name] = std::move(values);
+        }
+    } else if (section_id == 9) {
+        // section 9: task_forces (added v2 extension, 2026-04-08)
+        // Layout:
+        //   uint32 force_count
+        //   for i in 0..force_count:
+        //       int32 owner_slot
+        //       char  name[64]
+        uint32_t force_count = 0;
+        if (!c.read_u32(&force_count)) { *err = "task_force count truncated"; return false; }
+        if (force_count > 4096) { *err = "task_force count out of sane bound"; return false; }
+        out.task_forces.mut().clear();
+        for (uint32_t i = 0; i < force_count; i++) {
+            int32_t owner = 0;
+            std::string name;
+            if (!c.read_i32(&owner)) { *err = "task_force owner truncated"; return false; }
+            if (!c.read_fixed_str(&name, 64)) { *err = "task_force name truncated"; return false; }
+            ReplayTaskForceRecord rec;
+            rec.owner_slot = owner;
+            rec.name = name;
+            out.task_forces.mut().push_back(std::move(rec));
+        }
+    } else if (section_id == 10) {
+        // section 10: object_owners (added v2 extension, 2026-04-08)
+        // Layout:
+        //   uint32 type_count
+        //   for i in 0..type_count:
+        //       char    type_name[64]
+        //       uint32  instance_count
+        //       int32   owner_slot[instance_count]
+        uint32_t type_count = 0;
+        if (!c.read_u32(&type_count)) { *err = "object_owners type_count truncated"; return false; }
+        if (type_count > 4096) { *err = "object_owners type_count out of sane bound"; return false; }
+        out.object_owners.mut().clear();
+        for (uint32_t i = 0; i < type_count; i++) {
+            std::string name;
+            uint32_t instance_count = 0;
+            if (!c.read_fixed_str(&name, 64)) { *err = "object_owners type name truncated"; return false; }
+            if (!c.read_u32(&instance_count)) { *err = "object_owners instance_count truncated"; return false; }
+            if (instance_count > 65536) { *err = "object_owners instance_count out of sane bound"; return false; }
+            std::vector<int32_t> owners;
+            owners.reserve(instance_count);
+            for (uint32_t j = 0; j < instance_count; j++) {
+                int32_t s = 0;
+                if (!c.read_i32(&s)) { *err = "object_owners owner truncated"; return false; }
+                owners.push_back(s);
+            }
+            out.object_owners.mut()[ReplayUpper(name)] = std::move(owners);
+        }
+    } else if (section_id == 11) {
+        // section 11: selected_units (added 2026-04-23 for Task 101)
+        // Layout:
+        //   uint32 count
+        //   uint64 obj_addr[count]
+        uint32_t count = 0;
+        if (!c.read_u32(&count)) { *err = "selected_units count truncated"; return false; }
+        if (count > 4096) { *err = "selected_units count out of sane bound"; return false; }
+        out.selected_units.clear();
+        out.selected_units.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t obj = 0;
+            if (!c.read_u64(&obj)) { *err = "selected_units obj_addr truncated"; return false; }
+            out.selected_units.push_back(obj);
+        }
+    } else if (section_id == 12) {
+        // section 12: unit_detail (added 2026-04-23 for Task 101)
+        // Layout per unit: 102 bytes fixed + hardpoint indices.
+        //   uint64  obj_addr
+        //   char    type_name[64]
+        //   int32   owner_slot
+        //   float32 hull
+        //   float32 max_hull
+        //   uint8   invuln_flag
+        //   uint8   prevent_death
+        //   uint8   reserved[6]
+        //   uint32  hardpoint_count
+        //   uint32  hardpoint_indices[hardpoint_count]
+        // Section 13 (behavior_attach) is responsible for the per-HP
+        // behavior name lists.
+        uint32_t unit_count = 0;
+        if (!c.read_u32(&unit_count)) { *err = "unit_detail count truncated"; return false; }
+        if (unit_count > 65536) { *err = "unit_detail count out of sane bound"; return false; }
+        out.units.mut().reserve(out.units.size() + unit_count);
+        std::string type_name;  // one scratch name for the section; rows copy it into the table's arena
+        for (uint32_t i = 0; i < unit_count; i++) {
+            uint64_t obj_addr = 0;
+            int32_t owner_slot = 0;
+            uint32_t hull_bits = 0, max_hull_bits = 0;
+            uint8_t invuln_flag = 0, prevent_death = 0;
+            uint8_t reserved[6];
+            if (!c.read_u64(&obj_addr))               { *err = "unit_detail obj_addr truncated"; return false; }
+            if (!c.read_fixed_str(&type_name, 64))    { *err = "unit_detail type_name truncated"; return false; }
+            if (!c.read_i32(&owner_slot))             { *err = "unit_detail owner_slot truncated"; return false; }
+            if (!c.read_u32(&hull_bits))              { *err = "unit_detail hull truncated"; return false; }
+            if (!c.read_u32(&max_hull_bits))          { *err = "unit_detail max_hull truncated"; return false; }
+            if (!c.read_u8(&invuln_flag))             { *err = "unit_detail invuln_flag truncated"; return false; }
+            if (!c.read_u8(&prevent_death))           { *err = "unit_detail prevent_death truncated"; return false; }
+            if (!c.read_bytes(reserved, 6))           { *err = "unit_detail reserved truncated"; return false; }
+            uint32_t hp_count = 0;
+            if (!c.read_u32(&hp_count))               { *err = "unit_detail hp_count truncated"; return false; }
+            if (hp_count > 1024) { *err = "unit_detail hp_count out of sane bound"; return false; }
+            float hull = 0.0f, max_hull = 0.0f;
+            memcpy(&hull, &hull_bits, 4);
+            memcpy(&max_hull, &max_hull_bits, 4);
+            auto& u = ReplayMutMockUnit(out, obj_addr, type_name, owner_slot, hull, max_hull, hp_count);
+            u.invuln_flag = invuln_flag;
+            u.prevent_death = prevent_death;
+            for (uint32_t j = 0; j < hp_count; j++) {
+                uint32_t hp_index = 0;
+                if (!c.read_u32(&hp_index)) { *err = "unit_detail hp_index truncated"; return false; }
+                if (j < u.hardpoints.size()) u.hardpoints[j].index = hp_index;
+            }
+        }
+    } else if (section_id == 13) {
+        // section 13: behavior_attach (added 2026-04-23 for Task 101)
+        // Flat list of (obj_addr, hp_index, behavior_name) triples.
+        //   uint32 entry_count
+        //   for i in 0..entry_count:
+        //       uint64 obj_addr
+        //       uint32 hp_index
+        //       char   behavior_name[32]
+        // Entries referring to units not present in section 12 are
+        // ignored (forward-compat: a capture that emits behaviors for
+        // units outside the selection should not fail loading).
+        uint32_t entry_count = 0;
+        if (!c.read_u32(&entry_count)) { *err = "behavior_attach count truncated"; return false; }
+        if (entry_count > 65536) { *err = "behavior_attach count out of sane bound"; return false; }
+        std::string behavior;
+        for (uint32_t i = 0; i < entry_count; i++) {
+            uint64_t obj_addr = 0;
+            uint32_t hp_index = 0;
+            if (!c.read_u64(&obj_addr))             { *err = "behavior_attach obj_addr truncated"; return false; }
+            if (!c.read_u32(&hp_index))             { *err = "behavior_attach hp_index truncated"; return false; }
+            if (!c.read_fixed_str(&behavior, 32))   { *err = "behavior_attach name truncated"; return false; }
+            // Silently skip entries that do not match a loaded unit.
+            ReplayMutAttachBehavior(out, obj_addr, static_cast<int>(hp_index), behavior);
+        }
+    } else if (section_id == 14) {
+        // section 14: unit_position (added 2026-10-14)
+        //   uint32 count
+        //   for i in 0..count:
+        //       uint64  obj_addr
+        //       float32 x, y, z
+        // Like section 13, entries for units not in section 12 are skipped.
+        uint32_t count = 0;
+        if (!c.read_u32(&count)) { *err = "unit_position count truncated"; return false; }
+        if (count > 65536) { *err = "unit_position count out of sane bound"; return false; }
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t obj_addr = 0;
+            float xyz[3];
+            if (!c.read_u64(&obj_addr))    { *err = "unit_position obj_addr truncated"; return false; }
+            if (!c.read_bytes(xyz, 12))    { *err = "unit_position xyz truncated"; return false; }
+            ReplayMutSetUnitPosition(out, obj_addr, xyz[0], xyz[1], xyz[2]);
+        }
+    }
+    return true;
+}
+
+// Decodes the 68-byte file header into `out`. Returns false with *err set
+// when it is malformed or names an unknown version.
+inline bool ParseSnapshotHeader(const uint8_t* bytes, size_t n, ReplayState& out,
+                                std::string* err) {
+    SnapCursor c(bytes, n);
+    uint8_t magic[16];
+    if (!c.read_bytes(magic, 16)) { *err = "header truncated"; return false; }
+    const uint8_t kMagicV1[16] = {
+        'S','W','F','O','C','S','N','A','P','v','1', 0, 0, 0, 0, 0
+    };
+    const uint8_t kMagicV2[16] = {
+        'S','W','F','O','C','S','N','A','P','v','2', 0, 0, 0, 0, 0
+    };
+    const uint8_t kMagicV3[16] = {
+        'S','W','F','O','C','S','N','A','P','v','3', 0, 0, 0, 0, 0
+    };
+    const uint8_t kMagicV4[16] = {
+        'S','W','F','O','C','S','N','A','P','v','4', 0, 0, 0, 0, 0
+    };
+    bool isV1 = memcmp(magic, kMagicV1, 16) == 0;
+    bool isV2 = memcmp(magic, kMagicV2, 16) == 0;
+    bool isV3 = memcmp(magic, kMagicV3, 16) == 0;
+    bool isV4 = memcmp(magic, kMagicV4, 16) == 0;
+    if (!isV1 && !isV2 && !isV3 && !isV4) {
+        *err = "magic mismatch (expected 'SWFOCSNAPv1' .. 'SWFOCSNAPv4')";
+        return false;
+    }
+
+    if (!c.read_u32(&out.format_version)) { *err = "format_version truncated"; return false; }
+    // v1 = legacy (no explicit local_slot in section 1; derived from first player)
+    // v2 = current (explicit local_slot in section 1, added 2026-04-08)
+    // v3 = v2 layout with LZ4-compressed sections (expanded before parsing)
+    // v4 = delta against a base capture (rebuilt before parsing)
+    if (out.format_version < 1 || out.format_version > 4) {
+        char buf[128];
+        snprintf(buf, sizeof(buf),
+                 "unsupported format_version=%u (expected 1 .. 4)",
+                 out.format_version);
+        *err = buf;
+        return false;
+    }
+    // Cross-check: magic and format_version must agree.
+    if ((isV1 && out.format_version != 1) || (isV2 && out.format_version != 2)
+        || (isV3 && out.format_version != 3) || (isV4 && out.format_version != 4)) {
+        *err = "magic/format_version mismatch";
+        return false;
+    }
+
+    if (!c.read_u64(&out.capture_timestamp_ms)) { *err = "timestamp truncated"; return false; }
+    if (!c.read_bytes(out.engine_build_hash, 32)) { *err = "engine_build_hash truncated"; return false; }
+    if (!c.read_u8(&out.game_mode)) { *err = "game_mode truncated"; return false; }
+    if (!c.skip(7)) { *err = "reserved header padding truncated"; return false; }
+
+    // Header should be exactly 68 bytes.
+    if (c.pos() != 68) {
+        *err = "header did not end at offset 68";
+        return false;
+    }
+    return true;
+}
+
+// Decodes the section at index entry `e` of a mapped file: checked against
+// the entry and its CRC, expanded first when LZ4-compressed.
+inline bool DecodeIndexedSection(const uint8_t* bytes, const SnapIndexEntry& e, std::vector<uint8_t>* inflated,
+                                 ReplayState& out, std::string* err) {
+    const uint32_t id = e.id & SNAP_SECTION_ID_MASK;
+    const uint8_t* payload = bytes + e.off + 8;
+    uint32_t len = e.len;
+    uint32_t head[2];
+    memcpy(head, bytes + e.off, 8);
+    if (head[0] != e.id || head[1] != e.len || Crc32_Compute(payload, len) != e.crc) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "section %u does not match its section index entry", id);
+        *err = buf;
+        return false;
+    }
+    if (e.id & SNAP_SECTION_LZ4) {
+        uint32_t rawLen = 0;
+        if (len >= 4) memcpy(&rawLen, payload, 4);
+        inflated->resize(rawLen);
+        if (len < 4 || rawLen > static_cast<size_t>(len - 4) * 255
+            || !SnapLz4Decompress(payload + 4, len - 4, inflated->data(), rawLen)) {
+            *err = "compressed section does not decode to its raw_length";
+            return false;
+        }
+        payload = inflated->data();
+        len = rawLen;
+    }
+    return ParseSnapshotSection(id, payload, len, out, err);
+}
+
+// Decodes an expanded stream of `n` bytes: the header, the section list and
+// the end-marker CRC, then the sections selected in `sections`. Those not
+// selected are appended to `skipped` when it is given. `refs` is scratch
+// the caller may reuse across calls. Returns r->ok.
+inline bool SnapDecodeStream(const uint8_t* bytes, size_t n, ReplayState& out, uint32_t sections,
+                             std::vector<SnapSectionRef>* refs, SnapshotLoadResult* r,
+                             std::vector<SnapIndexEntry>* skipped = nullptr) {
+    r->ok = false;
+    if (!ParseSnapshotHeader(bytes, n, out, &r->error)) return false;
+
+    size_t endOff = 0;
+    if (const char* e = SnapIndexSections(bytes, n, 68, refs, &endOff)) {
+        r->error = e;
+        return false;
+    }
+    uint32_t endLen = 0, fileCrc = 0;
+    memcpy(&endLen, bytes + endOff + 4, 4);
+    memcpy(&fileCrc, bytes + endOff + 8, 4);
+    if (endLen != 4) {
+        r->error = "end marker section_length != 4";
+        return false;
+    }
+    // CRC covers [0 .. endOff + 8), i.e. end-marker header included.
+    uint32_t expected = Crc32_Compute(bytes, endOff + 8);
+    if (expected != fileCrc) {
+        char buf[128];
+        snprintf(buf, sizeof(buf),
+                 "CRC32 mismatch (file=0x%08X computed=0x%08X)",
+                 fileCrc, expected);
+        r->error = buf;
+        return false;
+    }
+
+    r->sections_total = refs->size();
+    for (const SnapSectionRef& ref : *refs) {
+        if (ref.id >= 32) continue;
+        if (!(sections & REPLAY_SECTION(ref.id))) {
+            if (skipped) skipped->push_back({ref.id, static_cast<uint32_t>(ref.off), ref.len, 0});
+            continue;
+        }
+        if (!ParseSnapshotSection(ref.id, bytes + ref.off + 8, ref.len, out, &r->error)) return false;
+        r->sections_loaded++;
+    }
+    r->ok = true;
+    return true;
+}
+
+// Empties everything a load fills -- the header and the tables of sections
+// 1 .. 14 -- keeping their storage, so the next load into `s` reads as a
+// load into a fresh state.
+inline void ReplayClearSnapshot(ReplayState& s) {
+    s.format_version = 0;
+    s.capture_timestamp_ms = 0;
+    memset(s.engine_build_hash, 0, sizeof(s.engine_build_hash));
+    s.game_mode = 0;
+    s.local_slot = -1;
+    s.players.clear();
+    s.lua_state_ptrs.clear();
+    if (!s.objects.empty()) s.objects.mut().clear();
+    if (!s.globals.empty()) s.globals.mut().clear();
+    if (!s.metadata.empty()) s.metadata.mut().clear();
+    if (!s.planets.empty()) s.planets.mut().clear();
+    if (!s.diplomacy.empty()) s.diplomacy.mut().clear();
+    if (!s.cooldowns.empty()) s.cooldowns.mut().clear();
+    if (!s.task_forces.empty()) s.task_forces.mut().clear();
+    if (!s.object_owners.empty()) s.object_owners.mut().clear();
+    s.selected_units.clear();
+    if (!s.units.empty()) s.units.mut().clear();
+    s.unit_grid.valid = false;
+}
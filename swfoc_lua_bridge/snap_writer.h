@@ -0,0 +1,436 @@
+#pragma once
+// snap_writer.h -- streaming .swfocsnap writer behind SWFOC_DumpState.
+//
+// v1 built the whole snapshot in a DumpBuf (a std::vector grown by insert,
+// plus a temporary vector per fixed-width string), one DumpBuf per section
+// copied into the file buffer, and then fopen/fwrite/CRC on the game's main
+// thread. Here the main thread only reads engine memory and stores fields:
+//
+//   * Two chunk buffers, each reserved once at open (SNAP_CHUNK_RESERVE).
+//     Fields are stored in place at the fill cursor; fixed-width strings are
+//     zero-filled in place. A section larger than the chunk grows it (counted
+//     in `grows`), it is never split.
+//   * SnapEndSection patches the section length into its header and hands
+//     the chunk to the I/O thread, then carries on in the other chunk. The
+//     main thread only waits when the I/O thread is still writing the
+//     previous chunk (counted in `stalls`).
+//   * The I/O thread opens the file, writes each chunk, and runs the CRC over
+//     the staged bytes. SnapWriterFinish writes the end marker;
+//     the I/O thread appends the CRC and closes the file.
+//
+// Deferred writers (SWFOC_DumpStateAsync) never hand off mid-capture: the
+// whole snapshot is staged in the fill chunk within the one call, so the main
+// thread never waits on the I/O thread. SnapWriterClose then hands the staged
+// file over without waiting; SnapWriterDone polls and SnapWriterCollect joins.
+//
+// Compressing writers (SnapWriterCompressSections, v3) stage exactly the v2
+// byte stream and the I/O thread re-frames it as it writes: each section of
+// at least SNAP_LZ4_MIN_SECTION bytes whose LZ4 block is smaller goes out as
+// id | SNAP_SECTION_LZ4, u32 raw_length, block. The CRC still runs over the
+// staged (uncompressed) bytes, so the main thread's cost does not change.
+//
+// Delta writers (SnapWriterDeltaAgainst, v4) also stage the full stream;
+// the I/O thread compares each section with the base's (snap_delta.h) and
+// writes only what changed, then compresses that if lz4 is on too.
+// SnapWriterKeepStream has the I/O thread keep a copy of the staged stream,
+// which becomes the base of the next delta.
+//
+// Indexing writers (SnapWriterIndexSections) have the I/O thread note each
+// section's file offset, stored length and CRC as it writes it, and append
+// the section index (snap_index.h) after the CRC. Every writer that takes a
+// path other than straight chunk copies re-frames section by section, so
+// the index sees exactly the sections that reached the file.
+//
+// Offsets from SnapOffset stay valid for SnapPatchU32 until the open section
+// ends. Every SnapWriterOpen must be paired with SnapWriterFinish, or with
+// SnapWriterClose and SnapWriterCollect; both join the I/O thread.
+// Header-only and Win32-free so test_harness.cpp drives the real code; the
+// caller supplies the CRC function.
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "snap_lz4.h"
+#include "snap_delta.h"
+#include "snap_index.h"
+
+#define SNAP_CHUNK_RESERVE (64 * 1024)  // bytes per chunk buffer
+
+typedef std::shared_ptr<const std::vector<uint8_t>> SnapStream;  // full stream, CRC included
+
+struct SnapChunk {
+    std::vector<uint8_t> bytes;  // sized at open, grows only for an oversized section
+    size_t               len = 0;
+};
+
+struct SnapWriter {
+    SnapChunk  chunks[2];
+    SnapChunk* fill = nullptr;     // main thread stores here
+    SnapChunk* pending = nullptr;  // handed to the I/O thread; guarded by lock
+    bool       closing = false;    // guarded by lock
+    bool       finished = false;   // I/O thread exited; guarded by lock
+    bool       deferred = false;   // stage everything, hand off at close
+    bool       lz4 = false;        // v3: compress sections on the I/O thread
+    size_t     headerBytes = 0;    // leading file header the I/O thread stores raw
+    bool       keep = false;       // copy the staged stream into `kept`
+    bool       index = false;      // append a section index after the CRC
+    SnapStream base;               // v4: write only what differs from this
+    std::vector<SnapSectionRef> baseSections;
+    size_t     sectionStart = 0;   // header offset of the open section in fill
+    size_t     submitted = 0;      // bytes handed to the I/O thread
+    uint32_t   handoffs = 0;
+    uint32_t   stalls = 0;         // handoffs that waited for the I/O thread
+    uint32_t   grows = 0;
+    SnapCrcFn  crcFn = nullptr;
+    std::string path;
+
+    // Written by the I/O thread, read after join.
+    bool       opened = false;
+    size_t     written = 0;
+    size_t     expected = 0;       // bytes handed to fwrite, the CRC aside
+    uint32_t   crc = 0;
+    std::vector<uint8_t> packed;   // LZ4 scratch
+    std::vector<uint8_t> patch;    // delta scratch
+    size_t     baseNext = 0;       // first baseSections entry not yet matched
+    std::vector<uint8_t> kept;     // the staged stream, CRC included
+    uint32_t   headerCrc = 0;      // of the file header, for the index
+    std::vector<SnapIndexEntry> entries;
+
+    std::mutex              lock;
+    std::condition_variable cv;
+    std::thread             io;
+};
+
+struct SnapWriteResult {
+    bool     opened;
+    size_t   written;   // bytes that reached the file
+    size_t   total;     // bytes the snapshot should have, CRC included
+    size_t   raw;       // full uncompressed size, CRC included (== total unless lz4 / delta)
+    bool     lz4;
+    bool     delta;
+    uint32_t handoffs;
+    uint32_t stalls;
+    uint32_t grows;
+};
+
+inline void SnapIoEmit(SnapWriter* w, FILE* f, const void* p, size_t n) {
+    if (!n) return;
+    if (f) w->written += fwrite(p, 1, n, f);
+    w->expected += n;
+}
+
+// Writes one section, LZ4-compressed when that is on and it pays.
+inline void SnapIoEmitSection(SnapWriter* w, FILE* f, uint32_t id, const uint8_t* payload,
+                              size_t len) {
+    const size_t at = w->expected;
+    size_t packedLen = 0;
+    if (w->lz4 && len >= SNAP_LZ4_MIN_SECTION) {
+        // Capacity len - 5: stored only if it beats the raw payload.
+        if (w->packed.size() < len) w->packed.resize(len);
+        packedLen = SnapLz4Compress(payload, len, w->packed.data(), len - 5);
+    }
+    if (packedLen) {
+        const uint32_t head[3] = { id | SNAP_SECTION_LZ4,
+                                   static_cast<uint32_t>(packedLen + 4),
+                                   static_cast<uint32_t>(len) };
+        SnapIoEmit(w, f, head, sizeof(head));
+        SnapIoEmit(w, f, w->packed.data(), packedLen);
+        if (w->index) {
+            const uint32_t crc = w->crcFn(w->crcFn(0, &head[2], 4), w->packed.data(), packedLen);
+            w->entries.push_back({ head[0], static_cast<uint32_t>(at), head[1], crc });
+        }
+    } else {
+        const uint32_t head[2] = { id, static_cast<uint32_t>(len) };
+        SnapIoEmit(w, f, head, sizeof(head));
+        SnapIoEmit(w, f, payload, len);
+        if (w->index) {
+            w->entries.push_back({ id, static_cast<uint32_t>(at), head[1], w->crcFn(0, payload, len) });
+        }
+    }
+}
+
+// v4: drops every base section ahead of section id that the capture skipped.
+inline void SnapIoDropBaseBefore(SnapWriter* w, FILE* f, uint32_t id) {
+    while (w->baseNext < w->baseSections.size() && w->baseSections[w->baseNext].id < id) {
+        SnapIoEmitSection(w, f, w->baseSections[w->baseNext++].id | SNAP_SECTION_DROP, nullptr, 0);
+    }
+}
+
+// Writes staged section (id, payload) of a v4 delta: nothing when the base
+// has it unchanged, else a patch when one is smaller, else the section.
+inline void SnapIoEmitDelta(SnapWriter* w, FILE* f, uint32_t id, const uint8_t* payload,
+                            size_t len) {
+    SnapIoDropBaseBefore(w, f, id);
+    const SnapSectionRef* b = nullptr;
+    if (w->baseNext < w->baseSections.size() && w->baseSections[w->baseNext].id == id) {
+        b = &w->baseSections[w->baseNext++];
+    }
+    if (!b) {
+        SnapIoEmitSection(w, f, id, payload, len);
+        return;
+    }
+    const uint8_t* basePayload = w->base->data() + b->off + 8;
+    if (b->len == len && memcmp(basePayload, payload, len) == 0) return;
+    const SnapKeyedLayout* l = SnapFindKeyedLayout(id);
+    if (l && SnapDeltaPatch(*l, basePayload, b->len, payload, len, &w->patch)
+        && w->patch.size() < len) {
+        SnapIoEmitSection(w, f, id | SNAP_SECTION_PATCH, w->patch.data(), w->patch.size());
+    } else {
+        SnapIoEmitSection(w, f, id, payload, len);
+    }
+}
+
+// Writes chunk c re-framed for v3 / v4. Chunks always hold whole sections;
+// the first one starts with the file header.
+inline void SnapIoEmitSections(SnapWriter* w, FILE* f, const SnapChunk* c) {
+    const uint8_t* b = c->bytes.data();
+    size_t pos = w->expected == 0 ? w->headerBytes : 0;
+    SnapIoEmit(w, f, b, pos);
+    if (pos && w->index) w->headerCrc = w->crcFn(0, b, pos);
+    while (pos + 8 <= c->len) {
+        uint32_t id, len;
+        memcpy(&id, b + pos, 4);
+        memcpy(&len, b + pos + 4, 4);
+        if (id == SNAP_END_SECTION_ID) {
+            if (w->base) SnapIoDropBaseBefore(w, f, SNAP_END_SECTION_ID);
+            SnapIoEmit(w, f, b + pos, 8);
+            pos += 8;
+            continue;
+        }
+        if (w->base && id != SNAP_DELTA_BASE_ID) {
+            SnapIoEmitDelta(w, f, id, b + pos + 8, len);
+        } else {
+            SnapIoEmitSection(w, f, id, b + pos + 8, len);
+        }
+        pos += 8 + static_cast<size_t>(len);
+    }
+}
+
+inline void SnapIoLoop(SnapWriter* w) {
+    FILE* f = fopen(w->path.c_str(), "wb");
+    w->opened = f != nullptr;
+    std::unique_lock<std::mutex> lk(w->lock);
+    for (;;) {
+        w->cv.wait(lk, [w] { return w->pending != nullptr || w->closing; });
+        if (!w->pending) break;
+        SnapChunk* c = w->pending;
+        lk.unlock();
+        if (w->keep) w->kept.insert(w->kept.end(), c->bytes.data(), c->bytes.data() + c->len);
+        if (w->lz4 || w->base || w->index) {
+            SnapIoEmitSections(w, f, c);
+        } else {
+            SnapIoEmit(w, f, c->bytes.data(), c->len);
+        }
+        w->crc = w->crcFn(w->crc, c->bytes.data(), c->len);
+        lk.lock();
+        w->pending = nullptr;
+        w->cv.notify_all();
+    }
+    lk.unlock();
+    if (w->keep) {
+        const uint8_t* crc = reinterpret_cast<const uint8_t*>(&w->crc);
+        w->kept.insert(w->kept.end(), crc, crc + 4);
+    }
+    if (f) w->written += fwrite(&w->crc, 1, 4, f);
+    if (w->index) {
+        std::vector<uint8_t> index;
+        SnapPutIndex(w->crcFn, w->headerCrc, w->entries, &index);
+        SnapIoEmit(w, f, index.data(), index.size());
+    }
+    if (f) fclose(f);
+    lk.lock();
+    w->finished = true;
+}
+
+inline void SnapWriterOpen(SnapWriter* w, const char* path, SnapCrcFn crcFn,
+                           bool deferred = false) {
+    for (SnapChunk& c : w->chunks) {
+        c.bytes.resize(SNAP_CHUNK_RESERVE);
+        c.len = 0;
+    }
+    w->fill = &w->chunks[0];
+    w->pending = nullptr;
+    w->closing = false;
+    w->finished = false;
+    w->deferred = deferred;
+    w->lz4 = false;
+    w->headerBytes = 0;
+    w->keep = false;
+    w->index = false;
+    w->headerCrc = 0;
+    w->entries.clear();
+    w->base.reset();
+    w->baseSections.clear();
+    w->baseNext = 0;
+    w->kept.clear();
+    w->sectionStart = 0;
+    w->submitted = 0;
+    w->handoffs = w->stalls = w->grows = 0;
+    w->crcFn = crcFn;
+    w->path = path;
+    w->opened = false;
+    w->written = 0;
+    w->expected = 0;
+    w->crc = 0;
+    w->io = std::thread(SnapIoLoop, w);
+}
+
+// Switches w to v3 section compression. Call right after SnapWriterOpen,
+// before the first field; headerBytes is the file header ahead of section 1.
+inline void SnapWriterCompressSections(SnapWriter* w, size_t headerBytes) {
+    w->lz4 = true;
+    w->headerBytes = headerBytes;
+}
+
+// Switches w to a v4 delta against base, the full stream of an earlier
+// capture. Call right after SnapWriterOpen, before the first field. False
+// (and w unchanged) if base does not index.
+inline bool SnapWriterDeltaAgainst(SnapWriter* w, const SnapStream& base, size_t headerBytes) {
+    size_t endOff = 0;
+    if (SnapIndexSections(base->data(), base->size(), headerBytes, &w->baseSections, &endOff)) {
+        w->baseSections.clear();
+        return false;
+    }
+    // A delta base's own reference is not part of its state.
+    if (!w->baseSections.empty() && w->baseSections[0].id == SNAP_DELTA_BASE_ID) {
+        w->baseSections.erase(w->baseSections.begin());
+    }
+    w->base = base;
+    w->headerBytes = headerBytes;
+    return true;
+}
+
+// Has the I/O thread append a section index after the CRC. Call right after
+// SnapWriterOpen; headerBytes is the file header ahead of section 1.
+inline void SnapWriterIndexSections(SnapWriter* w, size_t headerBytes) {
+    w->index = true;
+    w->headerBytes = headerBytes;
+}
+
+// Has the I/O thread keep the staged stream, CRC included, in w->kept for
+// after SnapWriterCollect. Call right after SnapWriterOpen.
+inline void SnapWriterKeepStream(SnapWriter* w) { w->keep = true; }
+
+// Reserves n bytes at the fill cursor and returns them for in-place stores.
+inline uint8_t* SnapClaim(SnapWriter* w, size_t n) {
+    SnapChunk* c = w->fill;
+    if (c->len + n > c->bytes.size()) {
+        size_t cap = c->bytes.size() * 2;
+        if (cap < c->len + n) cap = c->len + n;
+        c->bytes.resize(cap);
+        w->grows++;
+    }
+    uint8_t* p = c->bytes.data() + c->len;
+    c->len += n;
+    return p;
+}
+
+inline void SnapPut(SnapWriter* w, const void* p, size_t n) {
+    if (n) memcpy(SnapClaim(w, n), p, n);
+}
+inline void SnapU8(SnapWriter* w, uint8_t v)   { *SnapClaim(w, 1) = v; }
+inline void SnapU16(SnapWriter* w, uint16_t v) { memcpy(SnapClaim(w, 2), &v, 2); }
+inline void SnapU32(SnapWriter* w, uint32_t v) { memcpy(SnapClaim(w, 4), &v, 4); }
+inline void SnapU64(SnapWriter* w, uint64_t v) { memcpy(SnapClaim(w, 8), &v, 8); }
+inline void SnapF64(SnapWriter* w, double v)   { memcpy(SnapClaim(w, 8), &v, 8); }
+inline void SnapZeros(SnapWriter* w, size_t n) { memset(SnapClaim(w, n), 0, n); }
+
+// Null-padded fixed-width ASCII field.
+inline void SnapFixedStr(SnapWriter* w, const char* s, size_t width) {
+    uint8_t* p = SnapClaim(w, width);
+    size_t n = s ? strnlen(s, width) : 0;
+    if (n) memcpy(p, s, n);
+    memset(p + n, 0, width - n);
+}
+
+inline size_t SnapOffset(const SnapWriter* w) { return w->fill->len; }
+
+inline void SnapPatchU32(SnapWriter* w, size_t off, uint32_t v) {
+    memcpy(w->fill->bytes.data() + off, &v, 4);
+}
+
+// Hands the fill chunk to the I/O thread and switches to the other one.
+inline void SnapSubmit(SnapWriter* w) {
+    if (w->fill->len == 0) return;
+    {
+        std::unique_lock<std::mutex> lk(w->lock);
+        if (w->pending) {
+            w->stalls++;
+            w->cv.wait(lk, [w] { return w->pending == nullptr; });
+        }
+        w->pending = w->fill;
+        w->submitted += w->fill->len;
+        w->handoffs++;
+        w->fill = (w->fill == &w->chunks[0]) ? &w->chunks[1] : &w->chunks[0];
+        w->fill->len = 0;
+    }
+    w->cv.notify_all();
+}
+
+inline void SnapBeginSection(SnapWriter* w, uint32_t id) {
+    w->sectionStart = w->fill->len;
+    SnapU32(w, id);
+    SnapU32(w, 0);  // section_length, patched by SnapEndSection
+}
+
+inline void SnapEndSection(SnapWriter* w) {
+    SnapPatchU32(w, w->sectionStart + 4,
+                 static_cast<uint32_t>(w->fill->len - w->sectionStart - 8));
+    if (!w->deferred) SnapSubmit(w);
+}
+
+// Stores the delta_base section (section 0) of a v4 capture.
+inline void SnapWriteDeltaBase(SnapWriter* w) {
+    SnapBeginSection(w, SNAP_DELTA_BASE_ID);
+    SnapU64(w, SnapStreamTimestamp(w->base->data()));
+    SnapU32(w, SnapStreamCrc(w->base->data(), w->base->size()));
+    SnapEndSection(w);
+}
+
+// Writes the end marker and hands the rest to the I/O thread, which appends
+// the CRC and closes the file. Waits only for a chunk still being written.
+inline void SnapWriterClose(SnapWriter* w) {
+    SnapU32(w, SNAP_END_SECTION_ID);
+    SnapU32(w, 4);
+    SnapSubmit(w);
+    {
+        std::lock_guard<std::mutex> lk(w->lock);
+        w->closing = true;
+    }
+    w->cv.notify_all();
+}
+
+// True once the I/O thread has closed the file; SnapWriterCollect then
+// returns without blocking.
+inline bool SnapWriterDone(SnapWriter* w) {
+    std::lock_guard<std::mutex> lk(w->lock);
+    return w->finished;
+}
+
+// Joins the I/O thread and reports what reached the file.
+inline void SnapWriterCollect(SnapWriter* w, SnapWriteResult* out) {
+    w->io.join();
+    out->opened = w->opened;
+    out->written = w->written;
+    out->total = w->expected + 4;
+    out->raw = w->submitted + 4;
+    out->lz4 = w->lz4;
+    out->delta = w->base != nullptr;
+    out->handoffs = w->handoffs;
+    out->stalls = w->stalls;
+    out->grows = w->grows;
+}
+
+// Close + Collect: the synchronous SWFOC_DumpState path.
+inline void SnapWriterFinish(SnapWriter* w, SnapWriteResult* out) {
+    SnapWriterClose(w);
+    SnapWriterCollect(w, out);
+}
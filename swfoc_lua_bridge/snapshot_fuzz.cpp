@@ -0,0 +1,163 @@
+// snapshot_fuzz.cpp -- fuzz target for the .swfocsnap parser (snap_reader.h).
+//
+// Snapshots come from a live game process and from whoever hands a capture
+// around, and every section carries counts and lengths the parser trusts
+// only after checking. This target feeds arbitrary bytes through the same
+// SnapDecodeStream swfoc_replay.exe loads with, from memory:
+//
+//   * One ReplayState, one section list and one input buffer live for the
+//     whole process. ReplayClearSnapshot empties the state between inputs
+//     but keeps its storage, so an iteration allocates only where the
+//     input itself grows a table. No file is opened or mapped.
+//   * A mutated input would almost never keep its end-marker CRC, and the
+//     parser rejects a CRC mismatch before any section. The target copies
+//     the input and rewrites the CRC over the copy, so mutations reach the
+//     section parsers; the mismatch path is covered by test_harness.cpp.
+//   * v3 inputs (SWFOCSNAPv3) are expanded in memory first, exercising the
+//     LZ4 section decoder too. v4 deltas need a base and are rejected as
+//     swfoc_replay.exe rejects them without --base.
+//
+// Seeds: make_test_snapshot.py's fixtures cover both v1 and v2 magic,
+// sections 1 .. 10 (v2 / --v2-early / --v1), 11 .. 14 (--units) and LZ4
+// (--v3). build_snapshot_fuzz.bat writes them to fuzz_seeds\.
+//
+// Build (one of):
+//   libFuzzer:  clang++ -O1 -g -std=c++17 -fsanitize=fuzzer,address
+//                   -DSNAPSHOT_FUZZ_LIBFUZZER -I. -o snapshot_fuzz snapshot_fuzz.cpp
+//               ./snapshot_fuzz fuzz_seeds/
+//   AFL++:      afl-clang-fast++ -O2 -std=c++17 -I. -o snapshot_fuzz snapshot_fuzz.cpp
+//               afl-fuzz -i fuzz_seeds -o fuzz_out -- ./snapshot_fuzz
+//               (persistent mode with the shared-memory test case)
+//   Plain:      x86_64-w64-mingw32-g++ -O2 -std=c++17 -I. -static
+//                   -o snapshot_fuzz.exe snapshot_fuzz.cpp
+//               (or build_snapshot_fuzz.bat)
+//
+// The plain build replays inputs instead of generating them:
+//   snapshot_fuzz.exe [--iterations N] <file> [<file> ...]
+// parses each file N times (default 1), prints whether it loads and how
+// many sections it decoded, and the parse rate over all of them.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "snap_reader.h"
+
+struct SnapshotFuzzContext {
+    ReplayState                 state;
+    std::vector<SnapSectionRef> refs;
+    std::vector<uint8_t>        input;     // the input with its CRC fixed
+    std::vector<uint8_t>        expanded;  // v3 sections expanded
+    SnapshotLoadResult          result;
+};
+
+static SnapshotFuzzContext g_fuzz;
+
+// Points the stored CRC of `buf` at its contents when its section list
+// reaches an end marker; leaves it alone otherwise.
+static void SnapshotFuzzFixCrc(std::vector<uint8_t>* buf, std::vector<SnapSectionRef>* refs) {
+    size_t endOff = 0;
+    if (buf->size() < 68 || SnapIndexSections(buf->data(), buf->size(), 68, refs, &endOff)) return;
+    const uint32_t crc = Crc32_Compute(buf->data(), endOff + 8);
+    memcpy(buf->data() + endOff + 8, &crc, 4);
+}
+
+// One input. Returns whether it loaded.
+static bool SnapshotFuzzOne(const uint8_t* data, size_t size) {
+    SnapshotFuzzContext& f = g_fuzz;
+    ReplayClearSnapshot(f.state);
+    f.result.ok = false;
+    f.result.error.clear();
+    f.result.sections_total = 0;
+    f.result.sections_loaded = 0;
+    f.input.assign(data, data + size);
+
+    const uint8_t* bytes = f.input.data();
+    size_t n = f.input.size();
+    if (n >= 16 && memcmp(bytes, "SWFOCSNAPv4", 12) == 0) return false;
+    if (n >= 16 && memcmp(bytes, "SWFOCSNAPv3", 12) == 0) {
+        if (SnapLz4ExpandSections(bytes, n, 68, &f.expanded)) return false;
+        SnapshotFuzzFixCrc(&f.expanded, &f.refs);
+        bytes = f.expanded.data();
+        n = f.expanded.size();
+    } else {
+        SnapshotFuzzFixCrc(&f.input, &f.refs);
+    }
+    return SnapDecodeStream(bytes, n, f.state, REPLAY_ALL_SECTIONS, &f.refs, &f.result);
+}
+
+#if defined(SNAPSHOT_FUZZ_LIBFUZZER)
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    SnapshotFuzzOne(data, size);
+    return 0;
+}
+
+#elif defined(__AFL_FUZZ_TESTCASE_LEN)
+
+__AFL_FUZZ_INIT();
+
+int main() {
+    __AFL_INIT();
+    const unsigned char* buf = __AFL_FUZZ_TESTCASE_BUF;
+    while (__AFL_LOOP(100000)) SnapshotFuzzOne(buf, static_cast<size_t>(__AFL_FUZZ_TESTCASE_LEN));
+    return 0;
+}
+
+#else
+
+static bool ReadWholeFile(const char* path, std::vector<uint8_t>* out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+    out->clear();
+    uint8_t chunk[65536];
+    size_t got = 0;
+    while ((got = fread(chunk, 1, sizeof(chunk), fp)) > 0) out->insert(out->end(), chunk, chunk + got);
+    fclose(fp);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    long iterations = 1;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtol(argv[++i], nullptr, 10);
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty() || iterations < 1) {
+        fprintf(stderr, "usage: %s [--iterations N] <snapshot> [<snapshot> ...]\n",
+                argv[0] ? argv[0] : "snapshot_fuzz.exe");
+        return 2;
+    }
+
+    std::vector<std::vector<uint8_t>> inputs(paths.size());
+    for (size_t k = 0; k < paths.size(); k++) {
+        if (!ReadWholeFile(paths[k], &inputs[k])) {
+            fprintf(stderr, "could not read %s\n", paths[k]);
+            return 3;
+        }
+    }
+
+    uint64_t execs = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < inputs.size(); k++) {
+        bool ok = false;
+        for (long it = 0; it < iterations; it++) ok = SnapshotFuzzOne(inputs[k].data(), inputs[k].size());
+        execs += static_cast<uint64_t>(iterations);
+        printf("%s: %s, %zu of %zu sections\n", paths[k], ok ? "ok" : g_fuzz.result.error.c_str(),
+               g_fuzz.result.sections_loaded, g_fuzz.result.sections_total);
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%llu execs in %.3f s (%.0f execs/s)\n", static_cast<unsigned long long>(execs), secs,
+           secs > 0.0 ? static_cast<double>(execs) / secs : 0.0);
+    return 0;
+}
+
+#endif
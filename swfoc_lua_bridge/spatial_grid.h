@@ -0,0 +1,166 @@
+#pragma once
+// spatial_grid.h -- uniform-grid index of unit ground positions.
+//
+// "Units within R of P" (SWFOC_QueryUnitsInRadius, the replay area-damage
+// splash) used to mean testing every walked unit. The grid buckets units by
+// the ground-plane (x, y) cell they stand in, so a query only visits the
+// cells its circle or rectangle overlaps:
+//
+//   * Cells are SPATIAL_GRID_DEFAULT_CELL world units on a side and hashed
+//     into SPATIAL_GRID_BUCKETS buckets, so the map size is never needed.
+//     Entries are stored bucket-sorted (counting sort) with their integer
+//     cell, and a query skips entries of other cells sharing a bucket -- a
+//     unit is reported at most once.
+//   * SpatialGridUpdate is fed the tactical walk every tick. When the walk
+//     lists the same units in the same order and none of them left its
+//     cell, it only rewrites positions in place; otherwise it re-sorts.
+//     Between ticks most units move within their cell, so the common tick
+//     touches no bucket bookkeeping at all.
+//   * A query whose footprint spans more cells than there are buckets just
+//     scans every entry.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge builds and queries it on the main thread.
+
+#include <cstdint>
+#include <cmath>
+
+#define SPATIAL_GRID_MAX          2048     // RVA::Selection::kMaxTacticalObjects
+#define SPATIAL_GRID_BUCKETS      4096     // power of two
+#define SPATIAL_GRID_DEFAULT_CELL 256.0f   // world units
+#define SPATIAL_GRID_CELL_LIMIT   1000000  // cell coordinates are clamped to +-this
+
+struct SpatialGrid {
+    float    cell;                          // 0 = SPATIAL_GRID_DEFAULT_CELL
+    uint32_t count;
+    // Bucket-sorted entries.
+    uint64_t obj[SPATIAL_GRID_MAX];
+    int32_t  owner[SPATIAL_GRID_MAX];
+    float    x[SPATIAL_GRID_MAX];
+    float    y[SPATIAL_GRID_MAX];
+    int32_t  cx[SPATIAL_GRID_MAX];
+    int32_t  cy[SPATIAL_GRID_MAX];
+    uint16_t start[SPATIAL_GRID_BUCKETS + 1];  // entries of bucket b: [start[b], start[b+1])
+    // Last input, in walk order, for the in-place refresh.
+    uint64_t inObj[SPATIAL_GRID_MAX];
+    uint16_t inSlot[SPATIAL_GRID_MAX];      // input i lives at entry inSlot[i]
+    uint32_t rebuilds;
+    uint32_t refreshes;
+};
+
+inline int32_t SpatialGridCellCoord(const SpatialGrid* g, float v) {
+    const float c = floorf(v / (g->cell > 0.0f ? g->cell : SPATIAL_GRID_DEFAULT_CELL));
+    if (!(c > -SPATIAL_GRID_CELL_LIMIT)) return -SPATIAL_GRID_CELL_LIMIT;  // also NaN
+    if (c > SPATIAL_GRID_CELL_LIMIT) return SPATIAL_GRID_CELL_LIMIT;
+    return (int32_t)c;
+}
+
+inline uint32_t SpatialGridBucket(int32_t cx, int32_t cy) {
+    return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u) & (SPATIAL_GRID_BUCKETS - 1);
+}
+
+// Indexes n units (n is clamped to SPATIAL_GRID_MAX). Returns true when the
+// entries were re-sorted, false when only positions and owners changed.
+inline bool SpatialGridUpdate(SpatialGrid* g, const uint64_t* objs, const int32_t* owner,
+                              const float* xs, const float* ys, int n) {
+    if (n < 0) n = 0;
+    if (n > SPATIAL_GRID_MAX) n = SPATIAL_GRID_MAX;
+
+    bool same = (uint32_t)n == g->count;
+    for (int i = 0; same && i < n; i++) {
+        const uint16_t e = g->inSlot[i];
+        same = g->inObj[i] == objs[i] && g->cx[e] == SpatialGridCellCoord(g, xs[i])
+               && g->cy[e] == SpatialGridCellCoord(g, ys[i]);
+    }
+    if (same) {
+        for (int i = 0; i < n; i++) {
+            const uint16_t e = g->inSlot[i];
+            g->x[e] = xs[i];
+            g->y[e] = ys[i];
+            g->owner[e] = owner[i];
+        }
+        g->refreshes++;
+        return false;
+    }
+
+    static_assert(SPATIAL_GRID_MAX <= 0xFFFF, "entry indices are uint16_t");
+    uint16_t bucketOf[SPATIAL_GRID_MAX];
+    for (uint32_t b = 0; b <= SPATIAL_GRID_BUCKETS; b++) g->start[b] = 0;
+    for (int i = 0; i < n; i++) {
+        bucketOf[i] = (uint16_t)SpatialGridBucket(SpatialGridCellCoord(g, xs[i]), SpatialGridCellCoord(g, ys[i]));
+        g->start[bucketOf[i] + 1]++;
+    }
+    for (uint32_t b = 0; b < SPATIAL_GRID_BUCKETS; b++) g->start[b + 1] += g->start[b];
+    uint16_t fill[SPATIAL_GRID_BUCKETS];
+    for (uint32_t b = 0; b < SPATIAL_GRID_BUCKETS; b++) fill[b] = g->start[b];
+    for (int i = 0; i < n; i++) {
+        const uint16_t e = fill[bucketOf[i]]++;
+        g->obj[e] = objs[i];
+        g->owner[e] = owner[i];
+        g->x[e] = xs[i];
+        g->y[e] = ys[i];
+        g->cx[e] = SpatialGridCellCoord(g, xs[i]);
+        g->cy[e] = SpatialGridCellCoord(g, ys[i]);
+        g->inObj[i] = objs[i];
+        g->inSlot[i] = e;
+    }
+    g->count = (uint32_t)n;
+    g->rebuilds++;
+    return true;
+}
+
+// Calls visit(entry) for every entry whose cell lies in [cx0,cx1] x [cy0,cy1].
+template<typename Visit>
+inline void SpatialGridVisitCells(const SpatialGrid* g, int32_t cx0, int32_t cy0, int32_t cx1, int32_t cy1,
+                                  Visit&& visit) {
+    const uint64_t cells = (uint64_t)(cx1 - cx0 + 1) * (uint64_t)(cy1 - cy0 + 1);
+    if (cells > SPATIAL_GRID_BUCKETS) {
+        for (uint32_t e = 0; e < g->count; e++) {
+            if (g->cx[e] >= cx0 && g->cx[e] <= cx1 && g->cy[e] >= cy0 && g->cy[e] <= cy1) visit(e);
+        }
+        return;
+    }
+    for (int32_t cy = cy0; cy <= cy1; cy++) {
+        for (int32_t cx = cx0; cx <= cx1; cx++) {
+            const uint32_t b = SpatialGridBucket(cx, cy);
+            for (uint32_t e = g->start[b]; e < g->start[b + 1]; e++) {
+                if (g->cx[e] == cx && g->cy[e] == cy) visit(e);
+            }
+        }
+    }
+}
+
+// Entries within `radius` of (x, y), boundary included. Writes up to `max`
+// entry indices to `out` and returns the total number of matches.
+inline int SpatialGridQueryRadius(const SpatialGrid* g, float x, float y, float radius, uint16_t* out,
+                                  int max) {
+    if (!(radius >= 0.0f)) return 0;
+    const float r2 = radius * radius;
+    int n = 0;
+    SpatialGridVisitCells(g, SpatialGridCellCoord(g, x - radius), SpatialGridCellCoord(g, y - radius),
+                          SpatialGridCellCoord(g, x + radius), SpatialGridCellCoord(g, y + radius),
+                          [&](uint32_t e) {
+                              const float dx = g->x[e] - x, dy = g->y[e] - y;
+                              if (dx * dx + dy * dy > r2) return;
+                              if (n < max) out[n] = (uint16_t)e;
+                              n++;
+                          });
+    return n;
+}
+
+// Entries inside the axis-aligned rectangle spanned by the two corners
+// (either order), edges included. Same output contract as QueryRadius.
+inline int SpatialGridQueryRect(const SpatialGrid* g, float x0, float y0, float x1, float y1, uint16_t* out,
+                                int max) {
+    if (x1 < x0) { const float t = x0; x0 = x1; x1 = t; }
+    if (y1 < y0) { const float t = y0; y0 = y1; y1 = t; }
+    int n = 0;
+    SpatialGridVisitCells(g, SpatialGridCellCoord(g, x0), SpatialGridCellCoord(g, y0),
+                          SpatialGridCellCoord(g, x1), SpatialGridCellCoord(g, y1),
+                          [&](uint32_t e) {
+                              if (g->x[e] < x0 || g->x[e] > x1 || g->y[e] < y0 || g->y[e] > y1) return;
+                              if (n < max) out[n] = (uint16_t)e;
+                              n++;
+                          });
+    return n;
+}
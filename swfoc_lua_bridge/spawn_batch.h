@@ -0,0 +1,272 @@
+#pragma once
+// spawn_batch.h -- batched spawns, spread across frames under a unit budget.
+//
+// SWFOC_SpawnUnitLua spawns one unit per pipe command, so a 40-unit test
+// fleet was 40 round-trips, and the ones that landed in the same frame
+// hitched it. SWFOC_SpawnBatch takes the whole fleet in one command:
+//
+//   "type;count;owner;x;y;z|type;count;owner;x;y;z|..."
+//
+// one entry per '|', owner a player slot. The spec becomes a SpawnBatch in
+// a SpawnQueue; Hook_luaD_call then spawns at most `budget` units per frame
+// (SPAWN_FRAME_MS apart) until the queue is empty:
+//
+//   * Batches run in submission order, entries in spec order.
+//   * The spawner callback gets an entry and a unit count and returns how
+//     many it spawned. Units it did not spawn count as failed; when it
+//     spawns none the rest of the entry is failed too (a bad type or an
+//     empty owner slot fails every unit the same way) without using the
+//     frame's budget.
+//   * A batch keeps its slot, and so its progress for SWFOC_SpawnBatchStatus,
+//     until a batch SPAWN_BATCH_SLOTS ids later reuses it. A new batch whose
+//     slot is still spawning is refused (SpawnQueuePush returns 0).
+//
+// A zeroed SpawnQueue is ready to use (budget 0 means
+// SPAWN_BUDGET_DEFAULT).
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge queues and spawns on the main thread.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "player_table.h"
+
+#define SPAWN_BATCH_ENTRIES   32    // entries per batch
+#define SPAWN_BATCH_UNITS_MAX 512   // units per batch
+#define SPAWN_BATCH_SLOTS     4     // batches queued or kept for status
+#define SPAWN_TYPE_MAX        64    // type name, NUL included
+#define SPAWN_BUDGET_DEFAULT  4     // units per frame
+#define SPAWN_BUDGET_MAX      64
+#define SPAWN_FRAME_MS        16
+
+enum SpawnParseResult {
+    SPAWN_PARSE_OK = 0,
+    SPAWN_PARSE_EMPTY,     // no entries
+    SPAWN_PARSE_TOO_MANY,  // over SPAWN_BATCH_ENTRIES or SPAWN_BATCH_UNITS_MAX
+    SPAWN_PARSE_FIELDS,    // not six ';'-separated fields
+    SPAWN_PARSE_TYPE,      // empty, too long, or not [A-Za-z0-9_]
+    SPAWN_PARSE_COUNT,     // not an integer >= 1
+    SPAWN_PARSE_OWNER,     // not a slot in [0, PLAYER_TABLE_SLOTS)
+    SPAWN_PARSE_POSITION,  // not a finite number
+};
+
+struct SpawnBatchEntry {
+    char    type[SPAWN_TYPE_MAX];
+    int32_t owner;
+    float   x, y, z;
+    int32_t count;
+    int32_t done;      // units spawned or failed
+};
+
+struct SpawnBatch {
+    uint32_t        id;       // 0 = slot never used
+    int32_t         entries;
+    int32_t         cursor;   // first entry with units left
+    int32_t         total;
+    int32_t         spawned;
+    int32_t         failed;
+    SpawnBatchEntry entry[SPAWN_BATCH_ENTRIES];
+};
+
+struct SpawnQueue {
+    SpawnBatch slots[SPAWN_BATCH_SLOTS];  // batch id N lives in slots[(N - 1) % SLOTS]
+    uint32_t   lastId;
+    int32_t    budget;                    // units per frame, 0 = default
+    int32_t    pending;                   // units left across all batches
+    uint64_t   nextMs;
+    uint32_t   frames;                    // SpawnQueueStep calls
+};
+
+inline const char* SpawnParseError(int r) {
+    switch (r) {
+    case SPAWN_PARSE_OK:       return "ok";
+    case SPAWN_PARSE_EMPTY:    return "no entries";
+    case SPAWN_PARSE_TOO_MANY: return "too many entries or units";
+    case SPAWN_PARSE_FIELDS:   return "expected type;count;owner;x;y;z";
+    case SPAWN_PARSE_TYPE:     return "bad type name";
+    case SPAWN_PARSE_COUNT:    return "count must be an integer >= 1";
+    case SPAWN_PARSE_OWNER:    return "owner must be a player slot 0..7";
+    case SPAWN_PARSE_POSITION: return "bad position";
+    }
+    return "?";
+}
+
+inline int32_t SpawnBatchPending(const SpawnBatch* b) {
+    return b->total - b->spawned - b->failed;
+}
+
+inline int SpawnQueueBudget(const SpawnQueue* q) {
+    return q->budget > 0 ? q->budget : SPAWN_BUDGET_DEFAULT;
+}
+
+// n is clamped to [1, SPAWN_BUDGET_MAX].
+inline void SpawnQueueSetBudget(SpawnQueue* q, int n) {
+    q->budget = n < 1 ? 1 : n > SPAWN_BUDGET_MAX ? SPAWN_BUDGET_MAX : n;
+}
+
+// Copies field [s, e) into buf (cap bytes, NUL included); false if it does
+// not fit.
+inline bool SpawnField(const char* s, const char* e, char* buf, size_t cap) {
+    const size_t n = (size_t)(e - s);
+    if (n >= cap) return false;
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    return true;
+}
+
+inline bool SpawnParseInt(const char* s, const char* e, long* out) {
+    char buf[16];
+    if (s == e || !SpawnField(s, e, buf, sizeof(buf))) return false;
+    char* end = nullptr;
+    *out = strtol(buf, &end, 10);
+    return *end == '\0';
+}
+
+inline bool SpawnParseFloat(const char* s, const char* e, float* out) {
+    char buf[32];
+    if (s == e || !SpawnField(s, e, buf, sizeof(buf))) return false;
+    char* end = nullptr;
+    const double v = strtod(buf, &end);
+    if (*end != '\0' || !(v >= -3.0e38 && v <= 3.0e38)) return false;  // also NaN / inf
+    *out = (float)v;
+    return true;
+}
+
+inline int SpawnParseEntry(SpawnBatchEntry* out, const char* s, const char* e) {
+    const char* f[7];
+    int nf = 0;
+    f[nf++] = s;
+    for (const char* p = s; p < e && nf < 7; p++)
+        if (*p == ';') f[nf++] = p + 1;
+    if (nf != 6) return SPAWN_PARSE_FIELDS;
+    f[6] = e + 1;  // so f[i + 1] - 1 ends field i
+
+    memset(out, 0, sizeof(*out));
+    const char* ts = f[0];
+    const char* te = f[1] - 1;
+    if (ts == te || !SpawnField(ts, te, out->type, sizeof(out->type))) return SPAWN_PARSE_TYPE;
+    for (const char* p = ts; p < te; p++) {
+        const char c = *p;
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        if (!ok) return SPAWN_PARSE_TYPE;
+    }
+    long count = 0, owner = 0;
+    if (!SpawnParseInt(f[1], f[2] - 1, &count) || count < 1 || count > SPAWN_BATCH_UNITS_MAX)
+        return SPAWN_PARSE_COUNT;
+    if (!SpawnParseInt(f[2], f[3] - 1, &owner) || owner < 0 || owner >= PLAYER_TABLE_SLOTS)
+        return SPAWN_PARSE_OWNER;
+    if (!SpawnParseFloat(f[3], f[4] - 1, &out->x) || !SpawnParseFloat(f[4], f[5] - 1, &out->y)
+        || !SpawnParseFloat(f[5], f[6] - 1, &out->z))
+        return SPAWN_PARSE_POSITION;
+    out->count = (int32_t)count;
+    out->owner = (int32_t)owner;
+    return SPAWN_PARSE_OK;
+}
+
+// Parses `spec` into b (id 0, nothing spawned). On failure *badEntry is the
+// 0-based entry at fault (-1 when none is) and b is unusable.
+inline int SpawnBatchParse(SpawnBatch* b, const char* spec, int* badEntry) {
+    memset(b, 0, sizeof(*b));
+    *badEntry = -1;
+    if (!spec || !*spec) return SPAWN_PARSE_EMPTY;
+    const char* s = spec;
+    for (;;) {
+        const char* e = strchr(s, '|');
+        if (!e) e = s + strlen(s);
+        if (b->entries == SPAWN_BATCH_ENTRIES) {
+            *badEntry = b->entries;
+            return SPAWN_PARSE_TOO_MANY;
+        }
+        const int r = SpawnParseEntry(&b->entry[b->entries], s, e);
+        if (r != SPAWN_PARSE_OK) {
+            *badEntry = b->entries;
+            return r;
+        }
+        b->total += b->entry[b->entries].count;
+        b->entries++;
+        if (b->total > SPAWN_BATCH_UNITS_MAX) {
+            *badEntry = b->entries - 1;
+            return SPAWN_PARSE_TOO_MANY;
+        }
+        if (!*e) break;
+        s = e + 1;
+    }
+    return SPAWN_PARSE_OK;
+}
+
+inline SpawnBatch* SpawnQueueSlot(SpawnQueue* q, uint32_t id) {
+    return &q->slots[(id - 1) % SPAWN_BATCH_SLOTS];
+}
+
+// The batch with this id, or nullptr when it was never queued or its slot
+// has been reused.
+inline const SpawnBatch* SpawnQueueFind(const SpawnQueue* q, uint32_t id) {
+    if (id == 0) return nullptr;
+    const SpawnBatch* b = &q->slots[(id - 1) % SPAWN_BATCH_SLOTS];
+    return b->id == id ? b : nullptr;
+}
+
+// Queues a parsed batch and returns its id, or 0 when its slot still holds
+// a batch with units left.
+inline uint32_t SpawnQueuePush(SpawnQueue* q, const SpawnBatch* parsed) {
+    const uint32_t id = q->lastId + 1 ? q->lastId + 1 : 1;
+    SpawnBatch* b = SpawnQueueSlot(q, id);
+    if (b->id && SpawnBatchPending(b) > 0) return 0;
+    memcpy(b, parsed, sizeof(*b));
+    b->id = id;
+    b->cursor = 0;
+    b->spawned = b->failed = 0;
+    for (int i = 0; i < b->entries; i++) b->entry[i].done = 0;
+    q->lastId = id;
+    q->pending += b->total;
+    return id;
+}
+
+// The oldest batch with units left, or nullptr.
+inline SpawnBatch* SpawnQueueActive(SpawnQueue* q) {
+    SpawnBatch* best = nullptr;
+    for (int i = 0; i < SPAWN_BATCH_SLOTS; i++) {
+        SpawnBatch* b = &q->slots[i];
+        if (b->id && SpawnBatchPending(b) > 0 && (!best || b->id < best->id)) best = b;
+    }
+    return best;
+}
+
+inline bool SpawnQueueDue(const SpawnQueue* q, uint64_t nowMs) {
+    return q->pending > 0 && nowMs >= q->nextMs;
+}
+
+// One frame: up to SpawnQueueBudget units through spawn(const
+// SpawnBatchEntry*, int n) -> units spawned. Returns the units attempted.
+// nextMs moves before the first spawn, so a spawn that re-enters
+// luaD_call does not find the queue due again.
+template<typename Spawn>
+inline int SpawnQueueStep(SpawnQueue* q, uint64_t nowMs, Spawn&& spawn) {
+    q->nextMs = nowMs + SPAWN_FRAME_MS;
+    q->frames++;
+    int left = SpawnQueueBudget(q);
+    int used = 0;
+    while (left > 0 && q->pending > 0) {
+        SpawnBatch* b = SpawnQueueActive(q);
+        if (!b) break;
+        SpawnBatchEntry* e = &b->entry[b->cursor];
+        const int n = e->count - e->done < left ? e->count - e->done : left;
+        int ok = spawn(static_cast<const SpawnBatchEntry*>(e), n);
+        ok = ok < 0 ? 0 : ok > n ? n : ok;
+        int failed = n - ok;
+        e->done += n;
+        if (ok == 0) {
+            failed += e->count - e->done;
+            e->done = e->count;
+        }
+        b->spawned += ok;
+        b->failed += failed;
+        q->pending -= ok + failed;
+        if (e->done == e->count) b->cursor++;
+        left -= n;
+        used += n;
+    }
+    return used;
+}
@@ -0,0 +1,178 @@
+#pragma once
+// state_set.h -- lock-free "is this lua_State registered?" test for the
+// luaD_call hook.
+//
+// Hook_luaD_call runs on every Lua function call and the game opens 400+
+// states, so taking csRegistered and scanning registered_states there was
+// the hottest cost the bridge added. StatePtrSet is a fixed-size
+// open-addressed (linear probing) pointer set:
+//
+//   * Readers (Hook_luaD_call) never lock: a lookup is a hash and a short
+//     probe of acquire loads.
+//   * Writers (lua_open / lua_close hooks) stay serialized by csRegistered.
+//     Erase uses backward-shift deletion, so there are no tombstones and
+//     probe chains never degrade with state churn.
+//   * A reader racing an erase can miss a live entry for that one call
+//     (a drain is delayed by one luaD_call). It can never report a pointer
+//     that was not inserted, because only registered pointers are stored.
+//   * If more than STATE_SET_MAX_LIVE states are live at once, `overflow`
+//     latches and callers fall back to the locked StateRegistryHas.
+//
+// StateRegistry pairs the set with the dense list the bridge enumerates
+// (SWFOC_StateInfo, snapshot section 2, the message-pump drain). The list
+// used to be a std::vector that lua_open and lua_close searched with
+// std::find and erased from the middle, so a load that opens and closes
+// hundreds of states went quadratic under the lock:
+//
+//   * A position map makes open, close and the locked lookup O(1); close
+//     moves the last entry into the hole, so the list is unordered.
+//   * Each entry keeps its insertion sequence; StateRegistryOldest (the
+//     longest-lived state, what states[0] used to be) scans for the
+//     lowest, O(n) but only on the paused-game drain path.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#define STATE_SET_SLOTS    2048  // power of two
+#define STATE_SET_MAX_LIVE 1536  // 75% load cap
+
+struct StatePtrSet {
+    std::atomic<void*> slots[STATE_SET_SLOTS];
+    uint32_t           live;      // writer-only
+    std::atomic<bool>  overflow;  // latched: an insert did not fit
+};
+
+inline uint32_t StateSetHash(const void* p) {
+    uint64_t v = (uint64_t)(uintptr_t)p;
+    v ^= v >> 33;
+    v *= 0xff51afd7ed558ccdull;
+    v ^= v >> 33;
+    return (uint32_t)v & (STATE_SET_SLOTS - 1);
+}
+
+// Only call while no reader can run (startup / tests).
+inline void StateSetReset(StatePtrSet* s) {
+    for (int i = 0; i < STATE_SET_SLOTS; i++) s->slots[i].store(nullptr, std::memory_order_relaxed);
+    s->live = 0;
+    s->overflow.store(false, std::memory_order_relaxed);
+}
+
+inline bool StateSetContains(const StatePtrSet* s, const void* p) {
+    uint32_t i = StateSetHash(p);
+    for (uint32_t n = 0; n < STATE_SET_SLOTS; n++) {
+        const void* v = s->slots[i].load(std::memory_order_acquire);
+        if (v == p) return true;
+        if (!v) return false;
+        i = (i + 1) & (STATE_SET_SLOTS - 1);
+    }
+    return false;
+}
+
+// Writer side. Returns false (and latches `overflow`) when the set is full.
+inline bool StateSetInsert(StatePtrSet* s, void* p) {
+    if (!p) return false;
+    if (StateSetContains(s, p)) return true;
+    if (s->live >= STATE_SET_MAX_LIVE) {
+        s->overflow.store(true, std::memory_order_release);
+        return false;
+    }
+    uint32_t i = StateSetHash(p);
+    while (s->slots[i].load(std::memory_order_relaxed)) i = (i + 1) & (STATE_SET_SLOTS - 1);
+    s->slots[i].store(p, std::memory_order_release);
+    s->live++;
+    return true;
+}
+
+// Writer side. Removes `p` if present, shifting later chain members back
+// into the hole so lookups never need tombstones.
+inline void StateSetErase(StatePtrSet* s, const void* p) {
+    const uint32_t mask = STATE_SET_SLOTS - 1;
+    uint32_t hole = StateSetHash(p);
+    for (uint32_t n = 0;; n++) {
+        const void* v = s->slots[hole].load(std::memory_order_relaxed);
+        if (!v || n >= STATE_SET_SLOTS) return;
+        if (v == p) break;
+        hole = (hole + 1) & mask;
+    }
+    for (uint32_t j = (hole + 1) & mask;; j = (j + 1) & mask) {
+        void* v = s->slots[j].load(std::memory_order_relaxed);
+        if (!v) break;
+        // Move v back only if its home slot is not inside (hole, j].
+        const uint32_t home = StateSetHash(v);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            s->slots[hole].store(v, std::memory_order_release);
+            hole = j;
+        }
+    }
+    s->slots[hole].store(nullptr, std::memory_order_release);
+    s->live--;
+}
+
+// Registry: lock-free membership plus an enumerable list. Writers and
+// enumerators hold the owner's lock; StateSetContains(&r->set, p) needs none.
+struct StateRegistry {
+    StatePtrSet                               set;
+    std::vector<void*>                        states;    // dense, unordered
+    std::vector<uint64_t>                     opened;    // insertion sequence, parallel to states
+    std::unordered_map<const void*, uint32_t> pos;       // index into states
+    uint64_t                                  next_seq;
+};
+
+// Only call while no reader can run (startup / tests).
+inline void StateRegistryReset(StateRegistry* r) {
+    StateSetReset(&r->set);
+    r->states.clear();
+    r->opened.clear();
+    r->pos.clear();
+    r->next_seq = 0;
+}
+
+inline bool StateRegistryHas(const StateRegistry* r, const void* p) {
+    return r->pos.find(p) != r->pos.end();
+}
+
+// Returns true when `p` was added, false when it was already there.
+// A full set latches r->set.overflow; the list still records `p`.
+inline bool StateRegistryInsert(StateRegistry* r, void* p) {
+    if (!p || StateRegistryHas(r, p)) return false;
+    r->pos.emplace(p, static_cast<uint32_t>(r->states.size()));
+    r->states.push_back(p);
+    r->opened.push_back(r->next_seq++);
+    StateSetInsert(&r->set, p);
+    return true;
+}
+
+// Returns true when `p` was present.
+inline bool StateRegistryErase(StateRegistry* r, const void* p) {
+    auto it = r->pos.find(p);
+    if (it == r->pos.end()) return false;
+    const uint32_t i = it->second;
+    const uint32_t last = static_cast<uint32_t>(r->states.size() - 1);
+    r->pos.erase(it);
+    if (i != last) {
+        r->states[i] = r->states[last];
+        r->opened[i] = r->opened[last];
+        r->pos[r->states[i]] = i;
+    }
+    r->states.pop_back();
+    r->opened.pop_back();
+    StateSetErase(&r->set, p);
+    return true;
+}
+
+// The live entry inserted first, or nullptr when empty.
+inline void* StateRegistryOldest(const StateRegistry* r) {
+    void* best = nullptr;
+    uint64_t seq = UINT64_MAX;
+    for (size_t i = 0; i < r->states.size(); i++) {
+        if (r->opened[i] < seq) {
+            seq = r->opened[i];
+            best = r->states[i];
+        }
+    }
+    return best;
+}
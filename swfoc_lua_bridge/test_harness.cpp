@@ -18,6 +18,8 @@
 #include <algorithm>
 #include <cmath>
 #include <atomic>
+#include <thread>
+#include <chrono>
 
 // Include the real lua_types.h for pfn_* typedefs and lua_State forward decl.
 // lua_State remains opaque -- we cast FakeLuaState* to lua_State* at call sites.
@@ -26,6 +28,52 @@
 #include "fake_lua.h"
 #include "fake_memory.h"
 #include "replay_state.h"
+#include "replay_tick.h"
+#include "replay_sweep.h"
+#include "replay_diff.h"
+#include "snap_reader.h"
+#include "helper_index.h"
+#include "pipe_protocol.h"
+#include "pipe_queue.h"
+#include "shared_memory.h"
+#include "state_set.h"
+#include "damage_ring.h"
+#include "unit_shadow.h"
+#include "unit_index.h"
+#include "region_cache.h"
+#include "obj_memo.h"
+#include "bulk_mutate.h"
+#include "crc32.h"
+#include "snap_writer.h"
+#include "snap_lz4.h"
+#include "snap_delta.h"
+#include "snap_index.h"
+#include "log_ring.h"
+#include "perf_hist.h"
+#include "hook_cost.h"
+#include "combat_mods.h"
+#include "combat_stats.h"
+#include "pending_journal.h"
+#include "slot_mods.h"
+#include "crash_trail.h"
+#include "type_cache.h"
+#include "type_census.h"
+#include "unit_handles.h"
+#include "spatial_grid.h"
+#include "selection_tracker.h"
+#include "position_track.h"
+#include "event_compact.h"
+#include "instance_names.h"
+#include "csv_row.h"
+#include "player_table.h"
+#include "spawn_batch.h"
+#include "hardpoint_layout.h"
+#include "mod_catalog.h"
+#include "timeline_ring.h"
+#include "camera_path.h"
+#include "timeline_replay.h"
+#include "lua_table_rows.h"
+#include "planet_table.h"
 
 // ======================================================================
 // Test framework
@@ -77,21 +125,31 @@ static pfn_lua_pcall        fn_pcall        = nullptr;
 static pfn_lua_load         fn_load         = nullptr;
 
 // State tracking
-static std::vector<void*> registered_states;
+static StateRegistry registered_states;
 static CRITICAL_SECTION csRegistered;
-static std::vector<void*> cached_game_states;
+static StateRegistry cached_game_states;
 static CRITICAL_SECTION csGameStates;
 
 // Pipe command queue. 2026-04-10: mirrors the bridge-side bump from 4096
 // -> 16384 so DiagListRegisteredFunctions and other diagnostic payloads
 // can round-trip without truncation. g_pipeResult also widened to
 // PIPE_CMD_MAX (was 512) to match the real bug fix in lua_bridge.cpp.
+// 2026-10-14: the single slot became the shared ticketed queue from
+// pipe_queue.h; the harness drains the same structure the bridge does.
 #define PIPE_CMD_MAX 16384
-static CRITICAL_SECTION g_pipeLock;
-static char  g_pipeCmd[PIPE_CMD_MAX];
-static bool  g_pipeCmdPending = false;
-static char  g_pipeResult[PIPE_CMD_MAX];
-static bool  g_pipeResultReady = false;
+#define PIPE_DRAIN_MAX_PER_CALL 4
+static PipeCmdQueue g_pipeQueue;
+
+// Drain budget replica state. The harness clock is fake: 1 tick = 1 us and
+// every read advances it by g_harnessQpcStep, so tests choose how "slow"
+// each command appears.
+static LONG g_pipeDrainBudgetUs = PIPE_DRAIN_BUDGET_US_DEFAULT;
+static LONG g_pipeDeferredCount = 0;
+static PipeBatchCursor g_pipeBatchCursor = {};
+static int g_pipeDrainDepth = 0;
+static int64_t g_harnessQpc = 0;
+static int64_t g_harnessQpcStep = 0;
+static const int64_t kHarnessQpcFreq = 1000000;
 
 // Shared memory (local, non-OS)
 struct LocalCmdBuffer {
@@ -106,13 +164,7 @@ static LocalCmdBuffer g_shmCmdBuf;
 static LocalCmdBuffer* g_cmdBuf = nullptr;
 static uint32_t g_lastCmdSeq = 0;
 
-struct LocalEvtBuffer {
-    std::atomic<uint32_t> write_pos;
-    std::atomic<uint32_t> read_pos;
-    std::atomic<uint32_t> event_count;
-    std::atomic<uint32_t> flags;
-    uint8_t ring[64 * 1024 - 16];
-};
+typedef SharedEvtBuffer LocalEvtBuffer;
 static LocalEvtBuffer g_shmEvtBuf;
 static LocalEvtBuffer* g_evtBuf = nullptr;
 
@@ -502,13 +554,20 @@ static int Lua_GetHardpoints(lua_State* L) {
         children[count++] = child;
     }
     char buf[2048];
-    size_t off = 0;
-    off = SafeAppendFmt(buf, off, sizeof(buf), "count=%d", count);
+    CsvRow row;
+    CsvRowInit(&row, buf, sizeof(buf));
+    CsvRowCount(&row, count);
     for (int i = 0; i < count; i++) {
         float hp = *reinterpret_cast<float*>(children[i] + RVA::GameObj::HP);
-        off = SafeAppendFmt(buf, off, sizeof(buf),
-                            " child%d=0x%016llX hp%d=%.3f",
-                            i, (unsigned long long)children[i], i, hp);
+        // " child%d=0x%016llX hp%d=%.3f"
+        CsvRowStr(&row, " child");
+        CsvRowI64(&row, i);
+        CsvRowStr(&row, "=0x");
+        CsvRowHex16(&row, (uint64_t)children[i]);
+        CsvRowStr(&row, " hp");
+        CsvRowI64(&row, i);
+        CsvRowChar(&row, '=');
+        CsvRowFixed(&row, hp, 3);
     }
     fn_pushstring(L, buf);
     return 1;
@@ -756,18 +815,14 @@ static void EnsureCombatHookLock() {
     }
 }
 
+// Decision logic is the real CombatResolveHp (combat_mods.h); the flags are
+// folded into the same modifier word the bridge keeps.
 static void Detour_SetHP(void* obj, float new_hp) {
-    LONG god = g_god_mode_enabled;
-    LONG ohk = g_ohk_enabled;
-    if (god || ohk) {
-        bool human = IsObjOwnedByHuman(reinterpret_cast<uintptr_t>(obj));
-        if (god && human) {
-            float cur = *reinterpret_cast<float*>(reinterpret_cast<uintptr_t>(obj) + RVA::GameObj::HP);
-            if (new_hp < cur) return;
-        }
-        if (ohk && !human) {
-            new_hp = 0.0f;
-        }
+    const uint32_t mods = (g_god_mode_enabled ? COMBAT_MOD_GOD : 0u) | (g_ohk_enabled ? COMBAT_MOD_OHK : 0u);
+    if (mods) {
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(obj);
+        const float cur = *reinterpret_cast<float*>(addr + RVA::GameObj::HP);
+        if (!CombatResolveHp(mods, cur, &new_hp, [addr] { return IsObjOwnedByHuman(addr); })) return;
     }
     if (g_real_SetHP) g_real_SetHP(obj, new_hp);
 }
@@ -994,6 +1049,43 @@ static int DoString(lua_State* L, const char* code, const char* chunkname = "=pi
     return fn_pcall(L, 0, 1, 0);
 }
 
+// Precompiled helper scripts -- mirrors CompileHelperScript /
+// PushHelperScript in lua_bridge.cpp. The script bodies live only in the
+// bridge; these stand-ins share its keys and the "return function" shape.
+enum HelperScriptId { HELPER_GET_PLANETS = 0, HELPER_FACTION_ROSTER, HELPER_REVEAL_ALL, HELPER_SCRIPT_COUNT };
+struct HelperScript { const char* key; const char* chunkname; const char* code; };
+static const HelperScript kHelperScripts[HELPER_SCRIPT_COUNT] = {
+    {"SWFOC.Helper.GetPlanets",    "=SWFOC_GetPlanets",       "return function()\nreturn '(no_planets)'\nend"},
+    {"SWFOC.Helper.FactionRoster", "=SWFOC_GetFactionRoster", "return function(target)\nreturn '(empty)'\nend"},
+    {"SWFOC.Helper.RevealAll",     "=SWFOC_RevealAll",        "return function(who)\nend"},
+};
+
+static bool CompileHelperScript(lua_State* L, int id) {
+    const HelperScript& h = kHelperScripts[id];
+    if (!fn_load || !fn_pcall) return false;
+    fn_pushstring(L, h.key);
+    StringReaderData rd = { h.code, strlen(h.code), false };
+    int err = fn_load(L, (lua_Chunkreader)StringReader, &rd, h.chunkname);
+    if (err == 0) err = fn_pcall(L, 0, 1, 0);
+    if (err != 0 || fn_type(L, -1) != LUA_TFUNCTION) {
+        fn_settop(L, -3);
+        return false;
+    }
+    fn_settable(L, LUA_REGISTRYINDEX);
+    return true;
+}
+
+static bool PushHelperScript(lua_State* L, int id) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        fn_pushstring(L, kHelperScripts[id].key);
+        fn_gettable(L, LUA_REGISTRYINDEX);
+        if (fn_type(L, -1) == LUA_TFUNCTION) return true;
+        fn_settop(L, -2);
+        if (attempt == 0 && !CompileHelperScript(L, id)) return false;
+    }
+    return false;
+}
+
 static int Lua_DoString(lua_State* L) {
     const char* code = fn_tostring(L, 1);
     if (!code) {
@@ -1026,11 +1118,11 @@ static int Lua_DrainPipe(lua_State* L) {
 
 static int SWFOC_StateInfo(lua_State* L) {
     EnterCriticalSection(&csGameStates);
-    int count = (int)cached_game_states.size();
+    int count = (int)cached_game_states.states.size();
     std::string info = "Game states: " + std::to_string(count) + "\n";
     for (int i = 0; i < count; i++) {
         char buf[64];
-        snprintf(buf, sizeof(buf), "  [%d] %p\n", i, cached_game_states[i]);
+        snprintf(buf, sizeof(buf), "  [%d] %p\n", i, cached_game_states.states[i]);
         info += buf;
     }
     LeaveCriticalSection(&csGameStates);
@@ -1041,11 +1133,16 @@ static int SWFOC_StateInfo(lua_State* L) {
 static int Lua_EventControl(lua_State* L) {
     if (!g_evtBuf) { fn_pushnumber(L, 0); return 1; }
     int enable = (int)fn_tonumber(L, 1);
+    const bool compact = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TSTRING
+        && strcmp(fn_tostring(L, 2), "compact") == 0;
     if (enable) {
-        g_evtBuf->write_pos.store(0, std::memory_order_release);
-        g_evtBuf->read_pos.store(0, std::memory_order_release);
-        g_evtBuf->event_count.store(0, std::memory_order_release);
-        g_evtBuf->flags.store(1, std::memory_order_release);
+        g_evtBuf->flags.store(0, std::memory_order_release);
+        ShmEvtDiscard(g_evtBuf);
+        if (compact) {
+            EvtStreamInfo info = {EVT_COMPACT_ENCODING, 0};
+            ShmEvtWrite(g_evtBuf, EVT_STREAM_INFO, &info, sizeof(info));
+        }
+        g_evtBuf->flags.store(compact ? 1 | SHMEM_EVT_FLAG_COMPACT : 1, std::memory_order_release);
     } else {
         g_evtBuf->flags.store(0, std::memory_order_release);
     }
@@ -1059,30 +1156,6 @@ static int Lua_EventControl(lua_State* L) {
 // TestSnapshotFormat below.
 // ======================================================================
 
-static uint32_t g_crc32Table[256];
-static bool g_crc32TableReady = false;
-
-static void Crc32_BuildTable() {
-    for (uint32_t i = 0; i < 256; i++) {
-        uint32_t c = i;
-        for (int k = 0; k < 8; k++) {
-            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
-        }
-        g_crc32Table[i] = c;
-    }
-    g_crc32TableReady = true;
-}
-
-static uint32_t Crc32_Update(uint32_t crc, const void* data, size_t len) {
-    if (!g_crc32TableReady) Crc32_BuildTable();
-    const uint8_t* p = (const uint8_t*)data;
-    crc = crc ^ 0xFFFFFFFFu;
-    for (size_t i = 0; i < len; i++) {
-        crc = g_crc32Table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
-    }
-    return crc ^ 0xFFFFFFFFu;
-}
-
 static const char* const kDumpObjectTypes[] = {
     "Vengeance_Frigate",
     "Nebulon_B_Frigate",
@@ -1122,29 +1195,6 @@ static const char* const kDumpGlobals[] = {
 static const uint32_t kDumpGlobalsCount =
     sizeof(kDumpGlobals) / sizeof(kDumpGlobals[0]);
 
-struct DumpBuf {
-    std::vector<uint8_t> bytes;
-    uint32_t crc;
-    DumpBuf() : crc(0) {}
-    void append(const void* p, size_t n) {
-        const uint8_t* b = (const uint8_t*)p;
-        bytes.insert(bytes.end(), b, b + n);
-    }
-    void u8(uint8_t v)   { append(&v, 1); }
-    void u16(uint16_t v) { append(&v, 2); }
-    void u32(uint32_t v) { append(&v, 4); }
-    void u64(uint64_t v) { append(&v, 8); }
-    void f64(double v)   { append(&v, 8); }
-    void fixedStr(const char* s, size_t width) {
-        std::vector<uint8_t> tmp(width, 0);
-        if (s) {
-            size_t n = strnlen(s, width);
-            memcpy(tmp.data(), s, n);
-        }
-        append(tmp.data(), width);
-    }
-};
-
 // In the test harness all memory is real VirtualAlloc memory, so these
 // just wrap the raw dereferences. No IsBadReadPtr guard needed offline.
 static uint64_t HarnessReadU64(uintptr_t addr) {
@@ -1172,8 +1222,8 @@ static uint64_t CaptureTimestampMs() {
     return (ft100ns / 10000ULL) - kEpochDeltaMs;
 }
 
-static void WriteGlobalRecord(lua_State* L, DumpBuf& buf, const char* name) {
-    buf.fixedStr(name, 64);
+static void WriteGlobalRecord(lua_State* L, SnapWriter* w, const char* name) {
+    SnapFixedStr(w, name, 64);
     int savedTop = fn_gettop(L);
     fn_pushstring(L, name);
     fn_gettable(L, LUA_GLOBALSINDEX);
@@ -1191,10 +1241,9 @@ static void WriteGlobalRecord(lua_State* L, DumpBuf& buf, const char* name) {
         ty = LUA_TNIL;
     }
     fn_settop(L, savedTop);
-    buf.u8((uint8_t)(ty & 0xFF));
-    uint8_t pad[7] = {0};
-    buf.append(pad, 7);
-    buf.u64(raw);
+    SnapU8(w, (uint8_t)(ty & 0xFF));
+    SnapZeros(w, 7);
+    SnapU64(w, raw);
 }
 
 // Offline version: the fake Lua cannot model Alamo engine globals, so we
@@ -1205,189 +1254,386 @@ static uint32_t QueryObjectTypeCount(lua_State* L, const char* typeName) {
     return 0;
 }
 
-static void WriteMetaPair(DumpBuf& buf, const char* key, const char* value) {
+static void WriteMetaPair(SnapWriter* w, const char* key, const char* value) {
     size_t kl = key ? strnlen(key, 0xFFFE) : 0;
     size_t vl = value ? strnlen(value, 0xFFFE) : 0;
-    buf.u16((uint16_t)kl);
-    buf.append(key, kl);
-    buf.u16((uint16_t)vl);
-    buf.append(value, vl);
+    SnapU16(w, (uint16_t)kl);
+    SnapPut(w, key, kl);
+    SnapU16(w, (uint16_t)vl);
+    SnapPut(w, value, vl);
 }
 
-static int Lua_DumpState(lua_State* L) {
-    const char* path = fn_tostring(L, 1);
-    if (!path || !path[0]) {
-        fn_pushstring(L, "ERR: SWFOC_DumpState: expected string path argument");
-        return 1;
-    }
-    DumpBuf buf;
-
+static void CaptureSnapshot(lua_State* L, SnapWriter* w) {
     // Header — bumped to v2 in 2026-04-08 to match the bridge writer.
+    const uint32_t version = w->base ? 4 : w->lz4 ? 3 : 2;
     const uint8_t kMagic[16] = {
-        'S','W','F','O','C','S','N','A','P','v','2',0,0,0,0,0
+        'S','W','F','O','C','S','N','A','P','v', (uint8_t)('0' + version),
+        0,0,0,0,0
     };
-    buf.append(kMagic, 16);
-    buf.u32(2);
-    buf.u64(CaptureTimestampMs());
-    uint8_t zeroHash[32] = {0};
-    buf.append(zeroHash, 32);
-    buf.u8(0);
-    uint8_t headerPad[7] = {0};
-    buf.append(headerPad, 7);
+    SnapPut(w, kMagic, 16);
+    SnapU32(w, version);
+    SnapU64(w, CaptureTimestampMs());
+    SnapZeros(w, 32);
+    SnapU8(w, 0);
+    SnapZeros(w, 7);
+
+    if (w->base) SnapWriteDeltaBase(w);
 
     // Section 1: player_array
     {
-        DumpBuf sec;
+        SnapBeginSection(w, 1);
         int32_t rawCount = (int32_t)HarnessReadU32(g_base + RVA::PlayerCount_Global);
         if (rawCount < 0) rawCount = 0;
         if (rawCount > 8) rawCount = 8;
         uint32_t clamped = (uint32_t)rawCount;
         uintptr_t arrBase = (uintptr_t)HarnessReadU64(g_base + RVA::PlayerArray_Global);
         uint32_t actual = 0;
-        sec.u32(0); // placeholder for player_count, patched at end
+        const size_t countOff = SnapOffset(w);
+        SnapU32(w, 0); // placeholder for player_count, patched at end
         // v2 addition: explicit local_slot. UINT32_MAX = no local player.
         int localSlotInt = FindLocalPlayerSlot();
         uint32_t localSlot = (localSlotInt < 0) ? 0xFFFFFFFFu : (uint32_t)localSlotInt;
-        sec.u32(localSlot);
+        SnapU32(w, localSlot);
         for (uint32_t i = 0; i < clamped; i++) {
             uint64_t pPtr = arrBase ? HarnessReadU64(arrBase + i * 8) : 0;
             if (!pPtr) continue;
-            sec.u32(i);
+            SnapU32(w, i);
             const char* faction = HarnessReadCStr(pPtr + RVA::PlayerObj::FactionName);
-            sec.fixedStr(faction ? faction : "", 64);
+            SnapFixedStr(w, faction ? faction : "", 64);
             float c = HarnessReadF32(pPtr + RVA::PlayerObj::Credits);
-            sec.f64((double)c);
+            SnapF64(w, (double)c);
             int32_t tech = (int32_t)HarnessReadU32(pPtr + RVA::PlayerObj::TechLevel);
-            sec.append(&tech, 4);
-            sec.fixedStr("", 64);
+            SnapPut(w, &tech, 4);
+            SnapZeros(w, 64);
             actual++;
         }
-        memcpy(sec.bytes.data(), &actual, 4);
-        buf.u32(1);
-        buf.u32((uint32_t)sec.bytes.size());
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapPatchU32(w, countOff, actual);
+        SnapEndSection(w);
     }
 
     // Section 2: lua_state_registry
     {
-        DumpBuf sec;
+        SnapBeginSection(w, 2);
         EnterCriticalSection(&csRegistered);
-        uint32_t stateCount = (uint32_t)registered_states.size();
+        uint32_t stateCount = (uint32_t)registered_states.states.size();
         if (stateCount > 1024) stateCount = 1024;
-        sec.u32(stateCount);
+        SnapU32(w, stateCount);
         for (uint32_t i = 0; i < stateCount; i++) {
-            sec.u64((uint64_t)(uintptr_t)registered_states[i]);
+            SnapU64(w, (uint64_t)(uintptr_t)registered_states.states[i]);
         }
         LeaveCriticalSection(&csRegistered);
-        buf.u32(2);
-        buf.u32((uint32_t)sec.bytes.size());
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // Section 3: object_catalog
     {
-        DumpBuf sec;
-        sec.u32(kDumpObjectTypesCount);
+        SnapBeginSection(w, 3);
+        SnapU32(w, kDumpObjectTypesCount);
         for (uint32_t i = 0; i < kDumpObjectTypesCount; i++) {
-            sec.fixedStr(kDumpObjectTypes[i], 64);
+            SnapFixedStr(w, kDumpObjectTypes[i], 64);
             uint32_t count = QueryObjectTypeCount(L, kDumpObjectTypes[i]);
-            sec.u32(count);
+            SnapU32(w, count);
         }
-        buf.u32(3);
-        buf.u32((uint32_t)sec.bytes.size());
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // Section 4: global_registry
     {
-        DumpBuf sec;
-        sec.u32(kDumpGlobalsCount);
+        SnapBeginSection(w, 4);
+        SnapU32(w, kDumpGlobalsCount);
         for (uint32_t i = 0; i < kDumpGlobalsCount; i++) {
-            WriteGlobalRecord(L, sec, kDumpGlobals[i]);
+            WriteGlobalRecord(L, w, kDumpGlobals[i]);
         }
-        buf.u32(4);
-        buf.u32((uint32_t)sec.bytes.size());
-        buf.append(sec.bytes.data(), sec.bytes.size());
+        SnapEndSection(w);
     }
 
     // Section 5: metadata
     {
-        DumpBuf sec;
-        sec.u32(4);
-        WriteMetaPair(sec, "capture_method",       "powrprof_dll");
-        WriteMetaPair(sec, "mod_name",             "unknown");
-        WriteMetaPair(sec, "mod_version",          "unknown");
-        WriteMetaPair(sec, "swfoc_bridge_version", "1.0");
-        buf.u32(5);
-        buf.u32((uint32_t)sec.bytes.size());
-        buf.append(sec.bytes.data(), sec.bytes.size());
-    }
-
-    // End marker
-    uint32_t endId = 0xFFFFFFFFu;
-    uint32_t endLen = 4;
-    buf.u32(endId);
-    buf.u32(endLen);
-    uint32_t crc = Crc32_Update(0, buf.bytes.data(), buf.bytes.size());
-    buf.u32(crc);
-
-    FILE* f = fopen(path, "wb");
-    if (!f) {
+        SnapBeginSection(w, 5);
+        SnapU32(w, 4);
+        WriteMetaPair(w, "capture_method",       "powrprof_dll");
+        WriteMetaPair(w, "mod_name",             "unknown");
+        WriteMetaPair(w, "mod_version",          "unknown");
+        WriteMetaPair(w, "swfoc_bridge_version", "1.0");
+        SnapEndSection(w);
+    }
+}
+
+static int PushSnapResult(lua_State* L, const char* path, const SnapWriteResult& res) {
+    if (!res.opened) {
         char errbuf[512];
         snprintf(errbuf, sizeof(errbuf),
                  "ERR: SWFOC_DumpState: could not open '%s' for write", path);
         fn_pushstring(L, errbuf);
         return 1;
     }
-    size_t wrote = fwrite(buf.bytes.data(), 1, buf.bytes.size(), f);
-    fclose(f);
-    if (wrote != buf.bytes.size()) {
+    if (res.written != res.total) {
         char errbuf[512];
         snprintf(errbuf, sizeof(errbuf),
                  "ERR: SWFOC_DumpState: short write (%zu of %zu bytes) to '%s'",
-                 wrote, buf.bytes.size(), path);
+                 res.written, res.total, path);
         fn_pushstring(L, errbuf);
         return 1;
     }
 
     char okbuf[512];
-    snprintf(okbuf, sizeof(okbuf),
-             "OK: snapshot written to %s (%zu bytes)", path, buf.bytes.size());
+    if (res.lz4 || res.delta) {
+        snprintf(okbuf, sizeof(okbuf),
+                 "OK: snapshot written to %s (%zu bytes, %s from %zu)", path, res.total,
+                 res.delta ? (res.lz4 ? "lz4 delta" : "delta") : "lz4", res.raw);
+    } else {
+        snprintf(okbuf, sizeof(okbuf),
+                 "OK: snapshot written to %s (%zu bytes)", path, res.total);
+    }
     fn_pushstring(L, okbuf);
     return 1;
 }
 
+static SnapStream g_snapBase;
+
+static bool ParseSnapCodec(lua_State* L, const char* fnName, bool* lz4, bool* delta) {
+    const char* codec = fn_tostring(L, 2);
+    *lz4 = false;
+    *delta = false;
+    if (!codec || strcmp(codec, "raw") == 0) return true;
+    if (strcmp(codec, "lz4") == 0 || strcmp(codec, "lz4+delta") == 0) *lz4 = true;
+    if (strcmp(codec, "delta") == 0 || strcmp(codec, "lz4+delta") == 0) *delta = true;
+    char errbuf[160];
+    if (!*lz4 && !*delta) {
+        snprintf(errbuf, sizeof(errbuf),
+                 "ERR: %s: unknown codec '%.32s' (expected raw, lz4, delta or lz4+delta)",
+                 fnName, codec);
+    } else if (*delta && !g_snapBase) {
+        snprintf(errbuf, sizeof(errbuf),
+                 "ERR: %s: no base capture for a delta yet (take a full one first)", fnName);
+    } else {
+        return true;
+    }
+    fn_pushstring(L, errbuf);
+    return false;
+}
+
+static void AdoptSnapBase(SnapWriter* w, const SnapWriteResult& res) {
+    if (!res.opened || res.written != res.total || w->kept.size() < 68 + 12) return;
+    if (g_snapBase && SnapStreamTimestamp(g_snapBase->data()) > SnapStreamTimestamp(w->kept.data())) {
+        return;
+    }
+    g_snapBase = std::make_shared<const std::vector<uint8_t>>(std::move(w->kept));
+}
+
+static int Lua_DumpState(lua_State* L) {
+    const char* path = fn_tostring(L, 1);
+    if (!path || !path[0]) {
+        fn_pushstring(L, "ERR: SWFOC_DumpState: expected string path argument");
+        return 1;
+    }
+    bool lz4, delta;
+    if (!ParseSnapCodec(L, "SWFOC_DumpState", &lz4, &delta)) return 1;
+    SnapWriter w;
+    SnapWriterOpen(&w, path, Crc32_Update);
+    SnapWriterKeepStream(&w);
+    SnapWriterIndexSections(&w, 68);
+    if (lz4) SnapWriterCompressSections(&w, 68);
+    if (delta) SnapWriterDeltaAgainst(&w, g_snapBase, 68);
+
+    CaptureSnapshot(L, &w);
+
+    SnapWriteResult res;
+    SnapWriterFinish(&w, &res);
+    AdoptSnapBase(&w, res);
+    return PushSnapResult(L, path, res);
+}
+
+// SWFOC_DumpStateAsync / SWFOC_DumpStatePoll replica.
+#define SNAP_ASYNC_SLOTS 4
+
+struct SnapAsyncJob {
+    uint32_t    id;
+    SnapWriter* writer;
+    char        path[MAX_PATH];
+};
+
+static SnapAsyncJob g_snapJobs[SNAP_ASYNC_SLOTS];
+static uint32_t     g_snapNextJobId = 1;
+
+static void RetireSnapJob(SnapAsyncJob* job, SnapWriteResult* res) {
+    SnapWriterCollect(job->writer, res);
+    AdoptSnapBase(job->writer, *res);
+    delete job->writer;
+    job->writer = nullptr;
+    job->id = 0;
+}
+
+static SnapAsyncJob* ClaimSnapJobSlot() {
+    for (SnapAsyncJob& job : g_snapJobs) {
+        if (job.id == 0) return &job;
+    }
+    SnapAsyncJob* oldest = nullptr;
+    for (SnapAsyncJob& job : g_snapJobs) {
+        if (SnapWriterDone(job.writer) && (!oldest || job.id < oldest->id)) oldest = &job;
+    }
+    if (oldest) {
+        SnapWriteResult dropped;
+        RetireSnapJob(oldest, &dropped);
+    }
+    return oldest;
+}
+
+static int Lua_DumpStateAsync(lua_State* L) {
+    const char* path = fn_tostring(L, 1);
+    if (!path || !path[0]) {
+        fn_pushstring(L, "ERR: SWFOC_DumpStateAsync: expected string path argument");
+        return 1;
+    }
+    if (strlen(path) >= MAX_PATH) {
+        fn_pushstring(L, "ERR: SWFOC_DumpStateAsync: path too long");
+        return 1;
+    }
+    bool lz4, delta;
+    if (!ParseSnapCodec(L, "SWFOC_DumpStateAsync", &lz4, &delta)) return 1;
+    SnapAsyncJob* job = ClaimSnapJobSlot();
+    if (!job) {
+        fn_pushstring(L, "ERR: SWFOC_DumpStateAsync: all capture slots still writing");
+        return 1;
+    }
+    job->writer = new SnapWriter;
+    SnapWriterOpen(job->writer, path, Crc32_Update, true);
+    SnapWriterKeepStream(job->writer);
+    SnapWriterIndexSections(job->writer, 68);
+    if (lz4) SnapWriterCompressSections(job->writer, 68);
+    if (delta) SnapWriterDeltaAgainst(job->writer, g_snapBase, 68);
+    CaptureSnapshot(L, job->writer);
+    const size_t staged = SnapOffset(job->writer) + 12;
+    SnapWriterClose(job->writer);
+    job->id = g_snapNextJobId++;
+    if (g_snapNextJobId == 0) g_snapNextJobId = 1;
+    snprintf(job->path, sizeof(job->path), "%s", path);
+
+    char okbuf[512];
+    snprintf(okbuf, sizeof(okbuf), "OK: queued id=%u (%zu bytes staged) for %s",
+             job->id, staged, path);
+    fn_pushstring(L, okbuf);
+    return 1;
+}
+
+static int Lua_DumpStatePoll(lua_State* L) {
+    const uint32_t id = (uint32_t)fn_tonumber(L, 1);
+    for (SnapAsyncJob& job : g_snapJobs) {
+        if (job.id == 0 || job.id != id) continue;
+        if (!SnapWriterDone(job.writer)) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "PENDING id=%u", id);
+            fn_pushstring(L, buf);
+            return 1;
+        }
+        char path[MAX_PATH];
+        snprintf(path, sizeof(path), "%s", job.path);
+        SnapWriteResult res;
+        RetireSnapJob(&job, &res);
+        return PushSnapResult(L, path, res);
+    }
+    char errbuf[96];
+    snprintf(errbuf, sizeof(errbuf), "ERR: SWFOC_DumpStatePoll: unknown capture id %u", id);
+    fn_pushstring(L, errbuf);
+    return 1;
+}
+
 // DrainPipeCommand replica
-bool DrainPipeCommand_impl(lua_State* L) {
-    EnterCriticalSection(&g_pipeLock);
-    if (!g_pipeCmdPending) {
-        LeaveCriticalSection(&g_pipeLock);
-        return false;
+static int64_t PipeQpcNow_impl() {
+    g_harnessQpc += g_harnessQpcStep;
+    return g_harnessQpc;
+}
+
+static void PipeBatchCursorBegin_impl(PipeBatchCursor* c, PipeCmdSlot* slot) {
+    c->slot  = slot;
+    c->next  = slot->cmd;
+    c->index = 0;
+    c->off   = PipeBatchBegin(slot->result, sizeof(slot->result), slot->batchCount);
+}
+
+static bool ExecutePipeBatchStep_impl(lua_State* L, PipeBatchCursor* c, const PipeDrainBudget* budget) {
+    const size_t kEntryReserve = 32;
+    PipeCmdSlot* slot = c->slot;
+    const uint32_t count = slot->batchCount;
+    for (bool first = true; c->index < count; first = false) {
+        if (!first && PipeBudgetSpent(budget, PipeQpcNow_impl())) return false;
+        const uint32_t i = c->index;
+        const size_t chunkLen = strlen(c->next);
+        int savedTop = fn_gettop(L);
+        int err = DoString(L, c->next, "=pipe");
+        const char* text = fn_tostring(L, -1);
+        if (!text) text = (err == 0) ? "" : "unknown error";
+        const size_t room = sizeof(slot->result) - (count - i - 1) * kEntryReserve;
+        if (!PipeBatchAppend(slot->result, room, &c->off, err == 0, text, strlen(text))) {
+            static const char kTrunc[] = "result truncated";
+            PipeBatchAppend(slot->result, sizeof(slot->result), &c->off, false, kTrunc, sizeof(kTrunc) - 1);
+        }
+        fn_settop(L, savedTop);
+        c->next += chunkLen + 1;
+        c->index++;
     }
-    char cmd[PIPE_CMD_MAX];
-    memcpy(cmd, g_pipeCmd, PIPE_CMD_MAX);
-    LeaveCriticalSection(&g_pipeLock);
+    return true;
+}
 
+static void ExecutePipeSlot_impl(lua_State* L, PipeCmdSlot* slot) {
     int savedTop = fn_gettop(L);
-    int err = DoString(L, cmd, "=pipe");
+    int err = DoString(L, slot->cmd, "=pipe");
 
-    EnterCriticalSection(&g_pipeLock);
     if (err == 0) {
         const char* retVal = fn_tostring(L, -1);
         if (retVal && retVal[0])
-            snprintf(g_pipeResult, sizeof(g_pipeResult), "%s\n", retVal);
+            snprintf(slot->result, sizeof(slot->result), "%s\n", retVal);
         else
-            strcpy(g_pipeResult, "OK\n");
+            strcpy(slot->result, "OK\n");
     } else {
         const char* errMsg = fn_tostring(L, -1);
         if (!errMsg) errMsg = "unknown error";
-        snprintf(g_pipeResult, sizeof(g_pipeResult), "ERR: %s\n", errMsg);
+        snprintf(slot->result, sizeof(slot->result), "ERR: %s\n", errMsg);
     }
     fn_settop(L, savedTop);
-    g_pipeResultReady = true;
-    g_pipeCmdPending = false;
-    LeaveCriticalSection(&g_pipeLock);
-    return true;
+}
+
+static bool PipeHasPendingWork_impl() {
+    return PipeQueueHasWork(&g_pipeQueue) || g_pipeBatchCursor.slot != nullptr;
+}
+
+bool DrainPipeCommand_impl(lua_State* L) {
+    const bool nested = ++g_pipeDrainDepth > 1;
+    PipeDrainBudget budget;
+    PipeBudgetBegin(&budget, PipeQpcNow_impl(), kHarnessQpcFreq, nested ? 0 : (uint32_t)g_pipeDrainBudgetUs);
+    PipeBatchCursor local = {};
+    PipeBatchCursor* cursor = nested ? &local : &g_pipeBatchCursor;
+    int executed = 0;
+    bool parked = false;
+    if (cursor->slot) {
+        executed++;
+        if (ExecutePipeBatchStep_impl(L, cursor, &budget)) {
+            PipeQueueComplete(&g_pipeQueue, cursor->slot);
+            cursor->slot = nullptr;
+        } else {
+            parked = true;
+        }
+    }
+    while (!parked && executed < PIPE_DRAIN_MAX_PER_CALL) {
+        if (executed > 0 && PipeBudgetSpent(&budget, PipeQpcNow_impl())) break;
+        PipeCmdSlot* slot = PipeQueuePop(&g_pipeQueue);
+        if (!slot) break;
+        executed++;
+        if (slot->batchCount) {
+            PipeBatchCursorBegin_impl(cursor, slot);
+            if (!ExecutePipeBatchStep_impl(L, cursor, &budget)) {
+                parked = true;
+                break;
+            }
+            cursor->slot = nullptr;
+        } else {
+            ExecutePipeSlot_impl(L, slot);
+        }
+        PipeQueueComplete(&g_pipeQueue, slot);
+    }
+    if (!nested && PipeHasPendingWork_impl()) g_pipeDeferredCount++;
+    g_pipeDrainDepth--;
+    return executed > 0;
 }
 
 // RegisterAll replica
@@ -1427,24 +1673,23 @@ static void RegisterAll(lua_State* L) {
 // lua_close hook replica
 static void Hook_lua_close(void* L) {
     EnterCriticalSection(&csGameStates);
-    auto it = std::find(cached_game_states.begin(), cached_game_states.end(), L);
-    if (it != cached_game_states.end()) cached_game_states.erase(it);
+    StateRegistryErase(&cached_game_states, L);
     LeaveCriticalSection(&csGameStates);
 
     EnterCriticalSection(&csRegistered);
-    auto it2 = std::find(registered_states.begin(), registered_states.end(), L);
-    if (it2 != registered_states.end()) registered_states.erase(it2);
+    StateRegistryErase(&registered_states, L);
     LeaveCriticalSection(&csRegistered);
 }
 
 // Reset all mutable bridge state between suites
 static void ResetBridgeState() {
-    registered_states.clear();
-    cached_game_states.clear();
-    g_pipeCmdPending = false;
-    g_pipeResultReady = false;
-    memset(g_pipeCmd, 0, sizeof(g_pipeCmd));
-    memset(g_pipeResult, 0, sizeof(g_pipeResult));
+    StateRegistryReset(&registered_states);
+    StateRegistryReset(&cached_game_states);
+    PipeQueueReset(&g_pipeQueue);
+    g_pipeBatchCursor = {};
+    g_pipeDrainBudgetUs = PIPE_DRAIN_BUDGET_US_DEFAULT;
+    g_pipeDeferredCount = 0;
+    g_harnessQpcStep = 0;
     g_lastCmdSeq = 0;
     memset(&g_shmCmdBuf, 0, sizeof(g_shmCmdBuf));
     memset(&g_shmEvtBuf, 0, sizeof(g_shmEvtBuf));
@@ -1465,39 +1710,94 @@ static void TestStateRegistration() {
     // Register all 5
     for (int i = 0; i < 5; i++) {
         EnterCriticalSection(&csRegistered);
-        registered_states.push_back((void*)&states[i]);
+        StateRegistryInsert(&registered_states, (void*)&states[i]);
         LeaveCriticalSection(&csRegistered);
     }
-    Check(registered_states.size() == 5, "Register 5 states");
+    Check(registered_states.states.size() == 5, "Register 5 states");
 
     // Cache 2 game states
     for (int i = 0; i < 5; i++) {
         if (states[i].has_game_globals) {
             EnterCriticalSection(&csGameStates);
-            cached_game_states.push_back((void*)&states[i]);
+            StateRegistryInsert(&cached_game_states, (void*)&states[i]);
             LeaveCriticalSection(&csGameStates);
         }
     }
-    Check(cached_game_states.size() == 2, "2 game states cached");
+    Check(cached_game_states.states.size() == 2, "2 game states cached");
 
     bool allFound = true;
     for (int i = 0; i < 5; i++) {
-        if (std::find(registered_states.begin(), registered_states.end(),
-                      (void*)&states[i]) == registered_states.end())
+        if (!StateRegistryHas(&registered_states, &states[i]) || !StateSetContains(&registered_states.set, &states[i]))
             allFound = false;
     }
     Check(allFound, "All 5 in registered_states");
 
     Hook_lua_close((void*)&states[1]);
-    Check(registered_states.size() == 4, "lua_close removes from registered");
-    Check(cached_game_states.size() == 1, "lua_close removes from game cache");
+    Check(registered_states.states.size() == 4, "lua_close removes from registered");
+    Check(cached_game_states.states.size() == 1, "lua_close removes from game cache");
 
     Hook_lua_close((void*)&states[0]);
-    Check(registered_states.size() == 3, "lua_close removes non-game state");
-    Check(cached_game_states.size() == 1, "Game cache unchanged for non-game state");
+    Check(registered_states.states.size() == 3, "lua_close removes non-game state");
+    Check(cached_game_states.states.size() == 1, "Game cache unchanged for non-game state");
 
     Hook_lua_close((void*)&states[0]);
-    Check(registered_states.size() == 3, "Double lua_close is safe (no crash)");
+    Check(registered_states.states.size() == 3, "Double lua_close is safe (no crash)");
+
+    // Lock-free registered-state set used by Hook_luaD_call (state_set.h)
+    static StatePtrSet set;
+    static char arena[STATE_SET_MAX_LIVE * 16];
+    StateSetReset(&set);
+    Check(!StateSetContains(&set, &states[0]), "Empty set contains nothing");
+    Check(StateSetInsert(&set, &states[0]) && StateSetInsert(&set, &states[0]) && set.live == 1,
+          "Re-inserting a state is idempotent");
+    StateSetErase(&set, &states[0]);
+    Check(!StateSetContains(&set, &states[0]) && set.live == 0, "Erase removes the state");
+    StateSetErase(&set, &states[0]);
+    Check(set.live == 0, "Erasing an absent state is a no-op");
+
+    bool filled = true;
+    for (int i = 0; i < STATE_SET_MAX_LIVE; i++) filled &= StateSetInsert(&set, arena + i * 16);
+    Check(filled && set.live == STATE_SET_MAX_LIVE, "Set holds STATE_SET_MAX_LIVE states");
+    Check(!StateSetInsert(&set, &states[1]) && set.overflow.load(), "Insert past the cap latches overflow");
+
+    // Churn: drop every other entry; survivors must stay reachable (the
+    // backward shift keeps every probe chain intact without tombstones).
+    for (int i = 0; i < STATE_SET_MAX_LIVE; i += 2) StateSetErase(&set, arena + i * 16);
+    bool survivors = true, gone = true;
+    for (int i = 0; i < STATE_SET_MAX_LIVE; i++) {
+        bool in = StateSetContains(&set, arena + i * 16);
+        if (i % 2) survivors &= in; else gone &= !in;
+    }
+    Check(survivors && gone && set.live == STATE_SET_MAX_LIVE / 2, "Erase churn keeps survivors reachable");
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < STATE_SET_MAX_LIVE; i += 2) StateSetInsert(&set, arena + i * 16);
+        for (int i = 0; i < STATE_SET_MAX_LIVE; i += 2) StateSetErase(&set, arena + i * 16);
+    }
+    survivors = true;
+    for (int i = 1; i < STATE_SET_MAX_LIVE; i += 2) survivors &= StateSetContains(&set, arena + i * 16);
+    Check(survivors && set.live == STATE_SET_MAX_LIVE / 2, "Repeated open/close cycles do not degrade the set");
+
+    // StateRegistry: the list Hook_lua_open / Hook_lua_close keep in O(1)
+    static StateRegistry reg;
+    StateRegistryReset(&reg);
+    Check(StateRegistryOldest(&reg) == nullptr, "Empty registry has no oldest state");
+    for (int i = 0; i < 5; i++) StateRegistryInsert(&reg, arena + i * 16);
+    Check(!StateRegistryInsert(&reg, arena) && reg.states.size() == 5, "Registry insert is idempotent");
+    Check(StateRegistryErase(&reg, arena + 1 * 16) && !StateRegistryErase(&reg, arena + 1 * 16),
+          "Registry erase reports presence once");
+    bool placed = reg.states.size() == 4 && reg.states[1] == arena + 4 * 16;
+    for (size_t i = 0; i < reg.states.size(); i++) placed &= reg.pos.at(reg.states[i]) == i;
+    Check(placed, "Erase moves the last entry into the hole and keeps positions exact");
+    Check(!StateSetContains(&reg.set, arena + 1 * 16) && StateSetContains(&reg.set, arena + 4 * 16),
+          "Registry keeps its lock-free set in step");
+    StateRegistryErase(&reg, arena);
+    Check(StateRegistryOldest(&reg) == arena + 2 * 16, "Oldest is the earliest live insert, not states[0]");
+    for (int round = 0; round < 1000; round++) {
+        StateRegistryInsert(&reg, arena + 100 * 16);
+        StateRegistryErase(&reg, arena + 100 * 16);
+    }
+    Check(reg.states.size() == 3 && reg.pos.size() == 3 && reg.set.live == 3 && StateRegistryOldest(&reg) == arena + 2 * 16,
+          "Open/close churn leaves the registry unchanged");
 }
 
 // ======================================================================
@@ -1511,6 +1811,7 @@ static void TestSWFOCFunctions() {
     GI_WriteFloat(RVA::DefaultHeroRespawnTime, 120.0f);
 
     FakeLuaState L;
+    L.log_calls = true;  // ListFactions and Log are checked through call_log
 
     // GetVersion
     fake_reset(&L);
@@ -1600,16 +1901,16 @@ static void TestSWFOCFunctions() {
 
     // DrainPipe (empty queue)
     fake_reset(&L);
-    g_pipeCmdPending = false;
+    PipeQueueReset(&g_pipeQueue);
     Lua_DrainPipe(LS(&L));
     Check(!L.stack.empty() && L.stack.back().numval == 0.0,
           "DrainPipe returns 0 when queue empty");
 
     // StateInfo
     fake_reset(&L);
-    cached_game_states.clear();
-    cached_game_states.push_back((void*)0x1234);
-    cached_game_states.push_back((void*)0x5678);
+    StateRegistryReset(&cached_game_states);
+    StateRegistryInsert(&cached_game_states, (void*)0x1234);
+    StateRegistryInsert(&cached_game_states, (void*)0x5678);
     SWFOC_StateInfo(LS(&L));
     Check(!L.stack.empty() && L.stack.back().type == LUA_TSTRING,
           "StateInfo returns a string");
@@ -1624,6 +1925,20 @@ static void TestSWFOCFunctions() {
     Lua_EventControl(LS(&L));
     Check(g_evtBuf->flags.load() == 1, "EventControl(1) enables events");
 
+    // EventControl(1, "compact") also sets the compact flag and opens the
+    // stream with EVT_STREAM_INFO
+    fake_reset(&L);
+    { StackEntry a; a.type = LUA_TNUMBER; a.numval = 1.0; L.stack.push_back(a); }
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = "compact"; L.stack.push_back(a); }
+    Lua_EventControl(LS(&L));
+    {
+        uint16_t type = 0, size = 0;
+        uint8_t out[32];
+        Check(g_evtBuf->flags.load() == (1 | SHMEM_EVT_FLAG_COMPACT)
+              && ShmEvtRead(g_evtBuf, &type, out, sizeof(out), &size) && type == EVT_STREAM_INFO
+              && size == sizeof(EvtStreamInfo), "EventControl(1, \"compact\") enables the compact stream");
+    }
+
     // EventControl(0) disable
     fake_reset(&L);
     { StackEntry a; a.type = LUA_TNUMBER; a.numval = 0.0; L.stack.push_back(a); }
@@ -1705,54 +2020,287 @@ static void TestPipeProtocol() {
     FakeLuaState L;
     L.load_error = 0; L.pcall_error = 0;
 
+    char reply[PIPE_CMD_MAX];
+    uint32_t ticket = 0;
+
     // Empty queue
     fake_reset(&L);
-    g_pipeCmdPending = false;
+    PipeQueueReset(&g_pipeQueue);
     bool did = DrainPipeCommand_impl(LS(&L));
     Check(!did, "DrainPipe returns false when empty");
+    Check(!PipeQueueHasWork(&g_pipeQueue), "Empty queue reports no work");
 
     // Queue and drain
     fake_reset(&L);
-    EnterCriticalSection(&g_pipeLock);
-    strncpy(g_pipeCmd, "return SWFOC_GetVersion()", PIPE_CMD_MAX - 1);
-    g_pipeCmdPending = true; g_pipeResultReady = false;
-    LeaveCriticalSection(&g_pipeLock);
+    Check(PipeQueuePush(&g_pipeQueue, "return SWFOC_GetVersion()", 25, &ticket), "Push into empty queue");
+    Check(PipeQueueHasWork(&g_pipeQueue), "Queued command reports work");
+    Check(!PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)), "Result not ready before drain");
     did = DrainPipeCommand_impl(LS(&L));
     Check(did, "DrainPipe executes pending command");
-    Check(g_pipeResultReady, "Pipe result ready after drain");
-    Check(!g_pipeCmdPending, "Pipe command cleared");
-    Check(strlen(g_pipeResult) > 0, "Pipe result has content");
+    Check(!PipeQueueHasWork(&g_pipeQueue), "Pipe command cleared");
+    Check(PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)), "Pipe result ready after drain");
+    Check(strlen(reply) > 0, "Pipe result has content");
+    Check(!PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)), "Result collected only once");
 
     // Drain with pcall error
     fake_reset(&L);
     L.pcall_error = 2; L.pcall_error_msg = "bad argument";
-    EnterCriticalSection(&g_pipeLock);
-    strncpy(g_pipeCmd, "bad_code()", PIPE_CMD_MAX - 1);
-    g_pipeCmdPending = true; g_pipeResultReady = false;
-    LeaveCriticalSection(&g_pipeLock);
+    PipeQueuePush(&g_pipeQueue, "bad_code()", 10, &ticket);
     did = DrainPipeCommand_impl(LS(&L));
     Check(did, "DrainPipe executes error command");
-    Check(strstr(g_pipeResult, "ERR:") != nullptr, "Error result starts with ERR:");
-    Check(strstr(g_pipeResult, "bad argument") != nullptr,
+    PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply));
+    Check(strstr(reply, "ERR:") != nullptr, "Error result starts with ERR:");
+    Check(strstr(reply, "bad argument") != nullptr,
           "Error result contains message");
 
     // Stack guard: verify settop called to restore
     fake_reset(&L);
     L.pcall_error = 0; L.load_error = 0;
     { StackEntry a; a.type = LUA_TNUMBER; a.numval = 999; L.stack.push_back(a); }
-    EnterCriticalSection(&g_pipeLock);
-    strncpy(g_pipeCmd, "return 1", PIPE_CMD_MAX - 1);
-    g_pipeCmdPending = true; g_pipeResultReady = false;
-    LeaveCriticalSection(&g_pipeLock);
+    PipeQueuePush(&g_pipeQueue, "return 1", 8, &ticket);
     DrainPipeCommand_impl(LS(&L));
+    PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply));
     // settop was called with savedTop=1, so stack size should be 1
     Check(L.stack.size() == 1, "Stack guard restores stack after drain");
 
-    // Queue-full (already pending)
-    EnterCriticalSection(&g_pipeLock);
-    g_pipeCmdPending = true;
-    LeaveCriticalSection(&g_pipeLock);
-    Check(g_pipeCmdPending, "Queue full: command still pending");
+    // Multiple producers: every slot accepted, one more rejected, then one
+    // drain pass runs up to PIPE_DRAIN_MAX_PER_CALL of them in ticket order.
+    fake_reset(&L);
+    PipeQueueReset(&g_pipeQueue);
+    uint32_t tickets[PIPE_QUEUE_SLOTS];
+    bool allPushed = true;
+    for (int i = 0; i < PIPE_QUEUE_SLOTS; i++) {
+        char cmd[32];
+        int n = snprintf(cmd, sizeof(cmd), "return %d", i);
+        allPushed = allPushed && PipeQueuePush(&g_pipeQueue, cmd, (size_t)n, &tickets[i]);
+    }
+    Check(allPushed, "Queue accepts PIPE_QUEUE_SLOTS concurrent commands");
+    Check(!PipeQueuePush(&g_pipeQueue, "return 99", 9, &ticket), "Queue full: extra command rejected");
+    did = DrainPipeCommand_impl(LS(&L));
+    int ready = 0;
+    for (int i = 0; i < PIPE_QUEUE_SLOTS; i++)
+        if (PipeQueueCollect(&g_pipeQueue, tickets[i], reply, sizeof(reply))) ready++;
+    Check(did && ready == PIPE_DRAIN_MAX_PER_CALL, "One drain pass runs PIPE_DRAIN_MAX_PER_CALL commands");
+    Check(PipeQueuePush(&g_pipeQueue, "return 8", 8, &ticket), "Collected slots are reusable");
+    while (DrainPipeCommand_impl(LS(&L))) {}
+    Check(!PipeQueueHasWork(&g_pipeQueue), "Repeated drains empty the queue");
+
+    // Abandoned tickets: a queued command the producer gave up on is skipped,
+    // and a late result for a running one is never handed to the next owner.
+    PipeQueueReset(&g_pipeQueue);
+    PipeQueuePush(&g_pipeQueue, "return 1", 8, &ticket);
+    PipeQueueAbandon(&g_pipeQueue, ticket);
+    Check(!DrainPipeCommand_impl(LS(&L)), "Abandoned queued command is not executed");
+    Check(!PipeQueueHasWork(&g_pipeQueue), "Abandoned slot leaves the queue");
+    PipeQueueReset(&g_pipeQueue);
+    PipeQueuePush(&g_pipeQueue, "return 1", 8, &ticket);
+    PipeCmdSlot* running = PipeQueuePop(&g_pipeQueue);
+    PipeQueueAbandon(&g_pipeQueue, ticket);
+    strcpy(running->result, "stale\n");
+    PipeQueueComplete(&g_pipeQueue, running);
+    Check(running->state == PIPE_SLOT_FREE, "Late result for abandoned ticket frees the slot");
+    Check(!PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)), "Late result is not collectable");
+    PipeQueueReset(&g_pipeQueue);
+    Check(PipeQueueDoneEvent(&g_pipeQueue, ticket) != nullptr, "Every slot has a completion event");
+
+    // Batch slot: every chunk runs in one drain pass, results come back
+    // framed in order with a per-chunk status.
+    fake_reset(&L);
+    static const char kPacked[] = "return 1\0return 2\0return 3";
+    Check(PipeQueuePush(&g_pipeQueue, kPacked, sizeof(kPacked), &ticket, 3), "Push packed batch");
+    did = DrainPipeCommand_impl(LS(&L));
+    Check(did && PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)), "Batch drained in one pass");
+    {
+        size_t pos = 0, plen = 0;
+        bool ok = false;
+        const char* payload = nullptr;
+        const size_t rlen = strlen(reply);
+        Check(PipeBatchHeaderCount(reply, rlen, &pos) == 3, "Batch reply announces 3 results");
+        int okCount = 0;
+        while (PipeBatchNext(reply, rlen, &pos, &ok, &payload, &plen)) okCount += ok ? 1 : 0;
+        Check(okCount == 3 && pos == rlen, "Batch reply carries 3 OK entries and nothing else");
+    }
+    fake_reset(&L);
+    L.pcall_error = 2; L.pcall_error_msg = "boom";
+    PipeQueuePush(&g_pipeQueue, kPacked, sizeof(kPacked), &ticket, 3);
+    DrainPipeCommand_impl(LS(&L));
+    PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply));
+    Check(strstr(reply, "ERR 4\nboom") != nullptr, "Batch chunk error keeps its message");
+    Check(L.stack.empty(), "Batch restores the stack after every chunk");
+    L.pcall_error = 0;
+    PipeQueueReset(&g_pipeQueue);
+
+    // Drain budget: once a pass has spent g_pipeDrainBudgetUs, the rest of
+    // the queue waits for the next pass; one command always runs.
+    PipeDrainBudget budget;
+    PipeBudgetBegin(&budget, 100, kHarnessQpcFreq, 0);
+    Check(!PipeBudgetSpent(&budget, 1000000000), "Zero budget never expires");
+    PipeBudgetBegin(&budget, 100, kHarnessQpcFreq, 50);
+    Check(!PipeBudgetSpent(&budget, 149) && PipeBudgetSpent(&budget, 150), "Budget expires after its microseconds");
+    PipeBudgetBegin(&budget, 0, 1000, 1);
+    Check(budget.limit == 1, "Sub-tick budget rounds up to one tick");
+
+    fake_reset(&L);
+    uint32_t t1, t2, t3;
+    PipeQueuePush(&g_pipeQueue, "return 1", 8, &t1);
+    PipeQueuePush(&g_pipeQueue, "return 2", 8, &t2);
+    PipeQueuePush(&g_pipeQueue, "return 3", 8, &t3);
+    g_pipeDrainBudgetUs = 10;
+    g_harnessQpcStep = 20;  // each clock read looks 20 us later
+    LONG deferredBefore = g_pipeDeferredCount;
+    Check(DrainPipeCommand_impl(LS(&L)), "Over-budget pass still runs one command");
+    Check(PipeQueueCollect(&g_pipeQueue, t1, reply, sizeof(reply))
+          && !PipeQueueCollect(&g_pipeQueue, t2, reply, sizeof(reply)), "Over-budget pass defers the rest");
+    Check(g_pipeDeferredCount == deferredBefore + 1, "Deferred pass is counted");
+    g_harnessQpcStep = 0;
+    DrainPipeCommand_impl(LS(&L));
+    Check(PipeQueueCollect(&g_pipeQueue, t2, reply, sizeof(reply))
+          && PipeQueueCollect(&g_pipeQueue, t3, reply, sizeof(reply)), "Deferred commands run on the next pass");
+
+    // A batch that runs out of budget parks and resumes chunk by chunk.
+    fake_reset(&L);
+    PipeQueuePush(&g_pipeQueue, kPacked, sizeof(kPacked), &ticket, 3);
+    g_harnessQpcStep = 20;
+    DrainPipeCommand_impl(LS(&L));
+    Check(g_pipeBatchCursor.slot != nullptr && g_pipeBatchCursor.index == 1, "Batch parks after one chunk");
+    Check(!PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)), "Parked batch is not collectable");
+    Check(PipeHasPendingWork_impl() && !PipeQueueHasWork(&g_pipeQueue), "Parked batch counts as pending work");
+    DrainPipeCommand_impl(LS(&L));
+    Check(g_pipeBatchCursor.index == 2, "Next pass resumes at the second chunk");
+    DrainPipeCommand_impl(LS(&L));
+    Check(g_pipeBatchCursor.slot == nullptr && PipeQueueCollect(&g_pipeQueue, ticket, reply, sizeof(reply)),
+          "Batch completes after its last chunk");
+    {
+        size_t pos = 0, plen = 0;
+        bool ok = false;
+        const char* payload = nullptr;
+        const size_t rlen = strlen(reply);
+        int okCount = 0;
+        Check(PipeBatchHeaderCount(reply, rlen, &pos) == 3, "Resumed batch announces 3 results");
+        while (PipeBatchNext(reply, rlen, &pos, &ok, &payload, &plen)) okCount += ok ? 1 : 0;
+        Check(okCount == 3 && pos == rlen, "Resumed batch reply is one well-formed frame");
+    }
+    Check(L.stack.empty(), "Resumed batch leaves the stack clean");
+    g_harnessQpcStep = 0;
+    g_pipeDrainBudgetUs = PIPE_DRAIN_BUDGET_US_DEFAULT;
+    PipeQueueReset(&g_pipeQueue);
+
+    // Latency histogram: log2 microsecond buckets, percentiles report the
+    // upper bound of the bucket holding the rank.
+    PipeLatencyHistogram hist = {};
+    Check(PipeLatencyPercentile(&hist, 50) == 0, "Empty histogram percentile is 0");
+    Check(PipeLatencyBucket(0) == 0 && PipeLatencyBucket(1) == 0, "Sub-2us latencies land in bucket 0");
+    Check(PipeLatencyBucket(5) == 2 && PipeLatencyBucket(1024) == 10, "Bucket is floor(log2(us))");
+    Check(PipeLatencyBucket(~0ull) == PIPE_LATENCY_BUCKETS - 1, "Huge latency clamps to last bucket");
+    for (int i = 0; i < 98; i++) PipeLatencyRecord(&hist, 300);   // bucket 8
+    PipeLatencyRecord(&hist, 20000);                               // bucket 14
+    PipeLatencyRecord(&hist, 20000);
+    Check(PipeLatencyCount(&hist) == 100, "Histogram counts every record");
+    Check(PipeLatencyPercentile(&hist, 50) == 512, "p50 is the 256-512us bucket bound");
+    Check(PipeLatencyPercentile(&hist, 99) == 32768, "p99 reaches the slow tail bucket");
+    PipeLatencyReset(&hist);
+    Check(PipeLatencyCount(&hist) == 0, "Histogram reset clears buckets");
+}
+
+// Persistent-session framing (pipe_protocol.h). The bridge's pipe instances
+// call these helpers directly, so the rules pinned here are the live ones.
+static void TestPipeFraming() {
+    StartSuite("Pipe Framing");
+
+    bool nulOnly = true;
+    Check(PipeIsDirective("@persist", 8), "'@' frame is a directive");
+    Check(!PipeIsDirective("return 1", 8), "Lua chunk is not a directive");
+    Check(!PipeIsDirective("", 0), "Empty frame is not a directive");
+    Check(PipeParsePersist("@persist", 8, &nulOnly) && !nulOnly, "@persist selects newline framing");
+    Check(PipeParsePersist("@persist nul", 12, &nulOnly) && nulOnly, "@persist nul selects NUL framing");
+    Check(PipeParsePersist("@persist \r", 10, &nulOnly) && !nulOnly, "@persist tolerates trailing whitespace");
+    Check(!PipeParsePersist("@persistent", 11, &nulOnly), "@persistent is rejected");
+    Check(!PipeParsePersist("@batch", 6, &nulOnly), "Unknown directive is rejected");
+
+    // @telemetry: exact directive, fixed little-endian record layout
+    Check(PipeIsTelemetry("@telemetry", 10), "@telemetry is recognized");
+    Check(PipeIsTelemetry("@telemetry \r", 12), "@telemetry tolerates trailing whitespace");
+    Check(!PipeIsTelemetry("@telemetryx", 11), "@telemetryx is rejected");
+    Check(!PipeIsTelemetry("@tele", 5), "Truncated @telemetry is rejected");
+    Check(offsetof(PipeTelemetry, localSlot) == 8 && offsetof(PipeTelemetry, fireRateMult) == 32
+          && offsetof(PipeTelemetry, tick) == 40 && offsetof(PipeTelemetry, sampleTick) == 48,
+          "PipeTelemetry field offsets are pinned");
+    static const unsigned char kMagic[4] = { 'S', 'W', 'T', 'M' };
+    uint32_t magic = PIPE_TELEMETRY_MAGIC;
+    Check(memcmp(&magic, kMagic, 4) == 0, "Telemetry magic reads \"SWTM\" on the wire");
+
+    char buf[64];
+    char out[64];
+    size_t len, flen = 0;
+
+    // Newline mode: CRLF stripped, NUL also terminates, empty frames skipped
+    static const char kMixed[] = "return 1\r\n\nreturn 2\0ret";
+    len = sizeof(kMixed) - 1;
+    memcpy(buf, kMixed, len);
+    Check(PipeTakeFrame(buf, &len, false, out, sizeof(out), &flen)
+          && strcmp(out, "return 1") == 0 && flen == 8, "Newline frame strips CRLF");
+    Check(PipeTakeFrame(buf, &len, false, out, sizeof(out), &flen)
+          && strcmp(out, "return 2") == 0, "Empty line skipped, NUL terminates");
+    Check(!PipeTakeFrame(buf, &len, false, out, sizeof(out), &flen), "Partial frame not taken");
+    Check(len == 3 && memcmp(buf, "ret", 3) == 0, "Partial frame kept at buffer front");
+    memcpy(buf + len, "urn 3\n", 6);
+    len += 6;
+    Check(PipeTakeFrame(buf, &len, false, out, sizeof(out), &flen)
+          && strcmp(out, "return 3") == 0 && len == 0, "Partial frame completes after append");
+
+    // NUL mode: newlines are part of the chunk
+    static const char kMultiLine[] = "local a=1\nreturn a\0";
+    len = sizeof(kMultiLine) - 1;
+    memcpy(buf, kMultiLine, len);
+    Check(PipeTakeFrame(buf, &len, true, out, sizeof(out), &flen)
+          && strcmp(out, "local a=1\nreturn a") == 0 && len == 0, "NUL frame keeps embedded newlines");
+
+    // Only terminators buffered: consumed without producing a frame
+    memcpy(buf, "\n\r\n\0", 4);
+    len = 4;
+    Check(!PipeTakeFrame(buf, &len, false, out, sizeof(out), &flen) && len == 0,
+          "Terminator-only input is discarded");
+
+    // Batch directive
+    uint32_t count = 0;
+    nulOnly = false;
+    Check(PipeParseBatch("@batch 9", 8, &count, &nulOnly) && count == 9 && !nulOnly, "@batch 9 parses");
+    Check(PipeParseBatch("@batch 3 nul", 12, &count, &nulOnly) && count == 3 && nulOnly, "@batch 3 nul selects NUL framing");
+    Check(!PipeParseBatch("@batch 0", 8, &count, &nulOnly), "@batch 0 is rejected");
+    Check(!PipeParseBatch("@batch 65", 9, &count, &nulOnly), "@batch above PIPE_BATCH_MAX is rejected");
+    Check(!PipeParseBatch("@batch", 6, &count, &nulOnly), "@batch without a count is rejected");
+    Check(!PipeParseBatch("@batch 2x", 9, &count, &nulOnly), "@batch with trailing junk is rejected");
+
+    // Batch reply: header + length-prefixed entries round-trip, payloads may
+    // contain newlines, and an entry that does not fit is refused whole.
+    char reply[96];
+    size_t off = PipeBatchBegin(reply, sizeof(reply), 3);
+    Check(off == 9 && memcmp(reply, "@batch 3\n", 9) == 0, "Batch reply header");
+    Check(PipeBatchAppend(reply, sizeof(reply), &off, true, "42", 2), "Append OK entry");
+    Check(PipeBatchAppend(reply, sizeof(reply), &off, false, "bad\narg", 7), "Append ERR entry with newline");
+    Check(PipeBatchAppend(reply, sizeof(reply), &off, true, "", 0), "Append empty (nil) entry");
+    const size_t full = off;
+    Check(!PipeBatchAppend(reply, 40, &off, true, "0123456789", 10) && off == full, "Oversized entry refused");
+    size_t pos = 0;
+    bool ok = false;
+    const char* payload = nullptr;
+    size_t plen = 0;
+    Check(PipeBatchHeaderCount(reply, full, &pos) == 3, "Reader sees 3 entries");
+    Check(PipeBatchNext(reply, full, &pos, &ok, &payload, &plen) && ok && plen == 2 && memcmp(payload, "42", 2) == 0,
+          "Reader entry 1 is OK 42");
+    Check(PipeBatchNext(reply, full, &pos, &ok, &payload, &plen) && !ok && plen == 7, "Reader entry 2 is ERR");
+    Check(PipeBatchNext(reply, full, &pos, &ok, &payload, &plen) && ok && plen == 0, "Reader entry 3 is empty OK");
+    Check(!PipeBatchNext(reply, full, &pos, &ok, &payload, &plen), "Reader stops after last entry");
+    Check(PipeBatchHeaderCount("ERR: oops\n", 10, &pos) == 0, "Non-batch reply has no header");
+    Check(!PipeBatchNext("OK 9\nab", 7, (pos = 0, &pos), &ok, &payload, &plen), "Short payload is rejected");
+
+    // Client-side reply classes.
+    Check(PipeClassifyReply("ERR: queue full, try again\n", 27) == PIPE_REPLY_REJECTED, "Queue-full reply is a rejection");
+    Check(PipeClassifyReply("ERR: timeout (10s)\n", 19) == PIPE_REPLY_TIMED_OUT, "Timeout reply is classified");
+    Check(PipeClassifyReply("ERR: [string \"pipe\"]:1: boom\n", 30) == PIPE_REPLY_ERROR, "Lua error is an error");
+    Check(PipeClassifyReply("5000\n", 5) == PIPE_REPLY_OK && PipeClassifyReply("", 0) == PIPE_REPLY_OK,
+          "Values and empty payloads are OK");
+    Check(PipeClassifyReply("ERR: queue", 10) == PIPE_REPLY_ERROR, "A truncated prefix is a plain error");
 }
 
 // ======================================================================
@@ -1835,36 +2383,258 @@ static void TestSharedMemoryProtocol() {
     // Same seq not re-executed
     Check(g_shmCmdBuf.cmd_seq.load() == g_lastCmdSeq, "Same seq not re-executed");
 
+    // Command ring v2: in-flight slots, oldest-first drain, abandonment
+    {
+        static SharedCmdRing ring;
+        ShmRingInit(&ring);
+        Check(ring.magic == SHMEM_RING_MAGIC && ring.slot_count == SHMEM_RING_SLOTS,
+              "Ring header advertises magic and slot count");
+
+        int a = ShmRingClaim(&ring);
+        int b = ShmRingClaim(&ring);
+        Check(a >= 0 && b >= 0 && a != b, "Two clients claim distinct slots");
+        strcpy(ring.slots[b].cmd, "return 2");
+        uint32_t seqB = ShmRingSubmit(&ring, b, 8);
+        strcpy(ring.slots[a].cmd, "return 1");
+        uint32_t seqA = ShmRingSubmit(&ring, a, 8);
+        Check(ring.pending.load() == 2, "Doorbell counts both queued slots");
+
+        int first = ShmRingPop(&ring);
+        Check(first == b && ring.slots[first].seq == seqB, "Oldest submit pops first");
+        Check(!ShmRingCollect(&ring, b, seqB, nullptr, 0), "Running slot is not collectable");
+        strcpy(ring.slots[b].result, "2");
+        ring.slots[b].result_len = 1;
+        Check(ShmRingComplete(&ring, b), "Completion reports a waiting client");
+
+        char out[16];
+        Check(!ShmRingCollect(&ring, b, seqB + 100, out, sizeof(out)), "Wrong seq is not collected");
+        Check(ShmRingCollect(&ring, b, seqB, out, sizeof(out)) && strcmp(out, "2") == 0,
+              "Client collects its own result");
+        Check(ring.slots[b].state.load() == SHM_SLOT_FREE, "Collect frees the slot");
+
+        int second = ShmRingPop(&ring);
+        Check(second == a && ring.pending.load() == 0, "Second command pops, doorbell clear");
+        ShmRingAbandon(&ring, a);
+        Check(ring.slots[a].state.load() == SHM_SLOT_ABANDONED, "Abandoning a running slot defers the free");
+        Check(!ShmRingComplete(&ring, a) && ring.slots[a].state.load() == SHM_SLOT_FREE,
+              "Late completion of an abandoned slot frees it silently");
+        Check(!ShmRingCollect(&ring, a, seqA, out, sizeof(out)), "Abandoned result is never collected");
+
+        for (int i = 0; i < SHMEM_RING_SLOTS; i++) ShmRingSubmit(&ring, ShmRingClaim(&ring), 0);
+        Check(ShmRingClaim(&ring) == -1, "Full ring refuses a claim");
+        ShmRingAbandon(&ring, 3);
+        Check(ring.pending.load() == SHMEM_RING_SLOTS - 1 && ShmRingClaim(&ring) == 3,
+              "Abandoning a queued slot frees it and clears its doorbell");
+
+        ShmRingInit(&ring);
+        int c = ShmRingClaim(&ring);
+        memset(ring.slots[c].cmd, 'x', SHMEM_RING_CMD_MAX);
+        ShmRingSubmit(&ring, c, 0xFFFFFFFFu);
+        Check(ring.slots[c].cmd_len == SHMEM_RING_CMD_MAX - 1
+              && ring.slots[c].cmd[SHMEM_RING_CMD_MAX - 1] == '\0', "Oversized cmd_len is clamped and terminated");
+    }
+
     // Event ring buffer write
     {
         g_evtBuf = &g_shmEvtBuf;
-        memset(&g_shmEvtBuf, 0, sizeof(g_shmEvtBuf));
+        ShmEvtInit(&g_shmEvtBuf);
         g_shmEvtBuf.flags.store(1, std::memory_order_release);
 
-        uint16_t type = 0x01; // EVT_HP_CHANGE
         struct { uint32_t id; float hp; float dmg; int dtype; } payload = {42, 100.0f, 25.0f, 3};
-        uint16_t payloadSize = sizeof(payload);
-        uint32_t totalSize = 4 + payloadSize;
-        uint32_t wp = g_shmEvtBuf.write_pos.load();
-        uint32_t ringSize = sizeof(g_shmEvtBuf.ring);
-
-        uint8_t header[4];
-        memcpy(header, &type, 2);
-        memcpy(header + 2, &payloadSize, 2);
-        for (uint32_t i = 0; i < 4; i++)
-            g_shmEvtBuf.ring[(wp + i) % ringSize] = header[i];
-        const uint8_t* src = (const uint8_t*)&payload;
-        for (uint32_t i = 0; i < payloadSize; i++)
-            g_shmEvtBuf.ring[(wp + 4 + i) % ringSize] = src[i];
-        g_shmEvtBuf.write_pos.store((wp + totalSize) % ringSize, std::memory_order_release);
-        g_shmEvtBuf.event_count.fetch_add(1, std::memory_order_relaxed);
-
-        Check(g_shmEvtBuf.write_pos.load() == totalSize, "Event write_pos advanced");
+        const uint32_t totalSize = ShmEvtRecordSize(sizeof(payload));
+        Check(ShmEvtWrite(&g_shmEvtBuf, EVT_HP_CHANGE, &payload, sizeof(payload)), "Event write succeeds");
+        Check(g_shmEvtBuf.write_pos.load() == totalSize && g_shmEvtBuf.reserve_pos.load() == totalSize,
+              "Event write_pos advanced");
+        Check(totalSize == 24, "Records are padded to 8 bytes");
         Check(g_shmEvtBuf.event_count.load() == 1, "Event count incremented");
 
         uint16_t readType;
         memcpy(&readType, g_shmEvtBuf.ring, 2);
         Check(readType == 0x01, "Event type is EVT_HP_CHANGE");
+
+        uint16_t type = 0, size = 0;
+        uint8_t out[64];
+        Check(ShmEvtRead(&g_shmEvtBuf, &type, out, sizeof(out), &size)
+              && type == EVT_HP_CHANGE && size == sizeof(payload) && memcmp(out, &payload, size) == 0,
+              "Reader gets the record back intact");
+        Check(!ShmEvtRead(&g_shmEvtBuf, &type, out, sizeof(out), &size), "Reader stops at write_pos");
+
+        // Payload layouts are a cross-DLL contract (overlay_event_feed.h).
+        Check(sizeof(EvtHPChange) == 16, "EvtHPChange is 16 bytes");
+        Check(sizeof(EvtUnitDied) == 20 && offsetof(EvtUnitDied, victim_owner) == EVT_UNIT_DIED_V1_SIZE
+              && offsetof(EvtUnitDied, local_slot) == 16,
+              "EvtUnitDied appends owner slots after the v1 fields");
+
+        // A stalled reader: records that do not fit are dropped, not lapped.
+        ShmEvtInit(&g_shmEvtBuf);
+        uint32_t id = 0, written = 0;
+        while (ShmEvtWrite(&g_shmEvtBuf, EVT_UNIT_DIED, &id, sizeof(id))) { id++; written++; }
+        Check(written == SHMEM_EVT_RING_SIZE / ShmEvtRecordSize(sizeof(id)), "Full ring holds exactly its capacity");
+        Check(!ShmEvtWrite(&g_shmEvtBuf, EVT_UNIT_DIED, &id, sizeof(id)), "Write into a full ring is refused");
+        Check(g_shmEvtBuf.dropped.load() == 2 && g_shmEvtBuf.dropped_pending.load() == 2,
+              "Drops are counted");
+        Check(g_shmEvtBuf.write_pos.load() - g_shmEvtBuf.read_pos.load() == SHMEM_EVT_RING_SIZE,
+              "Unread bytes are never overwritten");
+
+        // Reader catches up: the next record that fits carries a resync marker.
+        for (int i = 0; i < 4; i++) ShmEvtRead(&g_shmEvtBuf, &type, out, sizeof(out), &size);
+        id = 0xBEEF;
+        Check(ShmEvtWrite(&g_shmEvtBuf, EVT_UNIT_DIED, &id, sizeof(id)), "Write succeeds once space frees");
+        Check(g_shmEvtBuf.dropped_pending.load() == 0, "Pending drops are handed to the marker");
+        uint32_t v = 0, lastId = 0, lost = 0;
+        bool sawMarker = false, inOrder = true;
+        while (ShmEvtRead(&g_shmEvtBuf, &type, &v, sizeof(v), &size)) {
+            if (type == EVT_RESYNC) { sawMarker = true; lost = v; continue; }
+            if (sawMarker) { lastId = v; break; }
+            if (v < 4) inOrder = false;
+        }
+        Check(inOrder, "Records before the gap are the oldest survivors");
+        Check(sawMarker && lost == 2 && lastId == 0xBEEF, "EVT_RESYNC(2) precedes the first record after the gap");
+
+        // Wrap: cursors are free-running and records straddle the ring end.
+        ShmEvtInit(&g_shmEvtBuf);
+        g_shmEvtBuf.write_pos = g_shmEvtBuf.read_pos = g_shmEvtBuf.reserve_pos = 0xFFFFFFF0u;
+        Check(ShmEvtWrite(&g_shmEvtBuf, EVT_HP_CHANGE, &payload, sizeof(payload))
+              && ShmEvtRead(&g_shmEvtBuf, &type, out, sizeof(out), &size)
+              && memcmp(out, &payload, sizeof(payload)) == 0,
+              "Record spanning the uint32 cursor wrap round-trips");
+        Check(memcmp(g_shmEvtBuf.ring + SHMEM_EVT_RING_SIZE - 12, &payload, 12) == 0
+              && memcmp(g_shmEvtBuf.ring, (const uint8_t*)&payload + 12, 4) == 0,
+              "Payload is split at the ring end");
+        Check(g_shmEvtBuf.read_pos.load() == 0x8u, "Reader advances by the padded size");
+
+        // Aligned records can be read in place.
+        ShmEvtInit(&g_shmEvtBuf);
+        uint8_t odd[5] = {1, 2, 3, 4, 5};
+        ShmEvtWrite(&g_shmEvtBuf, EVT_STORY, odd, sizeof(odd));
+        ShmEvtWrite(&g_shmEvtBuf, EVT_HP_CHANGE, &payload, sizeof(payload));
+        const uint8_t* second = g_shmEvtBuf.ring + ShmEvtRecordSize(sizeof(odd));
+        Check(((uintptr_t)second & (SHMEM_EVT_ALIGN - 1)) == 0
+              && *(const uint16_t*)second == EVT_HP_CHANGE
+              && ((const uint32_t*)(second + SHMEM_EVT_HDR_SIZE))[0] == 42,
+              "Record after an odd-sized one starts 8-byte aligned");
+
+        // Discard never rewinds the cursors.
+        ShmEvtWrite(&g_shmEvtBuf, EVT_HP_CHANGE, &payload, sizeof(payload));
+        const uint32_t wpBefore = g_shmEvtBuf.write_pos.load();
+        ShmEvtDiscard(&g_shmEvtBuf);
+        Check(g_shmEvtBuf.read_pos.load() == wpBefore && g_shmEvtBuf.write_pos.load() == wpBefore
+              && g_shmEvtBuf.event_count.load() == 0, "Discard drops the backlog in place");
+
+        // Several producers: every committed record is whole.
+        ShmEvtInit(&g_shmEvtBuf);
+        const int kThreads = 4, kPerThread = 2000;
+        std::atomic<bool> stop{false};
+        uint32_t readOk = 0, readBad = 0, markerLost = 0;
+        std::thread reader([&]() {
+            uint16_t t, sz;
+            uint32_t rec[4];
+            for (;;) {
+                if (!ShmEvtRead(&g_shmEvtBuf, &t, rec, sizeof(rec), &sz)) {
+                    if (stop.load()) break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (t == EVT_RESYNC) { markerLost += rec[0]; continue; }
+                if (sz == sizeof(rec) && rec[1] == ~rec[0] && rec[2] == rec[0] * 3 && rec[3] == 0x5A5A5A5A) readOk++;
+                else readBad++;
+            }
+        });
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kThreads; t++) {
+            producers.emplace_back([t, kPerThread]() {
+                for (int i = 0; i < kPerThread; i++) {
+                    uint32_t k = (uint32_t)(t * kPerThread + i);
+                    uint32_t rec[4] = {k, ~k, k * 3, 0x5A5A5A5A};
+                    ShmEvtWrite(&g_shmEvtBuf, EVT_HP_CHANGE, rec, sizeof(rec));
+                }
+            });
+        }
+        for (auto& p : producers) p.join();
+        stop.store(true);
+        reader.join();
+        uint16_t t2, sz2; uint32_t tail[4];
+        while (ShmEvtRead(&g_shmEvtBuf, &t2, tail, sizeof(tail), &sz2)) {
+            if (t2 == EVT_RESYNC) markerLost += tail[0]; else readOk++;
+        }
+        Check(readBad == 0, "Concurrent producers never tear a record");
+        Check(readOk == g_shmEvtBuf.event_count.load()
+              && readOk + g_shmEvtBuf.dropped.load() == (uint32_t)(kThreads * kPerThread),
+              "Every record is either delivered or counted as dropped");
+        Check(markerLost + g_shmEvtBuf.dropped_pending.load() == g_shmEvtBuf.dropped.load(),
+              "Resync markers account for every drop");
+    }
+
+    // Binary unit table (SWFOC_ListTacticalUnits("bin"))
+    {
+        static SharedUnitTable units;
+        ShmUnitsInit(&units);
+        Check(units.magic == SHMEM_UNITS_MAGIC && units.header_size == 32
+              && units.capacity == SHMEM_UNITS_MAX && units.slot_filter == -1,
+              "Unit table header is initialised");
+        Check(offsetof(SharedUnitTable, owner) == 32 + 8 * SHMEM_UNITS_MAX
+              && offsetof(SharedUnitTable, hull) == 32 + 12 * SHMEM_UNITS_MAX
+              && offsetof(SharedUnitTable, flags) == 32 + 16 * SHMEM_UNITS_MAX,
+              "Unit columns sit at their documented offsets");
+        Check(units.version == 2
+              && offsetof(SharedUnitTable, pos) == 32 + 17 * SHMEM_UNITS_MAX
+              && offsetof(SharedUnitTable, half_extent) == 32 + 29 * SHMEM_UNITS_MAX
+              && offsetof(SharedUnitTable, pos) % 4 == 0,
+              "Version-2 bounds columns follow flags[] without moving v1 columns");
+
+        ShmUnitsBeginWrite(&units);
+        Check(units.seq.load() & 1, "seq is odd while writing");
+        uint64_t objIn[3] = {0x1000, 0x2000, 0x3000};
+        for (int i = 0; i < 3; i++) {
+            units.obj_addr[i] = objIn[i];
+            units.owner[i] = i;
+            units.hull[i] = 100.0f * (float)(i + 1);
+            units.flags[i] = (uint8_t)(SHM_UNIT_INVULN << i);
+        }
+        Check(ShmUnitsRead(&units, nullptr, nullptr, nullptr, nullptr, 16) == -1,
+              "Reader refuses a table mid-write");
+        units.count = 3;
+        const uint32_t seq = ShmUnitsEndWrite(&units);
+        Check(seq == 2 && units.seq.load() == 2, "EndWrite publishes an even seq");
+
+        uint64_t obj[4] = {}; int32_t owner[4] = {}; float hull[4] = {}; uint8_t flags[4] = {};
+        Check(ShmUnitsRead(&units, obj, owner, hull, flags, 4) == 3
+              && obj[2] == 0x3000 && owner[1] == 1 && hull[2] == 300.0f
+              && flags[1] == SHM_UNIT_PREVENT_DEATH,
+              "Reader copies every column");
+        Check(ShmUnitsRead(&units, obj, nullptr, nullptr, nullptr, 2) == 2,
+              "Reader honours its capacity");
+    }
+
+    // Binary planet table (SWFOC_ListPlanets("bin"))
+    {
+        static SharedPlanetTable planets;
+        ShmPlanetsInit(&planets);
+        Check(planets.magic == SHMEM_PLANETS_MAGIC && planets.header_size == 32
+              && planets.capacity == SHMEM_PLANETS_MAX && planets.version == 1,
+              "Planet table header is initialised");
+        Check(offsetof(SharedPlanetTable, owner) == 32 + 8 * SHMEM_PLANETS_MAX
+              && offsetof(SharedPlanetTable, tech) == 32 + 12 * SHMEM_PLANETS_MAX
+              && offsetof(SharedPlanetTable, buildings) == 32 + 16 * SHMEM_PLANETS_MAX
+              && offsetof(SharedPlanetTable, flags) == 32 + 20 * SHMEM_PLANETS_MAX
+              && offsetof(SharedPlanetTable, name) == 32 + 21 * SHMEM_PLANETS_MAX,
+              "Planet columns sit at their documented offsets");
+
+        ShmPlanetsBeginWrite(&planets);
+        Check(ShmPlanetsRead(&planets, nullptr, nullptr, nullptr, nullptr, nullptr, 16) == -1,
+              "Planet reader refuses a table mid-write");
+        planets.obj_addr[0] = 0x4000; planets.owner[0] = -1; planets.tech[0] = 0;
+        planets.obj_addr[1] = 0x5000; planets.owner[1] = 1;  planets.tech[1] = 3;
+        planets.buildings[1] = 4;
+        planets.flags[1] = SHM_PLANET_DESTROYED | SHM_PLANET_LOCAL_OWNER;
+        planets.count = 2;
+        Check(ShmPlanetsEndWrite(&planets) == 2, "Planet EndWrite publishes an even seq");
+
+        uint64_t obj[2] = {}; int32_t owner[2] = {}, tech[2] = {}, built[2] = {}; uint8_t flags[2] = {};
+        Check(ShmPlanetsRead(&planets, obj, owner, tech, built, flags, 2) == 2
+              && obj[1] == 0x5000 && owner[0] == -1 && tech[1] == 3 && built[1] == 4
+              && flags[1] == (SHM_PLANET_DESTROYED | SHM_PLANET_LOCAL_OWNER),
+              "Planet reader copies every column");
     }
 
     g_evtBuf = nullptr;
@@ -2033,9 +2803,9 @@ static void TestSnapshotFormat() {
     // Seed a few entries in registered_states so section 2 has data
     int dummy1 = 0, dummy2 = 0, dummy3 = 0;
     EnterCriticalSection(&csRegistered);
-    registered_states.push_back((void*)&dummy1);
-    registered_states.push_back((void*)&dummy2);
-    registered_states.push_back((void*)&dummy3);
+    StateRegistryInsert(&registered_states, (void*)&dummy1);
+    StateRegistryInsert(&registered_states, (void*)&dummy2);
+    StateRegistryInsert(&registered_states, (void*)&dummy3);
     LeaveCriticalSection(&csRegistered);
 
     FakeLuaState L;
@@ -2129,8 +2899,10 @@ static void TestSnapshotFormat() {
     uint32_t computed = Crc32_Update(0, bytes.data(), crcEndOff);
     Check(fileCrc == computed, "CRC32 at end matches body");
 
-    // Verify the file ends exactly at crcEndOff + 4 (no trailing garbage)
-    Check(bytes.size() == crcEndOff + 4, "No trailing bytes after CRC32");
+    // Verify the file ends with the section index right after the CRC32
+    // (no trailing garbage)
+    Check(bytes.size() == crcEndOff + 4 + SnapIndexLength(bytes.data(), bytes.size())
+          && bytes.size() > crcEndOff + 4, "Only the section index follows the CRC32");
 
     // Extra: metadata section contains "powrprof_dll" capture_method value.
     // Find the metadata section again by re-walking (simpler than re-hoisting).
@@ -2159,7 +2931,7 @@ static void TestSnapshotFormat() {
 
     // Clean up: remove dummy registered states and the snapshot file
     EnterCriticalSection(&csRegistered);
-    registered_states.clear();
+    StateRegistryReset(&registered_states);
     LeaveCriticalSection(&csRegistered);
     remove(snapPath);
 
@@ -3087,49 +3859,49 @@ ReplayState BuildReplayFixture() {
         {1, "EMPIRE",     99999.0, 5, ""},
         {2, "UNDERWORLD",  5000.0, 1, ""},
     };
-    s.objects["TIE_Fighter"]    = 12;
-    s.objects["X_Wing"]         = 8;
-    s.objects["Star_Destroyer"] = 2;
+    s.objects.mut()["TIE_Fighter"]    = 12;
+    s.objects.mut()["X_Wing"]         = 8;
+    s.objects.mut()["Star_Destroyer"] = 2;
 
     // section 6: planet_state
     {
         ReplayPlanetInfo p; p.name = "TATOOINE"; p.corruption = 0.10f; p.owner_slot = 0;
-        s.planets[ReplayUpper("TATOOINE")] = p;
+        s.planets.mut()[ReplayUpper("TATOOINE")] = p;
     }
     {
         ReplayPlanetInfo p; p.name = "CORUSCANT"; p.corruption = 0.0f; p.owner_slot = 1;
-        s.planets[ReplayUpper("CORUSCANT")] = p;
+        s.planets.mut()[ReplayUpper("CORUSCANT")] = p;
     }
     {
         ReplayPlanetInfo p; p.name = "NABOO"; p.corruption = 0.75f; p.owner_slot = 2;
-        s.planets[ReplayUpper("NABOO")] = p;
+        s.planets.mut()[ReplayUpper("NABOO")] = p;
     }
 
     // section 7: diplomacy
-    s.diplomacy[ReplayDiplomacyKey("REBEL", "EMPIRE")]      = "hostile";
-    s.diplomacy[ReplayDiplomacyKey("REBEL", "UNDERWORLD")]  = "neutral";
-    s.diplomacy[ReplayDiplomacyKey("EMPIRE", "UNDERWORLD")] = "hostile";
+    s.diplomacy.mut()[ReplayDiplomacyKey("REBEL", "EMPIRE")]      = "hostile";
+    s.diplomacy.mut()[ReplayDiplomacyKey("REBEL", "UNDERWORLD")]  = "neutral";
+    s.diplomacy.mut()[ReplayDiplomacyKey("EMPIRE", "UNDERWORLD")] = "hostile";
 
     // section 8: cooldowns
-    s.cooldowns["TIE_Fighter"] = {0.0f, 12.5f};
-    s.cooldowns["X_Wing"]      = {0.0f, 5.0f, 30.0f};
+    s.cooldowns.mut()["TIE_Fighter"] = {0.0f, 12.5f};
+    s.cooldowns.mut()["X_Wing"]      = {0.0f, 5.0f, 30.0f};
 
     // section 9: task_forces
-    s.task_forces.push_back({1, "Death_Squadron"});
-    s.task_forces.push_back({0, "Rogue_Squadron"});
+    s.task_forces.mut().push_back({1, "Death_Squadron"});
+    s.task_forces.mut().push_back({0, "Rogue_Squadron"});
 
     // section 10: object_owners
     {
         std::vector<int32_t> ties(12, 1);
-        s.object_owners[ReplayUpper("TIE_Fighter")] = ties;
+        s.object_owners.mut()[ReplayUpper("TIE_Fighter")] = ties;
     }
     {
         std::vector<int32_t> xwings(8, 0);
-        s.object_owners[ReplayUpper("X_Wing")] = xwings;
+        s.object_owners.mut()[ReplayUpper("X_Wing")] = xwings;
     }
     {
         std::vector<int32_t> sds(2, 1);
-        s.object_owners[ReplayUpper("Star_Destroyer")] = sds;
+        s.object_owners.mut()[ReplayUpper("Star_Destroyer")] = sds;
     }
 
     return s;
@@ -3227,7 +3999,7 @@ static void TestReplayUnitOwner() {
     Check(ReplayObsUnitOwner(s, "Y_Wing", 0) == 0, "round-trip: spawned Y_Wing[0] owned by REBEL");
     Check(ReplayObsUnitOwner(s, "Y_Wing", 2) == 0, "round-trip: spawned Y_Wing[2] owned by REBEL");
     Check(ReplayObsUnitOwner(s, "Y_Wing", 3) == -1, "spawn count respected (no Y_Wing[3])");
-    Check(s.objects["Y_Wing"] == 3, "objects catalog mirrors spawn");
+    Check(s.objects.mut()["Y_Wing"] == 3, "objects catalog mirrors spawn");
 
     // Spawn for unknown faction yields slot -1.
     ReplayMutSpawnUnit(s, "GHOST_FACTION", "B_Wing", 1);
@@ -3602,11 +4374,11 @@ static void TestReplayPlanets() {
           "unknown planet returns -1 owner");
 
     // Seed planets via the observers' input side. The ReplayState's
-    // planets map is keyed by uppercase name (matches ReplayDiplomacyKey
-    // convention) with display name preserved.
-    s.planets["NABOO"]      = ReplayPlanetInfo{"Naboo", 0.25f, 0};
-    s.planets["KAMINO"]     = ReplayPlanetInfo{"Kamino", 0.0f, 6};
-    s.planets["DANTOOINE"]  = ReplayPlanetInfo{"Dantooine", 0.75f, 2};
+    // planets map is keyed by uppercase name (ReplayUpper) with display
+    // name preserved.
+    s.planets.mut()["NABOO"]      = ReplayPlanetInfo{"Naboo", 0.25f, 0};
+    s.planets.mut()["KAMINO"]     = ReplayPlanetInfo{"Kamino", 0.0f, 6};
+    s.planets.mut()["DANTOOINE"]  = ReplayPlanetInfo{"Dantooine", 0.75f, 2};
 
     std::string csv = ReplayObsListPlanets(s);
     Check(csv.rfind("count=3", 0) == 0, "populated state starts with 'count=3'");
@@ -3791,6 +4563,21 @@ static void TestReplayEconomy() {
     Check(touched == 1, "pause + 1 frozen slot => only the frozen snap counts");
     Check(s.players[0].credits == 9999.0, "frozen slot re-snapped even at speed 0");
     Check(s.players[1].credits == 2500.0, "unfrozen slot 1 unchanged at speed 0");
+
+    // The per-slot plan reproduces the per-player product bit for bit; a
+    // slot past the per-slot tables takes the global multiplier.
+    ReplayMutSetGameSpeed(s, 1.5f);
+    ReplayMutSetIncomeMultiplier(s, -1, 0.3f);
+    s.players.push_back(ReplayPlayer{REPLAY_SLOTS + 4, "PIRATE", 10.0, 0, ""});
+    ReplayIncomePlan plan;
+    ReplayIncomePlanBuild(s, 7.1, &plan);
+    Check(plan.rate[1] == 7.1 * (double)2.0f * (double)1.5f && plan.rate[REPLAY_SLOTS] == 7.1 * (double)0.3f * (double)1.5f
+              && plan.frozen[0] && plan.target[0] == 9999.0 && !plan.frozen[REPLAY_SLOTS],
+          "plan rates are base * multiplier * game speed per slot");
+    const double before1 = s.players[1].credits, before3 = s.players[3].credits;
+    Check(ReplayMutTickIncome(s, 7.1) == 4 && s.players[1].credits == before1 + plan.rate[1]
+              && s.players[3].credits == before3 + 7.1 * (double)0.3f * (double)1.5f,
+          "an out-of-table slot gains at the global rate");
 }
 
 // Tasks 131 / 132 / 133 (added 2026-04-23). Pure-state regression for
@@ -3895,8 +4682,8 @@ static void TestReplayCombatScaling() {
               "unit b (slot 0 @ 3x) took 30 splash => 220");
 
         // Splash honours hardpoint INVULNERABLE.
-        ReplayUnitDetail* ua = ReplayFindUnit(s, a);
-        ua->hardpoints.push_back(ReplayHardpoint{0u, {std::string("INVULNERABLE")}});
+        ReplayMutMockUnit(s, a, "a-wing", 1, ReplayFindUnit(s, a)->hull, 200.0f, 1);
+        ReplayMutAttachBehavior(s, a, 0, "INVULNERABLE");
         int affected4 = ReplayMutApplyAreaSplash(s, primary, 40.0f);
         Check(affected4 == 1, "splash with invuln unit skips the invuln one");
         Check(ReplayFindUnit(s, a)->hull == 140.0f,
@@ -4617,7 +5404,7 @@ static void TestReplayOhkAttackPower() {
         Check(s.ohk_saved_attack_powers.size() == 2, "2 snapshots pre-despawn");
 
         // Despawn one — snapshot remains but unit is gone.
-        s.units.erase(0xA000);
+        s.units.mut().erase(0xA000);
 
         int restored = ReplayMutSetOHK(s, false);
         Check(restored == 1, "disable restored only the surviving unit");
@@ -4673,7 +5460,7 @@ static void TestReplayPlanetTech() {
     Check(ReplayMutSetPlanetCapital(s, "Naboo", true) == 0, "SetCapital on unknown returns 0");
 
     // Seed a planet via the map.
-    s.planets["NABOO"] = ReplayPlanetInfo{"Naboo", 0.0f, 0, 0, 0, false};
+    s.planets.mut()["NABOO"] = ReplayPlanetInfo{"Naboo", 0.0f, 0, 0, 0, false};
 
     Check(ReplayObsGetPlanetTech(s, "Naboo") == 0, "fresh planet: tech=0");
     Check(ReplayObsGetPlanetBuildings(s, "Naboo") == 0, "fresh planet: buildings=0");
@@ -4696,7 +5483,7 @@ static void TestReplayPlanetTech() {
 
     // Cross-field isolation: mutating capital does not touch corruption,
     // owner, tech, or buildings.
-    auto* p = &s.planets["NABOO"];
+    auto* p = &s.planets.mut()["NABOO"];
     Check(p->owner_slot == 0, "owner_slot untouched by capital toggle");
     Check(fabs(p->corruption - 0.0f) < 1e-6f, "corruption untouched by capital toggle");
 
@@ -4708,9 +5495,9 @@ static void TestReplayPlanetTech() {
 
     // ListPlanets row format is unchanged (no tech/buildings fields
     // injected -- consumers that want them use GetPlanetTechAndBuildings).
-    s.planets["NABOO"].tech_level = 2;
-    s.planets["NABOO"].building_count = 5;
-    s.planets["NABOO"].is_capital = false;
+    s.planets.mut()["NABOO"].tech_level = 2;
+    s.planets.mut()["NABOO"].building_count = 5;
+    s.planets.mut()["NABOO"].is_capital = false;
     std::string csv = ReplayObsListPlanets(s);
     Check(csv.find("|Naboo;0;0.000") != std::string::npos,
           "ListPlanets row still name;owner;corruption (tech fields stay in dedicated helper)");
@@ -5201,6 +5988,3571 @@ static void TestReplayEventStream() {
     Check(pos0 < pos1 && pos1 < pos2, "events drain in insertion order (FIFO)");
 }
 
+// 2026-10-14. damage_ring.h: the per-thread rings behind the live
+// SWFOC_EventStreamDrain. Pins:
+//   * a full ring drops the newest event and counts it, never overwrites
+//   * drain is bounded by `max` and leaves the remainder queued
+//   * capacity changes apply only once a ring is empty
+//   * rings are claimed once per thread; overflow threads are counted
+//   * concurrent writers on separate rings lose nothing the count misses
+static void TestDamageEventRings() {
+    StartSuite("Damage-event per-thread rings (damage_ring.h)");
+
+    static DamageRingSet set;
+    static DamageEvent out[DAMAGE_RING_CAP_MAX];
+    DamageRingSetInit(&set);
+
+    Check(DamageRingRoundCapacity(1) == DAMAGE_RING_CAP_MIN
+          && DamageRingRoundCapacity(3000) == 4096
+          && DamageRingRoundCapacity(1u << 30) == DAMAGE_RING_CAP_MAX,
+          "Capacity rounds up to a power of two within bounds");
+
+    const int r0 = DamageRingClaim(&set, 101);
+    Check(r0 == 0 && DamageRingClaim(&set, 101) == 0, "A thread claims one ring and keeps it");
+    Check(DamageRingClaim(&set, 202) == 1, "A second thread gets its own ring");
+
+    DamageRingSetCapacity(&set, DAMAGE_RING_CAP_MIN);
+    DamageEvent ev = {};
+    int pushed = 0;
+    for (int i = 0; i < DAMAGE_RING_CAP_MIN + 10; i++) {
+        ev.obj_addr = (uint64_t)i;
+        if (DamageRingPush(&set, r0, ev)) pushed++;
+    }
+    Check(pushed == DAMAGE_RING_CAP_MIN, "A full ring accepts exactly its capacity");
+    Check(set.rings[r0].dropped.load() == 10 && DamageRingDropped(&set) == 10,
+          "Overflow drops are counted");
+
+    int n = DamageRingDrain(&set, out, 100);
+    Check(n == 100 && out[0].obj_addr == 0 && out[99].obj_addr == 99,
+          "Bounded drain returns the oldest events first");
+    n = DamageRingDrain(&set, out, DAMAGE_RING_CAP_MAX);
+    Check(n == DAMAGE_RING_CAP_MIN - 100 && out[n - 1].obj_addr == DAMAGE_RING_CAP_MIN - 1,
+          "Next drain returns the remainder; no event was overwritten");
+
+    // Grow happens on the next push into an empty ring.
+    DamageRingSetCapacity(&set, 1024);
+    ev.obj_addr = 7;
+    DamageRingPush(&set, r0, ev);
+    Check(set.rings[r0].storage.load()->mask == 1023, "Empty ring adopts the new capacity");
+    for (int i = 0; i < 10; i++) DamageRingPush(&set, r0, ev);
+    DamageRingSetCapacity(&set, DAMAGE_RING_CAP_MIN);
+    DamageRingPush(&set, r0, ev);
+    Check(set.rings[r0].storage.load()->mask == 1023, "A non-empty ring keeps its storage");
+    Check(DamageRingDrain(&set, out, DAMAGE_RING_CAP_MAX) == 12, "Resize never loses queued events");
+
+    for (uint32_t tid = 300; tid < 300 + DAMAGE_RING_THREADS; tid++) DamageRingClaim(&set, tid);
+    Check(DamageRingClaim(&set, 999) == -1, "Threads beyond the ring table get no ring");
+    Check(!DamageRingPush(&set, -1, ev) && set.unowned_drops.load() == 1,
+          "Pushes without a ring are counted");
+    DamageRingSetFree(&set);
+
+    // Writers on separate rings, reader draining concurrently.
+    DamageRingSetInit(&set);
+    const int kWriters = 4, kEach = 20000;
+    std::atomic<int> writersDone{0};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < kWriters; w++) {
+        writers.emplace_back([w, &writersDone]() {
+            const int ring = DamageRingClaim(&set, (uint32_t)(1000 + w));
+            DamageEvent e = {};
+            for (int i = 0; i < kEach; i++) {
+                e.obj_addr = ((uint64_t)w << 32) | (uint32_t)i;
+                e.owner_slot = w;
+                DamageRingPush(&set, ring, e);
+            }
+            writersDone.fetch_add(1);
+        });
+    }
+    long received = 0;
+    bool ordered = true;
+    int64_t last[kWriters];
+    for (int w = 0; w < kWriters; w++) last[w] = -1;
+    for (;;) {
+        const bool finished = writersDone.load() == kWriters;
+        const int got = DamageRingDrain(&set, out, 512);
+        for (int i = 0; i < got; i++) {
+            const int w = out[i].owner_slot;
+            const int64_t seq = (int64_t)(out[i].obj_addr & 0xFFFFFFFFu);
+            if (w < 0 || w >= kWriters || (out[i].obj_addr >> 32) != (uint64_t)w || seq <= last[w]) ordered = false;
+            else last[w] = seq;
+        }
+        received += got;
+        if (finished && got == 0) break;
+    }
+    for (auto& t : writers) t.join();
+    Check(ordered, "Each writer's events arrive whole and in order");
+    Check(received + (long)DamageRingDropped(&set) == (long)kWriters * kEach,
+          "Every event is either drained or counted as dropped");
+    DamageRingSetFree(&set);
+}
+
+// 2026-10-14. unit_shadow.h: the shadow table behind
+// SWFOC_EnumerateUnitsDelta. Pins:
+//   * first call / since=0 / foreign generation => full reply
+//   * an unchanged pass keeps the generation and yields an empty delta
+//   * adds, field changes and removals each surface exactly once
+//   * compaction raises the floor so stale clients resync in full
+static int CollectShadow(const UnitShadow* sh, uint32_t since, uint64_t* addrs, uint8_t* alive) {
+    int n = 0;
+    UnitShadowForEachSince(sh, since, [&](const UnitShadowEntry& e) {
+        addrs[n] = e.addr;
+        alive[n] = e.alive;
+        n++;
+    });
+    return n;
+}
+
+static void TestUnitShadowDelta() {
+    StartSuite("Unit shadow table deltas (unit_shadow.h)");
+
+    static UnitShadow sh;
+    static uint64_t addrs[UNIT_SHADOW_SLOTS];
+    static uint8_t alive[UNIT_SHADOW_SLOTS];
+    UnitShadowInit(&sh, 1000);
+
+    auto pass = [&](const UnitShadowRow* rows, int n) {
+        UnitShadowBegin(&sh);
+        for (int i = 0; i < n; i++) UnitShadowObserve(&sh, rows[i]);
+        return UnitShadowEnd(&sh);
+    };
+    UnitShadowRow rows[3] = {
+        {0x1000, 500.0f, 1, 0, 0},
+        {0x2000, 250.0f, 1, 1, 0},
+        {0x3000, 900.0f, 2, 0, 1},
+    };
+
+    const uint32_t g1 = pass(rows, 3);
+    Check(g1 == 1001, "First pass with units advances the generation");
+    Check(UnitShadowNeedsFull(&sh, 0) && CollectShadow(&sh, 0, addrs, alive) == 3,
+          "since=0 gets a full reply of every live unit");
+    Check(UnitShadowNeedsFull(&sh, 5000), "A generation from the future gets a full reply");
+
+    Check(pass(rows, 3) == g1, "An unchanged pass keeps the generation");
+    Check(!UnitShadowNeedsFull(&sh, g1) && CollectShadow(&sh, g1, addrs, alive) == 0,
+          "Client at the current generation gets an empty delta");
+
+    rows[1].hull = 200.0f;
+    const uint32_t g2 = pass(rows, 3);
+    int n = CollectShadow(&sh, g1, addrs, alive);
+    Check(g2 == g1 + 1 && n == 1 && addrs[0] == 0x2000 && alive[0],
+          "A hull change reports just that unit");
+
+    UnitShadowRow withNew[3] = {rows[0], rows[1], {0x4000, 50.0f, 3, 0, 0}};
+    const uint32_t g3 = pass(withNew, 3);  // 0x3000 gone, 0x4000 new
+    n = CollectShadow(&sh, g2, addrs, alive);
+    bool sawAdd = false, sawRemove = false;
+    for (int i = 0; i < n; i++) {
+        if (addrs[i] == 0x4000 && alive[i]) sawAdd = true;
+        if (addrs[i] == 0x3000 && !alive[i]) sawRemove = true;
+    }
+    Check(g3 == g2 + 1 && n == 2 && sawAdd && sawRemove, "Adds and removals are both reported");
+    n = CollectShadow(&sh, g1, addrs, alive);
+    Check(n == 3, "An older client gets the union of every change since its generation");
+    Check(CollectShadow(&sh, g3, addrs, alive) == 0, "Nothing is reported twice");
+
+    // Removed unit comes back.
+    const uint32_t g4 = pass(rows, 3);
+    n = CollectShadow(&sh, g3, addrs, alive);
+    Check(g4 == g3 + 1 && n == 2, "A returning unit and a newly removed one are reported");
+
+    // Churn until compaction: stale clients fall below the floor.
+    static UnitShadowRow churn[1];
+    for (uint32_t i = 0; i < UNIT_SHADOW_MAX_DEAD + 4; i++) {
+        churn[0] = {0x100000 + (uint64_t)i * 16, 1.0f, 0, 0, 0};
+        pass(churn, 1);
+    }
+    Check(sh.floor > g4 && UnitShadowNeedsFull(&sh, g4), "Compaction forces stale clients to a full resync");
+    Check(sh.dead <= UNIT_SHADOW_MAX_DEAD && CollectShadow(&sh, 0, addrs, alive) == 1,
+          "Compaction keeps only live units");
+}
+
+// 2026-10-14. unit_index.h: the one-walk index behind the unit helpers.
+// Pins:
+//   * owner buckets partition the walk, walk order kept inside a bucket
+//   * owners outside [0, UNIT_INDEX_SLOTS) land in the shared last bucket
+//   * selection set ignores zeros and duplicates, misses stay misses
+static void TestUnitIndex() {
+    StartSuite("Unit index owner buckets + selection set (unit_index.h)");
+
+    static UnitIndex idx;
+    const uint64_t objs[7]   = {0x1000, 0x2000, 0x3000, 0x4000, 0x5000, 0x6000, 0x7000};
+    const int32_t  owners[7] = {2, 0, 2, -1, 0, 2, 40};
+    const uint64_t sel[5]    = {0x3000, 0, 0x3000, 0x6000, 0x9000};
+    UnitIndexBuild(&idx, objs, owners, 7, sel, 5);
+
+    Check(idx.count == 7, "Every object is indexed");
+    Check(UnitIndexOwnerCount(&idx, 0) == 2 && UnitIndexOwnerCount(&idx, 1) == 0
+          && UnitIndexOwnerCount(&idx, 2) == 3, "Bucket sizes match the owners");
+    const uint16_t* p2 = UnitIndexOwnerUnits(&idx, 2);
+    Check(p2[0] == 0 && p2[1] == 2 && p2[2] == 5, "Slot 2 keeps walk order");
+    const uint16_t* p0 = UnitIndexOwnerUnits(&idx, 0);
+    Check(idx.objs[p0[0]] == 0x2000 && idx.objs[p0[1]] == 0x5000, "Slot 0 rows point at its objects");
+    Check(UnitIndexOwnerCount(&idx, -1) == 0 && UnitIndexOwnerCount(&idx, UNIT_INDEX_SLOTS) == 0,
+          "Out-of-range slots report no units");
+    Check(idx.bucketStart[UNIT_INDEX_SLOTS + 1] - idx.bucketStart[UNIT_INDEX_SLOTS] == 2,
+          "Owner -1 and 40 share the overflow bucket");
+    int total = 0;
+    for (int s = 0; s < UNIT_INDEX_SLOTS; s++) total += UnitIndexOwnerCount(&idx, s);
+    Check(total == 5, "Slot buckets plus the overflow bucket cover the walk");
+
+    Check(idx.selCount == 3, "Selection set drops zeros and duplicates");
+    Check(UnitIndexIsSelected(&idx, 0x3000) && UnitIndexIsSelected(&idx, 0x6000),
+          "Selected objects are found");
+    Check(!UnitIndexIsSelected(&idx, 0x1000) && !UnitIndexIsSelected(&idx, 0),
+          "Unselected objects and null are not");
+
+    UnitIndexBuild(&idx, objs, owners, 0, nullptr, 0);
+    Check(idx.count == 0 && UnitIndexOwnerCount(&idx, 2) == 0 && !UnitIndexIsSelected(&idx, 0x3000),
+          "Rebuilding empty clears buckets and selection");
+}
+
+// 2026-10-14. region_cache.h: the VirtualQuery cache behind CanReadMem.
+// A fake address space stands in for VirtualQuery:
+//   [0x10000, 0x20000) readable, [0x20000, 0x30000) readable,
+//   [0x30000, 0x31000) no access, everything else one page at a time and
+//   unreadable. Pins lazy fill, cross-region ranges, epoch invalidation,
+//   overflow and overlap replacement.
+static int g_regionQueries = 0;
+static bool FakeRegionQuery(uint64_t addr, uint64_t* start, uint64_t* end, bool* readable) {
+    g_regionQueries++;
+    if (addr >= 0x10000 && addr < 0x20000) { *start = 0x10000; *end = 0x20000; *readable = true; return true; }
+    if (addr >= 0x20000 && addr < 0x30000) { *start = 0x20000; *end = 0x30000; *readable = true; return true; }
+    if (addr >= 0x30000 && addr < 0x31000) { *start = 0x30000; *end = 0x31000; *readable = false; return true; }
+    if (addr >= 0x7F0000000000ull) return false;
+    *start = addr & ~0xFFFull;
+    *end = *start + 0x1000;
+    *readable = false;
+    return true;
+}
+
+static void TestRegionCache() {
+    StartSuite("Readable region cache (region_cache.h)");
+
+    static RegionCache c;
+    memset(&c, 0, sizeof(c));
+    RegionCacheReset(&c, 1);
+    g_regionQueries = 0;
+
+    Check(RegionCacheCanRead(&c, 1, 0x10100, 8, FakeRegionQuery) && g_regionQueries == 1,
+          "First probe queries once");
+    Check(RegionCacheCanRead(&c, 1, 0x1F000, 0x400, FakeRegionQuery) && g_regionQueries == 1,
+          "Later probes in the same region are answered from the cache");
+    Check(RegionCacheCanRead(&c, 1, 0x1FFFC, 8, FakeRegionQuery) && g_regionQueries == 2 && c.count == 2,
+          "A range spanning two readable regions is readable");
+    Check(!RegionCacheCanRead(&c, 1, 0x2FFFC, 8, FakeRegionQuery),
+          "A range running into a no-access region is not");
+    const int before = g_regionQueries;
+    Check(!RegionCacheCanRead(&c, 1, 0x30010, 1, FakeRegionQuery) && g_regionQueries == before,
+          "Unreadable regions are cached too");
+    Check(!RegionCacheCanRead(&c, 1, 0x7F0000001000ull, 8, FakeRegionQuery),
+          "A failed query is unreadable");
+    Check(!RegionCacheCanRead(&c, 1, ~0ull - 2, 8, FakeRegionQuery), "A wrapping range is unreadable");
+
+    Check(RegionCacheFind(&c, 0x10000) == 0 && RegionCacheFind(&c, 0x1FFFF) == 0
+          && RegionCacheFind(&c, 0x20000) == 1 && RegionCacheFind(&c, 0x31000) == -1,
+          "Find honours half-open bounds");
+
+    g_regionQueries = 0;
+    Check(RegionCacheCanRead(&c, 2, 0x10100, 8, FakeRegionQuery) && g_regionQueries == 1 && c.count == 1,
+          "A new epoch drops the cache");
+
+    RegionCacheInsert(&c, 0x18000, 0x28000, false);
+    Check(c.count == 1 && !RegionCacheCanRead(&c, 2, 0x19000, 8, FakeRegionQuery),
+          "Inserting over an entry replaces it");
+    RegionCacheReset(&c, 3);
+    RegionCacheInsert(&c, 0x1000, 0x2000, true);
+    RegionCacheInsert(&c, 0x3000, 0x4000, true);
+    RegionCacheInsert(&c, 0x5000, 0x6000, true);
+    RegionCacheInsert(&c, 0x1800, 0x5800, false);
+    Check(c.count == 1 && !c.entries[0].readable && c.entries[0].start == 0x1800,
+          "A region covering several entries replaces all of them");
+    RegionCacheInsert(&c, 0x0800, 0x1000, true);
+    Check(c.count == 2 && c.entries[0].start == 0x0800 && c.entries[1].start == 0x1800,
+          "Entries stay sorted by start");
+
+    RegionCacheReset(&c, 4);
+    for (int i = 0; i < REGION_CACHE_MAX; i++)
+        RegionCacheInsert(&c, 0x100000 + (uint64_t)i * 0x2000, 0x101000 + (uint64_t)i * 0x2000, true);
+    Check(c.count == REGION_CACHE_MAX, "The cache fills to REGION_CACHE_MAX");
+    RegionCacheInsert(&c, 0x10000, 0x20000, true);
+    Check(c.count == 1 && RegionCacheFind(&c, 0x10000) == 0, "A full cache is cleared before the next insert");
+}
+
+// 2026-10-14. obj_memo.h: the per-tick GameObj field memo behind
+// IsObjOwnedByHuman / InspectUnit / GetHardpoints. Pins:
+//   * a stored entry is served only within its epoch
+//   * a hash collision replaces the older entry instead of aliasing it
+//   * obj 0 never hits
+static void TestObjMemo() {
+    StartSuite("GameObj field memo (obj_memo.h)");
+
+    static ObjMemo m;
+    memset(&m, 0, sizeof(m));
+    ObjMemoEntry e = {};
+    e.obj = 0x7FF612340000ull;
+    e.epoch = 10;
+    e.root = 0x7FF612350000ull;
+    e.player = 0x7FF600001000ull;
+    e.components = 0x7FF612348000ull;
+    e.valid = 1;
+    e.isHuman = 1;
+
+    Check(ObjMemoLookup(&m, e.obj, 10) == nullptr && m.misses == 1, "An empty memo misses");
+    ObjMemoStore(&m, e);
+    const ObjMemoEntry* hit = ObjMemoLookup(&m, e.obj, 10);
+    Check(hit && hit->root == e.root && hit->player == e.player && hit->isHuman == 1 && m.hits == 1,
+          "A stored entry is served with every field");
+    Check(ObjMemoLookup(&m, e.obj, 11) == nullptr, "A new epoch invalidates the entry");
+    Check(ObjMemoLookup(&m, 0, 10) == nullptr, "Null never hits");
+
+    uint64_t other = e.obj + 0x10;
+    while (ObjMemoHash(other) != ObjMemoHash(e.obj)) other += 0x10;
+    ObjMemoEntry f = e;
+    f.obj = other;
+    f.isHuman = 0;
+    ObjMemoStore(&m, f);
+    Check(ObjMemoLookup(&m, e.obj, 10) == nullptr, "A colliding store evicts the older object");
+    hit = ObjMemoLookup(&m, other, 10);
+    Check(hit && hit->obj == other && hit->isHuman == 0, "The colliding object gets its own fields");
+
+    int slotsUsed = 0;
+    static uint8_t used[OBJ_MEMO_SLOTS];
+    memset(used, 0, sizeof(used));
+    for (uint64_t i = 0; i < OBJ_MEMO_SLOTS; i++) {
+        const uint32_t h = ObjMemoHash(0x7FF612340000ull + i * 0x1B0);
+        if (!used[h]) { used[h] = 1; slotsUsed++; }
+    }
+    Check(slotsUsed > OBJ_MEMO_SLOTS / 2, "Consecutive engine-sized objects spread across the memo");
+}
+
+// 2026-10-14. bulk_mutate.h: plan parsing + filter matching behind
+// SWFOC_BulkMutateUnits. Pins:
+//   * filter terms combine with AND; empty / "all" matches everything
+//   * bad terms and ops are rejected with the offending text
+//   * ops keep their order, and a plan needs at least one
+//   * failure list caps at BULK_MAX_FAILURES but keeps counting
+static void TestBulkMutatePlan() {
+    StartSuite("Bulk unit mutation plans (bulk_mutate.h)");
+
+    BulkPlan plan;
+    const char* bad = nullptr;
+    Check(BulkParseFilter("", &plan.filter, &bad) && plan.filter.owner == -1
+          && !plan.filter.localOnly && !plan.filter.selectedOnly && plan.filter.typeOf == 0,
+          "Empty filter matches everything");
+    Check(BulkParseFilter("all", &plan.filter, &bad) && BulkParseFilter(nullptr, &plan.filter, &bad),
+          "'all' and null are accepted");
+    Check(BulkParseFilter("owner=2,local,selected,type=140737488355328", &plan.filter, &bad)
+          && plan.filter.owner == 2 && plan.filter.localOnly && plan.filter.selectedOnly
+          && plan.filter.typeOf == 140737488355328ull, "Every filter term parses");
+    Check(!BulkParseFilter("local,enemy", &plan.filter, &bad) && bad && strcmp(bad, "enemy") == 0,
+          "Unknown filter term is reported");
+    Check(!BulkParseFilter("owner=x", &plan.filter, &bad) && !BulkParseFilter("owner=16", &plan.filter, &bad)
+          && !BulkParseFilter("owner=-1", &plan.filter, &bad), "Bad owner slots are rejected");
+
+    Check(BulkParseOps("hull=99999;prevent_death=1;invuln=0", &plan, &bad) && plan.opCount == 3
+          && plan.ops[0].field == BULK_HULL && plan.ops[0].value == 99999.0f
+          && plan.ops[1].field == BULK_PREVENT_DEATH && plan.ops[2].field == BULK_INVULN
+          && plan.ops[2].value == 0.0f, "Ops parse in order");
+    Check(BulkParseOps("invuln_flag=1;", &plan, &bad) && plan.opCount == 1 && plan.ops[0].field == BULK_INVULN_FLAG,
+          "invuln_flag is not mistaken for invuln; trailing ';' is fine");
+    Check(!BulkParseOps("", &plan, &bad) && !BulkParseOps(nullptr, &plan, &bad), "A plan needs an op");
+    Check(!BulkParseOps("hull=1;owner=2", &plan, &bad) && bad && strcmp(bad, "owner=2") == 0,
+          "Unknown op field is reported");
+    Check(!BulkParseOps("hull=1e", &plan, &bad) && !BulkParseOps("hull", &plan, &bad),
+          "Malformed op values are rejected");
+    Check(!BulkParseOps("hull=1;hull=1;hull=1;hull=1;hull=1;hull=1;hull=1;hull=1;hull=1", &plan, &bad),
+          "More than BULK_MAX_OPS ops are rejected");
+
+    BulkFilter f;
+    BulkParseFilter("owner=1,selected", &f, nullptr);
+    BulkUnitView u = {1, true, true, 0};
+    Check(BulkFilterMatches(f, u), "Unit matching every term passes");
+    u.selected = false;
+    Check(!BulkFilterMatches(f, u), "Terms combine with AND");
+    BulkParseFilter("type=4096", &f, nullptr);
+    u.typePtr = 0x5000;
+    Check(!BulkFilterMatches(f, u), "Unresolved type filter matches nothing");
+    f.typePtr = 0x5000;
+    Check(BulkFilterMatches(f, u), "Resolved type filter matches the same type record");
+
+    static BulkResult r;
+    memset(&r, 0, sizeof(r));
+    for (int i = 0; i < BULK_MAX_FAILURES + 5; i++) BulkResultFail(&r, 0x1000 + i, BULK_FAIL_READONLY);
+    Check(r.listed == BULK_MAX_FAILURES && r.failed == BULK_MAX_FAILURES + 5,
+          "Failure list caps but keeps counting");
+    Check(strcmp(BulkFailureName(BULK_FAIL_INVULN_PATH), "invuln_path") == 0, "Failure codes have wire names");
+}
+
+static std::vector<uint8_t> SnapReadFile(const char* path) {
+    std::vector<uint8_t> bytes;
+    FILE* f = fopen(path, "rb");
+    if (!f) return bytes;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    bytes.resize((size_t)sz);
+    size_t got = fread(bytes.data(), 1, (size_t)sz, f);
+    fclose(f);
+    bytes.resize(got);
+    return bytes;
+}
+
+// A capture file without its trailing section index (snap_index.h).
+static std::vector<uint8_t> SnapReadStream(const char* path) {
+    std::vector<uint8_t> bytes = SnapReadFile(path);
+    bytes.resize(bytes.size() - SnapIndexLength(bytes.data(), bytes.size()));
+    return bytes;
+}
+
+static void TestSnapWriter() {
+    StartSuite("Streaming snapshot writer (snap_writer.h)");
+
+    // Reference: the same stream built the v1 way, one vector for the file.
+    std::vector<uint8_t> ref;
+    auto refPut = [&ref](const void* p, size_t n) {
+        const uint8_t* b = (const uint8_t*)p;
+        ref.insert(ref.end(), b, b + n);
+    };
+    auto refU32 = [&refPut](uint32_t v) { refPut(&v, 4); };
+
+    const char* path = "test_snap_writer.swfocsnap";
+    SnapWriter w;
+    SnapWriterOpen(&w, path, Crc32_Update);
+    const uint8_t hdr[12] = {'S','W','F','O','C','S','N','A','P','v','2',0};
+    SnapPut(&w, hdr, 12);
+    refPut(hdr, 12);
+
+    // Section 1: fixed-width strings, in place.
+    SnapBeginSection(&w, 1);
+    SnapFixedStr(&w, "TIE_Fighter", 16);
+    SnapFixedStr(&w, "Tartan_Patrol_Cruiser_Long_Name", 8);
+    SnapFixedStr(&w, nullptr, 4);
+    SnapEndSection(&w);
+    char f1[16] = "TIE_Fighter";
+    refU32(1); refU32(28);
+    refPut(f1, 16); refPut("Tartan_P", 8);
+    char z4[4] = {0};
+    refPut(z4, 4);
+
+    // Section 2: a placeholder patched after the payload.
+    SnapBeginSection(&w, 2);
+    size_t off = SnapOffset(&w);
+    SnapU32(&w, 0);
+    for (uint32_t i = 0; i < 5; i++) SnapU64(&w, 0x1000ull + i);
+    SnapPatchU32(&w, off, 5);
+    SnapEndSection(&w);
+    refU32(2); refU32(44); refU32(5);
+    for (uint64_t i = 0; i < 5; i++) { uint64_t v = 0x1000ull + i; refPut(&v, 8); }
+
+    // Section 3: bigger than one chunk, so it grows instead of splitting.
+    const uint32_t bigWords = SNAP_CHUNK_RESERVE / 4 + 1000;
+    SnapBeginSection(&w, 3);
+    for (uint32_t i = 0; i < bigWords; i++) SnapU32(&w, i * 2654435761u);
+    SnapEndSection(&w);
+    refU32(3); refU32(bigWords * 4);
+    for (uint32_t i = 0; i < bigWords; i++) refU32(i * 2654435761u);
+
+    // Many small sections: the double buffer turns over repeatedly.
+    for (uint32_t id = 10; id < 60; id++) {
+        SnapBeginSection(&w, id);
+        SnapU16(&w, (uint16_t)id);
+        SnapU8(&w, 7);
+        SnapF64(&w, id * 0.5);
+        SnapZeros(&w, 3);
+        SnapEndSection(&w);
+        refU32(id); refU32(14);
+        uint16_t a = (uint16_t)id; refPut(&a, 2);
+        uint8_t b = 7; refPut(&b, 1);
+        double d = id * 0.5; refPut(&d, 8);
+        uint8_t z3[3] = {0}; refPut(z3, 3);
+    }
+
+    SnapWriteResult res;
+    SnapWriterFinish(&w, &res);
+    refU32(0xFFFFFFFFu); refU32(4);
+    refU32(Crc32_Update(0, ref.data(), ref.size()));
+
+    std::vector<uint8_t> got = SnapReadFile(path);
+    Check(res.opened && res.written == res.total && res.total == ref.size(),
+          "Writer reports every byte written, CRC included");
+    Check(got == ref, "Streamed file is byte-identical to the one-buffer build");
+    Check(res.handoffs == 3 + 50 + 1, "One handoff per section plus the end marker");
+    Check(res.grows == 1, "Oversized section grows its chunk once");
+    Check(w.chunks[0].bytes.size() >= SNAP_CHUNK_RESERVE && w.chunks[1].bytes.size() >= SNAP_CHUNK_RESERVE,
+          "Both chunks were reserved up front");
+    remove(path);
+
+    // The writer can be reused: a second capture starts from a clean state.
+    SnapWriterOpen(&w, path, Crc32_Update);
+    SnapBeginSection(&w, 5);
+    SnapEndSection(&w);
+    SnapWriterFinish(&w, &res);
+    got = SnapReadFile(path);
+    Check(res.total == 20 && got.size() == 20 && SnapU32(got, 4) == 0
+          && SnapU32(got, 16) == Crc32_Update(0, got.data(), 16),
+          "Reused writer: empty section, end marker and CRC only");
+    remove(path);
+
+    // Open failure is reported after the capture, nothing reaches disk.
+    SnapWriterOpen(&w, "no_such_dir_for_snap/x.swfocsnap", Crc32_Update);
+    SnapBeginSection(&w, 1);
+    SnapU32(&w, 1);
+    SnapEndSection(&w);
+    SnapWriterFinish(&w, &res);
+    Check(!res.opened && res.written == 0 && res.total == 24,
+          "Unopenable path reports opened=false and zero bytes written");
+
+    // Deferred: the whole capture stays staged until close, one handoff.
+    SnapWriterOpen(&w, path, Crc32_Update, true);
+    for (uint32_t id = 1; id <= 8; id++) {
+        SnapBeginSection(&w, id);
+        SnapFixedStr(&w, "staged", 64);
+        SnapEndSection(&w);
+    }
+    const size_t stagedLen = SnapOffset(&w);
+    SnapWriterClose(&w);
+    for (int i = 0; i < 5000 && !SnapWriterDone(&w); i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    Check(SnapWriterDone(&w), "Deferred writer finishes without a join");
+    SnapWriterCollect(&w, &res);
+    got = SnapReadFile(path);
+    Check(stagedLen == 8 * 72 && res.handoffs == 1 && res.stalls == 0,
+          "Deferred writer stages every section and hands off once at close");
+    Check(res.written == res.total && got.size() == stagedLen + 12
+          && SnapU32(got, stagedLen + 8) == Crc32_Update(0, got.data(), stagedLen + 8),
+          "Deferred file carries the end marker and a valid CRC");
+    remove(path);
+}
+
+// SWFOC_DumpStateAsync / SWFOC_DumpStatePoll. Pins:
+//   * the async file equals the sync capture except the timestamp and CRC
+//   * Poll gives PENDING or the sync reply, then forgets the id
+//   * a finished, never-polled capture is reclaimed when every slot is taken
+static std::string SnapPollUntilDone(FakeLuaState* L, uint32_t id) {
+    std::string reply;
+    for (int i = 0; i < 5000; i++) {
+        L->stack.clear();
+        { StackEntry a; a.type = LUA_TNUMBER; a.numval = id; L->stack.push_back(a); }
+        Lua_DumpStatePoll(LS(L));
+        reply = L->stack.back().strval;
+        if (reply.compare(0, 7, "PENDING") != 0) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return reply;
+}
+
+static uint32_t SnapQueueAsync(FakeLuaState* L, const char* path, std::string* reply) {
+    L->stack.clear();
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = path; L->stack.push_back(a); }
+    Lua_DumpStateAsync(LS(L));
+    *reply = L->stack.back().strval;
+    unsigned id = 0;
+    return sscanf(reply->c_str(), "OK: queued id=%u", &id) == 1 ? id : 0;
+}
+
+static void TestSnapshotAsync() {
+    StartSuite("Asynchronous snapshot capture (SWFOC_DumpStateAsync / Poll)");
+    ResetBridgeState();
+    memset(g_gameImage, 0, GAME_IMAGE_SIZE);
+    SetupTestPlayers();
+
+    FakeLuaState L;
+    fake_reset(&L);
+    const char* syncPath = "test_snapshot_sync.swfocsnap";
+    const char* asyncPath = "test_snapshot_async.swfocsnap";
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = syncPath; L.stack.push_back(a); }
+    Lua_DumpState(LS(&L));
+
+    std::string reply;
+    uint32_t id = SnapQueueAsync(&L, asyncPath, &reply);
+    Check(id != 0, "DumpStateAsync returns 'OK: queued id=N'");
+    Check(reply.find("bytes staged") != std::string::npos, "Queued reply reports the staged size");
+
+    std::string done = SnapPollUntilDone(&L, id);
+    Check(done.compare(0, 24, "OK: snapshot written to ") == 0,
+          "Poll returns the DumpState OK reply once written");
+
+    std::vector<uint8_t> a = SnapReadStream(syncPath);
+    std::vector<uint8_t> b = SnapReadStream(asyncPath);
+    bool same = a.size() == b.size() && a.size() > 0x1C + 4;
+    if (same) {
+        same = memcmp(a.data(), b.data(), 0x14) == 0
+            && memcmp(a.data() + 0x1C, b.data() + 0x1C, a.size() - 0x1C - 4) == 0;
+    }
+    Check(same, "Async file matches the sync capture apart from timestamp and CRC");
+    Check(b.size() >= 4 && SnapU32(b, b.size() - 4) == Crc32_Update(0, b.data(), b.size() - 4),
+          "Async file CRC covers every byte before it");
+
+    reply = SnapPollUntilDone(&L, id);
+    Check(reply.find("unknown capture id") != std::string::npos, "A retired id is forgotten");
+    L.stack.clear();
+    Lua_DumpStateAsync(LS(&L));
+    Check(L.stack.back().strval.find("expected string path") != std::string::npos,
+          "DumpStateAsync rejects a missing path");
+
+    // Fill every slot, let them finish unpolled, then queue one more.
+    uint32_t ids[SNAP_ASYNC_SLOTS];
+    for (int i = 0; i < SNAP_ASYNC_SLOTS; i++) ids[i] = SnapQueueAsync(&L, asyncPath, &reply);
+    for (int spin = 0; spin < 5000; spin++) {
+        bool all = true;
+        for (SnapAsyncJob& job : g_snapJobs) all = all && job.id && SnapWriterDone(job.writer);
+        if (all) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    uint32_t extra = SnapQueueAsync(&L, asyncPath, &reply);
+    Check(extra != 0, "A full table reclaims a finished capture");
+    Check(SnapPollUntilDone(&L, ids[0]).find("unknown capture id") != std::string::npos,
+          "The oldest unpolled capture is the one reclaimed");
+    bool rest = SnapPollUntilDone(&L, extra).compare(0, 3, "OK:") == 0;
+    for (int i = 1; i < SNAP_ASYNC_SLOTS; i++) {
+        rest = rest && SnapPollUntilDone(&L, ids[i]).compare(0, 3, "OK:") == 0;
+    }
+    Check(rest, "The other captures still poll OK");
+
+    remove(syncPath);
+    remove(asyncPath);
+}
+
+// snap_lz4.h and v3 snapshots. Pins:
+//   * every input round-trips; zero runs shrink, random bytes do not grow
+//     past SnapLz4Bound, and a too-small capacity reports 0
+//   * truncated blocks, bad offsets and a wrong raw length are rejected
+//   * SWFOC_DumpState(path, "lz4") writes v3 whose expanded stream is the
+//     v2 capture with only the magic, version, timestamp and CRC changed,
+//     and whose CRC covers that expanded stream
+static bool SnapLz4RoundTrips(const std::vector<uint8_t>& src, size_t* packedLen) {
+    std::vector<uint8_t> packed(SnapLz4Bound(src.size()));
+    *packedLen = SnapLz4Compress(src.data(), src.size(), packed.data(), packed.size());
+    std::vector<uint8_t> back(src.size() + 1);
+    return *packedLen != 0
+        && SnapLz4Decompress(packed.data(), *packedLen, back.data(), src.size())
+        && memcmp(back.data(), src.data(), src.size()) == 0;
+}
+
+static void TestSnapLz4() {
+    StartSuite("LZ4 snapshot sections (snap_lz4.h, v3)");
+
+    uint32_t rng = 0x2545F491u;
+    std::vector<uint8_t> random(5000);
+    for (uint8_t& b : random) { rng = rng * 1664525u + 1013904223u; b = (uint8_t)(rng >> 24); }
+    std::vector<uint8_t> mixed;
+    for (int i = 0; i < 40; i++) {
+        mixed.insert(mixed.end(), 300, (uint8_t)0);             // 300-byte match runs
+        mixed.insert(mixed.end(), random.begin() + i * 60, random.begin() + i * 60 + 40);
+    }
+    size_t n = 0;
+    Check(SnapLz4RoundTrips(std::vector<uint8_t>(), &n) && n == 1, "Empty input is a single token");
+    Check(SnapLz4RoundTrips(std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7}, &n), "Tiny input round-trips");
+    std::vector<uint8_t> zeros(70000, 0);
+    Check(SnapLz4RoundTrips(zeros, &n) && n < 400, "70 KB of zeros round-trips into < 400 bytes");
+    Check(SnapLz4RoundTrips(random, &n) && n <= SnapLz4Bound(random.size()),
+          "Random bytes round-trip within SnapLz4Bound");
+    Check(SnapLz4RoundTrips(mixed, &n) && n < mixed.size() / 4, "Long literal and match runs round-trip");
+
+    std::vector<uint8_t> packed(SnapLz4Bound(mixed.size()));
+    Check(SnapLz4Compress(random.data(), random.size(), packed.data(), random.size() - 5) == 0,
+          "Incompressible input does not fit a smaller capacity");
+    size_t len = SnapLz4Compress(mixed.data(), mixed.size(), packed.data(), packed.size());
+    std::vector<uint8_t> back(mixed.size());
+    Check(!SnapLz4Decompress(packed.data(), len - 1, back.data(), mixed.size()),
+          "A truncated block is rejected");
+    Check(!SnapLz4Decompress(packed.data(), len, back.data(), mixed.size() - 1),
+          "A block that overruns its raw length is rejected");
+    const uint8_t badOffset[] = {0x10, 'a', 0x09, 0x00, 0x00};  // match 9 back after 1 byte
+    Check(!SnapLz4Decompress(badOffset, sizeof(badOffset), back.data(), 64),
+          "A match before the output start is rejected");
+
+    ResetBridgeState();
+    memset(g_gameImage, 0, GAME_IMAGE_SIZE);
+    SetupTestPlayers();
+    FakeLuaState L;
+    fake_reset(&L);
+    const char* rawPath = "test_snapshot_v2.swfocsnap";
+    const char* lz4Path = "test_snapshot_v3.swfocsnap";
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = rawPath; L.stack.push_back(a); }
+    Lua_DumpState(LS(&L));
+    L.stack.clear();
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = lz4Path; L.stack.push_back(a); }
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = "lz4"; L.stack.push_back(a); }
+    Lua_DumpState(LS(&L));
+    Check(L.stack.back().strval.find(", lz4 from ") != std::string::npos,
+          "lz4 DumpState reports the uncompressed size");
+
+    std::vector<uint8_t> v2 = SnapReadStream(rawPath);
+    std::vector<uint8_t> v3 = SnapReadStream(lz4Path);
+    Check(v3.size() > 68 && memcmp(v3.data(), "SWFOCSNAPv3", 12) == 0 && SnapU32(v3, 16) == 3,
+          "lz4 capture carries the v3 magic and format_version 3");
+    Check(v3.size() < v2.size(), "lz4 capture is smaller than the v2 capture");
+    Check(v3.size() > 76 && (SnapU32(v3, 68) & SNAP_SECTION_LZ4) && (SnapU32(v3, 68) & SNAP_SECTION_ID_MASK) == 1,
+          "Section 1 (mostly padding) is stored compressed");
+
+    std::vector<uint8_t> expanded;
+    const char* err = SnapLz4ExpandSections(v3.data(), v3.size(), 68, &expanded);
+    Check(err == nullptr, "v3 capture expands");
+    bool same = expanded.size() == v2.size() && v2.size() > 0x1C + 4;
+    if (same) {
+        same = memcmp(expanded.data(), v2.data(), 10) == 0
+            && memcmp(expanded.data() + 11, v2.data() + 11, 5) == 0
+            && memcmp(expanded.data() + 0x1C, v2.data() + 0x1C, v2.size() - 0x1C - 4) == 0;
+    }
+    Check(same, "Expanded v3 equals the v2 capture apart from magic, version, timestamp, CRC");
+    Check(expanded.size() >= 4
+          && SnapU32(expanded, expanded.size() - 4) == Crc32_Update(0, expanded.data(), expanded.size() - 4),
+          "v3 CRC covers the uncompressed stream");
+
+    std::vector<uint8_t> corrupt = v3;
+    corrupt[68 + 12] ^= 0xFF;
+    Check(SnapLz4ExpandSections(corrupt.data(), corrupt.size(), 68, &expanded) != nullptr
+          || SnapU32(expanded, expanded.size() - 4) != Crc32_Update(0, expanded.data(), expanded.size() - 4),
+          "A corrupted compressed section fails to expand or fails the CRC");
+    corrupt = v3;
+    corrupt[68 + 8] = 0xFF; corrupt[68 + 9] = 0xFF; corrupt[68 + 10] = 0xFF; corrupt[68 + 11] = 0x7F;
+    Check(SnapLz4ExpandSections(corrupt.data(), corrupt.size(), 68, &expanded) != nullptr,
+          "An impossible raw_length is rejected before allocating");
+
+    L.stack.clear();
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = lz4Path; L.stack.push_back(a); }
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = "zstd"; L.stack.push_back(a); }
+    Lua_DumpState(LS(&L));
+    Check(L.stack.back().strval.find("unknown codec 'zstd'") != std::string::npos,
+          "DumpState rejects an unknown codec");
+
+    L.stack.clear();
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = lz4Path; L.stack.push_back(a); }
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = "lz4"; L.stack.push_back(a); }
+    Lua_DumpStateAsync(LS(&L));
+    unsigned id = 0;
+    sscanf(L.stack.back().strval.c_str(), "OK: queued id=%u", &id);
+    Check(id != 0 && SnapPollUntilDone(&L, id).find(", lz4 from ") != std::string::npos,
+          "lz4 DumpStateAsync polls to a compressed capture");
+    std::vector<uint8_t> async = SnapReadStream(lz4Path);
+    Check(async.size() == v3.size()
+          && memcmp(async.data() + 0x1C, v3.data() + 0x1C, v3.size() - 0x1C - 4) == 0,
+          "Async lz4 capture matches the sync one");
+
+    remove(rawPath);
+    remove(lz4Path);
+}
+
+// snap_delta.h and v4 delta snapshots. Pins:
+//   * a patch copies unchanged keyed records and carries changed, new and
+//     reordered ones; applying it gives the new payload byte for byte
+//   * SWFOC_DumpState(path, "delta") needs a base, writes only section 0
+//     and the patched section 1 after a credits change, and rebuilds (also
+//     through a delta base) into the same sections a full capture has,
+//     under the delta's CRC
+//   * a base section the capture no longer has is dropped
+static std::vector<uint8_t> SnapUnitRecord(uint64_t addr, float hull, uint32_t hardpoints) {
+    std::vector<uint8_t> r(92 + 4 * hardpoints, 0);
+    memcpy(r.data(), &addr, 8);
+    memcpy(r.data() + 76, &hull, 4);
+    memcpy(r.data() + 88, &hardpoints, 4);
+    for (uint32_t i = 0; i < hardpoints; i++) memcpy(r.data() + 92 + 4 * i, &i, 4);
+    return r;
+}
+
+static std::vector<uint8_t> SnapUnitSection(const std::vector<std::vector<uint8_t>>& units) {
+    std::vector<uint8_t> p(4);
+    const uint32_t n = (uint32_t)units.size();
+    memcpy(p.data(), &n, 4);
+    for (const auto& u : units) p.insert(p.end(), u.begin(), u.end());
+    return p;
+}
+
+static std::vector<uint8_t> SnapDumpTo(FakeLuaState* L, const char* path, const char* codec) {
+    L->stack.clear();
+    { StackEntry a; a.type = LUA_TSTRING; a.strval = path; L->stack.push_back(a); }
+    if (codec) { StackEntry a; a.type = LUA_TSTRING; a.strval = codec; L->stack.push_back(a); }
+    Lua_DumpState(LS(L));
+    std::vector<uint8_t> file = SnapReadFile(path);
+    std::vector<uint8_t> stream;
+    if (file.size() < 80 || SnapLz4ExpandSections(file.data(), file.size(), 68, &stream)) stream.clear();
+    return stream;
+}
+
+static bool SnapSameSections(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    std::vector<SnapSectionRef> as, bs;
+    size_t ae = 0, be = 0;
+    if (SnapIndexSections(a.data(), a.size(), 68, &as, &ae)
+        || SnapIndexSections(b.data(), b.size(), 68, &bs, &be)) {
+        return false;
+    }
+    if (!as.empty() && as[0].id == SNAP_DELTA_BASE_ID) as.erase(as.begin());
+    if (!bs.empty() && bs[0].id == SNAP_DELTA_BASE_ID) bs.erase(bs.begin());
+    if (as.size() != bs.size()) return false;
+    for (size_t i = 0; i < as.size(); i++) {
+        if (as[i].id != bs[i].id || as[i].len != bs[i].len
+            || memcmp(a.data() + as[i].off, b.data() + bs[i].off, 8 + as[i].len) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool SnapCrcHolds(const std::vector<uint8_t>& s) {
+    return s.size() >= 4 && SnapU32(s, s.size() - 4) == Crc32_Update(0, s.data(), s.size() - 4);
+}
+
+static void TestSnapDelta() {
+    StartSuite("Delta snapshots (snap_delta.h, v4)");
+
+    const SnapKeyedLayout* units = SnapFindKeyedLayout(12);
+    std::vector<uint8_t> base = SnapUnitSection({
+        SnapUnitRecord(0x1000, 500.0f, 2), SnapUnitRecord(0x2000, 800.0f, 0),
+        SnapUnitRecord(0x3000, 120.0f, 5), SnapUnitRecord(0x4000, 60.0f, 1)});
+    std::vector<uint8_t> cur = SnapUnitSection({
+        SnapUnitRecord(0x4000, 60.0f, 1), SnapUnitRecord(0x1000, 500.0f, 2),
+        SnapUnitRecord(0x2000, 640.0f, 0), SnapUnitRecord(0x5000, 900.0f, 3)});
+    std::vector<uint8_t> patch, applied;
+    Check(units && SnapDeltaPatch(*units, base.data(), base.size(), cur.data(), cur.size(), &patch),
+          "unit_detail payloads split into keyed records");
+    Check(SnapDeltaApplyPatch(*units, base.data(), base.size(), patch.data(), patch.size(), &applied) == nullptr
+          && applied == cur, "Patch rebuilds a reordered, changed, shrunk and grown section");
+    Check(patch.size() == 4 + 2 * 9 + 2 * 1 + (92 + 0) + (92 + 12),
+          "Unchanged units cost a key, changed and new units a literal");
+    std::vector<uint8_t> bad = patch;
+    bad[4 + 1] ^= 0x77;  // first op copies obj_addr 0x4000 -> an unknown key
+    applied.clear();
+    Check(SnapDeltaApplyPatch(*units, base.data(), base.size(), bad.data(), bad.size(), &applied) != nullptr,
+          "A patch copying a key the base lacks is rejected");
+
+    // unit_position (section 14): 20-byte records keyed by obj_addr.
+    auto posSection = [](std::initializer_list<std::pair<uint64_t, float>> rows) {
+        std::vector<uint8_t> out(4);
+        const uint32_t n = (uint32_t)rows.size();
+        memcpy(out.data(), &n, 4);
+        for (const auto& r : rows) {
+            const float xyz[3] = {r.second, -r.second, 0.0f};
+            const size_t at = out.size();
+            out.resize(at + 20);
+            memcpy(&out[at], &r.first, 8);
+            memcpy(&out[at + 8], xyz, 12);
+        }
+        return out;
+    };
+    const SnapKeyedLayout* positions = SnapFindKeyedLayout(14);
+    const std::vector<uint8_t> posBase = posSection({{0x1000, 10.0f}, {0x2000, 20.0f}});
+    const std::vector<uint8_t> posCur = posSection({{0x1000, 10.0f}, {0x2000, 25.0f}});
+    patch.clear();
+    applied.clear();
+    Check(positions && positions->fixed == 20
+          && SnapDeltaPatch(*positions, posBase.data(), posBase.size(), posCur.data(), posCur.size(), &patch)
+          && SnapDeltaApplyPatch(*positions, posBase.data(), posBase.size(), patch.data(), patch.size(), &applied)
+                 == nullptr
+          && applied == posCur && patch.size() < posCur.size(),
+          "unit_position patches keep unmoved units as keys");
+
+    ResetBridgeState();
+    memset(g_gameImage, 0, GAME_IMAGE_SIZE);
+    SetupTestPlayers();
+    g_snapBase.reset();
+    FakeLuaState L;
+    fake_reset(&L);
+    const char* fullPath = "test_snapshot_full.swfocsnap";
+    const char* d1Path = "test_snapshot_d1.swfocsnap";
+    const char* d2Path = "test_snapshot_d2.swfocsnap";
+    SnapDumpTo(&L, d1Path, "delta");
+    Check(L.stack.back().strval.find("no base capture") != std::string::npos,
+          "A delta with no base capture yet is an ERR");
+
+    float* credits = reinterpret_cast<float*>(g_base + PLAYER_BASE_OFF + PLAYER_STRIDE + RVA::PlayerObj::Credits);
+    std::vector<uint8_t> f1 = SnapDumpTo(&L, fullPath, nullptr);
+    *credits = 26000.0f;
+    std::vector<uint8_t> d1 = SnapDumpTo(&L, d1Path, "delta");
+    Check(L.stack.back().strval.find(", delta from ") != std::string::npos,
+          "Delta reply reports the full size");
+    std::vector<uint8_t> d1File = SnapReadFile(d1Path);
+    Check(d1File.size() > 68 && memcmp(d1File.data(), "SWFOCSNAPv4", 12) == 0 && SnapU32(d1File, 16) == 4,
+          "Delta carries the v4 magic and format_version 4");
+    std::vector<SnapSectionRef> secs;
+    size_t endOff = 0;
+    SnapIndexSections(d1.data(), d1.size(), 68, &secs, &endOff);
+    Check(secs.size() == 2 && secs[0].id == SNAP_DELTA_BASE_ID && secs[1].id == (1u | SNAP_SECTION_PATCH),
+          "Only delta_base and the patched player_array are stored");
+    Check(d1File.size() * 4 < f1.size(), "The delta is under a quarter of the full capture");
+
+    std::vector<uint8_t> r1;
+    Check(SnapDeltaReconstruct(f1.data(), f1.size(), d1.data(), d1.size(), 68, &r1) == nullptr
+          && SnapCrcHolds(r1), "Base + delta rebuilds under the delta's CRC");
+    *credits = 27500.0f;
+    std::vector<uint8_t> d2 = SnapDumpTo(&L, d2Path, "lz4+delta");
+    Check(L.stack.back().strval.find(", lz4 delta from ") != std::string::npos,
+          "lz4+delta combines both");
+    std::vector<uint8_t> r2, wrong;
+    Check(SnapDeltaReconstruct(r1.data(), r1.size(), d2.data(), d2.size(), 68, &r2) == nullptr
+          && SnapCrcHolds(r2), "A delta of a delta rebuilds through the chain");
+    Check(SnapDeltaReconstruct(f1.data(), f1.size(), d2.data(), d2.size(), 68, &wrong) != nullptr,
+          "A delta applied to the wrong base is rejected");
+    std::vector<uint8_t> f3 = SnapDumpTo(&L, fullPath, "raw");
+    Check(SnapSameSections(r2, f3), "The rebuilt chain equals a full capture of the same state");
+
+    // Writer level: a section the capture no longer has is dropped.
+    const char* wPath = "test_snapshot_drop.swfocsnap";
+    SnapWriter w;
+    SnapWriteResult res;
+    SnapWriterOpen(&w, wPath, Crc32_Update);
+    SnapWriterKeepStream(&w);
+    SnapZeros(&w, 68);
+    for (uint32_t id : {2u, 7u, 9u}) {
+        SnapBeginSection(&w, id);
+        SnapU32(&w, id);
+        SnapEndSection(&w);
+    }
+    SnapWriterFinish(&w, &res);
+    SnapStream wBase = std::make_shared<const std::vector<uint8_t>>(w.kept);
+    SnapWriterOpen(&w, wPath, Crc32_Update);
+    Check(SnapWriterDeltaAgainst(&w, wBase, 68), "A kept stream is a usable delta base");
+    SnapWriterKeepStream(&w);
+    SnapZeros(&w, 68);
+    SnapWriteDeltaBase(&w);
+    SnapBeginSection(&w, 9);
+    SnapU32(&w, 99);
+    SnapEndSection(&w);
+    SnapWriterFinish(&w, &res);
+    std::vector<uint8_t> drop = SnapReadFile(wPath);
+    SnapIndexSections(drop.data(), drop.size(), 68, &secs, &endOff);
+    Check(secs.size() == 4 && secs[1].id == (2u | SNAP_SECTION_DROP) && secs[2].id == (7u | SNAP_SECTION_DROP)
+          && secs[3].id == 9u, "Vanished sections 2 and 7 are dropped, changed section 9 stored");
+    std::vector<uint8_t> rebuilt;
+    Check(SnapDeltaReconstruct(wBase->data(), wBase->size(), drop.data(), drop.size(), 68, &rebuilt) == nullptr
+          && rebuilt == w.kept, "Rebuilding the drops gives the staged stream");
+
+    remove(fullPath);
+    remove(d1Path);
+    remove(d2Path);
+    remove(wPath);
+}
+
+// snap_index.h and the section index after a capture's CRC. Pins:
+//   * SWFOC_DumpState appends an index whose entries are exactly the
+//     file's sections as stored: ids with their flags, header offsets,
+//     stored lengths and CRCs of the stored payloads, plus the header CRC
+//   * lz4 and delta captures index their compressed / patched sections
+//   * a damaged index fails its own CRC; a writer not asked for one writes
+//     none, and a file without one reports "no section index"
+static bool SnapIndexMatchesFile(const std::vector<uint8_t>& file) {
+    uint32_t headerCrc = 0;
+    std::vector<SnapIndexEntry> entries;
+    if (SnapReadIndex(file.data(), file.size(), Crc32_Update, &headerCrc, &entries)) return false;
+    if (headerCrc != Crc32_Update(0, file.data(), 68)) return false;
+    size_t pos = 68, i = 0;
+    for (; pos + 8 <= file.size() && SnapU32(file, pos) != SNAP_END_SECTION_ID; i++) {
+        const uint32_t len = SnapU32(file, pos + 4);
+        if (i >= entries.size() || entries[i].id != SnapU32(file, pos) || entries[i].off != pos
+            || entries[i].len != len || entries[i].crc != Crc32_Update(0, file.data() + pos + 8, len)) {
+            return false;
+        }
+        pos += 8 + static_cast<size_t>(len);
+    }
+    return i == entries.size() && file.size() == pos + 12 + SnapIndexLength(file.data(), file.size());
+}
+
+static void TestSnapIndex() {
+    StartSuite("Section index (snap_index.h)");
+
+    ResetBridgeState();
+    memset(g_gameImage, 0, GAME_IMAGE_SIZE);
+    SetupTestPlayers();
+    g_snapBase.reset();
+    FakeLuaState L;
+    fake_reset(&L);
+    const char* path = "test_snapshot_index.swfocsnap";
+
+    SnapDumpTo(&L, path, nullptr);
+    std::vector<uint8_t> v2 = SnapReadFile(path);
+    uint32_t headerCrc = 0;
+    std::vector<SnapIndexEntry> entries;
+    Check(SnapReadIndex(v2.data(), v2.size(), Crc32_Update, &headerCrc, &entries) == nullptr
+          && entries.size() == 5 && entries[0].id == 1 && entries[0].off == 68 && entries[4].id == 5,
+          "A v2 capture indexes sections 1 .. 5, section 1 at offset 68");
+    Check(SnapIndexMatchesFile(v2), "Every entry matches its section as stored");
+    Check(SnapIndexLength(v2.data(), v2.size()) == SNAP_INDEX_FIXED_BYTES + 5 * SNAP_INDEX_ENTRY_BYTES,
+          "The index costs 20 bytes plus 16 per section");
+
+    SnapDumpTo(&L, path, "lz4");
+    std::vector<uint8_t> v3 = SnapReadFile(path);
+    Check(SnapIndexMatchesFile(v3) && SnapReadIndex(v3.data(), v3.size(), Crc32_Update, &headerCrc, &entries) == nullptr
+          && (entries[0].id & SNAP_SECTION_LZ4), "An lz4 capture indexes its compressed sections as stored");
+    float* credits = reinterpret_cast<float*>(g_base + PLAYER_BASE_OFF + PLAYER_STRIDE + RVA::PlayerObj::Credits);
+    *credits = 31000.0f;
+    SnapDumpTo(&L, path, "delta");
+    std::vector<uint8_t> v4 = SnapReadFile(path);
+    Check(SnapIndexMatchesFile(v4) && SnapReadIndex(v4.data(), v4.size(), Crc32_Update, &headerCrc, &entries) == nullptr
+          && entries.size() == 2 && entries[0].id == SNAP_DELTA_BASE_ID && entries[1].id == (1u | SNAP_SECTION_PATCH),
+          "A delta capture indexes delta_base and its patch");
+
+    std::vector<uint8_t> bad = v2;
+    bad[bad.size() - 12] ^= 0x01;  // last entry's CRC
+    Check(SnapReadIndex(bad.data(), bad.size(), Crc32_Update, &headerCrc, &entries) != nullptr,
+          "A damaged index fails its own CRC");
+    bad = v2;
+    bad[68 + 8] ^= 0x01;
+    Check(SnapReadIndex(bad.data(), bad.size(), Crc32_Update, &headerCrc, &entries) == nullptr
+          && entries[0].crc != Crc32_Update(0, bad.data() + 68 + 8, entries[0].len),
+          "A damaged section fails its entry's CRC");
+
+    SnapWriter w;
+    SnapWriteResult res;
+    SnapWriterOpen(&w, path, Crc32_Update);
+    SnapZeros(&w, 68);
+    SnapBeginSection(&w, 2);
+    SnapU32(&w, 0);
+    SnapEndSection(&w);
+    SnapWriterFinish(&w, &res);
+    std::vector<uint8_t> plain = SnapReadFile(path);
+    Check(plain.size() == 68 + 12 + 12 && SnapIndexLength(plain.data(), plain.size()) == 0
+          && SnapReadIndex(plain.data(), plain.size(), Crc32_Update, &headerCrc, &entries) != nullptr,
+          "A writer not asked for an index writes none");
+    SnapWriterOpen(&w, path, Crc32_Update);
+    SnapWriterIndexSections(&w, 68);
+    SnapZeros(&w, 68);
+    SnapBeginSection(&w, 2);
+    SnapU32(&w, 0);
+    SnapEndSection(&w);
+    SnapWriterFinish(&w, &res);
+    std::vector<uint8_t> indexed = SnapReadFile(path);
+    Check(SnapIndexMatchesFile(indexed) && res.written == res.total && res.total == indexed.size(),
+          "The writer counts the index in the bytes it should write");
+    Check(std::vector<uint8_t>(indexed.begin(), indexed.begin() + plain.size()) == plain,
+          "Indexing leaves the stream ahead of the index unchanged");
+
+    remove(path);
+}
+
+// 2026-10-14. replay_flat.h: the flat containers behind ReplayState.
+// Pins:
+//   * ReplayFlatMap iterates in key order whatever the insertion order
+//   * find / count / [] / erase / at keep their std::map meaning
+//   * ReplaySlotTable never holds a slot outside [0, REPLAY_SLOTS), and
+//     the per-slot mutators reject one
+static void TestReplayFlat() {
+    StartSuite("Flat replay containers (replay_flat.h)");
+
+    ReplayFlatMap<uint64_t, int> m;
+    const uint64_t keys[] = { 0x30, 0x10, 0x50, 0x20, 0x40 };
+    for (uint64_t k : keys) m[k] = static_cast<int>(k);
+    bool ordered = m.size() == 5;
+    uint64_t prev = 0;
+    for (const auto& kv : m) {
+        ordered = ordered && kv.first > prev && kv.second == static_cast<int>(kv.first);
+        prev = kv.first;
+    }
+    Check(ordered, "Entries iterate in key order whatever the insertion order");
+    Check(m.find(0x20) != m.end() && m.find(0x20)->second == 0x20 && m.find(0x25) == m.end(),
+          "find hits a present key and misses an absent one");
+    m[0x20] = 7;
+    Check(m.size() == 5 && m.at(0x20) == 7, "[] on a present key updates it in place");
+    Check(m[0x60] == 0 && m.size() == 6 && m.count(0x60) == 1, "[] on an absent key inserts a default");
+    Check(m.erase(0x30) == 1 && m.erase(0x30) == 0 && m.count(0x30) == 0 && m.size() == 5,
+          "erase removes a key once");
+    bool threw = false;
+    try { m.at(0x30); } catch (const std::out_of_range&) { threw = true; }
+    Check(threw, "at on an absent key throws");
+
+    ReplayFlatMap<std::pair<std::string, std::string>, std::string> d;
+    d[{"REBEL", "EMPIRE"}] = "enemy";
+    d[{"EMPIRE", "REBEL"}] = "enemy";
+    d[{"EMPIRE", "EMPIRE"}] = "ally";
+    Check(d.begin()->first.second == "EMPIRE" && d.find({"REBEL", "EMPIRE"}) != d.end(),
+          "Pair keys sort and look up like std::map");
+
+    ReplaySlotTable<float> t;
+    t[3] = 2.0f;
+    t[0] = 0.5f;
+    Check(t.size() == 2 && t.count(3) == 1 && t.find(3)->second == 2.0f && t.find(3)->first == 3,
+          "A slot table stores by slot");
+    Check(t.find(1) == t.end() && t.count(-1) == 0 && t.count(REPLAY_SLOTS) == 0,
+          "Absent and out-of-range slots are not found");
+    Check(t.erase(3) == 1 && t.erase(3) == 0 && t.size() == 1, "erase removes a slot once");
+    t.clear();
+    Check(t.empty() && t.count(0) == 0, "clear empties the table");
+
+    ReplayState s;
+    Check(ReplayMutSetDamageMultiplier(s, REPLAY_SLOTS, 2.0f) == 0
+          && ReplayMutSetFreezeCredits(s, REPLAY_SLOTS, true, 100.0) == 0
+          && ReplayMutSetUnitCapOverride(s, REPLAY_SLOTS, 5) == 0,
+          "Per-slot mutations reject a slot past REPLAY_SLOTS");
+    Check(ReplayMutSetDamageMultiplier(s, REPLAY_SLOTS - 1, 2.0f) == 1
+          && ReplayObsGetDamageMultiplier(s, REPLAY_SLOTS - 1) == 2.0f
+          && ReplayObsGetDamageMultiplier(s, REPLAY_SLOTS) == s.global_damage_mult,
+          "The last slot stores; a slot past it reads the global value");
+
+    for (uint64_t a = 40; a > 0; a--) ReplayMutMockUnit(s, a * 0x100, "UNIT", 1, 50.0f, 100.0f, 1);
+    ReplayUnitDetail* u = ReplayFindUnit(s, 0x1400);
+    Check(s.units.size() == 40 && u && u->obj_addr == 0x1400 && u->hardpoints.size() == 1,
+          "Units mocked in reverse order are all found");
+    Check(s.units.begin()->first == 0x100, "Units iterate by obj_addr");
+}
+
+// 2026-10-14. replay_symbols.h: interned names behind behaviors, diplomacy
+// and faction lookups. Pins:
+//   * spellings that differ only in case intern to one symbol
+//   * a lookup never interns, and an unknown name matches nothing
+//   * symbols survive the table growing
+//   * the string-facing helpers keep their case-insensitive behavior
+static void TestReplaySymbols() {
+    StartSuite("Interned replay names (replay_symbols.h)");
+
+    const ReplaySymbol a = ReplayIntern("Shield_Generator");
+    Check(a != 0 && ReplayIntern("SHIELD_GENERATOR") == a && ReplayFindSymbol("shield_generator") == a,
+          "Case variants intern to one symbol");
+    Check(ReplaySymbolName(a) == "SHIELD_GENERATOR", "The symbol's name is the folded spelling");
+    const size_t before = ReplaySymbolCount();
+    Check(ReplayFindSymbol("NO_SUCH_BEHAVIOR_EVER") == 0 && ReplaySymbolCount() == before,
+          "A lookup of an unknown name returns 0 and interns nothing");
+
+    char name[32];
+    std::vector<ReplaySymbol> ids;
+    for (int i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "SYMBOL_GROWTH_%d", i);
+        ids.push_back(ReplayIntern(name));
+    }
+    bool stable = ReplayFindSymbol("Shield_Generator") == a;
+    for (int i = 0; i < 200; i++) {
+        snprintf(name, sizeof(name), "symbol_growth_%d", i);
+        stable = stable && ReplayFindSymbol(name) == ids[i];
+    }
+    Check(stable, "Symbols keep their ids as the table grows");
+    Check(ReplaySameName("Rebel", "REBEL") && !ReplaySameName("REBEL", "REBELS"),
+          "ReplaySameName folds case and compares lengths");
+
+    ReplayState s;
+    ReplayMutMockUnit(s, 0xA0, "X_WING", 0, 100.0f, 100.0f, 2);
+    Check(ReplayMutAttachBehavior(s, 0xA0, 0, "Invulnerable") == 1
+          && ReplayHardpointHasBehavior(ReplayFindUnit(s, 0xA0)->hardpoints[0], "INVULNERABLE")
+          && ReplayUnitAnyHardpointHasBehavior(*ReplayFindUnit(s, 0xA0), ReplayInvulnerableSymbol()),
+          "An attached behavior matches in any case and by symbol");
+    ReplayMutAttachBehavior(s, 0xA0, 0, "INVULNERABLE");
+    Check(ReplayFindUnit(s, 0xA0)->hardpoints[0].behaviors.size() == 1,
+          "Attaching the same behavior in another case is a no-op");
+    Check(ReplayMutDetachBehavior(s, 0xA0, 0, "never_attached_behavior") == 0
+          && ReplayFindSymbol("never_attached_behavior") == 0,
+          "Detaching an unknown behavior changes nothing and interns nothing");
+    Check(ReplayMutDetachBehavior(s, 0xA0, 0, "invulnerable") == 1
+          && ReplayFindUnit(s, 0xA0)->hardpoints[0].behaviors.empty(),
+          "Detach matches in any case");
+
+    ReplayMutSetDiplomacy(s, "Rebel", "Empire", "allied");
+    Check(ReplayObsDiplomaticState(s, "EMPIRE", "rebel") == "allied",
+          "Diplomacy keys ignore order and case");
+    Check(ReplayObsDiplomaticState(s, "REBEL", "NEVER_NAMED_FACTION") == "hostile"
+          && ReplayFindSymbol("NEVER_NAMED_FACTION") == 0,
+          "An unknown faction reads hostile without being interned");
+}
+
+// 2026-10-14. ReplayUnitTable's arena (replay_state.h). Pins:
+//   * rows a table inserts allocate their names and lists from its arena,
+//     hardpoints and abilities added later included
+//   * a forked table's copied rows live on the heap and outlive the
+//     original's clear()
+//   * clear() empties the table and the next rows reuse the arena
+static void TestReplayUnitArena() {
+    StartSuite("Units table arena (ReplayUnitTable)");
+
+    std::pmr::memory_resource* heap = std::pmr::get_default_resource();
+    ReplayState s;
+    ReplayMutMockUnit(s, 0xA0, "Aggressor_Destroyer_Long_Name", 1, 500.0f, 500.0f, 3);
+    ReplayMutAttachBehavior(s, 0xA0, 1, "INVULNERABLE");
+    ReplayMutAddUnitAbility(s, 0xA0, 0, "Ion_Cannon_Shot_Long_Name", 0, true);
+    const ReplayUnitDetail* u = ReplayFindUnit(s, 0xA0);
+    std::pmr::memory_resource* arena = u->type_name.get_allocator().resource();
+    Check(arena != heap && u->hardpoints.get_allocator().resource() == arena
+              && u->hardpoints[1].behaviors.get_allocator().resource() == arena
+              && u->abilities[0].name.get_allocator().resource() == arena,
+          "A row's name, hardpoints, behaviors and abilities come from the table's arena");
+    ReplayMutMockUnit(s, 0x10, "TIE_Fighter", 2, 50.0f, 50.0f, 1);
+    Check(ReplayFindUnit(s, 0xA0)->hardpoints[1].behaviors.get_allocator().resource() == arena
+              && ReplayHardpointHasBehavior(ReplayFindUnit(s, 0xA0)->hardpoints[1], "INVULNERABLE"),
+          "Rows shifted by an insertion keep their arena storage and contents");
+
+    ReplayState f = s;
+    ReplayMutSetUnitHull(f, 0xA0, 10.0f);
+    const ReplayUnitDetail* fu = ReplayFindUnit(f, 0xA0);
+    Check(!f.units.SharedWith(s.units) && fu->type_name.get_allocator().resource() == heap
+              && fu->hardpoints[1].behaviors.get_allocator().resource() == heap,
+          "A forked table copies its rows onto the heap");
+    ReplayClearSnapshot(s);
+    Check(s.units.empty() && ReplayFindUnit(f, 0xA0)->type_name == "Aggressor_Destroyer_Long_Name"
+              && ReplayHardpointHasBehavior(ReplayFindUnit(f, 0xA0)->hardpoints[1], "INVULNERABLE")
+              && ReplayFindUnit(f, 0xA0)->abilities[0].name == "Ion_Cannon_Shot_Long_Name",
+          "The fork's rows survive the original's clear");
+
+    ReplayMutMockUnit(s, 0xB0, "Victory_Destroyer_Long_Name", 1, 800.0f, 800.0f, 2);
+    Check(s.units.size() == 1 && ReplayFindUnit(s, 0xB0)->type_name.get_allocator().resource() == arena
+              && ReplayFindUnit(s, 0xB0)->hardpoints.size() == 2,
+          "Rows after a clear reuse the same arena");
+}
+
+// A stack that keeps real tables, for lua_table_rows.h (fake_lua.cpp drops
+// what settable / rawseti store outside the globals and the registry).
+struct MiniLuaTable;
+struct MiniLuaValue {
+    int                           type = LUA_TNIL;
+    double                        num  = 0.0;
+    std::string                   str;
+    std::shared_ptr<MiniLuaTable> table;
+};
+struct MiniLuaTable {
+    std::map<std::string, MiniLuaValue> fields;
+    std::map<int, MiniLuaValue>         slots;
+};
+struct MiniLua {
+    std::vector<MiniLuaValue> stack;
+    int                       pushstrings = 0;
+};
+
+static MiniLua* Mini(lua_State* L) { return reinterpret_cast<MiniLua*>(L); }
+static size_t MiniAt(lua_State* L, int idx) {
+    return idx > 0 ? (size_t)(idx - 1) : Mini(L)->stack.size() + (size_t)idx;
+}
+static int Mini_gettop(lua_State* L) { return (int)Mini(L)->stack.size(); }
+static void Mini_settop(lua_State* L, int idx) { Mini(L)->stack.resize(idx >= 0 ? idx : MiniAt(L, idx) + 1); }
+static void Mini_newtable(lua_State* L) {
+    MiniLuaValue v;
+    v.type = LUA_TTABLE;
+    v.table = std::make_shared<MiniLuaTable>();
+    Mini(L)->stack.push_back(v);
+}
+static void Mini_pushvalue(lua_State* L, int idx) { Mini(L)->stack.push_back(Mini(L)->stack[MiniAt(L, idx)]); }
+static const char* Mini_pushstring(lua_State* L, const char* s) {
+    MiniLuaValue v;
+    v.type = LUA_TSTRING;
+    v.str = s;
+    Mini(L)->stack.push_back(v);
+    Mini(L)->pushstrings++;
+    return Mini(L)->stack.back().str.c_str();
+}
+static void Mini_pushnumber(lua_State* L, double n) {
+    MiniLuaValue v;
+    v.type = LUA_TNUMBER;
+    v.num = n;
+    Mini(L)->stack.push_back(v);
+}
+static void Mini_settable(lua_State* L, int idx) {
+    std::shared_ptr<MiniLuaTable> t = Mini(L)->stack[MiniAt(L, idx)].table;
+    MiniLuaValue value = Mini(L)->stack.back();
+    const std::string key = Mini(L)->stack[Mini(L)->stack.size() - 2].str;
+    Mini(L)->stack.resize(Mini(L)->stack.size() - 2);
+    if (t) t->fields[key] = value;
+}
+static void Mini_rawseti(lua_State* L, int idx, int n) {
+    std::shared_ptr<MiniLuaTable> t = Mini(L)->stack[MiniAt(L, idx)].table;
+    MiniLuaValue value = Mini(L)->stack.back();
+    Mini(L)->stack.pop_back();
+    if (t) t->slots[n] = value;
+}
+
+// 2026-10-14. lua_table_rows.h: list replies as Lua tables. Pins:
+//   * the rows land in an array from 1, each record keyed by name
+//   * every name is pushed once however many rows there are
+//   * the caller's arguments stay put and the array ends on top
+//   * an over-wide row, an unresolved API and an empty list
+static void TestLuaTableRows() {
+    StartSuite("Lua table replies (lua_table_rows.h)");
+
+    const LuaRowsApi api = {Mini_gettop, Mini_settop,    Mini_newtable,   Mini_pushvalue,
+                            Mini_pushstring, Mini_pushnumber, Mini_settable, Mini_rawseti};
+    LuaRowsApi missing = api;
+    missing.pushvalue = nullptr;
+    Check(LuaRowsApiReady(api) && !LuaRowsApiReady(missing), "The builder needs every entry point");
+
+    MiniLua m;
+    lua_State* L = reinterpret_cast<lua_State*>(&m);
+    Mini_pushnumber(L, 7.0);  // the helper's own arguments
+    Mini_pushstring(L, "arg");
+    m.pushstrings = 0;
+
+    static const char* const kKeys[] = {"obj_addr", "name", "hull"};
+    LuaRows rows;
+    Check(LuaRowsBegin(&rows, api, L, kKeys, 3), "Begin pushes the array and the names");
+    const char* names[] = {"X_Wing", "Y_Wing", "A_Wing", "B_Wing", "E_Wing"};
+    for (int i = 0; i < 5; i++) {
+        LuaRowOpen(&rows);
+        LuaRowNumber(&rows, 0, 0x10000 + i);
+        LuaRowString(&rows, 1, names[i]);
+        LuaRowNumber(&rows, 2, 100.0 * i);
+        LuaRowClose(&rows);
+    }
+    Check(LuaRowsEnd(&rows) == 5, "End reports the rows appended");
+    Check(m.stack.size() == 3 && m.stack[0].num == 7.0 && m.stack[1].str == "arg"
+              && m.stack[2].type == LUA_TTABLE,
+          "The arguments stay below and the array is left on top");
+    const MiniLuaTable& t = *m.stack[2].table;
+    bool fields = t.slots.size() == 5 && t.fields.empty();
+    for (int i = 0; i < 5 && fields; i++) {
+        const auto it = t.slots.find(i + 1);
+        fields = it != t.slots.end() && it->second.type == LUA_TTABLE;
+        if (!fields) break;
+        const MiniLuaTable& r = *it->second.table;
+        fields = r.fields.size() == 3 && r.fields.at("obj_addr").num == 0x10000 + i
+              && r.fields.at("name").str == names[i] && r.fields.at("hull").num == 100.0 * i;
+    }
+    Check(fields, "Rows sit at 1..N, each record keyed by field name");
+    Check(m.pushstrings == 3 + 5, "Names are pushed once; only string values are pushed per row");
+
+    uint64_t objs[] = {0x7FF612345678ULL, 0x7FF612345680ULL};
+    m.stack.clear();
+    LuaRowsBegin(&rows, api, L, nullptr, 0);
+    for (uint64_t obj : objs) LuaRowsNumber(&rows, (double)obj);
+    LuaRowsEnd(&rows);
+    Check(m.stack.size() == 1 && m.stack[0].table->slots.size() == 2
+              && (uint64_t)m.stack[0].table->slots.at(2).num == objs[1],
+          "A flat array holds bare numbers, 48-bit pointers exactly");
+
+    m.stack.clear();
+    LuaRowsBegin(&rows, api, L, kKeys, 3);
+    Check(LuaRowsEnd(&rows) == 0 && m.stack.size() == 1 && m.stack[0].table->slots.empty(),
+          "An empty list is an empty table");
+
+    static const char* const kWide[LUA_ROWS_MAX_KEYS + 1] = {};
+    m.stack.clear();
+    Check(!LuaRowsBegin(&rows, api, L, kWide, LUA_ROWS_MAX_KEYS + 1) && m.stack.empty(),
+          "A row wider than LUA_ROWS_MAX_KEYS is refused before anything is pushed");
+}
+
+static void TestPlanetTable() {
+    StartSuite("Planet ID table and batched edits (planet_table.h)");
+
+    static PlanetTable t;
+    memset(&t, 0, sizeof(t));
+    PlanetTableBegin(&t, 0x1000);
+    const int cor = PlanetTableAdd(&t, 0xA0, "Coruscant");
+    const int kua = PlanetTableAdd(&t, 0xB0, "Kuat");
+    Check(cor == 0 && kua == 1 && t.count == 2 && t.session == 0x1000 && t.builds == 1,
+          "IDs are dense, in walk order");
+    Check(PlanetTableFind(&t, "CORUSCANT") == cor && PlanetTableFind(&t, "coruscant") == cor
+              && PlanetTableFind(&t, "kUaT") == kua && PlanetTableFindN(&t, "Kuatx", 4) == kua,
+          "Lookups ignore case and take a length");
+    Check(PlanetTableFind(&t, "Coruscan") < 0 && PlanetTableFind(&t, "Coruscantt") < 0
+              && PlanetTableFind(&t, "") < 0 && PlanetTableFind(&t, nullptr) < 0,
+          "Prefixes, extensions and empty names miss");
+    Check(PlanetTableAdd(&t, 0xC0, "KUAT") < 0 && PlanetTableAdd(&t, 0xD0, "") < 0 && t.skipped == 2
+              && t.obj[PlanetTableFind(&t, "Kuat")] == 0xB0,
+          "A duplicate or empty name is skipped; the first planet keeps it");
+
+    char name[32];
+    PlanetTableBegin(&t, 0x2000);
+    bool all = true;
+    for (int i = 0; i < PLANET_TABLE_MAX; i++) {
+        snprintf(name, sizeof(name), "Planet_%03d", i);
+        all = all && PlanetTableAdd(&t, 0x10000 + (uint64_t)i, name) == i;
+    }
+    snprintf(name, sizeof(name), "Planet_%03d", PLANET_TABLE_MAX);
+    Check(all && PlanetTableAdd(&t, 1, name) < 0 && t.count == PLANET_TABLE_MAX, "A full session table refuses more");
+    all = PlanetTableFind(&t, "Coruscant") < 0;
+    for (int i = 0; i < PLANET_TABLE_MAX; i++) {
+        snprintf(name, sizeof(name), "PLANET_%03d", i);
+        all = all && PlanetTableFind(&t, name) == i && t.obj[i] == 0x10000 + (uint64_t)i;
+    }
+    Check(all && t.builds == 2, "Every planet of a full table resolves; a new session forgets the old one");
+
+    static PlanetBatchEdit e[PLANET_BATCH_MAX];
+    int n = 0, bad = 0;
+    Check(PlanetBatchParse("Coruscant;owner=2;tech=3|Kuat;buildings=4||kuat;owner=1", e, PLANET_BATCH_MAX, &n, &bad)
+                  == PLANET_BATCH_PARSE_OK
+              && n == 3 && e[0].fields == (PLANET_EDIT_OWNER | PLANET_EDIT_TECH) && e[0].owner == 2
+              && e[0].tech == 3 && e[1].fields == PLANET_EDIT_BUILDINGS && e[1].buildings == 4
+              && !strcmp(e[2].name, "kuat") && e[2].id == -1,
+          "A batch parses every entry's fields; empty entries are skipped");
+    Check(PlanetBatchParse("", e, PLANET_BATCH_MAX, &n, &bad) == PLANET_BATCH_PARSE_EMPTY
+              && PlanetBatchParse("Kuat", e, PLANET_BATCH_MAX, &n, &bad) == PLANET_BATCH_PARSE_FIELD
+              && PlanetBatchParse("Kuat;owner=1|Hoth;color=2", e, PLANET_BATCH_MAX, &n, &bad)
+                     == PLANET_BATCH_PARSE_FIELD && bad == 1 && n == 1
+              && PlanetBatchParse("Kuat;owner=16", e, PLANET_BATCH_MAX, &n, &bad) == PLANET_BATCH_PARSE_NUMBER
+              && PlanetBatchParse("Kuat;tech=2x", e, PLANET_BATCH_MAX, &n, &bad) == PLANET_BATCH_PARSE_NUMBER
+              && PlanetBatchParse("Kuat;buildings=", e, PLANET_BATCH_MAX, &n, &bad) == PLANET_BATCH_PARSE_NUMBER
+              && PlanetBatchParse(";owner=1", e, PLANET_BATCH_MAX, &n, &bad) == PLANET_BATCH_PARSE_NAME
+              && PlanetBatchParse("A;owner=1|B;owner=1", e, 1, &n, &bad) == PLANET_BATCH_PARSE_TOO_MANY,
+          "Empty, fieldless, unknown-field, out-of-range, nameless and oversized batches are refused");
+
+    PlanetTableBegin(&t, 0x3000);
+    PlanetTableAdd(&t, 0xA0, "Coruscant");
+    PlanetTableAdd(&t, 0xB0, "Kuat");
+    PlanetBatchParse("Coruscant;owner=2;tech=3|Hoth;owner=1", e, PLANET_BATCH_MAX, &n, &bad);
+    Check(PlanetBatchResolve(&t, e, n) == 1 && e[0].id == 0 && e[0].obj == 0xA0 && e[1].id == -1,
+          "Resolve reports the first unknown planet");
+
+    static PendingJournal j;
+    PendingJournalInit(&j);
+    PendingState st;
+    PendingStateInit(&st);
+    PendingWrite first = PendingSlotValue(PENDING_PLANET_OWNER, 7, 0.0);
+    strcpy(first.name, "KUAT");
+    PendingJournalPush(&j, first);
+    PlanetBatchParse("Coruscant;owner=2;tech=3|Kuat;buildings=4|kuat;owner=1;buildings=5", e, PLANET_BATCH_MAX,
+                     &n, &bad);
+    Check(PlanetBatchResolve(&t, e, n) == -1 && e[2].id == 1 && e[2].obj == 0xB0, "Every planet resolves");
+    PendingWrite w[3];
+    Check(PlanetBatchWrites(e[0], w) == 2 && w[0].kind == PENDING_PLANET_OWNER && w[0].slot == 2
+              && !strcmp(w[0].name, "CORUSCANT") && w[0].key == 0xA0 && w[1].kind == PENDING_PLANET_TECH
+              && w[1].value == 3.0,
+          "An edit becomes uppercased journal writes keyed by the planet object");
+    const uint32_t folded = PlanetBatchFold(&j, &st, e, n);
+    Check(folded == 5 && !PendingJournalHasWork(&j) && j.applied.load() == 6 && st.planetOwners["KUAT"] == 1
+              && st.planetOwners["CORUSCANT"] == 2 && st.planetTech["CORUSCANT"] == 3
+              && st.planetBuildings["KUAT"] == 5 && !st.planetTech.count("KUAT"),
+          "The batch folds in one pass after the journal; later edits win field by field");
+
+    PendingWrite tech = {};
+    tech.kind = PENDING_PLANET_TECH;
+    Check(PendingJournalPush(&j, tech) == PENDING_PUSH_BAD_NAME, "Planet tech writes need a name");
+}
+
+
+// 2026-10-14. fake_lua.h: call log off by default, checkpoint / restore for
+// batch resets. Pins:
+//   * call_log stays empty unless log_calls is set, and log_calls survives
+//     fake_reset
+//   * fake_restore drops globals added since the checkpoint, puts back ones
+//     overwritten since (even twice), and keeps the registered helpers
+//   * fake_restore empties the stack and clears the error knobs
+//   * without a checkpoint, or after fake_reset, fake_restore is fake_reset
+// 2026-10-14. log_ring.h: the ring behind the bridge's asynchronous Log().
+// Pins:
+//   * level and category filtering, categories taken from the "[Tag]" prefix
+//   * lines come out whole and in order; a long line is cut with "...\n"
+//   * a full ring drops new lines and counts them, and frees on drain
+//   * only one consumer holds the ring; the synchronous flush writes the rest
+//   * concurrent producers lose nothing the drop count misses
+static void TestLogRing() {
+    StartSuite("Asynchronous log ring (log_ring.h)");
+
+    static LogRing ring;
+    LogRingInit(&ring);
+    std::string out;
+    auto sink = [&out](const char* text, uint32_t len) { out.append(text, len); };
+
+    Check(LogCategoryOf("[Pipe] Received %zu bytes\n") == LOG_CAT_PIPE
+          && LogCategoryOf("[DoString] Executing\n") == LOG_CAT_LUA
+          && LogCategoryOf("[DiagSelfTest] ok\n") == LOG_CAT_TEST
+          && LogCategoryOf("Cached game state\n") == LOG_CAT_OTHER
+          && LogCategoryOf("[Nope] x\n") == LOG_CAT_OTHER,
+          "Category comes from the line's [Tag] prefix");
+    Check(LogRingEnabled(&ring, LOG_LEVEL_DEBUG, LOG_CAT_PIPE), "Default level and mask let everything through");
+    ring.level.store(LOG_LEVEL_INFO);
+    ring.categories.store(LOG_CAT_ALL & ~LOG_CAT_PIPE);
+    Check(!LogRingEnabled(&ring, LOG_LEVEL_DEBUG, LOG_CAT_BRIDGE)
+          && !LogRingEnabled(&ring, LOG_LEVEL_INFO, LOG_CAT_PIPE)
+          && LogRingEnabled(&ring, LOG_LEVEL_ERROR, LOG_CAT_BRIDGE),
+          "Lines above the level or outside the mask are filtered");
+    LogRingInit(&ring);
+
+    LogRingPush(&ring, "[Bridge] one %d\n", 1);
+    LogRingPush(&ring, "[Bridge] two %s\n", "2");
+    Check(LogRingTryBeginDrain(&ring), "Consumer takes the ring");
+    Check(!LogRingTryBeginDrain(&ring), "A second consumer is refused while the first holds it");
+    Check(LogRingDrain(&ring, sink) == 2 && out == "[Bridge] one 1\n[Bridge] two 2\n",
+          "Drain writes published lines in order");
+    LogRingEndDrain(&ring);
+
+    out.clear();
+    std::string longText(LOG_RING_LINE_MAX * 2, 'x');
+    LogRingPush(&ring, "[Lua] %s\n", longText.c_str());
+    LogRingTryBeginDrain(&ring);
+    LogRingDrain(&ring, sink);
+    LogRingEndDrain(&ring);
+    Check(out.size() == LOG_RING_LINE_MAX - 1 && out.compare(out.size() - 4, 4, "...\n") == 0,
+          "A long line is cut to the slot and marked");
+
+    int pushed = 0;
+    for (int i = 0; i < LOG_RING_SLOTS + 5; i++) {
+        if (LogRingPush(&ring, "[Test] %d\n", i)) pushed++;
+    }
+    Check(pushed == LOG_RING_SLOTS && ring.dropped.load() == 5, "A full ring drops and counts new lines");
+    out.clear();
+    LogRingTryBeginDrain(&ring);
+    Check(LogRingDrain(&ring, sink) == LOG_RING_SLOTS && out.compare(0, 9, "[Test] 0\n") == 0,
+          "The oldest lines survive an overflow");
+    LogRingEndDrain(&ring);
+    Check(LogRingPush(&ring, "[Test] again\n"), "Drained slots are free again");
+
+    FILE* f = tmpfile();
+    Check(f && LogRingFlush(&ring, f), "Synchronous flush takes a free ring");
+    if (f) {
+        rewind(f);
+        char line[64] = {0};
+        Check(fgets(line, sizeof(line), f) && strcmp(line, "[Test] again\n") == 0,
+              "Synchronous flush writes the queued lines");
+        fclose(f);
+    }
+
+    // Producers racing a consumer.
+    LogRingInit(&ring);
+    const int kProducers = 4, kEach = 5000;
+    std::atomic<int> producersDone{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([p, &producersDone]() {
+            for (int i = 0; i < kEach; i++) LogRingPush(&ring, "[Pipe] %d %d\n", p, i);
+            producersDone.fetch_add(1);
+        });
+    }
+    long lines = 0;
+    bool ordered = true;
+    int last[kProducers] = {-1, -1, -1, -1};
+    for (;;) {
+        const bool finished = producersDone.load() == kProducers;
+        if (LogRingTryBeginDrain(&ring)) {
+            LogRingDrain(&ring, [&](const char* text, uint32_t) {
+                int p = -1, i = -1;
+                if (sscanf(text, "[Pipe] %d %d", &p, &i) != 2 || p < 0 || p >= kProducers || i <= last[p]) {
+                    ordered = false;
+                } else {
+                    last[p] = i;
+                }
+                lines++;
+            });
+            LogRingEndDrain(&ring);
+        }
+        if (finished && ring.tail.load() == ring.head.load()) break;
+        std::this_thread::yield();
+    }
+    for (auto& t : producers) t.join();
+    Check(ordered, "Each producer's lines arrive whole and in order");
+    Check(lines + (long)ring.dropped.load() == (long)kProducers * kEach,
+          "Every line is either written or counted as dropped");
+}
+
+// ----------------------------------------------------------------------
+// perf_hist.h: bucket math, percentiles, concurrent recording, JSON blob
+// ----------------------------------------------------------------------
+static void TestPerfHistograms() {
+    StartSuite("Latency histograms (perf_hist.h)");
+
+    static PerfCounters perf;
+    PerfReset(&perf);
+    Check(PerfBucket(0) == 0 && PerfBucket(1) == 0 && PerfBucket(2) == 1, "Sub-2ns samples land in bucket 0");
+    Check(PerfBucket(1000) == 9 && PerfBucket(~0ull) == PERF_HIST_BUCKETS - 1,
+          "Bucket is floor(log2(ns)), clamped to the open bucket");
+
+    PerfHistogram* exec = &perf.stages[PERF_STAGE_LUA_EXEC];
+    Check(PerfPercentile(exec, 50) == 0, "Empty histogram percentile is 0");
+    for (int i = 0; i < 98; i++) PerfRecord(exec, 3000);  // bucket 11: [2048, 4096)
+    PerfRecord(exec, 900000);                              // bucket 19
+    PerfRecord(exec, 1000000);
+    Check(exec->count.load() == 100 && exec->maxNs.load() == 1000000, "Count and maximum track every sample");
+    Check(PerfPercentile(exec, 50) == 4096, "p50 is the upper bound of the median bucket");
+    Check(PerfPercentile(exec, 99) == 1000000, "p99 is capped at the recorded maximum");
+    PerfRecord(&perf.stages[PERF_STAGE_PIPE_READ], 5);
+    Check(PerfPercentile(&perf.stages[PERF_STAGE_PIPE_READ], 99) == 5, "A lone sample reports itself");
+
+    // Pipe threads and the main thread record together without a lock.
+    PerfHistogram* wait = &perf.stages[PERF_STAGE_MAIN_WAIT];
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([wait, t] {
+            for (int i = 0; i < 10000; i++) PerfRecord(wait, (uint64_t)(t + 1) * 1000);
+        });
+    }
+    for (auto& w : writers) w.join();
+    uint64_t bucketSum = 0;
+    for (const auto& b : wait->buckets) bucketSum += b.load();
+    Check(wait->count.load() == 40000 && bucketSum == 40000 && wait->maxNs.load() == 4000
+          && wait->sumNs.load() == 100000000ull,
+          "Concurrent records lose no samples");
+
+    Check(PerfFuncBind(&perf, 0, "SWFOC_GetVersion") && PerfFuncBind(&perf, 1, "SWFOC_DiagPerf")
+          && !PerfFuncBind(&perf, PERF_FUNC_SLOTS, "SWFOC_TooMany"),
+          "Helpers bind by registration index up to PERF_FUNC_SLOTS");
+    Check(PerfFuncAt(&perf, 2) == nullptr && PerfFuncAt(&perf, -1) == nullptr, "Unbound slots are not timed");
+    PerfFuncSlot* version = PerfFuncAt(&perf, 0);
+    version->calls.fetch_add(3);
+    PerfRecord(&version->latency, 700);
+
+    static char json[PERF_JSON_MAX];
+    const size_t len = PerfFormatJson(&perf, json, sizeof(json));
+    const std::string blob(json, len);
+    Check(len > 0 && blob.front() == '{' && blob.back() == '}', "JSON blob is one object");
+    Check(blob.find("\"lua_exec\":{\"n\":100,") != std::string::npos
+          && blob.find("\"reply_write\":{\"n\":0,") != std::string::npos,
+          "Every stage is reported, recorded or not");
+    Check(blob.find("\"SWFOC_GetVersion\":{\"calls\":3,\"n\":1,\"mean_ns\":700,") != std::string::npos
+          && blob.find("SWFOC_DiagPerf") == std::string::npos,
+          "Called helpers are listed, idle ones left out");
+    Check(blob.find("\"truncated\":false") != std::string::npos, "A roomy buffer is not truncated");
+
+    for (int i = 0; i < PERF_FUNC_SLOTS; i++) {
+        static char names[PERF_FUNC_SLOTS][32];
+        snprintf(names[i], sizeof(names[i]), "SWFOC_Helper%03d", i);
+        PerfFuncBind(&perf, i, names[i]);
+        perf.funcs[i].calls.store(1);
+    }
+    char small[2048];
+    const size_t smallLen = PerfFormatJson(&perf, small, sizeof(small));
+    Check(smallLen < sizeof(small) && small[smallLen - 1] == '}'
+          && strstr(small, "\"truncated\":true}") != nullptr,
+          "A short buffer drops helpers but still closes the object");
+    Check(PerfFormatJson(&perf, small, PERF_JSON_MIN - 1) == 0 && small[0] == '\0',
+          "A buffer too small for the stages yields an empty string");
+
+    PerfReset(&perf);
+    Check(exec->count.load() == 0 && perf.funcs[0].calls.load() == 0 && perf.funcs[0].name != nullptr,
+          "Reset clears samples but keeps helper names bound");
+}
+
+// ----------------------------------------------------------------------
+// hook_cost.h: original excluded, per-thread blocks, overflow, reset
+// ----------------------------------------------------------------------
+static void TestHookCost() {
+    StartSuite("Detour overhead counters (hook_cost.h)");
+
+    static HookCostTable table;
+    HookCostInit(&table);
+    HookCostThread* mine = HookCostClaim(&table, 101);
+    Check(mine == &table.threads[0] && HookCostClaim(&table, 101) == mine, "A thread keeps the block it claimed");
+
+    // Entry at 1000, original runs 1100..1900, exit at 1950: 150 cycles ours.
+    HookCostScope scope;
+    HookCostBegin(&scope, mine, HOOK_COST_SET_HP, 1000);
+    HookCostOriginalBegin(&scope, 1100);
+    HookCostOriginalEnd(&scope, 1900);
+    HookCostEnd(&scope, 1950);
+    // Early return without calling the original: all 40 cycles are ours.
+    HookCostBegin(&scope, mine, HOOK_COST_SET_HP, 5000);
+    HookCostEnd(&scope, 5040);
+    HookCostTotals t = HookCostSum(&table, HOOK_COST_SET_HP);
+    Check(t.calls == 2 && t.cycles == 190 && t.maxCycles == 150 && t.threads == 1,
+          "Cycles spent in the original are not charged to the detour");
+
+    HookCostScope off;
+    HookCostBegin(&off, nullptr, HOOK_COST_SET_HP, 0);
+    HookCostOriginalBegin(&off, 10);
+    HookCostOriginalEnd(&off, 20);
+    HookCostEnd(&off, 30);
+    Check(HookCostSum(&table, HOOK_COST_SET_HP).calls == 2, "A scope begun while profiling was off records nothing");
+
+    for (uint32_t tid = 200; tid < 200 + HOOK_COST_THREADS; tid++) HookCostClaim(&table, tid);
+    Check(HookCostClaim(&table, 999) == &table.overflow && table.overflow.shared,
+          "Threads past HOOK_COST_THREADS share the overflow block");
+
+    std::vector<std::thread> hookers;
+    for (uint32_t n = 0; n < 12; n++) {
+        hookers.emplace_back([n] {
+            HookCostThread* th = HookCostClaim(&table, 300 + n);
+            for (uint64_t i = 0; i < 5000; i++) {
+                HookCostScope sc;
+                HookCostBegin(&sc, th, HOOK_COST_WEAPON_TICK, i * 100);
+                HookCostOriginalBegin(&sc, i * 100 + 10);
+                HookCostOriginalEnd(&sc, i * 100 + 60);
+                HookCostEnd(&sc, i * 100 + 20 + 60 + n);
+            }
+        });
+    }
+    for (auto& h : hookers) h.join();
+    t = HookCostSum(&table, HOOK_COST_WEAPON_TICK);
+    Check(t.calls == 60000 && t.maxCycles == 41, "Owned and overflow blocks aggregate without losing calls");
+    Check(t.cycles == 5000ull * (12 * 30 + 66), "Aggregate cycles sum every thread's share");
+
+    HookCostReset(&table);
+    Check(HookCostSum(&table, HOOK_COST_WEAPON_TICK).calls == 0 && HookCostClaim(&table, 101) == mine,
+          "Reset zeroes counters and keeps thread claims");
+    Check(strcmp(HookCostName(HOOK_COST_TAKE_DAMAGE_OUTER), "TakeDamageOuter") == 0
+          && strcmp(HookCostName(HOOK_COST_COUNT), "unknown") == 0,
+          "Hook names resolve for the report");
+}
+
+// ----------------------------------------------------------------------
+// combat_mods.h: packed modifier word + lazy ownership lookup
+// ----------------------------------------------------------------------
+static void TestPendingJournal() {
+    StartSuite("Pending-write journal (pending_journal.h)");
+
+    static PendingJournal j;
+    static PendingState st;
+    PendingJournalInit(&j);
+    PendingStateInit(&st);
+    Check(!PendingJournalHasWork(&j) && st.buildCostMult[3] == 1.0f && st.unitCap[3] == -1 && st.diplomacy[1][2] == -1,
+          "Fresh journal is empty, state holds neutral defaults");
+
+    Check(PendingJournalPush(&j, PendingSlotValue(PENDING_BUILD_COST_MULT, 3, 2.5)) == PENDING_PUSH_OK &&
+          PendingJournalPush(&j, PendingSlotValue(PENDING_BUILD_COST_MULT, 3, 4.0)) == PENDING_PUSH_OK,
+          "Two writes to one slot queue");
+    Check(PendingJournalPush(&j, PendingSlotValue(PENDING_FACTION_SPEED_MULT, 16, 2.0)) == PENDING_PUSH_BAD_SLOT &&
+          PendingJournalPush(&j, PendingSlotValue(PENDING_TARGET_FILTER, -1, 2.0)) == PENDING_PUSH_BAD_SLOT,
+          "Slots outside 0..15 are refused at push time");
+    Check(PendingJournalHasWork(&j) && st.buildCostMult[3] == 1.0f, "Nothing lands before the apply pass");
+    Check(PendingJournalApply(&j, &st) == 2 && st.buildCostMult[3] == 4.0f &&
+          PendingStateHas(&st, PENDING_BUILD_COST_MULT, 3) && !PendingStateHas(&st, PENDING_BUILD_COST_MULT, 2),
+          "Apply folds in claim order: the later write wins");
+    Check(!PendingJournalHasWork(&j) && PendingJournalApply(&j, &st) == 0, "Applied journal is empty again");
+
+    PendingJournalPush(&j, PendingSlotValue(PENDING_FREEZE_CREDITS, 1, 5000.0, true));
+    PendingJournalPush(&j, PendingSlotValue(PENDING_FREEZE_AI, 2, 0.0, true));
+    PendingJournalPush(&j, PendingGlobal(PENDING_INSTANT_BUILD, 0.0, true));
+    PendingJournalPush(&j, PendingGlobal(PENDING_GAME_SPEED, 0.5, false));
+    PendingJournalApply(&j, &st);
+    Check(PendingStateHas(&st, PENDING_FREEZE_CREDITS, 1) && st.frozenCredits[1] == 5000.0 &&
+          PendingStateHas(&st, PENDING_FREEZE_AI, 2) && PendingToggleOn(&st, PENDING_INSTANT_BUILD) &&
+          !PendingToggleOn(&st, PENDING_FREE_BUILD) && st.gameSpeed == 0.5f,
+          "Set/clear kinds, toggles and scalars fold");
+    PendingJournalPush(&j, PendingSlotValue(PENDING_FREEZE_CREDITS, 1, 0.0, false));
+    PendingJournalPush(&j, PendingGlobal(PENDING_INSTANT_BUILD, 0.0, false));
+    PendingJournalApply(&j, &st);
+    Check(!PendingStateHas(&st, PENDING_FREEZE_CREDITS, 1) && st.frozenCredits[1] == 0.0 &&
+          !PendingToggleOn(&st, PENDING_INSTANT_BUILD),
+          "Disable clears the slot and the toggle");
+
+    PendingWrite dip = PendingSlotValue(PENDING_DIPLOMACY, 5, 1);
+    dip.slot2 = 2;
+    PendingJournalPush(&j, dip);
+    PendingWrite planet = PendingSlotValue(PENDING_PLANET_OWNER, 4, 0.0);
+    strcpy(planet.name, "CORUSCANT");
+    PendingJournalPush(&j, planet);
+    PendingWrite hero = PendingGlobal(PENDING_RESPAWN_TIMER, 3000, false);
+    hero.key = 0x1234;
+    PendingJournalPush(&j, hero);
+    PendingWrite longName = PendingSlotValue(PENDING_PLANET_OWNER, 4, 0.0);
+    memset(longName.name, 'A', PENDING_NAME_MAX);
+    Check(PendingJournalPush(&j, longName) == PENDING_PUSH_BAD_NAME, "Unterminated planet name is refused");
+    PendingJournalApply(&j, &st);
+    Check(st.diplomacy[2][5] == 1 && st.diplomacy[5][2] == -1, "Diplomacy keys by the unordered slot pair");
+    Check(st.planetOwners.count("CORUSCANT") && st.planetOwners["CORUSCANT"] == 4 && st.respawnMs[0x1234] == 3000,
+          "Name- and object-keyed writes fold into their maps");
+
+    PendingWrite field = PendingGlobal(PENDING_UNIT_FIELD, 0.0, false);
+    field.key = 0x5000;
+    strcpy(field.name, "max_speed");
+    for (int i = 1; i <= 100; i++) {
+        field.value = i;
+        PendingJournalPush(&j, field);
+    }
+    strcpy(field.name, "attack_power");
+    PendingJournalPush(&j, field);
+    PendingWrite noField = PendingGlobal(PENDING_UNIT_FIELD, 1.0, false);
+    Check(PendingJournalPush(&j, noField) == PENDING_PUSH_BAD_NAME, "A unit-field write needs a field name");
+    PendingJournalApply(&j, &st);
+    Check(st.unitFields.size() == 2 && st.unitFields[std::make_pair(uint64_t(0x5000), std::string("max_speed"))].value == 100.0f,
+          "Unit-field writes coalesce by (obj_addr, field), last writer wins");
+    for (int i = 0; i < PENDING_UNIT_FIELDS_MAX; i++) {
+        field.key = 0x10000 + i;
+        PendingFold(&st, field);
+    }
+    Check(st.unitFields.size() == PENDING_UNIT_FIELDS_MAX && st.unitFieldsEvicted == 2
+              && !st.unitFields.count(std::make_pair(uint64_t(0x5000), std::string("max_speed"))),
+          "A full unit-field map evicts the writes made longest ago");
+
+    for (int i = 0; i < PENDING_JOURNAL_SLOTS; i++) PendingJournalPush(&j, PendingSlotValue(PENDING_UNIT_CAP, i % 16, i));
+    Check(PendingJournalPush(&j, PendingSlotValue(PENDING_UNIT_CAP, 0, 1)) == PENDING_PUSH_FULL && j.dropped.load() == 1,
+          "Full journal refuses and counts the write");
+    Check(PendingJournalApply(&j, &st) == PENDING_JOURNAL_SLOTS && st.unitCap[15] == PENDING_JOURNAL_SLOTS - 1,
+          "Full ring drains completely, last write per slot wins");
+
+    // Several producers, one applier: every write lands exactly once and
+    // each producer's writes keep their order.
+    PendingJournalInit(&j);
+    PendingStateInit(&st);
+    const int kPer = 2000;
+    std::atomic<int> done{0};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++) {
+        producers.emplace_back([&j, &done, t, kPer] {
+            for (int i = 1; i <= kPer; i++) {
+                while (PendingJournalPush(&j, PendingSlotValue(PENDING_UNIT_CAP, t, i)) == PENDING_PUSH_FULL) {
+                    std::this_thread::yield();
+                }
+            }
+            done.fetch_add(1);
+        });
+    }
+    uint64_t applied = 0;
+    bool ordered = true;
+    int32_t last[4] = {-1, -1, -1, -1};
+    while (done.load() < 4 || PendingJournalHasWork(&j)) {
+        applied += PendingJournalApply(&j, &st);
+        for (int t = 0; t < 4; t++) {
+            if (st.unitCap[t] < last[t]) ordered = false;
+            last[t] = st.unitCap[t];
+        }
+    }
+    for (auto& th : producers) th.join();
+    applied += PendingJournalApply(&j, &st);
+    Check(applied == 4u * kPer && j.applied.load() == 4u * kPer, "Concurrent producers: every write applied once");
+    Check(ordered && st.unitCap[0] == kPer && st.unitCap[3] == kPer, "Per-producer order preserved");
+}
+
+static void TestSlotModifiers() {
+    StartSuite("Per-slot modifier table (slot_mods.h)");
+
+    static SlotModifierTable t;
+    SlotModInit(&t);
+    Check(sizeof(SlotModifiers) == 64 && alignof(SlotModifiers) == 64, "One cache line per slot");
+    float delta = 100.0f;
+    Check(t.slotsActive.load() == 0 && SlotModActive(&t, 3) == nullptr &&
+          SlotModApplyCredits(&t, 3, &delta) && delta == 100.0f,
+          "Fresh table: no slot active, credits pass through");
+
+    Check(SlotModSet(&t, 3, SLOT_MOD_INCOME, 2.0f) && t.slotsActive.load() == (1u << 3),
+          "Setting a multiplier publishes the slot bit");
+    Check(SlotModApplyCredits(&t, 3, &delta) && delta == 200.0f, "Income scales a positive delta");
+    delta = -50.0f;
+    Check(SlotModApplyCredits(&t, 3, &delta) && delta == -50.0f, "Spends are never scaled");
+    delta = 100.0f;
+    Check(SlotModApplyCredits(&t, 4, &delta) && delta == 100.0f, "Other slots are untouched");
+
+    Check(SlotModSetFreeze(&t, 3, true) && !SlotModApplyCredits(&t, 3, &delta) && SlotModFrozen(&t, 3),
+          "Freeze drops the slot's deltas");
+    SlotModSetFreeze(&t, 3, false);
+    Check(t.slotsActive.load() == (1u << 3) && SlotModApplyCredits(&t, 3, &delta) && delta == 200.0f,
+          "Unfreeze keeps the income override active");
+    SlotModSet(&t, 3, SLOT_MOD_INCOME, 1.0f);
+    Check(t.slotsActive.load() == 0 && t.slots[3].active.load() == 0, "Back to 1.0 clears the slot bit");
+
+    Check(!SlotModSet(&t, 16, SLOT_MOD_FIRE_RATE, 2.0f) && !SlotModSet(&t, -1, SLOT_MOD_DAMAGE, 2.0f) &&
+          !SlotModSet(&t, 0, SLOT_MOD_FREEZE_CREDITS, 2.0f),
+          "Bad slots and non-multiplier fields are refused");
+    SlotModSet(&t, 7, SLOT_MOD_DAMAGE, 0.0f);
+    Check(SlotModGet(&t, 7, SLOT_MOD_DAMAGE) == 0.0f && (t.slots[7].active.load() & SLOT_MOD_DAMAGE),
+          "Zero is a real multiplier, not a sentinel");
+    Check(SlotModGet(&t, 99, SLOT_MOD_DAMAGE) == 1.0f, "Out-of-range reads are neutral");
+
+    // Writers on different fields of one slot never leave it hidden.
+    SlotModInit(&t);
+    std::thread a([] { for (int i = 0; i < 20000; i++) SlotModSet(&t, 5, SLOT_MOD_FIRE_RATE, (i & 1) ? 2.0f : 1.0f); });
+    std::thread b([] { for (int i = 0; i < 20000; i++) SlotModSetFreeze(&t, 5, (i & 1) == 0); });
+    a.join();
+    b.join();
+    SlotModSet(&t, 5, SLOT_MOD_BUILD_SPEED, 3.0f);
+    SlotModSet(&t, 5, SLOT_MOD_BUILD_SPEED, 1.0f);
+    Check((t.slots[5].active.load() != 0) == ((t.slotsActive.load() >> 5) & 1u), "Slot bit matches its fields after racing writers");
+}
+
+static void TestCrashTrail() {
+    StartSuite("Crash trail and breadcrumbs (crash_trail.h)");
+
+    static CrashTrail trail;
+    static CrashTrailRecord recs[CRASH_TRAIL_SLOTS];
+    CrashTrailInit(&trail);
+    Check(CrashTrailSnapshot(&trail, recs, CRASH_TRAIL_SLOTS) == 0, "Fresh trail is empty");
+
+    const uint64_t p0 = CrashTrailBegin(&trail, CRASH_TRAIL_PIPE, 7, 100, "SWFOC_SetCredits(0,\n5000)");
+    CrashTrailEnd(&trail, p0);
+    CrashTrailBegin(&trail, CRASH_TRAIL_SHM, 8, 200, "SWFOC_SpawnUnit('X')");
+    uint32_t n = CrashTrailSnapshot(&trail, recs, CRASH_TRAIL_SLOTS);
+    Check(n == 2 && recs[0].done && !recs[1].done && recs[1].kind == CRASH_TRAIL_SHM && recs[1].tid == 8,
+          "Finished and running commands are told apart");
+    Check(strchr(recs[0].text, '\n') == nullptr && strcmp(recs[0].text, "SWFOC_SetCredits(0, 5000)") == 0,
+          "Newlines are flattened");
+
+    std::string longCmd(300, 'a');
+    CrashTrailBegin(&trail, CRASH_TRAIL_BATCH, 1, 300, longCmd.c_str());
+    n = CrashTrailSnapshot(&trail, recs, CRASH_TRAIL_SLOTS);
+    Check(n == 3 && strlen(recs[2].text) == CRASH_TRAIL_TEXT - 1, "Long commands keep a bounded prefix");
+
+    for (int i = 0; i < CRASH_TRAIL_SLOTS + 10; i++) {
+        char cmd[32];
+        snprintf(cmd, sizeof(cmd), "cmd%d", i);
+        CrashTrailEnd(&trail, CrashTrailBegin(&trail, CRASH_TRAIL_PIPE, 1, 1000 + i, cmd));
+    }
+    n = CrashTrailSnapshot(&trail, recs, CRASH_TRAIL_SLOTS);
+    Check(n == CRASH_TRAIL_SLOTS && strcmp(recs[0].text, "cmd10") == 0 &&
+          strcmp(recs[n - 1].text, "cmd73") == 0 && recs[0].pos + CRASH_TRAIL_SLOTS - 1 == recs[n - 1].pos,
+          "Wrapped ring keeps the newest entries, oldest first");
+    Check(CrashTrailSnapshot(&trail, recs, 4) == 4 && strcmp(recs[3].text, "cmd73") == 0,
+          "A short snapshot takes the newest entries");
+
+    const uint64_t stale = trail.head.load() - CRASH_TRAIL_SLOTS;
+    CrashTrailEnd(&trail, stale - 1);
+    trail.entries[(stale + 5) & (CRASH_TRAIL_SLOTS - 1)].seq.fetch_sub(1);  // caught mid-write
+    n = CrashTrailSnapshot(&trail, recs, CRASH_TRAIL_SLOTS);
+    Check(n == CRASH_TRAIL_SLOTS - 1, "A torn entry is skipped");
+
+    CrashCrumbs crumbs = {};
+    CrashCrumbEnter(&crumbs, HOOK_COST_ADD_CREDITS, 10);
+    CrashCrumbEnter(&crumbs, HOOK_COST_SET_HP, 20);
+    CrashCrumbLeave(&crumbs);
+    Check(crumbs.depth == 1 && crumbs.hooks[0] == HOOK_COST_ADD_CREDITS && crumbs.lastHook == HOOK_COST_SET_HP + 1 &&
+          crumbs.entries == 2, "Crumbs track the open detours and the last one entered");
+    for (int i = 0; i < CRASH_CRUMB_DEPTH + 2; i++) CrashCrumbEnter(&crumbs, HOOK_COST_WEAPON_TICK, 30);
+    Check(crumbs.depth == CRASH_CRUMB_DEPTH + 3, "Depth keeps counting past the stack");
+    while (crumbs.depth) CrashCrumbLeave(&crumbs);
+    CrashCrumbLeave(&crumbs);
+    Check(crumbs.depth == 0, "Leave never underflows");
+
+    CrashSymbol syms[] = {{0x3000, "c"}, {0x1000, "a"}, {0x2000, "b"}};
+    CrashSymbolSort(syms, 3);
+    Check(CrashSymbolFind(syms, 3, 0x0fff) == nullptr, "Below the first symbol: none");
+    Check(CrashSymbolFind(syms, 3, 0x2000) == &syms[1] && CrashSymbolFind(syms, 3, 0x2abc) == &syms[1] &&
+          CrashSymbolFind(syms, 3, 0x9999) == &syms[2], "Nearest symbol at or below");
+
+    CrashTrailInit(&trail);
+    CrashTrailEnd(&trail, CrashTrailBegin(&trail, CRASH_TRAIL_PIPE, 4, 1000, "SWFOC_GetCredits(0)"));
+    CrashTrailBegin(&trail, CRASH_TRAIL_BATCH, 4, 3000, "SWFOC_KillUnit(42)");
+    crumbs = {};
+    CrashCrumbEnter(&crumbs, HOOK_COST_DEATH_HANDLER, 2000);
+    static char report[4096];
+    int pos = 0;
+    CrashFormatTrail(report, (int)sizeof(report), &pos, &crumbs, &trail, 4000, 1000,
+                     [](uint32_t hook) { return HookCostName(hook); });
+    Check(pos == (int)strlen(report) && strstr(report, "inside: DeathHandler (entered 2000.0 ms ago)") != nullptr,
+          "Report names the detour the thread is inside");
+    Check(strstr(report, "RUNNING SWFOC_KillUnit(42)") != nullptr && strstr(report, "done    SWFOC_GetCredits(0)") != nullptr,
+          "Report marks the command that never finished");
+
+    pos = 0;
+    char tiny[64];
+    CrashFormatTrail(tiny, (int)sizeof(tiny), &pos, nullptr, &trail, 4000, 1000,
+                     [](uint32_t hook) { return HookCostName(hook); });
+    Check(pos == (int)sizeof(tiny) - 1 && strlen(tiny) == sizeof(tiny) - 1 &&
+          strstr(tiny, "no bridge detour") != nullptr, "Report truncates inside a small buffer");
+}
+
+static void TestCrc32() {
+    StartSuite("Slicing-by-8 CRC32 (crc32.h)");
+
+    auto bytewise = [](uint32_t crc, const uint8_t* p, size_t len) {
+        crc ^= 0xFFFFFFFFu;
+        for (size_t i = 0; i < len; i++) {
+            crc ^= p[i];
+            for (int k = 0; k < 8; k++) crc = (crc & 1) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    };
+
+    Check(Crc32_Update(0, "123456789", 9) == 0xCBF43926u, "Check value of \"123456789\" is 0xCBF43926 (zlib.crc32)");
+    Check(Crc32_Update(0, nullptr, 0) == 0 && Crc32_Update(0x1234u, nullptr, 0) == 0x1234u, "Empty input leaves the CRC unchanged");
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    Check(Crc32_Update(0, fox, strlen(fox)) == 0x414FA339u, "Known 43-byte vector matches zlib");
+
+    std::vector<uint8_t> buf(4096 + 16);
+    uint32_t x = 0x9E3779B9u;
+    for (auto& b : buf) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        b = (uint8_t)x;
+    }
+    bool allMatch = true;
+    for (size_t off = 0; off < 8; off++) {
+        for (size_t len : {(size_t)0, (size_t)1, (size_t)7, (size_t)8, (size_t)9, (size_t)15, (size_t)16,
+                           (size_t)63, (size_t)64, (size_t)65, (size_t)1000, (size_t)4096}) {
+            if (Crc32_Update(0, buf.data() + off, len) != bytewise(0, buf.data() + off, len)) allMatch = false;
+        }
+    }
+    Check(allMatch, "Matches the bitwise reference at every length and alignment tried");
+
+    const uint32_t whole = Crc32_Update(0, buf.data(), 4096);
+    bool chunked = true;
+    for (size_t step : {(size_t)1, (size_t)3, (size_t)8, (size_t)13, (size_t)500}) {
+        uint32_t c = 0;
+        for (size_t pos = 0; pos < 4096; pos += step) c = Crc32_Update(c, buf.data() + pos, std::min(step, (size_t)4096 - pos));
+        if (c != whole) chunked = false;
+    }
+    Check(chunked, "Chunked updates equal one update over the whole buffer");
+}
+
+static void TestHelperScripts() {
+    StartSuite("Precompiled helper scripts (registry closures)");
+
+    FakeLuaState L;
+    fake_reset(&L);
+    int compiled = 0;
+    for (int id = 0; id < HELPER_SCRIPT_COUNT; id++) compiled += CompileHelperScript(LS(&L), id) ? 1 : 0;
+    Check(compiled == HELPER_SCRIPT_COUNT && L.registry.size() == (size_t)HELPER_SCRIPT_COUNT,
+          "RegisterAll-time pass stores one closure per helper script");
+    Check(L.stack.empty(), "Compiling leaves the stack balanced");
+
+    L.log_calls = true;
+    L.call_log.clear();
+    bool pushed = PushHelperScript(LS(&L), HELPER_FACTION_ROSTER);
+    fn_pushstring(LS(&L), "EMPIRE");
+    const int rc = fn_pcall(LS(&L), 1, 1, 0);
+    bool loaded = false;
+    for (const auto& c : L.call_log) loaded |= c.rfind("load(", 0) == 0;
+    Check(pushed && rc == 0 && !loaded, "A call after registration pcalls the closure without lua_load");
+    Check(L.stack.size() == 1, "Closure + argument leave one result");
+    fn_settop(LS(&L), 0);
+
+    // A state RegisterAll never saw compiles on first use, then reuses it.
+    FakeLuaState fresh;
+    fake_reset(&fresh);
+    fresh.log_calls = true;
+    int loads = 0;
+    for (int i = 0; i < 3; i++) {
+        if (PushHelperScript(LS(&fresh), HELPER_GET_PLANETS)) fn_pcall(LS(&fresh), 0, 1, 0);
+        fn_settop(LS(&fresh), 0);
+    }
+    for (const auto& c : fresh.call_log) loads += c.rfind("load(", 0) == 0 ? 1 : 0;
+    Check(loads == 1, "Lazy path compiles once across three calls");
+
+    FakeLuaState broken;
+    fake_reset(&broken);
+    broken.load_error = 3;
+    Check(!PushHelperScript(LS(&broken), HELPER_REVEAL_ALL) && broken.stack.empty(),
+          "A script that fails to load pushes nothing and reports false");
+    Check(broken.registry.empty(), "Nothing is stored for a failed compile");
+}
+
+static void TestTypeCensus() {
+    StartSuite("Type census (one-walk per-type populations)");
+
+    static TypeCensus c;
+    TypeCensusReset(&c);
+    const uint64_t kDestroyer = 0x7ff600001000ull, kTie = 0x7ff600002000ull, kCorvette = 0x7ff600003000ull;
+    for (int i = 0; i < 40; i++) TypeCensusAdd(&c, kTie);
+    for (int i = 0; i < 3; i++) TypeCensusAdd(&c, kDestroyer);
+    for (int i = 0; i < 7; i++) TypeCensusAdd(&c, kCorvette);
+    Check(c.distinct == 3 && c.objects == 50 && c.dropped == 0, "one slot per distinct type");
+
+    for (uint32_t k = 0; k < c.distinct; k++) {
+        const uint16_t i = c.used[k];
+        const char* name = c.type[i] == kTie ? "TIE_FIGHTER" : c.type[i] == kDestroyer ? "STAR_DESTROYER" : "";
+        c.nameHash[i] = name[0] ? TypeCensusNameHash(name, strlen(name)) : 0;
+    }
+    Check(TypeCensusCountByName(&c, "TIE_Fighter") == 40 && TypeCensusCountByName(&c, "Star_Destroyer") == 3,
+          "counts are exact and names match case-insensitively");
+    Check(TypeCensusCountByName(&c, "Corellian_Corvette") == 0 && TypeCensusCountByName(&c, "") == 0,
+          "unresolved or absent names count 0");
+
+    uint16_t top[2];
+    Check(TypeCensusTop(&c, top, 2) == 2 && c.type[top[0]] == kTie && c.type[top[1]] == kCorvette,
+          "top list is ordered by population and honours its limit");
+
+    TypeCensusReset(&c);
+    for (uint64_t t = 1; t <= TYPE_CENSUS_SLOTS; t++) TypeCensusAdd(&c, t << 4);
+    Check(c.distinct == TYPE_CENSUS_SLOTS / 2 && c.dropped == TYPE_CENSUS_SLOTS / 2
+          && c.objects == TYPE_CENSUS_SLOTS,
+          "a full census counts the overflow as dropped");
+    TypeCensusAdd(&c, 1ull << 4);
+    Check(c.count[c.used[0]] == 2, "known types still count when full");
+}
+
+static void TestUnitHandles() {
+    StartSuite("Unit handle table (unit_handles.h)");
+
+    static UnitHandleTable t;
+    memset(&t, 0, sizeof(t));
+    const uint64_t kL = 0x1000, kL2 = 0x2000;
+    const uint64_t kObj = 0x7ff612345670ull, kWrap = 0x7ff6a0000040ull, kType = 0x7ff600001000ull;
+    Check(UnitHandleFind(&t, kL, kObj) == nullptr && UnitHandleFind(&t, kL, 0) == nullptr,
+          "an unbound address (or 0) finds nothing");
+
+    UnitHandleEntry* e = UnitHandleBind(&t, kL, kObj, kWrap, kType);
+    const uint32_t gen = e->gen;
+    Check(UnitHandleFind(&t, kL, kObj) == e && e->wrapper == kWrap && t.resolves == 1,
+          "a bound address finds its wrapper");
+    Check(UnitHandleFind(&t, kL2, kObj) == nullptr, "bindings belong to their lua_State");
+    Check(UnitHandleStillValid(e, kObj, kType), "binding valid while the wrapper owns the object");
+    Check(!UnitHandleStillValid(e, 0, kType) && !UnitHandleStillValid(e, kObj, kType + 0x100),
+          "a released wrapper or a retyped (reused) address is stale");
+
+    UnitHandleDrop(e);
+    Check(UnitHandleFind(&t, kL, kObj) == nullptr && e->gen != gen, "drop forgets the binding and bumps its gen");
+
+    uint64_t other = kObj + 0x10;
+    while (UnitHandleSlot(other) != UnitHandleSlot(kObj)) other += 0x10;
+    UnitHandleBind(&t, kL, kObj, kWrap, kType);
+    UnitHandleBind(&t, kL, other, kWrap + 0x80, kType);
+    Check(UnitHandleFind(&t, kL, kObj) == nullptr && UnitHandleFind(&t, kL, other) != nullptr,
+          "a colliding address replaces the older binding");
+
+    UnitHandleBind(&t, kL2, kObj + 0x20, kWrap, kType);
+    UnitHandleDropState(&t, kL);
+    Check(UnitHandleFind(&t, kL, other) == nullptr && UnitHandleFind(&t, kL2, kObj + 0x20) != nullptr,
+          "closing a state drops only its bindings");
+
+    char key[32];
+    UnitHandleRegistryKey(17, key, sizeof(key));
+    Check(strcmp(key, "SWFOC.Unit.17") == 0, "registry key names the slot");
+}
+
+static void TestSpatialGrid() {
+    StartSuite("Spatial grid (spatial_grid.h range queries)");
+
+    static SpatialGrid g;
+    memset(&g, 0, sizeof(g));
+    const uint64_t objs[5] = {0x100, 0x200, 0x300, 0x400, 0x500};
+    const int32_t owner[5] = {0, 1, 1, 2, 0};
+    float xs[5] = {0.0f, 100.0f, 300.0f, -255.0f, 5000.0f};
+    float ys[5] = {0.0f, 0.0f, 0.0f, -10.0f, 5000.0f};
+    Check(SpatialGridUpdate(&g, objs, owner, xs, ys, 5) && g.count == 5, "first update sorts every unit in");
+
+    uint16_t hits[8];
+    int n = SpatialGridQueryRadius(&g, 0.0f, 0.0f, 100.0f, hits, 8);
+    bool ok = n == 2;
+    for (int k = 0; k < n && k < 8; k++) ok = ok && (g.obj[hits[k]] == 0x100 || g.obj[hits[k]] == 0x200);
+    Check(ok, "radius query finds the units within R (boundary included)");
+    Check(SpatialGridQueryRadius(&g, 0.0f, 0.0f, 300.0f, hits, 8) == 4,
+          "radius spanning cells on both sides of the origin");
+    Check(SpatialGridQueryRadius(&g, 0.0f, 0.0f, 300.0f, hits, 1) == 4,
+          "count is the full total even when the output is capped");
+    Check(SpatialGridQueryRadius(&g, 0.0f, 0.0f, 1e9f, hits, 8) == 5,
+          "a huge radius falls back to the full scan and finds everyone once");
+    Check(SpatialGridQueryRadius(&g, 0.0f, 0.0f, -1.0f, hits, 8) == 0, "negative radius matches nothing");
+
+    n = SpatialGridQueryRect(&g, 400.0f, 10.0f, -300.0f, -20.0f, hits, 8);
+    Check(n == 4, "rect query accepts corners in either order");
+    Check(SpatialGridQueryRect(&g, 4999.0f, 4999.0f, 5001.0f, 5001.0f, hits, 8) == 1
+          && g.obj[hits[0]] == 0x500, "tight rect around a far unit");
+
+    const uint32_t rebuilds = g.rebuilds;
+    xs[1] = 110.0f;  // stays in its cell
+    Check(!SpatialGridUpdate(&g, objs, owner, xs, ys, 5) && g.rebuilds == rebuilds && g.refreshes == 1,
+          "moving within a cell refreshes in place");
+    Check(SpatialGridQueryRadius(&g, 110.0f, 0.0f, 0.5f, hits, 8) == 1 && g.obj[hits[0]] == 0x200,
+          "refreshed position is what queries see");
+    xs[1] = 700.0f;  // crosses into another cell
+    Check(SpatialGridUpdate(&g, objs, owner, xs, ys, 5) && g.rebuilds == rebuilds + 1,
+          "crossing a cell re-sorts");
+    Check(SpatialGridQueryRadius(&g, 700.0f, 0.0f, 1.0f, hits, 8) == 1
+          && SpatialGridQueryRadius(&g, 100.0f, 0.0f, 20.0f, hits, 8) == 0,
+          "the moved unit is found only at its new cell");
+
+    // Cells sharing a bucket never leak into each other's results.
+    int32_t cy = 1;
+    while (SpatialGridBucket(0, cy) != SpatialGridBucket(0, 0)) cy++;
+    const uint64_t pair[2] = {0xA0, 0xB0};
+    const int32_t  po[2] = {0, 0};
+    const float    px[2] = {10.0f, 10.0f};
+    const float    py[2] = {10.0f, cy * SPATIAL_GRID_DEFAULT_CELL + 10.0f};
+    SpatialGridUpdate(&g, pair, po, px, py, 2);
+    Check(SpatialGridQueryRadius(&g, 10.0f, 10.0f, 50.0f, hits, 8) == 1 && g.obj[hits[0]] == 0xA0,
+          "a colliding bucket's other cell is filtered out");
+
+    // Replay: splash limited to the radius once units are placed.
+    ReplayState s;
+    ReplayMutMockUnit(s, 0x1000, "x-wing", 1, 100.0f, 100.0f, 0);
+    ReplayMutMockUnit(s, 0x2000, "a-wing", 1, 100.0f, 100.0f, 0);
+    ReplayMutMockUnit(s, 0x3000, "tie",    0, 100.0f, 100.0f, 0);
+    ReplayMutMockUnit(s, 0x4000, "tie",    0, 100.0f, 100.0f, 0);
+    Check(ReplayMutSetUnitPosition(s, 0x1000, 0.0f, 0.0f, 0.0f) == 1
+          && ReplayMutSetUnitPosition(s, 0x2000, 120.0f, 0.0f, 0.0f) == 1
+          && ReplayMutSetUnitPosition(s, 0x3000, 400.0f, 0.0f, 0.0f) == 1
+          && ReplayMutSetUnitPosition(s, 0x9999, 0.0f, 0.0f, 0.0f) == 0,
+          "replay: positions set on known units only");
+    std::vector<uint64_t> in;
+    Check(ReplayObsUnitsInRadius(s, 0.0f, 0.0f, 150.0f, &in) == 2 && in[0] == 0x1000 && in[1] == 0x2000,
+          "replay: radius query in obj_addr order, unplaced units excluded");
+    ReplayMutSetAreaDamageEnabled(s, true);
+    // 120 of 150 out: a fifth of the 50 splash with the default edge of 0.
+    Check(ReplayMutApplyAreaSplash(s, 0x1000, 100.0f) == 1 && fabsf(ReplayFindUnit(s, 0x2000)->hull - 90.0f) < 1e-3f
+          && ReplayFindUnit(s, 0x3000)->hull == 100.0f && ReplayFindUnit(s, 0x4000)->hull == 100.0f,
+          "replay: a placed primary splashes only the units within area_damage_radius");
+    Check(ReplayMutApplyAreaSplash(s, 0x4000, 100.0f) == 3, "replay: an unplaced primary splashes everyone");
+    Check(ReplayMutSetAreaDamageShape(s, 400.0f, 0.5f, 1.0f) == 1 && ReplayMutSetAreaDamageShape(s, 1.0f, 1.0f, 2.0f) == 0
+          && ReplayMutSetAreaDamageShape(s, -1.0f, 1.0f, 0.0f) == 0 && s.area_damage_radius == 400.0f,
+          "replay: area-damage shape is range-checked");
+    const float h2 = ReplayFindUnit(s, 0x2000)->hull, h3 = ReplayFindUnit(s, 0x3000)->hull;
+    Check(ReplayMutApplyAreaSplash(s, 0x1000, 20.0f) == 2 && ReplayFindUnit(s, 0x2000)->hull == h2 - 10.0f
+          && ReplayFindUnit(s, 0x3000)->hull == h3 - 10.0f,
+          "replay: edge 1 splashes flat across the radius");
+    ReplayMutSetUnitPosition(s, 0x3000, 1000.0f, 0.0f, 0.0f);
+    Check(ReplayMutApplyAreaSplash(s, 0x1000, 100.0f) == 1, "replay: a moved unit leaves the grid's radius");
+    ReplayState copy = s;
+    ReplayMutSetUnitPosition(copy, 0x3000, 10.0f, 0.0f, 0.0f);
+    Check(ReplayObsUnitsInRadius(copy, 0.0f, 0.0f, 50.0f, &in) == 2 && ReplayObsUnitsInRadius(s, 0.0f, 0.0f, 50.0f, &in) == 1,
+          "replay: a copied state keeps its own grid");
+}
+
+static void TestSelectionTracker() {
+    StartSuite("Selection tracker (selection_tracker.h change detection)");
+
+    static SelectionTracker t;
+    memset(&t, 0, sizeof(t));
+    SelectionTrackerReset(&t);
+    Check(!SelectionTrackerFresh(&t, 0, 0), "a reset tracker has no fresh sample");
+
+    const uint64_t vec = 0x7000;
+    uint64_t objs[3] = {0x100, 0x200, 0x300};
+    Check(SelectionTrackerUpdate(&t, vec, objs, 0, 1, 1000) && t.seq == 1 && t.count == 0,
+          "the first sample is a change, even when empty");
+    Check(SelectionTrackerFresh(&t, 1, 1050) && !SelectionTrackerFresh(&t, 2, 1050)
+          && !SelectionTrackerFresh(&t, 1, 1000 + SELECTION_MAX_AGE_MS),
+          "fresh within the same tick and max age only");
+    Check(!SelectionTrackerUpdate(&t, vec, objs, 0, 2, 1100) && t.seq == 1 && t.samples == 2,
+          "an unchanged selection is sampled but not reported");
+
+    Check(SelectionTrackerUpdate(&t, vec, objs, 2, 3, 1200) && t.seq == 2 && t.count == 2
+          && t.objs[0] == 0x100 && t.objs[1] == 0x200, "a new selection is copied in order");
+    Check(SelectionTrackerContains(&t, 0x200) && !SelectionTrackerContains(&t, 0x300),
+          "membership follows the tracked list");
+    const uint64_t swapped[2] = {0x200, 0x100};
+    Check(SelectionTrackerUpdate(&t, vec, swapped, 2, 4, 1300) && t.objs[0] == 0x200,
+          "same units in another order count as a change");
+    const uint64_t other[2] = {0x200, 0x300};
+    Check(SelectionTrackerUpdate(&t, vec, other, 2, 5, 1400) && t.changes == 4,
+          "same size, different unit counts as a change");
+    Check(SelectionTrackerUpdate(&t, 0, other, 2, 6, 1500) && t.count == 0,
+          "an unresolved vector reads as an empty selection");
+    Check(!SelectionTrackerUpdate(&t, 0, objs, 3, 7, 1600), "...and stays unchanged while unresolved");
+
+    static uint64_t many[SELECTION_TRACK_MAX + 8];
+    for (int i = 0; i < SELECTION_TRACK_MAX + 8; i++) many[i] = 0x1000 + 0x10 * (uint64_t)i;
+    SelectionTrackerUpdate(&t, vec, many, SELECTION_TRACK_MAX + 8, 8, 1700);
+    Check(t.count == SELECTION_TRACK_MAX, "an oversized walk is clamped");
+
+    // The event carries the tracker's view of the change.
+    ShmEvtInit(&g_shmEvtBuf);
+    g_shmEvtBuf.flags.store(1);
+    EvtSelection evt;
+    evt.seq = t.seq;
+    evt.count = t.count;
+    evt.first_obj = t.objs[0];
+    evt.hash = t.hash;
+    ShmEvtWrite(&g_shmEvtBuf, EVT_SELECTION, &evt, sizeof(evt));
+    uint8_t out[64];
+    uint16_t type = 0, size = 0;
+    EvtSelection back;
+    const bool read = ShmEvtRead(&g_shmEvtBuf, &type, out, sizeof(out), &size);
+    memcpy(&back, out, sizeof(back));
+    Check(read && type == EVT_SELECTION && size == 24 && back.seq == t.seq && back.first_obj == 0x1000,
+          "EVT_SELECTION round-trips through the event ring");
+}
+
+static void TestPositionTrack() {
+    StartSuite("Position tracking (position_track.h EVT_POSITION batches)");
+
+    static PositionTracker t;
+    PositionTrackReset(&t);
+    const uint64_t objs[5] = {0x100, 0, 0x200, 0x100, 0x300};
+    Check(PositionTrackSetUnits(&t, objs, 5) == 3 && t.objs[0] == 0x100 && t.objs[2] == 0x300,
+          "zeros and duplicates are skipped");
+    Check(!PositionTrackDue(&t, 0), "no rate, not due");
+    PositionTrackSetRate(&t, 500);
+    Check(t.hz == POSITION_TRACK_MAX_HZ && PositionTrackDue(&t, 0), "rate is clamped and due at once");
+
+    bool clamped = false;
+    Check(PositionQuantize(10.3f, 0.5f, &clamped) == 21 && PositionQuantize(-10.3f, 0.5f, &clamped) == -21
+          && !clamped, "quantize rounds to the nearest step");
+    Check(PositionQuantize(1e9f, 0.5f, &clamped) == 32767 && clamped, "out-of-range coordinates clamp");
+
+    // 0x100 at (10, 20, 0); 0x200 unplaced; 0x300 at (1e6, 0, 0).
+    float x100 = 10.0f;
+    bool gone300 = false;
+    auto read = [&](uint64_t obj, float* p) -> int {
+        if (obj == 0x100) { p[0] = x100; p[1] = 20.0f; p[2] = 0.0f; return POS_READ_OK; }
+        if (obj == 0x300) {
+            if (gone300) return POS_READ_GONE;
+            p[0] = 1e6f; p[1] = 0.0f; p[2] = 0.0f;
+            return POS_READ_OK;
+        }
+        return POS_READ_UNPLACED;
+    };
+    static uint8_t rec[POSITION_TRACK_RECORD_MAX];
+    EvtPositionBatch hdr;
+    EvtPositionEntry e;
+
+    uint32_t size = PositionTrackSample(&t, 1000, read, rec);
+    memcpy(&hdr, rec, sizeof(hdr));
+    memcpy(&e, rec + sizeof(hdr), sizeof(e));
+    Check(size == sizeof(hdr) + 2 * sizeof(e) && hdr.seq == 1 && (hdr.flags & POS_BATCH_KEYFRAME)
+          && hdr.unplaced == 1 && hdr.step == POSITION_TRACK_STEP, "first sample is a keyframe of placed units");
+    Check(e.obj == 0x100 && e.x == 20 && e.y == 40 && e.z == 0 && e.flags == 0, "entry is quantized by step");
+    memcpy(&e, rec + sizeof(hdr) + sizeof(e), sizeof(e));
+    Check(e.obj == 0x300 && (e.flags & POS_ENTRY_CLAMPED), "a far unit is flagged clamped");
+    Check(!PositionTrackDue(&t, 1000) && PositionTrackDue(&t, 1000 + 1000 / POSITION_TRACK_MAX_HZ),
+          "next sample is one period later");
+
+    Check(PositionTrackSample(&t, 1100, read, rec) == 0, "nothing moved: no record");
+    x100 = 10.1f;  // same quantum
+    Check(PositionTrackSample(&t, 1200, read, rec) == 0, "movement below one step is not sent");
+    x100 = 11.0f;
+    size = PositionTrackSample(&t, 1300, read, rec);
+    memcpy(&hdr, rec, sizeof(hdr));
+    memcpy(&e, rec + sizeof(hdr), sizeof(e));
+    Check(size == sizeof(hdr) + sizeof(e) && hdr.count == 1 && !(hdr.flags & POS_BATCH_KEYFRAME)
+          && e.obj == 0x100 && e.x == 22, "only the moved unit is sent");
+
+    gone300 = true;
+    size = PositionTrackSample(&t, 1400, read, rec);
+    memcpy(&hdr, rec, sizeof(hdr));
+    memcpy(&e, rec + sizeof(hdr), sizeof(e));
+    Check(hdr.count == 1 && e.obj == 0x300 && (e.flags & POS_ENTRY_GONE) && t.count == 2 && t.gone == 1,
+          "a gone unit is announced once and dropped");
+    Check(t.objs[0] == 0x100 && t.objs[1] == 0x200, "survivors keep their order");
+
+    while (t.seq % POSITION_TRACK_KEYFRAME != 0) PositionTrackSample(&t, 2000, read, rec);
+    size = PositionTrackSample(&t, 3000, read, rec);
+    memcpy(&hdr, rec, sizeof(hdr));
+    Check((hdr.flags & POS_BATCH_KEYFRAME) && hdr.count == 1 && hdr.unplaced == 1,
+          "every POSITION_TRACK_KEYFRAME-th sample resends unmoved units");
+
+    // The record fits the event ring as one EVT_POSITION.
+    ShmEvtInit(&g_shmEvtBuf);
+    g_shmEvtBuf.flags.store(1);
+    Check(ShmEvtWrite(&g_shmEvtBuf, EVT_POSITION, rec, (uint16_t)size), "EVT_POSITION batch is written");
+    uint8_t out[POSITION_TRACK_RECORD_MAX];
+    uint16_t type = 0, got = 0;
+    Check(ShmEvtRead(&g_shmEvtBuf, &type, out, sizeof(out), &got) && type == EVT_POSITION && got == size
+          && memcmp(out, rec, size) == 0, "...and read back intact");
+    Check(POSITION_TRACK_RECORD_MAX < 0xFFFF, "a full batch fits one record");
+}
+
+static void TestEventCompact() {
+    StartSuite("Compact event encoding (event_compact.h EVT_HP_BATCH)");
+
+    uint8_t v[10];
+    uint64_t back = 0;
+    Check(EvtVarintPut(v, 127) == 1 && EvtVarintPut(v, 128) == 2 && EvtVarintGet(v, 2, &back) == 2 && back == 128,
+          "varints are LEB128");
+    Check(EvtVarintPut(v, ~0ull) == 10 && EvtVarintGet(v, 10, &back) == 10 && back == ~0ull
+          && EvtVarintGet(v, 9, &back) == 0, "full-width varint round-trips; truncation is refused");
+    Check(EvtQuantizeFraction(500.0f, 1000.0f) == 16384 && EvtQuantizeFraction(-5.0f, 1000.0f) == 0
+          && EvtQuantizeFraction(5000.0f, 1000.0f) == 65534 && EvtQuantizeFraction(1.0f, 0.0f) == EVT_COMPACT_HP_UNKNOWN,
+          "HP fractions quantize, clamp, and mark an unknown max");
+    Check(fabsf(EvtDequantizeFraction(EvtQuantizeFraction(733.0f, 1000.0f), 1000.0f) - 733.0f) < 0.05f,
+          "a fraction dequantizes to within one step");
+
+    static EvtCompactSet set;
+    memset(&set, 0, sizeof(set));
+    EvtSessionReset(&set.sessions);
+    uint64_t claim = 0;
+    const int sid = EvtSessionAcquire(&set.sessions, 4242, &claim);
+    uint64_t claim2 = 0;
+    Check(sid >= 0 && claim && EvtSessionAcquire(&set.sessions, 4242, &claim2) == -1 && !claim2,
+          "an unpublished session id is not handed to others");
+    EvtSessionPublish(&set.sessions, sid, claim);
+    Check(EvtSessionAcquire(&set.sessions, 4242, &claim2) == sid && !claim2, "a published id is reused");
+    const int other = EvtSessionAcquire(&set.sessions, 4243, &claim2);
+    Check(other >= 0 && other != sid && claim2, "another unit gets its own id");
+    EvtSessionRelease(&set.sessions, other, claim2);
+    Check(EvtSessionAcquire(&set.sessions, 4243, &claim2) == other && claim2, "a released id can be claimed again");
+    EvtSessionReset(&set.sessions);
+    uint64_t fresh = 0;
+    EvtSessionAcquire(&set.sessions, 4242, &fresh);
+    Check(fresh != 0, "a reset forgets every binding");
+    uint64_t again = 0;
+    Check(EvtSessionAcquire(&set.sessions, 4243, &again) == other && again && again != claim2,
+          "the same unit reclaims its slot in the new epoch");
+    EvtSessionPublish(&set.sessions, other, claim2);
+    Check(set.sessions.key[other].load() == again, "a stale claim cannot publish over the new one");
+
+    // Batches through a real ring.
+    ShmEvtInit(&g_shmEvtBuf);
+    g_shmEvtBuf.flags.store(1);
+    auto sink = [](uint16_t type, const void* p, uint16_t n) { return ShmEvtWrite(&g_shmEvtBuf, type, p, n); };
+    set.baseMs = 10000;
+    const int b = EvtCompactClaim(&set, 77);
+    Check(b >= 0 && EvtCompactClaim(&set, 77) == b, "a thread keeps its batch");
+    Check(EvtCompactAppend(&set, b, 10005, 3, 32767, 100, 2, sink)
+          && EvtCompactAppend(&set, b, 10009, 4, 16384, 200, 300, sink)
+          && set.staged.load() == 2 && g_shmEvtBuf.write_pos.load() == 0, "events stage without touching the ring");
+    Check(!EvtCompactAppend(&set, -1, 10010, 3, 0, 0, 0, sink) && set.unowned.load() == 1,
+          "a thread without a batch falls back");
+    Check(EvtCompactFlushStale(&set, 10030, EVT_COMPACT_MAX_AGE_MS, sink) == 0
+          && EvtCompactFlushStale(&set, 10005 + EVT_COMPACT_MAX_AGE_MS, EVT_COMPACT_MAX_AGE_MS, sink) == 1
+          && set.staged.load() == 0, "a batch is flushed once it is older than the max age");
+
+    uint8_t rec[EVT_COMPACT_RECORD_MAX];
+    uint16_t type = 0, size = 0;
+    Check(ShmEvtRead(&g_shmEvtBuf, &type, rec, sizeof(rec), &size) && type == EVT_HP_BATCH,
+          "the flush wrote one EVT_HP_BATCH");
+    EvtCompactHP got[4];
+    int seen = 0;
+    const int decoded = EvtCompactDecodeBatch(rec, size, [&](const EvtCompactHP& e) { if (seen < 4) got[seen++] = e; });
+    Check(decoded == 2 && got[0].ms == 5 && got[0].sid == 3 && got[0].old_hp == 32767 && got[0].damage == 100
+          && got[0].damage_type == 2, "first event decodes with its time since the base");
+    Check(got[1].ms == 9 && got[1].sid == 4 && got[1].damage_type == 255, "second event: delta time, clamped type");
+    Check(EvtCompactDecodeBatch(rec, size - 1, [](const EvtCompactHP&) {}) == -1, "a truncated batch is refused");
+
+    // Density: a full burst against plain 24-byte EVT_HP_CHANGE records.
+    ShmEvtInit(&g_shmEvtBuf);
+    g_shmEvtBuf.flags.store(1);
+    for (uint32_t i = 0; i < 1024; i++) EvtCompactAppend(&set, b, 20000 + i / 4, (uint16_t)(i & 255), 30000, 120, 3, sink);
+    EvtCompactFlushStale(&set, ~0ull, 0, sink);
+    const uint32_t used = g_shmEvtBuf.write_pos.load();
+    Check(set.written.load() == 1026 && set.records.load() == 1 + 1024 / EVT_COMPACT_BATCH_EVENTS,
+          "full batches go out as they fill");
+    Check(used * 2 < 1024 * ShmEvtRecordSize(sizeof(EvtHPChange)),
+          "compact batches take well under half the ring space of plain records");
+}
+
+static void TestReplaySim() {
+    StartSuite("Replay SoA combat core (replay_sim.h)");
+
+    // A mixed roster: invulnerable, scaled, placed and unplaced units.
+    auto roster = [](ReplayState& s) {
+        for (int i = 0; i < 200; i++) {
+            const uint64_t obj = 0x10000 + (uint64_t)i * 0x40;
+            ReplayMutMockUnit(s, obj, "unit", i % 3, 100.0f + (float)(i % 7), 120.0f, 2);
+            if (i % 2 == 0) ReplayMutSetUnitPosition(s, obj, (float)(i % 20) * 30.0f, (float)(i / 20) * 30.0f, 0.0f);
+            if (i % 11 == 0) ReplayMutMakeInvulnerable(s, obj, true);
+        }
+        ReplayMutSetDamageMultiplier(s, 1, 2.0f);
+        ReplayMutSetDamageMultiplier(s, 2, 0.0f);
+        ReplayMutSetAreaDamageEnabled(s, true);
+    };
+    ReplayState a, b;
+    roster(a);
+    roster(b);
+
+    // Reference: the per-unit walk the kernels replace.
+    auto reference = [](ReplayState& s, uint64_t primary, float amount) {
+        const float splash = amount * s.area_damage_falloff;
+        const ReplayUnitDetail* p = ReplayFindUnit(static_cast<const ReplayState&>(s), primary);
+        int affected = 0;
+        for (auto& entry : s.units.mut()) {
+            ReplayUnitDetail& u = entry.second;
+            if (entry.first == primary) continue;
+            float hit = splash;
+            if (p && p->has_pos) {
+                const float dx = u.pos_x - p->pos_x, dy = u.pos_y - p->pos_y;
+                if (!u.has_pos || dx * dx + dy * dy > s.area_damage_radius * s.area_damage_radius) continue;
+                hit = splash * (1.0f - (1.0f - s.area_damage_edge) * (sqrtf(dx * dx + dy * dy) / s.area_damage_radius));
+            }
+            const float before = u.hull;
+            if (!ReplayUnitAnyHardpointHasBehavior(u, "INVULNERABLE")) {
+                u.hull = std::max(0.0f, u.hull - std::max(0.0f, hit * ReplayObsGetDamageMultiplier(s, u.owner_slot)));
+                affected++;
+            }
+            ReplayMutLogDamageEvent(s, entry.first, u.owner_slot, before - hit, u.hull);
+        }
+        return affected;
+    };
+    const uint64_t placed = 0x10000 + 42 * 0x40, unplaced = 0x10000 + 43 * 0x40;
+    Check(ReplayMutApplyAreaSplash(a, placed, 40.0f) == reference(b, placed, 40.0f),
+          "placed primary: same victim count as the unit walk");
+    Check(ReplayMutApplyAreaSplash(a, unplaced, 40.0f) == reference(b, unplaced, 40.0f),
+          "unplaced primary: same victim count as the unit walk");
+    Check(ReplayMutApplyAreaSplash(a, 0x9999, 10.0f) == reference(b, 0x9999, 10.0f),
+          "unknown primary splashes everyone");
+    bool same = a.damage_event_log.size() == b.damage_event_log.size();
+    for (size_t k = 0; same && k < a.damage_event_log.size(); k++) {
+        const auto& x = a.damage_event_log[k];
+        const auto& y = b.damage_event_log[k];
+        same = x.obj_addr == y.obj_addr && x.owner_slot == y.owner_slot && x.requested_hp == y.requested_hp
+               && x.current_hp == y.current_hp;
+    }
+    Check(same && !a.damage_event_log.empty(), "event stream matches the unit walk, in order");
+    same = true;
+    for (const auto& entry : a.units) same = same && entry.second.hull == ReplayFindUnit(b, entry.first)->hull;
+    Check(same, "hulls match the unit walk");
+
+    // A sweep on one loaded sim equals the same calls on the state.
+    ReplayState c, d;
+    roster(c);
+    roster(d);
+    ReplaySim sim;
+    ReplaySimLoad(c, &sim);
+    Check(ReplaySimCount(&sim) == 200 && ReplaySimBit(&sim, REPLAY_SIM_INVULN, 0)
+          && !ReplaySimBit(&sim, REPLAY_SIM_INVULN, 1) && ReplaySimBit(&sim, REPLAY_SIM_PLACED, 2)
+          && !ReplaySimBit(&sim, REPLAY_SIM_PLACED, 3) && sim.mult[1] == 2.0f && sim.mult[2] == 0.0f,
+          "load resolves invulnerability, placement and multipliers");
+    const int64_t p = ReplaySimFind(&sim, placed);
+    Check(p == 42 && ReplaySimFind(&sim, 0x9999) == -1, "find by obj_addr");
+    for (int round = 0; round < 5; round++) {
+        ReplaySimDamage(&sim, p, 15.0f);
+        ReplaySimSplash(&sim, p, true, sim.x[(size_t)p], sim.y[(size_t)p], c.area_damage_radius,
+                        c.area_damage_edge, 15.0f * c.area_damage_falloff);
+        ReplayMutApplyDamage(d, placed, 15.0f);
+        ReplayMutApplyAreaSplash(d, placed, 15.0f);
+    }
+    Check(ReplaySimDamage(&sim, p, 0.0f) == ReplayMutApplyDamage(d, placed, 0.0f),
+          "zero damage leaves the hull and still logs");
+    Check(ReplaySimDamage(&sim, -1, 5.0f) == -1.0f, "damage on a missing index returns -1");
+    Check(c.damage_event_log.empty(), "the sim holds its events until stored");
+    ReplaySimStore(&sim, c);
+    same = c.damage_event_log.size() == d.damage_event_log.size();
+    for (size_t k = 0; same && k < c.damage_event_log.size(); k++) {
+        same = c.damage_event_log[k].obj_addr == d.damage_event_log[k].obj_addr
+               && c.damage_event_log[k].current_hp == d.damage_event_log[k].current_hp;
+    }
+    for (const auto& entry : c.units) same = same && entry.second.hull == ReplayFindUnit(d, entry.first)->hull;
+    Check(same && sim.evUnit.empty(), "store writes hulls and events back and drains the sim");
+    Check(ReplaySimSplash(&sim, p, true, 0.0f, 0.0f, -1.0f, 0.0f, 10.0f) == 0 && sim.evUnit.empty(),
+          "a negative radius hits nobody");
+
+    // The invulnerability count follows every behavior mutator.
+    ReplayState e;
+    ReplayMutMockUnit(e, 0xE0, "frigate", 0, 50.0f, 50.0f, 3);
+    ReplayMutAttachBehavior(e, 0xE0, 1, "INVULNERABLE");
+    ReplayMutAttachBehavior(e, 0xE0, 1, "INVULNERABLE");
+    ReplayMutAttachBehavior(e, 0xE0, 2, "SHIELDED");
+    Check(ReplayFindUnit(e, 0xE0)->invuln_hardpoints == 1, "attach counts INVULNERABLE once per hardpoint");
+    Check(ReplayMutApplyDamage(e, 0xE0, 10.0f) == 50.0f, "one INVULNERABLE hardpoint blocks damage");
+    ReplayMutDetachBehavior(e, 0xE0, 2, "INVULNERABLE");
+    ReplayMutDetachBehavior(e, 0xE0, 1, "INVULNERABLE");
+    Check(ReplayFindUnit(e, 0xE0)->invuln_hardpoints == 0 && ReplayMutApplyDamage(e, 0xE0, 10.0f) == 40.0f,
+          "detach clears it");
+    ReplayMutMakeInvulnerable(e, 0xE0, true);
+    Check(ReplayFindUnit(e, 0xE0)->invuln_hardpoints == 3, "Make_Invulnerable covers every hardpoint");
+    ReplayMutMockUnit(e, 0xE0, "frigate", 0, 50.0f, 50.0f, 2);
+    Check(ReplayFindUnit(e, 0xE0)->invuln_hardpoints == 0, "re-mocking with new hardpoints resets it");
+
+    // A unit added after the load keeps its hull; the rest still store.
+    ReplaySimLoad(c, &sim);
+    ReplaySimSplash(&sim, -1, false, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    ReplayMutMockUnit(c, 0x1, "late", 0, 77.0f, 77.0f, 0);
+    ReplaySimStore(&sim, c);
+    Check(ReplayFindUnit(c, 0x1)->hull == 77.0f && ReplayFindUnit(c, 0x10000 + 0x40)->hull == sim.hull[1],
+          "store survives a table that changed since the load");
+}
+
+static void TestReplayTick() {
+    StartSuite("Replay fixed-step tick engine (replay_tick.h)");
+
+    auto fixture = [](ReplayState& s) {
+        s.players.push_back(ReplayPlayer{0, "REBEL", 1000.0, 0, ""});
+        s.players.push_back(ReplayPlayer{1, "EMPIRE", 2000.0, 0, ""});
+        ReplayMutSetIncomeMultiplier(s, 1, 2.0f);
+        ReplayMutMockUnit(s, 0xA0, "hero", 0, 0.0f, 500.0f, 0);
+        ReplayMutSetUnitIsHero(s, 0xA0, true);
+        ReplayMutSetHeroRespawnTimer(s, 0xA0, 1000);
+        ReplayMutAddUnitAbility(s, 0xA0, 0, "Force_Push", 250, false);
+        ReplayMutQueueBuild(s, 0, "X_Wing", 500);
+        ReplayMutQueueBuild(s, 0, "Y_Wing", 500);
+        ReplayMutQueueBuild(s, 1, "TIE_Fighter", 300);
+    };
+    ReplayTickConfig cfg;
+    cfg.dt_ms = 100;
+    cfg.income_per_sec = 10.0;
+
+    // 10 ticks = 1 s: income, one cooldown, three builds, one respawn.
+    ReplayState a;
+    fixture(a);
+    ReplayTickStats st;
+    Check(ReplayTickRun(a, cfg, 10, [](const ReplayState&) {}, nullptr, &st) == 10 && a.sim_tick == 10
+              && a.sim_time_ms == 1000, "ten 100 ms ticks advance the clock one second");
+    Check(a.players[0].credits == 1010.0 && a.players[1].credits == 2020.0,
+          "income per second is scaled to the tick and by the slot multiplier");
+    Check(st.abilities_ready == 1 && st.heroes_revived == 1 && ReplayFindUnit(a, 0xA0)->hull == 500.0f,
+          "the cooldown and the respawn timer run out");
+    Check(st.builds_completed == 3 && a.build_queue.empty() && a.units.size() == 4,
+          "each slot builds its queue in order and spawns the units");
+
+    // Build speed and the unit cap gate the queue.
+    ReplayState b;
+    ReplayMutQueueBuild(b, 0, "X_Wing", 400);
+    ReplayMutSetBuildSpeed(b, 0, 2.0f);
+    ReplayTickRun(b, cfg, 2, [](const ReplayState&) {});
+    Check(b.builds_completed == 1, "a 2x build speed finishes 400 ms in two 100 ms ticks");
+    ReplayMutQueueBuild(b, 0, "X_Wing", 0);
+    ReplayMutSetUnitCapOverride(b, 0, 1);
+    ReplayTickRun(b, cfg, 3, [](const ReplayState&) {});
+    Check(b.builds_completed == 1 && ReplayObsBuildQueueLength(b, 0) == 1, "a reached unit cap holds the order");
+    Check(ReplayMutQueueBuild(b, REPLAY_SLOTS, "X", 1) == 0 && ReplayMutQueueBuild(b, 0, "", 1) == 0
+              && ReplayMutQueueBuild(b, 0, "X", -1) == 0, "bad orders are rejected");
+
+    // Frozen credits win; a paused game moves nothing else; permadeath holds.
+    ReplayState c;
+    fixture(c);
+    ReplayMutSetFreezeCredits(c, 0, true, 5.0);
+    ReplayMutSetPermadeath(c, 0xA0, true);
+    ReplayTickRun(c, cfg, 20, [](const ReplayState&) {});
+    Check(c.players[0].credits == 5.0 && ReplayFindUnit(c, 0xA0)->hull == 0.0f,
+          "frozen credits and permadeath hold through the run");
+    ReplayState d;
+    fixture(d);
+    ReplayMutSetGameSpeed(d, 0.0f);
+    ReplayTickRun(d, cfg, 20, [](const ReplayState&) {});
+    Check(d.players[0].credits == 1000.0 && d.builds_completed == 0 && ReplayObsAbilityCooldown(d, 0xA0, 0) == 250,
+          "game speed 0 pauses income, builds and cooldowns");
+
+    // Observers follow the cadence; a checkpoint replays to the same digest.
+    ReplayState e;
+    fixture(e);
+    cfg.sample_every = 4;
+    cfg.checkpoint_every = 5;
+    std::vector<uint64_t> sampled;
+    std::vector<ReplayTickCheckpoint> cps;
+    ReplayTickRun(e, cfg, 12, [&sampled](const ReplayState& s) { sampled.push_back(s.sim_tick); }, &cps);
+    Check(sampled.size() == 3 && sampled[0] == 4 && sampled[2] == 12, "the observer sees every 4th tick");
+    Check(cps.size() == 2 && cps[0].tick == 5 && cps[1].tick == 10, "a checkpoint every 5th tick");
+    const uint64_t end = ReplayTickDigest(e);
+    Check(ReplayTickRestore(e, cps, 5) == 1 && ReplayTickDigest(e) == cps[0].digest && e.sim_tick == 5,
+          "restore rewinds to the checkpoint");
+    ReplayTickRun(e, cfg, 7, [](const ReplayState&) {});
+    Check(ReplayTickDigest(e) == end, "re-running from the checkpoint is deterministic");
+    Check(ReplayTickRestore(e, cps, 6) == 0, "no checkpoint, no restore");
+    cfg.dt_ms = 0;
+    Check(ReplayTickRun(e, cfg, 5, [](const ReplayState&) {}) == 0 && e.sim_tick == 12, "a zero dt runs nothing");
+}
+
+static void TestReplaySweep() {
+    StartSuite("Replay parameter sweep (replay_sweep.h)");
+
+    std::vector<ReplaySweepAxis> axes;
+    std::string error;
+    Check(ReplaySweepParse("income=0.5,1,2;damage@1=1,2;fire_rate=1,1.5", &axes, &error) && axes.size() == 3
+              && ReplaySweepRuns(axes) == 12 && axes[1].slot == 1 && axes[1].label == "damage@1",
+          "a three-axis grid parses to its product");
+    Check(ReplaySweepValue(axes, 0, 0) == 0.5f && ReplaySweepValue(axes, 4, 0) == 1.0f
+              && ReplaySweepValue(axes, 4, 1) == 2.0f && ReplaySweepValue(axes, 11, 2) == 1.5f,
+          "runs walk the first axis fastest");
+    std::vector<ReplaySweepAxis> bad;
+    Check(!ReplaySweepParse("speed=1", &bad, &error) && !ReplaySweepParse("damage@99=1", &bad, &error)
+              && !ReplaySweepParse("fire_rate=0", &bad, &error) && !ReplaySweepParse("income=1,x", &bad, &error)
+              && !ReplaySweepParse("game_speed@1=1", &bad, &error) && !ReplaySweepParse("", &bad, &error),
+          "unknown axes, bad slots and rejected values fail the parse");
+
+    ReplayState base;
+    base.players.push_back(ReplayPlayer{0, "REBEL", 1000.0, 0, ""});
+    base.players.push_back(ReplayPlayer{1, "EMPIRE", 1000.0, 0, ""});
+    for (int i = 0; i < 20; i++) {
+        ReplayMutMockUnit(base, 0x100 + (uint64_t)i, "unit", i % 2, 50.0f, 50.0f, 0);
+    }
+    ReplayMutQueueBuild(base, 0, "X_Wing", 1000);
+    ReplayTickConfig cfg;
+    cfg.dt_ms = 100;
+    cfg.income_per_sec = 10.0;
+    cfg.attrition_per_sec = 10.0f;
+
+    // A rearmed copy reproduces a fresh copy, run after run.
+    ReplayState work = base;
+    ReplaySweepResult res;
+    bool same = true;
+    for (size_t r = 0; r < ReplaySweepRuns(axes); r++) {
+        ReplaySweepRun(work, base, axes, r, cfg, 40, &res);
+        ReplayState fresh = base;
+        ReplaySweepResult ref;
+        ReplaySweepRun(fresh, base, axes, r, cfg, 40, &ref);
+        same = same && res.digest == ref.digest && res.credits == ref.credits && res.alive == ref.alive;
+    }
+    Check(same, "each run matches a fresh copy of the base");
+    Check(work.objects.size() == base.objects.size() && base.sim_tick == 0 && base.players[0].credits == 1000.0,
+          "the base state is left untouched");
+
+    // The parameters move the results.
+    ReplaySweepRun(work, base, axes, 0, cfg, 40, &res);   // income 0.5, damage@1 1, fire 1
+    Check(res.credits[0] == 1020.0 && res.alive[0] == 11 && res.alive[1] == 10 && res.stats.builds_completed == 1,
+          "income 0.5 over 4 s; 50 hull outlasts 40 hull of attrition");
+    ReplaySweepRun(work, base, axes, 11, cfg, 40, &res);  // income 2, damage@1 2, fire 1.5
+    Check(res.credits[1] == 1080.0 && res.alive[1] == 0 && res.stats.units_lost == 20,
+          "double damage at 1.5x fire rate wipes both sides");
+}
+
+static void TestReplayFork() {
+    StartSuite("Replay fork / restore (ReplayCow tables)");
+
+    ReplayState s;
+    for (int i = 0; i < 50; i++) {
+        ReplayMutMockUnit(s, 0x100 + (uint64_t)i, "unit", i % 2, 100.0f, 100.0f, 2);
+        s.objects.mut()["type_" + std::to_string(i)] = (uint32_t)i;
+    }
+    s.planets.mut()["NABOO"] = ReplayPlanetInfo{"Naboo", 0.25f, 0};
+    ReplayForkTable forks;
+    const uint32_t id = ReplayFork(s, &forks);
+    const ReplayState& f = forks.forks[0].second;
+    Check(id == 1 && f.units.SharedWith(s.units) && f.objects.SharedWith(s.objects),
+          "a fork shares every table with the live state");
+
+    // Mutate, observe: only the written table is copied.
+    ReplayMutApplyDamage(s, 0x100, 40.0f);
+    ReplayMutSpawnUnits(s, "X_Wing", 0, 3);
+    Check(!f.units.SharedWith(s.units) && f.objects.SharedWith(s.objects) && f.planets.SharedWith(s.planets),
+          "a unit write detaches the units table alone");
+    Check(ReplayFindUnit(f, 0x100)->hull == 100.0f && f.units.size() == 50 && f.damage_event_log.empty(),
+          "the fork keeps the pre-write records");
+    Check(ReplayFindUnit(s, 0x999) == nullptr && f.planets.SharedWith(s.planets)
+              && ReplayMutSetPlanetTech(s, "KAMINO", 3) == 0 && f.planets.SharedWith(s.planets),
+          "misses do not detach");
+
+    // Undo, twice. Reads go through a const view: a non-const lookup detaches.
+    const ReplayState& cs = s;
+    Check(ReplayRestore(s, forks, id) == 1 && ReplayFindUnit(cs, 0x100)->hull == 100.0f && s.units.size() == 50
+              && s.damage_event_log.empty() && s.units.SharedWith(f.units),
+          "restore brings the fork back and shares it again");
+    ReplayMutSetPlanetTech(s, "NABOO", 4);
+    ReplayMutApplyDamage(s, 0x101, 10.0f);
+    ReplayRestore(s, forks, id);
+    Check(ReplayFindUnit(cs, 0x101)->hull == 100.0f && s.planets.find("NABOO")->second.tech_level == 0,
+          "a fork can be restored again");
+
+    // A drained log stays in the fork.
+    ReplayMutApplyDamage(s, 0x102, 1.0f);
+    const uint32_t id2 = ReplayFork(s, &forks);
+    ReplayObsEventStreamDrain(s);
+    Check(s.damage_event_log.empty() && forks.forks[1].second.damage_event_log.size() == 1,
+          "draining the live log leaves the fork's");
+
+    Check(ReplayRestore(s, forks, 99) == 0 && ReplayDropFork(&forks, id) == 1 && ReplayRestore(s, forks, id) == 0
+              && ReplayRestore(s, forks, id2) == 1, "unknown and dropped ids are rejected");
+    ReplayDropFork(&forks, 0);
+    uint32_t last = 0;
+    for (int i = 0; i < REPLAY_FORK_MAX; i++) last = ReplayFork(s, &forks);
+    Check(last != 0 && ReplayFork(s, &forks) == 0 && ReplayDropFork(&forks, 0) == REPLAY_FORK_MAX,
+          "at most REPLAY_FORK_MAX forks; id 0 drops them all");
+}
+
+static void TestReplayEventLog() {
+    StartSuite("Replay damage-event log: bounded ring, paged and binary drains");
+
+    ReplayState s;
+    Check(ReplayMutSetEventLogCapacity(s, 1) == DAMAGE_RING_CAP_DEFAULT
+              && s.damage_event_log.get().capacity == DAMAGE_RING_CAP_MIN,
+          "capacity rounds like DamageRingSetCapacity and reports the previous value");
+    for (int i = 0; i < 300; i++) ReplayMutLogDamageEvent(s, 0x100, 1, 0.0f, (float)i, (uint64_t)i);
+    Check(ReplayObsEventLogCount(s) == DAMAGE_RING_CAP_MIN && ReplayObsEventLogDropped(s) == 300 - DAMAGE_RING_CAP_MIN
+              && s.damage_event_log[0].timestamp_ms == 0
+              && s.damage_event_log[DAMAGE_RING_CAP_MIN - 1].timestamp_ms == DAMAGE_RING_CAP_MIN - 1,
+          "a full log keeps the oldest events and refuses (counts) new ones");
+
+    std::string csv = ReplayObsEventStreamDrain(s, 100);
+    Check(csv.rfind("count=100|0;256;1;", 0) == 0 && ReplayObsEventLogCount(s) == DAMAGE_RING_CAP_MIN - 100,
+          "a paged drain returns the oldest rows and leaves the rest queued");
+    for (int i = 0; i < 100; i++) ReplayMutLogDamageEvent(s, 0x100, 1, 0.0f, 0.0f, 1000 + (uint64_t)i);
+    Check(ReplayObsEventLogCount(s) == DAMAGE_RING_CAP_MIN && s.damage_event_log.get().buf.size() == DAMAGE_RING_CAP_MIN
+              && s.damage_event_log[0].timestamp_ms == 100
+              && s.damage_event_log[DAMAGE_RING_CAP_MIN - 1].timestamp_ms == 1099,
+          "drained room is reused by wrapping; storage stays at the capacity");
+
+    ReplayMutSetEventLogCapacity(s, 1024);
+    ReplayMutLogDamageEvent(s, 0x100, 1, 0.0f, 0.0f, 5000);
+    Check(s.damage_event_log.get().mask + 1 == DAMAGE_RING_CAP_MIN && ReplayObsEventLogDropped(s) == 45,
+          "a new capacity waits until the log is empty");
+
+    std::vector<uint8_t> page;
+    Check(ReplayObsEventStreamDrainBinary(s, &page, 200) == 200
+              && page.size() == sizeof(ReplayEventDrainHeader) + 200 * sizeof(DamageEvent),
+          "a binary page is one header and count DamageEvent records");
+    ReplayEventDrainHeader hdr;
+    DamageEvent first;
+    memcpy(&hdr, page.data(), sizeof(hdr));
+    memcpy(&first, page.data() + sizeof(hdr), sizeof(first));
+    Check(hdr.count == 200 && hdr.remaining == DAMAGE_RING_CAP_MIN - 200 && hdr.dropped == 45
+              && first.timestamp_ms == 100 && first.obj_addr == 0x100 && first.owner_slot == 1,
+          "the header carries what is left and what was dropped; records keep the live layout");
+    while (!s.damage_event_log.empty()) ReplayObsEventStreamDrainBinary(s, &page);
+    Check(ReplayObsEventStreamDrain(s) == "count=0", "drained to empty");
+    ReplayMutLogDamageEvent(s, 0x100, 1, 0.0f, 0.0f, 6000);
+    Check(s.damage_event_log.get().mask + 1 == 1024 && s.damage_event_log[0].timestamp_ms == 6000,
+          "the next push on an empty log adopts the new capacity");
+
+    // The default page matches the live drain's kDrainMaxRows.
+    ReplayState d;
+    ReplayMutMockUnit(d, 0x200, "unit", 0, 1e6f, 1e6f, 1);
+    for (int i = 0; i < REPLAY_EVENT_DRAIN_ROWS + 50; i++) ReplayMutApplyDamage(d, 0x200, 1.0f);
+    csv = ReplayObsEventStreamDrain(d);
+    Check(csv.rfind("count=400|", 0) == 0 && ReplayObsEventLogCount(d) == 50
+              && ReplayObsEventStreamDrain(d).rfind("count=50|", 0) == 0,
+          "the default drain pages REPLAY_EVENT_DRAIN_ROWS rows");
+}
+
+static void TestReplayDiff() {
+    StartSuite("Replay snapshot diff: keyed matching, JSON lines per field");
+
+    ReplayState a;
+    a.players.push_back({0, "REBEL", 1000.0, 1, "Mon"});
+    a.players.push_back({1, "EMPIRE", 2000.0, 2, "Tarkin"});
+    ReplayMutMockUnit(a, 0x100, "X_WING", 0, 80.0f, 100.0f, 1);
+    ReplayMutMockUnit(a, 0x200, "TIE_FIGHTER", 1, 40.0f, 40.0f, 0);
+    ReplayPlanetInfo p; p.name = "HOTH"; p.owner_slot = 0;
+    a.planets.mut()["HOTH"] = p;
+    ReplayState b = a;
+
+    std::string out;
+    Check(ReplayDiffSection(REPLAY_DIFF_PLAYERS, a, true, b, true, &out) == 0
+          && ReplayDiffSection(REPLAY_DIFF_UNITS, a, true, b, true, &out) == 0
+          && ReplayDiffHeader(a, b, &out) == 0 && out.empty(),
+          "identical states diff to nothing");
+
+    std::swap(b.players[0], b.players[1]);  // players match by slot, not position
+    b.players[1].credits = 1500.0;
+    ReplayFindUnit(b, 0x100)->hull = 60.0f;
+    ReplayMutAttachBehavior(b, 0x100, 0, "INVULNERABLE");
+    ReplayMutMockUnit(b, 0x300, "A_WING", 0, 50.0f, 50.0f, 0);
+    b.planets.mut().erase("HOTH");
+
+    Check(ReplayDiffSection(REPLAY_DIFF_PLAYERS, a, true, b, true, &out) == 1
+          && out == "{\"section\":\"players\",\"key\":\"0\",\"field\":\"credits\",\"a\":1000,\"b\":1500}\n",
+          "a changed player field is one line keyed by slot");
+    out.clear();
+    Check(ReplayDiffSection(REPLAY_DIFF_UNITS, a, true, b, true, &out) == 3
+          && out.find("{\"section\":\"units\",\"key\":\"0x100\",\"field\":\"hull\",\"a\":80,\"b\":60}\n") != std::string::npos
+          && out.find("\"key\":\"0x100/hp0\",\"field\":\"behaviors\",\"a\":[],\"b\":[\"INVULNERABLE\"]")
+                 != std::string::npos
+          && out.find("{\"section\":\"units\",\"key\":\"0x300\",\"change\":\"added\"}\n") != std::string::npos,
+          "units match by obj_addr; hardpoints are keyed under their unit");
+    out.clear();
+    Check(ReplayDiffSection(REPLAY_DIFF_PLANETS, a, true, b, true, &out) == 1
+          && out == "{\"section\":\"planets\",\"key\":\"HOTH\",\"change\":\"removed\"}\n",
+          "a planet only the first file has is removed");
+    out.clear();
+    Check(ReplayDiffSection(REPLAY_DIFF_PLANETS, a, true, ReplayState(), false, &out) == 2
+          && out.rfind("{\"section\":\"planets\",\"change\":\"removed\"}\n", 0) == 0,
+          "a group one file lacks is reported once, then per record");
+
+    std::string s;
+    ReplayJsonString(&s, "a\"b\\\n");
+    Check(s == "\"a\\\"b\\\\\\n\"" && ReplayDiffReal(0.1f, 9) == "0.100000001", "strings escape; floats round-trip");
+}
+
+static void TestSnapshotReader() {
+    StartSuite("Snapshot reader: in-memory decode, CRC and bounds checks");
+
+    // Header + section 1 (one player) + end marker, as SNAPSHOT_FORMAT.md lays it out.
+    std::vector<uint8_t> snap(68, 0);
+    memcpy(snap.data(), "SWFOCSNAPv2", 11);
+    snap[16] = 2;
+    auto put = [&snap](const void* p, size_t n) {
+        snap.insert(snap.end(), static_cast<const uint8_t*>(p), static_cast<const uint8_t*>(p) + n);
+    };
+    auto u32 = [&put](uint32_t v) { put(&v, 4); };
+    char faction[64] = "REBEL", name[64] = "";
+    const double credits = 1234.5;
+    const int32_t tech = 3;
+    u32(1); u32(4 + 4 + 4 + 64 + 8 + 4 + 64);
+    u32(1); u32(0); u32(0); put(faction, 64); put(&credits, 8); put(&tech, 4); put(name, 64);
+    u32(SNAP_END_SECTION_ID); u32(4);
+    u32(Crc32_Compute(snap.data(), snap.size()));
+
+    ReplayState s;
+    std::vector<SnapSectionRef> refs;
+    SnapshotLoadResult r;
+    Check(SnapDecodeStream(snap.data(), snap.size(), s, REPLAY_ALL_SECTIONS, &refs, &r)
+              && r.sections_loaded == 1 && s.format_version == 2 && s.players.size() == 1
+              && s.players[0].faction_name == "REBEL" && s.players[0].credits == 1234.5 && s.local_slot == 0,
+          "a v2 stream decodes from memory");
+
+    std::vector<SnapIndexEntry> skipped;
+    ReplayState h;
+    SnapshotLoadResult rh;
+    Check(SnapDecodeStream(snap.data(), snap.size(), h, 0, &refs, &rh, &skipped) && h.players.empty()
+              && skipped.size() == 1 && skipped[0].id == 1 && skipped[0].off == 68,
+          "unselected sections are listed, not decoded");
+
+    std::vector<uint8_t> bad = snap;
+    bad[80] ^= 1;
+    SnapshotLoadResult rb;
+    Check(!SnapDecodeStream(bad.data(), bad.size(), h, REPLAY_ALL_SECTIONS, &refs, &rb)
+              && rb.error.find("CRC32 mismatch") == 0,
+          "a flipped byte fails the CRC before any section decodes");
+
+    bool bounded = true;
+    for (size_t n = 0; n < snap.size(); n++) {
+        SnapshotLoadResult rt;
+        bounded = bounded && !SnapDecodeStream(snap.data(), n, h, REPLAY_ALL_SECTIONS, &refs, &rt) && !rt.error.empty();
+    }
+    Check(bounded, "every truncation is rejected with an error");
+
+    // A player_count the payload cannot hold: the CRC is right, the section is not.
+    bad = snap;
+    const uint32_t huge = 4000;
+    memcpy(bad.data() + 76, &huge, 4);
+    const uint32_t crc = Crc32_Compute(bad.data(), bad.size() - 4);
+    memcpy(bad.data() + bad.size() - 4, &crc, 4);
+    Check(!SnapDecodeStream(bad.data(), bad.size(), h, REPLAY_ALL_SECTIONS, &refs, &rb)
+              && rb.error == "player slot truncated",
+          "a count past the payload fails on the first missing record");
+
+    const ReplayPlayer* storage = s.players.data();
+    ReplayClearSnapshot(s);
+    Check(s.players.empty() && s.format_version == 0 && s.local_slot == -1, "ReplayClearSnapshot empties the load");
+    SnapshotLoadResult r2;
+    Check(SnapDecodeStream(snap.data(), snap.size(), s, REPLAY_ALL_SECTIONS, &refs, &r2) && s.players.size() == 1
+              && s.players.data() == storage,
+          "a reload into a cleared state reuses its storage");
+}
+
+static void TestHelperIndex() {
+    StartSuite("Helper index: SWFOC table name lookup");
+
+    struct Entry { const char* name; int id; };
+    static const Entry entries[] = {
+        {"SWFOC_GetVersion",  0},
+        {"SWFOC_SetCredits",  1},
+        {"SWFOC_GetCredits",  2},
+        {"SWFOC_DiagPipeStats", 3},
+        {"SWFOC_Log",         4},
+    };
+    const size_t n = sizeof(entries) / sizeof(entries[0]);
+    HelperIndex index;
+    HelperIndexBuild(&index, entries, n);
+
+    bool sorted = index.order.size() == n;
+    for (size_t i = 1; sorted && i < n; i++)
+        sorted = strcmp(HelperShortName(entries[index.order[i - 1]].name),
+                        HelperShortName(entries[index.order[i]].name)) < 0;
+    Check(sorted, "index orders every entry by short name");
+
+    bool all = true;
+    for (size_t i = 0; i < n; i++) {
+        all = all && HelperIndexFind(index, entries, entries[i].name) == (int)i
+                  && HelperIndexFind(index, entries, HelperShortName(entries[i].name)) == (int)i;
+    }
+    Check(all, "every helper resolves by full and by short name");
+    Check(strcmp(HelperShortName("SWFOC_Log"), "Log") == 0 && strcmp(HelperShortName("Log"), "Log") == 0,
+          "short name drops the SWFOC_ prefix only when present");
+    Check(HelperIndexFind(index, entries, "GetCreditz") == -1 && HelperIndexFind(index, entries, "") == -1
+              && HelperIndexFind(index, entries, "SWFOC_") == -1 && HelperIndexFind(index, entries, nullptr) == -1,
+          "unknown, empty and null names miss");
+    Check(HelperIndexFind(index, entries, "getcredits") == -1, "lookup is case-sensitive, as Lua globals are");
+
+    HelperIndex empty;
+    HelperIndexBuild(&empty, entries, 0);
+    Check(HelperIndexFind(empty, entries, "Log") == -1, "an empty index finds nothing");
+}
+
+static void TestInstanceNames() {
+    StartSuite("Instance-scoped pipe and mapping names (instance_names.h)");
+
+    char tag[INSTANCE_TAG_MAX];
+    Check(InstanceTagResolve(nullptr, 7, tag, sizeof(tag)) && tag[0] == '\0'
+              && InstanceTagResolve("", 7, tag, sizeof(tag)) && tag[0] == '\0',
+          "No instance value means no tag");
+    Check(InstanceTagResolve("pid", 4711, tag, sizeof(tag)) && strcmp(tag, "4711") == 0,
+          "\"pid\" resolves to the process id");
+    Check(InstanceTagResolve("ci-7_a", 1, tag, sizeof(tag)) && strcmp(tag, "ci-7_a") == 0,
+          "A [A-Za-z0-9_-] value is its own tag");
+    const std::string longest(INSTANCE_TAG_MAX - 1, 'x'), tooLong(INSTANCE_TAG_MAX, 'x');
+    Check(InstanceTagResolve(longest.c_str(), 1, tag, sizeof(tag))
+              && !InstanceTagResolve(tooLong.c_str(), 1, tag, sizeof(tag)) && tag[0] == '\0',
+          "Tags stop at INSTANCE_TAG_MAX - 1 characters");
+    Check(!InstanceTagResolve("a b", 1, tag, sizeof(tag)) && !InstanceTagResolve("..\\x", 1, tag, sizeof(tag))
+              && !InstanceTagResolve("a:b", 1, tag, sizeof(tag)),
+          "Spaces, path and pipe-name separators are refused");
+
+    char name[INSTANCE_NAME_MAX];
+    Check(InstanceName(SHMEM_CMD_NAME, "", name, sizeof(name)) && strcmp(name, SHMEM_CMD_NAME) == 0,
+          "Untagged names are the legacy names");
+    Check(InstanceName("\\\\.\\pipe\\swfoc_bridge_replay", "4711", name, sizeof(name))
+              && strcmp(name, "\\\\.\\pipe\\swfoc_bridge_replay_4711") == 0,
+          "Tagged names append _<tag>");
+    Check(!InstanceName("0123456789", "ab", name, 12) && name[0] == '\0', "A name that does not fit is refused");
+    char a[64], b[64];
+    Check(InstanceEventName(SHMEM_RING_EVENT_PREFIX, nullptr, 3, a, sizeof(a))
+              && strcmp(a, SHMEM_RING_EVENT_PREFIX "3") == 0,
+          "Untagged ring events keep <prefix><i>");
+    Check(InstanceEventName("E", "a1", 2, a, sizeof(a)) && InstanceEventName("E", "a", 12, b, sizeof(b))
+              && strcmp(a, b) != 0 && strcmp(a, "E_a1_2") == 0,
+          "Tagged ring events cannot collide across tag / slot splits");
+
+    InstanceRecord r;
+    r.kind = "replay";
+    r.pid = 4711;
+    r.tag = "ci7";
+    r.pipe = "\\\\.\\pipe\\swfoc_bridge_replay_ci7";
+    r.started = 1760400000;
+    r.source = "C:\\snaps\\a\nb.swfocsnap";
+    const std::string text = FormatInstanceRecord(r);
+    InstanceRecord back;
+    Check(ParseInstanceRecord(text.data(), text.size(), &back) && back.kind == r.kind && back.pid == r.pid
+              && back.tag == r.tag && back.pipe == r.pipe && back.started == r.started
+              && back.source == "C:\\snaps\\a b.swfocsnap",
+          "A record round-trips; a newline in a value becomes a space");
+    const std::string crlf = "swfoc-instance 1\r\nkind=bridge\r\npid=9\r\nfuture=1\r\npipe=p\r\n";
+    Check(ParseInstanceRecord(crlf.data(), crlf.size(), &back) && back.kind == "bridge" && back.pid == 9
+              && back.pipe == "p" && back.tag.empty(),
+          "CRLF lines and unknown keys are accepted");
+    const std::string noMagic = "kind=bridge\npid=9\npipe=p\n", noPid = "swfoc-instance 1\nkind=bridge\npipe=p\n";
+    Check(!ParseInstanceRecord(noMagic.data(), noMagic.size(), &back)
+              && !ParseInstanceRecord(noPid.data(), noPid.size(), &back)
+              && !ParseInstanceRecord(text.data(), 10, &back),
+          "Records without the magic, a pid, or cut short are refused");
+
+    char file[64];
+    Check(InstanceRecordFileName("replay", 4711, file, sizeof(file)) && strcmp(file, "replay_4711.inst") == 0
+              && !InstanceRecordFileName("a/b", 1, file, sizeof(file)),
+          "One record file per kind and PID");
+    Check(InstanceRecordJson(r).find("\"pipe\":\"\\\\\\\\.\\\\pipe\\\\swfoc_bridge_replay_ci7\"") != std::string::npos,
+          "JSON lines escape the backslashes of the pipe name");
+}
+
+static void TestCsvRow() {
+    StartSuite("CSV row builder (csv_row.h)");
+
+    // CsvRowFixed must reproduce the CRT's %.3f / %.1f / %.0f byte for byte.
+    char got[CSV_FIXED_SCRATCH], want[CSV_FIXED_SCRATCH];
+    int mismatches = 0;
+    uint32_t bits = 0x12345678u;
+    for (int i = 0; i < 200000; i++) {
+        bits = bits * 1664525u + 1013904223u;  // every float bit pattern class, NaN and inf included
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        const int d = i & 3;
+        CsvFormatFixed(got, f, d);
+        snprintf(want, sizeof(want), "%.*f", d, f);
+        if (strcmp(got, want) != 0) mismatches++;
+    }
+    Check(mismatches == 0, "Fixed formatting of 200k float bit patterns matches snprintf");
+    const double edges[] = {0.0005, 0.0015, 0.0025, 2.5, 3.5, 0.125, -0.0005, -0.0, 1e-300,
+                            999.9995, 4503599627370495.5, 9223372036854775808.0, 1e300, 12345.678};
+    mismatches = 0;
+    for (double v : edges) {
+        for (int d = 0; d <= 3; d++) {
+            CsvFormatFixed(got, v, d);
+            snprintf(want, sizeof(want), "%.*f", d, v);
+            if (strcmp(got, want) != 0) mismatches++;
+        }
+    }
+    Check(mismatches == 0, "Ties round to even, -0 keeps its sign, huge doubles match snprintf");
+
+    char buf[256], ref[256];
+    CsvRow row;
+    CsvRowInit(&row, buf, sizeof(buf));
+    CsvRowCount(&row, 2);
+    CsvRowUnit(&row, 0xFFFFFFFFFFFFFFFFull, -1, 1234.5678f, 255, 1, 0, 1);
+    CsvRowDamageEvent(&row, 42, 0x1234, 3, -0.0005f, 100.0f);
+    snprintf(ref, sizeof(ref), "count=%d|%llu;%d;%.3f;%u;%u;%d;%d|%llu;%llu;%d;%.3f;%.3f", 2,
+             0xFFFFFFFFFFFFFFFFull, -1, 1234.5678f, 255u, 1u, 0, 1, 42ull, 0x1234ull, 3, -0.0005f, 100.0f);
+    Check(strcmp(buf, ref) == 0 && row.len == strlen(ref), "Unit and event rows match their printf formats");
+    CsvRowInit(&row, buf, sizeof(buf));
+    CsvRowPlayer(&row, 1, "REBEL", 1e6, -2, 1, 0, 7);
+    CsvRowHex16(&row, 0xABCull);
+    snprintf(ref, sizeof(ref), "|%d;%s;%.3f;%d;%d;%d;%d%016llX", 1, "REBEL", 1e6, -2, 1, 0, 7, 0xABCull);
+    Check(strcmp(buf, ref) == 0, "Player rows and %016llX match their printf formats");
+
+    char small[12], smallRef[12];
+    CsvRowInit(&row, small, sizeof(small));
+    CsvRowCount(&row, 7);
+    CsvRowFixed(&row, 123456.0f, 3);
+    CsvRowStr(&row, "|more");
+    size_t off = SafeAppendFmt(smallRef, 0, sizeof(smallRef), "count=%d", 7);
+    off = SafeAppendFmt(smallRef, off, sizeof(smallRef), "%.3f", 123456.0f);
+    SafeAppendFmt(smallRef, off, sizeof(smallRef), "|more");
+    Check(strcmp(small, smallRef) == 0 && row.len == sizeof(small) - 1,
+          "A full buffer clamps exactly like SafeAppendFmt and stays terminated");
+
+    int passes = 0;
+    const std::string big = CsvRowBuildString(8, [&](CsvRow* r) {
+        passes++;
+        for (int i = 0; i < 100; i++) CsvRowU64(r, 1234567890ull);
+    });
+    Check(big.size() == 1000 && passes == 5,  // 64, 128, 256, 512, 1024 bytes
+          "CsvRowBuildString grows past a short estimate");
+    Check(CsvRowCapacity(32, 400, CSV_EVENT_ROW_MAX) <= 65536,
+          "400 widest drain rows fit one 64 KB pipe reply");
+}
+
+static void TestPlayerTable() {
+    StartSuite("Per-tick player table (player_table.h)");
+
+    static const char kRebel[] = "REBEL";
+    PlayerTable t;
+    PlayerTableReset(&t, 12);
+    Check(t.count == PLAYER_TABLE_SLOTS && t.localSlot == -1 && t.humanSlot == -1 && !t.unitsValid,
+          "Reset clamps the count to the engine's slots and clears both slots");
+    PlayerTableReset(&t, -3);
+    Check(t.count == 0 && PlayerTableRow(&t, 0) == nullptr, "A negative count is an empty table");
+
+    PlayerTableReset(&t, 4);
+    t.rows[0].player = 0x1000; t.rows[0].faction = kRebel; t.rows[0].credits = 500.0f;
+    t.rows[1].player = 0;      t.rows[1].isHuman = 1;  // an empty slot never counts as local
+    t.rows[2].player = 0x3000; t.rows[2].isHuman = 1;  t.rows[2].tech = 3;
+    t.rows[3].player = 0x4000; t.rows[3].isHuman = 1;
+    PlayerTableFinish(&t);
+    Check(t.localSlot == 2 && t.rows[2].isLocal && !t.rows[3].isLocal && !t.rows[0].isLocal,
+          "The local slot is the first non-empty slot flagged human, as in the old scan");
+    Check(PlayerTablePlayer(&t, 0) == 0x1000 && PlayerTablePlayer(&t, 1) == 0
+              && PlayerTablePlayer(&t, 4) == 0 && PlayerTablePlayer(&t, -1) == 0,
+          "Empty, past-count and negative slots have no player");
+    Check(strcmp(PlayerTableFaction(&t, 0), "REBEL") == 0 && strcmp(PlayerTableFaction(&t, 2), "?") == 0
+              && strcmp(PlayerTableFaction(&t, 7), "?") == 0,
+          "Faction names fall back to \"?\" like GetFactionName");
+
+    t.rows[2].isHuman = 0;
+    t.rows[3].isHuman = 0;
+    PlayerTableFinish(&t);
+    Check(t.localSlot == -1 && !t.rows[2].isLocal, "No human slot means no local slot");
+}
+
+static void TestSpawnBatch() {
+    StartSuite("Batched spawns under a frame budget (spawn_batch.h)");
+
+    static SpawnBatch b;
+    int bad = 0;
+    Check(SpawnBatchParse(&b, "Rebel_Trooper_Squad;3;1;10;-2.5;0|T4B_Tank;2;0;0;0;0", &bad) == SPAWN_PARSE_OK
+              && b.entries == 2 && b.total == 5 && bad == -1,
+          "Two entries parse; the total counts every unit");
+    Check(strcmp(b.entry[0].type, "Rebel_Trooper_Squad") == 0 && b.entry[0].owner == 1
+              && b.entry[0].x == 10.0f && b.entry[0].y == -2.5f && b.entry[1].count == 2,
+          "Fields land in type, count, owner, x, y, z order");
+    Check(SpawnBatchParse(&b, "", &bad) == SPAWN_PARSE_EMPTY && bad == -1, "An empty spec has no entries");
+    Check(SpawnBatchParse(&b, "A;1;0;0;0;0|B;1;0;0;0", &bad) == SPAWN_PARSE_FIELDS && bad == 1,
+          "A short entry is reported by index");
+    Check(SpawnBatchParse(&b, "A(x);1;0;0;0;0", &bad) == SPAWN_PARSE_TYPE
+              && SpawnBatchParse(&b, ";1;0;0;0;0", &bad) == SPAWN_PARSE_TYPE,
+          "Type names are non-empty identifiers, so nothing can escape the helper call");
+    Check(SpawnBatchParse(&b, "A;0;0;0;0;0", &bad) == SPAWN_PARSE_COUNT
+              && SpawnBatchParse(&b, "A;2x;0;0;0;0", &bad) == SPAWN_PARSE_COUNT,
+          "Counts are whole numbers >= 1");
+    Check(SpawnBatchParse(&b, "A;1;8;0;0;0", &bad) == SPAWN_PARSE_OWNER
+              && SpawnBatchParse(&b, "A;1;-1;0;0;0", &bad) == SPAWN_PARSE_OWNER,
+          "Owners are player slots");
+    Check(SpawnBatchParse(&b, "A;1;0;nan;0;0", &bad) == SPAWN_PARSE_POSITION
+              && SpawnBatchParse(&b, "A;1;0;0;;0", &bad) == SPAWN_PARSE_POSITION,
+          "Positions are finite numbers");
+    std::string many;
+    for (int i = 0; i <= SPAWN_BATCH_ENTRIES; i++) many += i ? "|A;1;0;0;0;0" : "A;1;0;0;0;0";
+    Check(SpawnBatchParse(&b, many.c_str(), &bad) == SPAWN_PARSE_TOO_MANY && bad == SPAWN_BATCH_ENTRIES,
+          "At most SPAWN_BATCH_ENTRIES entries");
+    Check(SpawnBatchParse(&b, "A;500;0;0;0;0|B;13;0;0;0;0", &bad) == SPAWN_PARSE_TOO_MANY && bad == 1,
+          "At most SPAWN_BATCH_UNITS_MAX units");
+
+    static SpawnQueue q;
+    memset(&q, 0, sizeof(q));
+    Check(SpawnQueueBudget(&q) == SPAWN_BUDGET_DEFAULT && !SpawnQueueDue(&q, 0), "A zeroed queue is idle");
+    SpawnBatchParse(&b, "A;5;1;0;0;0|B;3;2;0;0;0", &bad);
+    const uint32_t first = SpawnQueuePush(&q, &b);
+    SpawnBatchParse(&b, "C;2;1;0;0;0", &bad);
+    const uint32_t second = SpawnQueuePush(&q, &b);
+    Check(first == 1 && second == 2 && q.pending == 10, "Batches get increasing ids");
+
+    std::string order;
+    int calls = 0;
+    auto spawnAll = [&](const SpawnBatchEntry* e, int n) {
+        calls++;
+        for (int i = 0; i < n; i++) order += e->type;
+        return n;
+    };
+    Check(SpawnQueueDue(&q, 100) && SpawnQueueStep(&q, 100, spawnAll) == 4 && order == "AAAA",
+          "One frame spawns the budget");
+    Check(!SpawnQueueDue(&q, 100 + SPAWN_FRAME_MS - 1) && SpawnQueueDue(&q, 100 + SPAWN_FRAME_MS),
+          "The next frame is SPAWN_FRAME_MS later, so re-entrant ticks do not spawn again");
+    SpawnQueueStep(&q, 200, spawnAll);
+    Check(order == "AAAAABBB" && calls == 3, "An entry boundary splits the frame across two calls");
+    Check(SpawnQueueFind(&q, first)->spawned == 8 && SpawnBatchPending(SpawnQueueFind(&q, first)) == 0,
+          "The first batch is done before the second starts");
+    SpawnQueueStep(&q, 300, spawnAll);
+    Check(order == "AAAAABBBCC" && q.pending == 0 && !SpawnQueueDue(&q, 1000), "The queue drains in order");
+
+    SpawnQueueSetBudget(&q, 0);
+    Check(q.budget == 1, "The budget is at least one unit");
+    SpawnQueueSetBudget(&q, 1000);
+    Check(q.budget == SPAWN_BUDGET_MAX, "The budget is at most SPAWN_BUDGET_MAX");
+
+    SpawnBatchParse(&b, "Bad;6;3;0;0;0|D;2;1;0;0;0", &bad);
+    const uint32_t third = SpawnQueuePush(&q, &b);
+    SpawnQueueSetBudget(&q, 4);
+    calls = 0;
+    auto partial = [&](const SpawnBatchEntry* e, int n) {
+        calls++;
+        if (strcmp(e->type, "Bad") == 0) return 0;
+        return n > 1 ? n - 1 : n;
+    };
+    const SpawnBatch* t = SpawnQueueFind(&q, third);
+    Check(SpawnQueueStep(&q, 400, partial) == 4 && calls == 1 && t->failed == 6 && q.pending == 2,
+          "A call that spawns nothing fails the rest of its entry; only the attempt uses the budget");
+    SpawnQueueStep(&q, 500, partial);
+    Check(t->spawned == 1 && t->failed == 7 && q.pending == 0, "Units a call did not spawn count as failed");
+
+    for (int i = 0; i < SPAWN_BATCH_SLOTS; i++) {
+        SpawnBatchParse(&b, "E;1;0;0;0;0", &bad);
+        SpawnQueuePush(&q, &b);
+    }
+    SpawnBatchParse(&b, "F;1;0;0;0;0", &bad);
+    Check(SpawnQueuePush(&q, &b) == 0, "A slot still spawning is not reused");
+    Check(SpawnQueueFind(&q, third) == nullptr && SpawnQueueFind(&q, 0) == nullptr,
+          "A reused slot forgets the old batch");
+}
+
+static void TestHardpointLayout() {
+    StartSuite("Per-type hardpoint layouts (hardpoint_layout.h)");
+
+    static HardpointLayoutCache c;
+    memset(&c, 0, sizeof(c));
+    Check(!HardpointLayoutBind(&c, 0x7000, 1) && HardpointLayoutFor(&c, 0) == nullptr,
+          "First bind drops nothing; type 0 has no layout");
+    HardpointLayout* star = HardpointLayoutFor(&c, 0x12340);
+    Check(star && star->hardpoints == -1 && HardpointLayoutFor(&c, 0x12340) == star && c.count == 1,
+          "A type gets one entry");
+    Check(!HardpointLayoutKnown(&c, star) && c.misses == 1, "A new type is unknown until it has been learned");
+
+    HardpointLayoutLearn(star, 0x0Bu);  // slots 0, 1, 3
+    HardpointLayoutLearn(star, 0x03u);  // this one lost slot 3
+    HardpointLayoutLearn(star, 0x13u);
+    Check(!HardpointLayoutKnown(&c, star), "Still learning after three units");
+    HardpointLayoutLearn(star, 0x01u);
+    Check(HardpointLayoutKnown(&c, star) && c.hits == 1 && star->childMask == 0x1Bu && star->span == 5,
+          "The layout is the union of the first units' slots");
+    HardpointLayoutLearn(star, 0x80000000u);
+    Check(star->childMask == 0x1Bu && star->span == 5, "A fixed layout does not change");
+
+    HardpointLayout* bare = HardpointLayoutFor(&c, 0x56780);
+    for (int i = 0; i < HARDPOINT_LAYOUT_LEARN; i++) HardpointLayoutLearn(bare, 0);
+    Check(HardpointLayoutKnown(&c, bare) && bare->span == 0, "A type with no children learns an empty layout");
+    HardpointLayoutLearn(HardpointLayoutFor(&c, 0x80000000u), 0x80000000u);
+    Check(HardpointLayoutFor(&c, 0x80000000u)->span == HARDPOINT_LAYOUT_CHILDREN, "Slot 31 spans all 32");
+
+    HardpointLayoutNoteCount(star, 12);
+    HardpointLayoutNoteCount(star, 9);
+    Check(star->hardpoints == 12, "The hardpoint count keeps the largest seen");
+
+    c.behavior = 0xBEEF;
+    Check(!HardpointLayoutBind(&c, 0x7000, 1) && c.count == 3 && c.behavior == 0xBEEF,
+          "Same mode and generation keep everything");
+    Check(HardpointLayoutBind(&c, 0x7000, 2) && c.count == 0 && c.behavior == 0 && c.resets == 1
+              && HardpointLayoutFor(&c, 0x12340)->samples == 0,
+          "A new generation drops layouts and the behavior");
+    HardpointLayoutFor(&c, 0x12340);
+    Check(HardpointLayoutBind(&c, 0x9000, 2) && c.count == 0, "A new game mode drops them too");
+
+    for (int i = 0; i < HARDPOINT_LAYOUT_MAX; i++) HardpointLayoutFor(&c, 0x100000 + (uint64_t)i * 0x40);
+    Check(c.count == HARDPOINT_LAYOUT_MAX && HardpointLayoutFor(&c, 0x99999990) == nullptr
+              && HardpointLayoutFor(&c, 0x100000) != nullptr,
+          "A full table stores no new types but still answers old ones");
+}
+
+static void TestModCatalog() {
+    StartSuite("Cached mod discovery (mod_catalog.h)");
+
+    static ModCatalog c;
+    std::string list, current, name;
+    Check(!ModCatalogRead(&c, &list, &current, &name), "Nothing to read before the first scan");
+
+    std::vector<ModEntry> mods;
+    ModCatalogPublish(&c, mods, false);
+    Check(ModCatalogRead(&c, &list, &current, &name) && list == "(no_mods)" && current == "vanilla"
+          && name == "vanilla" && c.scans == 1,
+          "No mods: (no_mods) and vanilla");
+
+    mods.push_back({"AOTR", "C:\\Game\\Mods\\AOTR", 50});
+    mods.push_back({"ThrawnsRevenge", "C:\\Game\\Mods\\ThrawnsRevenge", 90});
+    mods.push_back({"Republic", "C:\\Game\\Mods\\Republic", 90});
+    ModCatalogPublish(&c, mods, false);
+    ModCatalogRead(&c, &list, &current, &name);
+    Check(list == "AOTR;C:\\Game\\Mods\\AOTR\nThrawnsRevenge;C:\\Game\\Mods\\ThrawnsRevenge\n"
+                  "Republic;C:\\Game\\Mods\\Republic" && c.listed == 3,
+          "Rows are name;path in scan order");
+    Check(current == "ThrawnsRevenge;unknown\nC:\\Game\\Mods\\ThrawnsRevenge" && name == "ThrawnsRevenge",
+          "Current is the most recently accessed, the first one on a tie");
+    Check(ModCatalogRead(&c, nullptr, &current, nullptr) && current.find("ThrawnsRevenge") == 0,
+          "Null outputs are skipped");
+
+    std::vector<ModEntry> many;
+    for (int i = 0; i < 1000; i++) {
+        char n[32];
+        snprintf(n, sizeof(n), "Mod%04d", i);
+        many.push_back({n, std::string("C:\\Game\\Mods\\") + n, (uint64_t)i});
+    }
+    int listed = 0;
+    const std::string big = ModFormatList(many, &listed);
+    const ModEntry& last = many[(size_t)listed - 1];
+    const ModEntry& next = many[(size_t)listed];
+    Check(listed > 0 && listed < 1000 && big.substr(big.rfind('\n') + 1) == last.name + ";" + last.path
+          && big.size() + 1 + next.name.size() + 1 + next.path.size() + 1 >= MOD_LIST_MAX,
+          "A long list stops at MOD_LIST_MAX on a whole row");
+
+    ModCatalogPublish(&c, mods, true);
+    ModCatalogRead(&c, &list, &current, &name);
+    Check(list == MOD_SCAN_ERR_CWD && current == MOD_SCAN_ERR_CWD && name.empty() && c.scans == 3,
+          "A failed scan publishes the error, with no mod name");
+}
+
+static void TestCombatStats() {
+    StartSuite("Combat rollups per slot and type (combat_stats.h)");
+
+    static CombatStats s;
+    CombatStatsReset(&s);
+    const uint64_t tie = 0x140001000ULL, xwing = 0x140002000ULL, t0 = 100000;
+
+    CombatStatsRecordDamage(&s, 1, tie, 10.5f, t0);
+    CombatStatsRecordDamage(&s, 1, tie, 4.25f, t0 + 400);
+    CombatStatsRecordDamage(&s, 2, xwing, 20.0f, t0 + 1000);
+    CombatStatsRecordDamage(&s, 2, xwing, -5.0f, t0 + 1000);
+    CombatStatsRecordDamage(&s, 2, xwing, NAN, t0 + 1000);
+    Check(s.slot[1].hits.load() == 2 && s.slot[2].hits.load() == 1, "Only positive finite hits count");
+    Check(CombatStatRowWindow(s.slot[1], t0 + 1000, 2) == 14.75, "Fixed-point damage sums exactly");
+    Check(CombatStatRowWindow(s.slot[1], t0 + 1000, 1) == 0.0, "A 1 s window holds only the current second");
+    CombatStatRow* tieRow = CombatStatsTypeRow(&s, tie);
+    Check(tieRow && tieRow->hits.load() == 2 && CombatStatRowWindow(*tieRow, t0 + 500, 5) == 14.75,
+          "The type row saw the same hits as the slot row");
+
+    // Buckets age out without a sweep: 64 s later the same bucket index is
+    // reused by a new second and the old damage is gone from every window.
+    const uint64_t later = t0 + 64000;
+    CombatStatsRecordDamage(&s, 1, tie, 1.0f, later);
+    Check(CombatStatRowWindow(s.slot[1], later, COMBAT_STATS_MAX_WINDOW) == 1.0,
+          "A reused bucket restarts for its new second");
+    Check(s.slot[1].taken.load() == (uint64_t)(15.75 * COMBAT_STATS_FIXED), "Totals keep everything since reset");
+    Check(CombatStatRowWindow(s.slot[2], later, COMBAT_STATS_MAX_WINDOW) == 0.0, "Stale buckets are not summed");
+
+    CombatStatsRecordDeath(&s, 1, tie, 2, xwing);
+    CombatStatsRecordDeath(&s, 1, tie, -1, 0);
+    CombatStatsRecordDeath(&s, 40, tie, 2, xwing);
+    Check(s.slot[1].deaths.load() == 2 && s.slot[2].kills.load() == 2, "Deaths per victim slot, kills per killer slot");
+    Check(tieRow->deaths.load() == 3 && CombatStatsTypeRow(&s, xwing)->kills.load() == 2,
+          "Deaths per victim type, kills per killer type");
+    Check(s.slotsDropped.load() == 1, "An out-of-range slot is counted, not written");
+
+    // A full probe run drops instead of growing.
+    static CombatStats full;
+    CombatStatsReset(&full);
+    int claimed = 0;
+    for (uint64_t t = 1; t <= COMBAT_STATS_TYPES + 8; t++)
+        if (CombatStatsTypeRow(&full, t << 4)) claimed++;
+    Check(claimed == COMBAT_STATS_TYPES && full.typesDropped.load() == 8, "Type table fills, then counts drops");
+
+    char buf[4096];
+    CombatStatsFormat(s, later, 10, [](uint64_t type, char* out, size_t cap) {
+        snprintf(out, cap, "%s", type == 0x140001000ULL ? "TIE_Fighter" : "");
+    }, buf, sizeof(buf));
+    Check(strstr(buf, "window=10 types=2 types_dropped=0 slots_dropped=1\n") == buf, "Header line");
+    Check(strstr(buf, "slot=1 taken=1.0 dps=0.1 total=15.8 hits=3 kills=0 deaths=2\n") != nullptr, "Slot line");
+    const char* tieLine = strstr(buf, "type=TIE_Fighter taken=1.0");
+    const char* xLine = strstr(buf, "type=0x140002000 taken=0.0");
+    Check(tieLine && xLine && tieLine < xLine, "Types rank by window damage; unnamed types print their pointer");
+
+    // Concurrent hits on one bucket all land.
+    CombatStatsReset(&s);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([] { for (int i = 0; i < 5000; i++) CombatStatsRecordDamage(&s, 3, 0x140003000ULL, 0.5f, 500000); });
+    for (auto& th : threads) th.join();
+    Check(CombatStatRowWindow(s.slot[3], 500000, 1) == 10000.0 && s.slot[3].hits.load() == 20000,
+          "No hit is lost to a concurrent CAS");
+    CombatStatRow* row = CombatStatsTypeRow(&s, 0x140003000ULL);
+    CombatStatsReset(&s);
+    Check(CombatStatRowEmpty(s.slot[3]) && CombatStatRowEmpty(*row) && s.typeKey[row - s.type].load() == 0x140003000ULL,
+          "Reset clears counts and keeps keys");
+}
+
+static void TestCameraPath() {
+    StartSuite("Camera path playback (camera_path.h)");
+
+    static CameraPath p;
+    memset(&p, 0, sizeof(p));
+    Check(CameraPathParse(&p, "") == CAMERA_PATH_PARSE_EMPTY, "An empty path is rejected");
+    Check(CameraPathParse(&p, "0;1;2;3") == CAMERA_PATH_PARSE_EMPTY, "One key is not a path");
+    Check(CameraPathParse(&p, "0;1;2|100;1;2") == CAMERA_PATH_PARSE_FIELDS, "Three fields are rejected");
+    Check(CameraPathParse(&p, "0;1;2;3|100;1;2;3;4;5;6") == CAMERA_PATH_PARSE_FIELDS, "Mixed key shapes are rejected");
+    Check(CameraPathParse(&p, "0;1;x;3|100;1;2;3") == CAMERA_PATH_PARSE_NUMBER, "A bad number is rejected");
+    Check(CameraPathParse(&p, "0;1;2;3|0;1;2;3") == CAMERA_PATH_PARSE_TIME, "Key times must increase");
+    Check(CameraPathParse(&p, "0;1;2;3|10.5;1;2;3") == CAMERA_PATH_PARSE_TIME, "Key times are whole ms");
+    Check(p.keys == 0, "A failed parse leaves the path untouched");
+    std::string many;
+    for (int i = 0; i <= CAMERA_PATH_KEYS; i++) many += std::to_string(i * 10) + ";0;0;0|";
+    Check(CameraPathParse(&p, many.c_str()) == CAMERA_PATH_PARSE_TOO_MANY, "Past CAMERA_PATH_KEYS is rejected");
+
+    // Evenly spaced collinear keys: the spline is the straight line at
+    // constant speed, and every key is hit exactly.
+    Check(CameraPathParse(&p, "0;0;0;100|1000;100;0;100|2000;200;0;100|") == CAMERA_PATH_PARSE_OK && p.keys == 3
+          && !p.targets && CameraPathDuration(&p) == 2000, "Positions-only path parses");
+    CameraPose pose;
+    CameraPathEvaluate(&p, 0, &pose);
+    Check(pose.pos[0] == 0.0f && pose.pos[2] == 100.0f, "t=0 is the first key");
+    CameraPathEvaluate(&p, 1000, &pose);
+    Check(std::fabs(pose.pos[0] - 100.0f) < 1e-3f, "A middle key is passed through");
+    CameraPathEvaluate(&p, 500, &pose);
+    Check(std::fabs(pose.pos[0] - 50.0f) < 1e-3f && std::fabs(pose.pos[1]) < 1e-4f, "Straight keys interpolate linearly");
+    CameraPathEvaluate(&p, 99999, &pose);
+    Check(pose.pos[0] == 200.0f, "Past the end clamps to the last key");
+
+    // Curved path: smooth between keys (no jump across the middle key).
+    Check(CameraPathParse(&p, "0;0;0;0;0;0;0|300;100;100;0;0;0;0|1000;200;0;0;0;0;0") == CAMERA_PATH_PARSE_OK && p.targets,
+          "Targeted path parses");
+    CameraPose a, b;
+    CameraPathEvaluate(&p, 299, &a);
+    CameraPathEvaluate(&p, 301, &b);
+    Check(std::fabs(a.pos[0] - b.pos[0]) < 1.0f && std::fabs(a.pos[1] - b.pos[1]) < 1.0f, "No jump through a key");
+
+    // Playback: one pose per CAMERA_PATH_STEP_MS, then stop after the end.
+    CameraPathStart(&p, 5000, false);
+    Check(CameraPathStep(&p, 5000, &pose) && !CameraPathStep(&p, 5005, &pose), "Steps are throttled");
+    Check(CameraPathStep(&p, 5000 + CAMERA_PATH_STEP_MS, &pose), "The next step comes after CAMERA_PATH_STEP_MS");
+    Check(CameraPathStep(&p, 7000, &pose) && !p.playing && pose.pos[0] == 200.0f,
+          "Past the end: the last key, then stopped");
+    Check(!CameraPathStep(&p, 9000, &pose) && p.frames == 3, "A stopped path hands out nothing");
+    CameraPathStart(&p, 0, true);
+    Check(CameraPathStep(&p, 2300, &pose) && p.playing && p.startMs == 2000
+          && std::fabs(pose.pos[0] - 100.0f) < 1e-3f, "A looping path wraps");
+
+    // Look-at: right-handed, Z-up; the back column points from the target
+    // to the camera and the translation is the position.
+    const float identity[12] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0};
+    float m[12];
+    CameraPose look = {{0.0f, -10.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+    CameraPathMatrix(&p, look, identity, m);
+    Check(m[3] == 0.0f && m[7] == -10.0f && m[11] == 0.0f, "Translation is the pose position");
+    Check(std::fabs(m[2]) < 1e-6f && std::fabs(m[6] + 1.0f) < 1e-6f && std::fabs(m[10]) < 1e-6f, "Back column faces away from the target");
+    Check(std::fabs(m[0] - 1.0f) < 1e-6f && std::fabs(m[9] - 1.0f) < 1e-6f, "Right is +X and up is +Z for a level view");
+    CameraPose down = {{0.0f, 0.0f, 50.0f}, {0.0f, 0.0f, 0.0f}};
+    CameraPathMatrix(&p, down, identity, m);
+    Check(std::fabs(m[10] - 1.0f) < 1e-6f && std::fabs(m[5] - 1.0f) < 1e-6f, "Straight down uses +Y as the up hint");
+    CameraPose onTarget = {{1.0f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f}};
+    CameraPathMatrix(&p, onTarget, identity, m);
+    Check(m[0] == 1.0f && m[5] == 1.0f && m[10] == 1.0f && m[3] == 1.0f, "A target on the camera keeps the rotation");
+    CameraPathParse(&p, "0;5;6;7|100;5;6;7");
+    const float tilted[12] = {0, 1, 0, 9, 1, 0, 0, 9, 0, 0, 1, 9};
+    CameraPathMatrix(&p, look, tilted, m);
+    Check(m[1] == 1.0f && m[4] == 1.0f && m[3] == 0.0f && m[7] == -10.0f, "A positions-only path keeps the rotation");
+}
+
+static void TestTimelineRing() {
+    StartSuite("Session timeline ring file (timeline_ring.h / timeline_replay.h)");
+
+    const uint64_t fileSize = TIMELINE_HEADER_SIZE + TIMELINE_RING_MIN;
+    std::vector<uint8_t> file(fileSize + 8, 0);
+    TimelineWriter w;
+    Check(!TimelineFormat(file.data(), fileSize + 8, 1, 0, &w), "A ring that is not a power of two is rejected");
+    Check(TimelineFormat(file.data(), fileSize, 4242, 1000, &w), "Header + power-of-two ring formats");
+    TimelineView v;
+    Check(TimelineOpen(file.data(), fileSize, &v) == nullptr && v.head == 0 && v.tail == 0 && v.pid == 4242,
+          "A fresh file opens empty");
+    Check(TimelineOpen(file.data(), TIMELINE_HEADER_SIZE, &v) != nullptr, "A truncated file is rejected");
+
+    // Stage from "hooks", then drain in the writer's order: keyframe, events.
+    static SharedEvtBuffer stage;
+    ShmEvtInit(&stage);
+    static TimelineKeySlot slot;
+    TimelineKeyBuilder b;
+    TimelineKeyBegin(&b, slot.bytes, 1, 77);
+    TimelineKeyAddPlayer(&b, 0, 5000.0f, 3, false, false, "EMPIRE");
+    TimelineKeyAddPlayer(&b, 1, 1200.0f, 2, true, true, "REBEL_ALLIANCE_LONG_NAME");
+    TimelineKeyAddUnit(&b, 0xA000, 11, 1, 800.0f, 1000.0f);
+    TimelineKeyAddUnit(&b, 0xB000, 12, 0, 500.0f, 500.0f);
+    Check(!TimelineKeyAddPlayer(&b, 2, 0.0f, 0, false, false, "LATE"), "Players go before units");
+    const uint64_t sel[] = {0xA000};
+    TimelineKeySetSelection(&b, 5, sel, 1);
+    slot.size = TimelineKeyFinish(&b);
+    slot.ms = 10000;
+    slot.full.store(1);
+
+    EvtHPChange hp = {11, 800.0f, 150.0f, 2};
+    Check(TimelineStage(&stage, EVT_HP_CHANGE, 9990, &hp, sizeof(hp)), "An event stages");  // before the keyframe
+    hp.old_hp = 800.0f;
+    hp.damage = 300.0f;
+    TimelineStage(&stage, EVT_HP_CHANGE, 10100, &hp, sizeof(hp));
+    EvtUnitDied died = {12, 0, 0, 1, 1};
+    TimelineStage(&stage, EVT_UNIT_DIED, 10200, &died, sizeof(died));
+    hp.unit_id = 99;  // spawned after the keyframe
+    TimelineStage(&stage, EVT_HP_CHANGE, 10250, &hp, sizeof(hp));
+    uint8_t selRec[8 + 16];
+    const uint32_t selSeq = 6, selCount = 2;
+    const uint64_t selObjs[2] = {0xB000, 0xA000};
+    memcpy(selRec, &selSeq, 4);
+    memcpy(selRec + 4, &selCount, 4);
+    memcpy(selRec + 8, selObjs, 16);
+    TimelineStage(&stage, TIMELINE_REC_SELECTION, 10300, selRec, sizeof(selRec));
+    uint8_t posRec[sizeof(EvtPositionBatch) + sizeof(EvtPositionEntry)];
+    EvtPositionBatch pb = {1, 1, 0, 0, 0.5f};
+    EvtPositionEntry pe = {0xA000, 20, -4, 2, 0};
+    memcpy(posRec, &pb, sizeof(pb));
+    memcpy(posRec + sizeof(pb), &pe, sizeof(pe));
+    TimelineStage(&stage, EVT_POSITION, 10400, posRec, sizeof(posRec));
+    hp.unit_id = 11;
+    hp.old_hp = 500.0f;
+    hp.damage = 100.0f;
+    TimelineStage(&stage, EVT_HP_CHANGE, 20000, &hp, sizeof(hp));  // after the requested point
+
+    Check(TimelineTakeKeyframe(&slot, &w) && slot.full.load() == 0, "The writer takes the keyframe and frees the slot");
+    Check(!TimelineTakeKeyframe(&slot, &w), "An empty slot writes nothing");
+    Check(TimelineDrainStage(&stage, &w, 30000) == 7, "Every staged event reaches the file");
+    Check(TimelineOpen(file.data(), fileSize, &v) == nullptr && v.records == 8 && v.keyframes == 1,
+          "Header counts records and keyframes");
+
+    TimelineSpan span = TimelineScan(v);
+    Check(span.records == 8 && span.first_ms == 9990 && span.last_ms == 20000 && span.first_keyframe_ms == 10000,
+          "Scan reports the covered range");
+
+    ReplayState s;
+    TimelineLoadResult r = TimelineLoadState(v, 9999, s);
+    Check(!r.ok && !r.error.empty(), "No keyframe before the point: the load fails");
+    r = TimelineLoadState(v, 10500, s);
+    Check(r.ok && r.keyframe_ms == 10000 && s.players.size() == 2 && s.local_slot == 1
+          && s.players[1].faction_name == "REBEL_ALLIANCE_" && s.players[0].credits == 5000.0,
+          "Players come from the keyframe (faction names truncated to the row)");
+    const ReplayUnitDetail* a = ReplayFindUnit(s, 0xA000);
+    const ReplayUnitDetail* bu = ReplayFindUnit(s, 0xB000);
+    Check(a && bu && a->hull == 500.0f && a->max_hull == 1000.0f && bu->hull == 0.0f,
+          "Events after the keyframe apply; the one before it does not");
+    Check(r.events_applied == 4 && r.unknown_units == 1, "An unknown ObjectID is counted, not applied");
+    Check(s.selected_units.size() == 2 && s.selected_units[0] == 0xB000, "The selection record replaces the list");
+    Check(a->has_pos && a->pos_x == 10.0f && a->pos_y == -2.0f && a->pos_z == 1.0f, "Position batches place units");
+    Check(s.metadata.get().find(std::string("timeline_keyframe_ms")) != s.metadata.get().end()
+          && s.capture_timestamp_ms == 10500, "Metadata says where the state came from");
+    r = TimelineLoadState(v, 10150, s);
+    Check(r.ok && ReplayFindUnit(s, 0xB000)->hull == 500.0f && s.selected_units.size() == 1,
+          "An earlier point stops before the later events");
+
+    // Wrap: keep appending until the first records are evicted.
+    uint8_t blob[2000];
+    memset(blob, 0x5A, sizeof(blob));
+    for (int i = 0; i < 100; i++) TimelineAppend(&w, EVT_STORY, 30000 + (uint64_t)i, blob, sizeof(blob));
+    TimelineOpen(file.data(), fileSize, &v);
+    span = TimelineScan(v);
+    Check(v.tail > 0 && v.head - v.tail <= v.ring_size && span.keyframes == 0 && span.last_ms == 30099,
+          "Old records are evicted whole, newest kept");
+    Check(!TimelineLoadState(v, 40000, s).ok, "Once its keyframe is gone a point cannot be loaded");
+    Check(!TimelineAppend(&w, EVT_STORY, 0, blob, TIMELINE_RING_MIN / 4), "A record over a quarter of the ring is refused");
+
+    // A torn record (writer died or overwrote it mid-read) ends the walk.
+    TimelineRecord rec;
+    TimelineRingCopyOut(w.ring, v.ring_size, v.tail + TimelineRecordSize(sizeof(blob)), &rec, sizeof(rec));
+    rec.seq += 7;
+    TimelineRingCopyIn(w.ring, v.ring_size, v.tail + TimelineRecordSize(sizeof(blob)), &rec, sizeof(rec));
+    Check(TimelineScan(v).records == 1, "A broken seq chain stops the reader");
+
+    // Staging losses reach the file as EVT_RESYNC.
+    TimelineFormat(file.data(), fileSize, 1, 0, &w);
+    ShmEvtInit(&stage);
+    uint8_t big[TIMELINE_STAGE_MAX];
+    memset(big, 0, sizeof(big));
+    int staged = 0;
+    while (TimelineStage(&stage, EVT_STORY, 1, big, sizeof(big))) staged++;
+    TimelineStage(&stage, EVT_STORY, 1, big, sizeof(big));
+    TimelineDrainStage(&stage, &w, 5);
+    TimelineStage(&stage, EVT_STORY, 2, big, 8);
+    TimelineDrainStage(&stage, &w, 6);
+    Check(staged > 0 && w.hdr->dropped == 2 && !TimelineStage(&stage, EVT_STORY, 1, big, TIMELINE_STAGE_MAX + 1),
+          "Dropped events are counted; oversized payloads are refused");
+}
+
+static void TestCombatModifiers() {
+    StartSuite("Packed combat modifiers (combat_mods.h)");
+
+    std::atomic<uint32_t> mods{COMBAT_MOD_DAMAGE_EVENTS};
+    Check(!CombatModOn(&mods, COMBAT_MOD_GOD | COMBAT_MOD_OHK) && CombatModOn(&mods, COMBAT_MODS_SETHP),
+          "Default word logs damage events only");
+    CombatModSet(&mods, COMBAT_MOD_GOD | COMBAT_MOD_OHK, true);
+    CombatModSet(&mods, COMBAT_MOD_DAMAGE_EVENTS, false);
+    Check(mods.load() == (COMBAT_MOD_GOD | COMBAT_MOD_OHK), "Bits set and clear independently, several at once");
+    CombatModSet(&mods, COMBAT_MOD_GOD | COMBAT_MOD_OHK, false);
+    Check(mods.load() == 0 && !(mods.load() & COMBAT_MODS_SETHP), "All clear: SetHP takes the pass-through path");
+    CombatModSet(&mods, COMBAT_MOD_DAMAGE_MULT, true);
+    Check(!(mods.load() & COMBAT_MODS_SETHP), "The damage multiplier alone does not wake the SetHP detour");
+
+    int lookups = 0;
+    auto human = [&lookups] { lookups++; return true; };
+    auto enemy = [&lookups] { lookups++; return false; };
+    float hp = 90.0f;
+    Check(CombatResolveHp(0, 100.0f, &hp, human) && hp == 90.0f && lookups == 0,
+          "No modifiers: value forwarded, ownership never looked up");
+    Check(CombatResolveHp(COMBAT_MOD_GOD, 50.0f, &hp, human) && hp == 90.0f && lookups == 0,
+          "God mode lets a heal through without an ownership lookup");
+    Check(!CombatResolveHp(COMBAT_MOD_GOD, 100.0f, &hp, human) && lookups == 1,
+          "God mode drops HP loss on a human unit after one lookup");
+    lookups = 0;
+    Check(CombatResolveHp(COMBAT_MOD_GOD | COMBAT_MOD_OHK, 100.0f, &hp, enemy) && hp == 0.0f && lookups == 1,
+          "God + OHK on an enemy: zeroed, ownership looked up once");
+    lookups = 0;
+    hp = 120.0f;
+    Check(CombatResolveHp(COMBAT_MOD_OHK | COMBAT_MOD_DAMAGE_EVENTS, 100.0f, &hp, human) && hp == 120.0f
+          && lookups == 1,
+          "OHK leaves human units alone");
+}
+
+static void TestFakeLuaCheckpoint() {
+    StartSuite("FakeLuaState checkpoint / restore (fake_lua.h)");
+
+    FakeLuaState L;
+    RegisterAll(LS(&L));
+    Check(L.call_log.empty(), "No call log by default");
+    L.log_calls = true;
+    fn_gettop(LS(&L));
+    fake_reset(&L);
+    fn_gettop(LS(&L));
+    Check(L.log_calls && L.call_log.size() == 1 && L.call_log[0] == "gettop",
+          "log_calls survives fake_reset and logs");
+    L.log_calls = false;
+
+    fake_reset(&L);
+    RegisterAll(LS(&L));
+    const size_t registered = L.globals.size();
+    fake_checkpoint(&L);
+    fn_pushstring(LS(&L), "ScratchGlobal");
+    fn_pushnumber(LS(&L), 1);
+    fn_settable(LS(&L), LUA_GLOBALSINDEX);
+    for (int i = 0; i < 2; i++) {
+        fn_pushstring(LS(&L), "SWFOC_GetVersion");
+        fn_pushnumber(LS(&L), 7 + i);
+        fn_settable(LS(&L), LUA_GLOBALSINDEX);
+    }
+    fn_pushstring(LS(&L), "left on the stack");
+    L.pcall_error = 2;
+    Check(L.globals.size() == registered + 1 && L.globals["SWFOC_GetVersion"].type == LUA_TNUMBER,
+          "Writes after the checkpoint land");
+    fake_restore(&L);
+    Check(L.globals.size() == registered && L.globals.count("ScratchGlobal") == 0,
+          "fake_restore drops a global added since the checkpoint");
+    Check(L.globals["SWFOC_GetVersion"].type == LUA_TFUNCTION,
+          "fake_restore puts back a helper overwritten twice");
+    Check(L.stack.empty() && L.pcall_error == 0, "fake_restore empties the stack and clears pcall_error");
+    fake_restore(&L);
+    Check(L.globals.size() == registered, "A second fake_restore keeps the checkpoint");
+
+    fake_reset(&L);
+    RegisterAll(LS(&L));
+    fake_restore(&L);
+    Check(L.globals.empty(), "fake_restore after fake_reset clears like fake_reset");
+}
+
 // Task 111 (added 2026-04-23). Pure-state regression for GetAllPlayers CSV
 // contract. Pins:
 //   * empty-state returns literal "count=0"
@@ -5522,6 +9874,14 @@ static int HarnessStub_SetHeroRespawnTimer(lua_State* L) { fn_pushstring(L, "OK:
 static int HarnessStub_SetPermadeath(lua_State* L)       { fn_pushstring(L, "OK: stub"); return 1; }
 static int HarnessStub_HeroStatEdit(lua_State* L)        { fn_pushstring(L, "OK: stub"); return 1; }
 static int HarnessStub_GetPlanets(lua_State* L)          { fn_pushstring(L, "count=0"); return 1; }
+static int HarnessStub_ListPlanets(lua_State* L)         { fn_pushstring(L, "count=0"); return 1; }
+static int HarnessStub_TypeCensus(lua_State* L)          { fn_pushstring(L, "types=0 objects=0 dropped=0"); return 1; }
+static int HarnessStub_Unit(lua_State* L)                { fn_pushnil(L); return 1; }
+static int HarnessStub_QueryUnits(lua_State* L)          { fn_pushstring(L, "count=0 shown=0 placed=0 unplaced=0"); return 1; }
+static int HarnessStub_TrackUnits(lua_State* L)          { fn_pushstring(L, "tracking=0 follow=0 hz=0 seq=0 records=0 entries=0 gone=0 events=0"); return 1; }
+static int HarnessStub_SpawnBatch(lua_State* L)          { fn_pushstring(L, "ERR: stub"); return 1; }
+static int HarnessStub_SpawnBatchStatus(lua_State* L)    { fn_pushstring(L, "batch=0 total=0 spawned=0 failed=0 pending=0 queued=0 budget=4"); return 1; }
+static int HarnessStub_SetSpawnBudget(lua_State* L)      { fn_pushstring(L, "OK: budget=4"); return 1; }
 static int HarnessStub_ChangePlanetOwner(lua_State* L)   { fn_pushstring(L, "OK: stub"); return 1; }
 static int HarnessStub_GetPlanetTechAndBuildings(lua_State* L) { fn_pushstring(L, ""); return 1; }
 static int HarnessStub_SetDiplomacy(lua_State* L)        { fn_pushstring(L, "OK: stub"); return 1; }
@@ -5573,7 +9933,7 @@ static int HarnessStub_RevealAll(lua_State* L) { fn_pushstring(L, "OK: stub"); r
 // present in the harness. Real pure-state path is covered by
 // TestReplayGetAllPlayers.
 static int HarnessStub_GetAllPlayers(lua_State* L) { fn_pushstring(L, "count=0"); return 1; }
-// Task 112 stub: live EventStreamDrain reads module globals (g_eventRing,
+// Task 112 stub: live EventStreamDrain reads module globals (g_damageRings,
 // g_eventRingLock). Harness cannot exercise those so the stub returns an
 // empty sentinel; the real drain logic is covered by TestReplayEventStream.
 static int HarnessStub_EventStreamDrain(lua_State* L) { fn_pushstring(L, "count=0"); return 1; }
@@ -5605,6 +9965,8 @@ static void HarnessRegisterAll(FakeLuaState* fake) {
         {"SWFOC_StateInfo",          (lua_CFunction)SWFOC_StateInfo},
         {"SWFOC_EventControl",       Lua_EventControl},
         {"SWFOC_DumpState",          Lua_DumpState},
+        {"SWFOC_DumpStateAsync",     Lua_DumpStateAsync},
+        {"SWFOC_DumpStatePoll",      Lua_DumpStatePoll},
         // Player / economy
         {"SWFOC_GetLocalPlayer",     Lua_GetLocalPlayer},
         // 2026-04-25: v1 + v2 unregistered from Lua dispatch (v3 only).
@@ -5643,6 +10005,15 @@ static void HarnessRegisterAll(FakeLuaState* fake) {
         {"SWFOC_SetPermadeath",      HarnessStub_SetPermadeath},
         {"SWFOC_HeroStatEdit",       HarnessStub_HeroStatEdit},
         {"SWFOC_GetPlanets",         HarnessStub_GetPlanets},
+        {"SWFOC_ListPlanets",        HarnessStub_ListPlanets},
+        {"SWFOC_TypeCensus",         HarnessStub_TypeCensus},
+        {"SWFOC_Unit",               HarnessStub_Unit},
+        {"SWFOC_QueryUnitsInRadius", HarnessStub_QueryUnits},
+        {"SWFOC_QueryUnitsInRect",   HarnessStub_QueryUnits},
+        {"SWFOC_TrackUnits",         HarnessStub_TrackUnits},
+        {"SWFOC_SpawnBatch",         HarnessStub_SpawnBatch},
+        {"SWFOC_SpawnBatchStatus",   HarnessStub_SpawnBatchStatus},
+        {"SWFOC_SetSpawnBudget",     HarnessStub_SetSpawnBudget},
         {"SWFOC_ChangePlanetOwner",  HarnessStub_ChangePlanetOwner},
         {"SWFOC_GetPlanetTechAndBuildings", HarnessStub_GetPlanetTechAndBuildings},
         {"SWFOC_SetDiplomacy",       HarnessStub_SetDiplomacy},
@@ -6158,7 +10529,17 @@ static void TestSetHumanPlayerV2() {
 // FakeLuaState::known_object_types so fake_pcall returns truthy for known
 // types and nil for unknown — letting us verify both branches without a
 // real engine.
+//
+// The answer cache is the real type_cache.h; the key leaves out the
+// GameModeClass (no game-mode chain in the harness image).
 // ======================================================================
+static TypeCache g_typeCache;
+static uint32_t g_typeCacheGen = 0;
+
+static void InvalidateTypeCache() {
+    g_typeCacheGen++;
+}
+
 static int Lua_BatchTypeExists(lua_State* L) {
     constexpr size_t kMaxInputBytes = 16384;
     constexpr size_t kMaxNameBytes  = 256;
@@ -6216,18 +10597,35 @@ static int Lua_BatchTypeExists(lua_State* L) {
         ++cursor;
     }
 
+    const bool bitmap = fn_gettop(L) >= 2 && fn_type(L, 2) == LUA_TSTRING &&
+                        fn_tostring(L, 2) && strcmp(fn_tostring(L, 2), "bitmap") == 0;
     if (nameCount == 0) {
-        fn_pushstring(L, "");
+        fn_pushstring(L, bitmap ? "bitmap n=0 " : "");
         return 1;
     }
 
+    TypeCacheKey key = {};
+    key.state = (uint64_t)(uintptr_t)L;
+    key.gen = g_typeCacheGen;
+    TypeCacheBind(&g_typeCache, key);
+
     static thread_local char s_out[kMaxNames * 2 + 1];
+    static thread_local uint8_t s_bits[(kMaxNames + 7) / 8];
+    memset(s_bits, 0, sizeof(s_bits));
     size_t off = 0;
     for (size_t i = 0; i < nameCount; ++i) {
         if (i > 0 && off < sizeof(s_out) - 1) {
             s_out[off++] = '|';
         }
 
+        const size_t nameLen = strlen(s_names[i]);
+        const int known = nameLen ? TypeCacheLookup(&g_typeCache, s_names[i], nameLen) : 0;
+        if (known >= 0) {
+            if (known) s_bits[i >> 3] |= (uint8_t)(1u << (i & 7));
+            if (off < sizeof(s_out) - 1) s_out[off++] = known ? '1' : '0';
+            continue;
+        }
+
         int top = fn_gettop(L);
         fn_pushstring(L, "Find_Object_Type");
         fn_gettable(L, LUA_GLOBALSINDEX);
@@ -6244,23 +10642,37 @@ static int Lua_BatchTypeExists(lua_State* L) {
             if (rty != LUA_TNIL) {
                 flag = '1';
             }
+            TypeCacheStore(&g_typeCache, s_names[i], nameLen, flag == '1');
         }
         fn_settop(L, top);
 
+        if (flag == '1') s_bits[i >> 3] |= (uint8_t)(1u << (i & 7));
         if (off < sizeof(s_out) - 1) {
             s_out[off++] = flag;
         }
     }
     s_out[off] = '\0';
+    if (bitmap) {
+        static const char kHex[] = "0123456789abcdef";
+        off = (size_t)snprintf(s_out, sizeof(s_out), "bitmap n=%zu ", nameCount);
+        for (size_t b = 0; b < (nameCount + 7) / 8 && off + 2 < sizeof(s_out); b++) {
+            s_out[off++] = kHex[s_bits[b] >> 4];
+            s_out[off++] = kHex[s_bits[b] & 0xF];
+        }
+        s_out[off] = '\0';
+    }
     fn_pushstring(L, s_out);
     return 1;
 }
 
 static void TestBatchTypeExists() {
     StartSuite("BatchTypeExists (Spawn-tab live filtering)");
+    // Each case's FakeLuaState may land at the previous one's address; start
+    // every case as if that state had gone through lua_close.
 
     // Test 1: non-tactical state (Find_Object_Type not present) returns ERR.
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = false;
         fake_pushstring(&L, "REBEL_INFANTRY");
@@ -6274,6 +10686,7 @@ static void TestBatchTypeExists() {
 
     // Test 2: empty input -> empty output.
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         fake_pushstring(&L, "");
@@ -6285,6 +10698,7 @@ static void TestBatchTypeExists() {
 
     // Test 3: single known type -> "1".
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         L.known_object_types.insert("REBEL_INFANTRY");
@@ -6297,6 +10711,7 @@ static void TestBatchTypeExists() {
 
     // Test 4: single unknown type -> "0".
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         // intentionally empty known_object_types
@@ -6309,6 +10724,7 @@ static void TestBatchTypeExists() {
 
     // Test 5: mixed batch in fixed order.
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         L.known_object_types.insert("REBEL_INFANTRY");
@@ -6323,6 +10739,7 @@ static void TestBatchTypeExists() {
 
     // Test 6: trailing pipe is tolerated.
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         L.known_object_types.insert("REBEL_INFANTRY");
@@ -6339,6 +10756,7 @@ static void TestBatchTypeExists() {
     // Test 7: case sensitivity — known set is case-sensitive (mirrors
     // real Lua). "rebel_infantry" is NOT the same as "REBEL_INFANTRY".
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         L.known_object_types.insert("REBEL_INFANTRY");
@@ -6351,6 +10769,7 @@ static void TestBatchTypeExists() {
 
     // Test 8: oversized name in batch yields "0" placeholder, doesn't break batch.
     {
+        InvalidateTypeCache();
         FakeLuaState L;
         L.has_game_globals = true;
         L.known_object_types.insert("REBEL_INFANTRY");
@@ -6363,6 +10782,103 @@ static void TestBatchTypeExists() {
         Check(result != nullptr && strcmp(result, "1|0|1") == 0,
               "oversized entry replaced with empty string -> \"0\" flag, batch survives");
     }
+
+    // Test 9: repeat probes are answered from the cache -- a type that
+    // appears after the first probe stays "0" until the cache is invalidated.
+    {
+        InvalidateTypeCache();
+        FakeLuaState L;
+        L.has_game_globals = true;
+        L.known_object_types.insert("REBEL_INFANTRY");
+        fake_pushstring(&L, "REBEL_INFANTRY|EMPIRE_AT_AT");
+        Lua_BatchTypeExists(LS(&L));
+        const uint32_t missesBefore = g_typeCache.misses;
+        const uint32_t hitsBefore = g_typeCache.hits;
+        L.known_object_types.insert("EMPIRE_AT_AT");
+        fake_settop(&L, 0);
+        fake_pushstring(&L, "EMPIRE_AT_AT|REBEL_INFANTRY");
+        Lua_BatchTypeExists(LS(&L));
+        const char* result = fake_tostring(&L, -1);
+        Check(result != nullptr && strcmp(result, "0|1") == 0,
+              "repeat probe served from the cache, absent answers included");
+        Check(g_typeCache.hits == hitsBefore + 2 && g_typeCache.misses == missesBefore,
+              "repeat probe makes no cache misses");
+
+        InvalidateTypeCache();  // lua_open / lua_close / mod change
+        fake_settop(&L, 0);
+        fake_pushstring(&L, "EMPIRE_AT_AT|REBEL_INFANTRY");
+        Lua_BatchTypeExists(LS(&L));
+        result = fake_tostring(&L, -1);
+        Check(result != nullptr && strcmp(result, "1|1") == 0,
+              "invalidation re-probes through Find_Object_Type");
+    }
+
+    // Test 10: a different lua_State never sees another state's answers.
+    {
+        InvalidateTypeCache();
+        FakeLuaState A, B;
+        A.has_game_globals = B.has_game_globals = true;
+        A.known_object_types.insert("REBEL_INFANTRY");
+        fake_pushstring(&A, "REBEL_INFANTRY");
+        Lua_BatchTypeExists(LS(&A));
+        fake_pushstring(&B, "REBEL_INFANTRY");
+        Lua_BatchTypeExists(LS(&B));
+        const char* result = fake_tostring(&B, -1);
+        Check(result != nullptr && strcmp(result, "0") == 0, "cache is keyed by lua_State");
+    }
+
+    // Test 11: bitmap reply, bit i = name i, LSB first, two hex digits per byte.
+    {
+        InvalidateTypeCache();
+        FakeLuaState L;
+        L.has_game_globals = true;
+        std::string input;
+        for (int i = 0; i < 10; i++) {
+            std::string name = "T" + std::to_string(i);
+            if (i == 0 || i == 2 || i == 9) L.known_object_types.insert(name);
+            input += (i ? "|" : "") + name;
+        }
+        fake_pushstring(&L, input.c_str());
+        fake_pushstring(&L, "bitmap");
+        Lua_BatchTypeExists(LS(&L));
+        const char* result = fake_tostring(&L, -1);
+        Check(result != nullptr && strcmp(result, "bitmap n=10 0502") == 0,
+              "bitmap reply packs the flags");
+        fake_settop(&L, 0);
+        fake_pushstring(&L, "");
+        fake_pushstring(&L, "bitmap");
+        Lua_BatchTypeExists(LS(&L));
+        result = fake_tostring(&L, -1);
+        Check(result != nullptr && strcmp(result, "bitmap n=0 ") == 0, "empty bitmap batch");
+    }
+
+    // Test 12: the cache itself -- collisions compare names, and a full
+    // table stops storing instead of evicting.
+    {
+        static TypeCache c;
+        TypeCacheClear(&c);
+        TypeCacheKey k = {1, 2, 3};
+        Check(!TypeCacheBind(&c, k), "first bind drops nothing");
+        Check(TypeCacheLookup(&c, "AT_AT", 5) == -1, "unprobed name is unknown");
+        Check(TypeCacheStore(&c, "AT_AT", 5, true) && TypeCacheStore(&c, "AT_ST", 5, false),
+              "answers are stored");
+        Check(TypeCacheLookup(&c, "AT_AT", 5) == 1 && TypeCacheLookup(&c, "AT_ST", 5) == 0
+              && TypeCacheLookup(&c, "AT_A", 4) == -1,
+              "lookups match whole names only");
+        Check(!TypeCacheBind(&c, k) && c.count == 2, "same key keeps the answers");
+        k.mode = 4;
+        Check(TypeCacheBind(&c, k) && c.count == 0 && c.resets == 1,
+              "game-mode change drops the answers");
+        char name[16];
+        int stored = 0;
+        for (int i = 0; i < TYPE_CACHE_MAX_NAMES + 10; i++) {
+            int len = snprintf(name, sizeof(name), "N%d", i);
+            if (TypeCacheStore(&c, name, (size_t)len, (i & 1) != 0)) stored++;
+        }
+        Check(stored == TYPE_CACHE_MAX_NAMES && TypeCacheLookup(&c, "N1", 2) == 1
+              && TypeCacheLookup(&c, "N6200", 5) == -1,
+              "full table keeps its answers and stops storing");
+    }
 }
 
 // ======================================================================
@@ -6374,7 +10890,7 @@ int main() {
 
     InitializeCriticalSection(&csRegistered);
     InitializeCriticalSection(&csGameStates);
-    InitializeCriticalSection(&g_pipeLock);
+    PipeQueueInit(&g_pipeQueue);
 
     WireFakes();
     InitGameImage();
@@ -6383,6 +10899,7 @@ int main() {
     TestSWFOCFunctions();       printf("\n");
     TestDoStringCapture();      printf("\n");
     TestPipeProtocol();         printf("\n");
+    TestPipeFraming();          printf("\n");
     TestSharedMemoryProtocol(); printf("\n");
     TestRegistrationAndProbe(); printf("\n");
     TestPlayerHelpers();        printf("\n");
@@ -6422,6 +10939,55 @@ int main() {
     TestReplayRevealAll();                      printf("\n");
     TestReplayGetAllPlayers();                  printf("\n");
     TestReplayEventStream();                    printf("\n");
+    TestDamageEventRings();                     printf("\n");
+    TestUnitShadowDelta();                      printf("\n");
+    TestUnitIndex();                            printf("\n");
+    TestRegionCache();                          printf("\n");
+    TestObjMemo();                              printf("\n");
+    TestBulkMutatePlan();                       printf("\n");
+    TestSnapWriter();                           printf("\n");
+    TestSnapshotAsync();                        printf("\n");
+    TestSnapLz4();                              printf("\n");
+    TestSnapDelta();                            printf("\n");
+    TestSnapIndex();                            printf("\n");
+    TestReplayFlat();                           printf("\n");
+    TestReplaySymbols();                        printf("\n");
+    TestReplayUnitArena();                      printf("\n");
+    TestLuaTableRows();                         printf("\n");
+    TestPlanetTable();                          printf("\n");
+    TestLogRing();                              printf("\n");
+    TestPerfHistograms();                       printf("\n");
+    TestHookCost();                             printf("\n");
+    TestCombatModifiers();                      printf("\n");
+    TestPendingJournal();                       printf("\n");
+    TestSlotModifiers();                        printf("\n");
+    TestCrashTrail();                           printf("\n");
+    TestCrc32();                                printf("\n");
+    TestHelperScripts();                        printf("\n");
+    TestTypeCensus();                           printf("\n");
+    TestUnitHandles();                          printf("\n");
+    TestSpatialGrid();                          printf("\n");
+    TestSelectionTracker();                     printf("\n");
+    TestPositionTrack();                        printf("\n");
+    TestEventCompact();                         printf("\n");
+    TestReplaySim();                            printf("\n");
+    TestReplayTick();                           printf("\n");
+    TestReplaySweep();                          printf("\n");
+    TestReplayFork();                           printf("\n");
+    TestReplayEventLog();                       printf("\n");
+    TestReplayDiff();                           printf("\n");
+    TestSnapshotReader();                       printf("\n");
+    TestHelperIndex();                          printf("\n");
+    TestInstanceNames();                        printf("\n");
+    TestCsvRow();                               printf("\n");
+    TestPlayerTable();                          printf("\n");
+    TestSpawnBatch();                           printf("\n");
+    TestHardpointLayout();                      printf("\n");
+    TestModCatalog();                           printf("\n");
+    TestTimelineRing();                         printf("\n");
+    TestCombatStats();                          printf("\n");
+    TestCameraPath();                           printf("\n");
+    TestFakeLuaCheckpoint();                    printf("\n");
     TestReplayEnumerateUnits();                 printf("\n");
     TestReplayHealAllLocal();                   printf("\n");
     TestReplayDamageMultiplier();               printf("\n");
@@ -6462,7 +11028,7 @@ int main() {
     FreeGameImage();
     DeleteCriticalSection(&csRegistered);
     DeleteCriticalSection(&csGameStates);
-    DeleteCriticalSection(&g_pipeLock);
+    PipeQueueDestroy(&g_pipeQueue);
 
     return g_failed > 0 ? 1 : 0;
 }
@@ -0,0 +1,209 @@
+#pragma once
+// timeline_replay.h -- a point on a session timeline (timeline_ring.h) as a
+// ReplayState, for swfoc_replay.exe --timeline.
+//
+// The state at `at_ms` is the last keyframe at or before it, with the
+// records after that keyframe (ms in (keyframe ms, at_ms]) applied:
+//
+//   * EVT_HP_CHANGE sets the unit's hull to old_hp - damage (clamped at 0);
+//     EVT_UNIT_DIED sets it to 0. Units are matched by ObjectID through the
+//     keyframe rows; an event for a unit the keyframe does not list (spawned
+//     since, or past TIMELINE_KEY_UNITS) is counted, not applied.
+//   * TIMELINE_REC_SELECTION replaces selected_units.
+//   * EVT_POSITION entries place units (POS_ENTRY_GONE ones are left alone).
+//   * EVT_RESYNC counts a staging gap: events were lost there.
+//
+// Only what a keyframe records is reconstructed: players (slot, faction,
+// credits, tech), the local slot, units (obj_addr, owner, hull, max hull,
+// position) and the selection. Everything else keeps its ReplayState
+// default. The metadata table reports where the state came from
+// (timeline_at_ms, timeline_keyframe_ms, timeline_events, timeline_gaps).
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "position_track.h"
+#include "replay_state.h"
+#include "timeline_ring.h"
+
+struct TimelineSpan {
+    uint64_t first_ms  = 0;
+    uint64_t last_ms   = 0;
+    uint32_t records   = 0;
+    uint32_t keyframes = 0;
+    uint64_t first_keyframe_ms = 0;
+};
+
+// The time range the readable records cover.
+inline TimelineSpan TimelineScan(const TimelineView& v) {
+    TimelineSpan s;
+    TimelineForEach(v, v.tail, [&s](uint64_t, const TimelineRecord& rec, const uint8_t*) {
+        if (!s.records || rec.ms < s.first_ms) s.first_ms = rec.ms;
+        if (rec.ms > s.last_ms) s.last_ms = rec.ms;
+        if (rec.type == TIMELINE_REC_KEYFRAME && !s.keyframes++) s.first_keyframe_ms = rec.ms;
+        s.records++;
+        return true;
+    });
+    return s;
+}
+
+struct TimelineLoadResult {
+    bool        ok = false;
+    std::string error;
+    uint64_t    at_ms          = 0;
+    uint64_t    keyframe_ms    = 0;
+    uint32_t    events_applied = 0;
+    uint32_t    unknown_units  = 0;  // events for units the keyframe does not list
+    uint32_t    gaps           = 0;  // EVT_RESYNC records in the applied range
+};
+
+inline void TimelineApplyKeyframe(const uint8_t* p, const TimelineKeyLayout& k, ReplayState& out,
+                                  std::unordered_map<uint32_t, uint64_t>* byUnitId) {
+    for (uint32_t i = 0; i < k.hdr.players; i++) {
+        TimelineKeyPlayer row;
+        memcpy(&row, p + k.players + i * sizeof(row), sizeof(row));
+        ReplayPlayer pl;
+        pl.slot = (uint32_t)row.slot;
+        row.faction[TIMELINE_KEY_FACTION - 1] = '\0';
+        pl.faction_name = row.faction;
+        pl.credits = row.credits;
+        pl.tech_level = row.tech;
+        out.players.push_back(pl);
+    }
+    out.local_slot = k.hdr.local_slot;
+
+    auto& units = out.units.mut();
+    units.reserve(k.hdr.units);
+    for (uint32_t i = 0; i < k.hdr.units; i++) {
+        TimelineKeyUnit row;
+        memcpy(&row, p + k.units + i * sizeof(row), sizeof(row));
+        ReplayUnitDetail& u = units[row.obj];
+        u.obj_addr = row.obj;
+        u.owner_slot = row.owner;
+        u.hull = row.hull;
+        u.max_hull = row.max_hull;
+        (*byUnitId)[row.unit_id] = row.obj;
+    }
+    for (uint32_t i = 0; i < k.hdr.selected; i++) {
+        uint64_t obj;
+        memcpy(&obj, p + k.selected + i * sizeof(obj), sizeof(obj));
+        out.selected_units.push_back(obj);
+    }
+}
+
+// One event after the keyframe. Returns false when it names a unit the
+// keyframe does not list.
+inline bool TimelineApplyEvent(const TimelineRecord& rec, const uint8_t* p, ReplayState& out,
+                               const std::unordered_map<uint32_t, uint64_t>& byUnitId) {
+    auto unitFor = [&](uint32_t unitId) -> ReplayUnitDetail* {
+        const auto it = byUnitId.find(unitId);
+        return it != byUnitId.end() ? ReplayFindUnit(out, it->second) : nullptr;
+    };
+    switch (rec.type) {
+    case EVT_HP_CHANGE: {
+        if (rec.size < sizeof(EvtHPChange)) return true;
+        EvtHPChange e;
+        memcpy(&e, p, sizeof(e));
+        ReplayUnitDetail* u = unitFor(e.unit_id);
+        if (!u) return false;
+        const float hull = e.old_hp - e.damage;
+        u->hull = hull > 0.0f ? hull : 0.0f;
+        return true;
+    }
+    case EVT_UNIT_DIED: {
+        if (rec.size < EVT_UNIT_DIED_V1_SIZE) return true;
+        uint32_t unitId;
+        memcpy(&unitId, p, sizeof(unitId));
+        ReplayUnitDetail* u = unitFor(unitId);
+        if (!u) return false;
+        u->hull = 0.0f;
+        return true;
+    }
+    case TIMELINE_REC_SELECTION: {
+        if (rec.size < 8) return true;
+        uint32_t count;
+        memcpy(&count, p + 4, sizeof(count));
+        if (8 + (uint64_t)count * sizeof(uint64_t) > rec.size) return true;
+        out.selected_units.assign(count, 0);
+        if (count) memcpy(out.selected_units.data(), p + 8, count * sizeof(uint64_t));
+        return true;
+    }
+    case EVT_POSITION: {
+        if (rec.size < sizeof(EvtPositionBatch)) return true;
+        EvtPositionBatch b;
+        memcpy(&b, p, sizeof(b));
+        bool known = true;
+        for (uint32_t i = 0; i < b.count; i++) {
+            const uint32_t off = sizeof(b) + i * (uint32_t)sizeof(EvtPositionEntry);
+            if (off + sizeof(EvtPositionEntry) > rec.size) break;
+            EvtPositionEntry e;
+            memcpy(&e, p + off, sizeof(e));
+            if (e.flags & POS_ENTRY_GONE) continue;
+            if (!ReplayMutSetUnitPosition(out, e.obj, e.x * b.step, e.y * b.step, e.z * b.step)) known = false;
+        }
+        return known;
+    }
+    default:
+        return true;
+    }
+}
+
+// Rebuilds `out` as of atMs. Fails when no keyframe is at or before it.
+inline TimelineLoadResult TimelineLoadState(const TimelineView& v, uint64_t atMs, ReplayState& out) {
+    TimelineLoadResult r;
+    r.at_ms = atMs;
+    uint64_t keyPos = 0;
+    bool haveKey = false;
+    TimelineForEach(v, v.tail, [&](uint64_t pos, const TimelineRecord& rec, const uint8_t*) {
+        if (rec.type == TIMELINE_REC_KEYFRAME && rec.ms <= atMs) {
+            keyPos = pos;
+            haveKey = true;
+        }
+        return true;
+    });
+    if (!haveKey) {
+        r.error = "no keyframe at or before the requested time";
+        return r;
+    }
+
+    out = ReplayState();
+    std::unordered_map<uint32_t, uint64_t> byUnitId;
+    bool keyDone = false;
+    TimelineForEach(v, keyPos, [&](uint64_t, const TimelineRecord& rec, const uint8_t* p) {
+        if (!keyDone) {
+            TimelineKeyLayout k;
+            if (rec.type != TIMELINE_REC_KEYFRAME || !TimelineKeyParse(p, rec.size, &k)) {
+                r.error = "keyframe record does not parse";
+                return false;
+            }
+            TimelineApplyKeyframe(p, k, out, &byUnitId);
+            r.keyframe_ms = rec.ms;
+            keyDone = true;
+            return true;
+        }
+        if (rec.ms <= r.keyframe_ms || rec.ms > atMs) return true;
+        if (rec.type == TIMELINE_REC_KEYFRAME) return true;
+        if (rec.type == EVT_RESYNC) {
+            r.gaps++;
+            return true;
+        }
+        if (TimelineApplyEvent(rec, p, out, byUnitId)) r.events_applied++;
+        else r.unknown_units++;
+        return true;
+    });
+    if (!keyDone && r.error.empty()) r.error = "keyframe was overwritten while reading";
+    if (!r.error.empty()) return r;
+
+    out.capture_timestamp_ms = atMs;
+    auto& meta = out.metadata.mut();
+    meta["source"] = "timeline";
+    meta["timeline_at_ms"] = std::to_string(atMs);
+    meta["timeline_keyframe_ms"] = std::to_string(r.keyframe_ms);
+    meta["timeline_events"] = std::to_string(r.events_applied);
+    meta["timeline_gaps"] = std::to_string(r.gaps);
+    r.ok = true;
+    return r;
+}
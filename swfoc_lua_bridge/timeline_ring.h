@@ -0,0 +1,425 @@
+#pragma once
+// timeline_ring.h -- the session timeline: the bridge's event stream plus
+// periodic player / unit keyframes, kept in a fixed-size ring file on disk.
+//
+// After a desync or a crash the question is "what happened in the last few
+// minutes", and a SWFOC_DumpState capture only answers "what is true now".
+// While SWFOC_Timeline("on") has it running, the bridge appends to a mapped
+// ring file instead:
+//
+//   * Every event WriteEvent publishes (HP changes, deaths, production,
+//     EVT_POSITION batches) is staged into a private SharedEvtBuffer
+//     (shared_memory.h) behind its Unix ms, whether or not
+//     SWFOC_EventControl has the shared ring on. A hook pays one
+//     ShmEvtWrite; when staging is full the event is dropped and counted,
+//     and the gap reaches the file as an EVT_RESYNC record.
+//   * Selection changes are staged as TIMELINE_REC_SELECTION (the whole
+//     list, not EVT_SELECTION's hash).
+//   * Every TIMELINE_KEYFRAME_MS Hook_luaD_call fills the TimelineKeySlot
+//     with the player table, the tactical units (obj_addr, ObjectID, owner,
+//     hull) and the selection. The slot holds one keyframe; one that finds
+//     it still full is skipped and counted.
+//   * A writer thread moves the keyframe and then the staged events into the
+//     file every TIMELINE_FLUSH_MS. It is the file's only writer; hooks never
+//     touch the mapping.
+//
+// File layout (little-endian): a 64-byte TimelineFileHeader, then ring_size
+// bytes of records. A record is a 16-byte TimelineRecord header and `size`
+// payload bytes, padded to TIMELINE_ALIGN. Records sit at free-running
+// stream positions and wrap at the ring end, where one may be split.
+// [tail, head) always holds whole records, oldest first: the writer moves
+// tail past what it is about to overwrite before writing, and moves head
+// once a record is complete, so a process that dies mid-write leaves a file
+// whose header still describes intact records. `seq` numbers records
+// consecutively, which lets a reader of a file still being written stop at
+// the first record that changed under it.
+//
+// Record ms values come from the bridge's capture clock. A keyframe is
+// written before the events staged with it, so an event after a keyframe
+// record with ms <= the keyframe's happened before the keyframe was read.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code; the
+// bridge maps the file and the replay harness reads it (timeline_replay.h).
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "shared_memory.h"
+
+#define TIMELINE_MAGIC        0x4C545753u  // "SWTL"
+#define TIMELINE_VERSION      1
+#define TIMELINE_HEADER_SIZE  64
+#define TIMELINE_RECORD_HDR   16
+#define TIMELINE_ALIGN        8
+#define TIMELINE_RING_DEFAULT (32u << 20)  // ring bytes; power of two
+#define TIMELINE_RING_MIN     (64u << 10)
+#define TIMELINE_RING_MAX     (1u << 30)
+#define TIMELINE_KEYFRAME_MS  5000
+#define TIMELINE_SAMPLE_MS    250          // selection polling while recording
+#define TIMELINE_FLUSH_MS     50
+#define TIMELINE_STAGE_MAX    1024         // largest staged payload (ms prefix excluded)
+
+#define TIMELINE_KEY_PLAYERS  8            // PLAYER_TABLE_SLOTS
+#define TIMELINE_KEY_UNITS    2048         // UNIT_INDEX_MAX
+#define TIMELINE_KEY_SELECTED 64           // RVA::Selection::kMaxSelectionCount
+#define TIMELINE_KEY_FACTION  16           // faction name bytes, NUL included
+
+// Record types beyond the shared_memory.h EventType values.
+#define TIMELINE_REC_KEYFRAME  0x100       // TimelineKeyHeader + rows
+#define TIMELINE_REC_SELECTION 0x101       // u32 seq, u32 count, u64 obj[count]
+
+struct TimelineFileHeader {
+    uint32_t              magic;        // +0  TIMELINE_MAGIC, written last
+    uint16_t              version;      // +4
+    uint16_t              header_size;  // +6  TIMELINE_HEADER_SIZE
+    uint32_t              ring_size;    // +8  power of two
+    uint32_t              pid;          // +12 process that wrote the file
+    std::atomic<uint64_t> head;         // +16 stream position after the newest record
+    std::atomic<uint64_t> tail;         // +24 stream position of the oldest record
+    uint64_t              records;      // +32 appended since the file was formatted
+    uint64_t              keyframes;    // +40
+    uint64_t              dropped;      // +48 events lost in staging
+    uint64_t              created_ms;   // +56
+};
+static_assert(sizeof(TimelineFileHeader) == TIMELINE_HEADER_SIZE, "timeline header is 64 bytes");
+
+struct TimelineRecord {
+    uint16_t type;  // EventType or TIMELINE_REC_*
+    uint16_t size;  // payload bytes
+    uint32_t seq;   // record number, low 32 bits
+    uint64_t ms;
+};
+static_assert(sizeof(TimelineRecord) == TIMELINE_RECORD_HDR, "timeline record header is 16 bytes");
+
+#pragma pack(push, 1)
+struct TimelineKeyHeader {
+    uint32_t players;        // TimelineKeyPlayer rows that follow
+    uint32_t units;          // TimelineKeyUnit rows after the players
+    uint32_t selected;       // u64 obj_addrs after the units
+    int32_t  local_slot;
+    uint32_t units_walked;   // > units when the keyframe was full
+    uint32_t selection_seq;  // SelectionTracker::seq of the selection rows
+    uint64_t tick;           // Hook_luaD_call tick it was read on
+};
+
+struct TimelineKeyPlayer {
+    int32_t slot;
+    float   credits;
+    int32_t tech;
+    uint8_t is_human;
+    uint8_t is_local;
+    uint8_t pad[2];
+    char    faction[TIMELINE_KEY_FACTION];
+};
+
+struct TimelineKeyUnit {
+    uint64_t obj;       // GameObjectClass*
+    uint32_t unit_id;   // GameObj+0x50, what the events carry
+    int32_t  owner;
+    float    hull;
+    float    max_hull;  // 0 = unknown
+};
+#pragma pack(pop)
+
+#define TIMELINE_KEY_MAX (sizeof(TimelineKeyHeader) + TIMELINE_KEY_PLAYERS * sizeof(TimelineKeyPlayer) \
+                          + TIMELINE_KEY_UNITS * sizeof(TimelineKeyUnit) + TIMELINE_KEY_SELECTED * sizeof(uint64_t))
+static_assert(TIMELINE_KEY_MAX <= 0xFFFF, "a keyframe fits one record");
+
+inline uint32_t TimelineRecordSize(uint32_t payloadSize) {
+    return (TIMELINE_RECORD_HDR + payloadSize + TIMELINE_ALIGN - 1) & ~(uint32_t)(TIMELINE_ALIGN - 1);
+}
+
+inline bool TimelineRingSizeValid(uint64_t ringSize) {
+    return ringSize >= TIMELINE_RING_MIN && ringSize <= TIMELINE_RING_MAX && (ringSize & (ringSize - 1)) == 0;
+}
+
+// ---- Writer (one thread) ----------------------------------------------------
+
+struct TimelineWriter {
+    TimelineFileHeader* hdr;
+    uint8_t*            ring;
+    uint32_t            seq;  // of the next record
+};
+
+inline void TimelineRingCopyIn(uint8_t* ring, uint32_t ringSize, uint64_t pos, const void* src, uint32_t n) {
+    const uint32_t off = (uint32_t)(pos & (ringSize - 1));
+    const uint32_t first = n < ringSize - off ? n : ringSize - off;
+    memcpy(ring + off, src, first);
+    if (first < n) memcpy(ring, static_cast<const uint8_t*>(src) + first, n - first);
+}
+
+inline void TimelineRingCopyOut(const uint8_t* ring, uint32_t ringSize, uint64_t pos, void* dst, uint32_t n) {
+    const uint32_t off = (uint32_t)(pos & (ringSize - 1));
+    const uint32_t first = n < ringSize - off ? n : ringSize - off;
+    memcpy(dst, ring + off, first);
+    if (first < n) memcpy(static_cast<uint8_t*>(dst) + first, ring, n - first);
+}
+
+// Formats `base` (fileSize bytes: the header plus a TimelineRingSizeValid
+// ring) as an empty timeline. False when the size is not one.
+inline bool TimelineFormat(uint8_t* base, uint64_t fileSize, uint32_t pid, uint64_t nowMs, TimelineWriter* w) {
+    if (fileSize < TIMELINE_HEADER_SIZE || !TimelineRingSizeValid(fileSize - TIMELINE_HEADER_SIZE)) return false;
+    TimelineFileHeader* h = reinterpret_cast<TimelineFileHeader*>(base);
+    h->magic = 0;
+    h->version = TIMELINE_VERSION;
+    h->header_size = TIMELINE_HEADER_SIZE;
+    h->ring_size = (uint32_t)(fileSize - TIMELINE_HEADER_SIZE);
+    h->pid = pid;
+    h->head.store(0, std::memory_order_relaxed);
+    h->tail.store(0, std::memory_order_relaxed);
+    h->records = 0;
+    h->keyframes = 0;
+    h->dropped = 0;
+    h->created_ms = nowMs;
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = TIMELINE_MAGIC;
+    w->hdr = h;
+    w->ring = base + TIMELINE_HEADER_SIZE;
+    w->seq = 0;
+    return true;
+}
+
+// Appends one record, evicting the oldest ones it needs the room of. False
+// for a payload too large to be worth a record (over a quarter of the ring)
+// or over the 16-bit size.
+inline bool TimelineAppend(TimelineWriter* w, uint16_t type, uint64_t ms, const void* payload, uint32_t size) {
+    TimelineFileHeader* h = w->hdr;
+    const uint32_t ringSize = h->ring_size;
+    const uint32_t total = TimelineRecordSize(size);
+    if (size > 0xFFFF || total > ringSize / 4) return false;
+
+    const uint64_t head = h->head.load(std::memory_order_relaxed);
+    uint64_t tail = h->tail.load(std::memory_order_relaxed);
+    if (head + total - tail > ringSize) {
+        while (head + total - tail > ringSize) {
+            TimelineRecord old;
+            TimelineRingCopyOut(w->ring, ringSize, tail, &old, sizeof(old));
+            tail += TimelineRecordSize(old.size);
+        }
+        // Readers must stop trusting the evicted bytes before they change.
+        h->tail.store(tail, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    TimelineRecord rec;
+    rec.type = type;
+    rec.size = (uint16_t)size;
+    rec.seq = w->seq++;
+    rec.ms = ms;
+    TimelineRingCopyIn(w->ring, ringSize, head, &rec, sizeof(rec));
+    if (size) TimelineRingCopyIn(w->ring, ringSize, head + TIMELINE_RECORD_HDR, payload, size);
+    h->records++;
+    if (type == TIMELINE_REC_KEYFRAME) h->keyframes++;
+    h->head.store(head + total, std::memory_order_release);
+    return true;
+}
+
+// ---- Staging (any thread) ---------------------------------------------------
+
+// Stages one event behind its ms. False when it was dropped (staging full,
+// or a payload over TIMELINE_STAGE_MAX).
+inline bool TimelineStage(SharedEvtBuffer* stage, uint16_t type, uint64_t ms, const void* payload, uint16_t size) {
+    if (size > TIMELINE_STAGE_MAX) return false;
+    uint8_t buf[sizeof(uint64_t) + TIMELINE_STAGE_MAX];
+    memcpy(buf, &ms, sizeof(ms));
+    if (size) memcpy(buf + sizeof(ms), payload, size);
+    return ShmEvtWrite(stage, type, buf, (uint16_t)(sizeof(ms) + size));
+}
+
+// Moves every staged event into the file, oldest first. Staging losses
+// become EVT_RESYNC records (u32 lost) stamped `nowMs` and are added to the
+// header's `dropped`. Returns the records written.
+inline uint32_t TimelineDrainStage(SharedEvtBuffer* stage, TimelineWriter* w, uint64_t nowMs) {
+    uint8_t buf[sizeof(uint64_t) + TIMELINE_STAGE_MAX];
+    uint16_t type = 0, size = 0;
+    uint32_t n = 0;
+    while (ShmEvtRead(stage, &type, buf, sizeof(buf), &size)) {
+        if (type == EVT_RESYNC) {
+            uint32_t lost = 0;
+            memcpy(&lost, buf, size < sizeof(lost) ? size : sizeof(lost));
+            w->hdr->dropped += lost;
+            n += TimelineAppend(w, EVT_RESYNC, nowMs, &lost, sizeof(lost)) ? 1 : 0;
+            continue;
+        }
+        if (size < sizeof(uint64_t) || size > sizeof(buf)) continue;
+        uint64_t ms;
+        memcpy(&ms, buf, sizeof(ms));
+        n += TimelineAppend(w, type, ms, buf + sizeof(ms), size - sizeof(ms)) ? 1 : 0;
+    }
+    return n;
+}
+
+// ---- Keyframes ----------------------------------------------------------------
+
+// One keyframe handed from the game thread to the writer. `full` is the
+// handoff: the game thread fills the slot only while it is 0 and then
+// stores 1; the writer copies it out and stores 0.
+struct TimelineKeySlot {
+    std::atomic<uint32_t> full;
+    uint32_t              size;
+    uint64_t              ms;
+    uint32_t              built;
+    uint32_t              skipped;  // keyframes not built because the slot was full
+    uint8_t               bytes[TIMELINE_KEY_MAX];
+};
+
+// Builds a keyframe payload in place: players, then units, then the
+// selection, in that order.
+struct TimelineKeyBuilder {
+    uint8_t*          out;
+    uint32_t          size;
+    TimelineKeyHeader hdr;
+};
+
+inline void TimelineKeyBegin(TimelineKeyBuilder* b, uint8_t* out, int32_t localSlot, uint64_t tick) {
+    b->out = out;
+    b->size = sizeof(TimelineKeyHeader);
+    memset(&b->hdr, 0, sizeof(b->hdr));
+    b->hdr.local_slot = localSlot;
+    b->hdr.tick = tick;
+}
+
+inline bool TimelineKeyAddPlayer(TimelineKeyBuilder* b, int32_t slot, float credits, int32_t tech, bool isHuman,
+                                 bool isLocal, const char* faction) {
+    if (b->hdr.players >= TIMELINE_KEY_PLAYERS || b->hdr.units || b->hdr.selected) return false;
+    TimelineKeyPlayer p;
+    memset(&p, 0, sizeof(p));
+    p.slot = slot;
+    p.credits = credits;
+    p.tech = tech;
+    p.is_human = isHuman ? 1 : 0;
+    p.is_local = isLocal ? 1 : 0;
+    if (faction) {
+        size_t n = 0;
+        for (; n < TIMELINE_KEY_FACTION - 1 && faction[n]; n++) p.faction[n] = faction[n];
+    }
+    memcpy(b->out + b->size, &p, sizeof(p));
+    b->size += sizeof(p);
+    b->hdr.players++;
+    return true;
+}
+
+// Counts the unit in units_walked either way; false once the keyframe is full.
+inline bool TimelineKeyAddUnit(TimelineKeyBuilder* b, uint64_t obj, uint32_t unitId, int32_t owner, float hull,
+                               float maxHull) {
+    b->hdr.units_walked++;
+    if (b->hdr.units >= TIMELINE_KEY_UNITS || b->hdr.selected) return false;
+    TimelineKeyUnit u;
+    u.obj = obj;
+    u.unit_id = unitId;
+    u.owner = owner;
+    u.hull = hull;
+    u.max_hull = maxHull;
+    memcpy(b->out + b->size, &u, sizeof(u));
+    b->size += sizeof(u);
+    b->hdr.units++;
+    return true;
+}
+
+inline void TimelineKeySetSelection(TimelineKeyBuilder* b, uint32_t seq, const uint64_t* objs, int count) {
+    if (b->hdr.selected) return;
+    const uint32_t n = count < 0 ? 0 : (uint32_t)count > TIMELINE_KEY_SELECTED ? TIMELINE_KEY_SELECTED : (uint32_t)count;
+    if (n) memcpy(b->out + b->size, objs, n * sizeof(uint64_t));
+    b->size += n * sizeof(uint64_t);
+    b->hdr.selected = n;
+    b->hdr.selection_seq = seq;
+}
+
+// Writes the header; returns the payload size.
+inline uint32_t TimelineKeyFinish(TimelineKeyBuilder* b) {
+    memcpy(b->out, &b->hdr, sizeof(b->hdr));
+    return b->size;
+}
+
+// Offsets of the row arrays in a keyframe payload. False when the counts
+// do not fit `size`.
+struct TimelineKeyLayout {
+    TimelineKeyHeader hdr;
+    uint32_t          players;   // byte offset of the first player row
+    uint32_t          units;
+    uint32_t          selected;
+};
+
+inline bool TimelineKeyParse(const uint8_t* p, uint32_t size, TimelineKeyLayout* out) {
+    if (size < sizeof(TimelineKeyHeader)) return false;
+    memcpy(&out->hdr, p, sizeof(out->hdr));
+    const TimelineKeyHeader& h = out->hdr;
+    if (h.players > TIMELINE_KEY_PLAYERS || h.units > TIMELINE_KEY_UNITS || h.selected > TIMELINE_KEY_SELECTED)
+        return false;
+    out->players = sizeof(TimelineKeyHeader);
+    out->units = out->players + h.players * (uint32_t)sizeof(TimelineKeyPlayer);
+    out->selected = out->units + h.units * (uint32_t)sizeof(TimelineKeyUnit);
+    return out->selected + h.selected * (uint32_t)sizeof(uint64_t) <= size;
+}
+
+// Writer side: moves a full slot into the file.
+inline bool TimelineTakeKeyframe(TimelineKeySlot* slot, TimelineWriter* w) {
+    if (!slot->full.load(std::memory_order_acquire)) return false;
+    const bool ok = TimelineAppend(w, TIMELINE_REC_KEYFRAME, slot->ms, slot->bytes, slot->size);
+    slot->full.store(0, std::memory_order_release);
+    return ok;
+}
+
+// ---- Reader ---------------------------------------------------------------------
+
+struct TimelineView {
+    const uint8_t* ring;
+    uint32_t       ring_size;
+    uint64_t       tail;
+    uint64_t       head;
+    uint64_t       records;
+    uint64_t       keyframes;
+    uint64_t       dropped;
+    uint64_t       created_ms;
+    uint32_t       pid;
+};
+
+// Validates a timeline file image. Returns nullptr, or why it is not one.
+inline const char* TimelineOpen(const uint8_t* bytes, uint64_t n, TimelineView* v) {
+    if (n < TIMELINE_HEADER_SIZE) return "file is smaller than the timeline header";
+    const TimelineFileHeader* h = reinterpret_cast<const TimelineFileHeader*>(bytes);
+    if (h->magic != TIMELINE_MAGIC) return "bad magic (not a timeline file)";
+    if (h->version != TIMELINE_VERSION || h->header_size != TIMELINE_HEADER_SIZE) return "unsupported timeline version";
+    if (!TimelineRingSizeValid(h->ring_size) || n < TIMELINE_HEADER_SIZE + (uint64_t)h->ring_size)
+        return "ring size does not match the file";
+    v->ring = bytes + TIMELINE_HEADER_SIZE;
+    v->ring_size = h->ring_size;
+    v->tail = h->tail.load(std::memory_order_acquire);
+    v->head = h->head.load(std::memory_order_acquire);
+    v->records = h->records;
+    v->keyframes = h->keyframes;
+    v->dropped = h->dropped;
+    v->created_ms = h->created_ms;
+    v->pid = h->pid;
+    if (v->head < v->tail || v->head - v->tail > v->ring_size) return "head and tail are inconsistent";
+    return nullptr;
+}
+
+// Calls fn(pos, record, payload) for each record in [tail, head), oldest
+// first, until fn returns false. Stops early at a record that does not fit
+// or breaks the seq chain (a live writer overwrote it). Returns the records
+// visited.
+template <typename Fn>
+inline uint32_t TimelineForEach(const TimelineView& v, uint64_t from, Fn&& fn) {
+    std::vector<uint8_t> payload;
+    uint32_t visited = 0;
+    bool first = true;
+    uint32_t expect = 0;
+    for (uint64_t pos = from < v.tail ? v.tail : from; pos + TIMELINE_RECORD_HDR <= v.head;) {
+        TimelineRecord rec;
+        TimelineRingCopyOut(v.ring, v.ring_size, pos, &rec, sizeof(rec));
+        const uint32_t total = TimelineRecordSize(rec.size);
+        if (pos + total > v.head || (!first && rec.seq != expect)) break;
+        first = false;
+        expect = rec.seq + 1;
+        payload.resize(rec.size);
+        if (rec.size) TimelineRingCopyOut(v.ring, v.ring_size, pos + TIMELINE_RECORD_HDR, payload.data(), rec.size);
+        visited++;
+        if (!fn(pos, rec, rec.size ? payload.data() : nullptr)) break;
+        pos += total;
+    }
+    return visited;
+}
@@ -0,0 +1,120 @@
+#pragma once
+// type_cache.h -- remembered Find_Object_Type answers for SWFOC_BatchTypeExists.
+//
+// The Spawn tab re-probes the whole on-disk catalog each time it opens, one
+// pcall per name, although the set of loaded types only changes when the
+// game loads something else. The bridge keeps every answer here, present
+// and absent alike, and serves repeat probes without entering Lua:
+//
+//   * Open addressing (linear probe) on a 64-bit FNV-1a hash of the name;
+//     names are copied into a private pool and compared on hit, so a hash
+//     collision can never report the wrong type.
+//   * The whole table is bound to a TypeCacheKey: the lua_State that did
+//     the probing, the live GameModeClass (a new one is built on every
+//     galactic / tactical transition) and a generation the bridge bumps on
+//     lua_open, lua_close and a changed SWFOC_GetCurrentMod answer.
+//     TypeCacheBind with a different key empties the table first.
+//   * When the slots or the name pool run out, further names are simply
+//     not stored; they keep going through Find_Object_Type.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge only probes from the game's main thread.
+
+#include <cstdint>
+#include <cstring>
+
+#define TYPE_CACHE_SLOTS     8192        // power of two
+#define TYPE_CACHE_MAX_NAMES 6144        // 3/4 load factor
+#define TYPE_CACHE_POOL      (192 * 1024)
+
+struct TypeCacheKey {
+    uint64_t state;  // lua_State*
+    uint64_t mode;   // GameModeClass*, 0 outside a loaded game
+    uint32_t gen;
+};
+
+struct TypeCache {
+    TypeCacheKey key;
+    bool         bound;
+    uint32_t     count;
+    uint32_t     poolUsed;
+    uint64_t     hash[TYPE_CACHE_SLOTS];     // 0 = empty slot
+    uint32_t     nameOff[TYPE_CACHE_SLOTS];
+    uint16_t     nameLen[TYPE_CACHE_SLOTS];
+    uint8_t      exists[TYPE_CACHE_SLOTS];
+    char         pool[TYPE_CACHE_POOL];
+    uint32_t     hits;
+    uint32_t     misses;
+    uint32_t     resets;
+};
+
+inline uint64_t TypeCacheHash(const char* name, size_t len) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)name[i];
+        h *= 1099511628211ull;
+    }
+    return h | 1;  // never 0, which marks an empty slot
+}
+
+inline void TypeCacheClear(TypeCache* c) {
+    memset(c->hash, 0, sizeof(c->hash));
+    c->count = 0;
+    c->poolUsed = 0;
+    c->bound = false;
+}
+
+// Binds the cache to `key`, emptying it when the key changed. Returns true
+// when the cached answers were dropped.
+inline bool TypeCacheBind(TypeCache* c, const TypeCacheKey& key) {
+    if (c->bound && c->key.state == key.state && c->key.mode == key.mode && c->key.gen == key.gen) return false;
+    const bool dropped = c->bound && c->count > 0;
+    TypeCacheClear(c);
+    c->key = key;
+    c->bound = true;
+    if (dropped) c->resets++;
+    return dropped;
+}
+
+// Returns the slot holding `name`, or the empty slot where it would go.
+inline uint32_t TypeCacheFind(const TypeCache* c, const char* name, size_t len, uint64_t h) {
+    uint32_t i = (uint32_t)(h >> 32) & (TYPE_CACHE_SLOTS - 1);
+    while (c->hash[i]) {
+        if (c->hash[i] == h && c->nameLen[i] == len && memcmp(c->pool + c->nameOff[i], name, len) == 0) break;
+        i = (i + 1) & (TYPE_CACHE_SLOTS - 1);
+    }
+    return i;
+}
+
+// 1 / 0 for a remembered answer, -1 when `name` has not been probed yet.
+inline int TypeCacheLookup(TypeCache* c, const char* name, size_t len) {
+    const uint64_t h = TypeCacheHash(name, len);
+    const uint32_t i = TypeCacheFind(c, name, len, h);
+    if (!c->hash[i]) {
+        c->misses++;
+        return -1;
+    }
+    c->hits++;
+    return c->exists[i];
+}
+
+// Remembers one Find_Object_Type answer. Returns false when the table or
+// the name pool is full (the answer is then just not cached).
+inline bool TypeCacheStore(TypeCache* c, const char* name, size_t len, bool exists) {
+    if (len > 0xFFFF) return false;
+    const uint64_t h = TypeCacheHash(name, len);
+    const uint32_t i = TypeCacheFind(c, name, len, h);
+    if (c->hash[i]) {
+        c->exists[i] = exists ? 1 : 0;
+        return true;
+    }
+    if (c->count >= TYPE_CACHE_MAX_NAMES || c->poolUsed + len > TYPE_CACHE_POOL) return false;
+    memcpy(c->pool + c->poolUsed, name, len);
+    c->hash[i] = h;
+    c->nameOff[i] = c->poolUsed;
+    c->nameLen[i] = (uint16_t)len;
+    c->exists[i] = exists ? 1 : 0;
+    c->poolUsed += (uint32_t)len;
+    c->count++;
+    return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+// type_census.h -- per-type object populations from one list walk.
+//
+// DumpState's object catalog used to run Find_All_Objects_Of_Type once per
+// catalog entry -- a full engine walk each -- and could only report 0/1 for
+// the tables it returned. The bridge instead walks the mode object list
+// once, buckets every object by its GameObjectType pointer here, and hashes
+// each distinct type's name once afterwards, so any number of per-type
+// counts are exact and cost that single walk:
+//
+//   * Open addressing (linear probe) on the type pointer; a census holds
+//     TYPE_CENSUS_SLOTS distinct types and counts anything past that in
+//     `dropped` instead of growing.
+//   * Names are matched on a case-folded FNV-1a hash (the engine's type
+//     lookups ignore case); the walker fills nameHash for every used slot.
+//   * `used` lists the occupied slots in first-seen order, so iterating a
+//     census never scans the empty slots.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge builds and reads it on the main thread.
+
+#include <cstdint>
+#include <cstring>
+
+#define TYPE_CENSUS_SLOTS 1024  // power of two
+
+struct TypeCensus {
+    uint64_t type[TYPE_CENSUS_SLOTS];      // 0 = empty
+    uint32_t count[TYPE_CENSUS_SLOTS];
+    uint64_t nameHash[TYPE_CENSUS_SLOTS];  // 0 = name not resolved
+    uint16_t used[TYPE_CENSUS_SLOTS];
+    uint32_t distinct;
+    uint32_t objects;
+    uint32_t dropped;                      // objects whose type did not fit
+};
+
+inline void TypeCensusReset(TypeCensus* c) {
+    memset(c->type, 0, sizeof(c->type));
+    c->distinct = 0;
+    c->objects = 0;
+    c->dropped = 0;
+}
+
+inline uint32_t TypeCensusSlot(uint64_t type) {
+    type >>= 4;
+    type ^= type >> 29;
+    type *= 0x9e3779b97f4a7c15ull;
+    return (uint32_t)(type >> 32) & (TYPE_CENSUS_SLOTS - 1);
+}
+
+// Counts one object of `type` (nonzero).
+inline void TypeCensusAdd(TypeCensus* c, uint64_t type) {
+    c->objects++;
+    uint32_t i = TypeCensusSlot(type);
+    while (c->type[i] && c->type[i] != type) i = (i + 1) & (TYPE_CENSUS_SLOTS - 1);
+    if (c->type[i] == type) {
+        c->count[i]++;
+        return;
+    }
+    if (c->distinct >= TYPE_CENSUS_SLOTS / 2) {  // keep probes short
+        c->dropped++;
+        return;
+    }
+    c->type[i] = type;
+    c->count[i] = 1;
+    c->nameHash[i] = 0;
+    c->used[c->distinct++] = (uint16_t)i;
+}
+
+inline uint64_t TypeCensusNameHash(const char* name, size_t len) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t ch = (uint8_t)name[i];
+        if (ch >= 'a' && ch <= 'z') ch = (uint8_t)(ch - 'a' + 'A');
+        h ^= ch;
+        h *= 1099511628211ull;
+    }
+    return h | 1;
+}
+
+// Population of every type whose name matches, case-insensitively.
+inline uint32_t TypeCensusCountByName(const TypeCensus* c, const char* name) {
+    const uint64_t h = TypeCensusNameHash(name, strlen(name));
+    uint32_t n = 0;
+    for (uint32_t k = 0; k < c->distinct; k++) {
+        const uint16_t i = c->used[k];
+        if (c->nameHash[i] == h) n += c->count[i];
+    }
+    return n;
+}
+
+// Writes up to `max` slot indices, largest population first (ties in
+// first-seen order), and returns how many were written.
+inline int TypeCensusTop(const TypeCensus* c, uint16_t* out, int max) {
+    int n = 0;
+    for (uint32_t k = 0; k < c->distinct; k++) {
+        const uint16_t i = c->used[k];
+        int pos = n < max ? n++ : max;
+        while (pos > 0 && c->count[out[pos - 1]] < c->count[i]) {
+            if (pos < max) out[pos] = out[pos - 1];
+            pos--;
+        }
+        if (pos < max) out[pos] = i;
+    }
+    return n;
+}
@@ -0,0 +1,96 @@
+#pragma once
+// unit_handles.h -- obj_addr -> engine GameObjectWrapper handle table.
+//
+// The engine-method wires (Heal / Teleport / Change_Owner /
+// Make_Invulnerable) take a unit Lua expression, and the overlay used to
+// pass Find_First_Object("<type>"): an engine-side search that picks
+// whichever instance of the type comes first. SWFOC_Unit(obj_addr, type)
+// resolves the exact object instead -- once, by matching the wrappers
+// Find_All_Objects_Of_Type returns against the address -- and this table
+// remembers which wrapper belongs to which address, so every later command
+// for that unit is one probe:
+//
+//   * Direct-mapped on a hash of obj_addr; a collision replaces the older
+//     binding. The wrapper itself lives in the Lua registry under the slot's
+//     key (UnitHandleRegistryKey), so replacing a binding also releases the
+//     old wrapper to the collector.
+//   * Every binding carries a generation, bumped whenever the slot is bound
+//     or dropped. A binding is only trusted while the wrapper still points
+//     at the same object and the object still has the same type (callers
+//     check with UnitHandleStillValid); otherwise it was a dead unit whose
+//     address got reused, the slot is dropped and the address re-resolved.
+//   * Bindings belong to one lua_State; UnitHandleDropState forgets a
+//     closed state's bindings.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Not thread-safe: the bridge only resolves on the game's main thread.
+
+#include <cstdint>
+#include <cstdio>
+
+#define UNIT_HANDLE_SLOTS 256  // power of two
+
+struct UnitHandleEntry {
+    uint64_t state;    // lua_State* the wrapper lives in, 0 = empty
+    uint64_t obj;      // GameObjectClass*
+    uint64_t wrapper;  // GameObjectWrapper* (its +0x60 points back at obj)
+    uint64_t type;     // obj's GameObjectType* when bound
+    uint32_t gen;
+};
+
+struct UnitHandleTable {
+    UnitHandleEntry entries[UNIT_HANDLE_SLOTS];
+    uint32_t        hits;
+    uint32_t        resolves;
+    uint32_t        stale;  // bindings dropped because the unit was gone
+};
+
+inline uint32_t UnitHandleSlot(uint64_t obj) {
+    obj >>= 4;
+    obj ^= obj >> 31;
+    obj *= 0x9e3779b97f4a7c15ull;
+    return (uint32_t)(obj >> 32) & (UNIT_HANDLE_SLOTS - 1);
+}
+
+// Registry key holding the wrapper bound in `slot` ("SWFOC.Unit.<slot>").
+inline void UnitHandleRegistryKey(uint32_t slot, char* out, size_t cap) {
+    snprintf(out, cap, "SWFOC.Unit.%u", slot);
+}
+
+// The binding for (state, obj), or nullptr.
+inline UnitHandleEntry* UnitHandleFind(UnitHandleTable* t, uint64_t state, uint64_t obj) {
+    UnitHandleEntry* e = &t->entries[UnitHandleSlot(obj)];
+    return (obj && e->state == state && e->obj == obj) ? e : nullptr;
+}
+
+// The wrapper still owns obj and obj's type did not change since binding.
+inline bool UnitHandleStillValid(const UnitHandleEntry* e, uint64_t wrapperObj, uint64_t objType) {
+    return wrapperObj == e->obj && objType == e->type;
+}
+
+// Binds obj's slot to a freshly resolved wrapper and returns the entry.
+inline UnitHandleEntry* UnitHandleBind(UnitHandleTable* t, uint64_t state, uint64_t obj, uint64_t wrapper,
+                                       uint64_t type) {
+    UnitHandleEntry* e = &t->entries[UnitHandleSlot(obj)];
+    e->state = state;
+    e->obj = obj;
+    e->wrapper = wrapper;
+    e->type = type;
+    e->gen++;
+    t->resolves++;
+    return e;
+}
+
+inline void UnitHandleDrop(UnitHandleEntry* e) {
+    e->state = 0;
+    e->obj = 0;
+    e->wrapper = 0;
+    e->gen++;
+}
+
+// Forgets every binding of a closed lua_State.
+inline void UnitHandleDropState(UnitHandleTable* t, uint64_t state) {
+    for (uint32_t i = 0; i < UNIT_HANDLE_SLOTS; i++) {
+        if (t->entries[i].state == state) UnitHandleDrop(&t->entries[i]);
+    }
+}
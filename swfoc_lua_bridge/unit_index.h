@@ -0,0 +1,95 @@
+#pragma once
+// unit_index.h -- one-walk index of the tactical unit list.
+//
+// SWFOC_EnumerateUnits walked the list twice (count, then emit), every
+// unit helper re-validated each object, and is_selected was a linear scan
+// of the selection per unit. The bridge now walks once per game tick into
+// a UnitIndex and answers the unit helpers from it:
+//
+//   * objs[] / owner[] hold the valid objects in walk order.
+//   * byOwner[] lists positions grouped by owner slot (counting sort,
+//     walk order kept inside a bucket); owners outside [0, UNIT_INDEX_SLOTS)
+//     share the last bucket.
+//   * sel[] is a small open-addressed set of the selected objects.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// The bridge owns the refresh policy (GetTacticalUnitIndex).
+
+#include <cstdint>
+#include <cstring>
+
+#define UNIT_INDEX_MAX      2048  // RVA::Selection::kMaxTacticalObjects
+#define UNIT_INDEX_SLOTS    16    // owner buckets; one more collects the rest
+#define UNIT_INDEX_SEL_HASH 256   // power of two, well above kMaxSelectionCount
+
+struct UnitIndex {
+    int      count;
+    uint64_t objs[UNIT_INDEX_MAX];
+    int32_t  owner[UNIT_INDEX_MAX];
+    uint16_t byOwner[UNIT_INDEX_MAX];
+    int      bucketStart[UNIT_INDEX_SLOTS + 2];  // bucket b = byOwner[start[b], start[b + 1])
+    uint64_t sel[UNIT_INDEX_SEL_HASH];           // 0 = empty
+    int      selCount;
+};
+
+inline int UnitIndexBucket(int32_t owner) {
+    return (owner >= 0 && owner < UNIT_INDEX_SLOTS) ? owner : UNIT_INDEX_SLOTS;
+}
+
+inline uint32_t UnitIndexSelHash(uint64_t obj) {
+    obj ^= obj >> 29;
+    obj *= 0xbf58476d1ce4e5b9ull;
+    obj ^= obj >> 32;
+    return (uint32_t)obj & (UNIT_INDEX_SEL_HASH - 1);
+}
+
+// objs/owners: `n` already-validated objects in walk order. sel: `selN`
+// selected objects (duplicates and zeros are ignored).
+inline void UnitIndexBuild(UnitIndex* idx, const uint64_t* objs, const int32_t* owners, int n,
+                           const uint64_t* sel, int selN) {
+    if (n < 0) n = 0;
+    if (n > UNIT_INDEX_MAX) n = UNIT_INDEX_MAX;
+    idx->count = n;
+    int sizes[UNIT_INDEX_SLOTS + 1] = {0};
+    for (int i = 0; i < n; i++) {
+        idx->objs[i] = objs[i];
+        idx->owner[i] = owners[i];
+        sizes[UnitIndexBucket(owners[i])]++;
+    }
+    idx->bucketStart[0] = 0;
+    for (int b = 0; b <= UNIT_INDEX_SLOTS; b++) idx->bucketStart[b + 1] = idx->bucketStart[b] + sizes[b];
+    int fill[UNIT_INDEX_SLOTS + 1];
+    for (int b = 0; b <= UNIT_INDEX_SLOTS; b++) fill[b] = idx->bucketStart[b];
+    for (int i = 0; i < n; i++) idx->byOwner[fill[UnitIndexBucket(owners[i])]++] = (uint16_t)i;
+
+    memset(idx->sel, 0, sizeof(idx->sel));
+    idx->selCount = 0;
+    for (int i = 0; i < selN && idx->selCount < UNIT_INDEX_SEL_HASH / 2; i++) {
+        if (!sel[i]) continue;
+        uint32_t h = UnitIndexSelHash(sel[i]);
+        while (idx->sel[h] && idx->sel[h] != sel[i]) h = (h + 1) & (UNIT_INDEX_SEL_HASH - 1);
+        if (!idx->sel[h]) { idx->sel[h] = sel[i]; idx->selCount++; }
+    }
+}
+
+inline bool UnitIndexIsSelected(const UnitIndex* idx, uint64_t obj) {
+    if (!obj || idx->selCount == 0) return false;
+    uint32_t h = UnitIndexSelHash(obj);
+    while (idx->sel[h]) {
+        if (idx->sel[h] == obj) return true;
+        h = (h + 1) & (UNIT_INDEX_SEL_HASH - 1);
+    }
+    return false;
+}
+
+// Units owned by `slot`; slots outside [0, UNIT_INDEX_SLOTS) have none.
+inline int UnitIndexOwnerCount(const UnitIndex* idx, int slot) {
+    if (slot < 0 || slot >= UNIT_INDEX_SLOTS) return 0;
+    return idx->bucketStart[slot + 1] - idx->bucketStart[slot];
+}
+
+// Positions into objs[] / owner[] for `slot`, UnitIndexOwnerCount long.
+inline const uint16_t* UnitIndexOwnerUnits(const UnitIndex* idx, int slot) {
+    if (slot < 0 || slot >= UNIT_INDEX_SLOTS) return idx->byOwner;
+    return idx->byOwner + idx->bucketStart[slot];
+}
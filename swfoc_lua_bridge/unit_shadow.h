@@ -0,0 +1,189 @@
+#pragma once
+// unit_shadow.h -- shadow copy of the tactical unit list for
+// SWFOC_EnumerateUnitsDelta.
+//
+// SWFOC_EnumerateUnits re-sends every row on every call, so an editor
+// refreshing its unit grid pays for hundreds of unchanged units. The bridge
+// keeps a shadow table keyed by obj_addr (hull, owner, invuln, prevent-death)
+// and a generation counter; a client passes the generation from its last
+// reply and gets only the rows added, changed or removed since then.
+//
+//   * One pass = UnitShadowBegin, UnitShadowObserve per walked unit,
+//     UnitShadowEnd. A pass that changes nothing keeps the generation, so
+//     an idle client keeps getting empty deltas.
+//   * Removed units stay as dead entries stamped with their removal
+//     generation until the table needs the room. Compacting them raises
+//     `floor`; a client whose generation is below the floor (or above the
+//     current one, e.g. from an earlier bridge session) gets a full reply.
+//   * Open addressing with linear probing over UNIT_SHADOW_SLOTS entries;
+//     compaction rebuilds the table, so there are no tombstones.
+//
+// Header-only and Win32-free so test_harness.cpp drives the real code.
+// Single-threaded: only the game's main thread runs Lua helpers.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#define UNIT_SHADOW_SLOTS    4096  // power of two
+#define UNIT_SHADOW_MAX_USED 3072  // 75% load cap, live + dead
+#define UNIT_SHADOW_MAX_DEAD 512   // compact once this many removals pile up
+
+struct UnitShadowEntry {
+    uint64_t addr;     // 0 = empty slot
+    float    hull;
+    int32_t  owner;
+    uint32_t changed;  // generation of the last add / change / removal
+    uint32_t seen;     // pass that last observed the unit
+    uint8_t  invuln;
+    uint8_t  pdb;
+    uint8_t  alive;
+};
+
+struct UnitShadow {
+    UnitShadowEntry entries[UNIT_SHADOW_SLOTS];
+    uint32_t gen;      // current generation
+    uint32_t floor;    // oldest generation deltas are exact from
+    uint32_t pass;     // pass counter for `seen`
+    uint32_t used;     // occupied slots (live + dead)
+    uint32_t dead;
+    bool     dirty;    // current pass changed something
+};
+
+struct UnitShadowRow {
+    uint64_t addr;
+    float    hull;
+    int32_t  owner;
+    uint8_t  invuln;
+    uint8_t  pdb;
+};
+
+inline uint32_t UnitShadowHash(uint64_t addr) {
+    addr ^= addr >> 33;
+    addr *= 0xff51afd7ed558ccdull;
+    addr ^= addr >> 33;
+    return (uint32_t)addr & (UNIT_SHADOW_SLOTS - 1);
+}
+
+// `base` seeds the generation so clients holding a generation from an
+// earlier session are unlikely to land inside [floor, gen].
+inline void UnitShadowInit(UnitShadow* sh, uint32_t base) {
+    memset(sh->entries, 0, sizeof(sh->entries));
+    sh->gen = base;
+    sh->floor = base;
+    sh->pass = 0;
+    sh->used = 0;
+    sh->dead = 0;
+    sh->dirty = false;
+}
+
+inline UnitShadowEntry* UnitShadowFind(UnitShadow* sh, uint64_t addr) {
+    uint32_t i = UnitShadowHash(addr);
+    for (uint32_t n = 0; n < UNIT_SHADOW_SLOTS; n++) {
+        UnitShadowEntry* e = &sh->entries[i];
+        if (e->addr == addr) return e;
+        if (e->addr == 0) return nullptr;
+        i = (i + 1) & (UNIT_SHADOW_SLOTS - 1);
+    }
+    return nullptr;
+}
+
+inline UnitShadowEntry* UnitShadowSlotFor(UnitShadow* sh, uint64_t addr) {
+    uint32_t i = UnitShadowHash(addr);
+    while (sh->entries[i].addr != 0 && sh->entries[i].addr != addr)
+        i = (i + 1) & (UNIT_SHADOW_SLOTS - 1);
+    return &sh->entries[i];
+}
+
+// Drops dead entries and rebuilds the table. Clients older than the
+// current generation lose their delta base and get a full reply next.
+inline bool UnitShadowCompact(UnitShadow* sh) {
+    UnitShadowEntry* keep = static_cast<UnitShadowEntry*>(
+        malloc(sizeof(UnitShadowEntry) * (sh->used ? sh->used : 1)));
+    if (!keep) return false;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < UNIT_SHADOW_SLOTS; i++) {
+        if (sh->entries[i].addr && sh->entries[i].alive) keep[n++] = sh->entries[i];
+    }
+    memset(sh->entries, 0, sizeof(sh->entries));
+    for (uint32_t i = 0; i < n; i++) *UnitShadowSlotFor(sh, keep[i].addr) = keep[i];
+    free(keep);
+    sh->used = n;
+    sh->dead = 0;
+    sh->floor = sh->gen;
+    return true;
+}
+
+inline void UnitShadowBegin(UnitShadow* sh) {
+    sh->pass++;
+    sh->dirty = false;
+}
+
+// Returns false when the unit did not fit (table full of live units).
+inline bool UnitShadowObserve(UnitShadow* sh, const UnitShadowRow& row) {
+    if (!row.addr) return false;
+    const uint32_t next = sh->gen + 1;
+    UnitShadowEntry* e = UnitShadowFind(sh, row.addr);
+    if (!e) {
+        if (sh->used >= UNIT_SHADOW_MAX_USED && !(sh->dead && UnitShadowCompact(sh))) return false;
+        if (sh->used >= UNIT_SHADOW_MAX_USED) return false;
+        e = UnitShadowSlotFor(sh, row.addr);
+        e->addr = row.addr;
+        e->alive = 0;
+        sh->used++;
+    } else if (!e->alive) {
+        sh->dead--;
+    }
+    if (!e->alive || e->hull != row.hull || e->owner != row.owner
+        || e->invuln != row.invuln || e->pdb != row.pdb) {
+        e->hull = row.hull;
+        e->owner = row.owner;
+        e->invuln = row.invuln;
+        e->pdb = row.pdb;
+        e->alive = 1;
+        e->changed = next;
+        sh->dirty = true;
+    }
+    e->seen = sh->pass;
+    return true;
+}
+
+// Marks units not observed this pass as removed and publishes the
+// generation. Returns the generation clients should send next time.
+inline uint32_t UnitShadowEnd(UnitShadow* sh) {
+    const uint32_t next = sh->gen + 1;
+    for (uint32_t i = 0; i < UNIT_SHADOW_SLOTS; i++) {
+        UnitShadowEntry* e = &sh->entries[i];
+        if (e->addr && e->alive && e->seen != sh->pass) {
+            e->alive = 0;
+            e->changed = next;
+            sh->dead++;
+            sh->dirty = true;
+        }
+    }
+    if (sh->dirty) sh->gen = next;
+    if (sh->dead > UNIT_SHADOW_MAX_DEAD) UnitShadowCompact(sh);
+    return sh->gen;
+}
+
+// True when `since` cannot be answered with a delta.
+inline bool UnitShadowNeedsFull(const UnitShadow* sh, uint32_t since) {
+    return since < sh->floor || since > sh->gen;
+}
+
+// Visits the rows a client at generation `since` needs: every live unit for
+// a full reply, else every entry changed after `since` (dead ones are
+// removals). visit(const UnitShadowEntry&) is called once per row.
+template <typename Visit>
+inline int UnitShadowForEachSince(const UnitShadow* sh, uint32_t since, Visit visit) {
+    const bool full = UnitShadowNeedsFull(sh, since);
+    int n = 0;
+    for (uint32_t i = 0; i < UNIT_SHADOW_SLOTS; i++) {
+        const UnitShadowEntry& e = sh->entries[i];
+        if (!e.addr) continue;
+        if (full ? !e.alive : e.changed <= since) continue;
+        visit(e);
+        n++;
+    }
+    return n;
+}
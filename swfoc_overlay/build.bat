@@ -20,22 +20,14 @@ REM Reuse the bridge's MinHook source. We compile our own .o files so the
 REM overlay DLL is fully self-contained at link time.
 set MH_SRC=../swfoc_lua_bridge/minhook/src
 
-echo [1/4] Compiling MinHook (shared with swfoc_lua_bridge)...
+echo [1/5] Compiling MinHook (shared with swfoc_lua_bridge)...
 "%GCC%" -c %CFLAGS% -I%MH_SRC% -I../swfoc_lua_bridge/minhook/include %MH_SRC%/hook.c -o hook.o
 "%GCC%" -c %CFLAGS% %MH_SRC%/buffer.c -o buffer.o
 "%GCC%" -c %CFLAGS% %MH_SRC%/trampoline.c -o trampoline.o
 "%GCC%" -c %CFLAGS% %MH_SRC%/hde/hde64.c -o hde64.o
 if errorlevel 1 goto fail
 
-echo [2/4] Compiling overlay sources...
-"%GPP%" -c %CPPFLAGS% overlay.cpp -o overlay.o
-"%GPP%" -c %CPPFLAGS% dllmain.cpp -o dllmain.o
-"%GPP%" -c %CPPFLAGS% hud_state.cpp -o hud_state.o
-REM iter 516: Phase 3 action-worker lifecycle (drain thread + ActionQueue).
-"%GPP%" -c %CPPFLAGS% overlay_action_worker.cpp -o overlay_action_worker.o
-if errorlevel 1 goto fail
-
-echo [3/4] Compiling ImGui v1.91.5 (vendored Phase 2-full)...
+echo [2/5] Compiling ImGui v1.91.5 (vendored Phase 2-full)...
 REM Iter 276: vendored Dear ImGui core + DX9 backend + Win32 backend.
 REM See knowledge-base/iter276_overlay_imgui_vendoring.md for the design doc.
 REM Compile units (6): core 4 + backends 2. Linked statically into swfoc_overlay.dll.
@@ -47,7 +39,31 @@ REM Compile units (6): core 4 + backends 2. Linked statically into swfoc_overlay
 "%GPP%" -c %CPPFLAGS% imgui/backends/imgui_impl_win32.cpp -o imgui_impl_win32.o
 if errorlevel 1 goto fail
 
-echo [4/4] Linking swfoc_overlay.dll...
+echo [3/5] Baking the font atlas...
+REM 2026-10-14: the overlay's font atlas is rasterised here, by the same
+REM ImGui objects the DLL links, instead of on the game's first Present
+REM (overlay_font_atlas.h). A failed bake is not fatal: the DLL is then built
+REM without -DSWFOC_BAKED_FONT_ATLAS and rasterises at runtime as before.
+set ATLAS_FLAG=
+"%GPP%" %CPPFLAGS% font_atlas_bake.cpp imgui_imgui.o imgui_draw.o imgui_widgets.o imgui_tables.o -o font_atlas_bake.exe -static
+if errorlevel 1 goto nobake
+".\font_atlas_bake.exe" overlay_font_atlas_blob.inc
+if errorlevel 1 goto nobake
+set ATLAS_FLAG=-DSWFOC_BAKED_FONT_ATLAS
+goto baked
+:nobake
+echo     font atlas bake failed; the DLL will build the atlas at runtime
+:baked
+
+echo [4/5] Compiling overlay sources...
+"%GPP%" -c %CPPFLAGS% %ATLAS_FLAG% overlay.cpp -o overlay.o
+"%GPP%" -c %CPPFLAGS% dllmain.cpp -o dllmain.o
+"%GPP%" -c %CPPFLAGS% hud_state.cpp -o hud_state.o
+REM iter 516: Phase 3 action-worker lifecycle (drain thread + ActionQueue).
+"%GPP%" -c %CPPFLAGS% overlay_action_worker.cpp -o overlay_action_worker.o
+if errorlevel 1 goto fail
+
+echo [5/5] Linking swfoc_overlay.dll...
 REM -ld3d9 brings in Direct3DCreate9 + the IDirect3D9 vtable.
 REM -lkernel32 -luser32 cover GetAsyncKeyState (hotkey), CreateFile/ReadFile/WriteFile (pipe).
 REM -limm32 needed by imgui_impl_win32 for IME (input method editor) support.
@@ -4,8 +4,9 @@ REM build_action_worker_test.bat — compile + run the overlay_action_worker.h t
 REM
 REM overlay_action_worker.h is header-only; it pulls in overlay_action_queue.h
 REM (std::deque + std::mutex + std::function) and <functional> — no Windows, no
-REM ImGui, no bridge, no <thread>. The test injects fake send / shouldStop /
-REM sleep callables so it needs no game and no pipe. Reuses the MinGW g++ that
+REM ImGui, no bridge. The test injects fake send / shouldStop / sleep
+REM callables so it needs no game and no pipe; one pin runs the loop on a
+REM <thread> to check that Enqueue() wakes the worker. Reuses the MinGW g++ that
 REM build.bat uses for the DLL.
 REM
 REM -static -pthread: ActionQueue uses std::mutex, so the test pulls libstdc++'s
@@ -0,0 +1,49 @@
+@echo off
+REM ============================================================================
+REM build_bridge_instance_test.bat — compile + run the
+REM overlay_bridge_instance.h test (2026-10-14, instance-scoped bridge names).
+REM
+REM overlay_bridge_instance.h is header-only and std-only — it pulls in
+REM <cstdint>, <cstring> and <string>. The test adds <cstdio>. No Windows, no
+REM ImGui, no bridge, no <thread>. Needs no game and no pipe. Reuses the MinGW
+REM g++ that build.bat uses for the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_bvh_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay bridge-instance unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === BRIDGE-INSTANCE TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_bridge_instance_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_bridge_instance_test.cpp -o overlay_bridge_instance_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_bridge_instance_test.exe...
+echo.
+".\overlay_bridge_instance_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === BRIDGE-INSTANCE TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === BRIDGE-INSTANCE TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === BRIDGE-INSTANCE TEST: FAILURES ===
+exit /b 1
+
+:end
@@ -0,0 +1,48 @@
+@echo off
+REM ============================================================================
+REM build_device_capture_test.bat — compile + run the
+REM overlay_device_capture.h test (2026-10-14, D3D9 vtable capture).
+REM
+REM overlay_device_capture.h is header-only and std-only — it pulls in
+REM <atomic> and <cstdint>. The test adds <cstdio> and <cstring>. No Windows,
+REM no ImGui, no bridge, no <thread>, no D3D9. Needs no game and no pipe. Reuses the MinGW g++ that build.bat uses for the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_bvh_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay device-capture unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === DEVICE-CAPTURE TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_device_capture_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_device_capture_test.cpp -o overlay_device_capture_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_device_capture_test.exe...
+echo.
+".\overlay_device_capture_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === DEVICE-CAPTURE TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === DEVICE-CAPTURE TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === DEVICE-CAPTURE TEST: FAILURES ===
+exit /b 1
+
+:end
@@ -0,0 +1,50 @@
+@echo off
+REM ============================================================================
+REM build_event_feed_test.bat — compile + run the
+REM overlay_event_feed.h test (2026-10-14, HUD counters from the event ring).
+REM
+REM overlay_event_feed.h is header-only and std-only — it pulls in <atomic>,
+REM <cstddef>, <cstdint> and <cstring>. The test adds <cstdio> and <memory>.
+REM No Windows, no ImGui, no bridge, no <thread>. Needs no game, no pipe and
+REM no shared-memory mapping. Reuses the MinGW g++ that build.bat uses for
+REM the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_aabb_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay event-feed kernel unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === EVENT-FEED TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_event_feed_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_event_feed_test.cpp -o overlay_event_feed_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_event_feed_test.exe...
+echo.
+".\overlay_event_feed_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === EVENT-FEED TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === EVENT-FEED TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === EVENT-FEED TEST: FAILURES ===
+exit /b 1
+
+:end
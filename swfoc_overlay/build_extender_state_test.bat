@@ -0,0 +1,49 @@
+@echo off
+REM ============================================================================
+REM build_extender_state_test.bat — compile + run the
+REM overlay_extender_state.h test (2026-10-14, extender toggle block).
+REM
+REM overlay_extender_state.h is header-only and std-only — <atomic>,
+REM <cstddef>, <cstdint>, <cstdio> and <string>. The test adds <cstring>. No
+REM Windows, no ImGui, no extender, no <thread>. Needs no game and no pipe.
+REM Reuses the MinGW g++ that build.bat uses for the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_table_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay extender-state reader unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === EXTENDER-STATE TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_extender_state_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_extender_state_test.cpp -o overlay_extender_state_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_extender_state_test.exe...
+echo.
+".\overlay_extender_state_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === EXTENDER-STATE TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === EXTENDER-STATE TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === EXTENDER-STATE TEST: FAILURES ===
+exit /b 1
+
+:end
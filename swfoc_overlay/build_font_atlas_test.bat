@@ -0,0 +1,49 @@
+@echo off
+REM ============================================================================
+REM build_font_atlas_test.bat — compile + run the
+REM overlay_font_atlas.h test (2026-10-14, baked font atlas).
+REM
+REM overlay_font_atlas.h is header-only and std-only — it pulls in
+REM <cstddef>, <cstdint>, <cstring> and <vector>. The test adds <cstdio>. No
+REM Windows, no ImGui, no bridge, no <thread>, no D3D9. Needs no game and no
+REM pipe. Reuses the MinGW g++ that build.bat uses for the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_bvh_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay font-atlas unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === FONT-ATLAS TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_font_atlas_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_font_atlas_test.cpp -o overlay_font_atlas_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_font_atlas_test.exe...
+echo.
+".\overlay_font_atlas_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === FONT-ATLAS TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === FONT-ATLAS TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === FONT-ATLAS TEST: FAILURES ===
+exit /b 1
+
+:end
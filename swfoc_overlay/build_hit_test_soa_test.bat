@@ -0,0 +1,51 @@
+@echo off
+REM ============================================================================
+REM build_hit_test_soa_test.bat — compile + run the
+REM overlay_hit_test_soa.h test (2026-10-14, SSE batch ray-vs-AABB kernel).
+REM
+REM overlay_hit_test_soa.h is header-only and std-only plus <emmintrin.h>
+REM (SSE2, the x86-64 baseline: no -m flag needed) — it pulls in
+REM overlay_unit_aabb.h, <cmath>, <cstdint>, <limits> and <vector>. The test
+REM adds <chrono> and <cstdio> and prints a scalar vs SIMD benchmark line. No
+REM Windows, no ImGui, no bridge, no <thread>. Needs no game and no pipe.
+REM Reuses the MinGW g++ that build.bat uses for the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_aabb_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay SIMD ray-vs-AABB kernel unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === HIT-TEST-SOA TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_hit_test_soa_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_hit_test_soa_test.cpp -o overlay_hit_test_soa_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_hit_test_soa_test.exe...
+echo.
+".\overlay_hit_test_soa_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === HIT-TEST-SOA TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === HIT-TEST-SOA TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === HIT-TEST-SOA TEST: FAILURES ===
+exit /b 1
+
+:end
@@ -0,0 +1,46 @@
+@echo off
+REM ============================================================================
+REM build_minimap_density_test.bat — compile + run the overlay_minimap_density.h
+REM test (2026-10-14).
+REM
+REM overlay_minimap_density.h is header-only and std-only (<cstdint>, <vector>);
+REM it #includes overlay_minimap.h (WorldToMinimap). No Windows, no ImGui, no
+REM D3D, no bridge. Needs no game and no pipe. Reuses the MinGW g++ that
+REM build.bat uses for the DLL.
+REM
+REM Mirrors build_minimap_test.bat — full compiler path via `where`, cwd pinned
+REM to this script's folder, test exe run by explicit relative path. CRLF line
+REM endings required (cmd.exe).
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay minimap density raster unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === MINIMAP DENSITY TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_minimap_density_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_minimap_density_test.cpp -o overlay_minimap_density_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_minimap_density_test.exe...
+echo.
+".\overlay_minimap_density_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === MINIMAP DENSITY TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === MINIMAP DENSITY TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === MINIMAP DENSITY TEST: FAILURES ===
+exit /b 1
+
+:end
@@ -0,0 +1,49 @@
+@echo off
+REM ============================================================================
+REM build_snapshot_buffer_test.bat — compile + run the
+REM overlay_snapshot_buffer.h test (2026-10-14, HUD snapshot triple buffer).
+REM
+REM overlay_snapshot_buffer.h is header-only and std-only — it pulls in
+REM <atomic>, <cstdint> and <utility>. The test adds <cstdio>, <string> and
+REM <thread> for its writer-thread race. No Windows, no ImGui, no bridge.
+REM Needs no game and no pipe. Reuses the MinGW g++ that build.bat uses for
+REM the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is required: the race section spawns a std::thread.
+REM
+REM Mirrors build_unit_aabb_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay snapshot-buffer kernel unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === SNAPSHOT-BUFFER TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_snapshot_buffer_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_snapshot_buffer_test.cpp -o overlay_snapshot_buffer_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_snapshot_buffer_test.exe...
+echo.
+".\overlay_snapshot_buffer_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === SNAPSHOT-BUFFER TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === SNAPSHOT-BUFFER TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === SNAPSHOT-BUFFER TEST: FAILURES ===
+exit /b 1
+
+:end
@@ -0,0 +1,49 @@
+@echo off
+REM ============================================================================
+REM build_unit_bvh_test.bat — compile + run the
+REM overlay_unit_bvh.h test (2026-10-14, unit BVH for click picking).
+REM
+REM overlay_unit_bvh.h is header-only and std-only — it pulls in
+REM overlay_hit_test.h, <algorithm>, <cstdint> and <vector>. The test adds
+REM <cstdio>. No Windows, no ImGui, no bridge, no <thread>. Needs no game and
+REM no pipe. Reuses the MinGW g++ that build.bat uses for the DLL.
+REM
+REM -static links libstdc++ / libwinpthread in so the test exe runs with no DLL
+REM on PATH. -pthread is carried for parity with the sibling overlay test
+REM scripts even though this test pulls in no threading runtime.
+REM
+REM Mirrors build_unit_aabb_test.bat — full compiler path via `where`, cwd
+REM pinned to this script's folder, test exe run by explicit relative path.
+REM ============================================================================
+cd /d "%~dp0"
+echo === Overlay unit-BVH picking unit test ===
+echo.
+
+set "GPP="
+for /f "delims=" %%i in ('where x86_64-w64-mingw32-g++ 2^>nul') do if not defined GPP set "GPP=%%i"
+if not defined GPP echo === UNIT-BVH TEST: x86_64-w64-mingw32-g++ not on PATH === & exit /b 1
+
+echo [1/2] Compiling overlay_unit_bvh_test.cpp...
+"%GPP%" -O2 -std=c++17 -Wall -Wextra -Werror -static -pthread overlay_unit_bvh_test.cpp -o overlay_unit_bvh_test.exe
+if errorlevel 1 goto buildfail
+
+echo [2/2] Running overlay_unit_bvh_test.exe...
+echo.
+".\overlay_unit_bvh_test.exe"
+if errorlevel 1 goto testfail
+
+echo.
+echo === UNIT-BVH TEST: ALL PASS ===
+goto end
+
+:buildfail
+echo.
+echo === UNIT-BVH TEST: BUILD FAILED ===
+exit /b 1
+
+:testfail
+echo.
+echo === UNIT-BVH TEST: FAILURES ===
+exit /b 1
+
+:end
@@ -18,9 +18,9 @@ namespace
     HMODULE g_self = nullptr;
     DWORD WINAPI BootstrapThread(LPVOID)
     {
-        // Allow the host process to fully initialize D3D9 before we hook.
-        // 1500 ms is a conservative cushion; the bridge DLL uses similar.
-        Sleep(1500);
+        // No startup delay: Install detours IDirect3D9::CreateDevice, which
+        // must land before the game creates its device, then watches for the
+        // Present/Reset install on this thread (overlay_device_capture.h).
         swfoc_overlay::Install();
         return 0;
     }
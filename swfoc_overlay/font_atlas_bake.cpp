@@ -0,0 +1,73 @@
+// =============================================================================
+// swfoc_overlay/font_atlas_bake.cpp — build-time font atlas baker
+// (2026-10-14).
+//
+// Builds the overlay's font atlas with the vendored ImGui exactly as the DLL
+// would at runtime (ConfigureOverlayFontAtlas), captures it and writes the
+// blob of overlay_font_atlas.h as a C array:
+//
+//   font_atlas_bake.exe overlay_font_atlas_blob.inc
+//
+// build.bat runs this before compiling overlay.cpp and adds
+// -DSWFOC_BAKED_FONT_ATLAS when it succeeds. The blob is checked back through
+// LoadBakedFontAtlas before it is written, so a blob the DLL would refuse
+// never ships.
+// =============================================================================
+
+#include "overlay_font_atlas_imgui.h"
+
+#include <cstdio>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: font_atlas_bake <out.inc>\n");
+        return 2;
+    }
+
+    ImFontAtlas atlas;
+    swfoc_overlay::ConfigureOverlayFontAtlas(&atlas);
+    unsigned char* pixels = nullptr;
+    int w = 0, h = 0;
+    atlas.GetTexDataAsAlpha8(&pixels, &w, &h);
+
+    swfoc_overlay::BakedFontAtlas baked;
+    if (!swfoc_overlay::CaptureBakedFontAtlas(&atlas, &baked))
+    {
+        std::fprintf(stderr, "font_atlas_bake: atlas build failed\n");
+        return 1;
+    }
+    const std::vector<uint8_t> blob = swfoc_overlay::SerializeBakedFontAtlas(baked);
+
+    ImFontAtlas check;
+    if (!swfoc_overlay::LoadBakedFontAtlas(&check, blob.data(), blob.size())
+        || check.Fonts[0]->Glyphs.Size != atlas.Fonts[0]->Glyphs.Size)
+    {
+        std::fprintf(stderr, "font_atlas_bake: blob does not load back\n");
+        return 1;
+    }
+
+    FILE* f = std::fopen(argv[1], "wb");
+    if (!f)
+    {
+        std::fprintf(stderr, "font_atlas_bake: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    std::fprintf(f, "// Generated by font_atlas_bake.exe (build.bat) for ImGui %s. Do not edit.\n"
+                    "// %dx%d Alpha8, %zu glyphs; see overlay_font_atlas.h for the layout.\n"
+                    "static const unsigned char kOverlayFontAtlasBlob[%zu] = {\n",
+                 IMGUI_VERSION, w, h, baked.glyphs.size(), blob.size());
+    for (size_t i = 0; i < blob.size(); i++)
+    {
+        std::fprintf(f, "%s0x%02x,", (i % 16 == 0) ? "    " : " ", blob[i]);
+        if (i % 16 == 15 || i + 1 == blob.size()) std::fputc('\n', f);
+    }
+    std::fprintf(f, "};\n");
+    std::fclose(f);
+
+    std::printf("font_atlas_bake: %dx%d atlas, %zu glyphs, %d px -> %zu byte blob\n",
+                w, h, baked.glyphs.size(), w * h, blob.size());
+    return 0;
+}
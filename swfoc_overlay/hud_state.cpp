@@ -3,23 +3,42 @@
 //
 // The worker pattern is deliberately simple:
 //   while (!shutdown):
-//     snap = build_snapshot_via_bridge()
-//     atomic_swap(snap_ptr, snap)
-//     sleep(refresh_ms)
+//     plan = PlanHudRefresh(visible)          // overlay_hud_refresh.h
+//     if plan has tiers:
+//       snap = build_snapshot_via_bridge(last, plan.tiers)
+//       publish(snap)
+//     sleep(plan.sleep_ms)
 //
-// We use a heap-allocated HudSnapshot and an std::atomic<HudSnapshot*>
-// for the swap. Reader copies the pointed-to value while holding a
-// mutex (HudSnapshot has std::string members so atomic struct-swap
-// isn't viable). The mutex is held only for the copy duration —
-// microseconds on the render thread.
+// Probes are split into a fast and a slow tier; fields of a tier not due on
+// this pass are carried forward from the last snapshot. Nothing is probed
+// while the overlay is hidden. Between passes the worker drains the bridge
+// event ring (overlay_event_feed.h) and moves the kill / death / unit
+// counters as deaths happen; the pipe reconciles them.
 //
-// The bridge probe is named-pipe-based: open \\.\pipe\swfoc_bridge,
-// send a Lua line, read a response. Phase 2 ships with the connection
-// + send-receive but the actual Lua queries that build the snapshot
-// are stubbed; a future iter (or live testing) wires them up.
+// Snapshots go through a SnapshotTripleBuffer (overlay_snapshot_buffer.h):
+// the worker publishes into its own slot, the render thread pins the
+// latest slot once per frame by reference. No mutex, no copy and no heap
+// allocation on the render thread.
+//
+// The bridge probe is named-pipe-based: a Lua line goes out over one of a
+// small pool of persistent "@persist" sessions on \\.\pipe\swfoc_bridge
+// (overlay_bridge_client.h), or a one-shot connection when none is usable.
+// Phase 2 ships with the connection + send-receive but the actual Lua queries
+// that build the snapshot are stubbed; a future iter (or live testing) wires
+// them up.
 // =============================================================================
 
 #include "hud_state.h"
+#include "overlay.h"  // IsVisible — the refresh scheduler suspends while hidden
+#include "overlay_bridge_batch.h"
+#include "overlay_bridge_instance.h"
+#include "overlay_bridge_client.h"
+#include "overlay_bridge_telemetry.h"
+#include "overlay_event_feed.h"
+#include "overlay_extender_state.h"
+#include "overlay_hud_refresh.h"
+#include "overlay_snapshot_buffer.h"
+#include "overlay_unit_table.h"
 
 #include <windows.h>
 
@@ -28,26 +47,61 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace
 {
-    // Bridge pipe name shared with powrprof.dll's named-pipe server.
-    constexpr const char* kBridgePipeName = R"(\\.\pipe\swfoc_bridge)";
-
-    // Refresh cadence — operator-perceptible at ~2 Hz, doesn't bombard
-    // the bridge during high-frequency game state.
-    constexpr DWORD kRefreshIntervalMs = 500;
+    // The bridge pipe and mappings, suffixed with the SWFOC_BRIDGE_INSTANCE
+    // tag powrprof.dll resolved in this same process
+    // (overlay_bridge_instance.h). Resolved once, on first use.
+    const swfoc_overlay::BridgeInstanceNames& BridgeNames()
+    {
+        static const swfoc_overlay::BridgeInstanceNames names = [] {
+            char env[64];
+            const DWORD n = GetEnvironmentVariableA(swfoc_overlay::kBridgeInstanceEnvVar, env, sizeof(env));
+            return swfoc_overlay::ResolveBridgeInstanceNames(n > 0 && n < sizeof(env) ? env : nullptr,
+                                                             GetCurrentProcessId());
+        }();
+        return names;
+    }
 
-    // Per-call timeout — generous because the bridge is in-process
-    // (powrprof.dll is loaded by StarWarsG.exe along with us).
+    // Per-call deadline on a pooled bridge session (connect, write and
+    // read) — generous because the bridge is in-process (powrprof.dll is
+    // loaded by StarWarsG.exe along with us). The one-shot fallback stays
+    // blocking.
     constexpr DWORD kProbeTimeoutMs = 250;
 
     // ---- Snapshot storage ----------------------------------------------------
-    // std::shared_ptr swapped under a mutex. Render side copies the
-    // shared_ptr (refcount bump only) then dereferences without holding
-    // the mutex.
-    std::mutex g_snap_mutex;
-    std::shared_ptr<swfoc_overlay::HudSnapshot> g_current_snap;
+    // Writer: the HUD worker (or SetHudSnapshotForTest while it is stopped).
+    // Reader: the render thread.
+    swfoc_overlay::SnapshotTripleBuffer<swfoc_overlay::HudSnapshot> g_snap_buffer;
+
+    // ---- Bridge event ring (overlay_event_feed.h) -----------------------------
+    // Mapped by StartHudWorker (retried by the worker until the bridge has
+    // created it); the worker is its only reader.
+    HANDLE g_evt_map = nullptr;
+    swfoc_overlay::BridgeEventRing* g_evt_ring = nullptr;
+
+    // Records drained per wake; a full 64 KB ring is ~2700 death records.
+    constexpr int kEventDrainMax = 4096;
+
+    // ---- Bridge unit table (overlay_unit_table.h) -----------------------------
+    // Mapped by the worker after the first "bin" reply (the bridge creates
+    // the table on its first bulk listing). Worker thread only, like the
+    // last published BVH it reuses while the table's seq has not moved.
+    HANDLE g_units_map = nullptr;
+    const swfoc_overlay::BridgeUnitTable* g_units_table = nullptr;
+    std::shared_ptr<const swfoc_overlay::UnitBvh> g_unit_bvh;
+    swfoc_overlay::UnitAabbSet g_unit_set;
+    std::shared_ptr<const swfoc_overlay::MinimapDensityRaster> g_minimap_density;
+    uint32_t g_unit_bvh_seq = 0;
+
+    // ---- Extender toggle block (overlay_extender_state.h) ---------------------
+    // Created by the native extender host on its first toggle for this
+    // process; the worker retries the open each pass until it exists and is
+    // the only reader.
+    HANDLE g_ext_map = nullptr;
+    const swfoc_overlay::ExtenderStateBlock* g_ext_block = nullptr;
 
     // ---- Worker thread -------------------------------------------------------
     std::thread g_worker;
@@ -64,72 +118,239 @@ namespace
     void PublishSnapshot(swfoc_overlay::HudSnapshot snap)
     {
         snap.generated_tick = GetTickCount64();
-        auto sp = std::make_shared<swfoc_overlay::HudSnapshot>(std::move(snap));
-        std::lock_guard<std::mutex> lg(g_snap_mutex);
-        g_current_snap = std::move(sp);
+        g_snap_buffer.Publish(std::move(snap));
     }
 
     // Bridge probe — round-trip a single Lua line. The DEFINITION now lives in
     // `namespace swfoc_overlay` below (declared in hud_state.h) so Phase 3's
     // action worker (overlay_action_worker.cpp) reuses the exact same blocking
     // pipe round-trip as its write-command BridgeSendFn — one implementation,
-    // no duplicated pipe code. This using-declaration keeps BuildSnapshot's
-    // ~10 call sites unqualified and untouched.
+    // no duplicated pipe code.
     using swfoc_overlay::BridgeProbe;
+    using swfoc_overlay::BridgeBatchProbe;
+    using swfoc_overlay::BridgeTelemetryProbe;
 
-    swfoc_overlay::HudSnapshot BuildSnapshot()
+    // 2026-10-14: the snapshot probes, in wire order. BuildSnapshot sends
+    // them as ONE "@batch" request (overlay_bridge_batch.h) so a refresh is a
+    // single pipe connection and a single main-thread drain pass; the
+    // credits / unit-count chunks resolve the local slot themselves so no
+    // probe depends on an earlier round-trip. A pre-batch bridge answers with
+    // a Lua syntax error; the worker then remembers that and falls back to
+    // one BridgeProbe per chunk (same chunks, same parsing).
+    enum HudProbe
     {
-        swfoc_overlay::HudSnapshot snap;
+        kProbeLocalPlayer = 0,
+        kProbeCredits,
+        kProbeAliveUnits,
+        kProbeScene,
+        kProbeDamageMult,
+        kProbeFireRateMult,
+        kProbeKills,
+        kProbeDeaths,
+        kProbeTotalUnits,
+        kProbeUnitBounds,
+        kProbeCount
+    };
 
-        std::string resp;
-        // 1) Reachability + local player slot via SWFOC_GetLocalPlayer.
-        if (BridgeProbe("return SWFOC_GetLocalPlayer()", resp))
+    const std::string kProbeChunks[kProbeCount] = {
+        "return SWFOC_GetLocalPlayer()",
+        "local s = SWFOC_GetLocalPlayer() if s and s >= 0 then return SWFOC_GetCredits(s) end",
+        "local s = SWFOC_GetLocalPlayer() if s and s >= 0 then return SWFOC_CountUnits(s) end",
+        "return SWFOC_GetCurrentScene()",
+        "return SWFOC_GetDamageMultiplierGlobal()",
+        "return SWFOC_GetFireRateMultiplierGlobal()",
+        "return SWFOC_GetPlayerKills()",
+        "return SWFOC_GetPlayerDeaths()",
+        "return SWFOC_GetTotalUnitsAlive()",
+        "return SWFOC_ListTacticalUnits(\"bin\")",
+    };
+
+    // 2026-10-14: refresh tier per probe (overlay_hud_refresh.h). Fast:
+    // values that move every second of a battle. Slow: the scene and the
+    // global multipliers, which change on a scene load or a command.
+    // ProbeTier moves the event-fed Lua probe to the slow tier.
+    const uint8_t kProbeTiers[kProbeCount] = {
+        swfoc_overlay::kHudTierFast,  // kProbeLocalPlayer
+        swfoc_overlay::kHudTierFast,  // kProbeCredits
+        swfoc_overlay::kHudTierFast,  // kProbeAliveUnits
+        swfoc_overlay::kHudTierSlow,  // kProbeScene
+        swfoc_overlay::kHudTierSlow,  // kProbeDamageMult
+        swfoc_overlay::kHudTierSlow,  // kProbeFireRateMult
+        swfoc_overlay::kHudTierFast,  // kProbeKills
+        swfoc_overlay::kHudTierFast,  // kProbeDeaths
+        swfoc_overlay::kHudTierFast,  // kProbeTotalUnits
+        swfoc_overlay::kHudTierFast,  // kProbeUnitBounds
+    };
+
+    // With a live event feed the local alive count moves on every death
+    // record, so its Lua probe only reconciles (the telemetry-answered
+    // counters stay fast: they cost no main-thread drain).
+    uint8_t ProbeTier(int probe, bool eventFeed)
+    {
+        if (eventFeed && probe == kProbeAliveUnits) return swfoc_overlay::kHudTierSlow;
+        return kProbeTiers[probe];
+    }
+
+    // Set once a batch request came back as a non-batch reply.
+    std::atomic<bool> g_batch_unsupported{false};
+
+    // 2026-10-14: probes the bridge's binary "@telemetry" record
+    // (overlay_bridge_telemetry.h) already covers. When it answers, only the
+    // remaining probes go through Lua; a pre-telemetry bridge answers with
+    // an ERR line and the worker goes back to the full probe list.
+    std::atomic<bool> g_telemetry_unsupported{false};
+    const bool kProbeInTelemetry[kProbeCount] = {
+        true,   // kProbeLocalPlayer
+        true,   // kProbeCredits
+        false,  // kProbeAliveUnits
+        false,  // kProbeScene
+        true,   // kProbeDamageMult
+        true,   // kProbeFireRateMult
+        true,   // kProbeKills
+        true,   // kProbeDeaths
+        true,   // kProbeTotalUnits
+        false,  // kProbeUnitBounds
+    };
+
+    // The probes of `tiers` still needed through Lua, in wire order.
+    int SelectProbes(uint8_t tiers, bool eventFeed, bool haveTelemetry, int* out)
+    {
+        int n = 0;
+        for (int p = 0; p < kProbeCount; ++p)
         {
-            snap.bridge_reachable = true;
-            // Response is integer slot number; parse permissively.
-            try { snap.local_player_slot = std::stoi(resp); }
-            catch (...) { /* leave as -1 */ }
+            if (!(ProbeTier(p, eventFeed) & tiers)) continue;
+            if (haveTelemetry && kProbeInTelemetry[p]) continue;
+            out[n++] = p;
         }
-        else
+        return n;
+    }
+
+    // Carries one probe's field over from the previous snapshot, for tiers
+    // this pass does not refresh.
+    void CarryProbe(swfoc_overlay::HudSnapshot& snap,
+                    const swfoc_overlay::HudSnapshot& prev, int probe)
+    {
+        switch (probe)
         {
-            snap.bridge_reachable = false;
-            snap.last_error = resp;
-            return snap;  // Skip remaining probes if pipe is dead.
+        case kProbeLocalPlayer:  snap.local_player_slot = prev.local_player_slot; break;
+        case kProbeCredits:      snap.credits = prev.credits; break;
+        case kProbeAliveUnits:   snap.alive_units = prev.alive_units; break;
+        case kProbeScene:        snap.scene_name = prev.scene_name; break;
+        case kProbeDamageMult:   snap.damage_mult = prev.damage_mult; break;
+        case kProbeFireRateMult: snap.firerate_mult = prev.firerate_mult; break;
+        case kProbeKills:        snap.local_kills = prev.local_kills; break;
+        case kProbeDeaths:       snap.local_deaths = prev.local_deaths; break;
+        case kProbeTotalUnits:   snap.total_units_in_play = prev.total_units_in_play; break;
+        case kProbeUnitBounds:
+            snap.unit_aabbs = prev.unit_aabbs;
+            snap.unit_bvh = prev.unit_bvh;
+            break;
+        default:                 break;
         }
+    }
 
-        // 2) Credits — SWFOC_GetCredits(slot).
-        if (snap.local_player_slot >= 0)
+    bool MapUnitTable()
+    {
+        if (g_units_table != nullptr) return true;
+        g_units_map = OpenFileMappingA(FILE_MAP_READ, FALSE, BridgeNames().units.c_str());
+        if (g_units_map == nullptr) return false;
+        g_units_table = static_cast<const swfoc_overlay::BridgeUnitTable*>(MapViewOfFile(
+            g_units_map, FILE_MAP_READ, 0, 0, sizeof(swfoc_overlay::BridgeUnitTable)));
+        if (g_units_table == nullptr)
         {
-            char lua[64];
-            std::snprintf(lua, sizeof(lua),
-                "return SWFOC_GetCredits(%d)", snap.local_player_slot);
-            if (BridgeProbe(lua, resp))
-            {
-                try { snap.credits = std::stoll(resp); }
-                catch (...) { /* leave as -1 */ }
-            }
+            CloseHandle(g_units_map);
+            g_units_map = nullptr;
+            return false;
         }
+        return true;
+    }
 
-        // 3) Alive units — SWFOC_CountUnits(slot) (placeholder helper name;
-        //    Phase 2 wiring will replace with the real catalog name).
-        if (snap.local_player_slot >= 0)
+    void UnmapUnitTable()
+    {
+        if (g_units_table != nullptr) UnmapViewOfFile(g_units_table);
+        if (g_units_map != nullptr) CloseHandle(g_units_map);
+        g_units_table = nullptr;
+        g_units_map = nullptr;
+        g_unit_bvh.reset();
+        swfoc_overlay::ClearUnitAabbSet(g_unit_set);
+        g_minimap_density.reset();
+        g_unit_bvh_seq = 0;
+    }
+
+    // 2026-10-14: "bin count=N seq=S bounds=B" from SWFOC_ListTacticalUnits.
+    // The boxes come out of the mapped table and the BVH is built here, on
+    // the worker, so the render thread only walks it. An unchanged seq
+    // reuses the last tree. An ERR reply (no tactical battle) or a table
+    // without bounds leaves both empty: a clean pick miss. The minimap
+    // density raster (overlay_minimap_density.h) comes from the same copy,
+    // so it too is rebuilt once per table seq and never per frame.
+    void ApplyUnitBounds(swfoc_overlay::HudSnapshot& snap, const std::string& resp)
+    {
+        swfoc_overlay::BridgeUnitReply reply;
+        if (!swfoc_overlay::ParseBridgeUnitReply(resp, reply) || reply.bounds == 0) return;
+        if (!g_unit_bvh || reply.seq != g_unit_bvh_seq)
         {
-            char lua[64];
-            std::snprintf(lua, sizeof(lua),
-                "return SWFOC_CountUnits(%d)", snap.local_player_slot);
-            if (BridgeProbe(lua, resp))
+            std::vector<swfoc_overlay::UnitAabb> units;
+            std::vector<uint8_t> flags;
+            if (!MapUnitTable() || !swfoc_overlay::ReadBridgeUnitBounds(*g_units_table, units, &flags))
             {
-                try { snap.alive_units = std::stoi(resp); }
-                catch (...) { /* leave as -1 */ }
+                return;
             }
+            auto bvh = std::make_shared<swfoc_overlay::UnitBvh>();
+            swfoc_overlay::BuildUnitBvh(*bvh, units);
+            // The flat set keeps the first kMaxRaycastUnits, in table order.
+            swfoc_overlay::ClearUnitAabbSet(g_unit_set);
+            for (const swfoc_overlay::UnitAabb& u : units)
+            {
+                if (!swfoc_overlay::AppendUnitAabb(g_unit_set, u.handle, u.box)) break;
+            }
+            std::vector<swfoc_overlay::MinimapUnitDot> dots;
+            dots.reserve(units.size());
+            for (size_t i = 0; i < units.size(); ++i)
+            {
+                const swfoc_overlay::Aabb& b = units[i].box;
+                dots.push_back(swfoc_overlay::MinimapUnitDot{
+                    0.5f * (b.min.x + b.max.x), 0.5f * (b.min.y + b.max.y),
+                    (flags[i] & swfoc_overlay::kBridgeUnitLocalOwner) != 0 });
+            }
+            auto density = std::make_shared<swfoc_overlay::MinimapDensityRaster>();
+            swfoc_overlay::RasterizeMinimapDensity(dots, swfoc_overlay::kMinimapHalfExtent,
+                                                   reply.seq, *density);
+            g_unit_bvh = std::move(bvh);
+            g_minimap_density = std::move(density);
+            g_unit_bvh_seq = reply.seq;
         }
+        snap.unit_bvh = g_unit_bvh;
+        snap.unit_aabbs = g_unit_set;
+        snap.minimap_density = g_minimap_density;
+    }
 
-        // 4) Scene name — SWFOC_GetCurrentScene() returns either planet
-        //    name (galactic) or map name (tactical).
-        if (BridgeProbe("return SWFOC_GetCurrentScene()", resp))
+    // Fold one probe's text response into the snapshot. Parse failures leave
+    // the field at its sentinel so the render side shows a placeholder.
+    void ApplyProbe(swfoc_overlay::HudSnapshot& snap, int probe,
+                    const std::string& resp)
+    {
+        switch (probe)
         {
-            // Strip surrounding quotes if the bridge returned a quoted
-            // string literal.
+        case kProbeLocalPlayer:
+            // Response is integer slot number; parse permissively.
+            try { snap.local_player_slot = std::stoi(resp); }
+            catch (...) { /* leave as -1 */ }
+            break;
+        case kProbeCredits:
+            try { snap.credits = std::stoll(resp); }
+            catch (...) { /* leave as -1 */ }
+            break;
+        case kProbeAliveUnits:
+            // SWFOC_CountUnits(slot) (placeholder helper name; Phase 2
+            // wiring will replace with the real catalog name).
+            try { snap.alive_units = std::stoi(resp); }
+            catch (...) { /* leave as -1 */ }
+            break;
+        case kProbeScene:
+            // SWFOC_GetCurrentScene() returns either planet name
+            // (galactic) or map name (tactical). Strip surrounding quotes
+            // if the bridge returned a quoted string literal.
             if (resp.size() >= 2 && resp.front() == '"' && resp.back() == '"')
             {
                 snap.scene_name = resp.substr(1, resp.size() - 2);
@@ -138,39 +359,185 @@ namespace
             {
                 snap.scene_name = resp;
             }
+            break;
+        case kProbeDamageMult:
+            // 2026-05-08 (iter 281): Tier 2 damage-multiplier probe via
+            // iter-96 SWFOC_GetDamageMultiplierGlobal (LIVE getter pair).
+            // Bridge returns a stringified float (e.g. "2.0" or "1.0"); on
+            // parse failure the field stays at -1.0f sentinel and the
+            // render side falls back to TextDisabled placeholder.
+            try { snap.damage_mult = std::stof(resp); }
+            catch (...) { /* leave at -1.0f sentinel */ }
+            break;
+        case kProbeFireRateMult:
+            // 2026-05-08 (iter 282): Tier 2 fire-rate-multiplier probe via
+            // SWFOC_GetFireRateMultiplierGlobal — already LIVE in the bridge
+            // (iter-281's honest-defer was based on incomplete investigation).
+            try { snap.firerate_mult = std::stof(resp); }
+            catch (...) { /* leave at -1.0f sentinel */ }
+            break;
+        case kProbeKills:
+            // 2026-05-08 (iter 285): Tier 3 HUD counters NOW LIVE.
+            // Hook_DeathHandler maintains std::atomic<int> counters and
+            // SWFOC_GetTotalUnitsAlive walks Selection::kObjectListHead.
+            // Parse failures fall back to -1 sentinel which the render side
+            // displays as "—" or "n/a".
+            try { snap.local_kills = std::stoi(resp); }
+            catch (...) { /* leave at -1 sentinel */ }
+            break;
+        case kProbeDeaths:
+            try { snap.local_deaths = std::stoi(resp); }
+            catch (...) { /* leave at -1 sentinel */ }
+            break;
+        case kProbeTotalUnits:
+            try { snap.total_units_in_play = std::stoi(resp); }
+            catch (...) { /* leave at -1 sentinel */ }
+            break;
+        case kProbeUnitBounds:
+            ApplyUnitBounds(snap, resp);
+            break;
+        default:
+            break;
         }
+    }
 
-        // 5) 2026-05-08 (iter 281): Tier 2 damage-multiplier probe via
-        //    iter-96 SWFOC_GetDamageMultiplierGlobal (LIVE getter pair).
-        //    Resolves iter-279 honest-defer for the HUD's damage row.
-        //    Bridge returns a stringified float (e.g. "2.0" or "1.0"); on
-        //    parse failure the field stays at -1.0f sentinel and the
-        //    render side falls back to TextDisabled placeholder.
-        if (BridgeProbe("return SWFOC_GetDamageMultiplierGlobal()", resp))
+    // One "@telemetry" round-trip. Returns false when the pipe is dead
+    // (pipeDead set, snap carries the failure reason) or the bridge predates
+    // the directive (caller probes everything through Lua instead). `tick`
+    // receives the bridge's luaD_call tick for pause detection.
+    bool RunTelemetryProbe(swfoc_overlay::HudSnapshot& snap, bool& pipeDead,
+                           int64_t& tick)
+    {
+        pipeDead = false;
+        std::string resp;
+        if (!BridgeTelemetryProbe(resp))
         {
-            try { snap.damage_mult = std::stof(resp); }
-            catch (...) { /* leave at -1.0f sentinel */ }
+            pipeDead = true;
+            snap.last_error = resp;
+            return false;
         }
+        swfoc_overlay::BridgeTelemetry t;
+        if (!swfoc_overlay::ParseBridgeTelemetry(resp, t))
+        {
+            g_telemetry_unsupported.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        snap.local_player_slot = t.local_slot;
+        // Same sentinel as the Lua probe: no local player, no credits.
+        if (t.local_slot >= 0) snap.credits = static_cast<int64_t>(t.credits);
+        snap.damage_mult = t.damage_mult;
+        snap.firerate_mult = t.firerate_mult;
+        snap.local_kills = t.kills;
+        snap.local_deaths = t.deaths;
+        snap.total_units_in_play = t.units_alive;
+        tick = t.tick;
+        return true;
+    }
 
-        // 6) 2026-05-08 (iter 282): Tier 2 fire-rate-multiplier probe via
-        //    SWFOC_GetFireRateMultiplierGlobal — DISCOVERED to already be
-        //    LIVE in the bridge (lua_bridge.cpp:6794, registered in the
-        //    Lua table at line 7616). iter-281's honest-defer was based on
-        //    incomplete investigation — it checked iter-225's setter doc
-        //    but didn't grep for `Lua_GetFireRateMultiplierGlobal` in the
-        //    bridge, which would have shown the getter was already there.
-        //    iter-282 resolves the second Tier 2 honest-defer entirely by
-        //    just adding this probe call (no bridge work needed).
-        if (BridgeProbe("return SWFOC_GetFireRateMultiplierGlobal()", resp))
+    // One batched round-trip for `count` probes. Returns false when the pipe
+    // is dead (snap carries the failure reason) or the bridge predates
+    // "@batch" (caller falls back to per-probe round-trips).
+    bool RunBatchedProbes(swfoc_overlay::HudSnapshot& snap, const int* probes,
+                          int count, bool& pipeDead)
+    {
+        pipeDead = false;
+        std::string chunks[kProbeCount];
+        for (int i = 0; i < count; ++i)
         {
-            try { snap.firerate_mult = std::stof(resp); }
-            catch (...) { /* leave at -1.0f sentinel */ }
+            chunks[i] = kProbeChunks[probes[i]];
         }
+        std::string request;
+        std::string resp;
+        swfoc_overlay::BuildBridgeBatchRequest(chunks, count, request);
+        if (!BridgeBatchProbe(request, resp))
+        {
+            pipeDead = true;
+            snap.last_error = resp;
+            return false;
+        }
+        swfoc_overlay::BridgeBatchResult results[kProbeCount];
+        if (!swfoc_overlay::ParseBridgeBatchReply(resp, count, results))
+        {
+            g_batch_unsupported.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            // ERR entries carry the Lua error text; leave the sentinel.
+            if (results[i].ok) ApplyProbe(snap, probes[i], results[i].payload);
+        }
+        return true;
+    }
 
-        // 7) 2026-05-08 (iter 284): Tier 3 — session elapsed seconds.
+    // No carried-forward values survive a dead pipe: the render side shows
+    // placeholders, not numbers from before the bridge went away.
+    swfoc_overlay::HudSnapshot UnreachableSnapshot(const std::string& error)
+    {
+        swfoc_overlay::HudSnapshot snap;
+        snap.bridge_reachable = false;
+        snap.last_error = error;
+        return snap;
+    }
+
+    // Refreshes the probes of `tiers` (overlay_hud_refresh.h) and carries
+    // the rest over from `prev`. A dead pipe yields a fresh unreachable
+    // snapshot, as before. `tick` receives the telemetry tick, 0 if none.
+    swfoc_overlay::HudSnapshot BuildSnapshot(const swfoc_overlay::HudSnapshot& prev,
+                                             uint8_t tiers, bool eventFeed, int64_t& tick)
+    {
+        swfoc_overlay::HudSnapshot snap;
+        tick = 0;
+        // The selection only ever arrives as EVT_SELECTION; no probe owns it.
+        snap.selection_seq = prev.selection_seq;
+        snap.selected_count = prev.selected_count;
+        snap.selected_unit = prev.selected_unit;
+        for (int p = 0; p < kProbeCount; ++p)
+        {
+            if (!(ProbeTier(p, eventFeed) & tiers)) CarryProbe(snap, prev, p);
+        }
+
+        // 1) Reachability + the binary telemetry record when the bridge
+        //    supports it and the fast tier is due, then the remaining probes
+        //    in one "@batch" request; otherwise one round-trip per probe,
+        //    skipping the rest if the pipe is dead.
+        bool haveTelemetry = false;
+        if ((tiers & swfoc_overlay::kHudTierFast)
+            && !g_telemetry_unsupported.load(std::memory_order_relaxed))
+        {
+            bool pipeDead = false;
+            haveTelemetry = RunTelemetryProbe(snap, pipeDead, tick);
+            if (pipeDead) return UnreachableSnapshot(snap.last_error);
+        }
+        int probes[kProbeCount];
+        const int probeCount = SelectProbes(tiers, eventFeed, haveTelemetry, probes);
+        bool batched = probeCount == 0;
+        if (!batched && !g_batch_unsupported.load(std::memory_order_relaxed))
+        {
+            bool pipeDead = false;
+            batched = RunBatchedProbes(snap, probes, probeCount, pipeDead);
+            if (pipeDead) return UnreachableSnapshot(snap.last_error);
+        }
+        snap.bridge_reachable = true;
+        if (!batched)
+        {
+            std::string resp;
+            for (int i = 0; i < probeCount; ++i)
+            {
+                if (BridgeProbe(kProbeChunks[probes[i]], resp))
+                {
+                    ApplyProbe(snap, probes[i], resp);
+                }
+                else if (!haveTelemetry && i == 0)
+                {
+                    // Skip remaining probes if pipe is dead.
+                    return UnreachableSnapshot(resp);
+                }
+            }
+        }
+
+        // 2) 2026-05-08 (iter 284): Tier 3 — session elapsed seconds.
         //    Local clock; no bridge wire needed. Seeded at first
-        //    successful bridge probe (iter-281 step #1 sets
-        //    bridge_reachable=true). Persistent across snapshot
+        //    successful bridge probe. Persistent across snapshot
         //    rotations — survives until DLL unload.
         if (snap.bridge_reachable)
         {
@@ -185,110 +552,417 @@ namespace
             }
         }
 
-        // 8) 2026-05-08 (iter 285): Tier 3 HUD counters NOW LIVE.
-        //    iter-284 honest-deferred kill/death/units-alive; iter-285
-        //    closed the defer by extending Hook_DeathHandler in the
-        //    bridge to maintain std::atomic<int> counters + adding a
-        //    SWFOC_GetTotalUnitsAlive Lua getter that walks
-        //    Selection::kObjectListHead. This worker just probes the 3
-        //    new wires; parse failures fall back to -1 sentinel which
-        //    the render side displays as "—" or "n/a".
-        if (BridgeProbe("return SWFOC_GetPlayerKills()", resp))
+        // 3) 2026-05-21 (iter 302): Phase 5 unit-AABB set. 2026-10-14: fed
+        //    by kProbeUnitBounds above (ApplyUnitBounds) from the bridge's
+        //    bulk unit table, with every bounded unit in snap.unit_bvh.
+
+        return snap;
+    }
+
+    bool MapEventFeed()
+    {
+        if (g_evt_ring != nullptr) return true;
+        g_evt_map = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE,
+                                     BridgeNames().events.c_str());
+        if (g_evt_map == nullptr) return false;
+        g_evt_ring = static_cast<swfoc_overlay::BridgeEventRing*>(MapViewOfFile(
+            g_evt_map, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(swfoc_overlay::BridgeEventRing)));
+        if (g_evt_ring == nullptr)
         {
-            try { snap.local_kills = std::stoi(resp); }
-            catch (...) { /* leave at -1 sentinel */ }
+            CloseHandle(g_evt_map);
+            g_evt_map = nullptr;
+            return false;
         }
-        if (BridgeProbe("return SWFOC_GetPlayerDeaths()", resp))
+        return true;
+    }
+
+    void UnmapEventFeed()
+    {
+        if (g_evt_ring != nullptr) UnmapViewOfFile(g_evt_ring);
+        if (g_evt_map != nullptr) CloseHandle(g_evt_map);
+        g_evt_ring = nullptr;
+        g_evt_map = nullptr;
+    }
+
+    // The bridge starts with its event stream off; SWFOC_EventControl(1)
+    // discards any backlog and turns it on. Retried on slow passes, so a
+    // stream someone else switched off comes back.
+    bool EnsureEventFeed()
+    {
+        if (!MapEventFeed()) return false;
+        if (swfoc_overlay::BridgeEventsEnabled(*g_evt_ring)) return true;
+        if (g_evt_ring->version != swfoc_overlay::kBridgeEventsVersion) return false;
+        std::string resp;
+        return BridgeProbe("return SWFOC_EventControl(1)", resp) && resp == "1"
+            && swfoc_overlay::BridgeEventsEnabled(*g_evt_ring);
+    }
+
+    void ApplyEventDeltas(swfoc_overlay::HudSnapshot& snap,
+                          const swfoc_overlay::BridgeEventDeltas& d)
+    {
+        swfoc_overlay::ApplyBridgeCounterDelta(snap.local_kills, d.kills);
+        swfoc_overlay::ApplyBridgeCounterDelta(snap.local_deaths, d.deaths);
+        swfoc_overlay::ApplyBridgeCounterDelta(snap.alive_units, d.local_alive);
+        swfoc_overlay::ApplyBridgeCounterDelta(snap.total_units_in_play, d.total_alive);
+        if (d.selection_changed)
         {
-            try { snap.local_deaths = std::stoi(resp); }
-            catch (...) { /* leave at -1 sentinel */ }
+            snap.selection_seq = d.selection_seq;
+            snap.selected_count = d.selection_count;
+            snap.selected_unit = d.selection_first;
         }
-        if (BridgeProbe("return SWFOC_GetTotalUnitsAlive()", resp))
+    }
+
+    bool MapExtenderState()
+    {
+        if (g_ext_block != nullptr) return true;
+        g_ext_map = OpenFileMappingA(FILE_MAP_READ, FALSE,
+                                     swfoc_overlay::ExtenderStateName(GetCurrentProcessId()).c_str());
+        if (g_ext_map == nullptr) return false;
+        g_ext_block = static_cast<const swfoc_overlay::ExtenderStateBlock*>(MapViewOfFile(
+            g_ext_map, FILE_MAP_READ, 0, 0, sizeof(swfoc_overlay::ExtenderStateBlock)));
+        if (g_ext_block == nullptr)
         {
-            try { snap.total_units_in_play = std::stoi(resp); }
-            catch (...) { /* leave at -1 sentinel */ }
+            CloseHandle(g_ext_map);
+            g_ext_map = nullptr;
+            return false;
         }
+        return true;
+    }
 
-        // 9) 2026-05-21 (iter 302): Phase 5 unit-AABB set — HONEST DEFER.
-        //    snap.unit_aabbs default-constructs EMPTY (count == 0) and the
-        //    worker leaves it so — there is deliberately no probe here. The
-        //    bridge exposes no per-unit world-AABB read wire: SWFOC_EnumerateUnits
-        //    returns handles only, and no SWFOC_GetUnitAabb-class getter exists
-        //    in lua_bridge.cpp (see the HudSnapshot::unit_aabbs comment in
-        //    hud_state.h). The iter 298-302 client-side-raycast kernel chain
-        //    (overlay_cursor_ray.h / overlay_hit_test.h / overlay_unit_aabb.h)
-        //    is built and test-pinned; this step starts appending the moment a
-        //    SWFOC_GetUnitAabb-class wire lands. An empty set is a safe
-        //    clean-miss for the raycast — never a phantom inspector hit.
+    void UnmapExtenderState()
+    {
+        if (g_ext_block != nullptr) UnmapViewOfFile(g_ext_block);
+        if (g_ext_map != nullptr) CloseHandle(g_ext_map);
+        g_ext_block = nullptr;
+        g_ext_map = nullptr;
+    }
 
-        return snap;
+    // Copies the extender block into `snap`; true when it changed. A torn
+    // or missing block keeps the last copy.
+    bool ApplyExtenderState(swfoc_overlay::HudSnapshot& snap)
+    {
+        if (!MapExtenderState()) return false;
+        swfoc_overlay::ExtenderState state = snap.extender;
+        if (!swfoc_overlay::ReadExtenderState(*g_ext_block, state)) return false;
+        const bool changed = state.writes != snap.extender.writes;
+        snap.extender = state;
+        return changed;
     }
 
     void WorkerLoop()
     {
+        swfoc_overlay::HudRefreshScheduler schedule;
+        swfoc_overlay::HudSnapshot last;
         while (!g_shutdown.load(std::memory_order_relaxed))
         {
-            // Build + publish.
-            PublishSnapshot(BuildSnapshot());
-            // Sleep in 50 ms slices so shutdown is responsive.
-            for (int i = 0; i < kRefreshIntervalMs / 50
-                && !g_shutdown.load(std::memory_order_relaxed); ++i)
+            // Drain first: deaths before this pass are then either in the
+            // carried-forward fields or overwritten by fresh pipe values.
+            bool countersMoved = false;
+            schedule.event_feed = g_evt_ring != nullptr
+                && swfoc_overlay::BridgeEventsEnabled(*g_evt_ring);
+            if (schedule.event_feed)
             {
-                Sleep(50);
+                swfoc_overlay::BridgeEventDeltas deltas;
+                swfoc_overlay::DrainBridgeEvents(*g_evt_ring, deltas, kEventDrainMax);
+                if (deltas.resync) swfoc_overlay::NoteHudEventResync(schedule);
+                ApplyEventDeltas(last, deltas);
+                countersMoved = deltas.kills || deltas.deaths
+                    || deltas.local_alive || deltas.total_alive
+                    || deltas.selection_changed;
             }
+            // A few loads from shared memory; read every pass.
+            if (ApplyExtenderState(last)) countersMoved = true;
+
+            const bool visible = swfoc_overlay::IsVisible();
+            const swfoc_overlay::HudRefreshPlan plan = swfoc_overlay::PlanHudRefresh(
+                schedule, GetTickCount64(), visible);
+            if (plan.tiers != swfoc_overlay::kHudTierNone)
+            {
+                if ((plan.tiers & swfoc_overlay::kHudTierSlow) && !schedule.event_feed)
+                {
+                    schedule.event_feed = EnsureEventFeed();
+                }
+                int64_t tick = 0;
+                const swfoc_overlay::ExtenderState extender = last.extender;
+                last = BuildSnapshot(last, plan.tiers, schedule.event_feed, tick);
+                last.extender = extender;  // not a probe; survives a dead pipe too
+                swfoc_overlay::NoteHudRefreshResult(schedule, last.bridge_reachable, tick);
+                PublishSnapshot(last);
+            }
+            else if (countersMoved && visible)
+            {
+                PublishSnapshot(last);
+            }
+            // At most kHudHiddenPollMs (kHudEventPollMs with a live event
+            // feed), so shutdown stays responsive.
+            Sleep(static_cast<DWORD>(plan.sleep_ms));
         }
     }
 }
 
 namespace swfoc_overlay
 {
+    namespace
+    {
+        // ---- Pooled persistent sessions (overlay_bridge_client.h) ----------
+        // Each slot is one "@persist" connection, opened overlapped in
+        // message read mode and held by whichever worker thread try-locks
+        // it first. A thread that finds every slot busy, a probe that
+        // cannot ride a newline-framed session, and a bridge that does not
+        // ack "@persist" all take the one-shot path below.
+        struct BridgePoolSlot
+        {
+            std::mutex lock;
+            HANDLE pipe = INVALID_HANDLE_VALUE;
+            HANDLE event = nullptr;  // manual-reset, for OVERLAPPED I/O
+            BridgeReconnectState reconnect;
+        };
+        BridgePoolSlot g_bridge_pool[kBridgePoolSize];
+
+        enum class PooledResult
+        {
+            Done,         // reply in `response`
+            Failed,       // request may have reached the bridge; do not resend
+            Unavailable,  // nothing sent; use the one-shot path
+        };
+
+        void ClosePoolSlot(BridgePoolSlot& slot)
+        {
+            if (slot.pipe != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(slot.pipe);
+                slot.pipe = INVALID_HANDLE_VALUE;
+            }
+        }
+
+        // Waits for an overlapped ReadFile / WriteFile until `deadline`.
+        // Returns ERROR_SUCCESS, ERROR_MORE_DATA (message only partly read),
+        // WAIT_TIMEOUT (I/O cancelled) or the failing error code.
+        DWORD AwaitPipeIo(HANDLE pipe, OVERLAPPED& ov, BOOL started,
+                          ULONGLONG deadline, DWORD& bytes)
+        {
+            bytes = 0;
+            if (!started)
+            {
+                const DWORD err = GetLastError();
+                if (err != ERROR_IO_PENDING) return err;
+                const ULONGLONG now = GetTickCount64();
+                const DWORD wait = now < deadline ? static_cast<DWORD>(deadline - now) : 0;
+                if (WaitForSingleObject(ov.hEvent, wait) != WAIT_OBJECT_0)
+                {
+                    CancelIo(pipe);
+                    GetOverlappedResult(pipe, &ov, &bytes, TRUE);
+                    return WAIT_TIMEOUT;
+                }
+            }
+            if (!GetOverlappedResult(pipe, &ov, &bytes, FALSE))
+            {
+                return GetLastError();
+            }
+            return ERROR_SUCCESS;
+        }
+
+        bool PooledWrite(BridgePoolSlot& slot, const std::string& payload,
+                         ULONGLONG deadline)
+        {
+            OVERLAPPED ov = {};
+            ov.hEvent = slot.event;
+            ResetEvent(slot.event);
+            BOOL ok = WriteFile(slot.pipe, payload.data(),
+                static_cast<DWORD>(payload.size()), nullptr, &ov);
+            DWORD written = 0;
+            return AwaitPipeIo(slot.pipe, ov, ok, deadline, written) == ERROR_SUCCESS
+                && written == payload.size();
+        }
+
+        // Reads until IsBridgeReplyComplete. The bridge writes each reply
+        // as one message, so this is normally a single ReadFile.
+        bool PooledRead(BridgePoolSlot& slot, BridgeReplyKind kind,
+                        std::string& response, ULONGLONG deadline)
+        {
+            response.clear();
+            char buf[4096];
+            while (!IsBridgeReplyComplete(kind, response))
+            {
+                OVERLAPPED ov = {};
+                ov.hEvent = slot.event;
+                ResetEvent(slot.event);
+                BOOL ok = ReadFile(slot.pipe, buf, sizeof(buf), nullptr, &ov);
+                DWORD got = 0;
+                const DWORD err = AwaitPipeIo(slot.pipe, ov, ok, deadline, got);
+                if (err != ERROR_SUCCESS && err != ERROR_MORE_DATA) return false;
+                response.append(buf, got);
+            }
+            return true;
+        }
+
+        // Opens and handshakes a session. Returns false (with backoff
+        // noted) when the pipe cannot be opened or the bridge is legacy.
+        bool OpenPoolSlot(BridgePoolSlot& slot, ULONGLONG deadline)
+        {
+            const ULONGLONG now = GetTickCount64();
+            if (!BridgeMayConnect(slot.reconnect, now)) return false;
+            if (slot.event == nullptr)
+            {
+                slot.event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+                if (slot.event == nullptr) return false;
+            }
+            slot.pipe = CreateFileA(
+                BridgeNames().pipe.c_str(),
+                GENERIC_READ | GENERIC_WRITE,
+                0,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_FLAG_OVERLAPPED,
+                nullptr);
+            if (slot.pipe == INVALID_HANDLE_VALUE)
+            {
+                BridgeNoteConnectFailure(slot.reconnect, now);
+                return false;
+            }
+            DWORD mode = PIPE_READMODE_MESSAGE;
+            SetNamedPipeHandleState(slot.pipe, &mode, nullptr, nullptr);
+
+            std::string ack;
+            if (!PooledWrite(slot, kBridgePersistRequest, deadline)
+                || !PooledRead(slot, BridgeReplyKind::Text, ack, deadline))
+            {
+                ClosePoolSlot(slot);
+                BridgeNoteConnectFailure(slot.reconnect, now);
+                return false;
+            }
+            if (ack != kBridgePersistAck)
+            {
+                ClosePoolSlot(slot);
+                BridgeNoteLegacyBridge(slot.reconnect, now);
+                return false;
+            }
+            BridgeNoteConnected(slot.reconnect);
+            return true;
+        }
+
+        PooledResult PooledRoundTrip(BridgePoolSlot& slot, const std::string& payload,
+                                     BridgeReplyKind kind, std::string& response)
+        {
+            const ULONGLONG deadline = GetTickCount64() + kProbeTimeoutMs;
+            bool fresh = false;
+            if (slot.pipe == INVALID_HANDLE_VALUE)
+            {
+                if (!OpenPoolSlot(slot, deadline)) return PooledResult::Unavailable;
+                fresh = true;
+            }
+            if (!PooledWrite(slot, payload, deadline))
+            {
+                // A session the bridge dropped while idle fails here before
+                // anything ran, so one reconnect-and-resend is safe.
+                ClosePoolSlot(slot);
+                if (fresh || !OpenPoolSlot(slot, deadline)) return PooledResult::Unavailable;
+                if (!PooledWrite(slot, payload, deadline))
+                {
+                    ClosePoolSlot(slot);
+                    return PooledResult::Unavailable;
+                }
+            }
+            if (!PooledRead(slot, kind, response, deadline))
+            {
+                // A late reply would answer the next request; drop the
+                // session and let the next call reconnect.
+                ClosePoolSlot(slot);
+                response = "(pipe read timed out)";
+                return PooledResult::Failed;
+            }
+            return PooledResult::Done;
+        }
+
+        // Legacy connect / write / read / close, read until the bridge
+        // disconnects so long replies are no longer cut at 1 KB.
+        bool OneShotRoundTrip(const std::string& payload, std::string& response)
+        {
+            response.clear();
+            HANDLE pipe = CreateFileA(
+                BridgeNames().pipe.c_str(),
+                GENERIC_READ | GENERIC_WRITE,
+                0,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+            if (pipe == INVALID_HANDLE_VALUE)
+            {
+                response = "(pipe open failed)";
+                return false;
+            }
+            DWORD mode = PIPE_READMODE_BYTE;
+            SetNamedPipeHandleState(pipe, &mode, nullptr, nullptr);
+
+            DWORD written = 0;
+            if (!WriteFile(pipe, payload.data(),
+                    static_cast<DWORD>(payload.size()), &written, nullptr))
+            {
+                CloseHandle(pipe);
+                response = "(pipe write failed)";
+                return false;
+            }
+            char buf[4096];
+            DWORD readBytes = 0;
+            BOOL ok = ReadFile(pipe, buf, sizeof(buf), &readBytes, nullptr);
+            if (ok) response.assign(buf, readBytes);
+            while (ok)
+            {
+                // The bridge disconnects after the reply; ReadFile then fails
+                // with ERROR_BROKEN_PIPE, which ends a complete read.
+                if (!ReadFile(pipe, buf, sizeof(buf), &readBytes, nullptr)
+                    || readBytes == 0)
+                {
+                    break;
+                }
+                response.append(buf, readBytes);
+            }
+            CloseHandle(pipe);
+            if (!ok)
+            {
+                response = "(pipe read failed)";
+                return false;
+            }
+            return true;
+        }
+
+        // Pooled session when one is free and the payload fits its
+        // framing, one-shot otherwise.
+        bool BridgeRoundTrip(const std::string& payload, std::string& response,
+                             BridgeReplyKind kind)
+        {
+            if (kind != BridgeReplyKind::Text || IsPersistableBridgeFrame(payload))
+            {
+                for (BridgePoolSlot& slot : g_bridge_pool)
+                {
+                    std::unique_lock<std::mutex> held(slot.lock, std::try_to_lock);
+                    if (!held.owns_lock()) continue;
+                    switch (PooledRoundTrip(slot, payload, kind, response))
+                    {
+                        case PooledResult::Done:        return true;
+                        case PooledResult::Failed:      return false;
+                        case PooledResult::Unavailable: break;
+                    }
+                    break;
+                }
+            }
+            return OneShotRoundTrip(payload, response);
+        }
+    }
+
     // Bridge primitive — round-trip a single Lua line through the
     // \\.\pipe\swfoc_bridge named pipe. Shared by the HUD read-probe worker
     // (BuildSnapshot, above) and the Phase 3 action worker
-    // (overlay_action_worker.cpp). BLOCKING: synchronous
-    // CreateFile / WriteFile / ReadFile — must run on a background worker
+    // (overlay_action_worker.cpp). BLOCKING: waits on pipe I/O (up to
+    // kProbeTimeoutMs on a pooled session) — must run on a background worker
     // thread, never the D3D9 render thread. Declared in hud_state.h.
     bool BridgeProbe(const std::string& lua, std::string& response)
     {
-        response.clear();
-        HANDLE pipe = CreateFileA(
-            kBridgePipeName,
-            GENERIC_READ | GENERIC_WRITE,
-            0,
-            nullptr,
-            OPEN_EXISTING,
-            FILE_ATTRIBUTE_NORMAL,
-            nullptr);
-        if (pipe == INVALID_HANDLE_VALUE)
-        {
-            response = "(pipe open failed)";
-            return false;
-        }
-        // Make sure we don't sit on a stalled pipe forever.
-        DWORD mode = PIPE_READMODE_BYTE;
-        SetNamedPipeHandleState(pipe, &mode, nullptr, nullptr);
-
-        const std::string line = lua + "\n";
-        DWORD written = 0;
-        if (!WriteFile(pipe, line.data(),
-                static_cast<DWORD>(line.size()), &written, nullptr))
+        if (!BridgeRoundTrip(lua + "\n", response, BridgeReplyKind::Text))
         {
-            CloseHandle(pipe);
-            response = "(pipe write failed)";
             return false;
         }
-        // Best-effort read with a small buffer.
-        char buf[1024];
-        DWORD readBytes = 0;
-        const BOOL ok = ReadFile(pipe, buf, sizeof(buf) - 1, &readBytes, nullptr);
-        CloseHandle(pipe);
-        if (!ok)
-        {
-            response = "(pipe read failed)";
-            return false;
-        }
-        buf[readBytes] = '\0';
-        response.assign(buf, readBytes);
         // Strip trailing newline if present.
         while (!response.empty()
             && (response.back() == '\n' || response.back() == '\r'))
@@ -298,10 +972,28 @@ namespace swfoc_overlay
         return true;
     }
 
+    // Batch primitive — sends a prebuilt "@batch N" request
+    // (overlay_bridge_batch.h) and returns the raw framed reply. Same
+    // blocking contract as BridgeProbe. Declared in hud_state.h.
+    bool BridgeBatchProbe(const std::string& request, std::string& response)
+    {
+        return BridgeRoundTrip(request, response, BridgeReplyKind::Batch);
+    }
+
+    // Telemetry primitive — sends "@telemetry" and returns the raw binary
+    // record (overlay_bridge_telemetry.h). Same blocking contract as
+    // BridgeProbe. Declared in hud_state.h.
+    bool BridgeTelemetryProbe(std::string& response)
+    {
+        return BridgeRoundTrip(swfoc_overlay::kBridgeTelemetryRequest, response,
+                               BridgeReplyKind::Telemetry);
+    }
+
     void StartHudWorker()
     {
         if (g_worker.joinable()) return;  // Idempotent.
         g_shutdown.store(false);
+        MapEventFeed();  // the worker retries if the bridge is not up yet
         g_worker = std::thread(WorkerLoop);
     }
 
@@ -309,22 +1001,37 @@ namespace swfoc_overlay
     {
         g_shutdown.store(true);
         if (g_worker.joinable()) g_worker.join();
+        // The stream is left on: with no reader the ring fills and the
+        // bridge's hooks drop records at the cost of one compare each.
+        UnmapEventFeed();
+        UnmapUnitTable();
+        UnmapExtenderState();
+        // StopActionWorker runs first (overlay.cpp), so no thread is left
+        // inside a pooled session.
+        for (BridgePoolSlot& slot : g_bridge_pool)
+        {
+            std::lock_guard<std::mutex> held(slot.lock);
+            ClosePoolSlot(slot);
+            if (slot.event != nullptr)
+            {
+                CloseHandle(slot.event);
+                slot.event = nullptr;
+            }
+        }
     }
 
-    HudSnapshot GetHudSnapshot()
+    const HudSnapshot& AcquireHudSnapshot()
     {
-        std::shared_ptr<HudSnapshot> sp;
-        {
-            std::lock_guard<std::mutex> lg(g_snap_mutex);
-            sp = g_current_snap;
-        }
-        return sp ? *sp : HudSnapshot{};
+        return g_snap_buffer.Acquire();
+    }
+
+    const HudSnapshot& PinnedHudSnapshot()
+    {
+        return g_snap_buffer.Pinned();
     }
 
     void SetHudSnapshotForTest(const HudSnapshot& snap)
     {
-        auto sp = std::make_shared<HudSnapshot>(snap);
-        std::lock_guard<std::mutex> lg(g_snap_mutex);
-        g_current_snap = std::move(sp);
+        g_snap_buffer.Publish(snap);
     }
 }
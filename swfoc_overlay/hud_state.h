@@ -4,8 +4,10 @@
 // The overlay's render path reads a snapshot of HudState every frame; a
 // background worker polls the existing powrprof.dll bridge pipe (the
 // editor's ground truth) and refreshes HudState atomically. Render and
-// poll never block each other — the worker swaps a pre-built snapshot
-// into an std::atomic<HudSnapshot> pointer once per refresh tick.
+// poll never block each other — the worker publishes a pre-built snapshot
+// into a lock-free triple buffer once per refresh tick. Refresh ticks follow
+// overlay_hud_refresh.h: a fast and a slow probe tier, a full refresh when
+// the panel opens, and no probing at all while the overlay is hidden.
 //
 // Phase 2 fields are intentionally narrow: credits, unit count, current
 // planet/map name, and bridge-reachable flag. Phases 3-5 will extend
@@ -15,9 +17,13 @@
 #pragma once
 
 #include "overlay_unit_aabb.h"  // UnitAabbSet — the Phase 5 unit-AABB section
+#include "overlay_unit_bvh.h"   // UnitBvh — every unit's pick box, uncapped
+#include "overlay_minimap_density.h"  // MinimapDensityRaster — live minimap dots
+#include "overlay_extender_state.h"   // ExtenderState — the native extender's toggles
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace swfoc_overlay
@@ -93,17 +99,41 @@ namespace swfoc_overlay
         // stability commitment exactly as the iter-281 / iter-284 fields above
         // did — old readers walking the leading fields are untouched.
         //
-        // HONEST DEFER: the worker leaves this set EMPTY (count == 0). The
-        // bridge exposes no per-unit world-AABB read wire — SWFOC_EnumerateUnits
-        // (LIVE iter-104) returns handles, not bounding boxes, and no
-        // SWFOC_GetUnitAabb-class getter exists in lua_bridge.cpp. Populating
-        // it needs either a new bridge wire reading each GameObject's
-        // CollisionClass bounds or the engine's selection-raycast RVA —
-        // overlay-interactive.md honest-defer #2. The iter 298-302 client-side
-        // raycast kernel chain is fully built and unit-pinned; it goes live the
-        // moment that wire lands. An empty set makes PickUnitInSet /
-        // NearestUnitHit a clean miss — never a phantom inspector hit.
+        // 2026-10-14: the worker fills this from the bridge's bulk unit table
+        // (overlay_unit_table.h) — the first kMaxRaycastUnits bounded units,
+        // for callers still on the flat set. Picking goes through unit_bvh.
+        // Until the bridge can read engine positions (ReadUnitWorldBounds in
+        // lua_bridge.cpp) no row carries bounds and both stay empty — a clean
+        // miss, never a phantom inspector hit.
         UnitAabbSet unit_aabbs;
+
+        // 2026-10-14: every bounded unit in the battle, no 64 cap, in a BVH
+        // built on the HUD worker (overlay_unit_bvh.h). Immutable once
+        // published and shared between snapshots until the next unit-table
+        // read, so the triple-buffer copy is a refcount bump. Null until the
+        // first read; PickUnitInBvh(ray, *unit_bvh) resolves a click.
+        std::shared_ptr<const UnitBvh> unit_bvh;
+
+        // 2026-10-14: per-side unit-density image for the minimap, rasterized
+        // on the HUD worker from the same unit-table copy as unit_bvh and
+        // shared the same way. Its `generation` is the table seq; the render
+        // thread uploads it to one D3D9 texture only when that changes. Null
+        // while no unit carries bounds.
+        std::shared_ptr<const MinimapDensityRaster> minimap_density;
+
+        // 2026-10-14: the local player's engine selection, from the bridge's
+        // EVT_SELECTION records (overlay_event_feed.h) — published on change,
+        // never polled. selection_seq is the bridge's change counter (0 = no
+        // record yet); selected_unit is the first selected object, 0 = none.
+        uint32_t selection_seq = 0;
+        int selected_count = 0;
+        uint64_t selected_unit = 0;
+
+        // 2026-10-14: the native extender's toggles (credit lock, timer, fog,
+        // AI, unit cap, instant build), copied from its shared-memory block
+        // (overlay_extender_state.h) on every worker pass — no probe.
+        // extender.known == 0 while no extender has applied anything here.
+        ExtenderState extender;
     };
 
     // ---- Phase 2 worker control ----------------------------------------------
@@ -116,14 +146,21 @@ namespace swfoc_overlay
     void StopHudWorker();
 
     // ---- Render-side accessors -----------------------------------------------
-    // Returns a copy of the most recent snapshot. Render path calls
-    // this once per Present detour. Returns a default-constructed
-    // snapshot when the worker hasn't produced one yet.
-    HudSnapshot GetHudSnapshot();
+    // Pins the most recent snapshot for this frame and returns it by
+    // reference (overlay_snapshot_buffer.h triple buffer — no lock, no copy,
+    // no allocation). Render thread only, once per Present detour; the
+    // reference stays valid and unchanged until the next call. Returns a
+    // default-constructed snapshot when the worker hasn't produced one yet.
+    const HudSnapshot& AcquireHudSnapshot();
+
+    // Render thread only: the snapshot this frame's AcquireHudSnapshot
+    // pinned, for render helpers further down the same frame.
+    const HudSnapshot& PinnedHudSnapshot();
 
     // Test-only: synthesize a snapshot directly. Used by the harness so
     // we can verify the render path produces sensible output without
-    // running the full bridge worker thread.
+    // running the full bridge worker thread. Only while the worker is
+    // stopped — the snapshot buffer has a single writer.
     void SetHudSnapshotForTest(const HudSnapshot& snap);
 
     // ---- Bridge primitive (shared) -------------------------------------------
@@ -138,8 +175,23 @@ namespace swfoc_overlay
     // commands — both are the same blocking named-pipe round-trip, so they
     // share one implementation rather than duplicating the pipe code.
     //
-    // BLOCKING: performs synchronous CreateFile / WriteFile / ReadFile. Must be
-    // called only from a background worker thread, never the D3D9 render thread
-    // (that is the entire reason the action queue exists).
+    // The line rides a pooled persistent bridge session when one is free
+    // (overlay_bridge_client.h; reply read to its '\n', deadline
+    // kProbeTimeoutMs) and a one-shot connection otherwise.
+    //
+    // BLOCKING: waits on named-pipe I/O. Must be called only from a background
+    // worker thread, never the D3D9 render thread (that is the entire reason
+    // the action queue exists).
     bool BridgeProbe(const std::string& lua, std::string& response);
+
+    // Batched variant: sends a prebuilt "@batch N" request (see
+    // overlay_bridge_batch.h) on one connection and returns the raw
+    // length-prefixed reply, read until its last entry. Same
+    // BLOCKING contract as BridgeProbe.
+    bool BridgeBatchProbe(const std::string& request, std::string& response);
+
+    // Binary telemetry variant: sends "@telemetry" and returns the raw
+    // fixed-size record (see overlay_bridge_telemetry.h), read to its
+    // announced size. Same BLOCKING contract as BridgeProbe.
+    bool BridgeTelemetryProbe(std::string& response);
 }
@@ -1,9 +1,11 @@
 // =============================================================================
 // swfoc_overlay — D3D9 detour core (Phase 1 skeleton).
 //
-// Pattern is the standard "create a throwaway D3D9 device to harvest the
-// vtable, then MinHook the IDirect3DDevice9::Present slot in the host
-// process's vtable so every frame routes through us first." See:
+// Pattern: MinHook the IDirect3DDevice9::Present slot in the host process's
+// vtable so every frame routes through us first. The vtable comes from the
+// game's own device, caught through an IDirect3D9::CreateDevice detour; a
+// throwaway device is only the fallback for a device that predates the
+// detour (overlay_device_capture.h). See:
 // - https://github.com/rdbo/D3D9-Hook (reference implementation)
 // - swfoc_lua_bridge/lua_bridge.cpp (sibling project, same MinHook usage)
 //
@@ -20,8 +22,13 @@
 #include "overlay_phase3_catalog.h" // iter 527: Phase 3 per-widget capability badges
 #include "overlay_dragdrop.h"       // iter 529: Phase 4 drag-drop spawn kernel
 #include "overlay_minimap.h"        // iter 530: Phase 4 tactical minimap kernel
+#include "overlay_minimap_density.h" // live unit-density raster for the minimap
 #include "overlay_preview_ring.h"   // iter 531: Phase 4 drop-point preview ring
 #include "overlay_spawn_gate.h"     // iter 532: Phase 4 multi-player safety gate
+#include "overlay_frame_cache.h"    // retained frames + overlay frame times
+#include "overlay_device_capture.h" // CreateDevice capture, dummy-device fallback
+#include "overlay_hotkey_matrix.h"  // F1..F12 routing from the WndProc detour
+#include "overlay_pause_hotkey.h"   // F4 pause / resume
 
 #include <windows.h>
 #include <d3d9.h>
@@ -35,13 +42,26 @@
 // replace the minimal panel with a 4-row HUD strip rendered via ImGui
 // Tables + ProgressBar widgets consuming the HudSnapshot model unchanged.
 #include "imgui/imgui.h"
+#include "imgui/imgui_internal.h"  // GImGui->InputEventsQueue for the frame cache
 #include "imgui/backends/imgui_impl_dx9.h"
 #include "imgui/backends/imgui_impl_win32.h"
+#include "overlay_font_atlas_imgui.h"  // build-time font atlas (font_atlas_bake.cpp)
+#ifdef SWFOC_BAKED_FONT_ATLAS
+#include "overlay_font_atlas_blob.inc"  // kOverlayFontAtlasBlob, written by build.bat
+#endif
+
+// 2026-10-14: one hidden ImGui frame of the full panel right after init, so
+// the first F1 frame finds its windows, tables and draw-list buffers already
+// allocated. Build with -DSWFOC_OVERLAY_PREWARM=0 to skip it.
+#ifndef SWFOC_OVERLAY_PREWARM
+#define SWFOC_OVERLAY_PREWARM 1
+#endif
 
 #include <algorithm>  // iter 278: std::min for ProgressBar ratio clamps
 #include <atomic>
 #include <cstdio>
 #include <cstdlib>  // iter 520: std::strtoull for the Kill-button hex field
+#include <cstring>  // memcpy for the minimap density upload
 
 // imgui_impl_win32.h intentionally guards this declaration behind a '#if 0'
 // block to avoid forcing <windows.h> on every includer; the header instructs
@@ -61,31 +81,12 @@ namespace
     // every 600 frames (~10 sec at 60 fps) as proof-of-life.
     std::atomic<uint64_t> g_frameCount{0};
 
-    // ---- Hotkey monitor -----------------------------------------------------
-    // Phase 1 polls F1 from the bootstrap worker thread instead of detouring
-    // WndProc — simpler, safer, no risk of deadlocking the host's window
-    // message pump. Resolution: 100 ms tick.
-    std::atomic<bool> g_hotkeyShutdown{false};
-    HANDLE g_hotkeyThread = nullptr;
-
-    DWORD WINAPI HotkeyPollLoop(LPVOID)
-    {
-        SHORT prevState = 0;
-        while (!g_hotkeyShutdown.load(std::memory_order_relaxed))
-        {
-            const SHORT state = GetAsyncKeyState(VK_F1);
-            const bool downNow = (state & 0x8000) != 0;
-            const bool downPrev = (prevState & 0x8000) != 0;
-            if (downNow && !downPrev)
-            {
-                swfoc_overlay::ToggleVisible();
-                OutputDebugStringA("[swfoc_overlay] F1 toggled visibility\n");
-            }
-            prevState = state;
-            Sleep(100);
-        }
-        return 0;
-    }
+    // ---- Hotkeys ------------------------------------------------------------
+    // 2026-10-14: the F1..F12 matrix (overlay_hotkey_matrix.h) is routed
+    // from HookedWndProc as the key messages arrive; the Phase 1 thread that
+    // polled GetAsyncKeyState(VK_F1) every 100 ms is gone. Render/input
+    // thread only, like the rest of the WndProc path.
+    swfoc_overlay::PauseToggle g_pauseToggle;  // F4
 
     // ---- D3D9 Present detour ------------------------------------------------
     typedef HRESULT (WINAPI *PresentFn)(
@@ -93,8 +94,16 @@ namespace
     typedef HRESULT (WINAPI *ResetFn)(
         IDirect3DDevice9*, D3DPRESENT_PARAMETERS*);
 
+    typedef HRESULT (WINAPI *CreateDeviceFn)(
+        IDirect3D9*, UINT, D3DDEVTYPE, HWND, DWORD, D3DPRESENT_PARAMETERS*, IDirect3DDevice9**);
+
     PresentFn g_origPresent = nullptr;
     ResetFn g_origReset = nullptr;
+    CreateDeviceFn g_origCreateDevice = nullptr;
+
+    // DeviceHookSource of the Present/Reset install, None until one lands.
+    std::atomic<int> g_deviceHooked{0};
+    std::atomic<bool> g_captureShutdown{false};
 
     // ---- Host WndProc detour (iter 514) ------------------------------------
     // Phase 3 needs ImGui to receive mouse + keyboard input. We subclass the
@@ -115,6 +124,9 @@ namespace
     void RenderImGuiPanel();
     void RenderActionsWindow();
     void RenderActionToast();
+    void ReleaseMinimapTexture();
+    void RunHotkey(const swfoc_overlay::HotkeyBinding& binding);
+    extern swfoc_overlay::OverlayFrameCache g_frameCache;
 
     // ---- HUD support helpers (faction tinting) -----------------------------
     // 2026-04-28 (iter 103, master ralph loop): faction tinting on the
@@ -197,6 +209,9 @@ namespace
         if (g_imguiInitialized.load(std::memory_order_acquire))
         {
             ImGui_ImplDX9_InvalidateDeviceObjects();
+            ReleaseMinimapTexture();  // D3DPOOL_DEFAULT, must go before Reset
+            // The retained draw data points at the released font texture.
+            g_frameCache.have = false;
         }
         const HRESULT hr = g_origReset(dev, params);
         if (SUCCEEDED(hr) && g_imguiInitialized.load(std::memory_order_acquire))
@@ -226,6 +241,18 @@ namespace
             // so the game keeps receiving input the overlay does not need.
             ImGui_ImplWin32_WndProcHandler(hwnd, msg, wParam, lParam);
 
+            // Hotkeys first: an F-key the matrix intercepts never reaches
+            // the game, whether or not a widget has keyboard focus.
+            const bool keyDown = msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN;
+            if (keyDown || msg == WM_KEYUP || msg == WM_SYSKEYUP)
+            {
+                const swfoc_overlay::HotkeyRoute route = swfoc_overlay::RouteHotkeyMessage(
+                    static_cast<int>(wParam), keyDown, (lParam & (1 << 30)) != 0,
+                    g_visible.load(std::memory_order_relaxed));
+                if (route.fire) RunHotkey(*route.binding);
+                if (route.swallow) return 0;
+            }
+
             const ImGuiIO& io = ImGui::GetIO();
             if (swfoc_overlay::ShouldSwallowMessage(
                     msg,
@@ -250,17 +277,100 @@ namespace
         return CallWindowProcW(g_origWndProc, hwnd, msg, wParam, lParam);
     }
 
-    // ---- VTable harvesting --------------------------------------------------
-    // Spin up a hidden window + throwaway D3D9 device just long enough to
-    // read its vtable, capture Present/Reset slots, then tear down. The
-    // host's later D3D9 device calls will hit our detours.
-    void* HarvestVtableSlot(int slotIndex)
+    // ---- Device vtable capture ----------------------------------------------
+    // Present/Reset are detoured once, off whichever device reaches
+    // InstallDeviceHooks first: the game's own, through the CreateDevice
+    // detour, or the fallback throwaway device. The slots live in d3d9.dll's
+    // shared vtable, so either way every host device hits our detours.
+    bool InstallDeviceHooks(IDirect3DDevice9* dev, swfoc_overlay::DeviceHookSource source)
+    {
+        if (!dev || !swfoc_overlay::ClaimDeviceHook(g_deviceHooked, source)) return false;
+
+        void** vtable = *reinterpret_cast<void***>(dev);
+        void* presentSlot = vtable[swfoc_overlay::kD3D9SlotPresent];
+        void* resetSlot = vtable[swfoc_overlay::kD3D9SlotReset];
+        if (MH_CreateHook(presentSlot,
+                reinterpret_cast<LPVOID>(&HookedPresent),
+                reinterpret_cast<LPVOID*>(&g_origPresent)) != MH_OK)
+        {
+            OutputDebugStringA("[swfoc_overlay] MH_CreateHook(Present) failed\n");
+            swfoc_overlay::ReleaseDeviceHook(g_deviceHooked);
+            return false;
+        }
+        if (MH_CreateHook(resetSlot,
+                reinterpret_cast<LPVOID>(&HookedReset),
+                reinterpret_cast<LPVOID*>(&g_origReset)) != MH_OK)
+        {
+            OutputDebugStringA("[swfoc_overlay] MH_CreateHook(Reset) failed\n");
+            MH_RemoveHook(presentSlot);
+            swfoc_overlay::ReleaseDeviceHook(g_deviceHooked);
+            return false;
+        }
+        if (MH_EnableHook(presentSlot) != MH_OK || MH_EnableHook(resetSlot) != MH_OK)
+        {
+            OutputDebugStringA("[swfoc_overlay] MH_EnableHook(Present/Reset) failed\n");
+            MH_RemoveHook(resetSlot);
+            MH_RemoveHook(presentSlot);
+            swfoc_overlay::ReleaseDeviceHook(g_deviceHooked);
+            return false;
+        }
+
+        char msg[96];
+        std::snprintf(msg, sizeof(msg), "[swfoc_overlay] Present/Reset hooked from %s\n",
+            swfoc_overlay::DeviceHookSourceLabel(source));
+        OutputDebugStringA(msg);
+        return true;
+    }
+
+    HRESULT WINAPI HookedCreateDevice(IDirect3D9* self, UINT adapter, D3DDEVTYPE type,
+        HWND focus, DWORD flags, D3DPRESENT_PARAMETERS* params, IDirect3DDevice9** out)
+    {
+        const HRESULT hr = g_origCreateDevice(self, adapter, type, focus, flags, params, out);
+        const int none = static_cast<int>(swfoc_overlay::DeviceHookSource::None);
+        if (SUCCEEDED(hr) && out && *out && g_deviceHooked.load(std::memory_order_acquire) == none)
+        {
+            InstallDeviceHooks(*out, swfoc_overlay::DeviceHookSource::CreateDevice);
+        }
+        return hr;
+    }
+
+    // IDirect3D9::CreateDevice off a bare IDirect3D9: no window, no device.
+    bool HookCreateDevice()
     {
         IDirect3D9* d3d9 = Direct3DCreate9(D3D_SDK_VERSION);
         if (!d3d9)
         {
             OutputDebugStringA("[swfoc_overlay] Direct3DCreate9 failed\n");
-            return nullptr;
+            return false;
+        }
+        void* slot = (*reinterpret_cast<void***>(d3d9))[swfoc_overlay::kD3D9SlotCreateDevice];
+        d3d9->Release();
+
+        if (MH_CreateHook(slot,
+                reinterpret_cast<LPVOID>(&HookedCreateDevice),
+                reinterpret_cast<LPVOID*>(&g_origCreateDevice)) != MH_OK)
+        {
+            OutputDebugStringA("[swfoc_overlay] MH_CreateHook(CreateDevice) failed\n");
+            return false;
+        }
+        if (MH_EnableHook(slot) != MH_OK)
+        {
+            OutputDebugStringA("[swfoc_overlay] MH_EnableHook(CreateDevice) failed\n");
+            MH_RemoveHook(slot);
+            return false;
+        }
+        return true;
+    }
+
+    // Fallback: spin up a hidden window + one throwaway D3D9 device just long
+    // enough to install Present/Reset off its vtable, then tear down.
+    bool HookFromDummyDevice()
+    {
+        IDirect3D9* d3d9 = Direct3DCreate9(D3D_SDK_VERSION);
+        if (!d3d9)
+        {
+            OutputDebugStringA("[swfoc_overlay] Direct3DCreate9 failed\n");
+            return false;
         }
 
         WNDCLASSA wc{};
@@ -274,7 +384,7 @@ namespace
         if (!wnd)
         {
             d3d9->Release();
-            return nullptr;
+            return false;
         }
 
         D3DPRESENT_PARAMETERS pp{};
@@ -282,8 +392,12 @@ namespace
         pp.SwapEffect = D3DSWAPEFFECT_DISCARD;
         pp.hDeviceWindow = wnd;
 
+        // Straight to the original: the detour must not see this device.
+        void** d3d9Vtable = *reinterpret_cast<void***>(d3d9);
+        CreateDeviceFn create = g_origCreateDevice ? g_origCreateDevice
+            : reinterpret_cast<CreateDeviceFn>(d3d9Vtable[swfoc_overlay::kD3D9SlotCreateDevice]);
         IDirect3DDevice9* dev = nullptr;
-        HRESULT hr = d3d9->CreateDevice(
+        HRESULT hr = create(d3d9,
             D3DADAPTER_DEFAULT,
             D3DDEVTYPE_HAL,
             wnd,
@@ -291,11 +405,10 @@ namespace
             &pp,
             &dev);
 
-        void* slot = nullptr;
+        bool hooked = false;
         if (SUCCEEDED(hr) && dev)
         {
-            void** vtable = *reinterpret_cast<void***>(dev);
-            slot = vtable[slotIndex];
+            hooked = InstallDeviceHooks(dev, swfoc_overlay::DeviceHookSource::DummyDevice);
             dev->Release();
         }
         else
@@ -310,12 +423,54 @@ namespace
         DestroyWindow(wnd);
         UnregisterClassA(wc.lpszClassName, wc.hInstance);
         d3d9->Release();
-        return slot;
+        return hooked;
     }
 
-    // VTable indices (D3D9 contract — fixed across all SDK versions)
-    constexpr int kSlotReset = 16;
-    constexpr int kSlotPresent = 17;
+    BOOL CALLBACK FindHostWindowProc(HWND hwnd, LPARAM lp)
+    {
+        DWORD pid = 0;
+        GetWindowThreadProcessId(hwnd, &pid);
+        if (pid != GetCurrentProcessId() || !IsWindowVisible(hwnd) || GetWindow(hwnd, GW_OWNER))
+        {
+            return TRUE;
+        }
+        *reinterpret_cast<HWND*>(lp) = hwnd;
+        return FALSE;
+    }
+
+    // Watches for the Present/Reset install; falls back to the throwaway
+    // device once the game's window has outlived kDeviceCaptureGraceMs with
+    // no CreateDevice through the detour.
+    void WatchDeviceCapture()
+    {
+        DWORD windowSince = 0;
+        bool fallbackTried = false;
+        while (!g_captureShutdown.load(std::memory_order_relaxed))
+        {
+            HWND host = nullptr;
+            EnumWindows(FindHostWindowProc, reinterpret_cast<LPARAM>(&host));
+            if (host && windowSince == 0) windowSince = GetTickCount() | 1u;
+            const uint32_t upMs = host ? GetTickCount() - windowSince : 0;
+
+            const auto hooked = static_cast<swfoc_overlay::DeviceHookSource>(
+                g_deviceHooked.load(std::memory_order_acquire));
+            const swfoc_overlay::DeviceCaptureStep step =
+                swfoc_overlay::NextDeviceCaptureStep(hooked, host != nullptr, upMs);
+            if (step == swfoc_overlay::DeviceCaptureStep::Stop) return;
+            if (step == swfoc_overlay::DeviceCaptureStep::HookFromDummy)
+            {
+                if (fallbackTried)
+                {
+                    OutputDebugStringA("[swfoc_overlay] device capture failed\n");
+                    return;
+                }
+                fallbackTried = true;
+                HookFromDummyDevice();
+                continue;
+            }
+            Sleep(100);
+        }
+    }
 
     // ---- Phase 2-full ImGui plumbing (iter 277) -----------------------------
     // Lazy-init pattern: first Present_Detour call captures the device + HWND,
@@ -332,6 +487,50 @@ namespace
     // WndProc if interactivity is needed.
     std::atomic<bool> g_imguiInitialized{false};
     HWND g_imguiHwnd = nullptr;
+    IDirect3DDevice9* g_imguiDevice = nullptr;  // the device ImGui_ImplDX9 was bound to
+    bool g_imguiPrewarmPending = false;          // render thread only
+
+    // Retained frames (overlay_frame_cache.h): RenderImGuiPanel re-submits
+    // the last ImDrawData while its inputs are unchanged. Render thread only.
+    swfoc_overlay::OverlayFrameCache g_frameCache;
+    swfoc_overlay::OverlayFrameTimes g_frameTimes;
+
+    uint64_t ActionFrameStamp()
+    {
+        swfoc_overlay::ActionQueue& q = swfoc_overlay::ActionQueueInstance();
+        const swfoc_overlay::ActionProgress p = q.BulkProgress();
+        uint64_t stamp = q.AcquireResults().total;
+        stamp = stamp * 31 + p.group;
+        stamp = stamp * 31 + p.done;
+        stamp = stamp * 31 + p.failed;
+        return stamp;
+    }
+
+    void RecordOverlayPass(const LARGE_INTEGER& freq, const LARGE_INTEGER& start, bool rebuilt)
+    {
+        LARGE_INTEGER end;
+        QueryPerformanceCounter(&end);
+        swfoc_overlay::RecordOverlayFrameTime(
+            g_frameTimes,
+            static_cast<float>(end.QuadPart - start.QuadPart) * 1e6f
+                / static_cast<float>(freq.QuadPart),
+            rebuilt);
+    }
+
+    // The baked atlas when the DLL carries one ImGui accepts; otherwise the
+    // same fonts, rasterised by the backend's first NewFrame.
+    void LoadOverlayFonts(ImFontAtlas* atlas)
+    {
+#ifdef SWFOC_BAKED_FONT_ATLAS
+        if (swfoc_overlay::LoadBakedFontAtlas(atlas, kOverlayFontAtlasBlob, sizeof(kOverlayFontAtlasBlob)))
+        {
+            OutputDebugStringA("[swfoc_overlay] font atlas: baked\n");
+            return;
+        }
+        OutputDebugStringA("[swfoc_overlay] font atlas: baked blob refused, building at runtime\n");
+#endif
+        swfoc_overlay::ConfigureOverlayFontAtlas(atlas);
+    }
 
     void EnsureImGuiInit(IDirect3DDevice9* dev, HWND hwnd)
     {
@@ -364,6 +563,7 @@ namespace
         io.LogFilename = nullptr;  // Don't write imgui_log.txt either.
 
         ImGui::StyleColorsDark();
+        LoadOverlayFonts(io.Fonts);
 
         if (!ImGui_ImplWin32_Init(useHwnd))
         {
@@ -380,6 +580,7 @@ namespace
         }
 
         g_imguiHwnd = useHwnd;
+        g_imguiDevice = dev;
 
         // iter 514: subclass the host window so ImGui receives mouse +
         // keyboard input (Phase 3 interactive widgets). Installed before the
@@ -391,6 +592,7 @@ namespace
             useHwnd, GWLP_WNDPROC,
             reinterpret_cast<LONG_PTR>(&HookedWndProc)));
 
+        g_imguiPrewarmPending = SWFOC_OVERLAY_PREWARM != 0;
         g_imguiInitialized.store(true, std::memory_order_release);
         OutputDebugStringA(
             "[swfoc_overlay] ImGui Init OK (Phase 3 WndProc detour active)\n");
@@ -410,10 +612,12 @@ namespace
             g_origWndProc = nullptr;
         }
 
+        ReleaseMinimapTexture();
         ImGui_ImplDX9_Shutdown();
         ImGui_ImplWin32_Shutdown();
         ImGui::DestroyContext();
         g_imguiHwnd = nullptr;
+        g_imguiDevice = nullptr;
         g_imguiInitialized.store(false, std::memory_order_release);
         OutputDebugStringA("[swfoc_overlay] ImGui Shutdown OK\n");
     }
@@ -422,8 +626,44 @@ namespace
     {
         if (!g_imguiInitialized.load(std::memory_order_acquire)) return;
 
+        LARGE_INTEGER qpcFreq;
+        LARGE_INTEGER qpcStart;
+        QueryPerformanceFrequency(&qpcFreq);
+        QueryPerformanceCounter(&qpcStart);
+
+        // The backends only queue input events (duplicates filtered); the
+        // frame itself is rebuilt only when overlay_frame_cache.h says one
+        // of its inputs changed, otherwise last frame's draw data is
+        // re-submitted below.
         ImGui_ImplDX9_NewFrame();
         ImGui_ImplWin32_NewFrame();
+
+        swfoc_overlay::OverlayFrameInputs frameIn;
+        frameIn.visible = g_visible.load(std::memory_order_relaxed);
+        frameIn.snapshot_tick = swfoc_overlay::AcquireHudSnapshot().generated_tick;
+        frameIn.action_stamp = ActionFrameStamp();
+        RECT client{};
+        if (g_imguiHwnd && GetClientRect(g_imguiHwnd, &client))
+        {
+            frameIn.client_w = client.right - client.left;
+            frameIn.client_h = client.bottom - client.top;
+        }
+        frameIn.pending_events = GImGui->InputEventsQueue.Size;
+        frameIn.interacting = ImGui::IsAnyItemActive() || ImGui::GetIO().WantTextInput
+            || ImGui::GetDragDropPayload() != nullptr;
+
+        // The prewarm pass builds the visible panel once, on this (init)
+        // Present, and throws the frame away.
+        const bool prewarm = g_imguiPrewarmPending;
+        g_imguiPrewarmPending = false;
+
+        if (!prewarm && !swfoc_overlay::OverlayFrameNeedsRebuild(g_frameCache, frameIn))
+        {
+            ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+            RecordOverlayPass(qpcFreq, qpcStart, false);
+            return;
+        }
+
         ImGui::NewFrame();
 
         // Phase 2-full Tier 1 (iter 278): 4-row HUD strip rendered via ImGui
@@ -432,9 +672,11 @@ namespace
         // unchanged (iter-103 5-row layout: bridge LED, credits, alive
         // units, scene, last-error). Phase 2-full Tier 2 (iter 279) extends
         // with catalog rollup + multipliers + faction-tint consistency.
-        if (g_visible.load(std::memory_order_relaxed))
+        if (prewarm || g_visible.load(std::memory_order_relaxed))
         {
-            const auto snap = swfoc_overlay::GetHudSnapshot();
+            // Pinned once per frame; RenderActionsWindow reads the same
+            // snapshot through PinnedHudSnapshot(). No copy, no lock.
+            const swfoc_overlay::HudSnapshot& snap = swfoc_overlay::PinnedHudSnapshot();
 
             // Layout: bottom-right of back-buffer with 12px margin.
             // 5 rows + headers + footer ⇒ ~180px tall, 280px wide.
@@ -553,6 +795,14 @@ namespace
                     ImGui::TextDisabled("Scene: unknown");
                 }
 
+                // ----- Row 3b: native extender toggles (only once one is known) -----
+                // Straight from the extender's shared block; no probe behind it.
+                if (snap.extender.known != 0)
+                {
+                    const std::string toggles = swfoc_overlay::SummarizeExtenderState(snap.extender);
+                    ImGui::TextWrapped("Extender: %s", toggles.c_str());
+                }
+
                 // ----- Row 4: Last error (only shown when present) -----
                 if (!snap.last_error.empty())
                 {
@@ -644,6 +894,10 @@ namespace
                 ImGui::Separator();
                 ImGui::TextDisabled(
                     "F1 toggles | Phase 2-full @ iter 285 (Tier 3 complete)");
+                const swfoc_overlay::OverlayFrameTimeSummary ft =
+                    swfoc_overlay::SummarizeOverlayFrameTimes(g_frameTimes);
+                ImGui::TextDisabled("Overlay CPU %.2f ms avg / %.2f max, %d%% rebuilt",
+                                    ft.avg_us / 1000.0f, ft.max_us / 1000.0f, ft.rebuilt_pct);
             }
             ImGui::End();
 
@@ -663,8 +917,17 @@ namespace
             RenderActionsWindow();
         }
 
+        if (prewarm)
+        {
+            // Nothing was rendered, so there is no draw data to retain.
+            ImGui::EndFrame();
+            g_frameCache.have = false;
+            return;
+        }
+
         ImGui::Render();
         ImGui_ImplDX9_RenderDrawData(ImGui::GetDrawData());
+        RecordOverlayPass(qpcFreq, qpcStart, true);
     }
 
     // ---- Phase 3 (iter 512 / 514 / 516 / 520 / 521 / 524): interactive Actions ---
@@ -758,6 +1021,65 @@ namespace
         return instance;
     }
 
+    // ---- Minimap unit-density texture (2026-10-14) ------------------------
+    // One kMinimapDensitySize^2 A8R8G8B8 texture holding the HUD worker's
+    // latest MinimapDensityRaster (overlay_minimap_density.h). Re-filled only
+    // when the snapshot carries a new raster generation, so the minimap draws
+    // every live unit as one textured quad whatever the unit count. Dynamic
+    // D3DPOOL_DEFAULT (D3D9Ex devices refuse MANAGED), so HookedReset and
+    // ShutdownImGui release it; the next frame recreates and re-uploads.
+    // Render thread only.
+    IDirect3DTexture9* g_minimapTex = nullptr;
+    uint32_t g_minimapTexGen = 0;
+    bool g_minimapTexFilled = false;
+
+    void ReleaseMinimapTexture()
+    {
+        if (g_minimapTex) g_minimapTex->Release();
+        g_minimapTex = nullptr;
+        g_minimapTexFilled = false;
+    }
+
+    // The texture for `raster`, uploading it first when its generation is
+    // not the one already on the GPU. Null when the device refuses.
+    IDirect3DTexture9* MinimapDensityTexture(
+        const swfoc_overlay::MinimapDensityRaster& raster)
+    {
+        constexpr int kSize = swfoc_overlay::kMinimapDensitySize;
+        if (!g_imguiDevice ||
+            raster.pixels.size() != static_cast<size_t>(kSize) * kSize)
+        {
+            return nullptr;
+        }
+        if (g_minimapTexFilled && g_minimapTexGen == raster.generation)
+        {
+            return g_minimapTex;
+        }
+        if (!g_minimapTex &&
+            FAILED(g_imguiDevice->CreateTexture(kSize, kSize, 1,
+                D3DUSAGE_DYNAMIC, D3DFMT_A8R8G8B8, D3DPOOL_DEFAULT,
+                &g_minimapTex, nullptr)))
+        {
+            g_minimapTex = nullptr;
+            return nullptr;
+        }
+        D3DLOCKED_RECT lr{};
+        if (FAILED(g_minimapTex->LockRect(0, &lr, nullptr, D3DLOCK_DISCARD)))
+        {
+            return nullptr;
+        }
+        for (int row = 0; row < kSize; ++row)
+        {
+            std::memcpy(static_cast<uint8_t*>(lr.pBits) + row * lr.Pitch,
+                        raster.pixels.data() + static_cast<size_t>(row) * kSize,
+                        kSize * sizeof(uint32_t));
+        }
+        g_minimapTex->UnlockRect(0);
+        g_minimapTexGen = raster.generation;
+        g_minimapTexFilled = true;
+        return g_minimapTex;
+    }
+
     // Dispatch a Phase 3 action: enqueue it onto the background bridge worker
     // (ActionQueueInstance, drained off the render thread) AND record it in
     // the recent-actions history so the toolbar can re-fire it. Every Phase 3
@@ -771,6 +1093,25 @@ namespace
         RecentActionsInstance().Record(req);
     }
 
+    // A routed hotkey press. Rows without overlay glue yet (F3's confirm
+    // prompt, the F6..F8 camera bookmarks) are intercepted per the matrix
+    // but do nothing here.
+    void RunHotkey(const swfoc_overlay::HotkeyBinding& binding)
+    {
+        switch (binding.fkey)
+        {
+            case 1:
+                swfoc_overlay::ToggleVisible();
+                OutputDebugStringA("[swfoc_overlay] F1 toggled visibility\n");
+                break;
+            case swfoc_overlay::kPauseHotkeyFKey:
+                DispatchAction(g_pauseToggle.Toggle());
+                break;
+            default:
+                break;
+        }
+    }
+
     // Dispatch a Phase 4 drag-drop spawn: enqueue the SWFOC_SpawnUnitLua
     // command for `unitType` under `faction` at the resolved world `drop`, and
     // record the drop point in the minimap marker ring so RenderMinimap plots
@@ -865,6 +1206,31 @@ namespace
                     ImGui::TextWrapped("  -> %s", result.response.c_str());
                 }
                 break;
+            case swfoc_overlay::ActionStatus::Superseded:
+                ImGui::TextDisabled("SUPERSEDED: %s", result.label.c_str());
+                break;
+        }
+
+        // Per-request history (2026-10-14): the newest results, each tagged
+        // with the id Enqueue() returned, so a burst of clicks can be read
+        // back one by one. AcquireResults() pins the worker's last published
+        // ring without taking the queue mutex; this is its only reader.
+        const swfoc_overlay::ActionResultRing& ring =
+            swfoc_overlay::ActionQueueInstance().AcquireResults();
+        if (ring.Count() > 0 && ImGui::TreeNode("Results"))
+        {
+            for (std::size_t i = 0; i < ring.Count(); ++i)
+            {
+                const swfoc_overlay::ActionResult& r = ring.Newest(i);
+                const char* tag =
+                    r.status == swfoc_overlay::ActionStatus::Live   ? "LIVE" :
+                    r.status == swfoc_overlay::ActionStatus::Failed ? "FAILED" :
+                                                                      "SUPERSEDED";
+                ImGui::Text("#%llu %s: %s",
+                            static_cast<unsigned long long>(r.id), tag,
+                            r.label.c_str());
+            }
+            ImGui::TreePop();
         }
     }
 
@@ -1085,12 +1451,12 @@ namespace
     // recorded in MarkerRingInstance() and drawn here as a dot via
     // WorldToMinimap() — green when on-map, amber when clamped to an edge.
     //
-    // HONEST DEFER (overlay_minimap.h): live ENGINE-unit dots need HudSnapshot
-    // per-unit positions (spec iter-302, Phase 5) and a pinned heightmap RVA.
-    // Until then the dots plot the operator's OWN spawns — real data the
-    // overlay already has. The map is a flat 2D grid, not a textured quad
-    // (the spec sketched ImGui::Image, but with no heightmap there is no map
-    // texture to show — a draw-list grid is the working interim idiom).
+    // Live ENGINE units draw underneath as the HUD worker's density raster
+    // (HudSnapshot::minimap_density, overlay_minimap_density.h): one textured
+    // quad, re-uploaded only when the unit table moves, green for the local
+    // player's units and red for everyone else's. It stays empty until the
+    // bridge reads engine positions (ReadUnitWorldBounds). The terrain is
+    // still a flat 2D grid — no heightmap RVA is pinned (overlay_minimap.h).
     //
     // `spawnAllowed` is the iter-532 multi-player safety gate (spec iter-295):
     // when false the minimap still draws — including the operator's recent-
@@ -1106,6 +1472,7 @@ namespace
         ImGui::TextDisabled("Drag the Unit type combo onto the map to spawn.");
         ImGui::TextDisabled("Dots = your recent spawn drops");
         ImGui::TextDisabled("(green on-map, amber clamped to an edge).");
+        ImGui::TextDisabled("Shading = live units (green yours, red others).");
 
         ImGui::BeginChild("##minimap",
             ImVec2(swfoc_overlay::kMinimapSizePx,
@@ -1130,6 +1497,16 @@ namespace
         dl->AddLine(ImVec2(midX, mapMin.y), ImVec2(midX, mapMax.y),
                     IM_COL32(64, 72, 84, 255));
 
+        // Live engine units: the HUD worker's density raster, one quad.
+        const swfoc_overlay::HudSnapshot& snap = swfoc_overlay::PinnedHudSnapshot();
+        if (snap.minimap_density)
+        {
+            if (IDirect3DTexture9* tex = MinimapDensityTexture(*snap.minimap_density))
+            {
+                dl->AddImage((ImTextureID)(intptr_t)tex, mapMin, mapMax);
+            }
+        }
+
         // One dot per retained spawn marker, projected through WorldToMinimap.
         swfoc_overlay::SpawnMarkerRing& ring = MarkerRingInstance();
         for (std::size_t i = 0; i < ring.Count(); ++i)
@@ -1228,8 +1605,8 @@ namespace
             // RenderMinimap binds a drop target. The red badge in the Phase 4
             // section explains why. Mirrors the iter-120 LiveSkip pattern:
             // gated, not errored. (overlay_spawn_gate.h is the pure kernel.)
-            const swfoc_overlay::HudSnapshot spawnGateSnap =
-                swfoc_overlay::GetHudSnapshot();
+            const swfoc_overlay::HudSnapshot& spawnGateSnap =
+                swfoc_overlay::PinnedHudSnapshot();
             const swfoc_overlay::SpawnGateStatus spawnGate =
                 swfoc_overlay::EvaluateSpawnGate(
                     spawnGateSnap.local_player_slot);
@@ -1434,37 +1811,13 @@ namespace swfoc_overlay
             return;
         }
 
-        void* presentSlot = HarvestVtableSlot(kSlotPresent);
-        void* resetSlot = HarvestVtableSlot(kSlotReset);
-        if (!presentSlot || !resetSlot)
-        {
-            OutputDebugStringA("[swfoc_overlay] vtable harvest failed\n");
-            return;
-        }
-
-        if (MH_CreateHook(presentSlot,
-                reinterpret_cast<LPVOID>(&HookedPresent),
-                reinterpret_cast<LPVOID*>(&g_origPresent)) != MH_OK)
-        {
-            OutputDebugStringA("[swfoc_overlay] MH_CreateHook(Present) failed\n");
-            return;
-        }
-        if (MH_CreateHook(resetSlot,
-                reinterpret_cast<LPVOID>(&HookedReset),
-                reinterpret_cast<LPVOID*>(&g_origReset)) != MH_OK)
-        {
-            OutputDebugStringA("[swfoc_overlay] MH_CreateHook(Reset) failed\n");
-            return;
-        }
-        if (MH_EnableHook(MH_ALL_HOOKS) != MH_OK)
+        // Catch the game's own device as it is created. Without the
+        // CreateDevice detour only the fallback throwaway device is left.
+        if (!HookCreateDevice())
         {
-            OutputDebugStringA("[swfoc_overlay] MH_EnableHook(ALL) failed\n");
-            return;
+            OutputDebugStringA("[swfoc_overlay] CreateDevice capture unavailable\n");
         }
 
-        g_hotkeyShutdown.store(false);
-        g_hotkeyThread = CreateThread(nullptr, 0, HotkeyPollLoop, nullptr, 0, nullptr);
-
         // Phase 2: spawn the bridge-poll worker so HUD bars reflect
         // live bridge state rather than just the toggle.
         StartHudWorker();
@@ -1475,6 +1828,10 @@ namespace swfoc_overlay
         StartActionWorker();
 
         OutputDebugStringA("[swfoc_overlay] Install OK — F1 toggles visibility\n");
+
+        // Runs on the bootstrap thread until Present/Reset are hooked.
+        g_captureShutdown.store(false);
+        WatchDeviceCapture();
     }
 
     void Uninstall()
@@ -1491,13 +1848,7 @@ namespace swfoc_overlay
         // is still valid. Order is intentional: workers → ImGui → hooks.
         ShutdownImGui();
 
-        g_hotkeyShutdown.store(true);
-        if (g_hotkeyThread)
-        {
-            WaitForSingleObject(g_hotkeyThread, 1000);
-            CloseHandle(g_hotkeyThread);
-            g_hotkeyThread = nullptr;
-        }
+        g_captureShutdown.store(true);
         MH_DisableHook(MH_ALL_HOOKS);
         MH_Uninitialize();
         OutputDebugStringA("[swfoc_overlay] Uninstall OK\n");
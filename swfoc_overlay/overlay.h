@@ -7,7 +7,8 @@
 namespace swfoc_overlay
 {
     // Detours IDirect3DDevice9::Present (and friends) so we can paint over the
-    // game on every frame. Idempotent — calling twice is a no-op.
+    // game on every frame. Idempotent — calling twice is a no-op. Returns once
+    // Present is hooked (or capture gave up), so call it off the loader lock.
     void Install();
 
     // Reverses Install's hooks. Called from DLL_PROCESS_DETACH.
@@ -19,6 +19,25 @@
 // unit-testable with a fake send — no bridge, no game, no DLL. See
 // overlay_action_queue_test.cpp (build_action_queue_test.bat).
 //
+// 2026-10-14: a held hotkey or dragged control used to enqueue dozens of
+// set-style requests that drained one blocking round-trip each. Requests now
+// carry an optional coalescing key (last writer wins while still pending),
+// and Drain() sends whatever is left as one "@batch N" call
+// (overlay_bridge_batch.h) when given a batch send.
+//
+// 2026-10-14: the single latest_ slot could not tell the UI which click
+// produced which response, and a bulk operation only reported its last
+// outcome. Every request now gets an ActionId back from Enqueue(); its
+// result lands in a bounded ring the render thread pins once per frame
+// without taking mutex_ (AcquireResults(), a SnapshotTripleBuffer); an
+// optional on_done callback fires on the worker thread; and EnqueueBulk()
+// tracks done / failed / pending for the whole group in one atomic word
+// (BulkProgress()), enough for a progress bar with no per-item polling.
+//
+// 2026-10-14: the worker used to poll with a 200 ms sliced Sleep, so a click
+// could wait a whole interval before dispatch began. Between drains it now
+// blocks in WaitForWork() on a condition variable that Enqueue() signals.
+//
 // NOTE: this header is not yet #included by any DLL translation unit. The
 // next overlay iter wires the Phase 3 button onClick handlers to Enqueue()
 // and starts the drain worker — see knowledge-base/overlay_phase3_*_iter513.md.
@@ -26,11 +45,20 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <mutex>
 #include <string>
+#include <vector>
+
+#include "overlay_bridge_batch.h"
+#include "overlay_snapshot_buffer.h"
 
 namespace swfoc_overlay
 {
@@ -40,55 +68,181 @@ namespace swfoc_overlay
     // "bridge call issued" be confused with "engine state changed").
     enum class ActionStatus
     {
-        Idle,     // No action dispatched yet this session.
-        Pending,  // Enqueued; the drain worker has not run it yet.
-        Live,     // Bridge round-trip succeeded.
-        Failed,   // Bridge round-trip failed (pipe error or send rejected).
+        Idle,        // No action dispatched yet this session.
+        Pending,     // Enqueued; the drain worker has not run it yet.
+        Live,        // Bridge round-trip succeeded.
+        Failed,      // Bridge round-trip failed (pipe error or send rejected).
+        Superseded,  // Dropped unsent: a newer request with its key replaced it.
     };
 
+    // Per-queue request id, assigned by Enqueue() from 1 up. 0 = none.
+    using ActionId = uint64_t;
+
+    // Outcome of one action. LatestResult() copies the most recent one for
+    // the footer toast; the result ring keeps the last kActionResultRingSize.
+    struct ActionResult
+    {
+        ActionId id = 0;       // Enqueue()'s return value for this request
+        ActionStatus status = ActionStatus::Idle;
+        std::string label;     // label of the action this result describes
+        std::string response;  // bridge response text, or failure reason
+    };
+
+    // Completion callback. Runs on the DRAIN WORKER thread once the request
+    // is Live, Failed or Superseded — never on the render thread, and never
+    // with the queue's mutex held, so it may Enqueue() a follow-up.
+    using ActionDoneFn = std::function<void(const ActionResult& result)>;
+
     // A queued action: a human-readable label for the toast plus the exact
     // Lua line to send through the bridge (built by overlay_actions.h).
+    //
+    // `key` names the state a set-style action overwrites (game speed, the
+    // camera position, one unit's invulnerability). A pending request with
+    // the same non-empty key is superseded by the newer one — only the last
+    // value of a slider drag or a held hotkey reaches the bridge. Empty
+    // (the default) never coalesces: spawns, kills and heals all run.
     struct ActionRequest
     {
         std::string label;  // e.g. "Spawn Rebel_Trooper_Squad"
         std::string lua;    // e.g. "return SWFOC_SpawnUnitLua(...)"
+        std::string key = std::string();  // e.g. "game_speed"; "" = never coalesce
+        ActionDoneFn on_done = ActionDoneFn();  // optional, worker thread
     };
 
-    // Snapshot of the most-recent action outcome, copied by the render
-    // thread once per frame for the footer toast.
-    struct ActionResult
+    // The last kActionResultRingSize results, oldest first. `total` counts
+    // every result ever recorded, so a reader can tell new entries from the
+    // ones it already showed.
+    constexpr std::size_t kActionResultRingSize = 16;
+
+    struct ActionResultRing
     {
-        ActionStatus status = ActionStatus::Idle;
-        std::string label;     // label of the action this result describes
-        std::string response;  // bridge response text, or failure reason
+        ActionResult entries[kActionResultRingSize];
+        uint64_t     total = 0;
+
+        std::size_t Count() const
+        {
+            return total < kActionResultRingSize
+                ? static_cast<std::size_t>(total) : kActionResultRingSize;
+        }
+
+        // i = 0 is the newest result. Precondition: i < Count().
+        const ActionResult& Newest(std::size_t i) const
+        {
+            return entries[(total - 1 - i) % kActionResultRingSize];
+        }
+
+        void Push(const ActionResult& r)
+        {
+            entries[total % kActionResultRingSize] = r;
+            ++total;
+        }
     };
 
+    // Progress of the most recent EnqueueBulk() group. pending() is what a
+    // progress bar needs; group 0 means no bulk operation yet.
+    struct ActionProgress
+    {
+        uint32_t group = 0;
+        uint32_t total = 0;
+        uint32_t done = 0;    // Live or Superseded
+        uint32_t failed = 0;
+
+        uint32_t pending() const { return total - done - failed; }
+    };
+
+    // Largest group EnqueueBulk() tracks; the counters are 16-bit fields of
+    // one atomic word.
+    constexpr std::size_t kMaxActionBulk = 0xFFFF;
+
     // The send-function contract: run `lua` through the bridge, write the
     // response into `response`, return true on success. BridgeProbe in
     // hud_state.cpp has exactly this shape; the test injects a fake.
     using BridgeSendFn =
         std::function<bool(const std::string& lua, std::string& response)>;
 
-    // Thread-safe FIFO action queue + latest-result store.
+    // Batched send: run a prebuilt "@batch N" request (overlay_bridge_batch.h)
+    // and return the raw reply. BridgeBatchProbe in hud_state.cpp has this
+    // shape. Returns false only when the pipe round-trip itself failed.
+    using BridgeBatchSendFn =
+        std::function<bool(const std::string& request, std::string& response)>;
+
+    // Thread-safe FIFO action queue + result store.
     //
-    //   Render thread : Enqueue() on button click, LatestResult() per frame.
-    //   Worker thread : Drain(send) in a loop.
+    //   Render thread : Enqueue() / EnqueueBulk() on a click, LatestResult(),
+    //                   AcquireResults() and BulkProgress() per frame.
+    //   Worker thread : Drain(send) in a loop, WaitForWork() between drains.
     //
-    // Every public method takes the internal mutex, so the object is safe to
-    // share between the render thread and the worker thread.
+    // Enqueue / LatestResult / PendingCount take the internal mutex.
+    // AcquireResults() and BulkProgress() do not: the ring is a single-writer
+    // (Drain) / single-reader (AcquireResults) triple buffer and the bulk
+    // counters are one atomic word.
     class ActionQueue
     {
     public:
         // Render-thread side. Append a request to the FIFO and mark the
         // latest result Pending, so the toast updates the instant the
-        // operator clicks — before the worker has run anything.
-        void Enqueue(const ActionRequest& req)
+        // operator clicks — before the worker has run anything. Returns the
+        // request's id.
+        //
+        // A keyed request first drops any pending request with the same key
+        // and then joins the BACK of the queue, so it never overtakes an
+        // action the operator issued before it. The dropped request
+        // completes as Superseded on the next Drain().
+        ActionId Enqueue(const ActionRequest& req)
         {
-            std::lock_guard<std::mutex> lg(mutex_);
-            pending_.push_back(req);
-            latest_.status = ActionStatus::Pending;
-            latest_.label = req.label;
-            latest_.response.clear();
+            ActionId id = 0;
+            {
+                std::lock_guard<std::mutex> lg(mutex_);
+                id = EnqueueLocked(req, 0);
+            }
+            work_cv_.notify_one();
+            return id;
+        }
+
+        // Render-thread side. Enqueue a bulk operation (e.g. the faction
+        // switch batch) as one progress group, restarting BulkProgress() at
+        // 0 / requests.size(). Returns the group id, or 0 (nothing queued)
+        // for an empty or over-kMaxActionBulk group.
+        uint32_t EnqueueBulk(const std::vector<ActionRequest>& requests)
+        {
+            if (requests.empty() || requests.size() > kMaxActionBulk) return 0;
+            ActionProgress p;
+            {
+                std::lock_guard<std::mutex> lg(mutex_);
+                if (++bulk_group_ > 0xFFFF) bulk_group_ = 1;
+                p.group = bulk_group_;
+                p.total = static_cast<uint32_t>(requests.size());
+                progress_.store(PackProgress(p), std::memory_order_release);
+                for (const ActionRequest& req : requests) EnqueueLocked(req, p.group);
+            }
+            work_cv_.notify_one();
+            return p.group;
+        }
+
+        // Worker-thread side. Block until there is something to drain, a
+        // Wake() arrives, or `timeoutMs` passes — the worker's inter-drain
+        // pause, so a click is dispatched as soon as it is enqueued instead
+        // of at the next poll. Returns true when woken by work or Wake().
+        bool WaitForWork(uint32_t timeoutMs)
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            const bool woke = work_cv_.wait_for(
+                lk, std::chrono::milliseconds(timeoutMs),
+                [this] { return wake_ || !pending_.empty() || !superseded_.empty(); });
+            wake_ = false;
+            return woke;
+        }
+
+        // Any thread. Release the current (or next) WaitForWork() with no
+        // work queued; StopActionWorker() calls it after setting the stop
+        // flag so shutdown never waits out the timeout.
+        void Wake()
+        {
+            {
+                std::lock_guard<std::mutex> lg(mutex_);
+                wake_ = true;
+            }
+            work_cv_.notify_all();
         }
 
         // Render-thread side. Copy the latest result for the toast.
@@ -98,6 +252,19 @@ namespace swfoc_overlay
             return latest_;
         }
 
+        // Render-thread side, ONE reader only. Pins the newest published
+        // result ring; the reference stays valid until the next call.
+        const ActionResultRing& AcquireResults()
+        {
+            return ring_buf_.Acquire();
+        }
+
+        // Any thread. Counters of the most recent EnqueueBulk() group.
+        ActionProgress BulkProgress() const
+        {
+            return UnpackProgress(progress_.load(std::memory_order_acquire));
+        }
+
         // Number of requests still waiting to be drained.
         std::size_t PendingCount() const
         {
@@ -105,56 +272,223 @@ namespace swfoc_overlay
             return pending_.size();
         }
 
+        // Requests superseded by a newer one with the same key, ever.
+        std::size_t CoalescedCount() const
+        {
+            std::lock_guard<std::mutex> lg(mutex_);
+            return coalesced_;
+        }
+
         // Worker-thread side. Pop and dispatch every pending request in
-        // FIFO order, sending each through `send`. After each dispatch the
-        // latest result is updated to Live or Failed. Returns the number of
-        // requests processed.
+        // FIFO order. After each dispatch the latest result is updated to
+        // Live or Failed. Returns the number of requests processed.
+        //
+        // Requests are popped under the lock, up to kMaxBridgeBatch at a
+        // time; the lock is then RELEASED across the (blocking) send, so a
+        // slow bridge never holds the mutex — Enqueue() / LatestResult() on
+        // the render thread stay non-blocking even mid-dispatch.
         //
-        // Each request is popped under the lock; the lock is then RELEASED
-        // across the (blocking) send call, so a slow bridge never holds the
-        // mutex — Enqueue() / LatestResult() on the render thread stay
-        // non-blocking even mid-dispatch.
-        int Drain(const BridgeSendFn& send)
+        // With `sendBatch` set, two or more popped requests go out as ONE
+        // "@batch N" round-trip; the bridge runs them back to back, in
+        // order, in a single main-thread pass. A request the batch framing
+        // cannot carry, or a bridge that does not answer with a batch reply
+        // (pre-batch build: nothing ran), falls back to one `send` each. A
+        // failed batch round-trip fails every request in it and re-sends
+        // none — the bridge may already have run some of them.
+        int Drain(const BridgeSendFn& send,
+                  const BridgeBatchSendFn& sendBatch = BridgeBatchSendFn())
         {
             int processed = 0;
+            std::vector<Entry> reqs;
+            {
+                std::lock_guard<std::mutex> lg(mutex_);
+                reqs.swap(superseded_);
+            }
+            for (const Entry& e : reqs)
+            {
+                ActionResult result;
+                result.status = ActionStatus::Superseded;
+                result.label = e.req.label;
+                Complete(e, result, false);
+            }
+            if (!reqs.empty()) ring_buf_.Publish(ring_);
+
             for (;;)
             {
-                ActionRequest req;
+                reqs.clear();
                 {
                     std::lock_guard<std::mutex> lg(mutex_);
                     if (pending_.empty()) break;
-                    req = pending_.front();
-                    pending_.pop_front();
+                    const std::size_t take = sendBatch
+                        ? std::min<std::size_t>(pending_.size(), kMaxBridgeBatch)
+                        : 1;
+                    for (std::size_t i = 0; i < take; ++i)
+                    {
+                        reqs.push_back(std::move(pending_.front()));
+                        pending_.pop_front();
+                    }
                 }
 
-                ActionResult result;
-                result.label = req.label;
-                if (send)
+                if (reqs.size() < 2 || !SendBatch(reqs, sendBatch))
                 {
-                    std::string response;
-                    const bool ok = send(req.lua, response);
-                    result.status = ok ? ActionStatus::Live
-                                       : ActionStatus::Failed;
-                    result.response = response;
+                    for (const Entry& e : reqs) SendOne(e, send);
                 }
-                else
+                ring_buf_.Publish(ring_);
+                processed += static_cast<int>(reqs.size());
+            }
+            return processed;
+        }
+
+    private:
+        struct Entry
+        {
+            ActionRequest req;
+            ActionId      id = 0;
+            uint32_t      group = 0;  // EnqueueBulk group, 0 = none
+        };
+
+        static uint64_t PackProgress(const ActionProgress& p)
+        {
+            return (static_cast<uint64_t>(p.group) << 48)
+                 | (static_cast<uint64_t>(p.total) << 32)
+                 | (static_cast<uint64_t>(p.done) << 16)
+                 | static_cast<uint64_t>(p.failed);
+        }
+
+        static ActionProgress UnpackProgress(uint64_t v)
+        {
+            ActionProgress p;
+            p.group = static_cast<uint32_t>(v >> 48);
+            p.total = static_cast<uint32_t>((v >> 32) & 0xFFFF);
+            p.done = static_cast<uint32_t>((v >> 16) & 0xFFFF);
+            p.failed = static_cast<uint32_t>(v & 0xFFFF);
+            return p;
+        }
+
+        ActionId EnqueueLocked(const ActionRequest& req, uint32_t group)
+        {
+            if (!req.key.empty())
+            {
+                for (auto it = pending_.begin(); it != pending_.end();)
                 {
-                    result.status = ActionStatus::Failed;
-                    result.response = "(no send function)";
+                    if (it->req.key == req.key)
+                    {
+                        superseded_.push_back(std::move(*it));
+                        it = pending_.erase(it);
+                        ++coalesced_;
+                    }
+                    else
+                    {
+                        ++it;
+                    }
                 }
+            }
+            Entry e;
+            e.req = req;
+            e.id = ++next_id_;
+            e.group = group;
+            pending_.push_back(std::move(e));
+            latest_.id = next_id_;
+            latest_.status = ActionStatus::Pending;
+            latest_.label = req.label;
+            latest_.response.clear();
+            return next_id_;
+        }
+
+        // Worker side: record one finished request. `latest` is false for a
+        // superseded request, whose newer replacement already owns latest_.
+        void Complete(const Entry& e, ActionResult& result, bool latest)
+        {
+            result.id = e.id;
+            if (latest)
+            {
+                std::lock_guard<std::mutex> lg(mutex_);
+                latest_ = result;
+            }
+            ring_.Push(result);
+            if (e.group != 0) CountBulk(e.group, result.status != ActionStatus::Failed);
+            if (e.req.on_done) e.req.on_done(result);
+        }
 
+        // Bumps done / failed unless a newer EnqueueBulk() restarted the
+        // counters for another group.
+        void CountBulk(uint32_t group, bool done)
+        {
+            uint64_t cur = progress_.load(std::memory_order_acquire);
+            for (;;)
+            {
+                ActionProgress p = UnpackProgress(cur);
+                if (p.group != group) return;
+                if (done) ++p.done;
+                else ++p.failed;
+                if (progress_.compare_exchange_weak(cur, PackProgress(p),
+                                                    std::memory_order_acq_rel))
                 {
-                    std::lock_guard<std::mutex> lg(mutex_);
-                    latest_ = result;
+                    return;
                 }
-                ++processed;
             }
-            return processed;
         }
 
-    private:
+        void SendOne(const Entry& e, const BridgeSendFn& send)
+        {
+            ActionResult result;
+            result.label = e.req.label;
+            if (send)
+            {
+                std::string response;
+                const bool ok = send(e.req.lua, response);
+                result.status = ok ? ActionStatus::Live
+                                   : ActionStatus::Failed;
+                result.response = response;
+            }
+            else
+            {
+                result.status = ActionStatus::Failed;
+                result.response = "(no send function)";
+            }
+            Complete(e, result, true);
+        }
+
+        // One "@batch N" round-trip for `reqs`. Returns false, having sent
+        // nothing that ran, when the caller should fall back to SendOne.
+        bool SendBatch(const std::vector<Entry>& reqs,
+                       const BridgeBatchSendFn& sendBatch)
+        {
+            const int n = static_cast<int>(reqs.size());
+            std::vector<std::string> chunks;
+            chunks.reserve(reqs.size());
+            for (const Entry& e : reqs) chunks.push_back(e.req.lua);
+            std::string request;
+            if (!BuildBridgeBatchRequest(chunks.data(), n, request)) return false;
+
+            std::string reply;
+            const bool sent = sendBatch(request, reply);
+            std::vector<BridgeBatchResult> entries(reqs.size());
+            if (sent && !ParseBridgeBatchReply(reply, n, entries.data())) return false;
+            for (int i = 0; i < n; ++i)
+            {
+                ActionResult result;
+                result.label = reqs[i].req.label;
+                result.status = sent && entries[i].ok ? ActionStatus::Live
+                                                      : ActionStatus::Failed;
+                result.response = sent ? entries[i].payload : reply;
+                Complete(reqs[i], result, true);
+            }
+            return true;
+        }
+
         mutable std::mutex mutex_;
-        std::deque<ActionRequest> pending_;
+        std::condition_variable work_cv_;  // Enqueue / Wake -> WaitForWork
+        bool wake_ = false;
+        std::deque<Entry> pending_;
+        std::vector<Entry> superseded_;   // completed by the next Drain()
+        std::size_t coalesced_ = 0;
+        ActionId next_id_ = 0;
+        uint32_t bulk_group_ = 0;
         ActionResult latest_;
+
+        ActionResultRing ring_;                             // Drain() only
+        SnapshotTripleBuffer<ActionResultRing> ring_buf_;   // -> AcquireResults()
+        std::atomic<uint64_t> progress_{0};
     };
 }
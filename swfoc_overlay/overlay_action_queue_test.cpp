@@ -17,6 +17,20 @@
 // asserts it equals the enqueue order — it passes ONLY on the correct FIFO
 // form and fails on a LIFO regression.
 //
+// 2026-10-14 pins:
+//   - COALESCE     : a keyed request supersedes a pending one with the same
+//                    key and joins the back; unkeyed requests never merge.
+//   - ONE BATCH    : with a batch send, N pending requests cost ONE
+//                    round-trip, in FIFO order, with per-entry status.
+//   - LEGACY       : a non-batch reply falls back to one send each.
+//   - NO RESEND    : a failed batch round-trip fails all, re-sends none.
+//   - IDS          : Enqueue() ids are unique and tag the ring's results.
+//   - RING         : AcquireResults() holds the newest results, bounded.
+//   - CALLBACK     : on_done fires once per request, superseded included.
+//   - BULK         : EnqueueBulk() counts done / failed / pending per group.
+//   - WAIT         : WaitForWork() returns at once with work or a Wake(),
+//                    and times out (false) on an idle queue.
+//
 // The non-blocking guarantee (no pipe I/O on the render thread) is an
 // architectural property a unit test cannot assert; it is documented in
 // overlay_action_queue.h's header comment and enforced by Drain() releasing
@@ -219,6 +233,250 @@ int main()
                     q.LatestResult().label, "c");
     }
 
+    // ---- PIN coalesce: last writer wins, behind earlier actions -----------
+    {
+        ActionQueue q;
+        q.Enqueue(ActionRequest{ "speed 1", "S1", "game_speed" });
+        q.Enqueue(ActionRequest{ "spawn", "SP" });
+        q.Enqueue(ActionRequest{ "speed 2", "S2", "game_speed" });
+        q.Enqueue(ActionRequest{ "spawn", "SP" });
+        q.Enqueue(ActionRequest{ "speed 3", "S3", "game_speed" });
+        ExpectEqInt("coalesce: superseded requests dropped",
+                    static_cast<long long>(q.PendingCount()), 3);
+        ExpectEqInt("coalesce: two coalesced",
+                    static_cast<long long>(q.CoalescedCount()), 2);
+        std::vector<std::string> seen;
+        q.Drain([&seen](const std::string& lua, std::string& resp) -> bool
+        {
+            seen.push_back(lua);
+            resp = "ok";
+            return true;
+        });
+        ExpectEqStr("PIN coalesce: unkeyed kept, keyed value is the last",
+                    Join(seen), "SP,SP,S3");
+    }
+
+    // ---- PIN one batch: N pending requests cost one round-trip ------------
+    {
+        ActionQueue q;
+        q.Enqueue(ActionRequest{ "a", "L0" });
+        q.Enqueue(ActionRequest{ "b", "L1" });
+        q.Enqueue(ActionRequest{ "c", "L2" });
+        int singles = 0;
+        int batches = 0;
+        std::string seenRequest;
+        const int processed = q.Drain(
+            [&singles](const std::string&, std::string&) -> bool
+            {
+                ++singles;
+                return true;
+            },
+            [&](const std::string& request, std::string& resp) -> bool
+            {
+                ++batches;
+                seenRequest = request;
+                resp = "@batch 3\nOK 1\naOK 1\nbERR 4\nboom";
+                return true;
+            });
+        ExpectEqInt("batch: returns 3 processed", processed, 3);
+        ExpectEqInt("PIN batch: one round-trip", batches, 1);
+        ExpectEqInt("batch: no single sends", singles, 0);
+        ExpectEqStr("batch: chunks in FIFO order",
+                    seenRequest, "@batch 3\nL0\nL1\nL2\n");
+        ExpectEqInt("batch: latest takes the last entry's status",
+                    StatusInt(q.LatestResult().status),
+                    StatusInt(ActionStatus::Failed));
+        ExpectEqStr("batch: latest response is the last entry's payload",
+                    q.LatestResult().response, "boom");
+        ExpectEqStr("batch: latest label is the last request",
+                    q.LatestResult().label, "c");
+    }
+
+    // ---- A lone request skips the batch framing ----------------------------
+    {
+        ActionQueue q;
+        q.Enqueue(ActionRequest{ "a", "L0" });
+        int batches = 0;
+        q.Drain([](const std::string&, std::string& resp) -> bool
+                {
+                    resp = "ok";
+                    return true;
+                },
+                [&batches](const std::string&, std::string&) -> bool
+                {
+                    ++batches;
+                    return true;
+                });
+        ExpectEqInt("single: no batch round-trip", batches, 0);
+        ExpectEqInt("single: latest status is Live",
+                    StatusInt(q.LatestResult().status),
+                    StatusInt(ActionStatus::Live));
+    }
+
+    // ---- PIN legacy: a non-batch reply falls back per request -------------
+    {
+        ActionQueue q;
+        q.Enqueue(ActionRequest{ "a", "L0" });
+        q.Enqueue(ActionRequest{ "b", "L1" });
+        std::vector<std::string> seen;
+        q.Drain([&seen](const std::string& lua, std::string& resp) -> bool
+                {
+                    seen.push_back(lua);
+                    resp = "ok";
+                    return true;
+                },
+                [](const std::string&, std::string& resp) -> bool
+                {
+                    resp = "ERR: [string \"@batch 2\"]:1: syntax error\n";
+                    return true;
+                });
+        ExpectEqStr("PIN legacy: each request sent singly, in order",
+                    Join(seen), "L0,L1");
+    }
+
+    // ---- PIN no resend: a failed batch round-trip fails everything ---------
+    {
+        ActionQueue q;
+        q.Enqueue(ActionRequest{ "a", "L0" });
+        q.Enqueue(ActionRequest{ "b", "L1" });
+        int singles = 0;
+        const int processed = q.Drain(
+            [&singles](const std::string&, std::string&) -> bool
+            {
+                ++singles;
+                return true;
+            },
+            [](const std::string&, std::string& resp) -> bool
+            {
+                resp = "(pipe timeout)";
+                return false;
+            });
+        ExpectEqInt("no resend: both processed", processed, 2);
+        ExpectEqInt("PIN no resend: nothing re-sent singly", singles, 0);
+        ExpectEqInt("no resend: latest status is Failed",
+                    StatusInt(q.LatestResult().status),
+                    StatusInt(ActionStatus::Failed));
+        ExpectEqStr("no resend: latest response is the failure",
+                    q.LatestResult().response, "(pipe timeout)");
+    }
+
+    // ---- PIN ids: each request's result carries its Enqueue() id ---------
+    {
+        ActionQueue q;
+        const ActionId a = q.Enqueue(ActionRequest{ "a", "L0" });
+        const ActionId b = q.Enqueue(ActionRequest{ "b", "L1" });
+        ExpectEqInt("ids: distinct and increasing", b > a && a != 0, 1);
+        q.Drain([](const std::string& lua, std::string& resp) -> bool
+        {
+            resp = "r" + lua;
+            return lua != "L1";
+        });
+        const ActionResultRing& ring = q.AcquireResults();
+        ExpectEqInt("ring: two results", static_cast<long long>(ring.Count()), 2);
+        ExpectEqInt("PIN ids: newest result is b",
+                    static_cast<long long>(ring.Newest(0).id),
+                    static_cast<long long>(b));
+        ExpectEqInt("ids: b failed", StatusInt(ring.Newest(0).status),
+                    StatusInt(ActionStatus::Failed));
+        ExpectEqInt("ids: older result is a",
+                    static_cast<long long>(ring.Newest(1).id),
+                    static_cast<long long>(a));
+        ExpectEqStr("ids: a's own response", ring.Newest(1).response, "rL0");
+        ExpectEqInt("ids: latest result names b",
+                    static_cast<long long>(q.LatestResult().id),
+                    static_cast<long long>(b));
+    }
+
+    // ---- PIN ring: bounded, newest kept ------------------------------------
+    {
+        ActionQueue q;
+        ExpectEqInt("ring: empty before any drain",
+                    static_cast<long long>(q.AcquireResults().Count()), 0);
+        ActionId last = 0;
+        for (std::size_t i = 0; i < kActionResultRingSize + 5; ++i)
+        {
+            last = q.Enqueue(ActionRequest{ "x", "L" + std::to_string(i) });
+        }
+        q.Drain([](const std::string&, std::string&) -> bool { return true; });
+        const ActionResultRing& ring = q.AcquireResults();
+        ExpectEqInt("PIN ring: capped at kActionResultRingSize",
+                    static_cast<long long>(ring.Count()),
+                    static_cast<long long>(kActionResultRingSize));
+        ExpectEqInt("ring: total counts every result",
+                    static_cast<long long>(ring.total),
+                    static_cast<long long>(kActionResultRingSize + 5));
+        ExpectEqInt("ring: newest is the last request",
+                    static_cast<long long>(ring.Newest(0).id),
+                    static_cast<long long>(last));
+        ExpectEqInt("ring: oldest kept is 6th",
+                    static_cast<long long>(ring.Newest(kActionResultRingSize - 1).id),
+                    static_cast<long long>(last - kActionResultRingSize + 1));
+    }
+
+    // ---- PIN callback: once per request, superseded ones too ---------------
+    {
+        ActionQueue q;
+        std::vector<std::string> done;
+        auto record = [&done](const ActionResult& r)
+        {
+            done.push_back(r.label + "=" + std::to_string(StatusInt(r.status)));
+        };
+        q.Enqueue(ActionRequest{ "s1", "S1", "speed", record });
+        q.Enqueue(ActionRequest{ "s2", "S2", "speed", record });
+        q.Drain([](const std::string&, std::string&) -> bool { return true; });
+        ExpectEqStr("PIN callback: superseded then live",
+                    Join(done),
+                    "s1=" + std::to_string(StatusInt(ActionStatus::Superseded)) +
+                    ",s2=" + std::to_string(StatusInt(ActionStatus::Live)));
+        ExpectEqInt("callback: latest is not the superseded one",
+                    StatusInt(q.LatestResult().status),
+                    StatusInt(ActionStatus::Live));
+    }
+
+    // ---- PIN bulk: done / failed / pending for one group -------------------
+    {
+        ActionQueue q;
+        ExpectEqInt("bulk: no group yet",
+                    static_cast<long long>(q.BulkProgress().group), 0);
+        std::vector<ActionRequest> batch;
+        batch.push_back(ActionRequest{ "u1", "OK1" });
+        batch.push_back(ActionRequest{ "u2", "BAD" });
+        batch.push_back(ActionRequest{ "u3", "OK3" });
+        const uint32_t g = q.EnqueueBulk(batch);
+        ExpectEqInt("bulk: group assigned", g != 0, 1);
+        ExpectEqInt("bulk: all pending before drain",
+                    static_cast<long long>(q.BulkProgress().pending()), 3);
+        q.Enqueue(ActionRequest{ "loose", "OK4" });
+        q.Drain([](const std::string& lua, std::string&) -> bool
+        {
+            return lua != "BAD";
+        });
+        const ActionProgress p = q.BulkProgress();
+        ExpectEqInt("PIN bulk: done", static_cast<long long>(p.done), 2);
+        ExpectEqInt("PIN bulk: failed", static_cast<long long>(p.failed), 1);
+        ExpectEqInt("bulk: none pending", static_cast<long long>(p.pending()), 0);
+        ExpectEqInt("bulk: loose request not counted",
+                    static_cast<long long>(p.total), 3);
+        ExpectEqInt("bulk: empty group refused",
+                    static_cast<long long>(q.EnqueueBulk({})), 0);
+    }
+
+    // ---- PIN wait: work and Wake() release WaitForWork() ------------------
+    {
+        ActionQueue q;
+        ExpectEqInt("wait: idle queue times out",
+                    q.WaitForWork(1) ? 1 : 0, 0);
+        q.Enqueue(ActionRequest{ "a", "L0" });
+        ExpectEqInt("PIN wait: pending work returns true",
+                    q.WaitForWork(60000) ? 1 : 0, 1);
+        q.Drain([](const std::string&, std::string&) -> bool { return true; });
+        q.Wake();
+        ExpectEqInt("PIN wait: a Wake() before the wait is not lost",
+                    q.WaitForWork(60000) ? 1 : 0, 1);
+        ExpectEqInt("wait: the Wake() is consumed",
+                    q.WaitForWork(1) ? 1 : 0, 0);
+    }
+
     std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
     return g_failures == 0 ? 0 : 1;
 }
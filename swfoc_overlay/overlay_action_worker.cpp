@@ -12,15 +12,16 @@
 //       LatestResult() once per frame; the worker thread drains it.
 //   StartActionWorker()   — spawn the background std::thread running
 //       RunActionWorkerLoop() with the real BridgeProbe send (hud_state.h),
-//       a sliced Sleep, and an std::atomic<bool> stop signal. Idempotent.
+//       ActionQueue::WaitForWork() as the pause, and an std::atomic<bool>
+//       stop signal. Idempotent.
 //   StopActionWorker()    — set the stop signal and join the thread.
 //       Idempotent.
 //
 // Install() calls StartActionWorker() after StartHudWorker(); Uninstall()
 // calls StopActionWorker() before the D3D9 hooks come down, so an in-flight
 // bridge round-trip drains cleanly. The shape mirrors hud_state.cpp's
-// StartHudWorker / StopHudWorker exactly: idempotent joinable() guard, sliced
-// Sleep so a shutdown requested mid-pause is honoured within one slice.
+// StartHudWorker / StopHudWorker: idempotent joinable() guard, and a pause a
+// shutdown can cut short (here Wake() on the queue's condition variable).
 //
 // Why a worker thread at all: BridgeProbe does blocking named-pipe I/O. The
 // Phase 3 buttons must never run it on the render thread (inside the D3D9
@@ -32,9 +33,8 @@
 
 #include "hud_state.h"  // swfoc_overlay::BridgeProbe — the real blocking send.
 
-#include <windows.h>    // Sleep
-
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include <thread>
 
@@ -53,21 +53,14 @@ namespace
     std::thread g_actionWorker;
     std::atomic<bool> g_actionShutdown{false};
 
-    // Inter-drain pause. Sliced into 50 ms chunks (mirrors hud_state.cpp's
-    // WorkerLoop) so a shutdown requested mid-pause is honoured within one
-    // slice instead of after a full interval.
-    constexpr int kActionDrainIntervalMs = 200;
-    constexpr int kActionSleepSliceMs = 50;
+    // Inter-drain pause: block until Enqueue() signals work or
+    // StopActionWorker() calls Wake(). The timeout is only a backstop; no
+    // work is ever left waiting on it.
+    constexpr uint32_t kActionIdleWaitMs = 1000;
 
-    void SlicedSleep()
+    void WaitForWork()
     {
-        for (int i = 0;
-             i < kActionDrainIntervalMs / kActionSleepSliceMs
-                 && !g_actionShutdown.load(std::memory_order_relaxed);
-             ++i)
-        {
-            Sleep(kActionSleepSliceMs);
-        }
+        Queue().WaitForWork(kActionIdleWaitMs);
     }
 }
 
@@ -97,14 +90,21 @@ namespace swfoc_overlay
                 {
                     return g_actionShutdown.load(std::memory_order_relaxed);
                 },
-                // Inter-drain pause, shutdown-responsive.
-                SlicedSleep);
+                // Inter-drain pause: wakes on Enqueue(), shutdown-responsive.
+                WaitForWork,
+                // Whatever piled up between drains goes out as one "@batch"
+                // round-trip instead of one pipe call each.
+                [](const std::string& request, std::string& response)
+                {
+                    return BridgeBatchProbe(request, response);
+                });
         });
     }
 
     void StopActionWorker()
     {
         g_actionShutdown.store(true);
+        Queue().Wake();  // release a worker blocked in WaitForWork()
         if (g_actionWorker.joinable()) g_actionWorker.join();
     }
 }
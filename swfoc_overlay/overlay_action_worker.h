@@ -28,7 +28,7 @@
 // overlay_action_worker.cpp (added iter 516): ActionQueueInstance() exposes the
 // one process-wide ActionQueue, and StartActionWorker() / StopActionWorker()
 // spawn / join the single background std::thread that runs RunActionWorkerLoop
-// with the real BridgeProbe send (hud_state.h), a sliced Sleep, and the
+// with the real BridgeProbe send (hud_state.h), ActionQueue::WaitForWork(), and the
 // shutdown atomic. overlay.cpp's Install() / Uninstall() own that lifecycle.
 // Phase 3's RenderActionsWindow wires the buttons to ActionQueueInstance()
 // next overlay iter. See knowledge-base/overlay_phase3_actionworker_iter515.md
@@ -49,9 +49,11 @@ namespace swfoc_overlay
     // call-count fake.
     using ShouldStopFn = std::function<bool()>;
 
-    // Inter-drain pause. The real worker binds this to a sliced Sleep (so a
-    // shutdown requested during the pause stays responsive); the test binds a
-    // no-op counter so the loop runs instantly.
+    // Inter-drain pause. The real worker binds this to
+    // ActionQueue::WaitForWork(), which returns as soon as Enqueue() adds work
+    // or StopActionWorker() calls Wake() — a click is dispatched at once and
+    // a shutdown requested during the pause stays responsive. The test binds
+    // a no-op counter so the loop runs instantly.
     using WorkerSleepFn = std::function<void()>;
 
     // Drain `queue` through `send` repeatedly until `shouldStop()` is true,
@@ -72,15 +74,18 @@ namespace swfoc_overlay
     //   - empty send       -> ActionQueue::Drain already marks each request
     //     Failed with "(no send function)" — the loop just keeps ticking.
     //   - empty sleep      -> the inter-drain pause is skipped.
+    //   - empty sendBatch  -> every request goes through `send` on its own.
     inline void RunActionWorkerLoop(ActionQueue& queue,
                                     const BridgeSendFn& send,
                                     const ShouldStopFn& shouldStop,
-                                    const WorkerSleepFn& sleep)
+                                    const WorkerSleepFn& sleep,
+                                    const BridgeBatchSendFn& sendBatch =
+                                        BridgeBatchSendFn())
     {
         if (!shouldStop) return;  // No stop signal — refuse to loop forever.
         while (!shouldStop())
         {
-            queue.Drain(send);
+            queue.Drain(send, sendBatch);
             if (shouldStop()) break;  // Stop requested mid-tick — skip sleep.
             if (sleep) sleep();
         }
@@ -6,8 +6,9 @@
 // overlay_action_queue.h + <functional> — no Windows, no <thread>, no ImGui,
 // no bridge). The blocking bridge send, the real Sleep and the shutdown
 // signal are all injected as callables, so this test drives the entire worker
-// loop deterministically with a plain g++ — no game, no pipe, no thread.
-// Build + run via build_action_worker_test.bat.
+// loop deterministically with a plain g++ — no game, no pipe. Only the
+// WAKE-ON-ENQUEUE pin spawns a thread, to run the loop the way
+// overlay_action_worker.cpp does. Build + run via build_action_worker_test.bat.
 //
 // RED-GREEN REGRESSION PINS
 // ------------------------
@@ -21,13 +22,20 @@
 //                    shutdown would delay DLL teardown by a full sleep
 //                    interval. The "PIN no-sleep-on-stop" check stops the loop
 //                    immediately after a drain and asserts zero sleeps.
+//   - WAKE-ON-ENQUEUE : with ActionQueue::WaitForWork() as the pause, a
+//                    request enqueued while the worker waits is dispatched
+//                    long before the wait's timeout, and Wake() releases the
+//                    worker for shutdown the same way (2026-10-14).
 // =============================================================================
 
 #include "overlay_action_worker.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdio>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace
@@ -274,6 +282,46 @@ int main()
                     stopCalls, 4);
     }
 
+    // ---- RED-GREEN PIN: WaitForWork() wakes on Enqueue() and Wake() -------
+    {
+        using Clock = std::chrono::steady_clock;
+        ActionQueue q;
+        std::atomic<bool> stop{false};
+        std::atomic<int> sent{0};
+        std::thread worker([&]
+        {
+            RunActionWorkerLoop(
+                q,
+                [&sent](const std::string&, std::string& r) -> bool
+                {
+                    r = "ok";
+                    ++sent;
+                    return true;
+                },
+                [&stop] { return stop.load(); },
+                // A 60 s backstop: only a signal can end the wait in time.
+                [&q] { q.WaitForWork(60000); });
+        });
+
+        // Let the worker reach its wait, then click.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const Clock::time_point t0 = Clock::now();
+        q.Enqueue(ActionRequest{ "a", "L0" });
+        while (sent.load() == 0 && Clock::now() - t0 < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ExpectEqInt("PIN wake-on-enqueue: dispatched without waiting out the pause",
+                    sent.load(), 1);
+
+        const Clock::time_point t1 = Clock::now();
+        stop.store(true);
+        q.Wake();
+        worker.join();
+        ExpectEqInt("wake-on-enqueue: Wake() releases the worker for shutdown",
+                    Clock::now() - t1 < std::chrono::seconds(5) ? 1 : 0, 1);
+    }
+
     std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
     return g_failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,141 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_batch.h — client side of the bridge's "@batch"
+// pipe request (2026-10-14).
+//
+// The HUD worker used to open the bridge pipe ~9 times per refresh — one
+// connect / write / read / close per probe, each queued separately for the
+// game's main thread. powrprof.dll now accepts a batch request on a single
+// connection (swfoc_lua_bridge/pipe_protocol.h is the server-side spec):
+//
+//     "@batch N\n"  + N chunks, each '\n'-terminated
+//     "@batch N nul\n" + N chunks, each NUL-terminated (multi-line chunks)
+//
+// All N chunks run back to back in one main-thread drain pass, so the
+// snapshot is internally consistent within one game tick, and the reply is
+// one length-prefixed frame:
+//
+//     "@batch N\n" then per chunk "OK <len>\n<bytes>" or "ERR <len>\n<bytes>"
+//
+// This header is the pure kernel — request building and reply parsing have a
+// right and a wrong answer and are pinned by overlay_bridge_batch_test.cpp.
+// The pipe round-trip itself stays in hud_state.cpp (BridgeBatchProbe).
+//
+// RED-GREEN REGRESSION PINS (overlay_bridge_batch_test.cpp)
+// --------------------------------------------------------
+//   - NEWLINE FRAMING      : single-line chunks produce "@batch N\n" framing.
+//   - NUL FRAMING          : any chunk with a '\n' switches the whole request
+//                            to "@batch N nul" — a newline-framed multi-line
+//                            chunk would be split into extra frames.
+//   - CAP / EMPTY / NUL    : 0 chunks, > kMaxBridgeBatch chunks, an empty
+//                            chunk or an embedded NUL build no request.
+//   - COUNT MISMATCH       : a reply announcing a different N is rejected.
+//   - LEGACY ERR REPLY     : a pre-batch bridge answers "ERR: ..." — parsed
+//                            as "not a batch reply" so the worker can fall
+//                            back to per-probe round-trips.
+//   - TRUNCATED PAYLOAD    : a length larger than the remaining bytes fails.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_bridge_batch_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace swfoc_overlay
+{
+    // Mirrors PIPE_BATCH_MAX in swfoc_lua_bridge/pipe_protocol.h.
+    constexpr int kMaxBridgeBatch = 64;
+
+    struct BridgeBatchResult
+    {
+        bool        ok = false;   // chunk ran without a Lua error
+        std::string payload;      // tostring(result), "" for nil, or the error
+    };
+
+    // Build the request text for `count` chunks. Returns false (leaving
+    // `out` empty) when count is outside [1, kMaxBridgeBatch] or any chunk
+    // is empty or carries an embedded NUL.
+    inline bool BuildBridgeBatchRequest(const std::string* chunks, int count,
+                                        std::string& out)
+    {
+        out.clear();
+        if (chunks == nullptr || count < 1 || count > kMaxBridgeBatch)
+        {
+            return false;
+        }
+        bool multiLine = false;
+        for (int i = 0; i < count; ++i)
+        {
+            if (chunks[i].empty()
+                || chunks[i].find('\0') != std::string::npos)
+            {
+                return false;
+            }
+            if (chunks[i].find('\n') != std::string::npos)
+            {
+                multiLine = true;
+            }
+        }
+        out = "@batch " + std::to_string(count) + (multiLine ? " nul\n" : "\n");
+        const char terminator = multiLine ? '\0' : '\n';
+        for (int i = 0; i < count; ++i)
+        {
+            out += chunks[i];
+            out += terminator;
+        }
+        return true;
+    }
+
+    // Parse a batch reply into out[0..count). Returns true only when the
+    // reply is a well-formed batch frame announcing exactly `count` entries.
+    inline bool ParseBridgeBatchReply(const std::string& reply, int count,
+                                      BridgeBatchResult* out)
+    {
+        const std::string header = "@batch " + std::to_string(count) + "\n";
+        if (out == nullptr || reply.compare(0, header.size(), header) != 0)
+        {
+            return false;
+        }
+        std::size_t pos = header.size();
+        for (int i = 0; i < count; ++i)
+        {
+            bool ok = false;
+            if (reply.compare(pos, 3, "OK ") == 0)
+            {
+                ok = true;
+                pos += 3;
+            }
+            else if (reply.compare(pos, 4, "ERR ") == 0)
+            {
+                pos += 4;
+            }
+            else
+            {
+                return false;
+            }
+            std::size_t len = 0;
+            std::size_t digits = 0;
+            while (pos < reply.size() && reply[pos] >= '0' && reply[pos] <= '9')
+            {
+                len = len * 10 + static_cast<std::size_t>(reply[pos] - '0');
+                ++pos;
+                ++digits;
+            }
+            if (digits == 0 || pos >= reply.size() || reply[pos] != '\n')
+            {
+                return false;
+            }
+            ++pos;
+            if (reply.size() - pos < len)
+            {
+                return false;
+            }
+            out[i].ok = ok;
+            out[i].payload.assign(reply, pos, len);
+            pos += len;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,152 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_batch_test.cpp — unit test for
+// overlay_bridge_batch.h (2026-10-14).
+//
+// overlay_bridge_batch.h builds the "@batch N" request the HUD worker sends
+// to powrprof.dll and parses the length-prefixed multi-result reply. This test
+// pins both halves against the wire format in
+// swfoc_lua_bridge/pipe_protocol.h so the worker (hud_state.cpp) can depend
+// on them build-only.
+//
+// overlay_bridge_batch.h is header-only and std-only. Build + run via
+// build_bridge_batch_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - NEWLINE FRAMING      : single-line chunks -> "@batch N\n" + "chunk\n"...
+//   - NUL FRAMING          : a multi-line chunk switches to "@batch N nul".
+//   - CAP / EMPTY / NUL    : out-of-range counts and bad chunks build nothing.
+//   - COUNT MISMATCH       : a reply announcing a different N is rejected.
+//   - LEGACY ERR REPLY     : "ERR: ..." from a pre-batch bridge is rejected.
+//   - TRUNCATED PAYLOAD    : a length past the end of the reply is rejected.
+// =============================================================================
+
+#include "overlay_bridge_batch.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectStr(const char* name, const std::string& got,
+                   const std::string& want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got : %s\n    want: %s\n",
+                        name, got.c_str(), want.c_str());
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::BridgeBatchResult;
+    using swfoc_overlay::BuildBridgeBatchRequest;
+    using swfoc_overlay::ParseBridgeBatchReply;
+    using swfoc_overlay::kMaxBridgeBatch;
+}
+
+int main()
+{
+    std::printf("=== overlay_bridge_batch.h unit test ===\n");
+
+    // ---- Request building --------------------------------------------------
+    {
+        Section("request building");
+
+        const std::string lines[2] = { "return 1", "return SWFOC_GetCredits(0)" };
+        std::string req;
+        ExpectTrue("two single-line chunks build a request",
+                   BuildBridgeBatchRequest(lines, 2, req));
+        // PIN (NEWLINE FRAMING)
+        ExpectStr("PIN NEWLINE FRAMING: header + '\\n'-terminated chunks", req,
+                  "@batch 2\nreturn 1\nreturn SWFOC_GetCredits(0)\n");
+
+        const std::string multi[2] = { "return 1", "local a = 2\nreturn a" };
+        ExpectTrue("a multi-line chunk still builds a request",
+                   BuildBridgeBatchRequest(multi, 2, req));
+        // PIN (NUL FRAMING)
+        static const char kNulReq[] = "@batch 2 nul\nreturn 1\0local a = 2\nreturn a\0";
+        ExpectStr("PIN NUL FRAMING: multi-line chunk switches to nul framing",
+                  req, std::string(kNulReq, sizeof(kNulReq) - 1));
+
+        // PIN (CAP / EMPTY / NUL)
+        ExpectTrue("PIN CAP: zero chunks build nothing",
+                   !BuildBridgeBatchRequest(lines, 0, req) && req.empty());
+        std::string many[kMaxBridgeBatch + 1];
+        for (auto& c : many)
+        {
+            c = "return 1";
+        }
+        ExpectTrue("kMaxBridgeBatch chunks are accepted",
+                   BuildBridgeBatchRequest(many, kMaxBridgeBatch, req));
+        ExpectTrue("PIN CAP: kMaxBridgeBatch + 1 chunks build nothing",
+                   !BuildBridgeBatchRequest(many, kMaxBridgeBatch + 1, req));
+        const std::string empty[1] = { "" };
+        ExpectTrue("PIN EMPTY: an empty chunk builds nothing",
+                   !BuildBridgeBatchRequest(empty, 1, req));
+        const std::string nul[1] = { std::string("return\0 1", 9) };
+        ExpectTrue("PIN NUL: an embedded NUL builds nothing",
+                   !BuildBridgeBatchRequest(nul, 1, req));
+    }
+
+    // ---- Reply parsing -----------------------------------------------------
+    {
+        Section("reply parsing");
+
+        const std::string reply = "@batch 3\nOK 2\n42ERR 8\nbad\nargsOK 0\n";
+        BridgeBatchResult out[3];
+        ExpectTrue("a well-formed 3-entry reply parses",
+                   ParseBridgeBatchReply(reply, 3, out));
+        ExpectTrue("entry 0 is OK", out[0].ok);
+        ExpectStr("entry 0 payload", out[0].payload, "42");
+        ExpectTrue("entry 1 is ERR", !out[1].ok);
+        ExpectStr("entry 1 payload keeps its newline", out[1].payload, "bad\nargs");
+        ExpectTrue("entry 2 (nil) is an empty OK",
+                   out[2].ok && out[2].payload.empty());
+
+        // PIN (COUNT MISMATCH)
+        ExpectTrue("PIN COUNT MISMATCH: announcing 3 but expecting 2 fails",
+                   !ParseBridgeBatchReply(reply, 2, out));
+        // PIN (LEGACY ERR REPLY)
+        ExpectTrue("PIN LEGACY ERR REPLY: pre-batch bridge error is rejected",
+                   !ParseBridgeBatchReply(
+                       "ERR: [string \"=pipe\"]:1: unexpected symbol near '@'", 1, out));
+        // PIN (TRUNCATED PAYLOAD)
+        ExpectTrue("PIN TRUNCATED PAYLOAD: length past the end fails",
+                   !ParseBridgeBatchReply("@batch 1\nOK 9\nabc", 1, out));
+        ExpectTrue("a missing entry fails",
+                   !ParseBridgeBatchReply("@batch 2\nOK 1\na", 2, out));
+        ExpectTrue("a garbage status fails",
+                   !ParseBridgeBatchReply("@batch 1\nYES 1\na", 1, out));
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
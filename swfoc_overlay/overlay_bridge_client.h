@@ -0,0 +1,197 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_client.h — framing and reconnect rules for the
+// overlay's pooled persistent bridge connection (2026-10-14).
+//
+// BridgeProbe used to pay CreateFileA / SetNamedPipeHandleState / WriteFile /
+// one 1 KB ReadFile / CloseHandle on every call, from both the HUD worker and
+// the action worker, and silently truncated replies past 1023 bytes.
+// hud_state.cpp now keeps a small pool of "@persist" sessions
+// (swfoc_lua_bridge/pipe_protocol.h is the server-side spec) and reads each
+// reply until it is complete:
+//
+//   * text reply     : ends at its '\n' terminator (the bridge always sends one)
+//   * "@batch N"     : header plus N length-prefixed entries
+//   * "@telemetry"   : the record size announced at offset 6
+//
+// A reply of the wrong shape (an "ERR: ..." line in answer to a batch or
+// telemetry request) is complete at its '\n'. The session is newline-framed,
+// so a probe whose Lua spans several lines cannot ride it and takes the
+// legacy one-shot path instead.
+//
+// Connect failures back off exponentially; a bridge that does not ack
+// "@persist" (pre-persistent build) is left on the one-shot path and only
+// re-probed after kBridgeLegacyRetryMs.
+//
+// RED-GREEN REGRESSION PINS (overlay_bridge_client_test.cpp)
+// --------------------------------------------------------
+//   - TEXT TERMINATOR      : a text reply is incomplete until its '\n'.
+//   - BATCH LENGTHS        : a payload containing '\n' does not end a batch
+//                            reply early; a missing entry keeps it open.
+//   - TELEMETRY SIZE       : the record is complete at its announced size,
+//                            never at an embedded '\n' byte.
+//   - LEGACY ERR REPLY     : "ERR: ...\n" completes any request kind.
+//   - PERSISTABLE FRAMES   : multi-line, NUL-carrying or empty Lua is refused.
+//   - BACKOFF              : doubles per failure, caps, resets on connect.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_bridge_client_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace swfoc_overlay
+{
+    // Mirrors PIPE_DIRECTIVE_PERSIST in swfoc_lua_bridge/pipe_protocol.h.
+    constexpr const char* kBridgePersistRequest = "@persist\n";
+    constexpr const char* kBridgePersistAck = "OK\n";
+
+    // Persistent sessions held open at once. The bridge runs 4 pipe
+    // instances; two (HUD worker + action worker) leave room for scripts.
+    constexpr int kBridgePoolSize = 2;
+
+    constexpr uint64_t kBridgeReconnectMinMs = 100;
+    constexpr uint64_t kBridgeReconnectMaxMs = 2000;
+    constexpr uint64_t kBridgeLegacyRetryMs = 30000;
+
+    enum class BridgeReplyKind
+    {
+        Text,       // one Lua chunk, '\n'-terminated reply
+        Batch,      // "@batch N" request, length-prefixed reply
+        Telemetry,  // "@telemetry" request, fixed-size binary reply
+    };
+
+    // True when `frame` (Lua plus its '\n' terminator) is exactly one frame
+    // of a newline-framed persistent session.
+    inline bool IsPersistableBridgeFrame(const std::string& frame)
+    {
+        if (frame.size() < 2 || frame.back() != '\n') return false;
+        for (std::size_t i = 0; i + 1 < frame.size(); ++i)
+        {
+            if (frame[i] == '\n' || frame[i] == '\0') return false;
+        }
+        return true;
+    }
+
+    namespace client_detail
+    {
+        inline bool StartsWith(const std::string& s, const char* prefix)
+        {
+            return s.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+        }
+
+        // True when `s` is a proper prefix of `literal`.
+        inline bool IsPrefixOf(const std::string& s, const char* literal)
+        {
+            const std::size_t n = std::char_traits<char>::length(literal);
+            return s.size() < n && s.compare(0, s.size(), literal, s.size()) == 0;
+        }
+
+        // Reads a decimal at s[*pos] terminated by `stop`; advances past it.
+        inline bool ReadCount(const std::string& s, std::size_t* pos,
+                              char stop, std::size_t* out)
+        {
+            std::size_t v = 0;
+            std::size_t digits = 0;
+            std::size_t i = *pos;
+            while (i < s.size() && s[i] >= '0' && s[i] <= '9' && digits < 9)
+            {
+                v = v * 10 + static_cast<std::size_t>(s[i] - '0');
+                ++i;
+                ++digits;
+            }
+            if (digits == 0 || i >= s.size() || s[i] != stop) return false;
+            *pos = i + 1;
+            *out = v;
+            return true;
+        }
+
+        // Batch body is complete (or malformed, which no further bytes fix).
+        inline bool BatchComplete(const std::string& r)
+        {
+            std::size_t pos = 7;  // "@batch "
+            std::size_t count = 0;
+            if (!ReadCount(r, &pos, '\n', &count))
+            {
+                // Header still arriving unless it already went wrong.
+                return r.find('\n') != std::string::npos;
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (r.compare(pos, 3, "OK ") == 0) pos += 3;
+                else if (r.compare(pos, 4, "ERR ") == 0) pos += 4;
+                else return r.size() >= pos + 4;  // malformed once 4 bytes are in
+                std::size_t len = 0;
+                const std::size_t lenAt = pos;
+                if (!ReadCount(r, &pos, '\n', &len))
+                {
+                    return r.find('\n', lenAt) != std::string::npos;
+                }
+                if (r.size() - pos < len) return false;
+                pos += len;
+            }
+            return true;
+        }
+    }
+
+    // True once `reply` holds a whole reply to a request of `kind`.
+    inline bool IsBridgeReplyComplete(BridgeReplyKind kind, const std::string& reply)
+    {
+        if (reply.empty()) return false;
+        if (kind == BridgeReplyKind::Batch && client_detail::StartsWith(reply, "@batch "))
+        {
+            return client_detail::BatchComplete(reply);
+        }
+        if (kind == BridgeReplyKind::Telemetry && client_detail::StartsWith(reply, "SWTM"))
+        {
+            if (reply.size() < 8) return false;
+            const std::size_t size = static_cast<unsigned char>(reply[6])
+                | (static_cast<std::size_t>(static_cast<unsigned char>(reply[7])) << 8);
+            return reply.size() >= size;
+        }
+        // Too short yet to tell a framed reply from an "ERR: ..." line.
+        if (kind == BridgeReplyKind::Batch && client_detail::IsPrefixOf(reply, "@batch ")) return false;
+        if (kind == BridgeReplyKind::Telemetry && client_detail::IsPrefixOf(reply, "SWTM")) return false;
+        return reply.back() == '\n';
+    }
+
+    // Connect pacing for one pool slot.
+    struct BridgeReconnectState
+    {
+        uint32_t failures = 0;
+        uint64_t next_attempt_ms = 0;
+    };
+
+    inline bool BridgeMayConnect(const BridgeReconnectState& s, uint64_t now_ms)
+    {
+        return now_ms >= s.next_attempt_ms;
+    }
+
+    inline void BridgeNoteConnectFailure(BridgeReconnectState& s, uint64_t now_ms)
+    {
+        uint64_t delay = kBridgeReconnectMinMs;
+        for (uint32_t i = 0; i < s.failures && delay < kBridgeReconnectMaxMs; ++i)
+        {
+            delay *= 2;
+        }
+        if (delay > kBridgeReconnectMaxMs) delay = kBridgeReconnectMaxMs;
+        ++s.failures;
+        s.next_attempt_ms = now_ms + delay;
+    }
+
+    // The bridge answered "@persist" with something other than the ack.
+    inline void BridgeNoteLegacyBridge(BridgeReconnectState& s, uint64_t now_ms)
+    {
+        s.failures = 0;
+        s.next_attempt_ms = now_ms + kBridgeLegacyRetryMs;
+    }
+
+    inline void BridgeNoteConnected(BridgeReconnectState& s)
+    {
+        s.failures = 0;
+        s.next_attempt_ms = 0;
+    }
+}
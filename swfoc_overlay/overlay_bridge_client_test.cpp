@@ -0,0 +1,168 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_client_test.cpp — unit test for
+// overlay_bridge_client.h (2026-10-14).
+//
+// overlay_bridge_client.h decides when a reply read off a pooled persistent
+// bridge session is complete, which probes may ride a session, and how often
+// a slot reconnects. A wrong "complete" answer either stalls the HUD worker
+// until its deadline or leaves half a reply in the pipe for the next probe,
+// so the framing rules are pinned here rather than found live.
+//
+// overlay_bridge_client.h is header-only and std-only. Build + run via
+// build_bridge_client_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - TEXT TERMINATOR      : a text reply is incomplete until its '\n'.
+//   - BATCH LENGTHS        : a '\n' inside a payload does not end a batch.
+//   - TELEMETRY SIZE       : complete at the announced size only.
+//   - LEGACY ERR REPLY     : "ERR: ...\n" completes any request kind.
+//   - PERSISTABLE FRAMES   : multi-line, NUL-carrying or empty Lua is refused.
+//   - BACKOFF              : doubles per failure, caps, resets on connect.
+// =============================================================================
+
+#include "overlay_bridge_client.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    // True when no proper prefix of `reply` is complete but the whole is.
+    bool CompleteOnlyAtEnd(swfoc_overlay::BridgeReplyKind kind, const std::string& reply)
+    {
+        for (std::size_t n = 0; n < reply.size(); ++n)
+        {
+            if (swfoc_overlay::IsBridgeReplyComplete(kind, reply.substr(0, n))) return false;
+        }
+        return swfoc_overlay::IsBridgeReplyComplete(kind, reply);
+    }
+
+    std::string TelemetryRecord(std::size_t size)
+    {
+        std::string r(size, '\0');
+        r.replace(0, 4, "SWTM");
+        r[4] = 1;
+        r[6] = static_cast<char>(size & 0xFF);
+        r[7] = static_cast<char>(size >> 8);
+        r[12] = '\n';  // a credits byte that happens to be 0x0A
+        return r;
+    }
+
+    using swfoc_overlay::BridgeReplyKind;
+    using swfoc_overlay::BridgeReconnectState;
+    using swfoc_overlay::IsBridgeReplyComplete;
+    using swfoc_overlay::IsPersistableBridgeFrame;
+}
+
+int main()
+{
+    std::printf("=== overlay_bridge_client.h unit test ===\n");
+
+    // ---- Reply completeness ------------------------------------------------
+    {
+        Section("reply completeness");
+
+        // PIN (TEXT TERMINATOR)
+        ExpectTrue("PIN TEXT TERMINATOR: complete exactly at the '\\n'",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Text, "12500\n"));
+        ExpectTrue("a text reply past 1 KB is read whole",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Text, std::string(4096, 'x') + "\n"));
+        ExpectTrue("the persist ack is a text reply",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Text, swfoc_overlay::kBridgePersistAck));
+
+        // PIN (BATCH LENGTHS)
+        ExpectTrue("PIN BATCH LENGTHS: payload newlines do not end the reply",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Batch,
+                                     "@batch 2\nOK 4\na\nb\nERR 5\nboom\n"));
+        ExpectTrue("an empty nil payload completes its entry",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Batch, "@batch 2\nOK 0\nOK 1\n7"));
+        ExpectTrue("a missing last entry keeps the reply open",
+                   !IsBridgeReplyComplete(BridgeReplyKind::Batch, "@batch 2\nOK 1\n7"));
+        ExpectTrue("a malformed entry header stops the read",
+                   IsBridgeReplyComplete(BridgeReplyKind::Batch, "@batch 2\nOK 1\n7what"));
+
+        // PIN (TELEMETRY SIZE)
+        ExpectTrue("PIN TELEMETRY SIZE: complete at the announced size",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Telemetry, TelemetryRecord(56)));
+        ExpectTrue("a larger v2 record waits for its own size",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Telemetry, TelemetryRecord(64)));
+
+        // PIN (LEGACY ERR REPLY)
+        const std::string err = "ERR: unknown directive\n";
+        ExpectTrue("PIN LEGACY ERR REPLY: completes a batch request",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Batch, err));
+        ExpectTrue("PIN LEGACY ERR REPLY: completes a telemetry request",
+                   CompleteOnlyAtEnd(BridgeReplyKind::Telemetry, err));
+        ExpectTrue("a text reply that looks like a batch header is still text",
+                   IsBridgeReplyComplete(BridgeReplyKind::Text, "@batch 3\n"));
+    }
+
+    // ---- Persistable frames ------------------------------------------------
+    {
+        Section("persistable frames");
+
+        // PIN (PERSISTABLE FRAMES)
+        ExpectTrue("a one-line chunk rides the session",
+                   IsPersistableBridgeFrame("return SWFOC_GetCredits()\n"));
+        ExpectTrue("PIN PERSISTABLE FRAMES: a multi-line chunk is refused",
+                   !IsPersistableBridgeFrame("local a = 1\nreturn a\n"));
+        ExpectTrue("PIN PERSISTABLE FRAMES: an embedded NUL is refused",
+                   !IsPersistableBridgeFrame(std::string("return 1\0x\n", 11)));
+        ExpectTrue("PIN PERSISTABLE FRAMES: an empty chunk is refused",
+                   !IsPersistableBridgeFrame("\n"));
+        ExpectTrue("an unterminated frame is refused",
+                   !IsPersistableBridgeFrame("return 1"));
+    }
+
+    // ---- Reconnect backoff -------------------------------------------------
+    {
+        Section("reconnect backoff");
+
+        BridgeReconnectState s;
+        ExpectTrue("a fresh slot may connect", swfoc_overlay::BridgeMayConnect(s, 0));
+        swfoc_overlay::BridgeNoteConnectFailure(s, 1000);
+        ExpectTrue("first failure waits the minimum",
+                   !swfoc_overlay::BridgeMayConnect(s, 1099)
+                   && swfoc_overlay::BridgeMayConnect(s, 1100));
+        swfoc_overlay::BridgeNoteConnectFailure(s, 2000);
+        // PIN (BACKOFF)
+        ExpectTrue("PIN BACKOFF: the second failure doubles the wait",
+                   s.next_attempt_ms == 2000 + 2 * swfoc_overlay::kBridgeReconnectMinMs);
+        for (int i = 0; i < 40; ++i) swfoc_overlay::BridgeNoteConnectFailure(s, 5000);
+        ExpectTrue("PIN BACKOFF: the wait caps",
+                   s.next_attempt_ms == 5000 + swfoc_overlay::kBridgeReconnectMaxMs);
+        swfoc_overlay::BridgeNoteConnected(s);
+        ExpectTrue("PIN BACKOFF: a connect resets it",
+                   s.failures == 0 && swfoc_overlay::BridgeMayConnect(s, 0));
+        swfoc_overlay::BridgeNoteLegacyBridge(s, 100);
+        ExpectTrue("a legacy bridge is re-probed only after the long retry",
+                   !swfoc_overlay::BridgeMayConnect(s, 100 + swfoc_overlay::kBridgeLegacyRetryMs - 1)
+                   && swfoc_overlay::BridgeMayConnect(s, 100 + swfoc_overlay::kBridgeLegacyRetryMs));
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
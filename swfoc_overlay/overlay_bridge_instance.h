@@ -0,0 +1,91 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_instance.h — the bridge object names the
+// overlay opens, scoped to the bridge instance it shares a process with
+// (2026-10-14).
+//
+// powrprof.dll suffixes its pipe and mappings with the SWFOC_BRIDGE_INSTANCE
+// tag so several games can run on one test-farm machine
+// (swfoc_lua_bridge/instance_names.h is the spec). The overlay is loaded
+// into the same StarWarsG.exe, sees the same environment and the same PID,
+// so it resolves the same tag by the same rules and opens:
+//
+//     \\.\pipe\swfoc_bridge[_<tag>]
+//     Local\SWFOC_Bridge_Events[_<tag>]
+//     Local\SWFOC_Bridge_Units[_<tag>]
+//
+// Unset (the normal case) keeps the fixed names. "pid" means the process's
+// PID. A value that is not 1..31 of [A-Za-z0-9_-] is ignored by the bridge,
+// which then serves the fixed names, so it is ignored here too.
+//
+// RED-GREEN REGRESSION PINS (overlay_bridge_instance_test.cpp)
+// -----------------------------------------------------------
+//   - UNSET IS LEGACY  : no variable, or an empty one, opens the fixed names.
+//   - PID TAG          : "pid" becomes the decimal process id.
+//   - BAD TAG IGNORED  : a tag the bridge refuses falls back to the fixed
+//                        names, exactly as the bridge does.
+//   - SUFFIX           : every name gets "_<tag>".
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no bridge. Unit-tested
+// with a plain g++ (build_bridge_instance_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace swfoc_overlay
+{
+    // Mirrors INSTANCE_ENV_VAR / INSTANCE_TAG_PID / INSTANCE_TAG_MAX and
+    // PIPE_NAME / SHMEM_EVT_NAME / SHMEM_UNITS_NAME in swfoc_lua_bridge.
+    constexpr const char* kBridgeInstanceEnvVar = "SWFOC_BRIDGE_INSTANCE";
+    constexpr const char* kBridgeInstancePid = "pid";
+    constexpr std::size_t kBridgeInstanceTagMax = 31;
+    constexpr const char* kBridgePipeBaseName = R"(\\.\pipe\swfoc_bridge)";
+    constexpr const char* kBridgeEventsBaseName = "Local\\SWFOC_Bridge_Events";
+    constexpr const char* kBridgeUnitsBaseName = "Local\\SWFOC_Bridge_Units";
+
+    struct BridgeInstanceNames
+    {
+        std::string tag;     // "" for the fixed names
+        std::string pipe;
+        std::string events;
+        std::string units;
+    };
+
+    inline bool BridgeInstanceTagValid(const char* tag)
+    {
+        if (tag == nullptr || tag[0] == '\0') return false;
+        const std::size_t n = std::strlen(tag);
+        if (n > kBridgeInstanceTagMax) return false;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const char c = tag[i];
+            const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+                            || (c >= '0' && c <= '9') || c == '_' || c == '-';
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    // `env` is the SWFOC_BRIDGE_INSTANCE value (nullptr when unset), `pid`
+    // this process's id.
+    inline BridgeInstanceNames ResolveBridgeInstanceNames(const char* env, uint32_t pid)
+    {
+        BridgeInstanceNames names;
+        if (env != nullptr && std::strcmp(env, kBridgeInstancePid) == 0)
+        {
+            names.tag = std::to_string(pid);
+        }
+        else if (BridgeInstanceTagValid(env))
+        {
+            names.tag = env;
+        }
+        const std::string suffix = names.tag.empty() ? std::string() : "_" + names.tag;
+        names.pipe = kBridgePipeBaseName + suffix;
+        names.events = kBridgeEventsBaseName + suffix;
+        names.units = kBridgeUnitsBaseName + suffix;
+        return names;
+    }
+}
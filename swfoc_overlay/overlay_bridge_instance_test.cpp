@@ -0,0 +1,112 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_instance_test.cpp — unit test for
+// overlay_bridge_instance.h (2026-10-14).
+//
+// The overlay and the bridge resolve SWFOC_BRIDGE_INSTANCE independently, in
+// one process. If they disagree on even one character the HUD silently polls
+// a pipe and maps tables nobody serves, so every rule the bridge applies
+// (swfoc_lua_bridge/instance_names.h) is pinned here from the overlay side.
+//
+// overlay_bridge_instance.h is header-only and std-only. Build + run via
+// build_bridge_instance_test.bat — no game, no pipe, no ImGui, no D3D9.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - UNSET IS LEGACY  : nullptr and "" open the fixed names.
+//   - PID TAG          : "pid" is the decimal process id.
+//   - BAD TAG IGNORED  : spaces, slashes, 32 chars fall back to fixed names.
+//   - SUFFIX           : pipe, events and units all get "_<tag>".
+// =============================================================================
+
+#include "overlay_bridge_instance.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqStr(const char* name, const std::string& got, const std::string& want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got \"%s\", want \"%s\"\n", name, got.c_str(), want.c_str());
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::BridgeInstanceNames;
+    using swfoc_overlay::ResolveBridgeInstanceNames;
+
+    bool IsLegacy(const BridgeInstanceNames& n)
+    {
+        return n.tag.empty() && n.pipe == R"(\\.\pipe\swfoc_bridge)"
+               && n.events == "Local\\SWFOC_Bridge_Events" && n.units == "Local\\SWFOC_Bridge_Units";
+    }
+}
+
+int main()
+{
+    std::printf("overlay_bridge_instance_test\n");
+
+    // ---- Fixed names -------------------------------------------------------
+    {
+        Section("fixed names");
+
+        // PIN (UNSET IS LEGACY)
+        ExpectTrue("PIN UNSET IS LEGACY: no variable", IsLegacy(ResolveBridgeInstanceNames(nullptr, 42)));
+        ExpectTrue("PIN UNSET IS LEGACY: an empty variable", IsLegacy(ResolveBridgeInstanceNames("", 42)));
+
+        // PIN (BAD TAG IGNORED)
+        ExpectTrue("PIN BAD TAG IGNORED: a space", IsLegacy(ResolveBridgeInstanceNames("a b", 42)));
+        ExpectTrue("PIN BAD TAG IGNORED: a path separator", IsLegacy(ResolveBridgeInstanceNames("a\\b", 42)));
+        ExpectTrue("PIN BAD TAG IGNORED: 32 characters",
+                   IsLegacy(ResolveBridgeInstanceNames(std::string(32, 'x').c_str(), 42)));
+        ExpectTrue("31 characters is still a tag",
+                   ResolveBridgeInstanceNames(std::string(31, 'x').c_str(), 42).tag == std::string(31, 'x'));
+        ExpectTrue("PID is case-sensitive, as in the bridge", ResolveBridgeInstanceNames("PID", 42).tag == "PID");
+    }
+
+    // ---- Tagged names ------------------------------------------------------
+    {
+        Section("tagged names");
+
+        // PIN (PID TAG)
+        ExpectEqStr("PIN PID TAG: pid is the process id", ResolveBridgeInstanceNames("pid", 4711).tag, "4711");
+
+        // PIN (SUFFIX)
+        const BridgeInstanceNames n = ResolveBridgeInstanceNames("ci-7_a", 1);
+        ExpectEqStr("PIN SUFFIX: pipe", n.pipe, R"(\\.\pipe\swfoc_bridge_ci-7_a)");
+        ExpectEqStr("PIN SUFFIX: event ring", n.events, "Local\\SWFOC_Bridge_Events_ci-7_a");
+        ExpectEqStr("PIN SUFFIX: unit table", n.units, "Local\\SWFOC_Bridge_Units_ci-7_a");
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
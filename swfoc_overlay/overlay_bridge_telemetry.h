@@ -0,0 +1,122 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_telemetry.h — client side of the bridge's
+// "@telemetry" pipe request (2026-10-14).
+//
+// Most HUD getters (credits, kills, deaths, units alive, multipliers) used to
+// come back as Lua strings the worker std::stoi'd back into numbers, and
+// every one of them cost a main-thread drain. powrprof.dll now answers
+// "@telemetry\n" straight from its pipe thread with one fixed-size binary
+// record (PipeTelemetry in swfoc_lua_bridge/pipe_protocol.h is the spec):
+//
+//     off  size  field
+//       0     4  magic "SWTM"
+//       4     2  version (1)
+//       6     2  record size (56)
+//       8     4  local slot (int32, -1 = none)
+//      12     4  credits (float)
+//      16     4  units alive (int32)
+//      20     4  local kills (int32)
+//      24     4  local deaths (int32)
+//      28     4  damage multiplier (float)
+//      32     4  fire-rate multiplier (float)
+//      36     4  reserved
+//      40     8  luaD_call tick at reply time (int64)
+//      48     8  luaD_call tick of the slot/credits/units sample (int64)
+//
+// All fields are little-endian. The parser reads them byte-wise so it does
+// not depend on host endianness or struct packing.
+//
+// RED-GREEN REGRESSION PINS (overlay_bridge_telemetry_test.cpp)
+// ------------------------------------------------------------
+//   - ROUND TRIP           : every field decodes at its documented offset.
+//   - LEGACY ERR REPLY     : "ERR: unknown directive" (pre-telemetry bridge)
+//                            is rejected so the worker falls back to Lua.
+//   - SHORT RECORD         : fewer bytes than the announced size fail.
+//   - NEWER VERSION        : a larger record with a higher version still
+//                            parses its version-1 prefix.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_bridge_telemetry_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace swfoc_overlay
+{
+    // Mirrors PIPE_DIRECTIVE_TELEMETRY / PIPE_TELEMETRY_MAGIC in
+    // swfoc_lua_bridge/pipe_protocol.h.
+    constexpr const char* kBridgeTelemetryRequest = "@telemetry\n";
+    constexpr uint32_t kBridgeTelemetryMagic = 0x4D545753u;  // "SWTM"
+    constexpr std::size_t kBridgeTelemetryV1Size = 56;
+
+    struct BridgeTelemetry
+    {
+        int32_t local_slot = -1;
+        float   credits = 0.0f;
+        int32_t units_alive = 0;
+        int32_t kills = 0;
+        int32_t deaths = 0;
+        float   damage_mult = 1.0f;
+        float   firerate_mult = 1.0f;
+        int64_t tick = 0;
+        int64_t sample_tick = 0;
+    };
+
+    namespace telemetry_detail
+    {
+        inline uint64_t ReadLe(const std::string& s, std::size_t off,
+                               std::size_t bytes)
+        {
+            uint64_t v = 0;
+            for (std::size_t i = 0; i < bytes; ++i)
+            {
+                v |= static_cast<uint64_t>(
+                         static_cast<unsigned char>(s[off + i])) << (8 * i);
+            }
+            return v;
+        }
+
+        inline float ReadFloat(const std::string& s, std::size_t off)
+        {
+            const uint32_t bits = static_cast<uint32_t>(ReadLe(s, off, 4));
+            float f;
+            std::memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+    }
+
+    // Decode a "@telemetry" reply. Returns false for anything that is not a
+    // complete record (wrong magic, version 0, size below the version-1
+    // layout or past the end of `reply`).
+    inline bool ParseBridgeTelemetry(const std::string& reply,
+                                     BridgeTelemetry& out)
+    {
+        using telemetry_detail::ReadFloat;
+        using telemetry_detail::ReadLe;
+        if (reply.size() < kBridgeTelemetryV1Size
+            || ReadLe(reply, 0, 4) != kBridgeTelemetryMagic)
+        {
+            return false;
+        }
+        const std::size_t version = static_cast<std::size_t>(ReadLe(reply, 4, 2));
+        const std::size_t size = static_cast<std::size_t>(ReadLe(reply, 6, 2));
+        if (version < 1 || size < kBridgeTelemetryV1Size || size > reply.size())
+        {
+            return false;
+        }
+        out.local_slot    = static_cast<int32_t>(ReadLe(reply, 8, 4));
+        out.credits       = ReadFloat(reply, 12);
+        out.units_alive   = static_cast<int32_t>(ReadLe(reply, 16, 4));
+        out.kills         = static_cast<int32_t>(ReadLe(reply, 20, 4));
+        out.deaths        = static_cast<int32_t>(ReadLe(reply, 24, 4));
+        out.damage_mult   = ReadFloat(reply, 28);
+        out.firerate_mult = ReadFloat(reply, 32);
+        out.tick          = static_cast<int64_t>(ReadLe(reply, 40, 8));
+        out.sample_tick   = static_cast<int64_t>(ReadLe(reply, 48, 8));
+        return true;
+    }
+}
@@ -0,0 +1,146 @@
+// =============================================================================
+// swfoc_overlay/overlay_bridge_telemetry_test.cpp — unit test for
+// overlay_bridge_telemetry.h (2026-10-14).
+//
+// overlay_bridge_telemetry.h decodes the binary record powrprof.dll returns
+// for "@telemetry". This test builds records byte by byte from the offset
+// table in the header (which mirrors PipeTelemetry in
+// swfoc_lua_bridge/pipe_protocol.h) so a layout drift on either side fails
+// here rather than as garbage numbers on the HUD.
+//
+// overlay_bridge_telemetry.h is header-only and std-only. Build + run via
+// build_bridge_telemetry_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - ROUND TRIP           : every field decodes at its documented offset.
+//   - LEGACY ERR REPLY     : "ERR: unknown directive" is rejected.
+//   - SHORT RECORD         : fewer bytes than the announced size fail.
+//   - NEWER VERSION        : a larger version-2 record parses its v1 prefix.
+// =============================================================================
+
+#include "overlay_bridge_telemetry.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    void PutLe(std::string& s, std::size_t off, uint64_t v, std::size_t bytes)
+    {
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            s[off + i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void PutFloat(std::string& s, std::size_t off, float f)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        PutLe(s, off, bits, 4);
+    }
+
+    std::string MakeRecord(std::size_t size, uint16_t version)
+    {
+        std::string r(size, '\0');
+        PutLe(r, 0, swfoc_overlay::kBridgeTelemetryMagic, 4);
+        PutLe(r, 4, version, 2);
+        PutLe(r, 6, size, 2);
+        PutLe(r, 8, 2, 4);                                  // slot
+        PutFloat(r, 12, 12500.0f);                          // credits
+        PutLe(r, 16, 317, 4);                               // units alive
+        PutLe(r, 20, 41, 4);                                // kills
+        PutLe(r, 24, 7, 4);                                 // deaths
+        PutFloat(r, 28, 2.5f);                              // damage mult
+        PutFloat(r, 32, 0.5f);                              // fire-rate mult
+        PutLe(r, 40, 0x0000000123456789ull, 8);             // tick
+        PutLe(r, 48, 0x0000000123456000ull, 8);             // sample tick
+        return r;
+    }
+
+    using swfoc_overlay::BridgeTelemetry;
+    using swfoc_overlay::ParseBridgeTelemetry;
+    using swfoc_overlay::kBridgeTelemetryV1Size;
+}
+
+int main()
+{
+    std::printf("=== overlay_bridge_telemetry.h unit test ===\n");
+
+    // ---- Decoding ----------------------------------------------------------
+    {
+        Section("decoding");
+
+        BridgeTelemetry t;
+        // PIN (ROUND TRIP)
+        ExpectTrue("PIN ROUND TRIP: a version-1 record parses",
+                   ParseBridgeTelemetry(MakeRecord(kBridgeTelemetryV1Size, 1), t));
+        ExpectTrue("slot decodes", t.local_slot == 2);
+        ExpectTrue("credits decode", t.credits == 12500.0f);
+        ExpectTrue("units alive decode", t.units_alive == 317);
+        ExpectTrue("kills / deaths decode", t.kills == 41 && t.deaths == 7);
+        ExpectTrue("multipliers decode",
+                   t.damage_mult == 2.5f && t.firerate_mult == 0.5f);
+        ExpectTrue("ticks decode",
+                   t.tick == 0x123456789ll && t.sample_tick == 0x123456000ll);
+
+        std::string none = MakeRecord(kBridgeTelemetryV1Size, 1);
+        PutLe(none, 8, static_cast<uint32_t>(-1), 4);
+        ExpectTrue("slot -1 (no local player) decodes as negative",
+                   ParseBridgeTelemetry(none, t) && t.local_slot == -1);
+
+        // PIN (NEWER VERSION)
+        ExpectTrue("PIN NEWER VERSION: a larger v2 record parses its v1 prefix",
+                   ParseBridgeTelemetry(MakeRecord(kBridgeTelemetryV1Size + 8, 2), t)
+                   && t.kills == 41);
+    }
+
+    // ---- Rejection ---------------------------------------------------------
+    {
+        Section("rejection");
+
+        BridgeTelemetry t;
+        // PIN (LEGACY ERR REPLY)
+        ExpectTrue("PIN LEGACY ERR REPLY: text error is rejected",
+                   !ParseBridgeTelemetry(
+                       "ERR: unknown directive\n"
+                       "padding padding padding padding padding padding", t));
+        // PIN (SHORT RECORD)
+        std::string shortRec = MakeRecord(kBridgeTelemetryV1Size + 8, 2);
+        shortRec.resize(kBridgeTelemetryV1Size);
+        ExpectTrue("PIN SHORT RECORD: announced size past the end fails",
+                   !ParseBridgeTelemetry(shortRec, t));
+        ExpectTrue("a record below the v1 size fails",
+                   !ParseBridgeTelemetry(MakeRecord(kBridgeTelemetryV1Size, 1).substr(0, 40), t));
+        std::string v0 = MakeRecord(kBridgeTelemetryV1Size, 0);
+        ExpectTrue("version 0 fails", !ParseBridgeTelemetry(v0, t));
+        ExpectTrue("empty reply fails", !ParseBridgeTelemetry("", t));
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -30,6 +30,10 @@
 //       camera position as a 3-decimal "x.xxx,y.yyy,z.zzz" string. When no
 //       tactical camera is active it returns the literal "0.000,0.000,0.000"
 //       (NOT an ERR: string). (registered :8245; Lua_GetCameraPos :6011)
+//   SWFOC_CameraPath("play", path, loop) -> (2026-10-14) the bridge plays a
+//       whole "ms;x;y;z|ms;x;y;z|..." path itself, one pose per frame, so a
+//       fly-through over the bookmarks is one command instead of a
+//       SetCameraPos per step (swfoc_lua_bridge/camera_path.h).
 //
 // ParseCameraPos cannot tell "camera genuinely at the origin" from "no
 // active camera" — both wire-read as "0.000,0.000,0.000". That is the
@@ -62,6 +66,10 @@
 //   - PLAIN NUMBER ARGS            : BuildSetCameraPosCommand emits bare
 //                                    number literals — a copy-from-SWFOC_*Lua
 //                                    old form that LuaQuotes the coords fails.
+//   - TOUR IS ONE COMMAND          : BuildTour emits one SWFOC_CameraPath
+//                                    "play" through the set slots in slot
+//                                    order, segment_ms apart; fewer than two
+//                                    set slots yield an empty `lua`.
 //
 // THREADING: CameraBookmarks is touched ONLY by the render / input thread —
 // Save() / SaveFromWire() at the hotkey site, BuildRecall() / Get() while
@@ -274,6 +282,43 @@ namespace swfoc_overlay
                         FormatCoord(bm.x) + ", " + FormatCoord(bm.y) + ", " +
                         FormatCoord(bm.z) + ")";
             req.lua = BuildSetCameraPosCommand(bm.x, bm.y, bm.z);
+            req.key = "camera";  // only the last of several recalls matters
+            return req;
+        }
+
+        // Build the fly-through ActionRequest: one SWFOC_CameraPath "play"
+        // whose keys are the set slots in slot order, `segmentMs` apart, so
+        // the bridge flies the whole path without a command per step. The
+        // bookmarks carry no look-at target, so the camera keeps its
+        // rotation. Fewer than two set slots yield an EMPTY `lua`, like an
+        // unset recall.
+        ActionRequest BuildTour(int segmentMs, bool loop = false) const
+        {
+            ActionRequest req;
+            if (segmentMs < 1) segmentMs = 1;
+            std::string path;
+            int keys = 0;
+            for (std::size_t slot = 0; slot < kSlots; ++slot)
+            {
+                if (!slots_[slot].set) continue;
+                const CameraBookmark& bm = slots_[slot];
+                if (!path.empty()) path += "|";
+                path += std::to_string(keys * segmentMs) + ";" + FormatCoord(bm.x) +
+                        ";" + FormatCoord(bm.y) + ";" + FormatCoord(bm.z);
+                ++keys;
+            }
+            if (keys < 2)
+            {
+                req.label = "Camera tour needs two bookmarks";
+                return req;
+            }
+            req.label = "Camera tour (" + std::to_string(keys) + " bookmarks" +
+                        (loop ? ", looping)" : ")");
+            // The path is digits, '.', '-', ';' and '|': safe in a plain
+            // Lua string literal.
+            req.lua = "return SWFOC_CameraPath(\"play\", \"" + path + "\", " +
+                      (loop ? "1" : "0") + ")";
+            req.key = "camera";
             return req;
         }
 
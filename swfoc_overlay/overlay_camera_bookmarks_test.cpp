@@ -412,6 +412,30 @@ int main()
                        f8.label, "F8");
     }
 
+    // -----------------------------------------------------------------------
+    // 9. Tour — the bookmarks as one SWFOC_CameraPath command.
+    // -----------------------------------------------------------------------
+    std::printf("\n[tour: one SWFOC_CameraPath through the set slots]\n");
+    {
+        CameraBookmarks bm;
+        bm.Save(0, 10.0f, 20.0f, 30.0f);
+        const ActionRequest one = bm.BuildTour(1500);
+        ExpectTrue("tour: one bookmark is not a tour", one.lua.empty());
+        ExpectContains("tour: the empty toast says why", one.label, "two bookmarks");
+
+        bm.Save(2, -5.5f, 0.0f, 100.0f);
+        ExpectStr("tour: set slots in order, segment_ms apart, slot 1 skipped",
+                  bm.BuildTour(1500).lua,
+                  "return SWFOC_CameraPath(\"play\", \"0;10;20;30|1500;-5.5;0;100\", 0)");
+        bm.Save(1, 1.0f, 2.0f, 3.0f);
+        const ActionRequest loop = bm.BuildTour(0, true);
+        ExpectStr("tour: a looping tour with the segment clamped to 1 ms",
+                  loop.lua,
+                  "return SWFOC_CameraPath(\"play\", \"0;10;20;30|1;1;2;3|2;-5.5;0;100\", 1)");
+        ExpectContains("tour: the label counts the bookmarks", loop.label, "3 bookmarks");
+        ExpectStr("tour: a tour replaces a pending recall", loop.key, "camera");
+    }
+
     std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
     return g_failures == 0 ? 0 : 1;
 }
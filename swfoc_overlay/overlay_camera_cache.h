@@ -0,0 +1,128 @@
+// =============================================================================
+// swfoc_overlay/overlay_camera_cache.h — per-frame camera-transform cache for
+// cursor rays (2026-10-14).
+//
+// CursorRay (overlay_cursor_ray.h) inverts the view-projection matrix on
+// every call. Hover highlighting, the drag-drop spawn preview
+// (overlay_dragdrop.h / overlay_preview_ring.h) and the minimap each want a
+// ray per frame, and the camera matrix only changes when the camera moves.
+// The Present detour owns one CameraTransformCache and feeds it the engine's
+// view-projection once per frame; every consumer in that frame unprojects
+// through the cached inverse:
+//
+//   * UpdateCameraTransformCache keys the cache by Mat4Hash (FNV-1a over the
+//     64 matrix bytes) and confirms a hash match byte for byte, so a repeated
+//     camera costs one hash and one memcmp, and a collision can never hand
+//     out a stale inverse. Only a changed matrix runs Mat4Inverse.
+//   * CachedCursorRay gives exactly CursorRay's ray (same unprojection code,
+//     CursorRayFromInverse); a singular matrix yields valid=false rays until
+//     the camera changes.
+//   * CachedCursorRays unprojects a batch of screen points in one call, e.g.
+//     a preview ring's outline or a minimap viewport's four corners.
+//
+// Render thread only: the cache is plain data with no locking, like the rest
+// of the Present-detour state.
+//
+// RED-GREEN REGRESSION PINS (overlay_camera_cache_test.cpp)
+// -------------------------------------------------------
+//   - SAME RAY         : a cached ray equals CursorRay's, bit for bit.
+//   - INVERT ONCE      : a camera held for many frames is inverted once.
+//   - CHANGE REINVERTS : any changed matrix element re-inverts.
+//   - SINGULAR         : a singular matrix gives invalid rays, and a later
+//                        good matrix recovers.
+//   - BATCH            : CachedCursorRays matches per-point CachedCursorRay
+//                        and counts valid rays.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no bridge. Unit-tested
+// with a plain g++ (build_camera_cache_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include "overlay_cursor_ray.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace swfoc_overlay
+{
+    struct ScreenPoint
+    {
+        float x;
+        float y;
+    };
+
+    struct CameraTransformCache
+    {
+        bool     primed = false;      // has seen a matrix
+        bool     invertible = false;  // inv_view_proj is usable
+        uint64_t key = 0;             // Mat4Hash(view_proj)
+        uint64_t frame = 0;           // last frame that fed the cache
+        uint32_t inversions = 0;      // Mat4Inverse calls so far
+        Mat4     view_proj{};
+        Mat4     inv_view_proj{};
+    };
+
+    // FNV-1a over the matrix bytes.
+    inline uint64_t Mat4Hash(const Mat4& m)
+    {
+        unsigned char bytes[sizeof(m.m)];
+        std::memcpy(bytes, m.m, sizeof(bytes));
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char b : bytes)
+        {
+            h ^= b;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Feeds this frame's view-projection. Returns true when the matrix
+    // changed (and was inverted), false when the cached inverse still holds.
+    inline bool UpdateCameraTransformCache(CameraTransformCache& c,
+                                           const Mat4& viewProj, uint64_t frame)
+    {
+        c.frame = frame;
+        const uint64_t key = Mat4Hash(viewProj);
+        if (c.primed && key == c.key
+            && std::memcmp(c.view_proj.m, viewProj.m, sizeof(viewProj.m)) == 0)
+        {
+            return false;
+        }
+        c.primed = true;
+        c.key = key;
+        c.view_proj = viewProj;
+        c.invertible = Mat4Inverse(viewProj, c.inv_view_proj);
+        ++c.inversions;
+        return true;
+    }
+
+    // CursorRay through the cached inverse.
+    inline WorldRay CachedCursorRay(const CameraTransformCache& c, float sx, float sy,
+                                    float vw, float vh)
+    {
+        if (!c.invertible)
+        {
+            WorldRay ray{};
+            ray.origin    = Vec3{ 0.0f, 0.0f, 0.0f };
+            ray.direction = Vec3{ 0.0f, 0.0f, 0.0f };
+            ray.valid     = false;
+            return ray;
+        }
+        return CursorRayFromInverse(sx, sy, vw, vh, c.inv_view_proj);
+    }
+
+    // Unprojects `count` screen points into `out`. Returns how many rays
+    // came back valid.
+    inline int CachedCursorRays(const CameraTransformCache& c, const ScreenPoint* points,
+                                int count, float vw, float vh, WorldRay* out)
+    {
+        int valid = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            out[i] = CachedCursorRay(c, points[i].x, points[i].y, vw, vh);
+            if (out[i].valid) ++valid;
+        }
+        return valid;
+    }
+}
@@ -0,0 +1,212 @@
+// =============================================================================
+// swfoc_overlay/overlay_camera_cache_test.cpp — unit test for
+// overlay_camera_cache.h (2026-10-14).
+//
+// The cache must be invisible to its consumers: every ray it hands out is
+// the ray CursorRay would have built, and the only difference is how often
+// Mat4Inverse runs. Both halves are pinned against an RTS-style camera built
+// the way the engine builds it (LookAtRH * PerspectiveFovRH).
+//
+// overlay_camera_cache.h is header-only and std-only. Build + run via
+// build_camera_cache_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - SAME RAY         : cached ray == CursorRay, bit for bit.
+//   - INVERT ONCE      : 600 frames of one camera -> one inversion.
+//   - CHANGE REINVERTS : a one-element change re-inverts.
+//   - SINGULAR         : singular -> invalid rays; a good matrix recovers.
+//   - BATCH            : CachedCursorRays == per-point CachedCursorRay.
+// =============================================================================
+
+#include "overlay_camera_cache.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::CachedCursorRay;
+    using swfoc_overlay::CachedCursorRays;
+    using swfoc_overlay::CameraTransformCache;
+    using swfoc_overlay::CursorRay;
+    using swfoc_overlay::Mat4;
+    using swfoc_overlay::ScreenPoint;
+    using swfoc_overlay::UpdateCameraTransformCache;
+    using swfoc_overlay::Vec3;
+    using swfoc_overlay::WorldRay;
+
+    // Row-major D3DXMatrixPerspectiveFovRH / LookAtRH equivalents, as in
+    // overlay_cursor_ray_test.cpp.
+    Mat4 MakePerspectiveFovRH(float fovY, float aspect, float zn, float zf)
+    {
+        const float yScale = 1.0f / std::tan(fovY * 0.5f);
+        Mat4 r{};
+        r.m[0]  = yScale / aspect;
+        r.m[5]  = yScale;
+        r.m[10] = zf / (zn - zf);
+        r.m[11] = -1.0f;
+        r.m[14] = zn * zf / (zn - zf);
+        return r;
+    }
+
+    Mat4 MakeLookAtRH(const Vec3& eye, const Vec3& at, const Vec3& up)
+    {
+        const Vec3 z = swfoc_overlay::Vec3Normalize(swfoc_overlay::Vec3Sub(eye, at));
+        const Vec3 x = swfoc_overlay::Vec3Normalize(swfoc_overlay::Vec3Cross(up, z));
+        const Vec3 y = swfoc_overlay::Vec3Cross(z, x);
+        Mat4 r{};
+        r.m[0] = x.x; r.m[1] = y.x; r.m[2]  = z.x;
+        r.m[4] = x.y; r.m[5] = y.y; r.m[6]  = z.y;
+        r.m[8] = x.z; r.m[9] = y.z; r.m[10] = z.z;
+        r.m[12] = -swfoc_overlay::Vec3Dot(x, eye);
+        r.m[13] = -swfoc_overlay::Vec3Dot(y, eye);
+        r.m[14] = -swfoc_overlay::Vec3Dot(z, eye);
+        r.m[15] = 1.0f;
+        return r;
+    }
+
+    Mat4 Camera(float eyeX)
+    {
+        return swfoc_overlay::Mat4Multiply(
+            MakeLookAtRH(Vec3{ eyeX, -400.0f, 600.0f }, Vec3{ eyeX, 0.0f, 0.0f },
+                         Vec3{ 0.0f, 0.0f, 1.0f }),
+            MakePerspectiveFovRH(0.8f, 1920.0f / 1080.0f, 1.0f, 5000.0f));
+    }
+
+    bool SameRay(const WorldRay& a, const WorldRay& b)
+    {
+        return a.valid == b.valid
+            && a.origin.x == b.origin.x && a.origin.y == b.origin.y && a.origin.z == b.origin.z
+            && a.direction.x == b.direction.x && a.direction.y == b.direction.y
+            && a.direction.z == b.direction.z;
+    }
+}
+
+int main()
+{
+    std::printf("overlay_camera_cache_test\n");
+    const float vw = 1920.0f;
+    const float vh = 1080.0f;
+
+    // ---- Same ray, invert once ---------------------------------------------
+    {
+        Section("same ray, invert once");
+
+        const Mat4 vp = Camera(0.0f);
+        CameraTransformCache cache;
+        ExpectTrue("a fresh cache gives invalid rays",
+                   !CachedCursorRay(cache, 960.0f, 540.0f, vw, vh).valid);
+        ExpectTrue("the first frame inverts", UpdateCameraTransformCache(cache, vp, 1));
+
+        // PIN (SAME RAY)
+        int same = 0;
+        for (int i = 0; i < 64; ++i)
+        {
+            const float sx = 30.0f * i;
+            const float sy = 16.0f * i;
+            if (SameRay(CachedCursorRay(cache, sx, sy, vw, vh), CursorRay(sx, sy, vw, vh, vp))) ++same;
+        }
+        ExpectEqInt("PIN SAME RAY: 64 pixels match CursorRay bit for bit", same, 64);
+        ExpectTrue("PIN SAME RAY: a degenerate viewport is still invalid",
+                   !CachedCursorRay(cache, 1.0f, 1.0f, 0.0f, vh).valid);
+
+        // PIN (INVERT ONCE)
+        int changed = 0;
+        for (uint64_t frame = 2; frame <= 600; ++frame)
+        {
+            if (UpdateCameraTransformCache(cache, vp, frame)) ++changed;
+        }
+        ExpectEqInt("PIN INVERT ONCE: a held camera never re-inverts", changed, 0);
+        ExpectEqInt("PIN INVERT ONCE: one inversion in 600 frames", cache.inversions, 1);
+        ExpectEqInt("the cache records the last frame", static_cast<long long>(cache.frame), 600);
+
+        // PIN (CHANGE REINVERTS)
+        Mat4 nudged = vp;
+        nudged.m[12] = std::nextafter(nudged.m[12], 1e9f);
+        ExpectTrue("PIN CHANGE REINVERTS: a one-ulp change re-inverts",
+                   UpdateCameraTransformCache(cache, nudged, 601) && cache.inversions == 2);
+        const Mat4 panned = Camera(250.0f);
+        ExpectTrue("PIN CHANGE REINVERTS: a panned camera re-inverts",
+                   UpdateCameraTransformCache(cache, panned, 602));
+        ExpectTrue("and its rays follow the new camera",
+                   SameRay(CachedCursorRay(cache, 100.0f, 900.0f, vw, vh),
+                           CursorRay(100.0f, 900.0f, vw, vh, panned)));
+        ExpectTrue("Mat4Hash tells the two cameras apart",
+                   swfoc_overlay::Mat4Hash(vp) != swfoc_overlay::Mat4Hash(panned));
+    }
+
+    // ---- Singular matrices and batches -------------------------------------
+    {
+        Section("singular, batch");
+
+        // PIN (SINGULAR)
+        CameraTransformCache cache;
+        const Mat4 zero{};
+        UpdateCameraTransformCache(cache, zero, 1);
+        ExpectTrue("PIN SINGULAR: a singular matrix gives invalid rays",
+                   !cache.invertible && !CachedCursorRay(cache, 10.0f, 10.0f, vw, vh).valid);
+        UpdateCameraTransformCache(cache, zero, 2);
+        ExpectEqInt("PIN SINGULAR: and is not re-inverted every frame", cache.inversions, 1);
+        const Mat4 vp = Camera(0.0f);
+        UpdateCameraTransformCache(cache, vp, 3);
+        ExpectTrue("PIN SINGULAR: a good matrix recovers",
+                   cache.invertible && CachedCursorRay(cache, 10.0f, 10.0f, vw, vh).valid);
+
+        // PIN (BATCH)
+        const ScreenPoint corners[5] = {
+            { 0.0f, 0.0f }, { vw, 0.0f }, { vw, vh }, { 0.0f, vh }, { 960.0f, 540.0f },
+        };
+        WorldRay rays[5];
+        ExpectEqInt("PIN BATCH: every corner unprojects",
+                    CachedCursorRays(cache, corners, 5, vw, vh, rays), 5);
+        bool all = true;
+        for (int i = 0; i < 5; ++i)
+        {
+            all = all && SameRay(rays[i], CachedCursorRay(cache, corners[i].x, corners[i].y, vw, vh));
+        }
+        ExpectTrue("PIN BATCH: batch rays equal per-point rays", all);
+        UpdateCameraTransformCache(cache, zero, 4);
+        ExpectEqInt("PIN BATCH: a singular camera unprojects none",
+                    CachedCursorRays(cache, corners, 5, vw, vh, rays), 0);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
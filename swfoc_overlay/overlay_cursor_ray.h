@@ -336,26 +336,12 @@ namespace swfoc_overlay
                          1.0f - 2.0f * sy / vh };
     }
 
-    // Build a world-space pick ray from a cursor pixel.
-    //
-    // `sx` / `sy`  : cursor position in screen pixels (top-left origin).
-    // `vw` / `vh`  : viewport size in pixels (the host window client area).
-    // `viewProj`   : the engine's global view*projection matrix — read
-    //                directly from RVA 0xA6F49C, or composed from the view
-    //                (0xA6EEE4) and projection (0xA6EF24) matrices.
-    //
-    // The cursor is unprojected at the D3D near depth (z_ndc = 0) and the far
-    // depth (z_ndc = 1) by transforming both clip points through the inverse
-    // of `viewProj` and applying the perspective divide. The near point is
-    // the ray origin; the normalized near->far vector is the ray direction.
-    //
-    // `valid` is false — and origin/direction are zeroed — when the viewport
-    // is degenerate, `viewProj` is singular, or the near and far unprojected
-    // points coincide. The handedness of the projection does not matter here:
-    // inverting whatever matrix the engine actually built recovers correct
-    // world coordinates for a right-handed or left-handed pipeline alike.
-    inline WorldRay CursorRay(float sx, float sy, float vw, float vh,
-                              const Mat4& viewProj)
+    // 2026-10-14: the unprojection half of CursorRay below, for callers that
+    // already hold the inverse view-projection (overlay_camera_cache.h
+    // inverts once per camera change, not once per pick). Same `valid`
+    // rules, minus the singular-matrix check the caller has done.
+    inline WorldRay CursorRayFromInverse(float sx, float sy, float vw, float vh,
+                                         const Mat4& invVP)
     {
         WorldRay ray{};
         ray.origin    = Vec3{ 0.0f, 0.0f, 0.0f };
@@ -367,12 +353,6 @@ namespace swfoc_overlay
             return ray;  // degenerate viewport
         }
 
-        Mat4 invVP{};
-        if (!Mat4Inverse(viewProj, invVP))
-        {
-            return ray;  // singular view-projection matrix
-        }
-
         const NdcPoint ndc = ScreenToNdc(sx, sy, vw, vh);
 
         // D3D clip-space depth runs [0, 1]: z_ndc = 0 is the near plane,
@@ -406,6 +386,45 @@ namespace swfoc_overlay
         return ray;
     }
 
+    // Build a world-space pick ray from a cursor pixel.
+    //
+    // `sx` / `sy`  : cursor position in screen pixels (top-left origin).
+    // `vw` / `vh`  : viewport size in pixels (the host window client area).
+    // `viewProj`   : the engine's global view*projection matrix — read
+    //                directly from RVA 0xA6F49C, or composed from the view
+    //                (0xA6EEE4) and projection (0xA6EF24) matrices.
+    //
+    // The cursor is unprojected at the D3D near depth (z_ndc = 0) and the far
+    // depth (z_ndc = 1) by transforming both clip points through the inverse
+    // of `viewProj` and applying the perspective divide. The near point is
+    // the ray origin; the normalized near->far vector is the ray direction.
+    //
+    // `valid` is false — and origin/direction are zeroed — when the viewport
+    // is degenerate, `viewProj` is singular, or the near and far unprojected
+    // points coincide. The handedness of the projection does not matter here:
+    // inverting whatever matrix the engine actually built recovers correct
+    // world coordinates for a right-handed or left-handed pipeline alike.
+    inline WorldRay CursorRay(float sx, float sy, float vw, float vh,
+                              const Mat4& viewProj)
+    {
+        WorldRay ray{};
+        ray.origin    = Vec3{ 0.0f, 0.0f, 0.0f };
+        ray.direction = Vec3{ 0.0f, 0.0f, 0.0f };
+        ray.valid     = false;
+
+        if (vw <= 0.0f || vh <= 0.0f)
+        {
+            return ray;  // degenerate viewport
+        }
+
+        Mat4 invVP{};
+        if (!Mat4Inverse(viewProj, invVP))
+        {
+            return ray;  // singular view-projection matrix
+        }
+        return CursorRayFromInverse(sx, sy, vw, vh, invVP);
+    }
+
     // Convenience overload matching the spec's stated inputs (cursor +
     // viewport + view matrix + projection matrix). Composes the
     // view-projection matrix and delegates to the primary overload.
@@ -0,0 +1,101 @@
+// =============================================================================
+// swfoc_overlay/overlay_device_capture.h — where the overlay gets the
+// IDirect3DDevice9 vtable from (2026-10-14).
+//
+// Install used to create a hidden window and a throwaway D3D9 device (two of
+// them: one per harvested slot) 1.5 s after load, read Present / Reset off
+// its vtable and tear it down. That costs real startup time and competes
+// with the game's own device creation. Now:
+//
+//   * Install runs as soon as the bootstrap thread starts. It reads
+//     IDirect3D9::CreateDevice (slot kD3D9SlotCreateDevice) off an
+//     IDirect3D9 from Direct3DCreate9 — no window, no device — and detours
+//     it. The game's own CreateDevice call then hands the overlay the live
+//     device, whose vtable carries Present / Reset.
+//   * Only if the game's window has been up for kDeviceCaptureGraceMs with
+//     no CreateDevice seen (the device predates the detour), the overlay
+//     falls back to one throwaway device for both slots.
+//   * ClaimDeviceHook makes the two paths install the Present / Reset
+//     detours exactly once, whichever gets there first.
+//
+// RED-GREEN REGRESSION PINS (overlay_device_capture_test.cpp)
+// ---------------------------------------------------------
+//   - WAITS FOR A WINDOW : no host window means no device yet: keep waiting.
+//   - GRACE BEFORE DUMMY : a fresh window waits out the grace period.
+//   - DUMMY AFTER GRACE  : a window up past the grace with no capture falls
+//                          back to the throwaway device.
+//   - STOPS WHEN HOOKED  : once hooked, from either source, nothing more.
+//   - CLAIMS ONCE        : the second claim fails; a released claim can be
+//                          taken again.
+//   - D3D9 SLOTS         : CreateDevice 16 on IDirect3D9, Reset 16 and
+//                          Present 17 on IDirect3DDevice9.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no bridge. Unit-tested
+// with a plain g++ (build_device_capture_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace swfoc_overlay
+{
+    // VTable indices (D3D9 contract — fixed across all SDK versions)
+    constexpr int kD3D9SlotCreateDevice = 16;  // IDirect3D9
+    constexpr int kD3D9SlotReset = 16;         // IDirect3DDevice9
+    constexpr int kD3D9SlotPresent = 17;       // IDirect3DDevice9
+
+    // How long the game's window may be up without a CreateDevice through
+    // the detour before the device is assumed to predate it.
+    constexpr uint32_t kDeviceCaptureGraceMs = 3000;
+
+    enum class DeviceHookSource : int
+    {
+        None = 0,
+        CreateDevice = 1,  // the game's device, through the CreateDevice detour
+        DummyDevice = 2,   // fallback throwaway device
+    };
+
+    enum class DeviceCaptureStep
+    {
+        Wait,           // poll again later
+        HookFromDummy,  // create the throwaway device now
+        Stop,           // hooked; the watch is over
+    };
+
+    // One poll of the capture watch. `window_up_ms` is how long the game's
+    // top-level window has been visible (ignored when there is none).
+    inline DeviceCaptureStep NextDeviceCaptureStep(
+        DeviceHookSource hooked, bool host_window, uint32_t window_up_ms)
+    {
+        if (hooked != DeviceHookSource::None) return DeviceCaptureStep::Stop;
+        if (!host_window) return DeviceCaptureStep::Wait;
+        if (window_up_ms < kDeviceCaptureGraceMs) return DeviceCaptureStep::Wait;
+        return DeviceCaptureStep::HookFromDummy;
+    }
+
+    // Takes the one Present / Reset install for `source`. False when another
+    // source already holds it.
+    inline bool ClaimDeviceHook(std::atomic<int>& slot, DeviceHookSource source)
+    {
+        int expected = static_cast<int>(DeviceHookSource::None);
+        return slot.compare_exchange_strong(expected, static_cast<int>(source));
+    }
+
+    // Gives a claim back after its install failed, so the other path may try.
+    inline void ReleaseDeviceHook(std::atomic<int>& slot)
+    {
+        slot.store(static_cast<int>(DeviceHookSource::None));
+    }
+
+    inline const char* DeviceHookSourceLabel(DeviceHookSource source)
+    {
+        switch (source)
+        {
+            case DeviceHookSource::CreateDevice: return "game CreateDevice";
+            case DeviceHookSource::DummyDevice: return "throwaway device";
+            default: return "none";
+        }
+    }
+}
@@ -0,0 +1,140 @@
+// =============================================================================
+// swfoc_overlay/overlay_device_capture_test.cpp — unit test for
+// overlay_device_capture.h (2026-10-14).
+//
+// Falling back to the throwaway device too early is the startup stall this
+// kernel exists to remove; never falling back leaves an overlay that
+// installed after the game's CreateDevice with no Present detour at all. So
+// both edges of the grace period are pinned, and so is the once-only claim
+// that keeps the two install paths from hooking Present twice.
+//
+// overlay_device_capture.h is header-only and std-only. Build + run via
+// build_device_capture_test.bat — no game, no pipe, no ImGui, no D3D9.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - WAITS FOR A WINDOW : no window, no fallback.
+//   - GRACE BEFORE DUMMY : under kDeviceCaptureGraceMs, wait.
+//   - DUMMY AFTER GRACE  : at kDeviceCaptureGraceMs, fall back.
+//   - STOPS WHEN HOOKED  : either source stops the watch.
+//   - CLAIMS ONCE        : one claim wins until released.
+//   - D3D9 SLOTS         : 16 / 16 / 17.
+// =============================================================================
+
+#include "overlay_device_capture.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::DeviceCaptureStep;
+    using swfoc_overlay::DeviceHookSource;
+    using swfoc_overlay::NextDeviceCaptureStep;
+    using swfoc_overlay::kDeviceCaptureGraceMs;
+}
+
+int main()
+{
+    std::printf("overlay_device_capture_test\n");
+
+    // ---- Capture watch -----------------------------------------------------
+    {
+        Section("capture watch");
+
+        // PIN (WAITS FOR A WINDOW)
+        ExpectTrue("PIN WAITS FOR A WINDOW: no window waits",
+                   NextDeviceCaptureStep(DeviceHookSource::None, false, 0) == DeviceCaptureStep::Wait);
+        ExpectTrue("PIN WAITS FOR A WINDOW: however long the watch has run",
+                   NextDeviceCaptureStep(DeviceHookSource::None, false, 600000) == DeviceCaptureStep::Wait);
+
+        // PIN (GRACE BEFORE DUMMY), PIN (DUMMY AFTER GRACE)
+        ExpectTrue("PIN GRACE BEFORE DUMMY: a new window waits",
+                   NextDeviceCaptureStep(DeviceHookSource::None, true, 0) == DeviceCaptureStep::Wait);
+        ExpectTrue("PIN GRACE BEFORE DUMMY: one ms short still waits",
+                   NextDeviceCaptureStep(DeviceHookSource::None, true, kDeviceCaptureGraceMs - 1)
+                       == DeviceCaptureStep::Wait);
+        ExpectTrue("PIN DUMMY AFTER GRACE: the grace spent falls back",
+                   NextDeviceCaptureStep(DeviceHookSource::None, true, kDeviceCaptureGraceMs)
+                       == DeviceCaptureStep::HookFromDummy);
+
+        // PIN (STOPS WHEN HOOKED)
+        ExpectTrue("PIN STOPS WHEN HOOKED: through CreateDevice",
+                   NextDeviceCaptureStep(DeviceHookSource::CreateDevice, true, kDeviceCaptureGraceMs * 2)
+                       == DeviceCaptureStep::Stop);
+        ExpectTrue("PIN STOPS WHEN HOOKED: through the throwaway device",
+                   NextDeviceCaptureStep(DeviceHookSource::DummyDevice, false, 0) == DeviceCaptureStep::Stop);
+    }
+
+    // ---- Install claim -----------------------------------------------------
+    {
+        Section("install claim");
+
+        // PIN (CLAIMS ONCE)
+        std::atomic<int> slot{0};
+        ExpectTrue("PIN CLAIMS ONCE: the first claim wins",
+                   swfoc_overlay::ClaimDeviceHook(slot, DeviceHookSource::CreateDevice));
+        ExpectTrue("PIN CLAIMS ONCE: the other path then loses",
+                   !swfoc_overlay::ClaimDeviceHook(slot, DeviceHookSource::DummyDevice));
+        ExpectEqInt("the slot names the winner", slot.load(), static_cast<int>(DeviceHookSource::CreateDevice));
+        swfoc_overlay::ReleaseDeviceHook(slot);
+        ExpectTrue("PIN CLAIMS ONCE: a released claim can be taken again",
+                   swfoc_overlay::ClaimDeviceHook(slot, DeviceHookSource::DummyDevice));
+        ExpectTrue("labels name each source",
+                   std::strcmp(swfoc_overlay::DeviceHookSourceLabel(DeviceHookSource::CreateDevice),
+                               "game CreateDevice") == 0
+                       && std::strcmp(swfoc_overlay::DeviceHookSourceLabel(DeviceHookSource::DummyDevice),
+                                      "throwaway device") == 0
+                       && std::strcmp(swfoc_overlay::DeviceHookSourceLabel(DeviceHookSource::None), "none") == 0);
+    }
+
+    // ---- D3D9 slots --------------------------------------------------------
+    {
+        Section("d3d9 slots");
+
+        // PIN (D3D9 SLOTS)
+        ExpectEqInt("PIN D3D9 SLOTS: IDirect3D9::CreateDevice", swfoc_overlay::kD3D9SlotCreateDevice, 16);
+        ExpectEqInt("PIN D3D9 SLOTS: IDirect3DDevice9::Reset", swfoc_overlay::kD3D9SlotReset, 16);
+        ExpectEqInt("PIN D3D9 SLOTS: IDirect3DDevice9::Present", swfoc_overlay::kD3D9SlotPresent, 17);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// =============================================================================
+// swfoc_overlay/overlay_event_feed.h — client side of the bridge's event ring
+// (Local\SWFOC_Bridge_Events), feeding the HUD's unit counters (2026-10-14).
+//
+// powrprof.dll's damage / death hooks publish records into a shared-memory
+// byte ring (SharedEvtBuffer in swfoc_lua_bridge/shared_memory.h is the
+// spec), but the HUD kept polling kills, deaths and unit counts over the
+// pipe. The HUD worker now maps the ring, is its single consumer, and folds
+// EVT_UNIT_DIED records into the last snapshot between pipe refreshes:
+//
+//     victim_owner == local_slot   deaths + 1, local alive units - 1
+//     killer_owner == local_slot   kills + 1
+//     every death                  total units in play - 1
+//
+// (the same rules Hook_DeathHandler applies to its own atomics). Spawns are
+// not evented, so the pipe still reconciles every counter on its slower
+// cadence; an EVT_RESYNC marker (records lost to a full ring) or a v1 death
+// record without owner slots asks for a reconcile at once.
+//
+// EVT_SELECTION records (the bridge publishes one whenever the local
+// player's selection changes) keep only the newest: the inspector follows
+// the engine selection from them instead of asking the pipe.
+//
+// Layout mirrored here (little-endian, offsets in bytes):
+//
+//     +0  write_pos   +4  read_pos  +8  event_count  +12 flags (bit 0 on)
+//     +16 reserve_pos +20 dropped   +24 dropped_pending +28 version (2)
+//     +32 ring[64 KB] of [u16 type][u16 size][payload], 8-byte aligned
+//
+// RED-GREEN REGRESSION PINS (overlay_event_feed_test.cpp)
+// ------------------------------------------------------
+//   - LAYOUT             : ring at +32, records padded to 8 bytes.
+//   - COUNTER RULES      : kills / deaths / alive / total deltas follow the
+//                          victim / killer / local slots exactly.
+//   - NO LOCAL PLAYER    : local_slot -1 moves only the total.
+//   - RESYNC             : EVT_RESYNC and v1 death records flag a reconcile.
+//   - WRAP               : a record split across the ring end reads intact.
+//   - OTHER EVENTS       : HP / position records are consumed and ignored.
+//   - SELECTION LATEST   : of several EVT_SELECTION records the newest wins.
+//   - APPLY              : deltas never move an unknown (-1) field or push a
+//                          count below zero.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_event_feed_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace swfoc_overlay
+{
+    // Mirrors SHMEM_EVT_* / EventType in swfoc_lua_bridge/shared_memory.h.
+    constexpr const char* kBridgeEventsName = "Local\\SWFOC_Bridge_Events";
+    constexpr uint32_t kBridgeEventsVersion = 2;
+    constexpr uint32_t kBridgeEventRingSize = 64 * 1024;
+    constexpr uint32_t kBridgeEventHeaderSize = 4;
+    constexpr uint32_t kBridgeEventAlign = 8;
+    constexpr uint16_t kBridgeEvtUnitDied = 0x02;
+    constexpr uint16_t kBridgeEvtSelection = 0x20;
+    constexpr uint16_t kBridgeEvtResync = 0xFF;
+    constexpr uint16_t kBridgeUnitDiedV1Size = 8;
+    constexpr uint16_t kBridgeUnitDiedSize = 20;
+    constexpr uint16_t kBridgeSelectionSize = 24;  // EvtSelection
+
+    struct BridgeEventRing
+    {
+        std::atomic<uint32_t> write_pos;
+        std::atomic<uint32_t> read_pos;
+        std::atomic<uint32_t> event_count;
+        std::atomic<uint32_t> flags;
+        std::atomic<uint32_t> reserve_pos;
+        std::atomic<uint32_t> dropped;
+        std::atomic<uint32_t> dropped_pending;
+        uint32_t              version;
+        alignas(8) uint8_t    ring[kBridgeEventRingSize];
+    };
+    static_assert(offsetof(BridgeEventRing, ring) == 32, "ring offset drifted from SharedEvtBuffer");
+
+    // Counter changes drained since the last apply.
+    struct BridgeEventDeltas
+    {
+        int  kills = 0;
+        int  deaths = 0;
+        int  local_alive = 0;
+        int  total_alive = 0;
+        bool resync = false;   // counters need a pipe reconcile
+        int  records = 0;      // records consumed, any type
+        // Newest EVT_SELECTION drained, when selection_changed.
+        bool     selection_changed = false;
+        uint32_t selection_seq = 0;
+        int      selection_count = 0;
+        uint64_t selection_first = 0;  // 0 = nothing selected
+    };
+
+    inline uint32_t BridgeEventRecordSize(uint32_t payloadSize)
+    {
+        return (kBridgeEventHeaderSize + payloadSize + kBridgeEventAlign - 1)
+            & ~(kBridgeEventAlign - 1);
+    }
+
+    inline bool BridgeEventsEnabled(const BridgeEventRing& r)
+    {
+        return r.version == kBridgeEventsVersion
+            && (r.flags.load(std::memory_order_acquire) & 1) != 0;
+    }
+
+    // Single consumer. Copies up to `cap` payload bytes into `out` and
+    // advances read_pos. Mirrors ShmEvtRead.
+    inline bool ReadBridgeEvent(BridgeEventRing& r, uint16_t& type, void* out,
+                                uint32_t cap, uint16_t& size)
+    {
+        const uint32_t rp = r.read_pos.load(std::memory_order_relaxed);
+        if (rp == r.write_pos.load(std::memory_order_acquire)) return false;
+        uint32_t header = 0;
+        std::memcpy(&header, r.ring + (rp & (kBridgeEventRingSize - 1)), kBridgeEventHeaderSize);
+        type = static_cast<uint16_t>(header & 0xFFFF);
+        size = static_cast<uint16_t>(header >> 16);
+        const uint32_t n = size < cap ? size : cap;
+        const uint32_t off = (rp + kBridgeEventHeaderSize) & (kBridgeEventRingSize - 1);
+        const uint32_t first = n < kBridgeEventRingSize - off ? n : kBridgeEventRingSize - off;
+        std::memcpy(out, r.ring + off, first);
+        if (first < n) std::memcpy(static_cast<uint8_t*>(out) + first, r.ring, n - first);
+        r.read_pos.store(rp + BridgeEventRecordSize(size), std::memory_order_release);
+        return true;
+    }
+
+    // Folds one EVT_UNIT_DIED payload into `d`.
+    inline void FoldBridgeUnitDied(const uint8_t* payload, uint16_t size,
+                                   BridgeEventDeltas& d)
+    {
+        if (size < kBridgeUnitDiedSize)
+        {
+            d.resync = true;  // v1 record: no owners to attribute it with
+            return;
+        }
+        int32_t victim = 0, killer = 0, local = 0;
+        std::memcpy(&victim, payload + 8, 4);
+        std::memcpy(&killer, payload + 12, 4);
+        std::memcpy(&local, payload + 16, 4);
+        d.total_alive -= 1;
+        if (local < 0) return;
+        if (victim == local)
+        {
+            d.deaths += 1;
+            d.local_alive -= 1;
+        }
+        if (killer == local) d.kills += 1;
+    }
+
+    // Keeps one EVT_SELECTION payload in `d`, replacing an older one.
+    inline void FoldBridgeSelection(const uint8_t* payload, uint16_t size,
+                                    BridgeEventDeltas& d)
+    {
+        if (size < kBridgeSelectionSize) return;
+        std::memcpy(&d.selection_seq, payload + 0, 4);
+        std::memcpy(&d.selection_count, payload + 4, 4);
+        std::memcpy(&d.selection_first, payload + 8, 8);
+        d.selection_changed = true;
+    }
+
+    // Drains up to `maxRecords` records into `d`. Returns records consumed.
+    inline int DrainBridgeEvents(BridgeEventRing& r, BridgeEventDeltas& d,
+                                 int maxRecords)
+    {
+        uint8_t payload[64];
+        int n = 0;
+        uint16_t type = 0, size = 0;
+        while (n < maxRecords && ReadBridgeEvent(r, type, payload, sizeof(payload), size))
+        {
+            ++n;
+            if (type == kBridgeEvtUnitDied) FoldBridgeUnitDied(payload, size, d);
+            else if (type == kBridgeEvtSelection) FoldBridgeSelection(payload, size, d);
+            else if (type == kBridgeEvtResync) d.resync = true;
+        }
+        d.records += n;
+        return n;
+    }
+
+    // Applies a delta to a counter, leaving unknown (-1) values unknown.
+    inline void ApplyBridgeCounterDelta(int& field, int delta)
+    {
+        if (field < 0 || delta == 0) return;
+        field += delta;
+        if (field < 0) field = 0;
+    }
+}
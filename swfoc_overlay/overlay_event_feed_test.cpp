@@ -0,0 +1,248 @@
+// =============================================================================
+// swfoc_overlay/overlay_event_feed_test.cpp — unit test for
+// overlay_event_feed.h (2026-10-14).
+//
+// overlay_event_feed.h reads the bridge's shared-memory event ring and turns
+// EVT_UNIT_DIED records into HUD counter deltas. This test writes records
+// into a BridgeEventRing exactly as ShmEvtWrite lays them out
+// (swfoc_lua_bridge/shared_memory.h) so a layout drift or a miscounted
+// death fails here rather than as a wrong kill count on the HUD.
+//
+// overlay_event_feed.h is header-only and std-only. Build + run via
+// build_event_feed_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - LAYOUT             : ring at +32, records padded to 8 bytes.
+//   - COUNTER RULES      : deltas follow the victim / killer / local slots.
+//   - NO LOCAL PLAYER    : local_slot -1 moves only the total.
+//   - RESYNC             : EVT_RESYNC and v1 death records flag a reconcile.
+//   - WRAP               : a record split across the ring end reads intact.
+//   - OTHER EVENTS       : HP / position records are consumed and ignored.
+//   - SELECTION LATEST   : of several EVT_SELECTION records the newest wins.
+//   - APPLY              : unknown fields stay unknown, counts stay >= 0.
+// =============================================================================
+
+#include "overlay_event_feed.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::BridgeEventDeltas;
+    using swfoc_overlay::BridgeEventRing;
+    using swfoc_overlay::DrainBridgeEvents;
+    using swfoc_overlay::kBridgeEventRingSize;
+
+    // Test-side producer with ShmEvtWrite's record layout (single writer).
+    void Write(BridgeEventRing& r, uint16_t type, const void* payload, uint16_t size)
+    {
+        const uint32_t pos = r.write_pos.load();
+        const uint32_t header = static_cast<uint32_t>(type) | (static_cast<uint32_t>(size) << 16);
+        std::memcpy(r.ring + (pos & (kBridgeEventRingSize - 1)), &header, 4);
+        for (uint16_t i = 0; i < size; ++i)
+        {
+            r.ring[(pos + 4 + i) & (kBridgeEventRingSize - 1)] =
+                static_cast<const uint8_t*>(payload)[i];
+        }
+        r.write_pos.store(pos + swfoc_overlay::BridgeEventRecordSize(size));
+    }
+
+    void WriteDeath(BridgeEventRing& r, int32_t victim, int32_t killer, int32_t local)
+    {
+        const int32_t rec[5] = { 1234, 0, victim, killer, local };
+        Write(r, swfoc_overlay::kBridgeEvtUnitDied, rec, sizeof(rec));
+    }
+
+    std::unique_ptr<BridgeEventRing> MakeRing()
+    {
+        std::unique_ptr<BridgeEventRing> r(new BridgeEventRing());
+        r->version = swfoc_overlay::kBridgeEventsVersion;
+        r->flags.store(1);
+        return r;
+    }
+}
+
+int main()
+{
+    std::printf("=== overlay_event_feed.h unit test ===\n");
+
+    // ---- Layout ------------------------------------------------------------
+    {
+        Section("layout");
+
+        // PIN (LAYOUT)
+        ExpectTrue("PIN LAYOUT: records are padded to 8 bytes",
+                   swfoc_overlay::BridgeEventRecordSize(20) == 24
+                   && swfoc_overlay::BridgeEventRecordSize(4) == 8);
+        ExpectTrue("PIN LAYOUT: the death payload is 20 bytes",
+                   swfoc_overlay::kBridgeUnitDiedSize == 20);
+        auto r = MakeRing();
+        ExpectTrue("an enabled v2 ring reports enabled", swfoc_overlay::BridgeEventsEnabled(*r));
+        r->flags.store(0);
+        ExpectTrue("a disabled ring reports disabled", !swfoc_overlay::BridgeEventsEnabled(*r));
+        r->flags.store(1);
+        r->version = 1;
+        ExpectTrue("a v1 ring is not trusted", !swfoc_overlay::BridgeEventsEnabled(*r));
+    }
+
+    // ---- Counter rules -----------------------------------------------------
+    {
+        Section("counter rules");
+
+        auto r = MakeRing();
+        WriteDeath(*r, 2, 5, 2);   // local unit killed by slot 5
+        WriteDeath(*r, 5, 2, 2);   // local player kills a slot-5 unit
+        WriteDeath(*r, 3, 5, 2);   // unrelated players
+        WriteDeath(*r, 2, 2, 2);   // local friendly fire
+        BridgeEventDeltas d;
+        ExpectTrue("four records drain", DrainBridgeEvents(*r, d, 64) == 4);
+        // PIN (COUNTER RULES)
+        ExpectTrue("PIN COUNTER RULES: kills count the local killer",
+                   d.kills == 2);
+        ExpectTrue("PIN COUNTER RULES: deaths and local alive follow the victim",
+                   d.deaths == 2 && d.local_alive == -2);
+        ExpectTrue("PIN COUNTER RULES: every death lowers the total",
+                   d.total_alive == -4 && !d.resync);
+
+        // PIN (NO LOCAL PLAYER)
+        BridgeEventDeltas none;
+        WriteDeath(*r, 2, 2, -1);
+        DrainBridgeEvents(*r, none, 64);
+        ExpectTrue("PIN NO LOCAL PLAYER: only the total moves",
+                   none.total_alive == -1 && none.kills == 0 && none.deaths == 0
+                   && none.local_alive == 0);
+
+        // PIN (OTHER EVENTS)
+        BridgeEventDeltas other;
+        const uint8_t hp[16] = {};
+        Write(*r, 0x01, hp, sizeof(hp));
+        Write(*r, 0x10, hp, 12);
+        ExpectTrue("PIN OTHER EVENTS: HP / position records are consumed",
+                   DrainBridgeEvents(*r, other, 64) == 2 && other.records == 2);
+        ExpectTrue("PIN OTHER EVENTS: and change no counter",
+                   other.total_alive == 0 && other.kills == 0 && !other.resync);
+
+        WriteDeath(*r, 2, 5, 2);
+        WriteDeath(*r, 2, 5, 2);
+        BridgeEventDeltas capped;
+        ExpectTrue("maxRecords bounds one drain",
+                   DrainBridgeEvents(*r, capped, 1) == 1 && capped.deaths == 1
+                   && DrainBridgeEvents(*r, capped, 1) == 1 && capped.deaths == 2);
+    }
+
+    // ---- Selection ---------------------------------------------------------
+    {
+        Section("selection");
+
+        auto r = MakeRing();
+        // EvtSelection: seq, count, first_obj, hash.
+        auto writeSelection = [&](uint32_t seq, int32_t count, uint64_t first)
+        {
+            uint8_t p[24] = {};
+            std::memcpy(p + 0, &seq, 4);
+            std::memcpy(p + 4, &count, 4);
+            std::memcpy(p + 8, &first, 8);
+            Write(*r, swfoc_overlay::kBridgeEvtSelection, p, sizeof(p));
+        };
+        BridgeEventDeltas none;
+        WriteDeath(*r, 2, 5, 2);
+        DrainBridgeEvents(*r, none, 64);
+        ExpectTrue("no selection record leaves selection_changed clear",
+                   !none.selection_changed);
+
+        writeSelection(4, 2, 0x1234ABCD00ull);
+        writeSelection(5, 1, 0x5678EF0000ull);
+        BridgeEventDeltas d;
+        ExpectTrue("selection records are consumed",
+                   DrainBridgeEvents(*r, d, 64) == 2);
+        // PIN (SELECTION LATEST)
+        ExpectTrue("PIN SELECTION LATEST: the newest record wins",
+                   d.selection_changed && d.selection_seq == 5 && d.selection_count == 1
+                   && d.selection_first == 0x5678EF0000ull);
+        ExpectTrue("selection records change no counter",
+                   d.total_alive == 0 && d.kills == 0 && !d.resync);
+
+        const uint8_t shortRec[8] = {};
+        Write(*r, swfoc_overlay::kBridgeEvtSelection, shortRec, sizeof(shortRec));
+        BridgeEventDeltas truncated;
+        DrainBridgeEvents(*r, truncated, 64);
+        ExpectTrue("a truncated selection record is ignored",
+                   !truncated.selection_changed);
+    }
+
+    // ---- Resync and wrap ---------------------------------------------------
+    {
+        Section("resync and wrap");
+
+        auto r = MakeRing();
+        const uint32_t lost = 7;
+        Write(*r, swfoc_overlay::kBridgeEvtResync, &lost, sizeof(lost));
+        BridgeEventDeltas d;
+        DrainBridgeEvents(*r, d, 64);
+        // PIN (RESYNC)
+        ExpectTrue("PIN RESYNC: a drop marker asks for a reconcile", d.resync);
+        const int32_t v1[2] = { 99, 0 };
+        Write(*r, swfoc_overlay::kBridgeEvtUnitDied, v1, sizeof(v1));
+        BridgeEventDeltas old;
+        DrainBridgeEvents(*r, old, 64);
+        ExpectTrue("PIN RESYNC: a v1 death record asks for a reconcile",
+                   old.resync && old.total_alive == 0);
+
+        // PIN (WRAP)
+        auto w = MakeRing();
+        const uint32_t nearEnd = kBridgeEventRingSize - 8;
+        w->write_pos.store(nearEnd);
+        w->read_pos.store(nearEnd);
+        WriteDeath(*w, 4, 1, 1);
+        BridgeEventDeltas wd;
+        ExpectTrue("PIN WRAP: a payload split at the ring end reads intact",
+                   DrainBridgeEvents(*w, wd, 64) == 1 && wd.kills == 1 && wd.deaths == 0
+                   && wd.total_alive == -1);
+        ExpectTrue("read_pos lands past the wrapped record",
+                   w->read_pos.load() == nearEnd + 24);
+    }
+
+    // ---- Apply -------------------------------------------------------------
+    {
+        Section("apply");
+
+        int kills = 3;
+        swfoc_overlay::ApplyBridgeCounterDelta(kills, 2);
+        int unknown = -1;
+        swfoc_overlay::ApplyBridgeCounterDelta(unknown, 2);
+        int alive = 1;
+        swfoc_overlay::ApplyBridgeCounterDelta(alive, -3);
+        // PIN (APPLY)
+        ExpectTrue("a known counter moves by the delta", kills == 5);
+        ExpectTrue("PIN APPLY: an unknown counter stays unknown", unknown == -1);
+        ExpectTrue("PIN APPLY: a count never goes below zero", alive == 0);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// =============================================================================
+// swfoc_overlay/overlay_extender_state.h — the native extender's toggle state,
+// read straight out of shared memory (2026-10-14).
+//
+// The extender host (native/SwfocExtender.Host) applies credit locks, the
+// timer / fog / AI toggles and the unit-cap and instant-build patches, and
+// after each successful one rewrites a small block named for the game's PID
+// (OverlayState in native/SwfocExtender.Overlay/.../OverlayState.hpp is the
+// spec):
+//
+//     Local\SwfocExtender_OverlayState_<pid>
+//
+// The overlay runs in that same game process, maps the block read-only and
+// copies it on every HUD worker pass, so the toggles reach the HUD with no
+// pipe round-trip. An extender that never ran leaves no block, and the HUD
+// shows nothing for it.
+//
+// Layout mirrored here (little-endian, offsets in bytes):
+//
+//     +0  magic "XOVL"  +4 version (1)  +6 header_size  +8 seq (odd = writing)
+//     +12 flags  +16 known  +20 locked_credits  +24 unit_cap  +28 process_id
+//     +32 writes (u64)  +40 updated_ms (u64)
+//
+// A bit in `known` means the extender has applied that feature in this
+// process; without it the matching `flags` bit says nothing.
+//
+// RED-GREEN REGRESSION PINS (overlay_extender_state_test.cpp)
+// ----------------------------------------------------------
+//   - LAYOUT          : every field sits at the extender's offset.
+//   - NAME            : the block name carries the PID.
+//   - WRONG MAGIC     : a bad magic or an older version reads as no block.
+//   - TORN READ       : an odd seq never settles -> failure, output unchanged.
+//   - UNKNOWN HIDDEN  : only known features are summarized; none -> "".
+//   - SUMMARY         : on/off text and the lock / cap values.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_extender_state_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace swfoc_overlay
+{
+    // Mirrors kOverlayStateBaseName / kOverlayStateMagic / kOverlayStateVersion
+    // and OverlayStateFlag in native/SwfocExtender.Overlay.
+    constexpr const char* kExtenderStateBaseName = "Local\\SwfocExtender_OverlayState";
+    constexpr uint32_t kExtenderStateMagic = 0x4C564F58u;  // "XOVL"
+    constexpr uint16_t kExtenderStateVersion = 1;
+
+    constexpr uint32_t kExtenderCreditsLocked = 0x01;
+    constexpr uint32_t kExtenderTimerFrozen = 0x02;
+    constexpr uint32_t kExtenderFogRevealed = 0x04;
+    constexpr uint32_t kExtenderAiEnabled = 0x08;
+    constexpr uint32_t kExtenderUnitCapPatched = 0x10;
+    constexpr uint32_t kExtenderInstantBuildPatched = 0x20;
+
+    struct ExtenderStateBlock
+    {
+        uint32_t              magic;
+        uint16_t              version;
+        uint16_t              header_size;
+        std::atomic<uint32_t> seq;
+        uint32_t              flags;
+        uint32_t              known;
+        int32_t               locked_credits;
+        int32_t               unit_cap;
+        uint32_t              process_id;
+        uint64_t              writes;
+        uint64_t              updated_ms;
+    };
+    static_assert(offsetof(ExtenderStateBlock, seq) == 8, "seq offset drifted from OverlayStateBlock");
+    static_assert(offsetof(ExtenderStateBlock, locked_credits) == 20, "locked_credits offset drifted from OverlayStateBlock");
+    static_assert(offsetof(ExtenderStateBlock, process_id) == 28, "process_id offset drifted from OverlayStateBlock");
+    static_assert(offsetof(ExtenderStateBlock, writes) == 32, "writes offset drifted from OverlayStateBlock");
+    static_assert(sizeof(ExtenderStateBlock) == 48, "size drifted from OverlayStateBlock");
+
+    // One consistent copy of the block.
+    struct ExtenderState
+    {
+        uint32_t flags = 0;
+        uint32_t known = 0;        // 0 = nothing applied yet
+        int32_t  locked_credits = 0;
+        int32_t  unit_cap = 0;
+        uint64_t writes = 0;       // changes when the extender publishes
+    };
+
+    inline std::string ExtenderStateName(uint32_t pid)
+    {
+        return std::string(kExtenderStateBaseName) + "_" + std::to_string(pid);
+    }
+
+    // Seqlock copy of the block into `out`. Returns false, leaving `out`
+    // alone, when the block is not (yet) valid or never settles.
+    inline bool ReadExtenderState(const ExtenderStateBlock& b, ExtenderState& out, int retries = 8)
+    {
+        for (int attempt = 0; attempt < retries; ++attempt)
+        {
+            const uint32_t before = b.seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            if (b.magic != kExtenderStateMagic || b.version < kExtenderStateVersion) return false;
+            ExtenderState s;
+            s.flags = b.flags;
+            s.known = b.known;
+            s.locked_credits = b.locked_credits;
+            s.unit_cap = b.unit_cap;
+            s.writes = b.writes;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (b.seq.load(std::memory_order_relaxed) != before) continue;
+            out = s;
+            return true;
+        }
+        return false;
+    }
+
+    // HUD line for the known features, e.g.
+    // "Credits locked 5000 | Fog revealed | AI off | Unit cap 300".
+    // Empty when nothing is known.
+    inline std::string SummarizeExtenderState(const ExtenderState& s)
+    {
+        std::string out;
+        char buf[48];
+        auto add = [&out](const char* text) {
+            if (!out.empty()) out += " | ";
+            out += text;
+        };
+        auto on = [&s](uint32_t bit) { return (s.flags & bit) != 0; };
+        if (s.known & kExtenderCreditsLocked)
+        {
+            if (on(kExtenderCreditsLocked))
+            {
+                std::snprintf(buf, sizeof(buf), "Credits locked %d", s.locked_credits);
+                add(buf);
+            }
+            else
+            {
+                add("Credits unlocked");
+            }
+        }
+        if (s.known & kExtenderTimerFrozen) add(on(kExtenderTimerFrozen) ? "Timer frozen" : "Timer running");
+        if (s.known & kExtenderFogRevealed) add(on(kExtenderFogRevealed) ? "Fog revealed" : "Fog on");
+        if (s.known & kExtenderAiEnabled) add(on(kExtenderAiEnabled) ? "AI on" : "AI off");
+        if (s.known & kExtenderUnitCapPatched)
+        {
+            if (on(kExtenderUnitCapPatched))
+            {
+                std::snprintf(buf, sizeof(buf), "Unit cap %d", s.unit_cap);
+                add(buf);
+            }
+            else
+            {
+                add("Unit cap default");
+            }
+        }
+        if (s.known & kExtenderInstantBuildPatched)
+            add(on(kExtenderInstantBuildPatched) ? "Instant build" : "Normal build");
+        return out;
+    }
+}
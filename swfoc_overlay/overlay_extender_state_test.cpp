@@ -0,0 +1,192 @@
+// =============================================================================
+// swfoc_overlay/overlay_extender_state_test.cpp — unit test for
+// overlay_extender_state.h (2026-10-14).
+//
+// overlay_extender_state.h reads the native extender's toggle block straight
+// out of shared memory, so a drifted offset or a torn copy would show the
+// operator a credit lock or a fog reveal that is not there. The block is
+// built here in plain memory, written the way OverlayState::publish writes it.
+//
+// overlay_extender_state.h is header-only and std-only. Build + run via
+// build_extender_state_test.bat — no game, no extender, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - LAYOUT          : fields at the extender's offsets (static_asserts plus
+//                       a byte-level check of unit_cap / updated_ms).
+//   - NAME            : Local\SwfocExtender_OverlayState_<pid>.
+//   - WRONG MAGIC     : bad magic / version 0 -> no state, output unchanged.
+//   - TORN READ       : a block stuck mid-write -> failure, output unchanged.
+//   - UNKNOWN HIDDEN  : unknown features stay out of the summary.
+//   - SUMMARY         : on/off wording and the lock / cap values.
+// =============================================================================
+
+#include "overlay_extender_state.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::ExtenderState;
+    using swfoc_overlay::ExtenderStateBlock;
+    using swfoc_overlay::ReadExtenderState;
+    using swfoc_overlay::SummarizeExtenderState;
+
+    // A settled block, as OverlayState leaves it after `writes` publishes.
+    void InitBlock(ExtenderStateBlock& b)
+    {
+        std::memset(static_cast<void*>(&b), 0, sizeof(b));
+        b.magic = swfoc_overlay::kExtenderStateMagic;
+        b.version = swfoc_overlay::kExtenderStateVersion;
+        b.header_size = sizeof(ExtenderStateBlock);
+        b.seq.store(0);
+        b.process_id = 4242;
+    }
+
+    // One seqlock publish, the way OverlayState::publish does it.
+    void Publish(ExtenderStateBlock& b, uint32_t flags, uint32_t known, int32_t credits, int32_t cap)
+    {
+        const uint32_t seq = b.seq.load();
+        b.seq.store(seq + 1);
+        b.flags = flags;
+        b.known = known;
+        b.locked_credits = credits;
+        b.unit_cap = cap;
+        ++b.writes;
+        b.updated_ms = 1700000000000ull;
+        b.seq.store(seq + 2);
+    }
+}
+
+int main()
+{
+    std::printf("overlay_extender_state_test\n");
+
+    // ---- Layout and name ---------------------------------------------------
+    {
+        Section("layout and name");
+
+        // PIN (LAYOUT)
+        ExtenderStateBlock b;
+        InitBlock(b);
+        Publish(b, swfoc_overlay::kExtenderUnitCapPatched, swfoc_overlay::kExtenderUnitCapPatched, 0, 300);
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(&b);
+        int32_t cap = 0;
+        uint64_t updated = 0;
+        std::memcpy(&cap, raw + 24, 4);
+        std::memcpy(&updated, raw + 40, 8);
+        ExpectEqInt("PIN LAYOUT: unit_cap sits at +24", cap, 300);
+        ExpectTrue("PIN LAYOUT: updated_ms sits at +40", updated == 1700000000000ull);
+
+        // PIN (NAME)
+        ExpectTrue("PIN NAME: the block name carries the PID",
+                   swfoc_overlay::ExtenderStateName(4242) == "Local\\SwfocExtender_OverlayState_4242");
+    }
+
+    // ---- Reads -------------------------------------------------------------
+    {
+        Section("reads");
+
+        ExtenderStateBlock b;
+        InitBlock(b);
+        ExtenderState s;
+        ExpectTrue("a fresh block reads", ReadExtenderState(b, s));
+        ExpectEqInt("nothing known before the first publish", s.known, 0);
+        ExpectTrue("PIN UNKNOWN HIDDEN: nothing known -> empty summary", SummarizeExtenderState(s).empty());
+
+        Publish(b, swfoc_overlay::kExtenderCreditsLocked | swfoc_overlay::kExtenderFogRevealed,
+                swfoc_overlay::kExtenderCreditsLocked | swfoc_overlay::kExtenderFogRevealed
+                    | swfoc_overlay::kExtenderAiEnabled,
+                5000, 0);
+        ExpectTrue("a published block reads", ReadExtenderState(b, s));
+        ExpectEqInt("writes", static_cast<long long>(s.writes), 1);
+        ExpectEqInt("locked_credits", s.locked_credits, 5000);
+
+        // PIN (WRONG MAGIC)
+        ExtenderState kept = s;
+        b.magic = 0;
+        ExtenderState out = kept;
+        ExpectTrue("PIN WRONG MAGIC: a bad magic is refused",
+                   !ReadExtenderState(b, out) && out.writes == kept.writes);
+        b.magic = swfoc_overlay::kExtenderStateMagic;
+        b.version = 0;
+        ExpectTrue("PIN WRONG MAGIC: version 0 is refused", !ReadExtenderState(b, out));
+        b.version = swfoc_overlay::kExtenderStateVersion;
+
+        // PIN (TORN READ)
+        b.seq.store(b.seq.load() + 1);
+        b.flags = 0;
+        ExpectTrue("PIN TORN READ: a block stuck mid-write fails", !ReadExtenderState(b, out));
+        ExpectTrue("PIN TORN READ: the caller's copy is kept",
+                   out.flags == kept.flags && out.known == kept.known);
+        b.seq.store(b.seq.load() + 1);
+        ExpectTrue("once the write ends the block reads again",
+                   ReadExtenderState(b, out) && out.flags == 0);
+    }
+
+    // ---- Summary -----------------------------------------------------------
+    {
+        Section("summary");
+
+        // PIN (SUMMARY)
+        ExtenderState s;
+        s.known = swfoc_overlay::kExtenderCreditsLocked | swfoc_overlay::kExtenderFogRevealed
+            | swfoc_overlay::kExtenderAiEnabled | swfoc_overlay::kExtenderUnitCapPatched;
+        s.flags = swfoc_overlay::kExtenderCreditsLocked | swfoc_overlay::kExtenderFogRevealed
+            | swfoc_overlay::kExtenderUnitCapPatched;
+        s.locked_credits = 5000;
+        s.unit_cap = 300;
+        const std::string text = SummarizeExtenderState(s);
+        ExpectTrue("PIN SUMMARY: known features in order, AI shown off",
+                   text == "Credits locked 5000 | Fog revealed | AI off | Unit cap 300");
+        std::printf("    %s\n", text.c_str());
+
+        s.known = swfoc_overlay::kExtenderTimerFrozen | swfoc_overlay::kExtenderInstantBuildPatched
+            | swfoc_overlay::kExtenderCreditsLocked;
+        s.flags = swfoc_overlay::kExtenderTimerFrozen | swfoc_overlay::kExtenderFogRevealed;
+        ExpectTrue("PIN UNKNOWN HIDDEN: a set bit without its known bit is not shown",
+                   SummarizeExtenderState(s) == "Credits unlocked | Timer frozen | Normal build");
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
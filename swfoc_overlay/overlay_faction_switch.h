@@ -131,6 +131,8 @@ namespace swfoc_overlay
     // Each request resolves its unit through InspectorUnitLuaExpr (honest-defer
     // #2 — see the file header) and embeds a 1-based ordinal + the unit type in
     // its label so the recent-actions toast distinguishes same-type units.
+    // Hand the batch to ActionQueue::EnqueueBulk() so BulkProgress() can
+    // drive a progress bar for the whole switch.
     inline std::vector<ActionRequest> BuildFactionSwitchBatch(
         const std::vector<UnitInfo>& units, int fromSlot, int toSlot)
     {
@@ -0,0 +1,250 @@
+// =============================================================================
+// swfoc_overlay/overlay_font_atlas.h — the overlay's font atlas, baked at
+// build time (2026-10-14).
+//
+// EnsureImGuiInit used to leave the font atlas to the DX9 backend's first
+// NewFrame: base85-decode + decompress ProggyClean, rasterise ~200 glyphs
+// through imstb_truetype, rect-pack, then upload. That all lands on one
+// Present. build.bat now runs font_atlas_bake.exe once, which builds the very
+// same atlas with the vendored ImGui, captures the result in the blob format
+// below and writes it out as overlay_font_atlas_blob.inc. At runtime the DLL
+// only parses the blob and hands ImGui the finished Alpha8 pixels and glyph
+// table (overlay_font_atlas_imgui.h); nothing is rasterised in the game.
+//
+// Blob layout (little-endian, no padding):
+//
+//   "SWFA"  u16 format  u16 ellipsis_count  u32 IMGUI_VERSION_NUM
+//   u16 tex_w  u16 tex_h  f32 font_size  f32 ascent  f32 descent
+//   u32 fallback_char  u32 ellipsis_char  f32 ellipsis_width
+//   f32 ellipsis_step  f32 white_u  f32 white_v
+//   u16 line_uv_count  u16 glyph_count  u32 rle_bytes
+//   line_uv_count x (f32 x4)                       TexUvLines
+//   glyph_count   x (u32 codepoint, f32 x9)        x0 y0 x1 y1 u0 v0 u1 v1 advance
+//   rle_bytes     of RLE-packed Alpha8 pixels
+//
+// The pixels are mostly runs of 0 (and 0xFF in the white/line rects), so
+// they are packed with a PackBits-style RLE: a control byte c < 0x80 is
+// followed by c+1 literal bytes, c >= 0x80 by one byte repeated c-0x7E
+// times (2..129).
+//
+// A blob baked against another ImGui version, or damaged in any way, is
+// refused whole: the caller falls back to the runtime build.
+//
+// RED-GREEN REGRESSION PINS (overlay_font_atlas_test.cpp)
+// -----------------------------------------------------
+//   - RLE ROUND TRIP  : runs, literals and run/literal boundaries decode to
+//                       the input byte for byte.
+//   - RLE EXACT FILL  : a stream that under- or over-fills the texture is
+//                       refused.
+//   - BLOB ROUND TRIP : serialise + parse reproduces every field.
+//   - VERSION GATE    : a blob for another ImGui version is refused.
+//   - TRUNCATION      : every strict prefix of a valid blob is refused.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no bridge. Unit-tested
+// with a plain g++ (build_font_atlas_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace swfoc_overlay
+{
+    constexpr uint32_t kBakedAtlasMagic = 0x41465753u;  // "SWFA"
+    constexpr uint16_t kBakedAtlasFormat = 1;
+    constexpr size_t kBakedAtlasHeaderBytes = 60;
+    constexpr size_t kBakedGlyphBytes = 40;
+
+    struct BakedGlyph
+    {
+        uint32_t codepoint = 0;
+        float x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+        float advance = 0;
+    };
+
+    struct BakedFontAtlas
+    {
+        uint32_t imgui_version = 0;
+        uint16_t tex_w = 0;
+        uint16_t tex_h = 0;
+        float font_size = 0;
+        float ascent = 0;
+        float descent = 0;
+        uint32_t fallback_char = 0;
+        uint32_t ellipsis_char = 0;
+        uint16_t ellipsis_count = 0;
+        float ellipsis_width = 0;
+        float ellipsis_step = 0;
+        float white_u = 0;
+        float white_v = 0;
+        std::vector<float> line_uvs;     // 4 per entry
+        std::vector<BakedGlyph> glyphs;
+        std::vector<uint8_t> alpha8;     // tex_w * tex_h
+    };
+
+    // ---- RLE ---------------------------------------------------------------
+
+    inline void RleEncodeAlpha8(const uint8_t* src, size_t n, std::vector<uint8_t>& out)
+    {
+        size_t i = 0;
+        while (i < n)
+        {
+            size_t run = 1;
+            while (i + run < n && run < 129 && src[i + run] == src[i]) ++run;
+            if (run >= 2)
+            {
+                out.push_back(static_cast<uint8_t>(0x7E + run));
+                out.push_back(src[i]);
+                i += run;
+                continue;
+            }
+            // Literals up to the next pair of equal bytes.
+            size_t lit = 1;
+            while (i + lit < n && lit < 128
+                   && !(i + lit + 1 < n && src[i + lit] == src[i + lit + 1]))
+            {
+                ++lit;
+            }
+            out.push_back(static_cast<uint8_t>(lit - 1));
+            out.insert(out.end(), src + i, src + i + lit);
+            i += lit;
+        }
+    }
+
+    // Decodes into exactly `dst_n` bytes. False when the stream is damaged,
+    // short, or has bytes left over.
+    inline bool RleDecodeAlpha8(const uint8_t* src, size_t n, uint8_t* dst, size_t dst_n)
+    {
+        size_t in = 0;
+        size_t outPos = 0;
+        while (in < n)
+        {
+            const uint8_t c = src[in++];
+            if (c < 0x80)
+            {
+                const size_t lit = static_cast<size_t>(c) + 1;
+                if (in + lit > n || outPos + lit > dst_n) return false;
+                std::memcpy(dst + outPos, src + in, lit);
+                in += lit;
+                outPos += lit;
+            }
+            else
+            {
+                const size_t run = static_cast<size_t>(c) - 0x7E;
+                if (in >= n || outPos + run > dst_n) return false;
+                std::memset(dst + outPos, src[in++], run);
+                outPos += run;
+            }
+        }
+        return outPos == dst_n;
+    }
+
+    // ---- Blob --------------------------------------------------------------
+
+    namespace font_atlas_detail
+    {
+        inline void Put(std::vector<uint8_t>& b, const void* p, size_t n)
+        {
+            const uint8_t* s = static_cast<const uint8_t*>(p);
+            b.insert(b.end(), s, s + n);
+        }
+        inline void PutU16(std::vector<uint8_t>& b, uint16_t v) { Put(b, &v, 2); }
+        inline void PutU32(std::vector<uint8_t>& b, uint32_t v) { Put(b, &v, 4); }
+        inline void PutF32(std::vector<uint8_t>& b, float v) { Put(b, &v, 4); }
+
+        struct Reader
+        {
+            const uint8_t* p;
+            size_t left;
+            bool Get(void* dst, size_t n)
+            {
+                if (n > left) return false;
+                std::memcpy(dst, p, n);
+                p += n;
+                left -= n;
+                return true;
+            }
+        };
+    }
+
+    inline std::vector<uint8_t> SerializeBakedFontAtlas(const BakedFontAtlas& a)
+    {
+        using namespace font_atlas_detail;
+        std::vector<uint8_t> rle;
+        RleEncodeAlpha8(a.alpha8.data(), a.alpha8.size(), rle);
+
+        std::vector<uint8_t> b;
+        b.reserve(kBakedAtlasHeaderBytes + a.line_uvs.size() * 4 + a.glyphs.size() * kBakedGlyphBytes + rle.size());
+        PutU32(b, kBakedAtlasMagic);
+        PutU16(b, kBakedAtlasFormat);
+        PutU16(b, a.ellipsis_count);
+        PutU32(b, a.imgui_version);
+        PutU16(b, a.tex_w);
+        PutU16(b, a.tex_h);
+        PutF32(b, a.font_size);
+        PutF32(b, a.ascent);
+        PutF32(b, a.descent);
+        PutU32(b, a.fallback_char);
+        PutU32(b, a.ellipsis_char);
+        PutF32(b, a.ellipsis_width);
+        PutF32(b, a.ellipsis_step);
+        PutF32(b, a.white_u);
+        PutF32(b, a.white_v);
+        PutU16(b, static_cast<uint16_t>(a.line_uvs.size() / 4));
+        PutU16(b, static_cast<uint16_t>(a.glyphs.size()));
+        PutU32(b, static_cast<uint32_t>(rle.size()));
+        for (size_t i = 0; i + 3 < a.line_uvs.size(); i += 4) Put(b, &a.line_uvs[i], 16);
+        for (const BakedGlyph& g : a.glyphs)
+        {
+            PutU32(b, g.codepoint);
+            PutF32(b, g.x0); PutF32(b, g.y0); PutF32(b, g.x1); PutF32(b, g.y1);
+            PutF32(b, g.u0); PutF32(b, g.v0); PutF32(b, g.u1); PutF32(b, g.v1);
+            PutF32(b, g.advance);
+        }
+        Put(b, rle.data(), rle.size());
+        return b;
+    }
+
+    // Parses `blob` into `out`. False, leaving `out` unspecified, unless the
+    // blob is whole, of this format and baked against `want_imgui_version`.
+    inline bool ParseBakedFontAtlas(const uint8_t* blob, size_t n, uint32_t want_imgui_version,
+                                    BakedFontAtlas* out)
+    {
+        using font_atlas_detail::Reader;
+        if (!blob || !out) return false;
+        Reader r{blob, n};
+        uint32_t magic = 0, rleBytes = 0;
+        uint16_t format = 0, lineCount = 0, glyphCount = 0;
+        if (!r.Get(&magic, 4) || magic != kBakedAtlasMagic) return false;
+        if (!r.Get(&format, 2) || format != kBakedAtlasFormat) return false;
+        if (!r.Get(&out->ellipsis_count, 2) || !r.Get(&out->imgui_version, 4)) return false;
+        if (out->imgui_version != want_imgui_version) return false;
+        if (!r.Get(&out->tex_w, 2) || !r.Get(&out->tex_h, 2)) return false;
+        if (!r.Get(&out->font_size, 4) || !r.Get(&out->ascent, 4) || !r.Get(&out->descent, 4)) return false;
+        if (!r.Get(&out->fallback_char, 4) || !r.Get(&out->ellipsis_char, 4)) return false;
+        if (!r.Get(&out->ellipsis_width, 4) || !r.Get(&out->ellipsis_step, 4)) return false;
+        if (!r.Get(&out->white_u, 4) || !r.Get(&out->white_v, 4)) return false;
+        if (!r.Get(&lineCount, 2) || !r.Get(&glyphCount, 2) || !r.Get(&rleBytes, 4)) return false;
+        if (out->tex_w == 0 || out->tex_h == 0 || glyphCount == 0) return false;
+
+        out->line_uvs.resize(static_cast<size_t>(lineCount) * 4);
+        if (lineCount && !r.Get(out->line_uvs.data(), out->line_uvs.size() * 4)) return false;
+        out->glyphs.resize(glyphCount);
+        for (BakedGlyph& g : out->glyphs)
+        {
+            if (!r.Get(&g.codepoint, 4) || !r.Get(&g.x0, 4) || !r.Get(&g.y0, 4) || !r.Get(&g.x1, 4)
+                || !r.Get(&g.y1, 4) || !r.Get(&g.u0, 4) || !r.Get(&g.v0, 4) || !r.Get(&g.u1, 4)
+                || !r.Get(&g.v1, 4) || !r.Get(&g.advance, 4))
+            {
+                return false;
+            }
+        }
+        if (r.left != rleBytes) return false;
+        out->alpha8.resize(static_cast<size_t>(out->tex_w) * out->tex_h);
+        return RleDecodeAlpha8(r.p, r.left, out->alpha8.data(), out->alpha8.size());
+    }
+}
@@ -0,0 +1,127 @@
+// =============================================================================
+// swfoc_overlay/overlay_font_atlas_imgui.h — moves the overlay's font atlas
+// between ImGui and the baked blob of overlay_font_atlas.h (2026-10-14).
+//
+// Shared by the two ends so they cannot drift apart:
+//   * font_atlas_bake.cpp (build time): ConfigureOverlayFontAtlas + Build,
+//     then CaptureBakedFontAtlas → SerializeBakedFontAtlas.
+//   * overlay.cpp (EnsureImGuiInit): LoadBakedFontAtlas, or, when the DLL
+//     was built without a blob or the blob is refused,
+//     ConfigureOverlayFontAtlas and the usual lazy Build in the backend.
+//
+// LoadBakedFontAtlas leaves the atlas exactly as Build would have: Alpha8
+// pixels, white-pixel and line UVs, one font with its glyph table and
+// lookup tables. ImGui_ImplDX9_CreateDeviceObjects then uploads it as-is.
+//
+// Needs imgui.h (and imgui_internal.h for IM_DRAWLIST_TEX_LINES_WIDTH_MAX);
+// no Windows, no D3D9.
+// =============================================================================
+
+#pragma once
+
+#include "overlay_font_atlas.h"
+
+#include "imgui/imgui.h"
+#include "imgui/imgui_internal.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace swfoc_overlay
+{
+    // The overlay draws no software cursor, so the atlas carries no cursor
+    // shapes — and a loaded atlas has no custom rects to find them in.
+    constexpr ImFontAtlasFlags kOverlayFontAtlasFlags = ImFontAtlasFlags_NoMouseCursors;
+
+    constexpr size_t kOverlayLineUvFloats = (IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1) * 4;
+
+    // The overlay's fonts, as both the baker and the runtime fallback add them.
+    inline void ConfigureOverlayFontAtlas(ImFontAtlas* atlas)
+    {
+        atlas->Flags |= kOverlayFontAtlasFlags;
+        atlas->AddFontDefault();
+    }
+
+    // The built atlas's first font + texture. False when it is not built.
+    inline bool CaptureBakedFontAtlas(ImFontAtlas* atlas, BakedFontAtlas* out)
+    {
+        if (!atlas->IsBuilt() || atlas->Fonts.Size < 1 || !atlas->TexPixelsAlpha8) return false;
+        const ImFont* font = atlas->Fonts[0];
+        out->imgui_version = IMGUI_VERSION_NUM;
+        out->tex_w = static_cast<uint16_t>(atlas->TexWidth);
+        out->tex_h = static_cast<uint16_t>(atlas->TexHeight);
+        out->font_size = font->FontSize;
+        out->ascent = font->Ascent;
+        out->descent = font->Descent;
+        out->fallback_char = font->FallbackChar;
+        out->ellipsis_char = font->EllipsisChar;
+        out->ellipsis_count = static_cast<uint16_t>(font->EllipsisCharCount);
+        out->ellipsis_width = font->EllipsisWidth;
+        out->ellipsis_step = font->EllipsisCharStep;
+        out->white_u = atlas->TexUvWhitePixel.x;
+        out->white_v = atlas->TexUvWhitePixel.y;
+        out->line_uvs.assign(&atlas->TexUvLines[0].x, &atlas->TexUvLines[0].x + kOverlayLineUvFloats);
+        out->glyphs.clear();
+        for (const ImFontGlyph& g : font->Glyphs)
+        {
+            if (g.Codepoint == '\t') continue;  // synthesised by BuildLookupTable
+            BakedGlyph b;
+            b.codepoint = g.Codepoint;
+            b.x0 = g.X0; b.y0 = g.Y0; b.x1 = g.X1; b.y1 = g.Y1;
+            b.u0 = g.U0; b.v0 = g.V0; b.u1 = g.U1; b.v1 = g.V1;
+            b.advance = g.AdvanceX;
+            out->glyphs.push_back(b);
+        }
+        out->alpha8.assign(atlas->TexPixelsAlpha8,
+                           atlas->TexPixelsAlpha8 + static_cast<size_t>(atlas->TexWidth) * atlas->TexHeight);
+        return true;
+    }
+
+    // Replaces `atlas` with the baked one. False, leaving `atlas` untouched,
+    // when the blob is refused (damaged, or baked against another ImGui).
+    inline bool LoadBakedFontAtlas(ImFontAtlas* atlas, const unsigned char* blob, size_t n)
+    {
+        BakedFontAtlas baked;
+        if (!ParseBakedFontAtlas(blob, n, IMGUI_VERSION_NUM, &baked)) return false;
+        if (baked.line_uvs.size() != kOverlayLineUvFloats) return false;
+
+        atlas->Clear();
+        atlas->Flags |= kOverlayFontAtlasFlags;
+        atlas->TexWidth = baked.tex_w;
+        atlas->TexHeight = baked.tex_h;
+        atlas->TexUvScale = ImVec2(1.0f / baked.tex_w, 1.0f / baked.tex_h);
+        atlas->TexUvWhitePixel = ImVec2(baked.white_u, baked.white_v);
+        std::memcpy(&atlas->TexUvLines[0].x, baked.line_uvs.data(), kOverlayLineUvFloats * sizeof(float));
+        atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(baked.alpha8.size()));
+        std::memcpy(atlas->TexPixelsAlpha8, baked.alpha8.data(), baked.alpha8.size());
+
+        ImFontConfig cfg;
+        cfg.FontDataOwnedByAtlas = false;
+        cfg.SizePixels = baked.font_size;
+        std::snprintf(cfg.Name, sizeof(cfg.Name), "ProggyClean.ttf, %dpx (baked)", static_cast<int>(baked.font_size));
+        atlas->ConfigData.push_back(cfg);
+
+        ImFont* font = IM_NEW(ImFont);
+        atlas->Fonts.push_back(font);
+        atlas->ConfigData.back().DstFont = font;
+        font->ConfigData = &atlas->ConfigData.back();
+        font->ConfigDataCount = 1;
+        font->ContainerAtlas = atlas;
+        font->FontSize = baked.font_size;
+        font->Ascent = baked.ascent;
+        font->Descent = baked.descent;
+        font->FallbackChar = static_cast<ImWchar>(baked.fallback_char);
+        font->EllipsisChar = static_cast<ImWchar>(baked.ellipsis_char);
+        for (const BakedGlyph& g : baked.glyphs)
+        {
+            font->AddGlyph(nullptr, static_cast<ImWchar>(g.codepoint), g.x0, g.y0, g.x1, g.y1,
+                           g.u0, g.v0, g.u1, g.v1, g.advance);
+        }
+        font->BuildLookupTable();
+        font->EllipsisCharCount = baked.ellipsis_count;
+        font->EllipsisWidth = baked.ellipsis_width;
+        font->EllipsisCharStep = baked.ellipsis_step;
+        atlas->TexReady = true;
+        return true;
+    }
+}
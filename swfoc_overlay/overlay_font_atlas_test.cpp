@@ -0,0 +1,216 @@
+// =============================================================================
+// swfoc_overlay/overlay_font_atlas_test.cpp — unit test for
+// overlay_font_atlas.h (2026-10-14).
+//
+// The DLL trusts a parsed blob enough to hand its pixels and glyph table
+// straight to ImGui, so the parser is the one place a damaged or stale blob
+// can be caught. Every refusal path is pinned, and so is a byte-exact round
+// trip through the RLE the pixels travel in.
+//
+// overlay_font_atlas.h is header-only and std-only. Build + run via
+// build_font_atlas_test.bat — no game, no pipe, no ImGui, no D3D9. The
+// ImGui side (overlay_font_atlas_imgui.h) is exercised by font_atlas_bake,
+// which loads every blob back before writing it.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - RLE ROUND TRIP  : runs, literals, the 128/129 caps, run/literal seams.
+//   - RLE EXACT FILL  : short, long and cut-off streams are refused.
+//   - BLOB ROUND TRIP : every field survives serialise + parse.
+//   - VERSION GATE    : another IMGUI_VERSION_NUM or format is refused.
+//   - TRUNCATION      : every strict prefix, and a trailing byte, refused.
+// =============================================================================
+
+#include "overlay_font_atlas.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::BakedFontAtlas;
+    using swfoc_overlay::BakedGlyph;
+
+    bool RoundTrips(const std::vector<uint8_t>& in)
+    {
+        std::vector<uint8_t> rle;
+        swfoc_overlay::RleEncodeAlpha8(in.data(), in.size(), rle);
+        std::vector<uint8_t> out(in.size(), 0xAA);
+        return swfoc_overlay::RleDecodeAlpha8(rle.data(), rle.size(), out.data(), out.size()) && out == in;
+    }
+
+    // A small atlas shaped like the real one: mostly zero, a white rect,
+    // anti-aliased glyph edges.
+    BakedFontAtlas SampleAtlas()
+    {
+        BakedFontAtlas a;
+        a.imgui_version = 19150;
+        a.tex_w = 64;
+        a.tex_h = 16;
+        a.font_size = 13.0f;
+        a.ascent = 11.0f;
+        a.descent = -2.0f;
+        a.fallback_char = '?';
+        a.ellipsis_char = 0x85;
+        a.ellipsis_count = 1;
+        a.ellipsis_width = 6.0f;
+        a.ellipsis_step = 6.0f;
+        a.white_u = 0.5f / 64;
+        a.white_v = 0.5f / 16;
+        for (int i = 0; i < 8 * 4; i++) a.line_uvs.push_back(static_cast<float>(i) / 32.0f);
+        for (uint32_t c = 0x20; c < 0x30; c++)
+        {
+            BakedGlyph g;
+            g.codepoint = c;
+            g.x0 = 0; g.y0 = 1; g.x1 = 6; g.y1 = 14;
+            g.u0 = (c - 0x20) * 6 / 64.0f; g.v0 = 0; g.u1 = g.u0 + 6 / 64.0f; g.v1 = 13 / 16.0f;
+            g.advance = 7.0f;
+            a.glyphs.push_back(g);
+        }
+        a.alpha8.assign(64 * 16, 0);
+        for (int i = 0; i < 4; i++) a.alpha8[i] = 0xFF;
+        for (int i = 70; i < 400; i += 3) a.alpha8[i] = static_cast<uint8_t>(i * 7);
+        return a;
+    }
+}
+
+int main()
+{
+    std::printf("overlay_font_atlas_test\n");
+
+    // ---- RLE ---------------------------------------------------------------
+    {
+        Section("rle");
+
+        // PIN (RLE ROUND TRIP)
+        ExpectTrue("PIN RLE ROUND TRIP: empty", RoundTrips({}));
+        ExpectTrue("PIN RLE ROUND TRIP: one byte", RoundTrips({7}));
+        ExpectTrue("PIN RLE ROUND TRIP: one pair", RoundTrips({7, 7}));
+        ExpectTrue("PIN RLE ROUND TRIP: a 129 run", RoundTrips(std::vector<uint8_t>(129, 0)));
+        ExpectTrue("PIN RLE ROUND TRIP: a 130 run splits", RoundTrips(std::vector<uint8_t>(130, 0)));
+        std::vector<uint8_t> lits;
+        for (int i = 0; i < 300; i++) lits.push_back(static_cast<uint8_t>(i * 31 + 1));
+        ExpectTrue("PIN RLE ROUND TRIP: 300 literals cross the 128 cap", RoundTrips(lits));
+        ExpectTrue("PIN RLE ROUND TRIP: literal / run seams", RoundTrips({1, 2, 3, 3, 4, 5, 5, 5, 6, 0, 0}));
+
+        std::vector<uint8_t> zeros(32768, 0), rle;
+        swfoc_overlay::RleEncodeAlpha8(zeros.data(), zeros.size(), rle);
+        ExpectEqInt("an empty 512x64 page packs to 2 bytes per 129", static_cast<long long>(rle.size()),
+                    2 * ((32768 + 128) / 129));
+
+        // PIN (RLE EXACT FILL)
+        std::vector<uint8_t> out(4);
+        const uint8_t run3[] = {0x81, 9};  // 3 x 9
+        ExpectTrue("PIN RLE EXACT FILL: short stream refused",
+                   !swfoc_overlay::RleDecodeAlpha8(run3, sizeof(run3), out.data(), 4));
+        ExpectTrue("PIN RLE EXACT FILL: long stream refused",
+                   !swfoc_overlay::RleDecodeAlpha8(run3, sizeof(run3), out.data(), 2));
+        ExpectTrue("PIN RLE EXACT FILL: exact stream accepted",
+                   swfoc_overlay::RleDecodeAlpha8(run3, sizeof(run3), out.data(), 3) && out[2] == 9);
+        const uint8_t cutLit[] = {0x02, 1, 2};  // promises 3 literals, has 2
+        ExpectTrue("PIN RLE EXACT FILL: cut-off literals refused",
+                   !swfoc_overlay::RleDecodeAlpha8(cutLit, sizeof(cutLit), out.data(), 3));
+        const uint8_t cutRun[] = {0x81};
+        ExpectTrue("PIN RLE EXACT FILL: run without its byte refused",
+                   !swfoc_overlay::RleDecodeAlpha8(cutRun, sizeof(cutRun), out.data(), 3));
+    }
+
+    // ---- Blob --------------------------------------------------------------
+    {
+        Section("blob");
+
+        const BakedFontAtlas a = SampleAtlas();
+        const std::vector<uint8_t> blob = swfoc_overlay::SerializeBakedFontAtlas(a);
+
+        // PIN (BLOB ROUND TRIP)
+        BakedFontAtlas b;
+        const bool parsed = swfoc_overlay::ParseBakedFontAtlas(blob.data(), blob.size(), 19150, &b);
+        ExpectTrue("PIN BLOB ROUND TRIP: parses", parsed);
+        ExpectTrue("PIN BLOB ROUND TRIP: scalars",
+                   b.tex_w == a.tex_w && b.tex_h == a.tex_h && b.font_size == a.font_size
+                       && b.ascent == a.ascent && b.descent == a.descent
+                       && b.fallback_char == a.fallback_char && b.ellipsis_char == a.ellipsis_char
+                       && b.ellipsis_count == a.ellipsis_count && b.ellipsis_width == a.ellipsis_width
+                       && b.ellipsis_step == a.ellipsis_step && b.white_u == a.white_u
+                       && b.white_v == a.white_v);
+        ExpectTrue("PIN BLOB ROUND TRIP: line uvs", b.line_uvs == a.line_uvs);
+        bool glyphsEqual = b.glyphs.size() == a.glyphs.size();
+        for (size_t i = 0; glyphsEqual && i < a.glyphs.size(); i++)
+        {
+            glyphsEqual = std::memcmp(&a.glyphs[i], &b.glyphs[i], sizeof(BakedGlyph)) == 0;
+        }
+        ExpectTrue("PIN BLOB ROUND TRIP: glyphs", glyphsEqual);
+        ExpectTrue("PIN BLOB ROUND TRIP: pixels", b.alpha8 == a.alpha8);
+        std::vector<uint8_t> rle;
+        swfoc_overlay::RleEncodeAlpha8(a.alpha8.data(), a.alpha8.size(), rle);
+        ExpectEqInt("blob size matches the documented layout", static_cast<long long>(blob.size()),
+                    static_cast<long long>(swfoc_overlay::kBakedAtlasHeaderBytes + a.line_uvs.size() * 4
+                                           + a.glyphs.size() * swfoc_overlay::kBakedGlyphBytes + rle.size()));
+        ExpectTrue("the packed pixels are smaller than the raw ones", rle.size() < a.alpha8.size() / 2);
+
+        // PIN (VERSION GATE)
+        BakedFontAtlas c;
+        ExpectTrue("PIN VERSION GATE: another ImGui refused",
+                   !swfoc_overlay::ParseBakedFontAtlas(blob.data(), blob.size(), 19160, &c));
+        std::vector<uint8_t> fmt = blob;
+        fmt[4] = 2;
+        ExpectTrue("PIN VERSION GATE: another format refused",
+                   !swfoc_overlay::ParseBakedFontAtlas(fmt.data(), fmt.size(), 19150, &c));
+        std::vector<uint8_t> magic = blob;
+        magic[0] = 'X';
+        ExpectTrue("bad magic refused", !swfoc_overlay::ParseBakedFontAtlas(magic.data(), magic.size(), 19150, &c));
+
+        // PIN (TRUNCATION)
+        bool allPrefixesRefused = true;
+        for (size_t n = 0; n < blob.size(); n++)
+        {
+            if (swfoc_overlay::ParseBakedFontAtlas(blob.data(), n, 19150, &c)) allPrefixesRefused = false;
+        }
+        ExpectTrue("PIN TRUNCATION: every strict prefix refused", allPrefixesRefused);
+        std::vector<uint8_t> longer = blob;
+        longer.push_back(0);
+        ExpectTrue("PIN TRUNCATION: a trailing byte refused",
+                   !swfoc_overlay::ParseBakedFontAtlas(longer.data(), longer.size(), 19150, &c));
+        ExpectTrue("null blob refused", !swfoc_overlay::ParseBakedFontAtlas(nullptr, 0, 19150, &c));
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// =============================================================================
+// swfoc_overlay/overlay_frame_cache_test.cpp — unit test for
+// overlay_frame_cache.h (2026-10-14).
+//
+// A reused frame that should have been rebuilt shows the operator a stale
+// number or swallows a click; a rebuilt frame that could have been reused
+// only costs CPU. So every input that must force a rebuild is pinned one at
+// a time, and the steady state is pinned to reuse.
+//
+// overlay_frame_cache.h is header-only and std-only. Build + run via
+// build_frame_cache_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - FIRST BUILDS   : the first frame rebuilds.
+//   - STEADY REUSES  : identical inputs reuse.
+//   - EACH INPUT     : each input alone forces a rebuild.
+//   - BACKSTOP       : reuse stops after kOverlayMaxReusedFrames.
+//   - TIMES WINDOW   : the summary covers only the last window.
+// =============================================================================
+
+#include "overlay_frame_cache.h"
+
+#include <cstdio>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::OverlayFrameCache;
+    using swfoc_overlay::OverlayFrameInputs;
+    using swfoc_overlay::OverlayFrameNeedsRebuild;
+    using swfoc_overlay::OverlayFrameTimes;
+    using swfoc_overlay::kOverlayMaxReusedFrames;
+
+    OverlayFrameInputs Steady()
+    {
+        OverlayFrameInputs in;
+        in.visible = true;
+        in.snapshot_tick = 1000;
+        in.action_stamp = 7;
+        in.client_w = 1920;
+        in.client_h = 1080;
+        return in;
+    }
+
+    // A primed cache, then one frame with `in`: did it rebuild?
+    bool RebuildsWith(const OverlayFrameInputs& in)
+    {
+        OverlayFrameCache c;
+        OverlayFrameNeedsRebuild(c, Steady());
+        OverlayFrameNeedsRebuild(c, Steady());
+        return OverlayFrameNeedsRebuild(c, in);
+    }
+}
+
+int main()
+{
+    std::printf("overlay_frame_cache_test\n");
+
+    // ---- Rebuild decisions -------------------------------------------------
+    {
+        Section("rebuild decisions");
+
+        // PIN (FIRST BUILDS), PIN (STEADY REUSES)
+        OverlayFrameCache c;
+        ExpectTrue("PIN FIRST BUILDS: the first frame rebuilds", OverlayFrameNeedsRebuild(c, Steady()));
+        ExpectTrue("PIN STEADY REUSES: the same inputs reuse", !OverlayFrameNeedsRebuild(c, Steady()));
+        ExpectTrue("PIN STEADY REUSES: and keep reusing", !OverlayFrameNeedsRebuild(c, Steady()));
+
+        // PIN (EACH INPUT)
+        OverlayFrameInputs in = Steady();
+        in.snapshot_tick = 1500;
+        ExpectTrue("PIN EACH INPUT: a new snapshot rebuilds", RebuildsWith(in));
+        in = Steady();
+        in.action_stamp = 8;
+        ExpectTrue("PIN EACH INPUT: an action result rebuilds", RebuildsWith(in));
+        in = Steady();
+        in.client_w = 1280;
+        ExpectTrue("PIN EACH INPUT: a resized client rebuilds", RebuildsWith(in));
+        in = Steady();
+        in.client_h = 720;
+        ExpectTrue("PIN EACH INPUT: a taller / shorter client rebuilds", RebuildsWith(in));
+        in = Steady();
+        in.visible = false;
+        ExpectTrue("PIN EACH INPUT: hiding rebuilds (to an empty frame)", RebuildsWith(in));
+        in = Steady();
+        in.pending_events = 1;
+        ExpectTrue("PIN EACH INPUT: a queued input event rebuilds", RebuildsWith(in));
+        in = Steady();
+        in.interacting = true;
+        ExpectTrue("PIN EACH INPUT: an interaction rebuilds", RebuildsWith(in));
+
+        OverlayFrameCache drag;
+        OverlayFrameNeedsRebuild(drag, Steady());
+        in = Steady();
+        in.interacting = true;
+        OverlayFrameNeedsRebuild(drag, in);
+        ExpectTrue("every frame of the interaction rebuilds", OverlayFrameNeedsRebuild(drag, in));
+        ExpectTrue("the frame after it ends rebuilds once more", OverlayFrameNeedsRebuild(drag, Steady()));
+        ExpectTrue("then the steady state reuses again", !OverlayFrameNeedsRebuild(drag, Steady()));
+
+        // PIN (BACKSTOP)
+        OverlayFrameCache b;
+        OverlayFrameNeedsRebuild(b, Steady());
+        int reused = 0;
+        while (!OverlayFrameNeedsRebuild(b, Steady())) ++reused;
+        ExpectEqInt("PIN BACKSTOP: reuse stops after kOverlayMaxReusedFrames",
+                    reused, kOverlayMaxReusedFrames);
+        ExpectTrue("PIN BACKSTOP: and the counter starts over", !OverlayFrameNeedsRebuild(b, Steady()));
+    }
+
+    // ---- Frame times -------------------------------------------------------
+    {
+        Section("frame times");
+
+        OverlayFrameTimes t;
+        swfoc_overlay::OverlayFrameTimeSummary s = swfoc_overlay::SummarizeOverlayFrameTimes(t);
+        ExpectTrue("an empty window summarizes to zero", s.avg_us == 0.0f && s.max_us == 0.0f);
+
+        swfoc_overlay::RecordOverlayFrameTime(t, 900.0f, true);
+        for (int i = 0; i < 3; ++i) swfoc_overlay::RecordOverlayFrameTime(t, 100.0f, false);
+        s = swfoc_overlay::SummarizeOverlayFrameTimes(t);
+        ExpectEqInt("average of 900 + 3 x 100", static_cast<long long>(s.avg_us), 300);
+        ExpectEqInt("max", static_cast<long long>(s.max_us), 900);
+        ExpectEqInt("one of four passes rebuilt", s.rebuilt_pct, 25);
+
+        // PIN (TIMES WINDOW)
+        for (int i = 0; i < swfoc_overlay::kOverlayFrameTimeWindow; ++i)
+        {
+            swfoc_overlay::RecordOverlayFrameTime(t, 50.0f, i % 2 == 0);
+        }
+        s = swfoc_overlay::SummarizeOverlayFrameTimes(t);
+        ExpectEqInt("PIN TIMES WINDOW: the 900 us spike has aged out",
+                    static_cast<long long>(s.max_us), 50);
+        ExpectEqInt("PIN TIMES WINDOW: the window is full, not longer",
+                    t.count, swfoc_overlay::kOverlayFrameTimeWindow);
+        ExpectEqInt("PIN TIMES WINDOW: half the window rebuilt", s.rebuilt_pct, 50);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -226,6 +226,8 @@ namespace swfoc_overlay
     // is crossed. The walk is clamped to kMaxRaycastUnits so a malformed count
     // cannot read past the HudSnapshot array. On a tie in entry distance the
     // lower array index wins (the strict `<` keeps the first-found hit).
+    // 2026-10-14: NearestUnitHitSoa (overlay_hit_test_soa.h) returns the same
+    // answer four boxes at a time over struct-of-arrays columns, uncapped.
     inline UnitHit NearestUnitHit(const WorldRay& ray,
                                   const UnitAabb* units, int count)
     {
@@ -0,0 +1,234 @@
+// =============================================================================
+// swfoc_overlay/overlay_hit_test_soa.h — struct-of-arrays unit boxes and a
+// four-wide SSE ray-vs-AABB kernel (2026-10-14).
+//
+// NearestUnitHit (overlay_hit_test.h) runs the slab test one box at a time
+// through scalar Vec3 math. With the bridge's bulk unit table a pick can see
+// the whole battle (up to 2048 units), so this header keeps the boxes as six
+// float columns and tests four boxes per iteration:
+//
+//   * UnitAabbSoa: min_x .. max_z columns plus handles, padded to a multiple
+//     of kUnitAabbSoaLanes with inverted (never-hit) boxes.
+//   * NearestUnitHitSoa: the same answer as NearestUnitHit over the same
+//     list — slab method, t >= 0 clamp, parallel-axis rule at
+//     kRayParallelEpsilon, inverted boxes skipped, nearest entry wins and a
+//     tie goes to the lower index — with no kMaxRaycastUnits clamp. The
+//     per-axis arithmetic is RayAabbIntersect's, operation for operation,
+//     so t comes back bit-identical.
+//
+// SSE2 is the x86-64 baseline, so the kernel needs no extra compiler flag;
+// an 8-wide AVX path would need -mavx on the DLL and a CPU check at load,
+// for at most one more doubling on a path that runs once per click. Other
+// targets fall back to a scalar loop over the same columns.
+//
+// RED-GREEN REGRESSION PINS (overlay_hit_test_soa_test.cpp)
+// -------------------------------------------------------
+//   - ORACLE               : the overlay_hit_test.h pins (nearest hit wins,
+//                            miss, box behind origin, parallel-axis ray,
+//                            inverted box, origin inside) give the same
+//                            hit / index / handle / t through both kernels.
+//   - TIE KEEPS ORDER      : equal entry t resolves to the lower index, also
+//                            across lanes and iterations.
+//   - PADDING NEVER HITS   : a count that is not a multiple of four never
+//                            reports a padding lane.
+//   - RANDOM AGREEMENT     : 2048-box scenes agree with the scalar walk.
+//   - BENCHMARK            : scalar vs SIMD timing is printed (not asserted).
+//
+// Pure, header-only, std-only plus <emmintrin.h>. No Windows, no ImGui, no
+// bridge. Unit-tested with a plain g++ (build_hit_test_soa_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include "overlay_unit_aabb.h"  // UnitAabbSet, and through it overlay_hit_test.h
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SWFOC_HIT_TEST_SSE2 1
+#endif
+
+namespace swfoc_overlay
+{
+    constexpr int kUnitAabbSoaLanes = 4;
+
+    struct UnitAabbSoa
+    {
+        int                        count = 0;  // real boxes; columns are padded
+        std::vector<float>         min_x, min_y, min_z;
+        std::vector<float>         max_x, max_y, max_z;
+        std::vector<std::uint64_t> handle;
+    };
+
+    // Rebuilds `soa` from `count` boxes. Invalid boxes are kept in place so
+    // indices match the input; the kernel skips them as the scalar walk does.
+    inline void BuildUnitAabbSoa(UnitAabbSoa& soa, const UnitAabb* units, int count)
+    {
+        if (units == nullptr || count < 0) count = 0;
+        const std::size_t padded = static_cast<std::size_t>(
+            (count + kUnitAabbSoaLanes - 1) / kUnitAabbSoaLanes * kUnitAabbSoaLanes);
+        soa.count = count;
+        // Padding is inverted on every axis: AabbIsValid rejects it.
+        soa.min_x.assign(padded, 1.0f);
+        soa.min_y.assign(padded, 1.0f);
+        soa.min_z.assign(padded, 1.0f);
+        soa.max_x.assign(padded, 0.0f);
+        soa.max_y.assign(padded, 0.0f);
+        soa.max_z.assign(padded, 0.0f);
+        soa.handle.assign(padded, 0);
+        for (int i = 0; i < count; ++i)
+        {
+            soa.min_x[i] = units[i].box.min.x;
+            soa.min_y[i] = units[i].box.min.y;
+            soa.min_z[i] = units[i].box.min.z;
+            soa.max_x[i] = units[i].box.max.x;
+            soa.max_y[i] = units[i].box.max.y;
+            soa.max_z[i] = units[i].box.max.z;
+            soa.handle[i] = units[i].handle;
+        }
+    }
+
+    inline void BuildUnitAabbSoa(UnitAabbSoa& soa, const UnitAabbSet& set)
+    {
+        int count = set.count;
+        if (count > kMaxRaycastUnits) count = kMaxRaycastUnits;
+        BuildUnitAabbSoa(soa, set.entries, count);
+    }
+
+    namespace soa_detail
+    {
+        inline UnitHit Miss()
+        {
+            UnitHit result{};
+            result.hit    = false;
+            result.index  = -1;
+            result.handle = 0;
+            result.t      = 0.0f;
+            return result;
+        }
+
+        inline UnitHit ScalarNearest(const WorldRay& ray, const UnitAabbSoa& soa)
+        {
+            UnitHit result = Miss();
+            for (int i = 0; i < soa.count; ++i)
+            {
+                const Aabb box{ Vec3{ soa.min_x[i], soa.min_y[i], soa.min_z[i] },
+                                Vec3{ soa.max_x[i], soa.max_y[i], soa.max_z[i] } };
+                float t = 0.0f;
+                if (!RayAabbIntersect(ray, box, t)) continue;
+                if (!result.hit || t < result.t)
+                {
+                    result.hit    = true;
+                    result.index  = i;
+                    result.handle = soa.handle[i];
+                    result.t      = t;
+                }
+            }
+            return result;
+        }
+
+#ifdef SWFOC_HIT_TEST_SSE2
+        // Narrows [entry, exit] by one axis, or marks every lane whose slab
+        // a parallel ray sits outside of. Mirrors RayAabbIntersect's loop body.
+        inline void Slab(float o, float d, __m128 lo, __m128 hi,
+                         __m128& entry, __m128& exit, __m128& outside)
+        {
+            const __m128 vo = _mm_set1_ps(o);
+            if (std::fabs(d) <= kRayParallelEpsilon)
+            {
+                outside = _mm_or_ps(outside, _mm_or_ps(_mm_cmplt_ps(vo, lo),
+                                                        _mm_cmpgt_ps(vo, hi)));
+                return;
+            }
+            const __m128 inv = _mm_set1_ps(1.0f / d);
+            const __m128 t1 = _mm_mul_ps(_mm_sub_ps(lo, vo), inv);
+            const __m128 t2 = _mm_mul_ps(_mm_sub_ps(hi, vo), inv);
+            // Current bound second: maxps / minps return it on a tie, as
+            // the scalar `>` / `<` keep it (so t = 0 stays +0, never -0).
+            entry = _mm_max_ps(_mm_min_ps(t1, t2), entry);
+            exit  = _mm_min_ps(_mm_max_ps(t1, t2), exit);
+        }
+
+        inline UnitHit SseNearest(const WorldRay& ray, const UnitAabbSoa& soa)
+        {
+            const float inf = std::numeric_limits<float>::infinity();
+            __m128  bestT   = _mm_set1_ps(inf);
+            __m128i bestIdx = _mm_set1_epi32(-1);
+            __m128i idx     = _mm_setr_epi32(0, 1, 2, 3);
+            const __m128i step = _mm_set1_epi32(kUnitAabbSoaLanes);
+            const int lanes = static_cast<int>(soa.min_x.size());
+            for (int i = 0; i < lanes; i += kUnitAabbSoaLanes)
+            {
+                const __m128 lx = _mm_loadu_ps(&soa.min_x[i]);
+                const __m128 ly = _mm_loadu_ps(&soa.min_y[i]);
+                const __m128 lz = _mm_loadu_ps(&soa.min_z[i]);
+                const __m128 hx = _mm_loadu_ps(&soa.max_x[i]);
+                const __m128 hy = _mm_loadu_ps(&soa.max_y[i]);
+                const __m128 hz = _mm_loadu_ps(&soa.max_z[i]);
+
+                // AabbIsValid per lane (false on NaN, like the scalar form).
+                const __m128 valid = _mm_and_ps(_mm_cmple_ps(lx, hx),
+                    _mm_and_ps(_mm_cmple_ps(ly, hy), _mm_cmple_ps(lz, hz)));
+
+                __m128 entry   = _mm_setzero_ps();
+                __m128 exit    = _mm_set1_ps(inf);
+                __m128 outside = _mm_setzero_ps();
+                Slab(ray.origin.x, ray.direction.x, lx, hx, entry, exit, outside);
+                Slab(ray.origin.y, ray.direction.y, ly, hy, entry, exit, outside);
+                Slab(ray.origin.z, ray.direction.z, lz, hz, entry, exit, outside);
+
+                // Strict < keeps the earlier (lower) index of each lane.
+                const __m128 better = _mm_andnot_ps(outside, _mm_and_ps(valid,
+                    _mm_and_ps(_mm_cmple_ps(entry, exit), _mm_cmplt_ps(entry, bestT))));
+                bestT = _mm_or_ps(_mm_and_ps(better, entry), _mm_andnot_ps(better, bestT));
+                const __m128i take = _mm_castps_si128(better);
+                bestIdx = _mm_or_si128(_mm_and_si128(take, idx), _mm_andnot_si128(take, bestIdx));
+                idx = _mm_add_epi32(idx, step);
+            }
+
+            alignas(16) float   t[kUnitAabbSoaLanes];
+            alignas(16) int32_t at[kUnitAabbSoaLanes];
+            _mm_store_ps(t, bestT);
+            _mm_store_si128(reinterpret_cast<__m128i*>(at), bestIdx);
+            UnitHit result = Miss();
+            for (int lane = 0; lane < kUnitAabbSoaLanes; ++lane)
+            {
+                if (at[lane] < 0) continue;
+                if (!result.hit || t[lane] < result.t
+                    || (t[lane] == result.t && at[lane] < result.index))
+                {
+                    result.hit    = true;
+                    result.index  = at[lane];
+                    result.handle = soa.handle[at[lane]];
+                    result.t      = t[lane];
+                }
+            }
+            return result;
+        }
+#endif
+    }
+
+    // The box the ray enters first, as NearestUnitHit reports it for the
+    // same list — without the kMaxRaycastUnits clamp.
+    inline UnitHit NearestUnitHitSoa(const WorldRay& ray, const UnitAabbSoa& soa)
+    {
+        if (!ray.valid || soa.count <= 0) return soa_detail::Miss();
+#ifdef SWFOC_HIT_TEST_SSE2
+        return soa_detail::SseNearest(ray, soa);
+#else
+        return soa_detail::ScalarNearest(ray, soa);
+#endif
+    }
+
+    // The scalar walk over the same columns, for targets without SSE2 and as
+    // the test's reference.
+    inline UnitHit NearestUnitHitSoaScalar(const WorldRay& ray, const UnitAabbSoa& soa)
+    {
+        if (!ray.valid || soa.count <= 0) return soa_detail::Miss();
+        return soa_detail::ScalarNearest(ray, soa);
+    }
+}
@@ -0,0 +1,267 @@
+// =============================================================================
+// swfoc_overlay/overlay_hit_test_soa_test.cpp — unit test + benchmark for
+// overlay_hit_test_soa.h (2026-10-14).
+//
+// The SSE kernel must pick exactly what NearestUnitHit picks. The
+// overlay_hit_test_test.cpp pins are replayed here as the oracle: each scene
+// goes through NearestUnitHit and through NearestUnitHitSoa, and hit, index,
+// handle and t must agree (t bit for bit). Random 2048-box scenes then
+// compare the kernel with the scalar walk over the same columns, and a
+// benchmark case prints both timings.
+//
+// overlay_hit_test_soa.h is header-only and std-only plus <emmintrin.h>.
+// Build + run via build_hit_test_soa_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - ORACLE             : nearest / miss / behind / parallel / invalid /
+//                          inside scenes agree with NearestUnitHit.
+//   - TIE KEEPS ORDER    : equal t picks the lower index across lanes.
+//   - PADDING NEVER HITS : a 5-box set never reports lanes 5..7.
+//   - RANDOM AGREEMENT   : random 2048-box scenes agree with the scalar walk.
+//   - BENCHMARK          : timing printed, not asserted.
+// =============================================================================
+
+#include "overlay_hit_test_soa.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::Aabb;
+    using swfoc_overlay::BuildUnitAabbSoa;
+    using swfoc_overlay::NearestUnitHit;
+    using swfoc_overlay::NearestUnitHitSoa;
+    using swfoc_overlay::NearestUnitHitSoaScalar;
+    using swfoc_overlay::UnitAabb;
+    using swfoc_overlay::UnitAabbSoa;
+    using swfoc_overlay::UnitHit;
+    using swfoc_overlay::Vec3;
+    using swfoc_overlay::WorldRay;
+
+    WorldRay MakeRay(const Vec3& origin, const Vec3& dir)
+    {
+        return WorldRay{ origin, swfoc_overlay::Vec3Normalize(dir), true };
+    }
+
+    bool SameHit(const UnitHit& a, const UnitHit& b)
+    {
+        return a.hit == b.hit && a.index == b.index && a.handle == b.handle
+            && a.t == b.t;
+    }
+
+    // Runs one scene through both kernels; true when they agree and the
+    // scalar kernel reported `wantIndex`.
+    bool Oracle(const WorldRay& ray, const std::vector<UnitAabb>& units, int wantIndex)
+    {
+        UnitAabbSoa soa;
+        BuildUnitAabbSoa(soa, units.data(), static_cast<int>(units.size()));
+        const UnitHit scalar = NearestUnitHit(ray, units.data(), static_cast<int>(units.size()));
+        const UnitHit simd = NearestUnitHitSoa(ray, soa);
+        return scalar.index == wantIndex && SameHit(scalar, simd);
+    }
+
+    struct Rng
+    {
+        uint32_t state = 2718281;
+        float Next(float lo, float hi)
+        {
+            state = state * 1664525u + 1013904223u;
+            return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+        }
+    };
+
+    std::vector<UnitAabb> RandomScene(Rng& rng, int n)
+    {
+        std::vector<UnitAabb> units;
+        for (int i = 0; i < n; ++i)
+        {
+            const Vec3 c{ rng.Next(0.0f, 2000.0f), rng.Next(0.0f, 2000.0f), rng.Next(0.0f, 40.0f) };
+            const float r = rng.Next(2.0f, 30.0f);
+            units.push_back(UnitAabb{ 0x10000u + static_cast<uint64_t>(i),
+                swfoc_overlay::AabbFromCenterExtents(c, r, r, r * 0.5f) });
+        }
+        return units;
+    }
+
+    WorldRay RandomRay(Rng& rng)
+    {
+        const Vec3 from{ rng.Next(0.0f, 2000.0f), rng.Next(-600.0f, 0.0f), 900.0f };
+        const Vec3 to{ rng.Next(0.0f, 2000.0f), rng.Next(0.0f, 2000.0f), 0.0f };
+        return MakeRay(from, Vec3{ to.x - from.x, to.y - from.y, to.z - from.z });
+    }
+}
+
+int main()
+{
+    std::printf("overlay_hit_test_soa_test\n");
+
+    // ---- Oracle: the overlay_hit_test.h pins -------------------------------
+    {
+        Section("oracle");
+        const WorldRay down = MakeRay(Vec3{ 0, 0, 100 }, Vec3{ 0, 0, -1 });
+
+        // PIN (ORACLE) nearest hit wins, far box listed first.
+        const std::vector<UnitAabb> twoBoxes = {
+            UnitAabb{ 0xFAAAull, Aabb{ Vec3{ -2, -2, 8 }, Vec3{ 2, 2, 12 } } },
+            UnitAabb{ 0x4EE7ull, Aabb{ Vec3{ -2, -2, 48 }, Vec3{ 2, 2, 52 } } },
+        };
+        ExpectTrue("PIN ORACLE: the near box wins", Oracle(down, twoBoxes, 1));
+
+        // PIN (ORACLE) miss.
+        ExpectTrue("PIN ORACLE: a ray beside every box misses",
+                   Oracle(MakeRay(Vec3{ 50, 0, 100 }, Vec3{ 0, 0, -1 }), twoBoxes, -1));
+
+        // PIN (ORACLE) box behind origin.
+        const std::vector<UnitAabb> behind = {
+            UnitAabb{ 0xBEEFull, Aabb{ Vec3{ -2, -2, 198 }, Vec3{ 2, 2, 202 } } },
+        };
+        ExpectTrue("PIN ORACLE: a box behind the origin is no hit", Oracle(down, behind, -1));
+
+        // PIN (ORACLE) parallel-axis ray: inside both parallel slabs, then
+        // outside the X slab.
+        const std::vector<UnitAabb> cube = {
+            UnitAabb{ 0xC0BEull, Aabb{ Vec3{ -5, -5, -5 }, Vec3{ 5, 5, 5 } } },
+        };
+        ExpectTrue("PIN ORACLE: parallel ray inside the slabs hits", Oracle(down, cube, 0));
+        ExpectTrue("PIN ORACLE: parallel ray outside the X slab misses",
+                   Oracle(MakeRay(Vec3{ 100, 0, 200 }, Vec3{ 0, 0, -1 }), cube, -1));
+        ExpectTrue("PIN ORACLE: parallel ray outside the Y slab misses",
+                   Oracle(MakeRay(Vec3{ 0, -100, 200 }, Vec3{ 0, 0, -1 }), cube, -1));
+        ExpectTrue("a ray along X, parallel to Y and Z, hits",
+                   Oracle(MakeRay(Vec3{ -50, 0, 0 }, Vec3{ 1, 0, 0 }), cube, 0));
+
+        // PIN (ORACLE) inverted box skipped.
+        const std::vector<UnitAabb> invalid = {
+            UnitAabb{ 0xDEADull, Aabb{ Vec3{ 5, 5, 5 }, Vec3{ -5, -5, -5 } } },
+            UnitAabb{ 0x600Dull, Aabb{ Vec3{ -2, -2, 8 }, Vec3{ 2, 2, 12 } } },
+        };
+        ExpectTrue("PIN ORACLE: the inverted box is skipped", Oracle(down, invalid, 1));
+
+        // PIN (ORACLE) origin inside the box hits at t = 0.
+        const std::vector<UnitAabb> around = {
+            UnitAabb{ 0x1111ull, Aabb{ Vec3{ -200, -200, -200 }, Vec3{ 200, 200, 200 } } },
+        };
+        ExpectTrue("PIN ORACLE: an origin inside the box hits at t = 0",
+                   Oracle(down, around, 0));
+        ExpectTrue("invalid ray misses through both kernels",
+                   Oracle(WorldRay{ Vec3{ 0, 0, 0 }, Vec3{ 0, 0, 0 }, false }, twoBoxes, -1));
+    }
+
+    // ---- Ties and padding --------------------------------------------------
+    {
+        Section("ties and padding");
+        const WorldRay down = MakeRay(Vec3{ 0, 0, 100 }, Vec3{ 0, 0, -1 });
+        const Aabb box{ Vec3{ -2, -2, 48 }, Vec3{ 2, 2, 52 } };
+
+        // PIN (TIE KEEPS ORDER): identical boxes at lanes 3, 5 and 9 (three
+        // iterations, two lanes).
+        std::vector<UnitAabb> units(12, UnitAabb{ 0, Aabb{ Vec3{ 10, 10, 0 }, Vec3{ 11, 11, 1 } } });
+        units[9] = UnitAabb{ 0x9, box };
+        units[5] = UnitAabb{ 0x5, box };
+        units[3] = UnitAabb{ 0x3, box };
+        UnitAabbSoa soa;
+        BuildUnitAabbSoa(soa, units.data(), static_cast<int>(units.size()));
+        const UnitHit tie = NearestUnitHitSoa(down, soa);
+        ExpectEqInt("PIN TIE KEEPS ORDER: the lowest of three tied indices wins", tie.index, 3);
+        units[3].box = Aabb{ Vec3{ 10, 10, 0 }, Vec3{ 11, 11, 1 } };
+        BuildUnitAabbSoa(soa, units.data(), static_cast<int>(units.size()));
+        ExpectEqInt("PIN TIE KEEPS ORDER: then the next one", NearestUnitHitSoa(down, soa).index, 5);
+
+        // PIN (PADDING NEVER HITS): padding boxes are inverted unit cubes at
+        // [1,0]; a ray through that spot must miss a 5-box set.
+        std::vector<UnitAabb> five(5, UnitAabb{ 0x77, Aabb{ Vec3{ 90, 90, 0 }, Vec3{ 91, 91, 1 } } });
+        BuildUnitAabbSoa(soa, five.data(), 5);
+        ExpectEqInt("columns pad to a multiple of four", static_cast<long long>(soa.min_x.size()), 8);
+        const UnitHit pad = NearestUnitHitSoa(MakeRay(Vec3{ 0.5f, 0.5f, 100 }, Vec3{ 0, 0, -1 }), soa);
+        ExpectTrue("PIN PADDING NEVER HITS: the padded spot is a miss", !pad.hit && pad.index == -1);
+        BuildUnitAabbSoa(soa, nullptr, 3);
+        ExpectTrue("a null list builds an empty set", soa.count == 0 && !NearestUnitHitSoa(down, soa).hit);
+
+        swfoc_overlay::UnitAabbSet set;
+        swfoc_overlay::AppendUnitAabb(set, 0x42, box);
+        BuildUnitAabbSoa(soa, set);
+        ExpectTrue("a UnitAabbSet converts", NearestUnitHitSoa(down, soa).handle == 0x42);
+    }
+
+    // ---- Random agreement + benchmark --------------------------------------
+    {
+        Section("random agreement and benchmark");
+
+        Rng rng;
+        const std::vector<UnitAabb> units = RandomScene(rng, 2048);
+        UnitAabbSoa soa;
+        BuildUnitAabbSoa(soa, units.data(), static_cast<int>(units.size()));
+
+        std::vector<WorldRay> rays;
+        for (int i = 0; i < 4000; ++i) rays.push_back(RandomRay(rng));
+
+        // PIN (RANDOM AGREEMENT)
+        int mismatches = 0;
+        int hits = 0;
+        for (const WorldRay& ray : rays)
+        {
+            const UnitHit a = NearestUnitHitSoa(ray, soa);
+            const UnitHit b = NearestUnitHitSoaScalar(ray, soa);
+            if (!SameHit(a, b)) ++mismatches;
+            if (b.hit) ++hits;
+        }
+        ExpectEqInt("PIN RANDOM AGREEMENT: 4000 picks over 2048 boxes agree", mismatches, 0);
+        ExpectTrue("the random rays actually hit boxes", hits > 1000);
+
+        // BENCHMARK: printed for comparison, never asserted (machine noise).
+        using Clock = std::chrono::steady_clock;
+        long long sink = 0;
+        const Clock::time_point s0 = Clock::now();
+        for (const WorldRay& ray : rays) sink += NearestUnitHitSoaScalar(ray, soa).index;
+        const Clock::time_point s1 = Clock::now();
+        for (const WorldRay& ray : rays) sink += NearestUnitHitSoa(ray, soa).index;
+        const Clock::time_point s2 = Clock::now();
+        const double scalarUs = std::chrono::duration<double, std::micro>(s1 - s0).count();
+        const double simdUs = std::chrono::duration<double, std::micro>(s2 - s1).count();
+        std::printf("  bench 4000 picks x 2048 boxes: scalar %.0f us, simd %.0f us (x%.1f) [%lld]\n",
+                    scalarUs, simdUs, simdUs > 0.0 ? scalarUs / simdUs : 0.0, sink);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
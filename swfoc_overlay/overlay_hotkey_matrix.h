@@ -38,8 +38,8 @@
 // carrying the disposition, the operator-trust capability status (guardrail
 // 1007), the game-side conflict note, and the rationale. Two consumers share
 // this single source of truth:
-//   - the deferred overlay.cpp WndProc detour calls OverlayInterceptsKey() to
-//     decide whether to swallow an F-key WM_KEYDOWN;
+//   - overlay.cpp's WndProc detour calls RouteHotkeyMessage() (built on
+//     OverlayInterceptsKey()) to decide whether to swallow an F-key message;
 //   - overlay_hotkey_matrix_test.cpp pins the matrix AND cross-checks the F4 /
 //     F6 / F7 / F8 rows against the Phase 6 kernels (overlay_pause_hotkey.h,
 //     overlay_camera_bookmarks.h) so the matrix can never drift from them.
@@ -71,6 +71,23 @@
 //                                     overlay_camera_bookmarks.h::CameraBook-
 //                                     markHotkey(0/1/2).
 //
+// 2026-10-14 — WNDPROC ROUTING
+// ----------------------------
+// overlay.cpp no longer polls GetAsyncKeyState(VK_F1) every 100 ms on its own
+// thread (up to 100 ms of latency, and a tap shorter than one tick was lost).
+// HookedWndProc hands every key message to RouteHotkeyMessage instead; the
+// row lookup behind it is kHotkeyVkTable, a 256-entry VK -> row index built
+// from kHotkeyMatrix at compile time, so FindHotkeyBinding (and
+// FindHotkeyBindingByFKey through VkForFKey) is one load rather than a scan.
+// A static_assert fails the build on a duplicate VK or F-key row. An intercepted key's WM_KEYUP is swallowed with its KEYDOWN,
+// and auto-repeat KEYDOWNs are swallowed without firing again.
+//
+//   - VK TABLE MIRRORS MATRIX  : every row resolves through the table, every
+//                                other VK 0..255 resolves to nullptr.
+//   - ROUTE FIRES ON THE EDGE  : a first KEYDOWN fires, a repeat does not,
+//                                a KEYUP never does; all three are swallowed
+//                                exactly when the key is intercepted.
+//
 // THREADING: the matrix is immutable constexpr data — every consumer only
 // READS it. OverlayInterceptsKey() is a pure function of its arguments. No
 // state, no mutex; safe to call from the WndProc detour on the host UI thread.
@@ -97,7 +114,7 @@ namespace swfoc_overlay
 
     // The VK code for F-key number `fkey` (1..12). Out of range yields 0 so a
     // caller never builds a garbage key code.
-    inline int VkForFKey(int fkey)
+    inline constexpr int VkForFKey(int fkey)
     {
         if (fkey < 1 || fkey > 12) return 0;
         return kVkF1 + (fkey - 1);
@@ -105,7 +122,7 @@ namespace swfoc_overlay
 
     // The F-key number (1..12) for VK code `vk`. Returns 0 when `vk` is not an
     // F1..F12 key — the caller's "this is not a function key" signal.
-    inline int FKeyForVk(int vk)
+    inline constexpr int FKeyForVk(int vk)
     {
         if (vk < kVkF1 || vk > kVkF12) return 0;
         return (vk - kVkF1) + 1;
@@ -264,15 +281,55 @@ namespace swfoc_overlay
     inline constexpr std::size_t kHotkeyMatrixCount =
         sizeof(kHotkeyMatrix) / sizeof(kHotkeyMatrix[0]);
 
-    // Look up the matrix row for VK code `vk`. Returns nullptr when `vk` is not
-    // an F1..F12 key — the test exercises both the hit and the miss path.
-    inline const HotkeyBinding* FindHotkeyBinding(int vk)
+    // VK code -> kHotkeyMatrix row index, -1 for a VK the matrix has no row
+    // for. Virtual-key codes are 1..254, so 256 entries cover every one.
+    inline constexpr int kHotkeyVkTableSize = 256;
+
+    struct HotkeyVkTable
     {
+        signed char row[kHotkeyVkTableSize];
+    };
+
+    inline constexpr HotkeyVkTable BuildHotkeyVkTable()
+    {
+        HotkeyVkTable t{};
+        for (int vk = 0; vk < kHotkeyVkTableSize; ++vk) t.row[vk] = -1;
         for (std::size_t i = 0; i < kHotkeyMatrixCount; ++i)
         {
-            if (kHotkeyMatrix[i].vk == vk) return &kHotkeyMatrix[i];
+            t.row[kHotkeyMatrix[i].vk] = static_cast<signed char>(i);
         }
-        return nullptr;
+        return t;
+    }
+
+    inline constexpr HotkeyVkTable kHotkeyVkTable = BuildHotkeyVkTable();
+
+    // 2026-10-14: a duplicate VK or F-key row would silently shadow another
+    // in kHotkeyVkTable, so the build refuses it.
+    inline constexpr bool HotkeyMatrixKeysAreUnique()
+    {
+        for (std::size_t i = 0; i < kHotkeyMatrixCount; ++i)
+        {
+            if (kHotkeyMatrix[i].vk < 0 || kHotkeyMatrix[i].vk >= kHotkeyVkTableSize) return false;
+            if (kHotkeyMatrix[i].vk != VkForFKey(kHotkeyMatrix[i].fkey)) return false;
+            for (std::size_t j = i + 1; j < kHotkeyMatrixCount; ++j)
+            {
+                if (kHotkeyMatrix[i].vk == kHotkeyMatrix[j].vk) return false;
+                if (kHotkeyMatrix[i].fkey == kHotkeyMatrix[j].fkey) return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(HotkeyMatrixKeysAreUnique(),
+                  "kHotkeyMatrix: duplicate or mismatched VK / F-key row");
+
+    // Look up the matrix row for VK code `vk`. Returns nullptr when `vk` is not
+    // an F1..F12 key — the test exercises both the hit and the miss path.
+    inline const HotkeyBinding* FindHotkeyBinding(int vk)
+    {
+        if (vk < 0 || vk >= kHotkeyVkTableSize) return nullptr;
+        const int row = kHotkeyVkTable.row[vk];
+        return row < 0 ? nullptr : &kHotkeyMatrix[row];
     }
 
     // Look up the matrix row by F-key number `fkey` (1..12). Returns nullptr
@@ -298,4 +355,25 @@ namespace swfoc_overlay
         if (binding->disposition != HotkeyDisposition::Intercept) return false;
         return overlayVisible || binding->intercept_when_hidden;
     }
+
+    // What HookedWndProc does with one key message (2026-10-14).
+    struct HotkeyRoute
+    {
+        const HotkeyBinding* binding = nullptr;  // the row, or nullptr
+        bool swallow = false;                    // keep the message from the game
+        bool fire = false;                       // run the binding's action now
+    };
+
+    // Routes a WM_KEYDOWN / WM_SYSKEYDOWN (`keyDown`, `repeat` from lParam
+    // bit 30) or WM_KEYUP / WM_SYSKEYUP through the matrix. Only the first
+    // KEYDOWN of a press fires; the repeats and the KEYUP of an intercepted
+    // key are swallowed with it, so the game never sees half a keystroke.
+    inline HotkeyRoute RouteHotkeyMessage(int vk, bool keyDown, bool repeat, bool overlayVisible)
+    {
+        HotkeyRoute route;
+        route.binding = FindHotkeyBinding(vk);
+        route.swallow = OverlayInterceptsKey(vk, overlayVisible);
+        route.fire = route.swallow && keyDown && !repeat;
+        return route;
+    }
 }
@@ -41,6 +41,11 @@
 //   - CAMERA KEYS ARE F6/F7/F8       : the camera rows match
 //                                      overlay_camera_bookmarks.h::CameraBook-
 //                                      markHotkey(0/1/2).
+//   - VK TABLE MIRRORS MATRIX        : (2026-10-14) kHotkeyVkTable resolves
+//                                      every row, by VK and by F-key number,
+//                                      and nothing else.
+//   - ROUTE FIRES ON THE EDGE        : (2026-10-14) RouteHotkeyMessage fires
+//                                      on the first KEYDOWN only.
 // =============================================================================
 
 #include "overlay_hotkey_matrix.h"
@@ -513,6 +518,63 @@ int main()
                     OverlayInterceptsKey(VkForFKey(3), overlayVisible));
     }
 
+    // =========================================================================
+    // [11] PIN: the VK table behind FindHotkeyBinding (2026-10-14).
+    // =========================================================================
+    std::printf("\n[11] Pin: VK table mirrors the matrix\n");
+    {
+        bool rowsResolve = true;
+        for (std::size_t i = 0; i < kHotkeyMatrixCount; ++i)
+        {
+            if (FindHotkeyBinding(kHotkeyMatrix[i].vk) != &kHotkeyMatrix[i]) rowsResolve = false;
+        }
+        ExpectTrue("VK TABLE MIRRORS MATRIX: every row resolves to itself", rowsResolve);
+        int hits = 0;
+        for (int vk = 0; vk < kHotkeyVkTableSize; ++vk)
+        {
+            if (FindHotkeyBinding(vk) != nullptr) ++hits;
+        }
+        ExpectIntEq("VK TABLE MIRRORS MATRIX: no other VK resolves", hits,
+                    static_cast<long long>(kHotkeyMatrixCount));
+        ExpectTrue("VK TABLE MIRRORS MATRIX: out-of-range VKs miss",
+                   FindHotkeyBinding(-1) == nullptr && FindHotkeyBinding(256) == nullptr);
+        ExpectTrue("VK TABLE MIRRORS MATRIX: the build-time uniqueness check holds",
+                   HotkeyMatrixKeysAreUnique());
+        bool byFKey = true;
+        for (int fkey = 1; fkey <= 12; ++fkey)
+        {
+            const HotkeyBinding* b = FindHotkeyBindingByFKey(fkey);
+            if (b == nullptr || b->fkey != fkey) byFKey = false;
+        }
+        ExpectTrue("VK TABLE MIRRORS MATRIX: F1..F12 resolve by F-key number", byFKey);
+    }
+
+    // =========================================================================
+    // [12] PIN: a keystroke through RouteHotkeyMessage (2026-10-14).
+    // =========================================================================
+    std::printf("\n[12] Pin: route fires on the edge\n");
+    {
+        const HotkeyRoute down = RouteHotkeyMessage(kVkF1, true, false, false);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: F1 KEYDOWN fires + swallows",
+                   down.fire && down.swallow && down.binding != nullptr && down.binding->fkey == 1);
+        const HotkeyRoute held = RouteHotkeyMessage(kVkF1, true, true, false);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: F1 auto-repeat swallows, no fire",
+                   held.swallow && !held.fire);
+        const HotkeyRoute up = RouteHotkeyMessage(kVkF1, false, false, true);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: F1 KEYUP swallows, no fire", up.swallow && !up.fire);
+
+        const HotkeyRoute f4Hidden = RouteHotkeyMessage(VkForFKey(4), true, false, false);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: F4 while hidden reaches the game",
+                   !f4Hidden.swallow && !f4Hidden.fire && f4Hidden.binding != nullptr);
+        const HotkeyRoute f4Shown = RouteHotkeyMessage(VkForFKey(4), true, false, true);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: F4 while visible fires", f4Shown.fire && f4Shown.swallow);
+        const HotkeyRoute f10 = RouteHotkeyMessage(VkForFKey(10), true, false, true);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: F10 is never routed", !f10.swallow && !f10.fire);
+        const HotkeyRoute letter = RouteHotkeyMessage(0x41, true, false, true);
+        ExpectTrue("ROUTE FIRES ON THE EDGE: a letter has no row and passes",
+                   letter.binding == nullptr && !letter.swallow && !letter.fire);
+    }
+
     std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
     return g_failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,143 @@
+// =============================================================================
+// swfoc_overlay/overlay_hud_refresh.h — adaptive refresh scheduler for the HUD
+// bridge-poll worker (2026-10-14).
+//
+// WorkerLoop used to rebuild the whole HudSnapshot every 500 ms whether the
+// overlay was shown or not, whether the game was paused, and whether the
+// value could have changed. The probes now sit in two tiers and the worker
+// asks this scheduler which tiers are due:
+//
+//   * FAST  (kHudFastRefreshMs)  credits, unit counts, kills / deaths —
+//           values that move every second of a battle.
+//   * SLOW  (kHudSlowRefreshMs)  scene name and the global multipliers —
+//           values that change on a scene load or an operator command.
+//   * PAUSED: while the bridge's luaD_call tick stops advancing (game paused
+//           or sitting in a menu) the fast tier drops to kHudPausedRefreshMs.
+//   * HIDDEN: no probes at all while the overlay is hidden; the worker only
+//           polls the visibility flag every kHudHiddenPollMs.
+//   * EVENTS: while the bridge event ring feeds the unit counters
+//             (overlay_event_feed.h) the worker wakes every kHudEventPollMs
+//             to drain it; a drop marker forces the next fast pass full.
+//   * OPEN:   the pass after the panel opens refreshes both tiers at once,
+//             as does the next fast pass after the bridge was unreachable,
+//             so the operator never looks at stale carried-forward values.
+//
+// Fields a pass does not refresh are carried forward from the last snapshot
+// (hud_state.cpp); this header only decides timing.
+//
+// RED-GREEN REGRESSION PINS (overlay_hud_refresh_test.cpp)
+// ------------------------------------------------------
+//   - HIDDEN SUSPENDS    : a hidden overlay plans no tier, however stale.
+//   - OPEN IS FULL       : the first visible pass refreshes both tiers.
+//   - TIERS INDEPENDENT  : a due fast tier does not drag the slow tier along.
+//   - PAUSE BACKS OFF    : a stalled tick stretches the fast interval; a
+//                          moving tick restores it.
+//   - UNREACHABLE RESETS : a failed pass makes the next fast pass full, at
+//                          the fast cadence (a dead pipe is not hammered).
+//   - SLEEP TO NEXT DUE  : the planned sleep ends when the next tier is due,
+//                          never longer than kHudHiddenPollMs so shutdown
+//                          and visibility changes stay responsive, and
+//                          never past kHudEventPollMs with a live event feed.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_hud_refresh_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <cstdint>
+
+namespace swfoc_overlay
+{
+    constexpr uint64_t kHudFastRefreshMs = 500;
+    constexpr uint64_t kHudSlowRefreshMs = 5000;
+    constexpr uint64_t kHudPausedRefreshMs = 2000;
+    constexpr uint64_t kHudHiddenPollMs = 100;
+    constexpr uint64_t kHudEventPollMs = 16;   // ~one frame at 60 fps
+
+    // Bit mask of probe tiers.
+    enum HudRefreshTier : uint8_t
+    {
+        kHudTierNone = 0,
+        kHudTierFast = 1,
+        kHudTierSlow = 2,
+        kHudTierAll = kHudTierFast | kHudTierSlow,
+    };
+
+    struct HudRefreshScheduler
+    {
+        bool     was_visible = false;
+        bool     need_full = true;   // next fast pass refreshes the slow tier too
+        bool     paused = false;     // luaD_call tick stalled between passes
+        bool     event_feed = false; // counters fed by the bridge event ring
+        uint64_t last_fast_ms = 0;
+        uint64_t last_slow_ms = 0;
+        int64_t  last_tick = 0;      // bridge luaD_call tick, 0 = unknown
+    };
+
+    struct HudRefreshPlan
+    {
+        uint8_t  tiers = kHudTierNone;
+        uint64_t sleep_ms = kHudHiddenPollMs;  // until the next decision
+    };
+
+    inline uint64_t HudFastIntervalMs(const HudRefreshScheduler& s)
+    {
+        return s.paused ? kHudPausedRefreshMs : kHudFastRefreshMs;
+    }
+
+    // Decides what to probe now. Records the visibility edge and marks the
+    // planned tiers as refreshed at now_ms.
+    inline HudRefreshPlan PlanHudRefresh(HudRefreshScheduler& s, uint64_t now_ms,
+                                         bool visible)
+    {
+        HudRefreshPlan plan;
+        if (!visible)
+        {
+            s.was_visible = false;
+            return plan;
+        }
+        const bool opened = !s.was_visible;
+        const bool fastDue = opened || now_ms - s.last_fast_ms >= HudFastIntervalMs(s);
+        if (fastDue) plan.tiers |= kHudTierFast;
+        if (opened || (fastDue && s.need_full) || now_ms - s.last_slow_ms >= kHudSlowRefreshMs)
+        {
+            plan.tiers |= kHudTierSlow;
+            s.need_full = false;
+        }
+        s.was_visible = true;
+        if (plan.tiers & kHudTierFast) s.last_fast_ms = now_ms;
+        if (plan.tiers & kHudTierSlow) s.last_slow_ms = now_ms;
+
+        const uint64_t fastAt = s.last_fast_ms + HudFastIntervalMs(s);
+        const uint64_t slowAt = s.last_slow_ms + kHudSlowRefreshMs;
+        const uint64_t due = fastAt < slowAt ? fastAt : slowAt;
+        plan.sleep_ms = due > now_ms ? due - now_ms : 0;
+        const uint64_t cap = s.event_feed ? kHudEventPollMs : kHudHiddenPollMs;
+        if (plan.sleep_ms > cap) plan.sleep_ms = cap;
+        return plan;
+    }
+
+    // Folds the outcome of a pass back in. `tick` is the bridge's luaD_call
+    // tick from the telemetry record, 0 when the pass did not read one.
+    inline void NoteHudRefreshResult(HudRefreshScheduler& s, bool reachable,
+                                     int64_t tick)
+    {
+        if (!reachable)
+        {
+            s.need_full = true;
+            s.paused = false;
+            s.last_tick = 0;
+            return;
+        }
+        if (tick == 0) return;
+        s.paused = s.last_tick != 0 && tick == s.last_tick;
+        s.last_tick = tick;
+    }
+
+    // The event feed lost records: reconcile every tier on the next fast pass.
+    inline void NoteHudEventResync(HudRefreshScheduler& s)
+    {
+        s.need_full = true;
+    }
+}
@@ -0,0 +1,176 @@
+// =============================================================================
+// swfoc_overlay/overlay_hud_refresh_test.cpp — unit test for
+// overlay_hud_refresh.h (2026-10-14).
+//
+// overlay_hud_refresh.h decides, each time the HUD worker wakes, which probe
+// tiers to send to the bridge. Getting it wrong either hammers the bridge
+// (a hidden overlay still probing, a dead pipe retried every wake) or shows
+// the operator stale values (a panel opening onto a minutes-old scene name),
+// so the timing rules are pinned here with a synthetic clock.
+//
+// overlay_hud_refresh.h is header-only and std-only. Build + run via
+// build_hud_refresh_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - HIDDEN SUSPENDS    : a hidden overlay plans no tier.
+//   - OPEN IS FULL       : the first visible pass refreshes both tiers.
+//   - TIERS INDEPENDENT  : a due fast tier does not drag the slow tier along.
+//   - PAUSE BACKS OFF    : a stalled tick stretches the fast interval.
+//   - UNREACHABLE RESETS : a failed pass makes the next fast pass full.
+//   - SLEEP TO NEXT DUE  : sleep ends at the next due tier, capped (tighter
+//                          with a live event feed).
+// =============================================================================
+
+#include "overlay_hud_refresh.h"
+
+#include <cstdio>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::HudRefreshPlan;
+    using swfoc_overlay::HudRefreshScheduler;
+    using swfoc_overlay::NoteHudRefreshResult;
+    using swfoc_overlay::PlanHudRefresh;
+    using swfoc_overlay::kHudFastRefreshMs;
+    using swfoc_overlay::kHudHiddenPollMs;
+    using swfoc_overlay::kHudPausedRefreshMs;
+    using swfoc_overlay::kHudSlowRefreshMs;
+    using swfoc_overlay::kHudTierAll;
+    using swfoc_overlay::kHudTierFast;
+    using swfoc_overlay::kHudTierNone;
+    using swfoc_overlay::kHudTierSlow;
+
+    // Runs the worker loop's decisions from `from` to `to` (exclusive),
+    // waking every planned sleep; counts planned tiers.
+    void Drive(HudRefreshScheduler& s, uint64_t from, uint64_t to, bool visible,
+               int& fast, int& slow)
+    {
+        fast = slow = 0;
+        uint64_t now = from;
+        while (now < to)
+        {
+            const HudRefreshPlan p = PlanHudRefresh(s, now, visible);
+            if (p.tiers & kHudTierFast) ++fast;
+            if (p.tiers & kHudTierSlow) ++slow;
+            now += p.sleep_ms ? p.sleep_ms : 1;
+        }
+    }
+}
+
+int main()
+{
+    std::printf("=== overlay_hud_refresh.h unit test ===\n");
+
+    // ---- Visibility --------------------------------------------------------
+    {
+        Section("visibility");
+
+        HudRefreshScheduler s;
+        // PIN (HIDDEN SUSPENDS)
+        int fast = 0, slow = 0;
+        Drive(s, 1000, 61000, false, fast, slow);
+        ExpectTrue("PIN HIDDEN SUSPENDS: a minute hidden plans no probe",
+                   fast == 0 && slow == 0);
+        ExpectTrue("hidden polls visibility at kHudHiddenPollMs",
+                   PlanHudRefresh(s, 61000, false).sleep_ms == kHudHiddenPollMs);
+
+        // PIN (OPEN IS FULL)
+        ExpectTrue("PIN OPEN IS FULL: the opening pass refreshes both tiers",
+                   PlanHudRefresh(s, 61000, true).tiers == kHudTierAll);
+        ExpectTrue("the next wake right after is idle",
+                   PlanHudRefresh(s, 61050, true).tiers == kHudTierNone);
+        PlanHudRefresh(s, 61100, false);
+        ExpectTrue("closing and reopening refreshes both tiers again",
+                   PlanHudRefresh(s, 61200, true).tiers == kHudTierAll);
+    }
+
+    // ---- Tiers -------------------------------------------------------------
+    {
+        Section("tiers");
+
+        HudRefreshScheduler s;
+        PlanHudRefresh(s, 0, true);
+        int fast = 0, slow = 0;
+        Drive(s, 1, 10001, true, fast, slow);
+        // PIN (TIERS INDEPENDENT)
+        ExpectTrue("PIN TIERS INDEPENDENT: 20 fast passes in 10 s",
+                   fast == static_cast<int>(10000 / kHudFastRefreshMs));
+        ExpectTrue("PIN TIERS INDEPENDENT: 2 slow passes in 10 s",
+                   slow == static_cast<int>(10000 / kHudSlowRefreshMs));
+
+        // PIN (SLEEP TO NEXT DUE)
+        HudRefreshScheduler t;
+        PlanHudRefresh(t, 0, true);
+        const HudRefreshPlan p = PlanHudRefresh(t, kHudFastRefreshMs - 30, true);
+        ExpectTrue("PIN SLEEP TO NEXT DUE: wakes when the fast tier is due",
+                   p.tiers == kHudTierNone && p.sleep_ms == 30);
+        ExpectTrue("PIN SLEEP TO NEXT DUE: never sleeps past the poll cap",
+                   PlanHudRefresh(t, kHudFastRefreshMs, true).sleep_ms == kHudHiddenPollMs);
+        t.event_feed = true;
+        ExpectTrue("PIN SLEEP TO NEXT DUE: a live event feed wakes every frame",
+                   PlanHudRefresh(t, kHudFastRefreshMs + 1, true).sleep_ms
+                   == swfoc_overlay::kHudEventPollMs);
+    }
+
+    // ---- Pause and reachability --------------------------------------------
+    {
+        Section("pause and reachability");
+
+        HudRefreshScheduler s;
+        PlanHudRefresh(s, 0, true);
+        NoteHudRefreshResult(s, true, 100);
+        PlanHudRefresh(s, kHudFastRefreshMs, true);
+        NoteHudRefreshResult(s, true, 100);
+        // PIN (PAUSE BACKS OFF)
+        ExpectTrue("PIN PAUSE BACKS OFF: a stalled tick marks paused", s.paused);
+        ExpectTrue("PIN PAUSE BACKS OFF: the fast tier waits the paused interval",
+                   !(PlanHudRefresh(s, 2 * kHudFastRefreshMs, true).tiers & kHudTierFast)
+                   && (PlanHudRefresh(s, kHudFastRefreshMs + kHudPausedRefreshMs, true).tiers
+                       & kHudTierFast));
+        NoteHudRefreshResult(s, true, 180);
+        ExpectTrue("a moving tick restores the fast interval",
+                   !s.paused && swfoc_overlay::HudFastIntervalMs(s) == kHudFastRefreshMs);
+        NoteHudRefreshResult(s, true, 0);
+        ExpectTrue("a pass without telemetry leaves the pause state alone", !s.paused);
+
+        // PIN (UNREACHABLE RESETS)
+        HudRefreshScheduler u;
+        PlanHudRefresh(u, 0, true);
+        NoteHudRefreshResult(u, false, 0);
+        ExpectTrue("PIN UNREACHABLE RESETS: the dead pipe is not retried at once",
+                   PlanHudRefresh(u, kHudHiddenPollMs, true).tiers == kHudTierNone);
+        ExpectTrue("PIN UNREACHABLE RESETS: the next fast pass is full",
+                   PlanHudRefresh(u, kHudFastRefreshMs, true).tiers == kHudTierAll);
+        ExpectTrue("and the one after is fast only",
+                   PlanHudRefresh(u, 2 * kHudFastRefreshMs, true).tiers == kHudTierFast);
+        swfoc_overlay::NoteHudEventResync(u);
+        ExpectTrue("an event-feed resync makes the next fast pass full",
+                   PlanHudRefresh(u, 3 * kHudFastRefreshMs, true).tiers == kHudTierAll);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -32,6 +32,10 @@
 //   7. RefreshInspectorPanel() — re-resolve the open panel against a fresh
 //      snapshot each frame so hull / shield / position stay live, and auto-
 //      close the panel when the inspected unit dies or leaves the field.
+//   8. FollowEngineSelection() — 2026-10-14: when the bridge reports a new
+//      engine selection (EVT_SELECTION -> HudSnapshot::selection_seq), open
+//      the panel on the selected unit, so selecting in-game inspects it
+//      without the overlay asking the pipe what is selected.
 //
 // WHERE THE DATA COMES FROM
 // -------------------------
@@ -59,6 +63,9 @@
 //   - RESOLVE BY HANDLE      : OpenInspectorFor finds the unit by handle, so a
 //                              reordered unit list still inspects the right
 //                              unit — a raw-index old form picks the wrong one.
+//   - SELECTION ON CHANGE    : FollowEngineSelection opens on the selected
+//                              unit only when the selection seq moved, so a
+//                              click-picked unit is not overridden every frame.
 //
 // Pure, header-only, std-only (<cstdint>, <cstdio>; <cmath> via the include
 // chain) — no ImGui, no Windows, no bridge. Unit-tested with a plain g++
@@ -310,4 +317,28 @@ namespace swfoc_overlay
         refreshed.unit = infos[idx];     // pull fresh hull / shield / position
         return refreshed;
     }
+
+    // Follow the engine selection. When `selectionSeq` differs from
+    // `seenSeq` (the seq the caller last acted on) and the newly selected
+    // handle resolves, the panel opens on it — the same as clicking that unit.
+    // An unchanged seq, an empty selection (handle 0) or a handle outside the
+    // visible set returns `current` unchanged. The caller stores
+    // `selectionSeq` as its new `seenSeq` either way.
+    inline InspectorPanel FollowEngineSelection(const InspectorPanel& current,
+                                                std::uint32_t seenSeq,
+                                                std::uint32_t selectionSeq,
+                                                std::uint64_t selectedHandle,
+                                                const UnitInfo* infos,
+                                                int count)
+    {
+        if (selectionSeq == seenSeq || selectedHandle == 0)
+        {
+            return current;
+        }
+        UnitHit pick{};
+        pick.hit    = true;
+        pick.index  = -1;
+        pick.handle = selectedHandle;
+        return UpdateInspectorPanel(current, pick, infos, count);
+    }
 }
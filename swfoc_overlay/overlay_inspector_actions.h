@@ -22,8 +22,8 @@
 // ActionRequest to the iter-513 ActionQueue — the deciding logic is here so a
 // unit test pins it before the render path depends on it.
 //
-// EXACT-UNIT TARGETING — THE HONEST LIMITATION
-// --------------------------------------------
+// EXACT-UNIT TARGETING
+// --------------------
 // The inspector picked ONE specific unit by raycast and knows its exact
 // engine handle (UnitInfo::handle == the GameObject address).
 //
@@ -31,16 +31,17 @@
 //     BuildInspectorKill targets the EXACT picked unit. No ambiguity.
 //
 //   - Heal / Teleport / SwapOwner / MakeInvuln are engine-METHOD wires: they
-//     take a unit Lua *expression*, not an address, and SWFOC exposes no
-//     "object from address" engine-Lua function. So these four fall back to
-//     Find_First_Object("<type>") — the first live instance of the picked
-//     unit's type — exactly as the Phase 3 widgets do (overlay.cpp iter-524).
-//     When several units share a type the method wires may act on a sibling.
+//     take a unit Lua *expression*, not an address. The engine exposes no
+//     "object from address" function, so the bridge provides one:
+//     SWFOC_Unit(<handle>, "<type>") returns the engine wrapper of exactly
+//     that object (resolved once, then an O(1) handle-table hit) or nil when
+//     the unit is gone — a stale handle fails the command instead of acting
+//     on a sibling. Only a unit with no handle (0) still falls back to
+//     Find_First_Object("<type>"), the first live instance of its type, as
+//     the Phase 3 widgets do (overlay.cpp iter-524).
 //
-// This is overlay-interactive.md honest-defer #2 (cursor-hit-unit detection):
-// a documented blocker with a deliberate workaround, not a failure. When a
-// future SWFOC_GetUnitAtScreenCoords or address->handle resolution wire lands,
-// only InspectorUnitLuaExpr() changes — the five builders below stay put.
+// InspectorUnitLuaExpr() is the single seam; the five builders below never
+// name a lookup themselves.
 //
 // RED-GREEN REGRESSION PINS (overlay_inspector_actions_test.cpp)
 // -------------------------------------------------------------
@@ -60,9 +61,12 @@
 //   - INVULN BOOL TOGGLES       : (unit,true) emits "true" + a "Make Invuln"
 //                                 label; (unit,false) emits "false" + a
 //                                 "Clear Invuln" label.
+//   - METHODS TARGET HANDLE     : a unit with a handle resolves through
+//                                 SWFOC_Unit(<handle>, ...) — a first-of-
+//                                 type old form drops the address.
 //   - EXPR ESCAPES TYPE NAME    : a unit type carrying a quote is escaped in
-//                                 the Find_First_Object literal — a raw-
-//                                 concat old form breaks the Lua literal.
+//                                 the type literal — a raw-concat old form
+//                                 breaks the Lua literal.
 //   - LABEL NAMES THE UNIT      : every ActionRequest label embeds the unit
 //                                 type, so the toast / recent-actions slot
 //                                 identifies the unit, not a generic verb.
@@ -119,19 +123,22 @@ namespace swfoc_overlay
 
     // ---- Unit-expression seam ---------------------------------------------
 
-    // The best-available Lua expression that resolves the inspected unit, for
-    // the four engine-METHOD wires (Heal / Teleport / SwapOwner / MakeInvuln)
-    // which take a unit Lua expression rather than a numeric address. Falls
-    // back to Find_First_Object("<type>") — see the EXACT-UNIT TARGETING note
-    // at the top of this header. The type name is run through LuaQuote so a
-    // name carrying a quote or backslash cannot break the Lua string literal.
-    //
-    // This is the single seam: when an address->handle resolution wire lands,
-    // this one function changes and the five builders below are untouched.
+    // The Lua expression that resolves the inspected unit, for the four
+    // engine-METHOD wires (Heal / Teleport / SwapOwner / MakeInvuln) which
+    // take a unit Lua expression rather than a numeric address:
+    // SWFOC_Unit(<handle>, "<type>") for the exact unit, or
+    // Find_First_Object("<type>") when the unit has no handle — see the
+    // EXACT-UNIT TARGETING note at the top of this header. The type name is
+    // run through LuaQuote so a name carrying a quote or backslash cannot
+    // break the Lua string literal.
     inline std::string InspectorUnitLuaExpr(const UnitInfo& unit)
     {
-        return std::string("Find_First_Object(") +
-               LuaQuote(std::string(unit.type)) + ")";
+        const std::string type = LuaQuote(std::string(unit.type));
+        if (unit.handle == 0)
+            return "Find_First_Object(" + type + ")";
+        return "SWFOC_Unit(" +
+               std::to_string(static_cast<unsigned long long>(unit.handle)) +
+               ", " + type + ")";
     }
 
     // ---- Inspector action builders ----------------------------------------
@@ -139,7 +146,9 @@ namespace swfoc_overlay
     // Each returns a dispatch-ready ActionRequest (overlay_action_queue.h):
     // `label` is the human-readable text for the footer toast / recent-actions
     // slot and always names the unit; `lua` is the exact bridge line built by
-    // overlay_actions.h. The render glue only enqueues the result.
+    // overlay_actions.h. The render glue only enqueues the result. Teleport,
+    // Swap Owner and Make Invuln set state, so they carry a per-unit
+    // coalescing key (ActionRequest::key); Kill and Heal never coalesce.
 
     // Kill the inspected unit. SWFOC_KillUnit is address-based, so this
     // targets the EXACT picked unit (UnitInfo::handle) — no first-of-type
@@ -154,7 +163,7 @@ namespace swfoc_overlay
     }
 
     // Heal the inspected unit to full via the engine :Heal() method. Resolves
-    // the unit through InspectorUnitLuaExpr (first-of-type fallback).
+    // the unit through InspectorUnitLuaExpr (exact handle).
     inline ActionRequest BuildInspectorHeal(const UnitInfo& unit)
     {
         ActionRequest req;
@@ -166,7 +175,7 @@ namespace swfoc_overlay
     // Teleport the inspected unit to a world position. The destination is
     // supplied by the caller — the iter-300 click pipeline can feed the
     // iter-298 pick ray's z=0 ground crossing straight in. Resolves the unit
-    // through InspectorUnitLuaExpr (first-of-type fallback).
+    // through InspectorUnitLuaExpr (exact handle).
     inline ActionRequest BuildInspectorTeleport(const UnitInfo& unit,
                                                 float x, float y, float z)
     {
@@ -174,6 +183,7 @@ namespace swfoc_overlay
         req.label = std::string("Teleport ") + unit.type;
         req.lua   = BuildTeleportUnitCommand(InspectorUnitLuaExpr(unit),
                                              x, y, z);
+        req.key   = "teleport " + InspectorUnitLuaExpr(unit);
         return req;
     }
 
@@ -181,7 +191,7 @@ namespace swfoc_overlay
     // full "swap sides" behaviour (iter-108 Change_Owner). The new owner is
     // the REQUESTED slot, never the unit's current owner; pass
     // NextFactionSlot(unit.owner) for a single-click cycle. Resolves the unit
-    // through InspectorUnitLuaExpr (first-of-type fallback).
+    // through InspectorUnitLuaExpr (exact handle).
     inline ActionRequest BuildInspectorSwapOwner(const UnitInfo& unit,
                                                  int newOwnerSlot)
     {
@@ -190,6 +200,7 @@ namespace swfoc_overlay
                     FactionName(newOwnerSlot);
         req.lua   = BuildChangeUnitOwnerCommand(
             InspectorUnitLuaExpr(unit), FactionPlayerName(newOwnerSlot));
+        req.key   = "owner " + InspectorUnitLuaExpr(unit);
         return req;
     }
 
@@ -197,7 +208,7 @@ namespace swfoc_overlay
     // :Make_Invulnerable() method (the real hardpoint-propagating invuln, not
     // a byte-flip). `invulnerable` true sets it, false clears it; the label
     // reads "Make Invuln" / "Clear Invuln" accordingly. Resolves the unit
-    // through InspectorUnitLuaExpr (first-of-type fallback).
+    // through InspectorUnitLuaExpr (exact handle).
     inline ActionRequest BuildInspectorMakeInvuln(const UnitInfo& unit,
                                                   bool invulnerable)
     {
@@ -206,6 +217,7 @@ namespace swfoc_overlay
                                               : "Clear Invuln ") + unit.type;
         req.lua   = BuildMakeUnitInvulnCommand(InspectorUnitLuaExpr(unit),
                                                invulnerable);
+        req.key   = "invuln " + InspectorUnitLuaExpr(unit);
         return req;
     }
 }
@@ -29,8 +29,10 @@
 //                                 not the unit's current owner.
 //   - INVULN BOOL TOGGLES       : true -> "true" + "Make Invuln"; false ->
 //                                 "false" + "Clear Invuln".
+//   - METHODS TARGET HANDLE     : a unit with a handle resolves through
+//                                 SWFOC_Unit(<handle>, ...), not first-of-type.
 //   - EXPR ESCAPES TYPE NAME    : a quote in the unit type is escaped in the
-//                                 Find_First_Object literal.
+//                                 type literal.
 //   - LABEL NAMES THE UNIT      : every ActionRequest label embeds the type.
 // =============================================================================
 
@@ -204,26 +206,36 @@ int main()
     }
 
     // -----------------------------------------------------------------------
-    // 4. InspectorUnitLuaExpr — the first-of-type fallback seam.
+    // 4. InspectorUnitLuaExpr — the exact-unit seam.
     // -----------------------------------------------------------------------
     std::printf("\n[InspectorUnitLuaExpr]\n");
     {
+        // METHODS TARGET HANDLE pin — the expression carries the unit's
+        // handle (0x1000 = 4096); a first-of-type old form drops it.
         const UnitInfo atat = MakeUnit(0x1000ull, 1, "Empire_AT_AT");
-        ExpectStr("type -> Find_First_Object(\"<type>\")",
+        ExpectStr("METHODS TARGET HANDLE: handle -> SWFOC_Unit(<handle>, \"<type>\")",
                   InspectorUnitLuaExpr(atat),
-                  "Find_First_Object(\"Empire_AT_AT\")");
+                  "SWFOC_Unit(4096, \"Empire_AT_AT\")");
+        ExpectAbsent("METHODS TARGET HANDLE: no first-of-type lookup",
+                     InspectorUnitLuaExpr(atat), "Find_First_Object");
 
         // EXPR ESCAPES TYPE NAME pin — a quote in the type is escaped so the
         // Lua string literal stays valid; a raw-concat old form breaks it.
         const UnitInfo weird = MakeUnit(0x2000ull, 0, "Bad\"Type");
         ExpectStr("EXPR ESCAPES TYPE NAME: embedded quote is escaped",
                   InspectorUnitLuaExpr(weird),
-                  "Find_First_Object(\"Bad\\\"Type\")");
+                  "SWFOC_Unit(8192, \"Bad\\\"Type\")");
 
         const UnitInfo empty = MakeUnit(0x3000ull, 2, "");
-        ExpectStr("empty type -> Find_First_Object(\"\")",
+        ExpectStr("empty type -> SWFOC_Unit(<handle>, \"\")",
                   InspectorUnitLuaExpr(empty),
-                  "Find_First_Object(\"\")");
+                  "SWFOC_Unit(12288, \"\")");
+
+        // No handle (0) -> the first-of-type fallback, still escaped.
+        const UnitInfo unbound = MakeUnit(0ull, 1, "Bad\"Type");
+        ExpectStr("handle 0 -> Find_First_Object(\"<type>\") fallback",
+                  InspectorUnitLuaExpr(unbound),
+                  "Find_First_Object(\"Bad\\\"Type\")");
     }
 
     // -----------------------------------------------------------------------
@@ -251,7 +263,7 @@ int main()
     }
 
     // -----------------------------------------------------------------------
-    // 6. BuildInspectorHeal — engine :Heal() via the first-of-type expr.
+    // 6. BuildInspectorHeal — engine :Heal() via the exact-unit expr.
     // -----------------------------------------------------------------------
     std::printf("\n[BuildInspectorHeal]\n");
     {
@@ -261,7 +273,7 @@ int main()
         ExpectStr("Lua resolves the unit then calls :Heal()",
                   req.lua,
                   "return SWFOC_HealUnitLua("
-                  "\"Find_First_Object(\\\"Empire_AT_AT\\\")\")");
+                  "\"SWFOC_Unit(16962, \\\"Empire_AT_AT\\\")\")");
         ExpectContains("HEAL WIRE NAME CORRECT", req.lua, "SWFOC_HealUnitLua(");
     }
 
@@ -277,8 +289,8 @@ int main()
                   "Teleport Rebel_Trooper_Squad");
         ExpectContains("Lua names the teleport wire", req.lua,
                        "SWFOC_TeleportUnitLua(");
-        ExpectContains("Lua resolves the unit by type", req.lua,
-                       "Find_First_Object(\\\"Rebel_Trooper_Squad\\\")");
+        ExpectContains("Lua resolves the exact unit", req.lua,
+                       "SWFOC_Unit(21845, \\\"Rebel_Trooper_Squad\\\")");
         ExpectContains("Lua carries the destination position", req.lua,
                        "Create_Position(100, 200, 0)");
     }
@@ -427,6 +439,15 @@ int main()
         ExpectAbsent("integration: the kill never targets the sibling",
                      acts[0].lua, "39321");
 
+        // So do the four method actions, through SWFOC_Unit.
+        for (int i = 1; i < 5; ++i)
+        {
+            ExpectContains("integration: the method action targets the picked handle",
+                           acts[i].lua, "SWFOC_Unit(16962, ");
+            ExpectAbsent("integration: the method action never targets the sibling",
+                         acts[i].lua, "39321");
+        }
+
         // A miss-pick yields no panel — and so the inspector simply has no
         // unit to build actions from (the glue gates the buttons on
         // panel.visible).
@@ -33,6 +33,8 @@
 //   - FACTION NAME CORRECT  : FactionName(0) is "Rebel", not "Unknown".
 //   - RESOLVE BY HANDLE     : OpenInspectorFor finds the unit by handle, so a
 //                             reordered list still inspects the right unit.
+//   - SELECTION ON CHANGE   : FollowEngineSelection opens on the selected
+//                             unit only when the selection seq moved.
 // =============================================================================
 
 #include "overlay_inspector.h"
@@ -183,6 +185,7 @@ int main()
 {
     using swfoc_overlay::FactionName;
     using swfoc_overlay::FindUnitByHandle;
+    using swfoc_overlay::FollowEngineSelection;
     using swfoc_overlay::FormatHealthLabel;
     using swfoc_overlay::FormatPositionLabel;
     using swfoc_overlay::HealthFraction;
@@ -601,6 +604,45 @@ int main()
                    !gone.visible);
     }
 
+    std::printf("\n");
+
+    // ---- 11. FollowEngineSelection (EVT_SELECTION) -------------------------
+    std::printf("[follow engine selection]\n");
+    {
+        const UnitInfo units[2] = {
+            MakeUnit(0xD1ull, 900, 1000, 0, 0, 0, Vec3{}, "Rebel_X-Wing"),
+            MakeUnit(0xD2ull, 300, 1000, 0, 0, 1, Vec3{}, "TIE_Fighter"),
+        };
+        const InspectorPanel closed{};
+
+        // RED-GREEN: SELECTION ON CHANGE — a new seq opens on the selection.
+        const InspectorPanel followed =
+            FollowEngineSelection(closed, 3, 4, 0xD2ull, units, 2);
+        ExpectTrue("FollowEngineSelection opens when the seq moves",
+                   followed.visible);
+        ExpectU64("FollowEngineSelection inspects the selected unit",
+                  followed.unit.handle, 0xD2ull);
+
+        // A click-picked unit survives frames where the seq did not move.
+        const InspectorPanel picked =
+            UpdateInspectorPanel(followed, MakeHit(true, 0, 0xD1ull, 1.0f),
+                                 units, 2);
+        const InspectorPanel same =
+            FollowEngineSelection(picked, 4, 4, 0xD2ull, units, 2);
+        ExpectU64("FollowEngineSelection keeps a pick while the seq is unchanged",
+                  same.unit.handle, 0xD1ull);
+
+        // Clearing the selection, or selecting an unlisted unit, changes nothing.
+        const InspectorPanel cleared =
+            FollowEngineSelection(picked, 4, 5, 0, units, 2);
+        ExpectTrue("FollowEngineSelection ignores an empty selection",
+                   cleared.visible && cleared.unit.handle == 0xD1ull);
+        const InspectorPanel unlisted =
+            FollowEngineSelection(picked, 5, 6, 0xEEull, units, 2);
+        ExpectU64("FollowEngineSelection ignores an unlisted handle",
+                  unlisted.unit.handle, 0xD1ull);
+    }
+
     std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
     return g_failures == 0 ? 0 : 1;
 }
@@ -0,0 +1,122 @@
+// =============================================================================
+// swfoc_overlay/overlay_minimap_density.h — live unit-density raster for the
+// tactical minimap (2026-10-14).
+//
+// The minimap plots the operator's spawn drops one ImGui circle each
+// (overlay_minimap.h); doing that for every live engine unit would cost
+// hundreds of draw-list circles per frame. Instead the HUD worker rasterizes
+// the bridge unit table's positions into a small per-side density image once
+// per unit-table generation, and the render thread uploads it to a single
+// D3D9 texture only when that generation changes — the minimap then costs one
+// textured quad per frame whatever the unit count.
+//
+//   - Grid: kMinimapDensitySize x kMinimapDensitySize cells over the same
+//     [-kMinimapHalfExtent, +kMinimapHalfExtent] square as the minimap,
+//     projected through WorldToMinimap so a density cell and a spawn dot for
+//     the same world point line up. Units outside the extent are counted in
+//     `off_map` and left out (the dots clamp to the edge; a density smear
+//     along the border would read as a real cluster).
+//   - Sides: each unit is FRIENDLY (local owner) or ENEMY; the two counts
+//     land in separate channels (green / red), so a contested cell shows
+//     both.
+//   - Pixels: A8R8G8B8 words (0xAARRGGBB, D3DFMT_A8R8G8B8's memory order),
+//     row 0 at the top. A cell with no units is fully transparent, so the
+//     minimap background shows through. Intensity grows with the count and
+//     saturates at kMinimapDensitySaturate units per cell.
+//
+// RED-GREEN REGRESSION PINS (overlay_minimap_density_test.cpp)
+// -----------------------------------------------------------
+//   - SAME PROJECTION    : a unit lands in the cell WorldToMinimap puts it in
+//                          — north at the top, not mirrored.
+//   - SIDES SEPARATE     : friendly units light green only, enemy red only.
+//   - EMPTY TRANSPARENT  : cells with no units have alpha 0.
+//   - DENSITY SATURATES  : more units -> brighter, capped, never wrapped.
+//   - OFF-MAP SKIPPED    : units outside the extent are counted, not drawn.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no D3D. Unit-tested with
+// a plain g++ (build_minimap_density_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include "overlay_minimap.h"  // WorldToMinimap, kMinimapHalfExtent
+
+#include <cstdint>
+#include <vector>
+
+namespace swfoc_overlay
+{
+    // Side length, in cells (= texels), of the density raster.
+    inline constexpr int kMinimapDensitySize = 128;
+
+    // Units per cell at which a side's channel reaches full intensity.
+    inline constexpr int kMinimapDensitySaturate = 8;
+
+    // One live unit for the raster: ground position and side.
+    struct MinimapUnitDot
+    {
+        float x;
+        float y;
+        bool  friendly;  // owned by the local player
+    };
+
+    struct MinimapDensityRaster
+    {
+        // Source generation (the bridge unit table's seq) the pixels were
+        // built from. The render thread re-uploads when it changes.
+        uint32_t generation = 0;
+        uint32_t friendly = 0;  // units drawn, per side
+        uint32_t enemy = 0;
+        uint32_t off_map = 0;   // units outside the extent, not drawn
+        // kMinimapDensitySize^2 A8R8G8B8 words, row-major, row 0 at the top.
+        std::vector<uint32_t> pixels;
+    };
+
+    // Channel intensity for `count` units in one cell: 0 for none, then a
+    // visible floor rising linearly to 255 at kMinimapDensitySaturate.
+    inline uint32_t MinimapDensityLevel(int count)
+    {
+        if (count <= 0) return 0;
+        if (count >= kMinimapDensitySaturate) return 255;
+        return 96u + static_cast<uint32_t>(count) * (255u - 96u)
+                         / static_cast<uint32_t>(kMinimapDensitySaturate);
+    }
+
+    // Rebuilds `out` from `dots` (positions in world units, the minimap's
+    // extent is +-halfExtent). Worker thread; `out` is not shared yet.
+    inline void RasterizeMinimapDensity(const std::vector<MinimapUnitDot>& dots,
+                                        float halfExtent, uint32_t generation,
+                                        MinimapDensityRaster& out)
+    {
+        constexpr int kCells = kMinimapDensitySize * kMinimapDensitySize;
+        std::vector<uint16_t> counts(2 * kCells, 0);  // [friendly | enemy]
+        out.generation = generation;
+        out.friendly = out.enemy = out.off_map = 0;
+        for (const MinimapUnitDot& d : dots)
+        {
+            const MinimapPoint p = WorldToMinimap(
+                d.x, d.y, static_cast<float>(kMinimapDensitySize), halfExtent);
+            if (!p.onMap)
+            {
+                ++out.off_map;
+                continue;
+            }
+            int cx = static_cast<int>(p.px);
+            int cy = static_cast<int>(p.py);
+            if (cx >= kMinimapDensitySize) cx = kMinimapDensitySize - 1;  // far edge
+            if (cy >= kMinimapDensitySize) cy = kMinimapDensitySize - 1;
+            uint16_t& c = counts[(d.friendly ? 0 : kCells) + cy * kMinimapDensitySize + cx];
+            if (c < 0xFFFF) ++c;
+            ++(d.friendly ? out.friendly : out.enemy);
+        }
+        out.pixels.assign(kCells, 0u);
+        for (int i = 0; i < kCells; ++i)
+        {
+            const uint32_t g = MinimapDensityLevel(counts[i]);
+            const uint32_t r = MinimapDensityLevel(counts[kCells + i]);
+            if (g == 0 && r == 0) continue;
+            const uint32_t a = g > r ? g : r;
+            out.pixels[i] = (a << 24) | (r << 16) | (g << 8);
+        }
+    }
+}
@@ -0,0 +1,167 @@
+// =============================================================================
+// swfoc_overlay/overlay_minimap_density_test.cpp — unit test for
+// overlay_minimap_density.h (2026-10-14).
+//
+// The HUD worker rasterizes live unit positions into a 128x128 per-side
+// density image that the minimap draws as one texture. This test pins the
+// raster: the projection it shares with WorldToMinimap, the channel split
+// between sides, transparency of empty cells, the saturating intensity ramp
+// and the off-map skip. Build + run via build_minimap_density_test.bat — no
+// game, no D3D.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - SAME PROJECTION    : world (0,0) is cell (64,64); a northern unit lands
+//                          near row 0, not mirrored to the bottom.
+//   - SIDES SEPARATE     : friendly -> green channel only, enemy -> red only.
+//   - EMPTY TRANSPARENT  : every cell without units is 0x00000000.
+//   - DENSITY SATURATES  : 2 units brighter than 1; 50 units == 255, no wrap.
+//   - OFF-MAP SKIPPED    : units beyond the extent count in off_map only.
+// =============================================================================
+
+#include "overlay_minimap_density.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqU32(const char* name, uint32_t got, uint32_t want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got : 0x%08x\n    want: 0x%08x\n",
+                        name, static_cast<unsigned>(got),
+                        static_cast<unsigned>(want));
+        }
+    }
+
+    uint32_t Pixel(const swfoc_overlay::MinimapDensityRaster& r, int cx, int cy)
+    {
+        return r.pixels[static_cast<size_t>(cy) * swfoc_overlay::kMinimapDensitySize
+                        + static_cast<size_t>(cx)];
+    }
+
+    uint32_t Green(uint32_t p) { return (p >> 8) & 0xFF; }
+    uint32_t Red(uint32_t p) { return (p >> 16) & 0xFF; }
+    uint32_t Alpha(uint32_t p) { return p >> 24; }
+}
+
+int main()
+{
+    using swfoc_overlay::MinimapDensityRaster;
+    using swfoc_overlay::MinimapUnitDot;
+    using swfoc_overlay::RasterizeMinimapDensity;
+    using swfoc_overlay::MinimapDensityLevel;
+    using swfoc_overlay::kMinimapDensitySize;
+    using swfoc_overlay::kMinimapHalfExtent;
+
+    std::printf("=== overlay_minimap_density.h unit test ===\n");
+
+    // -----------------------------------------------------------------------
+    // 1. Projection + sides.
+    // -----------------------------------------------------------------------
+    std::printf("\n[RasterizeMinimapDensity: projection + sides]\n");
+    {
+        std::vector<MinimapUnitDot> dots;
+        dots.push_back(MinimapUnitDot{ 0.0f, 0.0f, true });        // cell (64,64)
+        dots.push_back(MinimapUnitDot{ 0.0f, 1900.0f, false });    // row 3, north
+        dots.push_back(MinimapUnitDot{ -1990.0f, -1990.0f, true }); // bottom-left
+        MinimapDensityRaster r;
+        RasterizeMinimapDensity(dots, kMinimapHalfExtent, 7, r);
+
+        ExpectTrue("one word per cell",
+                   r.pixels.size() == static_cast<size_t>(kMinimapDensitySize) * kMinimapDensitySize);
+        ExpectEqU32("generation recorded", r.generation, 7);
+        ExpectEqU32("two friendly drawn", r.friendly, 2);
+        ExpectEqU32("one enemy drawn", r.enemy, 1);
+
+        const uint32_t origin = Pixel(r, 64, 64);
+        ExpectTrue("PIN SAME PROJECTION: world origin lights cell (64,64)", Alpha(origin) != 0);
+        ExpectTrue("PIN SIDES SEPARATE: a friendly cell is green only",
+                   Green(origin) != 0 && Red(origin) == 0);
+
+        const uint32_t north = Pixel(r, 64, 3);
+        ExpectTrue("PIN SAME PROJECTION: a northern unit lands near the top row",
+                   Alpha(north) != 0 && Alpha(Pixel(r, 64, kMinimapDensitySize - 4)) == 0);
+        ExpectTrue("PIN SIDES SEPARATE: an enemy cell is red only",
+                   Red(north) != 0 && Green(north) == 0);
+        ExpectTrue("bottom-left unit lands in the bottom-left cell",
+                   Alpha(Pixel(r, 0, kMinimapDensitySize - 1)) != 0);
+
+        int lit = 0;
+        for (uint32_t p : r.pixels) lit += p != 0 ? 1 : 0;
+        ExpectTrue("PIN EMPTY TRANSPARENT: only the three occupied cells are non-zero", lit == 3);
+    }
+
+    // -----------------------------------------------------------------------
+    // 2. Density ramp.
+    // -----------------------------------------------------------------------
+    std::printf("\n[MinimapDensityLevel]\n");
+    {
+        ExpectEqU32("no units -> 0", MinimapDensityLevel(0), 0);
+        ExpectTrue("PIN DENSITY SATURATES: 2 units brighter than 1",
+                   MinimapDensityLevel(2) > MinimapDensityLevel(1) && MinimapDensityLevel(1) > 0);
+        ExpectEqU32("PIN DENSITY SATURATES: the saturation count is full intensity",
+                    MinimapDensityLevel(swfoc_overlay::kMinimapDensitySaturate), 255);
+        ExpectEqU32("PIN DENSITY SATURATES: far past saturation stays 255",
+                    MinimapDensityLevel(100000), 255);
+
+        std::vector<MinimapUnitDot> crowd(50, MinimapUnitDot{ 10.0f, 10.0f, false });
+        crowd.push_back(MinimapUnitDot{ 10.0f, 10.0f, true });
+        MinimapDensityRaster r;
+        RasterizeMinimapDensity(crowd, kMinimapHalfExtent, 1, r);
+        const uint32_t p = Pixel(r, 64, 63);
+        ExpectEqU32("a contested cell: red saturated", Red(p), 255);
+        ExpectEqU32("a contested cell: green at one unit", Green(p), MinimapDensityLevel(1));
+        ExpectEqU32("a contested cell: alpha follows the stronger side", Alpha(p), 255);
+    }
+
+    // -----------------------------------------------------------------------
+    // 3. Off-map units + rebuild.
+    // -----------------------------------------------------------------------
+    std::printf("\n[RasterizeMinimapDensity: off-map + rebuild]\n");
+    {
+        std::vector<MinimapUnitDot> dots;
+        dots.push_back(MinimapUnitDot{ 5000.0f, 0.0f, true });
+        dots.push_back(MinimapUnitDot{ 0.0f, -2500.0f, false });
+        MinimapDensityRaster r;
+        RasterizeMinimapDensity(dots, kMinimapHalfExtent, 2, r);
+        ExpectEqU32("PIN OFF-MAP SKIPPED: both counted off-map", r.off_map, 2);
+        int lit = 0;
+        for (uint32_t px : r.pixels) lit += px != 0 ? 1 : 0;
+        ExpectTrue("PIN OFF-MAP SKIPPED: nothing drawn, no border smear", lit == 0);
+
+        dots.clear();
+        RasterizeMinimapDensity(dots, kMinimapHalfExtent, 3, r);
+        ExpectTrue("a rebuild resets every count",
+                   r.off_map == 0 && r.friendly == 0 && r.enemy == 0 && r.generation == 3);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
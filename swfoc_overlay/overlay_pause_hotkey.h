@@ -193,6 +193,7 @@ namespace swfoc_overlay
             ActionRequest req;
             req.lua   = BuildSetGameSpeedCommand(CurrentSpeed());
             req.label = paused_ ? PauseLabel() : ResumeLabel(resumeSpeed_);
+            req.key   = "game_speed";  // a mashed F4 sends only the final state
             return req;
         }
 
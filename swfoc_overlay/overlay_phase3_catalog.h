@@ -29,6 +29,16 @@
 // SWFOC_KillUnit, SWFOC_TeleportUnitLua, SWFOC_ChangeUnitOwner. If a future
 // iter demotes one (e.g. to PHASE 2 PENDING), flip its WidgetStatus here and
 // the test's all-LIVE pin documents the change.
+//
+// 2026-10-14: FindPhase3Widget no longer strcmp's its way down the catalog.
+// kPhase3WidgetIndex is a perfect-hash table over the labels (FNV-1a, folded
+// to kPhase3WidgetIndexSize slots), built at compile time; a lookup is one
+// hash of the label, one indexed load and one strcmp to confirm. The
+// static_asserts below fail the build on a duplicate label or on a label
+// that collides with another's slot (grow kPhase3WidgetIndexSize then).
+// Code that knows which widget it wants uses Phase3WidgetId and
+// Phase3WidgetFor(), a plain indexed load; the ids are asserted to match the
+// catalog order.
 // =============================================================================
 
 #pragma once
@@ -85,19 +95,102 @@ namespace swfoc_overlay
     inline constexpr std::size_t kPhase3WidgetCount =
         sizeof(kPhase3Widgets) / sizeof(kPhase3Widgets[0]);
 
+    // Compile-time catalog keys (2026-10-14) -------------------------------
+
+    // Catalog positions, in kPhase3Widgets order.
+    enum class Phase3WidgetId : std::size_t
+    {
+        Spawn,
+        MakeInvuln,
+        Kill,
+        Teleport,
+        FactionSwitch,
+        Count,
+    };
+
+    inline constexpr const Phase3Widget& Phase3WidgetFor(Phase3WidgetId id)
+    {
+        return kPhase3Widgets[static_cast<std::size_t>(id)];
+    }
+
+    namespace phase3_catalog_detail
+    {
+        constexpr bool StrEq(const char* a, const char* b)
+        {
+            while (*a && *a == *b) { ++a; ++b; }
+            return *a == *b;
+        }
+
+        constexpr unsigned int LabelHash(const char* s)
+        {
+            unsigned int h = 2166136261u;
+            while (*s) { h = (h ^ static_cast<unsigned char>(*s++)) * 16777619u; }
+            return h;
+        }
+    }
+
+    // Slot count of the label table — a power of two above the catalog size.
+    inline constexpr std::size_t kPhase3WidgetIndexSize = 16;
+
+    struct Phase3WidgetIndex
+    {
+        signed char slot[kPhase3WidgetIndexSize];  // catalog position, or -1
+        bool        perfect;                       // no two labels share a slot
+    };
+
+    inline constexpr std::size_t Phase3LabelSlot(const char* label)
+    {
+        return phase3_catalog_detail::LabelHash(label) & (kPhase3WidgetIndexSize - 1);
+    }
+
+    inline constexpr Phase3WidgetIndex BuildPhase3WidgetIndex()
+    {
+        Phase3WidgetIndex t{};
+        t.perfect = true;
+        for (std::size_t s = 0; s < kPhase3WidgetIndexSize; ++s) t.slot[s] = -1;
+        for (std::size_t i = 0; i < kPhase3WidgetCount; ++i)
+        {
+            const std::size_t s = Phase3LabelSlot(kPhase3Widgets[i].label);
+            if (t.slot[s] >= 0) t.perfect = false;
+            t.slot[s] = static_cast<signed char>(i);
+        }
+        return t;
+    }
+
+    inline constexpr Phase3WidgetIndex kPhase3WidgetIndex = BuildPhase3WidgetIndex();
+
+    inline constexpr bool Phase3LabelsAreUnique()
+    {
+        for (std::size_t i = 0; i < kPhase3WidgetCount; ++i)
+            for (std::size_t j = i + 1; j < kPhase3WidgetCount; ++j)
+                if (phase3_catalog_detail::StrEq(kPhase3Widgets[i].label, kPhase3Widgets[j].label)) return false;
+        return true;
+    }
+
+    static_assert(Phase3LabelsAreUnique(), "kPhase3Widgets: duplicate button label");
+    static_assert(kPhase3WidgetIndex.perfect,
+                  "kPhase3Widgets: two labels share a slot; grow kPhase3WidgetIndexSize");
+    static_assert(kPhase3WidgetCount < kPhase3WidgetIndexSize
+                      && (kPhase3WidgetIndexSize & (kPhase3WidgetIndexSize - 1)) == 0,
+                  "kPhase3WidgetIndexSize must be a power of two above the catalog size");
+    static_assert(static_cast<std::size_t>(Phase3WidgetId::Count) == kPhase3WidgetCount,
+                  "Phase3WidgetId must name every catalog entry");
+    static_assert(phase3_catalog_detail::StrEq(Phase3WidgetFor(Phase3WidgetId::Spawn).label, "Spawn")
+                      && phase3_catalog_detail::StrEq(Phase3WidgetFor(Phase3WidgetId::MakeInvuln).label, "Make Invuln")
+                      && phase3_catalog_detail::StrEq(Phase3WidgetFor(Phase3WidgetId::Kill).label, "Kill")
+                      && phase3_catalog_detail::StrEq(Phase3WidgetFor(Phase3WidgetId::Teleport).label, "Teleport")
+                      && phase3_catalog_detail::StrEq(Phase3WidgetFor(Phase3WidgetId::FactionSwitch).label,
+                                                      "Faction Switch"),
+                  "Phase3WidgetId order must match kPhase3Widgets");
+
     // Look up a Phase 3 widget by its exact button label. Returns nullptr when
     // `label` is null or not catalogued — the test exercises both the hit and
     // the miss path, and the wire-matches-builder pins resolve wires through it.
     inline const Phase3Widget* FindPhase3Widget(const char* label)
     {
         if (label == nullptr) return nullptr;
-        for (std::size_t i = 0; i < kPhase3WidgetCount; ++i)
-        {
-            if (std::strcmp(kPhase3Widgets[i].label, label) == 0)
-            {
-                return &kPhase3Widgets[i];
-            }
-        }
-        return nullptr;
+        const int i = kPhase3WidgetIndex.slot[Phase3LabelSlot(label)];
+        if (i < 0 || std::strcmp(kPhase3Widgets[i].label, label) != 0) return nullptr;
+        return &kPhase3Widgets[i];
     }
 }
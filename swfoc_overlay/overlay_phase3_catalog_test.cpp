@@ -34,6 +34,11 @@
 //                            (Spawn, Make Invuln, Kill, Teleport, Faction
 //                            Switch) — a reorder or an un-catalogued button
 //                            fires the test.
+//   - INDEXED LOOKUP       : (2026-10-14) every label resolves through the
+//                            kPhase3WidgetIndex slot table to its own entry,
+//                            a label landing in an occupied slot but spelled
+//                            differently misses, and Phase3WidgetFor(id) is
+//                            the catalog entry at that position.
 // =============================================================================
 
 #include "overlay_phase3_catalog.h"
@@ -208,6 +213,31 @@ int main()
                    FindPhase3Widget("Spaw") == nullptr);
     }
 
+    // ---- PIN indexed lookup (2026-10-14) ----------------------------------
+    {
+        int resolved = 0;
+        int occupied = 0;
+        for (std::size_t i = 0; i < kPhase3WidgetCount; ++i)
+        {
+            if (FindPhase3Widget(kPhase3Widgets[i].label) == &kPhase3Widgets[i]) ++resolved;
+        }
+        for (std::size_t s = 0; s < kPhase3WidgetIndexSize; ++s)
+        {
+            if (kPhase3WidgetIndex.slot[s] >= 0) ++occupied;
+        }
+        ExpectTrue("index: every label resolves to its own entry",
+                   resolved == static_cast<int>(kPhase3WidgetCount));
+        ExpectTrue("index: one slot per widget", occupied == static_cast<int>(kPhase3WidgetCount));
+        ExpectTrue("index: the table is a perfect hash", kPhase3WidgetIndex.perfect);
+        ExpectTrue("index: case differs -> miss", FindPhase3Widget("spawn") == nullptr);
+        ExpectTrue("index: trailing space -> miss", FindPhase3Widget("Kill ") == nullptr);
+        ExpectTrue("index: empty label -> miss", FindPhase3Widget("") == nullptr);
+        ExpectTrue("index: Phase3WidgetFor(Kill) is the Kill entry",
+                   &Phase3WidgetFor(Phase3WidgetId::Kill) == FindPhase3Widget("Kill"));
+        ExpectTrue("index: Phase3WidgetFor(FactionSwitch) is the last entry",
+                   &Phase3WidgetFor(Phase3WidgetId::FactionSwitch) == &kPhase3Widgets[kPhase3WidgetCount - 1]);
+    }
+
     // ---- PIN wire-matches-builder: the catalogued wire is the wire the ----
     //      overlay_actions.h builder actually sends. A badge cannot lie.
     ExpectWireInBuilder("Spawn",
@@ -0,0 +1,80 @@
+// =============================================================================
+// swfoc_overlay/overlay_snapshot_buffer.h — lock-free triple buffer for the
+// HUD snapshot (2026-10-14).
+//
+// GetHudSnapshot used to copy the whole HudSnapshot out from under
+// g_snap_mutex several times per frame — scene_name, last_error and the unit
+// AABB set included — inside the D3D9 Present detour. The render thread now
+// pins one immutable snapshot per frame by reference instead:
+//
+//   * Three slots. The writer (HUD worker) owns `back`, the reader (render
+//     thread) owns `front`, and `middle` is the hand-off slot, held in one
+//     atomic word together with a "fresh" bit.
+//   * Publish():  assign into back, then exchange back <-> middle and set
+//                 fresh. The writer never touches the slot the reader holds.
+//   * Acquire():  when fresh is set, exchange front <-> middle. The returned
+//                 reference stays valid and unchanged until the reader's
+//                 next Acquire(). Pinned() re-reads the same slot.
+//
+// Reader side is one atomic load plus at most one exchange: no lock, no heap
+// allocation, no copy. Any allocation (std::string assignment) happens on
+// the writer thread, in its own slot.
+//
+// RED-GREEN REGRESSION PINS (overlay_snapshot_buffer_test.cpp)
+// ----------------------------------------------------------
+//   - EMPTY IS DEFAULT      : Acquire() before any Publish() is T{}.
+//   - LATEST WINS           : several publishes between frames yield the
+//                             last one, never an older one.
+//   - PIN IS STABLE         : a pinned reference does not change while the
+//                             writer keeps publishing.
+//   - NO TEARING            : a reader racing a writer only ever sees whole,
+//                             monotonically newer snapshots.
+//
+// Single writer, single reader. Pure, header-only, std-only (<atomic>,
+// <cstdint>, <utility>). Unit-tested with a plain g++
+// (build_snapshot_buffer_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace swfoc_overlay
+{
+    template <typename T>
+    class SnapshotTripleBuffer
+    {
+    public:
+        // Writer thread only.
+        void Publish(T value)
+        {
+            slots_[back_] = std::move(value);
+            back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndexMask;
+        }
+
+        // Reader thread only. Latest published snapshot; valid until the
+        // next Acquire().
+        const T& Acquire()
+        {
+            if (middle_.load(std::memory_order_relaxed) & kFresh)
+            {
+                front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+            }
+            return slots_[front_];
+        }
+
+        // Reader thread only. The snapshot the last Acquire() pinned.
+        const T& Pinned() const { return slots_[front_]; }
+
+    private:
+        static constexpr uint32_t kIndexMask = 3;
+        static constexpr uint32_t kFresh = 4;
+
+        T slots_[3];
+        uint32_t back_ = 0;               // writer-owned
+        std::atomic<uint32_t> middle_{1}; // hand-off slot | kFresh
+        uint32_t front_ = 2;              // reader-owned
+    };
+}
@@ -0,0 +1,145 @@
+// =============================================================================
+// swfoc_overlay/overlay_snapshot_buffer_test.cpp — unit test for
+// overlay_snapshot_buffer.h (2026-10-14).
+//
+// overlay_snapshot_buffer.h is the triple buffer hud_state.cpp publishes HUD
+// snapshots through; the render thread pins one per frame by reference.
+// This test drives it single-threaded for the hand-off rules and with a
+// real writer thread for tearing.
+//
+// Header-only and std-only. Build + run via build_snapshot_buffer_test.bat —
+// no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - EMPTY IS DEFAULT : Acquire() before any Publish() is T{}.
+//   - LATEST WINS      : several publishes between frames yield the last.
+//   - PIN IS STABLE    : a pinned reference survives further publishes.
+//   - NO TEARING       : a racing reader sees whole, newer-only snapshots.
+// =============================================================================
+
+#include "overlay_snapshot_buffer.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    // Stand-in for HudSnapshot: a counter plus a string derived from it, so
+    // a torn read shows up as a mismatch.
+    struct Snap
+    {
+        int seq = -1;
+        std::string label;
+        int check = -1;
+    };
+
+    Snap MakeSnap(int seq)
+    {
+        Snap s;
+        s.seq = seq;
+        s.label = "snapshot-" + std::to_string(seq) + "-with-a-long-tail-past-sso";
+        s.check = seq * 7;
+        return s;
+    }
+
+    bool Whole(const Snap& s)
+    {
+        return s.check == s.seq * 7
+            && s.label == "snapshot-" + std::to_string(s.seq) + "-with-a-long-tail-past-sso";
+    }
+}
+
+int main()
+{
+    std::printf("=== overlay_snapshot_buffer.h ===\n");
+
+    // ---- Hand-off rules ----------------------------------------------------
+    {
+        Section("hand-off");
+
+        swfoc_overlay::SnapshotTripleBuffer<Snap> buf;
+        // PIN (EMPTY IS DEFAULT)
+        ExpectTrue("PIN EMPTY IS DEFAULT: nothing published yields T{}",
+                   buf.Acquire().seq == -1 && buf.Pinned().seq == -1);
+
+        buf.Publish(MakeSnap(1));
+        ExpectTrue("a publish is seen on the next Acquire", buf.Acquire().seq == 1);
+        ExpectTrue("Acquire without a new publish keeps the same snapshot",
+                   buf.Acquire().seq == 1);
+
+        // PIN (LATEST WINS)
+        buf.Publish(MakeSnap(2));
+        buf.Publish(MakeSnap(3));
+        buf.Publish(MakeSnap(4));
+        ExpectTrue("PIN LATEST WINS: three publishes between frames yield the third",
+                   buf.Acquire().seq == 4);
+
+        // PIN (PIN IS STABLE)
+        const Snap& pinned = buf.Acquire();
+        const std::string before = pinned.label;
+        for (int i = 5; i < 20; ++i) buf.Publish(MakeSnap(i));
+        ExpectTrue("PIN PIN IS STABLE: the pinned snapshot is untouched by publishes",
+                   pinned.seq == 4 && pinned.label == before && &buf.Pinned() == &pinned);
+        ExpectTrue("the next Acquire moves to the newest", buf.Acquire().seq == 19);
+    }
+
+    // ---- Concurrency -------------------------------------------------------
+    {
+        Section("writer thread");
+
+        swfoc_overlay::SnapshotTripleBuffer<Snap> buf;
+        constexpr int kPublishes = 200000;
+        std::atomic<bool> done{false};
+        std::thread writer([&]() {
+            for (int i = 0; i < kPublishes; ++i) buf.Publish(MakeSnap(i));
+            done.store(true, std::memory_order_release);
+        });
+
+        bool whole = true;
+        bool monotonic = true;
+        int last = -1;
+        long frames = 0;
+        while (!done.load(std::memory_order_acquire))
+        {
+            const Snap& s = buf.Acquire();
+            if (s.seq >= 0 && !Whole(s)) whole = false;
+            if (s.seq < last) monotonic = false;
+            last = s.seq;
+            ++frames;
+        }
+        writer.join();
+        // PIN (NO TEARING)
+        ExpectTrue("PIN NO TEARING: every snapshot read was whole", whole);
+        ExpectTrue("snapshots never go backwards", monotonic);
+        ExpectTrue("the final Acquire sees the last publish", buf.Acquire().seq == kPublishes - 1);
+        std::printf("  (%ld reader frames)\n", frames);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
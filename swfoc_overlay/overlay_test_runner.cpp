@@ -0,0 +1,234 @@
+// =============================================================================
+// swfoc_overlay/overlay_test_runner.cpp — entry point of the single-binary
+// overlay_tests target (CMakeLists.txt, 2026-10-14).
+//
+//   overlay_tests                  every test, in name order
+//   overlay_tests --only <name>    one test (ctest runs each this way, so
+//                                  `ctest -j` runs them in parallel)
+//   overlay_tests --list           the test names
+//   overlay_tests --bench [iters]  time the per-pick math kernels
+//
+// The tests are the unchanged *_test.cpp files; CMake renames each one's
+// main() and lists it in overlay_test_registry.inc.
+//
+// --bench times what one cursor pick costs on the render thread: the
+// overlay_cursor_ray.h inverse + unproject, the overlay_hit_test.h slab test
+// and nearest-hit walk, and the overlay_unit_aabb.h set fill / lookup / pick,
+// all over a full kMaxRaycastUnits set. Output is ns per call; the numbers
+// are for comparing a kernel change against its parent on one machine, not
+// across machines.
+// =============================================================================
+
+#include "overlay_cursor_ray.h"
+#include "overlay_hit_test.h"
+#include "overlay_unit_aabb.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct OverlayTest
+    {
+        const char* name;
+        int (*run)();
+    };
+}
+
+// The renamed test mains and kOverlayTests[] (generated at configure time).
+#include "overlay_test_registry.inc"
+
+namespace
+{
+    constexpr int kOverlayTestCount = static_cast<int>(sizeof(kOverlayTests) / sizeof(kOverlayTests[0]));
+
+    const OverlayTest* FindTest(const char* name)
+    {
+        for (const OverlayTest& t : kOverlayTests)
+        {
+            if (std::strcmp(t.name, name) == 0) return &t;
+        }
+        return nullptr;
+    }
+
+    int RunAll()
+    {
+        int failed = 0;
+        for (const OverlayTest& t : kOverlayTests)
+        {
+            std::printf("\n=== %s ===\n", t.name);
+            if (t.run() != 0)
+            {
+                ++failed;
+                std::printf("=== %s: FAIL ===\n", t.name);
+            }
+            std::fflush(stdout);
+        }
+        std::printf("\n=== overlay_tests: %d run, %d failed ===\n", kOverlayTestCount, failed);
+        return failed == 0 ? 0 : 1;
+    }
+
+    // ---- Bench -------------------------------------------------------------
+
+    using swfoc_overlay::Mat4;
+    using swfoc_overlay::Vec3;
+    using swfoc_overlay::WorldRay;
+
+    // Keeps the optimiser from dropping a timed call whose result is unused.
+    volatile float g_sink = 0.0f;
+
+    // Row-major D3DXMatrixPerspectiveFovRH / LookAtRH, as in the kernel tests.
+    Mat4 BenchPerspectiveRH(float fovY, float aspect, float zn, float zf)
+    {
+        const float yScale = 1.0f / std::tan(fovY * 0.5f);
+        Mat4 r{};
+        r.m[0] = yScale / aspect;
+        r.m[5] = yScale;
+        r.m[10] = zf / (zn - zf);
+        r.m[11] = -1.0f;
+        r.m[14] = zn * zf / (zn - zf);
+        return r;
+    }
+
+    Mat4 BenchLookAtRH(const Vec3& eye, const Vec3& at, const Vec3& up)
+    {
+        using namespace swfoc_overlay;
+        const Vec3 z = Vec3Normalize(Vec3Sub(eye, at));
+        const Vec3 x = Vec3Normalize(Vec3Cross(up, z));
+        const Vec3 y = Vec3Cross(z, x);
+        Mat4 r{};
+        r.m[0] = x.x; r.m[1] = y.x; r.m[2] = z.x;
+        r.m[4] = x.y; r.m[5] = y.y; r.m[6] = z.y;
+        r.m[8] = x.z; r.m[9] = y.z; r.m[10] = z.z;
+        r.m[12] = -Vec3Dot(x, eye);
+        r.m[13] = -Vec3Dot(y, eye);
+        r.m[14] = -Vec3Dot(z, eye);
+        r.m[15] = 1.0f;
+        return r;
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    template <typename Fn>
+    void Time(const char* label, long iters, Fn fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < iters; i++) fn(i);
+        const auto end = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        std::printf("  %-44s %9.1f ns/call\n", label, ns / static_cast<double>(iters));
+    }
+
+    int RunBench(long iters)
+    {
+        using namespace swfoc_overlay;
+        std::printf("overlay_tests --bench (%ld iterations)\n", iters);
+
+        const float vw = 1920.0f, vh = 1080.0f;
+        const Mat4 viewProj = Mat4Multiply(BenchLookAtRH(Vec3{0, -400, 600}, Vec3{0, 0, 0}, Vec3{0, 0, 1}),
+                                           BenchPerspectiveRH(0.8f, vw / vh, 1.0f, 5000.0f));
+        Mat4 invVP{};
+        if (!Mat4Inverse(viewProj, invVP))
+        {
+            std::printf("bench view-projection is singular\n");
+            return 1;
+        }
+
+        // An 8x8 grid of unit boxes around the origin — a full raycast set.
+        UnitAabbSet set;
+        for (int i = 0; i < kMaxRaycastUnits; i++)
+        {
+            AppendUnitAabb(set, 0x1000u + static_cast<std::uint64_t>(i),
+                           Vec3{(i % 8 - 4) * 40.0f, (i / 8 - 4) * 40.0f, 5.0f}, 6.0f, 6.0f, 5.0f);
+        }
+        const WorldRay center = CursorRayFromInverse(vw * 0.5f, vh * 0.5f, vw, vh, invVP);
+
+        // Cursor positions differ per call so no result can be hoisted.
+        auto sx = [&](long i) { return static_cast<float>(i % 1920); };
+        auto sy = [&](long i) { return static_cast<float>((i * 7) % 1080); };
+
+        Section("overlay_cursor_ray.h");
+        Time("Mat4Inverse", iters, [&](long i) {
+            Mat4 m = viewProj;
+            m.m[12] += static_cast<float>(i & 1);
+            Mat4 out{};
+            Mat4Inverse(m, out);
+            g_sink = out.m[0];
+        });
+        Time("CursorRay (inverse + unproject)", iters, [&](long i) {
+            g_sink = CursorRay(sx(i), sy(i), vw, vh, viewProj).direction.x;
+        });
+        Time("CursorRayFromInverse (cached inverse)", iters, [&](long i) {
+            g_sink = CursorRayFromInverse(sx(i), sy(i), vw, vh, invVP).direction.x;
+        });
+        Time("RayPlaneZ0", iters, [&](long i) {
+            g_sink = RayPlaneZ0(CursorRayFromInverse(sx(i), sy(i), vw, vh, invVP)).x;
+        });
+
+        Section("overlay_hit_test.h");
+        Time("RayAabbIntersect (one box)", iters, [&](long i) {
+            float t = 0.0f;
+            RayAabbIntersect(center, set.entries[i % kMaxRaycastUnits].box, t);
+            g_sink = t;
+        });
+        Time("NearestUnitHit (64 boxes)", iters, [&](long i) {
+            g_sink = NearestUnitHit(CursorRayFromInverse(sx(i), sy(i), vw, vh, invVP), set.entries, set.count).t;
+        });
+        Time("PickUnitAtCursor (64 boxes, with inverse)", iters, [&](long i) {
+            g_sink = PickUnitAtCursor(sx(i), sy(i), vw, vh, viewProj, set.entries, set.count).t;
+        });
+
+        Section("overlay_unit_aabb.h");
+        Time("AppendUnitAabb x64 (refill the set)", iters / 64 + 1, [&](long i) {
+            UnitAabbSet s;
+            for (int k = 0; k < kMaxRaycastUnits; k++)
+            {
+                AppendUnitAabb(s, static_cast<std::uint64_t>(k + 1), Vec3{static_cast<float>(i), 0, 0}, 1, 1, 1);
+            }
+            g_sink = s.entries[kMaxRaycastUnits - 1].box.min.x;
+        });
+        Time("FindUnitAabb (64 entries, miss)", iters, [&](long i) {
+            g_sink = FindUnitAabb(set, 0x9000u + static_cast<std::uint64_t>(i & 1)) ? 1.0f : 0.0f;
+        });
+        Time("PickUnitInSet (64 boxes)", iters, [&](long i) {
+            g_sink = PickUnitInSet(CursorRayFromInverse(sx(i), sy(i), vw, vh, invVP), set).t;
+        });
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 2 && std::strcmp(argv[1], "--list") == 0)
+    {
+        for (const OverlayTest& t : kOverlayTests) std::printf("%s\n", t.name);
+        return 0;
+    }
+    if (argc == 3 && std::strcmp(argv[1], "--only") == 0)
+    {
+        const OverlayTest* t = FindTest(argv[2]);
+        if (!t)
+        {
+            std::fprintf(stderr, "overlay_tests: no test named %s (--list)\n", argv[2]);
+            return 2;
+        }
+        return t->run();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        const long iters = argc >= 3 ? std::strtol(argv[2], nullptr, 10) : 1000000;
+        return RunBench(iters > 0 ? iters : 1000000);
+    }
+    if (argc != 1)
+    {
+        std::fprintf(stderr, "usage: overlay_tests [--list | --only <name> | --bench [iters]]\n");
+        return 2;
+    }
+    return RunAll();
+}
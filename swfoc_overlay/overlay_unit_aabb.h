@@ -15,9 +15,9 @@
 //
 // WHY A FIXED POD ARRAY, NOT std::vector
 // --------------------------------------
-// HudSnapshot is copied wholesale on every Present detour (GetHudSnapshot) and
-// rebuilt every refresh tick (hud_state.cpp). A flat POD array copies in one
-// memcpy, never heap-allocates on the render thread, and keeps HudSnapshot's
+// HudSnapshot is rebuilt every refresh tick (hud_state.cpp) and published
+// through the render thread's triple buffer (overlay_snapshot_buffer.h). A
+// flat POD array copies in one memcpy, never heap-allocates, and keeps HudSnapshot's
 // binary layout fixed-size — which is what the iter-275 binary-layout-stability
 // commitment wants. The capacity is kMaxRaycastUnits (64), the same
 // client-side raycast budget overlay_hit_test.h::NearestUnitHit clamps to.
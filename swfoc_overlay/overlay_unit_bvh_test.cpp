@@ -0,0 +1,225 @@
+// =============================================================================
+// swfoc_overlay/overlay_unit_bvh_test.cpp — unit test for overlay_unit_bvh.h
+// (2026-10-14).
+//
+// The BVH replaces a capped linear walk for click picking, so the one thing
+// it must never do is pick differently from that walk — only faster, and
+// past the old 64-unit cap. Every pick here is checked against an uncapped
+// linear scan with NearestUnitHit's tie rule.
+//
+// overlay_unit_bvh.h is header-only and std-only. Build + run via
+// build_unit_bvh_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - NO CAP            : the 500th unit of a 500-unit set is pickable.
+//   - MATCHES LINEAR    : random scenes agree with a linear scan.
+//   - TIE KEEPS ORDER   : identical boxes resolve to the lower index.
+//   - INVALID SKIPPED   : an inverted box is left out of the tree.
+//   - EMPTY IS A MISS   : an empty tree is a clean miss.
+// =============================================================================
+
+#include "overlay_unit_bvh.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::Aabb;
+    using swfoc_overlay::AabbFromCenterExtents;
+    using swfoc_overlay::BuildUnitBvh;
+    using swfoc_overlay::PickUnitInBvh;
+    using swfoc_overlay::UnitAabb;
+    using swfoc_overlay::UnitBvh;
+    using swfoc_overlay::UnitHit;
+    using swfoc_overlay::Vec3;
+    using swfoc_overlay::WorldRay;
+
+    // Deterministic LCG, so a failure reproduces.
+    struct Rng
+    {
+        uint32_t state = 12345;
+        float Next(float lo, float hi)
+        {
+            state = state * 1664525u + 1013904223u;
+            return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+        }
+    };
+
+    // Uncapped linear scan with NearestUnitHit's tie rule.
+    UnitHit LinearPick(const WorldRay& ray, const std::vector<UnitAabb>& units)
+    {
+        UnitHit best{ false, -1, 0, 0.0f };
+        for (std::size_t i = 0; i < units.size(); ++i)
+        {
+            float t = 0.0f;
+            if (!swfoc_overlay::RayAabbIntersect(ray, units[i].box, t)) continue;
+            if (!best.hit || t < best.t)
+            {
+                best = UnitHit{ true, static_cast<int>(i), units[i].handle, t };
+            }
+        }
+        return best;
+    }
+
+    WorldRay DownRay(float x, float y)
+    {
+        return WorldRay{ Vec3{ x, y, 1000.0f }, Vec3{ 0.0f, 0.0f, -1.0f }, true };
+    }
+
+    UnitAabb Unit(uint64_t handle, float x, float y, float z, float r)
+    {
+        return UnitAabb{ handle, AabbFromCenterExtents(Vec3{ x, y, z }, r, r, r) };
+    }
+}
+
+int main()
+{
+    std::printf("overlay_unit_bvh_test\n");
+
+    // ---- No cap ------------------------------------------------------------
+    {
+        Section("no cap");
+
+        // A 25 x 20 grid, 500 units, none overlapping.
+        std::vector<UnitAabb> units;
+        for (int i = 0; i < 500; ++i)
+        {
+            units.push_back(Unit(0x1000u + i, (i % 25) * 10.0f, (i / 25) * 10.0f, 0.0f, 2.0f));
+        }
+        UnitBvh bvh;
+        BuildUnitBvh(bvh, units);
+        ExpectEqInt("every unit lands in the tree", static_cast<long long>(bvh.units.size()), 500);
+
+        // PIN (NO CAP)
+        const UnitHit last = PickUnitInBvh(DownRay(24 * 10.0f, 19 * 10.0f), bvh);
+        ExpectTrue("PIN NO CAP: the 500th unit is picked", last.hit && last.index == 499);
+        ExpectEqInt("PIN NO CAP: its handle comes back", static_cast<long long>(last.handle), 0x1000 + 499);
+
+        int picked = 0;
+        for (int i = 0; i < 500; ++i)
+        {
+            const UnitHit h = PickUnitInBvh(DownRay((i % 25) * 10.0f, (i / 25) * 10.0f), bvh);
+            if (h.hit && h.index == i) ++picked;
+        }
+        ExpectEqInt("every grid unit is pickable at its centre", picked, 500);
+        ExpectTrue("a ray between units misses",
+                   !PickUnitInBvh(DownRay(5.0f, 5.0f), bvh).hit);
+    }
+
+    // ---- Matches linear ----------------------------------------------------
+    {
+        Section("matches linear");
+
+        Rng rng;
+        int mismatches = 0;
+        int hits = 0;
+        for (int scene = 0; scene < 20; ++scene)
+        {
+            std::vector<UnitAabb> units;
+            const int n = 1 + scene * 37;
+            for (int i = 0; i < n; ++i)
+            {
+                units.push_back(Unit(static_cast<uint64_t>(scene) * 1000 + i,
+                                     rng.Next(0.0f, 400.0f), rng.Next(0.0f, 400.0f),
+                                     rng.Next(0.0f, 20.0f), rng.Next(1.0f, 12.0f)));
+            }
+            UnitBvh bvh;
+            BuildUnitBvh(bvh, units);
+            for (int k = 0; k < 200; ++k)
+            {
+                const Vec3 from{ rng.Next(-100.0f, 500.0f), rng.Next(-100.0f, 500.0f), 300.0f };
+                const Vec3 to{ rng.Next(0.0f, 400.0f), rng.Next(0.0f, 400.0f), 0.0f };
+                const WorldRay ray{ from, Vec3{ to.x - from.x, to.y - from.y, to.z - from.z }, true };
+                const UnitHit a = PickUnitInBvh(ray, bvh);
+                const UnitHit b = LinearPick(ray, units);
+                if (a.hit != b.hit || a.index != b.index || a.handle != b.handle || a.t != b.t)
+                {
+                    ++mismatches;
+                }
+                if (b.hit) ++hits;
+            }
+        }
+        // PIN (MATCHES LINEAR)
+        ExpectEqInt("PIN MATCHES LINEAR: 4000 random picks agree", mismatches, 0);
+        ExpectTrue("the random scenes actually hit units", hits > 500);
+    }
+
+    // ---- Ties, invalid boxes, empty trees ----------------------------------
+    {
+        Section("ties, invalid boxes, empty trees");
+
+        // PIN (TIE KEEPS ORDER)
+        std::vector<UnitAabb> units;
+        for (int i = 0; i < 9; ++i) units.push_back(Unit(0x50u + i, i * 10.0f, 0.0f, 0.0f, 2.0f));
+        units.push_back(Unit(0xAA, 40.0f, 0.0f, 0.0f, 2.0f));  // same box as index 4
+        UnitBvh bvh;
+        BuildUnitBvh(bvh, units);
+        const UnitHit tie = PickUnitInBvh(DownRay(40.0f, 0.0f), bvh);
+        ExpectTrue("PIN TIE KEEPS ORDER: the lower index wins", tie.hit && tie.index == 4);
+        ExpectEqInt("PIN TIE KEEPS ORDER: with its handle", static_cast<long long>(tie.handle), 0x54);
+
+        // PIN (INVALID SKIPPED)
+        std::vector<UnitAabb> mixed = units;
+        mixed[2].box = Aabb{ Vec3{ 21.0f, 1.0f, 1.0f }, Vec3{ 19.0f, -1.0f, -1.0f } };
+        BuildUnitBvh(bvh, mixed);
+        ExpectEqInt("PIN INVALID SKIPPED: the inverted box is not in the tree",
+                    static_cast<long long>(bvh.units.size()), 9);
+        ExpectTrue("PIN INVALID SKIPPED: its spot is a miss", !PickUnitInBvh(DownRay(20.0f, 0.0f), bvh).hit);
+        const UnitHit after = PickUnitInBvh(DownRay(30.0f, 0.0f), bvh);
+        ExpectTrue("later units keep their input index", after.hit && after.index == 3);
+
+        // PIN (EMPTY IS A MISS)
+        UnitBvh never;
+        const UnitHit none = PickUnitInBvh(DownRay(0.0f, 0.0f), never);
+        ExpectTrue("PIN EMPTY IS A MISS: a never-built tree misses",
+                   !none.hit && none.index == -1 && none.handle == 0);
+        BuildUnitBvh(bvh, std::vector<UnitAabb>());
+        ExpectTrue("PIN EMPTY IS A MISS: rebuilding over nothing clears the tree",
+                   bvh.nodes.empty() && !PickUnitInBvh(DownRay(0.0f, 0.0f), bvh).hit);
+        BuildUnitBvh(bvh, units);
+        ExpectTrue("an invalid ray misses",
+                   !PickUnitInBvh(WorldRay{ Vec3{ 0, 0, 0 }, Vec3{ 0, 0, 0 }, false }, bvh).hit);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+// =============================================================================
+// swfoc_overlay/overlay_unit_table.h — client side of the bridge's bulk unit
+// table (Local\SWFOC_Bridge_Units), feeding the HUD's pick boxes (2026-10-14).
+//
+// SWFOC_ListTacticalUnits("bin") fills a struct-of-arrays block in shared
+// memory (SharedUnitTable in swfoc_lua_bridge/shared_memory.h is the spec)
+// and replies "bin count=N seq=S bounds=B". The HUD worker sends that probe
+// on its fast tier, maps the table once, and copies out every row flagged
+// SHM_UNIT_HAS_BOUNDS as a UnitAabb for BuildUnitBvh (overlay_unit_bvh.h).
+// One pipe round trip moves the whole battle; no per-unit text is formatted
+// or parsed.
+//
+// Layout mirrored here (little-endian, offsets in bytes, MAX = 2048):
+//
+//     +0  magic "UNIT"  +4 version (2)  +6 header_size  +8 seq (odd = writing)
+//     +12 count  +16 slot_filter  +20 capacity  +24 tick
+//     +32 obj_addr[MAX] u64, owner[MAX] i32, hull[MAX] f32, flags[MAX] u8,
+//         pos[MAX][3] f32, half_extent[MAX][3] f32
+//
+// The copy is a seqlock read: a torn or still-writing table is retried and,
+// if it never settles, reported as a failure so the HUD keeps its last boxes.
+//
+// RED-GREEN REGRESSION PINS (overlay_unit_table_test.cpp)
+// ------------------------------------------------------
+//   - LAYOUT          : every column sits at the bridge's offset.
+//   - REPLY           : "bin count= seq= bounds=" parses; an ERR line or a
+//                       v1 reply without bounds= does not claim boxes.
+//   - BOUNDS ONLY     : rows without SHM_UNIT_HAS_BOUNDS are skipped; the
+//                       rest become centre +/- half-extent boxes.
+//   - WRONG VERSION   : a v1 table or a bad magic yields no boxes.
+//   - TORN READ       : an odd seq never settles -> failure, output unchanged.
+//   - FLAGS FOLLOW    : the optional flags output lines up with the boxes.
+//
+// Pure, header-only, std-only. No Windows, no ImGui, no pipe. Unit-tested with
+// a plain g++ (build_unit_table_test.bat).
+// =============================================================================
+
+#pragma once
+
+#include "overlay_hit_test.h"  // Aabb, UnitAabb, AabbFromCenterExtents
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace swfoc_overlay
+{
+    // Mirrors SHMEM_UNITS_* / ShmUnitFlag in swfoc_lua_bridge/shared_memory.h.
+    constexpr const char* kBridgeUnitsName = "Local\\SWFOC_Bridge_Units";
+    constexpr uint32_t kBridgeUnitsMagic = 0x54494E55u;  // "UNIT"
+    constexpr uint16_t kBridgeUnitsVersion = 2;
+    constexpr uint32_t kBridgeUnitsMax = 2048;
+    constexpr uint8_t  kBridgeUnitLocalOwner = 0x04;
+    constexpr uint8_t  kBridgeUnitHasBounds = 0x10;
+
+    struct BridgeUnitTable
+    {
+        uint32_t              magic;
+        uint16_t              version;
+        uint16_t              header_size;
+        std::atomic<uint32_t> seq;
+        uint32_t              count;
+        int32_t               slot_filter;
+        uint32_t              capacity;
+        uint64_t              tick;
+        uint64_t              obj_addr[kBridgeUnitsMax];
+        int32_t               owner[kBridgeUnitsMax];
+        float                 hull[kBridgeUnitsMax];
+        uint8_t               flags[kBridgeUnitsMax];
+        float                 pos[kBridgeUnitsMax][3];
+        float                 half_extent[kBridgeUnitsMax][3];
+    };
+    static_assert(offsetof(BridgeUnitTable, obj_addr) == 32, "obj_addr offset drifted from SharedUnitTable");
+    static_assert(offsetof(BridgeUnitTable, flags) == 32 + 16 * kBridgeUnitsMax, "flags offset drifted from SharedUnitTable");
+    static_assert(offsetof(BridgeUnitTable, pos) == 32 + 17 * kBridgeUnitsMax, "pos offset drifted from SharedUnitTable");
+    static_assert(offsetof(BridgeUnitTable, half_extent) == 32 + 29 * kBridgeUnitsMax, "half_extent offset drifted from SharedUnitTable");
+
+    // The probe's reply line.
+    struct BridgeUnitReply
+    {
+        uint32_t count = 0;
+        uint32_t seq = 0;
+        uint32_t bounds = 0;   // rows carrying SHM_UNIT_HAS_BOUNDS
+    };
+
+    // Parses "bin count=N seq=S bounds=B". A v1 bridge omits bounds= and is
+    // refused: its table has no boxes to read.
+    inline bool ParseBridgeUnitReply(const std::string& reply, BridgeUnitReply& out)
+    {
+        unsigned count = 0, seq = 0, bounds = 0;
+        if (std::sscanf(reply.c_str(), "bin count=%u seq=%u bounds=%u",
+                        &count, &seq, &bounds) != 3)
+        {
+            return false;
+        }
+        out.count = count;
+        out.seq = seq;
+        out.bounds = bounds;
+        return true;
+    }
+
+    inline bool BridgeUnitTableUsable(const BridgeUnitTable& t)
+    {
+        return t.magic == kBridgeUnitsMagic && t.version >= kBridgeUnitsVersion;
+    }
+
+    // Seqlock copy of every bounded row into `out` (replaced). Returns false,
+    // leaving `out` alone, when the table is unusable or never settles.
+    // `flagsOut`, when given, receives each copied row's ShmUnitFlag byte in
+    // the same order (the minimap density raster reads the local-owner bit).
+    inline bool ReadBridgeUnitBounds(const BridgeUnitTable& t, std::vector<UnitAabb>& out,
+                                     std::vector<uint8_t>* flagsOut, int retries = 8)
+    {
+        if (!BridgeUnitTableUsable(t)) return false;
+        std::vector<uint64_t> obj;
+        std::vector<uint8_t> flags;
+        std::vector<float> pos, ext;
+        for (int attempt = 0; attempt < retries; ++attempt)
+        {
+            const uint32_t before = t.seq.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            uint32_t n = t.count;
+            if (n > kBridgeUnitsMax) n = kBridgeUnitsMax;
+            obj.resize(n);
+            flags.resize(n);
+            pos.resize(3 * n);
+            ext.resize(3 * n);
+            if (n > 0)
+            {
+                std::memcpy(obj.data(), t.obj_addr, n * sizeof(uint64_t));
+                std::memcpy(flags.data(), t.flags, n);
+                std::memcpy(pos.data(), t.pos, 3 * n * sizeof(float));
+                std::memcpy(ext.data(), t.half_extent, 3 * n * sizeof(float));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (t.seq.load(std::memory_order_relaxed) != before) continue;
+
+            std::vector<UnitAabb> units;
+            std::vector<uint8_t> kept;
+            units.reserve(n);
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                if (!(flags[i] & kBridgeUnitHasBounds)) continue;
+                const float* c = &pos[3 * i];
+                const float* e = &ext[3 * i];
+                units.push_back(UnitAabb{ obj[i],
+                    AabbFromCenterExtents(Vec3{ c[0], c[1], c[2] }, e[0], e[1], e[2]) });
+                if (flagsOut) kept.push_back(flags[i]);
+            }
+            out.swap(units);
+            if (flagsOut) flagsOut->swap(kept);
+            return true;
+        }
+        return false;
+    }
+
+    inline bool ReadBridgeUnitBounds(const BridgeUnitTable& t, std::vector<UnitAabb>& out,
+                                     int retries = 8)
+    {
+        return ReadBridgeUnitBounds(t, out, nullptr, retries);
+    }
+}
@@ -0,0 +1,195 @@
+// =============================================================================
+// swfoc_overlay/overlay_unit_table_test.cpp — unit test for
+// overlay_unit_table.h (2026-10-14).
+//
+// overlay_unit_table.h reads the bridge's bulk unit table straight out of
+// shared memory, so a drifted offset, a misread flag or a torn copy would
+// hand the picker boxes in the wrong place. The table is built here in a
+// plain heap block, written the way the bridge's PushUnitTable writes it.
+//
+// overlay_unit_table.h is header-only and std-only. Build + run via
+// build_unit_table_test.bat — no game, no pipe, no ImGui.
+//
+// RED-GREEN REGRESSION PINS
+// ------------------------
+//   - LAYOUT          : columns at the bridge's offsets (static_asserts plus
+//                       a byte-level check of pos / half_extent).
+//   - REPLY           : v2 replies parse; ERR and v1 replies do not.
+//   - BOUNDS ONLY     : only HAS_BOUNDS rows become boxes.
+//   - WRONG VERSION   : v1 / bad magic -> no boxes.
+//   - TORN READ       : a table stuck mid-write -> failure, output unchanged.
+//   - FLAGS FOLLOW    : the optional flags output lines up with the boxes.
+// =============================================================================
+
+#include "overlay_unit_table.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    int g_checks = 0;
+    int g_failures = 0;
+
+    void ExpectTrue(const char* name, bool cond)
+    {
+        ++g_checks;
+        if (cond)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    expected true\n", name);
+        }
+    }
+
+    void ExpectEqInt(const char* name, long long got, long long want)
+    {
+        ++g_checks;
+        if (got == want)
+        {
+            std::printf("  ok   %s\n", name);
+        }
+        else
+        {
+            ++g_failures;
+            std::printf("  FAIL %s\n    got %lld, want %lld\n", name, got, want);
+        }
+    }
+
+    void Section(const char* title)
+    {
+        std::printf("\n[ %s ]\n", title);
+    }
+
+    using swfoc_overlay::BridgeUnitReply;
+    using swfoc_overlay::BridgeUnitTable;
+    using swfoc_overlay::ParseBridgeUnitReply;
+    using swfoc_overlay::ReadBridgeUnitBounds;
+    using swfoc_overlay::UnitAabb;
+    using swfoc_overlay::kBridgeUnitHasBounds;
+
+    std::unique_ptr<BridgeUnitTable> NewTable()
+    {
+        std::unique_ptr<BridgeUnitTable> t(new BridgeUnitTable());
+        t->magic = swfoc_overlay::kBridgeUnitsMagic;
+        t->version = swfoc_overlay::kBridgeUnitsVersion;
+        t->header_size = 32;
+        t->seq.store(0);
+        t->capacity = swfoc_overlay::kBridgeUnitsMax;
+        t->slot_filter = -1;
+        return t;
+    }
+
+    void PutRow(BridgeUnitTable& t, uint32_t i, uint64_t obj, uint8_t flags,
+                float x, float y, float z, float ex, float ey, float ez)
+    {
+        t.obj_addr[i] = obj;
+        t.flags[i] = flags;
+        t.pos[i][0] = x;
+        t.pos[i][1] = y;
+        t.pos[i][2] = z;
+        t.half_extent[i][0] = ex;
+        t.half_extent[i][1] = ey;
+        t.half_extent[i][2] = ez;
+        if (t.count < i + 1) t.count = i + 1;
+    }
+}
+
+int main()
+{
+    std::printf("overlay_unit_table_test\n");
+
+    // ---- Layout and reply --------------------------------------------------
+    {
+        Section("layout and reply");
+
+        // PIN (LAYOUT)
+        std::unique_ptr<BridgeUnitTable> t = NewTable();
+        PutRow(*t, 1, 0xA, kBridgeUnitHasBounds, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f);
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(t.get());
+        float y = 0.0f, ez = 0.0f;
+        std::memcpy(&y, raw + 32 + 17 * 2048 + 12 + 4, 4);
+        std::memcpy(&ez, raw + 32 + 29 * 2048 + 12 + 8, 4);
+        ExpectTrue("PIN LAYOUT: pos[1].y sits at +32 + 17*MAX + 16", y == 2.0f);
+        ExpectTrue("PIN LAYOUT: half_extent[1].z sits at +32 + 29*MAX + 20", ez == 6.0f);
+
+        // PIN (REPLY)
+        BridgeUnitReply r;
+        ExpectTrue("PIN REPLY: a v2 reply parses",
+                   ParseBridgeUnitReply("bin count=12 seq=8 bounds=10\n", r));
+        ExpectEqInt("count", r.count, 12);
+        ExpectEqInt("seq", r.seq, 8);
+        ExpectEqInt("bounds", r.bounds, 10);
+        BridgeUnitReply untouched;
+        ExpectTrue("PIN REPLY: a v1 reply without bounds= is refused",
+                   !ParseBridgeUnitReply("bin count=12 seq=8\n", untouched));
+        ExpectTrue("PIN REPLY: an ERR line is refused",
+                   !ParseBridgeUnitReply("ERR: not in tactical\n", untouched));
+        ExpectTrue("PIN REPLY: a text unit list is refused",
+                   !ParseBridgeUnitReply("|0x1;0;100|\n", untouched));
+    }
+
+    // ---- Bounds ------------------------------------------------------------
+    {
+        Section("bounds");
+
+        std::unique_ptr<BridgeUnitTable> t = NewTable();
+        PutRow(*t, 0, 0x100, kBridgeUnitHasBounds, 10.0f, 20.0f, 0.0f, 2.0f, 3.0f, 4.0f);
+        PutRow(*t, 1, 0x200, 0x01, 50.0f, 50.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+        PutRow(*t, 2, 0x300, kBridgeUnitHasBounds | 0x04, -5.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+
+        // PIN (BOUNDS ONLY)
+        std::vector<UnitAabb> units;
+        ExpectTrue("a settled table reads", ReadBridgeUnitBounds(*t, units));
+        ExpectEqInt("PIN BOUNDS ONLY: the unbounded row is skipped",
+                    static_cast<long long>(units.size()), 2);
+        ExpectTrue("PIN BOUNDS ONLY: handles keep table order",
+                   units.size() == 2 && units[0].handle == 0x100 && units[1].handle == 0x300);
+        ExpectTrue("PIN BOUNDS ONLY: centre +/- half-extent",
+                   !units.empty() && units[0].box.min.x == 8.0f && units[0].box.max.y == 23.0f
+                   && units[0].box.min.z == -4.0f);
+
+        // PIN (FLAGS FOLLOW)
+        std::vector<uint8_t> flags;
+        ExpectTrue("PIN FLAGS FOLLOW: one flag byte per copied box",
+                   ReadBridgeUnitBounds(*t, units, &flags) && flags.size() == units.size());
+        ExpectTrue("PIN FLAGS FOLLOW: the local-owner bit rides with its row",
+                   flags.size() == 2 && !(flags[0] & swfoc_overlay::kBridgeUnitLocalOwner)
+                   && (flags[1] & swfoc_overlay::kBridgeUnitLocalOwner));
+
+        t->count = 0;
+        ExpectTrue("an empty table reads as no units",
+                   ReadBridgeUnitBounds(*t, units) && units.empty());
+
+        // PIN (WRONG VERSION)
+        t->count = 3;
+        t->version = 1;
+        std::vector<UnitAabb> kept(1);
+        ExpectTrue("PIN WRONG VERSION: a v1 table is refused",
+                   !ReadBridgeUnitBounds(*t, kept) && kept.size() == 1);
+        t->version = swfoc_overlay::kBridgeUnitsVersion;
+        t->magic = 0;
+        ExpectTrue("PIN WRONG VERSION: a bad magic is refused", !ReadBridgeUnitBounds(*t, kept));
+        t->magic = swfoc_overlay::kBridgeUnitsMagic;
+
+        // PIN (TORN READ)
+        t->seq.store(7);
+        ExpectTrue("PIN TORN READ: a table stuck mid-write fails",
+                   !ReadBridgeUnitBounds(*t, kept));
+        ExpectEqInt("PIN TORN READ: the caller's boxes are kept",
+                    static_cast<long long>(kept.size()), 1);
+        t->seq.store(8);
+        ExpectTrue("once the write ends the table reads again",
+                   ReadBridgeUnitBounds(*t, kept) && kept.size() == 2);
+    }
+
+    std::printf("\n%d checks, %d failures\n", g_checks, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}